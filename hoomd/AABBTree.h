@@ -77,6 +77,10 @@ struct PYBIND11_EXPORT AABBNode
                topology is left unchanged. Runs in O(log N) time. AABBs are not saved for all particles, so
                an update will only increase the volume of nodes. The tree should be rebuilt periodically instead of
                continually updated.
+    - Refit : Recompute the AABBs of all nodes from a complete set of particle AABBs, leaving the topology unchanged.
+              Runs in O(N) time and shrinks the nodes that update() grew.
+    - Reinsert : Move a particle to the leaf node that grows least to hold its new AABB. Runs in O(log N) time and
+                 keeps the node order, so the skip fields stay valid.
     - buildTree : build an efficiently arranged tree given a complete set of AABBs, one for each particle.
 
     **Implementation details**
@@ -168,6 +172,18 @@ class PYBIND11_EXPORT AABBTree
         //! Update the AABB of a particle
         inline void update(unsigned int idx, const AABB& aabb);
 
+        //! Recompute the AABBs of all nodes from the particle AABBs
+        inline void refit(const AABB *aabbs);
+
+        //! Move a particle to the leaf that best fits its new AABB
+        inline bool reinsert(unsigned int idx, const AABB& aabb);
+
+        //! Get the number of particles in the tree
+        inline unsigned int getNumParticles() const
+            {
+            return (unsigned int)m_mapping.size();
+            }
+
         //! Get the height of a given particle's leaf node
         inline unsigned int height(unsigned int idx);
 
@@ -259,6 +275,17 @@ class PYBIND11_EXPORT AABBTree
 
         //! Update the skip value for a node
         inline unsigned int updateSkip(unsigned int idx);
+
+        //! Cost of growing a box to hold another
+        inline static Scalar growthCost(const AABB& a, const AABB& b)
+            {
+            vec3<Scalar> old_extent = a.getUpper() - a.getLower();
+            AABB grown = merge(a, b);
+            vec3<Scalar> new_extent = grown.getUpper() - grown.getLower();
+
+            // compare the sum of the edge lengths, which remains meaningful for flat boxes in 2D
+            return (new_extent.x + new_extent.y + new_extent.z) - (old_extent.x + old_extent.y + old_extent.z);
+            }
     };
 
 
@@ -351,6 +378,110 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
         }
     }
 
+/*! \param aabbs List of AABBs for each particle, indexed by particle
+
+    refit() sets the AABB of every leaf node to the merged AABBs of its particles and the AABB of every internal node
+    to the merged AABBs of its children. buildNode() allocates every node before its children, so a single pass in
+    reverse node order visits children before their parents. Empty leaf nodes (left behind by reinsert()) do not
+    contribute to their parents.
+*/
+inline void AABBTree::refit(const AABB *aabbs)
+    {
+    std::vector<bool> empty(m_num_nodes, false);
+
+    for (unsigned int i = m_num_nodes; i > 0; i--)
+        {
+        AABBNode& node = m_nodes[i-1];
+
+        if (node.left == INVALID_NODE)
+            {
+            if (node.num_particles == 0)
+                {
+                empty[i-1] = true;
+                continue;
+                }
+
+            AABB my_aabb = aabbs[node.particles[0]];
+            for (unsigned int j = 1; j < node.num_particles; j++)
+                my_aabb = merge(my_aabb, aabbs[node.particles[j]]);
+            node.aabb = my_aabb;
+            }
+        else
+            {
+            bool left_empty = empty[node.left];
+            bool right_empty = empty[node.right];
+
+            if (left_empty && right_empty)
+                empty[i-1] = true;
+            else if (left_empty)
+                node.aabb = m_nodes[node.right].aabb;
+            else if (right_empty)
+                node.aabb = m_nodes[node.left].aabb;
+            else
+                node.aabb = merge(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+            }
+        }
+    }
+
+/*! \param idx Particle index to reinsert
+    \param aabb New AABB for particle *idx*
+    \returns false if the best fitting leaf node is full, in which case the tree is left unchanged
+
+    reinsert() descends from the root into the child that grows least to hold *aabb* and moves the particle into the
+    leaf node found. The particle is removed from its old leaf node, whose AABB is left as is until the next refit().
+    The tree topology and node order do not change.
+*/
+inline bool AABBTree::reinsert(unsigned int idx, const AABB& aabb)
+    {
+    assert(idx < m_mapping.size());
+
+    unsigned int old_node = m_mapping[idx];
+    assert(old_node != INVALID_NODE);
+
+    // find the leaf node that grows least
+    unsigned int new_node = m_root;
+    while (!isNodeLeaf(new_node))
+        {
+        unsigned int left_idx = m_nodes[new_node].left;
+        unsigned int right_idx = m_nodes[new_node].right;
+
+        if (growthCost(m_nodes[left_idx].aabb, aabb) <= growthCost(m_nodes[right_idx].aabb, aabb))
+            new_node = left_idx;
+        else
+            new_node = right_idx;
+        }
+
+    if (new_node != old_node)
+        {
+        if (m_nodes[new_node].num_particles >= NODE_CAPACITY)
+            return false;
+
+        // remove the particle from the old leaf node
+        AABBNode& old_leaf = m_nodes[old_node];
+        for (unsigned int j = 0; j < old_leaf.num_particles; j++)
+            {
+            if (old_leaf.particles[j] == idx)
+                {
+                old_leaf.num_particles--;
+                old_leaf.particles[j] = old_leaf.particles[old_leaf.num_particles];
+                old_leaf.particle_tags[j] = old_leaf.particle_tags[old_leaf.num_particles];
+                break;
+                }
+            }
+
+        // and add it to the new one
+        AABBNode& new_leaf = m_nodes[new_node];
+        new_leaf.particles[new_leaf.num_particles] = idx;
+        new_leaf.particle_tags[new_leaf.num_particles] = aabb.tag;
+        new_leaf.num_particles++;
+        m_mapping[idx] = new_node;
+        }
+
+    // grow the leaf and its parents
+    update(idx, aabb);
+    return true;
+    }
+
 /*! \param idx Particle to get height for
     \returns Height of the node
 */
@@ -16,7 +16,7 @@ namespace py = pybind11;
     \post The Analyzer is constructed with the given particle data and a NULL profiler.
 */
 Analyzer::Analyzer(std::shared_ptr<SystemDefinition> sysdef) : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()),
-    m_exec_conf(m_pdata->getExecConf())
+    m_exec_conf(m_pdata->getExecConf()), m_timer(m_exec_conf)
     {
     // sanity check
     assert(m_sysdef);
@@ -44,6 +44,7 @@ void export_Analyzer(py::module& m)
         .def("analyze", &Analyzer::analyze)
         .def("setProfiler", &Analyzer::setProfiler)
         .def("notifyDetach", &Analyzer::notifyDetach)
+        .def("getExecutionTime", &Analyzer::getExecutionTime)
     #ifdef ENABLE_MPI
         .def("setCommunicator", &Analyzer::setCommunicator)
     #endif
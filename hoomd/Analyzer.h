@@ -18,6 +18,7 @@
 #define __ANALYZER_H__
 
 #include "Profiler.h"
+#include "OperationTimer.h"
 #include "SystemDefinition.h"
 #include "SharedSignal.h"
 #include "Communicator.h"
@@ -68,6 +69,12 @@ class PYBIND11_EXPORT Analyzer
             */
         virtual void analyze(uint64_t timestep){}
 
+        //! Wait for analysis that runs concurrently with the simulation
+        /*! System calls this at the end of every run. Derived classes that analyze asynchronously (see AsyncAnalyzer)
+            override this to wait for their outstanding work.
+        */
+        virtual void synchronize(){}
+
         //! Sets the profiler for the analyzer to use
         void setProfiler(std::shared_ptr<Profiler> prof);
 
@@ -130,6 +137,18 @@ class PYBIND11_EXPORT Analyzer
                 }
             }
 
+        //! Get the timer of this analyzer
+        OperationTimer& getTimer()
+            {
+            return m_timer;
+            }
+
+        //! Get the time in seconds spent in this analyzer since the start of the run
+        double getExecutionTime()
+            {
+            return m_timer.getTotalTime();
+            }
+
         /// Python will notify C++ objects when they are detached from Simulation
         virtual void notifyDetach() { };
 
@@ -144,6 +163,7 @@ class PYBIND11_EXPORT Analyzer
 
         std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Stored shared ptr to the execution configuration
         std::vector< std::shared_ptr<hoomd::detail::SignalSlot> > m_slots; //!< Stored shared ptr to the system signals
+        OperationTimer m_timer;                           //!< Time spent in this analyzer
     };
 
 //! Export the Analyzer class to python
@@ -0,0 +1,169 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file AscentWriter.cc
+    \brief Defines the AscentWriter class
+*/
+
+#ifdef ENABLE_ASCENT
+
+#include "AscentWriter.h"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \param sysdef SystemDefinition containing the particle data to publish
+    \param actions Ascent actions in YAML or JSON, or the name of a file that holds them. When empty, Ascent reads
+                   ascent_actions.yaml (or .json) from the working directory.
+    \param device_pointers Set to true to publish device pointers on the GPU
+*/
+AscentWriter::AscentWriter(std::shared_ptr<SystemDefinition> sysdef,
+                           const std::string& actions,
+                           bool device_pointers)
+    : Analyzer(sysdef), m_actions_str(actions), m_device_pointers(device_pointers), m_open(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing AscentWriter" << endl;
+
+    if (m_device_pointers && !m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "write.Ascent: device pointers require a GPU" << endl;
+        throw std::runtime_error("Error initializing AscentWriter");
+        }
+
+    conduit::Node options;
+    #ifdef ENABLE_MPI
+    options["mpi_comm"] = MPI_Comm_c2f(m_exec_conf->getMPICommunicator());
+    #endif
+    if (m_device_pointers)
+        options["runtime/vtkm/backend"] = "cuda";
+
+    if (!actions.empty())
+        {
+        // the actions are either given inline or in a file
+        std::string protocol = (actions.find('{') != std::string::npos || actions.find('[') != std::string::npos)
+            ? "json" : "yaml";
+        std::ifstream file(actions);
+        if (file.good())
+            options["actions_file"] = actions;
+        else
+            m_actions.parse(actions, protocol);
+        }
+
+    m_ascent.open(options);
+    m_open = true;
+    }
+
+AscentWriter::~AscentWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying AscentWriter" << endl;
+    if (m_open)
+        m_ascent.close();
+    }
+
+void AscentWriter::notifyDetach()
+    {
+    if (m_open)
+        {
+        m_ascent.close();
+        m_open = false;
+        }
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The fields point directly into the particle data arrays, which stay acquired until the actions complete.
+*/
+void AscentWriter::analyze(uint64_t timestep)
+    {
+    if (!m_open)
+        {
+        m_exec_conf->msg->error() << "write.Ascent: the Ascent instance is closed" << endl;
+        throw std::runtime_error("Error writing with AscentWriter");
+        }
+
+    if (m_prof) m_prof->push("Ascent");
+
+    const access_location::Enum location = m_device_pointers ? access_location::device : access_location::host;
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), location, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), location, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), location, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), location, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), location, access_mode::read);
+
+    const conduit::index_t N = m_pdata->getN();
+    const conduit::index_t s4 = sizeof(Scalar4);
+    const conduit::index_t s_int3 = sizeof(int3);
+    const BoxDim& box = m_pdata->getBox();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+
+    conduit::Node mesh;
+    mesh["state/cycle"] = (conduit::uint64)timestep;
+    mesh["state/domain_id"] = m_exec_conf->getRank();
+    mesh["state/box/L"].set(std::vector<Scalar>{global_box.getL().x, global_box.getL().y, global_box.getL().z});
+    mesh["state/box/tilt"].set(std::vector<Scalar>{global_box.getTiltFactorXY(),
+                                                   global_box.getTiltFactorXZ(),
+                                                   global_box.getTiltFactorYZ()});
+    mesh["state/box/local_lo"].set(std::vector<Scalar>{box.getLo().x, box.getLo().y, box.getLo().z});
+    mesh["state/box/local_hi"].set(std::vector<Scalar>{box.getHi().x, box.getHi().y, box.getHi().z});
+
+    // coordinates are strided views of the position array
+    mesh["coordsets/coords/type"] = "explicit";
+    mesh["coordsets/coords/values/x"].set_external(&h_pos.data[0].x, N, 0, s4);
+    mesh["coordsets/coords/values/y"].set_external(&h_pos.data[0].y, N, 0, s4);
+    mesh["coordsets/coords/values/z"].set_external(&h_pos.data[0].z, N, 0, s4);
+
+    mesh["topologies/particles/type"] = "points";
+    mesh["topologies/particles/coordset"] = "coords";
+
+    auto add_field = [&mesh](const std::string& name) -> conduit::Node&
+        {
+        conduit::Node& field = mesh["fields/" + name];
+        field["association"] = "vertex";
+        field["topology"] = "particles";
+        return field["values"];
+        };
+
+    // the type index is stored in the low bytes of pos.w
+    conduit::Node& type_id = add_field("typeid");
+    type_id.set_external((conduit::int32*)&h_pos.data[0].w, N, 0, s4);
+
+    conduit::Node& velocity = add_field("velocity");
+    velocity["u"].set_external(&h_vel.data[0].x, N, 0, s4);
+    velocity["v"].set_external(&h_vel.data[0].y, N, 0, s4);
+    velocity["w"].set_external(&h_vel.data[0].z, N, 0, s4);
+
+    add_field("mass").set_external(&h_vel.data[0].w, N, 0, s4);
+
+    conduit::Node& orientation = add_field("orientation");
+    orientation["s"].set_external(&h_orientation.data[0].x, N, 0, s4);
+    orientation["x"].set_external(&h_orientation.data[0].y, N, 0, s4);
+    orientation["y"].set_external(&h_orientation.data[0].z, N, 0, s4);
+    orientation["z"].set_external(&h_orientation.data[0].w, N, 0, s4);
+
+    conduit::Node& image = add_field("image");
+    image["x"].set_external((conduit::int32*)&h_image.data[0].x, N, 0, s_int3);
+    image["y"].set_external((conduit::int32*)&h_image.data[0].y, N, 0, s_int3);
+    image["z"].set_external((conduit::int32*)&h_image.data[0].z, N, 0, s_int3);
+
+    add_field("tag").set_external((conduit::uint32*)h_tag.data, N, 0, sizeof(unsigned int));
+
+    m_ascent.publish(mesh);
+    m_ascent.execute(m_actions);
+
+    if (m_prof) m_prof->pop();
+    }
+
+void export_AscentWriter(py::module& m)
+    {
+    py::class_<AscentWriter, Analyzer, std::shared_ptr<AscentWriter> >(m,"AscentWriter")
+        .def(py::init< std::shared_ptr<SystemDefinition>, const std::string&, bool>())
+        .def_property_readonly("actions", &AscentWriter::getActions)
+        .def_property_readonly("device_pointers", &AscentWriter::getDevicePointers)
+        ;
+    }
+
+#endif // ENABLE_ASCENT
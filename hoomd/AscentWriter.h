@@ -0,0 +1,81 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file AscentWriter.h
+    \brief Declares the AscentWriter class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __ASCENT_WRITER_H__
+#define __ASCENT_WRITER_H__
+
+#ifdef ENABLE_ASCENT
+
+#include "Analyzer.h"
+
+#include <ascent.hpp>
+#include <conduit.hpp>
+
+#include <string>
+#include <pybind11/pybind11.h>
+
+//! Passes the particle data to an Ascent in situ pipeline
+/*! On every call to analyze(), AscentWriter describes the local particles of each rank as a Conduit Mesh Blueprint
+    point mesh and executes the configured Ascent actions on it. The fields are published with set_external() and
+    strides that match the particle data layout, so that no particle data is copied and no data is gathered across
+    ranks. Ascent renders or extracts in parallel on all ranks.
+
+    The published fields are the coordinates and the particle types (from the position array), the velocity and mass,
+    the orientation quaternion, the image and the tag. The box is published as the state of the mesh.
+
+    With device pointers enabled, the fields point to the device copies of the arrays, for GPU aware Ascent builds.
+    The pointers only remain valid during the call to execute(), so actions must not keep references to the data.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT AscentWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        AscentWriter(std::shared_ptr<SystemDefinition> sysdef,
+                     const std::string& actions,
+                     bool device_pointers);
+
+        //! Destructor
+        ~AscentWriter();
+
+        //! Publish the particle data and execute the actions
+        virtual void analyze(uint64_t timestep);
+
+        //! Get the actions
+        const std::string& getActions()
+            {
+            return m_actions_str;
+            }
+
+        //! Get whether device pointers are published
+        bool getDevicePointers()
+            {
+            return m_device_pointers;
+            }
+
+        /// Close the Ascent instance when the writer is removed from the simulation
+        virtual void notifyDetach();
+
+    private:
+        ascent::Ascent m_ascent;        //!< The Ascent instance
+        conduit::Node m_actions;        //!< Parsed actions
+        std::string m_actions_str;      //!< Actions as given by the user
+        bool m_device_pointers;         //!< True to publish device pointers
+        bool m_open;                    //!< True if the Ascent instance is open
+    };
+
+//! Exports the AscentWriter class to python
+void export_AscentWriter(pybind11::module& m);
+
+#endif // ENABLE_ASCENT
+
+#endif
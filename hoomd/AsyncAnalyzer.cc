@@ -0,0 +1,148 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file AsyncAnalyzer.cc
+    \brief Defines the AsyncAnalyzer base class
+*/
+
+#include "AsyncAnalyzer.h"
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \param sysdef System definition this analyzer will act on
+*/
+AsyncAnalyzer::AsyncAnalyzer(std::shared_ptr<SystemDefinition> sysdef) : Analyzer(sysdef)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing AsyncAnalyzer" << endl;
+    }
+
+AsyncAnalyzer::~AsyncAnalyzer()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying AsyncAnalyzer" << endl;
+
+    // the worker thread reads the staging buffers, never leave it running
+    for (unsigned int i = 0; i < 2; i++)
+        {
+        if (m_task[i].valid())
+            m_task[i].wait();
+        }
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The requested arrays are copied while the analysis of the previous snapshot may still run on the worker thread.
+    The new analysis starts once the previous one has completed, so that at most one analysis runs at a time.
+*/
+void AsyncAnalyzer::analyze(uint64_t timestep)
+    {
+    if (m_prof) m_prof->push("AsyncAnalyzer");
+
+    // the buffer is only refilled after its analysis completed
+    wait(m_cur_buffer);
+    stage(m_staging[m_cur_buffer], timestep);
+
+    // analyses run one at a time and in time step order
+    wait(m_cur_buffer ^ 1);
+
+    if (m_async)
+        {
+        const AsyncAnalyzerData& data = m_staging[m_cur_buffer];
+        m_task[m_cur_buffer] = std::async(std::launch::async, [this, &data]() { analyzeAsync(data); });
+        }
+    else
+        {
+        analyzeAsync(m_staging[m_cur_buffer]);
+        }
+
+    m_cur_buffer ^= 1;
+
+    if (m_prof) m_prof->pop();
+    }
+
+void AsyncAnalyzer::synchronize()
+    {
+    // wait for the older snapshot first to rethrow errors in time step order
+    wait(m_cur_buffer);
+    wait(m_cur_buffer ^ 1);
+    }
+
+/*! \param buffer Index of the staging buffer
+    Rethrows an exception thrown by analyzeAsync()
+*/
+void AsyncAnalyzer::wait(unsigned int buffer)
+    {
+    if (m_task[buffer].valid())
+        m_task[buffer].get();
+    }
+
+/*! \param data Staging buffer to fill
+    \param timestep Current time step of the simulation
+*/
+void AsyncAnalyzer::stage(AsyncAnalyzerData& data, uint64_t timestep)
+    {
+    const unsigned int requested = getRequestedFields();
+    const unsigned int N = m_pdata->getN();
+
+    data.timestep = timestep;
+    data.box = m_pdata->getBox();
+    data.global_box = m_pdata->getGlobalBox();
+    data.N = N;
+
+    if (requested & position)
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        data.pos.assign(h_pos.data, h_pos.data + N);
+        }
+    else
+        data.pos.clear();
+
+    if (requested & velocity)
+        {
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        data.vel.assign(h_vel.data, h_vel.data + N);
+        }
+    else
+        data.vel.clear();
+
+    if (requested & orientation)
+        {
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        data.orientation.assign(h_orientation.data, h_orientation.data + N);
+        }
+    else
+        data.orientation.clear();
+
+    if (requested & image)
+        {
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        data.image.assign(h_image.data, h_image.data + N);
+        }
+    else
+        data.image.clear();
+
+    if (requested & diameter)
+        {
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        data.diameter.assign(h_diameter.data, h_diameter.data + N);
+        }
+    else
+        data.diameter.clear();
+
+    if (requested & tag)
+        {
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        data.tag.assign(h_tag.data, h_tag.data + N);
+        }
+    else
+        data.tag.clear();
+    }
+
+void export_AsyncAnalyzer(py::module& m)
+    {
+    py::class_<AsyncAnalyzer, Analyzer, std::shared_ptr<AsyncAnalyzer>>(m,"AsyncAnalyzer")
+        .def("synchronize", &AsyncAnalyzer::synchronize)
+        .def_property("async_analysis", &AsyncAnalyzer::getAsync, &AsyncAnalyzer::setAsync)
+        ;
+    }
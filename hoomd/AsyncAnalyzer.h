@@ -0,0 +1,133 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file AsyncAnalyzer.h
+    \brief Declares the AsyncAnalyzer base class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __ASYNC_ANALYZER_H__
+#define __ASYNC_ANALYZER_H__
+
+#include "Analyzer.h"
+
+#include <future>
+#include <vector>
+#include <pybind11/pybind11.h>
+
+//! Copy of the particle data that an AsyncAnalyzer works on
+/*! Only the arrays requested by the analyzer are filled, the others are empty. The arrays hold the local particles
+    in the particle data order at the time of the snapshot.
+*/
+struct AsyncAnalyzerData
+    {
+    uint64_t timestep = 0;              //!< Time step of the snapshot
+    BoxDim box;                         //!< Local box
+    BoxDim global_box;                  //!< Global box
+    unsigned int N = 0;                 //!< Number of local particles
+    std::vector<Scalar4> pos;           //!< Positions and types
+    std::vector<Scalar4> vel;           //!< Velocities and masses
+    std::vector<Scalar4> orientation;   //!< Orientations
+    std::vector<int3> image;            //!< Images
+    std::vector<Scalar> diameter;       //!< Diameters
+    std::vector<unsigned int> tag;      //!< Tags
+    };
+
+//! Base class for analyzers that run concurrently with the integration
+/*! An Analyzer normally computes its result inline on the time step, which stalls the integration for the whole
+    analysis. AsyncAnalyzer splits analyze() into two parts. On the time step, the arrays that the analyzer requests
+    with getRequestedFields() are copied into a staging buffer. The derived class then computes its result from
+    that copy in analyzeAsync() on a worker thread while the simulation continues.
+
+    Two staging buffers are kept, so that the snapshot of the next time step can be taken while the analysis of the
+    previous one is still running. Before a buffer is refilled, and at the end of every run, the analyzer waits for
+    the analysis that reads it. Analyses therefore complete in time step order, and an exception thrown in
+    analyzeAsync() is rethrown on the next call to analyze() or synchronize().
+
+    analyzeAsync() must only access the data passed to it and the members of the derived class. It must not access
+    the particle data, other operations, MPI, or python, none of which are thread safe.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT AsyncAnalyzer : public Analyzer
+    {
+    public:
+        //! Particle data arrays that can be staged
+        enum fields
+            {
+            position = 1 << 0,
+            velocity = 1 << 1,
+            orientation = 1 << 2,
+            image = 1 << 3,
+            diameter = 1 << 4,
+            tag = 1 << 5
+            };
+
+        //! Constructs the analyzer
+        AsyncAnalyzer(std::shared_ptr<SystemDefinition> sysdef);
+
+        //! Destructor, waits for the outstanding analysis
+        virtual ~AsyncAnalyzer();
+
+        //! Stage the requested arrays and start the analysis on the worker thread
+        virtual void analyze(uint64_t timestep);
+
+        //! Wait for the outstanding analysis to complete
+        virtual void synchronize();
+
+        //! Wait for the outstanding analysis before the analyzer is detached
+        virtual void notifyDetach()
+            {
+            synchronize();
+            }
+
+        //! Set whether the analysis runs on a worker thread
+        /*! \param async When false, analyze() calls analyzeAsync() inline, which is useful for debugging
+        */
+        void setAsync(bool async)
+            {
+            synchronize();
+            m_async = async;
+            }
+
+        //! Get whether the analysis runs on a worker thread
+        bool getAsync()
+            {
+            return m_async;
+            }
+
+    protected:
+        //! Get the arrays to stage
+        /*! Derived classes return a combination of the fields flags
+        */
+        virtual unsigned int getRequestedFields()
+            {
+            return position;
+            }
+
+        //! Compute the result from a snapshot of the particle data
+        /*! \param data Snapshot of the requested arrays
+            This method runs on the worker thread.
+        */
+        virtual void analyzeAsync(const AsyncAnalyzerData& data) = 0;
+
+    private:
+        AsyncAnalyzerData m_staging[2];     //!< Staging buffers
+        std::future<void> m_task[2];        //!< Analysis reading each staging buffer
+        unsigned int m_cur_buffer = 0;      //!< Staging buffer to fill next
+        bool m_async = true;                //!< True if the analysis runs on a worker thread
+
+        //! Copy the requested arrays into a staging buffer
+        void stage(AsyncAnalyzerData& data, uint64_t timestep);
+
+        //! Wait for the analysis of a staging buffer
+        void wait(unsigned int buffer);
+    };
+
+//! Export the AsyncAnalyzer class to python
+void export_AsyncAnalyzer(pybind11::module& m);
+
+#endif
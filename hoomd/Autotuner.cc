@@ -2,11 +2,16 @@
 // This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
 #include "Autotuner.h"
+#include "AutotunerCache.h"
 
 #ifdef ENABLE_MPI
 #include "HOOMDMPI.h"
 #endif
 
+#ifdef ENABLE_NVTOOLS
+#include <nvToolsExt.h>
+#endif
+
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -32,8 +37,9 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
                      const std::string& name,
                      std::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name), m_parameters(parameters),
-      m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0),
-      m_exec_conf(exec_conf), m_mode(mode_median)
+      m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_current_candidate(0),
+      m_opt_element(0), m_sweep(0), m_exec_conf(exec_conf), m_mode(mode_median), m_cache_checked(false),
+      m_cached_time(0.0f), m_search(search_exhaustive)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << nsamples << " " << period << " " << name << endl;
 
@@ -55,7 +61,7 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
         m_samples[i].resize(m_nsamples);
         }
 
-    m_current_param = m_parameters[m_current_element];
+    beginInitialScan();
 
     // create CUDA events
     #ifdef ENABLE_HIP
@@ -87,7 +93,8 @@ Autotuner::Autotuner(unsigned int start,
                      std::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name),
       m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_current_param(0),
-      m_exec_conf(exec_conf), m_mode(mode_median)
+      m_current_candidate(0), m_opt_element(0), m_sweep(0), m_exec_conf(exec_conf), m_mode(mode_median),
+      m_cache_checked(false), m_cached_time(0.0f), m_search(search_exhaustive)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << " " << start << " " << end << " " << step << " "
                                 << nsamples << " " << period << " " << name << endl;
@@ -119,7 +126,7 @@ Autotuner::Autotuner(unsigned int start,
         m_samples[i].resize(m_nsamples);
         }
 
-    m_current_param = m_parameters[m_current_element];
+    beginInitialScan();
 
     // create CUDA events
     #ifdef ENABLE_HIP
@@ -143,13 +150,21 @@ Autotuner::~Autotuner()
 
 void Autotuner::begin()
     {
+    #ifdef ENABLE_NVTOOLS
+    // mark every tuned kernel, also when tuning is disabled
+    nvtxRangePush(m_name.c_str());
+    #endif
+
     // skip if disabled
     if (!m_enabled)
         return;
 
+    if (!m_cache_checked)
+        loadFromCache();
+
     #ifdef ENABLE_HIP
     // if we are scanning, record a cuda event - otherwise do nothing
-    if (m_state == STARTUP || m_state == SCANNING)
+    if (m_state == STARTUP || m_state == SCANNING || m_state == VERIFYING)
         {
         hipEventRecord(m_start, 0);
         if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
@@ -160,13 +175,17 @@ void Autotuner::begin()
 
 void Autotuner::end()
     {
+    #ifdef ENABLE_NVTOOLS
+    nvtxRangePop();
+    #endif
+
     // skip if disabled
     if (!m_enabled)
         return;
 
     #ifdef ENABLE_HIP
     // handle timing updates if scanning
-    if (m_state == STARTUP || m_state == SCANNING)
+    if (m_state == STARTUP || m_state == SCANNING || m_state == VERIFYING)
         {
         hipEventRecord(m_stop, 0);
         hipEventSynchronize(m_stop);
@@ -189,18 +208,23 @@ void Autotuner::end()
         if (m_current_sample >= m_nsamples)
             {
             m_current_sample = 0;
-            m_current_element++;
+            m_measured[m_current_element] = true;
+            m_current_candidate++;
 
-            // if we hit the end of the elements, transition to the IDLE state and compute the optimal parameter
-            if (m_current_element >= m_parameters.size())
+            // if we hit the end of the candidates, continue with the next sweep of the search, or transition to the
+            // IDLE state and compute the optimal parameter
+            if (m_current_candidate >= m_candidates.size())
                 {
-                m_current_element = 0;
-                m_state = IDLE;
-                m_current_param = computeOptimalParameter();
+                if (!nextSweep())
+                    {
+                    m_state = IDLE;
+                    m_current_param = computeOptimalParameter();
+                    }
                 }
             else
                 {
                 // if moving on to the next element, update the cached parameter to set
+                m_current_element = m_candidates[m_current_candidate];
                 m_current_param = m_parameters[m_current_element];
                 }
             }
@@ -208,13 +232,12 @@ void Autotuner::end()
     else if (m_state == SCANNING)
         {
         // move on to the next element
-        m_current_element++;
+        m_current_candidate++;
 
-        // if we hit the end of the elements, transition to the IDLE state and compute the optimal parameter, and move
-        // on to the next sample for next time
-        if (m_current_element >= m_parameters.size())
+        // if we hit the end of the candidates, transition to the IDLE state and compute the optimal parameter, and
+        // move on to the next sample for next time
+        if (m_current_candidate >= m_candidates.size())
             {
-            m_current_element = 0;
             m_state = IDLE;
             m_current_param = computeOptimalParameter();
             m_current_sample = (m_current_sample + 1) % m_nsamples;
@@ -222,9 +245,44 @@ void Autotuner::end()
         else
             {
             // if moving on to the next element, update the cached parameter to set
+            m_current_element = m_candidates[m_current_candidate];
             m_current_param = m_parameters[m_current_element];
             }
         }
+    else if (m_state == VERIFYING)
+        {
+        m_current_sample++;
+
+        // once all samples of the cached parameter are taken, compare with the cached time
+        if (m_current_sample >= m_nsamples)
+            {
+            m_current_sample = 0;
+
+            std::vector<float> v = m_samples[m_current_element];
+            size_t n = v.size() / 2;
+            nth_element(v.begin(), v.begin()+n, v.end());
+            int retune = v[n] > 1.2f * m_cached_time;
+
+            #ifdef ENABLE_MPI
+            // all ranks must agree, synchronized scans are collective
+            if (m_sync)
+                MPI_Allreduce(MPI_IN_PLACE, &retune, 1, MPI_INT, MPI_LOR, m_exec_conf->getMPICommunicator());
+            #endif
+
+            if (retune)
+                {
+                m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " - cached parameter is slower than "
+                                            << "before, beginning scan" << std::endl;
+                m_state = STARTUP;
+                beginInitialScan();
+                }
+            else
+                {
+                m_opt_element = m_current_element;
+                m_state = IDLE;
+                }
+            }
+        }
     else if (m_state == IDLE)
         {
         // increment the calls counter and see if we should transition to the scanning state
@@ -236,7 +294,7 @@ void Autotuner::end()
             m_calls = 0;
 
             // initialize a scan
-            m_current_param = m_parameters[m_current_element];
+            beginPeriodicScan();
             m_state = SCANNING;
             m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " - beginning scan" << std::endl;
             }
@@ -245,111 +303,252 @@ void Autotuner::end()
 
 /*! \returns The optimal parameter given the current data in m_samples
 
-    computeOptimalParameter computes the median time among all samples for a given element. It then chooses the
-    fastest time (with the lowest index breaking a tie) and returns the parameter that resulted in that time.
+    computeOptimalParameter chooses the element with the fastest time (see computeOptimalElement()), stores it in the
+    autotuner cache, and returns its parameter.
 */
 unsigned int Autotuner::computeOptimalParameter()
     {
-    bool is_root = true;
+    m_opt_element = computeOptimalElement();
+    unsigned int opt = m_parameters[m_opt_element];
+
+    // print stats
+    m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " found optimal parameter " << opt << endl;
 
+    bool is_root = true;
     #ifdef ENABLE_MPI
-    unsigned int nranks = 0;
     if (m_sync)
-        {
-        nranks = m_exec_conf->getNRanks();
         is_root = !m_exec_conf->getRank();
-        }
     #endif
 
+    AutotunerCache *cache = m_exec_conf->getAutotunerCache();
+    if (cache && is_root)
+        cache->store(m_name, opt, m_sample_median[m_opt_element]);
+
+    return opt;
+    }
+
+/*! \returns The index of the element with the fastest time
+
+    computeOptimalElement computes the median (or average, or maximum) time among all samples for a given element.
+    With synchronization, the times are reduced to their maximum over all ranks, so that every rank makes the same
+    choice. It then chooses the fastest time (with the lowest index breaking a tie).
+*/
+unsigned int Autotuner::computeOptimalElement()
+    {
     // start by computing the median for each element
     std::vector<float> v;
     for (unsigned int i = 0; i < m_parameters.size(); i++)
         {
         v = m_samples[i];
-        #ifdef ENABLE_MPI
-        if (m_sync && nranks)
+        if (m_mode == mode_avg)
             {
-            // combine samples from all ranks on rank zero
-            std::vector< std::vector<float> > all_v;
-            MPI_Barrier(m_exec_conf->getMPICommunicator());
-            gather_v(v, all_v, 0, m_exec_conf->getMPICommunicator());
-            if (is_root)
-                {
-                v.clear();
-                assert(all_v.size() == nranks);
-                for (unsigned int j = 0; j < nranks; ++j)
-                    v.insert(v.end(), all_v[j].begin(), all_v[j].end());
-                }
+            // compute average
+            float sum = 0.0f;
+            for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
+                sum += *it;
+            m_sample_median[i] = sum/float(v.size());
             }
-        #endif
-        if (is_root)
+        else if (m_mode == mode_max)
             {
-            if (m_mode == mode_avg)
+            // compute maximum
+            m_sample_median[i] = -FLT_MIN;
+            for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
                 {
-                // compute average
-                float sum = 0.0f;
-                for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
-                    sum += *it;
-                m_sample_median[i] = sum/float(v.size());
-                }
-            else if (m_mode == mode_max)
-                {
-                // compute maximum
-                m_sample_median[i] = -FLT_MIN;
-                for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
+                if (*it > m_sample_median[i])
                     {
-                    if (*it > m_sample_median[i])
-                        {
-                        m_sample_median[i] = *it;
-                        }
+                    m_sample_median[i] = *it;
                     }
                 }
-            else
-                {
-                // compute median
-                size_t n = v.size() / 2;
-                nth_element(v.begin(), v.begin()+n, v.end());
-                m_sample_median[i] = v[n];
-                }
+            }
+        else
+            {
+            // compute median
+            size_t n = v.size() / 2;
+            nth_element(v.begin(), v.begin()+n, v.end());
+            m_sample_median[i] = v[n];
             }
         }
 
-    unsigned int opt = 0;
-
-    if (is_root)
+    #ifdef ENABLE_MPI
+    // the slowest rank determines the time of a parameter in lockstep execution
+    if (m_sync && m_exec_conf->getNRanks() > 1)
         {
-        // now find the minimum and maximum times in the medians
-        float min = m_sample_median[0];
-        unsigned int min_idx = 0;
-        //float max = m_sample_median[0];
-        //unsigned int max_idx = 0;
+        MPI_Allreduce(MPI_IN_PLACE, &m_sample_median.front(), (int)m_sample_median.size(), MPI_FLOAT, MPI_MAX,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
 
-        for (unsigned int i = 1; i < m_parameters.size(); i++)
+    // now find the minimum time in the medians
+    float min = m_sample_median[0];
+    unsigned int min_idx = 0;
+
+    for (unsigned int i = 1; i < m_parameters.size(); i++)
+        {
+        if (m_sample_median[i] < min)
             {
-            if (m_sample_median[i] < min)
-                {
-                min = m_sample_median[i];
-                min_idx = i;
-                }
-            /*if (m_sample_median[i] > max)
-                {
-                max = m_sample_median[i];
-                max_idx = i;
-                }*/
+            min = m_sample_median[i];
+            min_idx = i;
             }
+        }
+
+    return min_idx;
+    }
+
+/*! With exhaustive search, all elements are candidates. With coordinate descent, the candidates are the elements on
+    the major axis through the first element, and elements that are never timed keep FLT_MAX samples.
+*/
+void Autotuner::beginInitialScan()
+    {
+    m_candidates.clear();
+    m_current_candidate = 0;
+    m_current_sample = 0;
+    m_sweep = 0;
+    m_measured.assign(m_parameters.size(), false);
+
+    if (m_search == search_coordinate_descent)
+        {
+        for (auto& samples : m_samples)
+            std::fill(samples.begin(), samples.end(), FLT_MAX);
+
+        appendLine(0, 0, false);
+        }
+    else
+        {
+        for (unsigned int i = 0; i < m_parameters.size(); i++)
+            m_candidates.push_back(i);
+        }
+
+    m_current_element = m_candidates[0];
+    m_current_param = m_parameters[m_current_element];
+    }
 
-        // get the optimal param
-        opt = m_parameters[min_idx];
-        // unsigned int percent = int(max/min * 100.0f)-100;
+/*! With coordinate descent, periodic scans time the elements on the lines along both axes through the optimum.
+*/
+void Autotuner::beginPeriodicScan()
+    {
+    m_candidates.clear();
+    m_current_candidate = 0;
 
-        // print stats
-        m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " found optimal parameter " << opt << endl;
+    if (m_search == search_coordinate_descent)
+        {
+        appendLine(m_opt_element, 0, false);
+        appendLine(m_opt_element, 1, false);
+        }
+    else
+        {
+        for (unsigned int i = 0; i < m_parameters.size(); i++)
+            m_candidates.push_back(i);
+        }
+
+    m_current_element = m_candidates[0];
+    m_current_param = m_parameters[m_current_element];
+    }
+
+/*! The next sweep runs along the other axis through the current optimum and skips elements that were already
+    timed. The search converges when a sweep leaves the optimum unchanged, or when the next line holds no new elements.
+*/
+bool Autotuner::nextSweep()
+    {
+    if (m_search != search_coordinate_descent)
+        return false;
+
+    unsigned int prev_opt = m_opt_element;
+    m_opt_element = computeOptimalElement();
+    m_sweep++;
+
+    if (m_sweep > 1 && m_opt_element == prev_opt)
+        return false;
+
+    m_candidates.clear();
+    m_current_candidate = 0;
+    appendLine(m_opt_element, m_sweep % 2, true);
+
+    if (m_candidates.empty())
+        return false;
+
+    m_exec_conf->msg->notice(6) << "Autotuner " << m_name << " - sweep " << m_sweep << " through "
+                                << m_parameters[m_opt_element] << endl;
+
+    m_current_element = m_candidates[0];
+    m_current_param = m_parameters[m_current_element];
+    return true;
+    }
+
+/*! \param element Element the line passes through
+    \param axis Axis the line runs along, 0 for major and 1 for minor
+    \param skip_measured If true, skip elements timed during the initial scan
+*/
+void Autotuner::appendLine(unsigned int element, unsigned int axis, bool skip_measured)
+    {
+    unsigned int other = 1 - axis;
+    unsigned int coordinate = paramCoordinate(m_parameters[element], other);
+
+    for (unsigned int i = 0; i < m_parameters.size(); i++)
+        {
+        if (paramCoordinate(m_parameters[i], other) != coordinate)
+            continue;
+        if (skip_measured && m_measured[i])
+            continue;
+        if (std::find(m_candidates.begin(), m_candidates.end(), i) != m_candidates.end())
+            continue;
+
+        m_candidates.push_back(i);
+        }
+    }
+
+/*! Looks up the tuner in the AutotunerCache of the execution configuration. On a hit, the tuner switches to the
+    VERIFYING state at the cached parameter. With synchronization enabled, rank 0 makes the decision for all ranks.
+*/
+void Autotuner::loadFromCache()
+    {
+    m_cache_checked = true;
+
+    // only start from the cache before the initial scan
+    if (m_state != STARTUP || m_current_candidate != 0 || m_current_sample != 0)
+        return;
+
+    AutotunerCache *cache = m_exec_conf->getAutotunerCache();
+    if (!cache)
+        return;
+
+    unsigned int param = 0;
+    float time = 0.0f;
+    bool found = cache->lookup(m_name, param, time);
+
+    // the parameter must still be valid for this tuner
+    unsigned int idx = 0;
+    if (found)
+        {
+        auto it = std::find(m_parameters.begin(), m_parameters.end(), param);
+        found = (it != m_parameters.end());
+        idx = (unsigned int)(it - m_parameters.begin());
         }
 
     #ifdef ENABLE_MPI
-    if (m_sync && nranks) bcast(opt, 0, m_exec_conf->getMPICommunicator());
+    if (m_sync)
+        {
+        bcast(found, 0, m_exec_conf->getMPICommunicator());
+        bcast(idx, 0, m_exec_conf->getMPICommunicator());
+        bcast(time, 0, m_exec_conf->getMPICommunicator());
+        }
     #endif
-    return opt;
+
+    if (!found)
+        return;
+
+    m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " starting from cached parameter "
+                                << m_parameters[idx] << endl;
+
+    for (unsigned int i = 0; i < m_parameters.size(); i++)
+        {
+        if (i != idx)
+            std::fill(m_samples[i].begin(), m_samples[i].end(), FLT_MAX);
+        }
+
+    m_cached_time = time;
+    m_current_element = idx;
+    m_current_param = m_parameters[idx];
+    m_state = VERIFYING;
     }
 
 void export_Autotuner(py::module& m)
@@ -32,6 +32,22 @@
     The sampling mode can also be changed to average or maximum. The latter is helpful when the distribution of kernel
     runtimes is bimodal, e.g. because it depends on input of variable size.
 
+    **Search strategies** <br>
+    By default, the initial scan times every parameter (search_exhaustive). Tuners of two-dimensional parameter spaces,
+    encoded as major*10000 + minor (e.g. block_size*10000 + threads_per_particle), can instead use coordinate descent
+    (search_coordinate_descent). The scan then times the line of parameters along the major axis through the first
+    parameter, then the line along the minor axis through the fastest parameter so far, and so on in alternating
+    directions, until a sweep leaves the optimum unchanged or finds no parameter that was not timed already. This takes
+    m_nsamples times the sum, rather than the product, of the axis lengths. Periodic scans time the two lines through
+    the current optimum. Parameters that were never timed are never chosen.
+
+    **MPI** <br>
+    With setSync(true), every rank computes the median (or average, or maximum) of its own samples, the ranks reduce
+    these times with MPI_MAX, and all ranks choose the parameter with the shortest maximum time. Ranks that run in
+    lockstep therefore use the same parameter, and it is the one that minimizes the time of the slowest rank. Every
+    decision of the coordinate descent is made from the reduced times, so all ranks time the same sequence of
+    parameters. All ranks must call begin() and end() the same number of times.
+
     The begin() and end() methods must be called before and after the kernel launch to be tuned. The value of the tuned
     parameter should be set to the return value of getParam(). begin() and end() drive the state machine to choose
     parameters and insert the cuda timing events (when needed).
@@ -44,15 +60,22 @@
 
     Each Autotuner instance has a string name to help identify it's output on the notice stream.
 
+    When the ExecutionConfiguration has an AutotunerCache, the first call to begin() looks up the optimal parameter
+    found by a previous run with the same name, device, version, and system size. Instead of the initial scan, the
+    tuner then times the cached parameter for one set of samples. It starts a full scan only when the kernel is more
+    than 20% slower than the cached time, and otherwise goes straight to the idle state. Every new optimum is stored in
+    the cache.
+
     Autotuner is not useful in non-GPU builds. Timing is performed with CUDA events and requires ENABLE_HIP=on.
     Behavior of Autotuner is undefined when ENABLE_HIP=off.
 
     ** Implementation ** <br>
     Internally, m_nsamples is the number of samples to take (odd for median computation). m_current_sample is the
     current sample being taken in a circular fashion, and m_current_element is the index of the current parameter being
-    sampled. m_samples stores the time of each sampled kernel launch, and m_sample_median stores the current median of
-    each set of samples. When idle, the number of calls is counted in m_calls. m_state lists the current state in the
-    state machine.
+    sampled. Scans walk through the elements listed in m_candidates. m_samples stores the time of each sampled kernel
+    launch, and m_sample_median stores the current median of each set of samples. When idle, the number of calls is
+    counted in m_calls. m_state lists the current state in the state machine. After a cache hit, the samples of all
+    other parameters are set to FLT_MAX, so periodic scans replace them one sample at a time before they can be chosen.
 */
 class PYBIND11_EXPORT Autotuner
     {
@@ -166,6 +189,24 @@ class PYBIND11_EXPORT Autotuner
             m_sync = sync;
             }
 
+        //! Enumeration of search strategies for the initial scan
+        enum search_Enum {
+            search_exhaustive = 0,      //!< Time all parameters
+            search_coordinate_descent   //!< Alternate between the axes of a major*10000 + minor parameter space
+            };
+
+        //! Set the search strategy
+        /*! \param search Search strategy
+
+            Must be called before the first call to begin(), it restarts the initial scan.
+         */
+        void setSearch(search_Enum search)
+            {
+            m_search = search;
+            if (m_state == STARTUP)
+                beginInitialScan();
+            }
+
         //!< Enumeration of different sampling modes
         enum mode_Enum {
             mode_median = 0, //!< Median
@@ -197,14 +238,42 @@ class PYBIND11_EXPORT Autotuner
             }
 
     protected:
+        //! Compute the optimal parameter, store it in the cache, and remember its element
         unsigned int computeOptimalParameter();
 
+        //! Find the element with the shortest time, reduced over all ranks when synchronizing
+        unsigned int computeOptimalElement();
+
+        //! Set up the candidates of the initial scan
+        void beginInitialScan();
+
+        //! Set up the candidates of a periodic scan
+        void beginPeriodicScan();
+
+        //! Set up the next coordinate descent sweep of the initial scan
+        /*! \returns false when the search has converged
+        */
+        bool nextSweep();
+
+        //! Append the elements on the line through an element along an axis to the candidates
+        void appendLine(unsigned int element, unsigned int axis, bool skip_measured);
+
+        //! Get the coordinate of a parameter along an axis of a major*10000 + minor parameter space
+        static unsigned int paramCoordinate(unsigned int param, unsigned int axis)
+            {
+            return axis == 0 ? param / 10000 : param % 10000;
+            }
+
+        //! Start from the cached optimal parameter, if there is one
+        void loadFromCache();
+
         //! State names
         enum State
            {
            STARTUP,
            IDLE,
-           SCANNING
+           SCANNING,
+           VERIFYING
            };
 
         // parameters
@@ -220,6 +289,11 @@ class PYBIND11_EXPORT Autotuner
         unsigned int m_current_element; //!< Index of current parameter sampled
         unsigned int m_calls;           //!< Count of the number of calls since the last sample
         unsigned int m_current_param;   //!< Value of the current parameter
+        unsigned int m_current_candidate; //!< Index of the current element in m_candidates
+        std::vector<unsigned int> m_candidates; //!< Elements to time in the current scan
+        std::vector<bool> m_measured;   //!< True for elements timed during the initial scan
+        unsigned int m_opt_element;     //!< Element of the optimal parameter
+        unsigned int m_sweep;           //!< Number of completed coordinate descent sweeps
 
         std::vector< std::vector< float > > m_samples;  //!< Raw sample data for each element
         std::vector< float > m_sample_median;           //!< Current sample median for each element
@@ -232,7 +306,10 @@ class PYBIND11_EXPORT Autotuner
         #endif
 
         bool m_sync;              //!< If true, synchronize results via MPI
+        bool m_cache_checked;     //!< True after the cache has been looked up
+        float m_cached_time;      //!< Kernel time of the cached parameter
         mode_Enum m_mode;         //!< The sampling mode
+        search_Enum m_search;     //!< The search strategy
     };
 
 //! Export the Autotuner class to python
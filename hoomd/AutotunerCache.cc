@@ -0,0 +1,117 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "AutotunerCache.h"
+#include "HOOMDVersion.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+/*! \file AutotunerCache.cc
+    \brief Definition of AutotunerCache
+*/
+
+/*! \param filename File to read and (when \a write is true) update
+    \param device Description of the device model, used in the keys
+    \param write Set to true on the one rank that updates the file
+
+    A missing file is not an error, it is created when the first optimum is stored. Lines that cannot be parsed are
+    skipped.
+*/
+AutotunerCache::AutotunerCache(const std::string& filename, const std::string& device, bool write)
+    : m_filename(filename), m_device(device), m_write(write), m_size_bucket(0)
+    {
+    ifstream f(filename.c_str());
+    string line;
+    while (getline(f, line))
+        {
+        // the key is everything up to the last two fields
+        size_t time_pos = line.rfind('\t');
+        if (time_pos == string::npos || time_pos == 0)
+            continue;
+        size_t param_pos = line.rfind('\t', time_pos - 1);
+        if (param_pos == string::npos)
+            continue;
+
+        Entry entry;
+        istringstream param_str(line.substr(param_pos + 1, time_pos - param_pos - 1));
+        istringstream time_str(line.substr(time_pos + 1));
+        if (!(param_str >> entry.param) || !(time_str >> entry.time))
+            continue;
+
+        m_entries[line.substr(0, param_pos)] = entry;
+        }
+    }
+
+/*! \param N Global number of particles
+*/
+void AutotunerCache::setSizeHint(unsigned int N)
+    {
+    unsigned int bucket = 0;
+    while (N >>= 1)
+        bucket++;
+    m_size_bucket = bucket;
+    }
+
+std::string AutotunerCache::makeKey(const std::string& name) const
+    {
+    ostringstream s;
+    s << name << '\t' << m_device << '\t' << HOOMD_VERSION << '\t' << m_size_bucket;
+    return s.str();
+    }
+
+/*! \param name Autotuner name
+    \param param [out] Cached optimal parameter
+    \param time [out] Cached kernel time at the optimal parameter
+    \returns true when an entry exists
+*/
+bool AutotunerCache::lookup(const std::string& name, unsigned int& param, float& time) const
+    {
+    auto it = m_entries.find(makeKey(name));
+    if (it == m_entries.end())
+        return false;
+
+    param = it->second.param;
+    time = it->second.time;
+    return true;
+    }
+
+/*! \param name Autotuner name
+    \param param Optimal parameter
+    \param time Kernel time at the optimal parameter
+
+    The file is only rewritten when the optimal parameter changes, so periodic rescans that confirm the optimum do not
+    touch the file system.
+*/
+void AutotunerCache::store(const std::string& name, unsigned int param, float time)
+    {
+    std::string key = makeKey(name);
+    auto it = m_entries.find(key);
+    bool changed = (it == m_entries.end() || it->second.param != param);
+
+    Entry entry;
+    entry.param = param;
+    entry.time = time;
+    m_entries[key] = entry;
+
+    if (changed && m_write)
+        write();
+    }
+
+void AutotunerCache::write()
+    {
+    // write to a temporary file and rename it so that concurrent jobs never read a partial file
+    std::string tmp_filename = m_filename + ".tmp";
+        {
+        ofstream f(tmp_filename.c_str());
+        if (!f.good())
+            return;
+
+        for (auto const& it : m_entries)
+            f << it.first << '\t' << it.second.param << '\t' << it.second.time << '\n';
+        }
+    std::rename(tmp_filename.c_str(), m_filename.c_str());
+    }
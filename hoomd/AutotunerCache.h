@@ -0,0 +1,72 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _AUTOTUNER_CACHE_H_
+#define _AUTOTUNER_CACHE_H_
+
+/*! \file AutotunerCache.h
+    \brief Declaration of AutotunerCache
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <map>
+#include <string>
+
+//! Stores optimal autotuner parameters in a file so that later runs can skip the initial scan
+/*! Entries are keyed by the autotuner name, the device model, the HOOMD version, and a system size bucket
+    (floor(log2(N)) of the global number of particles). Together these identify when a previously determined optimum
+    is likely to still be valid. Entries for other keys that are present in the file are kept when it is rewritten,
+    so one file can be shared between jobs on different devices and system sizes.
+
+    The file is plain text with one tab separated entry per line: name, device, version, size bucket, parameter, and
+    the kernel time in milliseconds. It is rewritten (through a temporary file and a rename) whenever an optimum
+    changes.
+
+    Autotuner looks up its entry on the first call to begin(). See Autotuner for how cached entries are verified.
+*/
+class AutotunerCache
+    {
+    public:
+        //! Load the cache
+        AutotunerCache(const std::string& filename, const std::string& device, bool write);
+
+        //! Get the file name
+        const std::string& getFilename() const
+            {
+            return m_filename;
+            }
+
+        //! Set the number of particles in the system
+        void setSizeHint(unsigned int N);
+
+        //! Look up the cached parameter for a tuner
+        bool lookup(const std::string& name, unsigned int& param, float& time) const;
+
+        //! Store the optimal parameter for a tuner
+        void store(const std::string& name, unsigned int param, float time);
+
+    private:
+        //! Cached parameter and kernel time
+        struct Entry
+            {
+            unsigned int param; //!< Optimal parameter
+            float time;         //!< Kernel time at the optimal parameter (ms)
+            };
+
+        std::string m_filename;                 //!< File to read and write
+        std::string m_device;                   //!< Device model
+        bool m_write;                           //!< True when this rank writes the file
+        unsigned int m_size_bucket;             //!< Current system size bucket
+        std::map<std::string, Entry> m_entries; //!< Entries by key
+
+        //! Build the key for a tuner
+        std::string makeKey(const std::string& name) const;
+
+        //! Write all entries to the file
+        void write();
+    };
+
+#endif // _AUTOTUNER_CACHE_H_
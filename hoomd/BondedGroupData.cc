@@ -14,6 +14,8 @@
 
 #include <pybind11/numpy.h>
 
+#include <algorithm>
+
 #ifdef ENABLE_HIP
 #include "BondedGroupData.cuh"
 #include "CachedAllocator.h"
@@ -146,15 +148,20 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
     m_group_rtag.swap(group_rtag);
 
     // Lookup by particle index table
-    GPUVector<members_t> gpu_table(m_exec_conf);
+    GlobalVector<members_t> gpu_table(m_exec_conf);
     m_gpu_table.swap(gpu_table);
 
-    GPUVector<unsigned int> gpu_pos_table(m_exec_conf);
+    GlobalVector<unsigned int> gpu_pos_table(m_exec_conf);
     m_gpu_pos_table.swap(gpu_pos_table);
 
-    GPUVector<unsigned int> n_groups(m_exec_conf);
+    GlobalVector<unsigned int> n_groups(m_exec_conf);
     m_gpu_n_groups.swap(n_groups);
 
+    GlobalVector<unsigned int> gpu_table_offsets(m_exec_conf);
+    m_gpu_table_offsets.swap(gpu_table_offsets);
+    m_gpu_table_csr = false;
+    m_gpu_max_n_groups = 0;
+
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
@@ -627,6 +634,67 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::removeBondedGro
     notifyGroupReorder();
     }
 
+/*! \param n Number of replicas of the system
+    \param old_n_particles Number of particles before ParticleData::replicate()
+
+    Copy j of the group with tag t has the tag j*N_groups + t and the members with tags shifted by j*old_n_particles,
+    as in Snapshot::replicate(). Each rank replicates only its local groups, whose copies have their members on the
+    same ranks as the original group, so the groups stay consistent with the replicated particle data.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::replicate(unsigned int n,
+    unsigned int old_n_particles)
+    {
+    if (m_recycled_tags.size())
+        {
+        m_exec_conf->msg->error() << "State.replicate: cannot replicate a system with removed " << name << "s" << endl;
+        throw runtime_error(std::string("Error replicating ") + name);
+        }
+
+    // we are changing the local number of groups, so remove ghosts
+    removeAllGhostGroups();
+
+    const unsigned int old_nglobal = m_nglobal;
+    const unsigned int old_n_groups = m_n_groups;
+
+    m_group_rtag.resize(n*old_nglobal);
+    for (unsigned int tag = old_nglobal; tag < n*old_nglobal; ++tag)
+        m_group_rtag[tag] = GROUP_NOT_LOCAL;
+
+    for (unsigned int j = 1; j < n; ++j)
+        {
+        for (unsigned int group_idx = 0; group_idx < old_n_groups; ++group_idx)
+            {
+            members_t g = m_groups[group_idx];
+            for (unsigned int k = 0; k < group_size; ++k)
+                g.tag[k] += j*old_n_particles;
+
+            unsigned int tag = j*old_nglobal + m_group_tag[group_idx];
+            m_group_rtag[tag] = getN();
+            m_groups.push_back(g);
+            m_group_typeval.push_back((typeval_t) m_group_typeval[group_idx]);
+            m_group_tag.push_back(tag);
+            #ifdef ENABLE_MPI
+            if (m_pdata->getDomainDecomposition())
+                m_group_ranks.push_back((ranks_t) m_group_ranks[group_idx]);
+            #endif
+
+            m_n_groups++;
+            }
+        }
+
+    // add to set of active tags
+    for (unsigned int tag = old_nglobal; tag < n*old_nglobal; ++tag)
+        m_tag_set.insert(m_tag_set.end(), tag);
+    m_invalid_cached_tags = true;
+
+    m_nglobal = n*old_nglobal;
+
+    // notify observers
+    m_group_num_change_signal.emit();
+    notifyGroupReorder();
+    }
+
 /*! \param name Type name
  */
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
@@ -698,6 +766,100 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::maybe_rebuild_t
     m_invalid_cached_tags = false;
     }
 
+/*! The local groups are ordered by the smallest particle index among their members, so that after a particle sort
+    consecutive groups access nearby particles in memory. Groups with equal keys keep their relative order. Ghost
+    groups are left at the end of the table. If the groups are already in order, nothing is changed and no reorder
+    signal is emitted.
+ */
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::sortGroups()
+    {
+    if (m_n_groups == 0)
+        return;
+
+    if (m_prof) m_prof->push("sort " + std::string(name) + "s");
+
+    // sort key (smallest member index), group index
+    std::vector< std::pair<unsigned int, unsigned int> > order(m_n_groups);
+    bool sorted = true;
+        {
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+
+        for (unsigned int group_idx = 0; group_idx < m_n_groups; ++group_idx)
+            {
+            // members that are not local sort last
+            unsigned int key = NOT_LOCAL;
+            for (unsigned int i = 0; i < group_size; ++i)
+                key = std::min(key, h_rtag.data[h_groups.data[group_idx].tag[i]]);
+
+            order[group_idx] = std::make_pair(key, group_idx);
+            if (group_idx > 0 && key < order[group_idx-1].first)
+                sorted = false;
+            }
+        }
+
+    if (sorted)
+        {
+        if (m_prof) m_prof->pop();
+        return;
+        }
+
+    std::sort(order.begin(), order.end());
+
+    // permute the group data into the alternate arrays
+        {
+        ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+        ArrayHandle<typeval_t> h_group_typeval(m_group_typeval, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_group_tag(m_group_tag, access_location::host, access_mode::read);
+
+        ArrayHandle<members_t> h_groups_alt(getAltMembersArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<typeval_t> h_group_typeval_alt(getAltTypeValArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_tag_alt(getAltTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_rtag(m_group_rtag, access_location::host, access_mode::readwrite);
+
+        const unsigned int n_tot = m_n_groups + m_n_ghost;
+        for (unsigned int group_idx = 0; group_idx < n_tot; ++group_idx)
+            {
+            const unsigned int old_idx = (group_idx < m_n_groups) ? order[group_idx].second : group_idx;
+            h_groups_alt.data[group_idx] = h_groups.data[old_idx];
+            h_group_typeval_alt.data[group_idx] = h_group_typeval.data[old_idx];
+            h_group_tag_alt.data[group_idx] = h_group_tag.data[old_idx];
+            h_group_rtag.data[h_group_tag.data[old_idx]] = group_idx;
+            }
+        }
+
+    swapMemberArrays();
+    swapTypeArrays();
+    swapTagArrays();
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+            {
+            ArrayHandle<ranks_t> h_group_ranks(m_group_ranks, access_location::host, access_mode::read);
+            ArrayHandle<ranks_t> h_group_ranks_alt(getAltRanksArray(), access_location::host,
+                access_mode::overwrite);
+
+            const unsigned int n_tot = m_n_groups + m_n_ghost;
+            for (unsigned int group_idx = 0; group_idx < n_tot; ++group_idx)
+                {
+                const unsigned int old_idx = (group_idx < m_n_groups) ? order[group_idx].second : group_idx;
+                h_group_ranks_alt.data[group_idx] = h_group_ranks.data[old_idx];
+                }
+            }
+
+        swapRankArrays();
+        }
+    #endif
+
+    // the GPU table is rebuilt on next access
+    notifyGroupReorder();
+
+    if (m_prof) m_prof->pop();
+    }
+
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable()
     {
@@ -756,13 +918,35 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                     num_groups_max = h_n_groups.data[i];
             }
 
-        // resize lookup table
-        m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), num_groups_max);
+        // choose the layout and resize lookup table
+        const unsigned int nptl = m_pdata->getN()+m_pdata->getNGhosts();
+        const unsigned int n_entries = group_size*ngroups_tot;
+        m_gpu_max_n_groups = num_groups_max;
+        m_gpu_table_csr = useCSRLayout(num_groups_max, nptl, n_entries);
+        if (m_gpu_table_csr)
+            m_gpu_table_indexer = Index2D(1, n_entries);
+        else
+            m_gpu_table_indexer = Index2D(nptl, num_groups_max);
         m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
         m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
+        m_gpu_table_offsets.resize(nptl);
+
+            {
+            ArrayHandle<unsigned int> h_n_groups(m_gpu_n_groups, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_offsets(m_gpu_table_offsets, access_location::host, access_mode::overwrite);
+
+            // the particles follow each other in the CSR layout, and each has its own column in the padded layout
+            unsigned int offset = 0;
+            for (unsigned int i = 0; i < nptl; ++i)
+                {
+                h_offsets.data[i] = m_gpu_table_csr ? offset : i;
+                offset += h_n_groups.data[i];
+                }
+            }
 
             {
             ArrayHandle<unsigned int> h_n_groups(m_gpu_n_groups, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_offsets(m_gpu_table_offsets, access_location::host, access_mode::read);
             ArrayHandle<members_t> h_gpu_table(m_gpu_table, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_gpu_pos_table(m_gpu_pos_table, access_location::host, access_mode::overwrite);
 
@@ -809,27 +993,134 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                         h.idx[n++] = idx2;
                         }
 
-                    h_gpu_table.data[m_gpu_table_indexer(idx1, num)] = h;
-                    h_gpu_pos_table.data[m_gpu_table_indexer(idx1, num)] = gpos;
+                    h_gpu_table.data[m_gpu_table_indexer(h_offsets.data[idx1], num)] = h;
+                    h_gpu_pos_table.data[m_gpu_table_indexer(h_offsets.data[idx1], num)] = gpos;
                     }
                 }
             }
 
         if (m_prof) m_prof->pop();
         }
+
+    updateGPUAdvice();
+    }
+
+/*! The table columns of the particles in each GPU's range of the particle partition are placed on that GPU, as are
+    its entries of the group counts, so that the bonded force kernels read the table from local memory. In the CSR
+    layout, the entries of the particles in a range are contiguous. All GPUs may access the whole table because the
+    bonded partners of a particle can be owned by another GPU.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::updateGPUAdvice()
+    {
+    #if defined(ENABLE_HIP) && defined(__HIP_PLATFORM_NVCC__)
+    if (m_exec_conf->isCUDAEnabled() && m_exec_conf->allConcurrentManagedAccess()
+        && m_gpu_table_indexer.getNumElements())
+        {
+        auto gpu_map = m_exec_conf->getGPUIds();
+        const GPUPartition& gpu_partition = m_pdata->getGPUPartition();
+        const unsigned int pitch = m_gpu_table_indexer.getW();
+
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            {
+            auto range = gpu_partition.getRange(idev);
+            unsigned int nelem = range.second - range.first;
+
+            if (!nelem)
+                continue;
+
+            cudaMemAdvise(m_gpu_n_groups.get()+range.first, sizeof(unsigned int)*nelem,
+                cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+            cudaMemAdvise(m_gpu_table_offsets.get()+range.first, sizeof(unsigned int)*nelem,
+                cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+
+            if (m_gpu_table_csr)
+                {
+                ArrayHandle<unsigned int> h_offsets(m_gpu_table_offsets, access_location::host, access_mode::read);
+                unsigned int begin = h_offsets.data[range.first];
+                unsigned int end = range.second < m_gpu_table_offsets.size() ? h_offsets.data[range.second]
+                                                                             : m_gpu_table_indexer.getNumElements();
+                if (end > begin)
+                    {
+                    cudaMemAdvise(m_gpu_table.get()+begin, sizeof(members_t)*(end-begin),
+                        cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+                    cudaMemAdvise(m_gpu_pos_table.get()+begin, sizeof(unsigned int)*(end-begin),
+                        cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+                    }
+                continue;
+                }
+
+            for (unsigned int i = 0; i < m_gpu_table_indexer.getH(); ++i)
+                {
+                cudaMemAdvise(m_gpu_table.get()+i*pitch+range.first, sizeof(members_t)*nelem,
+                    cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+                cudaMemAdvise(m_gpu_pos_table.get()+i*pitch+range.first, sizeof(unsigned int)*nelem,
+                    cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+                }
+            }
+
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            {
+            cudaMemAdvise(m_gpu_n_groups.get(), sizeof(unsigned int)*m_gpu_n_groups.getNumElements(),
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_gpu_table_offsets.get(), sizeof(unsigned int)*m_gpu_table_offsets.getNumElements(),
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_gpu_table.get(), sizeof(members_t)*m_gpu_table.getNumElements(),
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_gpu_pos_table.get(), sizeof(unsigned int)*m_gpu_pos_table.getNumElements(),
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            }
+        CHECK_CUDA_ERROR();
+        }
+    #endif
     }
 
 #ifdef ENABLE_HIP
+/*! The layout of the last rebuild is tried first. The padded table is switched to the CSR layout when it turns out
+    less than half full, and the CSR table back to the padded layout when the padded table would fill up again.
+*/
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTableGPU()
     {
     if (m_prof) m_prof->push(m_exec_conf, "update " + std::string(name) + " table");
 
-    // resize groups counter
-    m_gpu_n_groups.resize(m_pdata->getN()+m_pdata->getNGhosts());
+    const unsigned int nptl = m_pdata->getN()+m_pdata->getNGhosts();
+    const unsigned int n_entries = group_size*(getN() + getNGhosts());
+
+    // resize groups counter and offsets
+    m_gpu_n_groups.resize(nptl);
+    m_gpu_table_offsets.resize(nptl);
+
+    if (!m_gpu_table_csr)
+        {
+        rebuildPaddedGPUTableGPU();
+
+        if (useCSRLayout(m_gpu_max_n_groups, nptl, n_entries))
+            {
+            m_gpu_table_csr = true;
+            rebuildCSRGPUTableGPU();
+            }
+        }
+    else
+        {
+        unsigned int max_n_groups = rebuildCSRGPUTableGPU();
+
+        if (!useCSRLayout(max_n_groups, nptl, n_entries))
+            {
+            m_gpu_table_csr = false;
+            m_gpu_max_n_groups = max_n_groups;
+            rebuildPaddedGPUTableGPU();
+            }
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
 
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildPaddedGPUTableGPU()
+    {
     // resize GPU table to current number of particles
-    m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), m_gpu_table_indexer.getH());
+    m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), m_gpu_max_n_groups);
     m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
     m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
 
@@ -843,6 +1134,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
             ArrayHandle<typeval_t> d_group_typeval(m_group_typeval, access_location::device, access_mode::read);
             ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
             ArrayHandle<unsigned int> d_n_groups(m_gpu_n_groups, access_location::device, access_mode::overwrite);
+            ArrayHandle<unsigned int> d_gpu_table_offsets(m_gpu_table_offsets, access_location::device, access_mode::overwrite);
             ArrayHandle<members_t> d_gpu_table(m_gpu_table, access_location::device, access_mode::overwrite);
             ArrayHandle<unsigned int> d_gpu_pos_table(m_gpu_pos_table, access_location::device, access_mode::overwrite);
             ArrayHandle<unsigned int> d_condition(m_condition, access_location::device, access_mode::readwrite);
@@ -869,6 +1161,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 flag,
                 d_gpu_table.data,
                 d_gpu_pos_table.data,
+                d_gpu_table_offsets.data,
                 m_gpu_table_indexer.getW(),
                 d_scratch_g.data,
                 d_scratch_idx.data,
@@ -878,25 +1171,13 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
             }
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
 
-        if (flag >= m_next_flag+1)
-            {
-            // incomplete group detected
-            unsigned int group_idx = flag - m_next_flag - 1;
-            members_t g = m_groups[group_idx];
-
-            std::ostringstream oss;
-            oss << name << ".*: " << name << " ";
-            for (unsigned int k = 0; k < group_size; ++k)
-                oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
-            oss << "incomplete!" << std::endl;
-            m_exec_conf->msg->error() << oss.str();
-            throw std::runtime_error("Error building GPU group table.");
-            }
+        checkGPUTableCondition(flag);
 
         if (flag == m_next_flag)
             {
             // grow array by incrementing groups per particle
-            m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), m_gpu_table_indexer.getH()+1);
+            m_gpu_max_n_groups++;
+            m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), m_gpu_max_n_groups);
             m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
             m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
             m_next_flag++;
@@ -904,8 +1185,86 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
         else
             done = true;
         }
+    }
+
+/*! \returns The maximum number of groups of a particle
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildCSRGPUTableGPU()
+    {
+    // one entry per group member
+    m_gpu_table_indexer = Index2D(1, group_size*(getN() + getNGhosts()));
+    m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
+    m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
+
+    unsigned int flag = 0;
+    unsigned int max_n_groups = 0;
+
+        {
+        ArrayHandle<members_t> d_groups(m_groups, access_location::device, access_mode::read);
+        ArrayHandle<typeval_t> d_group_typeval(m_group_typeval, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_n_groups(m_gpu_n_groups, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_gpu_table_offsets(m_gpu_table_offsets, access_location::device, access_mode::overwrite);
+        ArrayHandle<members_t> d_gpu_table(m_gpu_table, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_gpu_pos_table(m_gpu_pos_table, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_condition(m_condition, access_location::device, access_mode::readwrite);
+
+        // allocate scratch buffers
+        CachedAllocator& alloc = m_exec_conf->getCachedAllocator();
+        size_t tmp_size = m_groups.size()*group_size;
+        ScopedAllocation<unsigned int> d_scratch_g(alloc, tmp_size);
+        ScopedAllocation<unsigned int> d_scratch_idx(alloc, tmp_size);
+        ScopedAllocation<unsigned int> d_offsets(alloc, tmp_size);
+
+        gpu_update_group_table_csr<group_size, members_t>(
+            getN() + getNGhosts(),
+            m_pdata->getN()+m_pdata->getNGhosts(),
+            d_groups.data,
+            d_group_typeval.data,
+            d_rtag.data,
+            d_n_groups.data,
+            max_n_groups,
+            d_condition.data,
+            m_next_flag,
+            flag,
+            d_gpu_table.data,
+            d_gpu_pos_table.data,
+            d_gpu_table_offsets.data,
+            d_scratch_g.data,
+            d_scratch_idx.data,
+            d_offsets.data,
+            has_type_mapping,
+            alloc);
+        }
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
 
-    if (m_prof) m_prof->pop(m_exec_conf);
+    checkGPUTableCondition(flag);
+
+    return max_n_groups;
+    }
+
+/*! \param flag Condition flag returned by the GPU table update
+
+    Throws an error if a group with a member that is not local was detected.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::checkGPUTableCondition(unsigned int flag)
+    {
+    if (flag >= m_next_flag+1)
+        {
+        // incomplete group detected
+        unsigned int group_idx = flag - m_next_flag - 1;
+        members_t g = m_groups[group_idx];
+
+        std::ostringstream oss;
+        oss << name << ".*: " << name << " ";
+        for (unsigned int k = 0; k < group_size; ++k)
+            oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
+        oss << "incomplete!" << std::endl;
+        m_exec_conf->msg->error() << oss.str();
+        throw std::runtime_error("Error building GPU group table.");
+        }
     }
 #endif
 
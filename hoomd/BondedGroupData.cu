@@ -13,6 +13,10 @@
 #include <thrust/sort.h>
 #include <thrust/device_ptr.h>
 #include <thrust/execution_policy.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/sequence.h>
 #pragma GCC diagnostic pop
 
 /*! \file BondedGroupData.cu
@@ -72,6 +76,7 @@ __global__ void gpu_group_scatter_kernel(
     const unsigned int *d_rtag,
     group_t *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
+    const unsigned int *d_pidx_group_offsets,
     unsigned int pidx_group_table_pitch,
     bool has_type_mapping
     )
@@ -81,7 +86,7 @@ __global__ void gpu_group_scatter_kernel(
     if (i >= n_scratch) return;
 
     unsigned int pidx = d_scratch_idx[i];
-    unsigned int offset = d_offset[i]*pidx_group_table_pitch + pidx;
+    unsigned int offset = d_offset[i]*pidx_group_table_pitch + d_pidx_group_offsets[pidx];
 
     // load group
     unsigned int group_idx = d_scratch_g[i];
@@ -123,6 +128,70 @@ __global__ void gpu_group_scatter_kernel(
     d_pidx_gpos_table[offset] = gpos;
     }
 
+//! Sort the expanded group list by particle index and scatter the groups into the table
+/*! The entry of the i-th group of particle pidx is at d_pidx_group_offsets[pidx] + i*pidx_group_table_pitch.
+*/
+template<unsigned int group_size, typename group_t>
+static void gpu_fill_group_table(
+    const unsigned int n_groups,
+    const group_t* d_group_table,
+    const typeval_union *d_group_typeval,
+    const unsigned int *d_rtag,
+    group_t *d_pidx_group_table,
+    unsigned int *d_pidx_gpos_table,
+    const unsigned int *d_pidx_group_offsets,
+    const unsigned int pidx_group_table_pitch,
+    unsigned int *d_scratch_g,
+    unsigned int *d_scratch_idx,
+    unsigned int *d_offsets,
+    bool has_type_mapping,
+    CachedAllocator& alloc
+    )
+    {
+    // sort groups by particle idx
+    thrust::device_ptr<unsigned int> scratch_idx(d_scratch_idx);
+    thrust::device_ptr<unsigned int> scratch_g(d_scratch_g);
+    #ifdef __HIP_PLATFORM_HCC__
+    thrust::sort_by_key(thrust::hip::par(alloc),
+    #else
+    thrust::sort_by_key(thrust::cuda::par(alloc),
+    #endif
+        scratch_idx,
+        scratch_idx + group_size*n_groups,
+        scratch_g);
+
+    // perform a segmented scan of d_scratch_idx
+    thrust::device_ptr<unsigned int> offsets(d_offsets);
+    thrust::constant_iterator<unsigned int> const_it(1);
+    #ifdef __HIP_PLATFORM_HCC__
+    thrust::exclusive_scan_by_key(thrust::hip::par(alloc),
+    #else
+    thrust::exclusive_scan_by_key(thrust::cuda::par(alloc),
+    #endif
+        scratch_idx,
+        scratch_idx + group_size*n_groups,
+        const_it,
+        offsets);
+
+    // scatter groups to destinations
+    unsigned int block_size = 256;
+    unsigned int n_blocks = (group_size*n_groups)/block_size + 1;
+
+    hipLaunchKernelGGL(gpu_group_scatter_kernel<group_size>, dim3(n_blocks), dim3(block_size), 0, 0,
+        n_groups*group_size,
+        d_scratch_g,
+        d_scratch_idx,
+        d_offsets,
+        d_group_table,
+        d_group_typeval,
+        d_rtag,
+        d_pidx_group_table,
+        d_pidx_gpos_table,
+        d_pidx_group_offsets,
+        pidx_group_table_pitch,
+        has_type_mapping);
+    }
+
 template<unsigned int group_size, typename group_t>
 void gpu_update_group_table(
     const unsigned int n_groups,
@@ -137,6 +206,7 @@ void gpu_update_group_table(
     unsigned int &flag,
     group_t *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
     const unsigned int pidx_group_table_pitch,
     unsigned int *d_scratch_g,
     unsigned int *d_scratch_idx,
@@ -168,48 +238,121 @@ void gpu_update_group_table(
 
     if (! (flag >= next_flag) && n_groups)
         {
-        // we are good, fill group table
-        // sort groups by particle idx
-        thrust::device_ptr<unsigned int> scratch_idx(d_scratch_idx);
-        thrust::device_ptr<unsigned int> scratch_g(d_scratch_g);
+        // we are good, every particle has its own column
+        thrust::device_ptr<unsigned int> group_offsets(d_pidx_group_offsets);
         #ifdef __HIP_PLATFORM_HCC__
-        thrust::sort_by_key(thrust::hip::par(alloc),
+        thrust::sequence(thrust::hip::par(alloc),
         #else
-        thrust::sort_by_key(thrust::cuda::par(alloc),
+        thrust::sequence(thrust::cuda::par(alloc),
         #endif
-            scratch_idx,
-            scratch_idx + group_size*n_groups,
-            scratch_g);
+            group_offsets,
+            group_offsets + N);
+
+        // fill group table
+        gpu_fill_group_table<group_size>(n_groups,
+                                         d_group_table,
+                                         d_group_typeval,
+                                         d_rtag,
+                                         d_pidx_group_table,
+                                         d_pidx_gpos_table,
+                                         d_pidx_group_offsets,
+                                         pidx_group_table_pitch,
+                                         d_scratch_g,
+                                         d_scratch_idx,
+                                         d_offsets,
+                                         has_type_mapping,
+                                         alloc);
+        }
+    }
 
-        // perform a segmented scan of d_scratch_idx
-        thrust::device_ptr<unsigned int> offsets(d_offsets);
-        thrust::constant_iterator<unsigned int> const_it(1);
-        #ifdef __HIP_PLATFORM_HCC__
-        thrust::exclusive_scan_by_key(thrust::hip::par(alloc),
-        #else
-        thrust::exclusive_scan_by_key(thrust::cuda::par(alloc),
-        #endif
-            scratch_idx,
-            scratch_idx + group_size*n_groups,
-            const_it,
-            offsets);
-
-        // scatter groups to destinations
-        block_size = 256;
-        n_blocks = (group_size*n_groups)/block_size + 1;
-
-        hipLaunchKernelGGL(gpu_group_scatter_kernel<group_size>, dim3(n_blocks), dim3(block_size), 0, 0,
-            n_groups*group_size,
-            d_scratch_g,
-            d_scratch_idx,
-            d_offsets,
-            d_group_table,
-            d_group_typeval,
-            d_rtag,
-            d_pidx_group_table,
-            d_pidx_gpos_table,
-            pidx_group_table_pitch,
-            has_type_mapping);
+/*! The groups of every particle are stored contiguously, starting at the prefix sum of the numbers of groups of the
+    particles before it. The table has one entry per group member, so its size does not depend on the largest number
+    of groups of a particle.
+*/
+template<unsigned int group_size, typename group_t>
+void gpu_update_group_table_csr(
+    const unsigned int n_groups,
+    const unsigned int N,
+    const group_t* d_group_table,
+    const typeval_union *d_group_typeval,
+    const unsigned int *d_rtag,
+    unsigned int *d_n_groups,
+    unsigned int &max_n_groups,
+    unsigned int *d_condition,
+    unsigned int next_flag,
+    unsigned int &flag,
+    group_t *d_pidx_group_table,
+    unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
+    unsigned int *d_scratch_g,
+    unsigned int *d_scratch_idx,
+    unsigned int *d_offsets,
+    bool has_type_mapping,
+    CachedAllocator& alloc
+    )
+    {
+    unsigned int block_size = 256;
+    unsigned n_blocks = n_groups / block_size + 1;
+
+    // reset number of groups
+    hipMemsetAsync(d_n_groups, 0, sizeof(unsigned int)*N);
+
+    // count the groups without a limit on their number per particle
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_count_groups_kernel<group_size>), dim3(n_blocks), dim3(block_size), 0, 0,
+        n_groups,
+        d_group_table,
+        d_rtag,
+        d_scratch_idx,
+        d_scratch_g,
+        d_n_groups,
+        0xffffffff,
+        d_condition,
+        next_flag);
+
+    // read back flag
+    hipMemcpy(&flag, d_condition, sizeof(unsigned int), hipMemcpyDeviceToHost);
+
+    max_n_groups = 0;
+    if (flag >= next_flag+1 || !N)
+        return;
+
+    // the groups of a particle start at the sum of the groups of all particles before it
+    thrust::device_ptr<unsigned int> n_groups_ptr(d_n_groups);
+    thrust::device_ptr<unsigned int> group_offsets(d_pidx_group_offsets);
+    #ifdef __HIP_PLATFORM_HCC__
+    thrust::exclusive_scan(thrust::hip::par(alloc),
+    #else
+    thrust::exclusive_scan(thrust::cuda::par(alloc),
+    #endif
+        n_groups_ptr,
+        n_groups_ptr + N,
+        group_offsets);
+
+    #ifdef __HIP_PLATFORM_HCC__
+    max_n_groups = thrust::reduce(thrust::hip::par(alloc),
+    #else
+    max_n_groups = thrust::reduce(thrust::cuda::par(alloc),
+    #endif
+        n_groups_ptr,
+        n_groups_ptr + N,
+        0u,
+        thrust::maximum<unsigned int>());
+
+    if (n_groups)
+        {
+        gpu_fill_group_table<group_size>(n_groups,
+                                         d_group_table,
+                                         d_group_typeval,
+                                         d_rtag,
+                                         d_pidx_group_table,
+                                         d_pidx_gpos_table,
+                                         d_pidx_group_offsets,
+                                         1,
+                                         d_scratch_g,
+                                         d_scratch_idx,
+                                         d_offsets,
+                                         has_type_mapping,
+                                         alloc);
         }
     }
 
@@ -231,6 +374,7 @@ template void gpu_update_group_table<2>(
     unsigned int &flag,
     group_storage<2> *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
     const unsigned int pidx_group_table_pitch,
     unsigned int *d_scratch_g,
     unsigned int *d_scratch_idx,
@@ -253,6 +397,7 @@ template void gpu_update_group_table<3>(
     unsigned int &flag,
     group_storage<3> *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
     const unsigned int pidx_group_table_pitch,
     unsigned int *d_scratch_g,
     unsigned int *d_scratch_idx,
@@ -275,6 +420,7 @@ template void gpu_update_group_table<4>(
     unsigned int &flag,
     group_storage<4> *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
     const unsigned int pidx_group_table_pitch,
     unsigned int *d_scratch_g,
     unsigned int *d_scratch_idx,
@@ -282,3 +428,69 @@ template void gpu_update_group_table<4>(
     bool has_type_mapping,
     CachedAllocator& alloc
     );
+
+//! BondData
+template void gpu_update_group_table_csr<2>(
+    const unsigned int n_groups,
+    const unsigned int N,
+    const union group_storage<2> *d_group_table,
+    const typeval_union *d_group_typeval,
+    const unsigned int *d_rtag,
+    unsigned int *d_n_groups,
+    unsigned int &max_n_groups,
+    unsigned int *d_condition,
+    unsigned int next_flag,
+    unsigned int &flag,
+    group_storage<2> *d_pidx_group_table,
+    unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
+    unsigned int *d_scratch_g,
+    unsigned int *d_scratch_idx,
+    unsigned int *d_offsets,
+    bool has_type_mapping,
+    CachedAllocator& alloc
+    );
+
+//! AngleData
+template void gpu_update_group_table_csr<3>(
+    const unsigned int n_groups,
+    const unsigned int N,
+    const union group_storage<3> *d_group_table,
+    const typeval_union *d_group_typeval,
+    const unsigned int *d_rtag,
+    unsigned int *d_n_groups,
+    unsigned int &max_n_groups,
+    unsigned int *d_condition,
+    unsigned int next_flag,
+    unsigned int &flag,
+    group_storage<3> *d_pidx_group_table,
+    unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
+    unsigned int *d_scratch_g,
+    unsigned int *d_scratch_idx,
+    unsigned int *d_offsets,
+    bool has_type_mapping,
+    CachedAllocator& alloc
+    );
+
+//! DihedralData and ImproperData
+template void gpu_update_group_table_csr<4>(
+    const unsigned int n_groups,
+    const unsigned int N,
+    const union group_storage<4> *d_group_table,
+    const typeval_union *d_group_typeval,
+    const unsigned int *d_rtag,
+    unsigned int *d_n_groups,
+    unsigned int &max_n_groups,
+    unsigned int *d_condition,
+    unsigned int next_flag,
+    unsigned int &flag,
+    group_storage<4> *d_pidx_group_table,
+    unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
+    unsigned int *d_scratch_g,
+    unsigned int *d_scratch_idx,
+    unsigned int *d_offsets,
+    bool has_type_mapping,
+    CachedAllocator& alloc
+    );
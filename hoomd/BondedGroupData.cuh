@@ -70,6 +70,7 @@ void gpu_update_group_table(
     unsigned int &flag,
     group_t *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
     const unsigned int pidx_group_table_pitch,
     unsigned int *d_scratch_g,
     unsigned int *d_scratch_idx,
@@ -77,4 +78,26 @@ void gpu_update_group_table(
     bool has_type_mapping,
     CachedAllocator& alloc
     );
+
+template<unsigned int group_size, typename group_t>
+void gpu_update_group_table_csr(
+    const unsigned int n_groups,
+    const unsigned int N,
+    const group_t* d_group_table,
+    const typeval_union *d_group_typeval,
+    const unsigned int *d_rtag,
+    unsigned int *d_n_groups,
+    unsigned int &max_n_groups,
+    unsigned int *d_condition,
+    unsigned int next_flag,
+    unsigned int &flag,
+    group_t *d_pidx_group_table,
+    unsigned int *d_pidx_gpos_table,
+    unsigned int *d_pidx_group_offsets,
+    unsigned int *d_scratch_g,
+    unsigned int *d_scratch_idx,
+    unsigned int *d_offsets,
+    bool has_type_mapping,
+    CachedAllocator& alloc
+    );
 #endif // __BONDED_GROUP_DATA_CUH__
@@ -520,7 +520,7 @@ class BondedGroupData
          */
 
         //! Return GPU bonded groups list
-        const GPUVector<members_t>& getGPUTable()
+        const GlobalVector<members_t>& getGPUTable()
             {
             // rebuild lookup table if necessary
             if (m_groups_dirty)
@@ -533,7 +533,7 @@ class BondedGroupData
             }
 
         //! Return GPU list of particle in group position
-        const GPUArray<unsigned >& getGPUPosTable()
+        const GlobalArray<unsigned int>& getGPUPosTable()
             {
             // rebuild lookup table if necessary
             if (m_groups_dirty)
@@ -545,6 +545,37 @@ class BondedGroupData
             return m_gpu_pos_table;
             }
 
+        //! Return the start of the groups of every particle in the GPU table
+        /*! The groups of particle idx are at getGPUTableIndexer()(offsets[idx], i) for i < n_groups[idx]. In the
+            padded layout, the table has one column per particle and the offset of a particle is its index. In the
+            CSR layout, the groups of each particle are stored contiguously, the offsets are the prefix sums of the
+            numbers of groups, and the indexer has a width of 1.
+         */
+        const GlobalArray<unsigned int>& getGPUTableOffsets()
+            {
+            // rebuild lookup table if necessary
+            if (m_groups_dirty)
+                {
+                rebuildGPUTable();
+                m_groups_dirty = false;
+                }
+
+            return m_gpu_table_offsets;
+            }
+
+        //! Return true if the GPU table stores the groups of every particle contiguously
+        bool isGPUTableCSR()
+            {
+            // rebuild lookup table if necessary
+            if (m_groups_dirty)
+                {
+                rebuildGPUTable();
+                m_groups_dirty = false;
+                }
+
+            return m_gpu_table_csr;
+            }
+
         //! Return two-dimensional group-by-ptl-index lookup table
         const Index2D& getGPUTableIndexer()
             {
@@ -559,7 +590,7 @@ class BondedGroupData
             }
 
         //! Return list of number of groups per particle
-        const GPUArray<unsigned int>& getNGroupsArray() const
+        const GlobalArray<unsigned int>& getNGroupsArray() const
             {
             return m_gpu_n_groups;
             }
@@ -578,6 +609,9 @@ class BondedGroupData
          */
         void removeBondedGroup(unsigned int group_tag);
 
+        //! Replicate the local bonded groups after the particles have been replicated
+        void replicate(unsigned int n, unsigned int old_n_particles);
+
         //! Set the profiler
         /*! \param prof The profiler
          */
@@ -615,6 +649,9 @@ class BondedGroupData
             m_groups_dirty = true;
             }
 
+        //! Reorder the local groups to follow the order of their member particles
+        void sortGroups();
+
     protected:
         #ifdef ENABLE_MPI
         //! Helper function to transfer bonded groups connected to a single particle
@@ -632,10 +669,13 @@ class BondedGroupData
         GPUVector<typeval_t> m_group_typeval;        //!< List of group types/constraint values
         GPUVector<unsigned int> m_group_tag;         //!< List of group tags
         GPUVector<unsigned int> m_group_rtag;        //!< Global reverse-lookup table for group tags
-        GPUVector<members_t> m_gpu_table;            //!< Storage for groups by particle index for access on the GPU
-        GPUVector<unsigned int> m_gpu_pos_table;     //!< Position of particle idx in group table
+        GlobalVector<members_t> m_gpu_table;         //!< Storage for groups by particle index for access on the GPU
+        GlobalVector<unsigned int> m_gpu_pos_table;  //!< Position of particle idx in group table
         Index2D m_gpu_table_indexer;                 //!< Indexer for GPU table
-        GPUVector<unsigned int> m_gpu_n_groups;      //!< Number of entries in lookup table per particle
+        GlobalVector<unsigned int> m_gpu_n_groups;   //!< Number of entries in lookup table per particle
+        GlobalVector<unsigned int> m_gpu_table_offsets; //!< Start of the entries of every particle in the GPU table
+        bool m_gpu_table_csr;                        //!< True if the GPU table has the CSR layout
+        unsigned int m_gpu_max_n_groups;             //!< Maximum number of groups of a particle at the last rebuild
         std::vector<std::string> m_type_mapping;     //!< Mapping of types of bonded groups
 
         unsigned int m_n_groups;                     //!< Number of local groups
@@ -675,6 +715,22 @@ class BondedGroupData
         //! Helper function to rebuild lookup by index table
         void rebuildGPUTable();
 
+        //! Test whether the CSR layout of the GPU table saves memory
+        /*! \param max_n_groups Maximum number of groups of a particle
+            \param nptl Number of local and ghost particles
+            \param n_entries Number of entries in the table (group_size per group)
+
+            The padded table has max_n_groups entries per particle. A few particles in many groups, such as
+            crosslinkers, inflate it for all particles, and the CSR layout is used when it would be less than half full.
+         */
+        static bool useCSRLayout(unsigned int max_n_groups, unsigned int nptl, unsigned int n_entries)
+            {
+            return (size_t)max_n_groups*nptl > 2*(size_t)n_entries;
+            }
+
+        //! Set the memory hints of the lookup by index table for multiple GPUs
+        void updateGPUAdvice();
+
         //! Resize internal tables
         /*! \param new_size New size of local group tables, new_size = n_local + n_ghost
          */
@@ -695,6 +751,15 @@ class BondedGroupData
         //! Helper function to rebuild lookup by index table on the GPU
         void rebuildGPUTableGPU();
 
+        //! Rebuild the padded lookup table on the GPU
+        void rebuildPaddedGPUTableGPU();
+
+        //! Rebuild the CSR lookup table on the GPU
+        unsigned int rebuildCSRGPUTableGPU();
+
+        //! Check the condition flag of a GPU table rebuild for incomplete groups
+        void checkGPUTableCondition(unsigned int flag);
+
         GPUArray<unsigned int> m_condition;          //!< Condition variable for rebuilding GPU table on the GPU
         unsigned int m_next_flag;                    //!< Next flag value for GPU table rebuild
         #endif
@@ -49,6 +49,7 @@ class __attribute__((visibility("default"))) CachedAllocator
         CachedAllocator(bool managed, unsigned int max_cached_bytes=100u*1024u*1024u, float cache_reltol = 0.1f)
             : m_managed(managed),
               m_num_bytes_tot(0),
+              m_peak_bytes_tot(0),
               m_max_cached_bytes(max_cached_bytes),
               m_cache_reltol(cache_reltol)
             { }
@@ -65,6 +66,18 @@ class __attribute__((visibility("default"))) CachedAllocator
             m_max_cached_bytes = max_cached_bytes;
             }
 
+        //! Get the number of bytes allocated from the device, in use or cached
+        size_t getNumBytesAllocated() const
+            {
+            return m_num_bytes_tot;
+            }
+
+        //! Get the high-water mark of the bytes allocated from the device
+        size_t getPeakBytesAllocated() const
+            {
+            return m_peak_bytes_tot;
+            }
+
         //! Destructor
         virtual ~CachedAllocator()
             {
@@ -107,6 +120,7 @@ class __attribute__((visibility("default"))) CachedAllocator
         bool m_managed;  //! True if we use unified memory
 
         size_t m_num_bytes_tot;
+        size_t m_peak_bytes_tot;
         size_t m_max_cached_bytes;
         float m_cache_reltol;
 
@@ -206,6 +220,8 @@ T* CachedAllocator::getTemporaryBuffer(size_t num_elements)
         CHECK_CUDA();
 
         m_num_bytes_tot += num_bytes;
+        if (m_num_bytes_tot > m_peak_bytes_tot)
+            m_peak_bytes_tot = m_num_bytes_tot;
 
         while (m_num_bytes_tot > m_max_cached_bytes && m_free_blocks.size())
             {
@@ -480,6 +480,8 @@ void CellList::computeCellList()
             continue;
             }
 
+        if (!binsType(__scalar_as_int(h_pos.data[n].w)))
+            continue;
 
         // find the bin each particle belongs in
         Scalar3 f = box.makeFraction(p,ghost_width);
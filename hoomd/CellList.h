@@ -11,6 +11,7 @@
 #include "Compute.h"
 
 #include <memory>
+#include <vector>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 
 /*! \file CellList.h
@@ -213,6 +214,29 @@ class PYBIND11_EXPORT CellList : public Compute
             m_params_changed = true;
             }
 
+        //! Bin only particles of the given types
+        /*! \param types Particle types to bin, an empty list bins all types
+
+            Separate cell lists per type allow grids with different cell widths for particles of very different sizes.
+        */
+        void setTypeFilter(const std::vector<unsigned int>& types)
+            {
+            m_bin_type.clear();
+            for (auto t : types)
+                {
+                if (t >= m_bin_type.size())
+                    m_bin_type.resize(t+1, false);
+                m_bin_type[t] = true;
+                }
+            m_params_changed = true;
+            }
+
+        //! Return true if particles of type \a type are binned
+        bool binsType(unsigned int type) const
+            {
+            return m_bin_type.empty() || (type < m_bin_type.size() && m_bin_type[type]);
+            }
+
         //! Request a multi-GPU cell list
         virtual void setPerDevice(bool per_device)
             {
@@ -392,6 +416,7 @@ class PYBIND11_EXPORT CellList : public Compute
 
         bool m_sort_cell_list;               //!< If true, sort cell list
         bool m_compute_adj_list;            //!< If true, compute the cell adjacency lists
+        std::vector<bool> m_bin_type;       //!< Types that are binned, all types if empty
 
         //! Computes what the dimensions should me
         uint3 computeDimensions();
@@ -34,9 +34,24 @@ CellListGPU::CellListGPU(std::shared_ptr<SystemDefinition> sysdef)
 
 void CellListGPU::computeCellList()
     {
+    if (!m_bin_type.empty())
+        {
+        m_exec_conf->msg->error() << "Cell lists filtered by type are not supported on the GPU" << endl;
+        throw std::runtime_error("Error computing cell list");
+        }
+
     if (m_prof)
         m_prof->push(m_exec_conf, "compute");
 
+    if (m_sort_cell_list && m_exec_conf->getNumActiveGPUs() == 1 && !m_per_device)
+        {
+        computeSortedCellList();
+
+        if (m_prof)
+            m_prof->pop(m_exec_conf);
+        return;
+        }
+
     // acquire the particle data
     ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
@@ -165,6 +180,105 @@ void CellListGPU::computeCellList()
         m_prof->pop(m_exec_conf);
     }
 
+/*! The particles are radix sorted by cell, which orders the particles in each cell by index without atomic
+    operations. The size of the fullest cell is known before the cell list is filled, so the cell list is resized
+    once instead of overflowing and computing it again.
+*/
+void CellListGPU::computeSortedCellList()
+    {
+    unsigned int n_binned = m_pdata->getN() + m_pdata->getNGhosts();
+    unsigned int n_cells = m_cell_indexer.getNumElements();
+
+    if (m_cell_start.getNumElements() != n_cells)
+        {
+        GlobalArray<unsigned int> cell_start(n_cells, m_exec_conf);
+        m_cell_start.swap(cell_start);
+        TAG_ALLOCATION(m_cell_start);
+        }
+
+    if (m_sorted_idx.getNumElements() < n_binned)
+        {
+        GlobalArray<unsigned int> sorted_idx(n_binned, m_exec_conf);
+        m_sorted_idx.swap(sorted_idx);
+        TAG_ALLOCATION(m_sorted_idx);
+        }
+
+    CachedAllocator& alloc = m_exec_conf->getCachedAllocator();
+    ScopedAllocation<unsigned int> d_sorted_cell_size(alloc, n_cells);
+    ScopedAllocation<unsigned int> d_keys_sorted(alloc, n_binned);
+    ScopedAllocation<unsigned int> d_max_cell_size(alloc, 1);
+
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_start(m_cell_start, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_sorted_idx(m_sorted_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle<uint3> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
+
+        gpu_sort_cell_keys(d_cell_start.data,
+                           d_sorted_cell_size.data,
+                           d_max_cell_size.data,
+                           d_keys_sorted.data,
+                           d_sorted_idx.data,
+                           d_conditions.data,
+                           d_pos.data,
+                           m_pdata->getN(),
+                           m_pdata->getNGhosts(),
+                           m_pdata->getBox(),
+                           m_cell_indexer,
+                           getGhostWidth(),
+                           alloc);
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    unsigned int max_cell_size = 0;
+    hipMemcpy(&max_cell_size, d_max_cell_size.data, sizeof(unsigned int), hipMemcpyDeviceToHost);
+
+    // make room for the fullest cell
+    if (max_cell_size > m_Nmax)
+        {
+        m_Nmax = max_cell_size;
+        initializeMemory();
+        }
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_charge(m_pdata->getCharges(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_cell_start(m_cell_start, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_sorted_idx(m_sorted_idx, access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_cell_size(m_cell_size, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_xyzf(m_xyzf, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_tdb(m_tdb, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_cell_orientation(m_orientation, access_location::device, access_mode::overwrite);
+    ArrayHandle<unsigned int> d_cell_idx(m_idx, access_location::device, access_mode::overwrite);
+
+    gpu_fill_sorted_cell_list(d_cell_size.data,
+                              d_xyzf.data,
+                              d_tdb.data,
+                              d_cell_orientation.data,
+                              d_cell_idx.data,
+                              d_sorted_cell_size.data,
+                              d_cell_start.data,
+                              d_keys_sorted.data,
+                              d_sorted_idx.data,
+                              d_pos.data,
+                              d_orientation.data,
+                              d_charge.data,
+                              d_diameter.data,
+                              d_body.data,
+                              n_binned,
+                              m_flag_charge,
+                              m_flag_type,
+                              m_cell_indexer,
+                              m_cell_list_indexer);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
 void CellListGPU::combineCellLists()
     {
     // access the cell list data arrays
@@ -12,10 +12,128 @@
 #include <thrust/device_ptr.h>
 #pragma GCC diagnostic pop
 
+#include <hipcub/hipcub.hpp>
+
 /*! \file CellListGPU.cu
     \brief Defines GPU kernel code for cell list generation on the GPU
 */
 
+//! Find the cell of a particle
+/*! \param pos Particle position
+    \param idx Particle index
+    \param N Number of particles
+    \param d_conditions Conditions flags for detecting overflow and other error conditions
+    \param box Box dimensions
+    \param ci Indexer to compute cell id from cell grid coords
+    \param ghost_width Width of ghost layer
+
+    \returns The cell index, or UINT_MAX when the particle is not binned. Particles with NaN positions and local
+              particles outside of the box are flagged in \a d_conditions.
+*/
+__device__ inline unsigned int gpu_compute_cell_bin(const Scalar3& pos,
+                                                    const unsigned int idx,
+                                                    const unsigned int N,
+                                                    uint3 *d_conditions,
+                                                    const BoxDim& box,
+                                                    const Index3D& ci,
+                                                    const Scalar3& ghost_width)
+    {
+    // check for nan pos
+    if (isnan(pos.x) || isnan(pos.y) || isnan(pos.z))
+        {
+        (*d_conditions).y = idx+1;
+        return UINT_MAX;
+        }
+
+    uchar3 periodic = box.getPeriodic();
+    Scalar3 f = box.makeFraction(pos,ghost_width);
+
+    // check if the particle is inside the unit cell + ghost layer in all dimensions
+    if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
+        (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
+        (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
+        {
+        // if a ghost particle is out of bounds, silently ignore it
+        if (idx < N)
+            (*d_conditions).z = idx+1;
+        return UINT_MAX;
+        }
+
+    // find the bin each particle belongs in
+    int ib = (int)(f.x * ci.getW());
+    int jb = (int)(f.y * ci.getH());
+    int kb = (int)(f.z * ci.getD());
+
+    // need to handle the case where the particle is exactly at the box hi
+    if (ib == ci.getW() && periodic.x)
+        ib = 0;
+    if (jb == ci.getH() && periodic.y)
+        jb = 0;
+    if (kb == ci.getD() && periodic.z)
+        kb = 0;
+
+    // all particles should be in a valid cell
+    if (ib < 0 || ib >= (int)ci.getW() ||
+        jb < 0 || jb >= (int)ci.getH() ||
+        kb < 0 || kb >= (int)ci.getD())
+        {
+        // but ghost particles that are out of range should not produce an error
+        if (idx < N)
+            {
+            #if (__CUDA_ARCH__ >= 600)
+            atomicMax_system(&(*d_conditions).z, idx+1);
+            #else
+            atomicMax(&(*d_conditions).z, idx+1);
+            #endif
+            }
+        return UINT_MAX;
+        }
+
+    return ci(ib, jb, kb);
+    }
+
+//! Write the entry of a particle into the cell list
+/*! \param write_pos Position in the cell list arrays
+    \param idx Particle index
+
+    The remaining parameters are documented in gpu_compute_cell_list_kernel().
+*/
+__device__ inline void gpu_write_cell_entry(const unsigned int write_pos,
+                                            const unsigned int idx,
+                                            Scalar4 *d_xyzf,
+                                            Scalar4 *d_tdb,
+                                            Scalar4 *d_cell_orientation,
+                                            unsigned int *d_cell_idx,
+                                            const Scalar4 *d_pos,
+                                            const Scalar4 *d_orientation,
+                                            const Scalar *d_charge,
+                                            const Scalar *d_diameter,
+                                            const unsigned int *d_body,
+                                            const bool flag_charge,
+                                            const bool flag_type)
+    {
+    Scalar4 postype = d_pos[idx];
+
+    Scalar flag = 0;
+    Scalar type = postype.w;
+
+    if (flag_charge)
+        flag = d_charge[idx];
+    else if (flag_type)
+        flag = type;
+    else
+        flag = __int_as_scalar(idx);
+
+    if (d_xyzf != NULL)
+        d_xyzf[write_pos] = make_scalar4(postype.x, postype.y, postype.z, flag);
+    if (d_tdb != NULL)
+        d_tdb[write_pos] = make_scalar4(type, d_diameter[idx], __int_as_scalar(d_body[idx]), 0);
+    if (d_cell_orientation != NULL)
+        d_cell_orientation[write_pos] = d_orientation[idx];
+    if (d_cell_idx != NULL)
+        d_cell_idx[write_pos] = idx;
+    }
+
 //! Kernel that computes the cell list on the GPU
 /*! \param d_cell_size Number of particles in each cell
     \param d_xyzf Cell XYZF data array
@@ -73,95 +191,27 @@ __global__ void gpu_compute_cell_list_kernel(unsigned int *d_cell_size,
     Scalar4 postype = d_pos[idx];
     Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
 
-    Scalar flag = 0;
-    Scalar diameter = 0;
-    Scalar body = 0;
-    Scalar type = postype.w;
-    Scalar4 orientation = make_scalar4(0,0,0,0);
-    if (d_tdb != NULL)
-        {
-        diameter = d_diameter[idx];
-        body = __int_as_scalar(d_body[idx]);
-        }
-    if (d_cell_orientation != NULL)
-        {
-        orientation = d_orientation[idx];
-        }
-
-    if (flag_charge)
-        flag = d_charge[idx];
-    else if (flag_type)
-        flag = type;
-    else
-        flag = __int_as_scalar(idx);
-
-    // check for nan pos
-    if (isnan(pos.x) || isnan(pos.y) || isnan(pos.z))
-        {
-        (*d_conditions).y = idx+1;
-        return;
-        }
-
-    uchar3 periodic = box.getPeriodic();
-    Scalar3 f = box.makeFraction(pos,ghost_width);
-
-    // check if the particle is inside the unit cell + ghost layer in all dimensions
-    if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
-        (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
-        (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
-        {
-        // if a ghost particle is out of bounds, silently ignore it
-        if (idx < N)
-            (*d_conditions).z = idx+1;
-        return;
-        }
-
-    // find the bin each particle belongs in
-    int ib = (int)(f.x * ci.getW());
-    int jb = (int)(f.y * ci.getH());
-    int kb = (int)(f.z * ci.getD());
-
-    // need to handle the case where the particle is exactly at the box hi
-    if (ib == ci.getW() && periodic.x)
-        ib = 0;
-    if (jb == ci.getH() && periodic.y)
-        jb = 0;
-    if (kb == ci.getD() && periodic.z)
-        kb = 0;
-
-    unsigned int bin = ci(ib, jb, kb);
-
-    // all particles should be in a valid cell
-    // all particles should be in a valid cell
-    if (ib < 0 || ib >= (int)ci.getW() ||
-        jb < 0 || jb >= (int)ci.getH() ||
-        kb < 0 || kb >= (int)ci.getD())
-        {
-        // but ghost particles that are out of range should not produce an error
-        if (idx < N)
-            {
-            #if (__CUDA_ARCH__ >= 600)
-            atomicMax_system(&(*d_conditions).z, idx+1);
-            #else
-            atomicMax(&(*d_conditions).z, idx+1);
-            #endif
-            }
+    unsigned int bin = gpu_compute_cell_bin(pos, idx, N, d_conditions, box, ci, ghost_width);
+    if (bin == UINT_MAX)
         return;
-        }
 
     unsigned int size = atomicInc(&d_cell_size[bin], 0xffffffff);
 
     if (size < Nmax)
         {
-        unsigned int write_pos = cli(size, bin);
-        if (d_xyzf != NULL)
-            d_xyzf[write_pos] = make_scalar4(pos.x, pos.y, pos.z, flag);
-        if (d_tdb != NULL)
-            d_tdb[write_pos] = make_scalar4(type, diameter, body, 0);
-        if (d_cell_orientation != NULL)
-            d_cell_orientation[write_pos] = orientation;
-        if (d_cell_idx != NULL)
-            d_cell_idx[write_pos] = idx;
+        gpu_write_cell_entry(cli(size, bin),
+                             idx,
+                             d_xyzf,
+                             d_tdb,
+                             d_cell_orientation,
+                             d_cell_idx,
+                             d_pos,
+                             d_orientation,
+                             d_charge,
+                             d_diameter,
+                             d_body,
+                             flag_charge,
+                             flag_type);
         }
     else
         {
@@ -536,3 +586,304 @@ hipError_t gpu_sort_cell_list(unsigned int *d_cell_size,
 
     return hipSuccess;
     }
+
+//! Kernel that computes the cell of every particle as a sort key
+/*! \param d_keys Cell index of each particle, number of cells for particles that are not binned
+    \param d_values Particle index (identity)
+    \param d_conditions Conditions flags for detecting error conditions
+    \param d_pos Particle position array
+    \param N Number of particles
+    \param n_binned Number of particles and ghost particles
+    \param box Box dimensions
+    \param ci Indexer to compute cell id from cell grid coords
+    \param ghost_width Width of ghost layer
+*/
+__global__ void gpu_compute_cell_keys_kernel(unsigned int *d_keys,
+                                             unsigned int *d_values,
+                                             uint3 *d_conditions,
+                                             const Scalar4 *d_pos,
+                                             const unsigned int N,
+                                             const unsigned int n_binned,
+                                             const BoxDim box,
+                                             const Index3D ci,
+                                             const Scalar3 ghost_width)
+    {
+    unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+    if (idx >= n_binned)
+        return;
+
+    Scalar4 postype = d_pos[idx];
+    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+    unsigned int bin = gpu_compute_cell_bin(pos, idx, N, d_conditions, box, ci, ghost_width);
+
+    d_keys[idx] = (bin == UINT_MAX) ? ci.getNumElements() : bin;
+    d_values[idx] = idx;
+    }
+
+//! Kernel that finds the first and one past the last element of every cell in the sorted keys
+/*! \param d_cell_start First position of each cell in the sorted keys
+    \param d_cell_end One past the last position of each cell in the sorted keys
+    \param d_keys_sorted Sorted cell indices
+    \param n_binned Number of keys
+    \param n_cells Number of cells
+*/
+__global__ void gpu_find_cell_ranges_kernel(unsigned int *d_cell_start,
+                                            unsigned int *d_cell_end,
+                                            const unsigned int *d_keys_sorted,
+                                            const unsigned int n_binned,
+                                            const unsigned int n_cells)
+    {
+    unsigned int k = blockDim.x * blockIdx.x + threadIdx.x;
+    if (k >= n_binned)
+        return;
+
+    unsigned int key = d_keys_sorted[k];
+    if (key >= n_cells)
+        return;
+
+    if (k == 0 || d_keys_sorted[k-1] != key)
+        d_cell_start[key] = k;
+
+    if (k == n_binned-1 || d_keys_sorted[k+1] != key)
+        d_cell_end[key] = k+1;
+    }
+
+//! Kernel that converts the end of every cell into its size
+__global__ void gpu_cell_size_from_ranges_kernel(unsigned int *d_cell_size,
+                                                 const unsigned int *d_cell_start,
+                                                 const unsigned int n_cells)
+    {
+    unsigned int cell = blockDim.x * blockIdx.x + threadIdx.x;
+    if (cell >= n_cells)
+        return;
+
+    d_cell_size[cell] -= d_cell_start[cell];
+    }
+
+/*! Driver function to bin the particles by a radix sort on their cell index
+
+    The particles are sorted by cell with a stable radix sort, so particles in the same cell stay in the order of their
+    indices. The result is a cell list in compressed sparse row format: the particles of cell c are
+    d_sorted_idx[d_cell_start[c]] ... d_sorted_idx[d_cell_start[c]+d_cell_size[c]-1].
+
+    \param d_cell_start First position of each cell in \a d_sorted_idx
+    \param d_cell_size Number of particles in each cell
+    \param d_max_cell_size Number of particles in the fullest cell (one element)
+    \param d_keys_sorted Cell index of each sorted particle, number of cells for particles that are not binned
+    \param d_sorted_idx Particle indices sorted by cell
+    \param d_conditions Conditions flags for detecting error conditions
+    \param d_pos Particle position array
+    \param N Number of particles
+    \param n_ghost Number of ghost particles
+    \param box Box dimensions
+    \param ci Indexer to compute cell id from cell grid coords
+    \param ghost_width Width of ghost layer
+    \param alloc Caching allocator for temporary storage
+*/
+void gpu_sort_cell_keys(unsigned int *d_cell_start,
+                        unsigned int *d_cell_size,
+                        unsigned int *d_max_cell_size,
+                        unsigned int *d_keys_sorted,
+                        unsigned int *d_sorted_idx,
+                        uint3 *d_conditions,
+                        const Scalar4 *d_pos,
+                        const unsigned int N,
+                        const unsigned int n_ghost,
+                        const BoxDim& box,
+                        const Index3D& ci,
+                        const Scalar3& ghost_width,
+                        CachedAllocator& alloc)
+    {
+    unsigned int block_size = 256;
+    unsigned int n_binned = N + n_ghost;
+    unsigned int n_cells = ci.getNumElements();
+
+    hipMemsetAsync(d_cell_start, 0, sizeof(unsigned int)*n_cells);
+    hipMemsetAsync(d_cell_size, 0, sizeof(unsigned int)*n_cells);
+    hipMemsetAsync(d_max_cell_size, 0, sizeof(unsigned int));
+
+    if (n_binned == 0)
+        return;
+
+    unsigned int *d_keys = alloc.getTemporaryBuffer<unsigned int>(n_binned);
+    unsigned int *d_values = alloc.getTemporaryBuffer<unsigned int>(n_binned);
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_compute_cell_keys_kernel), dim3(n_binned/block_size + 1), dim3(block_size), 0, 0,
+        d_keys,
+        d_values,
+        d_conditions,
+        d_pos,
+        N,
+        n_binned,
+        box,
+        ci,
+        ghost_width);
+
+    // only sort on the bits needed to represent the cell indices
+    int end_bit = 1;
+    while (end_bit < 32 && (1u << end_bit) <= n_cells)
+        end_bit++;
+
+    // Determine temporary device storage requirements
+    void *d_temp_storage = NULL;
+    size_t temp_storage_bytes = 0;
+    hipcub::DeviceRadixSort::SortPairs(d_temp_storage,
+        temp_storage_bytes,
+        d_keys,
+        d_keys_sorted,
+        d_values,
+        d_sorted_idx,
+        n_binned,
+        0,
+        end_bit);
+    d_temp_storage = alloc.allocate(temp_storage_bytes);
+
+    // key-value sort, stable in the particle index
+    hipcub::DeviceRadixSort::SortPairs(d_temp_storage,
+        temp_storage_bytes,
+        d_keys,
+        d_keys_sorted,
+        d_values,
+        d_sorted_idx,
+        n_binned,
+        0,
+        end_bit);
+    alloc.deallocate((char *) d_temp_storage);
+
+    alloc.deallocate((char *) d_values);
+    alloc.deallocate((char *) d_keys);
+
+    // the end of each cell is stored in d_cell_size and converted to the size
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_find_cell_ranges_kernel), dim3(n_binned/block_size + 1), dim3(block_size), 0, 0,
+        d_cell_start,
+        d_cell_size,
+        d_keys_sorted,
+        n_binned,
+        n_cells);
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_cell_size_from_ranges_kernel), dim3(n_cells/block_size + 1), dim3(block_size), 0, 0,
+        d_cell_size,
+        d_cell_start,
+        n_cells);
+
+    d_temp_storage = NULL;
+    temp_storage_bytes = 0;
+    hipcub::DeviceReduce::Max(d_temp_storage, temp_storage_bytes, d_cell_size, d_max_cell_size, n_cells);
+    d_temp_storage = alloc.allocate(temp_storage_bytes);
+    hipcub::DeviceReduce::Max(d_temp_storage, temp_storage_bytes, d_cell_size, d_max_cell_size, n_cells);
+    alloc.deallocate((char *) d_temp_storage);
+    }
+
+//! Kernel that fills the cell list from the particles sorted by cell
+/*! \param d_cell_start First position of each cell in \a d_sorted_idx
+    \param d_keys_sorted Cell index of each sorted particle
+    \param d_sorted_idx Particle indices sorted by cell
+    \param n_binned Number of sorted particles
+    \param ci Indexer to compute cell id from cell grid coords
+    \param cli Indexer to index into \a d_xyzf and \a d_tdb
+
+    The remaining parameters are documented in gpu_compute_cell_list_kernel().
+*/
+__global__ void gpu_fill_sorted_cell_list_kernel(Scalar4 *d_xyzf,
+                                                 Scalar4 *d_tdb,
+                                                 Scalar4 *d_cell_orientation,
+                                                 unsigned int *d_cell_idx,
+                                                 const unsigned int *d_cell_start,
+                                                 const unsigned int *d_keys_sorted,
+                                                 const unsigned int *d_sorted_idx,
+                                                 const Scalar4 *d_pos,
+                                                 const Scalar4 *d_orientation,
+                                                 const Scalar *d_charge,
+                                                 const Scalar *d_diameter,
+                                                 const unsigned int *d_body,
+                                                 const unsigned int n_binned,
+                                                 const bool flag_charge,
+                                                 const bool flag_type,
+                                                 const Index3D ci,
+                                                 const Index2D cli)
+    {
+    unsigned int k = blockDim.x * blockIdx.x + threadIdx.x;
+    if (k >= n_binned)
+        return;
+
+    unsigned int bin = d_keys_sorted[k];
+    if (bin >= ci.getNumElements())
+        return;
+
+    gpu_write_cell_entry(cli(k - d_cell_start[bin], bin),
+                         d_sorted_idx[k],
+                         d_xyzf,
+                         d_tdb,
+                         d_cell_orientation,
+                         d_cell_idx,
+                         d_pos,
+                         d_orientation,
+                         d_charge,
+                         d_diameter,
+                         d_body,
+                         flag_charge,
+                         flag_type);
+    }
+
+/*! Driver function to fill the cell list from the particles sorted by gpu_sort_cell_keys()
+
+    The cell list must have room for the fullest cell.
+
+    \param d_cell_size Number of particles in each cell (output)
+    \param d_sorted_cell_size Number of particles in each cell from gpu_sort_cell_keys()
+    \param d_cell_start First position of each cell in \a d_sorted_idx
+    \param d_keys_sorted Cell index of each sorted particle
+    \param d_sorted_idx Particle indices sorted by cell
+    \param n_binned Number of particles and ghost particles
+    \param ci Indexer to compute cell id from cell grid coords
+    \param cli Indexer to index into \a d_xyzf and \a d_tdb
+
+    The remaining parameters are documented in gpu_compute_cell_list_kernel().
+*/
+void gpu_fill_sorted_cell_list(unsigned int *d_cell_size,
+                               Scalar4 *d_xyzf,
+                               Scalar4 *d_tdb,
+                               Scalar4 *d_cell_orientation,
+                               unsigned int *d_cell_idx,
+                               const unsigned int *d_sorted_cell_size,
+                               const unsigned int *d_cell_start,
+                               const unsigned int *d_keys_sorted,
+                               const unsigned int *d_sorted_idx,
+                               const Scalar4 *d_pos,
+                               const Scalar4 *d_orientation,
+                               const Scalar *d_charge,
+                               const Scalar *d_diameter,
+                               const unsigned int *d_body,
+                               const unsigned int n_binned,
+                               const bool flag_charge,
+                               const bool flag_type,
+                               const Index3D& ci,
+                               const Index2D& cli)
+    {
+    unsigned int block_size = 256;
+
+    hipMemcpyAsync(d_cell_size, d_sorted_cell_size, sizeof(unsigned int)*ci.getNumElements(), hipMemcpyDeviceToDevice);
+
+    if (n_binned == 0)
+        return;
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_fill_sorted_cell_list_kernel), dim3(n_binned/block_size + 1), dim3(block_size), 0, 0,
+        d_xyzf,
+        d_tdb,
+        d_cell_orientation,
+        d_cell_idx,
+        d_cell_start,
+        d_keys_sorted,
+        d_sorted_idx,
+        d_pos,
+        d_orientation,
+        d_charge,
+        d_diameter,
+        d_body,
+        n_binned,
+        flag_charge,
+        flag_type,
+        ci,
+        cli);
+    }
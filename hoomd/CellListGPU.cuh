@@ -15,6 +15,7 @@
 #include "Index1D.h"
 #include "ParticleData.cuh"
 #include "GPUPartition.cuh"
+#include "CachedAllocator.h"
 
 /*! \file CellListGPU.cuh
     \brief Declares GPU kernel code for cell list generation on the GPU
@@ -75,4 +76,40 @@ hipError_t gpu_sort_cell_list(unsigned int *d_cell_size,
                         unsigned int *d_sort_permutation,
                         const Index3D ci,
                         const Index2D cli);
+
+//! Driver function to bin the particles by a radix sort on their cell index
+void gpu_sort_cell_keys(unsigned int *d_cell_start,
+                        unsigned int *d_cell_size,
+                        unsigned int *d_max_cell_size,
+                        unsigned int *d_keys_sorted,
+                        unsigned int *d_sorted_idx,
+                        uint3 *d_conditions,
+                        const Scalar4 *d_pos,
+                        const unsigned int N,
+                        const unsigned int n_ghost,
+                        const BoxDim& box,
+                        const Index3D& ci,
+                        const Scalar3& ghost_width,
+                        CachedAllocator& alloc);
+
+//! Driver function to fill the cell list from the particles sorted by gpu_sort_cell_keys()
+void gpu_fill_sorted_cell_list(unsigned int *d_cell_size,
+                               Scalar4 *d_xyzf,
+                               Scalar4 *d_tdb,
+                               Scalar4 *d_cell_orientation,
+                               unsigned int *d_cell_idx,
+                               const unsigned int *d_sorted_cell_size,
+                               const unsigned int *d_cell_start,
+                               const unsigned int *d_keys_sorted,
+                               const unsigned int *d_sorted_idx,
+                               const Scalar4 *d_pos,
+                               const Scalar4 *d_orientation,
+                               const Scalar *d_charge,
+                               const Scalar *d_diameter,
+                               const unsigned int *d_body,
+                               const unsigned int n_binned,
+                               const bool flag_charge,
+                               const bool flag_type,
+                               const Index3D& ci,
+                               const Index2D& cli);
 #endif
@@ -73,6 +73,23 @@ class PYBIND11_EXPORT CellListGPU : public CellList
             return m_cell_size_scratch;
             }
 
+        //! Get the first position of each cell in the sorted index array
+        /*! Only available when the cell list is sorted on a single GPU, see getSortedIndexArray().
+        */
+        const GlobalArray<unsigned int>& getCellStartArray() const
+            {
+            return m_cell_start;
+            }
+
+        //! Get the particle indices sorted by cell
+        /*! When the cell list is sorted on a single GPU, the particles of cell c are the getCellSizeArray()[c]
+            elements of this array starting at getCellStartArray()[c], in order of increasing index.
+        */
+        const GlobalArray<unsigned int>& getSortedIndexArray() const
+            {
+            return m_sorted_idx;
+            }
+
     protected:
         GlobalArray<unsigned int> m_cell_size_scratch;  //!< Number of members in each cell, one list per GPU
         GlobalArray<unsigned int> m_cell_adj_scratch;   //!< Cell adjacency list, one list per GPU
@@ -83,6 +100,9 @@ class PYBIND11_EXPORT CellListGPU : public CellList
 
         bool m_per_device;                              //!< True if we maintain a per-GPU cell list
 
+        GlobalArray<unsigned int> m_cell_start;         //!< First position of each cell in m_sorted_idx
+        GlobalArray<unsigned int> m_sorted_idx;         //!< Particle indices sorted by cell
+
         //! Compute the cell list
         virtual void computeCellList();
 
@@ -92,6 +112,9 @@ class PYBIND11_EXPORT CellListGPU : public CellList
         //! Combine the per-device cell lists
         virtual void combineCellLists();
 
+        //! Compute the cell list by sorting the particles by cell
+        void computeSortedCellList();
+
         std::unique_ptr<Autotuner> m_tuner;         //!< Autotuner for block size
         std::unique_ptr<Autotuner> m_tuner_combine; //!< Autotuner for block size of combine cell lists kernel
     };
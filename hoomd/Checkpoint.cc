@@ -0,0 +1,543 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file Checkpoint.cc
+    \brief Defines the CheckpointWriter and CheckpointReader classes
+*/
+
+#include "Checkpoint.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+namespace
+{
+//! Identifies checkpoint files
+const char checkpoint_magic[8] = {'H', 'O', 'O', 'M', 'D', 'C', 'H', 'K'};
+
+//! Version of the checkpoint layout
+const uint32_t checkpoint_version = 1;
+
+//! Replicated part of a checkpoint file
+struct CheckpointHeader
+    {
+    uint32_t n_files;                                   //!< Number of files in the checkpoint
+    uint64_t timestep;                                  //!< Timestep of the checkpoint
+    uint32_t dimensions;                                //!< Dimensionality of the system
+    Scalar3 L;                                          //!< Box lengths
+    Scalar3 tilt;                                       //!< Box tilt factors xy, xz and yz
+    uint32_t tag_end;                                   //!< One past the largest particle tag issued
+    std::vector<unsigned int> removed_tags;             //!< Tags below tag_end of removed particles
+    std::vector<std::string> type_mapping[6];           //!< Names of the particle, bond, angle, dihedral, improper
+                                                        //!< and special pair types
+    std::vector<IntegratorVariables> integrator_variables;  //!< Variables of the registered integrators
+    };
+
+template<class T>
+void writeValue(std::ofstream& f, const T& v)
+    {
+    f.write((const char *)&v, sizeof(T));
+    }
+
+template<class T>
+void writeVector(std::ofstream& f, const std::vector<T>& v)
+    {
+    uint64_t n = v.size();
+    writeValue(f, n);
+    if (n)
+        f.write((const char *)v.data(), n*sizeof(T));
+    }
+
+void writeString(std::ofstream& f, const std::string& s)
+    {
+    std::vector<char> chars(s.begin(), s.end());
+    writeVector(f, chars);
+    }
+
+void writeStrings(std::ofstream& f, const std::vector<std::string>& strings)
+    {
+    uint64_t n = strings.size();
+    writeValue(f, n);
+    for (const std::string& s : strings)
+        writeString(f, s);
+    }
+
+template<class T>
+void readValue(std::ifstream& f, T& v)
+    {
+    f.read((char *)&v, sizeof(T));
+    }
+
+template<class T>
+void readVector(std::ifstream& f, std::vector<T>& v)
+    {
+    uint64_t n = 0;
+    readValue(f, n);
+    v.resize(n);
+    if (n)
+        f.read((char *)v.data(), n*sizeof(T));
+    }
+
+void readString(std::ifstream& f, std::string& s)
+    {
+    std::vector<char> chars;
+    readVector(f, chars);
+    s.assign(chars.begin(), chars.end());
+    }
+
+void readStrings(std::ifstream& f, std::vector<std::string>& strings)
+    {
+    uint64_t n = 0;
+    readValue(f, n);
+    strings.resize(n);
+    for (std::string& s : strings)
+        readString(f, s);
+    }
+
+void writeHeader(std::ofstream& f, const CheckpointHeader& header)
+    {
+    f.write(checkpoint_magic, sizeof(checkpoint_magic));
+    writeValue(f, checkpoint_version);
+    writeValue(f, uint32_t(sizeof(Scalar)));
+    writeValue(f, header.n_files);
+    writeValue(f, header.timestep);
+    writeValue(f, header.dimensions);
+    writeValue(f, header.L);
+    writeValue(f, header.tilt);
+    writeValue(f, header.tag_end);
+    writeVector(f, header.removed_tags);
+    for (unsigned int i = 0; i < 6; i++)
+        writeStrings(f, header.type_mapping[i]);
+
+    uint64_t n_integrators = header.integrator_variables.size();
+    writeValue(f, n_integrators);
+    for (const IntegratorVariables& v : header.integrator_variables)
+        {
+        writeString(f, v.type);
+        writeVector(f, v.variable);
+        }
+    }
+
+void readHeader(std::ifstream& f, CheckpointHeader& header, const std::string& fname)
+    {
+    char magic[sizeof(checkpoint_magic)];
+    uint32_t version = 0;
+    uint32_t scalar_size = 0;
+    f.read(magic, sizeof(magic));
+    readValue(f, version);
+    readValue(f, scalar_size);
+    if (!f.good() || memcmp(magic, checkpoint_magic, sizeof(magic)) != 0 || version != checkpoint_version)
+        throw runtime_error(fname + " is not a checkpoint file of this version of HOOMD");
+    if (scalar_size != sizeof(Scalar))
+        throw runtime_error(fname + " was written with a different floating point precision");
+
+    readValue(f, header.n_files);
+    readValue(f, header.timestep);
+    readValue(f, header.dimensions);
+    readValue(f, header.L);
+    readValue(f, header.tilt);
+    readValue(f, header.tag_end);
+    readVector(f, header.removed_tags);
+    for (unsigned int i = 0; i < 6; i++)
+        readStrings(f, header.type_mapping[i]);
+
+    uint64_t n_integrators = 0;
+    readValue(f, n_integrators);
+    header.integrator_variables.resize(n_integrators);
+    for (IntegratorVariables& v : header.integrator_variables)
+        {
+        readString(f, v.type);
+        readVector(f, v.variable);
+        }
+    }
+
+std::string getFileName(const std::string& fname, unsigned int file)
+    {
+    std::ostringstream oss;
+    oss << fname << "." << file;
+    return oss.str();
+    }
+
+template<class Data>
+std::vector<std::string> getTypeMapping(std::shared_ptr<Data> data)
+    {
+    std::vector<std::string> type_mapping;
+    for (unsigned int i = 0; i < data->getNTypes(); i++)
+        type_mapping.push_back(data->getNameByType(i));
+    return type_mapping;
+    }
+
+//! Write the local groups whose first member is local, so that every group is written by one rank
+template<class GroupData>
+void writeGroups(std::ofstream& f, std::shared_ptr<GroupData> group_data, std::shared_ptr<ParticleData> pdata)
+    {
+    std::vector<unsigned int> tags;
+    std::vector<typename GroupData::members_t> members;
+    std::vector<typeval_t> typeval;
+
+        {
+        ArrayHandle<typename GroupData::members_t> h_members(group_data->getMembersArray(),
+                                                             access_location::host,
+                                                             access_mode::read);
+        ArrayHandle<typeval_t> h_typeval(group_data->getTypeValArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tags(group_data->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+        for (unsigned int group_idx = 0; group_idx < group_data->getN(); group_idx++)
+            {
+            if (h_rtag.data[h_members.data[group_idx].tag[0]] >= pdata->getN())
+                continue;
+            tags.push_back(h_tags.data[group_idx]);
+            members.push_back(h_members.data[group_idx]);
+            typeval.push_back(h_typeval.data[group_idx]);
+            }
+        }
+
+    writeVector(f, tags);
+    writeVector(f, members);
+    writeVector(f, typeval);
+    }
+
+//! Groups read from the files of one rank
+template<class GroupData>
+struct CheckpointGroups
+    {
+    std::vector<unsigned int> tags;
+    std::vector<typename GroupData::members_t> members;
+    std::vector<typeval_t> typeval;
+
+    void read(std::ifstream& f)
+        {
+        std::vector<unsigned int> file_tags;
+        std::vector<typename GroupData::members_t> file_members;
+        std::vector<typeval_t> file_typeval;
+        readVector(f, file_tags);
+        readVector(f, file_members);
+        readVector(f, file_typeval);
+        tags.insert(tags.end(), file_tags.begin(), file_tags.end());
+        members.insert(members.end(), file_members.begin(), file_members.end());
+        typeval.insert(typeval.end(), file_typeval.begin(), file_typeval.end());
+        }
+
+    //! Gather the groups on the root rank and initialize the group data from them in tag order
+    void restore(std::shared_ptr<GroupData> group_data,
+                 bool has_type_mapping,
+                 std::shared_ptr<const ExecutionConfiguration> exec_conf)
+        {
+        #ifdef ENABLE_MPI
+        if (exec_conf->getNRanks() > 1)
+            {
+            std::vector< std::vector<unsigned int> > all_tags;
+            std::vector< std::vector<typename GroupData::members_t> > all_members;
+            std::vector< std::vector<typeval_t> > all_typeval;
+            gather_v(tags, all_tags, 0, exec_conf->getMPICommunicator());
+            gather_v(members, all_members, 0, exec_conf->getMPICommunicator());
+            gather_v(typeval, all_typeval, 0, exec_conf->getMPICommunicator());
+
+            tags.clear();
+            members.clear();
+            typeval.clear();
+            for (unsigned int i = 0; i < all_tags.size(); i++)
+                {
+                tags.insert(tags.end(), all_tags[i].begin(), all_tags[i].end());
+                members.insert(members.end(), all_members[i].begin(), all_members[i].end());
+                typeval.insert(typeval.end(), all_typeval[i].begin(), all_typeval[i].end());
+                }
+            }
+        #endif
+
+        typename GroupData::Snapshot snapshot;
+        if (exec_conf->getRank() == 0)
+            {
+            std::vector<unsigned int> order(tags.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return tags[a] < tags[b]; });
+
+            snapshot.resize((unsigned int)tags.size());
+            snapshot.type_mapping = getTypeMapping(group_data);
+            for (unsigned int i = 0; i < order.size(); i++)
+                {
+                snapshot.groups[i] = members[order[i]];
+                if (has_type_mapping)
+                    snapshot.type_id[i] = typeval[order[i]].type;
+                else
+                    snapshot.val[i] = typeval[order[i]].val;
+                }
+            }
+
+        group_data->initializeFromSnapshot(snapshot);
+        }
+    };
+}
+
+/*! \param sysdef System definition containing the state to write
+    \param fname Prefix of the file names, the rank is appended to it
+*/
+CheckpointWriter::CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname)
+    : Analyzer(sysdef), m_fname(fname)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointWriter: " << m_fname << endl;
+    }
+
+CheckpointWriter::~CheckpointWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying CheckpointWriter" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void CheckpointWriter::analyze(uint64_t timestep)
+    {
+    if (m_prof)
+        m_prof->push("Checkpoint");
+
+    const std::string fname = getFileName(m_fname, m_exec_conf->getRank());
+    const std::string tmp_fname = fname + ".tmp";
+    std::ofstream f(tmp_fname.c_str(), std::ios::binary | std::ios::trunc);
+    if (!f.good())
+        {
+        m_exec_conf->msg->error() << "write.Checkpoint: Unable to open " << tmp_fname << endl;
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    CheckpointHeader header;
+    header.n_files = m_exec_conf->getNRanks();
+    header.timestep = timestep;
+    header.dimensions = m_sysdef->getNDimensions();
+    const BoxDim& box = m_pdata->getGlobalBox();
+    header.L = box.getL();
+    header.tilt = make_scalar3(box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ());
+    header.tag_end = m_pdata->getTagEnd();
+    header.removed_tags.assign(m_pdata->getRemovedTags().begin(), m_pdata->getRemovedTags().end());
+    header.type_mapping[0] = getTypeMapping(m_pdata);
+    header.type_mapping[1] = getTypeMapping(m_sysdef->getBondData());
+    header.type_mapping[2] = getTypeMapping(m_sysdef->getAngleData());
+    header.type_mapping[3] = getTypeMapping(m_sysdef->getDihedralData());
+    header.type_mapping[4] = getTypeMapping(m_sysdef->getImproperData());
+    header.type_mapping[5] = getTypeMapping(m_sysdef->getPairData());
+    std::shared_ptr<IntegratorData> integrator_data = m_sysdef->getIntegratorData();
+    for (unsigned int i = 0; i < integrator_data->getNumIntegrators(); i++)
+        header.integrator_variables.push_back(integrator_data->getIntegratorVariables(i));
+    writeHeader(f, header);
+
+    // pack the local particles, in the same way as for the migration between ranks
+    std::vector<pdata_element> particles(m_pdata->getN());
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        unsigned int net_virial_pitch = (unsigned int)m_pdata->getNetVirial().getPitch();
+        for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+            {
+            pdata_element& p = particles[idx];
+            p.pos = h_pos.data[idx];
+            p.vel = h_vel.data[idx];
+            p.accel = h_accel.data[idx];
+            p.charge = h_charge.data[idx];
+            p.diameter = h_diameter.data[idx];
+            p.image = h_image.data[idx];
+            p.body = h_body.data[idx];
+            p.orientation = h_orientation.data[idx];
+            p.angmom = h_angmom.data[idx];
+            p.inertia = h_inertia.data[idx];
+            p.tag = h_tag.data[idx];
+            p.net_force = h_net_force.data[idx];
+            p.net_torque = h_net_torque.data[idx];
+            for (unsigned int j = 0; j < 6; j++)
+                p.net_virial[j] = h_net_virial.data[net_virial_pitch*j+idx];
+            }
+        }
+    writeVector(f, particles);
+
+    writeGroups(f, m_sysdef->getBondData(), m_pdata);
+    writeGroups(f, m_sysdef->getAngleData(), m_pdata);
+    writeGroups(f, m_sysdef->getDihedralData(), m_pdata);
+    writeGroups(f, m_sysdef->getImproperData(), m_pdata);
+    writeGroups(f, m_sysdef->getConstraintData(), m_pdata);
+    writeGroups(f, m_sysdef->getPairData(), m_pdata);
+
+    f.close();
+    if (!f.good())
+        {
+        m_exec_conf->msg->error() << "write.Checkpoint: Error writing " << tmp_fname << endl;
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    // replace the previous checkpoint only once every rank has written its file
+    #ifdef ENABLE_MPI
+    MPI_Barrier(m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (std::rename(tmp_fname.c_str(), fname.c_str()) != 0)
+        {
+        m_exec_conf->msg->error() << "write.Checkpoint: Unable to rename " << tmp_fname << " to " << fname << endl;
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param exec_conf Execution configuration
+    \param fname Prefix of the file names, as given to CheckpointWriter
+*/
+CheckpointReader::CheckpointReader(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& fname)
+    : m_exec_conf(exec_conf), m_fname(fname), m_n_files(0), m_timestep(0)
+    {
+    m_snapshot = std::shared_ptr< SnapshotSystemData<double> >(new SnapshotSystemData<double>());
+
+    if (m_exec_conf->getRank() == 0)
+        {
+        const std::string first_fname = getFileName(m_fname, 0);
+        std::ifstream f(first_fname.c_str(), std::ios::binary);
+        if (!f.good())
+            {
+            m_exec_conf->msg->error() << "Unable to open checkpoint " << first_fname << endl;
+            throw runtime_error("Error reading checkpoint");
+            }
+
+        CheckpointHeader header;
+        readHeader(f, header, first_fname);
+        m_n_files = header.n_files;
+        m_timestep = header.timestep;
+
+        m_snapshot->dimensions = header.dimensions;
+        m_snapshot->global_box = BoxDim(header.L.x, header.L.y, header.L.z);
+        m_snapshot->global_box.setTiltFactors(header.tilt.x, header.tilt.y, header.tilt.z);
+        m_snapshot->particle_data.type_mapping = header.type_mapping[0];
+        m_snapshot->bond_data.type_mapping = header.type_mapping[1];
+        m_snapshot->angle_data.type_mapping = header.type_mapping[2];
+        m_snapshot->dihedral_data.type_mapping = header.type_mapping[3];
+        m_snapshot->improper_data.type_mapping = header.type_mapping[4];
+        m_snapshot->pair_data.type_mapping = header.type_mapping[5];
+        }
+
+    #ifdef ENABLE_MPI
+    bcast(m_n_files, 0, m_exec_conf->getMPICommunicator());
+    bcast(m_timestep, 0, m_exec_conf->getMPICommunicator());
+    #endif
+    }
+
+/*! \param sysdef System definition constructed from getSnapshot()
+*/
+void CheckpointReader::restore(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    CheckpointHeader header;
+    std::vector<pdata_element> particles;
+    CheckpointGroups<BondData> bonds;
+    CheckpointGroups<AngleData> angles;
+    CheckpointGroups<DihedralData> dihedrals;
+    CheckpointGroups<ImproperData> impropers;
+    CheckpointGroups<ConstraintData> constraints;
+    CheckpointGroups<PairData> pairs;
+
+    for (unsigned int file = m_exec_conf->getRank(); file < m_n_files; file += m_exec_conf->getNRanks())
+        {
+        const std::string fname = getFileName(m_fname, file);
+        std::ifstream f(fname.c_str(), std::ios::binary);
+        if (!f.good())
+            {
+            m_exec_conf->msg->error() << "Unable to open checkpoint " << fname << endl;
+            throw runtime_error("Error reading checkpoint");
+            }
+
+        readHeader(f, header, fname);
+        if (header.n_files != m_n_files || header.timestep != m_timestep)
+            {
+            m_exec_conf->msg->error() << fname << " belongs to a different checkpoint" << endl;
+            throw runtime_error("Error reading checkpoint");
+            }
+
+        std::vector<pdata_element> file_particles;
+        readVector(f, file_particles);
+        particles.insert(particles.end(), file_particles.begin(), file_particles.end());
+
+        bonds.read(f);
+        angles.read(f);
+        dihedrals.read(f);
+        impropers.read(f);
+        constraints.read(f);
+        pairs.read(f);
+
+        if (!f.good())
+            {
+            m_exec_conf->msg->error() << "Unexpected end of checkpoint " << fname << endl;
+            throw runtime_error("Error reading checkpoint");
+            }
+        }
+
+    // ranks without a file need the replicated part of the header from the root
+    #ifdef ENABLE_MPI
+    bcast(header.tag_end, 0, m_exec_conf->getMPICommunicator());
+    bcast(header.removed_tags, 0, m_exec_conf->getMPICommunicator());
+    bcast(header.integrator_variables, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    unsigned int n_particles = (unsigned int)particles.size();
+    #ifdef ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &n_particles, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+    #endif
+    if (n_particles != header.tag_end - header.removed_tags.size())
+        {
+        m_exec_conf->msg->error() << "The checkpoint " << m_fname << " is incomplete" << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    pdata->loadLocalParticles(particles,
+                              header.tag_end,
+                              std::set<unsigned int>(header.removed_tags.begin(), header.removed_tags.end()));
+
+    bonds.restore(sysdef->getBondData(), true, m_exec_conf);
+    angles.restore(sysdef->getAngleData(), true, m_exec_conf);
+    dihedrals.restore(sysdef->getDihedralData(), true, m_exec_conf);
+    impropers.restore(sysdef->getImproperData(), true, m_exec_conf);
+    constraints.restore(sysdef->getConstraintData(), false, m_exec_conf);
+    pairs.restore(sysdef->getPairData(), true, m_exec_conf);
+
+    // integrators constructed later find their variables by their order of registration
+    std::shared_ptr<IntegratorData> integrator_data = sysdef->getIntegratorData();
+    integrator_data->load((unsigned int)header.integrator_variables.size());
+    for (unsigned int i = 0; i < header.integrator_variables.size(); i++)
+        integrator_data->setIntegratorVariables(i, header.integrator_variables[i]);
+    }
+
+void export_Checkpoint(py::module& m)
+    {
+    py::class_<CheckpointWriter, Analyzer, std::shared_ptr<CheckpointWriter> >(m, "CheckpointWriter")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::string >())
+        .def_property_readonly("filename", &CheckpointWriter::getFilename)
+        ;
+
+    py::class_<CheckpointReader, std::shared_ptr<CheckpointReader> >(m, "CheckpointReader")
+        .def(py::init< std::shared_ptr<const ExecutionConfiguration>, std::string >())
+        .def("getTimeStep", &CheckpointReader::getTimeStep)
+        .def("getSnapshot", &CheckpointReader::getSnapshot)
+        .def("restore", &CheckpointReader::restore)
+        ;
+    }
@@ -0,0 +1,98 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include "Analyzer.h"
+#include "SnapshotSystemData.h"
+
+#include <string>
+#include <memory>
+
+/*! \file Checkpoint.h
+    \brief Declares the CheckpointWriter and CheckpointReader classes
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+//! Writes the full state of the system to binary checkpoint files
+/*! Every rank writes its own file \a fname.<rank>, so the ranks write in parallel and the state is never gathered.
+    A file holds a header with the box, the type names, the particle tags in use and the integrator variables,
+    followed by the raw local particle data (including the net forces) and the bonded groups whose first member is
+    local. Files are written under a temporary name and renamed once all ranks have finished, so a preempted job
+    leaves the previous checkpoint intact.
+
+    The checkpoint stores values in the native byte order and precision and is meant to be read back by the same
+    build of HOOMD with CheckpointReader.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT CheckpointWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname);
+
+        //! Destructor
+        ~CheckpointWriter();
+
+        //! Write the checkpoint of the current timestep
+        void analyze(uint64_t timestep);
+
+        //! Get the file name
+        std::string getFilename() const
+            {
+            return m_fname;
+            }
+
+    private:
+        std::string m_fname;    //!< Prefix of the checkpoint file names
+    };
+
+//! Reads the checkpoint files written by CheckpointWriter
+/*! CheckpointReader provides an empty snapshot with the box and the type names of the checkpoint to construct the
+    SystemDefinition, and restore() then loads the particles, bonded groups and integrator variables into it. Rank r
+    reads the files r, r + n_ranks, ... so a checkpoint can be read by any number of ranks. With the same domain
+    decomposition as the writer, every particle is read on the rank that wrote it and the restart is bit exact. With
+    a different one, Communicator::migrateParticlesToDomains() sends the particles to their domains after restore().
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT CheckpointReader
+    {
+    public:
+        //! Open the checkpoint and read its header
+        CheckpointReader(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& fname);
+
+        //! Get the timestep of the checkpoint
+        uint64_t getTimeStep() const
+            {
+            return m_timestep;
+            }
+
+        //! Get a snapshot with the box and type names of the checkpoint, and no particles
+        std::shared_ptr< SnapshotSystemData<double> > getSnapshot() const
+            {
+            return m_snapshot;
+            }
+
+        //! Load the particles, bonded groups and integrator variables of the checkpoint
+        void restore(std::shared_ptr<SystemDefinition> sysdef);
+
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< The execution configuration
+        std::string m_fname;                                          //!< Prefix of the checkpoint file names
+        unsigned int m_n_files;                                       //!< Number of files in the checkpoint
+        uint64_t m_timestep;                                          //!< Timestep of the checkpoint
+        std::shared_ptr< SnapshotSystemData<double> > m_snapshot;   //!< Empty snapshot of the system
+    };
+
+//! Exports the CheckpointWriter and CheckpointReader classes to python
+void export_Checkpoint(pybind11::module& m);
+
+#endif
@@ -0,0 +1,241 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CheckpointRing.cc
+    \brief Defines the CheckpointRing class
+*/
+
+#include "CheckpointRing.h"
+
+#ifdef ENABLE_HIP
+#include "CheckpointRing.cuh"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+/*! \param sysdef System definition to save and restore
+    \param depth Maximum number of checkpoints
+*/
+CheckpointRing::CheckpointRing(std::shared_ptr<SystemDefinition> sysdef, unsigned int depth)
+    : m_sysdef(sysdef), m_pdata(sysdef->getParticleData()), m_exec_conf(m_pdata->getExecConf()),
+      m_newest(0), m_n_checkpoints(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointRing" << endl;
+
+    if (depth == 0)
+        {
+        m_exec_conf->msg->error() << "The checkpoint ring must hold at least one checkpoint" << endl;
+        throw runtime_error("Error initializing CheckpointRing");
+        }
+
+    m_slots.resize(depth);
+
+    GlobalArray<unsigned int> flag(1, m_exec_conf);
+    m_flag.swap(flag);
+    TAG_ALLOCATION(m_flag);
+    }
+
+CheckpointRing::~CheckpointRing()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying CheckpointRing" << endl;
+    }
+
+/*! \param dst Destination array
+    \param src Source array
+    \param N Number of elements to copy
+*/
+template<class T>
+void CheckpointRing::copyArray(const GlobalArray<T>& dst, const GlobalArray<T>& src, unsigned int N)
+    {
+    #ifdef ENABLE_HIP
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        ArrayHandle<T> d_src(src, access_location::device, access_mode::read);
+        ArrayHandle<T> d_dst(dst, access_location::device, access_mode::overwrite);
+        hipMemcpy(d_dst.data, d_src.data, sizeof(T)*N, hipMemcpyDeviceToDevice);
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        return;
+        }
+    #endif
+
+    ArrayHandle<T> h_src(src, access_location::host, access_mode::read);
+    ArrayHandle<T> h_dst(dst, access_location::host, access_mode::overwrite);
+    std::copy(h_src.data, h_src.data + N, h_dst.data);
+    }
+
+/*! \param dst Array of a slot
+    \param src Particle data array
+    \param N Number of elements to copy
+
+    The arrays of the slots are allocated with the capacity of the particle data, so that they are only reallocated
+    when the particle data grows.
+*/
+template<class T>
+void CheckpointRing::saveArray(GlobalArray<T>& dst, const GlobalArray<T>& src, unsigned int N)
+    {
+    if (dst.getNumElements() < N)
+        {
+        GlobalArray<T> array(std::max(N, m_pdata->getMaxN()), m_exec_conf);
+        dst.swap(array);
+        TAG_ALLOCATION(dst);
+        }
+
+    copyArray(dst, src, N);
+    }
+
+/*! \param timestep Current timestep
+*/
+void CheckpointRing::save(uint64_t timestep)
+    {
+    // the oldest checkpoint is overwritten when the ring is full
+    if (m_n_checkpoints > 0)
+        m_newest = (m_newest + 1) % m_slots.size();
+    m_n_checkpoints = std::min(m_n_checkpoints + 1, (unsigned int)m_slots.size());
+
+    Slot& slot = m_slots[m_newest];
+    const unsigned int N = m_pdata->getN();
+
+    slot.timestep = timestep;
+    slot.N = N;
+    slot.N_global = m_pdata->getNGlobal();
+    slot.global_box = m_pdata->getGlobalBox();
+
+    std::shared_ptr<IntegratorData> integrator_data = m_sysdef->getIntegratorData();
+    slot.integrator_variables.clear();
+    for (unsigned int i = 0; i < integrator_data->getNumIntegrators(); i++)
+        slot.integrator_variables.push_back(integrator_data->getIntegratorVariables(i));
+
+    saveArray(slot.pos, m_pdata->getPositions(), N);
+    saveArray(slot.vel, m_pdata->getVelocities(), N);
+    saveArray(slot.accel, m_pdata->getAccelerations(), N);
+    saveArray(slot.charge, m_pdata->getCharges(), N);
+    saveArray(slot.diameter, m_pdata->getDiameters(), N);
+    saveArray(slot.image, m_pdata->getImages(), N);
+    saveArray(slot.tag, m_pdata->getTags(), N);
+    saveArray(slot.body, m_pdata->getBodies(), N);
+    saveArray(slot.orientation, m_pdata->getOrientationArray(), N);
+    saveArray(slot.angmom, m_pdata->getAngularMomentumArray(), N);
+    saveArray(slot.inertia, m_pdata->getMomentsOfInertiaArray(), N);
+    }
+
+/*! \param age 0 for the newest checkpoint, 1 for the one before it, ...
+    \returns The timestep of the restored checkpoint
+
+    The checkpoints newer than the restored one are discarded, the restored one is kept. The caller resets the
+    timestep, migrates the particles with MPI and recomputes the forces.
+*/
+uint64_t CheckpointRing::restore(unsigned int age)
+    {
+    if (age >= m_n_checkpoints)
+        {
+        m_exec_conf->msg->error() << "The checkpoint ring holds " << m_n_checkpoints << " checkpoints, cannot "
+                                  << "restore checkpoint " << age << endl;
+        throw runtime_error("Error restoring checkpoint");
+        }
+
+    m_newest = slotIndex(age);
+    m_n_checkpoints -= age;
+    const Slot& slot = m_slots[m_newest];
+
+    if (slot.N_global != m_pdata->getNGlobal())
+        {
+        m_exec_conf->msg->error() << "Particles were added or removed since the checkpoint of step " << slot.timestep
+                                  << ", cannot roll back" << endl;
+        throw runtime_error("Error restoring checkpoint");
+        }
+
+    if (m_pdata->getGlobalBox() != slot.global_box)
+        m_pdata->setGlobalBox(slot.global_box);
+
+    std::shared_ptr<IntegratorData> integrator_data = m_sysdef->getIntegratorData();
+    for (unsigned int i = 0; i < slot.integrator_variables.size() && i < integrator_data->getNumIntegrators(); i++)
+        integrator_data->setIntegratorVariables(i, slot.integrator_variables[i]);
+
+    const unsigned int N = slot.N;
+    m_pdata->setNLocal(N);
+
+    copyArray(m_pdata->getPositions(), slot.pos, N);
+    copyArray(m_pdata->getVelocities(), slot.vel, N);
+    copyArray(m_pdata->getAccelerations(), slot.accel, N);
+    copyArray(m_pdata->getCharges(), slot.charge, N);
+    copyArray(m_pdata->getDiameters(), slot.diameter, N);
+    copyArray(m_pdata->getImages(), slot.image, N);
+    copyArray(m_pdata->getTags(), slot.tag, N);
+    copyArray(m_pdata->getBodies(), slot.body, N);
+    copyArray(m_pdata->getOrientationArray(), slot.orientation, N);
+    copyArray(m_pdata->getAngularMomentumArray(), slot.angmom, N);
+    copyArray(m_pdata->getMomentsOfInertiaArray(), slot.inertia, N);
+
+        {
+        // the particles may have been reordered or migrated since the checkpoint
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+        std::fill(h_rtag.data, h_rtag.data + m_pdata->getRTags().getNumElements(), NOT_LOCAL);
+        for (unsigned int i = 0; i < N; i++)
+            h_rtag.data[h_tag.data[i]] = i;
+        }
+
+    m_pdata->notifyParticleSort();
+    m_pdata->invalidateDisplacementBound();
+
+    return slot.timestep;
+    }
+
+/*! \returns false when any rank has a particle with a non-finite position or velocity
+*/
+bool CheckpointRing::isStateValid()
+    {
+    const unsigned int N = m_pdata->getN();
+    bool valid = true;
+
+    #ifdef ENABLE_HIP
+    if (m_exec_conf->isCUDAEnabled())
+        {
+            {
+            ArrayHandle<unsigned int> h_flag(m_flag, access_location::host, access_mode::overwrite);
+            *h_flag.data = 0;
+            }
+
+            {
+            ArrayHandle<unsigned int> d_flag(m_flag, access_location::device, access_mode::readwrite);
+            ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+            ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+            gpu_check_finite(d_flag.data, d_pos.data, d_vel.data, N);
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+
+        ArrayHandle<unsigned int> h_flag(m_flag, access_location::host, access_mode::read);
+        valid = *h_flag.data == 0;
+        }
+    else
+    #endif
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N && valid; i++)
+            {
+            const Scalar4 pos = h_pos.data[i];
+            const Scalar4 vel = h_vel.data[i];
+            valid = std::isfinite(pos.x) && std::isfinite(pos.y) && std::isfinite(pos.z)
+                && std::isfinite(vel.x) && std::isfinite(vel.y) && std::isfinite(vel.z);
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        int local_valid = valid ? 1 : 0;
+        int global_valid = 1;
+        MPI_Allreduce(&local_valid, &global_valid, 1, MPI_INT, MPI_MIN, m_exec_conf->getMPICommunicator());
+        valid = global_valid > 0;
+        }
+    #endif
+
+    return valid;
+    }
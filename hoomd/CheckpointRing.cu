@@ -0,0 +1,50 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "CheckpointRing.cuh"
+
+/*! \file CheckpointRing.cu
+    \brief Defines GPU kernel drivers used by the CheckpointRing class
+*/
+
+//! Kernel to flag non-finite positions and velocities
+/*! \param d_flag Set to 1 when any particle has a non-finite position or velocity
+    \param d_pos Particle positions
+    \param d_vel Particle velocities
+    \param N Number of particles
+
+    One thread per particle. \a d_flag is only ever written with 1, so the concurrent writes do not race.
+*/
+__global__ void gpu_check_finite_kernel(unsigned int *d_flag,
+                                        const Scalar4 *d_pos,
+                                        const Scalar4 *d_vel,
+                                        const unsigned int N)
+    {
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N)
+        return;
+
+    const Scalar4 pos = d_pos[idx];
+    const Scalar4 vel = d_vel[idx];
+    if (!isfinite(pos.x) || !isfinite(pos.y) || !isfinite(pos.z)
+        || !isfinite(vel.x) || !isfinite(vel.y) || !isfinite(vel.z))
+        {
+        *d_flag = 1;
+        }
+    }
+
+/*! \param d_flag Flag to set when any particle has a non-finite position or velocity, must be zeroed by the caller
+    \param d_pos Particle positions
+    \param d_vel Particle velocities
+    \param N Number of particles
+*/
+hipError_t gpu_check_finite(unsigned int *d_flag,
+                            const Scalar4 *d_pos,
+                            const Scalar4 *d_vel,
+                            const unsigned int N)
+    {
+    const unsigned int block_size = 256;
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_check_finite_kernel), dim3(N/block_size + 1), dim3(block_size), 0, 0,
+                       d_flag, d_pos, d_vel, N);
+    return hipSuccess;
+    }
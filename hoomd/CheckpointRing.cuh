@@ -0,0 +1,21 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CheckpointRing.cuh
+    \brief Declares GPU kernel drivers used by the CheckpointRing class
+*/
+
+#ifndef __CHECKPOINT_RING_CUH__
+#define __CHECKPOINT_RING_CUH__
+
+#include <hip/hip_runtime.h>
+
+#include "HOOMDMath.h"
+
+//! Flag the particles with non-finite positions or velocities
+hipError_t gpu_check_finite(unsigned int *d_flag,
+                            const Scalar4 *d_pos,
+                            const Scalar4 *d_vel,
+                            const unsigned int N);
+
+#endif
@@ -0,0 +1,120 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CheckpointRing.h
+    \brief Declares the CheckpointRing class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __CHECKPOINT_RING_H__
+#define __CHECKPOINT_RING_H__
+
+#include "SystemDefinition.h"
+#include "GlobalArray.h"
+
+#include <memory>
+#include <vector>
+
+//! Keeps the last few states of the system in memory to roll back to
+/*! CheckpointRing holds up to \a depth checkpoints of the local particle data, the global box and the integrator
+    variables. A checkpoint copies the particle data arrays into arrays of the ring, device to device when the GPU is
+    enabled, so that it costs about as much as one particle sort. The oldest checkpoint is overwritten when the ring is
+    full.
+
+    restore() copies a checkpoint back and discards the newer ones. Because the random number streams of HOOMD are
+    keyed on the timestep, the state at the timestep of the checkpoint is restored completely. The rtag array is
+    rebuilt on the host, which is acceptable because rollbacks are rare. The particle data has to hold the same
+    particles as at the checkpoint: rolling back across the insertion or removal of particles is an error.
+
+    With MPI, every rank keeps the checkpoints of its own particles, and all ranks must save and restore together.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT CheckpointRing
+    {
+    public:
+        //! Construct an empty ring
+        CheckpointRing(std::shared_ptr<SystemDefinition> sysdef, unsigned int depth);
+
+        //! Destructor
+        ~CheckpointRing();
+
+        //! Save the current state, overwriting the oldest checkpoint when the ring is full
+        void save(uint64_t timestep);
+
+        //! Restore a checkpoint and discard the newer ones
+        uint64_t restore(unsigned int age);
+
+        //! Test if all positions and velocities are finite on all ranks
+        bool isStateValid();
+
+        //! Get the number of checkpoints in the ring
+        unsigned int getNumCheckpoints() const
+            {
+            return m_n_checkpoints;
+            }
+
+        //! Get the maximum number of checkpoints
+        unsigned int getDepth() const
+            {
+            return (unsigned int)m_slots.size();
+            }
+
+        //! Get the timestep of a checkpoint
+        /*! \param age 0 for the newest checkpoint, 1 for the one before it, ...
+        */
+        uint64_t getTimeStep(unsigned int age) const
+            {
+            return m_slots[slotIndex(age)].timestep;
+            }
+
+    private:
+        //! State of the system at one timestep
+        struct Slot
+            {
+            uint64_t timestep = 0;                                  //!< Timestep of the checkpoint
+            unsigned int N = 0;                                     //!< Number of local particles
+            unsigned int N_global = 0;                              //!< Number of particles on all ranks
+            BoxDim global_box;                                      //!< Global box
+            std::vector<IntegratorVariables> integrator_variables;  //!< Variables of the registered integrators
+
+            GlobalArray<Scalar4> pos;           //!< Positions and types
+            GlobalArray<Scalar4> vel;           //!< Velocities and masses
+            GlobalArray<Scalar3> accel;         //!< Accelerations
+            GlobalArray<Scalar> charge;         //!< Charges
+            GlobalArray<Scalar> diameter;       //!< Diameters
+            GlobalArray<int3> image;            //!< Images
+            GlobalArray<unsigned int> tag;      //!< Tags
+            GlobalArray<unsigned int> body;     //!< Rigid body ids
+            GlobalArray<Scalar4> orientation;   //!< Orientations
+            GlobalArray<Scalar4> angmom;        //!< Angular momenta
+            GlobalArray<Scalar3> inertia;       //!< Moments of inertia
+            };
+
+        std::shared_ptr<SystemDefinition> m_sysdef;                     //!< System definition
+        std::shared_ptr<ParticleData> m_pdata;                          //!< Particle data
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf;      //!< Execution configuration
+        std::vector<Slot> m_slots;          //!< Checkpoints
+        unsigned int m_newest;              //!< Index of the newest checkpoint in m_slots
+        unsigned int m_n_checkpoints;       //!< Number of valid checkpoints
+        GlobalArray<unsigned int> m_flag;   //!< Flag for the validity check on the GPU
+
+        //! Get the index in m_slots of a checkpoint
+        unsigned int slotIndex(unsigned int age) const
+            {
+            return (unsigned int)((m_newest + m_slots.size() - age) % m_slots.size());
+            }
+
+        //! Copy the first \a N elements of an array
+        template<class T>
+        void copyArray(const GlobalArray<T>& dst, const GlobalArray<T>& src, unsigned int N);
+
+        //! Copy the first \a N elements of an array into an array of a slot, growing it as needed
+        template<class T>
+        void saveArray(GlobalArray<T>& dst, const GlobalArray<T>& src, unsigned int N);
+    };
+
+#endif
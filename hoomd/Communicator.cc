@@ -14,6 +14,7 @@
 #include "HOOMDMPI.h"
 
 #include <algorithm>
+#include <cmath>
 #include <pybind11/stl.h>
 #include <cstddef>
 
@@ -21,6 +22,9 @@
 using namespace std;
 namespace py = pybind11;
 
+//! Number of quantization steps per unit of fractional coordinates in quantized ghost position updates
+const Scalar GHOST_QUANTIZATION_SCALE = Scalar(1 << 30);
+
 #include <vector>
 
 template<class group_data>
@@ -53,6 +57,14 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
         // remove ghost groups
         m_gdata->removeAllGhostGroups();
 
+        // between changes of the group table, only the groups of migrating particles need to be visited
+        bool incremental = !incomplete
+            && m_tag_group_offsets.size() == m_comm.m_pdata->getRTags().getNumElements() + 1;
+        if (incremental)
+            findMigratingGroups();
+
+        unsigned int n_visit = incremental ? (unsigned int)m_migrating_groups.size() : m_gdata->getN();
+
         // send map for rank updates
         typedef std::multimap<unsigned int, rank_element_t> map_t;
         map_t send_map;
@@ -73,9 +85,9 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             unsigned int my_rank = m_exec_conf->getRank();
 
             // mark groups whose member ranks need to be updated
-            unsigned int n_groups = m_gdata->getN();
-            for (unsigned int group_idx = 0; group_idx < n_groups; group_idx++)
+            for (unsigned int visit_idx = 0; visit_idx < n_visit; visit_idx++)
                 {
+                unsigned int group_idx = incremental ? m_migrating_groups[visit_idx] : visit_idx;
                 typename group_data::members_t g = h_members.data[group_idx];
                 typename group_data::ranks_t r = h_group_ranks.data[group_idx];
 
@@ -354,6 +366,9 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
         typedef std::multimap<unsigned int, group_element_t> group_map_t;
         group_map_t group_send_map;
 
+        // index of the first group that is no longer local
+        unsigned int first_removed = m_gdata->getN();
+
             {
             ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
             ArrayHandle<typeval_t> h_group_typeval(m_gdata->getTypeValArray(), access_location::host, access_mode::read);
@@ -363,10 +378,9 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_comm_flags(m_comm.m_pdata->getCommFlags(), access_location::host, access_mode::read);
 
-            unsigned int ngroups = m_gdata->getN();
-
-            for (unsigned int group_idx = 0; group_idx < ngroups; group_idx++)
+            for (unsigned int visit_idx = 0; visit_idx < n_visit; visit_idx++)
                 {
+                unsigned int group_idx = incremental ? m_migrating_groups[visit_idx] : visit_idx;
                 unsigned int mask = 0;
 
                 typename group_data::members_t members = h_groups.data[group_idx];
@@ -417,57 +431,47 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
 
                     // if group is no longer local, flag for removal
                     if (!is_local)
+                        {
                         h_group_rtag.data[el.group_tag] = GROUP_NOT_LOCAL;
+                        first_removed = std::min(first_removed, group_idx);
+                        }
                     }
                 } // end loop over groups
             }
 
-        unsigned int new_ngroups;
+        unsigned int new_ngroups = first_removed;
             {
-            ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
-            ArrayHandle<typeval_t> h_group_typeval(m_gdata->getTypeValArray(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::read);
-
-            // access alternate arrays to write to
-            ArrayHandle<typename group_data::members_t> h_groups_alt(m_gdata->getAltMembersArray(), access_location::host, access_mode::overwrite);
-            ArrayHandle<typeval_t> h_group_typeval_alt(m_gdata->getAltTypeValArray(), access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_group_tag_alt(m_gdata->getAltTags(), access_location::host, access_mode::overwrite);
-            ArrayHandle<typename group_data::ranks_t> h_group_ranks_alt(m_gdata->getAltRanksArray(), access_location::host, access_mode::overwrite);
+            // compact the group arrays in place, the groups before the first removed one keep their index
+            ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::readwrite);
+            ArrayHandle<typeval_t> h_group_typeval(m_gdata->getTypeValArray(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::readwrite);
+            ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
 
             // access rtags
             ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
 
             unsigned int ngroups = m_gdata->getN();
-            unsigned int n = 0;
-            for (unsigned int group_idx = 0; group_idx < ngroups; group_idx++)
+            unsigned int n = first_removed;
+            for (unsigned int group_idx = first_removed; group_idx < ngroups; group_idx++)
                 {
                 unsigned int group_tag = h_group_tag.data[group_idx];
                 bool keep = h_group_rtag.data[group_tag] != GROUP_NOT_LOCAL;
 
                 if (keep)
                     {
-                    h_groups_alt.data[n] = h_groups.data[group_idx];
-                    h_group_typeval_alt.data[n] = h_group_typeval.data[group_idx];
-                    h_group_tag_alt.data[n] = group_tag;
-                    h_group_ranks_alt.data[n] = h_group_ranks.data[group_idx];
+                    h_groups.data[n] = h_groups.data[group_idx];
+                    h_group_typeval.data[n] = h_group_typeval.data[group_idx];
+                    h_group_tag.data[n] = group_tag;
+                    h_group_ranks.data[n] = h_group_ranks.data[group_idx];
 
                     // rebuild rtags
                     h_group_rtag.data[group_tag] = n++;
                     }
                 }
 
-                new_ngroups = n;
+            new_ngroups = n;
             }
 
-
-        // make alternate arrays current
-        m_gdata->swapMemberArrays();
-        m_gdata->swapTypeArrays();
-        m_gdata->swapTagArrays();
-        m_gdata->swapRankArrays();
-
-
         assert(new_ngroups <= m_gdata->getN());
 
         // resize group arrays
@@ -671,6 +675,10 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
 
                         // update reverse-lookup table
                         h_group_rtag.data[tag] = add_idx++;
+
+                        // the group is not yet in the index of groups by particle
+                        if (incremental)
+                            m_new_group_tags.push_back(tag);
                         }
                     else
                         {
@@ -688,10 +696,90 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
         // resize arrays to final size
         m_gdata->removeGroups(nremove);
 
+        // rebuild the index when the table changed, or when too many groups were received since it was built
+        if (!incremental || m_new_group_tags.size() > m_gdata->getN()/4)
+            buildGroupIndex();
+
         if (m_comm.m_prof) m_comm.m_prof->pop();
         }
     }
 
+/*! The index lists the tags of the local groups of every particle tag in compressed sparse row format. It is built
+    from the local groups after a migration that visited all groups. Later migrations look up the groups of the
+    migrating particles in the index. Groups that left the rank remain listed (their rtag is GROUP_NOT_LOCAL), groups
+    that arrived are listed in m_new_group_tags until the index is rebuilt.
+*/
+template<class group_data>
+void Communicator::GroupCommunicator<group_data>::buildGroupIndex()
+    {
+    const unsigned int n_tags = m_comm.m_pdata->getRTags().getNumElements();
+    const unsigned int ngroups = m_gdata->getN();
+
+    ArrayHandle<typename group_data::members_t> h_members(m_gdata->getMembersArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
+
+    // count the groups of every particle
+    m_tag_group_offsets.assign(n_tags + 1, 0);
+    for (unsigned int group_idx = 0; group_idx < ngroups; group_idx++)
+        for (unsigned int i = 0; i < group_data::size; ++i)
+            m_tag_group_offsets[h_members.data[group_idx].tag[i] + 1]++;
+
+    for (unsigned int tag = 0; tag < n_tags; ++tag)
+        m_tag_group_offsets[tag + 1] += m_tag_group_offsets[tag];
+
+    // fill the rows, using the row starts of the next particle as insertion points
+    m_tag_group_tags.resize(m_tag_group_offsets[n_tags]);
+    for (unsigned int group_idx = 0; group_idx < ngroups; group_idx++)
+        for (unsigned int i = 0; i < group_data::size; ++i)
+            m_tag_group_tags[m_tag_group_offsets[h_members.data[group_idx].tag[i]]++] = h_group_tag.data[group_idx];
+
+    // shift the offsets back to the row starts
+    for (unsigned int tag = n_tags; tag > 0; --tag)
+        m_tag_group_offsets[tag] = m_tag_group_offsets[tag - 1];
+    m_tag_group_offsets[0] = 0;
+
+    m_new_group_tags.clear();
+    }
+
+/*! Fills m_migrating_groups with the sorted, unique local indices of the groups that have a member flagged for
+    migration, and of the groups received since the index was built.
+*/
+template<class group_data>
+void Communicator::GroupCommunicator<group_data>::findMigratingGroups()
+    {
+    m_migrating_groups.clear();
+
+    ArrayHandle<unsigned int> h_comm_flags(m_comm.m_pdata->getCommFlags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_comm.m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::read);
+
+    for (unsigned int pidx = 0; pidx < m_comm.m_pdata->getN(); ++pidx)
+        {
+        if (!h_comm_flags.data[pidx])
+            continue;
+
+        unsigned int tag = h_tag.data[pidx];
+        for (unsigned int j = m_tag_group_offsets[tag]; j < m_tag_group_offsets[tag + 1]; ++j)
+            {
+            unsigned int group_idx = h_group_rtag.data[m_tag_group_tags[j]];
+            if (group_idx != GROUP_NOT_LOCAL)
+                m_migrating_groups.push_back(group_idx);
+            }
+        }
+
+    // groups without a migrating member are skipped by migrateGroups()
+    for (unsigned int group_tag : m_new_group_tags)
+        {
+        unsigned int group_idx = h_group_rtag.data[group_tag];
+        if (group_idx != GROUP_NOT_LOCAL)
+            m_migrating_groups.push_back(group_idx);
+        }
+
+    std::sort(m_migrating_groups.begin(), m_migrating_groups.end());
+    m_migrating_groups.erase(std::unique(m_migrating_groups.begin(), m_migrating_groups.end()),
+                             m_migrating_groups.end());
+    }
+
 //! Mark ghost particles
 template<class group_data>
 void Communicator::GroupCommunicator<group_data>::markGhostParticles(
@@ -1072,6 +1160,10 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_image_copybuf(m_exec_conf),
             m_velocity_copybuf(m_exec_conf),
             m_orientation_copybuf(m_exec_conf),
+            m_pos_quant_copybuf(m_exec_conf),
+            m_pos_quant_recvbuf(m_exec_conf),
+            m_pos_recvbuf(m_exec_conf),
+            m_orientation_recvbuf(m_exec_conf),
             m_plan_copybuf(m_exec_conf),
             m_tag_copybuf(m_exec_conf),
             m_netforce_copybuf(m_exec_conf),
@@ -1081,6 +1173,8 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_plan(m_exec_conf),
             m_plan_reverse(m_exec_conf),
             m_tag_reverse(m_exec_conf),
+            m_ghost_reconstructed(m_exec_conf),
+            m_copy_reconstructed(m_exec_conf),
             m_netforce_reverse_copybuf(m_exec_conf),
             m_netforce_reverse_recvbuf(m_exec_conf),
             m_r_ghost_max(Scalar(0.0)),
@@ -1089,6 +1183,16 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_has_ghost_particles(false),
             m_last_flags(0),
             m_comm_pending(false),
+            m_overlap_ghost_update(false),
+            m_pending_wrap_start(0),
+            m_pending_wrap_n(0),
+            m_pending_dir(0),
+            m_quantize_ghost_positions(false),
+            m_reconstruct_ghost_bodies(false),
+            m_migration_skin(Scalar(0.0)),
+            m_migration_period(10),
+            m_n_deferred_migrations(0),
+            m_comm_time(0),
             m_bond_comm(*this, m_sysdef->getBondData()),
             m_angle_comm(*this, m_sysdef->getAngleData()),
             m_dihedral_comm(*this, m_sysdef->getDihedralData()),
@@ -1113,6 +1217,13 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
         m_copy_ghosts[dir].swap(copy_ghosts);
         m_num_copy_ghosts[dir] = 0;
         m_num_recv_ghosts[dir] = 0;
+
+        GlobalVector<unsigned int> update_ghosts(m_exec_conf);
+        m_update_ghosts[dir].swap(update_ghosts);
+        GlobalVector<unsigned int> recv_update_ghosts(m_exec_conf);
+        m_recv_update_ghosts[dir].swap(recv_update_ghosts);
+        m_num_update_ghosts[dir] = 0;
+        m_num_recv_update_ghosts[dir] = 0;
         }
 
     // All buffers corresponding to sending ghosts in reverse
@@ -1332,9 +1443,14 @@ void Communicator::initializeNeighborArrays()
 //! Interface to the communication methods.
 void Communicator::communicate(uint64_t timestep)
     {
+    const int64_t start = m_clk.getTime();
+
     // Guard to prevent recursive triggering of migration
     m_is_communicating = true;
 
+    // finish an update that was left pending by an overlapped force computation
+    completeGhostUpdate(timestep);
+
     // update ghost communication flags
     m_flags = CommFlags(0);
     m_requested_flags.emit_accumulate( [&](CommFlags f)
@@ -1375,16 +1491,30 @@ void Communicator::communicate(uint64_t timestep)
         {
         beginUpdateGhosts(timestep);
 
-        finishUpdateGhosts(timestep);
+        // in overlap mode, the update is completed by the force computes (see completeGhostUpdate())
+        if (!m_overlap_ghost_update)
+            finishUpdateGhosts(timestep);
         }
 
     // Check if migration of particles is requested
     if (migrate)
         {
+        // a forced migration may follow changes of the box or of the particle data, it cannot be deferred
+        bool defer = !m_force_migrate && m_has_ghost_particles && canDeferMigration();
         m_force_migrate = false;
 
-        // If so, migrate atoms
-        migrateParticles();
+        if (defer)
+            {
+            // particles stay with their rank, only the ghosts are exchanged again
+            m_pdata->removeAllGhostParticles();
+            m_n_deferred_migrations++;
+            }
+        else
+            {
+            // If so, migrate atoms
+            migrateParticles();
+            m_n_deferred_migrations = 0;
+            }
 
         // Construct ghost send lists, exchange ghost atom data
         exchangeGhosts();
@@ -1396,6 +1526,7 @@ void Communicator::communicate(uint64_t timestep)
         }
 
     m_is_communicating = false;
+    m_comm_time += m_clk.getTime() - start;
     }
 
 //! Transfer particles between neighboring domains
@@ -1535,6 +1666,102 @@ void Communicator::migrateParticles()
         m_prof->pop();
     }
 
+void Communicator::migrateParticlesToDomains()
+    {
+    while (true)
+        {
+        unsigned int n_outside = 0;
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            const BoxDim& box = m_pdata->getBox();
+            for (unsigned int idx = 0; idx < m_pdata->getN(); ++idx)
+                {
+                Scalar3 f = box.makeFraction(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z));
+                if (f.x < Scalar(0.0) || f.x >= Scalar(1.0)
+                    || f.y < Scalar(0.0) || f.y >= Scalar(1.0)
+                    || f.z < Scalar(0.0) || f.z >= Scalar(1.0))
+                    n_outside++;
+                }
+            }
+
+        MPI_Allreduce(MPI_IN_PLACE, &n_outside, 1, MPI_UNSIGNED, MPI_SUM, m_mpi_comm);
+        if (n_outside == 0)
+            break;
+
+        m_exec_conf->msg->notice(6) << "Communicator: migrating " << n_outside
+                                    << " particles outside of their domains" << std::endl;
+        migrateParticles();
+        }
+
+    // the ghosts need to be exchanged at the next step
+    forceMigrate();
+    }
+
+void Communicator::setMigrationSkin(Scalar skin)
+    {
+    if (skin < Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "comm: migration skin must be non-negative" << std::endl;
+        throw std::runtime_error("Error setting migration skin");
+        }
+
+    m_migration_skin = skin;
+
+    // the ghost layer width changes, and particles must be inside their domains before they can drift
+    forceMigrate();
+    }
+
+void Communicator::setMigrationPeriod(unsigned int period)
+    {
+    if (period == 0)
+        {
+        m_exec_conf->msg->error() << "comm: migration period must be positive" << std::endl;
+        throw std::runtime_error("Error setting migration period");
+        }
+
+    m_migration_period = period;
+    }
+
+/*! 
+eturns True if every rank can skip the migration
+
+    A migration can be deferred when the skin is enabled, fewer than m_migration_period - 1 migrations were deferred
+    in a row, no bonded group table needs to be rebuilt, and no local particle on any rank is further than
+    m_migration_skin outside of its domain. All ranks must call this method, since the result is reduced.
+*/
+bool Communicator::canDeferMigration()
+    {
+    if (m_migration_skin <= Scalar(0.0) || m_n_deferred_migrations + 1 >= m_migration_period)
+        return false;
+
+    // these flags are set on all ranks alike
+    if (m_bonds_changed || m_angles_changed || m_dihedrals_changed || m_impropers_changed
+        || m_constraints_changed || m_pairs_changed)
+        return false;
+
+    const BoxDim& box = m_pdata->getBox();
+    const Scalar3 skin_fraction = m_migration_skin / box.getNearestPlaneDistance();
+
+    unsigned int n_outside = 0;
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < m_pdata->getN(); ++idx)
+            {
+            Scalar3 f = box.makeFraction(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z));
+            if (f.x < -skin_fraction.x || f.x >= Scalar(1.0) + skin_fraction.x
+                || f.y < -skin_fraction.y || f.y >= Scalar(1.0) + skin_fraction.y
+                || f.z < -skin_fraction.z || f.z >= Scalar(1.0) + skin_fraction.z)
+                {
+                n_outside++;
+                break;
+                }
+            }
+        }
+
+    MPI_Allreduce(MPI_IN_PLACE, &n_outside, 1, MPI_UNSIGNED, MPI_SUM, m_mpi_comm);
+    return n_outside == 0;
+    }
+
 void Communicator::updateGhostWidth()
     {
         {
@@ -1563,6 +1790,10 @@ void Communicator::updateGhostWidth()
                                                             if (r > r_ghost_i) r_ghost_i = r;
                                                             }
                                                             ,cur_type);
+            // particles left outside of their domain by a deferred migration need neighbors further out
+            if (r_ghost_i > Scalar(0.0))
+                r_ghost_i += m_migration_skin;
+
             h_r_ghost.data[cur_type] = r_ghost_i;
             if (r_ghost_i > r_ghost_max) r_ghost_max = r_ghost_i;
             }
@@ -2086,6 +2317,9 @@ void Communicator::exchangeGhosts()
 
     m_last_flags = flags;
 
+    if (m_reconstruct_ghost_bodies)
+        exchangeGhostReconstructionFlags();
+
     /***********************************************************************************************************************************************************
      * For multi-body force fields we must allow particles to send information back through their ghosts.
      * For this purpose, we implement a system for ghosts to be sent back to their original domain with forces on them that can then be added back to the original local particle.
@@ -2341,23 +2575,68 @@ void Communicator::beginUpdateGhosts(uint64_t timestep)
 
     unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
 
+    // no ghosts are forwarded after the last direction, so its exchange may complete later in finishUpdateGhosts()
+    int last_dir = -1;
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        if (isCommunicating(dir))
+            last_dir = dir;
+        }
+
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
         if (! isCommunicating(dir) ) continue;
 
         CommFlags flags = getFlags();
+        bool defer = m_overlap_ghost_update && (int)dir == last_dir;
 
-        if (flags[comm_flag::position])
+        // positions and orientations are only sent for the ghosts that the receiver does not place itself
+        const unsigned int n_copy_update = m_reconstruct_ghost_bodies ? m_num_update_ghosts[dir]
+                                                                      : m_num_copy_ghosts[dir];
+        const unsigned int n_recv_update = m_reconstruct_ghost_bodies ? m_num_recv_update_ghosts[dir]
+                                                                      : m_num_recv_ghosts[dir];
+
+        if (flags[comm_flag::position] && m_quantize_ghost_positions)
+            {
+            m_pos_quant_copybuf.resize(n_copy_update);
+
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<int3> h_pos_quant_copybuf(m_pos_quant_copybuf, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_update_ghosts(m_update_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+            const BoxDim& global_box = m_pdata->getGlobalBox();
+            const Scalar3 origin = getGhostQuantizationOrigin(dir, true);
+
+            // quantize the offsets of the ghost positions from the shared face
+            for (unsigned int ghost_idx = 0; ghost_idx < n_copy_update; ghost_idx++)
+                {
+                unsigned int copy_idx = m_reconstruct_ghost_bodies ? h_update_ghosts.data[ghost_idx] : ghost_idx;
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[copy_idx]];
+
+                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+                Scalar4 postype = h_pos.data[idx];
+                Scalar3 f = global_box.makeFraction(make_scalar3(postype.x, postype.y, postype.z)) - origin;
+                h_pos_quant_copybuf.data[ghost_idx] = make_int3(int(std::lround(f.x*GHOST_QUANTIZATION_SCALE)),
+                                                                int(std::lround(f.y*GHOST_QUANTIZATION_SCALE)),
+                                                                int(std::lround(f.z*GHOST_QUANTIZATION_SCALE)));
+                }
+            }
+        else if (flags[comm_flag::position])
             {
             ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_update_ghosts(m_update_ghosts[dir], access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
             // copy positions of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+            for (unsigned int ghost_idx = 0; ghost_idx < n_copy_update; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int copy_idx = m_reconstruct_ghost_bodies ? h_update_ghosts.data[ghost_idx] : ghost_idx;
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[copy_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2390,12 +2669,14 @@ void Communicator::beginUpdateGhosts(uint64_t timestep)
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_update_ghosts(m_update_ghosts[dir], access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
             // copy orientation of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+            for (unsigned int ghost_idx = 0; ghost_idx < n_copy_update; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int copy_idx = m_reconstruct_ghost_bodies ? h_update_ghosts.data[ghost_idx] : ghost_idx;
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[copy_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2427,60 +2708,119 @@ void Communicator::beginUpdateGhosts(uint64_t timestep)
         size_t sz = 0;
         // only non-permanent fields (position, velocity, orientation) need to be considered here
         // charge, body, image and diameter are not updated between neighbor list builds
-        if (flags[comm_flag::position])
+        m_reqs.clear();
+        MPI_Request req;
+
+        if (flags[comm_flag::position] && m_quantize_ghost_positions)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            m_pos_quant_recvbuf.resize(n_recv_update);
+
+            ArrayHandle<int3> h_pos_quant_copybuf(m_pos_quant_copybuf, access_location::host, access_mode::read);
+            ArrayHandle<int3> h_pos_quant_recvbuf(m_pos_quant_recvbuf, access_location::host, access_mode::overwrite);
+
+            // exchange quantized positions, they are decoded into the particle data arrays after receipt
+            MPI_Isend(h_pos_quant_copybuf.data, (unsigned int)(n_copy_update*sizeof(int3)), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+            MPI_Irecv(h_pos_quant_recvbuf.data, (unsigned int)(n_recv_update*sizeof(int3)), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+
+            sz += sizeof(int3);
+            }
+        else if (flags[comm_flag::position] && m_reconstruct_ghost_bodies)
+            {
+            m_pos_recvbuf.resize(n_recv_update);
+
+            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::overwrite);
+
+            // exchange positions of the updated ghosts, they are scattered into the particle data arrays after receipt
+            MPI_Isend(h_pos_copybuf.data, (unsigned int)(n_copy_update*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+            MPI_Irecv(h_pos_recvbuf.data, (unsigned int)(n_recv_update*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &req);
+            m_reqs.push_back(req);
 
+            sz += sizeof(Scalar4);
+            }
+        else if (flags[comm_flag::position])
+            {
             ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
 
             // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_pos_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_pos.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            MPI_Isend(h_pos_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+            MPI_Irecv(h_pos.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &req);
+            m_reqs.push_back(req);
 
             sz += sizeof(Scalar4);
             }
 
         if (flags[comm_flag::velocity])
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
-
             ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
 
             // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_vel_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_vel.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            MPI_Isend(h_vel_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+            MPI_Irecv(h_vel.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &req);
+            m_reqs.push_back(req);
 
             sz += sizeof(Scalar4);
             }
 
-        if (flags[comm_flag::orientation])
+        if (flags[comm_flag::orientation] && m_reconstruct_ghost_bodies)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            m_orientation_recvbuf.resize(n_recv_update);
+
+            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::overwrite);
+
+            // exchange orientations of the updated ghosts, they are scattered into the particle data arrays after receipt
+            MPI_Isend(h_orientation_copybuf.data, (unsigned int)(n_copy_update*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+            MPI_Irecv(h_orientation_recvbuf.data, (unsigned int)(n_recv_update*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &req);
+            m_reqs.push_back(req);
 
+            sz += sizeof(Scalar4);
+            }
+        else if (flags[comm_flag::orientation])
+            {
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
 
             // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_orientation_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_orientation.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            MPI_Isend(h_orientation_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &req);
+            m_reqs.push_back(req);
+            MPI_Irecv(h_orientation.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar4)), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &req);
+            m_reqs.push_back(req);
 
             sz += sizeof(Scalar4);
             }
 
+        if (defer)
+            {
+            // leave the requests in flight, finishUpdateGhosts() waits for them and wraps the received ghosts
+            m_pending_wrap_start = start_idx;
+            m_pending_wrap_n = flags[comm_flag::position] ? m_num_recv_ghosts[dir] : 0;
+            m_pending_dir = dir;
+            m_comm_pending = true;
+            }
+        else if (m_reqs.size())
+            {
+            m_stats.resize(m_reqs.size());
+            MPI_Waitall((unsigned int)m_reqs.size(), &m_reqs.front(), &m_stats.front());
+            }
+
+        if (!defer)
+            unpackGhostUpdate(dir, start_idx);
+
         if (m_prof)
             m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
 
 
         // wrap particle positions (only if copying positions)
-        if (flags[comm_flag::position])
+        if (flags[comm_flag::position] && !defer)
             {
             ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
 
@@ -2501,6 +2841,247 @@ void Communicator::beginUpdateGhosts(uint64_t timestep)
             m_prof->pop();
     }
 
+/*! Finish ghost update
+ *
+ * \param timestep The time step
+ *
+ * Waits for the exchange in the last direction that beginUpdateGhosts() left in flight and wraps the received
+ * ghost positions.
+ */
+void Communicator::finishUpdateGhosts(uint64_t timestep)
+    {
+    if (!m_comm_pending)
+        return;
+
+    m_comm_pending = false;
+
+    if (m_prof)
+        m_prof->push("comm_ghost_update");
+
+    if (m_reqs.size())
+        {
+        m_stats.resize(m_reqs.size());
+        MPI_Waitall((unsigned int)m_reqs.size(), &m_reqs.front(), &m_stats.front());
+        }
+
+    unpackGhostUpdate(m_pending_dir, m_pending_wrap_start);
+
+    if (m_pending_wrap_n)
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+
+        const BoxDim shifted_box = getShiftedBox();
+        for (unsigned int idx = m_pending_wrap_start; idx < m_pending_wrap_start + m_pending_wrap_n; idx++)
+            {
+            Scalar4& pos = h_pos.data[idx];
+
+            // wrap particles received across a global boundary
+            int3 img = make_int3(0,0,0);
+            shifted_box.wrap(pos, img);
+            }
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param dir Direction of the exchange
+    \param send True for the sending rank, false for the receiving rank
+
+    Along the direction of the exchange, the origin is the face shared by the two domains, which is the upper face
+    of the sender and the lower face of the receiver for the directions 0, 2, 4, and vice versa. Along the other
+    axes, both domains span the same range and the origin is their lower face.
+
+    \returns The origin of the quantized positions in fractional coordinates of the global box
+*/
+Scalar3 Communicator::getGhostQuantizationOrigin(unsigned int dir, bool send) const
+    {
+    uint3 grid_pos = m_decomposition->getGridPos();
+    unsigned int grid_coord[3] = {grid_pos.x, grid_pos.y, grid_pos.z};
+    Scalar origin[3];
+
+    for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+        std::vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(axis);
+        origin[axis] = cum_frac[grid_coord[axis]];
+
+        if (axis == dir / 2)
+            {
+            // the sender's upper face for even directions, the receiver's upper face for odd directions
+            bool upper = (dir % 2 == 0) == send;
+            if (upper)
+                origin[axis] = cum_frac[grid_coord[axis] + 1];
+            }
+        }
+
+    return make_scalar3(origin[0], origin[1], origin[2]);
+    }
+
+/*! \param dir Direction of the exchange
+    \param start_idx Index of the first ghost received from the direction
+
+    The particle type of every ghost is kept from the last full ghost exchange.
+*/
+void Communicator::unpackQuantizedGhostPositions(unsigned int dir, unsigned int start_idx)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_pos_quant_recvbuf(m_pos_quant_recvbuf, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_recv_update_ghosts(m_recv_update_ghosts[dir], access_location::host, access_mode::read);
+
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const Scalar3 origin = getGhostQuantizationOrigin(dir, false);
+    const Scalar inv_scale = Scalar(1.0)/Scalar(GHOST_QUANTIZATION_SCALE);
+    const unsigned int n = m_reconstruct_ghost_bodies ? m_num_recv_update_ghosts[dir] : m_num_recv_ghosts[dir];
+
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        int3 q = h_pos_quant_recvbuf.data[i];
+        Scalar3 f = origin + make_scalar3(Scalar(q.x), Scalar(q.y), Scalar(q.z))*inv_scale;
+        Scalar3 pos = global_box.makeCoordinates(f);
+
+        unsigned int offset = m_reconstruct_ghost_bodies ? h_recv_update_ghosts.data[i] : i;
+        Scalar4& postype = h_pos.data[start_idx + offset];
+        postype.x = pos.x;
+        postype.y = pos.y;
+        postype.z = pos.z;
+        }
+    }
+
+/*! \param dir Direction of the exchange
+    \param start_idx Index of the first ghost received from the direction
+
+    Quantized positions are decoded. With ghost body reconstruction, the positions and orientations of the updated
+    ghosts are copied from the receive buffers to their slots in the particle data. Otherwise, they have already been
+    received into the particle data.
+*/
+void Communicator::unpackGhostUpdate(unsigned int dir, unsigned int start_idx)
+    {
+    CommFlags flags = getFlags();
+
+    if (flags[comm_flag::position] && m_quantize_ghost_positions)
+        {
+        unpackQuantizedGhostPositions(dir, start_idx);
+        }
+    else if (flags[comm_flag::position] && m_reconstruct_ghost_bodies)
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_pos_recvbuf(m_pos_recvbuf, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_recv_update_ghosts(m_recv_update_ghosts[dir], access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < m_num_recv_update_ghosts[dir]; ++i)
+            h_pos.data[start_idx + h_recv_update_ghosts.data[i]] = h_pos_recvbuf.data[i];
+        }
+
+    if (flags[comm_flag::orientation] && m_reconstruct_ghost_bodies)
+        {
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation_recvbuf(m_orientation_recvbuf, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_recv_update_ghosts(m_recv_update_ghosts[dir], access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < m_num_recv_update_ghosts[dir]; ++i)
+            h_orientation.data[start_idx + h_recv_update_ghosts.data[i]] = h_orientation_recvbuf.data[i];
+        }
+    }
+
+/*! The subscribers to the ghost reconstruction signal mark the ghosts they place after every ghost update. Ghosts
+    that this rank forwards to another neighbor are sent on before they are placed, so they are always updated. Every
+    rank then sends the flags of the ghosts it received from a direction back to the sender, and both sides keep the
+    list of the ghosts that are not placed by the receiver.
+*/
+void Communicator::exchangeGhostReconstructionFlags()
+    {
+    const unsigned int n_local = m_pdata->getN();
+    const unsigned int n_tot = n_local + m_pdata->getNGhosts();
+
+    m_ghost_reconstructed.resize(n_tot);
+
+        {
+        ArrayHandle<unsigned int> h_ghost_reconstructed(m_ghost_reconstructed, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < n_tot; ++i)
+            h_ghost_reconstructed.data[i] = 0;
+        }
+
+    m_ghost_reconstruction_requests.emit(m_ghost_reconstructed);
+
+    ArrayHandle<unsigned int> h_ghost_reconstructed(m_ghost_reconstructed, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    // forwarded ghosts are sent before they are placed
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < m_num_copy_ghosts[dir]; ++i)
+            h_ghost_reconstructed.data[h_rtag.data[h_copy_ghosts.data[i]]] = 0;
+        }
+
+    unsigned int start_idx = n_local;
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+
+        // we receive from the direction opposite to the one we send to
+        unsigned int recv_neighbor;
+        if (dir % 2 == 0)
+            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+        else
+            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+
+        m_copy_reconstructed.resize(m_num_copy_ghosts[dir]);
+        m_update_ghosts[dir].resize(m_num_copy_ghosts[dir]);
+        m_recv_update_ghosts[dir].resize(m_num_recv_ghosts[dir]);
+
+        ArrayHandle<unsigned int> h_copy_reconstructed(m_copy_reconstructed, access_location::host, access_mode::overwrite);
+
+        // the flags go back to the rank the ghosts came from
+        m_reqs.clear();
+        MPI_Request req;
+        MPI_Isend(h_ghost_reconstructed.data + start_idx,
+                  int(m_num_recv_ghosts[dir]*sizeof(unsigned int)),
+                  MPI_BYTE,
+                  recv_neighbor,
+                  0,
+                  m_mpi_comm,
+                  &req);
+        m_reqs.push_back(req);
+        MPI_Irecv(h_copy_reconstructed.data,
+                  int(m_num_copy_ghosts[dir]*sizeof(unsigned int)),
+                  MPI_BYTE,
+                  send_neighbor,
+                  0,
+                  m_mpi_comm,
+                  &req);
+        m_reqs.push_back(req);
+
+        m_stats.resize(m_reqs.size());
+        MPI_Waitall((unsigned int)m_reqs.size(), &m_reqs.front(), &m_stats.front());
+
+        ArrayHandle<unsigned int> h_update_ghosts(m_update_ghosts[dir], access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_recv_update_ghosts(m_recv_update_ghosts[dir], access_location::host, access_mode::overwrite);
+
+        unsigned int n_update = 0;
+        for (unsigned int i = 0; i < m_num_copy_ghosts[dir]; ++i)
+            {
+            if (!h_copy_reconstructed.data[i])
+                h_update_ghosts.data[n_update++] = i;
+            }
+        m_num_update_ghosts[dir] = n_update;
+
+        unsigned int n_recv_update = 0;
+        for (unsigned int i = 0; i < m_num_recv_ghosts[dir]; ++i)
+            {
+            if (!h_ghost_reconstructed.data[start_idx + i])
+                h_recv_update_ghosts.data[n_recv_update++] = i;
+            }
+        m_num_recv_update_ghosts[dir] = n_recv_update;
+
+        start_idx += m_num_recv_ghosts[dir];
+        }
+    }
+
 void Communicator::updateNetForce(uint64_t timestep)
     {
     CommFlags flags = getFlags();
@@ -2927,6 +3508,22 @@ void export_Communicator(py::module& m)
     .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
     .def_property_readonly("domain_decomposition",
                            &Communicator::getDomainDecomposition)
+    .def_property("overlap_ghost_update",
+                  &Communicator::getGhostUpdateOverlap,
+                  &Communicator::setGhostUpdateOverlap)
+    .def_property("quantize_ghost_positions",
+                  &Communicator::getGhostPositionQuantization,
+                  &Communicator::setGhostPositionQuantization)
+    .def_property("reconstruct_ghost_bodies",
+                  &Communicator::getGhostBodyReconstruction,
+                  &Communicator::setGhostBodyReconstruction)
+    .def_property("migration_skin",
+                  &Communicator::getMigrationSkin,
+                  &Communicator::setMigrationSkin)
+    .def_property("migration_period",
+                  &Communicator::getMigrationPeriod,
+                  &Communicator::setMigrationPeriod)
+    .def("migrateParticlesToDomains", &Communicator::migrateParticlesToDomains)
     ;
     }
 #endif // ENABLE_MPI
@@ -19,6 +19,7 @@
 #include "ParticleData.h"
 #include "BondedGroupData.h"
 #include "DomainDecomposition.h"
+#include "ClockSource.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
@@ -198,6 +199,18 @@ class PYBIND11_EXPORT Communicator
             }
 
 
+        //! Subscribe to list of functions that mark the ghost particles they place locally
+        /*! After every ghost exchange, the subscribers set the flag (indexed by particle index) of every ghost
+         * particle whose position and orientation they compute from other particles after every ghost update, such
+         * as the constituents of complete rigid bodies. With ghost body reconstruction enabled, these ghosts are
+         * left out of the ghost updates.
+         * \return A connection to the present class
+         */
+        Nano::Signal<void (const GlobalArray<unsigned int>& reconstructed)>& getGhostReconstructionRequestSignal()
+            {
+            return m_ghost_reconstruction_requests;
+            }
+
         //! Subscribe to list of functions that determine the communication flags
         /*! This method keeps track of all functions that may request communication flags
          * \return A connection to the present class
@@ -293,6 +306,17 @@ class PYBIND11_EXPORT Communicator
                 m_force_migrate = true;
             }
 
+        //! Get the wall clock time spent communicating on this rank
+        /*! \returns The accumulated time (in nanoseconds) spent in communicate() and completeGhostUpdate().
+
+            The time includes waiting for the neighboring ranks, so that the remaining time of a rank
+            measures its share of the work. Consumers take differences between two calls.
+        */
+        int64_t getCommunicationTime() const
+            {
+            return m_comm_time;
+            }
+
         /*! Exchange positions of ghost particles
          * Using the previously constructed ghost exchange lists, ghost positions are updated on the
          * neighboring processors.
@@ -312,10 +336,115 @@ class PYBIND11_EXPORT Communicator
          *
          * \param timestep The time step
          */
-        virtual void finishUpdateGhosts(uint64_t timestep)
+        virtual void finishUpdateGhosts(uint64_t timestep);
+
+        //! Enable or disable overlapping the ghost update with force computation
+        /*! When enabled, communicate() returns with the ghost position update still in flight (if the
+            communicator supports it). Forces that support overlap compute interactions among local particles
+            first and then call completeGhostUpdate(). All other consumers complete the update before reading
+            ghost data.
+        */
+        void setGhostUpdateOverlap(bool enable)
+            {
+            m_overlap_ghost_update = enable;
+            }
+
+        //! Get whether the ghost update overlaps with force computation
+        bool getGhostUpdateOverlap() const
+            {
+            return m_overlap_ghost_update;
+            }
+
+        //! Enable or disable quantized ghost position updates
+        /*! When enabled, ghost updates between migrations send the position of every ghost as three 32-bit
+            integers, the offset of its fractional coordinates from the boundary shared by the sending and the
+            receiving domain in units of 2^-30 of the global box. The particle type is not sent, since it does not
+            change between migrations. The resolution is about 1e-9 of the box length, below the precision of
+            single precision positions, so this is meant for mixed precision builds. Only the CPU communicator
+            supports quantization.
+        */
+        void setGhostPositionQuantization(bool enable)
+            {
+            m_quantize_ghost_positions = enable;
+            }
+
+        //! Get whether ghost position updates are quantized
+        bool getGhostPositionQuantization() const
+            {
+            return m_quantize_ghost_positions;
+            }
+
+        //! Enable or disable ghost body reconstruction
+        /*! When enabled, ghost updates between ghost exchanges do not send the position and orientation of the
+            ghosts that the receiving rank places itself after the update, which are the constituents of rigid bodies
+            that are complete on the receiving rank (see getGhostReconstructionRequestSignal()). Only the central
+            particles and the ghosts of incomplete bodies are updated. After every ghost exchange, each rank tells
+            its neighbors which of their ghosts it reconstructs. Only the CPU communicator supports reconstruction.
+        */
+        void setGhostBodyReconstruction(bool enable)
+            {
+            m_reconstruct_ghost_bodies = enable;
+
+            // the lists of updated ghosts are built with the ghost exchange
+            forceMigrate();
+            }
+
+        //! Get whether ghost bodies are reconstructed
+        bool getGhostBodyReconstruction() const
             {
-            // the base class implementation is currently empty
-            m_comm_pending = false;
+            return m_reconstruct_ghost_bodies;
+            }
+
+        //! Set the distance particles may move outside of their domain before they migrate
+        /*! With a positive skin, a migration requested by a neighbor list rebuild only exchanges the ghosts
+            again, as long as no particle is further than \a skin outside of the domain of its rank. The ghost
+            layer is widened by \a skin so that the particles left outside still see all their neighbors. Every
+            getMigrationPeriod()-th request, and whenever a particle leaves the skin, all particles are migrated
+            to their domains and the bonded groups follow them.
+        */
+        void setMigrationSkin(Scalar skin);
+
+        //! Get the migration skin
+        Scalar getMigrationSkin() const
+            {
+            return m_migration_skin;
+            }
+
+        //! Set the number of migration requests between full migrations
+        void setMigrationPeriod(unsigned int period);
+
+        //! Get the number of migration requests between full migrations
+        unsigned int getMigrationPeriod() const
+            {
+            return m_migration_period;
+            }
+
+        //! Returns true if particles may be outside of their domains because migrations were deferred
+        bool hasDeferredMigration() const
+            {
+            return m_n_deferred_migrations > 0;
+            }
+
+        //! Returns true if a ghost update has been started but not yet finished
+        bool isGhostUpdatePending() const
+            {
+            return m_comm_pending;
+            }
+
+        //! Finish a pending ghost update, if any
+        /*! \param timestep The time step
+        */
+        void completeGhostUpdate(uint64_t timestep)
+            {
+            if (m_comm_pending)
+                {
+                const int64_t start = m_clk.getTime();
+                finishUpdateGhosts(timestep);
+
+                // communicate() accounts for its own time
+                if (!m_is_communicating)
+                    m_comm_time += m_clk.getTime() - start;
+                }
             }
 
         /*! Communicate the net particle force
@@ -335,6 +464,13 @@ class PYBIND11_EXPORT Communicator
          */
         virtual void migrateParticles();
 
+        //! Migrate particles until every particle is inside its domain
+        /*! migrateParticles() moves a particle by at most one domain along each direction. After particles
+         *  were placed far from their domains, e.g. by SystemDefinition::replicate(), this method repeats the
+         *  migration until no rank has particles outside of its local box.
+         */
+        void migrateParticlesToDomains();
+
         /*! Particles that are within r_ghost from a neighboring domain's boundary are exchanged with the
          * processor that is responsible for it. Only information needed for calculating the forces (i.e.
          * particle position, type, charge and diameter) is exchanged.
@@ -403,6 +539,10 @@ class PYBIND11_EXPORT Communicator
                  *  \param local_multiple If true, a group may be split across several ranks
                  * A group is marked for sending by setting its rtag to GROUP_NOT_LOCAL, and by updating
                  * the rank information with the destination ranks (or the local ranks if incomplete=true)
+                 *
+                 * If incomplete is false, only the groups of the migrating particles are visited, found
+                 * with an index of the local groups by particle tag. The index is rebuilt after a call with
+                 * incomplete=true and after many groups have arrived.
                  */
                 void migrateGroups(bool incomplete, bool local_multiple);
 
@@ -433,6 +573,17 @@ class PYBIND11_EXPORT Communicator
 
                 std::vector<typename group_data::packed_t> m_groups_sendbuf;     //!< Send buffer for group elements
                 std::vector<typename group_data::packed_t> m_groups_recvbuf;     //!< Receive buffer for group elements
+
+                std::vector<unsigned int> m_tag_group_offsets;  //!< Row offsets of the group index, per particle tag
+                std::vector<unsigned int> m_tag_group_tags;     //!< Group tags of the group index
+                std::vector<unsigned int> m_new_group_tags;     //!< Tags of groups received since the index was built
+                std::vector<unsigned int> m_migrating_groups;   //!< Local indices of the groups to visit
+
+                //! Build the index of local groups by particle tag
+                void buildGroupIndex();
+
+                //! Find the local groups with migrating members
+                void findMigratingGroups();
             };
 
         //! Returns true if we are communicating particles along a given direction
@@ -485,6 +636,10 @@ class PYBIND11_EXPORT Communicator
         GlobalVector<int3> m_image_copybuf;          //!< Buffer for particle body ids to be copied
         GlobalVector<Scalar4> m_velocity_copybuf;    //!< Buffer for particle velocities to be copied
         GlobalVector<Scalar4> m_orientation_copybuf; //!< Buffer for particle orientation to be copied
+        GlobalVector<int3> m_pos_quant_copybuf;      //!< Buffer for quantized ghost positions to be copied
+        GlobalVector<int3> m_pos_quant_recvbuf;      //!< Buffer for received quantized ghost positions
+        GlobalVector<Scalar4> m_pos_recvbuf;         //!< Buffer for received ghost positions that are scattered
+        GlobalVector<Scalar4> m_orientation_recvbuf; //!< Buffer for received ghost orientations that are scattered
         GlobalVector<unsigned int> m_plan_copybuf;  //!< Buffer for particle plans
         GlobalVector<unsigned int> m_tag_copybuf;    //!< Buffer for particle tags
         GlobalVector<Scalar4> m_netforce_copybuf;    //!< Buffer for net force
@@ -496,6 +651,14 @@ class PYBIND11_EXPORT Communicator
         unsigned int m_num_copy_ghosts[6];       //!< Number of local particles that are sent to neighboring processors
         unsigned int m_num_recv_ghosts[6];       //!< Number of ghosts received per direction
 
+        // Variables for leaving reconstructed ghosts out of the ghost updates
+        GlobalVector<unsigned int> m_ghost_reconstructed;     //!< Per-particle flags of the ghosts placed locally
+        GlobalVector<unsigned int> m_copy_reconstructed;      //!< Flags of the sent ghosts that the receiver places
+        GlobalVector<unsigned int> m_update_ghosts[6];        //!< Per-direction indices into m_copy_ghosts of the updated ghosts
+        GlobalVector<unsigned int> m_recv_update_ghosts[6];   //!< Per-direction offsets of the updated received ghosts
+        unsigned int m_num_update_ghosts[6];     //!< Number of ghosts sent in updates per direction
+        unsigned int m_num_recv_update_ghosts[6]; //!< Number of ghosts received in updates per direction
+
         GlobalVector<unsigned int> m_plan;          //!< Array of per-direction flags that determine the sending route
 
         // Variables needed for sending ghost particles backwards
@@ -541,6 +704,9 @@ class PYBIND11_EXPORT Communicator
         Nano::Signal<Scalar(unsigned int type) >
             m_extra_ghost_layer_width_requests;  //!< List of functions that request an extra ghost layer width
 
+        Nano::Signal<void (const GlobalArray<unsigned int>& reconstructed)>
+            m_ghost_reconstruction_requests;  //!< List of functions that mark the ghosts they place locally
+
         Nano::Signal<void (uint64_t timestep)>
             m_compute_callbacks;   //!< List of functions that are called after ghost communication
 
@@ -551,6 +717,32 @@ class PYBIND11_EXPORT Communicator
         CommFlags m_last_flags;                       //!< Flags of last ghost exchange
 
         bool m_comm_pending;                     //!< If true, a communication is in process
+        bool m_overlap_ghost_update;             //!< If true, communicate() leaves the ghost update pending
+        unsigned int m_pending_wrap_start;       //!< First ghost index to wrap when the pending update completes
+        unsigned int m_pending_wrap_n;           //!< Number of ghosts to wrap when the pending update completes
+        unsigned int m_pending_dir;              //!< Direction of the exchange left pending
+        bool m_quantize_ghost_positions;         //!< If true, ghost position updates are sent quantized
+        bool m_reconstruct_ghost_bodies;         //!< If true, ghosts placed by the receiver are not updated
+        Scalar m_migration_skin;                 //!< Distance particles may move outside of their domain
+        unsigned int m_migration_period;         //!< Number of migration requests between full migrations
+        unsigned int m_n_deferred_migrations;    //!< Number of migrations deferred since the last full one
+
+        //! Test whether all ranks can defer the requested migration
+        bool canDeferMigration();
+
+        //! Get the fractional coordinates of the face shared with the neighbor in a direction
+        Scalar3 getGhostQuantizationOrigin(unsigned int dir, bool send) const;
+
+        //! Decode the quantized positions received from a direction
+        void unpackQuantizedGhostPositions(unsigned int dir, unsigned int start_idx);
+
+        //! Copy the ghost positions and orientations received from a direction into the particle data
+        void unpackGhostUpdate(unsigned int dir, unsigned int start_idx);
+
+        //! Exchange which ghosts are placed by the receiver and build the lists of updated ghosts
+        void exchangeGhostReconstructionFlags();
+        ClockSource m_clk;                       //!< Clock to time the communication
+        int64_t m_comm_time;                     //!< Accumulated communication time (in ns)
         std::vector<MPI_Request> m_reqs; //!< Container for all MPI communication requests
         std::vector<MPI_Status> m_stats; //!< Container for all MPI communication statuses
 
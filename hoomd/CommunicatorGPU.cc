@@ -25,6 +25,13 @@ CommunicatorGPU::CommunicatorGPU(std::shared_ptr<SystemDefinition> sysdef,
       m_max_stages(1),
       m_num_stages(0),
       m_comm_mask(0),
+      m_persistent_ghost_update(false),
+      m_aggregate_ghost_update(false),
+      m_ghost_chunk_size(0),
+      m_h_chunk_sendbuf(nullptr),
+      m_h_chunk_recvbuf(nullptr),
+      m_chunk_sendbuf_size(0),
+      m_chunk_recvbuf_size(0),
       m_bond_comm(*this, m_sysdef->getBondData()),
       m_angle_comm(*this, m_sysdef->getAngleData()),
       m_dihedral_comm(*this, m_sysdef->getDihedralData()),
@@ -47,13 +54,85 @@ CommunicatorGPU::CommunicatorGPU(std::shared_ptr<SystemDefinition> sysdef,
 
     // create cuda event
     hipEventCreateWithFlags(&m_event, hipEventDisableTiming);
+
+    // streams for the pipelined ghost update
+    hipStreamCreateWithFlags(&m_d2h_stream, hipStreamNonBlocking);
+    hipStreamCreateWithFlags(&m_h2d_stream, hipStreamNonBlocking);
     }
 
 //! Destructor
 CommunicatorGPU::~CommunicatorGPU()
     {
     m_exec_conf->msg->notice(5) << "Destroying CommunicatorGPU";
+    freePersistentRequests();
     hipEventDestroy(m_event);
+
+    for (auto event : m_chunk_events)
+        hipEventDestroy(event);
+    hipStreamDestroy(m_d2h_stream);
+    hipStreamDestroy(m_h2d_stream);
+
+    if (m_h_chunk_sendbuf)
+        hipHostFree(m_h_chunk_sendbuf);
+    if (m_h_chunk_recvbuf)
+        hipHostFree(m_h_chunk_recvbuf);
+    }
+
+/*! \param enable If true, ghost updates reuse persistent MPI requests
+
+    The requests are set up by the first ghost update after exchangeGhosts() and restarted on every following update
+    until the next ghost exchange, a change of the communication flags, or a reallocation of a communication buffer.
+*/
+void CommunicatorGPU::setPersistentGhostUpdate(bool enable)
+    {
+    if (m_comm_pending)
+        finishUpdateGhosts(0);
+
+    m_persistent_ghost_update = enable;
+    freePersistentRequests();
+    }
+
+/*! \param enable If true, ghost updates send the positions, velocities and orientations to a neighbor in one message
+
+    The fields stay in their separate buffers, and a derived MPI datatype addresses all of them. This reduces the
+    number of messages when more than one field is communicated, which helps when many ranks on a node share a
+    network interface.
+*/
+void CommunicatorGPU::setAggregateGhostUpdate(bool enable)
+    {
+    if (m_comm_pending)
+        finishUpdateGhosts(0);
+
+    m_aggregate_ghost_update = enable;
+    freePersistentRequests();
+    }
+
+void CommunicatorGPU::setGhostUpdateChunkSize(unsigned int chunk_size)
+    {
+    if (m_comm_pending)
+        finishUpdateGhosts(0);
+
+    #ifdef ENABLE_MPI_CUDA
+    if (chunk_size)
+        m_exec_conf->msg->warning() << "CommunicatorGPU: CUDA-aware MPI sends ghosts from the device, "
+                                    << "the ghost update is not pipelined" << std::endl;
+    #endif
+
+    m_ghost_chunk_size = chunk_size;
+    }
+
+//! Free the persistent requests of all stages
+void CommunicatorGPU::freePersistentRequests()
+    {
+    for (auto& stage_reqs : m_persistent_reqs)
+        {
+        for (auto& req : stage_reqs)
+            MPI_Request_free(&req);
+        stage_reqs.clear();
+        }
+
+    for (auto& key : m_persistent_key)
+        key.clear();
     }
 
 void CommunicatorGPU::allocateBuffers()
@@ -251,6 +330,11 @@ void CommunicatorGPU::initializeCommunicationStages()
     // number of communication stages
     m_num_stages = max_stage + 1;
 
+    // persistent requests are set up per stage
+    freePersistentRequests();
+    m_persistent_reqs.resize(m_num_stages);
+    m_persistent_key.resize(m_num_stages);
+
     // every direction occurs in one and only one stages
     // number of communications per stage is constant or decreases with stage number
     for (unsigned int istage = 0; istage < m_num_stages; ++istage)
@@ -1706,6 +1790,9 @@ void CommunicatorGPU::removeGhostParticleTags()
 //! Build a ghost particle list, exchange ghost particle data with neighboring processors
 void CommunicatorGPU::exchangeGhosts()
     {
+    // the ghost send and receive counts are about to change
+    freePersistentRequests();
+
     CommFlags current_flags = getFlags();
     if (current_flags[comm_flag::reverse_net_force] && this->m_exec_conf->isCUDAEnabled())
         {
@@ -2484,6 +2571,25 @@ void CommunicatorGPU::beginUpdateGhosts(uint64_t timestep)
             first_idx += m_n_recv_ghosts_tot[istage];
             }
 
+        #ifndef ENABLE_MPI_CUDA
+        if (m_ghost_chunk_size)
+            {
+            if (m_prof) m_prof->push(m_exec_conf, "MPI send/recv");
+            beginPipelinedGhostUpdate(stage, flags);
+
+            if (m_num_stages == 1)
+                {
+                // the received chunks are copied to the device in finishUpdateGhosts()
+                m_comm_pending = true;
+                }
+            else
+                {
+                finishPipelinedGhostUpdate(stage);
+                }
+            if (m_prof) m_prof->pop(m_exec_conf);
+            }
+        else
+        #endif
             {
             unsigned int offs = 0;
             // access particle data
@@ -2527,7 +2633,77 @@ void CommunicatorGPU::beginUpdateGhosts(uint64_t timestep)
             if (m_prof) m_prof->push(m_exec_conf, "MPI send/recv");
 
             m_reqs.clear();
-            MPI_Request req;
+
+            // persistent requests remain valid as long as the buffers they refer to are unchanged
+            std::vector<const void *> key = {
+                pos_ghost_sendbuf_handle.data, pos_ghost_recvbuf_handle.data + offs,
+                vel_ghost_sendbuf_handle.data, vel_ghost_recvbuf_handle.data + offs,
+                orientation_ghost_sendbuf_handle.data, orientation_ghost_recvbuf_handle.data + offs,
+                reinterpret_cast<const void *>(flags.to_ulong())};
+
+            bool reuse = m_persistent_ghost_update && m_persistent_key[stage] == key;
+            if (m_persistent_ghost_update && !reuse)
+                {
+                for (auto& req : m_persistent_reqs[stage])
+                    MPI_Request_free(&req);
+                m_persistent_reqs[stage].clear();
+                }
+
+            // post (or, for persistent requests, create) a send or receive
+            auto post_send = [&](const Scalar4 *buf, unsigned int n, unsigned int neighbor, int tag)
+                {
+                if (reuse)
+                    return;
+                MPI_Request req;
+                if (m_persistent_ghost_update)
+                    MPI_Send_init(buf, int(n*sizeof(Scalar4)), MPI_BYTE, neighbor, tag, m_mpi_comm, &req);
+                else
+                    MPI_Isend(buf, int(n*sizeof(Scalar4)), MPI_BYTE, neighbor, tag, m_mpi_comm, &req);
+                m_reqs.push_back(req);
+                };
+
+            auto post_recv = [&](Scalar4 *buf, unsigned int n, unsigned int neighbor, int tag)
+                {
+                if (reuse)
+                    return;
+                MPI_Request req;
+                if (m_persistent_ghost_update)
+                    MPI_Recv_init(buf, int(n*sizeof(Scalar4)), MPI_BYTE, neighbor, tag, m_mpi_comm, &req);
+                else
+                    MPI_Irecv(buf, int(n*sizeof(Scalar4)), MPI_BYTE, neighbor, tag, m_mpi_comm, &req);
+                m_reqs.push_back(req);
+                };
+
+            // post (or create) one send or receive covering the buffers of all fields
+            auto post_aggregate = [&](const std::vector<const void *>& bufs, unsigned int n, unsigned int neighbor, int tag,
+                                      bool send)
+                {
+                if (reuse)
+                    return;
+                std::vector<int> lengths(bufs.size(), int(n*sizeof(Scalar4)));
+                std::vector<MPI_Aint> displs(bufs.size());
+                std::vector<MPI_Datatype> types(bufs.size(), MPI_BYTE);
+                for (unsigned int i = 0; i < bufs.size(); ++i)
+                    MPI_Get_address(bufs[i], &displs[i]);
+
+                MPI_Datatype type;
+                MPI_Type_create_struct(int(bufs.size()), &lengths.front(), &displs.front(), &types.front(), &type);
+                MPI_Type_commit(&type);
+
+                MPI_Request req;
+                if (send && m_persistent_ghost_update)
+                    MPI_Send_init(MPI_BOTTOM, 1, type, neighbor, tag, m_mpi_comm, &req);
+                else if (send)
+                    MPI_Isend(MPI_BOTTOM, 1, type, neighbor, tag, m_mpi_comm, &req);
+                else if (m_persistent_ghost_update)
+                    MPI_Recv_init(MPI_BOTTOM, 1, type, neighbor, tag, m_mpi_comm, &req);
+                else
+                    MPI_Irecv(MPI_BOTTOM, 1, type, neighbor, tag, m_mpi_comm, &req);
+
+                // requests keep the datatype alive until they are freed
+                MPI_Type_free(&type);
+                m_reqs.push_back(req);
+                };
 
             unsigned int send_bytes = 0;
             unsigned int recv_bytes = 0;
@@ -2538,31 +2714,58 @@ void CommunicatorGPU::beginUpdateGhosts(uint64_t timestep)
                 // rank of neighbor processor
                 unsigned int neighbor = h_unique_neighbors.data[ineigh];
 
+                if (m_aggregate_ghost_update)
+                    {
+                    const unsigned int send_idx = h_ghost_begin.data[ineigh + stage*m_n_unique_neigh];
+                    const unsigned int recv_idx = m_ghost_offs[stage][ineigh] + offs;
+
+                    std::vector<const void *> send_bufs, recv_bufs;
+                    if (flags[comm_flag::position])
+                        {
+                        send_bufs.push_back(pos_ghost_sendbuf_handle.data + send_idx);
+                        recv_bufs.push_back(pos_ghost_recvbuf_handle.data + recv_idx);
+                        }
+                    if (flags[comm_flag::velocity])
+                        {
+                        send_bufs.push_back(vel_ghost_sendbuf_handle.data + send_idx);
+                        recv_bufs.push_back(vel_ghost_recvbuf_handle.data + recv_idx);
+                        }
+                    if (flags[comm_flag::orientation])
+                        {
+                        send_bufs.push_back(orientation_ghost_sendbuf_handle.data + send_idx);
+                        recv_bufs.push_back(orientation_ghost_recvbuf_handle.data + recv_idx);
+                        }
+
+                    if (send_bufs.empty())
+                        continue;
+
+                    if (m_n_send_ghosts[stage][ineigh])
+                        post_aggregate(send_bufs, m_n_send_ghosts[stage][ineigh], neighbor, 2, true);
+                    send_bytes += (unsigned int)(send_bufs.size()*m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4));
+
+                    if (m_n_recv_ghosts[stage][ineigh])
+                        post_aggregate(recv_bufs, m_n_recv_ghosts[stage][ineigh], neighbor, 2, false);
+                    recv_bytes += (unsigned int)(recv_bufs.size()*m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4));
+                    continue;
+                    }
+
                 if (flags[comm_flag::position])
                     {
                     if (m_n_send_ghosts[stage][ineigh])
                         {
-                        MPI_Isend(pos_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
-                            int(m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4)),
-                            MPI_BYTE,
-                            neighbor,
-                            2,
-                            m_mpi_comm,
-                            &req);
-                        m_reqs.push_back(req);
+                        post_send(pos_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
+                                  m_n_send_ghosts[stage][ineigh],
+                                  neighbor,
+                                  2);
                         }
                     send_bytes += (unsigned int)(m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4));
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(pos_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
-                            int(m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4)),
-                            MPI_BYTE,
-                            neighbor,
-                            2,
-                            m_mpi_comm,
-                            &req);
-                        m_reqs.push_back(req);
+                        post_recv(pos_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                                  m_n_recv_ghosts[stage][ineigh],
+                                  neighbor,
+                                  2);
                         }
                     recv_bytes += (unsigned int)(m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4));
                     }
@@ -2571,27 +2774,19 @@ void CommunicatorGPU::beginUpdateGhosts(uint64_t timestep)
                     {
                     if (m_n_send_ghosts[stage][ineigh])
                         {
-                        MPI_Isend(vel_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
-                            int(m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4)),
-                            MPI_BYTE,
-                            neighbor,
-                            3,
-                            m_mpi_comm,
-                            &req);
-                        m_reqs.push_back(req);
+                        post_send(vel_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
+                                  m_n_send_ghosts[stage][ineigh],
+                                  neighbor,
+                                  3);
                         }
                     send_bytes += (unsigned int)(m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4));
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(vel_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
-                            int(m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4)),
-                            MPI_BYTE,
-                            neighbor,
-                            3,
-                            m_mpi_comm,
-                            &req);
-                        m_reqs.push_back(req);
+                        post_recv(vel_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                                  m_n_recv_ghosts[stage][ineigh],
+                                  neighbor,
+                                  3);
                         }
                     recv_bytes += (unsigned int)(m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4));
                     }
@@ -2600,32 +2795,39 @@ void CommunicatorGPU::beginUpdateGhosts(uint64_t timestep)
                     {
                     if (m_n_send_ghosts[stage][ineigh])
                         {
-                        MPI_Isend(orientation_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
-                            int(m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4)),
-                            MPI_BYTE,
-                            neighbor,
-                            6,
-                            m_mpi_comm,
-                            &req);
-                        m_reqs.push_back(req);
+                        post_send(orientation_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
+                                  m_n_send_ghosts[stage][ineigh],
+                                  neighbor,
+                                  6);
                         }
                     send_bytes += (unsigned int)(m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4));
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(orientation_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
-                            int(m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4)),
-                            MPI_BYTE,
-                            neighbor,
-                            6,
-                            m_mpi_comm,
-                            &req);
-                        m_reqs.push_back(req);
+                        post_recv(orientation_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                                  m_n_recv_ghosts[stage][ineigh],
+                                  neighbor,
+                                  6);
                         }
                     recv_bytes += (unsigned int)(m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4));
                     }
                 } // end neighbor loop
 
+            if (m_persistent_ghost_update)
+                {
+                if (reuse)
+                    m_reqs = m_persistent_reqs[stage];
+                else
+                    {
+                    m_persistent_reqs[stage] = m_reqs;
+                    m_persistent_key[stage] = key;
+                    }
+
+                // start all sends and receives of this stage at once
+                if (m_reqs.size())
+                    MPI_Startall((int)m_reqs.size(), &m_reqs.front());
+                }
+
             if (m_num_stages == 1)
                 {
                 // use non-blocking MPI
@@ -2695,6 +2897,211 @@ void CommunicatorGPU::beginUpdateGhosts(uint64_t timestep)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+#ifndef ENABLE_MPI_CUDA
+namespace
+    {
+//! MPI tag of the messages of a field in a ghost update
+int ghost_update_tag(int field)
+    {
+    if (field == comm_flag::position)
+        return 2;
+    else if (field == comm_flag::velocity)
+        return 3;
+    else
+        return 6;
+    }
+    }
+
+/*! \param stage Communication stage
+    \param flags Fields to update
+
+    The segments of the send and receive buffers of every neighbor and field are cut into chunks of
+    m_ghost_chunk_size ghosts. Both sides of a message cut their segments the same way, and MPI keeps messages with the
+    same tag between two ranks in order, so every chunk matches the receive for it. All receives are posted first.
+    The chunks are then copied to the pinned host buffer on m_d2h_stream, and each is sent once its copy completed
+    while the copies of the following chunks proceed.
+*/
+void CommunicatorGPU::beginPipelinedGhostUpdate(unsigned int stage, const CommFlags& flags)
+    {
+    // the fields of a ghost update, all of them are Scalar4
+    m_chunk_fields.clear();
+    if (flags[comm_flag::position])
+        m_chunk_fields.push_back(comm_flag::position);
+    if (flags[comm_flag::velocity])
+        m_chunk_fields.push_back(comm_flag::velocity);
+    if (flags[comm_flag::orientation])
+        m_chunk_fields.push_back(comm_flag::orientation);
+
+    const unsigned int n_fields = (unsigned int)m_chunk_fields.size();
+    const unsigned int n_send = m_n_send_ghosts_tot[stage];
+    const unsigned int n_recv = m_n_recv_ghosts_tot[stage];
+
+    // the staging buffers hold one block of each field
+    if ((size_t)n_fields*n_send > m_chunk_sendbuf_size)
+        {
+        if (m_h_chunk_sendbuf)
+            hipHostFree(m_h_chunk_sendbuf);
+        m_chunk_sendbuf_size = (size_t)n_fields*n_send;
+        hipHostMalloc((void **)&m_h_chunk_sendbuf, m_chunk_sendbuf_size*sizeof(Scalar4), hipHostMallocDefault);
+        }
+    if ((size_t)n_fields*n_recv > m_chunk_recvbuf_size)
+        {
+        if (m_h_chunk_recvbuf)
+            hipHostFree(m_h_chunk_recvbuf);
+        m_chunk_recvbuf_size = (size_t)n_fields*n_recv;
+        hipHostMalloc((void **)&m_h_chunk_recvbuf, m_chunk_recvbuf_size*sizeof(Scalar4), hipHostMallocDefault);
+        }
+
+    m_send_chunks.clear();
+    m_recv_chunks.clear();
+        {
+        ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_ghost_begin(m_ghost_begin, access_location::host, access_mode::read);
+
+        for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+            {
+            unsigned int neighbor = h_unique_neighbors.data[ineigh];
+            unsigned int send_begin = h_ghost_begin.data[ineigh + stage*m_n_unique_neigh];
+            unsigned int recv_begin = m_ghost_offs[stage][ineigh];
+
+            for (unsigned int field = 0; field < n_fields; ++field)
+                {
+                for (unsigned int i = 0; i < m_n_send_ghosts[stage][ineigh]; i += m_ghost_chunk_size)
+                    {
+                    unsigned int n = std::min(m_ghost_chunk_size, m_n_send_ghosts[stage][ineigh] - i);
+                    m_send_chunks.push_back(ghost_chunk{field, send_begin + i, n, neighbor});
+                    }
+                for (unsigned int i = 0; i < m_n_recv_ghosts[stage][ineigh]; i += m_ghost_chunk_size)
+                    {
+                    unsigned int n = std::min(m_ghost_chunk_size, m_n_recv_ghosts[stage][ineigh] - i);
+                    m_recv_chunks.push_back(ghost_chunk{field, recv_begin + i, n, neighbor});
+                    }
+                }
+            }
+        }
+
+    // post all receives before the sends
+    m_chunk_recv_reqs.resize(m_recv_chunks.size());
+    for (unsigned int i = 0; i < m_recv_chunks.size(); ++i)
+        {
+        const ghost_chunk& c = m_recv_chunks[i];
+        MPI_Irecv(m_h_chunk_recvbuf + (size_t)c.field*n_recv + c.offset,
+                  int(c.n*sizeof(Scalar4)),
+                  MPI_BYTE,
+                  c.neighbor,
+                  ghost_update_tag(m_chunk_fields[c.field]),
+                  m_mpi_comm,
+                  &m_chunk_recv_reqs[i]);
+        }
+
+    while (m_chunk_events.size() < m_send_chunks.size())
+        {
+        hipEvent_t event;
+        hipEventCreateWithFlags(&event, hipEventDisableTiming);
+        m_chunk_events.push_back(event);
+        }
+
+    m_chunk_send_reqs.resize(m_send_chunks.size());
+        {
+        ArrayHandle<Scalar4> d_pos_ghost_sendbuf(m_pos_ghost_sendbuf, access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_vel_ghost_sendbuf(m_vel_ghost_sendbuf, access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation_ghost_sendbuf(m_orientation_ghost_sendbuf, access_location::device, access_mode::read);
+
+        std::vector<const Scalar4 *> d_sendbuf;
+        for (int field : m_chunk_fields)
+            {
+            if (field == comm_flag::position)
+                d_sendbuf.push_back(d_pos_ghost_sendbuf.data);
+            else if (field == comm_flag::velocity)
+                d_sendbuf.push_back(d_vel_ghost_sendbuf.data);
+            else
+                d_sendbuf.push_back(d_orientation_ghost_sendbuf.data);
+            }
+
+        // copy after the send buffers have been packed
+        hipEventRecord(m_event, 0);
+        hipStreamWaitEvent(m_d2h_stream, m_event, 0);
+
+        for (unsigned int i = 0; i < m_send_chunks.size(); ++i)
+            {
+            const ghost_chunk& c = m_send_chunks[i];
+            hipMemcpyAsync(m_h_chunk_sendbuf + (size_t)c.field*n_send + c.offset,
+                           d_sendbuf[c.field] + c.offset,
+                           c.n*sizeof(Scalar4),
+                           hipMemcpyDeviceToHost,
+                           m_d2h_stream);
+            hipEventRecord(m_chunk_events[i], m_d2h_stream);
+            }
+
+        // send every chunk as soon as it is on the host
+        for (unsigned int i = 0; i < m_send_chunks.size(); ++i)
+            {
+            const ghost_chunk& c = m_send_chunks[i];
+            hipEventSynchronize(m_chunk_events[i]);
+            MPI_Isend(m_h_chunk_sendbuf + (size_t)c.field*n_send + c.offset,
+                      int(c.n*sizeof(Scalar4)),
+                      MPI_BYTE,
+                      c.neighbor,
+                      ghost_update_tag(m_chunk_fields[c.field]),
+                      m_mpi_comm,
+                      &m_chunk_send_reqs[i]);
+            }
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    }
+
+/*! \param stage Communication stage
+
+    Every chunk is copied to the device receive buffer on m_h2d_stream as soon as it arrived. The default stream waits
+    for the copies, so the ghosts can be unpacked right after this call.
+*/
+void CommunicatorGPU::finishPipelinedGhostUpdate(unsigned int stage)
+    {
+    const unsigned int n_recv = m_n_recv_ghosts_tot[stage];
+
+        {
+        ArrayHandle<Scalar4> d_pos_ghost_recvbuf(m_pos_ghost_recvbuf, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_vel_ghost_recvbuf(m_vel_ghost_recvbuf, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_orientation_ghost_recvbuf(m_orientation_ghost_recvbuf, access_location::device, access_mode::overwrite);
+
+        std::vector<Scalar4 *> d_recvbuf;
+        for (int field : m_chunk_fields)
+            {
+            if (field == comm_flag::position)
+                d_recvbuf.push_back(d_pos_ghost_recvbuf.data);
+            else if (field == comm_flag::velocity)
+                d_recvbuf.push_back(d_vel_ghost_recvbuf.data);
+            else
+                d_recvbuf.push_back(d_orientation_ghost_recvbuf.data);
+            }
+
+        for (unsigned int k = 0; k < m_chunk_recv_reqs.size(); ++k)
+            {
+            int i;
+            MPI_Waitany((int)m_chunk_recv_reqs.size(), &m_chunk_recv_reqs.front(), &i, MPI_STATUS_IGNORE);
+
+            const ghost_chunk& c = m_recv_chunks[i];
+            hipMemcpyAsync(d_recvbuf[c.field] + c.offset,
+                           m_h_chunk_recvbuf + (size_t)c.field*n_recv + c.offset,
+                           c.n*sizeof(Scalar4),
+                           hipMemcpyHostToDevice,
+                           m_h2d_stream);
+            }
+
+        // the unpack kernel runs on the default stream
+        hipEventRecord(m_event, m_h2d_stream);
+        hipStreamWaitEvent(0, m_event, 0);
+        }
+
+    // the send buffers may be reused by the next update
+    if (m_chunk_send_reqs.size())
+        MPI_Waitall((int)m_chunk_send_reqs.size(), &m_chunk_send_reqs.front(), MPI_STATUSES_IGNORE);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    }
+#endif
+
 /*! Finish ghost update
  *
  * \param timestep The time step
@@ -2709,8 +3116,15 @@ void CommunicatorGPU::finishUpdateGhosts(uint64_t timestep)
 
         // complete communication
         if (m_prof) m_prof->push(m_exec_conf, "MPI send/recv");
-        std::vector<MPI_Status> stats(m_reqs.size());
-        MPI_Waitall((unsigned int)m_reqs.size(), &m_reqs.front(), &stats.front());
+        #ifndef ENABLE_MPI_CUDA
+        if (m_ghost_chunk_size)
+            finishPipelinedGhostUpdate(0);
+        else
+        #endif
+            {
+            std::vector<MPI_Status> stats(m_reqs.size());
+            MPI_Waitall((unsigned int)m_reqs.size(), &m_reqs.front(), &stats.front());
+            }
         if (m_prof) m_prof->pop(m_exec_conf);
 
         #ifdef ENABLE_MPI_CUDA
@@ -3103,6 +3517,15 @@ void export_CommunicatorGPU(py::module& m)
     py::class_<CommunicatorGPU, Communicator, std::shared_ptr<CommunicatorGPU> >(m,"CommunicatorGPU")
         .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
         .def("setMaxStages",&CommunicatorGPU::setMaxStages)
+        .def_property("persistent_ghost_update",
+                      &CommunicatorGPU::getPersistentGhostUpdate,
+                      &CommunicatorGPU::setPersistentGhostUpdate)
+        .def_property("aggregate_ghost_update",
+                      &CommunicatorGPU::getAggregateGhostUpdate,
+                      &CommunicatorGPU::setAggregateGhostUpdate)
+        .def_property("ghost_update_chunk_size",
+                      &CommunicatorGPU::getGhostUpdateChunkSize,
+                      &CommunicatorGPU::setGhostUpdateChunkSize)
     ;
     }
 
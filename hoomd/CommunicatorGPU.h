@@ -32,6 +32,13 @@
 
 //! Class that handles MPI communication (GPU version)
 /*! CommunicatorGPU is the GPU implementation of the base communication class.
+
+    Ghost particles are packed into send buffers by a GPU kernel, and the buffers are exchanged with host initiated
+    MPI calls (device buffers with a CUDA-aware MPI, host buffers otherwise). A backend with GPU initiated
+    communication (e.g. NVSHMEM) would override beginUpdateGhosts() and finishUpdateGhosts() and write the packed
+    ghosts directly into symmetric buffers on the neighbor ranks. The send and receive counts per stage and neighbor
+    (m_n_send_ghosts, m_n_recv_ghosts, m_ghost_offs) are fixed between calls to exchangeGhosts() and could size such
+    buffers.
 */
 class PYBIND11_EXPORT CommunicatorGPU : public Communicator
     {
@@ -81,6 +88,41 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
             forceMigrate();
             }
 
+        //! Enable or disable persistent MPI requests for ghost updates
+        void setPersistentGhostUpdate(bool enable);
+
+        //! Get whether ghost updates use persistent MPI requests
+        bool getPersistentGhostUpdate() const
+            {
+            return m_persistent_ghost_update;
+            }
+
+        //! Enable or disable sending all fields of a ghost update to a neighbor in one message
+        void setAggregateGhostUpdate(bool enable);
+
+        //! Get whether ghost updates send one message per neighbor
+        bool getAggregateGhostUpdate() const
+            {
+            return m_aggregate_ghost_update;
+            }
+
+        //! Set the number of ghosts per message of a pipelined ghost update
+        /*! \param chunk_size Number of ghosts per message, 0 disables pipelining
+
+            In builds without CUDA-aware MPI, a pipelined ghost update splits the data sent to every neighbor into
+            chunks of \a chunk_size ghosts. Each chunk is copied to a pinned host buffer on a separate stream and sent
+            as soon as its copy completed, and each received chunk is copied to the device as soon as it arrived.
+            The device-to-host copy, MPI, and the host-to-device copy of different chunks therefore overlap. Pipelined
+            updates do not use persistent or aggregated requests.
+        */
+        void setGhostUpdateChunkSize(unsigned int chunk_size);
+
+        //! Get the number of ghosts per message of a pipelined ghost update
+        unsigned int getGhostUpdateChunkSize() const
+            {
+            return m_ghost_chunk_size;
+            }
+
     protected:
         //! Helper class to perform the communication tasks related to bonded groups
         template<class group_data>
@@ -159,6 +201,36 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
         std::vector<unsigned int> m_comm_mask;         //!< Communication mask per stage
         std::vector<int> m_stages;                     //!< Communication stage per unique neighbor
 
+        /* Persistent ghost update */
+        bool m_persistent_ghost_update;                //!< True if ghost updates use persistent requests
+        std::vector<std::vector<MPI_Request> > m_persistent_reqs; //!< Persistent requests per stage
+        std::vector<std::vector<const void *> > m_persistent_key; //!< Buffers the requests of each stage refer to
+        bool m_aggregate_ghost_update;                 //!< True if ghost updates send one message per neighbor
+
+        /* Pipelined ghost update */
+        //! A contiguous range of a field sent to or received from a neighbor in one message
+        struct ghost_chunk
+            {
+            unsigned int field;                        //!< Index of the field among the communicated fields
+            unsigned int offset;                       //!< Index of the first ghost in the buffer
+            unsigned int n;                            //!< Number of ghosts
+            unsigned int neighbor;                     //!< Rank of the neighbor
+            };
+
+        unsigned int m_ghost_chunk_size;               //!< Number of ghosts per message (0: no pipelining)
+        hipStream_t m_d2h_stream;                      //!< Stream for the device-to-host copies of the chunks
+        hipStream_t m_h2d_stream;                      //!< Stream for the host-to-device copies of the chunks
+        std::vector<hipEvent_t> m_chunk_events;        //!< Completion events of the device-to-host copies
+        Scalar4 *m_h_chunk_sendbuf;                    //!< Pinned host staging buffer for sending
+        Scalar4 *m_h_chunk_recvbuf;                    //!< Pinned host staging buffer for receiving
+        size_t m_chunk_sendbuf_size;                   //!< Capacity of m_h_chunk_sendbuf (in elements)
+        size_t m_chunk_recvbuf_size;                   //!< Capacity of m_h_chunk_recvbuf (in elements)
+        std::vector<ghost_chunk> m_send_chunks;        //!< Chunks of the pending update to send
+        std::vector<ghost_chunk> m_recv_chunks;        //!< Chunks of the pending update to receive
+        std::vector<MPI_Request> m_chunk_send_reqs;    //!< Send requests of the chunks
+        std::vector<MPI_Request> m_chunk_recv_reqs;    //!< Receive requests of the chunks
+        std::vector<int> m_chunk_fields;               //!< Communicated fields (comm_flag values) of the pending update
+
         /* Particle migration */
         GlobalVector<pdata_element> m_gpu_sendbuf;        //!< Send buffer for particle data
         GlobalVector<pdata_element> m_gpu_recvbuf;        //!< Receive buffer for particle data
@@ -244,6 +316,17 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
 
         //! Helper function to set up communication stages
         void initializeCommunicationStages();
+
+        //! Helper function to free the persistent ghost update requests
+        void freePersistentRequests();
+
+        #ifndef ENABLE_MPI_CUDA
+        //! Copy the chunks of a ghost update stage to the host and post their sends and receives
+        void beginPipelinedGhostUpdate(unsigned int stage, const CommFlags& flags);
+
+        //! Copy the received chunks of a ghost update stage to the device as they arrive
+        void finishPipelinedGhostUpdate(unsigned int stage);
+        #endif
     };
 
 //! Export CommunicatorGPU class to python
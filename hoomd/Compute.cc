@@ -7,6 +7,8 @@
 #include "Compute.h"
 #include "Communicator.h"
 
+#include <pybind11/stl.h>
+
 namespace py = pybind11;
 
 
@@ -22,7 +24,8 @@ using namespace std;
     \post The Compute is constructed with the given particle data and a NULL profiler.
 */
 Compute::Compute(std::shared_ptr<SystemDefinition> sysdef) : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()),
-        m_exec_conf(m_pdata->getExecConf()), m_force_compute(false), m_last_computed(0), m_first_compute(true)
+        m_exec_conf(m_pdata->getExecConf()), m_force_compute(false), m_last_computed(0), m_first_compute(true),
+        m_timer(m_exec_conf)
     {
     // sanity check
     assert(m_sysdef);
@@ -127,6 +130,8 @@ void export_Compute(py::module& m)
     .def("benchmark", &Compute::benchmark)
     .def("setProfiler", &Compute::setProfiler)
     .def("notifyDetach", &Compute::notifyDetach)
+    .def("getExecutionTime", &Compute::getExecutionTime)
+    .def("getLoggedQuantityNames", &Compute::getLoggedQuantityNames)
     #ifdef ENABLE_MPI
     .def("setCommunicator", &Compute::setCommunicator)
     #endif
@@ -6,6 +6,8 @@
 
 #include "SystemDefinition.h"
 #include "Profiler.h"
+#include "OperationTimer.h"
+#include "LogRegistry.h"
 #include "SharedSignal.h"
 
 #include <memory>
@@ -156,6 +158,30 @@ class PYBIND11_EXPORT Compute
          */
         void forceCompute(uint64_t timestep);
 
+        //! Get the timer of this compute
+        OperationTimer& getTimer()
+            {
+            return m_timer;
+            }
+
+        //! Get the time in seconds spent in this compute since the start of the run
+        double getExecutionTime()
+            {
+            return m_timer.getTotalTime();
+            }
+
+        //! Get the log quantities this compute evaluates in C++
+        const LogRegistry& getLogRegistry() const
+            {
+            return m_log_registry;
+            }
+
+        //! Get the names of the log quantities this compute evaluates in C++
+        std::vector<std::string> getLoggedQuantityNames() const
+            {
+            return m_log_registry.getNames();
+            }
+
         /// Python will notify C++ objects when they are detached from Simulation
         virtual void notifyDetach() { };
 
@@ -200,6 +226,8 @@ class PYBIND11_EXPORT Compute
         bool m_force_compute;           //!< true if calculation is enforced
         uint64_t m_last_computed;       //!< Stores the last timestep compute was called
         bool m_first_compute;           //!< true if compute has not yet been called
+        OperationTimer m_timer;         //!< Time spent in this compute
+        LogRegistry m_log_registry;     //!< Log quantities evaluated in C++
 
         //! Simple method for testing if the computation should be run or not
         virtual bool shouldCompute(uint64_t timestep);
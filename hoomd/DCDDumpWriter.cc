@@ -16,6 +16,9 @@
 #include "Communicator.h"
 #endif
 
+#include <algorithm>
+#include <climits>
+#include <sstream>
 #include <stdexcept>
 
 namespace py = pybind11;
@@ -31,7 +34,7 @@ using namespace std;
 /*! \param file file to write to
     \param val integer to write
 */
-static void write_int(fstream &file, unsigned int val)
+static void write_int(ostream &file, unsigned int val)
     {
     file.write((char *)&val, sizeof(unsigned int));
     }
@@ -67,8 +70,8 @@ DCDDumpWriter::DCDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
                              bool overwrite)
     : Analyzer(sysdef), m_fname(fname), m_start_timestep(0), m_period(period), m_group(group),
       m_num_frames_written(0), m_last_written_step(0), m_appending(false),
-      m_unwrap_full(false), m_unwrap_rigid(false), m_angle(false),
-      m_overwrite(overwrite), m_is_initialized(false)
+      m_unwrap_full(false), m_unwrap_rigid(false), m_angle(false), m_parallel_io(false),
+      m_overwrite(overwrite), m_is_initialized(false), m_staging_buffer(NULL)
     {
     m_exec_conf->msg->notice(5) << "Constructing DCDDumpWriter: " << fname << " " << period << " " << overwrite << endl;
     }
@@ -132,6 +135,11 @@ DCDDumpWriter::~DCDDumpWriter()
         {
         m_file.close();
         delete[] m_staging_buffer;
+
+#ifdef ENABLE_MPI
+        if (useParallelIO())
+            MPI_File_close(&m_mpi_file);
+#endif
         }
     }
 
@@ -145,6 +153,15 @@ void DCDDumpWriter::analyze(uint64_t timestep)
     if (m_prof)
         m_prof->push("Dump DCD");
 
+#ifdef ENABLE_MPI
+    if (useParallelIO())
+        {
+        analyzeParallel(timestep);
+        if (m_prof) m_prof->pop();
+        return;
+        }
+#endif
+
     // take particle data snapshot
     SnapshotParticleData<Scalar> snapshot;
 
@@ -195,6 +212,203 @@ void DCDDumpWriter::analyze(uint64_t timestep)
         m_prof->pop();
     }
 
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step of the simulation
+
+    The root rank creates the file or reads its header as in initFileIO() and shares the header data with the other
+    ranks, then all ranks open the file for collective writes.
+*/
+void DCDDumpWriter::initFileIOParallel(uint64_t timestep)
+    {
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    m_nglobal = m_pdata->getNGlobal();
+
+    if (m_exec_conf->isRoot())
+        {
+        initFileIO(timestep);
+        m_file.seekp(0, std::ios_base::end);
+        m_frame_offset = m_file.tellp();
+        m_file.close();
+        }
+    m_is_initialized = true;
+
+    bcast(m_num_frames_written, 0, mpi_comm);
+    bcast(m_start_timestep, 0, mpi_comm);
+    bcast(m_last_written_step, 0, mpi_comm);
+    bcast(m_appending, 0, mpi_comm);
+    bcast(m_frame_offset, 0, mpi_comm);
+
+    int ret = MPI_File_open(mpi_comm, (char *)m_fname.c_str(), MPI_MODE_WRONLY, MPI_INFO_NULL, &m_mpi_file);
+    if (ret != MPI_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "DCD: Unable to open " << m_fname << " for parallel IO" << endl;
+        throw runtime_error("Error opening DCD file");
+        }
+
+    // map the tags to their position in the frame
+    unsigned int nparticles = m_group->getNumMembersGlobal();
+    m_group_idx.assign(nparticles ? m_group->getMemberTag(nparticles - 1) + 1 : 0, UINT_MAX);
+    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
+        m_group_idx[m_group->getMemberTag(group_idx)] = group_idx;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    Every rank writes the coordinates of its local group members to their slots in the frame, so the frame is
+    identical to the one written in serial.
+*/
+void DCDDumpWriter::analyzeParallel(uint64_t timestep)
+    {
+    if (! m_is_initialized)
+        initFileIOParallel(timestep);
+
+    if (m_nglobal != m_pdata->getNGlobal())
+        {
+        m_exec_conf->msg->error() << "analyze.dcd: Change in number of particles unsupported by DCD file format."
+            << std::endl;
+        throw std::runtime_error("Error writing DCD file");
+        }
+
+    if (m_appending && timestep <= m_last_written_step)
+        {
+        m_exec_conf->msg->warning() << "DCD: not writing output at timestep " << timestep << " because the file reports that it already has data up to step " << m_last_written_step << endl;
+        return;
+        }
+
+    bool root = m_exec_conf->isRoot();
+    if (root && (timestep - m_start_timestep) % m_period != 0)
+        m_exec_conf->msg->warning() << "DCD: writing time step " << timestep << " which is not specified in the period of the DCD file: " << m_start_timestep << " + i * " << m_period << endl;
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    unsigned int nparticles = m_group->getNumMembersGlobal();
+    unsigned int block_size = (unsigned int)(nparticles * sizeof(float));
+
+    // sort the local members by their position in the group
+    unsigned int nlocal = m_group->getNumMembers();
+    std::vector< std::pair<unsigned int, unsigned int> > order(nlocal);
+        {
+        ArrayHandle<unsigned int> h_member_idx(m_group->getIndexArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int j = 0; j < nlocal; j++)
+            {
+            unsigned int idx = h_member_idx.data[j];
+            order[j] = std::make_pair(m_group_idx[h_tag.data[idx]], idx);
+            }
+        }
+    std::sort(order.begin(), order.end());
+
+    // unwrap the positions
+    std::vector<int> displacements(nlocal);
+    std::vector<float> coords[3];
+    for (unsigned int d = 0; d < 3; d++)
+        coords[d].resize(nlocal);
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        unsigned int n_local_and_ghost = m_pdata->getN() + m_pdata->getNGhosts();
+
+        for (unsigned int k = 0; k < nlocal; k++)
+            {
+            unsigned int idx = order[k].second;
+            displacements[k] = int(order[k].first);
+            vec3<Scalar> pos(h_pos.data[idx]);
+
+            if (m_unwrap_full)
+                {
+                pos = box.shift(pos, h_image.data[idx]);
+                }
+            else if (m_unwrap_rigid && h_body.data[idx] < MIN_FLOPPY)
+                {
+                unsigned int central_idx = h_rtag.data[h_body.data[idx]];
+                if (central_idx >= n_local_and_ghost)
+                    {
+                    m_exec_conf->msg->error() << "DCD: The central particle of body " << h_body.data[idx]
+                                              << " is not available on rank " << m_exec_conf->getRank() << endl;
+                    throw runtime_error("Error writing DCD file");
+                    }
+
+                // ghost positions may be shifted by a box vector, place the particle next to the wrapped central
+                // particle as in the serial mode
+                vec3<Scalar> central(h_pos.data[central_idx]);
+                vec3<Scalar> dr = box.minImage(pos - central);
+                int3 img = make_int3(0, 0, 0);
+                box.wrap(central, img);
+                pos = central + dr;
+                }
+
+            coords[0][k] = float(pos.x);
+            coords[1][k] = float(pos.y);
+            coords[2][k] = float(pos.z);
+
+            // m_angle set to True turns on a hack where the particle orientation angle is written out to the z
+            // component, this only works in 2D simulations
+            if (m_angle)
+                {
+                quat<Scalar> orientation(h_orientation.data[idx]);
+                coords[2][k] = float(atan2(orientation.v.z, orientation.s) * 2);
+                }
+            }
+        }
+
+    // the root rank writes the frame header, the record markers and the updated file header
+    int ret = MPI_File_set_view(m_mpi_file, 0, MPI_BYTE, MPI_BYTE, (char *)"native", MPI_INFO_NULL);
+    if (root)
+        {
+        std::ostringstream frame_header;
+        write_frame_header(frame_header);
+        std::string header = frame_header.str();
+        ret |= MPI_File_write_at(m_mpi_file, m_frame_offset, (void *)header.data(), int(header.size()), MPI_BYTE,
+                                 MPI_STATUS_IGNORE);
+
+        MPI_Offset block_offset = m_frame_offset + header.size();
+        for (unsigned int d = 0; d < 3; d++)
+            {
+            ret |= MPI_File_write_at(m_mpi_file, block_offset, &block_size, 1, MPI_UNSIGNED, MPI_STATUS_IGNORE);
+            ret |= MPI_File_write_at(m_mpi_file, block_offset + sizeof(unsigned int) + block_size, &block_size, 1,
+                                     MPI_UNSIGNED, MPI_STATUS_IGNORE);
+            block_offset += block_size + 2*sizeof(unsigned int);
+            }
+
+        unsigned int nframes = m_num_frames_written + 1;
+        uint32_t nstep = static_cast<uint32_t>(timestep);
+        ret |= MPI_File_write_at(m_mpi_file, NFILE_POS, &nframes, 1, MPI_UNSIGNED, MPI_STATUS_IGNORE);
+        ret |= MPI_File_write_at(m_mpi_file, NSTEP_POS, &nstep, 1, MPI_UNSIGNED, MPI_STATUS_IGNORE);
+
+        if (timestep > std::numeric_limits<uint32_t>::max())
+            m_exec_conf->msg->warning() << "DCD: Truncating timestep to lower 32 bits" << endl;
+        }
+
+    // all ranks write their coordinates to the x, y and z blocks of the frame
+    const unsigned int frame_header_size = 48 + 2*sizeof(unsigned int);
+    MPI_Datatype filetype;
+    MPI_Type_create_indexed_block(int(nlocal), 1, displacements.data(), MPI_FLOAT, &filetype);
+    MPI_Type_commit(&filetype);
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        MPI_Offset block_offset = m_frame_offset + frame_header_size + d*(block_size + 2*sizeof(unsigned int))
+                                  + sizeof(unsigned int);
+        ret |= MPI_File_set_view(m_mpi_file, block_offset, MPI_FLOAT, filetype, (char *)"native", MPI_INFO_NULL);
+        ret |= MPI_File_write_all(m_mpi_file, coords[d].data(), int(nlocal), MPI_FLOAT, MPI_STATUS_IGNORE);
+        }
+    MPI_Type_free(&filetype);
+
+    // check for errors on any rank
+    MPI_Allreduce(MPI_IN_PLACE, &ret, 1, MPI_INT, MPI_BOR, m_exec_conf->getMPICommunicator());
+    if (ret != MPI_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "DCD: I/O error while writing DCD frame with parallel IO" << endl;
+        throw runtime_error("Error writing DCD file");
+        }
+
+    m_num_frames_written++;
+    m_frame_offset += frame_header_size + 3*(block_size + 2*sizeof(unsigned int));
+    }
+#endif
+
 /*! \param file File to write to
     Writes the initial DCD header to the beginning of the file. This must be
     called on a newly created (or truncated file).
@@ -270,7 +484,7 @@ void DCDDumpWriter::write_file_header(std::fstream &file)
     Writes the header that precedes each snapshot in the file. This header
     includes information on the box size of the simulation.
 */
-void DCDDumpWriter::write_frame_header(std::fstream &file)
+void DCDDumpWriter::write_frame_header(std::ostream &file)
     {
     double unitcell[6];
     BoxDim box = m_pdata->getGlobalBox();
@@ -421,5 +635,6 @@ void export_DCDDumpWriter(py::module& m)
     .def_property("unwrap_rigid", &DCDDumpWriter::getUnwrapRigid, &DCDDumpWriter::setUnwrapRigid)
     .def_property("angle_z", &DCDDumpWriter::getAngleZ, &DCDDumpWriter::setAngleZ)
     .def_property_readonly("overwrite", &DCDDumpWriter::getOverwrite)
+    .def_property("parallel_io", &DCDDumpWriter::getParallelIO, &DCDDumpWriter::setParallelIO)
     ;
     }
@@ -13,6 +13,7 @@
 #include <string>
 #include <memory>
 #include <fstream>
+#include <vector>
 
 /*! \file DCDDumpWriter.h
     \brief Declares the DCDDumpWriter class
@@ -46,6 +47,11 @@
     Due to a limitation in the DCD format, the time step period between calls to
     analyze() \b must be specified up front. If analyze() detects that this period is
     not being maintained, it will print a warning but continue.
+
+    With parallel IO enabled in an MPI simulation, the particles are not gathered to the root rank. Every rank
+    unwraps the positions of its local group members, sorts them by their position in the group and writes them
+    directly to the computed offsets of the frame with collective MPI-IO. The root rank only writes the file and
+    frame headers. Rigid bodies are unwrapped around the central particle, which must be local or a ghost.
     \ingroup analyzers
 */
 class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
@@ -102,6 +108,22 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
             return m_overwrite;
             }
 
+        //! Set whether each rank writes its particles with MPI-IO
+        void setParallelIO(bool enable)
+            {
+            if (m_is_initialized && enable != m_parallel_io)
+                {
+                m_exec_conf->msg->error() << "DCD: Cannot change parallel_io after the file is opened" << std::endl;
+                throw std::runtime_error("Error setting DCD parameters");
+                }
+            m_parallel_io = enable;
+            }
+
+        bool getParallelIO()
+            {
+            return m_parallel_io;
+            }
+
     private:
         std::string m_fname;                //!< The file name we are writing to
         uint64_t m_start_timestep;          //!< First time step written to the file
@@ -113,6 +135,7 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
         bool m_unwrap_full;                 //!< True if coordinates should be written out fully unwrapped in the box
         bool m_unwrap_rigid;                //!< True if rigid bodies should be written out unwrapped
         bool m_angle;                       //!< True if the z-component should be set to the orientation angle
+        bool m_parallel_io;                 //!< True if each rank writes its particles with MPI-IO
 
         bool m_overwrite;                   //!< True if file should be overwritten
         bool m_is_initialized;              //!< True if file IO has been initialized
@@ -121,12 +144,18 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
         float *m_staging_buffer;            //!< Buffer for staging particle positions in tag order
         std::fstream m_file;                //!< The file object
 
+#ifdef ENABLE_MPI
+        MPI_File m_mpi_file;                        //!< The file handle shared by all ranks in parallel IO
+        uint64_t m_frame_offset;                    //!< Offset of the next frame in the file
+        std::vector<unsigned int> m_group_idx;      //!< Position of each tag in the group, UINT_MAX for non-members
+#endif
+
         // helper functions
 
         //! Initializes the file header
         void write_file_header(std::fstream &file);
         //! Writes the frame header
-        void write_frame_header(std::fstream &file);
+        void write_frame_header(std::ostream &file);
         //! Writes the particle positions for a frame
         void write_frame_data(std::fstream &file, const SnapshotParticleData<Scalar>& snapshot);
         //! Updates the file header
@@ -134,6 +163,18 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
         //! Initializes the output file for writing
         void initFileIO(uint64_t timestep);
 
+#ifdef ENABLE_MPI
+        //! Test if the frames are written with parallel IO
+        bool useParallelIO() const
+            {
+            return m_parallel_io && m_comm;
+            }
+        //! Initializes the shared output file for parallel IO
+        void initFileIOParallel(uint64_t timestep);
+        //! Writes the frame of the current time step with parallel IO
+        void analyzeParallel(uint64_t timestep);
+#endif
+
     };
 
 //! Exports the DCDDumpWriter class to python
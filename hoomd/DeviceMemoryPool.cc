@@ -0,0 +1,156 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file DeviceMemoryPool.cc
+    \brief Defines the DeviceMemoryPool class
+*/
+
+#ifdef ENABLE_HIP
+#include "DeviceMemoryPool.h"
+
+#include <algorithm>
+
+DeviceMemoryPool::DeviceMemoryPool(bool managed, size_t max_cached_bytes, float cache_reltol)
+    : m_managed(managed), m_max_cached_bytes(max_cached_bytes), m_cache_reltol(cache_reltol)
+    {
+    }
+
+DeviceMemoryPool::~DeviceMemoryPool()
+    {
+    // all arrays hold a reference to the execution configuration, so all blocks have been returned at this point
+    releaseCache();
+    }
+
+/*! Sizes are rounded up to a multiple of 1/8 of the largest power of two not larger than the size, and to at least
+    256 bytes. Consecutive size classes are at most 12.5% apart.
+*/
+size_t DeviceMemoryPool::roundSize(size_t num_bytes)
+    {
+    size_t granularity = 256;
+    while (granularity*8 <= num_bytes)
+        granularity *= 2;
+    return (num_bytes + granularity - 1) / granularity * granularity;
+    }
+
+hipError_t DeviceMemoryPool::allocate(void **ptr, size_t num_bytes)
+    {
+    *ptr = nullptr;
+    if (num_bytes == 0)
+        return hipSuccess;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t block_bytes = roundSize(num_bytes);
+
+    // reuse the smallest free block that is large enough, within the tolerance
+    free_blocks_type::iterator free_block = m_free_blocks.lower_bound(block_bytes);
+    if (free_block != m_free_blocks.end()
+        && free_block->first <= block_bytes + (size_t)((float)block_bytes*m_cache_reltol))
+        {
+        *ptr = free_block->second;
+        block_bytes = free_block->first;
+        m_free_blocks.erase(free_block);
+        m_stats.bytes_cached -= block_bytes;
+        m_stats.num_hits++;
+        }
+    else
+        {
+        hipError_t err = m_managed ? hipMallocManaged(ptr, block_bytes, hipMemAttachGlobal)
+                                   : hipMalloc(ptr, block_bytes);
+
+        if (err != hipSuccess && !m_free_blocks.empty())
+            {
+            // the cached blocks may be holding the memory we need, release them and try again
+            hipGetLastError();
+            for (auto it = m_free_blocks.begin(); it != m_free_blocks.end(); ++it)
+                hipFree(it->second);
+            m_stats.bytes_reserved -= m_stats.bytes_cached;
+            m_stats.bytes_cached = 0;
+            m_free_blocks.clear();
+
+            err = m_managed ? hipMallocManaged(ptr, block_bytes, hipMemAttachGlobal)
+                            : hipMalloc(ptr, block_bytes);
+            }
+
+        if (err != hipSuccess)
+            {
+            *ptr = nullptr;
+            return err;
+            }
+
+        m_stats.bytes_reserved += block_bytes;
+        m_stats.peak_bytes_reserved = std::max(m_stats.peak_bytes_reserved, m_stats.bytes_reserved);
+        m_stats.num_misses++;
+        }
+
+    m_allocated_blocks.insert(std::make_pair(*ptr, block_bytes));
+    m_stats.bytes_in_use += block_bytes;
+    m_stats.peak_bytes_in_use = std::max(m_stats.peak_bytes_in_use, m_stats.bytes_in_use);
+
+    return hipSuccess;
+    }
+
+hipError_t DeviceMemoryPool::deallocate(void *ptr)
+    {
+    if (ptr == nullptr)
+        return hipSuccess;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    allocated_blocks_type::iterator block = m_allocated_blocks.find(ptr);
+    if (block == m_allocated_blocks.end())
+        {
+        // not allocated by the pool
+        return hipFree(ptr);
+        }
+
+    size_t block_bytes = block->second;
+    m_allocated_blocks.erase(block);
+    m_stats.bytes_in_use -= block_bytes;
+
+    m_free_blocks.insert(std::make_pair(block_bytes, ptr));
+    m_stats.bytes_cached += block_bytes;
+
+    trimCache();
+    return hipSuccess;
+    }
+
+void DeviceMemoryPool::trimCache()
+    {
+    while (m_stats.bytes_cached > m_max_cached_bytes && !m_free_blocks.empty())
+        {
+        // release the largest cached block
+        free_blocks_type::iterator largest = std::prev(m_free_blocks.end());
+        hipFree(largest->second);
+        m_stats.bytes_cached -= largest->first;
+        m_stats.bytes_reserved -= largest->first;
+        m_free_blocks.erase(largest);
+        }
+    }
+
+void DeviceMemoryPool::releaseCache()
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto it = m_free_blocks.begin(); it != m_free_blocks.end(); ++it)
+        hipFree(it->second);
+    m_stats.bytes_reserved -= m_stats.bytes_cached;
+    m_stats.bytes_cached = 0;
+    m_free_blocks.clear();
+    }
+
+void DeviceMemoryPool::setMaxCachedBytes(size_t max_cached_bytes)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_max_cached_bytes = max_cached_bytes;
+    trimCache();
+    }
+
+MemoryPoolStatistics DeviceMemoryPool::getStatistics() const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+    }
+
+#endif // ENABLE_HIP
@@ -0,0 +1,93 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file DeviceMemoryPool.h
+    \brief Declares a pool allocator for persistent device and managed memory allocations
+*/
+
+#pragma once
+
+#ifdef ENABLE_HIP
+#include <hip/hip_runtime.h>
+
+#include "MemoryTraceback.h"
+
+#include <map>
+#include <mutex>
+
+//! Pool allocator for the persistent allocations of GPUArray and GlobalArray
+/*! Arrays that grow and shrink with the number of local particles (ghost particles, migration, particle insertion
+    and removal) free and allocate memory every time their size changes. hipMalloc and hipFree are expensive and
+    hipFree synchronizes the device, so DeviceMemoryPool keeps freed blocks and hands them out again.
+
+    Requests are rounded up to size classes that are 1/8 of a power of two apart. The rounding gives allocations
+    some room to grow, and freed blocks are reused for any request of up to \a m_cache_reltol smaller size, so
+    that fluctuating array sizes settle on a set of cached blocks. Cached blocks are released, largest first, when
+    they exceed \a m_max_cached_bytes, or all at once when an allocation fails.
+
+    Blocks are reused in the order of the host calls. This is safe for work issued to the default stream, because
+    any kernel that accesses a freed block was issued before the kernels that access its next owner.
+
+    Allocation statistics, including the high-water marks of the memory in use and reserved, are available through
+    getStatistics() and reported by MemoryTraceback::outputPoolStatistics().
+*/
+class PYBIND11_EXPORT DeviceMemoryPool
+    {
+    public:
+        //! Constructor
+        /*! \param managed True if the pool allocates managed memory
+            \param max_cached_bytes Maximum number of bytes kept in free blocks
+            \param cache_reltol Relative tolerance for reusing a larger free block
+        */
+        DeviceMemoryPool(bool managed, size_t max_cached_bytes, float cache_reltol = 0.25f);
+
+        DeviceMemoryPool(const DeviceMemoryPool&) = delete;
+        DeviceMemoryPool& operator=(const DeviceMemoryPool&) = delete;
+
+        //! Destructor
+        ~DeviceMemoryPool();
+
+        //! Allocate a block
+        /*! \param num_bytes Number of bytes to allocate
+            \param ptr Set to the allocated block, or nullptr if \a num_bytes is 0
+            \returns The error code of the underlying allocation
+        */
+        hipError_t allocate(void **ptr, size_t num_bytes);
+
+        //! Return a block to the pool
+        /*! \param ptr Block previously returned by allocate()
+            \returns The error code of the underlying free, if the block is released
+        */
+        hipError_t deallocate(void *ptr);
+
+        //! Release all cached blocks
+        void releaseCache();
+
+        //! Set the maximum number of bytes kept in free blocks
+        void setMaxCachedBytes(size_t max_cached_bytes);
+
+        //! Get the allocation statistics
+        MemoryPoolStatistics getStatistics() const;
+
+    private:
+        //! Round a request up to its size class
+        static size_t roundSize(size_t num_bytes);
+
+        //! Release the largest free blocks until the cache fits
+        void trimCache();
+
+        typedef std::multimap<size_t, void*> free_blocks_type;
+        typedef std::map<void*, size_t> allocated_blocks_type;
+
+        bool m_managed;                 //!< True if the pool allocates managed memory
+        size_t m_max_cached_bytes;      //!< Maximum number of bytes in free blocks
+        float m_cache_reltol;           //!< Relative tolerance for reusing a larger free block
+
+        free_blocks_type m_free_blocks;             //!< Cached blocks by size
+        allocated_blocks_type m_allocated_blocks;   //!< Blocks in use and their sizes
+
+        MemoryPoolStatistics m_stats;   //!< Allocation statistics
+        mutable std::mutex m_mutex;     //!< Serializes access from multiple threads
+    };
+
+#endif // ENABLE_HIP
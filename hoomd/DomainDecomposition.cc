@@ -35,7 +35,7 @@ DomainDecomposition::DomainDecomposition(std::shared_ptr<ExecutionConfiguration>
                                unsigned int nz,
                                bool twolevel
                                )
-      : m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator())
+      : m_bisect(false), m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator())
     {
     m_exec_conf->msg->notice(5) << "Constructing DomainDecomposition" << endl;
 
@@ -64,7 +64,7 @@ DomainDecomposition::DomainDecomposition(std::shared_ptr<ExecutionConfiguration>
                                          const std::vector<Scalar>& fxs,
                                          const std::vector<Scalar>& fys,
                                          const std::vector<Scalar>& fzs)
-    : m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator())
+    : m_bisect(false), m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator())
     {
     m_exec_conf->msg->notice(5) << "Constructing DomainDecomposition" << endl;
 
@@ -524,6 +524,77 @@ void DomainDecomposition::setCumulativeFractions(unsigned int dir,
         }
     }
 
+/*!
+ * \param global_box The global simulation box
+ * \param pos Positions of the particles held by this rank (may be empty)
+ *
+ * Along each dimension, the cut planes are placed at the quantiles of the particle distribution, so that every slab of
+ * domains holds the same number of particles. This is what recursively bisecting the particles along the dimension
+ * gives when the cuts must span the whole box. The quantiles are found from a histogram of the fractional coordinates
+ * that is summed over all ranks, with a resolution of 1024 bins per domain. No domain is made narrower than a
+ * quarter of the uniform width, so that nearly empty regions do not collapse below the ghost layer width.
+ *
+ * \note bisect() is a collective call, and all ranks must participate even if they hold no particles.
+ */
+void DomainDecomposition::bisect(const BoxDim& global_box, const std::vector<Scalar3>& pos)
+    {
+    const unsigned int n_dims[3] = {m_nx, m_ny, m_nz};
+    for (unsigned int dir=0; dir < 3; ++dir)
+        {
+        const unsigned int n = n_dims[dir];
+        if (n == 1)
+            continue;
+
+        // histogram the fractional coordinates along dir
+        const unsigned int n_bins = 1024*n;
+        std::vector<unsigned int> hist(n_bins, 0);
+        for (auto it = pos.begin(); it != pos.end(); ++it)
+            {
+            const Scalar3 f = global_box.makeFraction(*it);
+            const Scalar f_dir = (dir == 0) ? f.x : ((dir == 1) ? f.y : f.z);
+            int bin = int(f_dir * Scalar(n_bins));
+            if (bin < 0)
+                bin = 0;
+            else if (bin >= (int)n_bins)
+                bin = n_bins - 1;
+            hist[bin]++;
+            }
+        MPI_Allreduce(MPI_IN_PLACE, &hist[0], n_bins, MPI_UNSIGNED, MPI_SUM, m_mpi_comm);
+
+        const double total = std::accumulate(hist.begin(), hist.end(), 0.0);
+        if (total == 0.0)
+            continue;
+
+        // interpolate the quantiles k/n within the bins
+        std::vector<Scalar> cum_frac(n+1);
+        cum_frac[0] = Scalar(0.0);
+        cum_frac[n] = Scalar(1.0);
+        double cum = 0.0;
+        unsigned int bin = 0;
+        for (unsigned int k=1; k < n; ++k)
+            {
+            const double target = total * double(k) / double(n);
+            while (bin < n_bins - 1 && cum + hist[bin] < target)
+                {
+                cum += hist[bin];
+                ++bin;
+                }
+            const double in_bin = (hist[bin] > 0) ? (target - cum) / double(hist[bin]) : 0.0;
+            cum_frac[k] = Scalar((double(bin) + std::min(in_bin, 1.0)) / double(n_bins));
+            }
+
+        // enforce the minimum width from below and then from above
+        const Scalar min_width = Scalar(0.25) / Scalar(n);
+        for (unsigned int k=1; k < n; ++k)
+            cum_frac[k] = std::max(cum_frac[k], cum_frac[k-1] + min_width);
+        for (unsigned int k=n-1; k >= 1; --k)
+            cum_frac[k] = std::min(cum_frac[k], cum_frac[k+1] - min_width);
+
+        // every rank computed the same fractions, the broadcast only validates them
+        setCumulativeFractions(dir, cum_frac, 0);
+        }
+    }
+
 /*!
  * \param global_box The global simulation box
  * \returns The local simulation box for the current rank
@@ -678,6 +749,7 @@ void export_DomainDecomposition(py::module& m)
               const std::vector<Scalar>&,
               const std::vector<Scalar>&>())
     .def("getCumulativeFractions", &DomainDecomposition::getCumulativeFractions)
+    .def_property("bisect", &DomainDecomposition::getBisect, &DomainDecomposition::setBisect)
     ;
     }
 #endif // ENABLE_MPI
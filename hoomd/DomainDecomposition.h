@@ -44,7 +44,10 @@
  *  ranks does not match the number that is available, behavior is reverted to the normal default with
  *  uniform cuts along each dimension.
  *
- *  The initialization of the domain decomposition scheme is performed in the constructor.
+ *  The initialization of the domain decomposition scheme is performed in the constructor. When bisection is enabled,
+ *  the particle data places the cut planes at the quantiles of the particle distribution with bisect() before it
+ *  distributes an initial snapshot. The cuts still span the whole box, so that every domain keeps its 26 Cartesian
+ *  neighbors for communication.
  */
 class PYBIND11_EXPORT DomainDecomposition
     {
@@ -152,6 +155,21 @@ class PYBIND11_EXPORT DomainDecomposition
         //! Collectively set the cumulative fractions along a dimension from a given rank
         void setCumulativeFractions(unsigned int dir, const std::vector<Scalar>& cum_frac, unsigned int root);
 
+        //! Get whether the cut planes are placed by bisecting the initial particle distribution
+        bool getBisect() const
+            {
+            return m_bisect;
+            }
+
+        //! Set whether the cut planes are placed by bisecting the initial particle distribution
+        void setBisect(bool bisect)
+            {
+            m_bisect = bisect;
+            }
+
+        //! Collectively place the cut planes so that the domain slabs hold equal numbers of particles
+        void bisect(const BoxDim& global_box, const std::vector<Scalar3>& pos);
+
         //! Get the dimensions of the local simulation box
         const BoxDim calculateLocalBox(const BoxDim& global_box);
 
@@ -174,6 +192,7 @@ class PYBIND11_EXPORT DomainDecomposition
         std::multimap<std::string, unsigned int> m_node_map; //!< Map of ranks per node
         unsigned int m_max_n_node;   //!< Maximum number of ranks on a node
         bool m_twolevel;             //!< Whether we use a two-level decomposition
+        bool m_bisect;               //!< Whether to bisect the initial particle distribution
 
         GlobalArray<unsigned int> m_cart_ranks; //!< A lookup-table to map the cartesian grid index onto ranks
         GlobalArray<unsigned int> m_cart_ranks_inv; //!< Inverse permutation of grid index lookup table
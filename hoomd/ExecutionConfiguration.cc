@@ -5,6 +5,7 @@
 
 #include "ExecutionConfiguration.h"
 #include "HOOMDVersion.h"
+#include "AutotunerCache.h"
 
 #ifdef ENABLE_HIP
 #include <hip/hip_runtime.h>
@@ -29,6 +30,7 @@ using namespace std;
 
 #if defined(ENABLE_HIP)
 #include "CachedAllocator.h"
+#include "DeviceMemoryPool.h"
 #endif
 
 /*! \file ExecutionConfiguration.cc
@@ -75,6 +77,10 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
         }
 
     msg->notice(5) << "Constructing ExecutionConfiguration: ( " << s.str() << ") " << endl;
+
+    m_host_memory_policy.reset(new HostMemoryPolicy());
+    m_memory_usage = std::make_shared<MemoryUsage>(msg);
+    msg->notice(3) << "Host memory: " << m_host_memory_policy->describe() << endl;
     exec_mode = mode;
 
 #if defined(ENABLE_HIP)
@@ -182,6 +188,10 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
         // initialize cached allocator, max allocation 0.5*global mem
         m_cached_alloc.reset(new CachedAllocator(false, (unsigned int)(0.5f*(float)dev_prop.totalGlobalMem)));
         m_cached_alloc_managed.reset(new CachedAllocator(true, (unsigned int)(0.5f*(float)dev_prop.totalGlobalMem)));
+
+        // initialize the pools for persistent allocations, cache at most 0.25*global mem in free blocks
+        m_device_pool.reset(new DeviceMemoryPool(false, size_t(0.25*double(dev_prop.totalGlobalMem))));
+        m_managed_pool.reset(new DeviceMemoryPool(true, size_t(0.25*double(dev_prop.totalGlobalMem))));
         }
     #endif
 
@@ -240,10 +250,16 @@ ExecutionConfiguration::~ExecutionConfiguration()
         }
     #endif
 
+    // report the high-water marks before releasing the pools
+    outputMemoryPoolStatistics();
+
     #if defined(ENABLE_HIP)
     // the destructors of these objects can issue hip calls, so free them before the device reset
     m_cached_alloc.reset();
     m_cached_alloc_managed.reset();
+
+    m_device_pool.reset();
+    m_managed_pool.reset();
     #endif
     }
 
@@ -634,6 +650,85 @@ int ExecutionConfiguration::guessLocalRank(bool &found)
     }
 
 
+/*! \param filename File to read cached parameters from and write new optima to. Set to an empty string to disable
+    the cache.
+
+    Every rank reads the file, the root rank of each partition writes it.
+*/
+void ExecutionConfiguration::setAutotunerCacheFile(const std::string& filename)
+    {
+    if (filename.empty())
+        {
+        m_autotuner_cache.reset();
+        return;
+        }
+
+    // the device model is part of the key, parameters tuned on one model are not valid on another
+    std::ostringstream device;
+    #if defined(ENABLE_HIP)
+    if (isCUDAEnabled())
+        device << m_gpu_id.size() << "x " << dev_prop.name;
+    else
+    #endif
+        device << "CPU";
+
+    m_autotuner_cache.reset(new AutotunerCache(filename, device.str(), isRoot()));
+    msg->notice(3) << "Using autotuner cache " << filename << std::endl;
+    }
+
+std::string ExecutionConfiguration::getAutotunerCacheFile() const
+    {
+    if (m_autotuner_cache)
+        return m_autotuner_cache->getFilename();
+    else
+        return std::string();
+    }
+
+/*! The statistics are only written when memory tracing is enabled.
+*/
+void ExecutionConfiguration::outputMemoryPoolStatistics() const
+    {
+    if (!m_memory_traceback)
+        return;
+
+    if (m_host_memory_policy)
+        m_memory_traceback->outputHostMemoryStatistics(msg, m_host_memory_policy->describe(),
+                                                       m_host_memory_policy->getStatistics());
+
+    #if defined(ENABLE_HIP)
+
+    if (m_device_pool)
+        m_memory_traceback->outputPoolStatistics(msg, "device", m_device_pool->getStatistics());
+    if (m_managed_pool)
+        m_memory_traceback->outputPoolStatistics(msg, "managed", m_managed_pool->getStatistics());
+    #endif
+    }
+
+/*! \returns The counters of MemoryUsage, and the bytes the cached allocators hold under "CachedAllocator" and
+    "CachedAllocatorManaged"
+*/
+std::map<std::string, MemoryUsageCounter> ExecutionConfiguration::getMemoryUsageCounters() const
+    {
+    std::map<std::string, MemoryUsageCounter> counters = m_memory_usage->getCounters();
+
+    #if defined(ENABLE_HIP)
+    if (m_cached_alloc)
+        {
+        MemoryUsageCounter& counter = counters["CachedAllocator"];
+        counter.bytes = m_cached_alloc->getNumBytesAllocated();
+        counter.peak_bytes = m_cached_alloc->getPeakBytesAllocated();
+        }
+    if (m_cached_alloc_managed)
+        {
+        MemoryUsageCounter& counter = counters["CachedAllocatorManaged"];
+        counter.bytes = m_cached_alloc_managed->getNumBytesAllocated();
+        counter.peak_bytes = m_cached_alloc_managed->getPeakBytesAllocated();
+        }
+    #endif
+
+    return counters;
+    }
+
 void export_ExecutionConfiguration(py::module& m)
     {
     py::class_<ExecutionConfiguration, std::shared_ptr<ExecutionConfiguration> > executionconfiguration(m,"ExecutionConfiguration");
@@ -659,9 +754,30 @@ void export_ExecutionConfiguration(py::module& m)
         .def("setMemoryTracing", &ExecutionConfiguration::setMemoryTracing)
         .def("getMemoryTracer", &ExecutionConfiguration::getMemoryTracer)
         .def("memoryTracingEnabled", &ExecutionConfiguration::memoryTracingEnabled)
+        .def("outputMemoryPoolStatistics", &ExecutionConfiguration::outputMemoryPoolStatistics)
+        .def("getMemoryUsage", [](const ExecutionConfiguration& self)
+            {
+            std::map<std::string, size_t> bytes;
+            for (const auto& owner_counter : self.getMemoryUsageCounters())
+                bytes[owner_counter.first] = owner_counter.second.bytes;
+            return bytes;
+            })
+        .def("getPeakMemoryUsage", [](const ExecutionConfiguration& self)
+            {
+            std::map<std::string, size_t> bytes;
+            for (const auto& owner_counter : self.getMemoryUsageCounters())
+                bytes[owner_counter.first] = owner_counter.second.peak_bytes;
+            return bytes;
+            })
+        .def("setHostHugePages", &ExecutionConfiguration::setHostHugePages)
+        .def("getHostHugePages", &ExecutionConfiguration::getHostHugePages)
+        .def("setHostNUMABinding", &ExecutionConfiguration::setHostNUMABinding)
+        .def("getHostNUMABinding", &ExecutionConfiguration::getHostNUMABinding)
         .def_static("getCapableDevices", &ExecutionConfiguration::getCapableDevices)
         .def_static("getScanMessages", &ExecutionConfiguration::getScanMessages)
         .def("getActiveDevices", &ExecutionConfiguration::getActiveDevices)
+        .def("setAutotunerCacheFile", &ExecutionConfiguration::setAutotunerCacheFile)
+        .def("getAutotunerCacheFile", &ExecutionConfiguration::getAutotunerCacheFile)
     ;
 
     py::enum_<ExecutionConfiguration::executionMode>(executionconfiguration,"executionMode")
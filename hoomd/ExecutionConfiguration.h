@@ -34,6 +34,8 @@
 
 #include "Messenger.h"
 #include "MemoryTraceback.h"
+#include "HostMemoryPolicy.h"
+#include "MemoryUsage.h"
 
 /*! \file ExecutionConfiguration.h
     \brief Declares ExecutionConfiguration and related classes
@@ -49,8 +51,14 @@
 #if defined(ENABLE_HIP)
 //! Forward declaration
 class CachedAllocator;
+
+//! Forward declaration
+class DeviceMemoryPool;
 #endif
 
+//! Forward declaration
+class AutotunerCache;
+
 //! Defines the execution configuration for the simulation
 /*! \ingroup data_structs
     ExecutionConfiguration is a data structure needed to support the hybrid CPU/GPU code. It initializes the CUDA GPU
@@ -288,8 +296,62 @@ class PYBIND11_EXPORT ExecutionConfiguration
         {
         return *m_cached_alloc_managed;
         }
+
+    //! Returns the pool for persistent device memory allocations
+    DeviceMemoryPool& getDeviceMemoryPool() const
+        {
+        return *m_device_pool;
+        }
+
+    //! Returns the pool for persistent managed memory allocations
+    DeviceMemoryPool& getManagedMemoryPool() const
+        {
+        return *m_managed_pool;
+        }
     #endif
 
+    //! Returns the accounting of array memory by owning class
+    std::shared_ptr<MemoryUsage> getMemoryUsage() const
+        {
+        return m_memory_usage;
+        }
+
+    //! Get the array memory by owner, with the temporary buffers of the cached allocators
+    std::map<std::string, MemoryUsageCounter> getMemoryUsageCounters() const;
+
+    //! Returns the placement policy for host memory allocations
+    HostMemoryPolicy& getHostMemoryPolicy() const
+        {
+        return *m_host_memory_policy;
+        }
+
+    //! Enable or disable huge pages for large host allocations
+    void setHostHugePages(bool enable)
+        {
+        m_host_memory_policy->setHugePages(enable);
+        }
+
+    //! Get whether huge pages are used for large host allocations
+    bool getHostHugePages() const
+        {
+        return m_host_memory_policy->getHugePages();
+        }
+
+    //! Enable or disable binding host allocations to the NUMA nodes of this rank
+    void setHostNUMABinding(bool enable)
+        {
+        m_host_memory_policy->setNUMABinding(enable);
+        }
+
+    //! Get whether host allocations are bound to the NUMA nodes of this rank
+    bool getHostNUMABinding() const
+        {
+        return m_host_memory_policy->getNUMABinding();
+        }
+
+    //! Output the allocation statistics of the memory pools through the memory tracer
+    void outputMemoryPoolStatistics() const;
+
     //! Set up memory tracing
     void setMemoryTracing(bool enable)
         {
@@ -339,6 +401,21 @@ class PYBIND11_EXPORT ExecutionConfiguration
         {
         return m_active_device_descriptions;
         }
+
+    //! Set the file that stores optimal autotuner parameters between runs
+    void setAutotunerCacheFile(const std::string& filename);
+
+    //! Get the autotuner cache file name (empty when the cache is disabled)
+    std::string getAutotunerCacheFile() const;
+
+    //! Get the autotuner cache
+    /*! 
+eturns The cache, or NULL when the cache is disabled
+    */
+    AutotunerCache *getAutotunerCache() const
+        {
+        return m_autotuner_cache.get();
+        }
 private:
     //! Guess local rank of this processor, used for GPU initialization
     /*! \returns Local rank guessed from common environment variables
@@ -403,6 +480,8 @@ private:
     #if defined(ENABLE_HIP)
     std::unique_ptr<CachedAllocator> m_cached_alloc;       //!< Cached allocator for temporary allocations
     std::unique_ptr<CachedAllocator> m_cached_alloc_managed; //!< Cached allocator for temporary allocations in managed memory
+    std::unique_ptr<DeviceMemoryPool> m_device_pool;       //!< Pool for persistent device memory allocations
+    std::unique_ptr<DeviceMemoryPool> m_managed_pool;      //!< Pool for persistent managed memory allocations
     #endif
 
     #ifdef ENABLE_TBB
@@ -414,6 +493,12 @@ private:
     void setupStats();
 
     std::unique_ptr<MemoryTraceback> m_memory_traceback;    //!< Keeps track of allocations
+
+    std::unique_ptr<HostMemoryPolicy> m_host_memory_policy; //!< Placement policy for host memory allocations
+
+    std::shared_ptr<MemoryUsage> m_memory_usage;            //!< Always-on accounting of array memory
+
+    std::unique_ptr<AutotunerCache> m_autotuner_cache;      //!< Optimal autotuner parameters from previous runs
     };
 
 
@@ -29,7 +29,8 @@ namespace py = pybind11;
     \post All forces are initialized to 0
 */
 ForceCompute::ForceCompute(std::shared_ptr<SystemDefinition> sysdef)
-     : Compute(sysdef), m_particles_sorted(false)
+     : Compute(sysdef), m_particles_sorted(false), m_respa_period(1), m_accumulate_net_force(false),
+       m_accumulating(false), m_net_force_only(false), m_accumulated_timestep(0)
     {
     assert(m_pdata);
     assert(m_pdata->getMaxN() > 0);
@@ -90,6 +91,20 @@ ForceCompute::ForceCompute(std::shared_ptr<SystemDefinition> sysdef)
 
     // start with no flags computed
     m_computed_flags.reset();
+
+    #ifdef ENABLE_HIP
+    // launch on the default stream unless an integrator assigns a stream
+    m_stream = 0;
+    #endif
+
+    // the logger sums the local energies of all forces in one reduction
+    m_log_registry.registerQuantity("energy",
+        [this](uint64_t timestep)
+            {
+            compute(timestep);
+            return calcEnergyLocal();
+            },
+        true);
     }
 
 /*! \post m_force, m_virial and m_torque are resized to the current maximum particle number
@@ -167,10 +182,11 @@ ForceCompute::~ForceCompute()
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<ForceCompute, &ForceCompute::reallocate>(this);
     }
 
-/*! Sums the total potential energy calculated by the last call to compute() and returns it.
+/*! Sums the potential energy of the local particles calculated by the last call to compute() and returns it.
 */
-Scalar ForceCompute::calcEnergySum()
+double ForceCompute::calcEnergyLocal()
     {
+    restoreForceArrays();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
     // always perform the sum in double precision for better accuracy
     // this is cheating and is really just a temporary hack to get logging up and running
@@ -181,6 +197,14 @@ Scalar ForceCompute::calcEnergySum()
         {
         pe_total += (double)h_force.data[i].w;
         }
+    return pe_total;
+    }
+
+/*! Sums the total potential energy calculated by the last call to compute() and returns it.
+*/
+Scalar ForceCompute::calcEnergySum()
+    {
+    double pe_total = calcEnergyLocal();
 #ifdef ENABLE_MPI
     if (m_comm)
         {
@@ -195,6 +219,7 @@ Scalar ForceCompute::calcEnergySum()
 */
 Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
     {
+    restoreForceArrays();
     unsigned int group_size = group->getNumMembers();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
 
@@ -220,6 +245,7 @@ Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
 
 vec3<double> ForceCompute::calcForceGroup(std::shared_ptr<ParticleGroup> group)
     {
+    restoreForceArrays();
     unsigned int group_size = group->getNumMembers();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
 
@@ -245,6 +271,7 @@ vec3<double> ForceCompute::calcForceGroup(std::shared_ptr<ParticleGroup> group)
 */
 std::vector<Scalar> ForceCompute::calcVirialGroup(std::shared_ptr<ParticleGroup> group)
     {
+    restoreForceArrays();
     const unsigned int group_size = group->getNumMembers();
     const ArrayHandle<Scalar> h_virial(m_virial,access_location::host,access_mode::read);
 
@@ -270,6 +297,7 @@ std::vector<Scalar> ForceCompute::calcVirialGroup(std::shared_ptr<ParticleGroup>
 
 pybind11::object ForceCompute::getEnergiesPython()
     {
+    restoreForceArrays();
     bool root = true;
 #ifdef ENABLE_MPI
     // if we are not the root processor, return None
@@ -309,6 +337,7 @@ pybind11::object ForceCompute::getEnergiesPython()
 
 pybind11::object ForceCompute::getForcesPython()
     {
+    restoreForceArrays();
     bool root = true;
 #ifdef ENABLE_MPI
     // if we are not the root processor, return None
@@ -352,6 +381,7 @@ pybind11::object ForceCompute::getForcesPython()
 
 pybind11::object ForceCompute::getTorquesPython()
     {
+    restoreForceArrays();
     bool root = true;
 #ifdef ENABLE_MPI
     // if we are not the root processor, return None
@@ -395,6 +425,7 @@ pybind11::object ForceCompute::getTorquesPython()
 
 pybind11::object ForceCompute::getVirialsPython()
     {
+    restoreForceArrays();
     if (!m_computed_flags[pdata_flag::pressure_tensor])
         {
         return pybind11::none();
@@ -463,15 +494,67 @@ void ForceCompute::compute(uint64_t timestep)
     // flags do not match
     if (m_particles_sorted ||
         shouldCompute(timestep) ||
+        m_net_force_only ||
         m_pdata->getFlags() != m_computed_flags)
         {
+        #ifdef ENABLE_MPI
+        // all ghost data must be current unless this force overlaps its computation with the ghost update
+        if (m_comm && !overlapsGhostUpdate())
+            m_comm->completeGhostUpdate(timestep);
+        #endif
+
+        m_timer.start();
         computeForces(timestep);
+        m_timer.stop();
         }
 
+    m_particles_sorted = false;
+    m_net_force_only = false;
+    m_computed_flags = m_pdata->getFlags();
+    }
+
+/*! \param timestep Current time step of the simulation
+    \pre The integrator has zeroed the net force arrays, or already added other forces to them
+    \post The forces are added to the net force, virial, and torque arrays. This compute's own arrays are not
+          written; they are recomputed when they are first accessed.
+
+    Unlike compute(), the forces are always evaluated because the net force arrays are cleared every time step.
+*/
+void ForceCompute::accumulateNetForce(uint64_t timestep)
+    {
+    assert(canAccumulateNetForce());
+
+    // mark the step as computed
+    shouldCompute(timestep);
+
+    #ifdef ENABLE_MPI
+    // all ghost data must be current unless this force overlaps its computation with the ghost update
+    if (m_comm && !overlapsGhostUpdate())
+        m_comm->completeGhostUpdate(timestep);
+    #endif
+
+    m_accumulating = true;
+    m_timer.start();
+    computeForces(timestep);
+    m_timer.stop();
+    m_accumulating = false;
+
+    m_net_force_only = true;
+    m_accumulated_timestep = timestep;
     m_particles_sorted = false;
     m_computed_flags = m_pdata->getFlags();
     }
 
+/*! The forces are evaluated again at the time step they were last added to the net force, with the current
+    particle positions. Integrators add forces at the end of the first half step, so the positions have not changed
+    when the forces are logged.
+*/
+void ForceCompute::recomputeForceArrays()
+    {
+    m_net_force_only = false;
+    computeForces(m_accumulated_timestep);
+    }
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
 
@@ -512,6 +595,7 @@ double ForceCompute::benchmark(unsigned int num_iters)
  */
 Scalar4 ForceCompute::getTorque(unsigned int tag)
     {
+    restoreForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar4 result = make_scalar4(0.0,0.0,0.0,0.0);
@@ -535,6 +619,7 @@ Scalar4 ForceCompute::getTorque(unsigned int tag)
  */
 Scalar3 ForceCompute::getForce(unsigned int tag)
     {
+    restoreForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar3 result = make_scalar3(0.0,0.0,0.0);
@@ -559,6 +644,7 @@ Scalar3 ForceCompute::getForce(unsigned int tag)
  */
 Scalar ForceCompute::getVirial(unsigned int tag, unsigned int component)
     {
+    restoreForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar result = Scalar(0.0);
@@ -582,6 +668,7 @@ Scalar ForceCompute::getVirial(unsigned int tag, unsigned int component)
  */
 Scalar ForceCompute::getEnergy(unsigned int tag)
     {
+    restoreForceArrays();
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar result = Scalar(0.0);
@@ -613,5 +700,9 @@ void export_ForceCompute(py::module& m)
     .def("getForces", &ForceCompute::getForcesPython)
     .def("getTorques", &ForceCompute::getTorquesPython)
     .def("getVirials", &ForceCompute::getVirialsPython)
+    .def("setRESPAPeriod", &ForceCompute::setRESPAPeriod)
+    .def("getRESPAPeriod", &ForceCompute::getRESPAPeriod)
+    .def("setAccumulateNetForce", &ForceCompute::setAccumulateNetForce)
+    .def("getAccumulateNetForce", &ForceCompute::getAccumulateNetForce)
     ;
     }
@@ -75,9 +75,19 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         //! Computes the forces
         virtual void compute(uint64_t timestep);
 
+        //! Completes forces that compute() left pending
+        /*! Integrators call this method after compute() has been called on all force computes and before they read
+            the forces. Force computes that wait on communication may return from compute() early and finish here, so
+            that the forces computed in between overlap with the communication.
+        */
+        virtual void finishCompute(uint64_t timestep){}
+
         //! Benchmark the force compute
         virtual double benchmark(unsigned int num_iters);
 
+        //! Sum the potential energy of the local particles
+        double calcEnergyLocal();
+
         //! Total the potential energy
         Scalar calcEnergySum();
 
@@ -129,21 +139,54 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         //! Get the array of computed forces
         GlobalArray<Scalar4>& getForceArray()
             {
+            restoreForceArrays();
             return m_force;
             }
 
         //! Get the array of computed virials
         GlobalArray<Scalar>& getVirialArray()
             {
+            restoreForceArrays();
             return m_virial;
             }
 
         //! Get the array of computed torques
         GlobalArray<Scalar4>& getTorqueArray()
             {
+            restoreForceArrays();
             return m_torque;
             }
 
+        //! Returns true if computeForces() can add the forces directly to the net force arrays
+        /*! Subclasses that return true must write to the net force, virial, and torque arrays instead of their own
+            arrays, without zeroing them first, while m_accumulating is set.
+        */
+        virtual bool canAccumulateNetForce()
+            {
+            return false;
+            }
+
+        //! Set whether this force is added directly to the net force when possible
+        void setAccumulateNetForce(bool accumulate)
+            {
+            m_accumulate_net_force = accumulate;
+            }
+
+        //! Get whether this force is added directly to the net force when possible
+        bool getAccumulateNetForce() const
+            {
+            return m_accumulate_net_force;
+            }
+
+        //! Returns true if the integrator may add this force directly to the net force
+        bool accumulatesNetForce()
+            {
+            return m_accumulate_net_force && m_respa_period == 1 && canAccumulateNetForce();
+            }
+
+        //! Compute the forces and add them to the net force arrays
+        void accumulateNetForce(uint64_t timestep);
+
         //! Get the contribution to the external virial
         Scalar getExternalVirial(unsigned int dir)
             {
@@ -167,6 +210,65 @@ class PYBIND11_EXPORT ForceCompute : public Compute
             flags[comm_flag::net_force] = 1; // only used if constraints are present
             return flags;
             }
+
+        //! Returns true if computeForces() completes a pending ghost update on its own
+        /*! Force computes that return true first compute interactions among local particles and call
+            Communicator::completeGhostUpdate() before they access ghost particle data. For all others, compute()
+            completes the pending update before calling computeForces().
+        */
+        virtual bool overlapsGhostUpdate()
+            {
+            return false;
+            }
+        #endif
+
+        //! Set the number of time steps between evaluations in a multiple time step integration
+        /*! \param period Number of time steps
+
+            Integrators evaluate the force on multiples of \a period and apply it as an impulse, scaled by \a period.
+            The default of 1 evaluates the force on every time step.
+        */
+        void setRESPAPeriod(unsigned int period)
+            {
+            if (period == 0)
+                {
+                m_exec_conf->msg->error() << "The RESPA period must be at least 1" << std::endl;
+                throw std::runtime_error("Error setting RESPA period");
+                }
+            m_respa_period = period;
+            }
+
+        //! Get the number of time steps between evaluations in a multiple time step integration
+        unsigned int getRESPAPeriod() const
+            {
+            return m_respa_period;
+            }
+
+        #ifdef ENABLE_HIP
+        //! Returns true if computeForces() launches all of its kernels on the stream given by setStream()
+        /*! Integrators may run such computes on separate streams so that their kernels execute concurrently.
+        */
+        virtual bool supportsStream()
+            {
+            return false;
+            }
+
+        //! Returns true if computeForces() updates its inputs on the default stream before it launches its kernels
+        /*! A neighbor list update is an example. Integrators launch these computes first, because work on the
+            default stream waits for the kernels already running on the other streams.
+        */
+        virtual bool updatesInputsOnDefaultStream()
+            {
+            return false;
+            }
+
+        //! Set the stream for the force kernels
+        /*! \param stream Stream to launch on, 0 for the default stream
+        */
+        void setStream(hipStream_t stream)
+            {
+            m_stream = stream;
+            }
         #endif
 
         //! Returns true if this ForceCompute requires anisotropic integration
@@ -216,6 +318,27 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         /// Store the particle data flags used during the last computation
         PDataFlags m_computed_flags;
 
+        unsigned int m_respa_period; //!< Number of time steps between evaluations
+
+        #ifdef ENABLE_HIP
+        hipStream_t m_stream;        //!< Stream for the force kernels
+        #endif
+
+        bool m_accumulate_net_force; //!< True if this force may be added directly to the net force
+        bool m_accumulating;         //!< True while computeForces() adds to the net force arrays
+        bool m_net_force_only;       //!< True if the last forces were only added to the net force arrays
+        uint64_t m_accumulated_timestep; //!< Time step of the forces last added to the net force arrays
+
+        //! Recompute the forces in this compute's own arrays if they were only added to the net force
+        void restoreForceArrays()
+            {
+            if (m_net_force_only)
+                recomputeForceArrays();
+            }
+
+        //! Recompute the forces last added to the net force arrays in this compute's own arrays
+        void recomputeForceArrays();
+
         //! Actually perform the computation of the forces
         /*! This is pure virtual here. Sub-classes must implement this function. It will be called by
             the base class compute() when the forces need to be computed.
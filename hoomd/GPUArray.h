@@ -24,6 +24,9 @@
 #endif
 
 #include "ExecutionConfiguration.h"
+#ifdef ENABLE_HIP
+#include "DeviceMemoryPool.h"
+#endif
 #include <string.h>
 #include <iostream>
 #include <stdexcept>
@@ -112,7 +115,8 @@ class device_deleter
                 this->m_exec_conf->msg->notice(10) << "Freeing " << m_N*sizeof(T) << " bytes of CUDA memory." << std::endl;
 
                 #ifdef ENABLE_HIP
-                hipFree(ptr);
+                // return the block to the pool, which frees it only when the cache is full
+                this->m_exec_conf->getDeviceMemoryPool().deallocate(ptr);
                 #endif
                 CHECK_CUDA_ERROR();
                 }
@@ -526,6 +530,15 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         //! Resize a 2D GPUArray
         void resize(size_t width, size_t height);
 
+        //! Set the tag that the memory of this array is counted under
+        /*! \param tag Name of the array, see MemoryUsage
+        */
+        void setTag(const std::string& tag)
+            {
+            m_tag = tag;
+            updateMemoryUsage();
+            }
+
         //! Return a string representation of this array
         std::string getRepresentation() const
             {
@@ -597,6 +610,8 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
 #ifdef ENABLE_HIP
         bool m_mapped;                          //!< True if we are using mapped memory
 #endif
+        std::string m_tag;                      //!< Name of the array (optional)
+        hoomd::detail::MemoryUsageRecord m_usage;   //!< Memory of the array counted in MemoryUsage
 
     // ok, this looks weird, but I want m_exec_conf to be protected and not have to go reorder all of the initializers
     protected:
@@ -612,6 +627,15 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         //! Helper function to allocate memory
         inline void allocate();
 
+        //! Helper function to count the current allocation in MemoryUsage
+        inline void updateMemoryUsage();
+
+        //! Helper function to allocate aligned host memory according to the host memory policy
+        inline int allocateHost(void **ptr, size_t num_bytes) const;
+
+        //! Helper function to clear host memory according to the host memory policy
+        inline void clearHost(void *ptr, size_t num_bytes) const;
+
 #ifdef ENABLE_HIP
         //! Helper function to copy memory from the device to host
         inline void memcpyDeviceToHost(bool async) const;
@@ -782,6 +806,7 @@ template<class T> GPUArray<T>::GPUArray(const GPUArray& from) noexcept
 #ifdef ENABLE_HIP
         m_mapped(from.m_mapped),
 #endif
+        m_tag(from.m_tag),
         m_exec_conf(from.m_exec_conf)
     {
     // allocate and clear new memory the same size as the data in from
@@ -811,6 +836,7 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(const GPUArray& rhs) noexc
 #ifdef ENABLE_HIP
         m_mapped = rhs.m_mapped;
 #endif
+        m_tag = rhs.m_tag;
         // initialize state variables
         m_data_location = data_location::host;
 
@@ -831,6 +857,8 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(const GPUArray& rhs) noexc
             #ifdef ENABLE_HIP
             d_data.reset();
             #endif
+
+            m_usage.release();
             }
         }
 
@@ -846,6 +874,10 @@ template<class T> GPUArray<T>::GPUArray(GPUArray&& from) noexcept
     m_data_location(std::move(from.m_data_location)),
 #ifdef ENABLE_HIP
     m_mapped(std::move(from.m_mapped)),
+#endif
+    m_tag(std::move(from.m_tag)),
+    m_usage(std::move(from.m_usage)),
+#ifdef ENABLE_HIP
     d_data(std::move(from.d_data)),
 #endif
     h_data(std::move(from.h_data)),
@@ -868,6 +900,8 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(GPUArray&& rhs) noexcept
         h_data = std::move(rhs.h_data);
         m_data_location = std::move(rhs.m_data_location);
         m_acquired = std::move(rhs.m_acquired);
+        m_tag = std::move(rhs.m_tag);
+        m_usage = std::move(rhs.m_usage);
         }
 
     return *this;
@@ -902,6 +936,8 @@ template<class T> void GPUArray<T>::swap(GPUArray& from)
     std::swap(m_mapped, from.m_mapped);
 #endif
     std::swap(h_data, from.h_data);
+    std::swap(m_tag, from.m_tag);
+    m_usage.swap(from.m_usage);
     }
 
 /*! \pre m_num_elements is set
@@ -936,8 +972,7 @@ template<class T> void GPUArray<T>::allocate()
     void *host_ptr = nullptr;
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign(&host_ptr, 32, m_num_elements*sizeof(T));
+    int retval = allocateHost(&host_ptr, m_num_elements*sizeof(T));
     if (retval != 0)
         {
         if (m_exec_conf)
@@ -977,7 +1012,7 @@ template<class T> void GPUArray<T>::allocate()
         else
             {
             #ifdef ENABLE_HIP
-            hipMalloc(&device_ptr, m_num_elements*sizeof(T));
+            m_exec_conf->getDeviceMemoryPool().allocate(&device_ptr, m_num_elements*sizeof(T));
             #endif
             CHECK_CUDA_ERROR();
             }
@@ -987,6 +1022,42 @@ template<class T> void GPUArray<T>::allocate()
         d_data = std::unique_ptr<T, hoomd::detail::device_deleter<T> >(reinterpret_cast<T *>(device_ptr), device_deleter);
         }
 #endif
+
+    updateMemoryUsage();
+    }
+
+/*! The array counts its size once under the owner of its tag, even when it holds both a host and a device copy.
+*/
+template<class T> void GPUArray<T>::updateMemoryUsage()
+    {
+    if (m_exec_conf && !isNull())
+        m_usage.update(m_exec_conf->getMemoryUsage(), m_tag, m_num_elements*sizeof(T));
+    else
+        m_usage.release();
+    }
+
+/*! \param ptr Set to the allocated memory
+    \param num_bytes Number of bytes to allocate
+    \returns 0 on success, or the error code of the allocation
+*/
+template<class T> int GPUArray<T>::allocateHost(void **ptr, size_t num_bytes) const
+    {
+    // at minimum, alignment needs to be 32 bytes for AVX
+    if (m_exec_conf)
+        return m_exec_conf->getHostMemoryPolicy().allocate(ptr, num_bytes, 32);
+    else
+        return posix_memalign(ptr, 32, num_bytes);
+    }
+
+/*! \param ptr Start of the memory
+    \param num_bytes Number of bytes to clear
+*/
+template<class T> void GPUArray<T>::clearHost(void *ptr, size_t num_bytes) const
+    {
+    if (m_exec_conf)
+        m_exec_conf->getHostMemoryPolicy().clear(ptr, num_bytes);
+    else
+        memset(ptr, 0, num_bytes);
     }
 
 /*! \pre allocate() has been called
@@ -1002,7 +1073,7 @@ template<class T> void GPUArray<T>::memclear(size_t first)
     assert(first < m_num_elements);
 
     // clear memory
-    memset((void *)(h_data.get()+first), 0, sizeof(T)*(m_num_elements-first));
+    clearHost((void *)(h_data.get()+first), sizeof(T)*(m_num_elements-first));
 
 #if defined (ENABLE_HIP)
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
@@ -1276,8 +1347,7 @@ template<class T> T* GPUArray<T>::resizeHostArray(size_t num_elements)
     T *h_tmp = NULL;
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign((void**)&h_tmp, 32, num_elements*sizeof(T));
+    int retval = allocateHost((void**)&h_tmp, num_elements*sizeof(T));
     if (retval != 0)
         {
         if (m_exec_conf)
@@ -1295,7 +1365,7 @@ template<class T> T* GPUArray<T>::resizeHostArray(size_t num_elements)
         }
 #endif
     // clear memory
-    memset((void *)h_tmp, 0, sizeof(T)*num_elements);
+    clearHost((void *)h_tmp, sizeof(T)*num_elements);
 
     // copy over data
     size_t num_copy_elements = m_num_elements > num_elements ? num_elements : m_num_elements;
@@ -1334,9 +1404,8 @@ template<class T> T* GPUArray<T>::resize2DHostArray(size_t pitch, size_t new_pit
     T *h_tmp = NULL;
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
     size_t size = new_pitch*new_height*sizeof(T);
-    int retval = posix_memalign((void**)&h_tmp, 32, size);
+    int retval = allocateHost((void**)&h_tmp, size);
     if (retval != 0)
         {
         if (m_exec_conf)
@@ -1355,7 +1424,7 @@ template<class T> T* GPUArray<T>::resize2DHostArray(size_t pitch, size_t new_pit
 #endif
 
     // clear memory
-    memset((void *)h_tmp, 0, sizeof(T)*new_pitch*new_height);
+    clearHost((void *)h_tmp, sizeof(T)*new_pitch*new_height);
 
     // copy over data
     // every column is copied separately such as to align with the new pitch
@@ -1400,7 +1469,7 @@ template<class T> T* GPUArray<T>::resizeDeviceArray(size_t num_elements)
     // allocate resized array
     T *d_tmp;
     #ifdef ENABLE_HIP
-    hipMalloc(&d_tmp, num_elements*sizeof(T));
+    m_exec_conf->getDeviceMemoryPool().allocate((void **)&d_tmp, num_elements*sizeof(T));
     #endif
 
     CHECK_CUDA_ERROR();
@@ -1442,7 +1511,7 @@ template<class T> T* GPUArray<T>::resize2DDeviceArray(size_t pitch, size_t new_p
     // allocate resized array
     T *d_tmp;
     #ifdef ENABLE_HIP
-    hipMalloc(&d_tmp, new_pitch*new_height*sizeof(T));
+    m_exec_conf->getDeviceMemoryPool().allocate((void **)&d_tmp, new_pitch*new_height*sizeof(T));
     #endif
     CHECK_CUDA_ERROR();
     assert(d_tmp);
@@ -1511,6 +1580,7 @@ template<class T> void GPUArray<T>::resize(size_t num_elements)
 #endif
     m_num_elements = num_elements;
     m_pitch = num_elements;
+    updateMemoryUsage();
     }
 
 /*! \param width new width of array
@@ -1556,5 +1626,6 @@ template<class T> void GPUArray<T>::resize(size_t width, size_t height)
     m_height = height;
     m_pitch  = new_pitch;
     m_num_elements = m_pitch * m_height;
+    updateMemoryUsage();
     }
 #endif
@@ -129,11 +129,57 @@ GSDDumpWriter::~GSDDumpWriter()
 
     if (root && m_is_initialized)
         {
+        try
+            {
+            waitForPendingWrite();
+            }
+        catch (const std::exception& e)
+            {
+            m_exec_conf->msg->error() << e.what() << endl;
+            }
+
         m_exec_conf->msg->notice(5) << "GSD: close gsd file " << m_fname << endl;
         gsd_close(&m_handle);
         }
     }
 
+/*! \param name Name of the chunk
+    \param type Type of the chunk data
+    \param N Number of rows
+    \param M Number of columns
+    \param data Chunk data (N*M elements)
+
+    With async writes enabled, the data is copied to the staging buffer and written by the background thread at the
+    end of analyze(). Otherwise, it is written to the file immediately.
+*/
+void GSDDumpWriter::writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, const void *data)
+    {
+    if (m_async_write)
+        {
+        StagedChunk chunk;
+        chunk.name = name;
+        chunk.type = type;
+        chunk.N = N;
+        chunk.M = M;
+        const char *bytes = (const char *)data;
+        chunk.data.assign(bytes, bytes + N*M*gsd_sizeof_type(type));
+        m_staged_chunks.push_back(std::move(chunk));
+        }
+    else
+        {
+        int retval = gsd_write_chunk(&m_handle, name, type, N, M, 0, data);
+        GSDUtils::checkError(retval, m_fname);
+        }
+    }
+
+/*! Errors raised by the background thread are rethrown here.
+*/
+void GSDDumpWriter::waitForPendingWrite()
+    {
+    if (m_pending_write.valid())
+        m_pending_write.get();
+    }
+
 /*! \param timestep Current time step of the simulation
 
     The first call to analyze() will create or overwrite the file and write out the current system configuration
@@ -147,10 +193,13 @@ void GSDDumpWriter::analyze(uint64_t timestep)
     if (m_prof)
         m_prof->push("Dump GSD");
 
+    // the file handle is in use until the previous frame is written
+    waitForPendingWrite();
+
     // take particle data snapshot
     m_exec_conf->msg->notice(10) << "GSD: taking particle data snapshot" << endl;
     SnapshotParticleData<float> snapshot;
-    const std::map<unsigned int, unsigned int>& map = m_pdata->takeSnapshot<float>(snapshot);
+    const std::vector<unsigned int> map = m_pdata->takeSnapshot<float>(snapshot);
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
@@ -227,7 +276,31 @@ void GSDDumpWriter::analyze(uint64_t timestep)
         m_log_writer.attr("_write_frame")(this);
         }
 
-    if (root)
+    if (root && m_async_write)
+        {
+        // write the staged chunks and end the frame while the simulation continues
+        m_exec_conf->msg->notice(10) << "GSD: ending frame in the background" << endl;
+        m_pending_write = std::async(std::launch::async,
+            [this, chunks = std::move(m_staged_chunks)]()
+                {
+                for (const auto& chunk : chunks)
+                    {
+                    int retval = gsd_write_chunk(&m_handle,
+                                                 chunk.name.c_str(),
+                                                 chunk.type,
+                                                 chunk.N,
+                                                 chunk.M,
+                                                 0,
+                                                 chunk.data.data());
+                    GSDUtils::checkError(retval, m_fname);
+                    }
+
+                int retval = gsd_end_frame(&m_handle);
+                GSDUtils::checkError(retval, m_fname);
+                });
+        m_staged_chunks.clear();
+        }
+    else if (root)
         {
         m_exec_conf->msg->notice(10) << "GSD: ending frame" << endl;
         retval = gsd_end_frame(&m_handle);
@@ -253,8 +326,7 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
         std::vector<char> types(max_len * type_mapping.size());
         for (unsigned int i = 0; i < type_mapping.size(); i++)
             strncpy(&types[max_len*i], type_mapping[i].c_str(), max_len);
-        int retval = gsd_write_chunk(&m_handle, chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk(chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, &types[0]);
         }
 
     }
@@ -269,18 +341,15 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
 */
 void GSDDumpWriter::writeFrameHeader(uint64_t timestep)
     {
-    int retval;
     m_exec_conf->msg->notice(10) << "GSD: writing configuration/step" << endl;
     uint64_t step = timestep;
-    retval = gsd_write_chunk(&m_handle, "configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
-    GSDUtils::checkError(retval, m_fname);
+    writeChunk("configuration/step", GSD_TYPE_UINT64, 1, 1, &step);
 
     if (gsd_get_nframes(&m_handle) == 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing configuration/dimensions" << endl;
         uint8_t dimensions = (uint8_t)m_sysdef->getNDimensions();
-        retval = gsd_write_chunk(&m_handle, "configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("configuration/dimensions", GSD_TYPE_UINT8, 1, 1, &dimensions);
         }
 
     m_exec_conf->msg->notice(10) << "GSD: writing configuration/box" << endl;
@@ -292,23 +361,20 @@ void GSDDumpWriter::writeFrameHeader(uint64_t timestep)
     box_a[3] = (float)box.getTiltFactorXY();
     box_a[4] = (float)box.getTiltFactorXZ();
     box_a[5] = (float)box.getTiltFactorYZ();
-    retval = gsd_write_chunk(&m_handle, "configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
-    GSDUtils::checkError(retval, m_fname);
+    writeChunk("configuration/box", GSD_TYPE_FLOAT, 6, 1, box_a);
 
     m_exec_conf->msg->notice(10) << "GSD: writing particles/N" << endl;
     uint32_t N = m_group->getNumMembersGlobal();
-    retval = gsd_write_chunk(&m_handle, "particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-    GSDUtils::checkError(retval, m_fname);
+    writeChunk("particles/N", GSD_TYPE_UINT32, 1, 1, &N);
     }
 
 /*! \param snapshot particle data snapshot to write out to the file
 
     Writes the data chunks types, typeid, mass, charge, diameter, body, moment_inertia in particles/.
 */
-void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
+void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot, const std::vector<unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
     uint64_t nframes = gsd_get_nframes(&m_handle);
 
     writeTypeMapping("particles/types", snapshot.type_mapping);
@@ -323,20 +389,19 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.type[it->second] != 0)
+            if (snapshot.type[snap_idx] != 0)
                 all_default = false;
 
-            type[group_idx] = uint32_t(snapshot.type[it->second]);
+            type[group_idx] = uint32_t(snapshot.type[snap_idx]);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/typeid"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/typeid" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/typeid", GSD_TYPE_UINT32, N, 1, &type[0]);
             if (nframes == 0)
                 m_nondefault["particles/typeid"] = true;
             }
@@ -352,20 +417,19 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.mass[it->second] != float(1.0))
+            if (snapshot.mass[snap_idx] != float(1.0))
                 all_default = false;
 
-            data[group_idx] = float(snapshot.mass[it->second]);
+            data[group_idx] = float(snapshot.mass[snap_idx]);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/mass"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/mass" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/mass", GSD_TYPE_FLOAT, N, 1, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/mass"] = true;
             }
@@ -377,19 +441,18 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.charge[it->second] != float(0.0))
+            if (snapshot.charge[snap_idx] != float(0.0))
                 all_default = false;
-            data[group_idx] = float(snapshot.charge[it->second]);
+            data[group_idx] = float(snapshot.charge[snap_idx]);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/charge"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/charge" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/charge", GSD_TYPE_FLOAT, N, 1, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/charge"] = true;
             }
@@ -401,20 +464,19 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.diameter[it->second] != float(1.0))
+            if (snapshot.diameter[snap_idx] != float(1.0))
                 all_default = false;
 
-            data[group_idx] = float(snapshot.diameter[it->second]);
+            data[group_idx] = float(snapshot.diameter[snap_idx]);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/diameter"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/diameter" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/diameter", GSD_TYPE_FLOAT, N, 1, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/diameter"] = true;
             }
@@ -430,20 +492,19 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.body[it->second] != NO_BODY)
+            if (snapshot.body[snap_idx] != NO_BODY)
                 all_default = false;
 
-            body[group_idx] = int32_t(snapshot.body[it->second]);
+            body[group_idx] = int32_t(snapshot.body[snap_idx]);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/body"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/body" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/body", GSD_TYPE_INT32, N, 1, &body[0]);
             if (nframes == 0)
                 m_nondefault["particles/body"] = true;
             }
@@ -459,26 +520,25 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.inertia[it->second].x != float(0.0) ||
-                snapshot.inertia[it->second].y != float(0.0) ||
-                snapshot.inertia[it->second].z != float(0.0))
+            if (snapshot.inertia[snap_idx].x != float(0.0) ||
+                snapshot.inertia[snap_idx].y != float(0.0) ||
+                snapshot.inertia[snap_idx].z != float(0.0))
                 {
                 all_default = false;
                 }
 
-            data[group_idx*3+0] = float(snapshot.inertia[it->second].x);
-            data[group_idx*3+1] = float(snapshot.inertia[it->second].y);
-            data[group_idx*3+2] = float(snapshot.inertia[it->second].z);
+            data[group_idx*3+0] = float(snapshot.inertia[snap_idx].x);
+            data[group_idx*3+1] = float(snapshot.inertia[snap_idx].y);
+            data[group_idx*3+2] = float(snapshot.inertia[snap_idx].z);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/moment_inertia"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/moment_inertia" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/moment_inertia"] = true;
             }
@@ -489,10 +549,9 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
 
     Writes the data chunks position and orientation in particles/.
 */
-void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
+void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot, const std::vector<unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
     uint64_t nframes = gsd_get_nframes(&m_handle);
 
         {
@@ -504,17 +563,16 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            data[group_idx*3+0] = float(snapshot.pos[it->second].x);
-            data[group_idx*3+1] = float(snapshot.pos[it->second].y);
-            data[group_idx*3+2] = float(snapshot.pos[it->second].z);
+            data[group_idx*3+0] = float(snapshot.pos[snap_idx].x);
+            data[group_idx*3+1] = float(snapshot.pos[snap_idx].y);
+            data[group_idx*3+2] = float(snapshot.pos[snap_idx].z);
             }
 
         m_exec_conf->msg->notice(10) << "GSD: writing particles/position" << endl;
-        retval = gsd_write_chunk(&m_handle, "particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("particles/position", GSD_TYPE_FLOAT, N, 3, &data[0]);
         }
 
         {
@@ -527,28 +585,27 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.orientation[it->second].s != float(1.0) ||
-                snapshot.orientation[it->second].v.x != float(0.0) ||
-                snapshot.orientation[it->second].v.y != float(0.0) ||
-                snapshot.orientation[it->second].v.z != float(0.0))
+            if (snapshot.orientation[snap_idx].s != float(1.0) ||
+                snapshot.orientation[snap_idx].v.x != float(0.0) ||
+                snapshot.orientation[snap_idx].v.y != float(0.0) ||
+                snapshot.orientation[snap_idx].v.z != float(0.0))
                 {
                 all_default = false;
                 }
 
-            data[group_idx*4+0] = float(snapshot.orientation[it->second].s);
-            data[group_idx*4+1] = float(snapshot.orientation[it->second].v.x);
-            data[group_idx*4+2] = float(snapshot.orientation[it->second].v.y);
-            data[group_idx*4+3] = float(snapshot.orientation[it->second].v.z);
+            data[group_idx*4+0] = float(snapshot.orientation[snap_idx].s);
+            data[group_idx*4+1] = float(snapshot.orientation[snap_idx].v.x);
+            data[group_idx*4+2] = float(snapshot.orientation[snap_idx].v.y);
+            data[group_idx*4+3] = float(snapshot.orientation[snap_idx].v.z);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/orientation" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/orientation", GSD_TYPE_FLOAT, N, 4, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/orientation"] = true;
             }
@@ -559,10 +616,9 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
 
     Writes the data chunks velocity, angmom, and image in particles/.
 */
-void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
+void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, const std::vector<unsigned int> &map)
     {
     uint32_t N = m_group->getNumMembersGlobal();
-    int retval;
     uint64_t nframes = gsd_get_nframes(&m_handle);
 
         {
@@ -575,26 +631,25 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.vel[it->second].x != float(0.0) ||
-                snapshot.vel[it->second].y != float(0.0) ||
-                snapshot.vel[it->second].z != float(0.0))
+            if (snapshot.vel[snap_idx].x != float(0.0) ||
+                snapshot.vel[snap_idx].y != float(0.0) ||
+                snapshot.vel[snap_idx].z != float(0.0))
                 {
                 all_default = false;
                 }
 
-            data[group_idx*3+0] = float(snapshot.vel[it->second].x);
-            data[group_idx*3+1] = float(snapshot.vel[it->second].y);
-            data[group_idx*3+2] = float(snapshot.vel[it->second].z);
+            data[group_idx*3+0] = float(snapshot.vel[snap_idx].x);
+            data[group_idx*3+1] = float(snapshot.vel[snap_idx].y);
+            data[group_idx*3+2] = float(snapshot.vel[snap_idx].z);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/velocity"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/velocity" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/velocity", GSD_TYPE_FLOAT, N, 3, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/velocity"] = true;
             }
@@ -610,28 +665,27 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.angmom[it->second].s != float(0.0) ||
-                snapshot.angmom[it->second].v.x != float(0.0) ||
-                snapshot.angmom[it->second].v.y != float(0.0) ||
-                snapshot.angmom[it->second].v.z != float(0.0))
+            if (snapshot.angmom[snap_idx].s != float(0.0) ||
+                snapshot.angmom[snap_idx].v.x != float(0.0) ||
+                snapshot.angmom[snap_idx].v.y != float(0.0) ||
+                snapshot.angmom[snap_idx].v.z != float(0.0))
                 {
                 all_default = false;
                 }
 
-            data[group_idx*4+0] = float(snapshot.angmom[it->second].s);
-            data[group_idx*4+1] = float(snapshot.angmom[it->second].v.x);
-            data[group_idx*4+2] = float(snapshot.angmom[it->second].v.y);
-            data[group_idx*4+3] = float(snapshot.angmom[it->second].v.z);
+            data[group_idx*4+0] = float(snapshot.angmom[snap_idx].s);
+            data[group_idx*4+1] = float(snapshot.angmom[snap_idx].v.x);
+            data[group_idx*4+2] = float(snapshot.angmom[snap_idx].v.y);
+            data[group_idx*4+3] = float(snapshot.angmom[snap_idx].v.z);
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/angmom"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/angmom" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/angmom", GSD_TYPE_FLOAT, N, 4, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/angmom"] = true;
             }
@@ -647,26 +701,25 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
             unsigned int t = m_group->getMemberTag(group_idx);
 
             // look up tag in snapshot
-            auto it = map.find(t);
-            assert(it != map.end());
+            unsigned int snap_idx = map[t];
+            assert(snap_idx != NOT_LOCAL);
 
-            if (snapshot.image[it->second].x != 0 ||
-                snapshot.image[it->second].y != 0 ||
-                snapshot.image[it->second].z != 0)
+            if (snapshot.image[snap_idx].x != 0 ||
+                snapshot.image[snap_idx].y != 0 ||
+                snapshot.image[snap_idx].z != 0)
                 {
                 all_default = false;
                 }
 
-            data[group_idx*3+0] = snapshot.image[it->second].x;
-            data[group_idx*3+1] = snapshot.image[it->second].y;
-            data[group_idx*3+2] = snapshot.image[it->second].z;
+            data[group_idx*3+0] = snapshot.image[snap_idx].x;
+            data[group_idx*3+1] = snapshot.image[snap_idx].y;
+            data[group_idx*3+2] = snapshot.image[snap_idx].z;
             }
 
         if (!all_default || (nframes > 0 && m_nondefault["particles/image"]))
             {
             m_exec_conf->msg->notice(10) << "GSD: writing particles/image" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("particles/image", GSD_TYPE_INT32, N, 3, &data[0]);
             if (nframes == 0)
                 m_nondefault["particles/image"] = true;
             }
@@ -693,77 +746,64 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "GSD: writing bonds/N" << endl;
         uint32_t N = bond.size;
-        int retval = gsd_write_chunk(&m_handle, "bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("bonds/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("bonds/types", bond.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing bonds/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("bonds/typeid", GSD_TYPE_UINT32, N, 1, &bond.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing bonds/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("bonds/group", GSD_TYPE_UINT32, N, 2, &bond.groups[0]);
         }
     if (angle.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing angles/N" << endl;
         uint32_t N = angle.size;
-        int retval = gsd_write_chunk(&m_handle, "angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("angles/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("angles/types", angle.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing angles/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("angles/typeid", GSD_TYPE_UINT32, N, 1, &angle.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing angles/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("angles/group", GSD_TYPE_UINT32, N, 3, &angle.groups[0]);
         }
     if (dihedral.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing dihedrals/N" << endl;
         uint32_t N = dihedral.size;
-        int retval = gsd_write_chunk(&m_handle, "dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("dihedrals/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("dihedrals/types", dihedral.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing dihedrals/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("dihedrals/typeid", GSD_TYPE_UINT32, N, 1, &dihedral.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing dihedrals/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("dihedrals/group", GSD_TYPE_UINT32, N, 4, &dihedral.groups[0]);
         }
     if (improper.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing impropers/N" << endl;
         uint32_t N = improper.size;
-        int retval = gsd_write_chunk(&m_handle, "impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("impropers/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("impropers/types", improper.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing impropers/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("impropers/typeid", GSD_TYPE_UINT32, N, 1, &improper.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing impropers/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("impropers/group", GSD_TYPE_UINT32, N, 4, &improper.groups[0]);
         }
 
     if (constraint.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing constraints/N" << endl;
         uint32_t N = constraint.size;
-        int retval = gsd_write_chunk(&m_handle, "constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("constraints/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         m_exec_conf->msg->notice(10) << "GSD: writing constraints/value" << endl;
             {
@@ -772,31 +812,26 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
             for (unsigned int i = 0; i < N; i++)
                 data[i] = float(constraint.val[i]);
 
-            retval = gsd_write_chunk(&m_handle, "constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
-            GSDUtils::checkError(retval, m_fname);
+            writeChunk("constraints/value", GSD_TYPE_FLOAT, N, 1, &data[0]);
             }
 
         m_exec_conf->msg->notice(10) << "GSD: writing constraints/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("constraints/group", GSD_TYPE_UINT32, N, 2, &constraint.groups[0]);
         }
 
     if (pair.size > 0)
         {
         m_exec_conf->msg->notice(10) << "GSD: writing pairs/N" << endl;
         uint32_t N = pair.size;
-        int retval = gsd_write_chunk(&m_handle, "pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("pairs/N", GSD_TYPE_UINT32, 1, 1, &N);
 
         writeTypeMapping("pairs/types", pair.type_mapping);
 
         m_exec_conf->msg->notice(10) << "GSD: writing pairs/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("pairs/typeid", GSD_TYPE_UINT32, N, 1, &pair.type_id[0]);
 
         m_exec_conf->msg->notice(10) << "GSD: writing pairs/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
-        GSDUtils::checkError(retval, m_fname);
+        writeChunk("pairs/group", GSD_TYPE_UINT32, N, 2, &pair.groups[0]);
         }
     }
 
@@ -960,6 +995,7 @@ void export_GSDDumpWriter(py::module& m)
         .def_property_readonly("mode", &GSDDumpWriter::getMode)
         .def_property_readonly("dynamic", &GSDDumpWriter::getDynamic)
         .def_property_readonly("truncate", &GSDDumpWriter::getTruncate)
+        .def_property("async_write", &GSDDumpWriter::getAsyncWrite, &GSDDumpWriter::setAsyncWrite)
         .def_property_readonly("filter", [](const std::shared_ptr<GSDDumpWriter> gsd)
                                              {
                                              return gsd->getGroup()->getFilter();
@@ -9,6 +9,8 @@
 
 #include <string>
 #include <memory>
+#include <future>
+#include <vector>
 #include "hoomd/extern/gsd.h"
 
 /*! \file GSDDumpWriter.h
@@ -28,6 +30,11 @@
 
     The file is not opened until the first call to analyze().
 
+    When async writes are enabled, analyze() copies the particle and topology chunks of the frame into a staging
+    buffer and a background thread writes them to the file while the simulation continues. At most one frame is
+    in flight: the next call to analyze() waits for the previous frame to be written. Chunks written by slots of the
+    write signal and by the log writer are written directly as part of the same frame.
+
     \ingroup analyzers
 */
 class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
@@ -79,6 +86,20 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
             return m_truncate;
             }
 
+        /// Set whether frames are written by a background thread
+        void setAsyncWrite(bool async_write)
+            {
+            if (!async_write)
+                waitForPendingWrite();
+            m_async_write = async_write;
+            }
+
+        /// Get whether frames are written by a background thread
+        bool getAsyncWrite()
+            {
+            return m_async_write;
+            }
+
         std::shared_ptr<ParticleGroup> getGroup()
             {
             return m_group;
@@ -157,6 +178,26 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
 
         hoomd::detail::SharedSignal<int (gsd_handle&)> m_write_signal;
 
+        /// A data chunk staged for a background write
+        struct StagedChunk
+            {
+            std::string name;
+            gsd_type type;
+            uint64_t N;
+            uint32_t M;
+            std::vector<char> data;
+            };
+
+        bool m_async_write = false;                 //!< True if frames are written by a background thread
+        std::vector<StagedChunk> m_staged_chunks;   //!< Chunks of the current frame staged for the background write
+        std::future<void> m_pending_write;          //!< Background write of the previous frame
+
+        //! Write a data chunk, or stage it for the background write
+        void writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, const void *data);
+
+        //! Wait for the background write of the previous frame to finish
+        void waitForPendingWrite();
+
         //! Write a type mapping out to the file
         void writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping);
 
@@ -167,13 +208,13 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
         void writeFrameHeader(uint64_t timestep);
 
         //! Write particle attributes
-        void writeAttributes(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map);
+        void writeAttributes(const SnapshotParticleData<float>& snapshot, const std::vector<unsigned int> &map);
 
         //! Write particle properties
-        void writeProperties(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map);
+        void writeProperties(const SnapshotParticleData<float>& snapshot, const std::vector<unsigned int> &map);
 
         //! Write particle momenta
-        void writeMomenta(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map);
+        void writeMomenta(const SnapshotParticleData<float>& snapshot, const std::vector<unsigned int> &map);
 
         //! Write bond topology
         void writeTopology(BondData::Snapshot& bond,
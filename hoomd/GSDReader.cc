@@ -9,6 +9,8 @@
 #include <string.h>
 #include <sstream>
 
+#include <sys/mman.h>
+
 #include <stdexcept>
 using namespace std;
 using namespace hoomd::detail;
@@ -68,6 +70,23 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
+    // map the file to avoid a buffered read of every chunk
+    if (m_handle.file_size > 0)
+        {
+        void *map = mmap(NULL, (size_t)m_handle.file_size, PROT_READ, MAP_SHARED, m_handle.fd, 0);
+        if (map != MAP_FAILED)
+            {
+            m_map = (const char *)map;
+            m_map_size = (size_t)m_handle.file_size;
+            madvise(map, m_map_size, MADV_WILLNEED);
+            }
+        else
+            {
+            m_exec_conf->msg->notice(5) << "data.gsd_snapshot: cannot map " << name << ", using buffered reads"
+                                        << endl;
+            }
+        }
+
     readHeader();
     readParticles();
     readTopology();
@@ -83,6 +102,9 @@ GSDReader::~GSDReader()
         }
     #endif
 
+    if (m_map)
+        munmap((void *)m_map, m_map_size);
+
     gsd_close(&m_handle);
     }
 
@@ -120,8 +142,15 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
             m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
             throw runtime_error("Error reading GSD file");
             }
-        int retval = gsd_read_chunk(&m_handle, data, entry);
-        GSDUtils::checkError(retval, m_name);
+        if (m_map && entry->location > 0 && (uint64_t)entry->location + actual_size <= m_map_size)
+            {
+            memcpy(data, m_map + entry->location, actual_size);
+            }
+        else
+            {
+            int retval = gsd_read_chunk(&m_handle, data, entry);
+            GSDUtils::checkError(retval, m_name);
+            }
 
         return true;
         }
@@ -22,6 +22,9 @@ template <class Real> struct SnapshotSystemData;
 /*! Read an input GSD file and generate a system snapshot. GSDReader can read any frame from a GSD
     file into the snapshot. For information on the GSD specification, see http://gsd.readthedocs.io/
 
+    The file is memory mapped when possible so that data chunks are copied straight from the page cache into the
+    snapshot. When the file cannot be mapped, chunks are read with gsd_read_chunk().
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT GSDReader
@@ -86,6 +89,8 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        const char *m_map = nullptr;                                 //!< Read only memory map of the file
+        size_t m_map_size = 0;                                       //!< Size of the memory map in bytes
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
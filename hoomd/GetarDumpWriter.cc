@@ -258,6 +258,13 @@ namespace getardump{
         return result.str();
         }
 
+    // Whether a record is read directly from the particle data rather
+    // than from the system snapshot
+    bool readsParticleData(const GetarDumpDescription &desc)
+        {
+        return desc.m_prop == PotentialEnergy || desc.m_prop == Virial || desc.m_prop == Box;
+        }
+
     NeedSnapshots::NeedSnapshots()
         {
         for(unsigned int i(0); i < 9; ++i)
@@ -329,14 +336,30 @@ namespace getardump{
         }
 
     GetarDumpWriter::~GetarDumpWriter()
-        {}
+        {
+        try
+            {
+            waitForPendingWrite();
+            }
+        catch(const std::exception &e)
+            {
+            m_exec_conf->msg->error() << e.what() << endl;
+            }
+        }
 
     void GetarDumpWriter::close()
         {
+        waitForPendingWrite();
         if(m_archive)
             m_archive->close();
         }
 
+    void GetarDumpWriter::waitForPendingWrite()
+        {
+        if(m_pending_write.valid())
+            m_pending_write.get();
+        }
+
     void GetarDumpWriter::analyze(uint64_t timestep)
         {
         const uint64_t shiftedTimestep(timestep - m_offset);
@@ -344,6 +367,10 @@ namespace getardump{
                                    false, false, false, false};
         bool ranThisStep(false);
 
+        // the archive and the system snapshot are in use until the
+        // records of the previous step are written
+        waitForPendingWrite();
+
         for(NeedSnapshotMap::iterator pIter(m_neededSnapshots.begin());
             pIter != m_neededSnapshots.end(); ++pIter)
             {
@@ -363,75 +390,85 @@ namespace getardump{
             return;
 #endif
 
-        if(m_operationMode == OneShot)
+        vector<GetarDumpDescription> records;
+        for(PeriodMap::iterator pIter(m_periods.begin());
+            pIter != m_periods.end(); ++pIter)
             {
-            for(PeriodMap::iterator pIter(m_periods.begin());
-                pIter != m_periods.end(); ++pIter)
-                if(!(shiftedTimestep%pIter->first))
-                    ranThisStep = true;
-
-            if(ranThisStep)
+            if(!(shiftedTimestep%pIter->first))
                 {
-                m_archive.reset(new GTAR(m_tempName, gtar::Write));
-                    {
-                    GTAR::BulkWriter writer(*m_archive);
-
-                    for(PeriodMap::iterator pIter(m_periods.begin());
-                        pIter != m_periods.end(); ++pIter)
-                        {
-                        if(!(shiftedTimestep%pIter->first))
-                            {
-                            for(vector<GetarDumpDescription>::iterator dIter(pIter->second.begin());
-                                dIter != pIter->second.end(); ++dIter)
-                                {
-                                write(writer, *dIter, timestep);
-                                // const Property prop(dIter->m_prop);
-                                // const Resolution res(dIter->m_res);
-
-                                // string path(dIter->getFormattedPath(timestep));
-                                }
-                            }
-                        }
-
-                    for(vector<GetarDumpDescription>::const_iterator iter(m_staticRecords.begin());
-                        iter != m_staticRecords.end(); ++iter)
-                        write(writer, *iter, 0);
+                ranThisStep = true;
+                records.insert(records.end(), pIter->second.begin(), pIter->second.end());
+                }
+            }
 
-                    }
+        if(!ranThisStep)
+            return;
+
+        if(m_operationMode == OneShot)
+            {
+            m_archive.reset(new GTAR(m_tempName, gtar::Write));
+            // static records ignore the timestep in their path
+            records.insert(records.end(), m_staticRecords.begin(), m_staticRecords.end());
+            }
+        else if(!m_archive)
+            return;
 
-                m_archive.reset();
-                int result(rename(m_tempName.c_str(), m_filename.c_str()));
+        if(m_async_write)
+            {
+            // records read from the particle data must be written
+            // before the simulation continues, the rest are written
+            // while it does
+            vector<GetarDumpDescription> liveRecords, snapshotRecords;
+            for(vector<GetarDumpDescription>::const_iterator dIter(records.begin());
+                dIter != records.end(); ++dIter)
+                {
+                if(readsParticleData(*dIter))
+                    liveRecords.push_back(*dIter);
+                else
+                    snapshotRecords.push_back(*dIter);
+                }
 
-                if(result)
+            writeRecords(liveRecords, timestep);
+            m_pending_write = std::async(std::launch::async,
+                [this, snapshotRecords, timestep]()
                     {
-                    stringstream msg;
-                    msg << "Error " << result << " in one-shot file: " << strerror(result);
-                    m_exec_conf->msg->error() << msg.str() << endl;
-                    throw runtime_error(msg.str());
-                    }
-                }
+                    finishRecords(snapshotRecords, timestep);
+                    });
             }
-        else if(m_archive)
+        else
             {
-            GTAR::BulkWriter writer(*m_archive);
+            writeRecords(records, timestep);
+            finishRecords(vector<GetarDumpDescription>(), timestep);
+            }
+        }
 
-            for(PeriodMap::iterator pIter(m_periods.begin());
-                pIter != m_periods.end(); ++pIter)
-                {
-                if(!(shiftedTimestep%pIter->first))
-                    {
-                    ranThisStep = true;
+    void GetarDumpWriter::writeRecords(const vector<GetarDumpDescription> &records, uint64_t timestep)
+        {
+        if(records.empty())
+            return;
 
-                    for(vector<GetarDumpDescription>::iterator dIter(pIter->second.begin());
-                        dIter != pIter->second.end(); ++dIter)
-                        {
-                        write(writer, *dIter, timestep);
-                        // const Property prop(dIter->m_prop);
-                        // const Resolution res(dIter->m_res);
+        GTAR::BulkWriter writer(*m_archive);
 
-                        // string path(dIter->getFormattedPath(timestep));
-                        }
-                    }
+        for(vector<GetarDumpDescription>::const_iterator dIter(records.begin());
+            dIter != records.end(); ++dIter)
+            write(writer, *dIter, timestep);
+        }
+
+    void GetarDumpWriter::finishRecords(const vector<GetarDumpDescription> &records, uint64_t timestep)
+        {
+        writeRecords(records, timestep);
+
+        if(m_operationMode == OneShot)
+            {
+            m_archive.reset();
+            int result(rename(m_tempName.c_str(), m_filename.c_str()));
+
+            if(result)
+                {
+                stringstream msg;
+                msg << "Error " << result << " in one-shot file: " << strerror(result);
+                m_exec_conf->msg->error() << msg.str() << endl;
+                throw runtime_error(msg.str());
                 }
             }
         }
@@ -824,6 +861,7 @@ namespace getardump{
         if(behavior == Constant)
             {
             m_staticRecords.push_back(desc);
+            waitForPendingWrite();
             if(m_archive)
                 {
                 GTAR::BulkWriter writer(*m_archive);
@@ -886,6 +924,8 @@ namespace getardump{
             rec = gtar::Record("", name, conv.str(), gtar::Discrete, gtar::UInt8, gtar::Text);
             }
 
+        waitForPendingWrite();
+
 #ifdef ENABLE_MPI
         // only write on root rank
         if (m_exec_conf->isRoot())
@@ -902,6 +942,7 @@ namespace getardump{
             .def("setPeriod", &GetarDumpWriter::setPeriod)
             .def("removeDump", &GetarDumpWriter::removeDump)
             .def("writeStr", &GetarDumpWriter::writeStr)
+            .def_property("async_write", &GetarDumpWriter::getAsyncWrite, &GetarDumpWriter::setAsyncWrite)
         ;
 
 
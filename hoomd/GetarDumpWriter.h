@@ -9,6 +9,7 @@
 #include "hoomd/extern/libgetar/src/GTAR.hpp"
 #include "hoomd/extern/libgetar/src/Record.hpp"
 #include "hoomd/GetarDumpIterators.h"
+#include <future>
 #include <memory>
 
 #include <map>
@@ -268,7 +269,38 @@ namespace getardump{
             /// (timesteps <0 indicate to dump a static quantity)
             void writeStr(const std::string &name, const std::string &contents, uint64_t timestep);
 
+            /// Set whether records are written by a background thread
+            ///
+            /// Records of the current step that are taken from the
+            /// system snapshot are written (and compressed) by a
+            /// background thread while the simulation continues;
+            /// records read directly from the particle data are
+            /// still written by analyze(). At most one step is in
+            /// flight: the next call to analyze() waits for the
+            /// previous records to be written.
+            void setAsyncWrite(bool async_write)
+                {
+                if(!async_write)
+                    waitForPendingWrite();
+                m_async_write = async_write;
+                }
+
+            /// Get whether records are written by a background thread
+            bool getAsyncWrite() const
+                {
+                return m_async_write;
+                }
+
         private:
+            /// Wait for the background write of the previous step,
+            /// rethrowing any error it raised
+            void waitForPendingWrite();
+            /// Write the given records of a step in one bulk write
+            void writeRecords(const std::vector<GetarDumpDescription> &records, uint64_t timestep);
+            /// Write the remaining records of a step and, in one-shot
+            /// mode, move the finished file into place
+            void finishRecords(const std::vector<GetarDumpDescription> &records, uint64_t timestep);
+
             /// Write any GetarDumpDescription for the given timestep
             void write(gtar::GTAR::BulkWriter &writer, const GetarDumpDescription &desc, uint64_t timestep);
             /// Write an individual GetarDumpDescription for the given timestep
@@ -297,6 +329,10 @@ namespace getardump{
             std::shared_ptr<SystemSnapshot> m_systemSnap;
             /// Map detailing when we need which snapshots
             NeedSnapshotMap m_neededSnapshots;
+            /// True if records are written by a background thread
+            bool m_async_write = false;
+            /// Background write of the previous step
+            std::future<void> m_pending_write;
         };
 
 void export_GetarDumpWriter(pybind11::module& m);
@@ -43,13 +43,19 @@
 #include <utility>
 
 #include <type_traits>
+#include <typeinfo>
 #include <string>
 #include <unistd.h>
 #include <vector>
 #include <sstream>
 
+//! Tag an array with the class that allocates it and its name, such as "NeighborList::m_nlist"
+/*! MemoryUsage counts the memory of the array under the class. Use it in member functions only.
+*/
 #define TAG_ALLOCATION(array) { \
-    array.setTag(std::string(#array)); \
+    static const std::string tag_owner = hoomd::detail::getClassName( \
+        typeid(std::remove_pointer<decltype(this)>::type)); \
+    array.setTag(tag_owner + "::" + std::string(#array)); \
     }
 
 namespace hoomd
@@ -57,6 +63,16 @@ namespace hoomd
 namespace detail
 {
 
+//! Get the demangled name of a class without its template arguments
+inline std::string getClassName(const std::type_info& type)
+    {
+    int status;
+    char *realname = abi::__cxa_demangle(type.name(), 0, 0, &status);
+    std::string name = status ? std::string(type.name()) : std::string(realname);
+    free(realname);
+    return name.substr(0, name.find('<'));
+    }
+
 #ifdef __GNUC__
 #define GCC_VERSION (__GNUC__ * 10000 \
                      + __GNUC_MINOR__ * 100 \
@@ -144,7 +160,8 @@ class managed_deleter
                 oss << std::endl;
                 this->m_exec_conf->msg->notice(10) << oss.str();
 
-                hipFree(m_allocation_ptr);
+                // return the block to the pool, which frees it only when the cache is full
+                this->m_exec_conf->getManagedMemoryPool().deallocate(m_allocation_ptr);
                 CHECK_CUDA_ERROR();
                 }
             else
@@ -335,6 +352,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
                 else
                     {
                     m_data.reset();
+                    m_usage.release();
                     }
                 }
 
@@ -354,7 +372,8 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
               m_acquired(std::move(other.m_acquired)),
               m_tag(std::move(other.m_tag)),
               m_align_bytes(std::move(other.m_align_bytes)),
-              m_is_managed(std::move(other.m_is_managed))
+              m_is_managed(std::move(other.m_is_managed)),
+              m_usage(std::move(other.m_usage))
               #ifdef ENABLE_HIP
               , m_event(std::move(other.m_event))
               #endif
@@ -379,6 +398,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
                 m_tag = std::move(other.m_tag);
                 m_align_bytes = std::move(other.m_align_bytes);
                 m_is_managed = std::move(other.m_is_managed);
+                m_usage = std::move(other.m_usage);
                 #ifdef ENABLE_HIP
                 m_event = std::move(other.m_event);
                 #endif
@@ -441,6 +461,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             std::swap(m_tag, from.m_tag);
             std::swap(m_align_bytes, from.m_align_bytes);
             std::swap(m_is_managed, from.m_is_managed);
+            m_usage.swap(from.m_usage);
             #ifdef ENABLE_HIP
             std::swap(m_event, from.m_event);
             #endif
@@ -644,6 +665,12 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             if (!isNull() && m_data)
                 m_data.get_deleter().setTag(tag);
 
+            // count the memory under the new tag
+            updateMemoryUsage();
+            #ifndef ALWAYS_USE_MANAGED_MEMORY
+            m_fallback.setTag(tag);
+            #endif
+
             // for debugging
             this->outputRepresentation();
             }
@@ -744,6 +771,8 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
         size_t m_align_bytes; //!< Size of alignment in bytes
         bool m_is_managed;  //!< Whether or not this array is stored using managed memory.
 
+        hoomd::detail::MemoryUsageRecord m_usage;   //!< Memory of the managed array counted in MemoryUsage
+
         #ifdef ENABLE_HIP
         std::unique_ptr<hipEvent_t, hoomd::detail::event_deleter> m_event;   //! CUDA event for synchronization
         #endif
@@ -770,7 +799,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
                 this->m_exec_conf->msg->notice(10) << "Allocating " << allocation_bytes
                     << " bytes of managed memory." << std::endl;
 
-                hipMallocManaged(&ptr, allocation_bytes, hipMemAttachGlobal);
+                this->m_exec_conf->getManagedMemoryPool().allocate(&ptr, allocation_bytes);
                 CHECK_CUDA_ERROR();
 
                 allocation_ptr = ptr;
@@ -831,10 +860,21 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
                 this->m_exec_conf->getMemoryTracer()->registerAllocation(reinterpret_cast<const void *>(m_data.get()),
                     sizeof(T)*m_num_elements, typeid(T).name(), m_tag);
 
+            updateMemoryUsage();
+
             // display representation for debugging
             if (m_tag != "")
                 outputRepresentation();
             }
+
+        //! Count the managed allocation in MemoryUsage, the fallback GPUArray counts its own
+        void updateMemoryUsage()
+            {
+            if (this->m_exec_conf && m_data)
+                m_usage.update(this->m_exec_conf->getMemoryUsage(), m_tag, sizeof(T)*m_num_elements);
+            else
+                m_usage.release();
+            }
     };
 
 //************************************************
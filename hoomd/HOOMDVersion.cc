@@ -36,6 +36,13 @@ std::string BuildInfo::getCompileFlags()
 #ifdef ENABLE_HPMC_MIXED_PRECISION
     o << "HPMC_MIXED ";
 #endif
+#ifdef ENABLE_MD_MIXED_PRECISION
+    o << "MD_MIXED ";
+#endif
+#endif
+
+#ifdef ENABLE_DETERMINISTIC_FORCES
+    o << "DETERMINISTIC_FORCES ";
 #endif
 
 #ifdef ENABLE_MPI
@@ -50,6 +57,14 @@ std::string BuildInfo::getCompileFlags()
     o << "TBB ";
 #endif
 
+#ifdef ENABLE_ASCENT
+    o << "ASCENT ";
+#endif
+
+#ifdef ENABLE_PAPI
+    o << "PAPI ";
+#endif
+
 #ifdef __SSE__
     o << "SSE ";
 #endif
@@ -163,6 +178,15 @@ bool BuildInfo::getEnableMPI()
 #endif
     }
 
+bool BuildInfo::getEnableAscent()
+    {
+#ifdef ENABLE_ASCENT
+    return true;
+#else
+    return false;
+#endif
+    }
+
 std::string BuildInfo::getSourceDir()
     {
     return std::string(HOOMD_SOURCE_DIR);
@@ -0,0 +1,214 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file HostMemoryPolicy.cc
+    \brief Defines the HostMemoryPolicy class
+*/
+
+#include "HostMemoryPolicy.h"
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef ENABLE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
+namespace
+    {
+#ifdef __linux__
+//! Memory policy modes of mbind(), see <numaif.h>
+const int hoomd_mpol_preferred = 1;
+const int hoomd_mpol_interleave = 3;
+
+//! Collect the numbers N of all directory entries named <prefix>N
+std::vector<unsigned int> list_numbered_entries(const std::string& path, const std::string& prefix)
+    {
+    std::vector<unsigned int> result;
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+        return result;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+        {
+        const char *name = entry->d_name;
+        if (strncmp(name, prefix.c_str(), prefix.size()) != 0)
+            continue;
+
+        const char *digits = name + prefix.size();
+        if (*digits == '\0' || strspn(digits, "0123456789") != strlen(digits))
+            continue;
+
+        result.push_back((unsigned int)atoi(digits));
+        }
+    closedir(dir);
+
+    std::sort(result.begin(), result.end());
+    return result;
+    }
+#endif
+
+//! Size of the chunks cleared by each TBB task
+const size_t clear_chunk_size = 256*1024;
+    }
+
+const size_t HostMemoryPolicy::huge_page_size;
+
+HostMemoryPolicy::HostMemoryPolicy()
+    : m_huge_pages(true), m_numa_binding(true), m_parallel_first_touch(true), m_num_nodes(1)
+    {
+    detectNUMANodes();
+    }
+
+void HostMemoryPolicy::detectNUMANodes()
+    {
+#ifdef __linux__
+    std::vector<unsigned int> nodes = list_numbered_entries("/sys/devices/system/node", "node");
+    if (nodes.empty())
+        return;
+    m_num_nodes = (unsigned int)nodes.size();
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+        return;
+
+    std::set<unsigned int> local_nodes;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+        if (!CPU_ISSET(cpu, &cpu_set))
+            continue;
+
+        std::vector<unsigned int> cpu_nodes = list_numbered_entries("/sys/devices/system/cpu/cpu"
+                                                                    + std::to_string(cpu), "node");
+        local_nodes.insert(cpu_nodes.begin(), cpu_nodes.end());
+        }
+
+    m_local_nodes.assign(local_nodes.begin(), local_nodes.end());
+#endif
+    }
+
+int HostMemoryPolicy::allocate(void **ptr, size_t num_bytes, size_t alignment)
+    {
+    bool huge = false;
+    bool bind = false;
+    size_t alloc_bytes = num_bytes;
+
+#ifdef __linux__
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    huge = m_huge_pages && num_bytes >= huge_page_size;
+    bind = m_numa_binding && num_bytes >= page_size && !m_local_nodes.empty()
+           && m_local_nodes.size() < m_num_nodes;
+
+    // madvise and mbind act on whole pages, so the allocation must start and end on a page boundary
+    if (huge)
+        {
+        alignment = std::max(alignment, huge_page_size);
+        alloc_bytes = (num_bytes + huge_page_size - 1)/huge_page_size*huge_page_size;
+        }
+    else if (bind)
+        {
+        alignment = std::max(alignment, page_size);
+        alloc_bytes = (num_bytes + page_size - 1)/page_size*page_size;
+        }
+#endif
+
+    int retval = posix_memalign(ptr, alignment, alloc_bytes);
+    if (retval != 0)
+        return retval;
+
+#ifdef __linux__
+    // both calls are hints, the allocation is usable if they fail
+    if (huge && madvise(*ptr, alloc_bytes, MADV_HUGEPAGE) != 0)
+        huge = false;
+
+    if (bind)
+        {
+        const unsigned int bits = 8*sizeof(unsigned long);
+        std::vector<unsigned long> mask(m_local_nodes.back()/bits + 1, 0);
+        for (auto node : m_local_nodes)
+            mask[node/bits] |= 1ul << (node % bits);
+
+        int mode = m_local_nodes.size() == 1 ? hoomd_mpol_preferred : hoomd_mpol_interleave;
+        if (syscall(SYS_mbind, *ptr, alloc_bytes, mode, mask.data(), mask.size()*bits + 1, 0) != 0)
+            bind = false;
+        }
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.num_allocations++;
+    m_stats.bytes_allocated += alloc_bytes;
+    if (huge)
+        m_stats.bytes_huge_pages += alloc_bytes;
+    if (bind)
+        m_stats.bytes_numa_bound += alloc_bytes;
+
+    return 0;
+    }
+
+void HostMemoryPolicy::clear(void *ptr, size_t num_bytes) const
+    {
+#ifdef ENABLE_TBB
+    if (m_parallel_first_touch && num_bytes >= huge_page_size)
+        {
+        char *data = reinterpret_cast<char *>(ptr);
+        size_t n_chunks = (num_bytes + clear_chunk_size - 1)/clear_chunk_size;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n_chunks),
+            [=](const tbb::blocked_range<size_t>& r)
+            {
+            size_t begin = r.begin()*clear_chunk_size;
+            size_t end = std::min(r.end()*clear_chunk_size, num_bytes);
+            memset(data + begin, 0, end - begin);
+            });
+        return;
+        }
+#endif
+
+    memset(ptr, 0, num_bytes);
+    }
+
+std::string HostMemoryPolicy::describe() const
+    {
+    std::ostringstream s;
+    s << "huge pages " << (m_huge_pages ? "on" : "off");
+
+    s << ", NUMA binding ";
+    if (!m_numa_binding)
+        {
+        s << "off";
+        }
+    else if (m_local_nodes.empty() || m_local_nodes.size() >= m_num_nodes)
+        {
+        s << "inactive (rank spans all " << m_num_nodes << " nodes)";
+        }
+    else
+        {
+        s << "to node";
+        if (m_local_nodes.size() > 1)
+            s << "s";
+        for (auto node : m_local_nodes)
+            s << " " << node;
+        s << " of " << m_num_nodes;
+        }
+
+    s << ", parallel first touch ";
+#ifdef ENABLE_TBB
+    s << (m_parallel_first_touch ? "on" : "off");
+#else
+    s << "unavailable (no TBB)";
+#endif
+    return s.str();
+    }
@@ -0,0 +1,143 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file HostMemoryPolicy.h
+    \brief Declares the placement policy for host memory allocations of GPUArray
+*/
+
+#pragma once
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+//! Placement statistics of host memory allocations
+struct HostMemoryStatistics
+    {
+    unsigned long num_allocations = 0;  //!< Number of allocations made through the policy
+    size_t bytes_allocated = 0;         //!< Bytes allocated through the policy
+    size_t bytes_huge_pages = 0;        //!< Bytes advised to be backed by transparent huge pages
+    size_t bytes_numa_bound = 0;        //!< Bytes bound to the NUMA nodes of the rank
+    };
+
+//! Allocation policy for the host memory of GPUArray
+/*! Large host arrays (positions, velocities, forces, neighbor lists) of multi-million particle systems suffer from
+    TLB misses, and with several MPI ranks per multi-socket node their pages may be placed on a remote NUMA node.
+    HostMemoryPolicy allocates host memory with three optional measures:
+
+    - <b>Huge pages</b>: allocations of at least one huge page (2 MB) are aligned to the huge page size and advised
+      with madvise(MADV_HUGEPAGE), so that the kernel backs them with transparent huge pages.
+    - <b>NUMA binding</b>: allocations are bound with mbind() to the NUMA nodes that hold the CPUs in the affinity
+      mask of the rank, preferring the node when there is only one and interleaving between them otherwise. Binding
+      is only enabled when the rank's CPUs do not span all NUMA nodes of the machine.
+    - <b>Parallel first touch</b>: clear() zeroes large allocations with the TBB threads of the rank, so that pages
+      are first touched, and placed, by the threads that later work on them.
+
+    The policy is queried once per allocation and only affects memory allocated afterwards. On systems other than
+    Linux, the huge page and NUMA options have no effect.
+*/
+class PYBIND11_EXPORT HostMemoryPolicy
+    {
+    public:
+        //! Constructor, detects the NUMA nodes of this rank
+        HostMemoryPolicy();
+
+        HostMemoryPolicy(const HostMemoryPolicy&) = delete;
+        HostMemoryPolicy& operator=(const HostMemoryPolicy&) = delete;
+
+        //! Allocate host memory
+        /*! \param ptr Set to the allocated memory
+            \param num_bytes Number of bytes to allocate
+            \param alignment Minimum alignment of the allocation
+            \returns 0 on success, or the error code of posix_memalign
+
+            The memory is released with free().
+        */
+        int allocate(void **ptr, size_t num_bytes, size_t alignment);
+
+        //! Set memory to zero, touching pages from the TBB threads
+        /*! \param ptr Start of the memory
+            \param num_bytes Number of bytes to clear
+        */
+        void clear(void *ptr, size_t num_bytes) const;
+
+        //! Enable or disable huge pages for large allocations
+        void setHugePages(bool enable)
+            {
+            m_huge_pages = enable;
+            }
+
+        //! Get whether huge pages are used for large allocations
+        bool getHugePages() const
+            {
+            return m_huge_pages;
+            }
+
+        //! Enable or disable binding allocations to the NUMA nodes of this rank
+        void setNUMABinding(bool enable)
+            {
+            m_numa_binding = enable;
+            }
+
+        //! Get whether allocations are bound to the NUMA nodes of this rank
+        bool getNUMABinding() const
+            {
+            return m_numa_binding;
+            }
+
+        //! Enable or disable clearing memory from the TBB threads
+        void setParallelFirstTouch(bool enable)
+            {
+            m_parallel_first_touch = enable;
+            }
+
+        //! Get whether memory is cleared from the TBB threads
+        bool getParallelFirstTouch() const
+            {
+            return m_parallel_first_touch;
+            }
+
+        //! Get the NUMA nodes that hold the CPUs of this rank
+        const std::vector<unsigned int>& getLocalNUMANodes() const
+            {
+            return m_local_nodes;
+            }
+
+        //! Get the number of NUMA nodes of the machine
+        unsigned int getNumNUMANodes() const
+            {
+            return m_num_nodes;
+            }
+
+        //! Get a description of the policy
+        std::string describe() const;
+
+        //! Get the placement statistics
+        HostMemoryStatistics getStatistics() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_stats;
+            }
+
+        //! Size of a huge page in bytes
+        static const size_t huge_page_size = 2*1024*1024;
+
+    private:
+        bool m_huge_pages;                          //!< True if large allocations are advised to use huge pages
+        bool m_numa_binding;                        //!< True if allocations are bound to the local NUMA nodes
+        bool m_parallel_first_touch;                //!< True if clear() uses the TBB threads
+        std::vector<unsigned int> m_local_nodes;    //!< NUMA nodes that hold the CPUs of this rank
+        unsigned int m_num_nodes;                   //!< Number of NUMA nodes of the machine
+
+        mutable std::mutex m_mutex;                 //!< Protects the statistics
+        HostMemoryStatistics m_stats;               //!< Placement statistics
+
+        //! Detect the NUMA nodes of the CPUs in the affinity mask of this process
+        void detectNUMANodes();
+    };
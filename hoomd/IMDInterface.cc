@@ -22,10 +22,40 @@ namespace py = pybind11;
 #include "hoomd/extern/vmdsock.h"
 #include "hoomd/extern/imd.h"
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
 #include <stdexcept>
 
 using namespace std;
 
+//! Send the energies and coordinates of one frame
+/*! \param sock Connected socket
+    \param timestep Time step of the frame
+    \param coords Coordinates to send (3 per particle)
+    \returns 0 on success, non-zero on an I/O error
+*/
+static int send_frame(void *sock, uint64_t timestep, const std::vector<float>& coords)
+    {
+    IMDEnergies energies;
+    energies.tstep = static_cast<int32_t>(timestep);
+    energies.T = 0.0f;
+    energies.Etot = 0.0f;
+    energies.Epot = 0.0f;
+    energies.Evdw = 0.0f;
+    energies.Eelec = 0.0f;
+    energies.Ebond = 0.0f;
+    energies.Eangle = 0.0f;
+    energies.Edihe = 0.0f;
+    energies.Eimpr = 0.0f;
+
+    int err = imd_send_energies(sock, &energies);
+    if (err)
+        return err;
+
+    return imd_send_fcoords(sock, int32(coords.size() / 3), coords.data());
+    }
+
 /*! After construction, IMDInterface is listening for connections on port \a port.
     analyze() must be called to handle any incoming connections.
     \param sysdef SystemDefinition containing the ParticleData that will be transmitted to VMD
@@ -70,9 +100,6 @@ void IMDInterface::initConnection()
     {
     int err = 0;
 
-    // start by initializing memory
-    m_tmp_coords = new float[m_pdata->getNGlobal() * 3];
-
     // initialize the listening socket
     vmdsock_init();
     m_listen_sock = vmdsock_create();
@@ -114,12 +141,13 @@ IMDInterface::~IMDInterface()
 
     if (m_is_initialized)
         {
-        // free all used memory
-        delete[] m_tmp_coords;
+        // the socket is in use until the previous frame is sent
+        if (m_pending_send.valid())
+            m_pending_send.wait();
+
         vmdsock_destroy(m_connected_sock);
         vmdsock_destroy(m_listen_sock);
 
-        m_tmp_coords = NULL;
         m_connected_sock = NULL;
         m_listen_sock = NULL;
         }
@@ -189,7 +217,13 @@ void IMDInterface::analyze(uint64_t timestep)
 #ifdef ENABLE_MPI
     unsigned char send_coords = 0;
     if (is_root && m_connected_sock && m_active && (m_trate == 0 || m_count % m_trate == 0))
-        send_coords = 1;
+        {
+        // drop the frame while the previous one is still being sent
+        if (!finishPendingSend(false))
+            m_dropped_frames++;
+        else if (m_connected_sock)
+            send_coords = 1;
+        }
 
     if (m_comm)
         {
@@ -199,9 +233,15 @@ void IMDInterface::analyze(uint64_t timestep)
     if (send_coords)
         sendCoords(timestep);
 #else
-    // send data when active, connected, and the rate matches
+    // send data when active, connected, and the rate matches, dropping the frame while the previous one is still
+    // being sent
     if (m_connected_sock && m_active && (m_trate == 0 || m_count % m_trate == 0))
-        sendCoords(timestep);
+        {
+        if (!finishPendingSend(false))
+            m_dropped_frames++;
+        else if (m_connected_sock)
+            sendCoords(timestep);
+        }
 #endif
 
     if (m_prof)
@@ -379,6 +419,10 @@ void IMDInterface::processIMD_IOERROR()
 
 void IMDInterface::processDeadConnection()
     {
+    // the socket is in use until the previous frame is sent, its result no longer matters
+    if (m_pending_send.valid())
+        m_pending_send.get();
+
     vmdsock_destroy(m_connected_sock);
     m_connected_sock = NULL;
     m_active = false;
@@ -421,6 +465,121 @@ void IMDInterface::establishConnectionAttempt()
         }
     }
 
+/*! \param wait If true, block until the previous frame is sent
+    \returns true if no frame is in flight
+
+    An I/O error of the background send drops the connection.
+*/
+bool IMDInterface::finishPendingSend(bool wait)
+    {
+    if (!m_pending_send.valid())
+        return true;
+
+    if (!wait && m_pending_send.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    if (m_pending_send.get())
+        {
+        m_exec_conf->msg->error() << "analyze.imd: I/O error while sending coordinates, disconnecting" << endl;
+        processDeadConnection();
+        }
+    return true;
+    }
+
+/*! \param coords Set to the coordinates to send on the root rank (3 per particle)
+
+    Every rank sends the positions of its local particles (or group members) along with their position in the frame
+    instead of gathering a full snapshot.
+*/
+void IMDInterface::gatherCoords(std::vector<float>& coords)
+    {
+    unsigned int n_send = m_group ? m_group->getNumMembersGlobal() : m_pdata->getNGlobal();
+
+    // map the tags to their position in the frame when the group changes
+    if (m_group && (m_group_idx.empty() || n_send != m_group_idx_members))
+        {
+        m_group_idx.assign(n_send ? m_group->getMemberTag(n_send - 1) + 1 : 0, UINT_MAX);
+        for (unsigned int group_idx = 0; group_idx < n_send; group_idx++)
+            m_group_idx[m_group->getMemberTag(group_idx)] = group_idx;
+        m_group_idx_members = n_send;
+        }
+
+    // pack the local particles with their position in the frame
+    std::vector<unsigned int> local_idx;
+    std::vector<float> local_coords;
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        unsigned int N = m_pdata->getN();
+        local_idx.reserve(N);
+        local_coords.reserve(3 * N);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int tag = h_tag.data[i];
+            unsigned int frame_idx = tag;
+            if (m_group)
+                {
+                frame_idx = tag < m_group_idx.size() ? m_group_idx[tag] : UINT_MAX;
+                if (frame_idx == UINT_MAX)
+                    continue;
+                }
+
+            local_idx.push_back(frame_idx);
+            local_coords.push_back(float(h_pos.data[i].x));
+            local_coords.push_back(float(h_pos.data[i].y));
+            local_coords.push_back(float(h_pos.data[i].z));
+            }
+        }
+
+#ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        bool root = m_exec_conf->isRoot();
+        unsigned int n_ranks = m_exec_conf->getNRanks();
+
+        int n_local = int(local_idx.size());
+        std::vector<int> counts(root ? n_ranks : 0);
+        MPI_Gather(&n_local, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, mpi_comm);
+
+        std::vector<int> offsets(counts.size());
+        std::vector<int> coord_counts(counts.size());
+        std::vector<int> coord_offsets(counts.size());
+        int n_total = 0;
+        for (unsigned int r = 0; r < counts.size(); r++)
+            {
+            offsets[r] = n_total;
+            coord_counts[r] = 3 * counts[r];
+            coord_offsets[r] = 3 * n_total;
+            n_total += counts[r];
+            }
+
+        std::vector<unsigned int> all_idx(n_total);
+        std::vector<float> all_coords(3 * n_total);
+        MPI_Gatherv(local_idx.data(), n_local, MPI_UNSIGNED, all_idx.data(), counts.data(), offsets.data(),
+                    MPI_UNSIGNED, 0, mpi_comm);
+        MPI_Gatherv(local_coords.data(), 3 * n_local, MPI_FLOAT, all_coords.data(), coord_counts.data(),
+                    coord_offsets.data(), MPI_FLOAT, 0, mpi_comm);
+
+        local_idx.swap(all_idx);
+        local_coords.swap(all_coords);
+
+        if (!root)
+            return;
+        }
+#endif
+
+    coords.resize(3 * n_send);
+    for (unsigned int k = 0; k < local_idx.size(); k++)
+        {
+        unsigned int frame_idx = local_idx[k];
+        coords[3 * frame_idx] = local_coords[3 * k];
+        coords[3 * frame_idx + 1] = local_coords[3 * k + 1];
+        coords[3 * frame_idx + 2] = local_coords[3 * k + 2];
+        }
+    }
+
 /*! \param timestep Current time step of the simulation
     \pre A connection has been established
 
@@ -428,9 +587,8 @@ void IMDInterface::establishConnectionAttempt()
 */
 void IMDInterface::sendCoords(uint64_t timestep)
     {
-    // take a snapshot of the particle data
-    SnapshotParticleData<Scalar> snapshot;
-    m_pdata->takeSnapshot(snapshot);
+    std::vector<float> coords;
+    gatherCoords(coords);
 
 #ifdef ENABLE_MPI
     // return now if not root rank
@@ -440,41 +598,19 @@ void IMDInterface::sendCoords(uint64_t timestep)
 
     assert(m_connected_sock != NULL);
 
-    // setup and send the energies structure
-    IMDEnergies energies;
-    energies.tstep = static_cast<int32_t>(timestep);
-    energies.T = 0.0f;
-    energies.Etot = 0.0f;
-    energies.Epot = 0.0f;
-    energies.Evdw = 0.0f;
-    energies.Eelec = 0.0f;
-    energies.Ebond = 0.0f;
-    energies.Eangle = 0.0f;
-    energies.Edihe = 0.0f;
-    energies.Eimpr = 0.0f;
-
-    int err = imd_send_energies(m_connected_sock, &energies);
-    if (err)
-        {
-        m_exec_conf->msg->error() << "analyze.imd: I/O error while sending energies, disconnecting" << endl;
-        processDeadConnection();
-        return;
-        }
-
-    // copy the particle data to the holding array and send it
-    for (unsigned int tag = 0; tag < m_pdata->getNGlobal(); tag++)
+    if (m_async_send)
         {
-        m_tmp_coords[tag*3] = float(snapshot.pos[tag].x);
-        m_tmp_coords[tag*3 + 1] = float(snapshot.pos[tag].y);
-        m_tmp_coords[tag*3 + 2] = float(snapshot.pos[tag].z);
+        // send the frame while the simulation continues
+        m_pending_send = std::async(std::launch::async, send_frame, m_connected_sock, timestep, std::move(coords));
         }
-    err = imd_send_fcoords(m_connected_sock, m_pdata->getNGlobal(), m_tmp_coords);
-
-    if (err)
+    else
         {
-        m_exec_conf->msg->error() << "analyze.imd: I/O error while sending coordinates, disconnecting" << endl;
-        processDeadConnection();
-        return;
+        int err = send_frame(m_connected_sock, timestep, coords);
+        if (err)
+            {
+            m_exec_conf->msg->error() << "analyze.imd: I/O error while sending coordinates, disconnecting" << endl;
+            processDeadConnection();
+            }
         }
     }
 
@@ -482,5 +618,8 @@ void export_IMDInterface(py::module& m)
     {
     py::class_<IMDInterface, Analyzer, std::shared_ptr<IMDInterface> >(m,"IMDInterface")
     .def(py::init< std::shared_ptr<SystemDefinition>, int, bool, unsigned int, std::shared_ptr<ConstForceCompute> >())
+    .def_property("async_send", &IMDInterface::getAsyncSend, &IMDInterface::setAsyncSend)
+    .def_property("group", &IMDInterface::getGroup, &IMDInterface::setGroup)
+    .def_property_readonly("dropped_frames", &IMDInterface::getDroppedFrames)
         ;
     }
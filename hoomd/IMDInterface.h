@@ -16,8 +16,11 @@
 
 #include "Analyzer.h"
 #include "ConstForceCompute.h"
+#include "ParticleGroup.h"
 
+#include <future>
 #include <memory>
+#include <vector>
 
 #ifndef __IMD_INTERFACE_H__
 #define __IMD_INTERFACE_H__
@@ -31,6 +34,13 @@
     In its current implementation, only a barebones set of commands are
     supported. The sending of any command that is not understood will
     result in the socket closing the connection.
+
+    The coordinates are gathered to the root rank directly from the local
+    particle data. When a group is set, only the positions of its members
+    are sent, in the order of their tags. With async sends enabled, a
+    background thread sends each frame so a slow client does not block the
+    simulation. At most one frame is in flight: frames that come due while
+    the previous one is still being sent are dropped.
     \ingroup analyzers
 */
 class PYBIND11_EXPORT IMDInterface : public Analyzer
@@ -49,10 +59,44 @@ class PYBIND11_EXPORT IMDInterface : public Analyzer
 
         //! Handle connection requests and send current positions if connected
         void analyze(uint64_t timestep);
+
+        //! Set whether frames are sent by a background thread
+        void setAsyncSend(bool async_send)
+            {
+            if (!async_send)
+                finishPendingSend(true);
+            m_async_send = async_send;
+            }
+
+        //! Get whether frames are sent by a background thread
+        bool getAsyncSend() const
+            {
+            return m_async_send;
+            }
+
+        //! Set the group of particles to send, or null to send all particles
+        void setGroup(std::shared_ptr<ParticleGroup> group)
+            {
+            m_group = group;
+            m_group_idx.clear();
+            m_group_idx_members = 0;
+            }
+
+        //! Get the group of particles to send
+        std::shared_ptr<ParticleGroup> getGroup() const
+            {
+            return m_group;
+            }
+
+        //! Get the number of frames dropped because the previous frame was still being sent
+        unsigned int getDroppedFrames() const
+            {
+            return m_dropped_frames;
+            }
+
     private:
         void *m_listen_sock;    //!< Socket we are listening on
         void *m_connected_sock; //!< Socket to transmit/receive data
-        float *m_tmp_coords;    //!< Temporary holding location for coordinate data
 
         bool m_active;          //!< True if we have received a go command
         bool m_paused;          //!< True if we are paused
@@ -66,6 +110,13 @@ class PYBIND11_EXPORT IMDInterface : public Analyzer
         std::shared_ptr<ConstForceCompute> m_force;   //!< Force for applying IMD forces
         float m_force_scale;                            //!< Factor by which to scale all IMD forces
 
+        std::shared_ptr<ParticleGroup> m_group;         //!< Group of particles to send (null for all particles)
+        std::vector<unsigned int> m_group_idx;          //!< Position of each tag in the group, UINT_MAX if not a member
+        unsigned int m_group_idx_members = 0;           //!< Number of group members when m_group_idx was built
+        bool m_async_send = false;                      //!< True if frames are sent by a background thread
+        std::future<int> m_pending_send;                //!< Background send of the previous frame
+        unsigned int m_dropped_frames = 0;              //!< Number of frames dropped under back-pressure
+
         //! Helper function that reads message headers and dispatches them to the relevant process functions
         void dispatch();
         //! Helper function to determine of messages are still available
@@ -91,6 +142,10 @@ class PYBIND11_EXPORT IMDInterface : public Analyzer
         void establishConnectionAttempt();
         //! Helper function to send current data to VMD
         void sendCoords(uint64_t timestep);
+        //! Gather the coordinates to send on the root rank
+        void gatherCoords(std::vector<float>& coords);
+        //! Collect the result of the background send of the previous frame
+        bool finishPendingSend(bool wait);
 
         //! Initialize socket and internal state variables for communication
         void initConnection();
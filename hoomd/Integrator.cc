@@ -30,6 +30,14 @@ Integrator::Integrator(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
 
 Integrator::~Integrator()
     {
+    #ifdef ENABLE_HIP
+    for (unsigned int i = 0; i < m_force_streams.size(); ++i)
+        {
+        hipEventDestroy(m_force_events[i]);
+        hipStreamDestroy(m_force_streams[i]);
+        }
+    #endif
+
     #ifdef ENABLE_MPI
     // disconnect
     if (m_request_flags_connected && m_comm)
@@ -300,16 +308,64 @@ Scalar Integrator::computeTotalMomentum(uint64_t timestep)
     return Scalar(p_tot);
     }
 
+/** @param timestep Current time step of the simulation
+
+    Force computes with a RESPA period larger than one form the outer level of a multiple time step integration. They
+    are only evaluated on multiples of their period.
+*/
+void Integrator::updateActiveForces(uint64_t timestep)
+    {
+    m_active_forces.clear();
+    for (auto& force : m_forces)
+        {
+        if (timestep % force->getRESPAPeriod() == 0)
+            m_active_forces.push_back(force);
+        }
+    }
+
 /** @param timestep Current time step of the simulation
     \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
     \note The summation step is performed <b>on the CPU</b> and will result in a lot of data traffic back and forth
           if the forces and/or integrator are on the GPU. Call computeNetForcesGPU() to sum the forces on the GPU
+
+    Force computes that accumulate the net force (see ForceCompute::accumulatesNetForce()) add their forces directly
+    to the zeroed net force arrays and are skipped in the summation.
 */
 void Integrator::computeNetForce(uint64_t timestep)
     {
+    updateActiveForces(timestep);
+
+        {
+        // start by zeroing the net force and virial arrays, so that forces may add to them directly
+        const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
+        const GlobalArray<Scalar>&  net_virial = m_pdata->getNetVirial();
+        const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
+        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
+
+        memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
+        memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
+        memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+        }
+
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
+        {
+        if ((*force_compute)->accumulatesNetForce())
+            (*force_compute)->accumulateNetForce(timestep);
+        else
+            (*force_compute)->compute(timestep);
+        }
+
+    for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
+        (*force_compute)->finishCompute(timestep);
+
+    #ifdef ENABLE_MPI
+    // if no force completed an overlapped ghost update, complete it now
+    if (m_comm)
+        m_comm->completeGhostUpdate(timestep);
+    #endif
 
     if (m_prof)
         {
@@ -324,14 +380,9 @@ void Integrator::computeNetForce(uint64_t timestep)
         const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
         const GlobalArray<Scalar>&  net_virial = m_pdata->getNetVirial();
         const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
-        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
-
-        // start by zeroing the net force and virial arrays
-        memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
-        memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
-        memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::readwrite);
 
         for (unsigned int i = 0; i < 6; ++i)
            external_virial[i] = Scalar(0.0);
@@ -347,8 +398,17 @@ void Integrator::computeNetForce(uint64_t timestep)
         assert(6*nparticles <= net_virial.getNumElements());
         assert(nparticles <= net_torque.getNumElements());
 
-        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
             {
+            for (unsigned int k = 0; k < 6; k++)
+                external_virial[k] += (*force_compute)->getExternalVirial(k);
+
+            external_energy += (*force_compute)->getExternalEnergy();
+
+            // forces that were added directly are already in the net force
+            if ((*force_compute)->accumulatesNetForce())
+                continue;
+
             GlobalArray<Scalar4>& h_force_array = (*force_compute)->getForceArray();
             GlobalArray<Scalar>& h_virial_array = (*force_compute)->getVirialArray();
             GlobalArray<Scalar4>& h_torque_array = (*force_compute)->getTorqueArray();
@@ -361,17 +421,20 @@ void Integrator::computeNetForce(uint64_t timestep)
             ArrayHandle<Scalar> h_virial(h_virial_array,access_location::host,access_mode::read);
             ArrayHandle<Scalar4> h_torque(h_torque_array,access_location::host,access_mode::read);
 
+            // outer level forces of a multiple time step integration act as an impulse
+            Scalar s = Scalar((*force_compute)->getRESPAPeriod());
+
             size_t virial_pitch = h_virial_array.getPitch();
             for (unsigned int j = 0; j < nparticles; j++)
                 {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
+                h_net_force.data[j].x += s*h_force.data[j].x;
+                h_net_force.data[j].y += s*h_force.data[j].y;
+                h_net_force.data[j].z += s*h_force.data[j].z;
                 h_net_force.data[j].w += h_force.data[j].w;
 
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
+                h_net_torque.data[j].x += s*h_torque.data[j].x;
+                h_net_torque.data[j].y += s*h_torque.data[j].y;
+                h_net_torque.data[j].z += s*h_torque.data[j].z;
                 h_net_torque.data[j].w += h_torque.data[j].w;
 
                 for (unsigned int k = 0; k < 6; k++)
@@ -379,11 +442,6 @@ void Integrator::computeNetForce(uint64_t timestep)
                     h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
                     }
                 }
-
-            for (unsigned int k = 0; k < 6; k++)
-                external_virial[k] += (*force_compute)->getExternalVirial(k);
-
-            external_energy += (*force_compute)->getExternalEnergy();
             }
         }
 
@@ -485,6 +543,85 @@ void Integrator::computeNetForce(uint64_t timestep)
     }
 
 #ifdef ENABLE_HIP
+/** @param timestep Current time step of the simulation
+
+    With concurrent forces enabled on a single GPU, the force computes that support streams are launched on their own
+    streams so that their kernels can overlap. The streams are created with the default flags, so they wait for all
+    previous work on the default stream, such as the integration of the positions, the ghost update, and the
+    neighbor list update. The force computes are launched in this order:
+
+    1. Computes that launch on the default stream.
+    2. Computes that update inputs on the default stream, e.g. the neighbor list, before they launch their kernels.
+    3. All other computes.
+
+    Work on the default stream waits for the kernels running on the other streams, so this order keeps the default
+    stream idle while the kernels of the last group run. The default stream then waits on an event recorded on every
+    stream before the net force is summed.
+*/
+void Integrator::computeForcesGPU(uint64_t timestep)
+    {
+    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
+
+    if (!m_concurrent_forces || m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
+            (*force_compute)->compute(timestep);
+
+        for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
+            (*force_compute)->finishCompute(timestep);
+        return;
+        }
+
+    // sort the force computes into the launch groups
+    std::vector< std::shared_ptr<ForceCompute> > default_stream;
+    std::vector< std::shared_ptr<ForceCompute> > streams_with_inputs;
+    std::vector< std::shared_ptr<ForceCompute> > streams;
+    for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
+        {
+        if (!(*force_compute)->supportsStream())
+            default_stream.push_back(*force_compute);
+        else if ((*force_compute)->updatesInputsOnDefaultStream())
+            streams_with_inputs.push_back(*force_compute);
+        else
+            streams.push_back(*force_compute);
+        }
+    streams.insert(streams.begin(), streams_with_inputs.begin(), streams_with_inputs.end());
+
+    // create one stream per concurrent force compute
+    while (m_force_streams.size() < streams.size())
+        {
+        hipStream_t stream;
+        hipEvent_t event;
+        hipStreamCreate(&stream);
+        hipEventCreateWithFlags(&event, hipEventDisableTiming);
+        m_force_streams.push_back(stream);
+        m_force_events.push_back(event);
+        }
+
+    for (force_compute = default_stream.begin(); force_compute != default_stream.end(); ++force_compute)
+        (*force_compute)->compute(timestep);
+
+    for (unsigned int i = 0; i < streams.size(); ++i)
+        {
+        streams[i]->setStream(m_force_streams[i]);
+        streams[i]->compute(timestep);
+        streams[i]->setStream(0);
+        }
+
+    // join the streams before the forces are read
+    for (unsigned int i = 0; i < streams.size(); ++i)
+        {
+        hipEventRecord(m_force_events[i], m_force_streams[i]);
+        hipStreamWaitEvent(0, m_force_events[i], 0);
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    for (force_compute = m_active_forces.begin(); force_compute != m_active_forces.end(); ++force_compute)
+        (*force_compute)->finishCompute(timestep);
+    }
+
 /** @param timestep Current time step of the simulation
     \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
     \note The summation step is performed <b>on the GPU</b>.
@@ -499,10 +636,17 @@ void Integrator::computeNetForceGPU(uint64_t timestep)
 
     // compute all the normal forces first
 
+    updateActiveForces(timestep);
+
+    computeForcesGPU(timestep);
+
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
 
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    #ifdef ENABLE_MPI
+    // if no force completed an overlapped ghost update, complete it now
+    if (m_comm)
+        m_comm->completeGhostUpdate(timestep);
+    #endif
 
     if (m_prof)
         {
@@ -539,7 +683,7 @@ void Integrator::computeNetForceGPU(uint64_t timestep)
         // there is no need to zero out the initial net force and virial here, the first call to the addition kernel
         // will do that
         // ahh!, but we do need to zer out the net force and virial if there are 0 forces!
-        if (m_forces.size() == 0)
+        if (m_active_forces.size() == 0)
             {
             // start by zeroing the net force and virial arrays
             hipMemset(d_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
@@ -552,86 +696,92 @@ void Integrator::computeNetForceGPU(uint64_t timestep)
         // now, add up the accelerations
         // sum all the forces into the net force
         // perform the sum in groups of 6 to avoid kernel launch and memory access overheads
-        for (unsigned int cur_force = 0; cur_force < m_forces.size(); cur_force += 6)
+        for (unsigned int cur_force = 0; cur_force < m_active_forces.size(); cur_force += 6)
             {
             // grab the device pointers for the current set
             gpu_force_list force_list;
 
-            const GlobalArray<Scalar4>& d_force_array0 = m_forces[cur_force]->getForceArray();
+            const GlobalArray<Scalar4>& d_force_array0 = m_active_forces[cur_force]->getForceArray();
             ArrayHandle<Scalar4> d_force0(d_force_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar>& d_virial_array0 = m_forces[cur_force]->getVirialArray();
+            const GlobalArray<Scalar>& d_virial_array0 = m_active_forces[cur_force]->getVirialArray();
             ArrayHandle<Scalar> d_virial0(d_virial_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar4>& d_torque_array0 = m_forces[cur_force]->getTorqueArray();
+            const GlobalArray<Scalar4>& d_torque_array0 = m_active_forces[cur_force]->getTorqueArray();
             ArrayHandle<Scalar4> d_torque0(d_torque_array0,access_location::device,access_mode::read);
             force_list.f0 = d_force0.data;
             force_list.v0 = d_virial0.data;
             force_list.vpitch0 = d_virial_array0.getPitch();
             force_list.t0 = d_torque0.data;
+            force_list.s0 = Scalar(m_active_forces[cur_force]->getRESPAPeriod());
 
-            if (cur_force+1 < m_forces.size())
+            if (cur_force+1 < m_active_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array1 = m_forces[cur_force+1]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array1 = m_active_forces[cur_force+1]->getForceArray();
                 ArrayHandle<Scalar4> d_force1(d_force_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array1 = m_forces[cur_force+1]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array1 = m_active_forces[cur_force+1]->getVirialArray();
                 ArrayHandle<Scalar> d_virial1(d_virial_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array1 = m_forces[cur_force+1]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array1 = m_active_forces[cur_force+1]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque1(d_torque_array1,access_location::device,access_mode::read);
                 force_list.f1 = d_force1.data;
                 force_list.v1 = d_virial1.data;
                 force_list.vpitch1 = d_virial_array1.getPitch();
                 force_list.t1 = d_torque1.data;
+                force_list.s1 = Scalar(m_active_forces[cur_force+1]->getRESPAPeriod());
                 }
-            if (cur_force+2 < m_forces.size())
+            if (cur_force+2 < m_active_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array2 = m_forces[cur_force+2]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array2 = m_active_forces[cur_force+2]->getForceArray();
                 ArrayHandle<Scalar4> d_force2(d_force_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array2 = m_forces[cur_force+2]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array2 = m_active_forces[cur_force+2]->getVirialArray();
                 ArrayHandle<Scalar> d_virial2(d_virial_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array2 = m_forces[cur_force+2]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array2 = m_active_forces[cur_force+2]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque2(d_torque_array2,access_location::device,access_mode::read);
                 force_list.f2 = d_force2.data;
                 force_list.v2 = d_virial2.data;
                 force_list.vpitch2 = d_virial_array2.getPitch();
                 force_list.t2 = d_torque2.data;
+                force_list.s2 = Scalar(m_active_forces[cur_force+2]->getRESPAPeriod());
                 }
-            if (cur_force+3 < m_forces.size())
+            if (cur_force+3 < m_active_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array3 = m_forces[cur_force+3]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array3 = m_active_forces[cur_force+3]->getForceArray();
                 ArrayHandle<Scalar4> d_force3(d_force_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array3 = m_forces[cur_force+3]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array3 = m_active_forces[cur_force+3]->getVirialArray();
                 ArrayHandle<Scalar> d_virial3(d_virial_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array3 = m_forces[cur_force+3]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array3 = m_active_forces[cur_force+3]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque3(d_torque_array3,access_location::device,access_mode::read);
                 force_list.f3 = d_force3.data;
                 force_list.v3 = d_virial3.data;
                 force_list.vpitch3 = d_virial_array3.getPitch();
                 force_list.t3 = d_torque3.data;
+                force_list.s3 = Scalar(m_active_forces[cur_force+3]->getRESPAPeriod());
                 }
-            if (cur_force+4 < m_forces.size())
+            if (cur_force+4 < m_active_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array4 = m_forces[cur_force+4]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array4 = m_active_forces[cur_force+4]->getForceArray();
                 ArrayHandle<Scalar4> d_force4(d_force_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array4 = m_forces[cur_force+4]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array4 = m_active_forces[cur_force+4]->getVirialArray();
                 ArrayHandle<Scalar> d_virial4(d_virial_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array4 = m_forces[cur_force+4]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array4 = m_active_forces[cur_force+4]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque4(d_torque_array4,access_location::device,access_mode::read);
                 force_list.f4 = d_force4.data;
                 force_list.v4 = d_virial4.data;
                 force_list.vpitch4 = d_virial_array4.getPitch();
                 force_list.t4 = d_torque4.data;
+                force_list.s4 = Scalar(m_active_forces[cur_force+4]->getRESPAPeriod());
                 }
-            if (cur_force+5 < m_forces.size())
+            if (cur_force+5 < m_active_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array5 = m_forces[cur_force+5]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array5 = m_active_forces[cur_force+5]->getForceArray();
                 ArrayHandle<Scalar4> d_force5(d_force_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array5 = m_forces[cur_force+5]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array5 = m_active_forces[cur_force+5]->getVirialArray();
                 ArrayHandle<Scalar> d_virial5(d_virial_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array5 = m_forces[cur_force+5]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array5 = m_active_forces[cur_force+5]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque5(d_torque_array5,access_location::device,access_mode::read);
                 force_list.f5 = d_force5.data;
                 force_list.v5 = d_virial5.data;
                 force_list.vpitch5 = d_virial_array5.getPitch();
                 force_list.t5 = d_torque5.data;
+                force_list.s5 = Scalar(m_active_forces[cur_force+5]->getRESPAPeriod());
                 }
 
             // clear on the first iteration only
@@ -660,11 +810,11 @@ void Integrator::computeNetForceGPU(uint64_t timestep)
         }
 
     // add up external virials and energies
-    for (unsigned int cur_force = 0; cur_force < m_forces.size(); cur_force ++)
+    for (unsigned int cur_force = 0; cur_force < m_active_forces.size(); cur_force ++)
         {
         for (unsigned int k = 0; k < 6; k++)
-            external_virial[k] += m_forces[cur_force]->getExternalVirial(k);
-        external_energy += m_forces[cur_force]->getExternalEnergy();
+            external_virial[k] += m_active_forces[cur_force]->getExternalVirial(k);
+        external_energy += m_active_forces[cur_force]->getExternalEnergy();
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -800,7 +950,7 @@ void Integrator::computeNetForceGPU(uint64_t timestep)
                 }
 
             // clear only on the first iteration AND if there are zero forces
-            bool clear = (cur_force == 0) && (m_forces.size() == 0);
+            bool clear = (cur_force == 0) && (m_active_forces.size() == 0);
 
             // access flags
             PDataFlags flags = this->m_pdata->getFlags();
@@ -945,5 +1095,6 @@ void export_Integrator(py::module& m)
     .def_property("dt", &Integrator::getDeltaT, &Integrator::setDeltaT)
 	.def_property_readonly("forces", &Integrator::getForces)
 	.def_property_readonly("constraints", &Integrator::getConstraintForces)
+    .def_property("concurrent_forces", &Integrator::getConcurrentForces, &Integrator::setConcurrentForces)
     ;
     }
@@ -143,6 +143,18 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// Prepare for the run
         virtual void prepRun(uint64_t timestep);
 
+        /// Set whether force computes run concurrently on separate streams on the GPU
+        void setConcurrentForces(bool concurrent)
+            {
+            m_concurrent_forces = concurrent;
+            }
+
+        /// Get whether force computes run concurrently on separate streams on the GPU
+        bool getConcurrentForces() const
+            {
+            return m_concurrent_forces;
+            }
+
         #ifdef ENABLE_MPI
         /// Set the communicator to use
         /** @param comm The Communicator
@@ -160,15 +172,35 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// List of all the force computes
         std::vector< std::shared_ptr<ForceCompute> > m_forces;
 
+        /// Force computes evaluated on the current time step
+        std::vector< std::shared_ptr<ForceCompute> > m_active_forces;
+
         /// List of all the constraints
         std::vector< std::shared_ptr<ForceConstraint> > m_constraint_forces;
 
         /// The HalfStepHook, if active
         std::shared_ptr<HalfStepHook> m_half_step_hook;
 
+        /// True if force computes run concurrently on separate streams on the GPU
+        bool m_concurrent_forces = false;
+
+#ifdef ENABLE_HIP
+        /// Streams for the concurrent force computes
+        std::vector<hipStream_t> m_force_streams;
+
+        /// Events to join the force streams before the net force is summed
+        std::vector<hipEvent_t> m_force_events;
+
+        /// helper function to compute the forces on the GPU, concurrently if enabled
+        void computeForcesGPU(uint64_t timestep);
+#endif
+
         /// helper function to compute initial accelerations
         void computeAccelerations(uint64_t timestep);
 
+        /// helper function to select the force computes that are evaluated on a time step
+        void updateActiveForces(uint64_t timestep);
+
         /// helper function to compute net force/virial
         void computeNetForce(uint64_t timestep);
 
@@ -35,7 +35,9 @@ LoadBalancer::LoadBalancer(std::shared_ptr<SystemDefinition> sysdef,
           m_mpi_comm(m_exec_conf->getMPICommunicator()), m_max_imbalance(Scalar(1.0)),
           m_recompute_max_imbalance(true), m_needs_migrate(false),
           m_needs_recount(false), m_tolerance(Scalar(1.05)), m_maxiter(1),
-          m_max_scale(Scalar(0.05)), m_N_own(m_pdata->getN()),
+          m_max_scale(Scalar(0.05)), m_time_weighted(false), m_damping(Scalar(0.5)), m_cost(Scalar(1.0)),
+          m_total_load(Scalar(m_pdata->getNGlobal())), m_have_cost(false), m_last_time(-1), m_last_comm_time(0),
+          m_N_own(m_pdata->getN()),
           m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
           m_n_iterations(0), m_n_rebalances(0)
     {
@@ -66,6 +68,16 @@ void LoadBalancer::update(uint64_t timestep)
 
     if (m_prof) m_prof->push(m_exec_conf, "balance");
 
+    // update the cost per particle from the time since the last call
+    measureCost();
+
+    // particles left outside of their domains by a deferred migration would be counted on the wrong rank
+    if (m_comm->hasDeferredMigration())
+        {
+        m_comm->forceMigrate();
+        m_comm->communicate(timestep);
+        }
+
     // no adjustment has been made yet, so set m_N_own to the number of particles on the rank
     resetNOwn(m_pdata->getN());
 
@@ -115,10 +127,10 @@ void LoadBalancer::update(uint64_t timestep)
                 min_frac_i = min_domain_frac.z;
                 }
 
-            vector<unsigned int> N_i;
+            vector<Scalar> N_i;
             bool adjusted = false;
 
-            // reduce the number of particles in the slice along dim
+            // reduce the load in the slice along dim
             bool active = reduce(N_i, dim, reduce_root);
 
             // attempt an adjustment
@@ -153,17 +165,75 @@ void LoadBalancer::update(uint64_t timestep)
             }
         }
 
+    // start the next measurement after balancing so that the migration is not included
+    if (m_time_weighted)
+        {
+        m_last_time = m_clk.getTime();
+        m_last_comm_time = m_comm->getCommunicationTime();
+        }
+
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
 /*!
- * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks.
+ * The cost per particle is the wall clock time the rank spent outside of communication since the end of the last
+ * update, divided by the number of particles it owns. It is normalized by the average cost per particle of all ranks,
+ * and ranks without particles are assigned the average. The normalized cost c is then mixed into the estimate with
+ * the damping factor d as c' = (1-d) c' + d c.
+ *
+ * No measurement is made on the first call after time weighting is enabled, and the particles keep the weight 1.
+ *
+ * \note All ranks must call measureCost() since it involves a collective reduction.
+ */
+void LoadBalancer::measureCost()
+    {
+    if (!m_time_weighted)
+        {
+        m_cost = Scalar(1.0);
+        m_total_load = Scalar(m_pdata->getNGlobal());
+        return;
+        }
+
+    // nothing to measure until a previous update has started the clock
+    if (m_last_time < 0)
+        return;
+
+    const int64_t comm_time = m_comm->getCommunicationTime() - m_last_comm_time;
+    double compute_time = double(m_clk.getTime() - m_last_time - comm_time);
+    if (compute_time < 0.0)
+        compute_time = 0.0;
+
+    double total_compute_time(0.0);
+    MPI_Allreduce(&compute_time, &total_compute_time, 1, MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+    if (!(total_compute_time > 0.0))
+        return;
+
+    const double avg_cost = total_compute_time / double(m_pdata->getNGlobal());
+    const unsigned int N = m_pdata->getN();
+    const Scalar cost = (N > 0) ? Scalar(compute_time / double(N) / avg_cost) : Scalar(1.0);
+
+    if (m_have_cost)
+        m_cost = (Scalar(1.0) - m_damping) * m_cost + m_damping * cost;
+    else
+        m_cost = cost;
+    m_have_cost = true;
+    m_recompute_max_imbalance = true;
+    }
+
+/*!
+ * Computes the imbalance factor I = L / <L> for each rank, and computes the maximum among all ranks. The load L is the
+ * number of owned particles weighted by the cost per particle of the rank, so that I = N / <N> without time weighting.
  */
 Scalar LoadBalancer::getMaxImbalance()
     {
     if (m_recompute_max_imbalance)
         {
-        Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+        Scalar cur_load = getLoad();
+        if (m_time_weighted)
+            {
+            MPI_Allreduce(&cur_load, &m_total_load, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_mpi_comm);
+            }
+        Scalar cur_imb = cur_load / (m_total_load / Scalar(m_exec_conf->getNRanks()));
         Scalar max_imb(0.0);
         MPI_Allreduce(&cur_imb, &max_imb, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
 
@@ -178,12 +248,12 @@ Scalar LoadBalancer::getMaxImbalance()
     }
 
 /*!
- * \param N_i Vector holding the total number of particles in each slice (will be allocated on call)
+ * \param N_i Vector holding the total load in each slice (will be allocated on call)
  * \param dim The dimension of the slices (x=0, y=1, z=2)
  * \param reduce_root The rank to perform the reduction on
  * \returns true if the current rank holds the active \a N_i
  *
- * \post \a N_i holds the number of particles in each slice along \a dim
+ * \post \a N_i holds the load (weighted number of particles) in each slice along \a dim
  *
  * \note reduce() relies on collective MPI calls, and so all ranks must call it. However, for efficiency the data will
  *       be active only on Cartesian rank \a reduce_root, as indicated by the return value. As a result, only \a reduce_root
@@ -194,18 +264,18 @@ Scalar LoadBalancer::getMaxImbalance()
  * down dimensions. Generally, load balancing should not be performed too frequently, and so we do not pursue this
  * optimization right now.
  */
-bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root)
+bool LoadBalancer::reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root)
     {
     // do nothing if there is only one rank
     if (N_i.size() == 1) return false;
 
     const Index3D& di = m_decomposition->getDomainIndexer();
-    std::vector<unsigned int> N_per_rank(di.getNumElements());
+    std::vector<Scalar> N_per_rank(di.getNumElements());
 
-    // get the number of particles the current rank owns (the quantity to be reduced)
-    unsigned int N_own = getNOwn();
+    // get the load of the current rank (the quantity to be reduced)
+    Scalar load = getLoad();
 
-    MPI_Gather(&N_own, 1, MPI_UNSIGNED, &N_per_rank[0], 1, MPI_UNSIGNED, reduce_root, m_mpi_comm);
+    MPI_Gather(&load, 1, MPI_HOOMD_SCALAR, &N_per_rank[0], 1, MPI_HOOMD_SCALAR, reduce_root, m_mpi_comm);
 
     // only the root rank performs the reduction
     if (m_exec_conf->getRank() != reduce_root)
@@ -213,7 +283,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
     // rearrange the data from ranks to cartesian order in case it is jumbled around
     ArrayHandle<unsigned int> h_cart_ranks_inv(m_decomposition->getInverseCartRanks(), access_location::host, access_mode::read);
-    std::vector<unsigned int> N_per_cart_rank(di.getNumElements());
+    std::vector<Scalar> N_per_cart_rank(di.getNumElements());
     for (unsigned int cur_rank=0; cur_rank < di.getNumElements(); ++cur_rank)
         {
         N_per_cart_rank[h_cart_ranks_inv.data[cur_rank]] = N_per_rank[cur_rank];
@@ -225,7 +295,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
         N_i.clear(); N_i.resize(di.getW());
         for (unsigned int i=0; i < di.getW(); ++i)
             {
-            N_i[i] = 0;
+            N_i[i] = Scalar(0.0);
             for (unsigned int k=0; k < di.getD(); ++k)
                 {
                 for (unsigned int j=0; j < di.getH(); ++j)
@@ -240,7 +310,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
         N_i.clear(); N_i.resize(di.getH());
         for (unsigned int j=0; j < di.getH(); ++j)
             {
-            N_i[j] = 0;
+            N_i[j] = Scalar(0.0);
             for (unsigned int k=0; k < di.getD(); ++k)
                 {
                 for (unsigned int i=0; i < di.getW(); ++i)
@@ -255,7 +325,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
         N_i.clear(); N_i.resize(di.getD());
         for (unsigned int k=0; k < di.getD(); ++k)
             {
-            N_i[k] = 0;
+            N_i[k] = Scalar(0.0);
             for (unsigned int j=0; j < di.getH(); ++j)
                 {
                 for (unsigned int i=0; i < di.getW(); ++i)
@@ -276,7 +346,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
 /*!
  * \param cum_frac_i The cumulative fraction array to write output into
- * \param N_i The reduced number of particles along the dimension
+ * \param N_i The reduced load along the dimension
  * \param L_i The global box length along the dimension
  * \param min_frac_i The minimum fractional width of a domain
  *
@@ -294,15 +364,15 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
  *     successful, apply the adjustment to \a cum_frac_i.
  */
 bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
-                          const vector<unsigned int>& N_i,
+                          const vector<Scalar>& N_i,
                           Scalar L_i,
                           Scalar min_frac_i)
     {
     if (N_i.size() == 1)
         return false;
 
-    // target particles per rank is uniform distribution
-    const Scalar target = Scalar(m_pdata->getNGlobal()) / Scalar(N_i.size());
+    // target load per rank is uniform distribution
+    const Scalar target = std::accumulate(N_i.begin(), N_i.end(), Scalar(0.0)) / Scalar(N_i.size());
 
     // make the minimum domain slightly bigger so that the optimization won't fail at equality
     const Scalar min_domain_size = Scalar(1.00001) * min_frac_i * L_i;
@@ -317,7 +387,7 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     for (unsigned int i=0; i < N_i.size(); ++i)
         {
         const Scalar imb_factor = Scalar(N_i[i]) / target;
-        Scalar scale_factor = (N_i[i] > 0) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
+        Scalar scale_factor = (N_i[i] > Scalar(0.0)) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
 
         // limit rescaling to 5% either direction
         // we should use absolute distance here, it is necessary to control balancing in corrugated systems
@@ -570,6 +640,8 @@ void export_LoadBalancer(py::module& m)
     .def_property("x", &LoadBalancer::getEnableX, &LoadBalancer::setEnableX)
     .def_property("y", &LoadBalancer::getEnableY, &LoadBalancer::setEnableY)
     .def_property("z", &LoadBalancer::getEnableZ, &LoadBalancer::setEnableZ)
+    .def_property("time_weighted", &LoadBalancer::getTimeWeighted, &LoadBalancer::setTimeWeighted)
+    .def_property("damping", &LoadBalancer::getDamping, &LoadBalancer::setDamping)
     ;
     }
 #endif // ENABLE_MPI
@@ -18,6 +18,7 @@
 #define __LOADBALANCER_H__
 #include "Tuner.h"
 #include "Trigger.h"
+#include "ClockSource.h"
 
 #include <memory>
 #include <pybind11/pybind11.h>
@@ -41,6 +42,11 @@
  * Constraints are satisfied by solving a least-squares problem with box constraints, where the cost function is the
  * deviation of the domain sizes from the proposed rescaled width.
  *
+ * When time weighting is enabled, each particle is weighted by the measured cost of a particle on its rank instead of
+ * counting all particles equally. The cost is the wall clock time the rank spent outside of communication since the
+ * last update, divided by the number of particles it owned. The estimate is damped by mixing only a fraction of each
+ * new measurement into the previous one, so that noise in the timings does not make the domains oscillate.
+ *
  * \ingroup updaters
  */
 class PYBIND11_EXPORT LoadBalancer : public Tuner
@@ -102,6 +108,48 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
                 }
             }
 
+        //! Get whether particles are weighted by the measured cost per particle
+        bool getTimeWeighted() const
+            {
+            return m_time_weighted;
+            }
+
+        //! Set whether particles are weighted by the measured cost per particle
+        /*!
+         * \param time_weighted Flag to balance the measured time (true) or the number of particles (false)
+         */
+        void setTimeWeighted(bool time_weighted)
+            {
+            if (time_weighted != m_time_weighted)
+                {
+                m_time_weighted = time_weighted;
+                m_cost = Scalar(1.0);
+                m_have_cost = false;
+                m_last_time = -1;
+                m_recompute_max_imbalance = true;
+                }
+            }
+
+        //! Get the damping of the measured cost per particle
+        Scalar getDamping() const
+            {
+            return m_damping;
+            }
+
+        //! Set the damping of the measured cost per particle
+        /*!
+         * \param damping Fraction of a new measurement mixed into the cost estimate (0 < damping <= 1)
+         */
+        void setDamping(Scalar damping)
+            {
+            if (!(damping > Scalar(0.0) && damping <= Scalar(1.0)))
+                {
+                m_exec_conf->msg->error() << "comm.balance: damping must be in (0,1]" << std::endl;
+                throw std::runtime_error("comm.balance: damping must be in (0,1]");
+                }
+            m_damping = damping;
+            }
+
         /// Set m_enable_x
         void setEnableX(bool enable) {m_enable_x = enable;}
 
@@ -137,8 +185,8 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
         Scalar m_max_imbalance;             //!< Maximum imbalance
         bool m_recompute_max_imbalance;     //!< Flag if maximum imbalance needs to be computed
 
-        //! Reduce the particle numbers per rank down to one dimension
-        bool reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root);
+        //! Reduce the loads per rank down to one dimension
+        bool reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root);
 
         //! Set flags within the class that a resize has been performed
         void signalResize()
@@ -150,7 +198,7 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
 
         //! Adjust the partitioning along a single dimension
         bool adjust(std::vector<Scalar>& cum_frac_i,
-                    const std::vector<unsigned int>& N_i,
+                    const std::vector<Scalar>& N_i,
                     Scalar L_i,
                     Scalar min_domain_frac);
         bool m_needs_migrate;   //!< Flag to signal that migration is necessary
@@ -180,6 +228,15 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
             }
         bool m_needs_recount;   //!< Flag if a particle change needs to be computed
 
+        //! Gets the load of the rank, which is the number of owned particles weighted by their cost
+        Scalar getLoad()
+            {
+            return Scalar(getNOwn()) * m_cost;
+            }
+
+        //! Measure the cost per particle since the last update
+        void measureCost();
+
         Scalar m_tolerance;     //!< Load imbalance to tolerate
         unsigned int m_maxiter; //!< Maximum number of iterations to attempt
         bool m_enable_x;        //!< Flag to enable balancing in x
@@ -188,6 +245,15 @@ class PYBIND11_EXPORT LoadBalancer : public Tuner
 
         const Scalar m_max_scale;   //!< Maximum fraction to rescale either direction (5%)
 
+        bool m_time_weighted;       //!< Flag to weight particles by the measured cost
+        Scalar m_damping;           //!< Fraction of a new measurement mixed into the cost
+        Scalar m_cost;              //!< Cost per particle on this rank (1 when not time weighted)
+        Scalar m_total_load;        //!< Total load of all ranks
+        bool m_have_cost;           //!< Flag if m_cost holds a measurement
+        ClockSource m_clk;          //!< Clock to measure the time between updates
+        int64_t m_last_time;        //!< Clock time at the end of the last update
+        int64_t m_last_comm_time;   //!< Communication time at the end of the last update
+
     private:
         unsigned int m_N_own;               //!< Number of particles owned by this rank
 
@@ -0,0 +1,108 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogBatch.cc
+    \brief Defines the LogBatch class
+*/
+
+#include "LogBatch.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <pybind11/stl.h>
+
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param exec_conf Execution configuration, its MPI communicator is used for the reduction
+*/
+LogBatch::LogBatch(std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    : m_exec_conf(exec_conf)
+    {
+    }
+
+/*! \param compute Compute providing the quantity
+    \param name Name of the quantity
+*/
+void LogBatch::addCompute(std::shared_ptr<Compute> compute, const std::string& name)
+    {
+    add(compute, compute->getLogRegistry(), name);
+    }
+
+/*! \param updater Updater providing the quantity
+    \param name Name of the quantity
+*/
+void LogBatch::addUpdater(std::shared_ptr<Updater> updater, const std::string& name)
+    {
+    add(updater, updater->getLogRegistry(), name);
+    }
+
+/*! \param system System providing the quantity
+    \param name Name of the quantity
+*/
+void LogBatch::addSystem(std::shared_ptr<System> system, const std::string& name)
+    {
+    add(system, system->getLogRegistry(), name);
+    }
+
+void LogBatch::add(std::shared_ptr<void> owner, const LogRegistry& registry, const std::string& name)
+    {
+    if (!registry.hasQuantity(name))
+        {
+        m_exec_conf->msg->error() << "LogBatch: quantity " << name << " is not registered" << endl;
+        throw runtime_error("Error adding log quantity");
+        }
+
+    m_owners.push_back(owner);
+    m_quantities.push_back(registry.getQuantity(name));
+    }
+
+/*! \param timestep Current time step of the simulation
+    \returns The values of all quantities, in the order they were added
+*/
+std::vector<double> LogBatch::evaluate(uint64_t timestep)
+    {
+    std::vector<double> values(m_quantities.size());
+    std::vector<double> local_sums;
+
+    for (unsigned int i = 0; i < m_quantities.size(); i++)
+        {
+        values[i] = m_quantities[i].getter(timestep);
+        if (m_quantities[i].sum)
+            local_sums.push_back(values[i]);
+        }
+
+#ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1 && local_sums.size() > 0)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &local_sums.front(), (int)local_sums.size(), MPI_DOUBLE, MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+
+        unsigned int j = 0;
+        for (unsigned int i = 0; i < m_quantities.size(); i++)
+            {
+            if (m_quantities[i].sum)
+                values[i] = local_sums[j++];
+            }
+        }
+#endif
+
+    return values;
+    }
+
+void export_LogBatch(py::module& m)
+    {
+    py::class_<LogBatch, std::shared_ptr<LogBatch> >(m, "LogBatch")
+        .def(py::init< std::shared_ptr<ExecutionConfiguration> >())
+        .def("add", &LogBatch::addCompute)
+        .def("add", &LogBatch::addUpdater)
+        .def("add", &LogBatch::addSystem)
+        .def("isInteger", &LogBatch::isInteger)
+        .def("getNumQuantities", &LogBatch::getNumQuantities)
+        .def("evaluate", &LogBatch::evaluate)
+        ;
+    }
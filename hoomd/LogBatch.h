@@ -0,0 +1,79 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogBatch.h
+    \brief Declares the LogBatch class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __LOG_BATCH_H__
+#define __LOG_BATCH_H__
+
+#include "Compute.h"
+#include "System.h"
+#include "Updater.h"
+#include "LogRegistry.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+//! Evaluates a list of registered log quantities in one pass
+/*! hoomd.logging.Logger builds a LogBatch from the entries whose quantities are registered in the LogRegistry of
+    their compute or updater. evaluate() calls all getters, packs the local contributions of the summed quantities
+    into one buffer, reduces it with a single MPI_Allreduce, and returns the values in the order they were added.
+    Logging many quantities therefore costs one Python call and one reduction per write instead of one of each per
+    quantity.
+
+    The batch holds shared pointers to the operations, so the getters stay valid as long as the batch exists.
+
+    \ingroup utils
+*/
+class PYBIND11_EXPORT LogBatch
+    {
+    public:
+        //! Constructor
+        LogBatch(std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Add a quantity of a compute
+        void addCompute(std::shared_ptr<Compute> compute, const std::string& name);
+
+        //! Add a quantity of an updater
+        void addUpdater(std::shared_ptr<Updater> updater, const std::string& name);
+
+        //! Add a quantity of the system
+        void addSystem(std::shared_ptr<System> system, const std::string& name);
+
+        //! Get the number of quantities
+        unsigned int getNumQuantities() const
+            {
+            return (unsigned int)m_quantities.size();
+            }
+
+        //! Test if a quantity is an integer
+        bool isInteger(unsigned int i) const
+            {
+            return m_quantities.at(i).integer;
+            }
+
+        //! Evaluate all quantities
+        std::vector<double> evaluate(uint64_t timestep);
+
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< Execution configuration
+        std::vector< std::shared_ptr<void> > m_owners;              //!< Keep the operations alive
+        std::vector<LogRegistry::Quantity> m_quantities;            //!< Quantities in the order they were added
+
+        //! Add a quantity of a registry
+        void add(std::shared_ptr<void> owner, const LogRegistry& registry, const std::string& name);
+    };
+
+//! Exports LogBatch to python
+void export_LogBatch(pybind11::module& m);
+
+#endif
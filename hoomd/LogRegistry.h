@@ -0,0 +1,82 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogRegistry.h
+    \brief Declares the LogRegistry class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __LOG_REGISTRY_H__
+#define __LOG_REGISTRY_H__
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+//! Scalar log quantities that an operation provides to LogBatch
+/*! Computes, forces, and updaters register a getter for each scalar quantity that they also provide as a loggable
+    property in Python, under the same name. hoomd.logging.Logger evaluates the registered quantities of all its
+    entries with one LogBatch, which calls the getters in C++ and reduces all summed quantities in a single
+    MPI_Allreduce.
+
+    A getter either returns the value of the quantity on all ranks, or, when registered with \a sum set, the
+    contribution of the local rank. LogBatch sums the latter over all ranks.
+
+    \ingroup utils
+*/
+class LogRegistry
+    {
+    public:
+        //! Getter of a quantity, takes the current timestep
+        typedef std::function<double(uint64_t)> Getter;
+
+        //! A registered quantity
+        struct Quantity
+            {
+            Getter getter;      //!< Returns the value, or the local contribution to it
+            bool sum;           //!< True if the getter returns the local contribution
+            bool integer;       //!< True if the quantity is an integer
+            };
+
+        //! Register a quantity
+        /*! \param name Name of the quantity, the same as the loggable property in Python
+            \param getter Function returning the value
+            \param sum True if \a getter returns the contribution of the local rank
+            \param integer True if the quantity is an integer, such as a timestep
+        */
+        void registerQuantity(const std::string& name, Getter getter, bool sum = false, bool integer = false)
+            {
+            m_quantities[name] = Quantity{getter, sum, integer};
+            }
+
+        //! Test if a quantity is registered
+        bool hasQuantity(const std::string& name) const
+            {
+            return m_quantities.find(name) != m_quantities.end();
+            }
+
+        //! Get a registered quantity
+        const Quantity& getQuantity(const std::string& name) const
+            {
+            return m_quantities.at(name);
+            }
+
+        //! Get the names of all registered quantities
+        std::vector<std::string> getNames() const
+            {
+            std::vector<std::string> names;
+            for (const auto& q : m_quantities)
+                names.push_back(q.first);
+            return names;
+            }
+
+    private:
+        std::map<std::string, Quantity> m_quantities;   //!< Registered quantities by name
+    };
+
+#endif
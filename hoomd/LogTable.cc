@@ -0,0 +1,222 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogTable.cc
+    \brief Defines the LogTable class
+*/
+
+#include "LogTable.h"
+
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <errno.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+namespace py = pybind11;
+
+namespace
+    {
+//! Initial capacity of the output buffer
+const size_t initial_buffer_size = 64*1024;
+
+//! Maximum number of decimals in pretty output
+const int max_decimals_pretty = 5;
+    }
+
+/*! \param sysdef System definition
+    \param batch Quantities to write, one column each
+    \param fd File descriptor to write to, it remains owned by the caller
+    \param headers Column headers
+    \param write_header Write the header line before the first row
+    \param delimiter Delimiter between columns
+    \param pretty Limit the number of decimals for readability
+    \param max_precision Maximum number of significant digits when not \a pretty
+    \param min_column_width Minimum width of a column
+    \param rows_per_flush Number of rows to buffer before writing them to \a fd
+*/
+LogTable::LogTable(std::shared_ptr<SystemDefinition> sysdef,
+                   std::shared_ptr<LogBatch> batch,
+                   int fd,
+                   const std::vector<std::string>& headers,
+                   bool write_header,
+                   const std::string& delimiter,
+                   bool pretty,
+                   unsigned int max_precision,
+                   unsigned int min_column_width,
+                   unsigned int rows_per_flush)
+    : Analyzer(sysdef), m_batch(batch), m_fd(fd), m_delimiter(delimiter), m_pretty(pretty),
+      m_precision(max_precision > 0 ? max_precision - 1 : 0), m_rows_per_flush(std::max(rows_per_flush, 1u)),
+      m_num_buffered_rows(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing LogTable" << endl;
+
+    if (headers.size() != m_batch->getNumQuantities())
+        {
+        m_exec_conf->msg->error() << "LogTable: " << headers.size() << " headers given for "
+                                  << m_batch->getNumQuantities() << " quantities" << endl;
+        throw runtime_error("Error initializing LogTable");
+        }
+
+    for (const auto& header : headers)
+        m_widths.push_back(std::max((unsigned int)header.size(), min_column_width));
+
+    m_buffer.reserve(initial_buffer_size);
+
+    if (write_header && m_exec_conf->getRank() == 0)
+        {
+        for (unsigned int i = 0; i < headers.size(); i++)
+            {
+            if (i > 0)
+                m_buffer += m_delimiter;
+            appendCentered(headers[i].c_str(), (unsigned int)headers[i].size(), m_widths[i]);
+            }
+        m_buffer += '\n';
+        }
+    }
+
+LogTable::~LogTable()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying LogTable" << endl;
+    try
+        {
+        flush();
+        }
+    catch (const std::exception&)
+        {
+        // the error has already been reported
+        }
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    All ranks evaluate the batch, the root rank appends the row to the buffer and writes the buffer every
+    m_rows_per_flush rows.
+*/
+void LogTable::analyze(uint64_t timestep)
+    {
+    if (m_prof) m_prof->push("LogTable");
+
+    std::vector<double> values = m_batch->evaluate(timestep);
+
+    if (m_exec_conf->getRank() == 0)
+        {
+        for (unsigned int i = 0; i < values.size(); i++)
+            {
+            if (i > 0)
+                m_buffer += m_delimiter;
+            appendNumber(values[i], m_batch->isInteger(i), m_widths[i]);
+            }
+        m_buffer += '\n';
+        m_num_buffered_rows++;
+
+        if (m_num_buffered_rows >= m_rows_per_flush)
+            flush();
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+void LogTable::flush()
+    {
+    size_t offset = 0;
+    while (offset < m_buffer.size())
+        {
+        ssize_t n = ::write(m_fd, m_buffer.data() + offset, m_buffer.size() - offset);
+        if (n < 0)
+            {
+            if (errno == EINTR)
+                continue;
+
+            m_exec_conf->msg->error() << "write.table: I/O error while writing: " << strerror(errno) << endl;
+            m_buffer.clear();
+            m_num_buffered_rows = 0;
+            throw runtime_error("Error writing table");
+            }
+        offset += n;
+        }
+
+    m_buffer.clear();
+    m_num_buffered_rows = 0;
+    }
+
+/*! \param str String to append
+    \param len Length of \a str
+    \param width Width of the column
+
+    Pads like Python's '^' alignment: the extra space goes to the right.
+*/
+void LogTable::appendCentered(const char *str, unsigned int len, unsigned int width)
+    {
+    unsigned int pad = width > len ? width - len : 0;
+    m_buffer.append(pad/2, ' ');
+    m_buffer.append(str, len);
+    m_buffer.append(pad - pad/2, ' ');
+    }
+
+/*! \param value Value to append
+    \param integer True to write the value as an integer
+    \param width Width of the column
+*/
+void LogTable::appendNumber(double value, bool integer, unsigned int width)
+    {
+    char str[512];
+    int len;
+
+    if (integer)
+        {
+        len = snprintf(str, sizeof(str), "%.0f", value);
+        }
+    else
+        {
+        // number of characters left of the decimal point, including the decimal point and sign
+        int min_len_repr = 1;
+        if (std::isfinite(value))
+            min_len_repr = int(log10(std::max(fabs(value), 1.0))) + 1;
+        if (value < 0)
+            min_len_repr += 1;
+
+        int decimals;
+        if (!(min_len_repr < 6) || min_len_repr > int(width))
+            {
+            if (m_pretty)
+                decimals = std::min(std::max(int(width) - 6, 1), max_decimals_pretty);
+            else
+                decimals = int(m_precision);
+            len = snprintf(str, sizeof(str), "%.*e", decimals, value);
+            }
+        else
+            {
+            if (m_pretty)
+                decimals = std::min(std::max(int(width) - min_len_repr - 2, 1), max_decimals_pretty);
+            else
+                decimals = std::max(int(m_precision) - min_len_repr + 1, 0);
+            len = snprintf(str, sizeof(str), "%.*f", decimals, value);
+            }
+        }
+
+    len = std::min(std::max(len, 0), int(sizeof(str)) - 1);
+    appendCentered(str, (unsigned int)len, width);
+    }
+
+void export_LogTable(py::module& m)
+    {
+    py::class_<LogTable, Analyzer, std::shared_ptr<LogTable> >(m, "LogTable")
+        .def(py::init< std::shared_ptr<SystemDefinition>,
+                       std::shared_ptr<LogBatch>,
+                       int,
+                       const std::vector<std::string>&,
+                       bool,
+                       const std::string&,
+                       bool,
+                       unsigned int,
+                       unsigned int,
+                       unsigned int >())
+        .def("flush", &LogTable::flush)
+        ;
+    }
@@ -0,0 +1,81 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogTable.h
+    \brief Declares the LogTable class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __LOG_TABLE_H__
+#define __LOG_TABLE_H__
+
+#include "Analyzer.h"
+#include "LogBatch.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+//! Writes rows of a LogBatch as a delimiter separated table
+/*! LogTable is the C++ backend of hoomd.write.Table. When all quantities of the table's logger are registered in
+    C++, the table evaluates them with a LogBatch, formats the row into an output buffer, and writes the buffer to
+    a file descriptor every \a rows_per_flush rows. Only the root rank formats and writes, all ranks take part in the
+    reduction of the batch.
+
+    The number formatting follows hoomd.write.Table: integers are written in full, floating point numbers with as
+    many decimals as fit in the column (at most 5 when \a pretty is set), switching to scientific notation when
+    the integer part is too long. All columns are centered.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT LogTable : public Analyzer
+    {
+    public:
+        //! Constructor
+        LogTable(std::shared_ptr<SystemDefinition> sysdef,
+                 std::shared_ptr<LogBatch> batch,
+                 int fd,
+                 const std::vector<std::string>& headers,
+                 bool write_header,
+                 const std::string& delimiter,
+                 bool pretty,
+                 unsigned int max_precision,
+                 unsigned int min_column_width,
+                 unsigned int rows_per_flush);
+
+        //! Destructor
+        virtual ~LogTable();
+
+        //! Write a row for the current timestep
+        virtual void analyze(uint64_t timestep);
+
+        //! Write the buffered rows to the file descriptor
+        void flush();
+
+    private:
+        std::shared_ptr<LogBatch> m_batch;      //!< Quantities to write
+        int m_fd;                               //!< File descriptor to write to (not owned)
+        std::vector<unsigned int> m_widths;     //!< Width of each column
+        std::string m_delimiter;                //!< Delimiter between columns
+        bool m_pretty;                          //!< Limit the decimals for readability
+        unsigned int m_precision;               //!< Number of significant digits when not pretty
+        unsigned int m_rows_per_flush;          //!< Number of rows to buffer before writing
+        unsigned int m_num_buffered_rows;       //!< Number of rows in the buffer
+        std::string m_buffer;                   //!< Formatted output not yet written
+
+        //! Append a string centered in a column
+        void appendCentered(const char *str, unsigned int len, unsigned int width);
+
+        //! Append a number formatted for a column
+        void appendNumber(double value, bool integer, unsigned int width);
+    };
+
+//! Exports LogTable to python
+void export_LogTable(pybind11::module& m);
+
+#endif
@@ -9,6 +9,8 @@
 #include "HOOMDMPI.h"
 #endif
 
+#include <pybind11/stl.h>
+
 #include <stdexcept>
 #include <iostream>
 #include <sstream>
@@ -92,6 +94,7 @@ void export_MPIConfiguration(pybind11::module& m)
         .def("getNRanks", &MPIConfiguration::getNRanks)
         .def("getRank", &MPIConfiguration::getRank)
         .def("barrier", &MPIConfiguration::barrier)
+        .def("allGather", &MPIConfiguration::allGather)
         .def("getNRanksGlobal", &MPIConfiguration::getNRanksGlobal)
         .def("getRankGlobal", &MPIConfiguration::getRankGlobal)
 #ifdef ENABLE_MPI
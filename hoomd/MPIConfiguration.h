@@ -21,6 +21,7 @@
 #endif
 
 #include <pybind11/pybind11.h>
+#include <vector>
 
 //! Defines the MPI configuration for the simulation
 /*! \ingroup data_structs
@@ -127,6 +128,21 @@ class PYBIND11_EXPORT MPIConfiguration
             #endif
             }
 
+        //! Gather a value from every rank in this partition on all ranks
+        /*! \param value Value of this rank
+            \returns The values of all ranks, in rank order
+        */
+        std::vector<double> allGather(double value) const
+            {
+            #ifdef ENABLE_MPI
+            std::vector<double> values(getNRanks());
+            MPI_Allgather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, m_mpi_comm);
+            return values;
+            #else
+            return std::vector<double>(1, value);
+            #endif
+            }
+
     protected:
 #ifdef ENABLE_MPI
         MPI_Comm m_mpi_comm;                   //!< The MPI communicator
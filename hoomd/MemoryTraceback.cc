@@ -142,3 +142,24 @@ void MemoryTraceback::outputTraces(std::shared_ptr<Messenger> msg) const
         free(symbols);
         }
     }
+
+void MemoryTraceback::outputPoolStatistics(std::shared_ptr<Messenger> msg, const std::string& name,
+    const MemoryPoolStatistics& stats) const
+    {
+    msg->notice(2) << "Memory pool [" << name << "]: " << pretty_bytes(stats.bytes_in_use) << " in use, "
+                   << pretty_bytes(stats.bytes_cached) << " cached, " << pretty_bytes(stats.bytes_reserved)
+                   << " reserved" << std::endl;
+    msg->notice(2) << "Memory pool [" << name << "]: high-water marks " << pretty_bytes(stats.peak_bytes_in_use)
+                   << " in use, " << pretty_bytes(stats.peak_bytes_reserved) << " reserved" << std::endl;
+    msg->notice(2) << "Memory pool [" << name << "]: " << stats.num_hits << " cache hits, " << stats.num_misses
+                   << " device allocations" << std::endl;
+    }
+
+void MemoryTraceback::outputHostMemoryStatistics(std::shared_ptr<Messenger> msg, const std::string& policy,
+    const HostMemoryStatistics& stats) const
+    {
+    msg->notice(2) << "Host memory: " << policy << std::endl;
+    msg->notice(2) << "Host memory: " << stats.num_allocations << " allocations of "
+                   << pretty_bytes(stats.bytes_allocated) << ", " << pretty_bytes(stats.bytes_huge_pages)
+                   << " on huge pages, " << pretty_bytes(stats.bytes_numa_bound) << " NUMA bound" << std::endl;
+    }
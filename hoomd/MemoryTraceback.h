@@ -12,9 +12,22 @@
 #include <map>
 
 #include "Messenger.h"
+#include "HostMemoryPolicy.h"
 
 #include <pybind11/pybind11.h>
 
+//! Allocation statistics of a memory pool
+struct MemoryPoolStatistics
+    {
+    size_t bytes_in_use = 0;            //!< Bytes in blocks handed out
+    size_t bytes_cached = 0;            //!< Bytes in free blocks kept for reuse
+    size_t bytes_reserved = 0;          //!< Bytes allocated from the device, in use or cached
+    size_t peak_bytes_in_use = 0;       //!< High-water mark of bytes_in_use
+    size_t peak_bytes_reserved = 0;     //!< High-water mark of bytes_reserved
+    unsigned long num_hits = 0;         //!< Number of requests served from the cache
+    unsigned long num_misses = 0;       //!< Number of requests that allocated from the device
+    };
+
 class PYBIND11_EXPORT MemoryTraceback
     {
     public:
@@ -35,6 +48,22 @@ class PYBIND11_EXPORT MemoryTraceback
         //! Output the list of pointers along with their stack traces
         void outputTraces(std::shared_ptr<Messenger> msg) const;
 
+        //! Output the allocation statistics and high-water marks of a memory pool
+        /*! \param msg Messenger to write to
+            \param name Name of the pool
+            \param stats Statistics of the pool
+         */
+        void outputPoolStatistics(std::shared_ptr<Messenger> msg, const std::string& name,
+            const MemoryPoolStatistics& stats) const;
+
+        //! Output the placement statistics of host memory allocations
+        /*! \param msg Messenger to write to
+            \param policy Description of the host memory policy
+            \param stats Statistics of the host allocations
+         */
+        void outputHostMemoryStatistics(std::shared_ptr<Messenger> msg, const std::string& policy,
+            const HostMemoryStatistics& stats) const;
+
         //! Update the name of an allocation
         /*! \param tag The new tag
          */
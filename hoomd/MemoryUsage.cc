@@ -0,0 +1,116 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file MemoryUsage.cc
+    \brief Defines the accounting of array memory by owning class
+*/
+
+#include "MemoryUsage.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+//! Total at which the first high-water mark is reported
+static const size_t first_report_bytes = 16*1024*1024;
+
+//! Number of owners listed in a report
+static const unsigned int num_report_owners = 5;
+
+MemoryUsage::MemoryUsage(std::shared_ptr<Messenger> msg)
+    : m_msg(msg), m_bytes(0), m_peak_bytes(0), m_next_report_bytes(first_report_bytes)
+    {
+    }
+
+void MemoryUsage::add(const std::string& owner, size_t bytes)
+    {
+    size_t report_bytes = 0;
+    std::map<std::string, MemoryUsageCounter> report_counters;
+
+        {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        MemoryUsageCounter& counter = m_counters[owner];
+        counter.bytes += bytes;
+        counter.peak_bytes = std::max(counter.peak_bytes, counter.bytes);
+        counter.num_arrays++;
+
+        m_bytes += bytes;
+        m_peak_bytes = std::max(m_peak_bytes, m_bytes);
+
+        // copy the counters only for a report, and write it after releasing the lock
+        if (m_bytes >= m_next_report_bytes)
+            {
+            report_bytes = m_bytes;
+            report_counters = m_counters;
+            m_next_report_bytes = size_t(1.25*double(m_bytes));
+            }
+        }
+
+    if (report_bytes)
+        report(report_bytes, report_counters);
+    }
+
+void MemoryUsage::remove(const std::string& owner, size_t bytes)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_counters.find(owner);
+    if (it == m_counters.end())
+        return;
+
+    MemoryUsageCounter& counter = it->second;
+    counter.bytes -= std::min(bytes, counter.bytes);
+    if (counter.num_arrays > 0)
+        counter.num_arrays--;
+    m_bytes -= std::min(bytes, m_bytes);
+    }
+
+/*! \param tag Tag of the array
+    \returns The part of \a tag before the last "::", the whole tag if there is none, or "untagged"
+*/
+std::string MemoryUsage::getOwner(const std::string& tag)
+    {
+    if (tag.empty())
+        return "untagged";
+
+    size_t pos = tag.rfind("::");
+    if (pos == std::string::npos || pos == 0)
+        return tag;
+
+    return tag.substr(0, pos);
+    }
+
+/*! \param bytes Total bytes at the high-water mark
+    \param counters Counters at the high-water mark
+*/
+void MemoryUsage::report(size_t bytes, const std::map<std::string, MemoryUsageCounter>& counters) const
+    {
+    if (!m_msg)
+        return;
+
+    std::vector< std::pair<size_t, std::string> > owners;
+    for (const auto& owner_counter : counters)
+        {
+        if (owner_counter.second.bytes > 0)
+            owners.push_back(std::make_pair(owner_counter.second.bytes, owner_counter.first));
+        }
+    std::sort(owners.begin(), owners.end(), std::greater< std::pair<size_t, std::string> >());
+
+    const double MiB = 1024.0*1024.0;
+    ostringstream s;
+    s << fixed << setprecision(1);
+    s << "Array memory high-water mark: " << double(bytes)/MiB << " MiB (";
+    for (unsigned int i = 0; i < owners.size() && i < num_report_owners; i++)
+        {
+        if (i > 0)
+            s << ", ";
+        s << owners[i].second << " " << double(owners[i].first)/MiB << " MiB";
+        }
+    if (owners.size() > num_report_owners)
+        s << ", ...";
+    s << ")";
+
+    m_msg->notice(3) << s.str() << endl;
+    }
@@ -0,0 +1,192 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file MemoryUsage.h
+    \brief Declares the accounting of array memory by owning class
+*/
+
+#pragma once
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "Messenger.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <pybind11/pybind11.h>
+
+//! Memory of the arrays of one owner
+struct MemoryUsageCounter
+    {
+    size_t bytes = 0;                   //!< Bytes of the arrays currently allocated
+    size_t peak_bytes = 0;              //!< High-water mark of bytes
+    unsigned long num_arrays = 0;       //!< Number of arrays currently allocated
+    };
+
+//! Accounts the memory of GlobalArray and GPUArray allocations by the class that owns them
+/*! MemoryTraceback records a stack trace per allocation and is only enabled for debugging. MemoryUsage is always on
+    and only keeps a byte counter per owner: each allocation, resize or free costs one map update under a mutex, and
+    array accesses cost nothing.
+
+    The owner of an array is the part of its tag before the last "::". TAG_ALLOCATION tags arrays with the name of the
+    class that allocates them, such as "NeighborList::m_nlist", so the arrays of a class are counted together. Arrays
+    without a tag count as "untagged". An array counts its size in bytes once; on the GPU, GPUArray keeps a host and
+    a device copy of that size.
+
+    Each time the total grows past 1.25 times the high-water mark reported last (and past 16 MiB), a notice at level 3
+    lists the largest owners, so that the output shows what a growing simulation spends its memory on.
+*/
+class PYBIND11_EXPORT MemoryUsage
+    {
+    public:
+        //! Constructor
+        /*! \param msg Messenger to report the high-water marks to
+        */
+        MemoryUsage(std::shared_ptr<Messenger> msg);
+
+        MemoryUsage(const MemoryUsage&) = delete;
+        MemoryUsage& operator=(const MemoryUsage&) = delete;
+
+        //! Count an allocation
+        /*! \param owner Owner of the allocation
+            \param bytes Size of the allocation
+        */
+        void add(const std::string& owner, size_t bytes);
+
+        //! Remove an allocation counted with add()
+        /*! \param owner Owner of the allocation
+            \param bytes Size of the allocation
+        */
+        void remove(const std::string& owner, size_t bytes);
+
+        //! Get the counters of all owners that allocated memory
+        std::map<std::string, MemoryUsageCounter> getCounters() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_counters;
+            }
+
+        //! Get the total bytes currently allocated
+        size_t getBytes() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_bytes;
+            }
+
+        //! Get the high-water mark of the total bytes
+        size_t getPeakBytes() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_peak_bytes;
+            }
+
+        //! Get the owner of an array from its tag
+        static std::string getOwner(const std::string& tag);
+
+    private:
+        std::shared_ptr<Messenger> m_msg;                       //!< Messenger for the high-water mark reports
+        mutable std::mutex m_mutex;                             //!< Protects the counters
+        std::map<std::string, MemoryUsageCounter> m_counters;   //!< Counters by owner
+        size_t m_bytes;                                         //!< Total bytes currently allocated
+        size_t m_peak_bytes;                                    //!< High-water mark of m_bytes
+        size_t m_next_report_bytes;                             //!< Total at which the next report is made
+
+        //! Write the largest owners to the messenger
+        void report(size_t bytes, const std::map<std::string, MemoryUsageCounter>& counters) const;
+    };
+
+namespace hoomd
+{
+namespace detail
+{
+
+//! The memory counted for one array
+/*! GlobalArray and GPUArray hold a MemoryUsageRecord and update it whenever they allocate, resize or change their tag.
+    The record removes its bytes from the MemoryUsage when it is updated or destroyed. It moves with the allocation it
+    describes, and a copy of an array starts with an empty record that its own allocation fills in.
+*/
+class MemoryUsageRecord
+    {
+    public:
+        //! Construct an empty record
+        MemoryUsageRecord()
+            : m_bytes(0)
+            { }
+
+        MemoryUsageRecord(const MemoryUsageRecord&) = delete;
+        MemoryUsageRecord& operator=(const MemoryUsageRecord&) = delete;
+
+        //! Move constructor
+        MemoryUsageRecord(MemoryUsageRecord&& other) noexcept
+            : m_usage(std::move(other.m_usage)), m_owner(std::move(other.m_owner)), m_bytes(other.m_bytes)
+            {
+            other.m_bytes = 0;
+            }
+
+        //! Move assignment operator
+        MemoryUsageRecord& operator=(MemoryUsageRecord&& other) noexcept
+            {
+            if (&other != this)
+                {
+                release();
+                m_usage = std::move(other.m_usage);
+                m_owner = std::move(other.m_owner);
+                m_bytes = other.m_bytes;
+                other.m_bytes = 0;
+                }
+            return *this;
+            }
+
+        //! Destructor
+        ~MemoryUsageRecord()
+            {
+            release();
+            }
+
+        //! Count an allocation in place of the previous one
+        /*! \param usage The MemoryUsage to count the allocation in
+            \param tag Tag of the array
+            \param bytes Size of the allocation
+        */
+        void update(std::shared_ptr<MemoryUsage> usage, const std::string& tag, size_t bytes)
+            {
+            release();
+            if (!usage || bytes == 0)
+                return;
+
+            m_usage = usage;
+            m_owner = MemoryUsage::getOwner(tag);
+            m_bytes = bytes;
+            m_usage->add(m_owner, m_bytes);
+            }
+
+        //! Remove the counted allocation
+        void release()
+            {
+            if (m_usage)
+                m_usage->remove(m_owner, m_bytes);
+            m_usage.reset();
+            m_bytes = 0;
+            }
+
+        //! Swap two records
+        void swap(MemoryUsageRecord& other)
+            {
+            std::swap(m_usage, other.m_usage);
+            std::swap(m_owner, other.m_owner);
+            std::swap(m_bytes, other.m_bytes);
+            }
+
+    private:
+        std::shared_ptr<MemoryUsage> m_usage;   //!< Where the allocation is counted (null if not counted)
+        std::string m_owner;                    //!< Owner the allocation is counted under
+        size_t m_bytes;                         //!< Size of the allocation
+    };
+
+} // end namespace detail
+} // end namespace hoomd
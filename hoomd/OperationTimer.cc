@@ -0,0 +1,101 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file OperationTimer.cc
+    \brief Defines the OperationTimer class
+*/
+
+#include "OperationTimer.h"
+
+/*! \param exec_conf Execution configuration
+    Events are used to time the intervals when \a exec_conf runs on the GPU.
+*/
+OperationTimer::OperationTimer(std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    : m_exec_conf(exec_conf), m_start_time(0), m_total_time(0.0)
+    {
+    #ifdef ENABLE_HIP
+    m_pending = false;
+    m_use_events = m_exec_conf->isCUDAEnabled();
+    if (m_use_events)
+        {
+        hipEventCreate(&m_start_event);
+        hipEventCreate(&m_stop_event);
+        }
+    #endif
+    }
+
+OperationTimer::~OperationTimer()
+    {
+    #ifdef ENABLE_HIP
+    if (m_use_events)
+        {
+        hipEventDestroy(m_start_event);
+        hipEventDestroy(m_stop_event);
+        }
+    #endif
+    }
+
+void OperationTimer::start()
+    {
+    #ifdef ENABLE_HIP
+    if (m_use_events)
+        {
+        // the events are reused, so the previous interval must be read out first
+        resolvePending();
+        hipEventRecord(m_start_event, 0);
+        return;
+        }
+    #endif
+
+    m_start_time = m_clk.getTime();
+    }
+
+void OperationTimer::stop()
+    {
+    #ifdef ENABLE_HIP
+    if (m_use_events)
+        {
+        hipEventRecord(m_stop_event, 0);
+        m_pending = true;
+        return;
+        }
+    #endif
+
+    m_total_time += double(m_clk.getTime() - m_start_time) / 1e9;
+    }
+
+/*! \returns The total time in seconds, waiting for the last interval to complete on the GPU when needed
+*/
+double OperationTimer::getTotalTime()
+    {
+    #ifdef ENABLE_HIP
+    resolvePending();
+    #endif
+
+    return m_total_time;
+    }
+
+void OperationTimer::reset()
+    {
+    #ifdef ENABLE_HIP
+    if (m_use_events && m_pending)
+        hipEventSynchronize(m_stop_event);
+    m_pending = false;
+    #endif
+
+    m_total_time = 0.0;
+    }
+
+#ifdef ENABLE_HIP
+void OperationTimer::resolvePending()
+    {
+    if (!m_pending)
+        return;
+
+    float ms = 0.0f;
+    hipEventSynchronize(m_stop_event);
+    hipEventElapsedTime(&ms, m_start_event, m_stop_event);
+    m_total_time += double(ms) / 1e3;
+    m_pending = false;
+    }
+#endif
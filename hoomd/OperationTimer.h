@@ -0,0 +1,76 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file OperationTimer.h
+    \brief Declares the OperationTimer class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __OPERATION_TIMER_H__
+#define __OPERATION_TIMER_H__
+
+#include "ClockSource.h"
+#include "ExecutionConfiguration.h"
+
+#ifdef ENABLE_HIP
+#include <hip/hip_runtime.h>
+#endif
+
+#include <memory>
+
+//! Accumulates the time spent in one operation
+/*! OperationTimer sums the time between matching calls to start() and stop(). Unlike Profiler, it never
+    synchronizes with the GPU, so it can stay enabled in production runs.
+
+    On the CPU, the intervals are read from a ClockSource. On the GPU, start() and stop() record events in the
+    default stream, and the elapsed time between them is added to the total the next time the timer is started or
+    the total is read. By then, the stop event has usually completed long ago, so waiting on it costs nothing.
+
+    \ingroup utils
+*/
+class PYBIND11_EXPORT OperationTimer
+    {
+    public:
+        //! Construct an OperationTimer
+        OperationTimer(std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Destructor
+        ~OperationTimer();
+
+        //! Start timing an interval
+        void start();
+
+        //! Stop timing the current interval
+        void stop();
+
+        //! Get the total time in seconds of the intervals since the last reset
+        double getTotalTime();
+
+        //! Reset the total time to zero
+        void reset();
+
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        ClockSource m_clk;          //!< Clock for the CPU intervals
+        int64_t m_start_time;       //!< Start of the current CPU interval
+        double m_total_time;        //!< Total time of the completed intervals in seconds
+
+        #ifdef ENABLE_HIP
+        hipEvent_t m_start_event;   //!< Event recorded by start()
+        hipEvent_t m_stop_event;    //!< Event recorded by stop()
+        bool m_pending;             //!< True when the last recorded interval is not yet added to the total
+        bool m_use_events;          //!< True when the intervals are timed with events
+
+        //! Add the last recorded interval to the total
+        void resolvePending();
+        #endif
+
+        // the timer owns events, it cannot be copied
+        OperationTimer(const OperationTimer&) = delete;
+        OperationTimer& operator=(const OperationTimer&) = delete;
+    };
+
+#endif
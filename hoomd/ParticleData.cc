@@ -10,6 +10,7 @@
 
 #include "ParticleData.h"
 #include "Profiler.h"
+#include "AutotunerCache.h"
 
 #ifdef ENABLE_MPI
 #include "HOOMDMPI.h"
@@ -29,6 +30,7 @@
 #include <stdexcept>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 using namespace std;
 
@@ -254,9 +256,10 @@ const BoxDim & ParticleData::getGlobalBox() const
     }
 
 /*! \b ANY time particles are rearranged in memory, this function must be called.
+    \param permutation True if the local particles were only reordered, and none were added, removed or modified
     \note The call must be made after calling release()
 */
-void ParticleData::notifyParticleSort()
+void ParticleData::notifyParticleSort(bool permutation)
     {
     #ifdef ENABLE_HIP
     if (m_exec_conf->isCUDAEnabled())
@@ -269,7 +272,82 @@ void ParticleData::notifyParticleSort()
         }
     #endif
 
+    // the structure of arrays positions follow the memory order of m_pos
+    m_pos_soa_valid = false;
+
+    // added, removed or modified particles have no known displacement
+    if (!permutation)
+        m_disp_bound_valid = false;
+
+    m_sort_is_permutation = permutation;
     m_sort_signal.emit();
+    m_sort_is_permutation = false;
+    }
+
+/*! \param timestep Timestep of the positions after the move
+    \param delta Upper bound on the distance any local particle moved since the positions at timestep-1
+
+    The bounds of consecutive timesteps are summed, so that m_disp_bound minus its value at an earlier timestep of the
+    same epoch bounds the displacement of every particle between the two timesteps. When the positions at timestep-1
+    are not covered, because a step was not reported or the bound was invalidated, a new epoch starts.
+*/
+void ParticleData::addDisplacementBound(uint64_t timestep, Scalar delta)
+    {
+    if (m_disp_bound_valid && m_disp_bound_timestep + 1 == timestep)
+        {
+        m_disp_bound += delta;
+        }
+    else
+        {
+        m_disp_bound_epoch++;
+        m_disp_bound = Scalar(0.0);
+        m_disp_bound_valid = true;
+        }
+    m_disp_bound_timestep = timestep;
+    }
+
+/*! \param timestep Current time step
+    \returns Positions of the local particles in structure of arrays layout
+
+    getPositions() remains the authoritative storage. The structure of arrays copy is packed from it at most once
+    per timestep (or again after the particles are sorted or invalidatePositionsSoA() is called), so that CPU loops
+    that only need the coordinates can stream contiguous x, y, and z arrays. Rows 0, 1, and 2 hold x, y, and z with a
+    row pitch of getPitch() elements. Only the first getN() elements of each row are valid, ghost particles are not
+    included.
+*/
+const GlobalArray< Scalar >& ParticleData::getPositionsSoA(uint64_t timestep)
+    {
+    if (m_pos_soa_valid && m_pos_soa_timestep == timestep)
+        return m_pos_soa;
+
+    if (m_pos_soa.isNull() || m_pos_soa.getPitch() < getN())
+        {
+        GlobalArray< Scalar > pos_soa(getMaxN(), 3, m_exec_conf);
+        m_pos_soa.swap(pos_soa);
+        TAG_ALLOCATION(m_pos_soa);
+        }
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_pos_soa(m_pos_soa, access_location::host, access_mode::overwrite);
+
+        const size_t pitch = m_pos_soa.getPitch();
+        Scalar *x = h_pos_soa.data;
+        Scalar *y = h_pos_soa.data + pitch;
+        Scalar *z = h_pos_soa.data + 2*pitch;
+        const unsigned int N = getN();
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            const Scalar4 postype = h_pos.data[i];
+            x[i] = postype.x;
+            y[i] = postype.y;
+            z[i] = postype.z;
+            }
+        }
+
+    m_pos_soa_timestep = timestep;
+    m_pos_soa_valid = true;
+    return m_pos_soa;
     }
 
 /*! This function is called any time the ghost particles are removed
@@ -446,7 +524,8 @@ void ParticleData::allocate(unsigned int N)
     #endif
 
     // allocate alternate particle data arrays (for swapping in-out)
-    allocateAlternateArrays(N);
+    if (! m_low_memory)
+        allocateAlternateArrays(N);
 
     // notify observers
     m_max_particle_num_signal.emit();
@@ -562,6 +641,51 @@ void ParticleData::allocateAlternateArrays(unsigned int N)
     #endif
     }
 
+/*! \param low_memory True to release the alternate arrays, false to allocate them again
+
+    The alternate arrays double the memory footprint of the particle data. Without them, particle sorts permute
+    the arrays one at a time in place (see SFCPackTuner). The particle migration in MPI simulations writes to the
+    alternate arrays, so low memory mode is not available with domain decomposition.
+*/
+void ParticleData::setLowMemory(bool low_memory)
+    {
+    if (low_memory == m_low_memory)
+        return;
+
+    #ifdef ENABLE_MPI
+    if (low_memory && m_decomposition)
+        {
+        m_exec_conf->msg->error() << "Low memory particle data is not supported with domain decomposition"
+                                  << std::endl;
+        throw std::runtime_error("Error setting low memory mode");
+        }
+    #endif
+
+    m_low_memory = low_memory;
+
+    if (m_low_memory)
+        {
+        m_exec_conf->msg->notice(5) << "Releasing alternate particle data arrays" << std::endl;
+        m_pos_alt = GlobalArray<Scalar4>();
+        m_vel_alt = GlobalArray<Scalar4>();
+        m_accel_alt = GlobalArray<Scalar3>();
+        m_charge_alt = GlobalArray<Scalar>();
+        m_diameter_alt = GlobalArray<Scalar>();
+        m_image_alt = GlobalArray<int3>();
+        m_tag_alt = GlobalArray<unsigned int>();
+        m_body_alt = GlobalArray<unsigned int>();
+        m_orientation_alt = GlobalArray<Scalar4>();
+        m_angmom_alt = GlobalArray<Scalar4>();
+        m_inertia_alt = GlobalArray<Scalar3>();
+        m_net_force_alt = GlobalArray<Scalar4>();
+        m_net_virial_alt = GlobalArray<Scalar>();
+        m_net_torque_alt = GlobalArray<Scalar4>();
+        }
+    else if (m_arrays_allocated)
+        {
+        allocateAlternateArrays(m_max_nparticles);
+        }
+    }
 
 //! Set global number of particles
 /*! \param nglobal Global number of particles
@@ -573,6 +697,11 @@ void ParticleData::setNGlobal(unsigned int nglobal)
     // Set global particle number
     m_nglobal = nglobal;
 
+    // cached autotuner parameters depend on the system size
+    AutotunerCache *autotuner_cache = m_exec_conf->getAutotunerCache();
+    if (autotuner_cache)
+        autotuner_cache->setSizeHint(nglobal);
+
     // we have changed the global particle number, notify subscribers
     m_global_particle_num_signal.emit();
 
@@ -761,21 +890,39 @@ void ParticleData::maybe_rebuild_tag_cache()
     if(!m_invalid_cached_tags)
         return;
 
-    // GlobalVector checks if the resize is necessary
-    m_cached_tag_set.resize(m_tag_set.size());
+    assert(m_tag_end - m_removed_tag_set.size() == getNGlobal());
+    m_cached_tag_set.resize(m_tag_end - m_removed_tag_set.size());
 
-    // iterate over each element in the set, building a mapping
+    // walk the range of issued tags, skipping the removed ones, building a mapping
     // from dense array indices to sparse particle tag indices
     unsigned int i(0);
-    for(std::set<unsigned int>::const_iterator it(m_tag_set.begin());
-        it != m_tag_set.end(); ++it, ++i)
+    std::set<unsigned int>::const_iterator removed_it(m_removed_tag_set.begin());
+    for (unsigned int tag = 0; tag < m_tag_end; ++tag)
         {
-        m_cached_tag_set[i] = *it;
+        if (removed_it != m_removed_tag_set.end() && *removed_it == tag)
+            {
+            ++removed_it;
+            continue;
+            }
+        m_cached_tag_set[i++] = tag;
         }
 
     m_invalid_cached_tags = false;
     }
 
+/*! \param index Array to fill with the snapshot index of every tag, NOT_LOCAL for the unused tags
+
+    Snapshots hold the particles in the order of the cached tag set.
+*/
+void ParticleData::buildSnapshotIndex(std::vector<unsigned int>& index)
+    {
+    maybe_rebuild_tag_cache();
+
+    index.assign(m_tag_end, NOT_LOCAL);
+    for (unsigned int snap_id = 0; snap_id < m_cached_tag_set.size(); snap_id++)
+        index[m_cached_tag_set[snap_id]] = snap_id;
+    }
+
 /*! \return true If and only if all particles are in the simulation box
 */
 template <class Real>
@@ -814,24 +961,67 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     return in_box;
     }
 
+#ifdef ENABLE_MPI
+namespace
+    {
+//! Send the per-rank vectors to their ranks
+/*! \param in_values Values to send to every rank
+    \param out_value Output vector for the values of this rank
+    \param distributed If true, all ranks send (all-to-all), otherwise only \a root sends (scatter)
+    \param root Sending rank when \a distributed is false
+    \param mpi_comm MPI communicator
+*/
+template<class T>
+void distribute_v(const std::vector< std::vector<T> >& in_values,
+                  std::vector<T>& out_value,
+                  bool distributed,
+                  unsigned int root,
+                  const MPI_Comm mpi_comm)
+    {
+    if (!distributed)
+        {
+        scatter_v(in_values, out_value, root, mpi_comm);
+        return;
+        }
+
+    std::vector< std::vector<T> > recv_values;
+    all_to_all_v(in_values, recv_values, mpi_comm);
+
+    out_value.clear();
+    for (const auto& v : recv_values)
+        out_value.insert(out_value.end(), v.begin(), v.end());
+    }
+    }
+#endif
+
 //! Initialize from a snapshot
 /*! \param snapshot the initial particle data
     \param ignore_bodies If True, ignore particles that have a body flag set
+    \param distributed If True, \a snapshot holds only the part of the system provided by this rank
 
     \post the particle data arrays are initialized from the snapshot, in index order
 
     \pre In parallel simulations, the local box size must be set before a call to initializeFromSnapshot().
  */
 template <class Real>
-void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snapshot, bool ignore_bodies)
+void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snapshot,
+                                          bool ignore_bodies,
+                                          bool distributed)
     {
     m_exec_conf->msg->notice(4) << "ParticleData: initializing from snapshot" << std::endl;
 
     // remove all ghost particles
     removeAllGhostParticles();
 
+    #ifdef ENABLE_MPI
+    if (!m_decomposition)
+        distributed = false;
+    #else
+    distributed = false;
+    #endif
+
     // check that all fields in the snapshot have correct length
-    if (m_exec_conf->getRank() == 0 && ! snapshot.validate())
+    if ((m_exec_conf->getRank() == 0 || distributed) && ! snapshot.validate())
         {
         m_exec_conf->msg->error() << "init.*: invalid particle data snapshot."
                                 << std::endl << std::endl;
@@ -839,7 +1029,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         }
 
     // clear set of active tags
-    m_tag_set.clear();
+    m_tag_end = 0;
+    m_removed_tag_set.clear();
 
     // clear reservoir of recycled tags
     while (! m_recycled_tags.empty())
@@ -891,7 +1082,44 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         tag_proc.resize(size);
         N_proc.resize(size,0);
 
-        if (my_rank == 0)
+        if (distributed)
+            {
+            // number the tags of this rank's particles after those of the lower ranks
+            unsigned int n_local = 0;
+            for (unsigned int snap_idx = 0; snap_idx < snapshot.size; snap_idx++)
+                {
+                if (!(ignore_bodies && snapshot.body[snap_idx] < MIN_FLOPPY))
+                    n_local++;
+                }
+
+            unsigned int tag_offset = 0;
+            MPI_Exscan(&n_local, &tag_offset, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+            if (my_rank == 0)
+                tag_offset = 0;
+            nglobal = tag_offset;
+            }
+
+        // place the cut planes at the quantiles of the particle distribution before placing the particles
+        if (m_decomposition->getBisect())
+            {
+            std::vector<Scalar3> bisect_pos;
+            if (my_rank == 0 || distributed)
+                {
+                bisect_pos.reserve(snapshot.size);
+                for (unsigned int snap_idx = 0; snap_idx < snapshot.size; snap_idx++)
+                    {
+                    if (ignore_bodies && snapshot.body[snap_idx] < MIN_FLOPPY)
+                        continue;
+                    bisect_pos.push_back(vec_to_scalar3(snapshot.pos[snap_idx]));
+                    }
+                }
+            m_decomposition->bisect(m_global_box, bisect_pos);
+
+            // update the local box to the new fractions
+            setGlobalBox(m_global_box);
+            }
+
+        if (my_rank == 0 || distributed)
             {
             ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
 
@@ -991,6 +1219,12 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
 
             }
 
+        if (distributed)
+            {
+            // the last rank holds the total number of particles
+            bcast(nglobal, size-1, mpi_comm);
+            }
+
         // get type mapping
         m_type_mapping = snapshot.type_mapping;
 
@@ -1024,22 +1258,25 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         std::vector<unsigned int> tag;
 
         // distribute particle data
-        scatter_v(pos_proc,pos,root, mpi_comm);
-        scatter_v(vel_proc,vel,root, mpi_comm);
-        scatter_v(accel_proc, accel, root, mpi_comm);
-        scatter_v(type_proc, type, root, mpi_comm);
-        scatter_v(mass_proc, mass, root, mpi_comm);
-        scatter_v(charge_proc, charge, root, mpi_comm);
-        scatter_v(diameter_proc, diameter, root, mpi_comm);
-        scatter_v(image_proc, image, root, mpi_comm);
-        scatter_v(body_proc, body, root, mpi_comm);
-        scatter_v(orientation_proc, orientation, root, mpi_comm);
-        scatter_v(angmom_proc, angmom, root, mpi_comm);
-        scatter_v(inertia_proc, inertia, root, mpi_comm);
-        scatter_v(tag_proc, tag, root, mpi_comm);
+        distribute_v(pos_proc, pos, distributed, root, mpi_comm);
+        distribute_v(vel_proc, vel, distributed, root, mpi_comm);
+        distribute_v(accel_proc, accel, distributed, root, mpi_comm);
+        distribute_v(type_proc, type, distributed, root, mpi_comm);
+        distribute_v(mass_proc, mass, distributed, root, mpi_comm);
+        distribute_v(charge_proc, charge, distributed, root, mpi_comm);
+        distribute_v(diameter_proc, diameter, distributed, root, mpi_comm);
+        distribute_v(image_proc, image, distributed, root, mpi_comm);
+        distribute_v(body_proc, body, distributed, root, mpi_comm);
+        distribute_v(orientation_proc, orientation, distributed, root, mpi_comm);
+        distribute_v(angmom_proc, angmom, distributed, root, mpi_comm);
+        distribute_v(inertia_proc, inertia, distributed, root, mpi_comm);
+        distribute_v(tag_proc, tag, distributed, root, mpi_comm);
 
         // distribute number of particles
-        scatter_v(N_proc, m_nparticles, root, mpi_comm);
+        if (distributed)
+            m_nparticles = (unsigned int)tag.size();
+        else
+            scatter_v(N_proc, m_nparticles, root, mpi_comm);
 
 
             {
@@ -1053,10 +1290,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             }
 
         // update list of active tags
-        for (unsigned int tag = 0; tag < nglobal; tag++)
-            {
-            m_tag_set.insert(tag);
-            }
+        m_tag_end = nglobal;
 
         // Now that active tag list has changed, invalidate the cache
         m_invalid_cached_tags = true;
@@ -1161,10 +1395,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         m_nparticles = nglobal;
 
         // update list of active tags
-        for (unsigned int tag = 0; tag < nglobal; tag++)
-            {
-            m_tag_set.insert(tag);
-            }
+        m_tag_end = nglobal;
 
         // rtag size reflects actual number of tags
         m_rtag.resize(nglobal);
@@ -1190,17 +1421,93 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     m_num_types_signal.emit();
     }
 
+/*! \param snapshot The snapshot to write to
+    \param type If non-negative, only include particles of this type
+    \returns The tag of every particle in the snapshot
+
+    The snapshot holds the particles owned by this rank (no ghosts) in ascending tag order. Unlike takeSnapshot(),
+    no data is communicated, so analyzers can call takeLocalSnapshot() on every rank and reduce only the metadata they
+    need. Positions are wrapped into the global box as in takeSnapshot().
+*/
+template <class Real>
+std::vector<unsigned int> ParticleData::takeLocalSnapshot(SnapshotParticleData<Real> &snapshot, int type)
+    {
+    m_exec_conf->msg->notice(4) << "ParticleData: taking local snapshot" << std::endl;
+
+    ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::read);
+    ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::read);
+    ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_diameter(m_diameter, access_location::host, access_mode::read);
+    ArrayHandle< unsigned int > h_body(m_body, access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 >  h_orientation(m_orientation, access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 >  h_angmom(m_angmom, access_location::host, access_mode::read);
+    ArrayHandle< Scalar3 >  h_inertia(m_inertia, access_location::host, access_mode::read);
+    ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::read);
+
+    // sort the selected local particles by tag
+    std::vector< std::pair<unsigned int, unsigned int> > tag_idx;
+    tag_idx.reserve(m_nparticles);
+    for (unsigned int idx = 0; idx < m_nparticles; idx++)
+        {
+        if (type >= 0 && __scalar_as_int(h_pos.data[idx].w) != type)
+            continue;
+        tag_idx.push_back(std::make_pair(h_tag.data[idx], idx));
+        }
+    std::sort(tag_idx.begin(), tag_idx.end());
+
+    snapshot.resize((unsigned int)tag_idx.size());
+    std::vector<unsigned int> tags(tag_idx.size());
+
+    for (unsigned int snap_id = 0; snap_id < tag_idx.size(); snap_id++)
+        {
+        unsigned int idx = tag_idx[snap_id].second;
+        tags[snap_id] = tag_idx[snap_id].first;
+
+        snapshot.pos[snap_id] = vec3<Real>(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - m_origin);
+        snapshot.vel[snap_id] = vec3<Real>(make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z));
+        snapshot.accel[snap_id] = vec3<Real>(h_accel.data[idx]);
+        snapshot.type[snap_id] = __scalar_as_int(h_pos.data[idx].w);
+        snapshot.mass[snap_id] = Real(h_vel.data[idx].w);
+        snapshot.charge[snap_id] = Real(h_charge.data[idx]);
+        snapshot.diameter[snap_id] = Real(h_diameter.data[idx]);
+        snapshot.image[snap_id] = h_image.data[idx];
+        snapshot.image[snap_id].x -= m_o_image.x;
+        snapshot.image[snap_id].y -= m_o_image.y;
+        snapshot.image[snap_id].z -= m_o_image.z;
+        snapshot.body[snap_id] = h_body.data[idx];
+        snapshot.orientation[snap_id] = quat<Real>(h_orientation.data[idx]);
+        snapshot.angmom[snap_id] = quat<Real>(h_angmom.data[idx]);
+        snapshot.inertia[snap_id] = vec3<Real>(h_inertia.data[idx]);
+
+        // make sure the position stored in the snapshot is within the boundaries
+        Scalar3 tmp = vec_to_scalar3(snapshot.pos[snap_id]);
+        m_global_box.wrap(tmp, snapshot.image[snap_id]);
+        snapshot.pos[snap_id] = vec3<Real>(tmp);
+        }
+
+    snapshot.type_mapping = m_type_mapping;
+    snapshot.is_accel_set = m_accel_set;
+
+    return tags;
+    }
+
 //! take a particle data snapshot
 /* \param snapshot The snapshot to write to
-   \returns a map to lookup the snapshot index from a particle tag
+   \returns an array to lookup the snapshot index from a particle tag (NOT_LOCAL for unused tags), empty on
+            non-root ranks
+
+   The snapshot holds the particles in ascending tag order. The cached tag set is already sorted, so the lookup
+   array is filled in a single pass and the particles are scattered to their snapshot index without sorting.
 
    \pre snapshot has to be allocated with a number of elements equal to the global number of particles)
 */
 template <class Real>
-std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticleData<Real> &snapshot)
+std::vector<unsigned int> ParticleData::takeSnapshot(SnapshotParticleData<Real> &snapshot)
     {
-    // a map to contain a particle tag-> snapshot idx lookup
-    std::map<unsigned int, unsigned int> index;
+    // a dense array to contain a particle tag-> snapshot idx lookup
+    std::vector<unsigned int> index;
 
     m_exec_conf->msg->notice(4) << "ParticleData: taking snapshot" << std::endl;
 
@@ -1234,7 +1541,6 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         std::vector<Scalar4> angmom(m_nparticles);
         std::vector<Scalar3> inertia(m_nparticles);
         std::vector<unsigned int> tag(m_nparticles);
-        std::map<unsigned int, unsigned int> rtag_map;
         for (unsigned int idx = 0; idx < m_nparticles; idx++)
             {
             pos[idx] = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - m_origin;
@@ -1252,9 +1558,7 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
             orientation[idx] = h_orientation.data[idx];
             angmom[idx] = h_angmom.data[idx];
             inertia[idx] = h_inertia.data[idx];
-
-            // insert reverse lookup global tag -> idx
-            rtag_map.insert(std::pair<unsigned int, unsigned int>(h_tag.data[idx], idx));
+            tag[idx] = h_tag.data[idx];
             }
 
         std::vector< std::vector<Scalar3> > pos_proc;              // Position array of every processor
@@ -1269,8 +1573,7 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         std::vector< std::vector<Scalar4 > > orientation_proc;     // Orientations of every processor
         std::vector< std::vector<Scalar4 > > angmom_proc;          // Angular momenta of every processor
         std::vector< std::vector<Scalar3 > > inertia_proc;         // Moments of inertia of every processor
-
-        std::vector< std::map<unsigned int, unsigned int> > rtag_map_proc; // List of reverse-lookup maps
+        std::vector< std::vector<unsigned int > > tag_proc;        // Tags of every processor
 
         const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
         unsigned int size = m_exec_conf->getNRanks();
@@ -1289,7 +1592,7 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         orientation_proc.resize(size);
         angmom_proc.resize(size);
         inertia_proc.resize(size);
-        rtag_map_proc.resize(size);
+        tag_proc.resize(size);
 
         unsigned int root = 0;
 
@@ -1306,9 +1609,7 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         gather_v(orientation, orientation_proc, root, mpi_comm);
         gather_v(angmom, angmom_proc, root, mpi_comm);
         gather_v(inertia, inertia_proc, root, mpi_comm);
-
-        // gather the reverse-lookup maps
-        gather_v(rtag_map, rtag_map_proc, root, mpi_comm);
+        gather_v(tag, tag_proc, root, mpi_comm);
 
         if (rank == root)
             {
@@ -1316,62 +1617,55 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
             snapshot.resize(getNGlobal());
 
             unsigned int n_ranks = m_exec_conf->getNRanks();
-            assert(rtag_map_proc.size() == n_ranks);
-
-            // create single map of all particle ranks and indices
-            std::map<unsigned int, std::pair<unsigned int, unsigned int> > rank_rtag_map;
-            std::map<unsigned int, unsigned int>::iterator it;
-            for (unsigned int irank = 0; irank < n_ranks; ++irank)
-                for (it = rtag_map_proc[irank].begin(); it != rtag_map_proc[irank].end(); ++it)
-                    rank_rtag_map.insert(std::pair<unsigned int, std::pair<unsigned int, unsigned int> >(
-                        it->first, std::pair<unsigned int, unsigned int>(irank, it->second)));
+            assert(tag_proc.size() == n_ranks);
 
-            // add particles to snapshot
-            assert(m_tag_set.size() == getNGlobal());
-            std::set<unsigned int>::const_iterator tag_set_it = m_tag_set.begin();
+            buildSnapshotIndex(index);
 
-            std::map<unsigned int, std::pair<unsigned int, unsigned int> >::iterator rank_rtag_it;
-            for (unsigned int snap_id = 0; snap_id < getNGlobal(); snap_id++)
+            // scatter the particles of every rank to their snapshot index
+            unsigned int n_found = 0;
+            for (unsigned int irank = 0; irank < n_ranks; ++irank)
                 {
-                unsigned int tag = *tag_set_it;
-                assert(tag <= getMaximumTag());
-                rank_rtag_it = rank_rtag_map.find(tag);
-
-                if (rank_rtag_it == rank_rtag_map.end())
+                for (unsigned int idx = 0; idx < tag_proc[irank].size(); ++idx)
                     {
-                    m_exec_conf->msg->error()
-                        << endl << "Could not find particle " << tag << " on any processor. "
-                        << endl << endl;
-                    throw std::runtime_error("Error gathering ParticleData");
+                    unsigned int tag = tag_proc[irank][idx];
+                    unsigned int snap_id = tag < index.size() ? index[tag] : NOT_LOCAL;
+
+                    if (snap_id == NOT_LOCAL)
+                        {
+                        m_exec_conf->msg->error()
+                            << endl << "Particle " << tag << " on processor " << irank << " is not in use. "
+                            << endl << endl;
+                        throw std::runtime_error("Error gathering ParticleData");
+                        }
+
+                    snapshot.pos[snap_id] = vec3<Real>(pos_proc[irank][idx]);
+                    snapshot.vel[snap_id] = vec3<Real>(vel_proc[irank][idx]);
+                    snapshot.accel[snap_id] = vec3<Real>(accel_proc[irank][idx]);
+                    snapshot.type[snap_id] = type_proc[irank][idx];
+                    snapshot.mass[snap_id] = Real(mass_proc[irank][idx]);
+                    snapshot.charge[snap_id] = Real(charge_proc[irank][idx]);
+                    snapshot.diameter[snap_id] = Real(diameter_proc[irank][idx]);
+                    snapshot.image[snap_id] = image_proc[irank][idx];
+                    snapshot.body[snap_id] = body_proc[irank][idx];
+                    snapshot.orientation[snap_id] = quat<Real>(orientation_proc[irank][idx]);
+                    snapshot.angmom[snap_id] = quat<Real>(angmom_proc[irank][idx]);
+                    snapshot.inertia[snap_id] = vec3<Real>(inertia_proc[irank][idx]);
+
+                    // make sure the position stored in the snapshot is within the boundaries
+                    Scalar3 tmp = vec_to_scalar3(snapshot.pos[snap_id]);
+                    m_global_box.wrap(tmp, snapshot.image[snap_id]);
+                    snapshot.pos[snap_id] = vec3<Real>(tmp);
+
+                    n_found++;
                     }
+                }
 
-                // rank contains the processor rank on which the particle was found
-                std::pair<unsigned int, unsigned int> rank_idx = rank_rtag_it->second;
-                unsigned int rank = rank_idx.first;
-                unsigned int idx = rank_idx.second;
-
-                // store tag in index map
-                index.insert(std::make_pair(tag, snap_id));
-
-                snapshot.pos[snap_id] = vec3<Real>(pos_proc[rank][idx]);
-                snapshot.vel[snap_id] = vec3<Real>(vel_proc[rank][idx]);
-                snapshot.accel[snap_id] = vec3<Real>(accel_proc[rank][idx]);
-                snapshot.type[snap_id] = type_proc[rank][idx];
-                snapshot.mass[snap_id] = Real(mass_proc[rank][idx]);
-                snapshot.charge[snap_id] = Real(charge_proc[rank][idx]);
-                snapshot.diameter[snap_id] = Real(diameter_proc[rank][idx]);
-                snapshot.image[snap_id] = image_proc[rank][idx];
-                snapshot.body[snap_id] = body_proc[rank][idx];
-                snapshot.orientation[snap_id] = quat<Real>(orientation_proc[rank][idx]);
-                snapshot.angmom[snap_id] = quat<Real>(angmom_proc[rank][idx]);
-                snapshot.inertia[snap_id] = vec3<Real>(inertia_proc[rank][idx]);
-
-                // make sure the position stored in the snapshot is within the boundaries
-                Scalar3 tmp = vec_to_scalar3(snapshot.pos[snap_id]);
-                m_global_box.wrap(tmp, snapshot.image[snap_id]);
-                snapshot.pos[snap_id] = vec3<Real>(tmp);
-
-                std::advance(tag_set_it, 1);
+            if (n_found != getNGlobal())
+                {
+                m_exec_conf->msg->error()
+                    << endl << "Found " << n_found << " particles on all processors, expected " << getNGlobal()
+                    << endl << endl;
+                throw std::runtime_error("Error gathering ParticleData");
                 }
             }
         }
@@ -1381,20 +1675,16 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         // allocate memory in snapshot
         snapshot.resize(getNGlobal());
 
-        assert(m_tag_set.size() == m_nparticles);
-        std::set<unsigned int>::const_iterator it = m_tag_set.begin();
+        buildSnapshotIndex(index);
 
         // iterate through active tags
         for (unsigned int snap_id = 0; snap_id < m_nparticles; snap_id++)
             {
-            unsigned int tag = *it;
+            unsigned int tag = m_cached_tag_set[snap_id];
             assert(tag <= getMaximumTag());
             unsigned int idx = h_rtag.data[tag];
             assert(idx < m_nparticles);
 
-            // store tag in index map
-            index.insert(std::make_pair(tag, snap_id));
-
             snapshot.pos[snap_id] = vec3<Real>(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - m_origin);
             snapshot.vel[snap_id] = vec3<Real>(make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z));
             snapshot.accel[snap_id] = vec3<Real>(h_accel.data[idx]);
@@ -1415,8 +1705,6 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
             Scalar3 tmp = vec_to_scalar3(snapshot.pos[snap_id]);
             m_global_box.wrap(tmp, snapshot.image[snap_id]);
             snapshot.pos[snap_id] = vec3<Real>(tmp);
-
-            std::advance(it, 1);
             }
         }
 
@@ -1937,6 +2225,7 @@ void ParticleData::setPosition(unsigned int tag, const Scalar3& pos, bool move)
 
         h_pos.data[idx].x = tmp_pos.x; h_pos.data[idx].y = tmp_pos.y; h_pos.data[idx].z = tmp_pos.z;
         h_image.data[idx] = img;
+        m_pos_soa_valid = false;
         }
 
     #ifdef ENABLE_MPI
@@ -2241,6 +2530,7 @@ unsigned int ParticleData::addParticle(unsigned int type)
         {
         tag = m_recycled_tags.top();
         m_recycled_tags.pop();
+        m_removed_tag_set.erase(tag);
         }
     else
         {
@@ -2248,11 +2538,10 @@ unsigned int ParticleData::addParticle(unsigned int type)
         tag = getNGlobal();
 
         assert(m_rtag.size() == getNGlobal());
+        assert(m_tag_end == tag);
+        m_tag_end++;
         }
 
-    // add to set of active tags
-    m_tag_set.insert(tag);
-
     // invalidate the active tag cache
     m_invalid_cached_tags = true;
 
@@ -2421,7 +2710,7 @@ void ParticleData::removeParticle(unsigned int tag)
         }
 
     // remove from set of active tags
-    m_tag_set.erase(tag);
+    m_removed_tag_set.insert(tag);
 
     // maintain a stack of deleted group tags for future recycling
     m_recycled_tags.push(tag);
@@ -2436,6 +2725,212 @@ void ParticleData::removeParticle(unsigned int tag)
     notifyParticleSort();
     }
 
+/*! \param nx Number of times to replicate the system along the x direction
+    \param ny Number of times to replicate the system along the y direction
+    \param nz Number of times to replicate the system along the z direction
+
+    The result is the same as that of SnapshotSystemData::replicate(): copy j of the particle with tag t has the tag
+    j*N + t. Each rank replicates only its own local particles in place, so the replicated system is never
+    gathered on one rank. With a domain decomposition, the copies remain on the rank of the original particle
+    until Communicator::migrateParticlesToDomains() sends them to their domains.
+
+    \pre The active particle tags are contiguous, i.e. no particle has been removed.
+*/
+void ParticleData::replicate(unsigned int nx, unsigned int ny, unsigned int nz)
+    {
+    if (nx == 0 || ny == 0 || nz == 0)
+        {
+        m_exec_conf->msg->error() << "State.replicate: the number of replicas must be positive" << endl;
+        throw std::runtime_error("Error replicating particles");
+        }
+
+    if (!m_removed_tag_set.empty())
+        {
+        m_exec_conf->msg->error() << "State.replicate: cannot replicate a system with removed particles" << endl;
+        throw std::runtime_error("Error replicating particles");
+        }
+
+    const unsigned int n_replicas = nx*ny*nz;
+    const unsigned int old_nglobal = getNGlobal();
+    if (uint64_t(old_nglobal)*n_replicas >= uint64_t(NOT_LOCAL))
+        {
+        m_exec_conf->msg->error() << "State.replicate: the replicated system would have too many particles" << endl;
+        throw std::runtime_error("Error replicating particles");
+        }
+    const unsigned int new_nglobal = old_nglobal*n_replicas;
+
+    // we are changing the local number of particles, so remove ghosts
+    removeAllGhostParticles();
+
+    const BoxDim old_box = m_global_box;
+    BoxDim new_box = old_box;
+    Scalar3 L = old_box.getL();
+    new_box.setL(make_scalar3(L.x*Scalar(nx), L.y*Scalar(ny), L.z*Scalar(nz)));
+
+    const unsigned int old_n = getN();
+    resize(old_n*n_replicas);
+
+        {
+        ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar3> h_accel(getAccelerations(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_charge(getCharges(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_diameter(getDiameters(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_body(getBodies(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_angmom(getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar3> h_inertia(getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
+
+        for (unsigned int i = 0; i < old_n; ++i)
+            {
+            // unwrap the position of particle i in the old box
+            Scalar3 p = old_box.shift(make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z), h_image.data[i]);
+            Scalar3 f = old_box.makeFraction(p);
+
+            unsigned int j = 0;
+            for (unsigned int l = 0; l < nx; l++)
+                for (unsigned int m = 0; m < ny; m++)
+                    for (unsigned int n = 0; n < nz; n++)
+                        {
+                        Scalar3 f_new;
+                        f_new.x = f.x/(Scalar)nx + (Scalar)l/(Scalar)nx;
+                        f_new.y = f.y/(Scalar)ny + (Scalar)m/(Scalar)ny;
+                        f_new.z = f.z/(Scalar)nz + (Scalar)n/(Scalar)nz;
+
+                        // copy 0 overwrites the original, after all fields have been read from it
+                        unsigned int k = j*old_n + i;
+
+                        // coordinates in new box, wrapped by multiple box vectors if necessary
+                        Scalar3 q = new_box.makeCoordinates(f_new);
+                        int3 img = new_box.getImage(q);
+                        q = new_box.shift(q, make_int3(-img.x, -img.y, -img.z));
+                        new_box.wrap(q, img);
+
+                        h_pos.data[k] = make_scalar4(q.x, q.y, q.z, h_pos.data[i].w);
+                        h_image.data[k] = img;
+                        h_vel.data[k] = h_vel.data[i];
+                        h_accel.data[k] = h_accel.data[i];
+                        h_charge.data[k] = h_charge.data[i];
+                        h_diameter.data[k] = h_diameter.data[i];
+                        h_orientation.data[k] = h_orientation.data[i];
+                        h_angmom.data[k] = h_angmom.data[i];
+                        h_inertia.data[k] = h_inertia.data[i];
+                        h_comm_flags.data[k] = 0;
+
+                        // body ids are tags, and floppy body ids remain floppy
+                        unsigned int body = h_body.data[i];
+                        h_body.data[k] = (body != NO_BODY ? j*old_nglobal + body : NO_BODY);
+                        if (body < MIN_FLOPPY && h_body.data[k] >= MIN_FLOPPY)
+                            {
+                            m_exec_conf->msg->error() << "State.replicate: replication would create more distinct "
+                                                      << "rigid bodies than HOOMD supports" << endl;
+                            throw std::runtime_error("Error replicating particles");
+                            }
+
+                        h_tag.data[k] = j*old_nglobal + h_tag.data[i];
+                        j++;
+                        }
+            }
+        }
+
+    // the set of active tags is the full range
+    m_tag_end = new_nglobal;
+    m_invalid_cached_tags = true;
+
+    m_rtag.resize(new_nglobal);
+        {
+        ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+        std::fill(h_rtag.data + old_nglobal, h_rtag.data + new_nglobal, NOT_LOCAL);
+        for (unsigned int idx = 0; idx < getN(); ++idx)
+            h_rtag.data[h_tag.data[idx]] = idx;
+        }
+
+    setGlobalBox(new_box);
+    setNGlobal(new_nglobal);
+    notifyParticleSort();
+    }
+
+/*! \param in Local particles
+    \param tag_end One past the largest tag issued
+    \param removed_tags Tags below \a tag_end of removed particles
+
+    Sets the local particles of every rank at once, e.g. when reading a checkpoint. Together, the ranks must hold
+    one particle for every active tag. The removed tags are recycled in ascending order.
+*/
+void ParticleData::loadLocalParticles(const std::vector<pdata_element>& in,
+                                      unsigned int tag_end,
+                                      const std::set<unsigned int>& removed_tags)
+    {
+    // we are changing the local number of particles, so remove ghosts
+    removeAllGhostParticles();
+
+    resize((unsigned int)in.size());
+
+        {
+        ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel(getAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge(getCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter(getDiameters(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image(getImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body(getBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom(getAngularMomentumArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia(getMomentsOfInertiaArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force(getNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque(getNetTorqueArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::overwrite);
+
+        unsigned int net_virial_pitch = (unsigned int)m_net_virial.getPitch();
+        for (unsigned int idx = 0; idx < in.size(); ++idx)
+            {
+            const pdata_element& p = in[idx];
+            h_pos.data[idx] = p.pos;
+            h_vel.data[idx] = p.vel;
+            h_accel.data[idx] = p.accel;
+            h_charge.data[idx] = p.charge;
+            h_diameter.data[idx] = p.diameter;
+            h_image.data[idx] = p.image;
+            h_body.data[idx] = p.body;
+            h_orientation.data[idx] = p.orientation;
+            h_angmom.data[idx] = p.angmom;
+            h_inertia.data[idx] = p.inertia;
+            h_net_force.data[idx] = p.net_force;
+            h_net_torque.data[idx] = p.net_torque;
+            for (unsigned int j = 0; j < 6; ++j)
+                h_net_virial.data[net_virial_pitch*j+idx] = p.net_virial[j];
+            h_tag.data[idx] = p.tag;
+            h_comm_flags.data[idx] = 0;
+            }
+        }
+
+    m_tag_end = tag_end;
+    m_removed_tag_set = removed_tags;
+    while (! m_recycled_tags.empty())
+        m_recycled_tags.pop();
+    for (std::set<unsigned int>::const_reverse_iterator it = removed_tags.rbegin(); it != removed_tags.rend(); ++it)
+        m_recycled_tags.push(*it);
+    m_invalid_cached_tags = true;
+
+    m_rtag.resize(tag_end);
+        {
+        ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::overwrite);
+        std::fill(h_rtag.data, h_rtag.data + tag_end, NOT_LOCAL);
+        for (unsigned int idx = 0; idx < getN(); ++idx)
+            h_rtag.data[h_tag.data[idx]] = idx;
+        }
+
+    setNGlobal(tag_end - (unsigned int)removed_tags.size());
+    notifyParticleSort();
+    }
+
 //! Return the nth active global tag
 /*! \param n Index of bond in global bond table
  */
@@ -2447,8 +2942,6 @@ unsigned int ParticleData::getNthTag(unsigned int n)
         throw std::runtime_error("Error fetching particle");
         }
 
-    assert(m_tag_set.size() == getNGlobal());
-
     // maybe_rebuild_tag_cache only rebuilds if necessary
     maybe_rebuild_tag_cache();
     return m_cached_tag_set[n];
@@ -2510,8 +3003,12 @@ template ParticleData::ParticleData(const SnapshotParticleData<double>& snapshot
                                            std::shared_ptr<ExecutionConfiguration> exec_conf,
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
-template void ParticleData::initializeFromSnapshot<double>(const SnapshotParticleData<double> & snapshot, bool ignore_bodies);
-template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<double>(SnapshotParticleData<double> &snapshot);
+template void ParticleData::initializeFromSnapshot<double>(const SnapshotParticleData<double> & snapshot,
+                                                           bool ignore_bodies,
+                                                           bool distributed);
+template std::vector<unsigned int> ParticleData::takeSnapshot<double>(SnapshotParticleData<double> &snapshot);
+template std::vector<unsigned int> ParticleData::takeLocalSnapshot<double>(SnapshotParticleData<double> &snapshot,
+                                                                           int type);
 
 
 template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
@@ -2519,8 +3016,12 @@ template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
                                            std::shared_ptr<ExecutionConfiguration> exec_conf,
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
-template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot, bool ignore_bodies);
-template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
+template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot,
+                                                          bool ignore_bodies,
+                                                          bool distributed);
+template std::vector<unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
+template std::vector<unsigned int> ParticleData::takeLocalSnapshot<float>(SnapshotParticleData<float> &snapshot,
+                                                                          int type);
 
 
 void export_ParticleData(py::module& m)
@@ -2572,6 +3073,7 @@ void export_ParticleData(py::module& m)
     .def("getMaximumTag", &ParticleData::getMaximumTag)
     .def("addParticle", &ParticleData::addParticle)
     .def("removeParticle", &ParticleData::removeParticle)
+    .def("replicate", &ParticleData::replicate)
     .def("getNthTag", &ParticleData::getNthTag)
 #ifdef ENABLE_MPI
     .def("setDomainDecomposition", &ParticleData::setDomainDecomposition)
@@ -299,9 +299,16 @@ struct pdata_element
 
     In a parallel simulation, the global tag is unique among all processors.
 
+    The set of active tags is kept as the range of issued tags minus the tags of removed particles, so every rank
+    replicates only one word per removed particle in addition to \c m_rtag. \c m_rtag itself remains a dense array
+    indexed by tag, because the GPU kernels and the bonded group tables look up indices in it directly.
+
     In order to help other classes deal with particles changing indices, any class that
     changes the order must call notifyParticleSort(). Any class interested in being notified
-    can subscribe to the signal by calling connectParticleSort().
+    can subscribe to the signal by calling connectParticleSort(). A class that only reorders the local particles,
+    without adding, removing or modifying any, should pass \a permutation = true so that listeners may follow the
+    particles by tag instead of recomputing their data. Listeners can check isParticleSortPermutation() while the
+    signal is emitted.
 
     Some fields in ParticleData are not computed and assigned by default because they require additional processing
     time. PDataFlags is a bitset that lists which flags (enumerated in pdata_flag) are enable/disabled. Computes should
@@ -590,6 +597,17 @@ class PYBIND11_EXPORT ParticleData
         //! Return positions and types
         const GlobalArray< Scalar4 >& getPositions() const { return m_pos; }
 
+        //! Return the local particle positions in structure of arrays layout
+        const GlobalArray< Scalar >& getPositionsSoA(uint64_t timestep);
+
+        //! Mark the structure of arrays positions as out of date
+        /*! Call after modifying positions when getPositionsSoA() may have already been called for this timestep
+        */
+        void invalidatePositionsSoA()
+            {
+            m_pos_soa_valid = false;
+            }
+
         //! Return velocities and masses
         const GlobalArray< Scalar4 >& getVelocities() const { return m_vel; }
 
@@ -719,6 +737,18 @@ class PYBIND11_EXPORT ParticleData
         //! Swap in moments of inertia
         inline void swapMomentsOfInertia() { m_inertia.swap(m_inertia_alt); }
 
+        //! Drop or restore the alternate arrays
+        void setLowMemory(bool low_memory);
+
+        //! Get whether the alternate arrays are dropped
+        /*! In low memory mode, the alternate arrays are not allocated and code that reorders the particle data has
+            to permute the arrays in place.
+        */
+        bool getLowMemory() const
+            {
+            return m_low_memory;
+            }
+
         //! Set the profiler to profile CPU<-->GPU memory copies
         /*! \param prof Pointer to the profiler to use. Set to NULL to deactivate profiling
         */
@@ -734,7 +764,40 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Notify listeners that the particles have been rearranged in memory
-        void notifyParticleSort();
+        void notifyParticleSort(bool permutation=false);
+
+        //! Return true if the particle sort being notified only reordered the local particles
+        bool isParticleSortPermutation() const
+            {
+            return m_sort_is_permutation;
+            }
+
+        //! Add the largest displacement of any local particle between timestep-1 and \a timestep
+        void addDisplacementBound(uint64_t timestep, Scalar delta);
+
+        //! Mark the displacement bound as unknown, e.g. after particles were moved by an updater
+        void invalidateDisplacementBound()
+            {
+            m_disp_bound_valid = false;
+            }
+
+        //! Return true if the displacement bound covers the positions at \a timestep
+        bool isDisplacementBoundValid(uint64_t timestep) const
+            {
+            return m_disp_bound_valid && m_disp_bound_timestep == timestep;
+            }
+
+        //! Get the sum of the displacements added since the displacement bound was last invalidated
+        Scalar getDisplacementBound() const
+            {
+            return m_disp_bound;
+            }
+
+        //! Get a counter that changes every time the displacement bound restarts from zero
+        uint64_t getDisplacementBoundEpoch() const
+            {
+            return m_disp_bound_epoch;
+            }
 
         //! Connects a function to be called every time the box size is changed
         Nano::Signal<void ()>& getBoxChangeSignal()
@@ -882,8 +945,7 @@ class PYBIND11_EXPORT ParticleData
         //! Return true if the tag is active
         bool isTagActive(unsigned int tag) const
             {
-            std::set<unsigned int>::const_iterator it = m_tag_set.find(tag);
-            return it != m_tag_set.end();
+            return tag < m_tag_end && m_removed_tag_set.find(tag) == m_removed_tag_set.end();
             }
 
         /*! Return the maximum particle tag in the simulation
@@ -891,10 +953,15 @@ class PYBIND11_EXPORT ParticleData
          */
         unsigned int getMaximumTag() const
             {
-            if (m_tag_set.empty())
-                return UINT_MAX;
-            else
-                return *m_tag_set.rbegin();
+            // walk down past the removed tags at the end of the range
+            unsigned int max_tag = m_tag_end;
+            std::set<unsigned int>::const_reverse_iterator it = m_removed_tag_set.rbegin();
+            while (max_tag > 0 && it != m_removed_tag_set.rend() && *it == max_tag - 1)
+                {
+                max_tag--;
+                ++it;
+                }
+            return max_tag > 0 ? max_tag - 1 : UINT_MAX;
             }
 
         //! Get the orientation of a particle with a given tag
@@ -996,12 +1063,22 @@ class PYBIND11_EXPORT ParticleData
         void removeFlag(pdata_flag::Enum flag) { m_flags[flag] = false; }
 
         //! Initialize from a snapshot
+        /*! With \a distributed set (MPI only), every rank passes its own part of the system. The parts are
+            exchanged with an all-to-all so that each particle ends up on the rank that owns its domain, and tags
+            are numbered in rank order. All ranks must pass the same type mapping.
+        */
         template <class Real>
-        void initializeFromSnapshot(const SnapshotParticleData<Real> & snapshot, bool ignore_bodies=false);
+        void initializeFromSnapshot(const SnapshotParticleData<Real> & snapshot,
+                                    bool ignore_bodies=false,
+                                    bool distributed=false);
 
         //! Take a snapshot
         template <class Real>
-        std::map<unsigned int, unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
+        std::vector<unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
+
+        //! Take a snapshot of the local particles without communication
+        template <class Real>
+        std::vector<unsigned int> takeLocalSnapshot(SnapshotParticleData<Real> &snapshot, int type=-1);
 
         //! Add ghost particles at the end of the local particle data
         void addGhostParticles(const unsigned int nghosts);
@@ -1015,6 +1092,19 @@ class PYBIND11_EXPORT ParticleData
             notifyGhostParticlesRemoved();
             }
 
+        //! Change the number of local particles
+        /*! \param N New number of local particles
+
+            The ghost particles are removed and the arrays grow as needed. This is used to load previously saved
+            particle data, the caller fills in the arrays and the reverse lookup tags and then calls
+            notifyParticleSort().
+        */
+        void setNLocal(unsigned int N)
+            {
+            removeAllGhostParticles();
+            resize(N);
+            }
+
 #ifdef ENABLE_MPI
         //! Set domain decomposition information
         void setDomainDecomposition(std::shared_ptr<DomainDecomposition> decomposition)
@@ -1081,6 +1171,26 @@ class PYBIND11_EXPORT ParticleData
         //! Remove a particle from the simulation
         void removeParticle(unsigned int tag);
 
+        //! Replicate the local particles to fill a box that is larger by an integer factor along each direction
+        void replicate(unsigned int nx, unsigned int ny, unsigned int nz);
+
+        //! Get one past the largest particle tag issued
+        unsigned int getTagEnd() const
+            {
+            return m_tag_end;
+            }
+
+        //! Get the tags below getTagEnd() of removed particles
+        const std::set<unsigned int>& getRemovedTags() const
+            {
+            return m_removed_tag_set;
+            }
+
+        //! Replace the local particles and the set of active tags
+        void loadLocalParticles(const std::vector<pdata_element>& in,
+                                unsigned int tag_end,
+                                const std::set<unsigned int>& removed_tags);
+
         //! Return the nth active global tag
         unsigned int getNthTag(unsigned int n);
 
@@ -1169,8 +1279,19 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray< Scalar3 > m_inertia;              //!< Principal moments of inertia for each particle
         GlobalArray<unsigned int> m_comm_flags;        //!< Array of communication flags
 
+        GlobalArray<Scalar> m_pos_soa;                 //!< Local particle positions as x, y, and z rows (derived from m_pos)
+        uint64_t m_pos_soa_timestep = 0;               //!< Timestep at which m_pos_soa was last packed
+        bool m_pos_soa_valid = false;                  //!< True when m_pos_soa is up to date for m_pos_soa_timestep
+        bool m_sort_is_permutation = false;            //!< True while notifying a sort that only reordered particles
+
+        Scalar m_disp_bound = 0;                       //!< Upper bound on the displacement of any particle in this epoch
+        uint64_t m_disp_bound_timestep = 0;            //!< Timestep of the positions covered by m_disp_bound
+        uint64_t m_disp_bound_epoch = 0;               //!< Incremented every time m_disp_bound restarts
+        bool m_disp_bound_valid = false;               //!< False when particles may have moved by an unknown amount
+
         std::stack<unsigned int> m_recycled_tags;    //!< Global tags of removed particles
-        std::set<unsigned int> m_tag_set;            //!< Lookup table for tags by active index
+        unsigned int m_tag_end = 0;                  //!< One past the largest tag issued, active tags are [0, m_tag_end)
+        std::set<unsigned int> m_removed_tag_set;    //!< Tags in [0, m_tag_end) of removed particles
         std::vector<unsigned int> m_cached_tag_set;   //!< Cached constant-time lookup table for tags by active index
         bool m_invalid_cached_tags;                  //!< true if m_cached_tag_set needs to be rebuilt
 
@@ -1197,6 +1318,7 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<Scalar4> m_net_force_alt;          //!< Net force (swap-in)
         GlobalArray<Scalar> m_net_virial_alt;             //!< Net virial (swap-in)
         GlobalArray<Scalar4> m_net_torque_alt;         //!< Net torque (swap-in)
+        bool m_low_memory = false;                      //!< True if the alternate arrays are not allocated
 
         std::shared_ptr<Profiler> m_prof;         //!< Pointer to the profiler. NULL if there is no profiler.
 
@@ -1234,6 +1356,9 @@ class PYBIND11_EXPORT ParticleData
         //! Helper function to rebuild the active tag cache if necessary
         void maybe_rebuild_tag_cache();
 
+        //! Build the lookup array from tags to snapshot indices
+        void buildSnapshotIndex(std::vector<unsigned int>& index);
+
         //! Helper function to check that particles of a snapshot are in the box
         /*! \return true If and only if all particles are in the simulation box
          * \param Snapshot to check
@@ -429,6 +429,9 @@ void ParticleGroup::updateMemberTags(bool force_update) const
     // build the reverse lookup table for tags
     buildTagHash();
 
+    // the index arrays have been reallocated
+    m_identity_n = 0;
+
     // now that the tag list is completely set up and all memory is allocated, rebuild the index list
     rebuildIndexList();
     }
@@ -667,21 +670,42 @@ void ParticleGroup::rebuildIndexList() const
     // notice message
     m_pdata->getExecConf()->msg->notice(10) << "ParticleGroup: rebuilding index" << std::endl;
 
+    const unsigned int nparticles = m_pdata->getN();
+    m_identity = m_member_tags.getNumElements() == m_pdata->getNGlobal();
+
+    if (m_identity)
+        {
+        // every local particle is a member in index order, whatever the order of the particles, so only the
+        // indices that were not local at the last rebuild need to be filled in
+        if (nparticles > m_identity_n)
+            {
+            ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+            for (unsigned int idx = m_identity_n; idx < nparticles; idx++)
+                {
+                h_is_member.data[idx] = 1;
+                h_member_idx.data[idx] = idx;
+                }
+            m_identity_n = nparticles;
+            }
+        m_num_local_members = nparticles;
+        }
     #ifdef ENABLE_HIP
-    if (m_pdata->getExecConf()->isCUDAEnabled() )
+    else if (m_pdata->getExecConf()->isCUDAEnabled() )
         {
+        m_identity_n = 0;
         rebuildIndexListGPU();
         }
-    else
     #endif
+    else
         {
+        m_identity_n = 0;
 
         // rebuild the membership flags for the  indices in the group and construct member list
         ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
-        unsigned int nparticles = m_pdata->getN();
         unsigned int cur_member = 0;
         for (unsigned int idx = 0; idx < nparticles; idx ++)
             {
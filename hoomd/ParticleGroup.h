@@ -137,6 +137,11 @@ class PYBIND11_EXPORT ParticleFilterRigidCenter : public ParticleFilter
     For that it needs a list of indices of all the particles in the group. To facilitates this, the list of indices
     in the group will be stored in a GPUArray.
 
+    When the group contains all particles, the j-th local member is the particle with index j in any order of the
+    particles. rebuildIndexList() then only fills in the indices that were not local at the last rebuild, instead of
+    looking up the membership of every particle after each sort, and isIdentity() lets callers skip the indirection
+    through the index list altogether.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT ParticleGroup
@@ -250,6 +255,19 @@ class PYBIND11_EXPORT ParticleGroup
             return m_member_idx;
             }
 
+        //! Test if the group contains all particles
+        /*! \returns true if the local member j is the particle with index j, for all j < getNumMembers()
+
+            \note This method CAN access the particle data tag array if the index is rebuilt.
+                  Hence, the tag array may not be accessed in the same scope in which this method is called.
+        */
+        bool isIdentity() const
+            {
+            checkRebuild();
+
+            return m_identity;
+            }
+
         #ifdef ENABLE_HIP
         //! Return the load balancing GPU partition
         const GPUPartition& getGPUPartition() const
@@ -338,6 +356,8 @@ class PYBIND11_EXPORT ParticleGroup
         mutable bool m_particles_sorted;                //!< True if particle have been sorted since last rebuild
         mutable bool m_reallocated;                     //!< True if particle data arrays have been reallocated
         mutable bool m_global_ptl_num_change;           //!< True if the global particle number changed
+        mutable bool m_identity = false;                //!< True if all particles are members
+        mutable unsigned int m_identity_n = 0;          //!< Number of leading identity entries in the index arrays
 
         mutable GlobalArray<unsigned int> m_is_member_tag;  //!< One byte per particle, == 1 if tag is a member of the group
         std::shared_ptr<ParticleFilter> m_selector; //!< The associated particle selector
@@ -12,6 +12,8 @@
 
 #include <iomanip>
 #include <sstream>
+#include <fstream>
+#include <stdexcept>
 
 
 using namespace std;
@@ -76,8 +78,14 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     \param tab_level Current number of tabs in the tree
     \param total_time Total number of nanoseconds taken by this node
     \param name_width Maximum name width for all siblings of this node (used to align output columns)
+    \param counter_names Names of the hardware counters
  */
-void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_level, int64_t total_time, int name_width) const
+void ProfileDataElem::output(std::ostream &o,
+                             const std::string& name,
+                             int tab_level,
+                             int64_t total_time,
+                             int name_width,
+                             const std::vector<std::string>& counter_names) const
     {
     // create a tab string to output for the current tab level
     string tabs = "";
@@ -100,6 +108,10 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
 
     output_line(o, name, sec, perc, flops, bytes, name_width);
 
+    // the counters of a parent include those of its children, only report leaves
+    if (m_children.size() == 0)
+        output_counters(o, tabs, sec, counter_names);
+
     // start by determining the name width
     map<string, ProfileDataElem>::const_iterator i;
 
@@ -115,7 +127,7 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
     // output each of the children
     for (i = m_children.begin(); i != m_children.end(); ++i)
         {
-        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width);
+        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width, counter_names);
         }
 
     // output an "Self" item to account for time actually spent in this data elem
@@ -188,10 +200,88 @@ void ProfileDataElem::output_line(std::ostream &o,
     o << endl;
     }
 
+/*! \param o Stream to write output to
+    \param tabs Indentation of the leaf
+    \param sec Elapsed time of the leaf in seconds
+    \param counter_names Names of the hardware counters
+
+    Writes the rate of every counter, followed by the metrics that can be derived from the collected counters:
+    - IPC from PAPI_TOT_INS and PAPI_TOT_CYC
+    - miss rates from matching pairs of PAPI_*_?CM and PAPI_*_?CA counters
+    - the memory bandwidth estimated from L3 misses (64 byte lines) and from counters that count bytes, such as the
+      CUPTI metrics dram__bytes_read.sum and dram__bytes_write.sum
+    - the achieved occupancy in active warps per active cycle of each SM from sm__warps_active.sum and
+      sm__cycles_active.sum
+*/
+void ProfileDataElem::output_counters(std::ostream &o,
+                                      const std::string &tabs,
+                                      double sec,
+                                      const std::vector<std::string>& counter_names) const
+    {
+    if (counter_names.empty() || m_counter_total.size() != counter_names.size() || sec == 0)
+        return;
+
+    auto find = [&counter_names](const std::string& suffix) -> int
+        {
+        for (size_t i = 0; i < counter_names.size(); ++i)
+            {
+            const std::string& n = counter_names[i];
+            if (n.size() >= suffix.size() && n.compare(n.size() - suffix.size(), suffix.size(), suffix) == 0)
+                return (int)i;
+            }
+        return -1;
+        };
+
+    o << tabs << "        " << "counters:";
+    for (size_t i = 0; i < counter_names.size(); ++i)
+        o << " " << counter_names[i] << "=" << setprecision(4) << double(m_counter_total[i])/sec << "/s";
+    o << endl;
+
+    ostringstream derived;
+    derived << setiosflags(ios::fixed) << setprecision(3);
+
+    int ins = find("PAPI_TOT_INS");
+    int cyc = find("PAPI_TOT_CYC");
+    if (ins >= 0 && cyc >= 0 && m_counter_total[cyc] > 0)
+        derived << " IPC=" << double(m_counter_total[ins]) / double(m_counter_total[cyc]);
+
+    for (size_t i = 0; i < counter_names.size(); ++i)
+        {
+        const std::string& n = counter_names[i];
+        if (n.size() < 3 || n.compare(n.size() - 2, 2, "CM") != 0)
+            continue;
+        int access = find(n.substr(0, n.size() - 1) + "A");
+        if (access >= 0 && m_counter_total[access] > 0)
+            derived << " " << n.substr(0, n.size() - 2) << "_miss_rate="
+                    << double(m_counter_total[i]) / double(m_counter_total[access]) * 100.0 << "%";
+        }
+
+    double bytes = 0;
+    int l3_miss = find("PAPI_L3_TCM");
+    if (l3_miss >= 0)
+        bytes += 64.0 * double(m_counter_total[l3_miss]);
+    for (size_t i = 0; i < counter_names.size(); ++i)
+        {
+        if (counter_names[i].find("bytes") != std::string::npos)
+            bytes += double(m_counter_total[i]);
+        }
+    if (bytes > 0)
+        derived << " bandwidth=" << bytes / sec / 1e9 << " GB/s";
+
+    int warps = find("sm__warps_active.sum");
+    int sm_cycles = find("sm__cycles_active.sum");
+    if (warps >= 0 && sm_cycles >= 0 && m_counter_total[sm_cycles] > 0)
+        derived << " active_warps_per_cycle=" << double(m_counter_total[warps]) / double(m_counter_total[sm_cycles]);
+
+    if (!derived.str().empty())
+        o << tabs << "        " << "derived: " << derived.str() << endl;
+    }
+
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+Profiler::Profiler(const std::string& name)
+    : m_name(name), m_max_trace_events(0), m_trace_next(0), m_n_trace_dropped(0)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
@@ -204,6 +294,166 @@ Profiler::Profiler(const std::string& name) : m_name(name)
     #endif
     }
 
+Profiler::~Profiler()
+    {
+    #ifdef ENABLE_PAPI
+    for (int& event_set : m_papi_event_sets)
+        {
+        long long *values = m_papi_buffer.data();
+        PAPI_stop(event_set, values);
+        PAPI_cleanup_eventset(event_set);
+        PAPI_destroy_eventset(&event_set);
+        }
+    #endif
+    }
+
+/*! \param events Names of PAPI preset or native events, such as PAPI_TOT_CYC, PAPI_L2_TCM, or
+        cuda:::dram__bytes_read.sum:device=0
+
+    The events are grouped into one event set per PAPI component and counting starts immediately. Counters must be
+    enabled when no range is open, and only once per profiler.
+*/
+void Profiler::enableCounters(const std::vector<std::string>& events)
+    {
+    if (events.empty())
+        return;
+
+    if (m_stack.top() != &m_root)
+        throw runtime_error("Cannot enable hardware counters with open profile ranges");
+
+    #ifdef ENABLE_PAPI
+    if (!m_counter_names.empty())
+        throw runtime_error("Hardware counters are already enabled");
+
+    if (PAPI_is_initialized() == PAPI_NOT_INITED)
+        {
+        int version = PAPI_library_init(PAPI_VER_CURRENT);
+        if (version != PAPI_VER_CURRENT)
+            throw runtime_error("Unable to initialize PAPI");
+        }
+
+    std::vector<int> components;
+    for (const std::string& event : events)
+        {
+        int code = 0;
+        int retval = PAPI_event_name_to_code(const_cast<char *>(event.c_str()), &code);
+        if (retval != PAPI_OK)
+            throw runtime_error("Unknown hardware counter " + event + ": " + PAPI_strerror(retval));
+
+        // events of different components cannot share an event set
+        int component = PAPI_get_event_component(code);
+        size_t set = 0;
+        while (set < components.size() && components[set] != component)
+            ++set;
+        if (set == components.size())
+            {
+            int event_set = PAPI_NULL;
+            retval = PAPI_create_eventset(&event_set);
+            if (retval != PAPI_OK)
+                throw runtime_error(std::string("Unable to create a PAPI event set: ") + PAPI_strerror(retval));
+            components.push_back(component);
+            m_papi_event_sets.push_back(event_set);
+            m_papi_counter.push_back(std::vector<size_t>());
+            }
+
+        retval = PAPI_add_event(m_papi_event_sets[set], code);
+        if (retval != PAPI_OK)
+            throw runtime_error("Unable to count " + event + ": " + PAPI_strerror(retval));
+
+        m_papi_counter[set].push_back(m_counter_names.size());
+        m_counter_names.push_back(event);
+        }
+
+    m_papi_buffer.resize(m_counter_names.size());
+    m_counter_values.resize(m_counter_names.size());
+    for (int event_set : m_papi_event_sets)
+        {
+        int retval = PAPI_start(event_set);
+        if (retval != PAPI_OK)
+            throw runtime_error(std::string("Unable to start the hardware counters: ") + PAPI_strerror(retval));
+        }
+    #else
+    throw runtime_error("Hardware counters require a build with ENABLE_PAPI");
+    #endif
+    }
+
+/*! \param values Vector to read the counters into, resized to the number of counters
+*/
+void Profiler::readCounters(std::vector<long long>& values)
+    {
+    values.resize(m_counter_names.size());
+    #ifdef ENABLE_PAPI
+    for (size_t set = 0; set < m_papi_event_sets.size(); ++set)
+        {
+        PAPI_read(m_papi_event_sets[set], m_papi_buffer.data());
+        for (size_t i = 0; i < m_papi_counter[set].size(); ++i)
+            values[m_papi_counter[set][i]] = m_papi_buffer[i];
+        }
+    #endif
+    }
+
+/*! \param max_events Maximum number of ranges to keep
+
+    Ranges are recorded when they are popped. Once \a max_events ranges are recorded, each new range overwrites the
+    oldest one. Tracing must be enabled when no range is open.
+*/
+void Profiler::enableTrace(size_t max_events)
+    {
+    if (m_stack.top() != &m_root)
+        throw runtime_error("Cannot enable tracing with open profile ranges");
+
+    m_max_trace_events = max_events;
+    m_trace.clear();
+    m_trace.reserve(max_events);
+    m_trace_next = 0;
+    m_n_trace_dropped = 0;
+    }
+
+/*! \param filename File to write
+    \param pid Process id to label the ranges with in the trace (the MPI rank)
+
+    The ranges are written as complete ("X") events with times in microseconds since the construction of the profiler,
+    one track per process. The number of ranges that were overwritten is stored in the metadata of the trace.
+*/
+void Profiler::writeTrace(const std::string& filename, unsigned int pid)
+    {
+    ofstream f(filename.c_str());
+    if (!f.good())
+        throw runtime_error("Unable to open trace file " + filename);
+
+    f << "{\"traceEvents\":[" << endl;
+    f << setprecision(15);
+
+    // the oldest event is at m_trace_next once the ring buffer is full
+    const size_t n = m_trace.size();
+    const size_t first = (n < m_max_trace_events) ? 0 : m_trace_next;
+    for (size_t i = 0; i < n; ++i)
+        {
+        const TraceEvent& event = m_trace[(first + i) % n];
+
+        // escape the characters that are not allowed in JSON strings
+        string name;
+        for (char c : *event.name)
+            {
+            if (c == '"' || c == '\\')
+                name += '\\';
+            name += c;
+            }
+
+        f << "{\"name\":\"" << name << "\",\"cat\":\"hoomd\",\"ph\":\"X\""
+          << ",\"ts\":" << double(event.start - m_root.m_start_time) / 1e3
+          << ",\"dur\":" << double(event.end - event.start) / 1e3
+          << ",\"pid\":" << pid << ",\"tid\":0"
+          << ",\"args\":{\"depth\":" << event.depth << "}}";
+        if (i + 1 < n)
+            f << ",";
+        f << endl;
+        }
+
+    f << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"profile\":\"" << m_name
+      << "\",\"dropped_events\":" << m_n_trace_dropped << "}}" << endl;
+    }
+
 void Profiler::output(std::ostream &o)
     {
     // perform a sanity check, but don't bail out
@@ -220,7 +470,7 @@ void Profiler::output(std::ostream &o)
     m_root.m_elapsed_time = m_clk.getTime() - m_root.m_start_time;
 
     // startup the recursive output process
-    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size());
+    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size(), m_counter_names);
     }
 
 /*! \param o Stream to output to
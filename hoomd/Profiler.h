@@ -23,9 +23,14 @@
 #include <nvToolsExt.h>
 #endif
 
+#ifdef ENABLE_PAPI
+#include <papi.h>
+#endif
+
 #include <string>
 #include <stack>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <cassert>
 
@@ -77,7 +82,12 @@ class PYBIND11_EXPORT ProfileDataElem
         int64_t getTotalMemByteCount() const;
 
         //! Output helper function
-        void output(std::ostream &o, const std::string &name, int tab_level, int64_t total_time, int name_width) const;
+        void output(std::ostream &o,
+                    const std::string &name,
+                    int tab_level,
+                    int64_t total_time,
+                    int name_width,
+                    const std::vector<std::string>& counter_names) const;
         //! Another output helper function
         void output_line(std::ostream &o,
                          const std::string &name,
@@ -86,6 +96,11 @@ class PYBIND11_EXPORT ProfileDataElem
                          double flops,
                          double bytes,
                          unsigned int name_width) const;
+        //! Output the hardware counters of a leaf
+        void output_counters(std::ostream &o,
+                             const std::string &tabs,
+                             double sec,
+                             const std::vector<std::string>& counter_names) const;
 
         std::map<std::string, ProfileDataElem> m_children; //!< Child nodes of this profile
 
@@ -94,6 +109,9 @@ class PYBIND11_EXPORT ProfileDataElem
         int64_t m_flop_count;   //!< A running total of floating point operations
         int64_t m_mem_byte_count;   //!< A running total of memory bytes transferred
 
+        std::vector<long long> m_counter_start; //!< Hardware counter values at the start of the most recent event
+        std::vector<long long> m_counter_total; //!< Running totals of the hardware counters
+
         #ifdef SCOREP_USER_ENABLE
         SCOREP_User_RegionHandle m_scorep_region;   //!< ScoreP region identifier
         #endif
@@ -118,6 +136,16 @@ class PYBIND11_EXPORT ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    With enableCounters(), hardware performance counters are read with PAPI at every push() and pop(), and the
+    difference is accumulated in each range. PAPI components also provide GPU counters (CUPTI on NVIDIA GPUs,
+    rocprofiler on AMD GPUs), so that both CPU and GPU counters can be collected around the same ranges. The output
+    lists the counter rates below each leaf together with derived metrics, such as the instructions per cycle, cache
+    miss rates, and the achieved memory bandwidth. Counters require a build with ENABLE_PAPI.
+
+    In trace mode (enableTrace()), every pop() also records the start and end time of the range in a ring buffer of
+    fixed capacity, so that the memory use stays bounded in long runs. writeTrace() writes the recorded ranges in the
+    Chrome trace event format, which chrome://tracing and Perfetto can display as a timeline.
     \ingroup utils
     */
 class PYBIND11_EXPORT Profiler
@@ -125,6 +153,8 @@ class PYBIND11_EXPORT Profiler
     public:
         //! Constructs an empty profiler and starts its timer ticking
         Profiler(const std::string& name = "Profile");
+        //! Destructor
+        ~Profiler();
         //! Pushes a new sub-category into the current category
         void push(const std::string& name);
         //! Pops back up to the next super-category
@@ -135,12 +165,47 @@ class PYBIND11_EXPORT Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Record the time of every range, keeping at most \a max_events of the most recent ranges
+        void enableTrace(size_t max_events);
+
+        //! Write the recorded ranges to a Chrome trace file
+        void writeTrace(const std::string& filename, unsigned int pid);
+
+        //! Collect the named hardware performance counters in every range
+        void enableCounters(const std::vector<std::string>& events);
+
     private:
+        //! A timed range recorded in trace mode
+        struct TraceEvent
+            {
+            const std::string *name;    //!< Name of the range (points to the key in the profile tree)
+            int64_t start;              //!< Start time of the range
+            int64_t end;                //!< End time of the range
+            unsigned int depth;         //!< Nesting depth of the range
+            };
+
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
 
+        std::vector<TraceEvent> m_trace;                //!< Ring buffer of recorded ranges
+        size_t m_max_trace_events;                      //!< Capacity of the ring buffer (0 when not tracing)
+        size_t m_trace_next;                            //!< Index of the next event to write in the ring buffer
+        uint64_t m_n_trace_dropped;                     //!< Number of ranges overwritten in the ring buffer
+        std::stack<const std::string *> m_name_stack;   //!< Names of the open ranges in trace mode
+
+        std::vector<std::string> m_counter_names;       //!< Names of the hardware counters (empty when disabled)
+        std::vector<long long> m_counter_values;        //!< Scratch space for reading the counters
+        #ifdef ENABLE_PAPI
+        std::vector<int> m_papi_event_sets;                 //!< One PAPI event set per component
+        std::vector< std::vector<size_t> > m_papi_counter;  //!< Counter index of each event in each event set
+        std::vector<long long> m_papi_buffer;               //!< Buffer for reading one event set
+        #endif
+
+        //! Read all hardware counters into \a values
+        void readCounters(std::vector<long long>& values);
+
         //! Output helper function
         void output(std::ostream &o);
 
@@ -206,6 +271,13 @@ inline void Profiler::push(const std::string& name)
     // and updating the stack
     m_stack.push(&cur->m_children[name]);
 
+    if (!m_counter_names.empty())
+        readCounters(m_stack.top()->m_counter_start);
+
+    // the keys of the profile tree are stable, so the trace can refer to them
+    if (m_max_trace_events)
+        m_name_stack.push(&cur->m_children.find(name)->first);
+
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
     SCOREP_USER_REGION_BEGIN( cur->m_children[name].m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
@@ -236,6 +308,30 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     cur->m_flop_count += flop_count;
     cur->m_mem_byte_count += byte_count;
 
+    // accumulate the hardware counters of the range
+    if (!m_counter_names.empty())
+        {
+        readCounters(m_counter_values);
+        cur->m_counter_total.resize(m_counter_values.size());
+        for (size_t i = 0; i < m_counter_values.size(); ++i)
+            cur->m_counter_total[i] += m_counter_values[i] - cur->m_counter_start[i];
+        }
+
+    // record the range, overwriting the oldest one when the buffer is full
+    if (m_max_trace_events && !m_name_stack.empty())
+        {
+        TraceEvent event = {m_name_stack.top(), cur->m_start_time, t, (unsigned int)(m_stack.size() - 2)};
+        if (m_trace.size() < m_max_trace_events)
+            m_trace.push_back(event);
+        else
+            {
+            m_trace[m_trace_next] = event;
+            m_n_trace_dropped++;
+            }
+        m_trace_next = (m_trace_next + 1) % m_max_trace_events;
+        m_name_stack.pop();
+        }
+
     // and finally popping the stack so that the next pop will access the correct element
     m_stack.pop();
     }
@@ -19,7 +19,8 @@ void export_HOOMDHostBuffer(pybind11::module &m)
                 {
                 return b.new_buffer();
                 })
-        .def_property_readonly("read_only", &HOOMDHostBuffer::getReadOnly);
+        .def_property_readonly("read_only", &HOOMDHostBuffer::getReadOnly)
+        .def_property_readonly("key", &HOOMDHostBuffer::getKey)
         ;
     }
 
@@ -30,7 +31,8 @@ void export_HOOMDDeviceBuffer(pybind11::module &m)
     pybind11::class_<HOOMDDeviceBuffer>(m, "HOOMDDeviceBuffer")
         .def_property_readonly("__cuda_array_interface__",
                                &HOOMDDeviceBuffer::getCudaArrayInterface)
-        .def_property_readonly("read_only", &HOOMDDeviceBuffer::getReadOnly);
+        .def_property_readonly("read_only", &HOOMDDeviceBuffer::getReadOnly)
+        .def_property_readonly("key", &HOOMDDeviceBuffer::getKey)
         ;
     }
 #endif
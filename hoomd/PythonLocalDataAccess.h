@@ -39,6 +39,25 @@ struct HOOMDBuffer {
         }
 
     bool getReadOnly() const {return m_read_only;}
+
+    /// Identify the exposed memory.
+    /** Two buffers with equal keys expose the same memory with the same layout,
+     *  so Python can keep using the views it created for the first buffer
+     *  instead of creating new ones.
+     */
+    pybind11::tuple getKey() const
+        {
+        pybind11::list key;
+        key.append((intptr_t)m_data);
+        key.append(m_typestr);
+        key.append(m_read_only);
+        for (size_t i = 0; i < m_shape.size(); i++)
+            {
+            key.append(m_shape[i]);
+            key.append(m_strides[i]);
+            }
+        return pybind11::tuple(key);
+        }
 };
 
 
@@ -84,7 +103,9 @@ struct HOOMDHostBuffer : public HOOMDBuffer
 #if ENABLE_HIP
 /// Represents the data required to implement the __cuda_array_interface__.
 /** Creates the Python dictionary to represent a GPU array through the
- *  __cuda_array_interface__. Currently supports version 2 of the protocol.
+ *  __cuda_array_interface__. Supports version 3 of the protocol, which lets
+ *  consumers order their work after HOOMD's kernels on the given stream
+ *  instead of synchronizing the device.
  */
 struct HOOMDDeviceBuffer : public HOOMDBuffer
     {
@@ -103,7 +124,7 @@ struct HOOMDDeviceBuffer : public HOOMDBuffer
                                  shape, strides, read_only);
         }
 
-    /// Convert object to a __cuda_array_interface__ v2 compliant Python dict.
+    /// Convert object to a __cuda_array_interface__ v3 compliant Python dict.
     /** We can't only add the existing values in the HOOMDDeviceBuffer because
      *  CuPy and potentially other packages that use the interface can't handle
      *  a shape where the first dimension is zero and the rest are non-zero. In
@@ -133,7 +154,9 @@ struct HOOMDDeviceBuffer : public HOOMDBuffer
             }
         auto interface = pybind11::dict();
         interface["typestr"] = m_typestr;
-        interface["version"] = 2;
+        interface["version"] = 3;
+        // HOOMD launches its kernels on the legacy default stream (1 in the protocol)
+        interface["stream"] = 1;
         interface["data"] = data;
         interface["shape"] = pybind11::tuple(shape);
         interface["strides"] = pybind11::tuple(strides);
@@ -63,6 +63,10 @@ struct RNGIdentifier
     static const uint8_t HPMCDepletantNumClusters = 38;
     static const uint8_t HPMCMonoPatch = 39;
     static const uint8_t UpdaterClusters2 = 40;
+    static const uint8_t HPMCMonoCheckerboard = 41;
+    static const uint8_t UpdaterEventChain = 42;
+    static const uint8_t UpdaterReplicaExchange = 43;
+    static const uint8_t HPMCMonoExternal = 44;
     };
 
 }
@@ -336,6 +336,22 @@ class UniformDistribution
             return a + width * detail::generate_canonical<Real>(rng);
             }
 
+        //! Draw two values from the distribution
+        /*! \param out1 [out] First output
+            \param out2 [out] Second output
+            \param rng Random number generator
+
+            Both values come from a single evaluation of the generator, which is half the cost of two draws.
+        */
+        template<typename RNG>
+        DEVICE inline void operator()(Real& out1, Real& out2, RNG& rng)
+            {
+            uint64_t u0, u1;
+            detail::generate_2u64(u0, u1, rng);
+            out1 = a + width * r123::u01<Real>(u0);
+            out2 = a + width * r123::u01<Real>(u1);
+            }
+
     private:
         const Real a;     //!< Left end point of the interval
         const Real width; //!< Width of the interval
@@ -380,6 +396,8 @@ class NormalDistribution
             \param out2 [out] Second output
             \param rng Random number generator
             \returns normally distributed random value in with standard deviation *sigma* and mean *mu*.
+
+            Both values come from a single evaluation of the generator, which is half the cost of two draws.
         */
         template<typename RNG>
         DEVICE inline void operator()(Real& out1, Real& out2, RNG& rng)
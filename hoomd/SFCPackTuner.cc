@@ -24,7 +24,7 @@ namespace py = pybind11;
  */
 SFCPackTuner::SFCPackTuner(std::shared_ptr<SystemDefinition> sysdef,
                            std::shared_ptr<Trigger> trigger)
-        : Tuner(sysdef, trigger), m_last_grid(0), m_last_dim(0)
+        : Tuner(sysdef, trigger), m_sort_bonded_groups(false), m_adaptive(false), m_last_grid(0), m_last_dim(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing SFCPackTuner" << endl;
 
@@ -33,6 +33,9 @@ SFCPackTuner::SFCPackTuner(std::shared_ptr<SystemDefinition> sysdef,
 
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_particle_keys.resize(m_pdata->getMaxN());
+    m_particle_keys_alt.resize(m_pdata->getMaxN());
+    m_sort_order_alt.resize(m_pdata->getMaxN());
 
     // set the default grid
     // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order
@@ -52,6 +55,9 @@ void SFCPackTuner::reallocate()
     {
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_particle_keys.resize(m_pdata->getMaxN());
+    m_particle_keys_alt.resize(m_pdata->getMaxN());
+    m_sort_order_alt.resize(m_pdata->getMaxN());
     }
 
 /*! Destructor
@@ -87,7 +93,9 @@ void SFCPackTuner::update(uint64_t timestep)
     if (m_prof) m_prof->push(m_exec_conf, "SFCPack");
 
     // figure out the sort order we need to apply
-    if (m_sysdef->getNDimensions() == 2)
+    if (m_adaptive)
+        getSortedOrderAdaptive();
+    else if (m_sysdef->getNDimensions() == 2)
         getSortedOrder2D();
     else
         getSortedOrder3D();
@@ -95,8 +103,11 @@ void SFCPackTuner::update(uint64_t timestep)
     // apply that sort order to the particles
     applySortOrder();
 
-    // trigger sort signal (this also forces particle migration)
-    m_pdata->notifyParticleSort();
+    // trigger sort signal (this also forces particle migration), the sort only permutes the particles
+    m_pdata->notifyParticleSort(true);
+
+    if (m_sort_bonded_groups)
+        sortBondedGroups();
 
     #ifdef ENABLE_MPI
     if (m_comm)
@@ -109,10 +120,29 @@ void SFCPackTuner::update(uint64_t timestep)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*! Groups are reordered only here, after the particles have been migrated and sorted, so that the group tables are
+    consistent with the particle data.
+ */
+void SFCPackTuner::sortBondedGroups()
+    {
+    m_sysdef->getBondData()->sortGroups();
+    m_sysdef->getAngleData()->sortGroups();
+    m_sysdef->getDihedralData()->sortGroups();
+    m_sysdef->getImproperData()->sortGroups();
+    m_sysdef->getConstraintData()->sortGroups();
+    m_sysdef->getPairData()->sortGroups();
+    }
+
 void SFCPackTuner::applySortOrder()
     {
     assert(m_pdata);
     assert(m_sort_order.size() >= m_pdata->getN());
+
+    if (m_pdata->getLowMemory())
+        {
+        applySortOrderInPlace();
+        return;
+        }
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
@@ -584,6 +614,119 @@ void SFCPackTuner::getSortedOrder3D()
         }
     }
 
+//! Spread the lower 21 bits of \a v so that two zero bits separate each of them
+static inline uint64_t morton_spread3(uint64_t v)
+    {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+    }
+
+//! Spread the 32 bits of \a v so that a zero bit separates each of them
+static inline uint64_t morton_spread2(uint64_t v)
+    {
+    v &= 0xffffffff;
+    v = (v | v << 16) & 0x0000ffff0000ffffULL;
+    v = (v | v << 8) & 0x00ff00ff00ff00ffULL;
+    v = (v | v << 4) & 0x0f0f0f0f0f0f0f0fULL;
+    v = (v | v << 2) & 0x3333333333333333ULL;
+    v = (v | v << 1) & 0x5555555555555555ULL;
+    return v;
+    }
+
+//! Quantize a fractional coordinate to \a bits bits, clamping particles that are slightly outside the box
+static inline uint64_t morton_quantize(Scalar f, unsigned int bits)
+    {
+    const uint64_t max_q = (uint64_t(1) << bits) - 1;
+    Scalar q = f * Scalar(uint64_t(1) << bits);
+    if (q < Scalar(0.0))
+        return 0;
+    if (q >= Scalar(max_q))
+        return max_q;
+    return (uint64_t)q;
+    }
+
+/*! Every particle gets a 64-bit Morton key of its fractional coordinates. The keys are ordered with a least
+    significant digit radix sort using 16-bit digits, which is stable and linear in the number of particles. Digits
+    that are equal for all particles are skipped.
+*/
+void SFCPackTuner::getSortedOrderAdaptive()
+    {
+    assert(m_pdata);
+    assert(m_particle_keys.size() >= m_pdata->getN());
+
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int N = m_pdata->getN();
+    const bool twod = m_sysdef->getNDimensions() == 2;
+
+    // compute the keys
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    for (unsigned int n = 0; n < N; n++)
+        {
+        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
+
+        uint64_t key;
+        if (twod)
+            key = (morton_spread2(morton_quantize(f.x, 32)) << 1) | morton_spread2(morton_quantize(f.y, 32));
+        else
+            key = (morton_spread3(morton_quantize(f.x, 21)) << 2)
+                | (morton_spread3(morton_quantize(f.y, 21)) << 1)
+                | morton_spread3(morton_quantize(f.z, 21));
+
+        m_particle_keys[n] = key;
+        m_sort_order[n] = n;
+        }
+    }
+
+    // radix sort the keys together with the particle indices
+    const unsigned int radix = 1 << 16;
+    std::vector<unsigned int> count(radix);
+    uint64_t *keys = m_particle_keys.data();
+    uint64_t *keys_alt = m_particle_keys_alt.data();
+    unsigned int *order = m_sort_order.data();
+    unsigned int *order_alt = m_sort_order_alt.data();
+
+    for (unsigned int shift = 0; shift < 64; shift += 16)
+        {
+        std::fill(count.begin(), count.end(), 0);
+        for (unsigned int n = 0; n < N; n++)
+            count[(keys[n] >> shift) & (radix-1)]++;
+
+        // all keys share this digit
+        if (N == 0 || count[(keys[0] >> shift) & (radix-1)] == N)
+            continue;
+
+        unsigned int offset = 0;
+        for (unsigned int d = 0; d < radix; d++)
+            {
+            unsigned int c = count[d];
+            count[d] = offset;
+            offset += c;
+            }
+
+        for (unsigned int n = 0; n < N; n++)
+            {
+            unsigned int dst = count[(keys[n] >> shift) & (radix-1)]++;
+            keys_alt[dst] = keys[n];
+            order_alt[dst] = order[n];
+            }
+
+        std::swap(keys, keys_alt);
+        std::swap(order, order_alt);
+        }
+
+    // the sorted order may have ended up in the scratch buffer
+    if (order != m_sort_order.data())
+        std::copy(order, order + N, m_sort_order.begin());
+    }
+
 void SFCPackTuner::writeTraversalOrder(const std::string& fname, const vector< unsigned int >& reverse_order)
     {
     m_exec_conf->msg->notice(2) << "sorter: Writing space filling curve traversal order to " << fname << endl;
@@ -614,6 +757,117 @@ void SFCPackTuner::writeTraversalOrder(const std::string& fname, const vector< u
         }
     }
 
+//! Permute an array in place
+/*! \param data Array to permute, element i is replaced by element order[i]
+    \param order The permutation
+    \param visited Scratch flags, one per element
+    \param N Number of elements
+
+    The permutation is applied by following its cycles, so only one element is held outside of the array.
+*/
+template<class T>
+static void permute_in_place(T *data, const unsigned int *order, std::vector<bool>& visited, unsigned int N)
+    {
+    std::fill(visited.begin(), visited.begin() + N, false);
+    for (unsigned int start = 0; start < N; start++)
+        {
+        if (visited[start])
+            continue;
+
+        T first = data[start];
+        unsigned int i = start;
+        while (true)
+            {
+            visited[i] = true;
+            unsigned int next = order[i];
+            if (next == start)
+                {
+                data[i] = first;
+                break;
+                }
+            data[i] = data[next];
+            i = next;
+            }
+        }
+    }
+
+/*! Unlike applySortOrder(), this method allocates no temporary arrays of particle data. The cycles of the sort order
+    are followed in each array in turn, at the cost of scattered memory accesses.
+*/
+void SFCPackTuner::applySortOrderInPlace()
+    {
+    const unsigned int N = m_pdata->getN();
+    const unsigned int *order = m_sort_order.data();
+    std::vector<bool> visited(N);
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_pos.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_vel.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_accel.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_charge.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_diameter.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host,
+                                      access_mode::readwrite);
+        permute_in_place(h_angmom.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host,
+                                       access_mode::readwrite);
+        permute_in_place(h_inertia.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
+        size_t virial_pitch = m_pdata->getNetVirial().getPitch();
+        for (unsigned int j = 0; j < 6; j++)
+            permute_in_place(h_net_virial.data + j*virial_pitch, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_net_force.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host,
+                                          access_mode::readwrite);
+        permute_in_place(h_net_torque.data, order, visited, N);
+        }
+        {
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host,
+                                           access_mode::readwrite);
+        permute_in_place(h_orientation.data, order, visited, N);
+        }
+        {
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_image.data, order, visited, N);
+        }
+        {
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::readwrite);
+        permute_in_place(h_body.data, order, visited, N);
+        }
+
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+    permute_in_place(h_tag.data, order, visited, N);
+
+    // rebuild global rtag
+    for (unsigned int i = 0; i < N; i++)
+        h_rtag.data[h_tag.data[i]] = i;
+    }
+
 void export_SFCPackTuner(py::module& m)
     {
     py::class_<SFCPackTuner, Tuner, std::shared_ptr<SFCPackTuner> >(m,"SFCPackTuner")
@@ -621,5 +875,11 @@ void export_SFCPackTuner(py::module& m)
                    std::shared_ptr<Trigger> >())
     .def_property("grid", &SFCPackTuner::getGrid,
                           &SFCPackTuner::setGridPython)
+    .def_property("sort_bonded_groups", &SFCPackTuner::getSortBondedGroups,
+                          &SFCPackTuner::setSortBondedGroups)
+    .def_property("low_memory", &SFCPackTuner::getLowMemory,
+                          &SFCPackTuner::setLowMemory)
+    .def_property("adaptive", &SFCPackTuner::getAdaptive,
+                          &SFCPackTuner::setAdaptive)
     ;
     }
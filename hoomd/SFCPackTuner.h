@@ -37,13 +37,19 @@
     Usage:<br>
     Constructe the SFCPackTuner, attaching it to the ParticleData. The grid size is automatically set to reasonable
     defaults, which is as high as it can possibly go without consuming a significant amount of memory. The grid
-    dimension can be changed by calling setGrid().
+    dimension can be changed by calling setGrid(). With setSortBondedGroups(), the bonded group tables are reordered
+    to follow the new particle order after every sort, which improves the locality of bonded force computations.
 
     Implementation details:<br>
     The rearranging is done by computing bins for the particles, and then ordering the particles based on the order in
     which those bins appear along a hilbert curve. It is very efficient, even when the box size changes often as the
     grid dimension is kept constant.
 
+    With setAdaptive(), the grid is not used. Instead, each particle gets a 64-bit Morton key computed from its
+    fractional coordinates (21 bits per dimension in 3D, 32 in 2D) and the keys are ordered with a radix sort. The
+    resolution of the curve then follows the particles, so that locality does not degrade in dense regions such as
+    droplets or polymer globules, and no memory is spent on empty regions of the box.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT SFCPackTuner : public Tuner
@@ -81,8 +87,49 @@ class PYBIND11_EXPORT SFCPackTuner : public Tuner
             return m_grid;
             }
 
+        //! Set whether to reorder the bonded group tables after each sort
+        void setSortBondedGroups(bool sort_bonded_groups)
+            {
+            m_sort_bonded_groups = sort_bonded_groups;
+            }
+
+        //! Get whether the bonded group tables are reordered after each sort
+        bool getSortBondedGroups()
+            {
+            return m_sort_bonded_groups;
+            }
+
+        //! Set whether to sort in place without the alternate particle data arrays
+        /*! \param low_memory True to release the alternate arrays of the particle data
+            \sa ParticleData::setLowMemory()
+        */
+        void setLowMemory(bool low_memory)
+            {
+            m_pdata->setLowMemory(low_memory);
+            }
+
+        //! Get whether the particles are sorted in place
+        bool getLowMemory()
+            {
+            return m_pdata->getLowMemory();
+            }
+
+        //! Set whether to order the particles by Morton keys of their continuous coordinates
+        void setAdaptive(bool adaptive)
+            {
+            m_adaptive = adaptive;
+            }
+
+        //! Get whether the particles are ordered by Morton keys of their continuous coordinates
+        bool getAdaptive()
+            {
+            return m_adaptive;
+            }
+
     protected:
         unsigned int m_grid;        //!< Grid dimension to use
+        bool m_sort_bonded_groups;  //!< True if the bonded group tables follow the particle order
+        bool m_adaptive;            //!< True if the sort uses Morton keys instead of the grid
         unsigned int m_last_grid;   //!< The last value of MMax
         unsigned int m_last_dim;    //!< Check the last dimension we ran at
         GPUArray< unsigned int > m_traversal_order;      //!< Generated traversal order of bins
@@ -91,10 +138,18 @@ class PYBIND11_EXPORT SFCPackTuner : public Tuner
         virtual void getSortedOrder2D();
         //! Helper function that actually performs the sort
         virtual void getSortedOrder3D();
+        //! Helper function that performs the sort by Morton keys of the continuous coordinates
+        virtual void getSortedOrderAdaptive();
 
         //! Apply the sorted order to the particle data
         virtual void applySortOrder();
 
+        //! Apply the sorted order to the particle data in place, one array at a time
+        void applySortOrderInPlace();
+
+        //! Reorder the bonded group tables to follow the particle order
+        void sortBondedGroups();
+
         //! Helper function to generate traversal order
         static void generateTraversalOrder(int i, int j, int k, int w, int Mx, unsigned int cell_order[8], std::vector< unsigned int > &traversal_order);
 
@@ -107,6 +162,9 @@ class PYBIND11_EXPORT SFCPackTuner : public Tuner
     private:
         std::vector<unsigned int> m_sort_order;             //!< Generated sort order of the particles
         std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins;    //!< Binned particles
+        std::vector<uint64_t> m_particle_keys;              //!< Morton keys of the particles
+        std::vector<uint64_t> m_particle_keys_alt;          //!< Radix sort buffer for the keys
+        std::vector<unsigned int> m_sort_order_alt;         //!< Radix sort buffer for the order
         std::shared_ptr<Trigger> m_trigger;
 
    };
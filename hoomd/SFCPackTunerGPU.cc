@@ -134,11 +134,36 @@ void SFCPackTunerGPU::getSortedOrder3D()
     if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
     }
 
+void SFCPackTunerGPU::getSortedOrderAdaptive()
+    {
+    assert(m_pdata);
+    assert(m_gpu_sort_order.getNumElements() >= m_pdata->getN());
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_sort_order(m_gpu_sort_order, access_location::device, access_mode::overwrite);
+
+    // compute the keys and radix sort them
+    gpu_generate_sorted_order_adaptive(m_pdata->getN(),
+        d_pos.data,
+        d_gpu_sort_order.data,
+        m_pdata->getBox(),
+        m_sysdef->getNDimensions() == 2,
+        m_exec_conf->getCachedAllocator());
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    }
+
 void SFCPackTunerGPU::applySortOrder()
     {
     assert(m_pdata);
     assert(m_gpu_sort_order.getNumElements() >= m_pdata->getN());
 
+    if (m_pdata->getLowMemory())
+        {
+        applySortOrderLowMemory();
+        return;
+        }
+
         {
         // access alternate arrays to write to
         ArrayHandle<Scalar4> d_pos_alt(m_pdata->getAltPositions(), access_location::device, access_mode::overwrite);
@@ -235,6 +260,84 @@ void SFCPackTunerGPU::applySortOrder()
     m_pdata->swapNetTorque();
     }
 
+/*! Each array is gathered into a scratch buffer of N elements of the largest type and copied back, so the peak
+    memory of the sort is one buffer instead of the alternate copy of the whole particle data.
+*/
+void SFCPackTunerGPU::applySortOrderLowMemory()
+    {
+    const unsigned int N = m_pdata->getN();
+
+    ScopedAllocation<Scalar4> d_scratch(m_exec_conf->getCachedAllocator(), N);
+    ArrayHandle<unsigned int> d_gpu_sort_order(m_gpu_sort_order, access_location::device, access_mode::read);
+    const unsigned int *order = d_gpu_sort_order.data;
+
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_pos.data, d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_vel.data, d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_accel.data, (Scalar3 *)d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar> d_charge(m_pdata->getCharges(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_charge.data, (Scalar *)d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_diameter.data, (Scalar *)d_scratch.data);
+        }
+        {
+        ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_image.data, (int3 *)d_scratch.data);
+        }
+        {
+        ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_body.data, (unsigned int *)d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device,
+                                           access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_orientation.data, d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device,
+                                      access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_angmom.data, d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device,
+                                       access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_inertia.data, (Scalar3 *)d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar> d_net_virial(m_pdata->getNetVirial(), access_location::device, access_mode::readwrite);
+        size_t virial_pitch = m_pdata->getNetVirial().getPitch();
+        for (unsigned int j = 0; j < 6; j++)
+            gpu_permute_sorted_order(N, order, d_net_virial.data + j*virial_pitch, (Scalar *)d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar4> d_net_force(m_pdata->getNetForce(), access_location::device, access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_net_force.data, d_scratch.data);
+        }
+        {
+        ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device,
+                                          access_mode::readwrite);
+        gpu_permute_sorted_order(N, order, d_net_torque.data, d_scratch.data);
+        }
+
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::readwrite);
+    gpu_permute_sorted_order(N, order, d_tag.data, (unsigned int *)d_scratch.data);
+    gpu_update_sorted_rtags(N, d_tag.data, d_rtag.data);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    }
+
 void export_SFCPackTunerGPU(py::module& m)
     {
     py::class_<SFCPackTunerGPU, SFCPackTuner, std::shared_ptr<SFCPackTunerGPU> >(m,"SFCPackTunerGPU")
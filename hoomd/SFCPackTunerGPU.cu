@@ -16,6 +16,7 @@
 #include <thrust/sort.h>
 #include <thrust/execution_policy.h>
 #include <thrust/device_ptr.h>
+#include <hipcub/hipcub.hpp>
 #pragma GCC diagnostic pop
 
 #include "SFCPackTunerGPU.cuh"
@@ -115,6 +116,133 @@ void gpu_generate_sorted_order(unsigned int N,
         }
     }
 
+//! Spread the lower 21 bits of \a v so that two zero bits separate each of them
+__device__ inline uint64_t gpu_morton_spread3(uint64_t v)
+    {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8) & 0x100f00f00f00f00fULL;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+    }
+
+//! Spread the 32 bits of \a v so that a zero bit separates each of them
+__device__ inline uint64_t gpu_morton_spread2(uint64_t v)
+    {
+    v &= 0xffffffff;
+    v = (v | v << 16) & 0x0000ffff0000ffffULL;
+    v = (v | v << 8) & 0x00ff00ff00ff00ffULL;
+    v = (v | v << 4) & 0x0f0f0f0f0f0f0f0fULL;
+    v = (v | v << 2) & 0x3333333333333333ULL;
+    v = (v | v << 1) & 0x5555555555555555ULL;
+    return v;
+    }
+
+//! Quantize a fractional coordinate to \a bits bits, clamping particles that are slightly outside the box
+__device__ inline uint64_t gpu_morton_quantize(Scalar f, unsigned int bits)
+    {
+    const uint64_t max_q = (uint64_t(1) << bits) - 1;
+    Scalar q = f * Scalar(uint64_t(1) << bits);
+    if (q < Scalar(0.0))
+        return 0;
+    if (q >= Scalar(max_q))
+        return max_q;
+    return (uint64_t)q;
+    }
+
+//! Kernel to compute the Morton keys of the particles
+template<bool twod>
+__global__ void gpu_sfc_morton_keys_kernel(unsigned int N,
+    const Scalar4 *d_pos,
+    uint64_t *d_keys,
+    unsigned int *d_values,
+    const BoxDim box)
+    {
+    unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N) return;
+
+    Scalar4 postype = d_pos[idx];
+    Scalar3 p = make_scalar3(postype.x, postype.y, postype.z);
+    Scalar3 f = box.makeFraction(p);
+
+    uint64_t key;
+    if (twod)
+        key = (gpu_morton_spread2(gpu_morton_quantize(f.x, 32)) << 1)
+            | gpu_morton_spread2(gpu_morton_quantize(f.y, 32));
+    else
+        key = (gpu_morton_spread3(gpu_morton_quantize(f.x, 21)) << 2)
+            | (gpu_morton_spread3(gpu_morton_quantize(f.y, 21)) << 1)
+            | gpu_morton_spread3(gpu_morton_quantize(f.z, 21));
+
+    d_keys[idx] = key;
+    d_values[idx] = idx;
+    }
+
+/*! \param N number of local particles
+    \param d_pos Device array of positions
+    \param d_sorted_order Sorted order of particles
+    \param box Box dimensions
+    \param twod If true, compute the keys in two dimensions
+    \param alloc Allocator for the keys and the temporary storage of the radix sort
+    */
+void gpu_generate_sorted_order_adaptive(unsigned int N,
+        const Scalar4 *d_pos,
+        unsigned int *d_sorted_order,
+        const BoxDim& box,
+        bool twod,
+        CachedAllocator& alloc)
+    {
+    if (!N)
+        return;
+
+    uint64_t *d_keys = alloc.getTemporaryBuffer<uint64_t>(N);
+    uint64_t *d_keys_sorted = alloc.getTemporaryBuffer<uint64_t>(N);
+    unsigned int *d_values = alloc.getTemporaryBuffer<unsigned int>(N);
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N/block_size + 1;
+
+    if (twod)
+        hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_sfc_morton_keys_kernel<true>), dim3(n_blocks), dim3(block_size), 0, 0, N, d_pos, d_keys, d_values, box);
+    else
+        hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_sfc_morton_keys_kernel<false>), dim3(n_blocks), dim3(block_size), 0, 0, N, d_pos, d_keys, d_values, box);
+
+    // 3D keys use the lower 63 bits
+    int end_bit = twod ? 64 : 63;
+
+    // Determine temporary device storage requirements
+    void *d_temp_storage = NULL;
+    size_t temp_storage_bytes = 0;
+    hipcub::DeviceRadixSort::SortPairs(d_temp_storage,
+        temp_storage_bytes,
+        d_keys,
+        d_keys_sorted,
+        d_values,
+        d_sorted_order,
+        N,
+        0,
+        end_bit);
+    d_temp_storage = alloc.allocate(temp_storage_bytes);
+
+    hipcub::DeviceRadixSort::SortPairs(d_temp_storage,
+        temp_storage_bytes,
+        d_keys,
+        d_keys_sorted,
+        d_values,
+        d_sorted_order,
+        N,
+        0,
+        end_bit);
+    alloc.deallocate((char *) d_temp_storage);
+
+    alloc.deallocate((char *) d_values);
+    alloc.deallocate((char *) d_keys_sorted);
+    alloc.deallocate((char *) d_keys);
+    }
+
 //! Kernel to apply sorted order
 __global__ void gpu_apply_sorted_order_kernel(
         unsigned int N,
@@ -260,3 +388,72 @@ void gpu_apply_sorted_order(
         d_net_torque_alt,
         d_rtag);
     }
+
+//! Kernel to gather one particle data array in the sorted order
+template<class T>
+__global__ void gpu_permute_sorted_order_kernel(unsigned int N,
+                                                const unsigned int *d_sorted_order,
+                                                const T *d_data,
+                                                T *d_scratch)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N) return;
+
+    d_scratch[idx] = d_data[d_sorted_order[idx]];
+    }
+
+/*! \param N Number of local particles
+    \param d_sorted_order Sort order, particle i is replaced by particle d_sorted_order[i]
+    \param d_data Array to permute, the ghost particles are not moved
+    \param d_scratch Scratch buffer of at least N elements
+
+    The array is gathered into the scratch buffer and copied back, so the sort needs only one scratch buffer for all
+    arrays instead of a second copy of every array.
+*/
+template<class T>
+void gpu_permute_sorted_order(unsigned int N,
+                              const unsigned int *d_sorted_order,
+                              T *d_data,
+                              T *d_scratch)
+    {
+    if (N == 0)
+        return;
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N/block_size + 1;
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_permute_sorted_order_kernel<T>), dim3(n_blocks), dim3(block_size), 0, 0,
+        N, d_sorted_order, d_data, d_scratch);
+
+    hipMemcpyAsync(d_data, d_scratch, sizeof(T)*N, hipMemcpyDeviceToDevice);
+    }
+
+//! Kernel to rebuild the reverse lookup tags after a sort
+__global__ void gpu_update_sorted_rtags_kernel(unsigned int N,
+                                               const unsigned int *d_tag,
+                                               unsigned int *d_rtag)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N) return;
+
+    d_rtag[d_tag[idx]] = idx;
+    }
+
+void gpu_update_sorted_rtags(unsigned int N,
+                             const unsigned int *d_tag,
+                             unsigned int *d_rtag)
+    {
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N/block_size + 1;
+
+    hipLaunchKernelGGL(gpu_update_sorted_rtags_kernel, dim3(n_blocks), dim3(block_size), 0, 0, N, d_tag, d_rtag);
+    }
+
+template void gpu_permute_sorted_order<Scalar4>(unsigned int, const unsigned int *, Scalar4 *, Scalar4 *);
+template void gpu_permute_sorted_order<Scalar3>(unsigned int, const unsigned int *, Scalar3 *, Scalar3 *);
+template void gpu_permute_sorted_order<Scalar>(unsigned int, const unsigned int *, Scalar *, Scalar *);
+template void gpu_permute_sorted_order<int3>(unsigned int, const unsigned int *, int3 *, int3 *);
+template void gpu_permute_sorted_order<unsigned int>(unsigned int, const unsigned int *, unsigned int *,
+    unsigned int *);
@@ -26,6 +26,14 @@ void gpu_generate_sorted_order(unsigned int N,
         bool twod,
         CachedAllocator& alloc);
 
+//! Generate sorted order by Morton keys of the continuous coordinates on GPU
+void gpu_generate_sorted_order_adaptive(unsigned int N,
+        const Scalar4 *d_pos,
+        unsigned int *d_sorted_order,
+        const BoxDim& box,
+        bool twod,
+        CachedAllocator& alloc);
+
 //! Reorder particle data (GPU driver function)
 void gpu_apply_sorted_order(
         unsigned int N,
@@ -62,4 +70,16 @@ void gpu_apply_sorted_order(
         Scalar4 *d_net_torque_alt,
         unsigned int *d_rtag);
 
+//! Permute one particle data array through a scratch buffer (GPU driver function)
+template<class T>
+void gpu_permute_sorted_order(unsigned int N,
+        const unsigned int *d_sorted_order,
+        T *d_data,
+        T *d_scratch);
+
+//! Rebuild the reverse lookup tags after a sort (GPU driver function)
+void gpu_update_sorted_rtags(unsigned int N,
+        const unsigned int *d_tag,
+        unsigned int *d_rtag);
+
 #endif // __SFC_PACK_UPDATER_GPU_CUH__
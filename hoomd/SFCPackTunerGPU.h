@@ -57,8 +57,14 @@ class PYBIND11_EXPORT SFCPackTunerGPU : public SFCPackTuner
         //! Helper function that actually performs the sort
         virtual void getSortedOrder3D();
 
+        //! Helper function that performs the sort by Morton keys of the continuous coordinates
+        virtual void getSortedOrderAdaptive();
+
         //! Apply the sorted order to the particle data
         virtual void applySortOrder();
+
+        //! Apply the sorted order one array at a time, without the alternate arrays
+        void applySortOrderLowMemory();
     };
 
 //! Export the SFCPackTunerGPU class to python
@@ -16,19 +16,20 @@ using namespace std;
 */
 
 volatile sig_atomic_t g_sigint_recvd = 0;
+volatile sig_atomic_t g_sigterm_recvd = 0;
 
 //! The actual signal handler
 extern "C" void sigint_handler(int sig)
     {
-    // ignore if we didn't get SIGINT
-    if (sig != SIGINT)
-        return;
-
-    // set the global
-    g_sigint_recvd = 1;
+    // set the global of the signal, ignore others
+    if (sig == SIGINT)
+        g_sigint_recvd = 1;
+    else if (sig == SIGTERM)
+        g_sigterm_recvd = 1;
     }
 
-ScopedSignalHandler::ScopedSignalHandler()
+ScopedSignalHandler::ScopedSignalHandler(bool catch_sigterm)
+    : m_catch_sigterm(catch_sigterm)
     {
     struct sigaction newact;
     newact.sa_handler = sigint_handler;
@@ -41,6 +42,16 @@ ScopedSignalHandler::ScopedSignalHandler()
         {
         cerr << "Error setting signal handler: " << strerror(errno) << endl;
         }
+
+    if (m_catch_sigterm)
+        {
+        retval = sigaction(SIGTERM, &newact, &m_old_term_action);
+
+        if (retval != 0)
+            {
+            cerr << "Error setting signal handler: " << strerror(errno) << endl;
+            }
+        }
     }
 
 ScopedSignalHandler::~ScopedSignalHandler()
@@ -52,4 +63,14 @@ ScopedSignalHandler::~ScopedSignalHandler()
         {
         cerr << "Error setting signal handler: " << strerror(errno) << endl;
         }
+
+    if (m_catch_sigterm)
+        {
+        retval = sigaction(SIGTERM, &m_old_term_action, &dummy_action);
+
+        if (retval != 0)
+            {
+            cerr << "Error setting signal handler: " << strerror(errno) << endl;
+            }
+        }
     }
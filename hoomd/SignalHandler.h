@@ -22,22 +22,35 @@
 */
 extern volatile sig_atomic_t g_sigint_recvd;
 
+//! Value set to non-zero if SIGTERM has occurred while a ScopedSignalHandler catches it
+/*! The run loop reads this value to write a checkpoint before a preempted job is killed.
+*/
+extern volatile sig_atomic_t g_sigterm_recvd;
+
 /** Manage the signal handler within a scope
 
     This allows System::run to install the signal handler and have it removed when it returns
-    or an exception is thrown.
+    or an exception is thrown. SIGTERM is only caught on request, otherwise it keeps its default action.
 */
 class ScopedSignalHandler
     {
     public:
         /// Install the signal handler
-        ScopedSignalHandler();
+        /** @param catch_sigterm Set to true to also catch SIGTERM
+        */
+        ScopedSignalHandler(bool catch_sigterm=false);
 
         /// Remove the signal handler and restore the previous
         ~ScopedSignalHandler();
     private:
         /// Save the old action
         struct sigaction m_old_action;
+
+        /// True when SIGTERM is caught
+        bool m_catch_sigterm;
+
+        /// Save the old action for SIGTERM
+        struct sigaction m_old_term_action;
     };
 
 #endif
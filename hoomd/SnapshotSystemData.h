@@ -46,7 +46,7 @@ struct SnapshotSystemData {
     unsigned int dimensions;               //!< The dimensionality of the system
     BoxDim global_box;                     //!< The dimensions of the simulation box
     SnapshotParticleData<Real> particle_data;    //!< The particle data
-    std::map<unsigned int, unsigned int> map; //!< Lookup particle index by tag
+    std::vector<unsigned int> map;         //!< Lookup particle index by tag (NOT_LOCAL for unused tags)
     BondData::Snapshot bond_data;          //!< The bond data
     AngleData::Snapshot angle_data;         //!< The angle data
     DihedralData::Snapshot dihedral_data;    //!< The dihedral data
@@ -17,6 +17,7 @@
 
 // #include <pybind11/pybind11.h>
 #include <stdexcept>
+#include <sstream>
 #include <time.h>
 #include <pybind11/cast.h>
 #include <pybind11/stl_bind.h>
@@ -43,7 +44,9 @@ PyObject* walltimeLimitExceptionTypeObj = 0;
 */
 System::System(std::shared_ptr<SystemDefinition> sysdef, uint64_t initial_tstep)
         : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep),
-          m_profile(false)
+          m_profile(false), m_trace_filename(""), m_trace_max_events(0), m_checkpoint_period(0),
+          m_rollback_dt_scale(1.0), m_max_rollbacks(0), m_n_consecutive_rollbacks(0), m_n_rollbacks(0),
+          m_preempted(false)
     {
     // sanity check
     assert(m_sysdef);
@@ -57,6 +60,16 @@ System::System(std::shared_ptr<SystemDefinition> sysdef, uint64_t initial_tstep)
         bcast(m_cur_tstep, 0, m_exec_conf->getMPICommunicator());
         }
     #endif
+
+    // the quantities that hoomd.Simulation logs
+    m_log_registry.registerQuantity("timestep",
+        [this](uint64_t timestep) { return double(m_cur_tstep); }, false, true);
+    m_log_registry.registerQuantity("final_timestep",
+        [this](uint64_t timestep) { return double(m_end_tstep); }, false, true);
+    m_log_registry.registerQuantity("tps",
+        [this](uint64_t timestep) { return double(m_last_TPS); });
+    m_log_registry.registerQuantity("walltime",
+        [this](uint64_t timestep) { return m_last_walltime; });
     }
 
 // -------------- Integrator methods
@@ -87,10 +100,17 @@ void System::setCommunicator(std::shared_ptr<Communicator> comm)
 
 void System::run(uint64_t nsteps, bool write_at_start)
     {
-    ScopedSignalHandler signal_handler;
+    ScopedSignalHandler signal_handler(bool(m_preemption_writer));
+    m_preempted = false;
     m_start_tstep = m_cur_tstep;
     m_end_tstep = m_cur_tstep + nsteps;
 
+    #ifdef ENABLE_MPI
+    // start the trace clocks of all ranks together
+    if (m_comm && !m_trace_filename.empty())
+        MPI_Barrier(m_exec_conf->getMPICommunicator());
+    #endif
+
     // initialize the last status time
     m_initial_time = m_clk.getTime();
     setupProfiling();
@@ -100,6 +120,10 @@ void System::run(uint64_t nsteps, bool write_at_start)
     m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep));
 
     resetStats();
+    resetTimers();
+
+    // particles may have been moved from python since the last run
+    m_sysdef->getParticleData()->invalidateDisplacementBound();
 
     #ifdef ENABLE_MPI
     if (m_comm)
@@ -124,44 +148,46 @@ void System::run(uint64_t nsteps, bool write_at_start)
         for (auto &analyzer_trigger_pair: m_analyzers)
             {
             if ((*analyzer_trigger_pair.second)(m_cur_tstep))
+                {
+                analyzer_trigger_pair.first->getTimer().start();
                 analyzer_trigger_pair.first->analyze(m_cur_tstep);
+                analyzer_trigger_pair.first->getTimer().stop();
+                }
             }
         }
 
+    // no operation runs before this step, so the loop only advances the integrator until then
+    uint64_t next_trigger_step = nextTriggerStep(m_cur_tstep);
+
     // run the steps
-    for (uint64_t count = 0; count < nsteps; count++)
+    while (m_cur_tstep < m_end_tstep)
         {
-        for (auto &tuner: m_tuners)
+        // check the state and save a checkpoint periodically, and at the start when there is none
+        if (m_checkpoint_ring
+            && (m_cur_tstep % m_checkpoint_period == 0 || m_checkpoint_ring->getNumCheckpoints() == 0)
+            && !checkpoint())
             {
-            if ((*tuner->getTrigger())(m_cur_tstep))
-                tuner->update(m_cur_tstep);
+            next_trigger_step = nextTriggerStep(m_cur_tstep);
+            continue;
             }
 
-        // execute updaters
-        for (auto &updater_trigger_pair: m_updaters)
+        try
             {
-            if ((*updater_trigger_pair.second)(m_cur_tstep))
-                updater_trigger_pair.first->update(m_cur_tstep);
+            runStep(next_trigger_step);
             }
-
-        // look ahead to the next time step and see which analyzers and updaters will be executed
-        // or together all of their requested PDataFlags to determine the flags to set for this time step
-        m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep+1));
-
-        // execute the integrator
-        if (m_integrator)
-            m_integrator->update(m_cur_tstep);
-
-        m_cur_tstep++;
-
-        // execute analyzers after incrementing the step counter
-        for (auto &analyzer_trigger_pair: m_analyzers)
+        catch (pybind11::error_already_set&)
             {
-            if ((*analyzer_trigger_pair.second)(m_cur_tstep))
-                analyzer_trigger_pair.first->analyze(m_cur_tstep);
+            throw;
             }
+        catch (std::runtime_error& e)
+            {
+            // the ranks cannot agree on a rollback when only some of them throw
+            if (!canRollBack() || m_exec_conf->getNRanks() > 1)
+                throw;
 
-        updateTPS();
+            rollBack(e.what());
+            next_trigger_step = nextTriggerStep(m_cur_tstep);
+            }
 
         // quit if Ctrl-C was pressed
         if (g_sigint_recvd)
@@ -169,10 +195,27 @@ void System::run(uint64_t nsteps, bool write_at_start)
             g_sigint_recvd = 0;
             PyErr_SetString(PyExc_KeyboardInterrupt, "");
             throw pybind11::error_already_set();
-            return;
+            }
+
+        // write the checkpoint and stop at the end of this step when the job is preempted
+        if (m_preemption_writer && isPreemptionRequested())
+            {
+            m_exec_conf->msg->notice(1) << "SIGTERM received, writing the checkpoint "
+                                        << m_preemption_writer->getFilename() << " at step " << m_cur_tstep << endl;
+            m_preemption_writer->analyze(m_cur_tstep);
+            m_preempted = true;
+            break;
             }
         }
 
+    // asynchronous analyses complete before the run returns
+    for (auto &analyzer_trigger_pair: m_analyzers)
+        analyzer_trigger_pair.first->synchronize();
+
+    // every rank writes its own trace
+    if (!m_trace_filename.empty() && m_profiler)
+        m_profiler->writeTrace(m_trace_filename, m_exec_conf->getRank());
+
     #ifdef ENABLE_MPI
     // make sure all ranks return the same TPS after the run completes
     if (m_comm)
@@ -183,6 +226,85 @@ void System::run(uint64_t nsteps, bool write_at_start)
     #endif
     }
 
+/*! \param next_trigger_step First step on which the triggers must be evaluated, updated when the operations run
+*/
+void System::runStep(uint64_t& next_trigger_step)
+    {
+    if (m_cur_tstep < next_trigger_step)
+        {
+        // no trigger is active on the next step, only the integrator requests flags
+        PDataFlags flags = m_default_flags;
+        if (m_integrator)
+            flags |= m_integrator->getRequestedPDataFlags();
+        m_sysdef->getParticleData()->setFlags(flags);
+
+        if (m_integrator)
+            {
+            m_integrator->getTimer().start();
+            m_integrator->update(m_cur_tstep);
+            m_integrator->getTimer().stop();
+            }
+
+        m_cur_tstep++;
+        updateTPS();
+        return;
+        }
+
+    for (auto &tuner: m_tuners)
+        {
+        if ((*tuner->getTrigger())(m_cur_tstep))
+            {
+            tuner->getTimer().start();
+            tuner->update(m_cur_tstep);
+            tuner->getTimer().stop();
+            }
+        }
+
+    // execute updaters
+    for (auto &updater_trigger_pair: m_updaters)
+        {
+        if ((*updater_trigger_pair.second)(m_cur_tstep))
+            {
+            updater_trigger_pair.first->getTimer().start();
+            updater_trigger_pair.first->update(m_cur_tstep);
+            updater_trigger_pair.first->getTimer().stop();
+
+            // updaters may move particles by any distance
+            m_sysdef->getParticleData()->invalidateDisplacementBound();
+            }
+        }
+
+    // look ahead to the next time step and see which analyzers and updaters will be executed
+    // or together all of their requested PDataFlags to determine the flags to set for this time step
+    m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep+1));
+
+    // execute the integrator
+    if (m_integrator)
+        {
+        m_integrator->getTimer().start();
+        m_integrator->update(m_cur_tstep);
+        m_integrator->getTimer().stop();
+        }
+
+    m_cur_tstep++;
+
+    // execute analyzers after incrementing the step counter
+    for (auto &analyzer_trigger_pair: m_analyzers)
+        {
+        if ((*analyzer_trigger_pair.second)(m_cur_tstep))
+            {
+            analyzer_trigger_pair.first->getTimer().start();
+            analyzer_trigger_pair.first->analyze(m_cur_tstep);
+            analyzer_trigger_pair.first->getTimer().stop();
+            }
+        }
+
+    updateTPS();
+
+    // the operations that ran may have changed the triggers
+    next_trigger_step = nextTriggerStep(m_cur_tstep);
+    }
+
 void System::updateTPS()
     {
     m_last_walltime = double(m_clk.getTime() - m_initial_time) / double(1e9);
@@ -198,6 +320,138 @@ void System::enableProfiler(bool enable)
     m_profile = enable;
     }
 
+/*! \returns The timing tree of the last run, or an empty string if it was not profiled
+*/
+std::string System::getProfile()
+    {
+    if (!m_profiler)
+        return std::string();
+
+    std::ostringstream s;
+    s << *m_profiler;
+    return s.str();
+    }
+
+/*! \param period Number of steps between checkpoints (0 disables rollback)
+    \param depth Number of checkpoints to keep in memory
+    \param dt_scale Factor to scale the time step of the integrator by on each rollback
+    \param max_rollbacks Maximum number of rollbacks without a new checkpoint in between
+
+    Every \a period steps, the run loop checks that all positions and velocities are finite and saves a checkpoint.
+    When the check fails, or when a step throws an exception, the simulation rolls back to the newest checkpoint.
+    When it fails again before the next checkpoint, it rolls back further.
+*/
+void System::setRollback(uint64_t period, unsigned int depth, Scalar dt_scale, unsigned int max_rollbacks)
+    {
+    if (period == 0)
+        {
+        m_checkpoint_ring.reset();
+        return;
+        }
+
+    if (dt_scale <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "The time step scale factor of the rollback must be positive" << endl;
+        throw runtime_error("Error configuring rollback");
+        }
+
+    m_checkpoint_ring.reset(new CheckpointRing(m_sysdef, depth));
+    m_checkpoint_period = period;
+    m_rollback_dt_scale = dt_scale;
+    m_max_rollbacks = max_rollbacks;
+    m_n_consecutive_rollbacks = 0;
+    m_n_rollbacks = 0;
+    }
+
+/*! \returns true when any rank received SIGTERM
+
+    The ranks agree on the result so that they all write the checkpoint. With MPI this costs a reduction of a single
+    integer per step, which is small next to the ghost communication of the step.
+*/
+bool System::isPreemptionRequested()
+    {
+    int local_requested = g_sigterm_recvd ? 1 : 0;
+    int global_requested = local_requested;
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        MPI_Allreduce(&local_requested, &global_requested, 1, MPI_INT, MPI_MAX, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (global_requested)
+        g_sigterm_recvd = 0;
+
+    return global_requested != 0;
+    }
+
+/*! \returns false when the simulation rolled back
+*/
+bool System::checkpoint()
+    {
+    if (m_profiler) m_profiler->push(m_exec_conf, "Checkpoint");
+    bool valid = m_checkpoint_ring->isStateValid();
+
+    // no new checkpoint is needed right after rolling back to this step
+    if (valid && (m_checkpoint_ring->getNumCheckpoints() == 0
+                  || m_checkpoint_ring->getTimeStep(0) != m_cur_tstep))
+        {
+        m_checkpoint_ring->save(m_cur_tstep);
+        m_n_consecutive_rollbacks = 0;
+        }
+    if (m_profiler) m_profiler->pop(m_exec_conf);
+
+    if (valid)
+        return true;
+
+    if (!canRollBack())
+        {
+        m_exec_conf->msg->error() << "Non-finite particle positions or velocities at step " << m_cur_tstep
+                                  << ", no checkpoint left to roll back to" << endl;
+        throw runtime_error("Error running the simulation");
+        }
+
+    rollBack("Non-finite particle positions or velocities");
+    return false;
+    }
+
+/*! \param reason Description of the failure
+
+    The first rollback after a checkpoint restores the newest checkpoint. Consecutive rollbacks restore older ones,
+    because the newest checkpoint may already contain the seed of the instability.
+*/
+void System::rollBack(const std::string& reason)
+    {
+    uint64_t failed_step = m_cur_tstep;
+    unsigned int age = (m_n_consecutive_rollbacks > 0 && m_checkpoint_ring->getNumCheckpoints() > 1) ? 1 : 0;
+    m_cur_tstep = m_checkpoint_ring->restore(age);
+    m_n_consecutive_rollbacks++;
+    m_n_rollbacks++;
+
+    m_exec_conf->msg->warning() << reason << " at step " << failed_step << ", rolling back to step "
+                                << m_cur_tstep << endl;
+
+    if (m_integrator && m_rollback_dt_scale != Scalar(1.0))
+        {
+        Scalar dt = m_integrator->getDeltaT() * m_rollback_dt_scale;
+        m_exec_conf->msg->warning() << "Changing the time step to " << dt << endl;
+        m_integrator->setDeltaT(dt);
+        }
+
+    m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep));
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        m_comm->forceMigrate();
+        m_comm->communicate(m_cur_tstep);
+        }
+    #endif
+
+    // recompute the forces on the restored particles
+    if (m_integrator)
+        m_integrator->prepRun(m_cur_tstep);
+    }
+
 /*! \param logger Logger to register computes and updaters with
     All computes and updaters registered with the system are also registered with the logger.
 */
@@ -247,11 +501,17 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 void System::setupProfiling()
     {
-    if (m_profile)
+    if (m_profile || !m_trace_filename.empty() || !m_counters.empty())
         m_profiler = std::shared_ptr<Profiler>(new Profiler("Simulation"));
     else
         m_profiler = std::shared_ptr<Profiler>();
 
+    if (!m_trace_filename.empty())
+        m_profiler->enableTrace(m_trace_max_events);
+
+    if (!m_counters.empty())
+        m_profiler->enableCounters(m_counters);
+
     // set the profiler on everything
     if (m_integrator)
         m_integrator->setProfiler(m_profiler);
@@ -275,6 +535,10 @@ void System::setupProfiling()
         updater_trigger_pair.first->setProfiler(m_profiler);
         }
 
+    // tuners
+    for (auto &tuner: m_tuners)
+        tuner->setProfiler(m_profiler);
+
     // computes
     for (auto compute: m_computes)
         compute->setProfiler(m_profiler);
@@ -304,6 +568,50 @@ void System::resetStats()
         compute->resetStats();
     }
 
+/*! The timers of all operations and of the forces in the integrator are reset so that the times read during and
+    after a run() only include that run() alone.
+*/
+void System::resetTimers()
+    {
+    if (m_integrator)
+        {
+        m_integrator->getTimer().reset();
+        for (auto& force : m_integrator->getForces())
+            force->getTimer().reset();
+        for (auto& force : m_integrator->getConstraintForces())
+            force->getTimer().reset();
+        }
+
+    for (auto &analyzer_trigger_pair: m_analyzers)
+        analyzer_trigger_pair.first->getTimer().reset();
+
+    for (auto &updater_trigger_pair: m_updaters)
+        updater_trigger_pair.first->getTimer().reset();
+
+    for (auto &tuner: m_tuners)
+        tuner->getTimer().reset();
+
+    for (auto compute: m_computes)
+        compute->getTimer().reset();
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        m_comm_time_start = m_comm->getCommunicationTime();
+    #endif
+    }
+
+/*! \returns The time in seconds spent communicating ghost and migrating particles since the start of the run
+*/
+double System::getCommunicationTime()
+    {
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return double(m_comm->getCommunicationTime() - m_comm_time_start) / 1e9;
+    #endif
+
+    return 0.0;
+    }
+
 /*! \param tstep Time step for which to determine the flags
 
     The flags needed are determined by peeking to \a tstep and then using bitwise or to combine all of the flags from the
@@ -336,6 +644,43 @@ PDataFlags System::determineFlags(uint64_t tstep)
     return flags;
     }
 
+/*! \param tstep Current time step
+
+    Tuners and updaters run on tstep before the integrator step, analyzers run on tstep+1 after it. The
+    particle data flags set before the integrator step depend on the triggers of all operations on tstep+1.
+    A step s of the run loop can skip the triggers when none of the tuners and updaters is active on s and none
+    of the operations is active on s+1.
+
+    \returns The first step at or after \a tstep on which the run loop evaluates the triggers
+*/
+uint64_t System::nextTriggerStep(uint64_t tstep)
+    {
+    uint64_t next = std::numeric_limits<uint64_t>::max();
+
+    // the first step s >= tstep+1 on which an operation may be active on s, needs a full step at s-1
+    auto after = [&next, tstep](std::shared_ptr<Trigger> trigger)
+        {
+        next = std::min(next, trigger->nextFireStep(tstep+1) - 1);
+        };
+
+    for (auto &tuner: m_tuners)
+        {
+        next = std::min(next, tuner->getTrigger()->nextFireStep(tstep));
+        after(tuner->getTrigger());
+        }
+
+    for (auto &updater_trigger_pair: m_updaters)
+        {
+        next = std::min(next, updater_trigger_pair.second->nextFireStep(tstep));
+        after(updater_trigger_pair.second);
+        }
+
+    for (auto &analyzer_trigger_pair: m_analyzers)
+        after(analyzer_trigger_pair.second);
+
+    return next;
+    }
+
 void export_System(py::module& m)
     {
     py::bind_vector<std::vector<std::pair<std::shared_ptr<Analyzer>,
@@ -354,14 +699,30 @@ void export_System(py::module& m)
     .def("registerLogger", &System::registerLogger)
     .def("setAutotunerParams", &System::setAutotunerParams)
     .def("enableProfiler", &System::enableProfiler)
+    .def("setTrace", &System::setTrace)
+    .def("setCounters", [](System& self, py::list events)
+        {
+        std::vector<std::string> names;
+        for (auto event : events)
+            names.push_back(event.cast<std::string>());
+        self.setCounters(names);
+        })
+    .def("getProfile", &System::getProfile)
+    .def("setRollback", &System::setRollback)
+    .def("getNumRollbacks", &System::getNumRollbacks)
+    .def("setPreemptionCheckpoint", &System::setPreemptionCheckpoint)
+    .def_property_readonly("preempted", &System::getPreempted)
     .def("run", &System::run)
 
     .def("getLastTPS", &System::getLastTPS)
     .def("getCurrentTimeStep", &System::getCurrentTimeStep)
+    .def("getCommunicationTime", &System::getCommunicationTime)
+    .def("getLoggedQuantityNames", &System::getLoggedQuantityNames)
     .def("setPressureFlag", &System::setPressureFlag)
     .def("getPressureFlag", &System::getPressureFlag)
     .def_property_readonly("walltime", &System::getCurrentWalltime)
     .def_property_readonly("final_timestep", &System::getEndStep)
+    .def_property_readonly("initial_timestep", &System::getStartStep)
     .def_property_readonly("analyzers", &System::getAnalyzers)
     .def_property_readonly("updaters", &System::getUpdaters)
     .def_property_readonly("tuners", &System::getTuners)
@@ -9,12 +9,16 @@
 #include "Compute.h"
 #include "Integrator.h"
 #include "Logger.h"
+#include "LogRegistry.h"
 #include "Trigger.h"
 #include "Tuner.h"
+#include "CheckpointRing.h"
+#include "Checkpoint.h"
 
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 
 #ifndef __SYSTEM_H__
 #define __SYSTEM_H__
@@ -104,6 +108,53 @@ class PYBIND11_EXPORT System
         //! Configures profiling of runs
         void enableProfiler(bool enable);
 
+        //! Configures tracing of runs
+        /*! \param filename File to write the trace of each run to (empty to disable tracing)
+            \param max_events Maximum number of profiled ranges to keep in the trace
+        */
+        void setTrace(const std::string& filename, unsigned int max_events)
+            {
+            m_trace_filename = filename;
+            m_trace_max_events = max_events;
+            }
+
+        //! Configures the hardware counters to collect in profiled runs
+        /*! \param events Names of the PAPI events (empty to disable the counters)
+        */
+        void setCounters(const std::vector<std::string>& events)
+            {
+            m_counters = events;
+            }
+
+        //! Get the profile of the last profiled run
+        std::string getProfile();
+
+        //! Configures the automatic rollback to in-memory checkpoints
+        void setRollback(uint64_t period, unsigned int depth, Scalar dt_scale, unsigned int max_rollbacks);
+
+        //! Get the number of rollbacks since rollback was enabled
+        unsigned int getNumRollbacks() const
+            {
+            return m_n_rollbacks;
+            }
+
+        //! Configures the checkpoint written when the job is preempted
+        /*! \param writer Writer of the checkpoint (null to leave SIGTERM at its default action)
+
+            While a writer is set, run() catches SIGTERM. After the step in which any rank receives it, all ranks
+            write the checkpoint and run() returns early.
+        */
+        void setPreemptionCheckpoint(std::shared_ptr<CheckpointWriter> writer)
+            {
+            m_preemption_writer = writer;
+            }
+
+        //! Test if the last run ended early to write the preemption checkpoint
+        bool getPreempted() const
+            {
+            return m_preempted;
+            }
+
         //! Register logger
         void registerLogger(std::shared_ptr<Logger> logger);
 
@@ -131,6 +182,27 @@ class PYBIND11_EXPORT System
             return m_end_tstep;
             }
 
+        /// Get the time step at the start of the current run
+        uint64_t getStartStep()
+            {
+            return m_start_tstep;
+            }
+
+        /// Get the time spent in communication since the start of the current run
+        double getCommunicationTime();
+
+        //! Get the log quantities the system evaluates in C++
+        const LogRegistry& getLogRegistry() const
+            {
+            return m_log_registry;
+            }
+
+        //! Get the names of the log quantities the system evaluates in C++
+        std::vector<std::string> getLoggedQuantityNames() const
+            {
+            return m_log_registry.getNames();
+            }
+
         // -------------- Misc methods
 
         //! Get the system definition
@@ -199,10 +271,25 @@ class PYBIND11_EXPORT System
         ClockSource m_clk;              //!< A clock counting time from the beginning of the run
 
         bool m_profile;         //!< True if runs should be profiled
+        std::string m_trace_filename;       //!< File to write the trace of a run to (empty when not tracing)
+        unsigned int m_trace_max_events;    //!< Maximum number of ranges in the trace
+        std::vector<std::string> m_counters;    //!< Hardware counters to collect (empty when disabled)
+
+        std::unique_ptr<CheckpointRing> m_checkpoint_ring;  //!< In-memory checkpoints (null when rollback is disabled)
+        uint64_t m_checkpoint_period;           //!< Number of steps between checkpoints
+        Scalar m_rollback_dt_scale;             //!< Factor to scale the time step by on each rollback
+        unsigned int m_max_rollbacks;           //!< Maximum number of rollbacks without a new checkpoint
+        unsigned int m_n_consecutive_rollbacks; //!< Number of rollbacks since the last new checkpoint
+        unsigned int m_n_rollbacks;             //!< Total number of rollbacks
+
+        std::shared_ptr<CheckpointWriter> m_preemption_writer; //!< Checkpoint to write on SIGTERM (may be null)
+        bool m_preempted;                       //!< True if the last run ended on SIGTERM
 
         /// Particle data flags to always set
         PDataFlags m_default_flags;
 
+        LogRegistry m_log_registry;     //!< Log quantities evaluated in C++
+
         // --------- Steps in the simulation run implemented in helper functions
         //! Sets up m_profiler and attaches/detaches to/from all computes, updaters, and analyzers
         void setupProfiling();
@@ -210,9 +297,34 @@ class PYBIND11_EXPORT System
         //! Resets stats for all contained classes
         void resetStats();
 
+        /// Reset the timers of all contained operations
+        void resetTimers();
+
         //! Get the flags needed for a particular step
         PDataFlags determineFlags(uint64_t tstep);
 
+        /// Get the first step at or after tstep on which the run loop must evaluate the triggers
+        uint64_t nextTriggerStep(uint64_t tstep);
+
+        /// Advance the simulation by one step
+        void runStep(uint64_t& next_trigger_step);
+
+        /// Save a checkpoint if the state is valid, roll back otherwise
+        bool checkpoint();
+
+        /// Test if the simulation can roll back
+        bool canRollBack() const
+            {
+            return m_checkpoint_ring && m_checkpoint_ring->getNumCheckpoints() > 0
+                && m_n_consecutive_rollbacks < m_max_rollbacks;
+            }
+
+        /// Restore a checkpoint after a failure
+        void rollBack(const std::string& reason);
+
+        /// Test if any rank received SIGTERM
+        bool isPreemptionRequested();
+
         /// Record the initial time of the last run
         int64_t m_initial_time=0;
 
@@ -222,6 +334,11 @@ class PYBIND11_EXPORT System
         /// Store the last recorded walltime
         double m_last_walltime=0;
 
+        #ifdef ENABLE_MPI
+        /// Communication time at the start of the last run (in ns)
+        int64_t m_comm_time_start=0;
+        #endif
+
         /// Update the TPS average
         void updateTPS();
 
@@ -167,6 +167,27 @@ void SystemDefinition::initializeFromSnapshot(std::shared_ptr< SnapshotSystemDat
     m_pair_data->initializeFromSnapshot(snapshot->pair_data);
     }
 
+/*! \param nx Number of times to replicate the system along the x direction
+    \param ny Number of times to replicate the system along the y direction
+    \param nz Number of times to replicate the system along the z direction
+
+    Produces the same system as SnapshotSystemData::replicate() without taking a snapshot: every rank replicates
+    its local particles and bonded groups.
+*/
+void SystemDefinition::replicate(unsigned int nx, unsigned int ny, unsigned int nz)
+    {
+    unsigned int old_n = m_particle_data->getNGlobal();
+    m_particle_data->replicate(nx, ny, nz);
+
+    unsigned int n = nx*ny*nz;
+    m_bond_data->replicate(n, old_n);
+    m_angle_data->replicate(n, old_n);
+    m_dihedral_data->replicate(n, old_n);
+    m_improper_data->replicate(n, old_n);
+    m_constraint_data->replicate(n, old_n);
+    m_pair_data->replicate(n, old_n);
+    }
+
 // instantiate both float and double methods
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<float> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
@@ -204,6 +225,7 @@ void export_SystemDefinition(py::module& m)
     .def("takeSnapshot_double", &SystemDefinition::takeSnapshot<double>)
     .def("initializeFromSnapshot", &SystemDefinition::initializeFromSnapshot<float>)
     .def("initializeFromSnapshot", &SystemDefinition::initializeFromSnapshot<double>)
+    .def("replicate", &SystemDefinition::replicate)
     .def("getSeed", &SystemDefinition::getSeed)
     .def("setSeed", &SystemDefinition::setSeed)
     ;
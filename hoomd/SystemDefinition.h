@@ -175,6 +175,9 @@ class PYBIND11_EXPORT SystemDefinition
         template <class Real>
         void initializeFromSnapshot(std::shared_ptr< SnapshotSystemData<Real> > snapshot);
 
+        //! Replicate the system in place on each rank
+        void replicate(unsigned int nx, unsigned int ny, unsigned int nz);
+
     private:
         unsigned int m_n_dimensions;                        //!< Dimensionality of the system
         uint16_t m_seed=0;                                  //!< Random number seed
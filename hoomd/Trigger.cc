@@ -27,6 +27,17 @@ class TriggerPy : public Trigger
                                    timestep      // Argument(s)
                               );
             }
+
+        // trampoline method, subclasses in python may override next_fire_step
+        uint64_t nextFireStep(uint64_t timestep) override
+            {
+            PYBIND11_OVERLOAD_NAME(uint64_t,        // Return type
+                                   Trigger,         // Parent class
+                                   "next_fire_step",
+                                   nextFireStep,
+                                   timestep         // Argument(s)
+                              );
+            }
     };
 
 void export_Trigger(pybind11::module& m)
@@ -35,6 +46,7 @@ void export_Trigger(pybind11::module& m)
         .def(pybind11::init<>())
         .def("__call__", &Trigger::operator())
         .def("compute", &Trigger::compute)
+        .def("next_fire_step", &Trigger::nextFireStep)
         ;
 
     pybind11::class_<PeriodicTrigger, Trigger,
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <pybind11/pybind11.h>
 #include <algorithm>
 #include <memory>
@@ -47,6 +48,21 @@ class PYBIND11_EXPORT Trigger
 
         virtual bool compute(uint64_t timestep) = 0;
 
+        /** Find the next time step on which the trigger may be active
+         *
+         *  @param timestep First time step to consider
+         *  @returns A time step `s >= timestep` such that the trigger is not active on any time step in
+         *           `[timestep, s)`, or `UINT64_MAX` if it is never active again.
+         *
+         *  The returned step is a lower bound, the trigger need not be active on it. System uses it to run the
+         *  integrator without evaluating the triggers in between. The default implementation knows nothing about
+         *  the trigger and returns `timestep`.
+        */
+        virtual uint64_t nextFireStep(uint64_t timestep)
+            {
+            return timestep;
+            }
+
     private:
             /// Caches the last time step at which the trigger was computed
             uint64_t m_last_timestep;
@@ -77,6 +93,22 @@ class PYBIND11_EXPORT PeriodicTrigger : public Trigger
             return (timestep - m_phase) % m_period == 0;
             }
 
+        uint64_t nextFireStep(uint64_t timestep)
+            {
+            // before the phase, compute() evaluates the wrapped unsigned difference
+            if (timestep < m_phase)
+                return timestep;
+
+            uint64_t remainder = (timestep - m_phase) % m_period;
+            if (remainder == 0)
+                return timestep;
+
+            uint64_t wait = m_period - remainder;
+            if (timestep > std::numeric_limits<uint64_t>::max() - wait)
+                return std::numeric_limits<uint64_t>::max();
+            return timestep + wait;
+            }
+
         /// Set the period
         void setPeriod(uint64_t period)
             {
@@ -123,6 +155,11 @@ class PYBIND11_EXPORT BeforeTrigger : public Trigger
         return timestep < m_timestep;
         }
 
+    uint64_t nextFireStep(uint64_t timestep)
+        {
+        return timestep < m_timestep ? timestep : std::numeric_limits<uint64_t>::max();
+        }
+
     /// Get the timestep before which the trigger is active.
     uint64_t getTimestep() const {return m_timestep;} const
 
@@ -148,6 +185,11 @@ class PYBIND11_EXPORT OnTrigger : public Trigger
         return timestep == m_timestep;
         }
 
+    uint64_t nextFireStep(uint64_t timestep)
+        {
+        return timestep <= m_timestep ? m_timestep : std::numeric_limits<uint64_t>::max();
+        }
+
     /// Get the timestep when the trigger is active.
     uint64_t getTimestep() const {return m_timestep;} const
 
@@ -173,6 +215,15 @@ class PYBIND11_EXPORT AfterTrigger : public Trigger
         return timestep > m_timestep;
         }
 
+    uint64_t nextFireStep(uint64_t timestep)
+        {
+        if (timestep > m_timestep)
+            return timestep;
+        if (m_timestep == std::numeric_limits<uint64_t>::max())
+            return m_timestep;
+        return m_timestep + 1;
+        }
+
     /// Get the timestep after which the trigger is active.
     uint64_t getTimestep() const {return m_timestep;} const
 
@@ -237,6 +288,15 @@ class PYBIND11_EXPORT AndTrigger : public Trigger
                     });
             }
 
+        /// All triggers must be active, so none of them may be inactive until the latest next step
+        uint64_t nextFireStep(uint64_t timestep)
+            {
+            uint64_t next = timestep;
+            for (auto& t : m_triggers)
+                next = std::max(next, t->nextFireStep(timestep));
+            return next;
+            }
+
         const std::vector<std::shared_ptr<Trigger> >& getTriggers() const
             {
             return m_triggers;
@@ -276,6 +336,15 @@ class PYBIND11_EXPORT OrTrigger : public Trigger
                     });
             }
 
+        /// Any trigger may activate, so take the earliest next step
+        uint64_t nextFireStep(uint64_t timestep)
+            {
+            uint64_t next = std::numeric_limits<uint64_t>::max();
+            for (auto& t : m_triggers)
+                next = std::min(next, t->nextFireStep(timestep));
+            return next;
+            }
+
         const std::vector<std::shared_ptr<Trigger> >& getTriggers() const
             {
             return m_triggers;
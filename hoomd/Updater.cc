@@ -4,6 +4,8 @@
 // Maintainer: joaander
 #include "Updater.h"
 
+#include <pybind11/stl.h>
+
 namespace py = pybind11;
 
 /*! \file Updater.cc
@@ -14,7 +16,8 @@ namespace py = pybind11;
     \post The Updater is constructed with the given particle data and a NULL profiler.
 */
 Updater::Updater(std::shared_ptr<SystemDefinition> sysdef)
-    : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()), m_exec_conf(m_pdata->getExecConf())
+    : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()), m_exec_conf(m_pdata->getExecConf()),
+      m_timer(m_exec_conf)
     {
     // sanity check
     assert(m_sysdef);
@@ -42,6 +45,8 @@ void export_Updater(py::module& m)
     .def("update", &Updater::update)
     .def("setProfiler", &Updater::setProfiler)
     .def("notifyDetach", &Updater::notifyDetach)
+    .def("getExecutionTime", &Updater::getExecutionTime)
+    .def("getLoggedQuantityNames", &Updater::getLoggedQuantityNames)
     #ifdef ENABLE_MPI
     .def("setCommunicator", &Updater::setCommunicator)
     #endif
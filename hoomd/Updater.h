@@ -8,6 +8,8 @@
 #include "HOOMDMath.h"
 #include "SystemDefinition.h"
 #include "Profiler.h"
+#include "OperationTimer.h"
+#include "LogRegistry.h"
 #include "SharedSignal.h"
 #include "Communicator.h"
 
@@ -190,6 +192,30 @@ class PYBIND11_EXPORT Updater
                 }
             }
 
+        //! Get the timer of this updater
+        OperationTimer& getTimer()
+            {
+            return m_timer;
+            }
+
+        //! Get the time in seconds spent in this updater since the start of the run
+        double getExecutionTime()
+            {
+            return m_timer.getTotalTime();
+            }
+
+        //! Get the log quantities this updater evaluates in C++
+        const LogRegistry& getLogRegistry() const
+            {
+            return m_log_registry;
+            }
+
+        //! Get the names of the log quantities this updater evaluates in C++
+        std::vector<std::string> getLoggedQuantityNames() const
+            {
+            return m_log_registry.getNames();
+            }
+
         /// Python will notify C++ objects when they are detached from Simulation
         virtual void notifyDetach() { };
 
@@ -202,6 +228,8 @@ class PYBIND11_EXPORT Updater
 #endif
         std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Stored shared ptr to the execution configuration
         std::vector< std::shared_ptr<hoomd::detail::SignalSlot> > m_slots; //!< Stored shared ptr to the system signals
+        OperationTimer m_timer;                           //!< Time spent in this updater
+        LogRegistry m_log_registry;                       //!< Log quantities evaluated in C++
     };
 
 //! Export the Updater class to python
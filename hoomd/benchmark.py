@@ -1,38 +1,439 @@
 # Copyright (c) 2009-2021 The Regents of the University of Michigan
 # This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
-# Maintainer: joaander / All Developers are free to add commands for new features
+r"""Benchmark the performance of HOOMD-blue operations.
 
-R""" Benchmark utilities
+The benchmarks in this module run standard systems with fixed seeds and report
+the time that each operation takes per step, so that results from different
+builds and versions of HOOMD-blue can be compared to detect performance
+regressions. Run the whole suite from the command line and write the results
+as JSON::
 
-Commands that help in benchmarking HOOMD-blue performance.
+    python3 -m hoomd.benchmark --device gpu --output results.json
+
+Use ``--benchmarks`` to select a subset of `BENCHMARKS` and ``mpirun`` to
+include the MPI communication in the measurement.
+
+Each benchmark reports the average `hoomd.Simulation.tps` of each repeat and
+the `time_per_step <hoomd.operation.Operation.time_per_step>` of each
+operation, force, and neighbor list, averaged over all repeats. With MPI, it
+also reports `hoomd.Simulation.communication_time_per_step`. The times are
+measured on rank 0.
+
+For scaling studies, ``--scaling`` runs one of the `WORKLOADS` on all ranks
+of the job instead. Repeat it with different numbers of ranks, with a fixed
+``--particles`` for strong scaling or a fixed ``--particles-per-rank`` for weak
+scaling::
+
+    for n in 1 2 4 8; do
+        mpirun -n $n python3 -m hoomd.benchmark --scaling lj_liquid \
+            --particles-per-rank 100000 --output weak.$n.json
+    done
 """
 
+import argparse
+import itertools
+import json
+
+import numpy
+
 import hoomd
 
-def series(warmup=100000, repeat=20, steps=10000, limit_hours=None):
-    R""" Perform a series of benchmark runs.
+
+def _lattice_snapshot(device, n, a, dimensions=3, r=0.1, seed=1):
+    """Make a snapshot with particles on a perturbed simple cubic lattice.
+
+    Args:
+        device (`hoomd.device.Device`): Device to create the snapshot on.
+        n (int): Number of particles along each box edge.
+        a (float): Lattice constant.
+        dimensions (int): Number of dimensions (2 or 3).
+        r (float): Fraction of *a* to randomly perturb the particles.
+        seed (int): Seed of the perturbation.
+    """
+    snap = hoomd.Snapshot(device.communicator)
+    if snap.exists:
+        box = [n * a, n * a, n * a, 0, 0, 0]
+        if dimensions == 2:
+            box[2] = 0
+        snap.configuration.box = box
+
+        range_ = numpy.arange(-n / 2, n / 2) + 0.5
+        if dimensions == 2:
+            pos = numpy.array(list(itertools.product(range_, range_, [0])))
+        else:
+            pos = numpy.array(list(itertools.product(range_, repeat=3)))
+        pos = pos * a
+
+        rng = numpy.random.default_rng(seed)
+        pos += rng.uniform(-r * a / 2, r * a / 2, size=pos.shape)
+        if dimensions == 2:
+            pos[:, 2] = 0
+
+        snap.particles.N = len(pos)
+        snap.particles.types = ['A']
+        snap.particles.position[:] = pos
+    return snap
+
+
+def _md_pair(pair_cls, params):
+    """Make a benchmark of an MD pair potential in a Langevin liquid."""
+
+    def make(device, n):
+        sim = hoomd.Simulation(device=device, seed=1)
+        sim.create_state_from_snapshot(
+            _lattice_snapshot(device, n, a=0.8**(-1 / 3)))
+
+        nlist = hoomd.md.nlist.Cell()
+        pair = pair_cls(nlist=nlist, r_cut=2.5)
+        pair.params[('A', 'A')] = params
+        langevin = hoomd.md.methods.Langevin(hoomd.filter.All(), kT=1.2)
+        sim.operations.integrator = hoomd.md.Integrator(dt=0.005,
+                                                        methods=[langevin],
+                                                        forces=[pair])
+        sim.state.thermalize_particle_momenta(hoomd.filter.All(), kT=1.2)
+        return sim, dict(nlist=nlist)
+
+    return make
+
+
+def _hpmc(shape_cls, shape, dimensions=3):
+    """Make a benchmark of HPMC moves in a dense fluid of hard shapes."""
+
+    def make(device, n):
+        sim = hoomd.Simulation(device=device, seed=1)
+        a = 1.2 if dimensions == 3 else 1.1
+        sim.create_state_from_snapshot(
+            _lattice_snapshot(device, n, a=a, dimensions=dimensions, r=0))
+
+        mc = shape_cls(d=0.1, a=0.1)
+        mc.shape['A'] = shape
+        sim.operations.integrator = mc
+        return sim, dict()
+
+    return make
+
+
+_cube = [(-0.5, -0.5, -0.5), (-0.5, -0.5, 0.5), (-0.5, 0.5, -0.5),
+         (-0.5, 0.5, 0.5), (0.5, -0.5, -0.5), (0.5, -0.5, 0.5),
+         (0.5, 0.5, -0.5), (0.5, 0.5, 0.5)]
+
+_square = [(-0.5, -0.5), (0.5, -0.5), (0.5, 0.5), (-0.5, 0.5)]
+
+BENCHMARKS = {}
+"""dict[str, Callable]: The benchmarks in the suite.
+
+Each value takes a `hoomd.device.Device` and the number of particles along
+each box edge, and returns a `hoomd.Simulation` together with a `dict` of
+additional named objects to time. Only the benchmarks of the components
+enabled in the build are included.
+"""
+
+if hasattr(hoomd, 'md'):
+    BENCHMARKS.update({
+        'md_pair_lj': _md_pair(hoomd.md.pair.LJ, dict(epsilon=1.0,
+                                                      sigma=1.0)),
+        'md_pair_gauss': _md_pair(hoomd.md.pair.Gauss, dict(epsilon=1.0,
+                                                            sigma=1.0)),
+        'md_pair_yukawa': _md_pair(hoomd.md.pair.Yukawa, dict(epsilon=1.0,
+                                                              kappa=1.0)),
+        'md_pair_morse': _md_pair(hoomd.md.pair.Morse, dict(D0=1.0,
+                                                            alpha=3.0,
+                                                            r0=1.0)),
+        'md_pair_mie': _md_pair(hoomd.md.pair.Mie, dict(epsilon=1.0,
+                                                        sigma=1.0,
+                                                        n=12,
+                                                        m=6)),
+        'md_pair_buckingham': _md_pair(hoomd.md.pair.Buckingham,
+                                       dict(A=1.0, rho=1.0, C=1.0)),
+    })
+
+if hasattr(hoomd, 'hpmc'):
+    BENCHMARKS.update({
+        'hpmc_sphere': _hpmc(hoomd.hpmc.integrate.Sphere,
+                             dict(diameter=1.0)),
+        'hpmc_convex_polyhedron': _hpmc(hoomd.hpmc.integrate.ConvexPolyhedron,
+                                        dict(vertices=_cube)),
+        'hpmc_convex_polygon': _hpmc(hoomd.hpmc.integrate.ConvexPolygon,
+                                     dict(vertices=_square),
+                                     dimensions=2),
+    })
+
+
+def run(name, device, n=32, warmup=1000, steps=1000, repeat=5):
+    """Run one benchmark.
 
     Args:
-        warmup (int): Number of time steps to ```hoomd.run``` to warm up the benchmark
-        repeat (int): Number of times to repeat the benchmark *steps*.
-        steps (int): Number of time steps to ```hoomd.run``` at each benchmark point.
-        limit_hours (float): Limit each individual ```hoomd.run``` length to this time.
+        name (str): Name of the benchmark in `BENCHMARKS`.
+        device (`hoomd.device.Device`): Device to execute on.
+        n (int): Number of particles along each box edge.
+        warmup (int): Number of time steps to run before timing.
+        steps (int): Number of time steps in each timed run.
+        repeat (int): Number of timed runs.
 
-    :py:meth:`series()` executes *warmup* time steps. After that, it
-    calls ``run(steps)``, *repeat* times and returns a list containing the average TPS for each of those runs.
+    Returns:
+        dict: The results of the benchmark.
     """
-    # check if initialization has occurred
-    if not hoomd.init.is_initialized():
-        raise RuntimeError("Cannot tune r_buff before initialization\n");
+    sim, named = BENCHMARKS[name](device, n)
+    sim.run(warmup)
+
+    timed = {}
+    for i, tuner in enumerate(sim.operations.tuners):
+        timed['tuner.{}.{}'.format(i, type(tuner).__name__)] = tuner
+    for i, updater in enumerate(sim.operations.updaters):
+        timed['updater.{}.{}'.format(i, type(updater).__name__)] = updater
+    integrator = sim.operations.integrator
+    timed['integrator.' + type(integrator).__name__] = integrator
+    for i, force in enumerate(getattr(integrator, 'forces', [])):
+        timed['force.{}.{}'.format(i, type(force).__name__)] = force
+    for key, obj in named.items():
+        timed[key + '.' + type(obj).__name__] = obj
+
+    tps = []
+    times = {key: 0.0 for key in timed}
+    comm_time = 0.0
+    for i in range(repeat):
+        sim.run(steps)
+        tps.append(sim.tps)
+        for key, obj in timed.items():
+            times[key] += obj.time_per_step / repeat
+        comm_time += sim.communication_time_per_step / repeat
+
+    return dict(N=sim.state.N_particles,
+                steps=steps,
+                tps=tps,
+                time_per_step=times,
+                communication_time_per_step=comm_time)
+
+
+def _lj_liquid(device):
+    """Make the unit cell of an LJ liquid."""
+    snap = _lattice_snapshot(device, 8, a=0.8**(-1 / 3))
+
+    def setup(sim):
+        nlist = hoomd.md.nlist.Cell()
+        lj = hoomd.md.pair.LJ(nlist=nlist, r_cut=2.5)
+        lj.params[('A', 'A')] = dict(epsilon=1.0, sigma=1.0)
+        langevin = hoomd.md.methods.Langevin(hoomd.filter.All(), kT=1.2)
+        sim.operations.integrator = hoomd.md.Integrator(dt=0.005,
+                                                        methods=[langevin],
+                                                        forces=[lj])
+        sim.state.thermalize_particle_momenta(hoomd.filter.All(), kT=1.2)
+        return dict(nlist=nlist)
+
+    return snap, setup
+
+
+def _polymer_melt(device):
+    """Make the unit cell of a Kremer-Grest polymer melt of 10-mers."""
+    length = 10
+    snap = _lattice_snapshot(device, length, a=0.85**(-1 / 3), r=0)
+    if snap.exists:
+        # each chain fills one row of the lattice along z
+        groups = [(i, i + 1)
+                  for i in range(snap.particles.N)
+                  if i % length != length - 1]
+        snap.bonds.N = len(groups)
+        snap.bonds.types = ['backbone']
+        snap.bonds.group[:] = groups
+
+    def setup(sim):
+        nlist = hoomd.md.nlist.Cell(exclusions=('bond',))
+        wca = hoomd.md.pair.LJ(nlist=nlist, r_cut=2**(1 / 6), mode='shift')
+        wca.params[('A', 'A')] = dict(epsilon=1.0, sigma=1.0)
+        fene = hoomd.md.bond.FENE()
+        fene.params['backbone'] = dict(k=30.0, r0=1.5, epsilon=1.0, sigma=1.0)
+        langevin = hoomd.md.methods.Langevin(hoomd.filter.All(), kT=1.0)
+        sim.operations.integrator = hoomd.md.Integrator(
+            dt=0.005, methods=[langevin], forces=[wca, fene])
+        sim.state.thermalize_particle_momenta(hoomd.filter.All(), kT=1.0)
+        return dict(nlist=nlist)
+
+    return snap, setup
+
+
+def _hard_polyhedra(device):
+    """Make the unit cell of a fluid of hard cubes."""
+    snap = _lattice_snapshot(device, 8, a=1.2, r=0)
+
+    def setup(sim):
+        mc = hoomd.hpmc.integrate.ConvexPolyhedron(d=0.1, a=0.1)
+        mc.shape['A'] = dict(vertices=_cube)
+        sim.operations.integrator = mc
+        return dict()
+
+    return snap, setup
+
+
+WORKLOADS = {}
+"""dict[str, Callable]: The workloads of the scaling benchmarks.
+
+Each value takes a `hoomd.device.Device` and returns a unit cell snapshot of
+the workload, which `scaling` replicates to the requested size, together with
+a function that adds the operations to a `hoomd.Simulation`.
+"""
+
+if hasattr(hoomd, 'md'):
+    WORKLOADS.update(lj_liquid=_lj_liquid, polymer_melt=_polymer_melt)
+
+if hasattr(hoomd, 'hpmc'):
+    WORKLOADS.update(hard_polyhedra=_hard_polyhedra)
+
+
+def _rank_statistics(communicator, value):
+    """Get the mean and maximum of a value over all ranks."""
+    values = communicator._all_gather(value)
+    return dict(mean=sum(values) / len(values), max=max(values))
+
+
+def scaling(workload, device, N, warmup=1000, steps=1000):
+    """Run one point of a strong or weak scaling study.
+
+    Args:
+        workload (str): Name of the workload in `WORKLOADS`.
+        device (`hoomd.device.Device`): Device to execute on.
+        N (int): Approximate number of particles in the system.
+        warmup (int): Number of time steps to run before timing.
+        steps (int): Number of time steps in the timed run.
+
+    The unit cell of the workload is replicated the same number of times
+    along each box edge so that the system has at least *N* particles.
+    Run `scaling` with the same *N* on different numbers of ranks to
+    measure the strong scaling, and with *N* proportional to the number of
+    ranks to measure the weak scaling.
+
+    Returns:
+        dict: The results of the benchmark. ``N_local`` and ``N_ghost`` are
+        the mean and maximum number of local and ghost particles per rank at
+        the end of the run. The number of ghost particles measures the volume
+        of the ghost updates, which send their positions every step.
+        ``compute_time_per_step`` is the time per step each rank spends
+        outside of the MPI communication, and ``imbalance`` is its maximum
+        over all ranks divided by its mean.
+    """
+    snap, setup = WORKLOADS[workload](device)
+    n_unit = device.communicator._all_gather(
+        snap.particles.N if snap.exists else 0)[0]
+    n_rep = max(1, int(numpy.ceil((N / n_unit)**(1 / 3))))
+    if snap.exists:
+        snap.replicate(n_rep, n_rep, n_rep)
+
+    sim = hoomd.Simulation(device=device, seed=1)
+    sim.create_state_from_snapshot(snap)
+    named = setup(sim)
+    sim.run(warmup)
+
+    timed = {}
+    for i, tuner in enumerate(sim.operations.tuners):
+        timed['tuner.{}.{}'.format(i, type(tuner).__name__)] = tuner
+    integrator = sim.operations.integrator
+    timed['integrator.' + type(integrator).__name__] = integrator
+    for i, force in enumerate(getattr(integrator, 'forces', [])):
+        timed['force.{}.{}'.format(i, type(force).__name__)] = force
+    for key, obj in named.items():
+        timed[key + '.' + type(obj).__name__] = obj
+
+    sim.run(steps)
+
+    comm = device.communicator
+    comm_time = sim.communication_time_per_step
+    compute_time = sim.walltime / steps - comm_time
+    compute_stats = _rank_statistics(comm, compute_time)
+    pdata = sim.state._cpp_sys_def.getParticleData()
+
+    return dict(workload=workload,
+                N=sim.state.N_particles,
+                num_ranks=comm.num_ranks,
+                steps=steps,
+                tps=sim.tps,
+                time_per_step={
+                    key: _rank_statistics(comm, obj.time_per_step)
+                    for key, obj in timed.items()
+                },
+                communication_time_per_step=_rank_statistics(comm, comm_time),
+                compute_time_per_step=compute_stats,
+                imbalance=compute_stats['max'] / compute_stats['mean'],
+                N_local=_rank_statistics(comm, pdata.getN()),
+                N_ghost=_rank_statistics(comm, pdata.getNGhosts()))
+
+
+def main(args=None):
+    """Run the benchmark suite from the command line."""
+    parser = argparse.ArgumentParser(
+        prog='python3 -m hoomd.benchmark',
+        description='Run the HOOMD-blue benchmark suite.')
+    parser.add_argument('--device',
+                        choices=['auto', 'cpu', 'gpu'],
+                        default='auto')
+    parser.add_argument('--benchmarks',
+                        nargs='+',
+                        choices=sorted(BENCHMARKS.keys()),
+                        default=sorted(BENCHMARKS.keys()))
+    parser.add_argument('-n', type=int, default=32,
+                        help='Number of particles along each box edge.')
+    parser.add_argument('--warmup', type=int, default=1000)
+    parser.add_argument('--steps', type=int, default=1000)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--output',
+                        help='File to write the results to, '
+                        'standard output when not given.')
+    parser.add_argument('--scaling',
+                        choices=sorted(WORKLOADS.keys()),
+                        help='Run one point of a scaling study of this '
+                        'workload instead of the suite.')
+    size = parser.add_mutually_exclusive_group()
+    size.add_argument('--particles',
+                      type=int,
+                      help='Number of particles in the scaling study '
+                      '(strong scaling).')
+    size.add_argument('--particles-per-rank',
+                      type=int,
+                      help='Number of particles per rank in the scaling '
+                      'study (weak scaling).')
+    args = parser.parse_args(args)
+
+    if args.device == 'cpu':
+        device = hoomd.device.CPU(notice_level=1)
+    elif args.device == 'gpu':
+        device = hoomd.device.GPU(notice_level=1)
+    else:
+        device = hoomd.device.auto_select(notice_level=1)
 
-    tps_list = [];
+    results = dict(hoomd_version=hoomd.version.version,
+                   git_sha1=hoomd.version.git_sha1,
+                   compile_flags=hoomd.version.compile_flags,
+                   device=type(device).__name__,
+                   num_ranks=device.communicator.num_ranks,
+                   benchmarks={})
+    if args.scaling is not None:
+        if args.particles_per_rank is not None:
+            N = args.particles_per_rank * device.communicator.num_ranks
+        elif args.particles is not None:
+            N = args.particles
+        else:
+            N = args.n**3
+        results['scaling'] = scaling(args.scaling,
+                                     device,
+                                     N,
+                                     warmup=args.warmup,
+                                     steps=args.steps)
+    else:
+        for name in args.benchmarks:
+            results['benchmarks'][name] = run(name,
+                                              device,
+                                              n=args.n,
+                                              warmup=args.warmup,
+                                              steps=args.steps,
+                                              repeat=args.repeat)
 
-    if warmup > 0:
-        hoomd.run(warmup);
+    if device.communicator.rank == 0:
+        text = json.dumps(results, indent=4)
+        if args.output is None:
+            print(text)
+        else:
+            with open(args.output, 'w') as f:
+                f.write(text + '\n')
 
-    for i in range(0,repeat):
-        hoomd.run(steps, limit_hours=limit_hours);
-        tps_list.append(hoomd.context.current.system.getLastTPS());
 
-    return tps_list;
+if __name__ == '__main__':
+    main()
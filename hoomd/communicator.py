@@ -376,6 +376,14 @@ class Communicator(object):
         if hoomd.version.mpi_enabled:
             self.cpp_mpi_conf.barrier()
 
+    def _all_gather(self, value):
+        """Gather a float from every rank in the partition on all ranks.
+
+        Returns:
+            list[float]: The values of all ranks, in rank order.
+        """
+        return self.cpp_mpi_conf.allGather(float(value))
+
     @contextlib.contextmanager
     def localize_abort(self):
         """ Localize MPI_Abort to this partition.
@@ -340,6 +340,7 @@ class HOOMDArray(metaclass=_WrapClassFactory(_wrap_list)):
         """
         self._buffer = buffer
         self._callback = callback
+        self._ndarray = None
         if read_only is None:
             try:
                 self._read_only = buffer.read_only
@@ -410,15 +411,17 @@ class HOOMDArray(metaclass=_WrapClassFactory(_wrap_list)):
     def _coerce_to_ndarray(self):
         """Provide a `numpy.ndarray` interface to the underlying buffer.
 
-        Raises a `HOOMDArrayError` when the provide callback returns False.
+        Raises a `HOOMDArrayError` when the provide callback returns False. The
+        array is created once and reused for every access, including in later
+        context managers that expose the same buffer.
         """
         if self._callback():
-            if self._read_only:
+            if self._ndarray is None:
                 arr = np.array(self._buffer, copy=False)
-                arr.flags['WRITEABLE'] = False
-                return arr
-            else:
-                return np.array(self._buffer, copy=False)
+                if self._read_only:
+                    arr.flags['WRITEABLE'] = False
+                self._ndarray = arr
+            return self._ndarray
         else:
             raise HOOMDArrayError(
                 "Cannot access {} outside context manager. Use "
@@ -482,6 +485,7 @@ if hoomd.version.gpu_enabled:
         def __init__(self, buffer, callback, read_only=None):
             self._buffer = buffer
             self._callback = callback
+            self._ndarray = None
             if read_only is None:
                 self._read_only = buffer.read_only
             else:
@@ -609,7 +613,9 @@ if hoomd.version.gpu_enabled:
                 False.
                 """
                 if self._callback():
-                    return cupy.array(self._buffer, copy=False)
+                    if self._ndarray is None:
+                        self._ndarray = cupy.array(self._buffer, copy=False)
+                    return self._ndarray
                 else:
                     raise HOOMDArrayError(
                         "Cannot access {} outside context manager. Use "
@@ -4,7 +4,7 @@ from hoomd import _hoomd
 
 
 class _LocalAccess(ABC):
-    __slots__ = ('_entered', '_accessed_fields', '_cpp_obj')
+    __slots__ = ('_entered', '_accessed_fields', '_cached_fields', '_cpp_obj')
     _global_fields = {'rtag': 'getRTags'}
 
     @property
@@ -19,7 +19,10 @@ class _LocalAccess(ABC):
 
     def __init__(self):
         self._entered = False
+        # arrays accessed in the current context manager
         self._accessed_fields = dict()
+        # (buffer key, array) of every field accessed in any context manager
+        self._cached_fields = dict()
 
     def __getattr__(self, attr):
         if attr in self._accessed_fields:
@@ -34,7 +37,19 @@ class _LocalAccess(ABC):
                 raise AttributeError(
                     "{} object has no attribute {}".format(type(self), attr))
 
-        self._accessed_fields[attr] = arr = self._array_cls(buff, lambda: self._entered)
+        # Getting the buffer synchronizes the data. When it exposes the same
+        # memory as in an earlier context manager, reuse that array and the
+        # views it holds.
+        key = buff.key
+        cached = self._cached_fields.get(attr)
+        if cached is not None and cached[0] == key:
+            arr = cached[1]
+        else:
+            arr = self._array_cls(
+                buff, lambda: self._entered and self._accessed_fields.get(
+                    attr) is arr)
+            self._cached_fields[attr] = (key, arr)
+        self._accessed_fields[attr] = arr
         return arr
 
     def _get_raw_attr_and_flag(self, attr):
@@ -380,6 +395,8 @@ class _LocalSnapshot:
 
     def __enter__(self):
         self._state._in_context_manager = True
+        self._box = self._state.box
+        self._local_box = self._state._cpp_sys_def.getParticleData().getBox()
         self._particles._enter()
         self._bonds._enter()
         self._angles._enter()
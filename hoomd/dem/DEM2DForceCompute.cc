@@ -12,6 +12,13 @@
 #include <pybind11/pybind11.h>
 
 #include <stdexcept>
+#include <atomic>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
 
 #ifdef ENABLE_OPENMP
 #include <omp.h>
@@ -247,10 +254,53 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
     // tally up the number of forces calculated
-    int64_t n_calc = 0;
+    std::atomic<int64_t> n_calc(0);
+
+    const unsigned int N = m_pdata->getN();
+
+    #ifdef ENABLE_TBB
+    // with a half neighbor list, several threads may add to the same particle j concurrently, so each thread
+    // accumulates into a private copy of the force, torque and virial arrays which are reduced at the end
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_force;
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_torque;
+    tbb::enumerable_thread_specific< std::vector<Scalar> > thread_virial;
+
+    // for each particle
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    Scalar4 *force = h_force.data;
+    Scalar4 *torque = h_torque.data;
+    Scalar *virial = h_virial.data;
+    if (third_law)
+        {
+        bool exists = false;
+        std::vector<Scalar4>& my_force = thread_force.local(exists);
+        std::vector<Scalar4>& my_torque = thread_torque.local();
+        std::vector<Scalar>& my_virial = thread_virial.local();
+        if (!exists)
+            {
+            my_force.resize(N, make_scalar4(0,0,0,0));
+            my_torque.resize(N, make_scalar4(0,0,0,0));
+            my_virial.resize(6*virial_pitch, Scalar(0.0));
+            }
+        force = my_force.data();
+        torque = my_torque.data();
+        virial = my_virial.data();
+        }
+
+    // the evaluator holds the per-pair diameters and velocities
+    DEMEvaluator<Real, Real4, Potential> evaluator(m_evaluator);
+
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    Scalar4 *force = h_force.data;
+    Scalar4 *torque = h_torque.data;
+    Scalar *virial = h_virial.data;
+    DEMEvaluator<Real, Real4, Potential> &evaluator = m_evaluator;
 
     // for each particle
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         vec3<Scalar> pi(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -287,11 +337,9 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
         // loop over all of the neighbors of this particle
         const unsigned int myHead = h_head_list.data[i];
         const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        n_calc += size;
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
             unsigned int k = h_nlist.data[myHead + j];
             // sanity check
@@ -318,18 +366,18 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
             if (Potential::needsDiameter())
                 {
                 dj = h_diameter.data[k];
-                m_evaluator.setDiameter(di,dj);
+                evaluator.setDiameter(di,dj);
                 }
 
             if(Potential::needsVelocity())
-                m_evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
+                evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
 
             // start computing the force
             // calculate r squared (FLOPS: 5)
             Scalar rsq = dot(dx, dx);
 
             // only compute the force if the particles are closer than the cutoff (FLOPS: 1)
-            if (m_evaluator.withinCutoff(rsq,r_cut_sq))
+            if (evaluator.withinCutoff(rsq,r_cut_sq))
                 {
                 // local forces and torques for particles i and j
                 vec2<Real> forceij, forceji;
@@ -351,7 +399,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                         for(typename vector<vec2<Real> >::const_iterator vjIter(vertices_j.begin());
                             vjIter + 1 != vertices_j.end(); ++vjIter)
                             {
-                            m_evaluator.vertexEdge(dx, *viIter, *vjIter, *(vjIter + 1),
+                            evaluator.vertexEdge(dx, *viIter, *vjIter, *(vjIter + 1),
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                             }
@@ -359,7 +407,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                         // didn't just evaluate that edge (i.e. the
                         // shape isn't a spherocylinder)
                         if(vertices_j.size() > 2)
-                            m_evaluator.vertexEdge(dx, *viIter, vertices_j.back(), vertices_j.front(),
+                            evaluator.vertexEdge(dx, *viIter, vertices_j.back(), vertices_j.front(),
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                         }
@@ -374,7 +422,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                         for(typename vector<vec2<Real> >::const_iterator viIter(vertices_i.begin());
                             viIter + 1 != vertices_i.end(); ++viIter)
                             {
-                            m_evaluator.vertexEdge(-dx, *vjIter, *viIter, *(viIter + 1),
+                            evaluator.vertexEdge(-dx, *vjIter, *viIter, *(viIter + 1),
                                 potentialij, forceji, torqueji,
                                 forceij, torqueij);
                             }
@@ -382,7 +430,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                         // didn't just evaluate that edge (i.e. the
                         // shape isn't a spherocylinder)
                         if(vertices_i.size() > 2)
-                            m_evaluator.vertexEdge(-dx, *vjIter, vertices_i.back(), vertices_i.front(),
+                            evaluator.vertexEdge(-dx, *vjIter, vertices_i.back(), vertices_i.front(),
                                 potentialij, forceji, torqueji,
                                 forceij, torqueij);
                         }
@@ -391,7 +439,7 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                 // edges, both are disks
                 else if(vertices_j.size() <= 1)
                     {
-                    m_evaluator.vertexVertex(dx, vertices_i[0], dx + vertices_j[0],
+                    evaluator.vertexVertex(dx, vertices_i[0], dx + vertices_j[0],
                         potentialij, forceij, torqueij,
                         forceji, torqueji);
                     }
@@ -416,15 +464,15 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                 viriali[3] += pair_virial[3];
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                if (third_law && k < m_pdata->getN())
+                if (third_law && k < N)
                     {
-                    h_force.data[k].x  += forceji.x;
-                    h_force.data[k].y  += forceji.y;
-                    h_force.data[k].w  += potentialij;
-                    h_torque.data[k].z += torqueji;
-                    h_virial.data[0*virial_pitch + k] += pair_virial[0];
-                    h_virial.data[1*virial_pitch + k] += pair_virial[1];
-                    h_virial.data[3*virial_pitch + k] += pair_virial[3];
+                    force[k].x  += forceji.x;
+                    force[k].y  += forceji.y;
+                    force[k].w  += potentialij;
+                    torque[k].z += torqueji;
+                    virial[0*virial_pitch + k] += pair_virial[0];
+                    virial[1*virial_pitch + k] += pair_virial[1];
+                    virial[3*virial_pitch + k] += pair_virial[3];
                     }
                 }
 
@@ -432,18 +480,59 @@ void DEM2DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
 
         // finally, increment the force, potential energy and virial for particle i
         // (MEM TRANSFER: 10 scalars / FLOPS: 5)
-        h_force.data[i].x  += fi.x;
-        h_force.data[i].y  += fi.y;
-        h_force.data[i].w  += pei;
-        h_torque.data[i].z += ti;
-        h_virial.data[0*virial_pitch + i] += viriali[0];
-        h_virial.data[1*virial_pitch + i] += viriali[1];
-        h_virial.data[3*virial_pitch + i] += viriali[3];
+        force[i].x  += fi.x;
+        force[i].y  += fi.y;
+        force[i].w  += pei;
+        torque[i].z += ti;
+        virial[0*virial_pitch + i] += viriali[0];
+        virial[1*virial_pitch + i] += viriali[1];
+        virial[3*virial_pitch + i] += viriali[3];
+        }
+    #ifdef ENABLE_TBB
+        });
+
+    // reduce the per-thread accumulators of the half neighbor list path
+    if (third_law)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+            for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+                {
+                const Scalar4 *my_force = it->data();
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    h_force.data[i].x += my_force[i].x;
+                    h_force.data[i].y += my_force[i].y;
+                    h_force.data[i].z += my_force[i].z;
+                    h_force.data[i].w += my_force[i].w;
+                    }
+                }
+
+            for (auto it = thread_torque.begin(); it != thread_torque.end(); ++it)
+                {
+                const Scalar4 *my_torque = it->data();
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    h_torque.data[i].x += my_torque[i].x;
+                    h_torque.data[i].y += my_torque[i].y;
+                    h_torque.data[i].z += my_torque[i].z;
+                    }
+                }
+
+            for (auto it = thread_virial.begin(); it != thread_virial.end(); ++it)
+                {
+                const Scalar *my_virial = it->data();
+                for (unsigned int k = 0; k < 6; ++k)
+                    for (unsigned int i = r.begin(); i != r.end(); ++i)
+                        h_virial.data[k*virial_pitch+i] += my_virial[k*virial_pitch+i];
+                }
+            });
         }
+    #endif
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+14+6+8);
+    int64_t flops = N * 5 + n_calc * (3+5+9+1+14+6+8);
     if (third_law) flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Scalar) + n_calc * (1+3+1)*sizeof(Scalar);
+    int64_t mem_transfer = N * (5+4+10)*sizeof(Scalar) + n_calc * (1+3+1)*sizeof(Scalar);
     if (third_law) mem_transfer += n_calc*10*sizeof(Scalar);
     if (m_prof) m_prof->pop(flops, mem_transfer);
     }
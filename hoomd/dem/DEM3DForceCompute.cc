@@ -16,6 +16,13 @@
 #include <stdexcept>
 #include <utility>
 #include <set>
+#include <atomic>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
 
 #ifdef ENABLE_OPENMP
 #include <omp.h>
@@ -46,7 +53,7 @@ DEM3DForceCompute<Real, Real4, Potential>::DEM3DForceCompute(
       m_numTypeEdges(0, this->m_exec_conf), m_numTypeFaces(0, this->m_exec_conf),
       m_vertexConnectivity(0, this->m_exec_conf), m_edges(0, this->m_exec_conf),
       m_faceRcutSq(0, this->m_exec_conf), m_edgeRcutSq(0, this->m_exec_conf),
-      m_verts(0, this->m_exec_conf), m_shapes(), m_facesVec()
+      m_faceSphere(0, this->m_exec_conf), m_verts(0, this->m_exec_conf), m_shapes(), m_facesVec()
     {
     m_exec_conf->msg->notice(5) << "Constructing DEM3DForceCompute" << endl;
 
@@ -240,6 +247,9 @@ void DEM3DForceCompute<Real, Real4, Potential>::createGeometry()
     if(m_faceRcutSq.getNumElements() != nFaces)
         m_faceRcutSq.resize(nFaces);
 
+    if(m_faceSphere.getNumElements() != nFaces)
+        m_faceSphere.resize(nFaces);
+
     if(m_firstTypeVert.getNumElements() != nTypes)
         m_firstTypeVert.resize(nTypes);
 
@@ -270,6 +280,8 @@ void DEM3DForceCompute<Real, Real4, Potential>::createGeometry()
         access_mode::overwrite);
     ArrayHandle<Real> h_edgeRcutSq(m_edgeRcutSq, access_location::host,
         access_mode::overwrite);
+    ArrayHandle<Real4> h_faceSphere(m_faceSphere, access_location::host,
+        access_mode::overwrite);
     ArrayHandle<unsigned int> h_nextFaceVert(m_nextFaceVert, access_location::host,
         access_mode::overwrite);
     ArrayHandle<unsigned int> h_realVertIndex(m_realVertIndex, access_location::host,
@@ -342,6 +354,33 @@ void DEM3DForceCompute<Real, Real4, Potential>::createGeometry()
             }
         }
 
+    // build m_faceSphere: the sphere around the centroid of each face
+    // that contains all of its vertices
+    memset(h_faceSphere.data, 0, sizeof(Real4)*nFaces);
+    for(size_t shapeIdx(0); shapeIdx < m_facesVec.size(); ++shapeIdx)
+        {
+        for(size_t faceIdx(shapeIdx), vecIdx(0);
+            vecIdx < m_facesVec[shapeIdx].size();
+            faceIdx = h_nextFace.data[faceIdx], ++vecIdx)
+            {
+            const vector<unsigned int> &face(m_facesVec[shapeIdx][vecIdx]);
+
+            vec3<Real> center;
+            for(size_t vertIdx(0); vertIdx < face.size(); ++vertIdx)
+                center += m_shapes[shapeIdx][face[vertIdx]];
+            center /= Real(face.size());
+
+            Real radiussq(0);
+            for(size_t vertIdx(0); vertIdx < face.size(); ++vertIdx)
+                {
+                const vec3<Real> delta(m_shapes[shapeIdx][face[vertIdx]] - center);
+                radiussq = max(radiussq, dot(delta, delta));
+                }
+
+            h_faceSphere.data[faceIdx] = vec_to_scalar4(center, sqrt(radiussq));
+            }
+        }
+
     // build m_nextFaceVert
     for(size_t shapeIdx(0), vertCount(0);
         shapeIdx < m_facesVec.size(); ++shapeIdx)
@@ -619,6 +658,8 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
         access_mode::read);
     ArrayHandle<Real> h_edgeRcutSq(m_edgeRcutSq, access_location::host,
         access_mode::read);
+    ArrayHandle<Real4> h_faceSphere(m_faceSphere, access_location::host,
+        access_mode::read);
     ArrayHandle<unsigned int> h_nextFaceVert(m_nextFaceVert, access_location::host,
         access_mode::read);
     ArrayHandle<unsigned int> h_realVertIndex(m_realVertIndex, access_location::host,
@@ -650,10 +691,53 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
     // tally up the number of forces calculated
-    int64_t n_calc = 0;
+    std::atomic<int64_t> n_calc(0);
+
+    const unsigned int N = m_pdata->getN();
+
+    #ifdef ENABLE_TBB
+    // with a half neighbor list, several threads may add to the same particle j concurrently, so each thread
+    // accumulates into a private copy of the force, torque and virial arrays which are reduced at the end
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_force;
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_torque;
+    tbb::enumerable_thread_specific< std::vector<Scalar> > thread_virial;
+
+    // for each particle
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    Scalar4 *force = h_force.data;
+    Scalar4 *torque = h_torque.data;
+    Scalar *virial = h_virial.data;
+    if (third_law)
+        {
+        bool exists = false;
+        std::vector<Scalar4>& my_force = thread_force.local(exists);
+        std::vector<Scalar4>& my_torque = thread_torque.local();
+        std::vector<Scalar>& my_virial = thread_virial.local();
+        if (!exists)
+            {
+            my_force.resize(N, make_scalar4(0,0,0,0));
+            my_torque.resize(N, make_scalar4(0,0,0,0));
+            my_virial.resize(6*virial_pitch, Scalar(0.0));
+            }
+        force = my_force.data();
+        torque = my_torque.data();
+        virial = my_virial.data();
+        }
+
+    // the evaluator holds the per-pair diameters and velocities
+    DEMEvaluator<Real, Real4, Potential> evaluator(m_evaluator);
+
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    Scalar4 *force = h_force.data;
+    Scalar4 *torque = h_torque.data;
+    Scalar *virial = h_virial.data;
+    DEMEvaluator<Real, Real4, Potential> &evaluator = m_evaluator;
 
     // for each particle
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         vec3<Scalar> pi(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -685,11 +769,9 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
         // loop over all of the neighbors of this particle
         const unsigned int myHead = h_head_list.data[i];
         const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        n_calc += size;
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
             unsigned int k = h_nlist.data[myHead + j];
             // sanity check
@@ -716,24 +798,27 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
             if (Potential::needsDiameter())
                 {
                 dj = h_diameter.data[k];
-                m_evaluator.setDiameter(di,dj);
+                evaluator.setDiameter(di,dj);
                 }
 
             if(Potential::needsVelocity())
-                m_evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
+                evaluator.setVelocity(vi - vec3<Scalar>(h_velocity.data[k]));
 
             // start computing the force
             // calculate r squared (FLOPS: 5)
             Real rsq = dot(dx, dx);
 
             // only compute the force if the particles are closer than the cutoff (FLOPS: 1)
-            if (m_evaluator.withinCutoff(rsq,r_cut_sq))
+            if (evaluator.withinCutoff(rsq,r_cut_sq))
                 {
                 // local forces and torques for particles i and j
                 vec3<Real> forceij, forceji;
                 vec3<Real> torqueij, torqueji;
                 Real potentialij(0);
 
+                // range of the vertex/face interaction for this pair
+                const Real range(evaluator.getInteractionRange());
+
                 // iterate over each vertex in particle i
                 for(size_t vertIndex(0); vertIndex < h_numTypeVerts.data[typei]; ++vertIndex)
                     {
@@ -744,16 +829,23 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                     size_t faceIndex(typej);
                     if(h_numTypeFaces.data[typej] > 0)
                         {
+                        // vertex relative to the center of j
+                        const vec3<Real> vertex0j(vertex0 - dx);
                         do
                             {
-                            m_evaluator.vertexFace(dx, vertex0, quatj,
-                                h_verts.data,
-                                h_realVertIndex.data,
-                                h_nextFaceVert.data,
-                                h_firstFaceVert.data[faceIndex],
-                                potentialij,
-                                forceij, torqueij,
-                                forceji, torqueji);
+                            // skip faces whose bounding sphere is out of range
+                            const vec3<Real> center(rotate(quatj, vec3<Real>(h_faceSphere.data[faceIndex])));
+                            const vec3<Real> delta(vertex0j - center);
+                            const Real reach(h_faceSphere.data[faceIndex].w + range);
+                            if(dot(delta, delta) <= reach*reach)
+                                evaluator.vertexFace(dx, vertex0, quatj,
+                                    h_verts.data,
+                                    h_realVertIndex.data,
+                                    h_nextFaceVert.data,
+                                    h_firstFaceVert.data[faceIndex],
+                                    potentialij,
+                                    forceij, torqueij,
+                                    forceji, torqueji);
                             faceIndex = h_nextFace.data[faceIndex];
                             }
                         while(faceIndex != typej);
@@ -769,7 +861,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                             p10 = rotate(quatj, p10);
                             p11 = rotate(quatj, p11);
 
-                            m_evaluator.vertexEdge(dx, vertex0, p10, p11,
+                            evaluator.vertexEdge(dx, vertex0, p10, p11,
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                             }
@@ -783,7 +875,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                             vec3<Real> vertex1(h_verts.data[h_firstTypeVert.data[typej] + vertj]);
                             vertex1 = rotate(quatj, vertex1);
 
-                            m_evaluator.vertexVertex(dx, vertex0, dx + vertex1,
+                            evaluator.vertexVertex(dx, vertex0, dx + vertex1,
                                 potentialij, forceij, torqueij,
                                 forceji, torqueji);
                             }
@@ -800,16 +892,23 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                     size_t faceIndex(typei);
                     if(h_numTypeFaces.data[typei] > 0)
                         {
+                        // vertex relative to the center of i
+                        const vec3<Real> vertex0i(vertex0 + dx);
                         do
                             {
-                            m_evaluator.vertexFace(-dx, vertex0, quati,
-                                h_verts.data,
-                                h_realVertIndex.data,
-                                h_nextFaceVert.data,
-                                h_firstFaceVert.data[faceIndex],
-                                potentialij,
-                                forceji, torqueji,
-                                forceij, torqueij);
+                            // skip faces whose bounding sphere is out of range
+                            const vec3<Real> center(rotate(quati, vec3<Real>(h_faceSphere.data[faceIndex])));
+                            const vec3<Real> delta(vertex0i - center);
+                            const Real reach(h_faceSphere.data[faceIndex].w + range);
+                            if(dot(delta, delta) <= reach*reach)
+                                evaluator.vertexFace(-dx, vertex0, quati,
+                                    h_verts.data,
+                                    h_realVertIndex.data,
+                                    h_nextFaceVert.data,
+                                    h_firstFaceVert.data[faceIndex],
+                                    potentialij,
+                                    forceji, torqueji,
+                                    forceij, torqueij);
                             faceIndex = h_nextFace.data[faceIndex];
                             }
                         while(faceIndex != typei);
@@ -825,7 +924,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                             p10 = rotate(quati, p10);
                             p11 = rotate(quati, p11);
 
-                            m_evaluator.vertexEdge(-dx, vertex0, p10, p11,
+                            evaluator.vertexEdge(-dx, vertex0, p10, p11,
                                 potentialij, forceji, torqueji,
                                 forceij, torqueij);
                             }
@@ -851,7 +950,7 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                         p10 = rotate(quatj, p10);
                         p11 = rotate(quatj, p11);
 
-                        m_evaluator.edgeEdge(dx, p00, p01, dx + p10, dx + p11, potentialij, forceij, torqueij, forceji, torqueji);
+                        evaluator.edgeEdge(dx, p00, p01, dx + p10, dx + p11, potentialij, forceij, torqueij, forceji, torqueji);
                         }
                     }
 
@@ -880,21 +979,21 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
                 viriali[5] += pair_virial[5];
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                if (third_law && k < m_pdata->getN())
+                if (third_law && k < N)
                     {
-                    h_force.data[k].x  += forceji.x;
-                    h_force.data[k].y  += forceji.y;
-                    h_force.data[k].z  += forceji.z;
-                    h_force.data[k].w  += potentialij;
-                    h_torque.data[k].x += torqueji.x;
-                    h_torque.data[k].y += torqueji.y;
-                    h_torque.data[k].z += torqueji.z;
-                    h_virial.data[0*virial_pitch + k] += pair_virial[0];
-                    h_virial.data[1*virial_pitch + k] += pair_virial[1];
-                    h_virial.data[2*virial_pitch + k] += pair_virial[2];
-                    h_virial.data[3*virial_pitch + k] += pair_virial[3];
-                    h_virial.data[4*virial_pitch + k] += pair_virial[4];
-                    h_virial.data[5*virial_pitch + k] += pair_virial[5];
+                    force[k].x  += forceji.x;
+                    force[k].y  += forceji.y;
+                    force[k].z  += forceji.z;
+                    force[k].w  += potentialij;
+                    torque[k].x += torqueji.x;
+                    torque[k].y += torqueji.y;
+                    torque[k].z += torqueji.z;
+                    virial[0*virial_pitch + k] += pair_virial[0];
+                    virial[1*virial_pitch + k] += pair_virial[1];
+                    virial[2*virial_pitch + k] += pair_virial[2];
+                    virial[3*virial_pitch + k] += pair_virial[3];
+                    virial[4*virial_pitch + k] += pair_virial[4];
+                    virial[5*virial_pitch + k] += pair_virial[5];
                     }
                 }
 
@@ -902,24 +1001,65 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(uint64_t timestep)
 
         // finally, increment the force, potential energy and virial for particle i
         // (MEM TRANSFER: 10 scalars / FLOPS: 5)
-        h_force.data[i].x  += fi.x;
-        h_force.data[i].y  += fi.y;
-        h_force.data[i].z  += fi.z;
-        h_force.data[i].w  += pei;
-        h_torque.data[i].x += ti.x;
-        h_torque.data[i].y += ti.y;
-        h_torque.data[i].z += ti.z;
-        h_virial.data[0*virial_pitch + i] += viriali[0];
-        h_virial.data[1*virial_pitch + i] += viriali[1];
-        h_virial.data[2*virial_pitch + i] += viriali[2];
-        h_virial.data[3*virial_pitch + i] += viriali[3];
-        h_virial.data[4*virial_pitch + i] += viriali[4];
-        h_virial.data[5*virial_pitch + i] += viriali[5];
+        force[i].x  += fi.x;
+        force[i].y  += fi.y;
+        force[i].z  += fi.z;
+        force[i].w  += pei;
+        torque[i].x += ti.x;
+        torque[i].y += ti.y;
+        torque[i].z += ti.z;
+        virial[0*virial_pitch + i] += viriali[0];
+        virial[1*virial_pitch + i] += viriali[1];
+        virial[2*virial_pitch + i] += viriali[2];
+        virial[3*virial_pitch + i] += viriali[3];
+        virial[4*virial_pitch + i] += viriali[4];
+        virial[5*virial_pitch + i] += viriali[5];
+        }
+    #ifdef ENABLE_TBB
+        });
+
+    // reduce the per-thread accumulators of the half neighbor list path
+    if (third_law)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+            for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+                {
+                const Scalar4 *my_force = it->data();
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    h_force.data[i].x += my_force[i].x;
+                    h_force.data[i].y += my_force[i].y;
+                    h_force.data[i].z += my_force[i].z;
+                    h_force.data[i].w += my_force[i].w;
+                    }
+                }
+
+            for (auto it = thread_torque.begin(); it != thread_torque.end(); ++it)
+                {
+                const Scalar4 *my_torque = it->data();
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    h_torque.data[i].x += my_torque[i].x;
+                    h_torque.data[i].y += my_torque[i].y;
+                    h_torque.data[i].z += my_torque[i].z;
+                    }
+                }
+
+            for (auto it = thread_virial.begin(); it != thread_virial.end(); ++it)
+                {
+                const Scalar *my_virial = it->data();
+                for (unsigned int k = 0; k < 6; ++k)
+                    for (unsigned int i = r.begin(); i != r.end(); ++i)
+                        h_virial.data[k*virial_pitch+i] += my_virial[k*virial_pitch+i];
+                }
+            });
         }
+    #endif
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3+5+9+1+14+6+8);
+    int64_t flops = N * 5 + n_calc * (3+5+9+1+14+6+8);
     if (third_law) flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5+4+10)*sizeof(Real) + n_calc * (1+3+1)*sizeof(Real);
+    int64_t mem_transfer = N * (5+4+10)*sizeof(Real) + n_calc * (1+3+1)*sizeof(Real);
     if (third_law) mem_transfer += n_calc*10*sizeof(Real);
     if (m_prof) m_prof->pop(flops, mem_transfer);
     }
@@ -148,6 +148,7 @@ class DEM3DForceCompute : public ForceCompute
         GPUArray<unsigned int> m_edges; //!< 2*edge->first real vert, 2*edge+1->second real vert in edge
         GPUArray<Real> m_faceRcutSq; //!< face index->rcut*rcut
         GPUArray<Real> m_edgeRcutSq; //!< edge index->rcut*rcut
+        GPUArray<Real4> m_faceSphere; //!< face index->bounding sphere center (xyz) and radius (w) in the body frame
         GPUArray<Real4> m_verts; //! Vertices for each real index
         std::vector<std::vector<vec3<Real> > > m_shapes; //!< Vertices for each type
         std::vector<std::vector<std::vector<unsigned int> > > m_facesVec; //!< Faces for each type
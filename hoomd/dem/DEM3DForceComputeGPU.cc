@@ -19,6 +19,7 @@
 #include "hip/hip_runtime.h"
 
 #include <stdexcept>
+#include <string>
 
 #include <pybind11/pybind11.h>
 
@@ -47,9 +48,9 @@ DEM3DForceComputeGPU<Real, Real4, Potential>::DEM3DForceComputeGPU(std::shared_p
         throw std::runtime_error("Error initializing DEM3DForceComputeGPU");
         }
 
-    unsigned warp_size = this->m_exec_conf->dev_prop.warpSize;
-    unsigned max_threads = this->m_exec_conf->dev_prop.maxThreadsPerBlock;
-    m_tuner.reset(new Autotuner(warp_size, max_threads, warp_size, 5, 100000, "dem_3d", this->m_exec_conf));
+    m_tuner_period = 100000;
+    m_tuner_enabled = true;
+    initTuner();
     }
 
 /*! Destructor. */
@@ -58,6 +59,34 @@ DEM3DForceComputeGPU<Real, Real4, Potential>::~DEM3DForceComputeGPU()
     {
     }
 
+/*! The autotuner chooses between gpu_compute_dem3d_forces_kernel, which assigns one thread to each vertex and
+  edge of a particle, and gpu_compute_dem3d_forces_warp_kernel, which spreads the features of one pair over a
+  group of threads. Which one is faster depends on the number of vertices, edges, and faces of the shapes, so the
+  autotuner is created anew (and named) for every shape complexity given by maxGPUThreads().
+
+  The parameters are encoded as block_size*10000 + threads_per_pair, where threads_per_pair is 0 for
+  gpu_compute_dem3d_forces_kernel.
+*/
+template<typename Real, typename Real4, typename Potential>
+void DEM3DForceComputeGPU<Real, Real4, Potential>::initTuner()
+    {
+    m_tuner_features = this->maxGPUThreads();
+
+    std::vector<unsigned int> valid_params;
+    const unsigned int warp_size = this->m_exec_conf->dev_prop.warpSize;
+    const unsigned int max_threads = this->m_exec_conf->dev_prop.maxThreadsPerBlock;
+    for (unsigned int block_size = warp_size; block_size <= max_threads; block_size += warp_size)
+        {
+        valid_params.push_back(block_size*10000);
+        for (auto s : Autotuner::getTppListPow2(warp_size))
+            valid_params.push_back(block_size*10000 + s);
+        }
+
+    m_tuner.reset(new Autotuner(valid_params, 5, m_tuner_period, "dem_3d_" + std::to_string(m_tuner_features),
+        this->m_exec_conf));
+    m_tuner->setEnabled(m_tuner_enabled);
+    }
+
 /*!  maxGPUThreads: returns the maximum number of GPU threads
   (2*vertices + edges) that will be needed among all shapes in the
   system.
@@ -120,14 +149,31 @@ void DEM3DForceComputeGPU<Real, Real4, Potential>::computeForces(uint64_t timest
         }
 
     size_t threadsPerParticle(this->maxGPUThreads());
-    size_t particlesPerBlock(m_tuner->getParam()/threadsPerParticle);
-    // cap the block size so we don't have forces for one particle
-    // spread among multiple blocks
-    particlesPerBlock = min(particlesPerBlock,
-        (size_t)(this->m_exec_conf->dev_prop.maxThreadsPerBlock)/threadsPerParticle);
-    // don't use too many registers (~145 per thread)
-    particlesPerBlock = min(particlesPerBlock,
-        (size_t)(this->m_exec_conf->dev_prop.regsPerBlock/threadsPerParticle/145));
+
+    // the shapes changed, tune again
+    if (threadsPerParticle != m_tuner_features)
+        initTuner();
+
+    const unsigned int param = m_tuner->getParam();
+    const unsigned int blockSize = param/10000;
+    const unsigned int threadsPerPair = param%10000;
+
+    size_t particlesPerBlock;
+    if (threadsPerPair > 0)
+        {
+        particlesPerBlock = blockSize/threadsPerPair;
+        }
+    else
+        {
+        particlesPerBlock = blockSize/threadsPerParticle;
+        // cap the block size so we don't have forces for one particle
+        // spread among multiple blocks
+        particlesPerBlock = min(particlesPerBlock,
+            (size_t)(this->m_exec_conf->dev_prop.maxThreadsPerBlock)/threadsPerParticle);
+        // don't use too many registers (~145 per thread)
+        particlesPerBlock = min(particlesPerBlock,
+            (size_t)(this->m_exec_conf->dev_prop.regsPerBlock/threadsPerParticle/145));
+        }
     // we better calculate for at least one particle per block
     particlesPerBlock = max(particlesPerBlock, (size_t)1);
 
@@ -188,7 +234,7 @@ void DEM3DForceComputeGPU<Real, Real4, Potential>::computeForces(uint64_t timest
         (unsigned int)this->numVertices(), (unsigned int)this->numEdges(),
         this->m_pdata->getNTypes(), box, d_n_neigh.data, d_nlist.data,
         d_head_list.data, this->m_evaluator, this->m_r_cut * this->m_r_cut,
-        (unsigned int)particlesPerBlock, d_firstTypeVert.data, d_numTypeVerts.data,
+        (unsigned int)particlesPerBlock, threadsPerPair, d_firstTypeVert.data, d_numTypeVerts.data,
         d_firstTypeEdge.data, d_numTypeEdges.data, d_numTypeFaces.data,
         d_vertexConnectivity.data, d_edges.data);
 
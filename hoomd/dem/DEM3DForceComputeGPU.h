@@ -45,6 +45,8 @@ class DEM3DForceComputeGPU: public DEM3DForceCompute<Real, Real4, Potential>
         //! Set parameters for the builtin autotuner
         virtual void setAutotunerParams(bool enable, unsigned int period)
             {
+            m_tuner_period = period;
+            m_tuner_enabled = enable;
             m_tuner->setPeriod(period);
             m_tuner->setEnabled(enable);
             }
@@ -53,7 +55,13 @@ class DEM3DForceComputeGPU: public DEM3DForceCompute<Real, Real4, Potential>
         size_t maxGPUThreads() const;
 
     protected:
-        std::unique_ptr<Autotuner> m_tuner;     //!< Autotuner for block size
+        std::unique_ptr<Autotuner> m_tuner;     //!< Autotuner for block size and threads per pair
+        size_t m_tuner_features;                //!< maxGPUThreads() of the shapes m_tuner was created for
+        unsigned int m_tuner_period;            //!< Period of the autotuner
+        bool m_tuner_enabled;                   //!< True when the autotuner is enabled
+
+        //! Create the autotuner for the current shapes
+        void initTuner();
 
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
@@ -15,6 +15,7 @@
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/Index1D.h"
 #include "hoomd/TextureTools.h"
+#include "hoomd/WarpTools.cuh"
 #include "DEM3DForceGPU.cuh"
 #include "hoomd/HOOMDMath.h"
 #include "atomics.cuh"
@@ -455,6 +456,413 @@ __global__ void gpu_compute_dem3d_forces_kernel(
         }
     }
 
+//! Index of the \a f-th face of shape \a type
+/*! The first face of each shape is stored at the index of the type, the others follow contiguously from
+    nextFaces[type].
+*/
+__device__ inline unsigned int dem3d_face_index(const unsigned int *nextFaces, unsigned int type, unsigned int f)
+    {
+    return f == 0 ? type : nextFaces[type] + f - 1;
+    }
+
+//! Kernel for calculating 3D DEM forces with a group of threads per particle
+/*! \tparam tpp Number of threads that cooperatively evaluate each particle pair, a power of 2 no larger than the warp
+
+  The arguments are the same as for gpu_compute_dem3d_forces_kernel.
+
+  Developer information:
+  Each group of tpp consecutive threads calculates the force on one particle. The group walks the neighbor list
+  of the particle and, for every neighbor within the cutoff, spreads the vertex/face, vertex/edge and edge/edge
+  combinations of the pair over its threads. With many vertices and faces per shape this keeps the whole warp
+  busy on one pair at a time, where gpu_compute_dem3d_forces_kernel leaves the threads of short feature lists
+  idle. The partial sums are reduced with warp shuffles at the end.
+
+  Enough shared memory to hold the real vertices (Real4) as well as the face, degenerate vertex, edge, and
+  per-type index arrays (unsigned int) should be allocated for the kernel call.
+*/
+template<typename Real, typename Real4, typename Evaluator, int tpp>
+__global__ void gpu_compute_dem3d_forces_warp_kernel(
+    const Scalar4* d_pos, const Scalar4* d_quat,
+    Scalar4* d_force, Scalar4* d_torque, Scalar* d_virial,
+    const size_t virial_pitch, const unsigned int N,
+    const unsigned int *d_nextFaces, const unsigned int *d_firstFaceVertices,
+    const unsigned int *d_nextVertices, const unsigned int *d_realVertices,
+    const Real4 *d_vertices, const Scalar *d_diam, const Scalar4 *d_velocity,
+    const unsigned int numFaces, const unsigned int numDegenerateVerts,
+    const unsigned int numVerts, const unsigned int numEdges,
+    const unsigned int numTypes, const BoxDim box, const unsigned int *d_n_neigh,
+    const unsigned int *d_nlist, const unsigned int *d_head_list, Evaluator evaluator,
+    const Real r_cutsq, const unsigned int *d_firstTypeVert,
+    const unsigned int *d_numTypeVerts, const unsigned int *d_firstTypeEdge,
+    const unsigned int *d_numTypeEdges, const unsigned int *d_numTypeFaces,
+    const unsigned int *d_edges)
+    {
+    HIP_DYNAMIC_SHARED( int, sh)
+
+    // real vertex index->vertex (position)
+    Real4 *vertices((Real4*)sh);
+    size_t shOffset(sizeof(Real4)/sizeof(int)*numVerts);
+
+    // face->next face, face->first vertex in face
+    unsigned int *nextFaces((unsigned int*)&sh[shOffset]);
+    shOffset += numFaces;
+    unsigned int *firstFaceVertex((unsigned int*)&sh[shOffset]);
+    shOffset += numFaces;
+
+    // deg. vertex->next deg. vertex, deg.vertex->real vertex
+    unsigned int *nextVertex((unsigned int*)&sh[shOffset]);
+    shOffset += numDegenerateVerts;
+    unsigned int *realVertex((unsigned int*)&sh[shOffset]);
+    shOffset += numDegenerateVerts;
+
+    // 2*edge->first real vert, 2*edge+1->second real vert in edge
+    unsigned int *edges((unsigned int*)&sh[shOffset]);
+    shOffset += 2*numEdges;
+
+    // type->first real vertex index, type->number of vertices,
+    // type->first edge in pair, type->number of edges,
+    // type -> number of faces
+    unsigned int *firstTypeVert((unsigned int*)&sh[shOffset]);
+    shOffset += numTypes;
+    unsigned int *numTypeVerts((unsigned int*)&sh[shOffset]);
+    shOffset += numTypes;
+    unsigned int *firstEdgeInType((unsigned int*)&sh[shOffset]);
+    shOffset += numTypes;
+    unsigned int *numTypeEdges((unsigned int*)&sh[shOffset]);
+    shOffset += numTypes;
+    unsigned int *numTypeFaces((unsigned int*)&sh[shOffset]);
+    shOffset += numTypes;
+
+    for(unsigned int i(threadIdx.x); i < numVerts; i += blockDim.x)
+        vertices[i] = d_vertices[i];
+
+    for(unsigned int i(threadIdx.x); i < numFaces; i += blockDim.x)
+        {
+        nextFaces[i] = d_nextFaces[i];
+        firstFaceVertex[i] = d_firstFaceVertices[i];
+        }
+
+    for(unsigned int i(threadIdx.x); i < numDegenerateVerts; i += blockDim.x)
+        {
+        nextVertex[i] = d_nextVertices[i];
+        realVertex[i] = d_realVertices[i];
+        }
+
+    for(unsigned int i(threadIdx.x); i < 2*numEdges; i += blockDim.x)
+        edges[i] = d_edges[i];
+
+    for(unsigned int i(threadIdx.x); i < numTypes; i += blockDim.x)
+        {
+        firstTypeVert[i] = d_firstTypeVert[i];
+        numTypeVerts[i] = d_numTypeVerts[i];
+        firstEdgeInType[i] = d_firstTypeEdge[i];
+        numTypeEdges[i] = d_numTypeEdges[i];
+        numTypeFaces[i] = d_numTypeFaces[i];
+        }
+
+    // make sure the shared memory initializations above are visible
+    // for the whole block
+    __syncthreads();
+
+    // partIdx is the absolute index of the particle this group of
+    // threads is calculating for, lane is this thread's index in the group
+    const unsigned int partIdx(blockIdx.x*(blockDim.x/tpp) + threadIdx.x/tpp);
+    const unsigned int lane(threadIdx.x % tpp);
+    const bool active(partIdx < N);
+
+    // this thread's share of the force, torque, potential energy, and
+    // virial of the particle
+    vec3<Real> localForce;
+    vec3<Real> localTorque;
+    Real localEnergy(0.0f);
+    Real localVirial[6];
+    for(size_t i(0); i < 6; ++i)
+        localVirial[i] = 0.0f;
+
+    if(active)
+        {
+        const unsigned int n_neigh(d_n_neigh[partIdx]);
+        const unsigned int myHead(d_head_list[partIdx]);
+
+        // fetch position and orientation of this particle
+        const Scalar4 postype(__ldg(d_pos + partIdx));
+        const vec3<Scalar> pos_i(postype.x, postype.y, postype.z);
+        const unsigned int type_i(__scalar_as_int(postype.w));
+        const Scalar4 quati(__ldg(d_quat + partIdx));
+        const quat<Real> quat_i(quati.x, vec3<Real>(quati.y, quati.z, quati.w));
+
+        Scalar di(0.0f);
+        if (Evaluator::needsDiameter())
+            di = __ldg(d_diam + partIdx);
+
+        vec3<Scalar> vi;
+        if (Evaluator::needsVelocity())
+            vi = vec3<Scalar>(__ldg(d_velocity + partIdx));
+
+        const unsigned int nVerts_i(numTypeVerts[type_i]);
+        const unsigned int nEdges_i(numTypeEdges[type_i]);
+        const unsigned int nFaces_i(numTypeFaces[type_i]);
+
+        for(unsigned int neigh_idx(0); neigh_idx < n_neigh; ++neigh_idx)
+            {
+            const unsigned int cur_neigh(d_nlist[myHead + neigh_idx]);
+
+            // grab the position and type of the neighbor
+            const Scalar4 neigh_postype(__ldg(d_pos + cur_neigh));
+            const unsigned int type_j(__scalar_as_int(neigh_postype.w));
+            const vec3<Scalar> neigh_pos(neigh_postype.x, neigh_postype.y, neigh_postype.z);
+
+            // rij is the distance from the center of particle
+            // i to particle j
+            vec3<Scalar> rijScalar(neigh_pos - pos_i);
+            rijScalar = vec3<Scalar>(box.minImage(vec_to_scalar3(rijScalar)));
+            const vec3<Real> rij(rijScalar);
+            const Real rsq(dot(rij, rij));
+
+            if (Evaluator::needsDiameter())
+                evaluator.setDiameter(di, __ldg(d_diam + cur_neigh));
+
+            if(!evaluator.withinCutoff(rsq, r_cutsq))
+                continue;
+
+            // fetch neighbor's orientation
+            const Scalar4 neighQuatF(__ldg(d_quat + cur_neigh));
+            const quat<Real> neighQuat(
+                neighQuatF.x, vec3<Real>(neighQuatF.y, neighQuatF.z, neighQuatF.w));
+
+            if (Evaluator::needsVelocity())
+                {
+                Scalar4 vj(__ldg(d_velocity + cur_neigh));
+                evaluator.setVelocity(vi - vec3<Scalar>(vj));
+                }
+
+            // evaluator for the features of j interacting with i
+            Evaluator evaluator_ji(evaluator);
+            evaluator_ji.swapij();
+
+            const unsigned int nVerts_j(numTypeVerts[type_j]);
+            const unsigned int nEdges_j(numTypeEdges[type_j]);
+            const unsigned int nFaces_j(numTypeFaces[type_j]);
+
+            // vertices of i against the faces of j (or its edge or
+            // vertex when j is a spherocylinder or sphere), vertices
+            // of j against the faces or edge of i, and edges of i
+            // against edges of j
+            const unsigned int featuresj(nFaces_j > 0? nFaces_j: 1);
+            const unsigned int nVertexFeature_ij(nVerts_i*featuresj);
+            const unsigned int nVertexFeature_ji(nFaces_i > 0? nVerts_j*nFaces_i: (nEdges_i > 0? nVerts_j: 0));
+            const unsigned int nEdgeEdge(nEdges_i*nEdges_j);
+            const unsigned int nWork(nVertexFeature_ij + nVertexFeature_ji + nEdgeEdge);
+
+            Real potentialE(0.0f);
+            vec3<Real> forceij;
+            vec3<Real> forceji;
+            vec3<Real> torqueij;
+            vec3<Real> torqueji;
+
+            for(unsigned int work(lane); work < nWork; work += tpp)
+                {
+                if(work < nVertexFeature_ij)
+                    {
+                    const unsigned int vertIdx(work/featuresj);
+                    const unsigned int featureIdx(work - vertIdx*featuresj);
+                    const vec3<Real> r0(rotate(quat_i, vec3<Real>(vertices[firstTypeVert[type_i] + vertIdx])));
+
+                    // shape j is a polyhedron
+                    if(nFaces_j > 0)
+                        {
+                        evaluator.vertexFace(rij, r0, neighQuat,
+                            vertices, realVertex, nextVertex,
+                            firstFaceVertex[dem3d_face_index(nextFaces, type_j, featureIdx)],
+                            potentialE, forceij, torqueij, forceji, torqueji);
+                        }
+                    // shape j wasn't a polyhedron, is it a spherocylinder?
+                    else if(nEdges_j > 0)
+                        {
+                        vec3<Real> p10(vertices[edges[2*(firstEdgeInType[type_j])]]);
+                        vec3<Real> p11(vertices[edges[2*(firstEdgeInType[type_j]) + 1]]);
+                        p10 = rotate(neighQuat, p10);
+                        p11 = rotate(neighQuat, p11);
+
+                        evaluator.vertexEdge(rij, r0, p10, p11, potentialE, forceij, torqueij, forceji, torqueji);
+                        }
+                    // shape j wasn't a spherocylinder either, must be a sphere
+                    else
+                        {
+                        vec3<Real> vertex1(vertices[firstTypeVert[type_j]]);
+                        vertex1 = rotate(neighQuat, vertex1);
+
+                        evaluator.vertexVertex(rij, r0, rij + vertex1,
+                            potentialE, forceij, torqueij, forceji, torqueji);
+                        }
+                    }
+                else if(work < nVertexFeature_ij + nVertexFeature_ji)
+                    {
+                    const unsigned int workji(work - nVertexFeature_ij);
+                    const unsigned int featuresi(nFaces_i > 0? nFaces_i: 1);
+                    const unsigned int vertIdx(workji/featuresi);
+                    const unsigned int featureIdx(workji - vertIdx*featuresi);
+                    const vec3<Real> r0(rotate(neighQuat, vec3<Real>(vertices[firstTypeVert[type_j] + vertIdx])));
+
+                    // faces of i
+                    if(nFaces_i > 0)
+                        {
+                        evaluator_ji.vertexFace(-rij, r0, quat_i,
+                            vertices, realVertex, nextVertex,
+                            firstFaceVertex[dem3d_face_index(nextFaces, type_i, featureIdx)],
+                            potentialE, forceji, torqueji, forceij, torqueij);
+                        }
+                    // shape i wasn't a polyhedron, it is a spherocylinder;
+                    // spheres are accounted for above
+                    else
+                        {
+                        vec3<Real> p00(vertices[edges[2*(firstEdgeInType[type_i])]]);
+                        vec3<Real> p01(vertices[edges[2*(firstEdgeInType[type_i]) + 1]]);
+                        p00 = rotate(quat_i, p00);
+                        p01 = rotate(quat_i, p01);
+
+                        evaluator_ji.vertexEdge(-rij, r0, p00, p01, potentialE, forceji, torqueji, forceij, torqueij);
+                        }
+                    }
+                else
+                    {
+                    const unsigned int workee(work - nVertexFeature_ij - nVertexFeature_ji);
+                    const unsigned int edgei(firstEdgeInType[type_i] + workee/nEdges_j);
+                    const unsigned int edgej(firstEdgeInType[type_j] + workee % nEdges_j);
+
+                    const vec3<Real> r0(rotate(quat_i, vec3<Real>(vertices[edges[2*edgei]])));
+                    const vec3<Real> r1(rotate(quat_i, vec3<Real>(vertices[edges[2*edgei + 1]])));
+                    const vec3<Real> r2(rotate(neighQuat, vec3<Real>(vertices[edges[2*edgej]])));
+                    const vec3<Real> r3(rotate(neighQuat, vec3<Real>(vertices[edges[2*edgej + 1]])));
+                    evaluator.edgeEdge(rij, r0, r1, rij + r2, rij + r3,
+                        potentialE, forceij, torqueij, forceji, torqueji);
+                    }
+                }
+
+            localForce += forceij;
+            localTorque += torqueij;
+            localEnergy += potentialE;
+
+            localVirial[0] -= .5f*rij.x*forceij.x;
+            localVirial[1] -= .5f*rij.y*forceij.x;
+            localVirial[2] -= .5f*rij.z*forceij.x;
+            localVirial[3] -= .5f*rij.y*forceij.y;
+            localVirial[4] -= .5f*rij.z*forceij.y;
+            localVirial[5] -= .5f*rij.z*forceij.z;
+            }
+        }
+
+    // sum the contributions of the threads in the group
+    hoomd::detail::WarpReduce<Real, tpp> reducer;
+    localForce.x = reducer.Sum(localForce.x);
+    localForce.y = reducer.Sum(localForce.y);
+    localForce.z = reducer.Sum(localForce.z);
+    localEnergy = reducer.Sum(localEnergy);
+    localTorque.x = reducer.Sum(localTorque.x);
+    localTorque.y = reducer.Sum(localTorque.y);
+    localTorque.z = reducer.Sum(localTorque.z);
+    for(size_t i(0); i < 6; ++i)
+        localVirial[i] = reducer.Sum(localVirial[i]);
+
+    // finally, write the result.
+    if(active && lane == 0)
+        {
+        d_force[partIdx] = make_scalar4(localForce.x, localForce.y, localForce.z, .5f*localEnergy);
+        d_torque[partIdx] = make_scalar4(localTorque.x, localTorque.y, localTorque.z, 0.0f);
+
+        for(size_t i(0); i < 6; ++i)
+            d_virial[i*virial_pitch + partIdx] = localVirial[i];
+        }
+    }
+
+//! Launcher for gpu_compute_dem3d_forces_warp_kernel
+/*! \tparam tpp Largest number of threads per pair to consider, the kernel is launched for the one that matches
+    \a threadsPerPair
+
+    Partial function template specialization is not allowed in C++, so instead we have to wrap this with a struct
+    that we are allowed to partially specialize.
+*/
+template<typename Real, typename Real4, typename Evaluator, int tpp>
+struct DEM3DForceWarpKernel
+    {
+    static void launch(const unsigned int threadsPerPair, const unsigned int particlesPerBlock,
+        Scalar4* d_force, Scalar4* d_torque, Scalar* d_virial,
+        const size_t virial_pitch, const unsigned int N,
+        const Scalar4 *d_pos, const Scalar4 *d_quat, const unsigned int *d_nextFaces,
+        const unsigned int *d_firstFaceVertices, const unsigned int *d_nextVertices,
+        const unsigned int *d_realVertices, const Real4 *d_vertices,
+        const Scalar *d_diam, const Scalar4 *d_velocity,
+        const unsigned int numFaces, const unsigned int numDegenerateVerts,
+        const unsigned int numVerts, const unsigned int numEdges,
+        const unsigned int numTypes, const BoxDim& box, const unsigned int *d_n_neigh,
+        const unsigned int *d_nlist, const unsigned int *d_head_list, const Evaluator evaluator,
+        const Real r_cutsq,
+        const unsigned int *d_firstTypeVert, const unsigned int *d_numTypeVerts,
+        const unsigned int *d_firstTypeEdge, const unsigned int *d_numTypeEdges,
+        const unsigned int *d_numTypeFaces, const unsigned int *d_edges)
+        {
+        if(threadsPerPair == tpp)
+            {
+            hipFuncAttributes attr;
+            hipFuncGetAttributes(&attr,
+                reinterpret_cast<const void*>(gpu_compute_dem3d_forces_warp_kernel<Real, Real4, Evaluator, tpp>));
+            const unsigned int pairsPerBlock(max(1u, min(particlesPerBlock, (unsigned int)attr.maxThreadsPerBlock/tpp)));
+
+            dim3 grid(N/pairsPerBlock + 1, 1, 1);
+            dim3 threads(pairsPerBlock*tpp, 1, 1);
+
+            const size_t shmSize(numVerts*sizeof(Real4) + // real vertex->point
+                2*numFaces*sizeof(unsigned int) + // face->next face, face->first vertex in face
+                2*numDegenerateVerts*sizeof(unsigned int) + // vertex->next vertex, vertex->real vertex
+                2*numEdges*sizeof(unsigned int) + 5*numTypes*sizeof(unsigned int)); // edge->real index, per-type counts
+
+            hipLaunchKernelGGL((gpu_compute_dem3d_forces_warp_kernel<Real, Real4, Evaluator, tpp>),
+                dim3(grid), dim3(threads), shmSize, 0, d_pos, d_quat, d_force, d_torque, d_virial, virial_pitch, N,
+                d_nextFaces, d_firstFaceVertices, d_nextVertices,
+                d_realVertices, d_vertices, d_diam, d_velocity,
+                numFaces, numDegenerateVerts, numVerts,
+                numEdges, numTypes, box, d_n_neigh, d_nlist, d_head_list, evaluator,
+                r_cutsq, d_firstTypeVert, d_numTypeVerts, d_firstTypeEdge,
+                d_numTypeEdges, d_numTypeFaces, d_edges);
+            }
+        else
+            {
+            DEM3DForceWarpKernel<Real, Real4, Evaluator, tpp/2>::launch(threadsPerPair, particlesPerBlock,
+                d_force, d_torque, d_virial, virial_pitch, N,
+                d_pos, d_quat, d_nextFaces, d_firstFaceVertices, d_nextVertices,
+                d_realVertices, d_vertices, d_diam, d_velocity,
+                numFaces, numDegenerateVerts, numVerts, numEdges, numTypes, box,
+                d_n_neigh, d_nlist, d_head_list, evaluator, r_cutsq,
+                d_firstTypeVert, d_numTypeVerts, d_firstTypeEdge, d_numTypeEdges,
+                d_numTypeFaces, d_edges);
+            }
+        }
+    };
+
+//! Template specialization to do nothing for the tpp = 0 case
+template<typename Real, typename Real4, typename Evaluator>
+struct DEM3DForceWarpKernel<Real, Real4, Evaluator, 0>
+    {
+    static void launch(const unsigned int threadsPerPair, const unsigned int particlesPerBlock,
+        Scalar4* d_force, Scalar4* d_torque, Scalar* d_virial,
+        const size_t virial_pitch, const unsigned int N,
+        const Scalar4 *d_pos, const Scalar4 *d_quat, const unsigned int *d_nextFaces,
+        const unsigned int *d_firstFaceVertices, const unsigned int *d_nextVertices,
+        const unsigned int *d_realVertices, const Real4 *d_vertices,
+        const Scalar *d_diam, const Scalar4 *d_velocity,
+        const unsigned int numFaces, const unsigned int numDegenerateVerts,
+        const unsigned int numVerts, const unsigned int numEdges,
+        const unsigned int numTypes, const BoxDim& box, const unsigned int *d_n_neigh,
+        const unsigned int *d_nlist, const unsigned int *d_head_list, const Evaluator evaluator,
+        const Real r_cutsq,
+        const unsigned int *d_firstTypeVert, const unsigned int *d_numTypeVerts,
+        const unsigned int *d_firstTypeEdge, const unsigned int *d_numTypeEdges,
+        const unsigned int *d_numTypeFaces, const unsigned int *d_edges)
+        {
+        // do nothing
+        }
+    };
+
 /*! \param d_force Device memory to write computed forces
   \param d_torque Device memory to write computed torques
   \param d_virial Device memory to write computed virials
@@ -473,11 +881,14 @@ __global__ void gpu_compute_dem3d_forces_kernel(
   \param r_cutsq Precomputed r_cut*r_cut, where r_cut is the radius beyond which the
   force is set to 0
   \param particlesPerBlock Block size to execute
+  \param threadsPerPair Number of threads that evaluate each pair in gpu_compute_dem3d_forces_warp_kernel, or 0
+  to launch gpu_compute_dem3d_forces_kernel with one thread per feature of each particle
   \param maxVerts Maximum number of vertices in any shape
 
   \returns Any error code resulting from the kernel launch
 
-  This is just a driver for gpu_compute_dem3d_forces_kernel, see the documentation for it for more information.
+  This is just a driver for gpu_compute_dem3d_forces_kernel and gpu_compute_dem3d_forces_warp_kernel, see the
+  documentation for them for more information.
 */
 template<typename Real, typename Real4, typename Evaluator>
 hipError_t gpu_compute_dem3d_forces(
@@ -492,12 +903,24 @@ hipError_t gpu_compute_dem3d_forces(
     const unsigned int numVerts, const unsigned int numEdges,
     const unsigned int numTypes, const BoxDim& box, const unsigned int *d_n_neigh,
     const unsigned int *d_nlist, const unsigned int *d_head_list, const Evaluator evaluator,
-    const Real r_cutsq, const unsigned int particlesPerBlock,
+    const Real r_cutsq, const unsigned int particlesPerBlock, const unsigned int threadsPerPair,
     const unsigned int *d_firstTypeVert, const unsigned int *d_numTypeVerts,
     const unsigned int *d_firstTypeEdge, const unsigned int *d_numTypeEdges,
     const unsigned int *d_numTypeFaces, const unsigned int *d_vertexConnectivity,
     const unsigned int *d_edges)
     {
+    if(threadsPerPair > 0)
+        {
+        DEM3DForceWarpKernel<Real, Real4, Evaluator, gpu_dem3d_max_tpp>::launch(threadsPerPair, particlesPerBlock,
+            d_force, d_torque, d_virial, virial_pitch, N,
+            d_pos, d_quat, d_nextFaces, d_firstFaceVertices, d_nextVertices,
+            d_realVertices, d_vertices, d_diam, d_velocity,
+            numFaces, numDegenerateVerts, numVerts, numEdges, numTypes, box,
+            d_n_neigh, d_nlist, d_head_list, evaluator, r_cutsq,
+            d_firstTypeVert, d_numTypeVerts, d_firstTypeEdge, d_numTypeEdges,
+            d_numTypeFaces, d_edges);
+        return hipSuccess;
+        }
 
     // setup the grid to run the kernel
     dim3 grid((int)ceil((double)N / (double)particlesPerBlock), 1, 1);
@@ -18,6 +18,13 @@
 #ifdef ENABLE_HIP
 #include <hip/hip_runtime.h>
 
+//! Maximum number of threads that evaluate one particle pair (width of a warp)
+#if defined(__HIP_PLATFORM_NVCC__)
+const int gpu_dem3d_max_tpp = 32;
+#elif defined(__HIP_PLATFORM_HCC__)
+const int gpu_dem3d_max_tpp = 64;
+#endif
+
 //! Kernel driver that computes 3D DEM forces on the GPU for DEM3DForceComputeGPU
 template<typename Real,  typename Real4, typename Evaluator>
 hipError_t gpu_compute_dem3d_forces(
@@ -50,6 +57,7 @@ hipError_t gpu_compute_dem3d_forces(
     const Evaluator evaluator,
     const Real r_cutsq,
     const unsigned int particlesPerBlock,
+    const unsigned int threadsPerPair,
     const unsigned int *d_firstTypeVert,
     const unsigned int *d_numTypeVerts,
     const unsigned int *d_firstTypeEdge,
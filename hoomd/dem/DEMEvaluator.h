@@ -43,6 +43,9 @@ class DEMEvaluator
 
         Real getRadius() const {return m_potential.getRadius();}
 
+        //! Largest distance between two points that interact
+        DEVICE inline Real getInteractionRange() const {return m_potential.getInteractionRange();}
+
         /*! Evaluate the force and torque contributions for particles i
           and j, with centers of mass separated by rij. The appropriate
           forces and torques for particles i and j will be added to
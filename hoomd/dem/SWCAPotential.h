@@ -70,6 +70,9 @@ class SWCAPotential
             return rmd*rmd < r_cut_sq;
             }
 
+        /*! Largest distance between two points that interact, given the current diameters */
+        DEVICE inline Real getInteractionRange() const {return sqrt(m_rcutsq) + m_delta;}
+
         //! Test if potential needs the diameter
         DEVICE static bool needsDiameter() {return true;}
         DEVICE void setDiameter(Real di, Real dj) {m_delta = 0.5*(di+dj) - 1;}
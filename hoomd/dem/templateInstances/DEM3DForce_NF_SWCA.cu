@@ -25,7 +25,8 @@ template hipError_t gpu_compute_dem3d_forces<Scalar, Scalar4, SWCADEM>(
         const BoxDim& box,
         const unsigned int *d_n_neigh, const unsigned int *d_nlist,
         const unsigned int *d_head_list, const SWCADEM evaluator, const Scalar r_cutsq,
-        const unsigned int particlesPerBlock, const unsigned int *d_firstTypeVert,
+        const unsigned int particlesPerBlock, const unsigned int threadsPerPair,
+        const unsigned int *d_firstTypeVert,
         const unsigned int *d_numTypeVerts, const unsigned int *d_firstTypeEdge,
         const unsigned int *d_numTypeEdges, const unsigned int *d_numTypeFaces,
         const unsigned int *d_vertexConnectivity, const unsigned int *d_edges);
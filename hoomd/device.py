@@ -116,6 +116,37 @@ class Device:
         else:
             self._cpp_exec_conf.setNumThreads(int(num_cpu_threads))
 
+    @property
+    def huge_pages(self):
+        """bool: Back large host arrays with transparent huge pages.
+
+        When `True` (the default), host memory allocations of 2 MB or more
+        are aligned to the huge page size and advised to use transparent huge
+        pages, which reduces TLB misses when accessing large particle arrays.
+        Set `huge_pages` before creating the simulation state.
+        """
+        return self._cpp_exec_conf.getHostHugePages()
+
+    @huge_pages.setter
+    def huge_pages(self, value):
+        self._cpp_exec_conf.setHostHugePages(bool(value))
+
+    @property
+    def numa_binding(self):
+        """bool: Bind host arrays to the NUMA nodes of this rank's CPUs.
+
+        When `True` (the default) and the CPU affinity mask of the MPI rank
+        covers only some of the NUMA nodes of the machine, host memory is
+        allocated on those nodes. Bind the ranks to cores with the MPI launcher
+        for this to take effect. Set `numa_binding` before creating the
+        simulation state.
+        """
+        return self._cpp_exec_conf.getHostNUMABinding()
+
+    @numa_binding.setter
+    def numa_binding(self, value):
+        self._cpp_exec_conf.setHostNUMABinding(bool(value))
+
 
 def _create_messenger(mpi_config, notice_level, msg_file, shared_msg_file):
     msg = _hoomd.Messenger(mpi_config)
@@ -253,6 +284,27 @@ class GPU(Device):
     def gpu_error_checking(self, new_bool):
         self._cpp_exec_conf.setCUDAErrorChecking(new_bool)
 
+    @property
+    def autotuner_cache(self):
+        """str: File that stores optimal autotuner parameters between runs.
+
+        When set, kernel autotuners start from the parameters found by previous
+        runs on the same device model with the same HOOMD version and a similar
+        number of particles, and skip their initial parameter scan. Autotuners
+        scan again when the cached parameter is slower than it was. Set to
+        `None` (the default) to disable the cache.
+
+        Set `autotuner_cache` before creating the simulation state.
+        """
+        filename = self._cpp_exec_conf.getAutotunerCacheFile()
+        return filename if filename else None
+
+    @autotuner_cache.setter
+    def autotuner_cache(self, filename):
+        if filename is None:
+            filename = ""
+        self._cpp_exec_conf.setAutotunerCacheFile(str(filename))
+
     @staticmethod
     def is_available():
         """Test if the GPU device is available.
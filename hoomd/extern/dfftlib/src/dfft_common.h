@@ -69,6 +69,8 @@ typedef struct
     int device;           /* ==1 if this is a device plan */
     #ifdef ENABLE_HIP
     int check_cuda_errors; /* == 1 if we are checking errors */
+    int cuda_aware_mpi;    /* == 1 if device buffers are passed to MPI directly */
+    MPI_Request *reqs;     /* Requests for the point-to-point exchanges (2 per rank) */
     #endif
 
     int row_m;            /* ==1 If we are using row-major procesor id mapping */
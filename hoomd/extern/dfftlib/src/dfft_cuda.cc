@@ -52,6 +52,89 @@
  * Implementation of the distributed FFT
  *****************************************************************************/
 
+/*
+ * Exchange the packed segments of a redistribution between all ranks
+ *
+ * The receives are posted first, and there is one message per peer instead of
+ * a collective. With CUDA-aware MPI, the device buffers are passed to MPI
+ * directly. Otherwise, every segment is staged through the pinned host buffers
+ * separately, so that the copy of a segment overlaps with the messages of the
+ * segments before it, and each received segment is copied back as soon as it
+ * arrives. The segment a rank keeps never leaves the device.
+ */
+void dfft_cuda_exchange(dfft_plan *plan, cuda_cpx_t *d_send, cuda_cpx_t *d_recv)
+    {
+    int nump, rank;
+    MPI_Comm_size(plan->comm, &nump);
+    MPI_Comm_rank(plan->comm, &rank);
+
+    /* the packed data must be complete before it is handed to MPI, and the
+     * previous exchange must have finished reading the staging buffers */
+    hipDeviceSynchronize();
+    if (plan->check_cuda_errors) CHECK_CUDA();
+
+    char *send_buf = plan->cuda_aware_mpi ? (char *)d_send : (char *)plan->h_stage_in;
+    char *recv_buf = plan->cuda_aware_mpi ? (char *)d_recv : (char *)plan->h_stage_out;
+    MPI_Request *recv_reqs = plan->reqs;
+    MPI_Request *send_reqs = plan->reqs + nump;
+
+    int i;
+    for (i = 0; i < nump; ++i)
+        {
+        recv_reqs[i] = MPI_REQUEST_NULL;
+        if (i != rank && plan->nrecv[i])
+            MPI_Irecv(recv_buf + plan->offset_recv[i], plan->nrecv[i], MPI_BYTE, i, 0,
+                plan->comm, &recv_reqs[i]);
+        }
+
+    for (i = 0; i < nump; ++i)
+        {
+        send_reqs[i] = MPI_REQUEST_NULL;
+        if (i == rank || !plan->nsend[i])
+            continue;
+
+        if (!plan->cuda_aware_mpi)
+            {
+            /* stage this segment into the host buffer */
+            hipMemcpy(send_buf + plan->offset_send[i], (char *)d_send + plan->offset_send[i],
+                plan->nsend[i], hipMemcpyDefault);
+            if (plan->check_cuda_errors) CHECK_CUDA();
+            }
+
+        MPI_Isend(send_buf + plan->offset_send[i], plan->nsend[i], MPI_BYTE, i, 0,
+            plan->comm, &send_reqs[i]);
+        }
+
+    /* the local segment */
+    if (plan->nsend[rank])
+        {
+        hipMemcpyAsync((char *)d_recv + plan->offset_recv[rank], (char *)d_send + plan->offset_send[rank],
+            plan->nsend[rank], hipMemcpyDefault, 0);
+        if (plan->check_cuda_errors) CHECK_CUDA();
+        }
+
+    if (plan->cuda_aware_mpi)
+        {
+        MPI_Waitall(nump, recv_reqs, MPI_STATUSES_IGNORE);
+        }
+    else
+        {
+        /* copy back the received segments in the order of their arrival */
+        for (;;)
+            {
+            MPI_Waitany(nump, recv_reqs, &i, MPI_STATUS_IGNORE);
+            if (i == MPI_UNDEFINED)
+                break;
+
+            hipMemcpyAsync((char *)d_recv + plan->offset_recv[i], recv_buf + plan->offset_recv[i],
+                plan->nrecv[i], hipMemcpyDefault, 0);
+            if (plan->check_cuda_errors) CHECK_CUDA();
+            }
+        }
+
+    MPI_Waitall(nump, send_reqs, MPI_STATUSES_IGNORE);
+    }
+
 /*
  * n-dimensional redistribute from group-cyclic with cycle c0 to cycle c1
  * 1 <=c0,c1 <= pdim[i]
@@ -271,27 +354,8 @@ void dfft_cuda_redistribute_nd( dfft_plan *plan,int stage, int size_in, int *emb
         if (plan->check_cuda_errors) CHECK_CUDA();
         }
 
-    /* synchronize */
-    MPI_Barrier(plan->comm);
-
     /* communicate */
-    #ifdef ENABLE_MPI_CUDA
-    MPI_Alltoallv(plan->d_scratch,plan->nsend, plan->offset_send, MPI_BYTE,
-                  plan->d_scratch_2, plan->nrecv, plan->offset_recv, MPI_BYTE,
-                  plan->comm);
-    #else
-    // stage into host buf
-    hipMemcpy(plan->h_stage_in, plan->d_scratch, sizeof(cuda_cpx_t)*size_in,hipMemcpyDefault);
-    if (plan->check_cuda_errors) CHECK_CUDA();
-
-    MPI_Alltoallv(plan->h_stage_in,plan->nsend, plan->offset_send, MPI_BYTE,
-                  plan->h_stage_out,plan->nrecv, plan->offset_recv, MPI_BYTE,
-                  plan->comm);
-
-    // copy back received data
-    hipMemcpy(plan->d_scratch_2,plan->h_stage_out, sizeof(cuda_cpx_t)*size_in,hipMemcpyDefault);
-    if (plan->check_cuda_errors) CHECK_CUDA();
-    #endif
+    dfft_cuda_exchange(plan, plan->d_scratch, plan->d_scratch_2);
 
     /* unpack data */
     if (dir)
@@ -1123,8 +1187,17 @@ int dfft_cuda_create_plan(dfft_plan *p,
     int res = dfft_create_plan_common(p, ndim, gdim, inembed, oembed,
         pdim, pidx, row_m, input_cyclic, output_cyclic, comm, proc_map, 1);
 
-    #ifndef ENABLE_MPI_CUDA
-    /* allocate staging bufs */
+    #ifdef ENABLE_MPI_CUDA
+    p->cuda_aware_mpi = 1;
+    #else
+    p->cuda_aware_mpi = 0;
+    #endif
+
+    int nump;
+    MPI_Comm_size(comm, &nump);
+    p->reqs = (MPI_Request *)malloc(sizeof(MPI_Request)*2*nump);
+
+    /* allocate staging bufs, also with CUDA-aware MPI because staging may be enabled at run time */
     /* we need to use posix_memalign/hipHostRegister instead
      * of hipHostMalloc, because hipHostMalloc doesn't have hooks
      * in the MPI library, and using it would lead to data corruption
@@ -1144,7 +1217,6 @@ int dfft_cuda_create_plan(dfft_plan *p,
     CHECK_CUDA();
     hipHostRegister(p->h_stage_out, size, hipHostMallocDefault);
     CHECK_CUDA();
-    #endif
 
     /* allocate memory for passing variables */
    hipMalloc((void **)&(p->d_pidx), sizeof(int)*ndim);
@@ -1222,12 +1294,11 @@ void dfft_cuda_destroy_plan(dfft_plan plan)
     {
     dfft_destroy_plan_common(plan, 1);
 
-    #ifndef ENABLE_MPI_CUDA
     hipHostUnregister(plan.h_stage_in);
     hipHostUnregister(plan.h_stage_out);
     free(plan.h_stage_in);
     free(plan.h_stage_out);
-    #endif
+    free(plan.reqs);
 
     int dmax = plan.max_depth + 2;
     int d;
@@ -1266,3 +1337,8 @@ void dfft_cuda_check_errors(dfft_plan *plan, int check_err)
     {
     plan->check_cuda_errors = check_err;
     }
+
+void dfft_cuda_set_cuda_aware_mpi(dfft_plan *plan, int cuda_aware_mpi)
+    {
+    plan->cuda_aware_mpi = cuda_aware_mpi;
+    }
@@ -40,6 +40,11 @@ EXTERN_DFFT void dfft_cuda_destroy_plan(dfft_plan plan);
  */
 EXTERN_DFFT void dfft_cuda_check_errors(dfft_plan *plan, int check_err);
 
+/*
+ * Set whether device buffers are passed to MPI directly (requires CUDA-aware MPI)
+ */
+EXTERN_DFFT void dfft_cuda_set_cuda_aware_mpi(dfft_plan *plan, int cuda_aware_mpi);
+
 /*
  * Execute the parallel FFT on the device
  */
@@ -148,13 +148,13 @@ class AnalyzerSDF : public Analyzer
         void openOutputFile();
 
         //! Write current histogram to the file
-        void writeOutput(uint64_t timestep);
+        virtual void writeOutput(uint64_t timestep);
 
         //! Zero the histogram counts
-        void zeroHistogram();
+        virtual void zeroHistogram();
 
         //! Add to histogram counts
-        void countHistogram(uint64_t timestep);
+        virtual void countHistogram(uint64_t timestep);
 
         //! Determine the s bin of a given particle pair
         size_t computeBin(const vec3<Scalar>& r_ij,
@@ -193,7 +193,7 @@ AnalyzerSDF<Shape>::AnalyzerSDF(std::shared_ptr<SystemDefinition> sysdef,
 
     Scalar max_diam = m_mc->getMaxCoreDiameter();
     m_last_max_diam = max_diam;
-    Scalar extra = lmax * max_diam;
+    Scalar extra = lmax / (1 - lmax) * max_diam;
     m_mc->setExtraGhostWidth(extra);
     }
 
@@ -211,7 +211,7 @@ void AnalyzerSDF<Shape>::analyze(uint64_t timestep)
     if (max_diam != m_last_max_diam)
         {
         m_last_max_diam = max_diam;
-        Scalar extra = m_lmax * max_diam;
+        Scalar extra = m_lmax / (1 - m_lmax) * max_diam;
         m_mc->setExtraGhostWidth(extra);
 
         // this forces an extra communication of ghosts, but only when the maximum diameter changes
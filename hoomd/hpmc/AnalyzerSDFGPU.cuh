@@ -0,0 +1,350 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _ANALYZER_SDF_GPU_CUH_
+#define _ANALYZER_SDF_GPU_CUH_
+
+#include "hip/hip_runtime.h"
+#include "HPMCPrecisionSetup.h"
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/Index1D.h"
+
+#include "ComputeFreeVolumeGPU.cuh"
+
+/*! \file AnalyzerSDFGPU.cuh
+    \brief Declaration of CUDA kernels drivers for AnalyzerSDFGPU
+*/
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Wraps arguments to gpu_hpmc_sdf
+/*! \ingroup hpmc_data_structs */
+struct hpmc_sdf_args_t
+    {
+    //! Construct a hpmc_sdf_args_t
+    hpmc_sdf_args_t(
+                unsigned int _N,
+                const Scalar4 *_d_postype,
+                const Scalar4 *_d_orientation,
+                const Index3D& _ci,
+                const unsigned int *_d_excell_idx,
+                const unsigned int *_d_excell_size,
+                const Index2D& _excli,
+                const uint3& _cell_dim,
+                const Scalar3 _ghost_width,
+                const unsigned int _num_types,
+                const BoxDim& _box,
+                const unsigned int _n_bins,
+                const Scalar _dl,
+                const unsigned int _block_size,
+                const unsigned int _stride,
+                const unsigned int _group_size,
+                unsigned int *_d_hist,
+                const hipDeviceProp_t& _devprop
+                )
+                : N(_N),
+                  d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  ci(_ci),
+                  d_excell_idx(_d_excell_idx),
+                  d_excell_size(_d_excell_size),
+                  excli(_excli),
+                  cell_dim(_cell_dim),
+                  ghost_width(_ghost_width),
+                  num_types(_num_types),
+                  box(_box),
+                  n_bins(_n_bins),
+                  dl(_dl),
+                  block_size(_block_size),
+                  stride(_stride),
+                  group_size(_group_size),
+                  d_hist(_d_hist),
+                  devprop(_devprop)
+        {
+        };
+
+    unsigned int N;                         //!< Number of local particles
+    const Scalar4 *d_postype;               //!< postype array
+    const Scalar4 *d_orientation;           //!< orientation array
+    const Index3D& ci;                      //!< Cell indexer
+    const unsigned int *d_excell_idx;       //!< Expanded cell neighbors
+    const unsigned int *d_excell_size;      //!< Size of expanded cell list per cell
+    const Index2D excli;                    //!< Expanded cell indexer
+    const uint3& cell_dim;                  //!< Cell dimensions
+    const Scalar3 ghost_width;              //!< Width of ghost layer
+    const unsigned int num_types;           //!< Number of particle types
+    const BoxDim& box;                      //!< Current simulation box
+    unsigned int n_bins;                    //!< Number of histogram bins
+    Scalar dl;                              //!< Histogram bin width
+    unsigned int block_size;                //!< Block size to execute
+    unsigned int stride;                    //!< Number of threads per overlap check
+    unsigned int group_size;                //!< Size of the group to execute
+    unsigned int *d_hist;                   //!< Histogram (accumulated, initialized by the caller)
+    const hipDeviceProp_t& devprop;         //!< CUDA device properties
+    };
+
+template< class Shape >
+hipError_t gpu_hpmc_sdf(const hpmc_sdf_args_t &args, const typename Shape::param_type *d_params);
+
+#ifdef __HIPCC__
+
+//! Test the overlap of two particles with their separation scaled by (1 - lambda)
+template< class Shape >
+__device__ inline bool sdf_test_scaled_overlap(const vec3<Scalar>& r_ij,
+                                               const Shape& shape_i,
+                                               const Shape& shape_j,
+                                               Scalar lambda)
+    {
+    unsigned int err_count = 0;
+    vec3<Scalar> r_ij_scaled = r_ij * (Scalar(1.0) - lambda);
+    return check_circumsphere_overlap(r_ij_scaled, shape_i, shape_j)
+        && test_overlap(r_ij_scaled, shape_i, shape_j, err_count);
+    }
+
+//! Kernel to add the smallest scale factor of each particle to the SDF histogram
+/*! One group of threads handles one local particle. The threads of the group bisect the bins of the particle's pairs
+    in parallel, and the smallest bin of the group is kept with an atomicMin in shared memory. A pair only needs to be
+    bisected when it overlaps at the right edge of the current smallest bin, so the search narrows as the group
+    proceeds. Pairs that already overlap at lambda = 0 are ignored, as in AnalyzerSDF::computeBin().
+
+    \param N Number of local particles
+    \param d_postype Particle positions and types by index
+    \param d_orientation Particle orientation
+    \param ci Cell indexer
+    \param d_excell_idx Expanded cell neighbors
+    \param d_excell_size Size of the expanded cells
+    \param excli Expanded cell indexer
+    \param cell_dim Dimensions of the cell list
+    \param ghost_width Width of ghost layer
+    \param num_types Number of particle types
+    \param box Simulation box
+    \param n_bins Number of histogram bins
+    \param dl Histogram bin width
+    \param d_hist Histogram (output value)
+    \param d_params Per-type shape parameters
+    \param max_extra_bytes Shared memory available for the shape parameters
+*/
+template< class Shape >
+__global__ void gpu_hpmc_sdf_kernel(unsigned int N,
+                                    const Scalar4 *d_postype,
+                                    const Scalar4 *d_orientation,
+                                    const Index3D ci,
+                                    const unsigned int *d_excell_idx,
+                                    const unsigned int *d_excell_size,
+                                    const Index2D excli,
+                                    const uint3 cell_dim,
+                                    const Scalar3 ghost_width,
+                                    const unsigned int num_types,
+                                    const BoxDim box,
+                                    const unsigned int n_bins,
+                                    const Scalar dl,
+                                    unsigned int *d_hist,
+                                    const typename Shape::param_type *d_params,
+                                    unsigned int max_extra_bytes)
+    {
+    unsigned int group = threadIdx.z;
+    unsigned int offset = threadIdx.y;
+    unsigned int group_size = blockDim.y;
+    bool master = (offset == 0 && threadIdx.x == 0);
+    unsigned int n_groups = blockDim.z;
+
+    // determine particle idx
+    unsigned int i = blockIdx.x * n_groups + group;
+
+    // load the per type parameters into shared memory
+    HIP_DYNAMIC_SHARED( char, s_data)
+    typename Shape::param_type *s_params = (typename Shape::param_type *)(&s_data[0]);
+    unsigned int *s_min_bin = (unsigned int *) (s_params + num_types);
+
+    // copy over parameters one int per thread for fast loads
+        {
+        unsigned int tidx = threadIdx.x+blockDim.x*threadIdx.y + blockDim.x*blockDim.y*threadIdx.z;
+        unsigned int block_size = blockDim.x*blockDim.y*blockDim.z;
+        unsigned int param_size = num_types*sizeof(typename Shape::param_type) / sizeof(int);
+
+        for (unsigned int cur_offset = 0; cur_offset < param_size; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < param_size)
+                {
+                ((int *)s_params)[cur_offset + tidx] = ((int *)d_params)[cur_offset + tidx];
+                }
+            }
+        }
+
+    __syncthreads();
+
+    // initialize extra shared mem
+    char *s_extra = (char *)(s_min_bin + n_groups);
+
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int cur_type = 0; cur_type < num_types; ++cur_type)
+        s_params[cur_type].load_shared(s_extra, available_bytes);
+
+    if (master)
+        s_min_bin[group] = n_bins;
+
+    __syncthreads();
+
+    bool active = i < N;
+
+    if (active)
+        {
+        Scalar4 postype_i = d_postype[i];
+        vec3<Scalar> pos_i(postype_i);
+        unsigned int typ_i = __scalar_as_int(postype_i.w);
+        Shape shape_i(quat<Scalar>(), s_params[typ_i]);
+        if (shape_i.hasOrientation())
+            shape_i.orientation = quat<Scalar>(d_orientation[i]);
+
+        // find the cell of the particle
+        unsigned int my_cell = compute_cell_idx(vec_to_scalar3(pos_i), box, ghost_width, cell_dim, ci);
+
+        // pairs further apart than this do not touch at the largest scale factor
+        const OverlapReal scale_max = OverlapReal(1.0) - OverlapReal(n_bins*dl);
+
+        // loop over neighboring cells
+        unsigned int excell_size = d_excell_size[my_cell];
+
+        for (unsigned int k = 0; k < excell_size; k += group_size)
+            {
+            unsigned int local_k = k + offset;
+            if (local_k < excell_size)
+                {
+                // read in position, and orientation of neighboring particle
+                unsigned int j = __ldg(&d_excell_idx[excli(local_k, my_cell)]);
+                if (j == i)
+                    continue;
+
+                Scalar4 postype_j = __ldg(d_postype + j);
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(), s_params[typ_j]);
+                if (shape_j.hasOrientation())
+                    shape_j.orientation = quat<Scalar>(__ldg(d_orientation + j));
+
+                // put particle j into the coordinate system of particle i
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i;
+                r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
+
+                OverlapReal rsq = dot(r_ij,r_ij);
+                OverlapReal DaDb = shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+                if (rsq*scale_max*scale_max*OverlapReal(4.0) > DaDb * DaDb)
+                    continue;
+
+                // this pair can only lower the minimum if it touches within the current smallest bin
+                unsigned int L = 0;
+                unsigned int R = *((volatile unsigned int *)&s_min_bin[group]);
+                if (R == 0 || !sdf_test_scaled_overlap(r_ij, shape_i, shape_j, Scalar(R)*dl))
+                    continue;
+
+                // the particles already overlap at the left boundary
+                if (sdf_test_scaled_overlap(r_ij, shape_i, shape_j, Scalar(0.0)))
+                    continue;
+
+                // progressively narrow the search window by halves
+                while ((R-L) > 1)
+                    {
+                    unsigned int m = (L+R)/2;
+
+                    if (sdf_test_scaled_overlap(r_ij, shape_i, shape_j, Scalar(m)*dl))
+                        R = m;
+                    else
+                        L = m;
+                    }
+
+                atomicMin(&s_min_bin[group], L);
+                }
+            }
+        }
+
+    __syncthreads();
+
+    // record the minimum bin
+    if (master && active && s_min_bin[group] < n_bins)
+        atomicAdd(&d_hist[s_min_bin[group]], 1);
+    }
+
+//! Kernel driver for gpu_hpmc_sdf_kernel()
+/*! \param args Bundled arguments
+    \param d_params Per-type shape parameters
+    \returns Error codes generated by any CUDA calls, or hipSuccess when there is no error
+
+    This templatized method is the kernel driver for the SDF histogram of any shape. It is instantiated for every shape
+    in kernel_sdf.cu.in.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+hipError_t gpu_hpmc_sdf(const hpmc_sdf_args_t& args, const typename Shape::param_type *d_params)
+    {
+    assert(args.d_postype);
+    assert(args.d_orientation);
+    assert(args.d_hist);
+    assert(args.group_size >= 1);
+    assert(args.group_size <= (unsigned int)args.devprop.warpSize);
+    assert(args.block_size%(args.stride*args.group_size)==0);
+
+    // determine the maximum block size and clamp the input block size down
+    static int max_block_size = -1;
+    static hipFuncAttributes attr;
+    if (max_block_size == -1)
+        {
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(gpu_hpmc_sdf_kernel<Shape>));
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    // setup the grid to run the kernel
+    unsigned int n_groups = min(args.block_size, (unsigned int)max_block_size) / args.group_size / args.stride;
+
+    dim3 threads(args.stride, args.group_size, n_groups);
+    dim3 grid( args.N / n_groups + 1, 1, 1);
+
+    unsigned int shared_bytes = (unsigned int)(args.num_types * sizeof(typename Shape::param_type)
+        + n_groups*sizeof(unsigned int));
+
+    unsigned int max_extra_bytes = static_cast<unsigned int>(args.devprop.sharedMemPerBlock - attr.sharedSizeBytes - shared_bytes);
+
+    // determine dynamically requested shared memory
+    char *ptr = (char *)nullptr;
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int i = 0; i < args.num_types; ++i)
+        {
+        d_params[i].allocate_shared(ptr, available_bytes);
+        }
+    unsigned int extra_bytes = max_extra_bytes - available_bytes;
+
+    shared_bytes += extra_bytes;
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_hpmc_sdf_kernel<Shape>), dim3(grid), dim3(threads), shared_bytes, 0,
+                                                     args.N,
+                                                     args.d_postype,
+                                                     args.d_orientation,
+                                                     args.ci,
+                                                     args.d_excell_idx,
+                                                     args.d_excell_size,
+                                                     args.excli,
+                                                     args.cell_dim,
+                                                     args.ghost_width,
+                                                     args.num_types,
+                                                     args.box,
+                                                     args.n_bins,
+                                                     args.dl,
+                                                     args.d_hist,
+                                                     d_params,
+                                                     max_extra_bytes);
+
+    return hipSuccess;
+    }
+
+#endif // __HIPCC__
+
+}; // end namespace detail
+
+} // end namespace hpmc
+
+#endif // _ANALYZER_SDF_GPU_CUH_
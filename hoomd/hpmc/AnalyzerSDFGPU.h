@@ -0,0 +1,322 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _ANALYZER_SDF_GPU_H_
+#define _ANALYZER_SDF_GPU_H_
+
+#ifdef ENABLE_HIP
+
+#include "hoomd/CellList.h"
+#include "hoomd/Autotuner.h"
+
+#include "AnalyzerSDF.h"
+#include "AnalyzerSDFGPU.cuh"
+#include "IntegratorHPMCMonoGPU.h"
+#include "IntegratorHPMCMonoGPUTypes.cuh"
+
+/*! \file AnalyzerSDFGPU.h
+    \brief Declaration of AnalyzerSDFGPU
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! SDF analysis on the GPU
+/*! AnalyzerSDFGPU counts the histogram of AnalyzerSDF on the GPU. It reads the pairs from the cell list of the
+    IntegratorHPMCMonoGPU. The extra ghost width set by AnalyzerSDF is also added to the width of those cells, so the
+    expanded cells hold all particles that can touch when scaled by lmax. The cell list is recomputed before counting,
+    because the particles have moved since the integrator built it.
+
+    The histogram stays on the device and is only copied to the host when it is written to the file, every navg
+    samples.
+
+    \ingroup hpmc_analyzers
+*/
+template < class Shape >
+class AnalyzerSDFGPU : public AnalyzerSDF<Shape>
+    {
+    public:
+        //! Constructor
+        AnalyzerSDFGPU(std::shared_ptr<SystemDefinition> sysdef,
+                       std::shared_ptr< IntegratorHPMCMonoGPU<Shape> > mc,
+                       double lmax,
+                       double dl,
+                       unsigned int navg,
+                       const std::string& fname,
+                       bool overwrite);
+
+        //! Destructor
+        virtual ~AnalyzerSDFGPU() { }
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            m_tuner_sdf->setPeriod(period);
+            m_tuner_sdf->setEnabled(enable);
+
+            m_tuner_excell_block_size->setPeriod(period);
+            m_tuner_excell_block_size->setEnabled(enable);
+            }
+
+    protected:
+        std::shared_ptr<CellList> m_cl;       //!< Cell list of the integrator
+        uint3 m_last_dim;                     //!< Dimensions of the cell list on the last call to countHistogram
+        unsigned int m_last_nmax;             //!< Last cell list NMax value allocated in excell
+
+        GPUArray<unsigned int> m_excell_idx;  //!< Particle indices in expanded cells
+        GPUArray<unsigned int> m_excell_size; //!< Number of particles in each expanded cell
+        Index2D m_excell_list_indexer;        //!< Indexer to access elements of the excell_idx list
+
+        GPUArray<unsigned int> m_hist_gpu;    //!< Histogram on the device
+
+        std::unique_ptr<Autotuner> m_tuner_sdf;                //!< Autotuner for the SDF kernel
+        std::unique_ptr<Autotuner> m_tuner_excell_block_size;  //!< Autotuner for excell block_size
+
+        //! Copy the histogram to the host and write it to the file
+        virtual void writeOutput(uint64_t timestep);
+
+        //! Zero the histogram counts
+        virtual void zeroHistogram();
+
+        //! Add to histogram counts
+        virtual void countHistogram(uint64_t timestep);
+
+        //! Resize the expanded cells
+        void initializeExcellMem();
+    };
+
+/*! \param sysdef System definition
+    \param mc The MC integrator
+    \param lmax Right hand side of the last histogram bin
+    \param dl Bin size
+    \param navg Number of samples to average before writing to the file
+    \param fname File name to write to
+    \param overwrite Set to true to overwrite instead of append to the file
+*/
+template < class Shape >
+AnalyzerSDFGPU<Shape>::AnalyzerSDFGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                      std::shared_ptr< IntegratorHPMCMonoGPU<Shape> > mc,
+                                      double lmax,
+                                      double dl,
+                                      unsigned int navg,
+                                      const std::string& fname,
+                                      bool overwrite)
+    : AnalyzerSDF<Shape>(sysdef, mc, lmax, dl, navg, fname, overwrite), m_cl(mc->getCellList())
+    {
+    // initialize the autotuners
+    // the full block size, stride and group size matrix is searched,
+    // encoded as block_size*1000000 + stride*100 + group_size.
+    std::vector<unsigned int> valid_params;
+    unsigned int warp_size = this->m_exec_conf->dev_prop.warpSize;
+    for (unsigned int block_size = warp_size; block_size <= (unsigned int) this->m_exec_conf->dev_prop.maxThreadsPerBlock; block_size += warp_size)
+        {
+        for (auto s : Autotuner::getTppListPow2(warp_size))
+            {
+            unsigned int stride = 1;
+            while (stride <= this->m_exec_conf->dev_prop.warpSize/s)
+                {
+                // only widen the parallelism if the shape supports it
+                if (stride == 1 || Shape::isParallel())
+                    {
+                    // blockDim.z is limited to 64
+                    if ((block_size % (stride*s)) == 0 && block_size/s/stride <= 64)
+                        valid_params.push_back(block_size*1000000 + stride*100 + s);
+                    }
+                stride*=2;
+                }
+            }
+        }
+    m_tuner_sdf.reset(new Autotuner(valid_params, 5, 1000000, "hpmc_sdf", this->m_exec_conf));
+    m_tuner_excell_block_size.reset(new Autotuner(warp_size,this->m_exec_conf->dev_prop.maxThreadsPerBlock,warp_size, 5, 1000000, "hpmc_sdf_excell_block_size", this->m_exec_conf));
+
+    GPUArray<unsigned int> excell_size(0, this->m_exec_conf);
+    m_excell_size.swap(excell_size);
+
+    GPUArray<unsigned int> excell_idx(0, this->m_exec_conf);
+    m_excell_idx.swap(excell_idx);
+
+    // set last dim to a bogus value so that it will re-init on the first call
+    m_last_dim = make_uint3(0xffffffff, 0xffffffff, 0xffffffff);
+    m_last_nmax = 0xffffffff;
+
+    GPUArray<unsigned int> hist_gpu(this->m_hist.size(), this->m_exec_conf);
+    m_hist_gpu.swap(hist_gpu);
+    zeroHistogram();
+    }
+
+/*! \param timestep Current time step
+*/
+template < class Shape >
+void AnalyzerSDFGPU<Shape>::writeOutput(uint64_t timestep)
+    {
+        {
+        ArrayHandle<unsigned int> h_hist(m_hist_gpu, access_location::host, access_mode::read);
+        std::copy(h_hist.data, h_hist.data + this->m_hist.size(), this->m_hist.begin());
+        }
+
+    AnalyzerSDF<Shape>::writeOutput(timestep);
+    }
+
+template < class Shape >
+void AnalyzerSDFGPU<Shape>::zeroHistogram()
+    {
+    AnalyzerSDF<Shape>::zeroHistogram();
+
+    ArrayHandle<unsigned int> d_hist(m_hist_gpu, access_location::device, access_mode::overwrite);
+    hipMemset(d_hist.data, 0, sizeof(unsigned int)*m_hist_gpu.getNumElements());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    }
+
+/*! \param timestep current timestep
+
+    Each local particle adds its bin to the device histogram, as in AnalyzerSDF::countHistogram().
+*/
+template < class Shape >
+void AnalyzerSDFGPU<Shape>::countHistogram(uint64_t timestep)
+    {
+    if (this->m_pdata->getN() == 0)
+        return;
+
+    // the pairs are found with the minimum image convention
+    Scalar range = this->m_mc->getMaxCoreDiameter() / (1 - this->m_lmax);
+    const BoxDim& box = this->m_pdata->getBox();
+    Scalar3 npd = box.getNearestPlaneDistance();
+
+    if ((box.getPeriodic().x && npd.x <= range*2) ||
+        (box.getPeriodic().y && npd.y <= range*2) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && npd.z <= range*2))
+        {
+        this->m_exec_conf->msg->error() << "Simulation box too small for analyze.sdf() on GPU - increase it so the minimum image convention works" << std::endl;
+        throw std::runtime_error("Error performing SDF analysis");
+        }
+
+    // bin the particles at their current positions, the integrator computed the cell list before its trial moves
+    m_cl->forceCompute(0);
+
+    // if the cell list is a different size than last time, reinitialize the expanded cell list
+    uint3 cur_dim = m_cl->getDim();
+    if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z
+        || m_last_nmax != m_cl->getNmax())
+        {
+        initializeExcellMem();
+
+        m_last_dim = cur_dim;
+        m_last_nmax = m_cl->getNmax();
+        }
+
+        {
+        // access the cell list data
+        ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_idx(m_cl->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+        // per-device cell list data
+        const ArrayHandle<unsigned int>& d_cell_size_per_device = m_cl->getPerDevice() ?
+            ArrayHandle<unsigned int>(m_cl->getCellSizeArrayPerDevice(),access_location::device, access_mode::read) :
+            ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+        const ArrayHandle<unsigned int>& d_cell_idx_per_device = m_cl->getPerDevice() ?
+            ArrayHandle<unsigned int>(m_cl->getIndexArrayPerDevice(), access_location::device, access_mode::read) :
+            ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+
+        ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+
+        // update the expanded cells
+        m_tuner_excell_block_size->begin();
+        gpu::hpmc_excell(d_excell_idx.data,
+                         d_excell_size.data,
+                         m_excell_list_indexer,
+                         m_cl->getPerDevice() ? d_cell_idx_per_device.data : d_cell_idx.data,
+                         m_cl->getPerDevice() ? d_cell_size_per_device.data : d_cell_size.data,
+                         d_cell_adj.data,
+                         m_cl->getCellIndexer(),
+                         m_cl->getCellListIndexer(),
+                         m_cl->getCellAdjIndexer(),
+                         m_cl->getPerDevice() ? this->m_exec_conf->getNumActiveGPUs() : 1,
+                         m_tuner_excell_block_size->getParam());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+        m_tuner_excell_block_size->end();
+        }
+
+    ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_excell_idx(m_excell_idx, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_excell_size(m_excell_size, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_hist(m_hist_gpu, access_location::device, access_mode::readwrite);
+
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = this->m_mc->getParams();
+
+    m_tuner_sdf->begin();
+    unsigned int param = m_tuner_sdf->getParam();
+    unsigned int block_size = param / 1000000;
+    unsigned int stride = (param % 1000000 ) / 100;
+    unsigned int group_size = param % 100;
+
+    detail::hpmc_sdf_args_t sdf_args(this->m_pdata->getN(),
+                                     d_postype.data,
+                                     d_orientation.data,
+                                     m_cl->getCellIndexer(),
+                                     d_excell_idx.data,
+                                     d_excell_size.data,
+                                     m_excell_list_indexer,
+                                     m_cl->getDim(),
+                                     m_cl->getGhostWidth(),
+                                     this->m_pdata->getNTypes(),
+                                     box,
+                                     (unsigned int)this->m_hist.size(),
+                                     this->m_dl,
+                                     block_size,
+                                     stride,
+                                     group_size,
+                                     d_hist.data,
+                                     this->m_exec_conf->dev_prop);
+
+    detail::gpu_hpmc_sdf<Shape>(sdf_args, params.data());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner_sdf->end();
+    }
+
+template < class Shape >
+void AnalyzerSDFGPU<Shape>::initializeExcellMem()
+    {
+    this->m_exec_conf->msg->notice(4) << "analyze.sdf: resizing expanded cells" << std::endl;
+
+    // get the current cell dimensions
+    unsigned int num_cells = m_cl->getCellIndexer().getNumElements();
+    unsigned int num_adj = m_cl->getCellAdjIndexer().getW();
+    unsigned int num_max = m_cl->getNmax();
+
+    // make the excell dimensions the same, but with room for Nmax*Nadj in each cell
+    m_excell_list_indexer = Index2D(num_max * num_adj, num_cells);
+
+    // reallocate memory
+    m_excell_idx.resize(m_excell_list_indexer.getNumElements());
+    m_excell_size.resize(num_cells);
+    }
+
+//! Export the AnalyzerSDFGPU class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of AnalyzerSDFGPU<Shape> will be exported
+*/
+template < class Shape > void export_AnalyzerSDFGPU(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< AnalyzerSDFGPU<Shape>, AnalyzerSDF<Shape>, std::shared_ptr< AnalyzerSDFGPU<Shape> > >(m, name.c_str())
+          .def(pybind11::init< std::shared_ptr<SystemDefinition>, std::shared_ptr< IntegratorHPMCMonoGPU<Shape> >, double, double, unsigned int, const std::string&, bool>())
+          ;
+    }
+
+} // end namespace hpmc
+
+#endif // ENABLE_HIP
+
+#endif // _ANALYZER_SDF_GPU_H_
@@ -25,12 +25,27 @@
 
 #include <pybind11/pybind11.h>
 
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 
 namespace hpmc
 {
 
 //! Template class for a free volume integration analyzer
-/*!
+/*! compute() estimates the free volume from the test insertions of a single time step, and sums the overlap counts
+    of the ranks right away.
+
+    sample() instead adds the estimate of the current time step to a running average. The overlap counts of the
+    samples are kept per rank, and are summed over the ranks in a single reduction when the running average is read.
+    The error of the running average is the standard error of the samples, which assumes that they are uncorrelated.
+
     \ingroup hpmc_integrators
 */
 template< class Shape >
@@ -104,6 +119,32 @@ class ComputeFreeVolume : public Compute
         //! Return an estimate of the overlap volume
         virtual Scalar getFreeVolume();
 
+        //! Add the free volume at the given time step to the running average
+        void sample(uint64_t timestep);
+
+        //! Get the running average of the free volume, NaN before the first sample
+        double getFreeVolumeMean();
+
+        //! Get the standard error of the running average, NaN before the second sample
+        double getFreeVolumeError();
+
+        //! Get the number of samples in the running average
+        uint64_t getNumFreeVolumeSamples()
+            {
+            return m_n_stream + m_pending_overlaps.size();
+            }
+
+        //! Remove all samples from the running average
+        void resetSamples()
+            {
+            m_pending_overlaps.clear();
+            m_pending_n_sample.clear();
+            m_pending_volume.clear();
+            m_n_stream = 0;
+            m_stream_sum = 0.0;
+            m_stream_sum_sq = 0.0;
+            }
+
     protected:
         std::shared_ptr<IntegratorHPMCMono<Shape> > m_mc;              //!< The parent integrator
         std::shared_ptr<CellList> m_cl;                        //!< The cell list
@@ -114,8 +155,33 @@ class ComputeFreeVolume : public Compute
 
         GPUArray<unsigned int> m_n_overlap_all;                  //!< Number of overlap volume particles in box
 
-        //! Return an estimate of the overlap volume
+        std::vector<unsigned int> m_pending_overlaps;            //!< Local overlap counts not yet reduced
+        std::vector<unsigned int> m_pending_n_sample;            //!< Number of insertions of the pending samples
+        std::vector<double> m_pending_volume;                    //!< Box volume of the pending samples
+        uint64_t m_n_stream;                                     //!< Number of reduced samples
+        double m_stream_sum;                                     //!< Sum of the reduced free volumes
+        double m_stream_sum_sq;                                  //!< Sum of the squared reduced free volumes
+        uint64_t m_last_sample;                                  //!< Time step of the last sample
+
+        //! Count the overlapping test insertions on this rank into m_n_overlap_all
         virtual void computeFreeVolume(uint64_t timestep);
+
+        //! Number of test insertions summed over the ranks
+        unsigned int getTotalNumSamples()
+            {
+            unsigned int n_sample = m_n_sample;
+
+            #ifdef ENABLE_MPI
+            // in MPI, for small n_sample we can encounter round-off issues
+            unsigned int n_ranks = this->m_exec_conf->getNRanks();
+            n_sample = (n_sample/n_ranks)*n_ranks;
+            #endif
+
+            return n_sample;
+            }
+
+        //! Sum the pending samples over the ranks and add them to the running average
+        void flushSamples();
     };
 
 
@@ -124,7 +190,8 @@ ComputeFreeVolume< Shape >::ComputeFreeVolume(std::shared_ptr<SystemDefinition>
                                                     std::shared_ptr<IntegratorHPMCMono<Shape> > mc,
                                                     std::shared_ptr<CellList> cl,
                                                     std::string suffix)
-    : Compute(sysdef), m_mc(mc), m_cl(cl), m_type(0), m_n_sample(0), m_suffix(suffix)
+    : Compute(sysdef), m_mc(mc), m_cl(cl), m_type(0), m_n_sample(0), m_suffix(suffix), m_n_stream(0),
+      m_stream_sum(0.0), m_stream_sum_sq(0.0), m_last_sample(0)
     {
     this->m_exec_conf->msg->notice(5) << "Constructing ComputeFreeVolume" << std::endl;
 
@@ -148,6 +215,103 @@ void ComputeFreeVolume<Shape>::compute(uint64_t timestep)
     m_mc->communicate(false);
 
     this->computeFreeVolume(timestep);
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::readwrite);
+        MPI_Allreduce(MPI_IN_PLACE, h_n_overlap_all.data, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    }
+
+/*! \param timestep Current time step
+
+    The test insertions are seeded by the time step, so repeated calls on the same time step are ignored.
+*/
+template<class Shape>
+void ComputeFreeVolume<Shape>::sample(uint64_t timestep)
+    {
+    if (getNumFreeVolumeSamples() > 0 && timestep == m_last_sample)
+        return;
+    m_last_sample = timestep;
+
+    // keep the reduced count of the last compute(), which computeFreeVolume() overwrites with the local count
+    unsigned int n_overlap_computed;
+        {
+        ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::read);
+        n_overlap_computed = *h_n_overlap_all.data;
+        }
+
+    // update ghost layers
+    m_mc->communicate(false);
+
+    this->computeFreeVolume(timestep);
+
+    ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::readwrite);
+    m_pending_overlaps.push_back(*h_n_overlap_all.data);
+    *h_n_overlap_all.data = n_overlap_computed;
+    m_pending_n_sample.push_back(getTotalNumSamples());
+    m_pending_volume.push_back(this->m_pdata->getGlobalBox().getVolume(this->m_sysdef->getNDimensions() == 2));
+    }
+
+/*! All ranks must call flushSamples() together.
+*/
+template<class Shape>
+void ComputeFreeVolume<Shape>::flushSamples()
+    {
+    if (m_pending_overlaps.size() == 0)
+        return;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE,
+                      m_pending_overlaps.data(),
+                      (int)m_pending_overlaps.size(),
+                      MPI_UNSIGNED,
+                      MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    for (unsigned int i = 0; i < m_pending_overlaps.size(); i++)
+        {
+        unsigned int n_sample = m_pending_n_sample[i];
+        double V_free = n_sample ? double(n_sample - m_pending_overlaps[i])/double(n_sample)*m_pending_volume[i] : 0.0;
+        m_stream_sum += V_free;
+        m_stream_sum_sq += V_free*V_free;
+        m_n_stream++;
+        }
+
+    m_pending_overlaps.clear();
+    m_pending_n_sample.clear();
+    m_pending_volume.clear();
+    }
+
+template<class Shape>
+double ComputeFreeVolume<Shape>::getFreeVolumeMean()
+    {
+    flushSamples();
+
+    if (m_n_stream == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    return m_stream_sum/double(m_n_stream);
+    }
+
+template<class Shape>
+double ComputeFreeVolume<Shape>::getFreeVolumeError()
+    {
+    flushSamples();
+
+    if (m_n_stream < 2)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    double n = double(m_n_stream);
+    double mean = m_stream_sum/n;
+    double variance = std::max(0.0, (m_stream_sum_sq - n*mean*mean)/(n - 1.0));
+    return std::sqrt(variance/n);
     }
 
 /*! \return the current free volume estimate by MC integration
@@ -155,8 +319,7 @@ void ComputeFreeVolume<Shape>::compute(uint64_t timestep)
 template<class Shape>
 void ComputeFreeVolume<Shape>::computeFreeVolume(uint64_t timestep)
     {
-    unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
+    std::atomic<unsigned int> overlap_count(0);
     unsigned int ndim = this->m_sysdef->getNDimensions();
 
     this->m_exec_conf->msg->notice(5) << "HPMC computing free volume " << timestep << std::endl;
@@ -192,8 +355,17 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(uint64_t timestep)
         n_sample /= this->m_exec_conf->getNRanks();
         #endif
 
+        // each test insertion has its own random number stream, so they are independent of the thread
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_sample),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+        #else
         for (unsigned int i = 0; i < n_sample; i++)
+        #endif
             {
+            unsigned int err_count = 0;
+
             // select a random particle coordinate in the box
             hoomd::RandomGenerator rng_i(hoomd::Seed(hoomd::RNGIdentifier::ComputeFreeVolume, timestep, seed),
                                          hoomd::Counter(m_exec_conf->getRank(), i));
@@ -277,16 +449,12 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(uint64_t timestep)
                 overlap_count++;
                 }
             } // end loop through all particles
+        #ifdef ENABLE_TBB
+            });
+        #endif
 
         } // end lexical scope
 
-    #ifdef ENABLE_MPI
-    if (m_comm)
-        {
-        MPI_Allreduce(MPI_IN_PLACE, &overlap_count, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
-        }
-    #endif
-
     if (m_prof) m_prof->pop();
 
     ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::overwrite);
@@ -309,14 +477,7 @@ Scalar ComputeFreeVolume<Shape>::getLogValue(const std::string& quantity, uint64
         ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::read);
 
         // generate n_sample random test depletants in the global box
-        unsigned int n_sample = m_n_sample;
-
-        #ifdef ENABLE_MPI
-        // in MPI, for small n_sample we can encounter round-off issues
-        unsigned int n_ranks = this->m_exec_conf->getNRanks();
-        n_sample = (n_sample/n_ranks)*n_ranks;
-        #endif
-
+        unsigned int n_sample = getTotalNumSamples();
 
         // total free volume
         const BoxDim& global_box = this->m_pdata->getGlobalBox();
@@ -335,14 +496,7 @@ Scalar ComputeFreeVolume<Shape>::getFreeVolume()
     ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::read);
 
     // generate n_sample random test depletants in the global box
-    unsigned int n_sample = m_n_sample;
-
-    #ifdef ENABLE_MPI
-    // in MPI, for small n_sample we can encounter round-off issues
-    unsigned int n_ranks = this->m_exec_conf->getNRanks();
-    n_sample = (n_sample/n_ranks)*n_ranks;
-    #endif
-
+    unsigned int n_sample = getTotalNumSamples();
 
     // total free volume
     const BoxDim& global_box = this->m_pdata->getGlobalBox();
@@ -365,6 +519,11 @@ template < class Shape > void export_ComputeFreeVolume(pybind11::module& m, cons
         .def_property("num_samples", &ComputeFreeVolume<Shape>::getNumSamples, &ComputeFreeVolume<Shape>::setNumSamples)
         .def_property("test_particle_type", &ComputeFreeVolume<Shape>::getTestParticleType, &ComputeFreeVolume<Shape>::setTestParticleType)
         .def_property_readonly("free_volume", &ComputeFreeVolume<Shape>::getFreeVolume)
+        .def("sample", &ComputeFreeVolume<Shape>::sample)
+        .def_property_readonly("free_volume_mean", &ComputeFreeVolume<Shape>::getFreeVolumeMean)
+        .def_property_readonly("free_volume_error", &ComputeFreeVolume<Shape>::getFreeVolumeError)
+        .def_property_readonly("num_free_volume_samples", &ComputeFreeVolume<Shape>::getNumFreeVolumeSamples)
+        .def("reset_samples", &ComputeFreeVolume<Shape>::resetSamples)
         ;
     }
 
@@ -270,14 +270,6 @@ void ComputeFreeVolumeGPU<Shape>::computeFreeVolume(uint64_t timestep)
         m_tuner_free_volume->end();
         }
 
-    #ifdef ENABLE_MPI
-    if (this->m_comm)
-        {
-        ArrayHandle<unsigned int> h_n_overlap_all(this->m_n_overlap_all, access_location::host, access_mode::readwrite);
-        MPI_Allreduce(MPI_IN_PLACE, h_n_overlap_all.data, 1, MPI_UNSIGNED, MPI_SUM, this->m_exec_conf->getMPICommunicator());
-        }
-    #endif
-
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
     }
 
@@ -16,18 +16,30 @@
 
 #ifndef __HIPCC__
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #endif
 
+#include <vector>
+
 namespace hpmc
 {
 
+//! External field evaluated by a python function
+/*! By default, the python function is called with a snapshot of the system and returns the total energy.
+
+    In batch mode, the python function is called as energy_function(box, types, positions, orientations) with numpy
+    arrays of shape (n,), (n,3) and (n,4) and returns the n per-particle energies. A single call evaluates the
+    configuration of all particles, or both the old and the new configuration of a moved particle, which avoids
+    taking a snapshot and entering python once per configuration.
+*/
 template< class Shape>
 class __attribute__ ((visibility ("hidden"))) ExternalCallback : public ExternalFieldMono<Shape>
     {
     public:
         ExternalCallback(std::shared_ptr<SystemDefinition> sysdef,
-                         pybind11::object energy_function)
-            : ExternalFieldMono<Shape>(sysdef), callback(energy_function)
+                         pybind11::object energy_function,
+                         bool batch=false)
+            : ExternalFieldMono<Shape>(sysdef), callback(energy_function), m_batch(batch)
             {
             #ifdef ENABLE_MPI
             if (this->m_pdata->getDomainDecomposition())
@@ -42,6 +54,11 @@ class __attribute__ ((visibility ("hidden"))) ExternalCallback : public External
         //! Compute Boltzmann weight exp(-U) of current configuration
         Scalar calculateBoltzmannWeight(uint64_t timestep)
             {
+            if (m_batch)
+                {
+                return exp(-getEnergyBatch(this->m_pdata->getGlobalBox(), NULL, NULL));
+                }
+
             auto snap = takeSnapshot();
             double energy = getEnergy(snap);
             return exp(-energy);
@@ -57,6 +74,16 @@ class __attribute__ ((visibility ("hidden"))) ExternalCallback : public External
                                const BoxDim * const  box_old_arg
                               )
             {
+            if (m_batch)
+                {
+                const BoxDim& box_new = this->m_pdata->getGlobalBox();
+                double energy_new = getEnergyBatch(box_new, NULL, NULL);
+                double energy_old = getEnergyBatch(box_old_arg ? *box_old_arg : box_new,
+                    position_old_arg,
+                    orientation_old_arg);
+                return energy_new-energy_old;
+                }
+
             auto snap = takeSnapshot();
             double energy_new = getEnergy(snap);
 
@@ -68,9 +95,8 @@ class __attribute__ ((visibility ("hidden"))) ExternalCallback : public External
             for (unsigned int i = 0; i < N; ++i)
                 {
                 unsigned int tag = h_tag.data[i];
-                auto snap_it = snap->map.find(tag);
-                assert (snap_it != snap->map.end());
-                unsigned int snap_idx = snap_it->second;
+                unsigned int snap_idx = snap->map[tag];
+                assert (snap_idx != NOT_LOCAL);
                 snap->particle_data.pos[snap_idx] = vec3<Scalar>(position_old_arg[i]);
                 if (orientation_old_arg != NULL)
                     snap->particle_data.orientation[snap_idx] = quat<Scalar>(orientation_old_arg[i]);
@@ -89,6 +115,22 @@ class __attribute__ ((visibility ("hidden"))) ExternalCallback : public External
                           const vec3<Scalar>& position_new,
                           const Shape& shape_new)
             {
+            if (m_batch)
+                {
+                unsigned int type;
+                    {
+                    ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::read);
+                    type = __scalar_as_int(h_postype.data[index].w);
+                    }
+
+                // evaluate the old and the new configuration in one call
+                std::vector<unsigned int> types(2, type);
+                std::vector< vec3<Scalar> > positions = {position_old, position_new};
+                std::vector< quat<Scalar> > orientations = {shape_old.orientation, shape_new.orientation};
+                std::vector<double> energies = callBatch(this->m_pdata->getGlobalBox(), types, positions, orientations);
+                return energies[1]-energies[0];
+                }
+
             // find index in snapshot
             unsigned int tag;
                 {
@@ -97,9 +139,8 @@ class __attribute__ ((visibility ("hidden"))) ExternalCallback : public External
                 }
 
             auto snap = takeSnapshot();
-            auto snap_it = snap->map.find(tag);
-            assert (snap_it != snap->map.end());
-            unsigned int snap_idx = snap_it->second;
+            unsigned int snap_idx = snap->map[tag];
+            assert (snap_idx != NOT_LOCAL);
 
             // update snapshot with old configuration
             snap->particle_data.pos[snap_idx] = position_old;
@@ -140,8 +181,100 @@ class __attribute__ ((visibility ("hidden"))) ExternalCallback : public External
             return e;
             }
 
+        //! Get the total energy of the local particles from the batched python function
+        /*! \param box Box to evaluate the energy in
+            \param position_arg Positions to use instead of the current ones (may be NULL)
+            \param orientation_arg Orientations to use instead of the current ones (may be NULL)
+        */
+        double getEnergyBatch(const BoxDim& box,
+                              const Scalar4 * const position_arg,
+                              const Scalar4 * const orientation_arg)
+            {
+            unsigned int N = this->m_pdata->getN();
+            std::vector<unsigned int> types(N);
+            std::vector< vec3<Scalar> > positions(N);
+            std::vector< quat<Scalar> > orientations(N);
+
+                {
+                ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::read);
+                ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+                const Scalar4 *position = position_arg ? position_arg : h_postype.data;
+                const Scalar4 *orientation = orientation_arg ? orientation_arg : h_orientation.data;
+                for (unsigned int i = 0; i < N; ++i)
+                    {
+                    types[i] = __scalar_as_int(h_postype.data[i].w);
+                    positions[i] = vec3<Scalar>(position[i]);
+                    orientations[i] = quat<Scalar>(orientation[i]);
+                    }
+                }
+
+            std::vector<double> energies = callBatch(box, types, positions, orientations);
+
+            double e = 0.0;
+            for (unsigned int i = 0; i < N; ++i)
+                e += energies[i];
+            return e;
+            }
+
+        //! Call the batched python function
+        /*! \returns The energy of each particle
+        */
+        std::vector<double> callBatch(const BoxDim& box,
+                                      const std::vector<unsigned int>& types,
+                                      const std::vector< vec3<Scalar> >& positions,
+                                      const std::vector< quat<Scalar> >& orientations)
+            {
+            size_t n = types.size();
+            std::vector<double> energies(n, 0.0);
+            if (callback.is(pybind11::none()))
+                return energies;
+
+            pybind11::array_t<unsigned int> type_array(n);
+            pybind11::array_t<Scalar> position_array({n, size_t(3)});
+            pybind11::array_t<Scalar> orientation_array({n, size_t(4)});
+
+            auto t = type_array.mutable_unchecked<1>();
+            auto r = position_array.mutable_unchecked<2>();
+            auto q = orientation_array.mutable_unchecked<2>();
+            for (size_t i = 0; i < n; ++i)
+                {
+                t(i) = types[i];
+                r(i, 0) = positions[i].x;
+                r(i, 1) = positions[i].y;
+                r(i, 2) = positions[i].z;
+                q(i, 0) = orientations[i].s;
+                q(i, 1) = orientations[i].v.x;
+                q(i, 2) = orientations[i].v.y;
+                q(i, 3) = orientations[i].v.z;
+                }
+
+            pybind11::object rv = callback(box, type_array, position_array, orientation_array);
+
+            pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast> rv_array;
+            try
+                {
+                rv_array = pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast>(rv);
+                }
+            catch (const std::exception& e)
+                {
+                throw std::runtime_error("Expected an array of per-particle energies (energy/kT) as return value.");
+                }
+
+            if ((size_t) rv_array.size() != n)
+                {
+                throw std::runtime_error("Expected one energy (energy/kT) per particle as return value.");
+                }
+
+            const double *rv_data = rv_array.data();
+            for (size_t i = 0; i < n; ++i)
+                energies[i] = rv_data[i];
+            return energies;
+            }
+
     private:
         pybind11::object callback; //! The python callback
+        bool m_batch;              //! True if the python callback evaluates arrays of particles
     };
 
 template<class Shape>
@@ -149,6 +282,7 @@ void export_ExternalCallback(pybind11::module& m, const std::string& name)
     {
     pybind11::class_<ExternalCallback<Shape>, ExternalFieldMono<Shape>, std::shared_ptr< ExternalCallback<Shape> > >(m, name.c_str())
     .def(pybind11::init< std::shared_ptr<SystemDefinition>, pybind11::object>())
+    .def(pybind11::init< std::shared_ptr<SystemDefinition>, pybind11::object, bool>())
     ;
     }
 
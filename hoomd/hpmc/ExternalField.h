@@ -19,8 +19,67 @@
 #include <pybind11/pybind11.h>
 #endif
 
+#ifdef ENABLE_HIP
+#include "hoomd/GPUPartition.cuh"
+#include <hip/hip_runtime.h>
+#endif
+
 namespace hpmc
 {
+
+namespace detail
+{
+
+#ifdef ENABLE_HIP
+//! Wraps arguments to the GPU external field kernels
+struct hpmc_external_args_t
+    {
+    //! Construct a hpmc_external_args_t
+    hpmc_external_args_t(const Scalar4 *_d_postype,
+                const Scalar4 *_d_orientation,
+                const Scalar4 *_d_trial_postype,
+                const Scalar4 *_d_trial_orientation,
+                const unsigned int *_d_trial_move_type,
+                const Scalar *_d_charge,
+                const Scalar *_d_diameter,
+                unsigned int *_d_reject_out_of_cell,
+                const uint16_t _seed,
+                const uint64_t _timestep,
+                const unsigned int _select,
+                const BoxDim& _box,
+                const GPUPartition& _gpu_partition)
+                : d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  d_trial_postype(_d_trial_postype),
+                  d_trial_orientation(_d_trial_orientation),
+                  d_trial_move_type(_d_trial_move_type),
+                  d_charge(_d_charge),
+                  d_diameter(_d_diameter),
+                  d_reject_out_of_cell(_d_reject_out_of_cell),
+                  seed(_seed),
+                  timestep(_timestep),
+                  select(_select),
+                  box(_box),
+                  gpu_partition(_gpu_partition)
+        { }
+
+    const Scalar4 *d_postype;               //!< postype array
+    const Scalar4 *d_orientation;           //!< orientation array
+    const Scalar4 *d_trial_postype;         //!< New positions (and type) of particles
+    const Scalar4 *d_trial_orientation;     //!< New orientations of particles
+    const unsigned int *d_trial_move_type;  //!< 0=no move, 1/2 = translate/rotate
+    const Scalar *d_charge;                 //!< Particle charges
+    const Scalar *d_diameter;               //!< Particle diameters
+    unsigned int *d_reject_out_of_cell;     //!< Flag if a particle move has been rejected a priori (output)
+    const uint16_t seed;                    //!< RNG seed
+    const uint64_t timestep;                //!< Current timestep
+    const unsigned int select;              //!< Current selection
+    const BoxDim& box;                      //!< Current simulation box
+    const GPUPartition& gpu_partition;      //!< split particles among GPUs
+    };
+#endif
+
+} // end namespace detail
 class ExternalField : public Compute
     {
     public:
@@ -68,7 +127,40 @@ class ExternalFieldMono : public ExternalField
         //! method to calculate the energy difference for the proposed move.
         virtual double energydiff(const unsigned int& index, const vec3<Scalar>& position_old, const Shape& shape_old, const vec3<Scalar>& position_new, const Shape& shape_new){return 0;}
 
+        //! Notify the field that the move last passed to energydiff() for particle \a index was accepted
+        /*! Fields that cache the energy of the current configuration update the cache here.
+        */
+        virtual void acceptMove(const unsigned int& index) {}
+
         virtual void reset(uint64_t timestep) {}
+
+        #ifdef ENABLE_HIP
+        //! A struct that contains the kernel arguments
+        typedef detail::hpmc_external_args_t gpu_args_t;
+
+        //! Returns true if the field can accept or reject trial moves on the GPU
+        virtual bool hasGPUImplementation()
+            {
+            return false;
+            }
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period) { }
+
+        //! Asynchronously reject trial moves according to the field energy difference
+        /*! \param args Kernel arguments
+            \param hStream stream to execute on
+
+            Rejected moves are flagged in args.d_reject_out_of_cell, so that the narrow phase skips them.
+        */
+        virtual void rejectMovesGPU(const gpu_args_t& args, hipStream_t hStream)
+            {
+            throw std::runtime_error("ExternalFieldMono (base class) does not support rejectMovesGPU");
+            }
+        #endif
     };
 
 
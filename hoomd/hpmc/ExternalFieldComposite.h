@@ -50,6 +50,14 @@ class ExternalFieldMonoComposite : public ExternalFieldMono<Shape>
             return Energy;
             }
 
+        void acceptMove(const unsigned int& index)
+            {
+            for(size_t i = 0; i < m_externals.size(); i++)
+                {
+                m_externals[i]->acceptMove(index);
+                }
+            }
+
         void addExternal(std::shared_ptr< ExternalFieldMono<Shape> > ext) { m_externals.push_back(ext); }
 
         void reset(uint64_t timestep)
@@ -60,6 +68,14 @@ class ExternalFieldMonoComposite : public ExternalFieldMono<Shape>
             }
         }
 
+        void compute(uint64_t timestep)
+            {
+            for(size_t i = 0; i < m_externals.size(); i++)
+                {
+                m_externals[i]->compute(timestep);
+                }
+            }
+
     private:
         std::vector< std::shared_ptr< ExternalFieldMono<Shape> > > m_externals;
     };
@@ -164,7 +164,8 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
                                         pybind11::list q0,
                                         Scalar q,
                                         pybind11::list symRotations
-                                    ) : ExternalFieldMono<Shape>(sysdef), m_k(k), m_q(q), m_Energy(0)
+                                    ) : ExternalFieldMono<Shape>(sysdef), m_k(k), m_q(q), m_Energy(0),
+                                        m_energy_cache_valid(false), m_trial_index(0), m_trial_energy(0)
             {
             m_ProvidedQuantities.push_back(LATTICE_ENERGY_LOG_NAME);
             m_ProvidedQuantities.push_back(LATTICE_ENERGY_AVG_LOG_NAME);
@@ -246,21 +247,32 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
             return dE;
             }
 
+        /*! The integrator calls compute() before every sweep, so the energy of each particle is cached here as
+            the old energy of its trial moves. The cache is refilled even when the logged energy of this time step
+            has already been computed, since other updaters may have moved particles since.
+        */
         void compute(uint64_t timestep)
             {
-            if(!this->shouldCompute(timestep))
-                {
-                return;
-                }
-            m_Energy = Scalar(0.0);
             // access particle data and system box
             ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_orient(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+            m_energy_cache.resize(m_pdata->getN());
             for(unsigned int i = 0; i < m_pdata->getN(); i++)
                 {
                 vec3<Scalar> position(h_postype.data[i]);
                 quat<Scalar> orientation(h_orient.data[i]);
-                m_Energy += calcE(i, position, orientation);
+                m_energy_cache[i] = calcE(i, position, orientation);
+                }
+            m_energy_cache_valid = true;
+
+            if(!this->shouldCompute(timestep))
+                {
+                return;
+                }
+            m_Energy = Scalar(0.0);
+            for(unsigned int i = 0; i < m_pdata->getN(); i++)
+                {
+                m_Energy += m_energy_cache[i];
                 }
 
             #ifdef ENABLE_MPI
@@ -284,10 +296,26 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
             m_num_samples++;
             }
 
+        /*! The old energy is taken from the cache filled by compute() and kept current by acceptMove(), so only the
+            new configuration is evaluated.
+        */
         double energydiff(const unsigned int& index, const vec3<Scalar>& position_old, const Shape& shape_old, const vec3<Scalar>& position_new, const Shape& shape_new)
             {
-            double old_U = calcE(index, position_old, shape_old), new_U = calcE(index, position_new, shape_new);
-            return new_U - old_U;
+            double old_U;
+            if (m_energy_cache_valid && index < m_energy_cache.size())
+                old_U = m_energy_cache[index];
+            else
+                old_U = calcE(index, position_old, shape_old);
+
+            m_trial_index = index;
+            m_trial_energy = calcE(index, position_new, shape_new);
+            return double(m_trial_energy) - old_U;
+            }
+
+        void acceptMove(const unsigned int& index)
+            {
+            if (m_energy_cache_valid && index == m_trial_index && index < m_energy_cache.size())
+                m_energy_cache[index] = m_trial_energy;
             }
 
         void setReferences(const pybind11::list& r0, const pybind11::list& q0)
@@ -377,11 +405,12 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
 
             if( lattice_orientations.size() )
                 m_latticeOrientations.setReferences(lattice_orientations.begin(), lattice_orientations.end(), m_pdata, m_exec_conf);
+            m_energy_cache_valid = false;
             }
 
-        void clearPositions() { m_latticePositions.clear(); }
+        void clearPositions() { m_latticePositions.clear(); m_energy_cache_valid = false; }
 
-        void clearOrientations() { m_latticeOrientations.clear(); }
+        void clearOrientations() { m_latticeOrientations.clear(); m_energy_cache_valid = false; }
 
         void scaleReferencePoints()
             {
@@ -395,6 +424,7 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
                     scale = pow((newVol/lastVol), Scalar(1.0/3.0));
                 m_latticePositions.scale(scale);
                 m_box = newBox;
+                m_energy_cache_valid = false;
             }
 
         //! Returns a list of log quantities this compute calculates
@@ -449,6 +479,7 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
             {
             m_k = k;
             m_q = q;
+            m_energy_cache_valid = false;
             }
 
         const GPUArray< Scalar3 >& getReferenceLatticePositions()
@@ -573,6 +604,11 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
 
         std::vector<std::string>        m_ProvidedQuantities;
         BoxDim                          m_box;              //!< Save the last known box;
+
+        std::vector<Scalar>             m_energy_cache;         //!< Energy of each local particle in the current configuration
+        bool                            m_energy_cache_valid;   //!< True when m_energy_cache matches the particle data
+        unsigned int                    m_trial_index;          //!< Particle of the last trial move
+        Scalar                          m_trial_energy;         //!< Energy of the last trial move
     };
 
 template<class Shape>
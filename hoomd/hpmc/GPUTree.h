@@ -24,6 +24,8 @@
 
 #ifndef __HIPCC__
 #include <sstream>
+#include <cmath>
+#include <cfloat>
 #endif
 
 #include "hoomd/ManagedArray.h"
@@ -34,6 +36,56 @@ namespace hpmc
 namespace detail
 {
 
+//! Compact storage of a GPUTree node
+/*! The node boxes are kept in one array of structures so that fetching a node reads one contiguous block, and
+    they are always stored in single precision. When OverlapReal is double, the lengths are grown to cover the rounding
+    of the center, rotation and lengths, so that overlap checks of the node boxes remain conservative. When OverlapReal
+    is float, the node boxes are stored exactly.
+*/
+struct CompactOBB
+    {
+    vec3<float> center;     //!< Center of the box
+    vec3<float> lengths;    //!< Half-axes of the box
+    quat<float> rotation;   //!< Orientation of the box
+    unsigned int mask;      //!< Overlap mask
+    unsigned int is_sphere; //!< Non-zero if the box is a sphere
+
+    //! Default constructor
+    DEVICE CompactOBB() : mask(0), is_sphere(0) { }
+
+    #ifndef __HIPCC__
+    //! Construct from an OBB
+    explicit CompactOBB(const OBB& obb)
+        : center(obb.center), lengths(obb.lengths), rotation(obb.rotation), mask(obb.mask),
+          is_sphere(obb.isSphere())
+        {
+        if (sizeof(OverlapReal) > sizeof(float))
+            {
+            // relative rounding error of float is 2^-24, allow for 16 times that
+            OverlapReal margin = OverlapReal(1.0/double(1 << 20))
+                * (fabs(obb.center.x) + fabs(obb.center.y) + fabs(obb.center.z)
+                   + obb.lengths.x + obb.lengths.y + obb.lengths.z);
+
+            lengths.x = std::nextafter(float(obb.lengths.x + margin), FLT_MAX);
+            lengths.y = std::nextafter(float(obb.lengths.y + margin), FLT_MAX);
+            lengths.z = std::nextafter(float(obb.lengths.z + margin), FLT_MAX);
+            }
+        }
+    #endif
+
+    //! Get the node box as an OBB
+    DEVICE inline OBB toOBB() const
+        {
+        OBB obb;
+        obb.center = vec3<OverlapReal>(center);
+        obb.lengths = vec3<OverlapReal>(lengths);
+        obb.rotation = quat<OverlapReal>(rotation);
+        obb.mask = mask;
+        obb.is_sphere = is_sphere;
+        return obb;
+        }
+    };
+
 //! Adapter class to AABTree for query on the GPU
 class GPUTree
     {
@@ -53,11 +105,7 @@ class GPUTree
             // allocate
             m_num_nodes = tree.getNumNodes();
 
-            m_center = ManagedArray<vec3<OverlapReal> >(m_num_nodes, managed);
-            m_lengths = ManagedArray<vec3<OverlapReal> >(m_num_nodes,managed);
-            m_rotation = ManagedArray<quat<OverlapReal> >(m_num_nodes,managed);
-            m_mask = ManagedArray<unsigned int>(m_num_nodes,managed);
-            m_is_sphere = ManagedArray<unsigned int>(m_num_nodes,managed);
+            m_obb = ManagedArray<CompactOBB>(m_num_nodes, managed);
             m_left = ManagedArray<unsigned int>(m_num_nodes, managed);
             m_escape = ManagedArray<unsigned int>(m_num_nodes, managed);
             m_ancestors = ManagedArray<unsigned int>(m_num_nodes, managed);
@@ -72,11 +120,7 @@ class GPUTree
                 m_left[i] = tree.getNodeLeft(i);
                 m_escape[i] = tree.getEscapeIndex(i);
 
-                m_center[i] = tree.getNodeOBB(i).getPosition();
-                m_rotation[i] = tree.getNodeOBB(i).rotation;
-                m_lengths[i] = tree.getNodeOBB(i).lengths;
-                m_mask[i] = tree.getNodeOBB(i).mask;
-                m_is_sphere[i] = tree.getNodeOBB(i).isSphere();
+                m_obb[i] = CompactOBB(tree.getNodeOBB(i));
 
                 m_leaf_ptr[i] = n;
                 n += tree.getNodeNumParticles(i);
@@ -267,24 +311,14 @@ class GPUTree
 
         DEVICE inline OBB getOBB(unsigned int idx) const
             {
-            OBB obb;
-            obb.center = m_center[idx];
-            obb.lengths = m_lengths[idx];
-            obb.rotation = m_rotation[idx];
-            obb.mask = m_mask[idx];
-            obb.is_sphere = m_is_sphere[idx];
-            return obb;
+            return m_obb[idx].toOBB();
             }
 
         #ifdef ENABLE_HIP
         //! Set CUDA memory hints
         void set_memory_hint() const
             {
-            m_center.set_memory_hint();
-            m_lengths.set_memory_hint();
-            m_rotation.set_memory_hint();
-            m_mask.set_memory_hint();
-            m_is_sphere.set_memory_hint();
+            m_obb.set_memory_hint();
 
             m_left.set_memory_hint();
             m_escape.set_memory_hint();
@@ -302,11 +336,7 @@ class GPUTree
          */
         DEVICE void load_shared(char *& ptr, unsigned int &available_bytes)
             {
-            m_center.load_shared(ptr, available_bytes);
-            m_lengths.load_shared(ptr, available_bytes);
-            m_rotation.load_shared(ptr, available_bytes);
-            m_mask.load_shared(ptr, available_bytes);
-            m_is_sphere.load_shared(ptr, available_bytes);
+            m_obb.load_shared(ptr, available_bytes);
 
             m_left.load_shared(ptr, available_bytes);
             m_escape.load_shared(ptr, available_bytes);
@@ -323,11 +353,7 @@ class GPUTree
          */
         HOSTDEVICE void allocate_shared(char *& ptr, unsigned int &available_bytes) const
             {
-            m_center.allocate_shared(ptr, available_bytes);
-            m_lengths.allocate_shared(ptr, available_bytes);
-            m_rotation.allocate_shared(ptr, available_bytes);
-            m_mask.allocate_shared(ptr, available_bytes);
-            m_is_sphere.allocate_shared(ptr, available_bytes);
+            m_obb.allocate_shared(ptr, available_bytes);
 
             m_left.allocate_shared(ptr, available_bytes);
             m_escape.allocate_shared(ptr, available_bytes);
@@ -344,12 +370,14 @@ class GPUTree
             return m_leaf_capacity;
             }
 
+        //! Get the node boxes
+        const ManagedArray<CompactOBB>& getNodeBoxes() const
+            {
+            return m_obb;
+            }
+
     private:
-        ManagedArray<vec3<OverlapReal> > m_center;
-        ManagedArray<vec3<OverlapReal> > m_lengths;
-        ManagedArray<quat<OverlapReal> > m_rotation;
-        ManagedArray<unsigned int> m_mask;
-        ManagedArray<unsigned int> m_is_sphere;
+        ManagedArray<CompactOBB> m_obb;       //!< Node boxes
 
         ManagedArray<unsigned int> m_leaf_ptr; //!< Pointer to leaf node contents
         ManagedArray<unsigned int> m_leaf_obb_ptr; //!< Pointer to leaf node OBBs
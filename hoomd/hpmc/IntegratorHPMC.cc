@@ -18,7 +18,8 @@ namespace hpmc
 {
 
 IntegratorHPMC::IntegratorHPMC(std::shared_ptr<SystemDefinition> sysdef)
-    : Integrator(sysdef, 0.005), m_translation_move_probability(32768), m_nselect(4),
+    : Integrator(sysdef, 0.005), m_translation_move_probability(32768), m_nselect(4), m_checkerboard(false),
+      m_depletant_load_balance(false), m_sync_free(false), m_nlist_buffer(0.0),
       m_nominal_width(1.0), m_extra_ghost_width(0), m_external_base(NULL), m_patch_log(false),
       m_past_first_run(false)
       #ifdef ENABLE_MPI
@@ -231,6 +232,18 @@ bool IntegratorHPMC::checkParticleOrientations()
     \returns false if resize results in overlaps
 */
 bool IntegratorHPMC::attemptBoxResize(uint64_t timestep, const BoxDim& new_box)
+    {
+    scaleBox(new_box);
+
+    // check overlaps
+    return !this->countOverlaps(true);
+    }
+
+/*! \param new_box The new global box
+
+    The particles keep their fractional coordinates in the box. The ghost particles are communicated for the new box.
+*/
+void IntegratorHPMC::scaleBox(const BoxDim& new_box)
     {
     unsigned int N = m_pdata->getN();
 
@@ -262,9 +275,6 @@ bool IntegratorHPMC::attemptBoxResize(uint64_t timestep, const BoxDim& new_box)
 
     // we have moved particles, communicate those changes
     this->communicate(false);
-
-    // check overlaps
-    return !this->countOverlaps(true);
     }
 
 /*! \param mode 0 -> Absolute count, 1 -> relative to the start of the run, 2 -> relative to the last executed step
@@ -276,6 +286,8 @@ bool IntegratorHPMC::attemptBoxResize(uint64_t timestep, const BoxDim& new_box)
 */
 hpmc_counters_t IntegratorHPMC::getCounters(unsigned int mode)
     {
+    updateDeferredCounters();
+
     ArrayHandle<hpmc_counters_t> h_counters(m_count_total, access_location::host, access_mode::read);
     hpmc_counters_t result;
 
@@ -325,6 +337,10 @@ void export_IntegratorHPMC(py::module& m)
         .def("setCommunicator", &IntegratorHPMC::setCommunicator)
         #endif
         .def_property("nselect", &IntegratorHPMC::getNSelect, &IntegratorHPMC::setNSelect)
+        .def_property("checkerboard", &IntegratorHPMC::getCheckerboard, &IntegratorHPMC::setCheckerboard)
+        .def_property("depletant_load_balance", &IntegratorHPMC::getDepletantLoadBalance, &IntegratorHPMC::setDepletantLoadBalance)
+        .def_property("sync_free", &IntegratorHPMC::getSyncFree, &IntegratorHPMC::setSyncFree)
+        .def_property("nlist_buffer", &IntegratorHPMC::getNlistBuffer, &IntegratorHPMC::setNlistBuffer)
         .def_property("translation_move_probability", &IntegratorHPMC::getTranslationMoveProbability, &IntegratorHPMC::setTranslationMoveProbability)
         ;
 
@@ -22,6 +22,8 @@
 #ifndef __HIPCC__
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+
+#include <limits>
 #endif
 
 #ifdef ENABLE_HIP
@@ -56,7 +58,7 @@ struct hpmc_patch_args_t
                 const BoxDim& _box,
                 const unsigned int *_d_excell_idx,
                 const unsigned int *_d_excell_size,
-                const Index2D& _excli,
+                const unsigned int *_d_excell_offsets,
                 const Scalar _r_cut_patch,
                 const Scalar *_d_additive_cutoff,
                 const unsigned int *_d_update_order_by_ptl,
@@ -82,7 +84,7 @@ struct hpmc_patch_args_t
                   box(_box),
                   d_excell_idx(_d_excell_idx),
                   d_excell_size(_d_excell_size),
-                  excli(_excli),
+                  d_excell_offsets(_d_excell_offsets),
                   r_cut_patch(_r_cut_patch),
                   d_additive_cutoff(_d_additive_cutoff),
                   d_update_order_by_ptl(_d_update_order_by_ptl),
@@ -110,7 +112,7 @@ struct hpmc_patch_args_t
     const BoxDim& box;                //!< Current simulation box
     const unsigned int *d_excell_idx;       //!< Expanded cell list
     const unsigned int *d_excell_size;//!< Size of expanded cells
-    const Index2D& excli;             //!< Excell indexer
+    const unsigned int *d_excell_offsets; //!< Offset of each expanded cell
     const Scalar r_cut_patch;        //!< Global cutoff radius
     const Scalar *d_additive_cutoff; //!< Additive contribution to cutoff per type
     const unsigned int *d_update_order_by_ptl; //!< Order of the update sequence
@@ -184,6 +186,40 @@ class PatchEnergy
             return 0;
             }
 
+        //! evaluate the energies of a block of pairs that share particle i
+        /*! \param n Number of pairs
+            \param r_ij Vectors pointing from particle i to each particle j
+            \param type_i Integer type index of particle i
+            \param q_i Orientation quaternion of particle i
+            \param d_i Diameter of particle i
+            \param charge_i Charge of particle i
+            \param type_j Integer type indices of the particles j
+            \param q_j Orientation quaternions of the particles j
+            \param d_j Diameters of the particles j
+            \param charge_j Charges of the particles j
+            \param energy Energy of each pair (output)
+
+            The base class calls energy() for every pair. Derived classes may evaluate the whole block at once to
+            avoid the per-pair call overhead.
+        */
+        virtual void energyBatch(unsigned int n,
+            const vec3<float> *r_ij,
+            unsigned int type_i,
+            const quat<float>& q_i,
+            float d_i,
+            float charge_i,
+            const unsigned int *type_j,
+            const quat<float> *q_j,
+            const float *d_j,
+            const float *charge_j,
+            float *energy)
+            {
+            for (unsigned int k = 0; k < n; ++k)
+                {
+                energy[k] = this->energy(r_ij[k], type_i, q_i, d_i, charge_i, type_j[k], q_j[k], d_j[k], charge_j[k]);
+                }
+            }
+
         #ifdef ENABLE_HIP
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
@@ -205,6 +241,59 @@ class PatchEnergy
         #endif
     };
 
+//! Collects the pairs of one particle for a batched patch energy evaluation
+/*! Pairs are added in the order in which the serial code would evaluate them. evaluate() fills energy, so that callers
+    can accumulate the pair energies in the same order.
+*/
+struct PatchEnergyBatch
+    {
+    std::vector< vec3<float> > r_ij;    //!< Vectors pointing from particle i to each particle j
+    std::vector<unsigned int> type_j;   //!< Types of the particles j
+    std::vector< quat<float> > q_j;     //!< Orientations of the particles j
+    std::vector<float> d_j;             //!< Diameters of the particles j
+    std::vector<float> charge_j;        //!< Charges of the particles j
+    std::vector<unsigned int> idx_j;    //!< Indices of the particles j
+    std::vector<float> energy;          //!< Energy of each pair, set by evaluate()
+
+    //! Remove all pairs
+    void clear()
+        {
+        r_ij.clear();
+        type_j.clear();
+        q_j.clear();
+        d_j.clear();
+        charge_j.clear();
+        idx_j.clear();
+        }
+
+    //! Add a pair
+    void push_back(const vec3<float>& r, unsigned int t, const quat<float>& q, float d, float charge,
+                   unsigned int idx)
+        {
+        r_ij.push_back(r);
+        type_j.push_back(t);
+        q_j.push_back(q);
+        d_j.push_back(d);
+        charge_j.push_back(charge);
+        idx_j.push_back(idx);
+        }
+
+    //! Get the number of pairs
+    unsigned int size() const
+        {
+        return (unsigned int)r_ij.size();
+        }
+
+    //! Evaluate the energies of all pairs
+    void evaluate(PatchEnergy& patch, unsigned int type_i, const quat<float>& q_i, float d_i, float charge_i)
+        {
+        energy.resize(size());
+        if (size() > 0)
+            patch.energyBatch(size(), r_ij.data(), type_i, q_i, d_i, charge_i, type_j.data(), q_j.data(),
+                d_j.data(), charge_j.data(), energy.data());
+        }
+    };
+
 class PYBIND11_EXPORT IntegratorHPMC : public Integrator
     {
     public:
@@ -338,15 +427,78 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
             return m_nselect;
             }
 
+        //! Set whether the CPU sweep runs concurrently on a checkerboard of cells
+        /*! \param checkerboard true to enable the threaded checkerboard sweep
+        */
+        void setCheckerboard(bool checkerboard)
+            {
+            m_checkerboard = checkerboard;
+            }
+
+        //! Get whether the CPU sweep runs concurrently on a checkerboard of cells
+        bool getCheckerboard()
+            {
+            return m_checkerboard;
+            }
+
+        //! Set whether the GPU sizes the depletant insertion work per particle
+        /*! \param load_balance true to distribute depletant insertions over blocks by the local density
+        */
+        void setDepletantLoadBalance(bool load_balance)
+            {
+            m_depletant_load_balance = load_balance;
+            }
+
+        //! Get whether the GPU sizes the depletant insertion work per particle
+        bool getDepletantLoadBalance()
+            {
+            return m_depletant_load_balance;
+            }
+
+        //! Set whether the GPU avoids synchronizing with the host within a sweep
+        /*! \param sync_free true to check for overflows once per convergence iteration and read back counters lazily
+        */
+        void setSyncFree(bool sync_free)
+            {
+            m_sync_free = sync_free;
+            }
+
+        //! Get whether the GPU avoids synchronizing with the host within a sweep
+        bool getSyncFree()
+            {
+            return m_sync_free;
+            }
+
+        //! Set the buffer distance of the cached overlap candidates
+        /*! \param buffer Distance added to the candidate search radius, 0 disables the cache
+        */
+        void setNlistBuffer(Scalar buffer)
+            {
+            if (buffer < Scalar(0.0))
+                {
+                m_exec_conf->msg->error() << "nlist_buffer must not be negative" << std::endl;
+                throw std::runtime_error("Error setting HPMC parameters");
+                }
+            m_nlist_buffer = buffer;
+            }
+
+        //! Get the buffer distance of the cached overlap candidates
+        Scalar getNlistBuffer()
+            {
+            return m_nlist_buffer;
+            }
+
         //! Get performance in moves per second
         virtual double getMPS()
             {
+            updateDeferredCounters();
             return m_mps;
             }
 
         //! Reset statistics counters
         virtual void resetStats()
             {
+            updateDeferredCounters();
             ArrayHandle<hpmc_counters_t> h_counters(m_count_total, access_location::host, access_mode::read);
             m_count_run_start = h_counters.data[0];
             m_clock = ClockSource();
@@ -359,11 +511,22 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
             }
 
         //! Count the number of particle overlaps
-        /*! \param timestep current step
-            \param early_exit exit at first overlap found if true
+        /*! \param early_exit exit at first overlap found if true
             \returns number of overlaps if early_exit=false, 1 if early_exit=true
         */
-        virtual unsigned int countOverlaps(bool early_exit)
+        unsigned int countOverlaps(bool early_exit)
+            {
+            if (early_exit)
+                return countOverlapsUpTo(0) ? 1 : 0;
+            return countOverlapsUpTo(std::numeric_limits<unsigned int>::max());
+            }
+
+        //! Count the number of particle overlaps, stopping once there are more than \a max_count
+        /*! \param max_count Number of overlaps to count exactly
+            \returns the number of overlaps if it is at most \a max_count, otherwise some number larger than
+                \a max_count
+        */
+        virtual unsigned int countOverlapsUpTo(unsigned int max_count)
             {
             return 0;
             }
@@ -417,6 +580,9 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         //! Method to scale the box
         virtual bool attemptBoxResize(uint64_t timestep, const BoxDim& new_box);
 
+        //! Scale the particle positions with the box and set the new box
+        virtual void scaleBox(const BoxDim& new_box);
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange();
 
@@ -494,6 +660,10 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
     protected:
         unsigned int m_translation_move_probability;     //!< Fraction of moves that are translation moves.
         unsigned int m_nselect;                     //!< Number of particles to select for trial moves
+        bool m_checkerboard;                        //!< True to sweep cells concurrently on the CPU
+        bool m_depletant_load_balance;              //!< True to size the depletant work per particle on the GPU
+        bool m_sync_free;                           //!< True to avoid host synchronizations within a GPU sweep
+        Scalar m_nlist_buffer;                      //!< Buffer of the cached overlap candidates (0 to disable)
 
         GPUVector<Scalar> m_d;                      //!< Maximum move displacement by type
         GPUVector<Scalar> m_a;                      //!< Maximum angular displacement by type
@@ -513,6 +683,8 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         bool m_patch_log;                           //!< If true, only use patch energy for logging
 
         bool m_past_first_run;                      //!< Flag to test if the first run() has started
+
+        hpmc_counters_t m_count_step_start;            //!< Count saved at the start of the last step
         //! Update the nominal width of the cells
         /*! This method is virtual so that derived classes can set appropriate widths
             (for example, some may want max diameter while others may want a buffer distance).
@@ -527,6 +699,14 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
             return Scalar(0.0);
             }
 
+        //! Finish reading back counters that were left on the device
+        /*! Derived classes that defer reading the counters back to the host override this method. It is called
+            before the counters or the moves per second are accessed.
+        */
+        virtual void updateDeferredCounters()
+            {
+            }
+
         #ifdef ENABLE_MPI
         //! Return the requested communication flags for ghost particles
         virtual CommFlags getCommFlags(uint64_t timestep)
@@ -538,7 +718,6 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
 
     private:
         hpmc_counters_t m_count_run_start;             //!< Count saved at run() start
-        hpmc_counters_t m_count_step_start;            //!< Count saved at the start of the last step
 
         #ifdef ENABLE_MPI
         bool m_communicator_ghost_width_connected;     //!< True if we have connected to Communicator's ghost layer width signal
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
 
 #include "hoomd/Integrator.h"
 #include "HPMCPrecisionSetup.h"
@@ -26,6 +27,8 @@
 #include "hoomd/GSDShapeSpecWriter.h"
 #include "ShapeSpheropolyhedron.h"
 
+#include <atomic>
+
 #ifdef ENABLE_TBB
 #include <thread>
 #include <tbb/blocked_range.h>
@@ -263,6 +266,28 @@ class IntegratorHPMCMono : public IntegratorHPMC
             this->m_external_base = (ExternalField*)external.get();
             }
 
+        //! Set the patch energy
+        virtual void setPatchEnergy(std::shared_ptr< PatchEnergy > patch)
+            {
+            IntegratorHPMC::setPatchEnergy(patch);
+            invalidatePatchCache();
+            }
+
+        //! Set whether to cache the patch energy of every particle
+        /*! \param cache true to cache the pair energies of each particle between trial moves
+        */
+        void setPatchEnergyCache(bool cache)
+            {
+            m_patch_cache = cache;
+            invalidatePatchCache();
+            }
+
+        //! Get whether to cache the patch energy of every particle
+        bool getPatchEnergyCache()
+            {
+            return m_patch_cache;
+            }
+
         //! Get a list of logged quantities
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -293,8 +318,8 @@ class IntegratorHPMCMono : public IntegratorHPMC
             return m_depletant_idx;
             }
 
-        //! Count overlaps with the option to exit early at the first detected overlap
-        virtual unsigned int countOverlaps(bool early_exit);
+        //! Count overlaps, stopping once there are more than max_count
+        virtual unsigned int countOverlapsUpTo(unsigned int max_count);
 
         //! Return a vector that is an unwrapped overlap map
         virtual std::vector<std::pair<unsigned int, unsigned int> > mapOverlaps();
@@ -495,15 +520,47 @@ class IntegratorHPMCMono : public IntegratorHPMC
         bool m_hasOrientation;                               //!< true if there are any orientable particles in the system
 
         std::shared_ptr< ExternalFieldMono<Shape> > m_external;//!< External Field
+        PatchEnergyBatch m_patch_batch;             //!< Pairs of the current trial move for the patch energy
         detail::AABBTree m_aabb_tree;               //!< Bounding volume hierarchy for overlap checks
         detail::AABB* m_aabbs;                      //!< list of AABBs, one per particle
         unsigned int m_aabbs_capacity;              //!< Capacity of m_aabbs list
         bool m_aabb_tree_invalid;                   //!< Flag if the aabb tree has been invalidated
+        bool m_aabb_tree_stale;                     //!< Flag if the particles moved since the tree was last fit
+        std::vector< vec3<Scalar> > m_aabb_ref_pos; //!< Particle positions when they were last placed in the tree
+        unsigned int m_aabb_n_reinserted;           //!< Number of reinsertions since the last full build
+
+        std::vector<unsigned int> m_nlist_head;     //!< Index of the first cached candidate of each particle
+        std::vector<uint2> m_nlist;                 //!< Cached overlap candidates (particle index, image index)
+        std::vector< vec3<Scalar> > m_nlist_ref_pos; //!< Unwrapped particle positions when the candidates were cached
+        std::vector<int3> m_nlist_ref_image;        //!< Particle images when the candidates were cached
+        Scalar m_nlist_cached_buffer;               //!< Buffer the candidates were cached with
+        bool m_nlist_valid;                         //!< True when the cached candidates can be used
+
+        typedef std::vector< std::pair<unsigned int, float> > PatchPairs; //!< Patch energies with each neighbor
+
+        bool m_patch_cache;                         //!< True to cache the patch energy of every particle
+        std::vector<PatchPairs> m_patch_cache_pairs; //!< Cached patch energies of each particle with its neighbors
+        std::vector<bool> m_patch_cache_valid;      //!< True when the cached energies of a particle are current
+        PatchPairs m_patch_cache_new;               //!< Patch energies of the current trial configuration
+        std::vector<Scalar4> m_patch_cache_postype; //!< Positions and types the cached energies refer to
+        std::vector<Scalar4> m_patch_cache_orientation; //!< Orientations the cached energies refer to
+        std::vector<Scalar2> m_patch_cache_diameter_charge; //!< Diameters and charges the cached energies refer to
 
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
         Index2D m_overlap_idx;                      //!!< Indexer for interaction matrix
 
+        /* Hard sphere sweep related data members */
+
+        std::vector<unsigned int> m_sphere_cell_size;  //!< Number of particles per cell
+        std::vector<unsigned int> m_sphere_cell_idx;   //!< Particle indices per cell, with a fixed capacity per cell
+        std::vector<Scalar> m_sphere_cell_x;           //!< x coordinates of the particles per cell
+        std::vector<Scalar> m_sphere_cell_y;           //!< y coordinates of the particles per cell
+        std::vector<Scalar> m_sphere_cell_z;           //!< z coordinates of the particles per cell
+        std::vector<unsigned int> m_sphere_cell_type;  //!< Types of the particles per cell
+        std::vector<unsigned int> m_sphere_cell_of;    //!< Cell of each particle
+        std::vector<OverlapReal> m_sphere_rsq;         //!< Squared contact distance per type pair, 0 if not checked
+
         /* Depletants related data members */
 
         Index2D m_depletant_idx;                    //!< Indexer for deplepant type pairs
@@ -530,6 +587,43 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Limit the maximum move distances
         virtual void limitMoveDistances();
 
+        //! Test whether the threaded checkerboard sweep can be used for this step
+        bool useCheckerboard(bool has_depletants);
+
+        //! Test whether the hard sphere sweep can be used for this step
+        /*! Only IntegratorHPMCMono<ShapeSphere> implements the hard sphere sweep.
+        */
+        bool useHardSphereSweep(bool has_depletants)
+            {
+            return false;
+            }
+
+        //! Perform all trial moves of one step with the hard sphere sweep
+        void updateHardSphere(uint64_t timestep, const unsigned int *h_overlaps, hpmc_counters_t& counters)
+            {
+            }
+
+        //! Cache the overlap candidates of every particle, if needed
+        void updateNlist();
+
+        //! Mark the cached patch energies of all particles as out of date
+        void invalidatePatchCache()
+            {
+            m_patch_cache_valid.clear();
+            }
+
+        //! Test whether the cached patch energies can be used for this step and invalidate those out of date
+        bool checkPatchCache();
+
+        //! Update the cached patch energies after a trial move of particle i was accepted
+        void acceptPatchCache(unsigned int i);
+
+        //! Store the particle state that the cached patch energies refer to
+        void storePatchCacheState();
+
+        //! Perform all trial moves of one step concurrently on a checkerboard of cells
+        void updateCheckerboard(uint64_t timestep, const unsigned int *h_overlaps, hpmc_counters_t& counters);
+
         //! callback so that the box change signal can invalidate the image list
         virtual void slotBoxChanged()
             {
@@ -538,12 +632,14 @@ class IntegratorHPMCMono : public IntegratorHPMC
             // anything that changes the box (i.e. NPT, box_resize) is also moving the particles,
             // so use it as a sign to rebuild the AABB tree
             m_aabb_tree_invalid = true;
+            invalidatePatchCache();
             }
 
         //! callback so that the particle sort signal can invalidate the AABB tree
         virtual void slotSorted()
             {
             m_aabb_tree_invalid = true;
+            invalidatePatchCache();
             }
     };
 
@@ -584,6 +680,13 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     m_aabbs = NULL;
     m_aabbs_capacity = 0;
     m_aabb_tree_invalid = true;
+    m_aabb_tree_stale = false;
+    m_aabb_n_reinserted = 0;
+
+    m_nlist_cached_buffer = 0;
+    m_nlist_valid = false;
+
+    m_patch_cache = false;
 
     m_depletant_idx = Index2D(this->m_pdata->getNTypes());
     m_fugacity.resize(m_depletant_idx.getNumElements(), 0.0);
@@ -877,6 +980,8 @@ void IntegratorHPMCMono<Shape>::slotNumTypesChange()
     m_implicit_count_run_start.resize(m_depletant_idx.getNumElements());
     m_implicit_count_step_start.resize(m_depletant_idx.getNumElements());
 
+    invalidatePatchCache();
+
     // call parent class method
     IntegratorHPMC::slotNumTypesChange();
     }
@@ -907,13 +1012,6 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
     m_update_order.resize(m_pdata->getN());
     m_update_order.shuffle(timestep, m_sysdef->getSeed(), m_exec_conf->getRank());
 
-    // update the AABB Tree
-    buildAABBTree();
-    // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
-    limitMoveDistances();
-    // update the image list
-    updateImageList();
-
     bool has_depletants = false;
     for (unsigned int i = 0; i < m_depletant_idx.getNumElements(); ++i)
         {
@@ -924,6 +1022,19 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
             }
         }
 
+    // the checkerboard and hard sphere sweeps find neighbors in their own cell lists
+    bool checkerboard = useCheckerboard(has_depletants);
+    bool hard_sphere = !checkerboard && useHardSphereSweep(has_depletants);
+
+    // update the AABB Tree
+    if (!checkerboard && !hard_sphere)
+        buildAABBTree();
+    // limit m_d entries so that particles cannot possibly wander more than one box image in one time step
+    limitMoveDistances();
+    // update the image list
+    if (!checkerboard && !hard_sphere)
+        updateImageList();
+
     // Combine the three seeds to generate RNG for poisson distribution
     hoomd::RandomGenerator rng_depletants(hoomd::Seed(hoomd::RNGIdentifier::HPMCDepletants,
                                                       timestep,
@@ -942,11 +1053,34 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
+    // the checkerboard sweep performs all nselect trial moves per particle
+    unsigned int nselect_serial = m_nselect;
+    if (checkerboard)
+        {
+        updateCheckerboard(timestep, h_overlaps.data, counters);
+        nselect_serial = 0;
+        }
+    else if (hard_sphere)
+        {
+        updateHardSphere(timestep, h_overlaps.data, counters);
+        nselect_serial = 0;
+        }
+
+    // the serial sweep reuses the patch energies of the current configuration between trial moves
+    const bool use_patch_cache = nselect_serial > 0 && checkPatchCache();
+
+    // half the buffer of the cached overlap candidates, squared
+    const Scalar nlist_max_disp_sq = Scalar(0.25)*m_nlist_buffer*m_nlist_buffer;
+
     // loop over local particles nselect times
-    for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
+    for (unsigned int i_nselect = 0; i_nselect < nselect_serial; i_nselect++)
         {
+        // recache the overlap candidates if particles moved too far
+        updateNlist();
+
         // access particle data and system box
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
@@ -1040,106 +1174,107 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
             // patch + field interaction deltaU
             double patch_field_energy_diff = 0;
 
-            // check for overlaps with neighboring particle's positions (also calculate the new energy)
-            // All image boxes (including the primary)
+            // pairs within the patch cutoff in the new configuration, evaluated only if there is no overlap
+            m_patch_batch.clear();
+
             const unsigned int n_images = (unsigned int)m_image_list.size();
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+
+            // test the trial configuration of i against particle j in image cur_image, shifted by r_shift, and
+            // queue the patch interaction if they do not overlap
+            auto check_overlap_j = [&](unsigned int j, unsigned int cur_image, const vec3<Scalar>& r_shift)
                 {
                 vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i_image);
 
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                Scalar4 postype_j;
+                Scalar4 orientation_j;
+
+                // handle j==i situations
+                if ( j != i )
                     {
-                    if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    // load the position and orientation of the j particle
+                    postype_j = h_postype.data[j];
+                    orientation_j = h_orientation.data[j];
+                    }
+                else
+                    {
+                    if (cur_image == 0)
                         {
-                        if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // in the first image, skip i == j
+                        return false;
+                        }
+                    else
+                        {
+                        // If this is particle i and we are in an outside image, use the translated position and orientation
+                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+                        orientation_j = quat_to_scalar4(shape_i.orientation);
+                        }
+                    }
 
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
+                // put particles in coordinate system of particle i
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image + r_shift;
 
-                                // handle j==i situations
-                                if ( j != i )
-                                    {
-                                    // load the position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
-                                    }
-                                else
-                                    {
-                                    if (cur_image == 0)
-                                        {
-                                        // in the first image, skip i == j
-                                        continue;
-                                        }
-                                    else
-                                        {
-                                        // If this is particle i and we are in an outside image, use the translated position and orientation
-                                        postype_j = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
-                                        orientation_j = quat_to_scalar4(shape_i.orientation);
-                                        }
-                                    }
-
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
 
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+                Scalar rcut = 0.0;
+                if (m_patch)
+                    rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
 
-                                Scalar rcut = 0.0;
-                                if (m_patch)
-                                    rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
+                counters.overlap_checks++;
+                if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
+                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                    {
+                    return true;
+                    }
+                else if (m_patch && !m_patch_log && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
+                    {
+                    m_patch_batch.push_back(vec3<float>(r_ij),
+                                            typ_j,
+                                            quat<float>(orientation_j),
+                                            float(h_diameter.data[j]),
+                                            float(h_charge.data[j]),
+                                            j);
+                    }
+                return false;
+                };
 
-                                counters.overlap_checks++;
-                                if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
-                                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
-                                    {
-                                    overlap = true;
-                                    break;
-                                    }
-                                else if (m_patch && !m_patch_log && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
-                                    {
-                                    // deltaU = U_old - U_new: subtract energy of new configuration
-                                    patch_field_energy_diff -= m_patch->energy(r_ij, typ_i,
-                                                               quat<float>(shape_i.orientation),
-                                                               float(h_diameter.data[i]),
-                                                               float(h_charge.data[i]),
-                                                               typ_j,
-                                                               quat<float>(orientation_j),
-                                                               float(h_diameter.data[j]),
-                                                               float(h_charge.data[j])
-                                                               );
-                                    }
-                                }
-                            }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                        }
+            // the cached candidates hold every particle that can overlap with a trial position within half the
+            // buffer of the position at which they were cached
+            bool use_nlist = false;
+            if (m_nlist_valid)
+                {
+                vec3<Scalar> dr = box.shift(pos_i, h_image.data[i]) - m_nlist_ref_pos[i];
+                use_nlist = dot(dr, dr) <= nlist_max_disp_sq;
+                }
 
-                    if (overlap)
-                        break;
-                    }  // end loop over AABB nodes
+            if (use_nlist)
+                {
+                const int3 dimg_i = h_image.data[i] - m_nlist_ref_image[i];
+                for (unsigned int k = m_nlist_head[i]; k < m_nlist_head[i+1]; k++)
+                    {
+                    unsigned int j = m_nlist[k].x;
 
-                if (overlap)
-                    break;
-                } // end loop over images
+                    // account for particles wrapped through the boundaries since the candidates were cached
+                    int3 dimg = h_image.data[j] - m_nlist_ref_image[j] - dimg_i;
+                    vec3<Scalar> r_shift(0,0,0);
+                    if (dimg.x || dimg.y || dimg.z)
+                        r_shift = box.shift(r_shift, dimg);
 
-            // calculate old patch energy only if m_patch not NULL and no overlaps
-            if (m_patch && !m_patch_log && !overlap)
+                    if (check_overlap_j(j, m_nlist[k].y, r_shift))
+                        {
+                        overlap = true;
+                        break;
+                        }
+                    }
+                }
+            else
                 {
+                // check for overlaps with neighboring particle's positions (also calculate the new energy)
+                // All image boxes (including the primary)
                 for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                     {
-                    vec3<Scalar> pos_i_image = pos_old + m_image_list[cur_image];
+                    vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
                     detail::AABB aabb = aabb_i_local;
                     aabb.translate(pos_i_image);
 
@@ -1152,52 +1287,12 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
                                 {
                                 for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                                     {
-                                    // read in its position and orientation
                                     unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
-
-                                    // handle j==i situations
-                                    if ( j != i )
-                                        {
-                                        // load the position and orientation of the j particle
-                                        postype_j = h_postype.data[j];
-                                        orientation_j = h_orientation.data[j];
-                                        }
-                                    else
+                                    if (check_overlap_j(j, cur_image, vec3<Scalar>(0,0,0)))
                                         {
-                                        if (cur_image == 0)
-                                            {
-                                            // in the first image, skip i == j
-                                            continue;
-                                            }
-                                        else
-                                            {
-                                            // If this is particle i and we are in an outside image, use the translated position and orientation
-                                            postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
-                                            orientation_j = quat_to_scalar4(shape_old.orientation);
-                                            }
+                                        overlap = true;
+                                        break;
                                         }
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
-
-                                    Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
-
-                                    // deltaU = U_old - U_new: add energy of old configuration
-                                    if (dot(r_ij,r_ij) <= rcut*rcut)
-                                        patch_field_energy_diff += m_patch->energy(r_ij,
-                                                                   typ_i,
-                                                                   quat<float>(orientation_i),
-                                                                   float(h_diameter.data[i]),
-                                                                   float(h_charge.data[i]),
-                                                                   typ_j,
-                                                                   quat<float>(orientation_j),
-                                                                   float(h_diameter.data[j]),
-                                                                   float(h_charge.data[j]));
                                     }
                                 }
                             }
@@ -1206,8 +1301,126 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
                             // skip ahead
                             cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
                             }
+
+                        if (overlap)
+                            break;
                         }  // end loop over AABB nodes
+
+                    if (overlap)
+                        break;
                     } // end loop over images
+                }
+
+            // calculate old patch energy only if m_patch not NULL and no overlaps
+            if (m_patch && !m_patch_log && !overlap)
+                {
+                // deltaU = U_old - U_new: subtract energy of new configuration
+                m_patch_batch.evaluate(*m_patch, typ_i, quat<float>(shape_i.orientation),
+                    float(h_diameter.data[i]), float(h_charge.data[i]));
+                for (unsigned int k = 0; k < m_patch_batch.size(); ++k)
+                    patch_field_energy_diff -= m_patch_batch.energy[k];
+
+                if (use_patch_cache)
+                    {
+                    // keep the pairs of the new configuration in case the move is accepted
+                    m_patch_cache_new.clear();
+                    for (unsigned int k = 0; k < m_patch_batch.size(); ++k)
+                        m_patch_cache_new.push_back(std::make_pair(m_patch_batch.idx_j[k], m_patch_batch.energy[k]));
+                    }
+
+                if (use_patch_cache && m_patch_cache_valid[i])
+                    {
+                    // deltaU = U_old - U_new: add the cached energy of the old configuration
+                    for (const auto& pair : m_patch_cache_pairs[i])
+                        patch_field_energy_diff += pair.second;
+                    }
+                else
+                    {
+                    m_patch_batch.clear();
+                    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+                        {
+                        vec3<Scalar> pos_i_image = pos_old + m_image_list[cur_image];
+                        detail::AABB aabb = aabb_i_local;
+                        aabb.translate(pos_i_image);
+
+                        // stackless search
+                        for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                            {
+                            if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                                {
+                                if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                                    {
+                                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                        {
+                                        // read in its position and orientation
+                                        unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                                        Scalar4 postype_j;
+                                        Scalar4 orientation_j;
+
+                                        // handle j==i situations
+                                        if ( j != i )
+                                            {
+                                            // load the position and orientation of the j particle
+                                            postype_j = h_postype.data[j];
+                                            orientation_j = h_orientation.data[j];
+                                            }
+                                        else
+                                            {
+                                            if (cur_image == 0)
+                                                {
+                                                // in the first image, skip i == j
+                                                continue;
+                                                }
+                                            else
+                                                {
+                                                // If this is particle i and we are in an outside image, use the translated position and orientation
+                                                postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
+                                                orientation_j = quat_to_scalar4(shape_old.orientation);
+                                                }
+                                            }
+
+                                        // put particles in coordinate system of particle i
+                                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                        Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+
+                                        Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
+
+                                        if (dot(r_ij,r_ij) <= rcut*rcut)
+                                            m_patch_batch.push_back(vec3<float>(r_ij),
+                                                                    typ_j,
+                                                                    quat<float>(orientation_j),
+                                                                    float(h_diameter.data[j]),
+                                                                    float(h_charge.data[j]),
+                                                                    j);
+                                        }
+                                    }
+                                }
+                            else
+                                {
+                                // skip ahead
+                                cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                                }
+                            }  // end loop over AABB nodes
+                        } // end loop over images
+
+                    // deltaU = U_old - U_new: add energy of old configuration
+                    m_patch_batch.evaluate(*m_patch, typ_i, quat<float>(orientation_i),
+                        float(h_diameter.data[i]), float(h_charge.data[i]));
+                    for (unsigned int k = 0; k < m_patch_batch.size(); ++k)
+                        patch_field_energy_diff += m_patch_batch.energy[k];
+
+                    if (use_patch_cache)
+                        {
+                        // cache the pairs of the old configuration
+                        m_patch_cache_pairs[i].clear();
+                        for (unsigned int k = 0; k < m_patch_batch.size(); ++k)
+                            m_patch_cache_pairs[i].push_back(std::make_pair(m_patch_batch.idx_j[k],
+                                                                            m_patch_batch.energy[k]));
+                        m_patch_cache_valid[i] = true;
+                        }
+                    }
                 } // end if (m_patch)
 
             // Add external energetic contribution
@@ -1242,101 +1455,596 @@ void IntegratorHPMCMono<Shape>::update(uint64_t timestep)
                         counters.rotate_accept_count++;
                     }
 
-                // update the position of the particle in the tree for future updates
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i);
-                m_aabb_tree.update(i, aabb);
+                // update the position of the particle in the tree for future updates
+                detail::AABB aabb = aabb_i_local;
+                aabb.translate(pos_i);
+                m_aabb_tree.update(i, aabb);
+
+                // a particle that left the buffer may be missing from the cached candidates of others
+                if (!use_nlist)
+                    m_nlist_valid = false;
+
+                if (use_patch_cache)
+                    acceptPatchCache(i);
+
+                // update position of particle
+                h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
+
+                if (shape_i.hasOrientation())
+                    {
+                    h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                    }
+
+                // let the external field keep its cached energy current
+                if (m_external)
+                    m_external->acceptMove(i);
+
+                // store new seed
+                if (has_depletants)
+                    h_vel.data[i].x = __int_as_scalar(seed_i_new);
+                }
+            else
+                {
+                if (!shape_i.ignoreStatistics())
+                    {
+                    // increment reject counter
+                    if (move_type_translate)
+                        counters.translate_reject_count++;
+                    else
+                        counters.rotate_reject_count++;
+                    }
+                }
+            } // end loop over all particles
+        } // end loop over nselect
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        // wrap particles back into box
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            {
+            box.wrap(h_postype.data[i], h_image.data[i]);
+            }
+        }
+
+    if (use_patch_cache)
+        storePatchCacheState();
+
+    // perform the grid shift
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+        // precalculate the grid shift
+        hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoShift, timestep, this->m_sysdef->getSeed()),
+                                   hoomd::Counter());
+        Scalar3 shift = make_scalar3(0,0,0);
+        hoomd::UniformDistribution<Scalar> uniform(-m_nominal_width/Scalar(2.0),m_nominal_width/Scalar(2.0));
+        shift.x = uniform(rng);
+        shift.y = uniform(rng);
+        if (this->m_sysdef->getNDimensions() == 3)
+            {
+            shift.z = uniform(rng);
+            }
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            {
+            // read in the current position and orientation
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> r_i = vec3<Scalar>(postype_i); // translation from local to global coordinates
+            r_i += vec3<Scalar>(shift);
+            h_postype.data[i] = vec_to_scalar4(r_i, postype_i.w);
+            box.wrap(h_postype.data[i], h_image.data[i]);
+            }
+        this->m_pdata->translateOrigin(shift);
+        }
+    #endif
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    // migrate and exchange particles
+    communicate(true);
+
+    // all particle have been moved, the aabb tree needs to be refit
+    m_aabb_tree_stale = true;
+
+    // set current MPS value
+    hpmc_counters_t run_counters = getCounters(1);
+    double cur_time = double(m_clock.getTime()) / Scalar(1e9);
+    m_mps = double(run_counters.getNMoves()) / cur_time;
+    }
+
+/*! The serial sweep tests trial moves against the cached candidates instead of traversing the AABB tree, in the spirit
+    of the buffered MD neighbor list. The candidates of a particle are all particles (and periodic images) within the
+    maximum core diameter plus nlist_buffer of it. They remain complete as long as no particle moved by more than half
+    the buffer since they were cached, so updateNlist() only caches them again when a particle moved further, or when
+    the image list, the number of particles, or the buffer changed. Trial moves that leave the buffer fall back to the
+    tree.
+
+    The cache is disabled when nlist_buffer is 0, with patch energies (which also need the pairs in the old
+    configuration), and with MPI domain decomposition (where ghost particles are exchanged every step).
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::updateNlist()
+    {
+    bool enable = m_nlist_buffer > Scalar(0.0) && (!m_patch || m_patch_log);
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        enable = false;
+    #endif
+
+    if (!enable)
+        {
+        m_nlist_valid = false;
+        return;
+        }
+
+    const unsigned int N = m_pdata->getN();
+    const BoxDim& box = m_pdata->getBox();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+
+    if (m_nlist_valid && (m_nlist_ref_pos.size() != N || m_nlist_cached_buffer != m_nlist_buffer))
+        m_nlist_valid = false;
+
+    if (m_nlist_valid)
+        {
+        const Scalar max_disp_sq = Scalar(0.25)*m_nlist_buffer*m_nlist_buffer;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            vec3<Scalar> dr = box.shift(vec3<Scalar>(h_postype.data[i]), h_image.data[i]) - m_nlist_ref_pos[i];
+            if (dot(dr, dr) > max_disp_sq)
+                {
+                m_nlist_valid = false;
+                break;
+                }
+            }
+        }
+
+    if (m_nlist_valid)
+        return;
+
+    m_exec_conf->msg->notice(8) << "Caching HPMC overlap candidates: " << N << " ptls" << std::endl;
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC nlist");
+
+    const Scalar r_list = getMaxCoreDiameter() + m_nlist_buffer;
+    const Scalar r_list_sq = r_list*r_list;
+    const detail::AABB aabb_local(vec3<Scalar>(0,0,0), r_list);
+    const unsigned int n_images = (unsigned int)m_image_list.size();
+
+    m_nlist.clear();
+    m_nlist_head.resize(N+1);
+    m_nlist_ref_pos.resize(N);
+    m_nlist_ref_image.resize(N);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        m_nlist_head[i] = (unsigned int)m_nlist.size();
+        vec3<Scalar> pos_i(h_postype.data[i]);
+
+        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+            {
+            vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+            detail::AABB aabb = aabb_local;
+            aabb.translate(pos_i_image);
+
+            // stackless search
+            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                {
+                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    {
+                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                        {
+                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                            {
+                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                            if (i == j && cur_image == 0)
+                                continue;
+
+                            vec3<Scalar> r_ij = vec3<Scalar>(h_postype.data[j]) - pos_i_image;
+                            if (dot(r_ij, r_ij) <= r_list_sq)
+                                m_nlist.push_back(make_uint2(j, cur_image));
+                            }
+                        }
+                    }
+                else
+                    {
+                    // skip ahead
+                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                    }
+                }
+            }
+
+        m_nlist_ref_pos[i] = box.shift(pos_i, h_image.data[i]);
+        m_nlist_ref_image[i] = h_image.data[i];
+        }
+    m_nlist_head[N] = (unsigned int)m_nlist.size();
+
+    m_nlist_cached_buffer = m_nlist_buffer;
+    m_nlist_valid = true;
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+    }
+
+/*! \returns true when the serial sweep can use the cached patch energies
+
+    With patch_energy_cache enabled, every particle keeps the patch energies of its current configuration with each
+    of its neighbors. A trial move then only evaluates the energies of the new configuration, and accepted moves
+    update the cache of the moved particle and its old and new neighbors. The cached energies are discarded when the
+    box, the particle order, the number of types, or the patch energy changes, and when other operations modified
+    the positions, orientations, diameters, or charges since the last step. Changes to the parameters of the patch
+    energy itself are not detected.
+
+    The cache is not used with MPI domain decomposition, where the ghost particles are exchanged every step.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::checkPatchCache()
+    {
+    bool enable = m_patch_cache && m_patch && !m_patch_log;
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        enable = false;
+    #endif
+
+    const unsigned int N = m_pdata->getN();
+    if (!enable || m_patch_cache_valid.size() != N || m_patch_cache_postype.size() != N)
+        {
+        m_patch_cache_valid.assign(N, false);
+        m_patch_cache_pairs.resize(N);
+        return enable;
+        }
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+    auto equal = [](const Scalar4& a, const Scalar4& b)
+        {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+        };
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (!equal(h_postype.data[i], m_patch_cache_postype[i])
+            || !equal(h_orientation.data[i], m_patch_cache_orientation[i])
+            || h_diameter.data[i] != m_patch_cache_diameter_charge[i].x
+            || h_charge.data[i] != m_patch_cache_diameter_charge[i].y)
+            {
+            m_exec_conf->msg->notice(8) << "Particles changed outside of HPMC, discarding cached patch energies"
+                                        << std::endl;
+            m_patch_cache_valid.assign(N, false);
+            break;
+            }
+        }
+
+    return true;
+    }
+
+/*! \param i Index of the particle whose trial move was accepted
+
+    The pairs of the new configuration are in m_patch_cache_new. Particles whose cache is out of date are left alone,
+    they recompute their energies at their next trial move.
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::acceptPatchCache(unsigned int i)
+    {
+    // remove the pairs of the old configuration from the neighbors
+    for (const auto& pair : m_patch_cache_pairs[i])
+        {
+        unsigned int j = pair.first;
+        if (j == i || !m_patch_cache_valid[j])
+            continue;
+
+        PatchPairs& pairs_j = m_patch_cache_pairs[j];
+        pairs_j.erase(std::remove_if(pairs_j.begin(), pairs_j.end(),
+                                     [i](const std::pair<unsigned int, float>& p) { return p.first == i; }),
+                      pairs_j.end());
+        }
+
+    // and add the pairs of the new one
+    for (const auto& pair : m_patch_cache_new)
+        {
+        unsigned int j = pair.first;
+        if (j != i && m_patch_cache_valid[j])
+            m_patch_cache_pairs[j].push_back(std::make_pair(i, pair.second));
+        }
+
+    m_patch_cache_pairs[i] = m_patch_cache_new;
+    m_patch_cache_valid[i] = true;
+    }
+
+template <class Shape>
+void IntegratorHPMCMono<Shape>::storePatchCacheState()
+    {
+    const unsigned int N = m_pdata->getN();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+    m_patch_cache_postype.assign(h_postype.data, h_postype.data + N);
+    m_patch_cache_orientation.assign(h_orientation.data, h_orientation.data + N);
+    m_patch_cache_diameter_charge.resize(N);
+    for (unsigned int i = 0; i < N; i++)
+        m_patch_cache_diameter_charge[i] = make_scalar2(h_diameter.data[i], h_charge.data[i]);
+    }
+
+/*! \param has_depletants true when any depletant fugacity is non-zero
+    \returns true when the checkerboard sweep is enabled and supports the current system
+
+    The checkerboard sweep only tests hard particle overlaps between neighboring cells. It falls back to the serial
+    sweep with depletants, patch energies, external fields, MPI domain decomposition, and boxes that are too small for
+    four cells per direction.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::useCheckerboard(bool has_depletants)
+    {
+    #ifdef ENABLE_TBB
+    if (!m_checkerboard || has_depletants || m_patch || m_external)
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
+
+    Scalar width = getMaxCoreDiameter();
+    if (width <= Scalar(0.0))
+        return false;
+
+    Scalar3 npd = m_pdata->getBox().getNearestPlaneDistance();
+    if (npd.x < Scalar(4.0)*width || npd.y < Scalar(4.0)*width
+        || (m_sysdef->getNDimensions() == 3 && npd.z < Scalar(4.0)*width))
+        return false;
+
+    return true;
+    #else
+    return false;
+    #endif
+    }
+
+/*! \param timestep Current time step
+    \param h_overlaps Interaction matrix
+    \param counters Counters to add the move statistics to
+
+    The box is divided into an even number of cells per direction, each at least one maximum core diameter wide,
+    with a random offset every step. Cells are grouped into 8 (4 in 2D) sets so that no two cells in a set are
+    adjacent. For every set in a random order, the cells of the set are swept concurrently. Particles in a cell are
+    moved in the shuffled update order and moves that leave the cell are rejected. Neighbors of active cells do not
+    move while the set is swept, so each cell sees a static environment and every sweep satisfies detailed balance,
+    as in the GPU implementation.
+
+    Trial moves use the same random number streams as the serial sweep.
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::updateCheckerboard(uint64_t timestep,
+                                                   const unsigned int *h_overlaps,
+                                                   hpmc_counters_t& counters)
+    {
+    #ifdef ENABLE_TBB
+    const BoxDim& box = m_pdata->getBox();
+    unsigned int ndim = m_sysdef->getNDimensions();
+    const unsigned int N = m_pdata->getN();
+    uint16_t seed = m_sysdef->getSeed();
+
+    // choose an even number of cells per direction, no narrower than the widest particle
+    Scalar width = getMaxCoreDiameter();
+    Scalar3 npd = box.getNearestPlaneDistance();
+    unsigned int dim[3];
+    dim[0] = ((unsigned int)(npd.x / width)) & ~1u;
+    dim[1] = ((unsigned int)(npd.y / width)) & ~1u;
+    dim[2] = (ndim == 3) ? (((unsigned int)(npd.z / width)) & ~1u) : 1;
+
+    // limit the number of cells for small particles, wider cells are always valid
+    while ((unsigned long)dim[0]*dim[1]*dim[2] > 2*(unsigned long)N + 64)
+        {
+        unsigned int d = (dim[0] >= dim[1]) ? 0 : 1;
+        if (ndim == 3 && dim[2] > dim[d])
+            d = 2;
+        if (dim[d] <= 4)
+            break;
+        dim[d] -= 2;
+        }
+    Index3D cell_idx(dim[0], dim[1], dim[2]);
+
+    // randomly shift the cell grid so that particles can cross the cell boundaries
+    hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoCheckerboard, timestep, seed),
+                               hoomd::Counter(m_exec_conf->getRank()));
+    hoomd::UniformDistribution<Scalar> uniform(Scalar(0.0), Scalar(1.0));
+    Scalar offset[3];
+    offset[0] = uniform(rng);
+    offset[1] = uniform(rng);
+    offset[2] = (ndim == 3) ? uniform(rng) : Scalar(0.0);
+
+    auto get_cell = [&](const vec3<Scalar>& r)
+        {
+        Scalar3 f = box.makeFraction(vec_to_scalar3(r));
+        Scalar f_i[3] = {f.x, f.y, f.z};
+        int c[3] = {0, 0, 0};
+        for (unsigned int d = 0; d < ndim; d++)
+            {
+            c[d] = int(floor((f_i[d] + offset[d]) * Scalar(dim[d]))) % int(dim[d]);
+            if (c[d] < 0)
+                c[d] += dim[d];
+            }
+        return cell_idx(c[0], c[1], c[2]);
+        };
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
+
+    // bin particles in the shuffled update order, particles stay in their cell for the whole step
+    std::vector< std::vector<unsigned int> > cells(cell_idx.getNumElements());
+    for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+        {
+        unsigned int i = m_update_order[cur_particle];
+        cells[get_cell(vec3<Scalar>(h_postype.data[i]))].push_back(i);
+        }
+
+    // cells of each set
+    unsigned int n_sets = (ndim == 3) ? 8 : 4;
+    std::vector< std::vector<unsigned int> > sets(n_sets);
+    for (unsigned int k = 0; k < dim[2]; k++)
+        for (unsigned int j = 0; j < dim[1]; j++)
+            for (unsigned int i = 0; i < dim[0]; i++)
+                sets[(i & 1) + 2*(j & 1) + 4*(k & 1)].push_back(cell_idx(i,j,k));
 
-                // update position of particle
-                h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
+    tbb::enumerable_thread_specific<hpmc_counters_t> thread_counters;
 
-                if (shape_i.hasOrientation())
-                    {
-                    h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
-                    }
+    for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
+        {
+        // sweep the sets in a random order
+        std::vector<unsigned int> set_order(n_sets);
+        for (unsigned int s = 0; s < n_sets; s++)
+            set_order[s] = s;
+        for (unsigned int s = n_sets - 1; s > 0; s--)
+            std::swap(set_order[s], set_order[hoomd::UniformIntDistribution(s)(rng)]);
+
+        for (unsigned int cur_set = 0; cur_set < n_sets; cur_set++)
+            {
+            const std::vector<unsigned int>& active_cells = sets[set_order[cur_set]];
 
-                // store new seed
-                if (has_depletants)
-                    h_vel.data[i].x = __int_as_scalar(seed_i_new);
-                }
-            else
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, (unsigned int)active_cells.size()),
+                [&](const tbb::blocked_range<unsigned int>& r)
                 {
-                if (!shape_i.ignoreStatistics())
+                hpmc_counters_t& local_counters = thread_counters.local();
+
+                for (unsigned int cur_cell = r.begin(); cur_cell != r.end(); ++cur_cell)
                     {
-                    // increment reject counter
-                    if (move_type_translate)
-                        counters.translate_reject_count++;
-                    else
-                        counters.rotate_reject_count++;
-                    }
-                }
-            } // end loop over all particles
-        } // end loop over nselect
+                    unsigned int my_cell = active_cells[cur_cell];
+                    uint3 my_cell_coord = cell_idx.getTriple(my_cell);
 
-        {
-        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
-        // wrap particles back into box
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            {
-            box.wrap(h_postype.data[i], h_image.data[i]);
-            }
-        }
+                    for (unsigned int i : cells[my_cell])
+                        {
+                        Scalar4 postype_i = h_postype.data[i];
+                        Scalar4 orientation_i = h_orientation.data[i];
+                        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+                        hoomd::RandomGenerator rng_i(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoTrialMove,
+                                                                 timestep,
+                                                                 seed),
+                                                     hoomd::Counter(i, m_exec_conf->getRank(), i_nselect));
+                        int typ_i = __scalar_as_int(postype_i.w);
+                        Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
+                        unsigned int move_type_select = hoomd::UniformIntDistribution(0xffff)(rng_i);
+                        bool move_type_translate = !shape_i.hasOrientation()
+                                                   || (move_type_select < m_translation_move_probability);
+
+                        bool overlap = false;
+
+                        if (move_type_translate)
+                            {
+                            if (h_d.data[typ_i] == 0.0)
+                                {
+                                if (!shape_i.ignoreStatistics())
+                                    local_counters.translate_accept_count++;
+                                continue;
+                                }
 
-    // perform the grid shift
-    #ifdef ENABLE_MPI
-    if (m_comm)
-        {
-        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+                            move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
 
-        // precalculate the grid shift
-        hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoShift, timestep, this->m_sysdef->getSeed()),
-                                   hoomd::Counter());
-        Scalar3 shift = make_scalar3(0,0,0);
-        hoomd::UniformDistribution<Scalar> uniform(-m_nominal_width/Scalar(2.0),m_nominal_width/Scalar(2.0));
-        shift.x = uniform(rng);
-        shift.y = uniform(rng);
-        if (this->m_sysdef->getNDimensions() == 3)
-            {
-            shift.z = uniform(rng);
-            }
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            {
-            // read in the current position and orientation
-            Scalar4 postype_i = h_postype.data[i];
-            vec3<Scalar> r_i = vec3<Scalar>(postype_i); // translation from local to global coordinates
-            r_i += vec3<Scalar>(shift);
-            h_postype.data[i] = vec_to_scalar4(r_i, postype_i.w);
-            box.wrap(h_postype.data[i], h_image.data[i]);
-            }
-        this->m_pdata->translateOrigin(shift);
-        }
-    #endif
+                            // moves out of the cell are rejected so that the cell list stays valid
+                            overlap = get_cell(pos_i) != my_cell;
+                            }
+                        else
+                            {
+                            if (h_a.data[typ_i] == 0.0)
+                                {
+                                if (!shape_i.ignoreStatistics())
+                                    local_counters.rotate_accept_count++;
+                                continue;
+                                }
 
-    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+                            if (ndim == 2)
+                                move_rotate<2>(shape_i.orientation, rng_i, h_a.data[typ_i]);
+                            else
+                                move_rotate<3>(shape_i.orientation, rng_i, h_a.data[typ_i]);
+                            }
 
-    // migrate and exchange particles
-    communicate(true);
+                        // check for overlaps with particles in this and the neighboring cells
+                        int nz = (ndim == 3) ? 1 : 0;
+                        for (int dz = -nz; dz <= nz && !overlap; dz++)
+                            for (int dy = -1; dy <= 1 && !overlap; dy++)
+                                for (int dx = -1; dx <= 1 && !overlap; dx++)
+                                    {
+                                    unsigned int neigh_cell = cell_idx(
+                                        (my_cell_coord.x + dim[0] + dx) % dim[0],
+                                        (my_cell_coord.y + dim[1] + dy) % dim[1],
+                                        (my_cell_coord.z + dim[2] + dz) % dim[2]);
 
-    // all particle have been moved, the aabb tree is now invalid
-    m_aabb_tree_invalid = true;
+                                    for (unsigned int j : cells[neigh_cell])
+                                        {
+                                        if (j == i)
+                                            continue;
 
-    // set current MPS value
-    hpmc_counters_t run_counters = getCounters(1);
-    double cur_time = double(m_clock.getTime()) / Scalar(1e9);
-    m_mps = double(run_counters.getNMoves()) / cur_time;
+                                        Scalar4 postype_j = h_postype.data[j];
+                                        vec3<Scalar> r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(
+                                            vec3<Scalar>(postype_j) - pos_i)));
+
+                                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                                        Shape shape_j(quat<Scalar>(h_orientation.data[j]), m_params[typ_j]);
+
+                                        local_counters.overlap_checks++;
+                                        if (h_overlaps[m_overlap_idx(typ_i, typ_j)]
+                                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                                            && test_overlap(r_ij, shape_i, shape_j, local_counters.overlap_err_count))
+                                            {
+                                            overlap = true;
+                                            break;
+                                            }
+                                        }
+                                    }
+
+                        if (!overlap)
+                            {
+                            if (!shape_i.ignoreStatistics())
+                                {
+                                if (move_type_translate)
+                                    local_counters.translate_accept_count++;
+                                else
+                                    local_counters.rotate_accept_count++;
+                                }
+
+                            h_postype.data[i] = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+
+                            if (shape_i.hasOrientation())
+                                h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+                            }
+                        else
+                            {
+                            if (!shape_i.ignoreStatistics())
+                                {
+                                if (move_type_translate)
+                                    local_counters.translate_reject_count++;
+                                else
+                                    local_counters.rotate_reject_count++;
+                                }
+                            }
+                        } // end loop over particles in the cell
+                    } // end loop over cells
+                });
+            } // end loop over sets
+        } // end loop over nselect
+
+    for (auto c : thread_counters)
+        counters = counters + c;
+    #endif
     }
 
-/*! \param timestep current step
-    \param early_exit exit at first overlap found if true
-    \returns number of overlaps if early_exit=false, 1 if early_exit=true
+/*! \param max_count Number of overlaps to count exactly
+    \returns the number of overlaps if it is at most \a max_count, otherwise some number larger than \a max_count
 */
 template <class Shape>
-unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
+unsigned int IntegratorHPMCMono<Shape>::countOverlapsUpTo(unsigned int max_count)
     {
-    unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
+    // shared between threads, checked by every thread for the early exit
+    std::atomic<unsigned int> overlap_count(0);
 
     // build an up to date AABB tree
     buildAABBTree();
@@ -1354,8 +2062,22 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
     // Loop over all particles
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    #endif
         {
+        // other threads may have found enough overlaps already
+        if (overlap_count > max_count)
+            {
+            break;
+            }
+
+        unsigned int err_count = 0;
+
         // read in the current position and orientation
         Scalar4 postype_i = h_postype.data[i];
         Scalar4 orientation_i = h_orientation.data[i];
@@ -1404,8 +2126,7 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
                                 && test_overlap(r_ij, shape_i, shape_j, err_count)
                                 && test_overlap(-r_ij, shape_j, shape_i, err_count))
                                 {
-                                overlap_count++;
-                                if (early_exit)
+                                if (++overlap_count > max_count)
                                     {
                                     // exit early from loop over neighbor particles
                                     break;
@@ -1420,36 +2141,40 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
                     cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
                     }
 
-                if (overlap_count && early_exit)
+                if (overlap_count > max_count)
                     {
                     break;
                     }
                 } // end loop over AABB nodes
 
-            if (overlap_count && early_exit)
+            if (overlap_count > max_count)
                 {
                 break;
                 }
             } // end loop over images
 
-        if (overlap_count && early_exit)
+        if (overlap_count > max_count)
             {
             break;
             }
         } // end loop over particles
+    #ifdef ENABLE_TBB
+        });
+    #endif
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
+    unsigned int result = overlap_count;
+
     #ifdef ENABLE_MPI
     if (this->m_pdata->getDomainDecomposition())
         {
-        MPI_Allreduce(MPI_IN_PLACE, &overlap_count, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
-        if (early_exit && overlap_count > 1)
-            overlap_count = 1;
+        // a rank that stopped early already has more than max_count, so the sum does too
+        MPI_Allreduce(MPI_IN_PLACE, &result, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
         }
     #endif
 
-    return overlap_count;
+    return result;
     }
 
 template<class Shape>
@@ -1717,6 +2442,9 @@ inline const std::vector<vec3<Scalar> >& IntegratorHPMCMono<Shape>::updateImageL
     if (m_image_list_valid)
         return m_image_list;
 
+    // the cached overlap candidates refer to images by index
+    m_nlist_valid = false;
+
     // triclinic boxes have 4 linearly independent body diagonals
     // box_circumsphere = max(body_diagonals)
     // range = getMaxCoreDiameter() + box_circumsphere
@@ -1986,6 +2714,13 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
     this is on the next timestep. But in some cases (i.e. NPT), the tree may need to be rebuilt several times in a
     single step because of box volume moves.
 
+    update() only sets m_aabb_tree_stale, as the trial moves displace most particles by a small fraction of their
+    size. A stale tree keeps its topology and is refit to the current particle AABBs. Particles that moved more than
+    a quarter of the nominal width since they were last placed in the tree (including those wrapped through a periodic
+    boundary) are first reinserted into the leaf that fits them best. The tree is rebuilt from scratch when the number
+    of particles changes, when a best fitting leaf is full, or when the reinsertions since the last build exceed a
+    tenth of the particles.
+
     Subclasses that override update() or other methods must be user to set m_aabb_tree_invalid appropriately, or
     erroneous simulations will result.
 
@@ -1994,6 +2729,58 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
 template <class Shape>
 const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
     {
+    unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
+
+    if (!m_aabb_tree_invalid && m_aabb_tree_stale && n_aabb > 0)
+        {
+        if (n_aabb != m_aabb_tree.getNumParticles())
+            m_aabb_tree_invalid = true;
+        else
+            {
+            if (this->m_prof) this->m_prof->push(this->m_exec_conf, "AABB tree refit");
+
+            ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+            const Scalar margin = Scalar(0.25)*m_nominal_width;
+            for (unsigned int i = 0; i < n_aabb; i++)
+                {
+                unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
+                Shape shape(quat<Scalar>(h_orientation.data[i]), m_params[typ_i]);
+                vec3<Scalar> pos_i(h_postype.data[i]);
+
+                if (!this->m_patch)
+                    m_aabbs[i] = shape.getAABB(pos_i);
+                else
+                    {
+                    Scalar radius = std::max(0.5*shape.getCircumsphereDiameter(),
+                        0.5*this->m_patch->getAdditiveCutoff(typ_i));
+                    m_aabbs[i] = detail::AABB(pos_i, radius);
+                    }
+
+                vec3<Scalar> dr = pos_i - m_aabb_ref_pos[i];
+                if (fabs(dr.x) > margin || fabs(dr.y) > margin || fabs(dr.z) > margin)
+                    {
+                    if (!m_aabb_tree.reinsert(i, m_aabbs[i]))
+                        {
+                        m_aabb_tree_invalid = true;
+                        break;
+                        }
+                    m_aabb_ref_pos[i] = pos_i;
+                    m_aabb_n_reinserted++;
+                    }
+                }
+
+            if (m_aabb_n_reinserted > n_aabb/10)
+                m_aabb_tree_invalid = true;
+
+            if (!m_aabb_tree_invalid)
+                m_aabb_tree.refit(m_aabbs);
+
+            if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+            }
+        }
+
     if (m_aabb_tree_invalid)
         {
         m_exec_conf->msg->notice(8) << "Building AABB tree: " << m_pdata->getN() << " ptls " << m_pdata->getNGhosts() << " ghosts" << std::endl;
@@ -2004,13 +2791,14 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
 
             // grow the AABB list to the needed size
-            unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
             if (n_aabb > 0)
                 {
                 growAABBList(n_aabb);
+                m_aabb_ref_pos.resize(n_aabb);
                 for (unsigned int cur_particle = 0; cur_particle < n_aabb; cur_particle++)
                     {
                     unsigned int i = cur_particle;
+                    m_aabb_ref_pos[i] = vec3<Scalar>(h_postype.data[i]);
                     unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
                     Shape shape(quat<Scalar>(h_orientation.data[i]), m_params[typ_i]);
 
@@ -2026,11 +2814,13 @@ const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
                 m_aabb_tree.buildTree(m_aabbs, n_aabb);
                 }
             }
+        m_aabb_n_reinserted = 0;
 
         if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
         }
 
     m_aabb_tree_invalid = false;
+    m_aabb_tree_stale = false;
     return m_aabb_tree;
     }
 
@@ -3455,6 +4245,280 @@ bool IntegratorHPMCMono<Shape>::attemptBoxResize(uint64_t timestep, const BoxDim
     return result;
     }
 
+/*! \param has_depletants true when any depletant fugacity is non-zero
+    \returns true when the hard sphere sweep supports the current system
+
+    The hard sphere sweep replaces the serial sweep for spheres and disks without orientation when there are no
+    depletants, patch energies, external fields, or MPI domain decomposition, and the box fits at least three cells
+    of the largest diameter per direction.
+*/
+template <>
+inline bool IntegratorHPMCMono<ShapeSphere>::useHardSphereSweep(bool has_depletants)
+    {
+    if (has_depletants || m_patch || m_external)
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
+
+    for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+        {
+        if (m_params[typ].isOriented)
+            return false;
+        }
+
+    Scalar width = getMaxCoreDiameter();
+    if (width <= Scalar(0.0))
+        return false;
+
+    Scalar3 npd = m_pdata->getBox().getNearestPlaneDistance();
+    if (npd.x < Scalar(3.0)*width || npd.y < Scalar(3.0)*width
+        || (m_sysdef->getNDimensions() == 3 && npd.z < Scalar(3.0)*width))
+        return false;
+
+    return true;
+    }
+
+/*! \param timestep Current time step
+    \param h_overlaps Interaction matrix
+    \param counters Counters to add the move statistics to
+
+    Performs the trial moves of the serial sweep, in the same order and with the same random numbers, so both sweeps
+    produce the same trajectory up to round-off. Instead of querying the AABB tree in every periodic image, the
+    candidates are the particles in the 27 (9 in 2D) cells around the trial position, in a cell list at least one
+    maximum diameter wide. The cells store the coordinates and types of their particles contiguously, and the
+    distance test against a cell is a branch-free loop over a precomputed table of squared contact distances that
+    the compiler can vectorize. Particles are wrapped into the box when their moves are accepted, so each
+    neighboring cell is seen through a fixed lattice vector.
+*/
+template <>
+inline void IntegratorHPMCMono<ShapeSphere>::updateHardSphere(uint64_t timestep,
+                                                              const unsigned int *h_overlaps,
+                                                              hpmc_counters_t& counters)
+    {
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    const unsigned int N = m_pdata->getN();
+    const unsigned int ntypes = m_pdata->getNTypes();
+    uint16_t seed = m_sysdef->getSeed();
+
+    // squared contact distances, 0 for type pairs that are not checked
+    m_sphere_rsq.resize(ntypes*ntypes);
+    for (unsigned int typ_i = 0; typ_i < ntypes; typ_i++)
+        for (unsigned int typ_j = 0; typ_j < ntypes; typ_j++)
+            {
+            OverlapReal RaRb = m_params[typ_i].radius + m_params[typ_j].radius;
+            m_sphere_rsq[typ_i*ntypes + typ_j] = h_overlaps[m_overlap_idx(typ_i, typ_j)] ? RaRb*RaRb
+                                                                                         : OverlapReal(0.0);
+            }
+
+    // cells no narrower than the largest particle
+    Scalar width = getMaxCoreDiameter();
+    Scalar3 npd = box.getNearestPlaneDistance();
+    unsigned int dim[3];
+    dim[0] = (unsigned int)(npd.x / width);
+    dim[1] = (unsigned int)(npd.y / width);
+    dim[2] = (ndim == 3) ? (unsigned int)(npd.z / width) : 1;
+
+    // limit the number of cells for small particles, wider cells are always valid
+    while ((unsigned long)dim[0]*dim[1]*dim[2] > 2*(unsigned long)N + 64)
+        {
+        unsigned int d = (dim[0] >= dim[1]) ? 0 : 1;
+        if (ndim == 3 && dim[2] > dim[d])
+            d = 2;
+        if (dim[d] <= 3)
+            break;
+        dim[d]--;
+        }
+    Index3D cell_idx(dim[0], dim[1], dim[2]);
+    const unsigned int n_cells = cell_idx.getNumElements();
+
+    vec3<Scalar> lattice[3] = {vec3<Scalar>(box.getLatticeVector(0)),
+                               vec3<Scalar>(box.getLatticeVector(1)),
+                               vec3<Scalar>(box.getLatticeVector(2))};
+
+    // cell of a position inside the box
+    auto get_cell = [&](const Scalar4& postype)
+        {
+        Scalar3 f = box.makeFraction(make_scalar3(postype.x, postype.y, postype.z));
+        Scalar f_i[3] = {f.x, f.y, f.z};
+        int c[3] = {0, 0, 0};
+        for (unsigned int d = 0; d < ndim; d++)
+            c[d] = std::min(std::max(int(f_i[d] * Scalar(dim[d])), 0), int(dim[d]) - 1);
+        return cell_idx(c[0], c[1], c[2]);
+        };
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+
+    m_sphere_cell_of.resize(N);
+    m_sphere_cell_size.assign(n_cells, 0);
+    unsigned int cell_cap = 0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        box.wrap(h_postype.data[i], h_image.data[i]);
+        m_sphere_cell_of[i] = get_cell(h_postype.data[i]);
+        cell_cap = std::max(cell_cap, ++m_sphere_cell_size[m_sphere_cell_of[i]]);
+        }
+
+    auto insert = [&](unsigned int i, unsigned int cell)
+        {
+        unsigned int k = cell*cell_cap + m_sphere_cell_size[cell]++;
+        Scalar4 postype = h_postype.data[i];
+        m_sphere_cell_idx[k] = i;
+        m_sphere_cell_x[k] = postype.x;
+        m_sphere_cell_y[k] = postype.y;
+        m_sphere_cell_z[k] = postype.z;
+        m_sphere_cell_type[k] = __scalar_as_int(postype.w);
+        };
+
+    auto remove = [&](unsigned int i, unsigned int cell)
+        {
+        unsigned int base = cell*cell_cap;
+        unsigned int last = base + --m_sphere_cell_size[cell];
+        for (unsigned int k = base; k < last; k++)
+            {
+            if (m_sphere_cell_idx[k] == i)
+                {
+                m_sphere_cell_idx[k] = m_sphere_cell_idx[last];
+                m_sphere_cell_x[k] = m_sphere_cell_x[last];
+                m_sphere_cell_y[k] = m_sphere_cell_y[last];
+                m_sphere_cell_z[k] = m_sphere_cell_z[last];
+                m_sphere_cell_type[k] = m_sphere_cell_type[last];
+                break;
+                }
+            }
+        };
+
+    auto build_cells = [&](unsigned int cap)
+        {
+        cell_cap = cap;
+        m_sphere_cell_size.assign(n_cells, 0);
+        m_sphere_cell_idx.resize(n_cells*cell_cap);
+        m_sphere_cell_x.resize(n_cells*cell_cap);
+        m_sphere_cell_y.resize(n_cells*cell_cap);
+        m_sphere_cell_z.resize(n_cells*cell_cap);
+        m_sphere_cell_type.resize(n_cells*cell_cap);
+        for (unsigned int i = 0; i < N; i++)
+            insert(i, m_sphere_cell_of[i]);
+        };
+
+    // leave room for particles moving between cells
+    build_cells(cell_cap + 2);
+
+    int nz = (ndim == 3) ? 1 : 0;
+
+    for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
+        {
+        // loop through N particles in a shuffled order
+        for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+            {
+            unsigned int i = m_update_order[cur_particle];
+
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+            // make a trial move for i, drawing the move type as the serial sweep does
+            hoomd::RandomGenerator rng_i(hoomd::Seed(hoomd::RNGIdentifier::HPMCMonoTrialMove, timestep, seed),
+                                         hoomd::Counter(i, m_exec_conf->getRank(), i_nselect));
+            unsigned int typ_i = __scalar_as_int(postype_i.w);
+            hoomd::UniformIntDistribution(0xffff)(rng_i);
+            bool ignore = m_params[typ_i].ignore;
+
+            // skip if no overlap check is required
+            if (h_d.data[typ_i] == 0.0)
+                {
+                if (!ignore)
+                    counters.translate_accept_count++;
+                continue;
+                }
+
+            move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
+
+            Scalar4 postype_new = make_scalar4(pos_i.x, pos_i.y, pos_i.z, postype_i.w);
+            int3 image_new = h_image.data[i];
+            box.wrap(postype_new, image_new);
+            unsigned int new_cell = get_cell(postype_new);
+            uint3 c = cell_idx.getTriple(new_cell);
+            int c_i[3] = {int(c.x), int(c.y), int(c.z)};
+
+            const OverlapReal *rsq_i = &m_sphere_rsq[typ_i*ntypes];
+
+            bool overlap = false;
+            for (int dz = -nz; dz <= nz && !overlap; dz++)
+                for (int dy = -1; dy <= 1 && !overlap; dy++)
+                    for (int dx = -1; dx <= 1 && !overlap; dx++)
+                        {
+                        // neighboring cell and the lattice vector to its periodic image next to i
+                        int dc[3] = {dx, dy, dz};
+                        unsigned int cc[3];
+                        vec3<Scalar> shift(0,0,0);
+                        for (unsigned int d = 0; d < 3; d++)
+                            {
+                            int c_d = c_i[d] + dc[d];
+                            if (c_d < 0)
+                                {
+                                c_d += dim[d];
+                                shift -= lattice[d];
+                                }
+                            else if (c_d >= int(dim[d]))
+                                {
+                                c_d -= dim[d];
+                                shift += lattice[d];
+                                }
+                            cc[d] = c_d;
+                            }
+
+                        unsigned int neigh_cell = cell_idx(cc[0], cc[1], cc[2]);
+                        unsigned int base = neigh_cell*cell_cap;
+                        unsigned int n = m_sphere_cell_size[neigh_cell];
+
+                        // position of i relative to the image of the cell
+                        Scalar x_i = postype_new.x - shift.x;
+                        Scalar y_i = postype_new.y - shift.y;
+                        Scalar z_i = postype_new.z - shift.z;
+
+                        unsigned int n_overlap = 0;
+                        for (unsigned int k = base; k < base + n; k++)
+                            {
+                            OverlapReal dx_ij = OverlapReal(m_sphere_cell_x[k] - x_i);
+                            OverlapReal dy_ij = OverlapReal(m_sphere_cell_y[k] - y_i);
+                            OverlapReal dz_ij = OverlapReal(m_sphere_cell_z[k] - z_i);
+                            OverlapReal rsq = dx_ij*dx_ij + dy_ij*dy_ij + dz_ij*dz_ij;
+                            n_overlap += (rsq < rsq_i[m_sphere_cell_type[k]]) & (m_sphere_cell_idx[k] != i);
+                            }
+
+                        counters.overlap_checks += n;
+                        overlap = n_overlap > 0;
+                        }
+
+            if (!overlap)
+                {
+                if (!ignore)
+                    counters.translate_accept_count++;
+
+                h_postype.data[i] = postype_new;
+                h_image.data[i] = image_new;
+
+                remove(i, m_sphere_cell_of[i]);
+                m_sphere_cell_of[i] = new_cell;
+                if (m_sphere_cell_size[new_cell] == cell_cap)
+                    build_cells(2*cell_cap);
+                else
+                    insert(i, new_cell);
+                }
+            else
+                {
+                if (!ignore)
+                    counters.translate_reject_count++;
+                }
+            } // end loop over all particles
+        } // end loop over nselect
+    }
+
 //! Export the IntegratorHPMCMono class to python
 /*! \param name Name of the class in the exported python module
     \tparam Shape An instantiation of IntegratorHPMCMono<Shape> will be exported
@@ -3468,6 +4532,8 @@ template < class Shape > void export_IntegratorHPMCMono(pybind11::module& m, con
           .def("getInteractionMatrix", &IntegratorHPMCMono<Shape>::getInteractionMatrixPy)
           .def("setExternalField", &IntegratorHPMCMono<Shape>::setExternalField)
           .def("setPatchEnergy", &IntegratorHPMCMono<Shape>::setPatchEnergy)
+          .def_property("patch_energy_cache", &IntegratorHPMCMono<Shape>::getPatchEnergyCache,
+                        &IntegratorHPMCMono<Shape>::setPatchEnergyCache)
           .def("mapOverlaps", &IntegratorHPMCMono<Shape>::mapOverlaps)
           .def("mapEnergies", &IntegratorHPMCMono<Shape>::PyMapEnergies)
           .def("connectGSDStateSignal", &IntegratorHPMCMono<Shape>::connectGSDStateSignal)
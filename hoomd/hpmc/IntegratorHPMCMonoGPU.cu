@@ -3,6 +3,11 @@
 
 #include "IntegratorHPMCMonoGPUTypes.cuh"
 #include "hoomd/GPUPartition.cuh"
+#include "hoomd/CachedAllocator.h"
+
+#include <thrust/device_ptr.h>
+#include <thrust/scan.h>
+#include <thrust/execution_policy.h>
 
 namespace hpmc
 {
@@ -70,6 +75,86 @@ __global__ void hpmc_excell(unsigned int *d_excell_idx,
     d_excell_size[my_cell] = my_cell_size;
     }
 
+//! Kernel to count the particles in the compact expanded cells
+/*! \param d_excell_size Output array to list the number of particles in each expanded cell
+    \param d_cell_size Number of particles in each cell
+    \param d_cell_adj Cell adjacency list
+    \param ci Cell indexer
+    \param cadji Cell adjacency indexer
+    \param ngpu Number of active devices
+
+    hpmc_excell_count executes one thread per cell. It sums the sizes of all neighboring cells.
+*/
+__global__ void hpmc_excell_count(unsigned int *d_excell_size,
+                                  const unsigned int *d_cell_size,
+                                  const unsigned int *d_cell_adj,
+                                  const Index3D ci,
+                                  const Index2D cadji,
+                                  const unsigned int ngpu)
+    {
+    unsigned int my_cell = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (my_cell >= ci.getNumElements())
+        return;
+
+    unsigned int my_cell_size = 0;
+
+    for (unsigned int offset = 0; offset < cadji.getW(); offset++)
+        {
+        unsigned int neigh_cell = d_cell_adj[cadji(offset, my_cell)];
+
+        for (unsigned int igpu = 0; igpu < ngpu; ++igpu)
+            my_cell_size += d_cell_size[neigh_cell+igpu*ci.getNumElements()];
+        }
+
+    d_excell_size[my_cell] = my_cell_size;
+    }
+
+//! Kernel to fill the compact expanded cells
+/*! \param d_excell_idx Output array to list the particle indices in the expanded cells
+    \param d_excell_offsets Offset of each expanded cell in d_excell_idx
+    \param d_cell_idx Particle indices in the normal cells
+    \param d_cell_size Number of particles in each cell
+    \param d_cell_adj Cell adjacency list
+    \param ci Cell indexer
+    \param cli Cell list indexer
+    \param cadji Cell adjacency indexer
+    \param ngpu Number of active devices
+
+    hpmc_excell_fill executes one thread per cell. It gathers the particle indices from all neighboring cells
+    into the output expanded cell, which starts at d_excell_offsets[my_cell].
+*/
+__global__ void hpmc_excell_fill(unsigned int *d_excell_idx,
+                                 const unsigned int *d_excell_offsets,
+                                 const unsigned int *d_cell_idx,
+                                 const unsigned int *d_cell_size,
+                                 const unsigned int *d_cell_adj,
+                                 const Index3D ci,
+                                 const Index2D cli,
+                                 const Index2D cadji,
+                                 const unsigned int ngpu)
+    {
+    unsigned int my_cell = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (my_cell >= ci.getNumElements())
+        return;
+
+    unsigned int *excell = d_excell_idx + d_excell_offsets[my_cell];
+
+    for (unsigned int offset = 0; offset < cadji.getW(); offset++)
+        {
+        unsigned int neigh_cell = d_cell_adj[cadji(offset, my_cell)];
+
+        for (unsigned int igpu = 0; igpu < ngpu; ++igpu)
+            {
+            unsigned int neigh_cell_size = d_cell_size[neigh_cell+igpu*ci.getNumElements()];
+
+            for (unsigned int k = 0; k < neigh_cell_size; k++)
+                *excell++ = d_cell_idx[cli(k, neigh_cell)+igpu*cli.getNumElements()];
+            }
+        }
+    }
+
 //! Kernel for grid shift
 /*! \param d_postype postype of each particle
     \param d_image Image flags for each particle
@@ -110,6 +195,32 @@ __global__ void hpmc_shift(Scalar4 *d_postype,
     d_image[my_pidx] = image;
     }
 
+//! Kernel to scale the particles with the box
+/*! \param d_postype postype of each particle
+    \param N number of particles
+    \param old_box Current global box
+    \param new_box New global box
+
+    Moves the particles to the same fractional coordinates in the new box.
+
+    \ingroup hpmc_kernels
+*/
+__global__ void hpmc_scale_box(Scalar4 *d_postype,
+                               const unsigned int N,
+                               const BoxDim old_box,
+                               const BoxDim new_box)
+    {
+    unsigned int my_pidx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (my_pidx >= N)
+        return;
+
+    Scalar4 postype = d_postype[my_pidx];
+    Scalar3 f = old_box.makeFraction(make_scalar3(postype.x, postype.y, postype.z));
+    Scalar3 pos = new_box.makeCoordinates(f);
+    d_postype[my_pidx] = make_scalar4(pos.x, pos.y, pos.z, postype.w);
+    }
+
 //!< Kernel to evaluate convergence
 __global__ void hpmc_check_convergence(
                  const unsigned int *d_trial_move_type,
@@ -194,6 +305,79 @@ void hpmc_excell(unsigned int *d_excell_idx,
 
     }
 
+//! Driver for kernel::hpmc_excell_count() and kernel::hpmc_excell_fill()
+/*! The expanded cells are stored back to back in d_excell_idx. Their sizes are counted first and the offsets
+    are the exclusive prefix sum of the sizes, so the total storage is the number of particle-cell pairs instead of
+    the number of cells times the largest possible expanded cell. The caller must size d_excell_idx for the sum of
+    all expanded cell sizes.
+*/
+void hpmc_excell_csr(unsigned int *d_excell_idx,
+                     unsigned int *d_excell_size,
+                     unsigned int *d_excell_offsets,
+                     const unsigned int *d_cell_idx,
+                     const unsigned int *d_cell_size,
+                     const unsigned int *d_cell_adj,
+                     const Index3D& ci,
+                     const Index2D& cli,
+                     const Index2D& cadji,
+                     const unsigned int ngpu,
+                     const unsigned int block_size,
+                     CachedAllocator& alloc)
+    {
+    assert(d_excell_idx);
+    assert(d_excell_size);
+    assert(d_excell_offsets);
+    assert(d_cell_idx);
+    assert(d_cell_size);
+    assert(d_cell_adj);
+
+    // determine the maximum block size and clamp the input block size down
+    static int max_block_size = -1;
+    if (max_block_size == -1)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(kernel::hpmc_excell_fill));
+        max_block_size = attr.maxThreadsPerBlock;
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(kernel::hpmc_excell_count));
+        max_block_size = min(max_block_size, attr.maxThreadsPerBlock);
+        }
+
+    // setup the grid to run the kernels
+    unsigned int run_block_size = min(block_size, (unsigned int)max_block_size);
+    dim3 threads(run_block_size, 1, 1);
+    dim3 grid(ci.getNumElements() / run_block_size + 1, 1, 1);
+
+    hipLaunchKernelGGL(kernel::hpmc_excell_count, dim3(grid), dim3(threads), 0, 0,
+        d_excell_size,
+        d_cell_size,
+        d_cell_adj,
+        ci,
+        cadji,
+        ngpu);
+
+    thrust::device_ptr<unsigned int> excell_size(d_excell_size);
+    thrust::device_ptr<unsigned int> excell_offsets(d_excell_offsets);
+    #ifdef __HIP_PLATFORM_HCC__
+    thrust::exclusive_scan(thrust::hip::par(alloc),
+    #else
+    thrust::exclusive_scan(thrust::cuda::par(alloc),
+    #endif
+        excell_size,
+        excell_size + ci.getNumElements(),
+        excell_offsets);
+
+    hipLaunchKernelGGL(kernel::hpmc_excell_fill, dim3(grid), dim3(threads), 0, 0,
+        d_excell_idx,
+        d_excell_offsets,
+        d_cell_idx,
+        d_cell_size,
+        d_cell_adj,
+        ci,
+        cli,
+        cadji,
+        ngpu);
+    }
+
 //! Kernel driver for kernel::hpmc_shift()
 void hpmc_shift(Scalar4 *d_postype,
                 int3 *d_image,
@@ -219,6 +403,25 @@ void hpmc_shift(Scalar4 *d_postype,
     hipDeviceSynchronize();
     }
 
+//! Kernel driver for kernel::hpmc_scale_box()
+void hpmc_scale_box(Scalar4 *d_postype,
+                    const unsigned int N,
+                    const BoxDim& old_box,
+                    const BoxDim& new_box,
+                    const unsigned int block_size)
+    {
+    assert(d_postype);
+
+    // setup the grid to run the kernel
+    dim3 threads(block_size, 1, 1);
+    dim3 grid(N / block_size + 1, 1, 1);
+
+    hipLaunchKernelGGL(kernel::hpmc_scale_box, dim3(grid), dim3(threads), 0, 0, d_postype,
+                                                      N,
+                                                      old_box,
+                                                      new_box);
+    }
+
 void hpmc_check_convergence(const unsigned int *d_trial_move_type,
                  const unsigned int *d_reject_out_of_cell,
                  unsigned int *d_reject_in,
@@ -52,7 +52,7 @@ __global__ void hpmc_narrow_phase(const Scalar4 *d_postype,
                            const unsigned int *d_trial_move_type,
                            const unsigned int *d_excell_idx,
                            const unsigned int *d_excell_size,
-                           const Index2D excli,
+                           const unsigned int *d_excell_offsets,
                            hpmc_counters_t *d_counters,
                            const unsigned int num_types,
                            const BoxDim box,
@@ -189,12 +189,14 @@ __global__ void hpmc_narrow_phase(const Scalar4 *d_postype,
 
     // counters to track progress through the loop over potential neighbors
     unsigned int excell_size;
+    unsigned int excell_start;
     unsigned int k = offset;
 
     // true if we are checking against the old configuration
     if (active)
         {
         excell_size = d_excell_size[my_cell];
+        excell_start = d_excell_offsets[my_cell];
         overlap_checks += excell_size;
         }
 
@@ -212,7 +214,7 @@ __global__ void hpmc_narrow_phase(const Scalar4 *d_postype,
             unsigned int j, next_j = 0;
             if (k < excell_size)
                 {
-                next_j = __ldg(&d_excell_idx[excli(k, my_cell)]);
+                next_j = __ldg(&d_excell_idx[excell_start + k]);
                 }
 
             // add to the queue as long as the queue is not full, and we have not yet reached the end of our own list
@@ -232,7 +234,7 @@ __global__ void hpmc_narrow_phase(const Scalar4 *d_postype,
                 k += group_size;
                 if (k < excell_size)
                     {
-                    next_j = __ldg(&d_excell_idx[excli(k, my_cell)]);
+                    next_j = __ldg(&d_excell_idx[excell_start + k]);
                     }
 
                 // has j been updated? ghost particles are not updated
@@ -469,7 +471,7 @@ void narrow_phase_launcher(const hpmc_args_t& args, const typename Shape::param_
             hipLaunchKernelGGL((hpmc_narrow_phase<Shape, launch_bounds_nonzero*MIN_BLOCK_SIZE>),
                 grid, thread, shared_bytes, args.streams[idev],
                 args.d_postype, args.d_orientation, args.d_trial_postype, args.d_trial_orientation,
-                args.d_trial_move_type, args.d_excell_idx, args.d_excell_size, args.excli,
+                args.d_trial_move_type, args.d_excell_idx, args.d_excell_size, args.d_excell_offsets,
                 args.d_counters+idev*args.counters_pitch, args.num_types,
                 args.box, args.ghost_width, args.cell_dim, args.ci, args.N, args.d_check_overlaps,
                 args.overlap_idx, params, args.d_update_order_by_ptl, args.d_reject_in, args.d_reject_out, args.d_reject_out_of_cell,
@@ -9,6 +9,7 @@
 #include "hoomd/hpmc/IntegratorHPMCMonoGPUTypes.cuh"
 #include "hoomd/hpmc/IntegratorHPMCMonoGPUDepletantsTypes.cuh"
 #include "hoomd/hpmc/IntegratorHPMCMonoGPUDepletantsAuxilliaryTypes.cuh"
+#include "hoomd/hpmc/IntegratorHPMCMonoGPUCountOverlaps.cuh"
 
 #include "hoomd/Autotuner.h"
 #include "hoomd/GlobalArray.h"
@@ -20,6 +21,9 @@
 
 #include <hip/hip_runtime.h>
 
+#include <algorithm>
+#include <climits>
+
 #ifdef ENABLE_MPI
 #include <mpi.h>
 #include "hoomd/MPIConfiguration.h"
@@ -170,6 +174,11 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
                     chain_length*period*this->m_nselect);
                 }
 
+            if (this->m_external && this->m_external->hasGPUImplementation())
+                {
+                this->m_external->setAutotunerParams(enable, period*this->m_nselect);
+                }
+
             m_tuner_depletants->setPeriod(chain_length*period*this->m_nselect);
             m_tuner_depletants->setEnabled(enable);
 
@@ -193,6 +202,9 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
 
             m_tuner_depletants_accept->setPeriod(chain_length*period*this->m_nselect);
             m_tuner_depletants_accept->setEnabled(enable);
+
+            m_tuner_count_overlaps->setPeriod(period);
+            m_tuner_count_overlaps->setEnabled(enable);
             }
 
         //! Method called when numbe of particle types changes
@@ -201,6 +213,21 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
         //! Take one timestep forward
         virtual void update(uint64_t timestep);
 
+        //! Count overlaps, stopping once there are more than max_count
+        virtual unsigned int countOverlapsUpTo(unsigned int max_count);
+
+        //! Scale the particle positions with the box on the GPU and set the new box
+        virtual void scaleBox(const BoxDim& new_box);
+
+        //! Get the cell list
+        /*! The nominal cell width includes the extra ghost width, so analyzers that set an extra ghost width (e.g.
+            AnalyzerSDFGPU) find all particles within their range in the adjacent cells.
+        */
+        std::shared_ptr<CellList> getCellList() const
+            {
+            return m_cl;
+            }
+
         #ifdef ENABLE_MPI
         void setNtrialCommunicator(std::shared_ptr<MPIConfiguration> mpi_conf)
             {
@@ -218,11 +245,11 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
     protected:
         std::shared_ptr<CellList> m_cl;                      //!< Cell list
         uint3 m_last_dim;                                    //!< Dimensions of the cell list on the last call to update
-        unsigned int m_last_nmax;                            //!< Last cell list NMax value allocated in excell
 
         GlobalArray<unsigned int> m_excell_idx;              //!< Particle indices in expanded cells
         GlobalArray<unsigned int> m_excell_size;             //!< Number of particles in each expanded cell
-        Index2D m_excell_list_indexer;                       //!< Indexer to access elements of the excell_idx list
+        GlobalArray<unsigned int> m_excell_offsets;          //!< Offset of each expanded cell in m_excell_idx
+        unsigned int m_excell_idle_count;                    //!< Number of consecutive builds using less than half of m_excell_idx
 
         std::unique_ptr<Autotuner> m_tuner_moves;            //!< Autotuner for proposing moves
         std::unique_ptr<Autotuner> m_tuner_narrow;           //!< Autotuner for the narrow phase
@@ -235,6 +262,7 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
         std::unique_ptr<Autotuner> m_tuner_depletants_phase1;//!< Tuner for depletants with ntrial, phase 1 kernel
         std::unique_ptr<Autotuner> m_tuner_depletants_phase2;//!< Tuner for depletants with ntrial, phase 2 kernel
         std::unique_ptr<Autotuner> m_tuner_depletants_accept;//!< Tuner for depletants with ntrial, acceptance kernel
+        std::unique_ptr<Autotuner> m_tuner_count_overlaps;   //!< Autotuner for counting overlaps
 
         GlobalArray<Scalar4> m_trial_postype;                 //!< New positions (and type) of particles
         GlobalArray<Scalar4> m_trial_orientation;             //!< New orientations
@@ -245,6 +273,7 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
         GlobalArray<unsigned int> m_reject_out;               //!< Flags to reject particle moves, per particle (temporary)
 
         GlobalArray<unsigned int> m_n_depletants;             //!< List of number of depletants, per particle
+        GlobalArray<unsigned int> m_depletant_block_end;      //!< Inclusive sum of blocks inserting depletants, per particle
         GlobalArray<unsigned int> m_n_depletants_ntrial;      //!< List of number of depletants, per particle, trial insertion and configuration:w
         GlobalArray<int> m_deltaF_int;                        //!< Free energy difference delta_F per particle for MH, rescaled to int
         unsigned int m_max_len;                               //!< Max length of shared memory allocation per group
@@ -252,11 +281,16 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
 
         detail::UpdateOrderGPU m_update_order;                   //!< Particle update order
         GlobalArray<unsigned int> m_condition;                  //!< Condition of convergence check
+        GlobalArray<unsigned int> m_overlap_count;              //!< Number of overlaps found by countOverlaps()
 
         //! For energy evaluation
         GlobalArray<Scalar> m_additive_cutoff;                //!< Per-type additive cutoffs from patch potential
 
         GlobalArray<hpmc_counters_t> m_counters;                    //!< Per-device counters
+        GlobalArray<hpmc_counters_t> m_count_step_start_device;     //!< Counters at the start of the step, on the device
+        bool m_count_step_start_deferred;    //!< True if the counters at the start of the step were not read back yet
+        bool m_mps_deferred;                 //!< True if the moves per second were not computed for the last step
+        double m_mps_time;                   //!< Run time at the end of the last step
         GlobalArray<hpmc_implicit_counters_t> m_implicit_counters;  //!< Per-device counters for depletants
 
         std::vector<hipStream_t> m_narrow_phase_streams;             //!< Stream for narrow phase kernel, per device
@@ -281,18 +315,28 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
         //! Set up excell_list
         virtual void initializeExcellMem();
 
+        //! Grow or shrink m_excell_idx to fit the expanded cells of the current particles
+        void reserveExcellIdx();
+
         //! Set the nominal width appropriate for looped moves
         virtual void updateCellWidth();
 
         //! Update GPU memory hints
         virtual void updateGPUAdvice();
+
+        //! Keep the most frequently read shape parameters in the persisting L2 cache
+        void updatePersistingWindow();
+
+        //! Read back the counters at the start of the step and compute the moves per second
+        virtual void updateDeferredCounters();
     };
 
 template< class Shape >
 IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefinition> sysdef,
                                                                    std::shared_ptr<CellList> cl)
     : IntegratorHPMCMono<Shape>(sysdef), m_cl(cl),
-      m_update_order(this->m_exec_conf)
+      m_update_order(this->m_exec_conf),
+      m_count_step_start_deferred(false), m_mps_deferred(false), m_mps_time(0.0)
     {
     this->m_cl->setRadius(1);
     this->m_cl->setComputeTDB(false);
@@ -304,7 +348,7 @@ IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefi
 
     // set last dim to a bogus value so that it will re-init on the first call
     m_last_dim = make_uint3(0xffffffff, 0xffffffff, 0xffffffff);
-    m_last_nmax = 0xffffffff;
+    m_excell_idle_count = 0;
 
     hipDeviceProp_t dev_prop = this->m_exec_conf->dev_prop;
     m_tuner_moves.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 1000000, "hpmc_moves", this->m_exec_conf));
@@ -357,6 +401,28 @@ IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefi
     m_tuner_depletants_phase1.reset(new Autotuner(valid_params_depletants, 5, 100000, "hpmc_depletants_phase1", this->m_exec_conf));
     m_tuner_depletants_phase2.reset(new Autotuner(valid_params_depletants, 5, 100000, "hpmc_depletants_phase2", this->m_exec_conf));
 
+    // tuning parameters for counting overlaps, encoded as block_size*1000000 + stride*100 + group_size
+    std::vector<unsigned int> valid_params_count;
+    for (unsigned int block_size = warp_size; block_size <= (unsigned int) dev_prop.maxThreadsPerBlock; block_size += warp_size)
+        {
+        for (auto s : Autotuner::getTppListPow2(warp_size))
+            {
+            unsigned int stride = 1;
+            while (stride <= warp_size/s)
+                {
+                // only widen the parallelism if the shape supports it
+                if (stride == 1 || Shape::isParallel())
+                    {
+                    // blockDim.z is limited to 64
+                    if ((block_size % (stride*s)) == 0 && block_size/s/stride <= 64)
+                        valid_params_count.push_back(block_size*1000000 + stride*100 + s);
+                    }
+                stride*=2;
+                }
+            }
+        }
+    m_tuner_count_overlaps.reset(new Autotuner(valid_params_count, 5, 1000000, "hpmc_count_overlaps", this->m_exec_conf));
+
     // initialize memory
     GlobalArray<Scalar4>(1,this->m_exec_conf).swap(m_trial_postype);
     TAG_ALLOCATION(m_trial_postype);
@@ -382,9 +448,15 @@ IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefi
     GlobalArray<unsigned int>(1, this->m_exec_conf).swap(m_condition);
     TAG_ALLOCATION(m_condition);
 
+    GlobalArray<unsigned int>(1, this->m_exec_conf).swap(m_overlap_count);
+    TAG_ALLOCATION(m_overlap_count);
+
     GlobalArray<unsigned int>(1, this->m_exec_conf).swap(m_req_len);
     TAG_ALLOCATION(m_req_len);
 
+    GlobalArray<hpmc_counters_t>(1, this->m_exec_conf).swap(m_count_step_start_device);
+    TAG_ALLOCATION(m_count_step_start_device);
+
     m_max_len = 0;
 
         {
@@ -417,9 +489,16 @@ IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefi
     m_excell_idx.swap(excell_idx);
     TAG_ALLOCATION(m_excell_idx);
 
+    GlobalArray<unsigned int> excell_offsets(0, this->m_exec_conf);
+    m_excell_offsets.swap(excell_offsets);
+    TAG_ALLOCATION(m_excell_offsets);
+
     GlobalArray<unsigned int>(1, this->m_exec_conf).swap(m_n_depletants);
     TAG_ALLOCATION(m_n_depletants);
 
+    GlobalArray<unsigned int>(1, this->m_exec_conf).swap(m_depletant_block_end);
+    TAG_ALLOCATION(m_depletant_block_end);
+
     GlobalArray<unsigned int>(1, this->m_exec_conf).swap(m_n_depletants_ntrial);
     TAG_ALLOCATION(m_n_depletants_ntrial);
 
@@ -652,6 +731,12 @@ void IntegratorHPMCMonoGPU< Shape >::updateGPUAdvice()
                     cudaMemPrefetchAsync(m_n_depletants.get()+this->m_depletant_idx(itype,jtype)*this->m_pdata->getMaxN()+range.first,
                         sizeof(unsigned int)*nelem, gpu_map[idev]);
 
+                    cudaMemAdvise(m_depletant_block_end.get()+this->m_depletant_idx(itype,jtype)*this->m_pdata->getMaxN()+range.first,
+                        sizeof(unsigned int)*nelem,
+                        cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+                    cudaMemPrefetchAsync(m_depletant_block_end.get()+this->m_depletant_idx(itype,jtype)*this->m_pdata->getMaxN()+range.first,
+                        sizeof(unsigned int)*nelem, gpu_map[idev]);
+
                     unsigned int ntrial = this->m_ntrial[this->m_depletant_idx(itype,jtype)];
                     if (ntrial == 0)
                         continue;
@@ -685,7 +770,23 @@ void IntegratorHPMCMonoGPU< Shape >::updateGPUAdvice()
 template< class Shape >
 void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
     {
-    IntegratorHPMC::update(timestep);
+    if (this->m_sync_free)
+        {
+        // keep a copy of the counters at the start of the step on the device, it is read back only when the counters
+        // are accessed
+        ArrayHandle<hpmc_counters_t> d_count_total(this->m_count_total, access_location::device, access_mode::read);
+        ArrayHandle<hpmc_counters_t> d_count_step_start(m_count_step_start_device, access_location::device,
+            access_mode::overwrite);
+        hipMemcpyAsync(d_count_step_start.data, d_count_total.data, sizeof(hpmc_counters_t), hipMemcpyDeviceToDevice);
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_count_step_start_deferred = true;
+        }
+    else
+        {
+        IntegratorHPMC::update(timestep);
+        m_count_step_start_deferred = false;
+        }
 
     if (this->m_patch && !this->m_patch_log)
         {
@@ -727,15 +828,16 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
 
         // if the cell list is a different size than last time, reinitialize the expanded cell list
         uint3 cur_dim = this->m_cl->getDim();
-        if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z
-            || m_last_nmax != this->m_cl->getNmax())
+        if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z)
             {
             initializeExcellMem();
 
             m_last_dim = cur_dim;
-            m_last_nmax = this->m_cl->getNmax();
             }
 
+        // make room for the expanded cells of the current local and ghost particles
+        reserveExcellIdx();
+
         // test if we are in domain decomposition mode
         bool domain_decomposition = false;
 #ifdef ENABLE_MPI
@@ -764,6 +866,7 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
         if (m_n_depletants.getNumElements() < this->m_pdata->getMaxN()*this->m_depletant_idx.getNumElements())
             {
             m_n_depletants.resize(this->m_pdata->getMaxN()*this->m_depletant_idx.getNumElements());
+            m_depletant_block_end.resize(this->m_pdata->getMaxN()*this->m_depletant_idx.getNumElements());
             update_gpu_advice = true;
             }
 
@@ -801,6 +904,14 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
             }
         #endif
 
+        // check for shared memory overflows once per convergence iteration, together with the convergence flag,
+        // unless other ranks take part in the sweep and need to rerun the kernels in lockstep
+        bool sync_free = this->m_sync_free;
+        #ifdef ENABLE_MPI
+        if (m_ntrial_comm || m_particle_comm)
+            sync_free = false;
+        #endif
+
         for (unsigned int itype = 0; itype < this->m_pdata->getNTypes(); ++itype)
             {
             for (unsigned int jtype = itype; jtype < this->m_pdata->getNTypes(); ++jtype)
@@ -881,12 +992,13 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
         // expanded cells & neighbor list
         ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
         ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+        ArrayHandle< unsigned int > d_excell_offsets(m_excell_offsets, access_location::device, access_mode::overwrite);
 
         // update the expanded cells
         this->m_tuner_excell_block_size->begin();
-        gpu::hpmc_excell(d_excell_idx.data,
+        gpu::hpmc_excell_csr(d_excell_idx.data,
                             d_excell_size.data,
-                            m_excell_list_indexer,
+                            d_excell_offsets.data,
                             m_cl->getPerDevice() ? d_cell_idx_per_device.data : d_cell_idx.data,
                             m_cl->getPerDevice() ? d_cell_size_per_device.data : d_cell_size.data,
                             d_cell_adj.data,
@@ -894,7 +1006,8 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                             this->m_cl->getCellListIndexer(),
                             this->m_cl->getCellAdjIndexer(),
                             this->m_exec_conf->getNumActiveGPUs(),
-                            this->m_tuner_excell_block_size->getParam());
+                            this->m_tuner_excell_block_size->getParam(),
+                            this->m_exec_conf->getCachedAllocator());
         if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
         this->m_tuner_excell_block_size->end();
 
@@ -959,7 +1072,7 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                     d_update_order_by_ptl.data,
                     d_excell_idx.data,
                     d_excell_size.data,
-                    m_excell_list_indexer,
+                    d_excell_offsets.data,
                     0, // d_reject_in
                     0, // d_reject_out
                     this->m_exec_conf->dev_prop,
@@ -975,38 +1088,66 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                 if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
                     CHECK_CUDA_ERROR();
                 m_tuner_moves->end();
+
+                // the external field energy of a particle does not depend on the other particles, so its
+                // Metropolis test is done once per trial move and flags the rejected moves before the overlap checks
+                if (this->m_external && this->m_external->hasGPUImplementation())
+                    {
+                    ArrayHandle<Scalar> d_charge(this->m_pdata->getCharges(), access_location::device, access_mode::read);
+                    ArrayHandle<Scalar> d_diameter(this->m_pdata->getDiameters(), access_location::device, access_mode::read);
+
+                    typename ExternalFieldMono<Shape>::gpu_args_t external_args(
+                        d_postype.data,
+                        d_orientation.data,
+                        d_trial_postype.data,
+                        d_trial_orientation.data,
+                        d_trial_move_type.data,
+                        d_charge.data,
+                        d_diameter.data,
+                        d_reject_out_of_cell.data,
+                        this->m_sysdef->getSeed(),
+                        timestep,
+                        i,
+                        box,
+                        this->m_pdata->getGPUPartition());
+
+                    this->m_external->rejectMovesGPU(external_args, 0);
+                    }
                 }
 
             bool converged = false;
+            bool reset_reject = true;
 
+            while (!converged)
                 {
-                // initialize reject flags
-                ArrayHandle<unsigned int> d_reject_out_of_cell(m_reject_out_of_cell, access_location::device, access_mode::read);
-                ArrayHandle<unsigned int> d_reject(m_reject, access_location::device, access_mode::overwrite);
-                ArrayHandle<unsigned int> d_reject_out(m_reject_out, access_location::device, access_mode::overwrite);
-
-                this->m_exec_conf->beginMultiGPU();
-                for (int idev = this->m_exec_conf->getNumActiveGPUs() - 1; idev >= 0; --idev)
+                if (reset_reject)
                     {
-                    hipSetDevice(this->m_exec_conf->getGPUIds()[idev]);
+                    // initialize reject flags, also when the sweep is restarted after an overflow
+                    ArrayHandle<unsigned int> d_reject_out_of_cell(m_reject_out_of_cell, access_location::device, access_mode::read);
+                    ArrayHandle<unsigned int> d_reject(m_reject, access_location::device, access_mode::overwrite);
+                    ArrayHandle<unsigned int> d_reject_out(m_reject_out, access_location::device, access_mode::overwrite);
 
-                    auto range = this->m_pdata->getGPUPartition().getRange(idev);
-                    if (range.second - range.first != 0)
+                    this->m_exec_conf->beginMultiGPU();
+                    for (int idev = this->m_exec_conf->getNumActiveGPUs() - 1; idev >= 0; --idev)
                         {
-                        hipMemcpyAsync(d_reject.data + range.first,
-                            d_reject_out_of_cell.data + range.first,
-                            sizeof(unsigned int)*(range.second-range.first),
-                            hipMemcpyDeviceToDevice);
-                        hipMemsetAsync(d_reject_out.data + range.first, 0,  sizeof(unsigned int)*(range.second-range.first));
+                        hipSetDevice(this->m_exec_conf->getGPUIds()[idev]);
+
+                        auto range = this->m_pdata->getGPUPartition().getRange(idev);
+                        if (range.second - range.first != 0)
+                            {
+                            hipMemcpyAsync(d_reject.data + range.first,
+                                d_reject_out_of_cell.data + range.first,
+                                sizeof(unsigned int)*(range.second-range.first),
+                                hipMemcpyDeviceToDevice);
+                            hipMemsetAsync(d_reject_out.data + range.first, 0,  sizeof(unsigned int)*(range.second-range.first));
+                            }
+                        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                            CHECK_CUDA_ERROR();
                         }
-                    if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-                        CHECK_CUDA_ERROR();
+                    this->m_exec_conf->endMultiGPU();
+                    reset_reject = false;
                     }
-                this->m_exec_conf->endMultiGPU();
-                }
 
-            while (!converged)
-                {
                     {
                     ArrayHandle<unsigned int> d_condition(m_condition, access_location::device, access_mode::overwrite);
                     // reset condition flag
@@ -1086,6 +1227,7 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                     // depletants
                     ArrayHandle<unsigned int> d_n_depletants(m_n_depletants, access_location::device, access_mode::overwrite);
                     ArrayHandle<unsigned int> d_n_depletants_ntrial(m_n_depletants_ntrial, access_location::device, access_mode::overwrite);
+                    ArrayHandle<unsigned int> d_depletant_block_end(m_depletant_block_end, access_location::device, access_mode::overwrite);
 
                     // fill the parameter structure for the GPU kernels
                     gpu::hpmc_args_t args(
@@ -1124,7 +1266,7 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                         d_update_order_by_ptl.data,
                         d_excell_idx.data,
                         d_excell_size.data,
-                        m_excell_list_indexer,
+                        d_excell_offsets.data,
                         d_reject.data,
                         d_reject_out.data,
                         this->m_exec_conf->dev_prop,
@@ -1214,6 +1356,12 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                                     depletants_per_thread,
                                     &m_depletant_streams[this->m_depletant_idx(itype,jtype)].front()
                                     );
+                                if (this->m_depletant_load_balance)
+                                    {
+                                    implicit_args.d_block_end = d_depletant_block_end.data +
+                                        this->m_depletant_idx(itype,jtype)*this->m_pdata->getMaxN();
+                                    implicit_args.alloc = &this->m_exec_conf->getCachedAllocatorManaged();
+                                    }
                                 gpu::hpmc_insert_depletants<Shape>(args, implicit_args, params.data());
                                 if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
                                     CHECK_CUDA_ERROR();
@@ -1375,15 +1523,19 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
 
                     this->m_exec_conf->endMultiGPU();
 
-                    // did the dynamically allocated shared memory overflow during kernel execution?
-                    ArrayHandle<unsigned int> h_req_len(m_req_len, access_location::host, access_mode::read);
-
-                    if (*h_req_len.data > m_max_len)
+                    // in the sync-free mode, an overflow is detected at the end of the iteration
+                    if (!sync_free)
                         {
-                        this->m_exec_conf->msg->notice(9) << "Increasing shared mem list size per group "
-                            << m_max_len << "->" << *h_req_len.data << std::endl;
-                        m_max_len = *h_req_len.data;
-                        continue; // rerun kernels
+                        // did the dynamically allocated shared memory overflow during kernel execution?
+                        ArrayHandle<unsigned int> h_req_len(m_req_len, access_location::host, access_mode::read);
+
+                        if (*h_req_len.data > m_max_len)
+                            {
+                            this->m_exec_conf->msg->notice(9) << "Increasing shared mem list size per group "
+                                << m_max_len << "->" << *h_req_len.data << std::endl;
+                            m_max_len = *h_req_len.data;
+                            continue; // rerun kernels
+                            }
                         }
 
                    reallocate_smem = false;
@@ -1439,15 +1591,18 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                         }
                     #endif
 
-                    // did the dynamically allocated shared memory overflow during kernel execution?
-                    ArrayHandle<unsigned int> h_req_len(m_req_len, access_location::host, access_mode::read);
-
-                    if (*h_req_len.data > m_max_len)
+                    if (!sync_free)
                         {
-                        this->m_exec_conf->msg->notice(9) << "Increasing shared mem list size per group "
-                            << m_max_len << "->" << *h_req_len.data << std::endl;
-                        m_max_len = *h_req_len.data;
-                        continue; // rerun kernels
+                        // did the dynamically allocated shared memory overflow during kernel execution?
+                        ArrayHandle<unsigned int> h_req_len(m_req_len, access_location::host, access_mode::read);
+
+                        if (*h_req_len.data > m_max_len)
+                            {
+                            this->m_exec_conf->msg->notice(9) << "Increasing shared mem list size per group "
+                                << m_max_len << "->" << *h_req_len.data << std::endl;
+                            m_max_len = *h_req_len.data;
+                            continue; // rerun kernels
+                            }
                         }
 
                     // final tally, do Metropolis-Hastings
@@ -1518,7 +1673,7 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                         box,
                         d_excell_idx.data,
                         d_excell_size.data,
-                        m_excell_list_indexer,
+                        d_excell_offsets.data,
                         this->m_patch->getRCut(),
                         d_additive_cutoff.data,
                         d_update_order_by_ptl.data,
@@ -1559,6 +1714,23 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
                 // flip reject flags
                 std::swap(m_reject,  m_reject_out);
 
+                if (sync_free)
+                    {
+                    // did the dynamically allocated shared memory overflow in any kernel of this iteration?
+                    ArrayHandle<unsigned int> h_req_len(m_req_len, access_location::host, access_mode::read);
+
+                    if (*h_req_len.data > m_max_len)
+                        {
+                        this->m_exec_conf->msg->notice(9) << "Increasing shared mem list size per group "
+                            << m_max_len << "->" << *h_req_len.data << std::endl;
+                        m_max_len = *h_req_len.data;
+
+                        // the reject flags of the previous iteration were overwritten, restart the sweep
+                        reset_reject = true;
+                        continue;
+                        }
+                    }
+
                     {
                     ArrayHandle<unsigned int> h_condition(m_condition, access_location::host, access_mode::read);
                     if (*h_condition.data == 0)
@@ -1670,9 +1842,222 @@ void IntegratorHPMCMonoGPU< Shape >::update(uint64_t timestep)
     this->m_aabb_tree_invalid = true;
 
     // set current MPS value
-    hpmc_counters_t run_counters = this->getCounters(1);
     double cur_time = double(this->m_clock.getTime()) / Scalar(1e9);
-    this->m_mps = double(run_counters.getNMoves()) / cur_time;
+    bool defer_mps = this->m_sync_free;
+    #ifdef ENABLE_MPI
+    // the counters are reduced over all ranks, which must happen at the same point on every rank
+    if (this->m_comm)
+        defer_mps = false;
+    #endif
+
+    if (defer_mps)
+        {
+        m_mps_time = cur_time;
+        m_mps_deferred = true;
+        }
+    else
+        {
+        m_mps_deferred = false;
+        hpmc_counters_t run_counters = this->getCounters(1);
+        this->m_mps = double(run_counters.getNMoves()) / cur_time;
+        }
+    }
+
+/*! Reads back the counters at the start of the last step and computes the moves per second of the last step, if
+    update() left them on the device.
+*/
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::updateDeferredCounters()
+    {
+    if (m_count_step_start_deferred)
+        {
+        ArrayHandle<hpmc_counters_t> h_count_step_start(m_count_step_start_device, access_location::host,
+            access_mode::read);
+        this->m_count_step_start = h_count_step_start.data[0];
+        m_count_step_start_deferred = false;
+        }
+
+    if (m_mps_deferred)
+        {
+        // clear the flag first, getCounters() calls this method
+        m_mps_deferred = false;
+        hpmc_counters_t run_counters = this->getCounters(1);
+        this->m_mps = double(run_counters.getNMoves()) / m_mps_time;
+        }
+    }
+
+/*! \param max_count Number of overlaps to count exactly
+    \returns the number of overlaps if it is at most \a max_count, otherwise some number larger than \a max_count
+
+    Counts the overlaps with the cell list on the GPU, so that box moves do not need to copy the particle data to the
+    host and build the AABB tree. Falls back on the CPU implementation in boxes that are too small for the minimum
+    image convention.
+*/
+template< class Shape >
+unsigned int IntegratorHPMCMonoGPU< Shape >::countOverlapsUpTo(unsigned int max_count)
+    {
+    BoxDim global_box = this->m_pdata->getGlobalBox();
+    Scalar3 nearest_plane_distance = global_box.getNearestPlaneDistance();
+
+    if ((global_box.getPeriodic().x && nearest_plane_distance.x <= this->m_nominal_width*2) ||
+        (global_box.getPeriodic().y && nearest_plane_distance.y <= this->m_nominal_width*2) ||
+        (this->m_sysdef->getNDimensions() == 3 && global_box.getPeriodic().z && nearest_plane_distance.z <= this->m_nominal_width*2))
+        {
+        return IntegratorHPMCMono<Shape>::countOverlapsUpTo(max_count);
+        }
+
+    unsigned int overlap_count = 0;
+
+    if (this->m_pdata->getN() > 0)
+        {
+        // the particles may have moved without a time step, the forced update leaves the regular schedule unchanged
+        this->m_cl->forceCompute(0);
+
+        if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC count overlaps");
+
+        // if the cell list is a different size than last time, reinitialize the expanded cell list
+        uint3 cur_dim = this->m_cl->getDim();
+        if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z)
+            {
+            initializeExcellMem();
+
+            m_last_dim = cur_dim;
+            }
+
+        // make room for the expanded cells of the current local and ghost particles
+        reserveExcellIdx();
+
+            {
+            // access the cell list data
+            ArrayHandle<unsigned int> d_cell_size(this->m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_cell_idx(this->m_cl->getIndexArray(), access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_cell_adj(this->m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+            // per-device cell list data
+            const ArrayHandle<unsigned int>& d_cell_size_per_device = m_cl->getPerDevice() ?
+                ArrayHandle<unsigned int>(m_cl->getCellSizeArrayPerDevice(),access_location::device, access_mode::read) :
+                ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+            const ArrayHandle<unsigned int>& d_cell_idx_per_device = m_cl->getPerDevice() ?
+                ArrayHandle<unsigned int>(m_cl->getIndexArrayPerDevice(), access_location::device, access_mode::read) :
+                ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+
+            // expanded cells
+            ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
+            ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+            ArrayHandle< unsigned int > d_excell_offsets(m_excell_offsets, access_location::device, access_mode::overwrite);
+
+            // update the expanded cells
+            this->m_tuner_excell_block_size->begin();
+            gpu::hpmc_excell_csr(d_excell_idx.data,
+                                d_excell_size.data,
+                                d_excell_offsets.data,
+                                m_cl->getPerDevice() ? d_cell_idx_per_device.data : d_cell_idx.data,
+                                m_cl->getPerDevice() ? d_cell_size_per_device.data : d_cell_size.data,
+                                d_cell_adj.data,
+                                this->m_cl->getCellIndexer(),
+                                this->m_cl->getCellListIndexer(),
+                                this->m_cl->getCellAdjIndexer(),
+                                this->m_exec_conf->getNumActiveGPUs(),
+                                this->m_tuner_excell_block_size->getParam(),
+                                this->m_exec_conf->getCachedAllocator());
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+            this->m_tuner_excell_block_size->end();
+            }
+
+            {
+            // reset the counter
+            ArrayHandle<unsigned int> h_overlap_count(m_overlap_count, access_location::host, access_mode::overwrite);
+            *h_overlap_count.data = 0;
+            }
+
+            {
+            ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::read);
+            ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_tag(this->m_pdata->getTags(), access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_overlaps(this->m_overlaps, access_location::device, access_mode::read);
+
+            ArrayHandle<unsigned int> d_excell_idx(m_excell_idx, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_excell_size(m_excell_size, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_excell_offsets(m_excell_offsets, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_overlap_count(m_overlap_count, access_location::device, access_mode::readwrite);
+
+            auto & params = this->getParams();
+
+            m_tuner_count_overlaps->begin();
+            unsigned int param = m_tuner_count_overlaps->getParam();
+            unsigned int block_size = param / 1000000;
+            unsigned int stride = (param % 1000000 ) / 100;
+            unsigned int group_size = param % 100;
+
+            detail::hpmc_count_overlaps_args_t count_args(this->m_pdata->getN(),
+                                                          d_postype.data,
+                                                          d_orientation.data,
+                                                          d_tag.data,
+                                                          this->m_cl->getCellIndexer(),
+                                                          d_excell_idx.data,
+                                                          d_excell_size.data,
+                                                          d_excell_offsets.data,
+                                                          this->m_cl->getDim(),
+                                                          this->m_cl->getGhostWidth(),
+                                                          this->m_pdata->getNTypes(),
+                                                          this->m_pdata->getBox(),
+                                                          block_size,
+                                                          stride,
+                                                          group_size,
+                                                          max_count,
+                                                          d_overlap_count.data,
+                                                          d_overlaps.data,
+                                                          this->m_overlap_idx,
+                                                          this->m_exec_conf->dev_prop);
+
+            detail::gpu_hpmc_count_overlaps<Shape>(count_args, params.data());
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+            m_tuner_count_overlaps->end();
+            }
+
+        ArrayHandle<unsigned int> h_overlap_count(m_overlap_count, access_location::host, access_mode::read);
+        overlap_count = *h_overlap_count.data;
+
+        if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+        }
+
+    #ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        {
+        // a rank that stopped early already has more than max_count, so the sum does too
+        MPI_Allreduce(MPI_IN_PLACE, &overlap_count, 1, MPI_UNSIGNED, MPI_SUM, this->m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return overlap_count;
+    }
+
+/*! \param new_box The new global box
+
+    Scales the positions on the device, so that box moves do not copy the particle data to the host.
+*/
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::scaleBox(const BoxDim& new_box)
+    {
+    BoxDim old_box = this->m_pdata->getGlobalBox();
+
+    if (this->m_pdata->getN() > 0)
+        {
+        ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+
+        gpu::hpmc_scale_box(d_postype.data,
+                            this->m_pdata->getN(),
+                            old_box,
+                            new_box,
+                            128);
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    this->m_pdata->setGlobalBox(new_box);
+
+    // we have moved particles, communicate those changes
+    this->communicate(false);
     }
 
 template< class Shape >
@@ -1680,18 +2065,12 @@ void IntegratorHPMCMonoGPU< Shape >::initializeExcellMem()
     {
     this->m_exec_conf->msg->notice(4) << "hpmc resizing expanded cells" << std::endl;
 
-    // get the current cell dimensions
+    // the expanded cells are stored back to back in m_excell_idx, which is sized by reserveExcellIdx()
     unsigned int num_cells = this->m_cl->getCellIndexer().getNumElements();
-    unsigned int num_adj = this->m_cl->getCellAdjIndexer().getW();
-    unsigned int n_cell_list = this->m_cl->getPerDevice() ? this->m_exec_conf->getNumActiveGPUs() : 1;
-    unsigned int num_max = this->m_cl->getNmax()*n_cell_list;
-
-    // make the excell dimensions the same, but with room for Nmax*Nadj in each cell
-    m_excell_list_indexer = Index2D(num_max * num_adj, num_cells);
 
     // reallocate memory
-    m_excell_idx.resize(m_excell_list_indexer.getNumElements());
     m_excell_size.resize(num_cells);
+    m_excell_offsets.resize(num_cells);
 
     #if defined(__HIP_PLATFORM_NVCC__) && 0 // excell is currently not multi-GPU optimized, let the CUDA driver figure this out
     if (this->m_exec_conf->allConcurrentManagedAccess())
@@ -1700,14 +2079,67 @@ void IntegratorHPMCMonoGPU< Shape >::initializeExcellMem()
         auto gpu_map = this->m_exec_conf->getGPUIds();
         for (unsigned int idev = 0; idev < this->m_exec_conf->getNumActiveGPUs(); ++idev)
             {
-            cudaMemAdvise(m_excell_idx.get(), sizeof(unsigned int)*m_excell_idx.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             cudaMemAdvise(m_excell_size.get(), sizeof(unsigned int)*m_excell_size.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_excell_offsets.get(), sizeof(unsigned int)*m_excell_offsets.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
             CHECK_CUDA_ERROR();
             }
         }
     #endif
     }
 
+/*! The cell adjacency is symmetric, so every particle in the cell list appears in at most as many expanded cells
+    as there are neighbors per cell. This bounds the total size of the expanded cells without reading the cell sizes
+    back from the device.
+
+    m_excell_idx grows with some headroom for fluctuations in the number of ghosts. It is shrunk only after it has
+    been more than twice as large as needed for many consecutive builds, so that a transient spike in the particle
+    count (e.g. a compressed configuration) does not hold on to the memory for the rest of the run.
+*/
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::reserveExcellIdx()
+    {
+    const unsigned int shrink_period = 100;
+
+    uint64_t n_cell_particles = uint64_t(this->m_pdata->getN()) + uint64_t(this->m_pdata->getNGhosts());
+    uint64_t req_size = n_cell_particles*this->m_cl->getCellAdjIndexer().getW();
+
+    // the offsets into the expanded cells are 32 bit
+    if (req_size > uint64_t(UINT_MAX))
+        {
+        this->m_exec_conf->msg->error() << "hpmc: Too many particles in the expanded cells on this rank ("
+            << req_size << ")" << std::endl;
+        throw std::runtime_error("Error performing HPMC update");
+        }
+
+    uint64_t cur_size = m_excell_idx.getNumElements();
+    bool realloc = false;
+    if (req_size > cur_size)
+        {
+        realloc = true;
+        }
+    else if (cur_size > 2*req_size)
+        {
+        realloc = ++m_excell_idle_count >= shrink_period;
+        }
+    else
+        {
+        m_excell_idle_count = 0;
+        }
+
+    if (realloc)
+        {
+        uint64_t new_size = std::min(req_size + req_size/8 + 1, uint64_t(UINT_MAX));
+        this->m_exec_conf->msg->notice(4) << "hpmc resizing expanded cell storage to " << new_size << std::endl;
+
+        // the contents are rebuilt before every use, swap in a new array instead of copying the old one
+        GlobalArray<unsigned int> excell_idx(new_size, this->m_exec_conf);
+        m_excell_idx.swap(excell_idx);
+        TAG_ALLOCATION(m_excell_idx);
+
+        m_excell_idle_count = 0;
+        }
+    }
+
 template< class Shape >
 void IntegratorHPMCMonoGPU< Shape >::slotNumTypesChange()
     {
@@ -1774,14 +2206,76 @@ void IntegratorHPMCMonoGPU< Shape >::slotNumTypesChange()
         }
     }
 
+/*! The narrow phase kernels load the shape parameters into shared memory when they fit. Larger parameters, such as
+    the trees of non-convex polyhedra with many faces, are read from global memory and compete in the L2 cache with
+    the particle data streamed by every launch. Set an access policy window on the kernel streams so that the largest
+    frequently read array of all types stays resident in the persisting part of the L2 cache across launches.
+
+    This requires CUDA 11 and a device with a persisting L2 cache, and does nothing otherwise.
+*/
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::updatePersistingWindow()
+    {
+    #if defined(__HIP_PLATFORM_NVCC__) && (CUDART_VERSION >= 11000)
+    // the streams are created after the base class constructor first sets the parameters
+    if (m_narrow_phase_streams.size() == 0)
+        return;
+
+    const void *base_ptr = nullptr;
+    size_t num_bytes = 0;
+    for (unsigned int i = 0; i < this->m_pdata->getNTypes(); ++i)
+        {
+        Shape shape(quat<Scalar>(), this->m_params[i]);
+        const void *ptr;
+        size_t bytes;
+        getPersistingData(shape, ptr, bytes);
+        if (bytes > num_bytes)
+            {
+            base_ptr = ptr;
+            num_bytes = bytes;
+            }
+        }
+
+    for (int idev = this->m_exec_conf->getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        int gpu_id = this->m_exec_conf->getGPUIds()[idev];
+        int max_persisting_bytes = 0;
+        int max_window_bytes = 0;
+        cudaDeviceGetAttribute(&max_persisting_bytes, cudaDevAttrMaxPersistingL2CacheSize, gpu_id);
+        cudaDeviceGetAttribute(&max_window_bytes, cudaDevAttrMaxAccessPolicyWindowSize, gpu_id);
+        if (max_persisting_bytes == 0)
+            continue;
+
+        size_t window_bytes = std::min(num_bytes, size_t(max_window_bytes));
+        size_t persisting_bytes = std::min(window_bytes, size_t(max_persisting_bytes));
+
+        // a window of zero bytes resets the policy when the parameters no longer need it
+        cudaStreamAttrValue attr;
+        attr.accessPolicyWindow.base_ptr = const_cast<void *>(base_ptr);
+        attr.accessPolicyWindow.num_bytes = window_bytes;
+        attr.accessPolicyWindow.hitRatio = window_bytes ? float(persisting_bytes)/float(window_bytes) : 0.0f;
+        attr.accessPolicyWindow.hitProp = cudaAccessPropertyPersisting;
+        attr.accessPolicyWindow.missProp = cudaAccessPropertyStreaming;
+
+        hipSetDevice(gpu_id);
+        cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize, persisting_bytes);
+        cudaStreamSetAttribute(m_narrow_phase_streams[idev], cudaStreamAttributeAccessPolicyWindow, &attr);
+
+        for (auto s: m_depletant_streams)
+            cudaStreamSetAttribute(s[idev], cudaStreamAttributeAccessPolicyWindow, &attr);
+        }
+    CHECK_CUDA_ERROR();
+    #endif
+    }
+
 template< class Shape >
 void IntegratorHPMCMonoGPU< Shape >::updateCellWidth()
     {
     // call base class method
     IntegratorHPMCMono<Shape>::updateCellWidth();
 
-    // update the cell list
-    this->m_cl->setNominalWidth(this->m_nominal_width);
+    // update the cell list, analyzers sharing it need the extra width
+    this->m_cl->setNominalWidth(this->m_nominal_width + this->m_extra_ghost_width);
 
     #ifdef __HIP_PLATFORM_NVCC__
     // set memory hints
@@ -1799,6 +2293,8 @@ void IntegratorHPMCMonoGPU< Shape >::updateCellWidth()
         CHECK_CUDA_ERROR();
         }
 
+    updatePersistingWindow();
+
     // reinitialize poisson means array
     ArrayHandle<Scalar> h_lambda(m_lambda, access_location::host, access_mode::overwrite);
 
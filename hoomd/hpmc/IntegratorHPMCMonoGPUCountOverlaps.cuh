@@ -0,0 +1,340 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _INTEGRATOR_HPMC_MONO_GPU_COUNT_OVERLAPS_CUH_
+#define _INTEGRATOR_HPMC_MONO_GPU_COUNT_OVERLAPS_CUH_
+
+#include "hip/hip_runtime.h"
+#include "HPMCPrecisionSetup.h"
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/Index1D.h"
+
+#include "ComputeFreeVolumeGPU.cuh"
+
+/*! \file IntegratorHPMCMonoGPUCountOverlaps.cuh
+    \brief Declaration of CUDA kernels drivers for IntegratorHPMCMonoGPU::countOverlaps
+*/
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Wraps arguments to gpu_hpmc_count_overlaps
+/*! \ingroup hpmc_data_structs */
+struct hpmc_count_overlaps_args_t
+    {
+    //! Construct a hpmc_count_overlaps_args_t
+    hpmc_count_overlaps_args_t(
+                unsigned int _N,
+                const Scalar4 *_d_postype,
+                const Scalar4 *_d_orientation,
+                const unsigned int *_d_tag,
+                const Index3D& _ci,
+                const unsigned int *_d_excell_idx,
+                const unsigned int *_d_excell_size,
+                const unsigned int *_d_excell_offsets,
+                const uint3& _cell_dim,
+                const Scalar3 _ghost_width,
+                const unsigned int _num_types,
+                const BoxDim& _box,
+                const unsigned int _block_size,
+                const unsigned int _stride,
+                const unsigned int _group_size,
+                const unsigned int _max_count,
+                unsigned int *_d_overlap_count,
+                const unsigned int *_d_check_overlaps,
+                Index2D _overlap_idx,
+                const hipDeviceProp_t& _devprop
+                )
+                : N(_N),
+                  d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  d_tag(_d_tag),
+                  ci(_ci),
+                  d_excell_idx(_d_excell_idx),
+                  d_excell_size(_d_excell_size),
+                  d_excell_offsets(_d_excell_offsets),
+                  cell_dim(_cell_dim),
+                  ghost_width(_ghost_width),
+                  num_types(_num_types),
+                  box(_box),
+                  block_size(_block_size),
+                  stride(_stride),
+                  group_size(_group_size),
+                  max_count(_max_count),
+                  d_overlap_count(_d_overlap_count),
+                  d_check_overlaps(_d_check_overlaps),
+                  overlap_idx(_overlap_idx),
+                  devprop(_devprop)
+        {
+        };
+
+    unsigned int N;                         //!< Number of local particles
+    const Scalar4 *d_postype;               //!< postype array
+    const Scalar4 *d_orientation;           //!< orientation array
+    const unsigned int *d_tag;              //!< Particle tags
+    const Index3D& ci;                      //!< Cell indexer
+    const unsigned int *d_excell_idx;       //!< Expanded cell neighbors
+    const unsigned int *d_excell_size;      //!< Size of expanded cell list per cell
+    const unsigned int *d_excell_offsets;   //!< Offset of each expanded cell in d_excell_idx
+    const uint3& cell_dim;                  //!< Cell dimensions
+    const Scalar3 ghost_width;              //!< Width of ghost layer
+    const unsigned int num_types;           //!< Number of particle types
+    const BoxDim& box;                      //!< Current simulation box
+    unsigned int block_size;                //!< Block size to execute
+    unsigned int stride;                    //!< Number of threads per overlap check
+    unsigned int group_size;                //!< Size of the group to execute
+    unsigned int max_count;                 //!< Stop counting after more than this many overlaps
+    unsigned int *d_overlap_count;          //!< Number of overlapping pairs (output, initialized by the caller)
+    const unsigned int *d_check_overlaps;   //!< Interaction matrix
+    Index2D overlap_idx;                    //!< Interaction matrix indexer
+    const hipDeviceProp_t& devprop;         //!< CUDA device properties
+    };
+
+template< class Shape >
+hipError_t gpu_hpmc_count_overlaps(const hpmc_count_overlaps_args_t &args, const typename Shape::param_type *d_params);
+
+#ifdef __HIPCC__
+
+//! Kernel to count the overlapping pairs of particles
+/*! One group of threads tests one local particle against the particles in its expanded cell, and adds the number of
+    overlapping pairs to \a d_overlap_count. Every pair is counted once, by the particle with the lower tag. Groups
+    stop as soon as more than \a max_count overlaps have been recorded, so the count is only exact up to
+    \a max_count.
+
+    \param N Number of local particles
+    \param d_postype Particle positions and types by index
+    \param d_orientation Particle orientation
+    \param d_tag Particle tags
+    \param ci Cell indexer
+    \param d_excell_idx Expanded cell neighbors
+    \param d_excell_size Size of the expanded cells
+    \param d_excell_offsets Offset of each expanded cell in d_excell_idx
+    \param cell_dim Dimensions of the cell list
+    \param ghost_width Width of ghost layer
+    \param num_types Number of particle types
+    \param box Simulation box
+    \param max_count Stop after more than this many overlaps
+    \param d_overlap_count Number of overlapping pairs (output value)
+    \param d_check_overlaps Per-type pair interaction matrix
+    \param overlap_idx Indexer into the interaction matrix
+    \param d_params Per-type shape parameters
+    \param max_extra_bytes Shared memory available for the shape parameters
+*/
+template< class Shape >
+__global__ void gpu_hpmc_count_overlaps_kernel(unsigned int N,
+                                               const Scalar4 *d_postype,
+                                               const Scalar4 *d_orientation,
+                                               const unsigned int *d_tag,
+                                               const Index3D ci,
+                                               const unsigned int *d_excell_idx,
+                                               const unsigned int *d_excell_size,
+                                               const unsigned int *d_excell_offsets,
+                                               const uint3 cell_dim,
+                                               const Scalar3 ghost_width,
+                                               const unsigned int num_types,
+                                               const BoxDim box,
+                                               const unsigned int max_count,
+                                               unsigned int *d_overlap_count,
+                                               const unsigned int *d_check_overlaps,
+                                               Index2D overlap_idx,
+                                               const typename Shape::param_type *d_params,
+                                               unsigned int max_extra_bytes)
+    {
+    unsigned int group = threadIdx.z;
+    unsigned int offset = threadIdx.y;
+    unsigned int group_size = blockDim.y;
+    unsigned int n_groups = blockDim.z;
+
+    // determine particle idx
+    unsigned int i = blockIdx.x * n_groups + group;
+
+    // load the per type pair parameters into shared memory
+    HIP_DYNAMIC_SHARED( char, s_data)
+    typename Shape::param_type *s_params = (typename Shape::param_type *)(&s_data[0]);
+    unsigned int *s_check_overlaps = (unsigned int *) (s_params + num_types);
+    unsigned int ntyppairs = overlap_idx.getNumElements();
+
+    // copy over parameters one int per thread for fast loads
+        {
+        unsigned int tidx = threadIdx.x+blockDim.x*threadIdx.y + blockDim.x*blockDim.y*threadIdx.z;
+        unsigned int block_size = blockDim.x*blockDim.y*blockDim.z;
+        unsigned int param_size = num_types*sizeof(typename Shape::param_type) / sizeof(int);
+
+        for (unsigned int cur_offset = 0; cur_offset < param_size; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < param_size)
+                {
+                ((int *)s_params)[cur_offset + tidx] = ((int *)d_params)[cur_offset + tidx];
+                }
+            }
+
+        for (unsigned int cur_offset = 0; cur_offset < ntyppairs; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < ntyppairs)
+                {
+                s_check_overlaps[cur_offset + tidx] = d_check_overlaps[cur_offset + tidx];
+                }
+            }
+        }
+
+    __syncthreads();
+
+    // initialize extra shared mem
+    char *s_extra = (char *)(s_check_overlaps + ntyppairs);
+
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int cur_type = 0; cur_type < num_types; ++cur_type)
+        s_params[cur_type].load_shared(s_extra, available_bytes);
+
+    __syncthreads();
+
+    if (i >= N)
+        return;
+
+    // other blocks may have found enough overlaps already
+    if (*((volatile unsigned int *)d_overlap_count) > max_count)
+        return;
+
+    Scalar4 postype_i = d_postype[i];
+    vec3<Scalar> pos_i(postype_i);
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    unsigned int tag_i = d_tag[i];
+    Shape shape_i(quat<Scalar>(), s_params[typ_i]);
+    if (shape_i.hasOrientation())
+        shape_i.orientation = quat<Scalar>(d_orientation[i]);
+
+    // find the cell of the particle
+    unsigned int my_cell = compute_cell_idx(vec_to_scalar3(pos_i), box, ghost_width, cell_dim, ci);
+
+    // loop over neighboring cells and check for overlaps
+    unsigned int excell_size = d_excell_size[my_cell];
+    unsigned int excell_start = d_excell_offsets[my_cell];
+
+    for (unsigned int k = 0; k < excell_size; k += group_size)
+        {
+        unsigned int local_k = k + offset;
+        if (local_k < excell_size)
+            {
+            // read in position, and orientation of neighboring particle
+            unsigned int j = __ldg(&d_excell_idx[excell_start + local_k]);
+
+            // count every pair once
+            if (j == i || __ldg(d_tag + j) < tag_i)
+                continue;
+
+            Scalar4 postype_j = __ldg(d_postype + j);
+            unsigned int typ_j = __scalar_as_int(postype_j.w);
+            Shape shape_j(quat<Scalar>(), s_params[typ_j]);
+            if (shape_j.hasOrientation())
+                shape_j.orientation = quat<Scalar>(__ldg(d_orientation + j));
+
+            // put particle j into the coordinate system of particle i
+            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i;
+            r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
+
+            // check for overlaps
+            OverlapReal rsq = dot(r_ij,r_ij);
+            OverlapReal DaDb = shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+
+            if (rsq*OverlapReal(4.0) <= DaDb * DaDb)
+                {
+                // circumsphere overlap
+                unsigned int err_count;
+                if (s_check_overlaps[overlap_idx(typ_i, typ_j)]
+                    && test_overlap(r_ij, shape_i, shape_j, err_count)
+                    && test_overlap(-r_ij, shape_j, shape_i, err_count))
+                    {
+                    if (atomicAdd(d_overlap_count, 1) >= max_count)
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+//! Kernel driver for gpu_hpmc_count_overlaps_kernel()
+/*! \param args Bundled arguments
+    \param d_params Per-type shape parameters
+    \returns Error codes generated by any CUDA calls, or hipSuccess when there is no error
+
+    This templatized method is the kernel driver for counting overlaps of any shape. It is instantiated for every shape
+    in kernel_count_overlaps.cu.in.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+hipError_t gpu_hpmc_count_overlaps(const hpmc_count_overlaps_args_t& args, const typename Shape::param_type *d_params)
+    {
+    assert(args.d_postype);
+    assert(args.d_orientation);
+    assert(args.d_overlap_count);
+    assert(args.group_size >= 1);
+    assert(args.group_size <= (unsigned int)args.devprop.warpSize);
+    assert(args.block_size%(args.stride*args.group_size)==0);
+
+    // determine the maximum block size and clamp the input block size down
+    static int max_block_size = -1;
+    static hipFuncAttributes attr;
+    if (max_block_size == -1)
+        {
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(gpu_hpmc_count_overlaps_kernel<Shape>));
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    // setup the grid to run the kernel
+    unsigned int n_groups = min(args.block_size, (unsigned int)max_block_size) / args.group_size / args.stride;
+
+    dim3 threads(args.stride, args.group_size, n_groups);
+    dim3 grid( args.N / n_groups + 1, 1, 1);
+
+    unsigned int shared_bytes = (unsigned int)(args.num_types * sizeof(typename Shape::param_type)
+        + args.overlap_idx.getNumElements()*sizeof(unsigned int));
+
+    unsigned int max_extra_bytes = static_cast<unsigned int>(args.devprop.sharedMemPerBlock - attr.sharedSizeBytes - shared_bytes);
+
+    // determine dynamically requested shared memory
+    char *ptr = (char *)nullptr;
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int i = 0; i < args.num_types; ++i)
+        {
+        d_params[i].allocate_shared(ptr, available_bytes);
+        }
+    unsigned int extra_bytes = max_extra_bytes - available_bytes;
+
+    shared_bytes += extra_bytes;
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_hpmc_count_overlaps_kernel<Shape>), dim3(grid), dim3(threads), shared_bytes, 0,
+                                                     args.N,
+                                                     args.d_postype,
+                                                     args.d_orientation,
+                                                     args.d_tag,
+                                                     args.ci,
+                                                     args.d_excell_idx,
+                                                     args.d_excell_size,
+                                                     args.d_excell_offsets,
+                                                     args.cell_dim,
+                                                     args.ghost_width,
+                                                     args.num_types,
+                                                     args.box,
+                                                     args.max_count,
+                                                     args.d_overlap_count,
+                                                     args.d_check_overlaps,
+                                                     args.overlap_idx,
+                                                     d_params,
+                                                     max_extra_bytes);
+
+    return hipSuccess;
+    }
+
+#endif // __HIPCC__
+
+}; // end namespace detail
+
+} // end namespace hpmc
+
+#endif // _INTEGRATOR_HPMC_MONO_GPU_COUNT_OVERLAPS_CUH_
@@ -9,6 +9,7 @@
 
 #include <thrust/device_ptr.h>
 #include <thrust/reduce.h>
+#include <thrust/scan.h>
 #include <thrust/execution_policy.h>
 
 namespace hpmc
@@ -155,6 +156,52 @@ __global__ void hpmc_depletants_accept(
         atomicAdd(&d_reject_out[i], 1);
     }
 
+//! Compute the number of blocks that insert the depletants of every particle
+/*! The cost of a depletant is estimated by the number of passes a group of threads makes over the neighbors in the
+    expanded cell of particle i, so that particles in dense regions are spread over more blocks.
+*/
+__global__ void count_depletant_blocks(const Scalar4 *d_postype,
+                                       const unsigned int *d_reject_out_of_cell,
+                                       const unsigned int *d_n_depletants,
+                                       const unsigned int *d_excell_size,
+                                       const BoxDim box,
+                                       const Scalar3 ghost_width,
+                                       const uint3 cell_dim,
+                                       const Index3D ci,
+                                       const unsigned int depletants_per_block,
+                                       const unsigned int threads_per_block,
+                                       const unsigned int group_size,
+                                       const unsigned int work_offset,
+                                       const unsigned int nwork,
+                                       unsigned int *d_n_blocks)
+    {
+    unsigned int idx = threadIdx.x + blockDim.x*blockIdx.x;
+
+    if (idx >= nwork)
+        return;
+
+    idx += work_offset;
+
+    unsigned int n_depletants = d_n_depletants[idx];
+    unsigned int n_blocks = 0;
+
+    // particles that left their cell are rejected without inserting depletants
+    if (n_depletants && !d_reject_out_of_cell[idx])
+        {
+        Scalar4 postype_i = d_postype[idx];
+        unsigned int my_cell = computeParticleCell(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_width,
+            cell_dim, ci, false);
+        unsigned long long cost = 1 + d_excell_size[my_cell]/group_size;
+
+        n_blocks = (unsigned int)(n_depletants*cost/depletants_per_block) + 1;
+
+        // every thread handles at least one depletant
+        n_blocks = min(n_blocks, (n_depletants-1)/threads_per_block + 1);
+        }
+
+    d_n_blocks[idx] = n_blocks;
+    }
+
 } // end namespace kernel
 
 void generate_num_depletants(const uint16_t seed,
@@ -319,6 +366,79 @@ void get_max_num_depletants_ntrial(const unsigned int ntrial,
         }
     }
 
+void get_num_depletant_blocks(const Scalar4 *d_postype,
+                              const unsigned int *d_reject_out_of_cell,
+                              const unsigned int *d_n_depletants,
+                              const unsigned int *d_excell_size,
+                              const BoxDim& box,
+                              const Scalar3 ghost_width,
+                              const uint3 cell_dim,
+                              const Index3D ci,
+                              const unsigned int depletants_per_block,
+                              const unsigned int threads_per_block,
+                              const unsigned int group_size,
+                              unsigned int *d_block_end,
+                              unsigned int *n_blocks,
+                              const hipStream_t *streams,
+                              const GPUPartition& gpu_partition,
+                              CachedAllocator& alloc)
+    {
+    assert(d_block_end);
+
+    // determine the maximum block size and clamp the input block size down
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(kernel::count_depletant_blocks));
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(256u, max_block_size);
+
+    thrust::device_ptr<unsigned int> block_end(d_block_end);
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
+
+        n_blocks[idev] = 0;
+        if (nwork == 0)
+            continue;
+
+        hipLaunchKernelGGL(kernel::count_depletant_blocks, nwork/run_block_size+1, run_block_size, 0, streams[idev],
+            d_postype,
+            d_reject_out_of_cell,
+            d_n_depletants,
+            d_excell_size,
+            box,
+            ghost_width,
+            cell_dim,
+            ci,
+            depletants_per_block,
+            threads_per_block,
+            group_size,
+            range.first,
+            nwork,
+            d_block_end);
+
+        // convert to the end of the range of blocks for every particle
+        #ifdef __HIP_PLATFORM_HCC__
+        thrust::inclusive_scan(thrust::hip::par(alloc).on(streams[idev]),
+        #else
+        thrust::inclusive_scan(thrust::cuda::par(alloc).on(streams[idev]),
+        #endif
+            block_end + range.first,
+            block_end + range.second,
+            block_end + range.first);
+
+        // the grid size is needed on the host
+        hipMemcpyAsync(&n_blocks[idev], d_block_end + range.second - 1, sizeof(unsigned int), hipMemcpyDeviceToHost,
+            streams[idev]);
+        hipStreamSynchronize(streams[idev]);
+        }
+    }
+
 void reduce_counters(const unsigned int ngpu,
                      const unsigned int pitch,
                      const hpmc_counters_t *d_per_device_counters,
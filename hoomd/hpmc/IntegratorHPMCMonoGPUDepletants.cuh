@@ -20,6 +20,7 @@
 #include "HPMCMiscFunctions.h"
 
 #include <cassert>
+#include <vector>
 
 // data types and function definitions
 #include "IntegratorHPMCMonoGPUDepletantsTypes.cuh"
@@ -53,7 +54,7 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
                                      hpmc_counters_t *d_counters,
                                      const unsigned int *d_excell_idx,
                                      const unsigned int *d_excell_size,
-                                     const Index2D excli,
+                                     const unsigned int *d_excell_offsets,
                                      const uint3 cell_dim,
                                      const Scalar3 ghost_width,
                                      const Index3D ci,
@@ -80,7 +81,9 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
                                      bool repulsive,
                                      unsigned int work_offset,
                                      unsigned int max_depletant_queue_size,
-                                     const unsigned int *d_n_depletants)
+                                     const unsigned int *d_n_depletants,
+                                     const unsigned int *d_block_end,
+                                     const unsigned int nwork)
     {
     // variables to tell what type of thread we are
     unsigned int group = threadIdx.z;
@@ -164,8 +167,33 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
 
     __syncthreads();
 
-    // identify the active cell that this thread handles
-    unsigned int i = blockIdx.x + work_offset;
+    // identify the particle that this block handles, and the position of the block among those of the particle
+    unsigned int i, gidx, blocks_per_particle;
+    if (d_block_end)
+        {
+        // binary search for the first particle whose range of blocks ends after this block
+        unsigned int lo = work_offset;
+        unsigned int hi = work_offset + nwork;
+        while (lo < hi)
+            {
+            unsigned int mid = lo + (hi - lo)/2;
+            if (d_block_end[mid] <= blockIdx.x)
+                lo = mid + 1;
+            else
+                hi = mid;
+            }
+        i = lo;
+
+        unsigned int block_begin = (i > work_offset) ? d_block_end[i-1] : 0;
+        gidx = blockIdx.x - block_begin;
+        blocks_per_particle = d_block_end[i] - block_begin;
+        }
+    else
+        {
+        i = blockIdx.x + work_offset;
+        gidx = gridDim.y*blockIdx.z+blockIdx.y;
+        blocks_per_particle = gridDim.y*gridDim.z;
+        }
 
     // if this particle is rejected a priori because it has left the cell, don't check overlaps
     // and avoid out of range memory access when computing the cell
@@ -236,8 +264,6 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
 
     __syncthreads();
 
-    unsigned int gidx = gridDim.y*blockIdx.z+blockIdx.y;
-    unsigned int blocks_per_particle = gridDim.y*gridDim.z;
     unsigned int i_dep = group_size*group+offset + gidx*group_size*n_groups;
 
     while (s_adding_depletants)
@@ -368,11 +394,13 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
 
         // counters to track progress through the loop over potential neighbors
         unsigned int excell_size;
+        unsigned int excell_start;
         unsigned int k = offset;
 
         if (active)
             {
             excell_size = d_excell_size[my_cell];
+            excell_start = d_excell_offsets[my_cell];
 
             if (master)
                 overlap_checks += excell_size;
@@ -390,7 +418,7 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
                 // prefetch j
                 unsigned int j, next_j = 0;
                 if (k < excell_size)
-                    next_j = __ldg(&d_excell_idx[excli(k, my_cell)]);
+                    next_j = __ldg(&d_excell_idx[excell_start + k]);
 
                 // add to the queue as long as the queue is not full, and we have not yet reached the end of our own list
                 // and as long as no overlaps have been found
@@ -407,7 +435,7 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
                     j = next_j;
 
                     if (k < excell_size)
-                        next_j = __ldg(&d_excell_idx[excli(k, my_cell)]);
+                        next_j = __ldg(&d_excell_idx[excell_start + k]);
 
                     // has j been updated? ghost particles are not updated
 
@@ -616,7 +644,7 @@ __global__ void hpmc_insert_depletants(const Scalar4 *d_trial_postype,
 
         Shape shape_i(quat<Scalar>(quat<Scalar>()), s_params[s_type_i]);
         bool ignore_stats = shape_i.ignoreStatistics();
-        if (!ignore_stats && blockIdx.y == 0 && blockIdx.z == 0)
+        if (!ignore_stats && gidx == 0)
             {
             // increment number of inserted depletants
             #if (__CUDA_ARCH__ >= 600)
@@ -707,6 +735,29 @@ void depletants_launcher(const hpmc_args_t& args, const hpmc_implicit_args_t& im
         // setup the grid to run the kernel
         dim3 threads(1, tpp, n_groups);
 
+        // in load balanced mode, size the work of every particle individually
+        std::vector<unsigned int> n_blocks(args.gpu_partition.getNumActiveGPUs());
+        if (implicit_args.d_block_end)
+            {
+            assert(implicit_args.alloc);
+            get_num_depletant_blocks(args.d_postype,
+                args.d_reject_out_of_cell,
+                implicit_args.d_n_depletants,
+                args.d_excell_size,
+                args.box,
+                args.ghost_width,
+                args.cell_dim,
+                args.ci,
+                implicit_args.depletants_per_thread*n_groups*tpp,
+                n_groups*tpp,
+                tpp,
+                implicit_args.d_block_end,
+                &n_blocks.front(),
+                implicit_args.streams,
+                args.gpu_partition,
+                *implicit_args.alloc);
+            }
+
         for (int idev = args.gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
             {
             auto range = args.gpu_partition.getRangeAndSetGPU(idev);
@@ -714,15 +765,26 @@ void depletants_launcher(const hpmc_args_t& args, const hpmc_implicit_args_t& im
             if (range.first == range.second)
                 continue;
 
-            unsigned int blocks_per_particle = implicit_args.max_n_depletants[idev] /
-                (implicit_args.depletants_per_thread*n_groups*tpp) + 1;
-
-            dim3 grid( range.second-range.first, blocks_per_particle, 1);
+            dim3 grid;
+            if (implicit_args.d_block_end)
+                {
+                if (n_blocks[idev] == 0)
+                    continue;
 
-            if (blocks_per_particle > static_cast<unsigned int>(args.devprop.maxGridSize[1]))
+                grid = dim3(n_blocks[idev], 1, 1);
+                }
+            else
                 {
-                grid.y = args.devprop.maxGridSize[1];
-                grid.z = blocks_per_particle/args.devprop.maxGridSize[1]+1;
+                unsigned int blocks_per_particle = implicit_args.max_n_depletants[idev] /
+                    (implicit_args.depletants_per_thread*n_groups*tpp) + 1;
+
+                grid = dim3( range.second-range.first, blocks_per_particle, 1);
+
+                if (blocks_per_particle > static_cast<unsigned int>(args.devprop.maxGridSize[1]))
+                    {
+                    grid.y = args.devprop.maxGridSize[1];
+                    grid.z = blocks_per_particle/args.devprop.maxGridSize[1]+1;
+                    }
                 }
 
             assert(args.d_trial_postype);
@@ -751,7 +813,7 @@ void depletants_launcher(const hpmc_args_t& args, const hpmc_implicit_args_t& im
                                  args.d_counters + idev*args.counters_pitch,
                                  args.d_excell_idx,
                                  args.d_excell_size,
-                                 args.excli,
+                                 args.d_excell_offsets,
                                  args.cell_dim,
                                  args.ghost_width,
                                  args.ci,
@@ -778,7 +840,9 @@ void depletants_launcher(const hpmc_args_t& args, const hpmc_implicit_args_t& im
                                  implicit_args.repulsive,
                                  range.first,
                                  max_depletant_queue_size,
-                                 implicit_args.d_n_depletants);
+                                 implicit_args.d_n_depletants,
+                                 implicit_args.d_block_end,
+                                 range.second-range.first);
             }
         }
     else
@@ -52,7 +52,7 @@ __global__ void hpmc_insert_depletants_phase2(const Scalar4 *d_trial_postype,
                                      hpmc_counters_t *d_counters,
                                      const unsigned int *d_excell_idx,
                                      const unsigned int *d_excell_size,
-                                     const Index2D excli,
+                                     const unsigned int *d_excell_offsets,
                                      const uint3 cell_dim,
                                      const Scalar3 ghost_width,
                                      const Index3D ci,
@@ -387,11 +387,13 @@ __global__ void hpmc_insert_depletants_phase2(const Scalar4 *d_trial_postype,
 
         // counters to track progress through the loop over potential neighbors
         unsigned int excell_size;
+        unsigned int excell_start;
         unsigned int k = offset;
 
         if (active)
             {
             excell_size = d_excell_size[my_cell];
+            excell_start = d_excell_offsets[my_cell];
 
             if (master)
                 overlap_checks += 2*excell_size;
@@ -409,7 +411,7 @@ __global__ void hpmc_insert_depletants_phase2(const Scalar4 *d_trial_postype,
                 // prefetch j
                 unsigned int j, next_j = 0;
                 if ((k >> 1) < excell_size)
-                    next_j = __ldg(&d_excell_idx[excli(k >> 1, my_cell)]);
+                    next_j = __ldg(&d_excell_idx[excell_start + (k >> 1)]);
 
                 // add to the queue as long as the queue is not full, and we have not yet reached the end of our own list
                 while (s_queue_size < max_queue_size && (k >> 1) < excell_size)
@@ -422,7 +424,7 @@ __global__ void hpmc_insert_depletants_phase2(const Scalar4 *d_trial_postype,
                     j = next_j;
 
                     if ((k>>1) < excell_size)
-                        next_j = __ldg(&d_excell_idx[excli(k >> 1, my_cell)]);
+                        next_j = __ldg(&d_excell_idx[excell_start + (k >> 1)]);
 
                     unsigned int tag_j = d_tag[j];
 
@@ -803,7 +805,7 @@ void depletants_launcher_phase2(const hpmc_args_t& args,
                                  args.d_counters + idev*args.counters_pitch,
                                  args.d_excell_idx,
                                  args.d_excell_size,
-                                 args.excli,
+                                 args.d_excell_offsets,
                                  args.cell_dim,
                                  args.ghost_width,
                                  args.ci,
@@ -43,7 +43,9 @@ struct hpmc_implicit_args_t
                   d_n_depletants(_d_n_depletants),
                   max_n_depletants(_max_n_depletants),
                   depletants_per_thread(_depletants_per_thread),
-                  streams(_streams)
+                  streams(_streams),
+                  d_block_end(0),
+                  alloc(0)
         { };
 
     const unsigned int depletant_type_a;           //!< Particle type of first depletant
@@ -56,6 +58,8 @@ struct hpmc_implicit_args_t
     const unsigned int *max_n_depletants;          //!< Maximum number of depletants inserted per particle, per device
     unsigned int depletants_per_thread;             //!< Controls parallelism (number of depletant loop iterations per group)
     const hipStream_t *streams;                    //!< Stream for this depletant type
+    unsigned int *d_block_end;                     //!< Inclusive sum of blocks per particle, NULL to size the grid by the maximum
+    CachedAllocator *alloc;                        //!< Allocator for the prefix sum over blocks per particle
     };
 
 //! Driver for kernel::hpmc_insert_depletants()
@@ -82,6 +86,23 @@ void get_max_num_depletants(unsigned int *d_n_depletants,
                             const GPUPartition& gpu_partition,
                             CachedAllocator& alloc);
 
+void get_num_depletant_blocks(const Scalar4 *d_postype,
+                              const unsigned int *d_reject_out_of_cell,
+                              const unsigned int *d_n_depletants,
+                              const unsigned int *d_excell_size,
+                              const BoxDim& box,
+                              const Scalar3 ghost_width,
+                              const uint3 cell_dim,
+                              const Index3D ci,
+                              const unsigned int depletants_per_block,
+                              const unsigned int threads_per_block,
+                              const unsigned int group_size,
+                              unsigned int *d_block_end,
+                              unsigned int *n_blocks,
+                              const hipStream_t *streams,
+                              const GPUPartition& gpu_partition,
+                              CachedAllocator& alloc);
+
 void reduce_counters(const unsigned int ngpu,
     const unsigned int pitch,
     const hpmc_counters_t *d_per_device_counters,
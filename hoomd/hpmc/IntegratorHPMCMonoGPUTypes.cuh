@@ -10,6 +10,7 @@
 #include "hoomd/BoxDim.h"
 #include "hoomd/hpmc/HPMCCounters.h"
 #include "hoomd/GPUPartition.cuh"
+#include "hoomd/CachedAllocator.h"
 
 namespace hpmc {
 
@@ -55,7 +56,7 @@ struct hpmc_args_t
                 const unsigned int *_d_update_order_by_ptl,
                 unsigned int *_d_excell_idx,
                 const unsigned int *_d_excell_size,
-                const Index2D& _excli,
+                const unsigned int *_d_excell_offsets,
                 const unsigned int *_d_reject_in,
                 unsigned int *_d_reject_out,
                 const hipDeviceProp_t &_devprop,
@@ -96,7 +97,7 @@ struct hpmc_args_t
                   d_update_order_by_ptl(_d_update_order_by_ptl),
                   d_excell_idx(_d_excell_idx),
                   d_excell_size(_d_excell_size),
-                  excli(_excli),
+                  d_excell_offsets(_d_excell_offsets),
                   d_reject_in(_d_reject_in),
                   d_reject_out(_d_reject_out),
                   devprop(_devprop),
@@ -140,7 +141,7 @@ struct hpmc_args_t
     const unsigned int *d_update_order_by_ptl;  //!< Lookup of update order by particle index
     unsigned int *d_excell_idx;       //!< Expanded cell list
     const unsigned int *d_excell_size;//!< Size of expanded cells
-    const Index2D& excli;             //!< Excell indexer
+    const unsigned int *d_excell_offsets; //!< Offset of each expanded cell
     const unsigned int *d_reject_in;  //!< Reject flags per particle (in)
     unsigned int *d_reject_out;       //!< Reject flags per particle (out)
     const hipDeviceProp_t& devprop;     //!< CUDA device properties
@@ -221,6 +222,20 @@ void hpmc_excell(unsigned int *d_excell_idx,
                  const unsigned int ngpu,
                  const unsigned int block_size);
 
+//! Driver for kernel::hpmc_excell_count() and kernel::hpmc_excell_fill()
+void hpmc_excell_csr(unsigned int *d_excell_idx,
+                     unsigned int *d_excell_size,
+                     unsigned int *d_excell_offsets,
+                     const unsigned int *d_cell_idx,
+                     const unsigned int *d_cell_size,
+                     const unsigned int *d_cell_adj,
+                     const Index3D& ci,
+                     const Index2D& cli,
+                     const Index2D& cadji,
+                     const unsigned int ngpu,
+                     const unsigned int block_size,
+                     CachedAllocator& alloc);
+
 //! Kernel driver for kernel::hpmc_shift()
 void hpmc_shift(Scalar4 *d_postype,
                 int3 *d_image,
@@ -229,6 +244,13 @@ void hpmc_shift(Scalar4 *d_postype,
                 const Scalar3 shift,
                 const unsigned int block_size);
 
+//! Kernel driver for kernel::hpmc_scale_box()
+void hpmc_scale_box(Scalar4 *d_postype,
+                    const unsigned int N,
+                    const BoxDim& old_box,
+                    const BoxDim& new_box,
+                    const unsigned int block_size);
+
 //! Kernel to evaluate convergence
 void hpmc_check_convergence(
      const unsigned int *d_trial_move_type,
@@ -387,9 +387,55 @@ class SupportFuncConvexPolyhedron
                         break;
                         }
                     }
+                #elif !defined(__HIPCC__) && defined(__AVX__)
+                // in double precision, process dot products with AVX 4 at a time. Each channel tracks the first
+                // maximum of every 4th vertex and the channels are combined in order, with the dot products summed in
+                // the same order as dot(). This selects the same vertex as the serial code below.
+                __m256d nx_v = _mm256_broadcast_sd(&n.x);
+                __m256d ny_v = _mm256_broadcast_sd(&n.y);
+                __m256d nz_v = _mm256_broadcast_sd(&n.z);
+
+                __m256d max_dot_v = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(nx_v, _mm256_load_pd(verts.x.get())),
+                                                                _mm256_mul_pd(ny_v, _mm256_load_pd(verts.y.get()))),
+                                                  _mm256_mul_pd(nz_v, _mm256_load_pd(verts.z.get())));
+                __m256d idx_v = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+                __m256d max_idx_v = idx_v;
+                const __m256d four_v = _mm256_set1_pd(4.0);
+
+                for (unsigned int i = 4; i < verts.N; i+=4)
+                    {
+                    __m256d x_v = _mm256_load_pd(verts.x.get() + i);
+                    __m256d y_v = _mm256_load_pd(verts.y.get() + i);
+                    __m256d z_v = _mm256_load_pd(verts.z.get() + i);
+                    idx_v = _mm256_add_pd(idx_v, four_v);
+
+                    __m256d d_v = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(nx_v, x_v), _mm256_mul_pd(ny_v, y_v)),
+                                                _mm256_mul_pd(nz_v, z_v));
+
+                    // keep the first maximum in each channel
+                    __m256d greater_v = _mm256_cmp_pd(d_v, max_dot_v, _CMP_GT_OQ);
+                    max_dot_v = _mm256_blendv_pd(max_dot_v, d_v, greater_v);
+                    max_idx_v = _mm256_blendv_pd(max_idx_v, idx_v, greater_v);
+                    }
+
+                double d_s[4] __attribute__((aligned(32)));
+                double idx_s[4] __attribute__((aligned(32)));
+                _mm256_store_pd(d_s, max_dot_v);
+                _mm256_store_pd(idx_s, max_idx_v);
+
+                max_dot = d_s[0];
+                max_idx = (unsigned int)idx_s[0];
+                for (unsigned int k = 1; k < 4; k++)
+                    {
+                    if (d_s[k] > max_dot)
+                        {
+                        max_dot = d_s[k];
+                        max_idx = (unsigned int)idx_s[k];
+                        }
+                    }
                 #else
 
-                // if no AVX or SSE, or running in double precision, fall back on serial computation
+                // otherwise fall back on serial computation
                 // this code path also triggers on the GPU
 
                 OverlapReal max_dot0 = dot(n, vec3<OverlapReal>(verts.x[0], verts.y[0], verts.z[0]));
@@ -801,16 +847,17 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
                                  const ShapeConvexPolyhedron& b,
                                  unsigned int& err)
     {
-    vec3<OverlapReal> dr(r_ab);
-
     OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
 
-    return detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts),
-                                  detail::SupportFuncConvexPolyhedron(b.verts),
-                                  rotate(conj(quat<OverlapReal>(a.orientation)), dr),
-                                  conj(quat<OverlapReal>(a.orientation))* quat<OverlapReal>(b.orientation),
-                                  DaDb/OverlapReal(2.0),
-                                  err);
+    // near contacts are re-checked in double precision when OverlapReal is float
+    vec3<double> dr_double(r_ab);
+    quat<double> qa(a.orientation);
+    return detail::xenocollide_3d_mixed(detail::SupportFuncConvexPolyhedron(a.verts),
+                                        detail::SupportFuncConvexPolyhedron(b.verts),
+                                        rotate(conj(qa), dr_double),
+                                        conj(qa) * quat<double>(b.orientation),
+                                        DaDb/OverlapReal(2.0),
+                                        err);
 
     /*
     return detail::gjke_3d(detail::SupportFuncConvexPolyhedron(a.verts),
@@ -1119,6 +1119,15 @@ inline std::string getShapeSpec(const ShapePolyhedron& s)
         }
     return shapedef.str();
     }
+
+/// The node boxes of the tree are read on every step of the tree traversal
+template<>
+inline void getPersistingData(const ShapePolyhedron& s, const void *& ptr, size_t& bytes)
+    {
+    const ManagedArray<detail::CompactOBB>& obb = s.tree.getNodeBoxes();
+    ptr = obb.get();
+    bytes = sizeof(detail::CompactOBB)*obb.size();
+    }
 #endif
 
 
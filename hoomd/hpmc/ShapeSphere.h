@@ -656,6 +656,21 @@ std::string getShapeSpec(const Shape& shape)
     throw std::runtime_error("Shape definition not supported for this shape class.");
     }
 
+//! Get the shape parameter data that the GPU kernels read most often
+/*! \param shape Shape to query
+    \param ptr Start of the data (output)
+    \param bytes Size of the data (output)
+
+    GPU integrators keep this range in the persisting part of the L2 cache between kernel launches. The default is
+    no data.
+*/
+template<class Shape>
+inline void getPersistingData(const Shape& shape, const void *& ptr, size_t& bytes)
+    {
+    ptr = nullptr;
+    bytes = 0;
+    }
+
 template<>
 inline std::string getShapeSpec(const ShapeSphere& sphere)
     {
@@ -158,16 +158,17 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
                                  const ShapeSpheropolyhedron& b,
                                  unsigned int& err)
     {
-    vec3<OverlapReal> dr = r_ab;
-
     OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
 
-    return xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,a.verts.sweep_radius),
-                          detail::SupportFuncConvexPolyhedron(b.verts,b.verts.sweep_radius),
-                          rotate(conj(quat<OverlapReal>(a.orientation)),dr),
-                          conj(quat<OverlapReal>(a.orientation)) * quat<OverlapReal>(b.orientation),
-                          DaDb/OverlapReal(2.0),
-                          err);
+    // near contacts are re-checked in double precision when OverlapReal is float
+    vec3<double> dr_double(r_ab);
+    quat<double> qa(a.orientation);
+    return xenocollide_3d_mixed(detail::SupportFuncConvexPolyhedron(a.verts,a.verts.sweep_radius),
+                                detail::SupportFuncConvexPolyhedron(b.verts,b.verts.sweep_radius),
+                                rotate(conj(qa), dr_double),
+                                conj(qa) * quat<double>(b.orientation),
+                                DaDb/OverlapReal(2.0),
+                                err);
 
     /*
     return gjke_3d(detail::SupportFuncSpheropolyhedron(a.verts),
@@ -466,6 +466,9 @@ DEVICE inline bool test_narrow_phase_overlap(vec3<OverlapReal> dr,
 
     vec3<OverlapReal> r_ab = rotate(conj(quat<OverlapReal>(b.orientation)),vec3<OverlapReal>(dr));
 
+    // orientation of a in the frame of b, shared by all pairs
+    quat<OverlapReal> q_ab = conj(quat<OverlapReal>(b.orientation))*quat<OverlapReal>(a.orientation);
+
     // loop through leaf particles of cur_node_a
     // parallel loop over N^2 interacting particle pairs
     unsigned int ptl_i = a.members.tree.getLeafNodePtrByNode(cur_node_a);
@@ -499,9 +502,9 @@ DEVICE inline bool test_narrow_phase_overlap(vec3<OverlapReal> dr,
             const mparam_type& params_i = a.members.mparams[ishape];
             Shape shape_i(quat<Scalar>(), params_i);
             if (shape_i.hasOrientation())
-                shape_i.orientation = conj(quat<OverlapReal>(b.orientation))*quat<OverlapReal>(a.orientation) * a.members.morientation[ishape];
+                shape_i.orientation = q_ab * a.members.morientation[ishape];
 
-            vec3<OverlapReal> pos_i(rotate(conj(quat<OverlapReal>(b.orientation))*quat<OverlapReal>(a.orientation),a.members.mpos[ishape])-r_ab);
+            vec3<OverlapReal> pos_i(rotate(q_ab,a.members.mpos[ishape])-r_ab);
             unsigned int overlap_i = a.members.moverlap[ishape];
 
             const auto& params_j = b.members.mparams[jshape];
@@ -0,0 +1,325 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "TunerMoveSize.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <pybind11/stl.h>
+
+namespace hpmc
+    {
+/// Smallest move size set by the tuners
+static const double min_move_size = 1e-7;
+
+TunerMoveSizeBase::TunerMoveSizeBase(std::shared_ptr<SystemDefinition> sysdef,
+                                     std::shared_ptr<Trigger> trigger,
+                                     double target)
+    : Tuner(sysdef, trigger), m_max_scale(2.0), m_gamma(1.0), m_tol(1e-2), m_freeze(false), m_tuned(0),
+      m_have_counters(false)
+    {
+    setTarget(target);
+    }
+
+void TunerMoveSizeBase::setTarget(double target)
+    {
+    if (!(target >= 0.0 && target <= 1.0))
+        {
+        m_exec_conf->msg->error() << "tune: target must be between 0 and 1" << std::endl;
+        throw std::runtime_error("Error setting move size tuner target");
+        }
+    m_target = target;
+    m_tuned = 0;
+    }
+
+void TunerMoveSizeBase::setMaxScale(double max_scale)
+    {
+    if (!(max_scale > 1.0))
+        {
+        m_exec_conf->msg->error() << "tune: max_scale must be greater than 1" << std::endl;
+        throw std::runtime_error("Error setting move size tuner max_scale");
+        }
+    m_max_scale = max_scale;
+    }
+
+void TunerMoveSizeBase::setGamma(double gamma)
+    {
+    if (!(gamma >= 0.0))
+        {
+        m_exec_conf->msg->error() << "tune: gamma must be non-negative" << std::endl;
+        throw std::runtime_error("Error setting move size tuner gamma");
+        }
+    m_gamma = gamma;
+    }
+
+void TunerMoveSizeBase::setTol(double tol)
+    {
+    if (!(tol >= 0.0))
+        {
+        m_exec_conf->msg->error() << "tune: tol must be non-negative" << std::endl;
+        throw std::runtime_error("Error setting move size tuner tol");
+        }
+    m_tol = tol;
+    m_tuned = 0;
+    }
+
+bool TunerMoveSizeBase::computeScale(std::pair<unsigned long long int, unsigned long long int>& previous,
+                                     unsigned long long int accept,
+                                     unsigned long long int reject,
+                                     double& scale)
+    {
+    scale = 1.0;
+    unsigned long long int total = accept + reject;
+
+    // the counters restart when the integrator or updater is reattached
+    if (accept < previous.first || total < previous.second)
+        previous = std::make_pair(0ull, 0ull);
+
+    unsigned long long int n_accept = accept - previous.first;
+    unsigned long long int n_total = total - previous.second;
+    previous = std::make_pair(accept, total);
+
+    if (n_total == 0)
+        return true;
+
+    double acceptance = double(n_accept) / double(n_total);
+    if (std::abs(acceptance - m_target) <= m_tol)
+        return true;
+
+    // larger moves are accepted less often
+    scale = (acceptance + m_gamma) / (m_gamma + m_target);
+    scale = std::max(std::min(scale, m_max_scale), 1.0 / m_max_scale);
+    return false;
+    }
+
+TunerMoveSize::TunerMoveSize(std::shared_ptr<SystemDefinition> sysdef,
+                             std::shared_ptr<Trigger> trigger,
+                             std::shared_ptr<IntegratorHPMC> mc,
+                             std::vector<std::string> moves,
+                             double target)
+    : TunerMoveSizeBase(sysdef, trigger, target), m_mc(mc),
+      m_max_translation_move(std::numeric_limits<double>::infinity()),
+      m_max_rotation_move(std::numeric_limits<double>::infinity())
+    {
+    m_exec_conf->msg->notice(5) << "Constructing TunerMoveSize" << std::endl;
+    setMoves(moves);
+    }
+
+TunerMoveSize::~TunerMoveSize()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying TunerMoveSize" << std::endl;
+    }
+
+void TunerMoveSize::setMoves(const std::vector<std::string>& moves)
+    {
+    m_tune_translation = false;
+    m_tune_rotation = false;
+    for (const auto& move : moves)
+        {
+        if (move == "d")
+            m_tune_translation = true;
+        else if (move == "a")
+            m_tune_rotation = true;
+        else
+            {
+            m_exec_conf->msg->error() << "tune.move_size: Unknown move " << move << std::endl;
+            throw std::runtime_error("Error setting moves to tune");
+            }
+        }
+    m_have_counters = false;
+    m_tuned = 0;
+    }
+
+std::vector<std::string> TunerMoveSize::getMoves()
+    {
+    std::vector<std::string> moves;
+    if (m_tune_rotation)
+        moves.push_back("a");
+    if (m_tune_translation)
+        moves.push_back("d");
+    return moves;
+    }
+
+void TunerMoveSize::setMaxTranslationMove(double max_translation_move)
+    {
+    if (!(max_translation_move >= min_move_size))
+        {
+        m_exec_conf->msg->error() << "tune.move_size: max_translation_move must be at least " << min_move_size
+                                  << std::endl;
+        throw std::runtime_error("Error setting max_translation_move");
+        }
+    m_max_translation_move = max_translation_move;
+    }
+
+void TunerMoveSize::setMaxRotationMove(double max_rotation_move)
+    {
+    if (!(max_rotation_move >= min_move_size))
+        {
+        m_exec_conf->msg->error() << "tune.move_size: max_rotation_move must be at least " << min_move_size
+                                  << std::endl;
+        throw std::runtime_error("Error setting max_rotation_move");
+        }
+    m_max_rotation_move = max_rotation_move;
+    }
+
+void TunerMoveSize::update(uint64_t timestep)
+    {
+    if (m_freeze && isTuned())
+        return;
+
+    // getCounters reduces the counts over all ranks, so all ranks compute the same scale factors
+    hpmc_counters_t counters = m_mc->getCounters(0);
+    if (!m_have_counters)
+        {
+        m_prev_translate = std::make_pair(counters.translate_accept_count,
+                                          counters.translate_accept_count + counters.translate_reject_count);
+        m_prev_rotate = std::make_pair(counters.rotate_accept_count,
+                                       counters.rotate_accept_count + counters.rotate_reject_count);
+        m_have_counters = true;
+        return;
+        }
+
+    bool converged = true;
+    unsigned int n_types = m_pdata->getNTypes();
+
+    if (m_tune_translation)
+        {
+        double scale;
+        converged = computeScale(m_prev_translate,
+                                 counters.translate_accept_count,
+                                 counters.translate_reject_count,
+                                 scale)
+                    && converged;
+        for (unsigned int type = 0; type < n_types && scale != 1.0; ++type)
+            {
+            std::string name = m_pdata->getNameByType(type);
+            double d = m_mc->getD(name);
+            if (d > 0)
+                m_mc->setD(name, std::max(std::min(d * scale, m_max_translation_move), min_move_size));
+            }
+        }
+
+    if (m_tune_rotation)
+        {
+        double scale;
+        converged
+            = computeScale(m_prev_rotate, counters.rotate_accept_count, counters.rotate_reject_count, scale)
+              && converged;
+        for (unsigned int type = 0; type < n_types && scale != 1.0; ++type)
+            {
+            std::string name = m_pdata->getNameByType(type);
+            double a = m_mc->getA(name);
+            if (a > 0)
+                m_mc->setA(name, std::max(std::min(a * scale, m_max_rotation_move), min_move_size));
+            }
+        }
+
+    recordTuned(converged);
+    }
+
+TunerBoxMCMoveSize::TunerBoxMCMoveSize(std::shared_ptr<SystemDefinition> sysdef,
+                                       std::shared_ptr<Trigger> trigger,
+                                       std::shared_ptr<UpdaterBoxMC> boxmc,
+                                       std::vector<std::string> moves,
+                                       double target)
+    : TunerMoveSizeBase(sysdef, trigger, target), m_boxmc(boxmc)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing TunerBoxMCMoveSize" << std::endl;
+    setMoves(moves);
+    }
+
+TunerBoxMCMoveSize::~TunerBoxMCMoveSize()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying TunerBoxMCMoveSize" << std::endl;
+    }
+
+void TunerBoxMCMoveSize::setMoves(const std::vector<std::string>& moves)
+    {
+    for (const auto& move : moves)
+        {
+        if (move != "volume" && move != "ln_volume" && move != "shear" && move != "aspect")
+            {
+            m_exec_conf->msg->error() << "tune.move_size: Unknown box move " << move << std::endl;
+            throw std::runtime_error("Error setting box moves to tune");
+            }
+        }
+    m_moves = moves;
+    m_prev.resize(m_moves.size());
+    m_have_counters = false;
+    m_tuned = 0;
+    }
+
+void TunerBoxMCMoveSize::update(uint64_t timestep)
+    {
+    if (m_freeze && isTuned())
+        return;
+
+    hpmc_boxmc_counters_t counters = m_boxmc->getCounters(0);
+    bool converged = true;
+    for (unsigned int i = 0; i < m_moves.size(); ++i)
+        {
+        const std::string& move = m_moves[i];
+        std::pair<unsigned long long int, unsigned long long int> count;
+        if (move == "volume")
+            count = std::make_pair(counters.volume_accept_count, counters.volume_reject_count);
+        else if (move == "ln_volume")
+            count = std::make_pair(counters.ln_volume_accept_count, counters.ln_volume_reject_count);
+        else if (move == "shear")
+            count = std::make_pair(counters.shear_accept_count, counters.shear_reject_count);
+        else
+            count = std::make_pair(counters.aspect_accept_count, counters.aspect_reject_count);
+
+        if (!m_have_counters)
+            {
+            m_prev[i] = std::make_pair(count.first, count.first + count.second);
+            continue;
+            }
+
+        double scale;
+        converged = computeScale(m_prev[i], count.first, count.second, scale) && converged;
+        if (scale != 1.0)
+            m_boxmc->scaleMoveSize(move, scale);
+        }
+
+    if (m_have_counters)
+        recordTuned(converged);
+    m_have_counters = true;
+    }
+
+void export_TunerMoveSize(pybind11::module& m)
+    {
+    pybind11::class_<TunerMoveSizeBase, Tuner, std::shared_ptr<TunerMoveSizeBase>>(m, "TunerMoveSizeBase")
+        .def_property("target", &TunerMoveSizeBase::getTarget, &TunerMoveSizeBase::setTarget)
+        .def_property("max_scale", &TunerMoveSizeBase::getMaxScale, &TunerMoveSizeBase::setMaxScale)
+        .def_property("gamma", &TunerMoveSizeBase::getGamma, &TunerMoveSizeBase::setGamma)
+        .def_property("tol", &TunerMoveSizeBase::getTol, &TunerMoveSizeBase::setTol)
+        .def_property("freeze", &TunerMoveSizeBase::getFreeze, &TunerMoveSizeBase::setFreeze)
+        .def_property_readonly("tuned", &TunerMoveSizeBase::isTuned);
+
+    pybind11::class_<TunerMoveSize, TunerMoveSizeBase, std::shared_ptr<TunerMoveSize>>(m, "TunerMoveSize")
+        .def(pybind11::init<std::shared_ptr<SystemDefinition>,
+                            std::shared_ptr<Trigger>,
+                            std::shared_ptr<IntegratorHPMC>,
+                            std::vector<std::string>,
+                            double>())
+        .def_property("moves", &TunerMoveSize::getMoves, &TunerMoveSize::setMoves)
+        .def_property("max_translation_move",
+                      &TunerMoveSize::getMaxTranslationMove,
+                      &TunerMoveSize::setMaxTranslationMove)
+        .def_property("max_rotation_move",
+                      &TunerMoveSize::getMaxRotationMove,
+                      &TunerMoveSize::setMaxRotationMove);
+
+    pybind11::class_<TunerBoxMCMoveSize, TunerMoveSizeBase, std::shared_ptr<TunerBoxMCMoveSize>>(
+        m,
+        "TunerBoxMCMoveSize")
+        .def(pybind11::init<std::shared_ptr<SystemDefinition>,
+                            std::shared_ptr<Trigger>,
+                            std::shared_ptr<UpdaterBoxMC>,
+                            std::vector<std::string>,
+                            double>())
+        .def_property("moves", &TunerBoxMCMoveSize::getMoves, &TunerBoxMCMoveSize::setMoves);
+    }
+
+    } // end namespace hpmc
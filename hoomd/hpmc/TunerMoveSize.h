@@ -0,0 +1,255 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// inclusion guard
+#pragma once
+
+#include <hoomd/Tuner.h>
+
+#include "IntegratorHPMC.h"
+#include "UpdaterBoxMC.h"
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+namespace hpmc
+    {
+/** Common part of the online move size tuners
+
+    Every time the trigger fires, the tuners compute the acceptance ratio of each tuned kind of move from the change of
+    the acceptance counters since the last call and scale the move size by (gamma + target) / (acceptance + gamma),
+    the same update as hoomd.tune.ScaleSolver with a negative correlation. The tuners run inside a single run() and
+    need no Python callbacks. The first call after construction (or after changing the tuned moves) only records the
+    counters.
+
+    The move sizes are tuned once all kinds of moves are within tol of the target for two consecutive calls. When
+    freeze is set, the tuner stops changing move sizes once tuned. Changing the target resumes tuning.
+*/
+class TunerMoveSizeBase : public Tuner
+    {
+    public:
+    /** Constructor
+
+        @param sysdef System definition
+        @param trigger Select the timesteps on which to tune
+        @param target Target acceptance ratio
+    */
+    TunerMoveSizeBase(std::shared_ptr<SystemDefinition> sysdef,
+                      std::shared_ptr<Trigger> trigger,
+                      double target);
+
+    /// Set the target acceptance ratio
+    void setTarget(double target);
+
+    /// Get the target acceptance ratio
+    double getTarget()
+        {
+        return m_target;
+        }
+
+    /// Set the maximum factor to scale the move sizes by in one call
+    void setMaxScale(double max_scale);
+
+    /// Get the maximum factor to scale the move sizes by in one call
+    double getMaxScale()
+        {
+        return m_max_scale;
+        }
+
+    /// Set the damping of the move size corrections
+    void setGamma(double gamma);
+
+    /// Get the damping of the move size corrections
+    double getGamma()
+        {
+        return m_gamma;
+        }
+
+    /// Set the tolerance of the acceptance ratio
+    void setTol(double tol);
+
+    /// Get the tolerance of the acceptance ratio
+    double getTol()
+        {
+        return m_tol;
+        }
+
+    /// Set whether to stop tuning once tuned
+    void setFreeze(bool freeze)
+        {
+        m_freeze = freeze;
+        }
+
+    /// Get whether to stop tuning once tuned
+    bool getFreeze()
+        {
+        return m_freeze;
+        }
+
+    /// Check whether the move sizes are tuned
+    bool isTuned()
+        {
+        return m_tuned >= 2;
+        }
+
+    protected:
+    /** Compute the scale factor of one kind of move
+
+        @param previous Accepted and total counts at the previous call, updated to the current counts
+        @param accept Current count of accepted moves
+        @param reject Current count of rejected moves
+        @param scale Set to the factor to scale the move size by
+
+        @returns true when the acceptance ratio is within tol of the target or no moves were made
+    */
+    bool computeScale(std::pair<unsigned long long int, unsigned long long int>& previous,
+                      unsigned long long int accept,
+                      unsigned long long int reject,
+                      double& scale);
+
+    /// Record the outcome of one tuning step
+    void recordTuned(bool converged)
+        {
+        m_tuned = converged ? m_tuned + 1 : 0;
+        }
+
+    double m_target;          //!< Target acceptance ratio
+    double m_max_scale;       //!< Maximum scale factor in one call
+    double m_gamma;           //!< Damping of the corrections
+    double m_tol;             //!< Tolerance of the acceptance ratio
+    bool m_freeze;            //!< Stop tuning once tuned
+    unsigned int m_tuned;     //!< Number of consecutive calls within tolerance
+    bool m_have_counters;     //!< True when the previous counters are set
+    };
+
+/** Online tuner of the HPMC translation and rotation move sizes
+
+    Scales the move sizes d and a of all types with a non-zero move size, clamped to [1e-7, max_translation_move] and
+    [1e-7, max_rotation_move].
+*/
+class TunerMoveSize : public TunerMoveSizeBase
+    {
+    public:
+    /** Constructor
+
+        @param sysdef System definition
+        @param trigger Select the timesteps on which to tune
+        @param mc HPMC integrator
+        @param moves Moves to tune: "a" and/or "d"
+        @param target Target acceptance ratio
+    */
+    TunerMoveSize(std::shared_ptr<SystemDefinition> sysdef,
+                  std::shared_ptr<Trigger> trigger,
+                  std::shared_ptr<IntegratorHPMC> mc,
+                  std::vector<std::string> moves,
+                  double target);
+
+    /// Destructor
+    virtual ~TunerMoveSize();
+
+    /// Tune the move sizes
+    virtual void update(uint64_t timestep);
+
+    /// Set the moves to tune
+    void setMoves(const std::vector<std::string>& moves);
+
+    /// Get the moves to tune
+    std::vector<std::string> getMoves();
+
+    /// Set the maximum translation move size
+    void setMaxTranslationMove(double max_translation_move);
+
+    /// Get the maximum translation move size
+    double getMaxTranslationMove()
+        {
+        return m_max_translation_move;
+        }
+
+    /// Set the maximum rotation move size
+    void setMaxRotationMove(double max_rotation_move);
+
+    /// Get the maximum rotation move size
+    double getMaxRotationMove()
+        {
+        return m_max_rotation_move;
+        }
+
+    protected:
+    /// HPMC integrator
+    std::shared_ptr<IntegratorHPMC> m_mc;
+
+    /// Tune the translation move size
+    bool m_tune_translation;
+
+    /// Tune the rotation move size
+    bool m_tune_rotation;
+
+    /// Maximum translation move size
+    double m_max_translation_move;
+
+    /// Maximum rotation move size
+    double m_max_rotation_move;
+
+    /// Accepted and total translation moves at the previous call
+    std::pair<unsigned long long int, unsigned long long int> m_prev_translate;
+
+    /// Accepted and total rotation moves at the previous call
+    std::pair<unsigned long long int, unsigned long long int> m_prev_rotate;
+    };
+
+/** Online tuner of the UpdaterBoxMC move sizes
+
+    Scales the maximum size of the box moves with a non-zero weight. "volume" tunes both the volume and the length
+    moves, which share the same acceptance counters.
+*/
+class TunerBoxMCMoveSize : public TunerMoveSizeBase
+    {
+    public:
+    /** Constructor
+
+        @param sysdef System definition
+        @param trigger Select the timesteps on which to tune
+        @param boxmc Box MC updater
+        @param moves Moves to tune: "volume", "ln_volume", "shear" and/or "aspect"
+        @param target Target acceptance ratio
+    */
+    TunerBoxMCMoveSize(std::shared_ptr<SystemDefinition> sysdef,
+                       std::shared_ptr<Trigger> trigger,
+                       std::shared_ptr<UpdaterBoxMC> boxmc,
+                       std::vector<std::string> moves,
+                       double target);
+
+    /// Destructor
+    virtual ~TunerBoxMCMoveSize();
+
+    /// Tune the move sizes
+    virtual void update(uint64_t timestep);
+
+    /// Set the moves to tune
+    void setMoves(const std::vector<std::string>& moves);
+
+    /// Get the moves to tune
+    std::vector<std::string> getMoves()
+        {
+        return m_moves;
+        }
+
+    protected:
+    /// Box MC updater
+    std::shared_ptr<UpdaterBoxMC> m_boxmc;
+
+    /// Moves to tune
+    std::vector<std::string> m_moves;
+
+    /// Accepted and total moves of each tuned kind at the previous call
+    std::vector<std::pair<unsigned long long int, unsigned long long int>> m_prev;
+    };
+
+/// Export the move size tuners to Python
+void export_TunerMoveSize(pybind11::module& m);
+
+    } // end namespace hpmc
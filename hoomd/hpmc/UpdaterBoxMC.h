@@ -203,6 +203,38 @@ class UpdaterBoxMC : public Updater
             m_volume_A2 = Lx / Lz;
             }
 
+        //! Scale the maximum size of one kind of box move
+        /*! \param move Kind of move: "volume" (the volume and length moves), "ln_volume", "shear" or "aspect"
+            \param scale Factor to multiply the move size(s) by
+        */
+        void scaleMoveSize(const std::string& move, Scalar scale)
+            {
+            if (move == "volume")
+                {
+                m_volume_delta *= scale;
+                for (unsigned int i = 0; i < 3; ++i)
+                    m_length_delta[i] *= scale;
+                }
+            else if (move == "ln_volume")
+                {
+                m_ln_volume_delta *= scale;
+                }
+            else if (move == "shear")
+                {
+                for (unsigned int i = 0; i < 3; ++i)
+                    m_shear_delta[i] *= scale;
+                }
+            else if (move == "aspect")
+                {
+                m_aspect_delta *= scale;
+                }
+            else
+                {
+                m_exec_conf->msg->error() << "update.boxmc: Unknown box move " << move << std::endl;
+                throw std::runtime_error("Error scaling box move size");
+                }
+            }
+
         //! Get pressure parameter
         /*! \returns pressure variant object
         */
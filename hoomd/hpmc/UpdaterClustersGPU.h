@@ -308,6 +308,16 @@ UpdaterClustersGPU<Shape>::~UpdaterClustersGPU()
 template< class Shape >
 void UpdaterClustersGPU<Shape>::update(uint64_t timestep)
     {
+    #ifdef ENABLE_MPI
+    // fail before the cell list is resized for the cluster move
+    if (this->m_pdata->getDomainDecomposition())
+        {
+        this->m_exec_conf->msg->error() << "UpdaterClustersGPU does not work with spatial domain decomposition."
+            << std::endl;
+        throw std::runtime_error("Error in UpdaterClustersGPU");
+        }
+    #endif
+
     // compute nominal cell width
     auto& params = this->m_mc->getParams();
     Scalar nominal_width = this->m_mc->getMaxCoreDiameter();
@@ -0,0 +1,488 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _UPDATER_HPMC_EVENT_CHAIN_
+#define _UPDATER_HPMC_EVENT_CHAIN_
+
+/*! \file UpdaterEventChain.h
+    \brief Declaration of UpdaterEventChain
+*/
+
+#include "hoomd/Updater.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/RNGIdentifiers.h"
+
+#include "IntegratorHPMCMono.h"
+#include "ShapeSphere.h"
+#include "ShapeConvexPolygon.h"
+#include "ShapeConvexPolyhedron.h"
+
+#include <limits>
+#include <vector>
+
+#ifndef __HIPCC__
+#include <pybind11/pybind11.h>
+#endif
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Candidate separating axes of a shape type in its body frame
+/*! Two convex polytopes are disjoint if and only if their projections onto one of the face normals of either
+    polytope, or onto the cross product of an edge of one with an edge of the other, are disjoint. Any superset of
+    these axes gives the same answer, so the axes need not be unique.
+*/
+struct EventChainAxes
+    {
+    std::vector< vec3<Scalar> > faces;  //!< Face normals (edge normals in 2D)
+    std::vector< vec3<Scalar> > edges;  //!< Edge directions (3D only)
+    };
+
+//! Spheres need no separating axes
+inline EventChainAxes getEventChainAxes(const SphereParams& params)
+    {
+    return EventChainAxes();
+    }
+
+//! The edge normals of a convex polygon
+inline EventChainAxes getEventChainAxes(const PolygonVertices& verts)
+    {
+    if (verts.sweep_radius != OverlapReal(0.0))
+        throw std::runtime_error("Event chains do not support rounded polygons.");
+
+    EventChainAxes axes;
+    for (unsigned int k = 0; k < verts.N; k++)
+        {
+        unsigned int l = (k + 1) % verts.N;
+        axes.faces.push_back(vec3<Scalar>(verts.y[l] - verts.y[k], verts.x[k] - verts.x[l], 0));
+        }
+    return axes;
+    }
+
+//! The face normals and edge directions of the convex hull of a polyhedron
+inline EventChainAxes getEventChainAxes(const PolyhedronVertices& verts)
+    {
+    if (verts.sweep_radius != OverlapReal(0.0))
+        throw std::runtime_error("Event chains do not support rounded polyhedra.");
+    if (verts.n_hull_verts == 0)
+        throw std::runtime_error("Event chains require polyhedra with a three dimensional convex hull.");
+
+    EventChainAxes axes;
+    for (unsigned int t = 0; t < verts.n_hull_verts; t += 3)
+        {
+        vec3<Scalar> v[3];
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            unsigned int idx = verts.hull_verts[t+k];
+            v[k] = vec3<Scalar>(verts.x[idx], verts.y[idx], verts.z[idx]);
+            }
+
+        axes.faces.push_back(cross(v[1] - v[0], v[2] - v[0]));
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            // every edge is shared by two triangles, keep it once
+            unsigned int a = verts.hull_verts[t+k];
+            unsigned int b = verts.hull_verts[t+(k+1)%3];
+            if (a < b)
+                axes.edges.push_back(v[(k+1)%3] - v[k]);
+            }
+        }
+    return axes;
+    }
+
+//! Project a convex polygon onto an axis
+/*! \param shape The polygon, centered at the origin
+    \param n The axis in the space frame
+    \param lo Set to the smallest projection of the vertices
+    \param hi Set to the largest projection of the vertices
+*/
+inline void projectEventChain(const ShapeConvexPolygon& shape, const vec3<Scalar>& n, Scalar& lo, Scalar& hi)
+    {
+    vec3<Scalar> n_body = rotate(conj(shape.orientation), n);
+    lo = std::numeric_limits<Scalar>::max();
+    hi = -std::numeric_limits<Scalar>::max();
+    for (unsigned int k = 0; k < shape.verts.N; k++)
+        {
+        Scalar p = n_body.x*shape.verts.x[k] + n_body.y*shape.verts.y[k];
+        lo = std::min(lo, p);
+        hi = std::max(hi, p);
+        }
+    }
+
+//! Project a convex polyhedron onto an axis
+inline void projectEventChain(const ShapeConvexPolyhedron& shape, const vec3<Scalar>& n, Scalar& lo, Scalar& hi)
+    {
+    vec3<Scalar> n_body = rotate(conj(shape.orientation), n);
+    lo = std::numeric_limits<Scalar>::max();
+    hi = -std::numeric_limits<Scalar>::max();
+    for (unsigned int k = 0; k < shape.verts.N; k++)
+        {
+        Scalar p = n_body.x*shape.verts.x[k] + n_body.y*shape.verts.y[k] + n_body.z*shape.verts.z[k];
+        lo = std::min(lo, p);
+        hi = std::max(hi, p);
+        }
+    }
+
+//! Restrict the interval of displacements for which two shapes overlap along one axis
+/*! \param s_lo Lower end of the interval
+    \param s_hi Upper end of the interval
+    \param n The axis
+    \param e Direction of the displacement
+    \param a_lo Smallest projection of the moving shape
+    \param a_hi Largest projection of the moving shape
+    \param b_lo Smallest projection of the other shape
+    \param b_hi Largest projection of the other shape
+    \returns false when the shapes remain disjoint along the axis for every displacement
+*/
+inline bool clipEventChainInterval(Scalar& s_lo, Scalar& s_hi, const vec3<Scalar>& n, const vec3<Scalar>& e,
+                                   Scalar a_lo, Scalar a_hi, Scalar b_lo, Scalar b_hi)
+    {
+    Scalar ne = dot(n, e);
+    if (ne*ne <= Scalar(1e-24)*dot(n, n))
+        return a_lo <= b_hi && a_hi >= b_lo;
+
+    // the projections overlap while a_lo + s ne <= b_hi and a_hi + s ne >= b_lo
+    Scalar t1 = (b_lo - a_hi)/ne;
+    Scalar t2 = (b_hi - a_lo)/ne;
+    s_lo = std::max(s_lo, std::min(t1, t2));
+    s_hi = std::min(s_hi, std::max(t1, t2));
+    return s_lo <= s_hi;
+    }
+
+//! Find the first contact of two spheres when the first moves along e
+/*! \param s Set to the displacement of the first sphere at contact
+    \param r_ij Position of the second sphere relative to the first
+    \param e Unit vector along the displacement
+    \param shape_i The moving sphere
+    \param axes_i Unused
+    \param shape_j The other sphere
+    \param axes_j Unused
+    \param s_max Largest displacement to consider
+    \param tol Contacts that break up within tol are ignored
+    \returns true when the spheres collide for a displacement in [0, s_max]
+*/
+inline bool eventChainCollision(Scalar& s, const vec3<Scalar>& r_ij, const vec3<Scalar>& e,
+                                const ShapeSphere& shape_i, const EventChainAxes& axes_i,
+                                const ShapeSphere& shape_j, const EventChainAxes& axes_j,
+                                Scalar s_max, Scalar tol)
+    {
+    Scalar d = Scalar(shape_i.params.radius) + Scalar(shape_j.params.radius);
+
+    // solve |r_ij - s e|^2 = d^2
+    Scalar b = dot(r_ij, e);
+    Scalar disc = b*b - dot(r_ij, r_ij) + d*d;
+    if (disc < Scalar(0.0))
+        return false;
+
+    Scalar s_lo = b - fast::sqrt(disc);
+    Scalar s_hi = std::min(s_max, b + fast::sqrt(disc));
+    if (s_lo > s_hi || s_hi <= tol)
+        return false;
+
+    s = std::max(s_lo, Scalar(0.0));
+    return true;
+    }
+
+//! Find the first contact of two convex polytopes when the first moves along e
+/*! The set of displacements at which the polytopes overlap is the intersection of the displacements at which their
+    projections overlap over all separating axes. The first contact is the lower end of that interval.
+*/
+template<class Shape>
+inline bool eventChainCollision(Scalar& s, const vec3<Scalar>& r_ij, const vec3<Scalar>& e,
+                                const Shape& shape_i, const EventChainAxes& axes_i,
+                                const Shape& shape_j, const EventChainAxes& axes_j,
+                                Scalar s_max, Scalar tol)
+    {
+    Scalar s_lo = -std::numeric_limits<Scalar>::max();
+    Scalar s_hi = s_max;
+
+    auto clip = [&](const vec3<Scalar>& n)
+        {
+        Scalar a_lo, a_hi, b_lo, b_hi;
+        projectEventChain(shape_i, n, a_lo, a_hi);
+        projectEventChain(shape_j, n, b_lo, b_hi);
+        Scalar shift = dot(n, r_ij);
+        return clipEventChainInterval(s_lo, s_hi, n, e, a_lo, a_hi, b_lo + shift, b_hi + shift);
+        };
+
+    for (const auto& n : axes_i.faces)
+        if (!clip(rotate(shape_i.orientation, n)))
+            return false;
+    for (const auto& n : axes_j.faces)
+        if (!clip(rotate(shape_j.orientation, n)))
+            return false;
+
+    for (const auto& a : axes_i.edges)
+        {
+        vec3<Scalar> a_space = rotate(shape_i.orientation, a);
+        for (const auto& b : axes_j.edges)
+            {
+            vec3<Scalar> n = cross(a_space, rotate(shape_j.orientation, b));
+            // parallel edges add no new axis
+            if (dot(n, n) <= Scalar(1e-12)*dot(a, a)*dot(b, b))
+                continue;
+            if (!clip(n))
+                return false;
+            }
+        }
+
+    if (s_hi <= tol)
+        return false;
+
+    s = std::max(s_lo, Scalar(0.0));
+    return true;
+    }
+
+} // end namespace detail
+
+//! Event-chain Monte Carlo for hard particles
+/*! Each chain picks a random particle and a random direction along one of the box axes and moves the particle
+    until it hits another one. The displacement passes (is lifted) to the particle that was hit, which continues in
+    the same direction, and so on until the particles have moved by chain_length in total. Every move is
+    rejection free, and the chains satisfy global balance (Bernard, Krauth, and Wilson 2009,
+    http://doi.org/10.1103/PhysRevE.80.056704).
+
+    The first contact along the path is computed exactly: analytically for spheres, and from the separating axes of
+    the two polytopes for convex polygons and polyhedra. Candidates come from a copy of the integrator's AABB tree
+    that is kept up to date as the particles move. The active particle advances by at most half the largest
+    particle diameter at a time so that every query stays within the integrator's image list.
+
+    Chains cross the whole box, so UpdaterEventChain does not support MPI domain decomposition.
+
+    \ingroup hpmc_integrators
+*/
+template<class Shape>
+class UpdaterEventChain : public Updater
+    {
+    public:
+        //! Constructor
+        /*! \param sysdef System definition
+            \param mc HPMC integrator
+        */
+        UpdaterEventChain(std::shared_ptr<SystemDefinition> sysdef,
+                          std::shared_ptr<IntegratorHPMCMono<Shape> > mc)
+            : Updater(sysdef), m_mc(mc), m_chain_length(1.0), m_n_chains(1), m_count_chains(0), m_count_collisions(0)
+            {
+            m_exec_conf->msg->notice(5) << "Constructing UpdaterEventChain" << std::endl;
+            }
+
+        //! Destructor
+        virtual ~UpdaterEventChain()
+            {
+            m_exec_conf->msg->notice(5) << "Destroying UpdaterEventChain" << std::endl;
+            }
+
+        //! Run the event chains
+        /*! \param timestep timestep at which update is being evaluated
+        */
+        virtual void update(uint64_t timestep);
+
+        //! Set the total displacement of a chain
+        void setChainLength(Scalar chain_length)
+            {
+            if (chain_length <= Scalar(0.0))
+                {
+                m_exec_conf->msg->error() << "update.EventChain: chain_length must be positive" << std::endl;
+                throw std::runtime_error("Error setting event chain parameters");
+                }
+            m_chain_length = chain_length;
+            }
+
+        //! Get the total displacement of a chain
+        Scalar getChainLength()
+            {
+            return m_chain_length;
+            }
+
+        //! Set the number of chains per update
+        void setNChains(unsigned int n_chains)
+            {
+            m_n_chains = n_chains;
+            }
+
+        //! Get the number of chains per update
+        unsigned int getNChains()
+            {
+            return m_n_chains;
+            }
+
+        //! Get the number of chains run so far
+        unsigned long long int getCountChains()
+            {
+            return m_count_chains;
+            }
+
+        //! Get the number of collisions (lifts) so far
+        unsigned long long int getCountCollisions()
+            {
+            return m_count_collisions;
+            }
+
+    protected:
+        std::shared_ptr< IntegratorHPMCMono<Shape> > m_mc;    //!< HPMC integrator
+        Scalar m_chain_length;                                //!< Total displacement of a chain
+        unsigned int m_n_chains;                              //!< Number of chains per update
+        unsigned long long int m_count_chains;                //!< Number of chains run
+        unsigned long long int m_count_collisions;            //!< Number of lifts
+
+        detail::AABBTree m_aabb_tree;                         //!< Locality lookup, updated as particles move
+        std::vector<detail::EventChainAxes> m_axes;           //!< Separating axes of each type
+    };
+
+template<class Shape>
+void UpdaterEventChain<Shape>::update(uint64_t timestep)
+    {
+    #ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        throw std::runtime_error("UpdaterEventChain does not work with spatial domain decomposition.");
+    #endif
+
+    m_exec_conf->msg->notice(10) << timestep << " UpdaterEventChain" << std::endl;
+
+    const unsigned int N = m_pdata->getN();
+    if (!N)
+        return;
+
+    if (m_prof) m_prof->push(m_exec_conf, "HPMC event chains");
+
+    auto& params = m_mc->getParams();
+    const unsigned int n_types = m_pdata->getNTypes();
+    m_axes.resize(n_types);
+    for (unsigned int typ = 0; typ < n_types; typ++)
+        m_axes[typ] = detail::getEventChainAxes(params[typ]);
+
+    m_aabb_tree = m_mc->buildAABBTree();
+    const std::vector< vec3<Scalar> >& image_list = m_mc->updateImageList();
+    const unsigned int n_images = (unsigned int)image_list.size();
+
+    const Scalar max_diameter = m_mc->getMaxCoreDiameter();
+    const Scalar tol = Scalar(1e-7)*max_diameter;
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const uint16_t seed = m_sysdef->getSeed();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+    const Index2D& overlap_idx = m_mc->getOverlapIndexer();
+
+    for (unsigned int chain = 0; chain < m_n_chains; chain++)
+        {
+        hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::UpdaterEventChain, timestep, seed),
+                                   hoomd::Counter(chain));
+
+        unsigned int i = hoomd::UniformIntDistribution(N-1)(rng);
+        unsigned int axis = hoomd::UniformIntDistribution(ndim-1)(rng);
+        vec3<Scalar> e(axis == 0, axis == 1, axis == 2);
+
+        Scalar remaining = m_chain_length;
+        while (remaining > Scalar(0.0))
+            {
+            Scalar s_seg = std::min(remaining, Scalar(0.5)*max_diameter);
+
+            vec3<Scalar> pos_i(h_postype.data[i]);
+            unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
+            Shape shape_i(quat<Scalar>(h_orientation.data[i]), params[typ_i]);
+            detail::AABB aabb_i_local = detail::merge(shape_i.getAABB(vec3<Scalar>(0,0,0)),
+                                                      shape_i.getAABB(s_seg*e));
+
+            // find the first particle in the way
+            Scalar s_hit = s_seg;
+            unsigned int j_hit = N;
+            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+                {
+                vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+                detail::AABB aabb = aabb_i_local;
+                aabb.translate(pos_i_image);
+
+                for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                    {
+                    if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        {
+                        if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                            {
+                            for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                                {
+                                unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                                if (i == j && cur_image == 0)
+                                    continue;
+
+                                unsigned int typ_j = __scalar_as_int(h_postype.data[j].w);
+                                if (!h_overlaps.data[overlap_idx(typ_i, typ_j)])
+                                    continue;
+
+                                Shape shape_j(quat<Scalar>(h_orientation.data[j]), params[typ_j]);
+                                vec3<Scalar> r_ij = vec3<Scalar>(h_postype.data[j]) - pos_i_image;
+
+                                Scalar s;
+                                if (detail::eventChainCollision(s, r_ij, e, shape_i, m_axes[typ_i],
+                                                                shape_j, m_axes[typ_j], s_hit, tol)
+                                    && s < s_hit)
+                                    {
+                                    s_hit = s;
+                                    j_hit = j;
+                                    }
+                                }
+                            }
+                        }
+                    else
+                        {
+                        // skip ahead
+                        cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                        }
+                    }
+                }
+
+            // move the active particle up to the contact
+            pos_i += s_hit*e;
+            int3 image = h_image.data[i];
+            box.wrap(pos_i, image);
+            h_postype.data[i] = make_scalar4(pos_i.x, pos_i.y, pos_i.z, h_postype.data[i].w);
+            h_image.data[i] = image;
+
+            detail::AABB aabb_new = shape_i.getAABB(pos_i);
+            if (!m_aabb_tree.reinsert(i, aabb_new))
+                m_aabb_tree.update(i, aabb_new);
+
+            remaining -= s_hit;
+
+            // and lift the displacement to the particle that was hit
+            if (j_hit != N)
+                {
+                i = j_hit;
+                m_count_collisions++;
+                }
+            }
+
+        m_count_chains++;
+        }
+
+    m_mc->invalidateAABBTree();
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+//! Export the UpdaterEventChain class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of UpdaterEventChain<Shape> will be exported
+*/
+template<class Shape> void export_UpdaterEventChain(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< UpdaterEventChain<Shape>, Updater, std::shared_ptr< UpdaterEventChain<Shape> > >(m, name.c_str())
+        .def(pybind11::init< std::shared_ptr<SystemDefinition>,
+                             std::shared_ptr< IntegratorHPMCMono<Shape> > >())
+        .def_property("chain_length", &UpdaterEventChain<Shape>::getChainLength,
+                      &UpdaterEventChain<Shape>::setChainLength)
+        .def_property("n_chains", &UpdaterEventChain<Shape>::getNChains, &UpdaterEventChain<Shape>::setNChains)
+        .def_property_readonly("chains", &UpdaterEventChain<Shape>::getCountChains)
+        .def_property_readonly("collisions", &UpdaterEventChain<Shape>::getCountCollisions)
+    ;
+    }
+
+} // end namespace hpmc
+
+#endif // _UPDATER_HPMC_EVENT_CHAIN_
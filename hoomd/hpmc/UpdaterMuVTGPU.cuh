@@ -0,0 +1,345 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _UPDATER_MUVT_GPU_CUH_
+#define _UPDATER_MUVT_GPU_CUH_
+
+#include "hip/hip_runtime.h"
+#include "HPMCPrecisionSetup.h"
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/Index1D.h"
+
+#include "ComputeFreeVolumeGPU.cuh"
+
+/*! \file UpdaterMuVTGPU.cuh
+    \brief Declaration of CUDA kernels drivers for UpdaterMuVTGPU
+*/
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Wraps arguments to gpu_hpmc_muvt_insert
+/*! \ingroup hpmc_data_structs */
+struct hpmc_muvt_insert_args_t
+    {
+    //! Construct a hpmc_muvt_insert_args_t
+    hpmc_muvt_insert_args_t(
+                unsigned int _n_trial,
+                unsigned int _type,
+                const Scalar4 *_d_trial_postype,
+                const Scalar4 *_d_trial_orientation,
+                const Scalar4 *_d_postype,
+                const Scalar4 *_d_orientation,
+                const Index3D& _ci,
+                const unsigned int *_d_excell_idx,
+                const unsigned int *_d_excell_size,
+                const Index2D& _excli,
+                const uint3& _cell_dim,
+                const Scalar3 _ghost_width,
+                const unsigned int _num_types,
+                const BoxDim& _box,
+                const unsigned int _block_size,
+                const unsigned int _stride,
+                const unsigned int _group_size,
+                unsigned int *_d_overlap,
+                const unsigned int *_d_check_overlaps,
+                Index2D _overlap_idx,
+                const hipDeviceProp_t& _devprop
+                )
+                : n_trial(_n_trial),
+                  type(_type),
+                  d_trial_postype(_d_trial_postype),
+                  d_trial_orientation(_d_trial_orientation),
+                  d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  ci(_ci),
+                  d_excell_idx(_d_excell_idx),
+                  d_excell_size(_d_excell_size),
+                  excli(_excli),
+                  cell_dim(_cell_dim),
+                  ghost_width(_ghost_width),
+                  num_types(_num_types),
+                  box(_box),
+                  block_size(_block_size),
+                  stride(_stride),
+                  group_size(_group_size),
+                  d_overlap(_d_overlap),
+                  d_check_overlaps(_d_check_overlaps),
+                  overlap_idx(_overlap_idx),
+                  devprop(_devprop)
+        {
+        };
+
+    unsigned int n_trial;                   //!< Number of insertion trials
+    unsigned int type;                      //!< Type of the inserted particle
+    const Scalar4 *d_trial_postype;         //!< Positions of the trials
+    const Scalar4 *d_trial_orientation;     //!< Orientations of the trials
+    const Scalar4 *d_postype;               //!< postype array
+    const Scalar4 *d_orientation;           //!< orientation array
+    const Index3D& ci;                      //!< Cell indexer
+    const unsigned int *d_excell_idx;       //!< Expanded cell neighbors
+    const unsigned int *d_excell_size;      //!< Size of expanded cell list per cell
+    const Index2D excli;                    //!< Expanded cell indexer
+    const uint3& cell_dim;                  //!< Cell dimensions
+    const Scalar3 ghost_width;              //!< Width of ghost layer
+    const unsigned int num_types;           //!< Number of particle types
+    const BoxDim& box;                      //!< Current simulation box
+    unsigned int block_size;                //!< Block size to execute
+    unsigned int stride;                    //!< Number of threads per overlap check
+    unsigned int group_size;                //!< Size of the group to execute
+    unsigned int *d_overlap;                //!< Per trial overlap flag (output)
+    const unsigned int *d_check_overlaps;   //!< Interaction matrix
+    Index2D overlap_idx;                    //!< Interaction matrix indexer
+    const hipDeviceProp_t& devprop;         //!< CUDA device properties
+    };
+
+template< class Shape >
+hipError_t gpu_hpmc_muvt_insert(const hpmc_muvt_insert_args_t &args, const typename Shape::param_type *d_params);
+
+#ifdef __HIPCC__
+
+//! Kernel to test insertion trials for overlaps with the particles in the system
+/*! One group of threads tests one trial against the particles in the expanded cell of the trial position and stores
+    1 in \a d_overlap for the trial if it overlaps any of them, 0 otherwise.
+
+    \param n_trial Number of trials
+    \param type Type of the inserted particle
+    \param d_trial_postype Positions of the trials
+    \param d_trial_orientation Orientations of the trials
+    \param d_postype Particle positions and types by index
+    \param d_orientation Particle orientation
+    \param ci Cell indexer
+    \param d_excell_idx Expanded cell neighbors
+    \param d_excell_size Size of the expanded cells
+    \param excli Expanded cell indexer
+    \param cell_dim Dimensions of the cell list
+    \param ghost_width Width of ghost layer
+    \param num_types Number of particle types
+    \param box Simulation box
+    \param d_overlap Per trial overlap flag (output value)
+    \param d_check_overlaps Per-type pair interaction matrix
+    \param overlap_idx Indexer into the interaction matrix
+    \param d_params Per-type shape parameters
+    \param max_extra_bytes Shared memory available for the shape parameters
+*/
+template< class Shape >
+__global__ void gpu_hpmc_muvt_insert_kernel(unsigned int n_trial,
+                                            unsigned int type,
+                                            const Scalar4 *d_trial_postype,
+                                            const Scalar4 *d_trial_orientation,
+                                            const Scalar4 *d_postype,
+                                            const Scalar4 *d_orientation,
+                                            const Index3D ci,
+                                            const unsigned int *d_excell_idx,
+                                            const unsigned int *d_excell_size,
+                                            const Index2D excli,
+                                            const uint3 cell_dim,
+                                            const Scalar3 ghost_width,
+                                            const unsigned int num_types,
+                                            const BoxDim box,
+                                            unsigned int *d_overlap,
+                                            const unsigned int *d_check_overlaps,
+                                            Index2D overlap_idx,
+                                            const typename Shape::param_type *d_params,
+                                            unsigned int max_extra_bytes)
+    {
+    unsigned int group = threadIdx.z;
+    unsigned int offset = threadIdx.y;
+    unsigned int group_size = blockDim.y;
+    bool master = (offset == 0 && threadIdx.x == 0);
+    unsigned int n_groups = blockDim.z;
+
+    // determine trial idx
+    unsigned int i = blockIdx.x * n_groups + group;
+
+    // load the per type pair parameters into shared memory
+    HIP_DYNAMIC_SHARED( char, s_data)
+    typename Shape::param_type *s_params = (typename Shape::param_type *)(&s_data[0]);
+    unsigned int *s_check_overlaps = (unsigned int *) (s_params + num_types);
+    unsigned int ntyppairs = overlap_idx.getNumElements();
+    unsigned int *s_overlap = (unsigned int *)(&s_check_overlaps[ntyppairs]);
+
+    // copy over parameters one int per thread for fast loads
+        {
+        unsigned int tidx = threadIdx.x+blockDim.x*threadIdx.y + blockDim.x*blockDim.y*threadIdx.z;
+        unsigned int block_size = blockDim.x*blockDim.y*blockDim.z;
+        unsigned int param_size = num_types*sizeof(typename Shape::param_type) / sizeof(int);
+
+        for (unsigned int cur_offset = 0; cur_offset < param_size; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < param_size)
+                {
+                ((int *)s_params)[cur_offset + tidx] = ((int *)d_params)[cur_offset + tidx];
+                }
+            }
+
+        for (unsigned int cur_offset = 0; cur_offset < ntyppairs; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < ntyppairs)
+                {
+                s_check_overlaps[cur_offset + tidx] = d_check_overlaps[cur_offset + tidx];
+                }
+            }
+        }
+
+    __syncthreads();
+
+    // initialize extra shared mem
+    char *s_extra = (char *)(s_overlap + n_groups);
+
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int cur_type = 0; cur_type < num_types; ++cur_type)
+        s_params[cur_type].load_shared(s_extra, available_bytes);
+
+    if (master)
+        {
+        s_overlap[group] = 0;
+        }
+
+    __syncthreads();
+
+    bool active = i < n_trial;
+
+    if (active)
+        {
+        vec3<Scalar> pos_i(d_trial_postype[i]);
+        Shape shape_i(quat<Scalar>(d_trial_orientation[i]), s_params[type]);
+
+        // find cell the trial is in
+        unsigned int my_cell = compute_cell_idx(vec_to_scalar3(pos_i), box, ghost_width, cell_dim, ci);
+
+        // loop over neighboring cells and check for overlaps
+        unsigned int excell_size = d_excell_size[my_cell];
+
+        for (unsigned int k = 0; k < excell_size; k += group_size)
+            {
+            unsigned int local_k = k + offset;
+            if (local_k < excell_size)
+                {
+                // read in position, and orientation of neighboring particle
+                unsigned int j = __ldg(&d_excell_idx[excli(local_k, my_cell)]);
+
+                Scalar4 postype_j = __ldg(d_postype + j);
+                Scalar4 orientation_j = make_scalar4(1,0,0,0);
+                unsigned int typ_j = __scalar_as_int(postype_j.w);
+                Shape shape_j(quat<Scalar>(orientation_j), s_params[typ_j]);
+                if (shape_j.hasOrientation())
+                    shape_j.orientation = quat<Scalar>(__ldg(d_orientation + j));
+
+                // put particle j into the coordinate system of the trial
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i;
+                r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
+
+                // check for overlaps
+                OverlapReal rsq = dot(r_ij,r_ij);
+                OverlapReal DaDb = shape_i.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+
+                if (rsq*OverlapReal(4.0) <= DaDb * DaDb)
+                    {
+                    // circumsphere overlap
+                    unsigned int err_count;
+                    if (s_check_overlaps[overlap_idx(typ_j, type)] && test_overlap(r_ij, shape_i, shape_j, err_count))
+                        {
+                        s_overlap[group] = 1;
+                        break;
+                        }
+                    }
+                }
+            }
+        }
+
+    __syncthreads();
+
+    if (master && active)
+        {
+        d_overlap[i] = s_overlap[group];
+        }
+    }
+
+//! Kernel driver for gpu_hpmc_muvt_insert_kernel()
+/*! \param args Bundled arguments
+    \param d_params Per-type shape parameters
+    \returns Error codes generated by any CUDA calls, or hipSuccess when there is no error
+
+    This templatized method is the kernel driver for insertion trials of any shape. It is instantiated for every shape
+    in kernel_muvt_insert.cu.in.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+hipError_t gpu_hpmc_muvt_insert(const hpmc_muvt_insert_args_t& args, const typename Shape::param_type *d_params)
+    {
+    assert(args.d_trial_postype);
+    assert(args.d_trial_orientation);
+    assert(args.d_overlap);
+    assert(args.group_size >= 1);
+    assert(args.group_size <= (unsigned int)args.devprop.warpSize);
+    assert(args.block_size%(args.stride*args.group_size)==0);
+
+    // determine the maximum block size and clamp the input block size down
+    static int max_block_size = -1;
+    static hipFuncAttributes attr;
+    if (max_block_size == -1)
+        {
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(gpu_hpmc_muvt_insert_kernel<Shape>));
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    // setup the grid to run the kernel
+    unsigned int n_groups = min(args.block_size, (unsigned int)max_block_size) / args.group_size / args.stride;
+
+    dim3 threads(args.stride, args.group_size, n_groups);
+    dim3 grid( args.n_trial / n_groups + 1, 1, 1);
+
+    unsigned int shared_bytes = (unsigned int)(args.num_types * sizeof(typename Shape::param_type) + n_groups*sizeof(unsigned int)
+        + args.overlap_idx.getNumElements()*sizeof(unsigned int));
+
+    unsigned int max_extra_bytes = static_cast<unsigned int>(args.devprop.sharedMemPerBlock - attr.sharedSizeBytes - shared_bytes);
+
+    // determine dynamically requested shared memory
+    char *ptr = (char *)nullptr;
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int i = 0; i < args.num_types; ++i)
+        {
+        d_params[i].allocate_shared(ptr, available_bytes);
+        }
+    unsigned int extra_bytes = max_extra_bytes - available_bytes;
+
+    shared_bytes += extra_bytes;
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_hpmc_muvt_insert_kernel<Shape>), dim3(grid), dim3(threads), shared_bytes, 0,
+                                                     args.n_trial,
+                                                     args.type,
+                                                     args.d_trial_postype,
+                                                     args.d_trial_orientation,
+                                                     args.d_postype,
+                                                     args.d_orientation,
+                                                     args.ci,
+                                                     args.d_excell_idx,
+                                                     args.d_excell_size,
+                                                     args.excli,
+                                                     args.cell_dim,
+                                                     args.ghost_width,
+                                                     args.num_types,
+                                                     args.box,
+                                                     args.d_overlap,
+                                                     args.d_check_overlaps,
+                                                     args.overlap_idx,
+                                                     d_params,
+                                                     max_extra_bytes);
+
+    return hipSuccess;
+    }
+
+#endif // __HIPCC__
+
+}; // end namespace detail
+
+} // end namespace hpmc
+
+#endif // _UPDATER_MUVT_GPU_CUH_
@@ -0,0 +1,389 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _UPDATER_MUVT_GPU_H_
+#define _UPDATER_MUVT_GPU_H_
+
+/*! \file UpdaterMuVTGPU.h
+    \brief Declaration of UpdaterMuVTGPU
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef ENABLE_HIP
+
+#include "hoomd/CellList.h"
+#include "hoomd/Autotuner.h"
+
+#include "UpdaterMuVT.h"
+#include "UpdaterMuVTGPU.cuh"
+#include "IntegratorHPMCMonoGPUTypes.cuh"
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! Grand canonical and Gibbs ensemble updater with overlap checks for insertions on the GPU
+/*! UpdaterMuVTGPU tests insertion trials against the particles in the system with a kernel that reads the GPU cell
+    list, without copying the particle data to the host or building the AABB tree. The kernel tests a batch of trials
+    in parallel, one thread group per trial, and testInsertions() takes any number of trials.
+
+    Insertions fall back on the CPU implementation when a patch interaction or depletants are present, with domain
+    decomposition, and when the box is too small for the minimum image convention. Removals and volume moves always
+    use the CPU implementation.
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class UpdaterMuVTGPU : public UpdaterMuVT<Shape>
+    {
+    public:
+        //! Constructor
+        /*! \param sysdef System definition
+            \param mc HPMC integrator
+            \param cl Cell list
+            \param npartition How many partitions to use in parallel for Gibbs ensemble (n=1 == grand canonical)
+        */
+        UpdaterMuVTGPU(std::shared_ptr<SystemDefinition> sysdef,
+                       std::shared_ptr<IntegratorHPMCMono<Shape> > mc,
+                       std::shared_ptr<CellList> cl,
+                       unsigned int npartition);
+
+        //! Destructor
+        virtual ~UpdaterMuVTGPU();
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            m_tuner_excell_block_size->setPeriod(period);
+            m_tuner_excell_block_size->setEnabled(enable);
+
+            m_tuner_insert->setPeriod(period);
+            m_tuner_insert->setEnabled(enable);
+            }
+
+    protected:
+        std::shared_ptr<CellList> m_cl;                      //!< Cell list
+        uint3 m_last_dim;                                    //!< Dimensions of the cell list on the last call
+        unsigned int m_last_nmax;                            //!< Last cell list NMax value allocated in excell
+
+        GlobalArray<unsigned int> m_excell_idx;              //!< Particle indices in expanded cells
+        GlobalArray<unsigned int> m_excell_size;             //!< Number of particles in each expanded cell
+        Index2D m_excell_list_indexer;                       //!< Indexer to access elements of the excell_idx list
+
+        GlobalArray<Scalar4> m_trial_postype;                //!< Positions of the insertion trials
+        GlobalArray<Scalar4> m_trial_orientation;            //!< Orientations of the insertion trials
+        GlobalArray<unsigned int> m_trial_overlap;           //!< Overlap flag of each insertion trial
+
+        std::unique_ptr<Autotuner> m_tuner_excell_block_size;  //!< Autotuner for excell block_size
+        std::unique_ptr<Autotuner> m_tuner_insert;             //!< Autotuner for the insertion overlap checks
+
+        /*! Check for overlaps of a fictitious particle
+         * \param timestep Current time step
+         * \param type Type of particle to test
+         * \param pos Position of fictitious particle
+         * \param orientation Orientation of particle
+         * \param lnboltzmann Log of Boltzmann weight of insertion attempt (return value)
+         * \returns True if boltzmann weight is non-zero
+         */
+        virtual bool tryInsertParticle(uint64_t timestep, unsigned int type, vec3<Scalar> pos,
+            quat<Scalar> orientation, Scalar &lnboltzmann);
+
+        //! Test whether insertion trials can be checked on the GPU
+        bool canInsertOnGPU();
+
+        //! Test a batch of insertion trials for overlaps, the results are stored in m_trial_overlap
+        void testInsertions(uint64_t timestep, unsigned int type, const vec3<Scalar> *pos,
+            const quat<Scalar> *orientation, unsigned int n_trial);
+
+        //! Resize the expanded cell list
+        void initializeExcellMem();
+    };
+
+template< class Shape >
+UpdaterMuVTGPU< Shape >::UpdaterMuVTGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                        std::shared_ptr<IntegratorHPMCMono<Shape> > mc,
+                                        std::shared_ptr<CellList> cl,
+                                        unsigned int npartition)
+    : UpdaterMuVT<Shape>(sysdef, mc, npartition), m_cl(cl)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing UpdaterMuVTGPU" << std::endl;
+
+    this->m_cl->setRadius(1);
+    this->m_cl->setComputeTDB(false);
+    this->m_cl->setFlagType();
+    this->m_cl->setComputeIdx(true);
+
+    // initialize the autotuners
+    // the full block size, stride and group size matrix is searched,
+    // encoded as block_size*1000000 + stride*100 + group_size.
+    std::vector<unsigned int> valid_params;
+    unsigned int warp_size = this->m_exec_conf->dev_prop.warpSize;
+    for (unsigned int block_size = warp_size; block_size <= (unsigned int) this->m_exec_conf->dev_prop.maxThreadsPerBlock; block_size += warp_size)
+        {
+        for (auto s : Autotuner::getTppListPow2(warp_size))
+            {
+            unsigned int stride = 1;
+            while (stride <= this->m_exec_conf->dev_prop.warpSize/s)
+                {
+                // only widen the parallelism if the shape supports it
+                if (stride == 1 || Shape::isParallel())
+                    {
+                    // blockDim.z is limited to 64
+                    if ((block_size % (stride*s)) == 0 && block_size/s/stride <= 64)
+                        valid_params.push_back(block_size*1000000 + stride*100 + s);
+                    }
+                stride*=2;
+                }
+            }
+        }
+    m_tuner_insert.reset(new Autotuner(valid_params, 5, 1000000, "hpmc_muvt_insert", this->m_exec_conf));
+    m_tuner_excell_block_size.reset(new Autotuner(warp_size, this->m_exec_conf->dev_prop.maxThreadsPerBlock, warp_size,
+        5, 1000000, "hpmc_muvt_excell_block_size", this->m_exec_conf));
+
+    GlobalArray<unsigned int> excell_size(0, this->m_exec_conf);
+    m_excell_size.swap(excell_size);
+
+    GlobalArray<unsigned int> excell_idx(0, this->m_exec_conf);
+    m_excell_idx.swap(excell_idx);
+
+    GlobalArray<Scalar4> trial_postype(1, this->m_exec_conf);
+    m_trial_postype.swap(trial_postype);
+
+    GlobalArray<Scalar4> trial_orientation(1, this->m_exec_conf);
+    m_trial_orientation.swap(trial_orientation);
+
+    GlobalArray<unsigned int> trial_overlap(1, this->m_exec_conf);
+    m_trial_overlap.swap(trial_overlap);
+
+    // set last dim to a bogus value so that it will re-init on the first call
+    m_last_dim = make_uint3(0xffffffff, 0xffffffff, 0xffffffff);
+    m_last_nmax = 0xffffffff;
+    }
+
+template< class Shape >
+UpdaterMuVTGPU< Shape >::~UpdaterMuVTGPU()
+    {
+    this->m_exec_conf->msg->notice(5) << "Destroying UpdaterMuVTGPU" << std::endl;
+    }
+
+/*! \returns true if the insertion overlap checks of the CPU implementation can be replaced by testInsertions()
+*/
+template< class Shape >
+bool UpdaterMuVTGPU< Shape >::canInsertOnGPU()
+    {
+    if (this->m_mc->getPatchInteraction())
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        return false;
+    #endif
+
+    // depletants modify the Boltzmann factor of the insertion
+    for (unsigned int type_d = 0; type_d < this->m_pdata->getNTypes(); ++type_d)
+        {
+        for (unsigned int type_j = 0; type_j < this->m_pdata->getNTypes(); ++type_j)
+            {
+            if (this->m_mc->getDepletantFugacity(type_d, type_j) != 0.0)
+                return false;
+            }
+        }
+
+    // the kernel uses the minimum image convention and does not check for self overlaps with periodic images
+    Scalar nominal_width = this->m_mc->getMaxCoreDiameter();
+    const BoxDim& box = this->m_pdata->getBox();
+    Scalar3 npd = box.getNearestPlaneDistance();
+
+    if ((box.getPeriodic().x && npd.x <= nominal_width*2) ||
+        (box.getPeriodic().y && npd.y <= nominal_width*2) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && npd.z <= nominal_width*2))
+        return false;
+
+    return true;
+    }
+
+template< class Shape >
+bool UpdaterMuVTGPU< Shape >::tryInsertParticle(uint64_t timestep, unsigned int type, vec3<Scalar> pos,
+    quat<Scalar> orientation, Scalar &lnboltzmann)
+    {
+    if (!canInsertOnGPU())
+        return UpdaterMuVT<Shape>::tryInsertParticle(timestep, type, pos, orientation, lnboltzmann);
+
+    lnboltzmann = Scalar(0.0);
+
+    // nothing to overlap with
+    if (this->m_pdata->getN() == 0)
+        return true;
+
+    testInsertions(timestep, type, &pos, &orientation, 1);
+
+    ArrayHandle<unsigned int> h_trial_overlap(m_trial_overlap, access_location::host, access_mode::read);
+    return !h_trial_overlap.data[0];
+    }
+
+/*! \param timestep Current time step
+    \param type Type of the inserted particle
+    \param pos Positions of the trials
+    \param orientation Orientations of the trials
+    \param n_trial Number of trials
+
+    All trials are tested independently against the current configuration.
+*/
+template< class Shape >
+void UpdaterMuVTGPU< Shape >::testInsertions(uint64_t timestep, unsigned int type, const vec3<Scalar> *pos,
+    const quat<Scalar> *orientation, unsigned int n_trial)
+    {
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "muVT insert");
+
+    if (m_trial_postype.getNumElements() < n_trial)
+        {
+        m_trial_postype.resize(n_trial);
+        m_trial_orientation.resize(n_trial);
+        m_trial_overlap.resize(n_trial);
+        }
+
+        {
+        ArrayHandle<Scalar4> h_trial_postype(m_trial_postype, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_trial_orientation(m_trial_orientation, access_location::host, access_mode::overwrite);
+
+        for (unsigned int i = 0; i < n_trial; ++i)
+            {
+            h_trial_postype.data[i] = vec_to_scalar4(pos[i], __int_as_scalar(type));
+            h_trial_orientation.data[i] = quat_to_scalar4(orientation[i]);
+            }
+        }
+
+    // set nominal width
+    Scalar nominal_width = this->m_mc->getMaxCoreDiameter();
+    if (this->m_cl->getNominalWidth() != nominal_width)
+        this->m_cl->setNominalWidth(nominal_width);
+
+    // compute cell list
+    this->m_cl->compute(timestep);
+
+    // if the cell list is a different size than last time, reinitialize expanded cell list
+    uint3 cur_dim = this->m_cl->getDim();
+    if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z ||
+        m_last_nmax != this->m_cl->getNmax())
+        {
+        initializeExcellMem();
+        m_last_dim = cur_dim;
+        m_last_nmax = this->m_cl->getNmax();
+        }
+
+    // access the cell list data
+    ArrayHandle<unsigned int> d_cell_size(this->m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_idx(this->m_cl->getIndexArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_adj(this->m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+    ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
+    ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+
+    // update the expanded cells
+    m_tuner_excell_block_size->begin();
+    gpu::hpmc_excell(d_excell_idx.data,
+                     d_excell_size.data,
+                     m_excell_list_indexer,
+                     d_cell_idx.data,
+                     d_cell_size.data,
+                     d_cell_adj.data,
+                     this->m_cl->getCellIndexer(),
+                     this->m_cl->getCellListIndexer(),
+                     this->m_cl->getCellAdjIndexer(),
+                     1,
+                     m_tuner_excell_block_size->getParam());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner_excell_block_size->end();
+
+    // access the particle data
+    ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_overlaps(this->m_mc->getInteractionMatrix(), access_location::device, access_mode::read);
+
+    ArrayHandle<Scalar4> d_trial_postype(m_trial_postype, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_trial_orientation(m_trial_orientation, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_trial_overlap(m_trial_overlap, access_location::device, access_mode::overwrite);
+
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = this->m_mc->getParams();
+    const BoxDim& box = this->m_pdata->getBox();
+
+    m_tuner_insert->begin();
+    unsigned int param = m_tuner_insert->getParam();
+    unsigned int block_size = param / 1000000;
+    unsigned int stride = (param % 1000000 ) / 100;
+    unsigned int group_size = param % 100;
+
+    detail::hpmc_muvt_insert_args_t insert_args(n_trial,
+                                                type,
+                                                d_trial_postype.data,
+                                                d_trial_orientation.data,
+                                                d_postype.data,
+                                                d_orientation.data,
+                                                this->m_cl->getCellIndexer(),
+                                                d_excell_idx.data,
+                                                d_excell_size.data,
+                                                m_excell_list_indexer,
+                                                this->m_cl->getDim(),
+                                                this->m_cl->getGhostWidth(),
+                                                this->m_pdata->getNTypes(),
+                                                box,
+                                                block_size,
+                                                stride,
+                                                group_size,
+                                                d_trial_overlap.data,
+                                                d_overlaps.data,
+                                                this->m_mc->getOverlapIndexer(),
+                                                this->m_exec_conf->dev_prop);
+
+    detail::gpu_hpmc_muvt_insert<Shape>(insert_args, params.data());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner_insert->end();
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+    }
+
+template< class Shape >
+void UpdaterMuVTGPU< Shape >::initializeExcellMem()
+    {
+    this->m_exec_conf->msg->notice(4) << "hpmc resizing expanded cells" << std::endl;
+
+    // get the current cell dimensions
+    unsigned int num_cells = this->m_cl->getCellIndexer().getNumElements();
+    unsigned int num_adj = this->m_cl->getCellAdjIndexer().getW();
+    unsigned int num_max = this->m_cl->getNmax();
+
+    // make the excell dimensions the same, but with room for Nmax*Nadj in each cell
+    m_excell_list_indexer = Index2D(num_max * num_adj, num_cells);
+
+    // reallocate memory
+    m_excell_idx.resize(m_excell_list_indexer.getNumElements());
+    m_excell_size.resize(num_cells);
+    }
+
+//! Export the UpdaterMuVTGPU class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of UpdaterMuVTGPU<Shape> will be exported
+*/
+template < class Shape > void export_UpdaterMuVTGPU(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< UpdaterMuVTGPU<Shape>, UpdaterMuVT<Shape>, std::shared_ptr< UpdaterMuVTGPU<Shape> > >(m, name.c_str())
+          .def( pybind11::init< std::shared_ptr<SystemDefinition>,
+                                std::shared_ptr< IntegratorHPMCMono<Shape> >,
+                                std::shared_ptr<CellList>,
+                                unsigned int>())
+          ;
+    }
+
+} // end namespace hpmc
+
+#endif // ENABLE_HIP
+
+#endif // _UPDATER_MUVT_GPU_H_
@@ -41,8 +41,8 @@ void UpdaterQuickCompress::update(uint64_t timestep)
         m_prof->push("UpdaterQuickCompress");
     m_exec_conf->msg->notice(10) << "UpdaterQuickCompress: " << timestep << std::endl;
 
-    // count the number of overlaps in the current configuration
-    auto n_overlaps = m_mc->countOverlaps(false);
+    // only whether the current configuration has overlaps matters here
+    auto n_overlaps = m_mc->countOverlapsUpTo(0);
     BoxDim current_box = m_pdata->getGlobalBox();
 
     // TODO: This slow. We will implement a general reusable fix later in #705
@@ -63,6 +63,10 @@ void UpdaterQuickCompress::update(uint64_t timestep)
         m_is_complete = false;
     }
 
+/*! The positions are backed up, scaled and counted where the integrator keeps them, so a GPU integrator moves the
+    box without copying the particle data to the host. The overlap count stops once the move is known to be
+    rejected.
+*/
 void UpdaterQuickCompress::performBoxScale(uint64_t timestep)
     {
     auto new_box = getNewBox(timestep);
@@ -70,6 +74,15 @@ void UpdaterQuickCompress::performBoxScale(uint64_t timestep)
 
     // Make a backup copy of position data
     unsigned int N_backup = m_pdata->getN();
+    #ifdef ENABLE_HIP
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_pos_backup(m_pos_backup, access_location::device, access_mode::overwrite);
+        hipMemcpy(d_pos_backup.data, d_pos.data, sizeof(Scalar4) * N_backup, hipMemcpyDeviceToDevice);
+        }
+    else
+    #endif
         {
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(),
                                    access_location::host,
@@ -80,19 +93,32 @@ void UpdaterQuickCompress::performBoxScale(uint64_t timestep)
         memcpy(h_pos_backup.data, h_pos.data, sizeof(Scalar4) * N_backup);
         }
 
-    m_mc->attemptBoxResize(timestep, new_box);
+    m_mc->scaleBox(new_box);
 
-    auto n_overlaps = m_mc->countOverlaps(false);
-    if (n_overlaps > m_max_overlaps_per_particle * m_pdata->getNGlobal())
+    const unsigned int max_overlaps
+        = (unsigned int)(m_max_overlaps_per_particle * m_pdata->getNGlobal());
+    auto n_overlaps = m_mc->countOverlapsUpTo(max_overlaps);
+    if (n_overlaps > max_overlaps)
         {
         // the box move generated too many overlaps, undo the move
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(),
-                                   access_location::host,
-                                   access_mode::readwrite);
-        ArrayHandle<Scalar4> h_pos_backup(m_pos_backup, access_location::host, access_mode::read);
         unsigned int N = m_pdata->getN();
         assert(N == N_backup);
-        memcpy(h_pos.data, h_pos_backup.data, sizeof(Scalar4) * N);
+        #ifdef ENABLE_HIP
+        if (m_exec_conf->isCUDAEnabled())
+            {
+            ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+            ArrayHandle<Scalar4> d_pos_backup(m_pos_backup, access_location::device, access_mode::read);
+            hipMemcpy(d_pos.data, d_pos_backup.data, sizeof(Scalar4) * N, hipMemcpyDeviceToDevice);
+            }
+        else
+        #endif
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(),
+                                       access_location::host,
+                                       access_mode::readwrite);
+            ArrayHandle<Scalar4> h_pos_backup(m_pos_backup, access_location::host, access_mode::read);
+            memcpy(h_pos.data, h_pos_backup.data, sizeof(Scalar4) * N);
+            }
         m_pdata->setGlobalBox(old_box);
 
         // we have moved particles, communicate those changes
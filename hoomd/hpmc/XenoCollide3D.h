@@ -30,8 +30,12 @@ namespace detail
 
 const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
 
+//! Width of the band around contact, relative to R, in which xenocollide_3d_mixed re-checks in double precision
+const double XENOCOLLIDE_3D_MIXED_BAND = 1e-4;
+
 //! XenoCollide overlap check in 3D
-/*! \tparam SupportFuncA Support function class type for shape A
+/*! \tparam Real Precision of the computation
+    \tparam SupportFuncA Support function class type for shape A
     \tparam SupportFuncB Support function class type for shape B
     \param sa Support function for shape A
     \param sb Support function for shape B
@@ -39,6 +43,8 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     \param q Orientation of shape B in frame A
     \param R Approximate radius of Minkowski difference for scaling tolerance value
     \param err_count Error counter to increment whenever an infinite loop is encountered
+    \param margin Set to the distance of the origin from the plane that decided the result (0 when the result was
+           decided within the tolerances)
     \returns true when the two shapes overlap and false when they are disjoint.
 
     XenoCollide is a generic algorithm for detecting overlaps between two shapes. It operates with the support function
@@ -67,26 +73,28 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
 
     \ingroup minkowski
 */
-template<class SupportFuncA, class SupportFuncB>
-DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
-                                  const SupportFuncB& sb,
-                                  const vec3<OverlapReal>& ab_t,
-                                  const quat<OverlapReal>& q,
-                                  const OverlapReal R,
-                                  unsigned int& err_count)
+template<class Real, class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d_margin(const SupportFuncA& sa,
+                                         const SupportFuncB& sb,
+                                         const vec3<Real>& ab_t,
+                                         const quat<Real>& q,
+                                         const Real R,
+                                         unsigned int& err_count,
+                                         Real& margin)
     {
     // This implementation of XenoCollide is hand-written from the description of the algorithm on page 171 of _Games
     // Programming Gems 7_
 
-    vec3<OverlapReal> v0, v1, v2, v3, v4, n;
-    CompositeSupportFunc3D<SupportFuncA, SupportFuncB> S(sa, sb, ab_t, q);
-    OverlapReal d;
-    const OverlapReal precision_tol = OverlapReal(1e-7);        // precision tolerance for single-precision floats near 1.0
-    const OverlapReal root_tol = OverlapReal(3e-4);   // square root of precision tolerance
+    vec3<Real> v0, v1, v2, v3, v4, n;
+    CompositeSupportFunc3D<SupportFuncA, SupportFuncB, Real> S(sa, sb, ab_t, q);
+    Real d;
+    const Real precision_tol = Real(1e-7);        // precision tolerance for single-precision floats near 1.0
+    const Real root_tol = Real(3e-4);   // square root of precision tolerance
 
     if (fabs(ab_t.x) < root_tol && fabs(ab_t.y) < root_tol && fabs(ab_t.z) < root_tol)
         {
         // Interior point is at origin => particles overlap
+        margin = R;
         return true;
         }
 
@@ -103,8 +111,12 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     v1 = S(-v0); // should be guaranteed ||v1|| > 0
 
     /* if (dot(v1, v1 - v0) <= 0) // by convexity */
-    if (dot(v1, v0) > OverlapReal(0.0))
-        return false;   // origin is outside v1 support plane
+    if (dot(v1, v0) > Real(0.0))
+        {
+        // origin is outside v1 support plane
+        margin = dot(v1, v0) / fast::sqrt(dot(v0, v0));
+        return false;
+        }
 
     // find support v2 perpendicular to v0, v1 plane
     n = cross(v1, v0);
@@ -112,17 +124,23 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     // plane. If origin is on a line between v1 and v0, particles overlap.
     //if (dot(n, n) < tol)
     if (fabs(n.x) < precision_tol && fabs(n.y) < precision_tol && fabs(n.z) < precision_tol)
+        {
+        margin = Real(0.0);
         return true;
+        }
 
     v2 = S(n); // Convexity should guarantee ||v2|| > 0, but v2 == v1 may be possible in edge cases of {B}-{A}
     // particles do not overlap if origin outside v2 support plane
-    if (dot(v2, n) < OverlapReal(0.0))
+    if (dot(v2, n) < Real(0.0))
+        {
+        margin = -dot(v2, n) / fast::sqrt(dot(n, n));
         return false;
+        }
 
     // Find next support direction perpendicular to plane (v1,v0,v2)
     n = cross(v1 - v0, v2 - v0);
     // Maintain known handedness of the portal: make sure plane normal points towards origin
-    if (dot(n, v0) > OverlapReal(0.0))
+    if (dot(n, v0) > Real(0.0))
         {
         v1.swap(v2);
         n = -n;
@@ -139,13 +157,18 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         if (count >= XENOCOLLIDE_3D_MAX_ITERATIONS)
             {
             err_count++;
+            margin = Real(0.0);
             return true;
             }
 
         // Get the next support point
         v3 = S(n);
         if (dot(v3, n) <= 0)
-            return false; // check if origin outside v3 support plane
+            {
+            // origin outside v3 support plane
+            margin = -dot(v3, n) / fast::sqrt(dot(n, n));
+            return false;
+            }
 
         // If origin lies on opposite side of a plane from the third support point, use outer-facing plane normal
         // to find a new support point.
@@ -153,7 +176,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // if (dot(cross(v3 - v0, v1 - v0), -v0) < 0)
         // -> if (dot(cross(v1 - v0, v3 - v0), v0) < 0)
         // A little bit of algebra shows that dot(cross(a - c, b - c), c) == dot(cross(a, b), c)
-        if (dot(cross(v1, v3), v0) < OverlapReal(0.0))
+        if (dot(cross(v1, v3), v0) < Real(0.0))
             {
             // replace v2 and find new support direction
             v2 = v3; // preserve handedness
@@ -161,7 +184,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
             continue; // continue iterating to find valid portal
             }
         // Check (v2, v0, v3)
-        if (dot(cross(v3, v2), v0) < OverlapReal(0.0))
+        if (dot(cross(v3, v2), v0) < Real(0.0))
             {
             // replace v1 and find new support direction
             v1 = v3;
@@ -186,8 +209,9 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // check if origin is inside (or overlapping)
         // the = is important, because in an MC simulation you are guaranteed to find cases where edges and or vertices
         // touch exactly
-        if (dot(v1, n) >= OverlapReal(0.0))
+        if (dot(v1, n) >= Real(0.0))
             {
+            margin = dot(v1, n) / fast::sqrt(dot(n, n));
             return true;
             }
 
@@ -197,26 +221,34 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         // ----
         // if (origin outside support plane) return false
-        if (dot(v4, n) < OverlapReal(0.0))
+        if (dot(v4, n) < Real(0.0))
             {
+            margin = -dot(v4, n) / fast::sqrt(dot(n, n));
             return false;
             }
 
         // Perform tolerance checks
         // are we within an epsilon of the surface of the shape? If yes, done, one way or another
-        const OverlapReal tol_multiplier = 10000;
+        const Real tol_multiplier = 10000;
         n = cross(v2 - v1, v3 - v1);
         d = dot((v4 - v1) * tol_multiplier, n);
-        OverlapReal tol = precision_tol * tol_multiplier * R * fast::sqrt(dot(n,n));
+        Real tol = precision_tol * tol_multiplier * R * fast::sqrt(dot(n,n));
 
         // First, check if v4 is on plane (v2,v1,v3)
         if (fabs(d) < tol)
-            return false; // no more refinement possible, but not intersection detected
+            {
+            // no more refinement possible, but not intersection detected
+            margin = -dot(v1, n) / fast::sqrt(dot(n, n));
+            return false;
+            }
 
         // Second, check if origin is on plane (v2,v1,v3) and has been missed by other checks
         d = dot(v1 * tol_multiplier, n);
         if (fabs(d) < tol)
+            {
+            margin = Real(0.0);
             return true;
+            }
 
         if (count >= XENOCOLLIDE_3D_MAX_ITERATIONS)
             {
@@ -244,6 +276,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
                 d, tol
                 );
             */
+            margin = Real(0.0);
             return true;
             }
 
@@ -260,17 +293,17 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         //        (v1 % v4) * v0 == v1 * (v4 % v0)    > 0 if origin inside (v1, v4, v0)
         //        (v2 % v4) * v0 == v2 * (v4 % v0)    > 0 if origin inside (v2, v4, v0)
         //        (v3 % v4) * v0 == v3 * (v4 % v0)    > 0 if origin inside (v3, v4, v0)
-        vec3<OverlapReal> x = cross(v4, v0);
-        if (dot(v1, x) > OverlapReal(0.0))
+        vec3<Real> x = cross(v4, v0);
+        if (dot(v1, x) > Real(0.0))
             {
-            if (dot(v2, x) > OverlapReal(0.0))
+            if (dot(v2, x) > Real(0.0))
                 v1 = v4;    // Inside v1 & inside v2 ==> eliminate v1
             else
                 v3 = v4;                   // Inside v1 & outside v2 ==> eliminate v3
             }
         else
             {
-            if (dot(v3, x) > OverlapReal(0.0))
+            if (dot(v3, x) > Real(0.0))
                 v2 = v4;    // Outside v1 & inside v3 ==> eliminate v2
             else
                 v1 = v4;                   // Outside v1 & outside v3 ==> eliminate v1
@@ -278,6 +311,81 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         }
     }
+> eliminate v1
+            }
+
+        }
+    }
+
+//! XenoCollide overlap check in 3D
+/*! \param sa Support function for shape A
+    \param sb Support function for shape B
+    \param ab_t Vector pointing from a's center to b's center, in frame A
+    \param q Orientation of shape B in frame A
+    \param R Approximate radius of Minkowski difference for scaling tolerance value
+    \param err_count Error counter to increment whenever an infinite loop is encountered
+    \returns true when the two shapes overlap and false when they are disjoint.
+
+    See xenocollide_3d_margin().
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
+                                  const SupportFuncB& sb,
+                                  const vec3<OverlapReal>& ab_t,
+                                  const quat<OverlapReal>& q,
+                                  const OverlapReal R,
+                                  unsigned int& err_count)
+    {
+    OverlapReal margin;
+    return xenocollide_3d_margin(sa, sb, ab_t, q, R, err_count, margin);
+    }
+
+//! XenoCollide overlap check in 3D with a double precision fallback
+/*! \param sa Support function for shape A
+    \param sb Support function for shape B
+    \param ab_t Vector pointing from a's center to b's center, in frame A
+    \param q Orientation of shape B in frame A
+    \param R Approximate radius of Minkowski difference for scaling tolerance value
+    \param err_count Error counter to increment whenever an infinite loop is encountered
+    \returns true when the two shapes overlap and false when they are disjoint.
+
+    When OverlapReal is float, the check first runs in single precision. Near contacts, where the separation of the
+    origin from the deciding support plane is within XENOCOLLIDE_3D_MIXED_BAND * R, the rounding of the
+    composite support points can flip the result, so the check is repeated with the Minkowski difference composed in
+    double precision. Only a small fraction of the pairs fall in the band, so this keeps the throughput of the single
+    precision check with the results of the double precision one. With double precision OverlapReal, this is
+    xenocollide_3d().
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d_mixed(const SupportFuncA& sa,
+                                        const SupportFuncB& sb,
+                                        const vec3<double>& ab_t,
+                                        const quat<double>& q,
+                                        const OverlapReal R,
+                                        unsigned int& err_count)
+    {
+    OverlapReal margin;
+    bool overlap = xenocollide_3d_margin(sa,
+                                         sb,
+                                         vec3<OverlapReal>(ab_t),
+                                         quat<OverlapReal>(q),
+                                         R,
+                                         err_count,
+                                         margin);
+
+    if (sizeof(OverlapReal) < sizeof(double) && double(margin) < XENOCOLLIDE_3D_MIXED_BAND * double(R))
+        {
+        double margin_double;
+        overlap = xenocollide_3d_margin(sa, sb, ab_t, q, double(R), err_count, margin_double);
+        }
+
+    return overlap;
+    }
+
 } // end namespace hpmc::detail
 
 }; // end namespace hpmc
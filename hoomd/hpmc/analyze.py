@@ -98,6 +98,9 @@ class sdf(_analyzer):
             hoomd.context.current.device.cpp_msg.error("analyze.sdf: Unsupported integrator.\n");
             raise runtime_error("Error initializing analyze.sdf");
 
+        if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+            cls = getattr(_hpmc, cls.__name__ + 'GPU');
+
         self.cpp_analyzer = cls(hoomd.context.current.system_definition,
                                 mc.cpp_integrator,
                                 xmax,
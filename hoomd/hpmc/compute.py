@@ -52,11 +52,27 @@ class FreeVolume(Compute):
         `FreeVolume` respects the ``interaction_matrix`` set in the HPMC
         integrator.
 
+    Call `sample` to add the free volume at the current time step to a
+    running average `free_volume_mean`. The overlap counts of the samples are
+    summed over the MPI ranks only when the running average is read, so
+    sampling often adds no communication. `free_volume_error` is the standard
+    error of the samples, which assumes that they are uncorrelated. Space the
+    samples apart by more than the correlation time of the free volume.
+
     Examples::
 
         fv = hoomd.hpmc.compute.FreeVolume(test_particle_type='B',
                                            num_samples=1000)
 
+    Sample the free volume every 1000 steps::
+
+        class Sample(hoomd.custom.Action):
+            def act(self, timestep):
+                fv.sample()
+
+        sim.operations.writers.append(
+            hoomd.write.CustomWriter(action=Sample(), trigger=1000))
+
 
     Attributes:
         test_particle_type (str): Test particle type.
@@ -107,3 +123,47 @@ class FreeVolume(Compute):
             return self._cpp_obj.free_volume
         else:
             return None
+
+    def sample(self):
+        """Add the free volume at the current time step to the running average.
+
+        Samples on a time step that has already been sampled are ignored.
+        """
+        if not self._attached:
+            raise RuntimeError("FreeVolume must be attached before sampling.")
+        self._cpp_obj.sample(self._simulation.timestep)
+
+    def reset_samples(self):
+        """Remove all samples from the running average."""
+        if self._attached:
+            self._cpp_obj.reset_samples()
+
+    @log
+    def free_volume_mean(self):
+        """float: Running average of the sampled free volumes.
+
+        NaN before the first sample.
+        """
+        if self._attached:
+            return self._cpp_obj.free_volume_mean
+        else:
+            return None
+
+    @log
+    def free_volume_error(self):
+        """float: Standard error of `free_volume_mean`.
+
+        NaN before the second sample.
+        """
+        if self._attached:
+            return self._cpp_obj.free_volume_error
+        else:
+            return None
+
+    @log
+    def num_free_volume_samples(self):
+        """int: Number of samples in `free_volume_mean`."""
+        if self._attached:
+            return self._cpp_obj.num_free_volume_samples
+        else:
+            return None
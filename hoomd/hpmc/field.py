@@ -920,6 +920,7 @@ class callback(_external):
         mc (:py:mod:`hoomd.hpmc.integrate`): MC integrator.
         callback (`callable`): A python function to evaluate the energy of a configuration
         composite (bool): True if this evaluator is part of a composite external field
+        batch (bool): When True, call *energy_function* with arrays of particle properties instead of a snapshot
 
     Example::
 
@@ -935,8 +936,18 @@ class callback(_external):
           mc.shape_param.set('A',diameter=1.0)
           hpmc.field.callback(mc=mc, energy_function=energy);
           run(100)
+
+    With ``batch=True``, *energy_function* is called as ``energy_function(box, types, positions, orientations)``
+    with the particle type ids (shape ``(N,)``), positions (shape ``(N,3)``) and orientations (shape ``(N,4)``) of
+    a whole configuration and returns the energy of each particle. A single call evaluates all particles, or both
+    the old and new state of a moved particle, and no snapshot is taken::
+
+          def energy(box, types, positions, orientations):
+              return -positions @ numpy.array([5,0,0])
+
+          hpmc.field.callback(mc=mc, energy_function=energy, batch=True);
     """
-    def __init__(self, mc, energy_function, composite=False):
+    def __init__(self, mc, energy_function, composite=False, batch=False):
         _external.__init__(self);
         cls = None;
         if not hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
@@ -974,7 +985,7 @@ class callback(_external):
             raise RuntimeError("Error initializing hpmc.field.callback");
 
         self.compute_name = "callback"
-        self.cpp_compute = cls(hoomd.context.current.system_definition, energy_function)
+        self.cpp_compute = cls(hoomd.context.current.system_definition, energy_function, batch)
         hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name)
         if not composite:
             mc.set_external(self);
@@ -113,6 +113,56 @@ class HPMCIntegrator(BaseIntegrator):
         nselect (int): Number of trial moves to perform per particle per
             timestep.
 
+        checkerboard (bool): Set to `True` to perform trial moves concurrently
+            on a checkerboard of cells on the CPU (**default:** `False`). This
+            requires a build with TBB. The checkerboard sweep is used for hard
+            particles without depletants on a single MPI rank, in boxes at least
+            four maximum particle diameters wide. Otherwise, HPMC falls back to
+            the serial sweep. It results in a different (valid) Markov chain
+            than the serial sweep.
+
+        depletant_load_balance (bool): Set to `True` to distribute the
+            depletant insertions of every particle over GPU thread blocks in
+            proportion to the number of neighbors in its cell (**default:**
+            `False`). This speeds up inhomogeneous systems, such as phase
+            separated colloid polymer mixtures, where the default launch sizes
+            the work of all particles by the maximum. It does not change the
+            Markov chain, and applies to depletants with ``depletant_ntrial``
+            of 0.
+
+        sync_free (bool): Set to `True` to reduce the host synchronizations
+            of the GPU sweep (**default:** `False`). Overflows of the shared
+            memory lists are then detected only together with the convergence
+            flag at the end of each iteration, after which the affected sweep
+            is restarted with larger lists. The move counters are left on the
+            GPU and read back only when accessed, e.g. when logging `counters`
+            or `mps`. It does not change the Markov chain and speeds up
+            small systems, where the synchronizations dominate the run time.
+            It has no effect on the CPU.
+
+        nlist_buffer (float): Buffer distance of the cached overlap candidates
+            (**default:** 0). When positive, the serial CPU sweep caches, for
+            every particle, the particles within the maximum particle diameter
+            plus ``nlist_buffer`` and tests trial moves against them instead of
+            searching the AABB tree. The cache is rebuilt only after a particle
+            moves by more than half the buffer, so choose a buffer a few times
+            larger than the move size ``d``. Like the MD neighbor list buffer,
+            it does not change the Markov chain. It has no effect with patch
+            energies, MPI domain decomposition, the checkerboard sweep, or on
+            the GPU.
+
+        patch_energy_cache (bool): Set to `True` to keep the patch energy of
+            every particle with each of its neighbors between trial moves
+            (**default:** `False`). Trial moves then evaluate only the energy
+            of the new configuration, which halves the cost of patch energies
+            in the CPU sweep. The cached energies are discarded when the box,
+            the particles, or the patch energy object change, but not when the
+            parameters of the patch energy change: set `patch_energy_cache`
+            again after modifying them. The acceptance tests sum the same pair
+            energies in a different order, so the Markov chain matches the
+            uncached one only up to round-off. It has no effect with MPI domain
+            decomposition or on the GPU.
+
     .. rubric:: Attributes
     """
 
@@ -124,7 +174,12 @@ class HPMCIntegrator(BaseIntegrator):
         # Set base parameter dict for hpmc integrators
         param_dict = ParameterDict(
             translation_move_probability=float(translation_move_probability),
-            nselect=int(nselect))
+            nselect=int(nselect),
+            checkerboard=False,
+            depletant_load_balance=False,
+            sync_free=False,
+            nlist_buffer=0.0,
+            patch_energy_cache=False)
         self._param_dict.update(param_dict)
 
         # Set standard typeparameters for hpmc integrators
@@ -170,6 +225,11 @@ class HPMCIntegrator(BaseIntegrator):
 
     def _attach(self):
         """Initialize the reflected c++ class."""
+        if self._cpp_cls not in _hpmc.__dict__:
+            raise RuntimeError(
+                f"{type(self).__name__} is not available in this build of "
+                f"HOOMD-blue. Add it to HPMC_SHAPES when configuring the build.")
+
         sys_def = self._simulation.state._cpp_sys_def
         if (isinstance(self._simulation.device, hoomd.device.GPU)
                 and (self._cpp_cls + 'GPU') in _hpmc.__dict__):
@@ -21,6 +21,7 @@
 #include "UpdaterClusters.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterQuickCompress.h"
+#include "TunerMoveSize.h"
 
 #include "GPUTree.h"
 
@@ -62,21 +63,49 @@ PYBIND11_MODULE(_hpmc, m)
 
     export_UpdaterBoxMC(m);
     export_UpdaterQuickCompress(m);
+    export_TunerMoveSize(m);
     export_external_fields(m);
 
+    // shapes are exported when they are selected with HPMC_SHAPES at build time
+    #ifdef ENABLE_HPMC_SHAPE_SPHERE
     export_sphere(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_CONVEX_POLYGON
     export_convex_polygon(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_SIMPLE_POLYGON
     export_simple_polygon(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_SPHEROPOLYGON
     export_spheropolygon(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_POLYHEDRON
     export_polyhedron(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_ELLIPSOID
     export_ellipsoid(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_FACETED_ELLIPSOID
     export_faceted_ellipsoid(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_SPHINX
     export_sphinx(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_UNION_CONVEX_POLYHEDRON
     export_union_convex_polyhedron(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_UNION_FACETED_ELLIPSOID
     export_union_faceted_ellipsoid(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_UNION_SPHERE
     export_union_sphere(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_CONVEX_POLYHEDRON
     export_convex_polyhedron(m);
+    #endif
+    #ifdef ENABLE_HPMC_SHAPE_CONVEX_SPHEROPOLYHEDRON
     export_convex_spheropolyhedron(m);
+    #endif
 
     py::class_<SphereParams, std::shared_ptr<SphereParams> >(m, "SphereParams")
         .def(pybind11::init< pybind11::dict >())
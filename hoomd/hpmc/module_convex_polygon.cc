@@ -20,10 +20,13 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterClusters.h"
+#include "UpdaterEventChain.h"
 
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -46,6 +49,7 @@ void export_convex_polygon(py::module& m)
     export_AnalyzerSDF< ShapeConvexPolygon >(m, "AnalyzerSDFConvexPolygon");
     export_UpdaterMuVT< ShapeConvexPolygon >(m, "UpdaterMuVTConvexPolygon");
     export_UpdaterClusters< ShapeConvexPolygon >(m, "UpdaterClustersConvexPolygon");
+    export_UpdaterEventChain< ShapeConvexPolygon >(m, "UpdaterEventChainConvexPolygon");
 
     export_ExternalFieldInterface<ShapeConvexPolygon>(m, "ExternalFieldConvexPolygon");
     export_LatticeField<ShapeConvexPolygon>(m, "ExternalFieldLatticeConvexPolygon");
@@ -58,6 +62,8 @@ void export_convex_polygon(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapeConvexPolygon >(m, "IntegratorHPMCMonoConvexPolygonGPU");
     export_ComputeFreeVolumeGPU< ShapeConvexPolygon >(m, "ComputeFreeVolumeConvexPolygonGPU");
+    export_AnalyzerSDFGPU< ShapeConvexPolygon >(m, "AnalyzerSDFConvexPolygonGPU");
+    export_UpdaterMuVTGPU< ShapeConvexPolygon >(m, "UpdaterMuVTConvexPolygonGPU");
     export_UpdaterClustersGPU< ShapeConvexPolygon >(m, "UpdaterClustersConvexPolygonGPU");
     #endif
     }
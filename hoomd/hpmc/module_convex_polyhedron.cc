@@ -20,10 +20,13 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterClusters.h"
+#include "UpdaterEventChain.h"
 
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -46,6 +49,7 @@ void export_convex_polyhedron(py::module& m)
     export_AnalyzerSDF< ShapeConvexPolyhedron >(m, "AnalyzerSDFConvexPolyhedron");
     export_UpdaterMuVT< ShapeConvexPolyhedron >(m, "UpdaterMuVTConvexPolyhedron");
     export_UpdaterClusters< ShapeConvexPolyhedron >(m, "UpdaterClustersConvexPolyhedron");
+    export_UpdaterEventChain< ShapeConvexPolyhedron >(m, "UpdaterEventChainConvexPolyhedron");
 
     export_ExternalFieldInterface<ShapeConvexPolyhedron >(m, "ExternalFieldConvexPolyhedron");
     export_LatticeField<ShapeConvexPolyhedron >(m, "ExternalFieldLatticeConvexPolyhedron");
@@ -59,6 +63,8 @@ void export_convex_polyhedron(py::module& m)
 
     export_IntegratorHPMCMonoGPU< ShapeConvexPolyhedron >(m, "IntegratorHPMCMonoConvexPolyhedronGPU");
     export_ComputeFreeVolumeGPU< ShapeConvexPolyhedron >(m, "ComputeFreeVolumeConvexPolyhedronGPU");
+    export_AnalyzerSDFGPU< ShapeConvexPolyhedron >(m, "AnalyzerSDFConvexPolyhedronGPU");
+    export_UpdaterMuVTGPU< ShapeConvexPolyhedron >(m, "UpdaterMuVTConvexPolyhedronGPU");
     export_UpdaterClustersGPU< ShapeConvexPolyhedron >(m, "UpdaterClustersConvexPolyhedronGPU");
 
     #endif
@@ -24,6 +24,8 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -59,6 +61,8 @@ void export_convex_spheropolyhedron(py::module& m)
 
     export_IntegratorHPMCMonoGPU< ShapeSpheropolyhedron >(m, "IntegratorHPMCMonoSpheropolyhedronGPU");
     export_ComputeFreeVolumeGPU< ShapeSpheropolyhedron >(m, "ComputeFreeVolumeSpheropolyhedronGPU");
+    export_AnalyzerSDFGPU< ShapeSpheropolyhedron >(m, "AnalyzerSDFSpheropolyhedronGPU");
+    export_UpdaterMuVTGPU< ShapeSpheropolyhedron >(m, "UpdaterMuVTConvexSpheropolyhedronGPU");
     export_UpdaterClustersGPU< ShapeSpheropolyhedron >(m, "UpdaterClustersConvexSpheropolyhedronGPU");
 
     #endif
@@ -24,6 +24,8 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -55,6 +57,8 @@ void export_ellipsoid(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapeEllipsoid >(m, "IntegratorHPMCMonoEllipsoidGPU");
     export_ComputeFreeVolumeGPU< ShapeEllipsoid >(m, "ComputeFreeVolumeEllipsoidGPU");
+    export_AnalyzerSDFGPU< ShapeEllipsoid >(m, "AnalyzerSDFEllipsoidGPU");
+    export_UpdaterMuVTGPU< ShapeEllipsoid >(m, "UpdaterMuVTEllipsoidGPU");
     export_UpdaterClustersGPU< ShapeEllipsoid >(m, "UpdaterClustersEllipsoidGPU");
     #endif
     }
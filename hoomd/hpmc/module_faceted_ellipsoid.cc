@@ -23,6 +23,8 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -57,6 +59,8 @@ void export_faceted_ellipsoid(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapeFacetedEllipsoid >(m, "IntegratorHPMCMonoFacetedEllipsoidGPU");
     export_ComputeFreeVolumeGPU< ShapeFacetedEllipsoid >(m, "ComputeFreeVolumeFacetedEllipsoidGPU");
+    export_AnalyzerSDFGPU< ShapeFacetedEllipsoid >(m, "AnalyzerSDFFacetedEllipsoidGPU");
+    export_UpdaterMuVTGPU< ShapeFacetedEllipsoid >(m, "UpdaterMuVTFacetedEllipsoidGPU");
     export_UpdaterClustersGPU< ShapeFacetedEllipsoid >(m, "UpdaterClustersFacetedEllipsoidGPU");
     #endif
     }
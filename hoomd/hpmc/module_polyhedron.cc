@@ -24,6 +24,7 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -55,6 +56,7 @@ void export_polyhedron(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapePolyhedron >(m, "IntegratorHPMCMonoPolyhedronGPU");
     export_ComputeFreeVolumeGPU< ShapePolyhedron >(m, "ComputeFreeVolumePolyhedronGPU");
+    export_UpdaterMuVTGPU< ShapePolyhedron >(m, "UpdaterMuVTPolyhedronGPU");
     export_UpdaterClustersGPU< ShapePolyhedron >(m, "UpdaterClustersPolyhedronGPU");
     #endif
     }
@@ -24,6 +24,8 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -58,6 +60,8 @@ void export_simple_polygon(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapeSimplePolygon >(m, "IntegratorHPMCMonoSimplePolygonGPU");
     export_ComputeFreeVolumeGPU< ShapeSimplePolygon >(m, "ComputeFreeVolumeSimplePolygonGPU");
+    export_AnalyzerSDFGPU< ShapeSimplePolygon >(m, "AnalyzerSDFSimplePolygonGPU");
+    export_UpdaterMuVTGPU< ShapeSimplePolygon >(m, "UpdaterMuVTSimplePolygonGPU");
     export_UpdaterClustersGPU< ShapeSimplePolygon >(m, "UpdaterClustersSimplePolygonGPU");
     #endif
     }
@@ -20,10 +20,13 @@
 #include "UpdaterRemoveDrift.h"
 #include "UpdaterMuVT.h"
 #include "UpdaterClusters.h"
+#include "UpdaterEventChain.h"
 
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -43,6 +46,7 @@ void export_sphere(py::module& m)
     export_AnalyzerSDF< ShapeSphere >(m, "AnalyzerSDFSphere");
     export_UpdaterMuVT< ShapeSphere >(m, "UpdaterMuVTSphere");
     export_UpdaterClusters< ShapeSphere >(m, "UpdaterClustersSphere");
+    export_UpdaterEventChain< ShapeSphere >(m, "UpdaterEventChainSphere");
 
     export_ExternalFieldInterface<ShapeSphere>(m, "ExternalFieldSphere");
     export_LatticeField<ShapeSphere>(m, "ExternalFieldLatticeSphere");
@@ -55,6 +59,8 @@ void export_sphere(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapeSphere >(m, "IntegratorHPMCMonoSphereGPU");
     export_ComputeFreeVolumeGPU< ShapeSphere >(m, "ComputeFreeVolumeSphereGPU");
+    export_AnalyzerSDFGPU< ShapeSphere >(m, "AnalyzerSDFSphereGPU");
+    export_UpdaterMuVTGPU< ShapeSphere >(m, "UpdaterMuVTSphereGPU");
     export_UpdaterClustersGPU< ShapeSphere >(m, "UpdaterClustersSphereGPU");
     #endif
     }
@@ -24,6 +24,8 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -55,6 +57,8 @@ void export_spheropolygon(py::module& m)
     #ifdef ENABLE_HIP
     export_IntegratorHPMCMonoGPU< ShapeSpheropolygon >(m, "IntegratorHPMCMonoSpheropolygonGPU");
     export_ComputeFreeVolumeGPU< ShapeSpheropolygon >(m, "ComputeFreeVolumeSpheropolygonGPU");
+    export_AnalyzerSDFGPU< ShapeSpheropolygon >(m, "AnalyzerSDFSpheropolygonGPU");
+    export_UpdaterMuVTGPU< ShapeSpheropolygon >(m, "UpdaterMuVTConvexSpheropolygonGPU");
     export_UpdaterClustersGPU< ShapeSpheropolygon >(m, "UpdaterClustersConvexSpheropolygonGPU");
     #endif
     }
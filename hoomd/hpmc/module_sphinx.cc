@@ -24,6 +24,8 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -57,6 +59,8 @@ void export_sphinx(py::module& m)
 
     export_IntegratorHPMCMonoGPU< ShapeSphinx >(m, "IntegratorHPMCMonoSphinxGPU");
     export_ComputeFreeVolumeGPU< ShapeSphinx >(m, "ComputeFreeVolumeSphinxGPU");
+    export_AnalyzerSDFGPU< ShapeSphinx >(m, "AnalyzerSDFSphinxGPU");
+    export_UpdaterMuVTGPU< ShapeSphinx >(m, "UpdaterMuVTSphinxGPU");
     export_UpdaterClustersGPU< ShapeSphinx >(m, "UpdaterClustersSphinxGPU");
 
     #endif
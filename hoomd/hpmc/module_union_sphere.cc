@@ -23,6 +23,7 @@
 #ifdef ENABLE_HIP
 #include "IntegratorHPMCMonoGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "UpdaterMuVTGPU.h"
 #include "UpdaterClustersGPU.h"
 #endif
 
@@ -56,6 +57,7 @@ void export_union_sphere(py::module& m)
 
     export_IntegratorHPMCMonoGPU< ShapeUnion<ShapeSphere> >(m, "IntegratorHPMCMonoSphereUnionGPU");
     export_ComputeFreeVolumeGPU< ShapeUnion<ShapeSphere> >(m, "ComputeFreeVolumeSphereUnionGPU");
+    export_UpdaterMuVTGPU< ShapeUnion<ShapeSphere> >(m, "UpdaterMuVTSphereUnionGPU");
     export_UpdaterClustersGPU< ShapeUnion<ShapeSphere> >(m, "UpdaterClustersSphereUnionGPU");
 
     #endif
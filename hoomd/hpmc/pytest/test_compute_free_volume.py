@@ -68,3 +68,44 @@ def test_validation_systems(simulation_factory, two_particle_snapshot_factory,
     np.testing.assert_allclose(free_volume,
                                free_volume_compute.free_volume,
                                rtol=2e-2)
+
+
+def test_sampling(simulation_factory, lattice_snapshot_factory):
+    n = 7
+    radius1, radius2 = _radii[0]
+    free_volume = (n**3) * (1 - (4 / 3) * np.pi * (radius1 + radius2)**3)
+    sim = simulation_factory(
+        lattice_snapshot_factory(particle_types=['A', 'B'],
+                                 n=n,
+                                 a=1,
+                                 dimensions=3,
+                                 r=0))
+
+    mc = hoomd.hpmc.integrate.Sphere(d=0.01)
+    mc.shape["A"] = {'diameter': radius1 * 2}
+    mc.shape["B"] = {'diameter': radius2 * 2}
+    sim.operations.add(mc)
+
+    free_volume_compute = hoomd.hpmc.compute.FreeVolume(test_particle_type='B',
+                                                        num_samples=5000)
+    sim.operations.add(free_volume_compute)
+    assert free_volume_compute.free_volume_mean is None
+    sim.run(0)
+
+    assert free_volume_compute.num_free_volume_samples == 0
+    assert np.isnan(free_volume_compute.free_volume_mean)
+
+    for i in range(5):
+        free_volume_compute.sample()
+        # repeated samples on one time step are ignored
+        free_volume_compute.sample()
+        sim.run(1)
+
+    assert free_volume_compute.num_free_volume_samples == 5
+    np.testing.assert_allclose(free_volume,
+                               free_volume_compute.free_volume_mean,
+                               rtol=2e-2)
+    assert free_volume_compute.free_volume_error > 0
+
+    free_volume_compute.reset_samples()
+    assert free_volume_compute.num_free_volume_samples == 0
@@ -0,0 +1,90 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause
+# License.
+
+"""Test hoomd.hpmc.update.EventChain."""
+
+import hoomd
+import pytest
+import numpy as np
+
+valid_attrs = [
+    ('trigger', hoomd.trigger.Periodic(10)),
+    ('chain_length', 2.5),
+    ('n_chains', 20),
+]
+
+cube = [(-0.5, -0.5, -0.5), (-0.5, -0.5, 0.5), (-0.5, 0.5, -0.5),
+        (-0.5, 0.5, 0.5), (0.5, -0.5, -0.5), (0.5, -0.5, 0.5),
+        (0.5, 0.5, -0.5), (0.5, 0.5, 0.5)]
+
+square = [(-0.5, -0.5), (0.5, -0.5), (0.5, 0.5), (-0.5, 0.5)]
+
+shapes = [
+    (hoomd.hpmc.integrate.Sphere, dict(diameter=1.0), 3),
+    (hoomd.hpmc.integrate.ConvexPolyhedron, dict(vertices=cube), 3),
+    (hoomd.hpmc.integrate.ConvexPolygon, dict(vertices=square), 2),
+]
+
+
+@pytest.mark.serial
+@pytest.mark.parametrize("attr,value", valid_attrs)
+def test_valid_setattr(device, attr, value):
+    """Test that EventChain can get and set attributes."""
+    ec = hoomd.hpmc.update.EventChain(trigger=hoomd.trigger.Periodic(1))
+
+    setattr(ec, attr, value)
+    assert getattr(ec, attr) == value
+
+
+@pytest.mark.serial
+@pytest.mark.parametrize("integrator,shape,dim", shapes)
+def test_chains(device, simulation_factory, lattice_snapshot_factory,
+                integrator, shape, dim):
+    """Test that event chains move particles without creating overlaps."""
+    if isinstance(device, hoomd.device.GPU):
+        pytest.skip("EventChain runs on the CPU only")
+
+    sim = simulation_factory(
+        lattice_snapshot_factory(dimensions=dim, a=1.2, n=6))
+
+    mc = integrator(d=0, a=0)
+    mc.shape['A'] = shape
+    sim.operations.integrator = mc
+
+    ec = hoomd.hpmc.update.EventChain(trigger=hoomd.trigger.Periodic(1),
+                                      chain_length=3.0,
+                                      n_chains=10)
+    sim.operations.updaters.append(ec)
+
+    sim.run(0)
+    assert ec.chains == 0
+    pos_start = sim.state.snapshot.particles.position
+
+    sim.run(10)
+
+    assert ec.chains == 100
+    assert ec.collisions > 0
+    assert mc.overlaps == 0
+
+    pos_end = sim.state.snapshot.particles.position
+    assert not np.allclose(pos_start, pos_end)
+    if dim == 2:
+        np.testing.assert_allclose(pos_end[:, 2], 0)
+
+
+@pytest.mark.serial
+def test_unsupported_integrator(device, simulation_factory,
+                                lattice_snapshot_factory):
+    """Test that EventChain rejects shapes it does not support."""
+    sim = simulation_factory(lattice_snapshot_factory(a=2, n=3))
+
+    mc = hoomd.hpmc.integrate.Ellipsoid()
+    mc.shape['A'] = dict(a=0.5, b=0.5, c=0.5)
+    sim.operations.integrator = mc
+
+    ec = hoomd.hpmc.update.EventChain()
+    sim.operations.updaters.append(ec)
+
+    with pytest.raises(RuntimeError):
+        sim.run(0)
@@ -1,9 +1,10 @@
 from math import isclose
 import pytest
 
+import hoomd
 from hoomd import hpmc
 from hoomd.hpmc.tune.move_size import (
-    _MoveSizeTuneDefinition, MoveSize)
+    _MoveSizeTuneDefinition, MoveSize, OnlineMoveSize, OnlineBoxMCMoveSize)
 
 
 @pytest.fixture
@@ -203,3 +204,59 @@ class TestMoveSize:
         tolerance = move_size_tuner.solver.tol
         assert abs(acceptance_rate - move_size_tuner.target) <= tolerance
         print(simulation.timestep)
+
+
+class TestOnlineMoveSize:
+
+    def test_set_params(self):
+        tuner = OnlineMoveSize(trigger=hoomd.trigger.Periodic(10),
+                               moves=['d'],
+                               target=0.5)
+        assert tuner.moves == ['d']
+        assert tuner.target == 0.5
+        assert tuner.freeze
+        assert not tuner.tuned
+
+        tuner.max_translation_move = 0.5
+        assert tuner.max_translation_move == 0.5
+        tuner.tol = 0.05
+        assert tuner.tol == 0.05
+        with pytest.raises(ValueError):
+            tuner.moves = ['f']
+        with pytest.raises(ValueError):
+            tuner.target = 1.5
+
+    def test_tune_in_one_run(self, simulation):
+        tuner = OnlineMoveSize(trigger=hoomd.trigger.Periodic(10),
+                               moves=['d'],
+                               target=0.5,
+                               tol=0.05)
+        simulation.operations.tuners.append(tuner)
+        simulation.run(4000)
+
+        assert tuner.tuned
+        integrator = simulation.operations.integrator
+        assert integrator.d['A'] > 0.01
+
+        # a frozen tuner no longer changes the move size
+        d = integrator.d['A']
+        simulation.run(100)
+        assert integrator.d['A'] == d
+
+
+def test_online_boxmc_move_size(simulation):
+    boxmc = hpmc.update.BoxMC(trigger=hoomd.trigger.Periodic(1), betaP=1.0)
+    boxmc.volume = dict(weight=1.0, mode='standard', delta=1e-3)
+    simulation.operations.updaters.append(boxmc)
+
+    tuner = OnlineBoxMCMoveSize(trigger=hoomd.trigger.Periodic(10),
+                                boxmc=boxmc,
+                                moves=['volume'],
+                                target=0.5,
+                                tol=0.1)
+    simulation.operations.tuners.append(tuner)
+    simulation.run(100)
+
+    assert tuner.boxmc is boxmc
+    assert tuner.moves == ['volume']
+    assert boxmc.volume['delta'] != 1e-3
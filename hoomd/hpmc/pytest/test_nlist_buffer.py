@@ -0,0 +1,45 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause
+# License.
+
+"""Test the cached overlap candidates of the HPMC integrators."""
+
+import hoomd
+import pytest
+import numpy as np
+
+
+def test_nlist_buffer_attribute(device):
+    """Test that nlist_buffer can be set."""
+    mc = hoomd.hpmc.integrate.Sphere()
+    assert mc.nlist_buffer == 0
+
+    mc.nlist_buffer = 0.3
+    assert mc.nlist_buffer == 0.3
+
+
+@pytest.mark.serial
+@pytest.mark.parametrize("dimensions", [2, 3])
+def test_same_markov_chain(device, simulation_factory,
+                           lattice_snapshot_factory, dimensions):
+    """Test that the cached candidates reproduce the tree search exactly."""
+    if isinstance(device, hoomd.device.GPU):
+        pytest.skip("The candidate cache is used by the CPU sweep only")
+
+    snap = lattice_snapshot_factory(dimensions=dimensions, a=1.1, n=8)
+
+    positions = []
+    for buffer in [0, 0.4]:
+        sim = simulation_factory(snap)
+        sim.seed = 5
+
+        mc = hoomd.hpmc.integrate.Sphere(d=0.05, nselect=2)
+        mc.shape['A'] = dict(diameter=1.0)
+        mc.nlist_buffer = buffer
+        sim.operations.integrator = mc
+
+        sim.run(100)
+        assert mc.overlaps == 0
+        positions.append(sim.state.snapshot.particles.position)
+
+    np.testing.assert_array_equal(positions[0], positions[1])
@@ -0,0 +1,46 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause
+# License.
+
+"""Test the sync-free GPU sweep of the HPMC integrators."""
+
+import hoomd
+import pytest
+import numpy as np
+
+
+def test_sync_free_attribute(device):
+    """Test that sync_free can be set."""
+    mc = hoomd.hpmc.integrate.Sphere()
+    assert not mc.sync_free
+
+    mc.sync_free = True
+    assert mc.sync_free
+
+
+@pytest.mark.serial
+@pytest.mark.parametrize("dimensions", [2, 3])
+def test_same_markov_chain(device, simulation_factory,
+                           lattice_snapshot_factory, dimensions):
+    """Test that the sync-free sweep reproduces the default sweep exactly."""
+    snap = lattice_snapshot_factory(dimensions=dimensions, a=1.1, n=8)
+
+    positions = []
+    translate = []
+    for sync_free in [False, True]:
+        sim = simulation_factory(snap)
+        sim.seed = 5
+
+        mc = hoomd.hpmc.integrate.Sphere(d=0.05, nselect=2)
+        mc.shape['A'] = dict(diameter=1.0)
+        mc.sync_free = sync_free
+        sim.operations.integrator = mc
+
+        sim.run(100)
+        assert mc.overlaps == 0
+        assert mc.mps > 0
+        positions.append(sim.state.snapshot.particles.position)
+        translate.append(mc.translate_moves)
+
+    np.testing.assert_array_equal(positions[0], positions[1])
+    assert translate[0] == translate[1]
@@ -107,3 +107,62 @@ UP_TEST( bigger )
         UP_ASSERT(in(i, hits));
         }
     }
+
+UP_TEST( refit_reinsert )
+    {
+    const unsigned int N = 1000;
+    hoomd::RandomGenerator rng(hoomd::Seed(0, 1, 2),
+                               hoomd::Counter(7,8,9));
+
+    std::vector< vec3<Scalar> > points(N);
+    AABB aabbs[N];
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] = vec3<Scalar>(hoomd::detail::generate_canonical<float>(rng),
+                                  hoomd::detail::generate_canonical<float>(rng),
+                                  hoomd::detail::generate_canonical<float>(rng))
+                                  * Scalar(100);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+
+    AABBTree tree;
+    tree.buildTree(aabbs, N);
+    UP_ASSERT_EQUAL(tree.getNumParticles(), N);
+
+    // move every tenth point far away and reinsert it, nudge the others slightly
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (i % 10 == 0)
+            {
+            points[i] = Scalar(100) - points[i];
+            UP_ASSERT(tree.reinsert(i, AABB(points[i], Scalar(1.0))));
+            }
+        else
+            {
+            points[i] += vec3<Scalar>(0.1, -0.1, 0.1);
+            }
+        }
+
+    // refit the tree to the current positions, which shrinks the leaves left by the reinserted points
+    for (unsigned int i = 0; i < N; i++)
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+    tree.refit(aabbs);
+
+    std::vector<unsigned int> hits;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        hits.clear();
+        tree.query(hits, AABB(points[i], Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        }
+
+    // every node must enclose its children after the refit
+    for (unsigned int node = 0; node < tree.getNumNodes(); node++)
+        {
+        if (tree.isNodeLeaf(node))
+            {
+            for (unsigned int j = 0; j < tree.getNodeNumParticles(node); j++)
+                UP_ASSERT(contains(tree.getNodeAABB(node), aabbs[tree.getNodeParticle(node, j)]));
+            }
+        }
+    }
@@ -311,6 +311,47 @@ UP_TEST( overlap_cube_no_rot )
     }
 
 
+UP_TEST( overlap_cube_near_contact )
+    {
+    // large rotated cubes placed face to face just inside and just outside of contact
+    quat<Scalar> o = quat<Scalar>::fromAxisAngle(vec3<Scalar>(1,2,3) / sqrt(Scalar(14.0)), Scalar(0.7));
+
+    vector< vec3<OverlapReal> > vlist;
+    vlist.push_back(vec3<OverlapReal>(-50,-50,-50));
+    vlist.push_back(vec3<OverlapReal>(50,-50,-50));
+    vlist.push_back(vec3<OverlapReal>(50,50,-50));
+    vlist.push_back(vec3<OverlapReal>(-50,50,-50));
+    vlist.push_back(vec3<OverlapReal>(-50,-50,50));
+    vlist.push_back(vec3<OverlapReal>(50,-50,50));
+    vlist.push_back(vec3<OverlapReal>(50,50,50));
+    vlist.push_back(vec3<OverlapReal>(-50,50,50));
+    PolyhedronVertices verts(vlist, 0, 0);
+
+    ShapeConvexPolyhedron a(o, verts);
+    ShapeConvexPolyhedron b(o, verts);
+
+    for (Scalar gap : {Scalar(-1e-3), Scalar(1e-3)})
+        {
+        vec3<Scalar> r_ij = rotate(o, vec3<Scalar>(100 + gap, 30, -20));
+        UP_ASSERT_EQUAL(test_overlap(r_ij,a,b,err_count), gap < 0);
+        UP_ASSERT_EQUAL(test_overlap(-r_ij,b,a,err_count), gap < 0);
+
+        // the mixed precision check agrees with the check in double precision
+        double margin;
+        quat<double> qa(a.orientation);
+        vec3<double> dr = rotate(conj(qa), vec3<double>(r_ij));
+        bool overlap_double = xenocollide_3d_margin(SupportFuncConvexPolyhedron(a.verts),
+                                                    SupportFuncConvexPolyhedron(b.verts),
+                                                    dr,
+                                                    conj(qa) * quat<double>(b.orientation),
+                                                    double(verts.diameter),
+                                                    err_count,
+                                                    margin);
+        UP_ASSERT_EQUAL(overlap_double, gap < 0);
+        UP_ASSERT(margin >= 0);
+        }
+    }
+
 UP_TEST( overlap_cube_rot1 )
     {
     // second set of simple overlap checks is two cubes, with one rotated by 45 degrees
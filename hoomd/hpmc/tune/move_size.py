@@ -1,4 +1,6 @@
 from hoomd.custom import _InternalAction
+from hoomd.operation import Tuner
+from hoomd.trigger import Trigger
 from hoomd.data.parameterdicts import ParameterDict, TypeParameterDict
 from hoomd.data.typeparam import TypeParameter
 from hoomd.data.typeconverter import (
@@ -7,6 +9,8 @@ from hoomd.tune import _InternalCustomTuner
 from hoomd.tune.attr_tuner import (
     _TuneDefinition, SolverStep, ScaleSolver, SecantSolver)
 from hoomd.hpmc.integrate import HPMCIntegrator
+from hoomd.hpmc.update import BoxMC
+from hoomd.hpmc import _hpmc
 
 
 class _MoveSizeTuneDefinition(_TuneDefinition):
@@ -391,3 +395,192 @@ class MoveSize(_InternalCustomTuner):
         solver = SecantSolver(gamma, tol)
         return cls(trigger, moves, target, solver, types, max_translation_move,
                    max_rotation_move)
+
+
+def _check_fraction(value):
+    if 0 <= value <= 1:
+        return value
+    raise ValueError("Value {} should be between 0 and 1.".format(value))
+
+
+class _OnlineTuner(Tuner):
+    """Common parameters of the online move size tuners."""
+
+    def __init__(self, trigger, moves, target, max_scale, gamma, tol, freeze):
+        self._param_dict.update(
+            ParameterDict(trigger=Trigger,
+                          target=OnlyTypes(float, postprocess=_check_fraction),
+                          max_scale=float,
+                          gamma=float,
+                          tol=float,
+                          freeze=bool))
+        self.trigger = trigger
+        self.moves = moves
+        self.target = target
+        self.max_scale = max_scale
+        self.gamma = gamma
+        self.tol = tol
+        self.freeze = freeze
+
+    @property
+    def tuned(self):
+        """bool: Whether the move sizes have converged to the target.
+
+        `False` when not attached.
+        """
+        if not self._attached:
+            return False
+        return self._cpp_obj.tuned
+
+
+class OnlineMoveSize(_OnlineTuner):
+    """Tune HPMCIntegrator move sizes during a run.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to tune
+            the move sizes.
+        moves (list[str]): The moves to tune. Available options are 'a' and
+            'd'.
+        target (float): The target acceptance ratio, between 0 and 1.
+        max_translation_move (float): The largest translation move size to
+            set.
+        max_rotation_move (float): The largest rotation move size to set.
+        max_scale (float): The largest factor to scale the move sizes by in
+            one step.
+        gamma (float): Damping of the corrections to the move sizes (larger
+            values increase stability while increasing convergence time).
+        tol (float): The absolute tolerance between the acceptance ratio and
+            the target.
+        freeze (bool): Stop changing the move sizes once tuned.
+
+    `OnlineMoveSize` is a C++ implementation of `MoveSize.scale_solver`. Each
+    time *trigger* fires, it computes the translation and rotation acceptance
+    ratios since the previous step and scales ``d`` and ``a`` of all types by
+    :math:`(\\gamma + \\mathrm{target}) / (\\mathrm{acceptance} + \\gamma)`,
+    limited to the range from ``1/max_scale`` to ``max_scale``. The moves are
+    tuned when the acceptance ratios are within *tol* of the target for two
+    consecutive steps. `OnlineMoveSize` adjusts the move sizes within a single
+    `Simulation.run` without calling back to Python, so there is no need to
+    split the equilibration into many short runs, on the CPU or the GPU. Set a
+    `hoomd.trigger.Periodic` trigger to tune every *k* sweeps.
+
+    Note:
+        The tuner treats all particle types together, using the acceptance
+        ratio of all trial moves, and does not change the move sizes of types
+        with ``d = 0`` or ``a = 0``.
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to tune
+            the move sizes.
+        moves (list[str]): The moves to tune.
+        target (float): The target acceptance ratio.
+        max_translation_move (float): The largest translation move size to
+            set.
+        max_rotation_move (float): The largest rotation move size to set.
+        max_scale (float): The largest factor to scale the move sizes by in
+            one step.
+        gamma (float): Damping of the corrections to the move sizes.
+        tol (float): The absolute tolerance between the acceptance ratio and
+            the target.
+        freeze (bool): Stop changing the move sizes once tuned. Set a new
+            target to resume tuning.
+    """
+
+    def __init__(self,
+                 trigger,
+                 moves,
+                 target,
+                 max_translation_move=float('inf'),
+                 max_rotation_move=float('inf'),
+                 max_scale=2.0,
+                 gamma=1.0,
+                 tol=1e-2,
+                 freeze=True):
+        self._param_dict = ParameterDict(
+            moves=OnlyIf(to_type_converter([OnlyFrom(['a', 'd'])])),
+            max_translation_move=float,
+            max_rotation_move=float)
+        self.max_translation_move = max_translation_move
+        self.max_rotation_move = max_rotation_move
+        super().__init__(trigger, moves, target, max_scale, gamma, tol, freeze)
+
+    def _attach(self):
+        integrator = self._simulation.operations.integrator
+        if not isinstance(integrator, HPMCIntegrator):
+            raise RuntimeError("The integrator must be a HPMC integrator.")
+
+        if not integrator._attached:
+            raise RuntimeError("Integrator is not attached yet.")
+
+        self._cpp_obj = _hpmc.TunerMoveSize(
+            self._simulation.state._cpp_sys_def, self.trigger,
+            integrator._cpp_obj, self.moves, self.target)
+        super()._attach()
+
+
+class OnlineBoxMCMoveSize(_OnlineTuner):
+    """Tune BoxMC move sizes during a run.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to tune
+            the move sizes.
+        boxmc (hoomd.hpmc.update.BoxMC): The box updater to tune.
+        moves (list[str]): The moves to tune. Available options are
+            'volume', 'ln_volume', 'shear', and 'aspect'.
+        target (float): The target acceptance ratio, between 0 and 1.
+        max_scale (float): The largest factor to scale the move sizes by in
+            one step.
+        gamma (float): Damping of the corrections to the move sizes.
+        tol (float): The absolute tolerance between the acceptance ratio and
+            the target.
+        freeze (bool): Stop changing the move sizes once tuned.
+
+    `OnlineBoxMCMoveSize` applies the same update as `OnlineMoveSize` to the
+    ``delta`` of the box moves. 'volume' tunes both the ``volume`` and the
+    ``length`` moves, which share the acceptance counters. The *boxmc* updater
+    must be in the simulation's updaters.
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to tune
+            the move sizes.
+        boxmc (hoomd.hpmc.update.BoxMC): The box updater to tune.
+        moves (list[str]): The moves to tune.
+        target (float): The target acceptance ratio.
+        max_scale (float): The largest factor to scale the move sizes by in
+            one step.
+        gamma (float): Damping of the corrections to the move sizes.
+        tol (float): The absolute tolerance between the acceptance ratio and
+            the target.
+        freeze (bool): Stop changing the move sizes once tuned. Set a new
+            target to resume tuning.
+    """
+
+    def __init__(self,
+                 trigger,
+                 boxmc,
+                 moves,
+                 target,
+                 max_scale=2.0,
+                 gamma=1.0,
+                 tol=1e-2,
+                 freeze=True):
+        self._param_dict = ParameterDict(
+            moves=OnlyIf(
+                to_type_converter(
+                    [OnlyFrom(['volume', 'ln_volume', 'shear', 'aspect'])])))
+        self._boxmc = OnlyTypes(BoxMC)(boxmc)
+        super().__init__(trigger, moves, target, max_scale, gamma, tol, freeze)
+
+    @property
+    def boxmc(self):
+        """hoomd.hpmc.update.BoxMC: The box updater to tune."""
+        return self._boxmc
+
+    def _attach(self):
+        if not self._boxmc._attached:
+            raise RuntimeError("The BoxMC updater must be attached first.")
+
+        self._cpp_obj = _hpmc.TunerBoxMCMoveSize(
+            self._simulation.state._cpp_sys_def, self.trigger,
+            self._boxmc._cpp_obj, self.moves, self.target)
+        super()._attach()
@@ -353,11 +353,23 @@ class MuVT(Updater):
 
         cpp_cls_name = "UpdaterMuVT"
         cpp_cls_name += integrator.__class__.__name__
+        use_gpu = (isinstance(self._simulation.device, hoomd.device.GPU)
+                   and (cpp_cls_name + 'GPU') in _hpmc.__dict__)
+        if use_gpu:
+            cpp_cls_name += "GPU"
         cpp_cls = getattr(_hpmc, cpp_cls_name)
 
-        self._cpp_obj = cpp_cls(self._simulation.state._cpp_sys_def,
-                                integrator._cpp_obj,
-                                self.ngibbs)
+        if use_gpu:
+            sys_def = self._simulation.state._cpp_sys_def
+            self._cpp_cell = _hoomd.CellListGPU(sys_def)
+            self._cpp_obj = cpp_cls(self._simulation.state._cpp_sys_def,
+                                    integrator._cpp_obj,
+                                    self._cpp_cell,
+                                    self.ngibbs)
+        else:
+            self._cpp_obj = cpp_cls(self._simulation.state._cpp_sys_def,
+                                    integrator._cpp_obj,
+                                    self.ngibbs)
         super()._attach()
 
     @log(category='sequence')
@@ -526,6 +538,13 @@ class Clusters(Updater):
 
     The `Clusters` updater support threaded execution on multiple CPU cores.
 
+    .. rubric:: Domain decomposition
+
+    Pivot moves and line reflections map particles across the whole box, so
+    clusters are not local to a domain. `Clusters` does not support MPI domain
+    decomposition. On a GPU device with several GPUs, the interaction graph is
+    built on all devices and its connected components are labelled jointly.
+
     Attributes:
         pivot_move_ratio (float): Set the ratio between pivot and reflection moves.
         flip_probability (float): Set the probability for transforming an
@@ -596,6 +615,95 @@ class Clusters(Updater):
         else:
             return counter.average_cluster_size
 
+
+class EventChain(Updater):
+    r"""Apply event-chain Monte Carlo moves.
+
+    Args:
+        chain_length (float): Total displacement of the particles in one
+            chain :math:`[\mathrm{length}]`.
+        n_chains (int): Number of chains to run on each triggered time step.
+        trigger (Trigger): Select the timesteps on which to run event chains.
+
+    Event-chain Monte Carlo (Bernard, Krauth, and Wilson 2009,
+    http://doi.org/10.1103/PhysRevE.80.056704) moves a randomly chosen
+    particle along a random box axis until it hits another particle. The
+    remaining displacement then passes to the particle that was hit, which
+    moves on in the same direction, until the particles in the chain have
+    moved by `chain_length` in total. Chains are rejection free and relax
+    dense hard particle systems much faster than local moves. They do not
+    rotate particles, so combine `EventChain` with the integrator's local
+    moves for anisotropic shapes.
+
+    `EventChain` supports `hoomd.hpmc.integrate.Sphere`,
+    `hoomd.hpmc.integrate.ConvexPolygon`, and
+    `hoomd.hpmc.integrate.ConvexPolyhedron` with hard interactions only
+    (no patch energies, depletants, or rounded shapes). It runs on the CPU
+    only and does not support MPI domain decomposition.
+
+    Attributes:
+        chain_length (float): Total displacement of the particles in one
+            chain :math:`[\mathrm{length}]`.
+        n_chains (int): Number of chains to run on each triggered time step.
+        trigger (Trigger): Select the timesteps on which to run event chains.
+    """
+
+    def __init__(self, chain_length=1.0, n_chains=1, trigger=1):
+        super().__init__(trigger)
+
+        param_dict = ParameterDict(chain_length=float(chain_length),
+                                   n_chains=int(n_chains))
+
+        self._param_dict.update(param_dict)
+
+    def _add(self, simulation):
+        """Add the operation to a simulation.
+
+        HPMC uses RNGs. Warn the user if they did not set the seed.
+        """
+        if simulation is not None:
+            simulation._warn_if_seed_unset()
+
+        super()._add(simulation)
+
+    def _attach(self):
+        integrator = self._simulation.operations.integrator
+        if not isinstance(integrator, integrate.HPMCIntegrator):
+            raise RuntimeError("The integrator must be a HPMC integrator.")
+
+        cpp_cls_name = "UpdaterEventChain" + integrator.__class__.__name__
+        if cpp_cls_name not in _hpmc.__dict__:
+            raise RuntimeError("EventChain does not support "
+                               f"{integrator.__class__.__name__}.")
+
+        if not integrator._attached:
+            raise RuntimeError("Integrator is not attached yet.")
+
+        cpp_cls = getattr(_hpmc, cpp_cls_name)
+        self._cpp_obj = cpp_cls(self._simulation.state._cpp_sys_def,
+                                integrator._cpp_obj)
+        super()._attach()
+
+    @log
+    def collisions(self):
+        """int: Number of collisions (lifts) in all chains run so far.
+
+        None when not attached
+        """
+        if self._attached:
+            return self._cpp_obj.collisions
+        return None
+
+    @log
+    def chains(self):
+        """int: Number of chains run so far.
+
+        None when not attached
+        """
+        if self._attached:
+            return self._cpp_obj.chains
+        return None
+
 class QuickCompress(Updater):
     """Quickly compress a hard particle system to a target box.
 
@@ -0,0 +1,180 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __PAIR_EVALUATOR_JIT_H__
+#define __PAIR_EVALUATOR_JIT_H__
+
+#ifndef __HIPCC__
+#include <string>
+#include <stdexcept>
+#include <pybind11/pybind11.h>
+#endif
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file EvaluatorPairJIT.h
+    \brief Defines the pair evaluator class for pair potentials compiled at run time
+*/
+
+//! Maximum number of parameters per type pair of a JIT pair potential
+const unsigned int jit_pair_max_params = 16;
+
+//! Class for evaluating user supplied pair potentials
+/*! EvaluatorPairJIT follows the evaluator interface of EvaluatorPairLJ, so the JIT pair potentials use the cutoff,
+    energy shift, XPLOR smoothing, exclusions, logging and MPI machinery of PotentialPair unchanged. The energy and
+    force are computed by a function that LLVM compiles from user code at run time:
+
+    \code
+    Scalar eval(Scalar rsq, const Scalar *param, Scalar d_i, Scalar d_j, Scalar q_i, Scalar q_j, Scalar& force_divr)
+    \endcode
+
+    It returns the pair energy and sets force_divr to -(1/r) dV/dr. \a param points to the parameters of the type pair.
+
+    The parameters store a pointer to the compiled function next to the numerical values, since the evaluator is
+    constructed from the parameters alone. PotentialPairJIT sets it whenever parameters are set. The GPU kernel
+    (PotentialPairJITGPU.inc) reads only the numerical values and calls the NVRTC compiled version of the same code.
+
+    The user function may use the diameters and charges, so both are always requested from PotentialPair.
+*/
+class EvaluatorPairJIT
+    {
+    public:
+        //! Function pointer to the compiled pair function
+        typedef Scalar (*eval_fn)(Scalar rsq,
+                                  const Scalar *param,
+                                  Scalar d_i,
+                                  Scalar d_j,
+                                  Scalar q_i,
+                                  Scalar q_j,
+                                  Scalar& force_divr);
+
+        //! Define the parameter type used by this pair potential evaluator
+        struct param_type
+            {
+            Scalar param[jit_pair_max_params];  //!< Parameters passed to the user function
+            unsigned int n_param;               //!< Number of parameters set
+            eval_fn eval;                       //!< Compiled user function, NULL when the type pair does not interact
+
+            #ifdef ENABLE_HIP
+            //! Set CUDA memory hints
+            void set_memory_hint() const
+                {
+                // default implementation does nothing
+                }
+            #endif
+
+            #ifndef __HIPCC__
+            param_type() : n_param(0), eval(NULL)
+                {
+                for (unsigned int i = 0; i < jit_pair_max_params; ++i)
+                    param[i] = Scalar(0.0);
+                }
+
+            param_type(pybind11::dict v) : param_type()
+                {
+                pybind11::list l = v["params"];
+                if (pybind11::len(l) > jit_pair_max_params)
+                    throw std::runtime_error("JIT pair potentials accept at most " +
+                                             std::to_string(jit_pair_max_params) + " parameters per type pair");
+
+                n_param = (unsigned int) pybind11::len(l);
+                for (unsigned int i = 0; i < n_param; ++i)
+                    param[i] = l[i].cast<Scalar>();
+                }
+
+            pybind11::dict asDict()
+                {
+                pybind11::list l;
+                for (unsigned int i = 0; i < n_param; ++i)
+                    l.append(param[i]);
+
+                pybind11::dict v;
+                v["params"] = l;
+                return v;
+                }
+            #endif
+            };
+
+        #ifndef __HIPCC__
+        //! Constructs the pair potential evaluator
+        /*! \param _rsq Squared distance between the particles
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param _params Per type pair parameters of this potential
+        */
+        EvaluatorPairJIT(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
+            : rsq(_rsq), rcutsq(_rcutsq), params(_params), di(0), dj(0), qi(0), qj(0)
+            {
+            }
+
+        //! The user function may depend on the diameter
+        static bool needsDiameter() { return true; }
+        //! Accept the optional diameter values
+        /*! \param _di Diameter of particle i
+            \param _dj Diameter of particle j
+        */
+        void setDiameter(Scalar _di, Scalar _dj)
+            {
+            di = _di;
+            dj = _dj;
+            }
+
+        //! The user function may depend on the charge
+        static bool needsCharge() { return true; }
+        //! Accept the optional charge values
+        /*! \param _qi Charge of particle i
+            \param _qj Charge of particle j
+        */
+        void setCharge(Scalar _qi, Scalar _qj)
+            {
+            qi = _qi;
+            qj = _qj;
+            }
+
+        //! Evaluate the force and energy
+        /*! \param force_divr Output parameter to write the computed force divided by r.
+            \param pair_eng Output parameter to write the computed pair energy
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+            \return True if they are evaluated or false if they are not because we are beyond the cutoff
+        */
+        bool evalForceAndEnergy(Scalar& force_divr, Scalar& pair_eng, bool energy_shift)
+            {
+            if (rsq < rcutsq && params.eval)
+                {
+                pair_eng = params.eval(rsq, params.param, di, dj, qi, qj, force_divr);
+
+                if (energy_shift)
+                    {
+                    Scalar force_divr_cut;
+                    pair_eng -= params.eval(rcutsq, params.param, di, dj, qi, qj, force_divr_cut);
+                    }
+                return true;
+                }
+            else
+                return false;
+            }
+
+        //! Get the name of this potential
+        /*! \returns The potential name.
+        */
+        static std::string getName()
+            {
+            return std::string("jit");
+            }
+
+        std::string getShapeSpec() const
+            {
+            throw std::runtime_error("Shape definition not supported for this pair potential.");
+            }
+
+    protected:
+        Scalar rsq;                 //!< Stored rsq from the constructor
+        Scalar rcutsq;              //!< Stored rcutsq from the constructor
+        const param_type& params;   //!< Stored parameters from the constructor
+        Scalar di;                  //!< Diameter of particle i
+        Scalar dj;                  //!< Diameter of particle j
+        Scalar qi;                  //!< Charge of particle i
+        Scalar qj;                  //!< Charge of particle j
+        #endif
+    };
+
+#endif // __PAIR_EVALUATOR_JIT_H__
@@ -100,13 +100,20 @@ __device__ union_params_t *d_union_params;
 //! Device storage of rcut value
 __device__ float d_rcut_union;
 
+//! Compute the energy of two overlapping leaf nodes
+/*! The constituent pairs of the two leaves are distributed over the eval_threads of the group (blockDim.x). Each
+    thread transforms a constituent of a only when its pair index advances to the next one, and skips the leaf of b
+    for constituents that are farther from the leaf's bounding box than their largest cutoff.
+
+    \param q_ba Orientation of particle a in the body frame of particle b
+    \param r_ab Position of particle b relative to particle a, in the body frame of particle b
+ */
 __device__ inline float compute_leaf_leaf_energy(const union_params_t* params,
                              float r_cut,
-                             const vec3<float>& dr,
+                             const quat<float>& q_ba,
+                             const vec3<float>& r_ab,
                              unsigned int type_a,
                              unsigned int type_b,
-                             const quat<float>& orientation_a,
-                             const quat<float>& orientation_b,
                              unsigned int cur_node_a,
                              unsigned int cur_node_b)
     {
@@ -128,38 +135,60 @@ __device__ inline float compute_leaf_leaf_energy(const union_params_t* params,
     ptl_i += threadIdx.x / nb;
     ptl_j += threadIdx.x % nb;
 
-    vec3<float> r_ij = rotate(conj(orientation_b),dr);
+    // the leaf OBB bounds the constituent spheres of b
+    const hpmc::detail::OBB obb_b = params[type_b].tree.getOBB(cur_node_b);
+
+    // constituent of a in the frame of b, updated when ptl_i advances
+    unsigned int cached_ptl_i = 0xffffffffu;
+    unsigned int ileaf = 0;
+    unsigned int type_i = 0;
+    quat<float> orientation_i;
+    vec3<float> pos_i;
+    float d_i = 0.0f;
+    bool active_i = false;
 
     while ((ptl_i < ptls_i_end) && (ptl_j < ptls_j_end))
         {
-        unsigned int ileaf = params[type_a].tree.getParticleByIndex(ptl_i);
-        unsigned int type_i = params[type_a].mtype[ileaf];
-
-        quat<float> orientation_i = conj(orientation_b)*orientation_a * params[type_a].morientation[ileaf];
-        vec3<float> pos_i(rotate(conj(orientation_b)*orientation_a,params[type_a].mpos[ileaf])-r_ij);
-
-        unsigned int jleaf = params[type_b].tree.getParticleByIndex(ptl_j);
-        unsigned int type_j = params[type_b].mtype[jleaf];
-        quat<float> orientation_j = params[type_b].morientation[jleaf];
-        vec3<float> r_ij_local = params[type_b].mpos[jleaf] - pos_i;
-
-        float rsq = dot(r_ij_local,r_ij_local);
-        float d_i = params[type_a].mdiameter[ileaf];
-        float d_j = params[type_b].mdiameter[jleaf];
-        float rcut_total = r_cut+0.5f*(d_i + d_j);
+        if (ptl_i != cached_ptl_i)
+            {
+            cached_ptl_i = ptl_i;
+            ileaf = params[type_a].tree.getParticleByIndex(ptl_i);
+            d_i = params[type_a].mdiameter[ileaf];
+            pos_i = rotate(q_ba,params[type_a].mpos[ileaf])-r_ab;
+
+            float rcut_i = r_cut + 0.5f*d_i;
+            active_i = hpmc::detail::SqDistPointOBBSmallerThan(vec3<OverlapReal>(pos_i), obb_b,
+                OverlapReal(rcut_i*rcut_i));
+
+            if (active_i)
+                {
+                type_i = params[type_a].mtype[ileaf];
+                orientation_i = q_ba * params[type_a].morientation[ileaf];
+                }
+            }
 
-        if (rsq <= rcut_total*rcut_total)
+        if (active_i)
             {
-            // evaluate energy via JIT function
-            energy += ::eval(r_ij_local,
-                type_i,
-                orientation_i,
-                d_i,
-                params[type_a].mcharge[ileaf],
-                type_j,
-                orientation_j,
-                d_j,
-                params[type_b].mcharge[jleaf]);
+            unsigned int jleaf = params[type_b].tree.getParticleByIndex(ptl_j);
+            vec3<float> r_ij_local = params[type_b].mpos[jleaf] - pos_i;
+
+            float rsq = dot(r_ij_local,r_ij_local);
+            float d_j = params[type_b].mdiameter[jleaf];
+            float rcut_total = r_cut+0.5f*(d_i + d_j);
+
+            if (rsq <= rcut_total*rcut_total)
+                {
+                // evaluate energy via JIT function
+                energy += ::eval(r_ij_local,
+                    type_i,
+                    orientation_i,
+                    d_i,
+                    params[type_a].mcharge[ileaf],
+                    params[type_b].mtype[jleaf],
+                    params[type_b].morientation[jleaf],
+                    d_j,
+                    params[type_b].mcharge[jleaf]);
+                }
             }
 
         // increment counters
@@ -199,7 +228,9 @@ __device__ inline float eval_union(const union_params_t *params,
     unsigned int cur_node_a = 0;
     unsigned int cur_node_b = 0;
 
-    vec3<float> dr_rot(rotate(conj(q_j),-r_ij));
+    // frame of b, shared by all leaf pairs
+    vec3<float> r_ab(rotate(conj(q_j),r_ij));
+    vec3<float> dr_rot(-r_ab);
     quat<float> q(conj(q_j)*q_i);
 
     hpmc::detail::OBB obb_a = tree_a.getOBB(cur_node_a);
@@ -232,7 +263,7 @@ __device__ inline float eval_union(const union_params_t *params,
 
         if (hpmc::detail::traverseBinaryStack(tree_a, tree_b, cur_node_a, cur_node_b, stack, obb_a, obb_b, q, dr_rot))
             {
-            energy += compute_leaf_leaf_energy(params, r_cut, r_ij, type_i, type_j, q_i, q_j, query_node_a, query_node_b);
+            energy += compute_leaf_leaf_energy(params, r_cut, q, r_ab, type_i, type_j, query_node_a, query_node_b);
             }
         }
     return energy;
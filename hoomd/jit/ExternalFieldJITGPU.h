@@ -0,0 +1,136 @@
+#ifndef _EXTERNAL_FIELD_ENERGY_JIT_GPU_H_
+#define _EXTERNAL_FIELD_ENERGY_JIT_GPU_H_
+
+#ifdef ENABLE_HIP
+
+#include "ExternalFieldJIT.h"
+#include "GPUEvalFactory.h"
+#include <pybind11/stl.h>
+
+#include <vector>
+
+#include "hoomd/Autotuner.h"
+
+//! Evaluate external field energies via runtime generated code, GPU version
+/*! The CPU evaluator of ExternalFieldJIT remains in use for whole-system energies (box moves and logging). Trial moves
+    of the GPU integrators are accepted or rejected by a kernel compiled with NVRTC from the same user code.
+*/
+template< class Shape>
+class ExternalFieldJITGPU : public ExternalFieldJIT<Shape>
+    {
+    public:
+        //! Constructor
+        ExternalFieldJITGPU(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<ExecutionConfiguration> exec_conf,
+                            const std::string& llvm_ir,
+                            const std::string& code,
+                            const std::string& kernel_name,
+                            const std::vector<std::string>& options,
+                            const std::string& cuda_devrt_library_path,
+                            unsigned int compute_arch)
+            : ExternalFieldJIT<Shape>(sysdef, exec_conf, llvm_ir),
+              m_gpu_factory(exec_conf, code, kernel_name, options, cuda_devrt_library_path, compute_arch)
+            {
+            m_tuner.reset(new Autotuner(m_gpu_factory.getLaunchBounds(), 5, 100000, "hpmc_external_jit", this->m_exec_conf));
+            }
+
+        //! Returns true if the field can accept or reject trial moves on the GPU
+        virtual bool hasGPUImplementation()
+            {
+            return true;
+            }
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            m_tuner->setPeriod(period);
+            m_tuner->setEnabled(enable);
+            }
+
+        //! Asynchronously launch the JIT kernel
+        /*! \param args Kernel arguments
+            \param hStream stream to execute on
+        */
+        virtual void rejectMovesGPU(const typename ExternalFieldJIT<Shape>::gpu_args_t& args, hipStream_t hStream)
+            {
+            #ifdef __HIP_PLATFORM_NVCC__
+            assert(args.d_postype);
+            assert(args.d_orientation);
+
+            this->m_exec_conf->beginMultiGPU();
+            m_tuner->begin();
+            unsigned int block_size = m_tuner->getParam();
+
+            // the kernel has no dynamic shared memory, only clamp to the register limit
+            unsigned int run_block_size = std::min(block_size, m_gpu_factory.getKernelMaxThreads(0, 1, block_size)); // fixme GPU 0
+
+            auto& gpu_partition = args.gpu_partition;
+
+            for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+                {
+                auto range = gpu_partition.getRangeAndSetGPU(idev);
+
+                unsigned int nwork = range.second - range.first;
+                dim3 grid(nwork/run_block_size + 1, 1, 1);
+                dim3 threads(run_block_size, 1, 1);
+
+                auto launcher = m_gpu_factory.configureKernel(idev, grid, threads, 0, hStream, 1, block_size);
+
+                CUresult res = launcher(args.d_postype,
+                    args.d_orientation,
+                    args.d_trial_postype,
+                    args.d_trial_orientation,
+                    args.d_trial_move_type,
+                    args.d_charge,
+                    args.d_diameter,
+                    args.d_reject_out_of_cell,
+                    (unsigned int) args.seed,
+                    args.timestep,
+                    args.select,
+                    args.box,
+                    range.first,
+                    nwork);
+
+                if (res != CUDA_SUCCESS)
+                    {
+                    char *error;
+                    cuGetErrorString(res, const_cast<const char **>(&error));
+                    throw std::runtime_error("Error launching NVRTC kernel: "+std::string(error));
+                    }
+                }
+
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            m_tuner->end();
+            this->m_exec_conf->endMultiGPU();
+            #endif
+            }
+
+    protected:
+        std::unique_ptr<Autotuner> m_tuner;     //!< Autotuner for the block size
+
+    private:
+        GPUEvalFactory m_gpu_factory;           //!< JIT implementation
+    };
+
+//! Exports the ExternalFieldJITGPU class to python
+template< class Shape>
+void export_ExternalFieldJITGPU(pybind11::module &m, std::string name)
+    {
+    pybind11::class_<ExternalFieldJITGPU<Shape>, ExternalFieldJIT<Shape>, std::shared_ptr<ExternalFieldJITGPU<Shape> > >(m, name.c_str())
+            .def(pybind11::init< std::shared_ptr<SystemDefinition>,
+                                 std::shared_ptr<ExecutionConfiguration>,
+                                 const std::string&,
+                                 const std::string&,
+                                 const std::string&,
+                                 const std::vector<std::string>&,
+                                 const std::string&,
+                                 unsigned int >())
+            ;
+    }
+
+#endif
+#endif // _EXTERNAL_FIELD_ENERGY_JIT_GPU_H_
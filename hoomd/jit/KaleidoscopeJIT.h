@@ -40,6 +40,9 @@
 
 #include "llvm/IR/Mangler.h"
 #include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/CodeGen.h"
+#include "llvm/ADT/StringMap.h"
 
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
 
@@ -100,7 +103,7 @@ public:
               return nullptr;
             },
             [](Error Err) { cantFail(std::move(Err), "lookupFlags failed"); })),
-        TM(EngineBuilder().selectTarget()), DL(TM->createDataLayout()),
+        TM(selectHostTarget()), DL(TM->createDataLayout()),
         ObjectLayer(ES,
                     [this](VModuleKey) {
                       return RTDYLDOBJECTLINKINGLAYER::Resources{
@@ -146,7 +149,7 @@ public:
   typedef CompileLayerT::ModuleHandleT ModuleHandleT;
 
   KaleidoscopeJIT()
-      : TM(EngineBuilder().selectTarget()), DL(TM->createDataLayout()),
+      : TM(selectHostTarget()), DL(TM->createDataLayout()),
         ObjectLayer([]() { return std::make_shared<SectionMemoryManager>(); }),
         CompileLayer(ObjectLayer, SimpleCompiler(*TM)),
         CXXRuntimeOverrides(
@@ -201,7 +204,7 @@ public:
   typedef CompileLayerT::ModuleSetHandleT ModuleHandleT;
 
   KaleidoscopeJIT()
-      : TM(EngineBuilder().selectTarget()), DL(TM->createDataLayout()),
+      : TM(selectHostTarget()), DL(TM->createDataLayout()),
         CompileLayer(ObjectLayer, SimpleCompiler(*TM)),
         CXXRuntimeOverrides(
             [this](const std::string &S) { return mangle(S); })
@@ -263,6 +266,22 @@ public:
 
 private:
 
+  // Generate code for the host CPU with all of its features, the equivalent
+  // of -O3 -march=native. EngineBuilder defaults to a generic CPU otherwise.
+  static TargetMachine *selectHostTarget() {
+    std::vector<std::string> Attrs;
+    StringMap<bool> Features;
+    if (sys::getHostCPUFeatures(Features))
+      for (auto &F : Features)
+        Attrs.push_back((F.second ? "+" : "-") + F.first().str());
+
+    return EngineBuilder()
+        .setMCPU(sys::getHostCPUName())
+        .setMAttrs(Attrs)
+        .setOptLevel(CodeGenOpt::Aggressive)
+        .selectTarget();
+  }
+
   std::string mangle(const std::string &Name) {
     std::string MangledName;
     {
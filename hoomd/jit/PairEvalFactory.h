@@ -0,0 +1,41 @@
+#pragma once
+
+// do not include python headers
+#define HOOMD_LLVMJIT_BUILD
+#include "hoomd/HOOMDMath.h"
+
+#include "KaleidoscopeJIT.h"
+
+class PairEvalFactory
+    {
+    public:
+        typedef Scalar (*PairEvalFnPtr)(Scalar rsq,
+            const Scalar *param,
+            Scalar d_i,
+            Scalar d_j,
+            Scalar q_i,
+            Scalar q_j,
+            Scalar& force_divr
+            );
+
+        //! Constructor
+        PairEvalFactory(const std::string& llvm_ir);
+
+        //! Return the evaluator
+        PairEvalFnPtr getEval()
+            {
+            return m_eval;
+            }
+
+        //! Get the error message from initialization
+        const std::string& getError()
+            {
+            return m_error_msg;
+            }
+
+    private:
+        std::unique_ptr<llvm::orc::KaleidoscopeJIT> m_jit; //!< The persistent JIT engine
+        PairEvalFnPtr m_eval;                  //!< Function pointer to evaluator
+
+        std::string m_error_msg; //!< The error message if initialization fails
+    };
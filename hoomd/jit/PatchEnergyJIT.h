@@ -77,6 +77,29 @@ class PYBIND11_EXPORT PatchEnergyJIT : public hpmc::PatchEnergy
             return m_eval(r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j);
             }
 
+        //! evaluate the energies of a block of pairs that share particle i
+        /*! Calls the eval_batch function of the JIT module, which loops over the pairs inside the module so that LLVM
+            can inline and vectorize the user code. Falls back on one call per pair when the module does not define
+            eval_batch.
+        */
+        virtual void energyBatch(unsigned int n,
+            const vec3<float> *r_ij,
+            unsigned int type_i,
+            const quat<float>& q_i,
+            float d_i,
+            float charge_i,
+            const unsigned int *type_j,
+            const quat<float> *q_j,
+            const float *d_j,
+            const float *charge_j,
+            float *energy)
+            {
+            if (m_eval_batch)
+                m_eval_batch(n, r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j, energy);
+            else
+                hpmc::PatchEnergy::energyBatch(n, r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j, energy);
+            }
+
         static pybind11::object getAlphaNP(pybind11::object self)
             {
             auto self_cpp = self.cast<PatchEnergyJIT *>();
@@ -90,6 +113,7 @@ class PYBIND11_EXPORT PatchEnergyJIT : public hpmc::PatchEnergy
         Scalar m_r_cut;                             //!< Cutoff radius
         std::shared_ptr<EvalFactory> m_factory;       //!< The factory for the evaluator function
         EvalFactory::EvalFnPtr m_eval;                //!< Pointer to evaluator function inside the JIT module
+        EvalFactory::EvalBatchFnPtr m_eval_batch;     //!< Pointer to batched evaluator function inside the JIT module
         unsigned int m_alpha_size;                  //!< Size of array
         std::vector<float, managed_allocator<float> > m_alpha; //!< Array containing adjustable parameters
     };
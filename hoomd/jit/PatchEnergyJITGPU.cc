@@ -96,7 +96,7 @@ void PatchEnergyJITGPU::computePatchEnergyGPU(const gpu_args_t& args, hipStream_
             args.d_diameter,
             args.d_excell_idx,
             args.d_excell_size,
-            args.excli,
+            args.d_excell_offsets,
             args.d_update_order_by_ptl,
             args.d_reject_in,
             args.d_reject_out,
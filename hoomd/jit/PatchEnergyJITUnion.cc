@@ -90,16 +90,27 @@ void PatchEnergyJITUnion::setParam(unsigned int type,
     m_tree[type] = hpmc::detail::GPUTree(tree,false);
     }
 
-float PatchEnergyJITUnion::compute_leaf_leaf_energy(vec3<float> dr,
+/*! \param q_ba Orientation of particle a in the body frame of particle b
+    \param r_ab Position of particle b relative to particle a, in the body frame of particle b
+    \param type_a Type of particle a
+    \param type_b Type of particle b
+    \param cur_node_a Leaf node of the tree of particle a
+    \param cur_node_b Leaf node of the tree of particle b
+
+    Each constituent of a is transformed once, and skips the leaf of b altogether when the leaf's bounding box
+    is farther away than the largest cutoff of the constituent.
+*/
+float PatchEnergyJITUnion::compute_leaf_leaf_energy(const quat<float>& q_ba,
+                             const vec3<float>& r_ab,
                              unsigned int type_a,
                              unsigned int type_b,
-                             const quat<float>& orientation_a,
-                             const quat<float>& orientation_b,
                              unsigned int cur_node_a,
                              unsigned int cur_node_b)
     {
     float energy = 0.0;
-    vec3<float> r_ab = rotate(conj(quat<float>(orientation_b)),vec3<float>(dr));
+
+    // the leaf OBB bounds the constituent spheres of b
+    const hpmc::detail::OBB obb_b = m_tree[type_b].getOBB(cur_node_b);
 
     // loop through leaf particles of cur_node_a
     unsigned int na = m_tree[type_a].getNumParticles(cur_node_a);
@@ -108,10 +119,15 @@ float PatchEnergyJITUnion::compute_leaf_leaf_energy(vec3<float> dr,
     for (unsigned int i= 0; i < na; i++)
         {
         unsigned int ileaf = m_tree[type_a].getParticleByNode(cur_node_a, i);
+        vec3<float> pos_i(rotate(q_ba,m_position[type_a][ileaf])-r_ab);
+
+        // prune the constituent against the whole leaf of b
+        float rcut_i = float(m_rcut_union+0.5*m_diameter[type_a][ileaf]);
+        if (!hpmc::detail::SqDistPointOBBSmallerThan(vec3<OverlapReal>(pos_i), obb_b, OverlapReal(rcut_i*rcut_i)))
+            continue;
 
         unsigned int type_i = m_type[type_a][ileaf];
-        quat<float> orientation_i = conj(quat<float>(orientation_b))*quat<float>(orientation_a) * m_orientation[type_a][ileaf];
-        vec3<float> pos_i(rotate(conj(quat<float>(orientation_b))*quat<float>(orientation_a),m_position[type_a][ileaf])-r_ab);
+        quat<float> orientation_i = q_ba * m_orientation[type_a][ileaf];
 
         // loop through leaf particles of cur_node_b
         for (unsigned int j= 0; j < nb; j++)
@@ -164,6 +180,10 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
 
     if (tree_a.getNumLeaves() <= tree_b.getNumLeaves())
         {
+        // frame of b, shared by all leaf pairs
+        const quat<float> q_ba = conj(q_j)*q_i;
+        const vec3<float> r_ab = rotate(conj(q_j),r_ij);
+
         #ifdef ENABLE_TBB
         energy += tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, tree_a.getNumLeaves()),
             0.0f,
@@ -182,14 +202,14 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
             obb_a.lengths.z += float(m_rcut_union);
 
             // rotate and translate a's obb into b's body frame
-            obb_a.affineTransform(conj(q_j)*q_i, rotate(conj(q_j),-r_ij));
+            obb_a.affineTransform(q_ba, -r_ab);
 
             unsigned cur_node_b = 0;
             while (cur_node_b < tree_b.getNumNodes())
                 {
                 unsigned int query_node = cur_node_b;
                 if (tree_b.queryNode(obb_a, cur_node_b))
-                    energy += compute_leaf_leaf_energy(r_ij, type_i, type_j, q_i, q_j, cur_node_a, query_node);
+                    energy += compute_leaf_leaf_energy(q_ba, r_ab, type_i, type_j, cur_node_a, query_node);
                 }
             }
         #ifdef ENABLE_TBB
@@ -199,6 +219,10 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
         }
     else
         {
+        // frame of a, shared by all leaf pairs
+        const quat<float> q_ab = conj(q_i)*q_j;
+        const vec3<float> r_ba = rotate(conj(q_i),-r_ij);
+
         #ifdef ENABLE_TBB
         energy += tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, tree_b.getNumLeaves()),
             0.0f,
@@ -217,14 +241,14 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
             obb_b.lengths.z += float(m_rcut_union);
 
             // rotate and translate b's obb into a's body frame
-            obb_b.affineTransform(conj(q_i)*q_j, rotate(conj(q_i),r_ij));
+            obb_b.affineTransform(q_ab, -r_ba);
 
             unsigned cur_node_a = 0;
             while (cur_node_a < tree_a.getNumNodes())
                 {
                 unsigned int query_node = cur_node_a;
                 if (tree_a.queryNode(obb_b, cur_node_a))
-                    energy += compute_leaf_leaf_energy(-r_ij, type_j, type_i, q_j, q_i, cur_node_b, query_node);
+                    energy += compute_leaf_leaf_energy(q_ab, r_ba, type_j, type_i, cur_node_b, query_node);
                 }
             }
         #ifdef ENABLE_TBB
@@ -114,6 +114,24 @@ class PatchEnergyJITUnion : public PatchEnergyJIT
             float d_j,
             float charge_j);
 
+        //! evaluate the energies of a block of pairs that share particle i
+        /*! The union energy is not evaluated by a single JIT function, so call energy() for every pair.
+        */
+        virtual void energyBatch(unsigned int n,
+            const vec3<float> *r_ij,
+            unsigned int type_i,
+            const quat<float>& q_i,
+            float d_i,
+            float charge_i,
+            const unsigned int *type_j,
+            const quat<float> *q_j,
+            const float *d_j,
+            const float *charge_j,
+            float *energy)
+            {
+            hpmc::PatchEnergy::energyBatch(n, r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j, energy);
+            }
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -144,11 +162,10 @@ class PatchEnergyJITUnion : public PatchEnergyJIT
         std::vector< std::vector<unsigned int> > m_type;          // The type identifiers of the constituent particles
 
         //! Compute the energy of two overlapping leaf nodes
-        float compute_leaf_leaf_energy(vec3<float> dr,
+        float compute_leaf_leaf_energy(const quat<float>& q_ba,
+                                     const vec3<float>& r_ab,
                                      unsigned int type_a,
                                      unsigned int type_b,
-                                     const quat<float>& orientation_a,
-                                     const quat<float>& orientation_b,
                                      unsigned int cur_node_a,
                                      unsigned int cur_node_b);
 
@@ -0,0 +1,56 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "PotentialPairJIT.h"
+
+/*! \file PotentialPairJIT.cc
+    \brief Defines the pair potential compiled at run time
+*/
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighborlist to use for computing the forces
+    \param llvm_ir Contents of the LLVM IR to load
+
+    After construction, the LLVM IR is loaded, compiled, and forces are computed for all type pairs with parameters.
+*/
+PotentialPairJIT::PotentialPairJIT(std::shared_ptr<SystemDefinition> sysdef,
+                                   std::shared_ptr<NeighborList> nlist,
+                                   const std::string& llvm_ir)
+    : PotentialPair<EvaluatorPairJIT>(sysdef, nlist)
+    {
+    // build the JIT.
+    m_factory = std::shared_ptr<PairEvalFactory>(new PairEvalFactory(llvm_ir));
+
+    // get the evaluator
+    m_eval = m_factory->getEval();
+
+    if (!m_eval)
+        {
+        m_exec_conf->msg->error() << m_factory->getError() << std::endl;
+        throw std::runtime_error("Error compiling JIT code.");
+        }
+    }
+
+/*! \param typ1 First type index in the pair
+    \param typ2 Second type index in the pair
+    \param param Parameter to set
+
+    The compiled function is attached to the parameters before they are stored.
+*/
+void PotentialPairJIT::setParams(unsigned int typ1, unsigned int typ2, const param_type& param)
+    {
+    param_type param_jit = param;
+    param_jit.eval = m_eval;
+    PotentialPair<EvaluatorPairJIT>::setParams(typ1, typ2, param_jit);
+    }
+
+void export_PotentialPairJIT(pybind11::module &m)
+    {
+    export_PotentialPair< PotentialPair<EvaluatorPairJIT> >(m, "PotentialPairJITBase");
+    pybind11::class_<PotentialPairJIT, PotentialPair<EvaluatorPairJIT>, std::shared_ptr<PotentialPairJIT> >(m,
+        "PotentialPairJIT")
+            .def(pybind11::init< std::shared_ptr<SystemDefinition>,
+                                 std::shared_ptr<NeighborList>,
+                                 const std::string& >())
+            ;
+    }
@@ -0,0 +1,48 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _POTENTIAL_PAIR_JIT_H_
+#define _POTENTIAL_PAIR_JIT_H_
+
+#include "hoomd/md/PotentialPair.h"
+
+#include "EvaluatorPairJIT.h"
+#include "PairEvalFactory.h"
+
+/*! \file PotentialPairJIT.h
+    \brief Declares the pair potential compiled at run time
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Pair potential with a user supplied energy and force compiled at run time
+/*! The user provides LLVM IR code containing a function 'eval' with the signature documented in EvaluatorPairJIT. On
+    construction, this class compiles the IR to machine code with LLVM and hands the function pointer to the
+    evaluator through the per type pair parameters. Everything else (cutoffs, shift modes, exclusions, logging,
+    MPI) is inherited from PotentialPair.
+*/
+class PYBIND11_EXPORT PotentialPairJIT : public PotentialPair<EvaluatorPairJIT>
+    {
+    public:
+        //! Constructor
+        PotentialPairJIT(std::shared_ptr<SystemDefinition> sysdef,
+                         std::shared_ptr<NeighborList> nlist,
+                         const std::string& llvm_ir);
+
+        //! Destructor
+        virtual ~PotentialPairJIT() {}
+
+        //! Set the pair parameters for a single type pair
+        virtual void setParams(unsigned int typ1, unsigned int typ2, const param_type& param);
+
+    protected:
+        std::shared_ptr<PairEvalFactory> m_factory;       //!< The factory for the evaluator function
+        PairEvalFactory::PairEvalFnPtr m_eval;            //!< Pointer to evaluator function inside the JIT module
+    };
+
+//! Exports the PotentialPairJIT class to python
+void export_PotentialPairJIT(pybind11::module &m);
+
+#endif // _POTENTIAL_PAIR_JIT_H_
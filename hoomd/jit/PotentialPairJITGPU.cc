@@ -0,0 +1,155 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifdef ENABLE_HIP
+
+#include "PotentialPairJITGPU.h"
+
+/*! \file PotentialPairJITGPU.cc
+    \brief Defines the pair potential compiled at run time, GPU version
+*/
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighborlist to use for computing the forces
+    \param llvm_ir Contents of the LLVM IR to load for the CPU evaluator
+    \param code CUDA source of the kernel, including the user function
+    \param kernel_name Name of the kernel to instantiate
+    \param options Options passed to NVRTC
+    \param cuda_devrt_library_path Path to the CUDA device runtime library
+    \param compute_arch Compute architecture to compile for
+*/
+PotentialPairJITGPU::PotentialPairJITGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                         std::shared_ptr<NeighborList> nlist,
+                                         const std::string& llvm_ir,
+                                         const std::string& code,
+                                         const std::string& kernel_name,
+                                         const std::vector<std::string>& options,
+                                         const std::string& cuda_devrt_library_path,
+                                         unsigned int compute_arch)
+    : PotentialPairJIT(sysdef, nlist, llvm_ir),
+      m_gpu_factory(m_exec_conf, code, kernel_name, options, cuda_devrt_library_path, compute_arch)
+    {
+    // can't run on the GPU if there aren't any GPUs in the execution configuration
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a PotentialPairJITGPU with no GPU in the execution configuration"
+                  << std::endl;
+        throw std::runtime_error("Error initializing PotentialPairJITGPU");
+        }
+
+    m_tuner.reset(new Autotuner(m_gpu_factory.getLaunchBounds(), 5, 100000, "pair_jit", m_exec_conf));
+    #ifdef ENABLE_MPI
+    // synchronize autotuner results across ranks
+    m_tuner->setSync(bool(m_pdata->getDomainDecomposition()));
+    #endif
+    }
+
+//! Kernel driver for kernel::gpu_compute_pair_forces_jit
+void PotentialPairJITGPU::computeForces(uint64_t timestep)
+    {
+    m_nlist->compute(timestep);
+
+    // start the profile
+    if (m_prof) m_prof->push(m_exec_conf, m_prof_name);
+
+    // The GPU implementation CANNOT handle a half neighborlist, error out now
+    if (m_nlist->getStorageMode() == NeighborList::half)
+        {
+        m_exec_conf->msg->error() << "PotentialPairJITGPU cannot handle a half neighborlist" << std::endl;
+        throw std::runtime_error("Error computing forces in PotentialPairJITGPU");
+        }
+
+    #ifdef __HIP_PLATFORM_NVCC__
+    // access the neighbor list
+    ArrayHandle<unsigned int> d_n_neigh(m_nlist->getConsumerNNeighArray(m_r_cut_nlist),
+                                        access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_nlist(m_nlist->getNListArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_head_list(m_nlist->getHeadList(), access_location::device, access_mode::read);
+
+    // access the particle data
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_charge(m_pdata->getCharges(), access_location::device, access_mode::read);
+
+    // access parameters
+    ArrayHandle<Scalar> d_ronsq(m_ronsq, access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_rcutsq(m_rcutsq, access_location::device, access_mode::read);
+    ArrayHandle<param_type> d_params(m_params, access_location::device, access_mode::read);
+
+    ArrayHandle<Scalar4> d_force(m_force, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar> d_virial(m_virial, access_location::device, access_mode::overwrite);
+
+    BoxDim box = m_pdata->getBox();
+    PDataFlags flags = m_pdata->getFlags();
+
+    m_exec_conf->beginMultiGPU();
+    m_tuner->begin();
+    unsigned int block_size = m_tuner->getParam();
+
+    // the kernel has no dynamic shared memory, only clamp to the register limit
+    unsigned int run_block_size = std::min(block_size, m_gpu_factory.getKernelMaxThreads(0, 1, block_size)); // fixme GPU 0
+
+    auto& gpu_partition = m_pdata->getGPUPartition();
+
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+
+        unsigned int nwork = range.second - range.first;
+        dim3 grid(nwork/run_block_size + 1, 1, 1);
+        dim3 threads(run_block_size, 1, 1);
+
+        auto launcher = m_gpu_factory.configureKernel(idev, grid, threads, 0, m_stream, 1, block_size);
+
+        CUresult res = launcher(d_force.data,
+            d_virial.data,
+            m_virial.getPitch(),
+            d_pos.data,
+            d_diameter.data,
+            d_charge.data,
+            box,
+            d_n_neigh.data,
+            d_nlist.data,
+            d_head_list.data,
+            d_params.data,
+            d_rcutsq.data,
+            d_ronsq.data,
+            m_typpair_idx,
+            (unsigned int) m_shift_mode,
+            (unsigned int) flags[pdata_flag::pressure_tensor],
+            range.first,
+            nwork);
+
+        if (res != CUDA_SUCCESS)
+            {
+            char *error;
+            cuGetErrorString(res, const_cast<const char **>(&error));
+            throw std::runtime_error("Error launching NVRTC kernel: "+std::string(error));
+            }
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    m_tuner->end();
+    m_exec_conf->endMultiGPU();
+    #endif
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+void export_PotentialPairJITGPU(pybind11::module &m)
+    {
+    pybind11::class_<PotentialPairJITGPU, PotentialPairJIT, std::shared_ptr<PotentialPairJITGPU> >(m,
+        "PotentialPairJITGPU")
+            .def(pybind11::init< std::shared_ptr<SystemDefinition>,
+                                 std::shared_ptr<NeighborList>,
+                                 const std::string&,
+                                 const std::string&,
+                                 const std::string&,
+                                 const std::vector<std::string>&,
+                                 const std::string&,
+                                 unsigned int >())
+            ;
+    }
+
+#endif
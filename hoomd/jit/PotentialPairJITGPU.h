@@ -0,0 +1,67 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _POTENTIAL_PAIR_JIT_GPU_H_
+#define _POTENTIAL_PAIR_JIT_GPU_H_
+
+#ifdef ENABLE_HIP
+
+#include "PotentialPairJIT.h"
+#include "GPUEvalFactory.h"
+#include <pybind11/stl.h>
+
+#include <vector>
+
+#include "hoomd/Autotuner.h"
+
+/*! \file PotentialPairJITGPU.h
+    \brief Declares the pair potential compiled at run time, GPU version
+*/
+
+//! Pair potential with a user supplied energy and force compiled at run time, GPU version
+/*! Forces are computed by a kernel that NVRTC compiles from the same user code (PotentialPairJITGPU.inc). The LLVM
+    compiled evaluator of PotentialPairJIT remains in use for the methods that run on the CPU, such as
+    computeEnergyBetweenSets().
+*/
+class PYBIND11_EXPORT PotentialPairJITGPU : public PotentialPairJIT
+    {
+    public:
+        //! Constructor
+        PotentialPairJITGPU(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<NeighborList> nlist,
+                            const std::string& llvm_ir,
+                            const std::string& code,
+                            const std::string& kernel_name,
+                            const std::vector<std::string>& options,
+                            const std::string& cuda_devrt_library_path,
+                            unsigned int compute_arch);
+
+        //! Destructor
+        virtual ~PotentialPairJITGPU() {}
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            PotentialPairJIT::setAutotunerParams(enable, period);
+            m_tuner->setPeriod(period);
+            m_tuner->setEnabled(enable);
+            }
+
+    protected:
+        std::unique_ptr<Autotuner> m_tuner;     //!< Autotuner for the block size
+
+        //! Actually compute the forces
+        virtual void computeForces(uint64_t timestep);
+
+    private:
+        GPUEvalFactory m_gpu_factory;           //!< JIT implementation
+    };
+
+//! Exports the PotentialPairJITGPU class to python
+void export_PotentialPairJITGPU(pybind11::module &m);
+
+#endif
+#endif // _POTENTIAL_PAIR_JIT_GPU_H_
@@ -0,0 +1,127 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+""" Compilation cache for JIT code
+
+Rank 0 compiles the user code to LLVM IR and broadcasts the IR to all other ranks, so the compiler runs once per job
+instead of once per rank. Set the environment variable ``HOOMD_JIT_CACHE_DIR`` to a directory to also keep the IR
+between jobs. Entries are named by a hash of the code, the compiler command, the compiler version and the HOOMD
+version, so changing any of them compiles the code again.
+
+Patch energies are compiled with ``-march=native`` on rank 0, so all ranks must run on the same CPU model. Entries in a
+shared cache directory are only reused by jobs that run on the same CPU model, because the CPU name is part of the hash.
+
+The GPU code of the JIT evaluators is compiled by NVRTC on every rank and is not cached.
+"""
+
+import hoomd
+from hoomd import _hoomd
+
+import hashlib
+import os
+import platform
+import subprocess
+import tempfile
+
+
+def _host_cpu():
+    """Identify the host CPU model for the cache key."""
+    try:
+        with open('/proc/cpuinfo', 'r') as f:
+            for line in f:
+                if line.startswith('model name'):
+                    return line.split(':', 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor()
+
+
+def _compiler_version(clang):
+    """Get the version string of the compiler for the cache key."""
+    p = subprocess.Popen([clang, '--version'], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    output = p.communicate()
+    return output[0].decode()
+
+
+def _compile(cmd, cpp_function):
+    """Run the compiler, return the IR or raise RuntimeError with the compiler output."""
+    p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
+
+    # pass C++ function to stdin
+    output = p.communicate(cpp_function.encode('utf-8'))
+
+    if p.returncode != 0:
+        raise RuntimeError("Command "+' '.join(cmd)+"\n"+output[1].decode()+"\n")
+
+    return output[0].decode()
+
+
+def _lookup_or_compile(cmd, cpp_function, cache_dir, msg):
+    """Return the IR from the cache directory, compiling and storing it on a miss."""
+    key = hashlib.sha256()
+    for part in [cpp_function, ' '.join(cmd), _compiler_version(cmd[0]), hoomd.version.version, _host_cpu()]:
+        key.update(part.encode('utf-8'))
+        key.update(b'\0')
+    fn = os.path.join(cache_dir, key.hexdigest() + '.ll')
+
+    try:
+        with open(fn, 'r') as f:
+            return f.read()
+    except OSError:
+        pass
+
+    llvm_ir = _compile(cmd, cpp_function)
+
+    # write to a temporary file first, so that concurrent jobs never read partial entries
+    try:
+        os.makedirs(cache_dir, exist_ok=True)
+        fd, tmp = tempfile.mkstemp(dir=cache_dir, suffix='.tmp')
+        with os.fdopen(fd, 'w') as f:
+            f.write(llvm_ir)
+        os.replace(tmp, fn)
+    except OSError as e:
+        msg.warning("Cannot write JIT cache entry " + fn + ": " + str(e) + "\n")
+
+    return llvm_ir
+
+
+def compile_llvm_ir(cmd, cpp_function, device=None):
+    """Compile C++ code to LLVM IR once for all ranks.
+
+    Args:
+        cmd (list[str]): Compiler command that reads the code from stdin and writes the IR to stdout.
+        cpp_function (str): C++ code to compile.
+        device (`hoomd.device.Device`): Device of the simulation, defaults to the device of the current context.
+
+    Returns:
+        str: The LLVM IR.
+
+    Raises ``RuntimeError`` on all ranks when the code does not compile.
+    """
+    if device is None:
+        exec_conf = hoomd.context.current.device.cpp_exec_conf
+        msg = hoomd.context.current.device.cpp_msg
+    else:
+        exec_conf = device._cpp_exec_conf
+        msg = device._cpp_msg
+    cache_dir = os.environ.get('HOOMD_JIT_CACHE_DIR')
+
+    llvm_ir = ''
+    error = ''
+    if exec_conf.getRank() == 0:
+        try:
+            if cache_dir:
+                llvm_ir = _lookup_or_compile(cmd, cpp_function, cache_dir, msg)
+            else:
+                llvm_ir = _compile(cmd, cpp_function)
+        except RuntimeError as e:
+            error = str(e)
+
+    # all ranks need to know about the error, otherwise they would wait for the IR
+    error = _hoomd.mpi_bcast_str(error, exec_conf)
+    if error:
+        msg.error("Error compiling provided code\n");
+        msg.error(error);
+        raise RuntimeError("Error compiling provided code")
+
+    return _hoomd.mpi_bcast_str(llvm_ir, exec_conf)
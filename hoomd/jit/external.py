@@ -3,6 +3,7 @@
 
 from hoomd import _hoomd
 from hoomd.jit import _jit
+from hoomd.jit import cache
 from hoomd.hpmc import field
 from hoomd.hpmc import integrate
 import hoomd
@@ -59,6 +60,10 @@ class user(field._external):
     * *charge* the particle charge.
     * Your code *must* return a value.
 
+    On the GPU, *code* is also compiled with NVRTC into a kernel that accepts or rejects the trial moves inside
+    the HPMC update. The LLVM compiled version still computes the energy of the whole system, e.g. for box moves
+    and logging. *llvm_ir_file* alone is not sufficient on the GPU.
+
     Once initialized, the following log quantities are provided to analyze.log:
 
     * **external_field_jit** -- total energy of the field
@@ -89,39 +94,33 @@ class user(field._external):
     def __init__(self, mc, code=None, llvm_ir_file=None, clang_exec=None):
         super(user, self).__init__()
 
-        # raise an error if this run is on the GPU
-        cls = None;
-        if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
-            hoomd.context.current.device.cpp_msg.error("JIT forces are not supported on the GPU\n");
-            raise RuntimeError("Error initializing force energy");
+        if isinstance(mc, integrate.sphere):
+            shape_name = 'Sphere'
+        elif isinstance(mc, integrate.convex_polygon):
+            shape_name = 'ConvexPolygon'
+        elif isinstance(mc, integrate.simple_polygon):
+            shape_name = 'SimplePolygon'
+        elif isinstance(mc, integrate.convex_polyhedron):
+            shape_name = 'ConvexPolyhedron'
+        elif isinstance(mc, integrate.convex_spheropolyhedron):
+            shape_name = 'Spheropolyhedron'
+        elif isinstance(mc, integrate.ellipsoid):
+            shape_name = 'Ellipsoid'
+        elif isinstance(mc, integrate.convex_spheropolygon):
+            shape_name = 'Spheropolygon'
+        elif isinstance(mc, integrate.faceted_ellipsoid):
+            shape_name = 'FacetedEllipsoid'
+        elif isinstance(mc, integrate.polyhedron):
+            shape_name = 'Polyhedron'
+        elif isinstance(mc, integrate.sphinx):
+            shape_name = 'Sphinx'
+        elif isinstance(mc, integrate.sphere_union):
+            shape_name = 'SphereUnion'
+        elif isinstance(mc, integrate.convex_spheropolyhedron_union):
+            shape_name = 'ConvexPolyhedronUnion'
         else:
-            if isinstance(mc, integrate.sphere):
-                cls = _jit.ExternalFieldJITSphere;
-            elif isinstance(mc, integrate.convex_polygon):
-                cls = _jit.ExternalFieldJITConvexPolygon;
-            elif isinstance(mc, integrate.simple_polygon):
-                cls = _jit.ExternalFieldJITSimplePolygon;
-            elif isinstance(mc, integrate.convex_polyhedron):
-                cls = _jit.ExternalFieldJITConvexPolyhedron;
-            elif isinstance(mc, integrate.convex_spheropolyhedron):
-                cls = _jit.ExternalFieldJITSpheropolyhedron;
-            elif isinstance(mc, integrate.ellipsoid):
-                cls = _jit.ExternalFieldJITEllipsoid;
-            elif isinstance(mc, integrate.convex_spheropolygon):
-                cls =_jit.ExternalFieldJITSpheropolygon;
-            elif isinstance(mc, integrate.faceted_ellipsoid):
-                cls =_jit.ExternalFieldJITFacetedEllipsoid;
-            elif isinstance(mc, integrate.polyhedron):
-                cls =_jit.ExternalFieldJITPolyhedron;
-            elif isinstance(mc, integrate.sphinx):
-                cls =_jit.ExternalFieldJITSphinx;
-            elif isinstance(mc, integrate.sphere_union):
-                cls = _jit.ExternalFieldJITSphereUnion;
-            elif isinstance(mc, integrate.convex_spheropolyhedron_union):
-                cls = _jit.ExternalFieldJITConvexPolyhedronUnion;
-            else:
-                hoomd.context.current.device.cpp_msg.error("jit.field.user: Unsupported integrator.\n");
-                raise RuntimeError("Error initializing compute.position_lattice_field");
+            hoomd.context.current.device.cpp_msg.error("jit.field.user: Unsupported integrator.\n");
+            raise RuntimeError("Error initializing compute.position_lattice_field");
 
         # Find a clang executable if none is provided
         if clang_exec is not None:
@@ -137,8 +136,35 @@ class user(field._external):
                 llvm_ir = f.read()
 
         self.compute_name = "external_field_jit"
-        self.cpp_compute = cls(hoomd.context.current.system_definition,
-            hoomd.context.current.device.cpp_exec_conf, llvm_ir);
+        if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+            if code is None:
+                hoomd.context.current.device.cpp_msg.error("jit.external.user: code is required on the GPU\n");
+                raise RuntimeError("Error initializing external field.");
+
+            include_path_hoomd = os.path.dirname(hoomd.__file__) + '/include';
+            include_path_source = hoomd._hoomd.__hoomd_source_dir__
+            include_path_cuda = _jit.__cuda_include_path__
+            options = ["-I"+include_path_hoomd, "-I"+include_path_source, "-I"+include_path_cuda]
+            cuda_devrt_library_path = _jit.__cuda_devrt_library_path__
+
+            # select maximum supported compute capability out of those we compile for
+            compute_archs = _jit.__cuda_compute_archs__;
+            compute_capability = hoomd.context.current.device.cpp_exec_conf.getComputeCapability(0) # GPU 0
+            compute_major, compute_minor = compute_capability.split('.')
+            max_arch = 0
+            for a in compute_archs.split('_'):
+                if int(a) < int(compute_major)*10+int(compute_major):
+                    max_arch = int(a)
+
+            cls = getattr(_jit, 'ExternalFieldJITGPU' + shape_name)
+            gpu_code = self.wrap_gpu_code(code)
+            self.cpp_compute = cls(hoomd.context.current.system_definition,
+                hoomd.context.current.device.cpp_exec_conf, llvm_ir,
+                gpu_code, "hpmc::gpu::kernel::hpmc_external_field_jit", options, cuda_devrt_library_path, max_arch);
+        else:
+            cls = getattr(_jit, 'ExternalFieldJIT' + shape_name)
+            self.cpp_compute = cls(hoomd.context.current.system_definition,
+                hoomd.context.current.device.cpp_exec_conf, llvm_ir);
         hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name)
 
         self.mc = mc
@@ -191,6 +217,10 @@ Scalar charge
             cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_patsource, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
         else:
             cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_patsource, '-S', '-emit-llvm','-x','c++', '-o','-','-']
+        if fn is None:
+            # compile once on rank 0 and reuse the IR from the on-disk cache when enabled
+            return cache.compile_llvm_ir(cmd, cpp_function)
+
         p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
 
         # pass C++ function to stdin
@@ -204,3 +234,34 @@ Scalar charge
             raise RuntimeError("Error initializing force.");
 
         return llvm_ir
+
+    def wrap_gpu_code(self, code):
+        R'''Helper function to compile the provided code into a device function
+
+        Args:
+            code (str): C++ code to compile
+
+        .. versionadded:: 3.0
+        '''
+
+        cpp_function = """
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/hpmc/IntegratorHPMCMonoGPUExternalJIT.inc"
+
+__device__ inline float eval(const BoxDim& box,
+    unsigned int type_i,
+    const vec3<Scalar>& r_i,
+    const quat<Scalar>& q_i,
+    Scalar diameter,
+    Scalar charge)
+    {
+"""
+        cpp_function += code
+        cpp_function += """
+    }
+"""
+
+        # Compile on C++ side
+        return cpp_function
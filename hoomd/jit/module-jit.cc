@@ -8,6 +8,7 @@
 //#include "hoomd/hpmc/IntegratorHPMCMono.h"
 //#include "hoomd/hpmc/IntegratorHPMCMonoImplicit.h"
 #include "ExternalFieldJIT.h"
+#include "PotentialPairJIT.h"
 //#include "ExternalFieldJIT.cc"
 
 #include "hoomd/hpmc/ShapeSphere.h"
@@ -26,6 +27,8 @@
 #ifdef ENABLE_HIP
 #include "PatchEnergyJITGPU.h"
 #include "PatchEnergyJITUnionGPU.h"
+#include "ExternalFieldJITGPU.h"
+#include "PotentialPairJITGPU.h"
 #endif
 
 #include <pybind11/pybind11.h>
@@ -54,6 +57,8 @@ PYBIND11_MODULE(_jit, m)
     export_ExternalFieldJIT<ShapeFacetedEllipsoid>(m, "ExternalFieldJITFacetedEllipsoid");
     export_ExternalFieldJIT<ShapeSphinx>(m, "ExternalFieldJITSphinx");
 
+    export_PotentialPairJIT(m);
+
     #if defined(ENABLE_HIP) && defined(__HIP_PLATFORM_NVCC__)
     m.attr("__cuda_devrt_library_path__") = std::string(CUDA_DEVRT_LIBRARY_PATH);
     m.attr("__cuda_include_path__") = std::string(CUDA_INCLUDE_PATH);
@@ -61,5 +66,18 @@ PYBIND11_MODULE(_jit, m)
 
     export_PatchEnergyJITGPU(m);
     export_PatchEnergyJITUnionGPU(m);
+
+    export_ExternalFieldJITGPU<ShapeSphere>(m, "ExternalFieldJITGPUSphere");
+    export_ExternalFieldJITGPU<ShapeConvexPolygon>(m, "ExternalFieldJITGPUConvexPolygon");
+    export_ExternalFieldJITGPU<ShapePolyhedron>(m, "ExternalFieldJITGPUPolyhedron");
+    export_ExternalFieldJITGPU<ShapeConvexPolyhedron>(m, "ExternalFieldJITGPUConvexPolyhedron");
+    export_ExternalFieldJITGPU<ShapeSpheropolyhedron>(m, "ExternalFieldJITGPUSpheropolyhedron");
+    export_ExternalFieldJITGPU<ShapeSpheropolygon>(m, "ExternalFieldJITGPUSpheropolygon");
+    export_ExternalFieldJITGPU<ShapeSimplePolygon>(m, "ExternalFieldJITGPUSimplePolygon");
+    export_ExternalFieldJITGPU<ShapeEllipsoid>(m, "ExternalFieldJITGPUEllipsoid");
+    export_ExternalFieldJITGPU<ShapeFacetedEllipsoid>(m, "ExternalFieldJITGPUFacetedEllipsoid");
+    export_ExternalFieldJITGPU<ShapeSphinx>(m, "ExternalFieldJITGPUSphinx");
+
+    export_PotentialPairJITGPU(m);
     #endif
     }
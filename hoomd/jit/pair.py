@@ -0,0 +1,176 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+"""JIT compiled pair potentials for MD."""
+
+from hoomd.jit import _jit
+from hoomd.jit import cache
+from hoomd.md.pair.pair import Pair
+from hoomd.data.parameterdicts import TypeParameterDict
+from hoomd.data.typeparam import TypeParameter
+import hoomd
+
+import os
+
+
+class User(Pair):
+    R""" Pair potential with a user supplied energy and force.
+
+    Args:
+        nlist (`hoomd.md.nlist.NList`): Neighbor list
+        code (str): C++ code to compile
+        r_cut (float): Default cutoff radius (in distance units).
+        r_on (float): Default turn-on radius (in distance units).
+        mode (str): energy shifting/smoothing mode
+        clang_exec (str): The Clang executable to use
+
+    `User` computes a pair potential from C++ code that is compiled at run
+    time. The code is the body of a function with the following signature:
+
+    .. code::
+
+        Scalar eval(Scalar rsq,
+                    const Scalar *param,
+                    Scalar d_i,
+                    Scalar d_j,
+                    Scalar q_i,
+                    Scalar q_j,
+                    Scalar& force_divr)
+
+    * *rsq* is the squared distance between the particles.
+    * *param* points to the parameters of the type pair.
+    * *d_i* and *d_j* are the particle diameters.
+    * *q_i* and *q_j* are the particle charges.
+    * Your code *must* return the pair energy and set *force_divr* to
+      :math:`-\frac{1}{r} \frac{\partial V}{\partial r}`.
+
+    The cutoff, the energy shifting and smoothing modes, exclusions and
+    logging behave exactly as for the built-in potentials, see `Pair`.
+    Compilation assumes that a recent ``clang`` installation is on your PATH.
+    On the GPU, *code* is also compiled with NVRTC into the force kernel.
+    Type pairs without ``params`` do not interact.
+
+    Attributes:
+        params (`TypeParameter` [\
+            `tuple` [``particle_type``, ``particle_type``],\
+            `dict`]):
+            The potential parameters. The dictionary has the following keys:
+
+            * ``params`` (`list` [`float`], **required**) -
+              values passed to the code in *param* (at most 16)
+
+    Example::
+
+        nl = nlist.Cell()
+        lj = '''Scalar r2inv = Scalar(1.0) / rsq;
+                Scalar r6inv = r2inv * r2inv * r2inv;
+                force_divr = r2inv * r6inv * (Scalar(12.0) * param[0] * r6inv
+                                              - Scalar(6.0) * param[1]);
+                return r6inv * (param[0] * r6inv - param[1]);'''
+        user = hoomd.jit.pair.User(nl, code=lj, r_cut=3.0)
+        user.params[('A', 'A')] = dict(params=[4.0, 4.0])
+
+    .. versionadded:: 3.0
+    """
+    _cpp_class_name = "PotentialPairJIT"
+    _half_list_gpu = False
+
+    def __init__(self, nlist, code, r_cut=None, r_on=0., mode='none',
+                 clang_exec=None):
+        super().__init__(nlist, r_cut, r_on, mode)
+        params = TypeParameter('params', 'particle_types',
+                               TypeParameterDict(params=[float], len_keys=2))
+        self._add_typeparam(params)
+        self._code = code
+        self._clang_exec = clang_exec if clang_exec is not None else 'clang'
+
+    @property
+    def code(self):
+        """str: C++ code of the pair function."""
+        return self._code
+
+    def _create_cpp_obj(self):
+        device = self._simulation.device
+        llvm_ir = self._compile_user(device)
+
+        if isinstance(device, hoomd.device.CPU):
+            return _jit.PotentialPairJIT(self._simulation.state._cpp_sys_def,
+                                         self.nlist._cpp_obj, llvm_ir)
+
+        include_path_hoomd = os.path.dirname(hoomd.__file__) + '/include'
+        include_path_source = hoomd._hoomd.__hoomd_source_dir__
+        include_path_cuda = _jit.__cuda_include_path__
+        options = [
+            "-I" + include_path_hoomd, "-I" + include_path_source,
+            "-I" + include_path_cuda
+        ]
+        cuda_devrt_library_path = _jit.__cuda_devrt_library_path__
+
+        # select maximum supported compute capability out of those we compile
+        # for
+        compute_archs = _jit.__cuda_compute_archs__
+        compute_capability = device._cpp_exec_conf.getComputeCapability(0)
+        compute_major, compute_minor = compute_capability.split('.')
+        max_arch = 0
+        for a in compute_archs.split('_'):
+            if int(a) <= int(compute_major) * 10 + int(compute_minor):
+                max_arch = int(a)
+
+        return _jit.PotentialPairJITGPU(
+            self._simulation.state._cpp_sys_def, self.nlist._cpp_obj, llvm_ir,
+            self._wrap_gpu_code(), "kernel::gpu_compute_pair_forces_jit",
+            options, cuda_devrt_library_path, max_arch)
+
+    def _compile_user(self, device):
+        """Compile the code to LLVM IR."""
+        cpp_function = """
+#include "hoomd/HOOMDMath.h"
+
+extern "C"
+{
+
+Scalar eval(Scalar rsq,
+    const Scalar *param,
+    Scalar d_i,
+    Scalar d_j,
+    Scalar q_i,
+    Scalar q_j,
+    Scalar& force_divr)
+    {
+"""
+        cpp_function += self._code
+        cpp_function += """
+    }
+}
+"""
+
+        include_path = os.path.dirname(hoomd.__file__) + '/include'
+        include_path_source = hoomd._hoomd.__hoomd_source_dir__
+
+        cmd = [
+            self._clang_exec, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD',
+            '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm',
+            '-x', 'c++', '-o', '-', '-'
+        ]
+        return cache.compile_llvm_ir(cmd, cpp_function, device)
+
+    def _wrap_gpu_code(self):
+        """Wrap the code into a device function for NVRTC."""
+        cpp_function = """
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/jit/PotentialPairJITGPU.inc"
+
+__device__ inline Scalar eval(Scalar rsq,
+    const Scalar *param,
+    Scalar d_i,
+    Scalar d_j,
+    Scalar q_i,
+    Scalar q_j,
+    Scalar& force_divr)
+    {
+"""
+        cpp_function += self._code
+        cpp_function += """
+    }
+"""
+        return cpp_function
@@ -3,6 +3,7 @@
 
 from hoomd import _hoomd
 from hoomd.jit import _jit
+from hoomd.jit import cache
 import hoomd
 
 import subprocess
@@ -122,8 +123,25 @@ class user(object):
 
     ``vec3`` and ``quat`` are defined in HOOMDMath.h.
 
-    Compile the file with clang: ``clang -O3 --std=c++14 -DHOOMD_LLVMJIT_BUILD -I /path/to/hoomd/include -S -emit-llvm code.cc`` to produce
-    the LLVM IR in ``code.ll``.
+    The file may also define an extern "C" ``eval_batch`` function that evaluates a block of pairs of particle i
+    and stores each pair energy in *energy*. HOOMD calls it on the CPU when it is present, and ``eval`` otherwise:
+
+    .. code::
+
+        void eval_batch(unsigned int n,
+                        const vec3<float> *r_ij,
+                        unsigned int type_i,
+                        const quat<float>& q_i,
+                        float d_i,
+                        float charge_i,
+                        const unsigned int *type_j,
+                        const quat<float> *q_j,
+                        const float *d_j,
+                        const float *charge_j,
+                        float *energy)
+
+    Compile the file with clang: ``clang -O3 -march=native --std=c++14 -DHOOMD_LLVMJIT_BUILD -I /path/to/hoomd/include -S -emit-llvm code.cc``
+    to produce the LLVM IR in ``code.ll``.
 
     .. versionadded:: 2.3
     '''
@@ -217,6 +235,23 @@ float eval(const vec3<float>& r_ij,
         cpp_function += code
         cpp_function += """
     }
+
+// evaluate a block of pairs in one call, so that eval is inlined and the loop can be vectorized
+void eval_batch(unsigned int n,
+    const vec3<float> *r_ij,
+    unsigned int type_i,
+    const quat<float>& q_i,
+    float d_i,
+    float charge_i,
+    const unsigned int *type_j,
+    const quat<float> *q_j,
+    const float *d_j,
+    const float *charge_j,
+    float *energy)
+    {
+    for (unsigned int k = 0; k < n; ++k)
+        energy[k] = eval(r_ij[k], type_i, q_i, d_i, charge_i, type_j[k], q_j[k], d_j[k], charge_j[k]);
+    }
 }
 """
 
@@ -229,9 +264,13 @@ float eval(const vec3<float>& r_ij,
             clang = 'clang';
 
         if fn is not None:
-            cmd = [clang, '-O3', '--std=c++14', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
+            cmd = [clang, '-O3', '-march=native', '--std=c++14', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
         else:
-            cmd = [clang, '-O3', '--std=c++14', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o','-','-']
+            cmd = [clang, '-O3', '-march=native', '--std=c++14', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o','-','-']
+        if fn is None:
+            # compile once on rank 0 and reuse the IR from the on-disk cache when enabled
+            return cache.compile_llvm_ir(cmd, cpp_function)
+
         p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
 
         # pass C++ function to stdin
@@ -2,7 +2,8 @@ from copy import deepcopy
 from enum import Flag, auto
 from itertools import count
 from functools import reduce
-from hoomd.util import dict_map, SafeNamespaceDict
+from hoomd import _hoomd
+from hoomd.util import dict_map, dict_flatten, SafeNamespaceDict
 from collections.abc import Sequence
 
 
@@ -545,6 +546,8 @@ class Logger(SafeNamespaceDict):
     def __init__(self, categories=None, only_default=True):
         self._categories = LoggerCategories.ALL if categories is None else LoggerCategories.any(categories)
         self._only_default = only_default
+        self._batch = None
+        self._batch_entries_cache = []
         super().__init__()
 
     @property
@@ -731,7 +734,74 @@ class Logger(SafeNamespaceDict):
                 `hoomd.logging.LoggerCategories` enum value use
                 ``LoggerCategories[category]``.
         """
-        return dict_map(self._dict, lambda x: x())
+        batched = self._evaluate_batch()
+        return dict_map(
+            self._dict, lambda x: (batched[id(x)], 'scalar')
+            if id(x) in batched else x())
+
+    @staticmethod
+    def _cpp_log_source(obj):
+        """Get the C++ object and simulation that evaluate obj's quantities.
+
+        Attached operations evaluate their quantities with ``_cpp_obj``, a
+        `hoomd.Simulation` with its ``_cpp_sys``.
+        """
+        if getattr(obj, '_attached', False):
+            return getattr(obj, '_cpp_obj', None), obj._simulation
+        cpp_sys = getattr(obj, '_cpp_sys', None)
+        if cpp_sys is not None:
+            return cpp_sys, obj
+        return None, None
+
+    def _batch_entries(self):
+        """Find the scalar entries whose C++ object evaluates them."""
+        entries = []
+        simulation = None
+        for entry in dict_flatten(self._dict).values():
+            if entry.category is not LoggerCategories.scalar:
+                continue
+            cpp_obj, entry_simulation = self._cpp_log_source(entry.obj)
+            if not hasattr(cpp_obj, 'getLoggedQuantityNames'):
+                continue
+            if simulation is None:
+                simulation = entry_simulation
+            elif entry_simulation is not simulation:
+                continue
+            if entry.attr in cpp_obj.getLoggedQuantityNames():
+                entries.append((entry, cpp_obj))
+        return entries, simulation
+
+    def _evaluate_batch(self):
+        """Evaluate all quantities registered in C++ with one LogBatch.
+
+        The batch calls the getters of all registered quantities in C++ and
+        reduces the quantities summed over MPI ranks in a single reduction.
+        It is rebuilt when the logged entries or their C++ objects change.
+
+        Returns:
+            dict: Values keyed by the ``id`` of the `_LoggerEntry`.
+        """
+        entries, simulation = self._batch_entries()
+        if not entries:
+            self._batch = None
+            self._batch_entries_cache = []
+            return {}
+
+        cached = self._batch_entries_cache
+        if (len(cached) != len(entries) or any(
+                a[0] is not b[0] or a[1] is not b[1]
+                for a, b in zip(cached, entries))):
+            batch = _hoomd.LogBatch(simulation.device._cpp_exec_conf)
+            for entry, cpp_obj in entries:
+                batch.add(cpp_obj, entry.attr)
+            self._batch = batch
+            self._batch_entries_cache = entries
+
+        values = self._batch.evaluate(simulation.timestep)
+        return {
+            id(entry): int(value) if self._batch.isInteger(i) else value
+            for i, ((entry, _), value) in enumerate(zip(entries, values))
+        }
 
     def _contains_obj(self, namespace, obj):
         '''Evaluates based on identity.'''
@@ -6,6 +6,7 @@
 
 
 #include "ActiveForceCompute.h"
+#include "ActiveForceMath.h"
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
@@ -31,7 +32,8 @@ ActiveForceCompute::ActiveForceCompute(std::shared_ptr<SystemDefinition> sysdef,
                                         Scalar ry,
                                         Scalar rz)
         : ForceCompute(sysdef), m_group(group),
-            m_rotationDiff(rotation_diff), m_P(P), m_rx(rx), m_ry(ry), m_rz(rz)
+            m_rotationDiff(rotation_diff), m_P(P), m_rx(rx), m_ry(ry), m_rz(rz), m_fused(false),
+            m_fused_zeroed(false)
     {
     // allocate memory for the per-type active_force storage and initialize them to (1.0,0,0)
     GlobalVector<Scalar4> tmp_f_activeVec(m_pdata->getNTypes(), m_exec_conf);
@@ -211,13 +213,10 @@ void ActiveForceCompute::setForces()
         unsigned int idx = m_group->getMemberIndex(i);
         unsigned int type = __scalar_as_int(h_pos.data[idx].w);
 
-        vec3<Scalar> f(h_f_actVec.data[type].w*h_f_actVec.data[type].x, h_f_actVec.data[type].w*h_f_actVec.data[type].y, h_f_actVec.data[type].w*h_f_actVec.data[type].z);
         quat<Scalar> quati(h_orientation.data[idx]);
-        vec3<Scalar> fi = rotate(quati, f);
+        vec3<Scalar> fi, ti;
+        active_force_and_torque(quati, h_f_actVec.data[type], h_t_actVec.data[type], fi, ti);
         h_force.data[idx] = vec_to_scalar4(fi, 0);
-
-        vec3<Scalar> t(h_t_actVec.data[type].w*h_t_actVec.data[type].x, h_t_actVec.data[type].w*h_t_actVec.data[type].y, h_t_actVec.data[type].w*h_t_actVec.data[type].z);
-        vec3<Scalar> ti = rotate(quati, t);
         h_torque.data[idx] = vec_to_scalar4(ti, 0);
         }
     }
@@ -240,6 +239,8 @@ void ActiveForceCompute::rotationalDiffusion(uint64_t timestep)
     assert(h_orientation.data != NULL);
     assert(h_tag.data != NULL);
 
+    EvaluatorConstraintEllipsoid ellipsoid(m_P, m_rx, m_ry, m_rz);
+
     for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
         {
         unsigned int idx = m_group->getMemberIndex(i);
@@ -251,69 +252,10 @@ void ActiveForceCompute::rotationalDiffusion(uint64_t timestep)
                                    hoomd::Counter(ptag));
 
         quat<Scalar> quati(h_orientation.data[idx]);
-
-
-        if (m_sysdef->getNDimensions() == 2) // 2D
-            {
-            Scalar delta_theta; // rotational diffusion angle
-            delta_theta = hoomd::NormalDistribution<Scalar>(m_rotationConst)(rng);
-            Scalar theta = delta_theta/2.0; // half angle to calculate the quaternion which represents the rotation
-            vec3<Scalar> b(0,0,slow::sin(theta));
-
-            quat<Scalar> rot_quat(slow::cos(theta),b);// rotational diffusion quaternion
-
-            quati = rot_quat*quati; //rotational diffusion quaternion applied to orientation
-            h_orientation.data[idx].x = quati.s;
-            h_orientation.data[idx].y = quati.v.x;
-            h_orientation.data[idx].z = quati.v.y;
-            h_orientation.data[idx].w = quati.v.z;
-            // In 2D, the only meaningful torque vector is out of plane and should not change
-            }
-        else // 3D: Following Stenhammar, Soft Matter, 2014
-            {
-            if (m_rx == 0) // if no constraint
-                {
-                hoomd::SpherePointGenerator<Scalar> unit_vec;
-                vec3<Scalar> rand_vec;
-                unit_vec(rng, rand_vec);
-
-                vec3<Scalar> f(h_f_actVec.data[type].x, h_f_actVec.data[type].y, h_f_actVec.data[type].z);
-                vec3<Scalar> fi = rotate(quati, f); //rotate active force vector from local to global frame
-
-                vec3<Scalar> aux_vec; // rotation axis
-                aux_vec.x = fi.y * rand_vec.z - fi.z * rand_vec.y;
-                aux_vec.y = fi.z * rand_vec.x - fi.x * rand_vec.z;
-                aux_vec.z = fi.x * rand_vec.y - fi.y * rand_vec.x;
-                Scalar aux_vec_mag = 1.0/slow::sqrt(aux_vec.x*aux_vec.x + aux_vec.y*aux_vec.y + aux_vec.z*aux_vec.z);
-                aux_vec.x *= aux_vec_mag;
-                aux_vec.y *= aux_vec_mag;
-                aux_vec.z *= aux_vec_mag;
-
-                Scalar delta_theta = hoomd::NormalDistribution<Scalar>(m_rotationConst)(rng);
-                Scalar theta = delta_theta/2.0; // half angle to calculate the quaternion which represents the rotation
-                quat<Scalar> rot_quat(slow::cos(theta),slow::sin(theta)*aux_vec); // rotational diffusion quaternion
-
-                quati = rot_quat*quati; //rotational diffusion quaternion applied to orientation
-                h_orientation.data[idx] = quat_to_scalar4(quati);
-                }
-            else // if constraint exists
-                {
-                EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
-
-                Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
-                Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
-
-                vec3<Scalar> norm;
-                norm = vec3<Scalar> (norm_scalar3);
-
-                Scalar delta_theta = hoomd::NormalDistribution<Scalar>(m_rotationConst)(rng);
-                Scalar theta = delta_theta/2.0; // half angle to calculate the quaternion which represents the rotation
-                quat<Scalar> rot_quat(slow::cos(theta),slow::sin(theta)*norm);//rotational diffusion quaternion
-
-                quati = rot_quat*quati; //rotational diffusion quaternion applied to orientation
-                h_orientation.data[idx] = quat_to_scalar4(quati);
-                }
-            }
+        Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+        active_force_rotational_diffusion(quati, current_pos, h_f_actVec.data[type], ellipsoid, m_rx != 0,
+                                          m_sysdef->getNDimensions() == 2, m_rotationConst, rng);
+        h_orientation.data[idx] = quat_to_scalar4(quati);
         }
     }
 
@@ -338,41 +280,8 @@ void ActiveForceCompute::setConstraint()
         unsigned int type = __scalar_as_int(h_pos.data[idx].w);
 
         Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
-
-        Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
-        vec3<Scalar> norm = vec3<Scalar>(norm_scalar3);
-
-        Scalar3 f = make_scalar3(h_f_actVec.data[type].x, h_f_actVec.data[type].y, h_f_actVec.data[type].z);
         quat<Scalar> quati(h_orientation.data[idx]);
-        vec3<Scalar> fi = rotate(quati, vec3<Scalar>(f));//rotate active force vector from local to global frame
-
-
-        Scalar dot_prod = fi.x * norm.x + fi.y * norm.y + fi.z * norm.z;
-
-        Scalar dot_perp_prod = slow::sqrt(1-dot_prod*dot_prod);
-
-        Scalar phi_half = slow::atan(dot_prod/dot_perp_prod)/2.0;
-
-
-        fi.x -= norm.x * dot_prod;
-        fi.y -= norm.y * dot_prod;
-        fi.z -= norm.z * dot_prod;
-
-        Scalar new_norm = 1.0/slow::sqrt(fi.x*fi.x + fi.y*fi.y + fi.z*fi.z);
-
-        fi.x *= new_norm;
-        fi.y *= new_norm;
-        fi.z *= new_norm;
-
-        vec3<Scalar> rot_vec = cross(norm,fi);
-        rot_vec.x *= slow::sin(phi_half);
-        rot_vec.y *= slow::sin(phi_half);
-        rot_vec.z *= slow::sin(phi_half);
-
-        quat<Scalar> rot_quat(cos(phi_half),rot_vec);
-
-        quati = rot_quat*quati;
-
+        active_force_constrain(quati, current_pos, h_f_actVec.data[type], Ellipsoid);
         h_orientation.data[idx] = quat_to_scalar4(quati);
         }
     }
@@ -384,7 +293,19 @@ void ActiveForceCompute::computeForces(uint64_t timestep)
     {
     if (m_prof) m_prof->push(m_exec_conf, "ActiveForceCompute");
 
-    if (last_computed != timestep)
+    if (m_fused)
+        {
+        // the integration method applies the active forces, leave no stale forces behind
+        if (!m_fused_zeroed)
+            {
+            ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::overwrite);
+            ArrayHandle<Scalar4> h_torque(m_torque,access_location::host,access_mode::overwrite);
+            memset(h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
+            memset(h_torque.data, 0, sizeof(Scalar4) * m_torque.getNumElements());
+            m_fused_zeroed = true;
+            }
+        }
+    else if (last_computed != timestep)
         {
         m_rotationConst = slow::sqrt(2.0 * m_rotationDiff * m_deltaT);
 
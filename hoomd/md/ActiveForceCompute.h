@@ -77,6 +77,53 @@ class PYBIND11_EXPORT ActiveForceCompute : public ForceCompute
         /// Gets active torque vector for a given particle type
         pybind11::tuple getActiveTorque(const std::string& type_name);
 
+        //! Let an integration method apply the active forces and rotational diffusion
+        /*! When fused, computeForces() leaves the force and torque arrays zero and the integration method evaluates
+            the active force, the active torque, the constraint, and the rotational diffusion of every particle in its
+            own update. See TwoStepBD::setActiveForce().
+        */
+        void setFused(bool fused)
+            {
+            m_fused = fused;
+            m_fused_zeroed = false;
+            }
+
+        //! Get whether an integration method applies the active forces
+        bool isFused()
+            {
+            return m_fused;
+            }
+
+        //! Get the group of active particles
+        std::shared_ptr<ParticleGroup> getGroup()
+            {
+            return m_group;
+            }
+
+        //! Get the per-type active force unit vectors and magnitudes
+        const GlobalVector<Scalar4>& getActiveForceVectors()
+            {
+            return m_f_activeVec;
+            }
+
+        //! Get the per-type active torque unit vectors and magnitudes
+        const GlobalVector<Scalar4>& getActiveTorqueVectors()
+            {
+            return m_t_activeVec;
+            }
+
+        //! Get the position of the constraint ellipsoid
+        Scalar3 getConstraintPosition()
+            {
+            return m_P;
+            }
+
+        //! Get the radii of the constraint ellipsoid (all zero without a constraint)
+        Scalar3 getConstraintRadii()
+            {
+            return make_scalar3(m_rx, m_ry, m_rz);
+            }
+
 
     protected:
         //! Actually compute the forces
@@ -103,6 +150,8 @@ class PYBIND11_EXPORT ActiveForceCompute : public ForceCompute
         GlobalVector<Scalar4> m_t_activeVec; //! active torque unit vectors and magnitudes for each particle type
 
         uint64_t last_computed;
+        bool m_fused;         //!< True when an integration method applies the active forces
+        bool m_fused_zeroed;  //!< True when the force arrays have been zeroed since fusing
     };
 
 //! Exports the ActiveForceComputeClass to python
@@ -0,0 +1,157 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file ActiveForceMath.h
+    \brief Per-particle active force operations shared by ActiveForceCompute and the fused active Brownian update
+*/
+
+#ifndef __ACTIVE_FORCE_MATH_H__
+#define __ACTIVE_FORCE_MATH_H__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/RNGIdentifiers.h"
+#include "EvaluatorConstraintEllipsoid.h"
+
+#ifdef __HIPCC__
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Compute the active force and torque of a particle in the global frame
+/*! \param quati Orientation of the particle
+    \param fact Active force unit vector (xyz) and magnitude (w) in the particle frame
+    \param tact Active torque unit vector (xyz) and magnitude (w) in the particle frame
+    \param fi Active force in the global frame (output)
+    \param ti Active torque in the global frame (output)
+*/
+DEVICE inline void active_force_and_torque(const quat<Scalar>& quati,
+                                           const Scalar4& fact,
+                                           const Scalar4& tact,
+                                           vec3<Scalar>& fi,
+                                           vec3<Scalar>& ti)
+    {
+    vec3<Scalar> f(fact.w*fact.x, fact.w*fact.y, fact.w*fact.z);
+    fi = rotate(quati, f);
+
+    vec3<Scalar> t(tact.w*tact.x, tact.w*tact.y, tact.w*tact.z);
+    ti = rotate(quati, t);
+    }
+
+//! Rotate a particle so that its active force vector lies in the tangent plane of an ellipsoid
+/*! \param quati Orientation of the particle, updated in place
+    \param pos Position of the particle
+    \param fact Active force unit vector in the particle frame
+    \param ellipsoid Constraint surface
+*/
+DEVICE inline void active_force_constrain(quat<Scalar>& quati,
+                                          const Scalar3& pos,
+                                          const Scalar4& fact,
+                                          EvaluatorConstraintEllipsoid& ellipsoid)
+    {
+    Scalar3 norm_scalar3 = ellipsoid.evalNormal(pos); // the normal vector to which the particles are confined.
+    vec3<Scalar> norm = vec3<Scalar>(norm_scalar3);
+
+    vec3<Scalar> f(fact.x, fact.y, fact.z);
+    vec3<Scalar> fi = rotate(quati, f); //rotate active force vector from local to global frame
+
+    Scalar dot_prod = fi.x * norm.x + fi.y * norm.y + fi.z * norm.z;
+
+    Scalar dot_perp_prod = slow::sqrt(1-dot_prod*dot_prod);
+
+    Scalar phi_half = slow::atan(dot_prod/dot_perp_prod)/2.0;
+
+    fi.x -= norm.x * dot_prod;
+    fi.y -= norm.y * dot_prod;
+    fi.z -= norm.z * dot_prod;
+
+    Scalar new_norm = 1.0/slow::sqrt(fi.x*fi.x + fi.y*fi.y + fi.z*fi.z);
+
+    fi.x *= new_norm;
+    fi.y *= new_norm;
+    fi.z *= new_norm;
+
+    vec3<Scalar> rot_vec = cross(norm,fi);
+    rot_vec.x *= slow::sin(phi_half);
+    rot_vec.y *= slow::sin(phi_half);
+    rot_vec.z *= slow::sin(phi_half);
+
+    quat<Scalar> rot_quat(cos(phi_half),rot_vec);
+
+    quati = rot_quat*quati;
+    }
+
+//! Apply one step of rotational diffusion to the orientation of an active particle
+/*! \param quati Orientation of the particle, updated in place
+    \param pos Position of the particle
+    \param fact Active force unit vector in the particle frame
+    \param ellipsoid Constraint surface, used when \a constrained is set
+    \param constrained True when the particles are confined to the ellipsoid
+    \param is2D True in 2D simulations
+    \param rotationConst Standard deviation of the rotation angle, sqrt(2 D_r dt)
+    \param rng Random number generator of this particle
+
+    The orientation of any torque vector relative to the force vector is preserved. In 3D, this follows Stenhammar,
+    Soft Matter, 2014.
+*/
+DEVICE inline void active_force_rotational_diffusion(quat<Scalar>& quati,
+                                                     const Scalar3& pos,
+                                                     const Scalar4& fact,
+                                                     EvaluatorConstraintEllipsoid& ellipsoid,
+                                                     bool constrained,
+                                                     bool is2D,
+                                                     Scalar rotationConst,
+                                                     hoomd::RandomGenerator& rng)
+    {
+    if (is2D) // 2D
+        {
+        Scalar delta_theta; // rotational diffusion angle
+        delta_theta = hoomd::NormalDistribution<Scalar>(rotationConst)(rng);
+        Scalar theta = delta_theta/2.0; // half angle to calculate the quaternion which represents the rotation
+        vec3<Scalar> b(0,0,slow::sin(theta));
+
+        quat<Scalar> rot_quat(slow::cos(theta),b);// rotational diffusion quaternion
+
+        quati = rot_quat*quati; //rotational diffusion quaternion applied to orientation
+        // In 2D, the only meaningful torque vector is out of plane and should not change
+        }
+    else if (!constrained)
+        {
+        hoomd::SpherePointGenerator<Scalar> unit_vec;
+        vec3<Scalar> rand_vec;
+        unit_vec(rng, rand_vec);
+
+        vec3<Scalar> f(fact.x, fact.y, fact.z);
+        vec3<Scalar> fi = rotate(quati, f); //rotate active force vector from local to global frame
+
+        vec3<Scalar> aux_vec; // rotation axis
+        aux_vec.x = fi.y * rand_vec.z - fi.z * rand_vec.y;
+        aux_vec.y = fi.z * rand_vec.x - fi.x * rand_vec.z;
+        aux_vec.z = fi.x * rand_vec.y - fi.y * rand_vec.x;
+        Scalar aux_vec_mag = 1.0/slow::sqrt(aux_vec.x*aux_vec.x + aux_vec.y*aux_vec.y + aux_vec.z*aux_vec.z);
+        aux_vec.x *= aux_vec_mag;
+        aux_vec.y *= aux_vec_mag;
+        aux_vec.z *= aux_vec_mag;
+
+        Scalar delta_theta = hoomd::NormalDistribution<Scalar>(rotationConst)(rng);
+        Scalar theta = delta_theta/2.0; // half angle to calculate the quaternion which represents the rotation
+        quat<Scalar> rot_quat(slow::cos(theta),slow::sin(theta)*aux_vec); // rotational diffusion quaternion
+
+        quati = rot_quat*quati; //rotational diffusion quaternion applied to orientation
+        }
+    else
+        {
+        Scalar3 norm_scalar3 = ellipsoid.evalNormal(pos); // the normal vector to which the particles are confined.
+        vec3<Scalar> norm = vec3<Scalar>(norm_scalar3);
+
+        Scalar delta_theta = hoomd::NormalDistribution<Scalar>(rotationConst)(rng);
+        Scalar theta = delta_theta/2.0; // half angle to calculate the quaternion which represents the rotation
+        quat<Scalar> rot_quat(slow::cos(theta),slow::sin(theta)*norm);//rotational diffusion quaternion
+
+        quati = rot_quat*quati; //rotational diffusion quaternion applied to orientation
+        }
+    }
+
+#endif // __ACTIVE_FORCE_MATH_H__
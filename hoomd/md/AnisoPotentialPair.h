@@ -225,6 +225,7 @@ class AnisoPotentialPair : public ForceCompute
         GlobalArray<Scalar> m_rcutsq;                  //!< Cutoff radius squared per type pair
         GlobalArray<param_type> m_params;   //!< Pair parameters per type pair
         GlobalArray<shape_type> m_shape_params;   //!< Pair parameters per type pair
+        GlobalArray<Scalar4> m_lab_frame;           //!< Lab frame quantities of the local and ghost particles
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
@@ -237,6 +238,18 @@ class AnisoPotentialPair : public ForceCompute
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
 
+        //! Grow m_lab_frame to hold the local and ghost particles
+        void allocateLabFrame()
+            {
+            const unsigned int n = m_pdata->getN() + m_pdata->getNGhosts();
+            if (m_lab_frame.getNumElements() < n)
+                {
+                GlobalArray<Scalar4> lab_frame(n, m_exec_conf);
+                m_lab_frame.swap(lab_frame);
+                TAG_ALLOCATION(m_lab_frame);
+                }
+            }
+
         //! Method to be called when number of types changes
         void slotNumTypesChange()
             {
@@ -610,7 +623,8 @@ void AnisoPotentialPair< aniso_evaluator >::computeForces(uint64_t timestep)
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
 
     // access the neighbor list, particle data, and system box
-    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getConsumerNNeighArray(m_r_cut_nlist),
+                                        access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
 
@@ -639,13 +653,22 @@ void AnisoPotentialPair< aniso_evaluator >::computeForces(uint64_t timestep)
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor];
 
+    // evaluate the orientation dependent quantities once per particle instead of once per pair
+    allocateLabFrame();
+    ArrayHandle<Scalar4> h_lab_frame(m_lab_frame, access_location::host, access_mode::overwrite);
+    for (unsigned int i = 0; i < m_pdata->getN() + m_pdata->getNGhosts(); i++)
+        {
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        h_lab_frame.data[i] = aniso_evaluator::labFrame(h_orientation.data[i], h_shape_params.data[typei]);
+        }
+
     // for each particle
     for (int i = 0; i < (int)m_pdata->getN(); i++)
         {
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        Scalar4 quat_i = h_orientation.data[i];
+        Scalar4 lab_i = h_lab_frame.data[i];
 
         // sanity check
         assert(typei < m_pdata->getNTypes());
@@ -685,7 +708,7 @@ void AnisoPotentialPair< aniso_evaluator >::computeForces(uint64_t timestep)
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
             Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
             Scalar3 dx = pi - pj;
-            Scalar4 quat_j = h_orientation.data[j];
+            Scalar4 lab_j = h_lab_frame.data[j];
 
             // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
             unsigned int typej = __scalar_as_int(h_pos.data[j].w);
@@ -720,7 +743,7 @@ void AnisoPotentialPair< aniso_evaluator >::computeForces(uint64_t timestep)
 
             Scalar pair_eng = Scalar(0.0);
 
-            aniso_evaluator eval(dx, quat_i, quat_j, rcutsq, param);
+            aniso_evaluator eval(dx, lab_i, lab_j, rcutsq, param);
 
             if (aniso_evaluator::needsDiameter())
                 eval.setDiameter(di, dj);
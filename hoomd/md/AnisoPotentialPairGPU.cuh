@@ -39,11 +39,13 @@ struct a_pair_args_t
               Scalar *_d_virial,
               size_t _virial_pitch,
               const unsigned int _N,
+              const unsigned int _n_ghost,
               const unsigned int _n_max,
               const Scalar4 *_d_pos,
               const Scalar *_d_diameter,
               const Scalar *_d_charge,
               const Scalar4 *_d_orientation,
+              Scalar4 *_d_lab_frame,
               const unsigned int *_d_tag,
               const BoxDim& _box,
               const unsigned int *_d_n_neigh,
@@ -64,11 +66,13 @@ struct a_pair_args_t
                   d_virial(_d_virial),
                   virial_pitch(_virial_pitch),
                   N(_N),
+                  n_ghost(_n_ghost),
                   n_max(_n_max),
                   d_pos(_d_pos),
                   d_diameter(_d_diameter),
                   d_charge(_d_charge),
                   d_orientation(_d_orientation),
+                  d_lab_frame(_d_lab_frame),
                   d_tag(_d_tag),
                   box(_box),
                   d_n_neigh(_d_n_neigh),
@@ -91,11 +95,13 @@ struct a_pair_args_t
     Scalar *d_virial;                //!< Virial to write out
     const size_t virial_pitch; //!< The pitch of the 2D array of virial matrix elements
     const unsigned int N;           //!< number of particles
+    const unsigned int n_ghost;     //!< number of ghost particles
     const unsigned int n_max;       //!< maximum size of particle data arrays
     const Scalar4 *d_pos;           //!< particle positions
     const Scalar *d_diameter;       //!< particle diameters
     const Scalar *d_charge;         //!< particle charges
     const Scalar4 *d_orientation;   //!< particle orientation to compute forces over
+    Scalar4 *d_lab_frame;           //!< lab frame quantities of the local and ghost particles (evaluator::labFrame)
     const unsigned int *d_tag;      //!< particle tags to compute forces over
     const BoxDim& box;              //!< Simulation box in GPU format
     const unsigned int *d_n_neigh;  //!< Device array listing the number of neighbors on each particle
@@ -114,6 +120,31 @@ struct a_pair_args_t
 
 #ifdef __HIPCC__
 
+//! Kernel for evaluating the lab frame quantities of the particles
+/*! \param d_lab_frame Output lab frame quantities
+    \param d_pos particle positions
+    \param d_orientation particle orientations
+    \param d_shape_params Shape parameters, stored per type
+    \param n Number of local and ghost particles
+
+    The pair kernel gives these to the evaluator in place of the orientations, so that quantities such as the lab
+    frame dipole moment are computed once per particle rather than once per pair.
+*/
+template< class evaluator >
+__global__ void gpu_compute_aniso_lab_frame_kernel(Scalar4 *d_lab_frame,
+                                                   const Scalar4 *d_pos,
+                                                   const Scalar4 *d_orientation,
+                                                   const typename evaluator::shape_type *d_shape_params,
+                                                   const unsigned int n)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n)
+        return;
+
+    unsigned int type = __scalar_as_int(__ldg(d_pos + idx).w);
+    d_lab_frame[idx] = evaluator::labFrame(__ldg(d_orientation + idx), d_shape_params[type]);
+    }
+
 //! Kernel for calculating pair forces
 /*! This kernel is called to calculate the pair forces on all N particles. Actual evaluation of the potentials and
     forces for each pair is handled via the template class \a evaluator.
@@ -126,7 +157,7 @@ struct a_pair_args_t
     \param d_pos particle positions
     \param d_diameter particle diameters
     \param d_charge particle charges
-    \param d_orientation Quaternion data on the GPU to calculate forces on
+    \param d_lab_frame Lab frame quantities of the particles, see gpu_compute_aniso_lab_frame_kernel()
     \param d_tag Tag data on the GPU to calculate forces on
     \param box Box dimensions used to implement periodic boundary conditions
     \param d_n_neigh Device memory array listing the number of neighbors for each particle
@@ -162,7 +193,7 @@ __global__ void gpu_compute_pair_aniso_forces_kernel(Scalar4 *d_force,
                                                      const Scalar4 *d_pos,
                                                      const Scalar *d_diameter,
                                                      const Scalar *d_charge,
-                                                     const Scalar4 *d_orientation,
+                                                     const Scalar4 *d_lab_frame,
                                                      const unsigned int *d_tag,
                                                      const BoxDim box,
                                                      const unsigned int *d_n_neigh,
@@ -254,7 +285,7 @@ __global__ void gpu_compute_pair_aniso_forces_kernel(Scalar4 *d_force,
         // read in the position of our particle
         Scalar4 postypei = __ldg(d_pos + idx);
         Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
-        Scalar4 quati = __ldg(d_orientation + idx);
+        Scalar4 quati = __ldg(d_lab_frame + idx);
 
         Scalar di = Scalar(0);
         if (evaluator::needsDiameter())
@@ -285,7 +316,7 @@ __global__ void gpu_compute_pair_aniso_forces_kernel(Scalar4 *d_force,
                 // get the neighbor's position
                 Scalar4 postypej = __ldg(d_pos + cur_j);
                 Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
-                Scalar4 quatj = __ldg(d_orientation + cur_j);
+                Scalar4 quatj = __ldg(d_lab_frame + cur_j);
 
                 Scalar dj = Scalar(0);
                 if (evaluator::needsDiameter())
@@ -491,7 +522,7 @@ struct AnisoPairForceComputeKernel
                                                    pair_args.d_pos,
                                                    pair_args.d_diameter,
                                                    pair_args.d_charge,
-                                                   pair_args.d_orientation,
+                                                   pair_args.d_lab_frame,
                                                    pair_args.d_tag,
                                                    pair_args.box,
                                                    pair_args.d_n_neigh,
@@ -537,6 +568,20 @@ hipError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
     assert(pair_args.d_rcutsq);
     assert(pair_args.ntypes > 0);
 
+    // evaluate the lab frame quantities of all local and ghost particles on the first GPU
+    const unsigned int n_lab_frame = pair_args.N + pair_args.n_ghost;
+    if (n_lab_frame > 0)
+        {
+        unsigned int block_size = 256;
+        hipLaunchKernelGGL((gpu_compute_aniso_lab_frame_kernel<evaluator>), dim3(n_lab_frame/block_size + 1),
+            dim3(block_size), 0, 0, pair_args.d_lab_frame, pair_args.d_pos, pair_args.d_orientation,
+            d_shape_params, n_lab_frame);
+        }
+
+    // finish the lab frame quantities before the other GPUs read them
+    if (pair_args.gpu_partition.getNumActiveGPUs() > 1)
+        hipDeviceSynchronize();
+
     // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
     for (int idev = pair_args.gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
         {
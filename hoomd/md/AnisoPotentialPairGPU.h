@@ -134,7 +134,8 @@ void AnisoPotentialPairGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timest
         }
 
     // access the neighbor list
-    ArrayHandle<unsigned int> d_n_neigh(this->m_nlist->getNNeighArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_n_neigh(this->m_nlist->getConsumerNNeighArray(this->m_r_cut_nlist),
+                                        access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_nlist(this->m_nlist->getNListArray(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_head_list(this->m_nlist->getHeadList(), access_location::device, access_mode::read);
 
@@ -145,6 +146,10 @@ void AnisoPotentialPairGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timest
     ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(),access_location::device,access_mode::read);
     ArrayHandle<unsigned int> d_tag(this->m_pdata->getTags(), access_location::device, access_mode::read);
 
+    // scratch space for the lab frame quantities of the particles
+    this->allocateLabFrame();
+    ArrayHandle<Scalar4> d_lab_frame(this->m_lab_frame, access_location::device, access_mode::overwrite);
+
     BoxDim box = this->m_pdata->getBox();
 
     // access parameters
@@ -175,11 +180,13 @@ void AnisoPotentialPairGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timest
                            d_virial.data,
                            this->m_virial.getPitch(),
                            this->m_pdata->getN(),
+                           this->m_pdata->getNGhosts(),
                            this->m_pdata->getMaxN(),
                            d_pos.data,
                            d_diameter.data,
                            d_charge.data,
                            d_orientation.data,
+                           d_lab_frame.data,
                            d_tag.data,
                            box,
                            d_n_neigh.data,
@@ -24,7 +24,7 @@ using namespace std;
 BondTablePotential::BondTablePotential(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_table_width(table_width)
+        : ForceCompute(sysdef), m_table_width(table_width), m_hermite(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondTablePotential" << endl;
 
@@ -119,6 +119,26 @@ void BondTablePotential::setTable(unsigned int type,
         }
     }
 
+/*! \param interpolation "linear" or "hermite"
+*/
+void BondTablePotential::setInterpolation(const std::string& interpolation)
+    {
+    if (interpolation == "linear")
+        m_hermite = false;
+    else if (interpolation == "hermite")
+        m_hermite = true;
+    else
+        {
+        m_exec_conf->msg->error() << "bond.table: interpolation must be linear or hermite, got " << interpolation << endl;
+        throw runtime_error("Error setting table interpolation");
+        }
+    }
+
+std::string BondTablePotential::getInterpolation()
+    {
+    return m_hermite ? "hermite" : "linear";
+    }
+
 /*! BondTablePotential provides
     - \c bond_table_energy
 */
@@ -234,18 +254,14 @@ void BondTablePotential::computeForces(uint64_t timestep)
             unsigned int value_i = (unsigned int)floor(value_f);
             Scalar2 VF0 = h_tables.data[m_table_value(value_i, type)];
             Scalar2 VF1 = h_tables.data[m_table_value(value_i+1, type)];
-            // unpack the data
-            Scalar V0 = VF0.x;
-            Scalar V1 = VF1.x;
-            Scalar F0 = VF0.y;
-            Scalar F1 = VF1.y;
 
-            // compute the linear interpolation coefficient
-            Scalar f = value_f - Scalar(value_i);
+            // compute the interpolation coefficient
+        Scalar f = value_f - Scalar(value_i);
 
-            // interpolate to get V and F;
-            Scalar V = V0 + f * (V1 - V0);
-            Scalar F = F0 + f * (F1 - F0);
+        // interpolate to get V and F
+        Scalar2 VF = table_interpolate(VF0, VF1, f, delta_r, m_hermite);
+        Scalar V = VF.x;
+        Scalar F = VF.y;
 
             // convert to standard variables used by the other pair computes in HOOMD-blue
             Scalar force_divr = Scalar(0.0);
@@ -296,5 +312,7 @@ void export_BondTablePotential(py::module& m)
     py::class_<BondTablePotential, ForceCompute, std::shared_ptr<BondTablePotential> >(m, "BondTablePotential")
     .def(py::init< std::shared_ptr<SystemDefinition>, unsigned int, const std::string& >())
     .def("setTable", &BondTablePotential::setTable)
+    .def("setInterpolation", &BondTablePotential::setInterpolation)
+    .def("getInterpolation", &BondTablePotential::getInterpolation)
     ;
     }
@@ -7,6 +7,7 @@
 #include "hoomd/ForceCompute.h"
 #include "hoomd/Index1D.h"
 #include "hoomd/GPUArray.h"
+#include "TableInterpolation.h"
 
 #include <memory>
 
@@ -48,6 +49,10 @@
     Values are interpolated linearly between two points straddling the given r. For a given r, the first point needed, i
     can be calculated via i = floorf((r - rmin) / dr). The fraction between ri and ri+1 can be calculated via
     f = (r - rmin) / dr - float(i). And the linear interpolation can then be performed via V(r) ~= Vi + f * (Vi+1 - Vi)
+
+    With setInterpolation("hermite"), V is interpolated with the cubic Hermite spline through the tabulated values
+    and slopes and the force is its derivative, see table_interpolate(). This reaches the accuracy of linear
+    interpolation with a much coarser table.
     \ingroup computes
 */
 class PYBIND11_EXPORT BondTablePotential : public ForceCompute
@@ -68,6 +73,12 @@ class PYBIND11_EXPORT BondTablePotential : public ForceCompute
                               Scalar rmin,
                               Scalar rmax);
 
+        //! Set the interpolation between the table points
+        void setInterpolation(const std::string& interpolation);
+
+        //! Get the interpolation between the table points
+        std::string getInterpolation();
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -94,6 +105,7 @@ class PYBIND11_EXPORT BondTablePotential : public ForceCompute
         GPUArray<Scalar4> m_params;                 //!< Parameters stored for each table
         Index2D m_table_value;                      //!< Index table helper
         std::string m_log_name;                     //!< Cached log name
+        bool m_hermite;                             //!< True for cubic Hermite interpolation, false for linear
 
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
@@ -66,6 +66,10 @@ void BondTablePotentialGPU::computeForces(uint64_t timestep)
     ArrayHandle<Scalar2> d_tables(m_tables, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_params(m_params, access_location::device, access_mode::read);
 
+    // stage the tables in shared memory next to the parameters when they fit
+    bool stage_tables = sizeof(Scalar4)*m_bond_data->getNTypes() + sizeof(Scalar2)*m_tables.getNumElements()
+                        <= m_exec_conf->dev_prop.sharedMemPerBlock;
+
     ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(m_virial,access_location::device,access_mode::overwrite);
 
@@ -73,6 +77,7 @@ void BondTablePotentialGPU::computeForces(uint64_t timestep)
         // Access the bond table for reading
         ArrayHandle<BondData::members_t> d_gpu_bondlist(this->m_bond_data->getGPUTable(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int > d_gpu_n_bonds(this->m_bond_data->getNGroupsArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_table_offsets(this->m_bond_data->getGPUTableOffsets(), access_location::device, access_mode::read);
         // access the flags array for overwriting
         ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::overwrite);
 
@@ -87,6 +92,7 @@ void BondTablePotentialGPU::computeForces(uint64_t timestep)
                              box,
                              d_gpu_bondlist.data,
                              m_bond_data->getGPUTableIndexer().getW(),
+                             d_gpu_table_offsets.data,
                              d_gpu_n_bonds.data,
                              m_bond_data->getNTypes(),
                              d_tables.data,
@@ -94,7 +100,9 @@ void BondTablePotentialGPU::computeForces(uint64_t timestep)
                              m_table_width,
                              m_table_value,
                              d_flags.data,
-                             m_tuner->getParam());
+                             m_tuner->getParam(),
+                             m_hermite,
+                             stage_tables);
         }
 
 
@@ -25,11 +25,14 @@
     \param box Box dimensions used to implement periodic boundary conditions
     \param blist List of bonds stored on the GPU
     \param pitch Pitch of 2D bond list
+    \param table_offsets Index of the first entry of every particle in the bond list
     \param n_bonds_list List of numbers of bonds stored on the GPU
     \param n_bond_type number of bond types
     \param d_params Parameters for each table associated with a type pair
     \param table_value index helper function
     \param d_flags Flag allocated on the device for use in checking for bonds that cannot be evaluated
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \param stage_tables True if the tables are copied to shared memory after the parameters
 
     See BondTablePotential for information on the memory layout.
 */
@@ -41,12 +44,15 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
                                      const BoxDim box,
                                      const group_storage<2> *blist,
                                      size_t pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_bonds_list,
                                      const unsigned int n_bond_type,
                                      const Scalar2 *d_tables,
                                      const Scalar4 *d_params,
                                      const Index2D table_value,
-                                     unsigned int *d_flags)
+                                     unsigned int *d_flags,
+                                     const bool hermite,
+                                     const bool stage_tables)
     {
 
 
@@ -57,6 +63,17 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
         if (cur_offset + threadIdx.x < n_bond_type)
             s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
         }
+
+    // the tables follow the parameters, when they fit
+    Scalar2 *s_tables = (Scalar2 *)(&s_params[n_bond_type]);
+    if (stage_tables)
+        {
+        for (unsigned int cur_offset = 0; cur_offset < table_value.getNumElements(); cur_offset += blockDim.x)
+            {
+            if (cur_offset + threadIdx.x < table_value.getNumElements())
+                s_tables[cur_offset + threadIdx.x] = d_tables[cur_offset + threadIdx.x];
+            }
+        }
     __syncthreads();
 
 
@@ -69,6 +86,9 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_bonds =n_bonds_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our particle.
     Scalar4 postype = d_pos[idx];
     Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
@@ -84,7 +104,7 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
     for (int bond_idx = 0; bond_idx < n_bonds; bond_idx++)
         {
         // MEM TRANSFER: 8 bytes
-        group_storage<2> cur_bond = blist[pitch*bond_idx + idx];
+        group_storage<2> cur_bond = blist[pitch*bond_idx + table_start];
 
         int cur_bond_idx = cur_bond.idx[0];
         int cur_bond_type = cur_bond.idx[1];
@@ -117,20 +137,17 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
             // compute index into the table and read in values
             unsigned int value_i = floor(value_f);
 
-            Scalar2 VF0 = __ldg(d_tables + table_value(value_i, cur_bond_type));
-            Scalar2 VF1 = __ldg(d_tables + table_value(value_i+1, cur_bond_type));
-            // unpack the data
-            Scalar V0 = VF0.x;
-            Scalar V1 = VF1.x;
-            Scalar F0 = VF0.y;
-            Scalar F1 = VF1.y;
+            unsigned int i0 = table_value(value_i, cur_bond_type);
+            Scalar2 VF0 = stage_tables ? s_tables[i0] : __ldg(d_tables + i0);
+            Scalar2 VF1 = stage_tables ? s_tables[i0+1] : __ldg(d_tables + i0 + 1);
 
-            // compute the linear interpolation coefficient
+            // compute the interpolation coefficient
             Scalar f = value_f - Scalar(value_i);
 
-            // interpolate to get V and F;
-            Scalar V = V0 + f * (V1 - V0);
-            Scalar F = F0 + f * (F1 - F0);
+            // interpolate to get V and F
+            Scalar2 VF = table_interpolate(VF0, VF1, f, delta_r, hermite);
+            Scalar V = VF.x;
+            Scalar F = VF.y;
 
             // convert to standard variables used by the other pair computes in HOOMD-blue
             Scalar forcemag_divr = 0.0f;
@@ -174,6 +191,7 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
     \param box Box dimensions used to implement periodic boundary conditions
     \param blist List of bonds stored on the GPU
     \param pitch Pitch of 2D bond list
+    \param table_offsets Index of the first entry of every particle in the bond list
     \param n_bonds_list List of numbers of bonds stored on the GPU
     \param n_bond_type number of bond types
     \param d_tables Tables of the potential and force
@@ -183,6 +201,8 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
     \param d_flags flags on the device - a 1 will be written if evaluation
                    of forces failed for any bond
     \param block_size Block size at which to run the kernel
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \param stage_tables True if the tables fit in shared memory next to the parameters
 
     \note This is just a kernel driver. See gpu_compute_bondtable_forces_kernel for full documentation.
 */
@@ -194,6 +214,7 @@ hipError_t gpu_compute_bondtable_forces(Scalar4* d_force,
                                      const BoxDim &box,
                                      const group_storage<2> *blist,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_bonds_list,
                                      const unsigned int n_bond_type,
                                      const Scalar2 *d_tables,
@@ -201,7 +222,9 @@ hipError_t gpu_compute_bondtable_forces(Scalar4* d_force,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
                                      unsigned int *d_flags,
-                                     const unsigned int block_size)
+                                     const unsigned int block_size,
+                                     const bool hermite,
+                                     const bool stage_tables)
     {
     assert(d_params);
     assert(d_tables);
@@ -222,7 +245,11 @@ hipError_t gpu_compute_bondtable_forces(Scalar4* d_force,
     dim3 grid( N / run_block_size + 1, 1, 1);
     dim3 threads(run_block_size, 1, 1);
 
-    hipLaunchKernelGGL((gpu_compute_bondtable_forces_kernel), dim3(grid), dim3(threads), sizeof(Scalar4)*n_bond_type , 0, d_force,
+    unsigned int shared_bytes = sizeof(Scalar4)*n_bond_type;
+    if (stage_tables)
+        shared_bytes += sizeof(Scalar2)*table_value.getNumElements();
+
+    hipLaunchKernelGGL((gpu_compute_bondtable_forces_kernel), dim3(grid), dim3(threads), shared_bytes, 0, d_force,
              d_virial,
              virial_pitch,
              N,
@@ -230,12 +257,15 @@ hipError_t gpu_compute_bondtable_forces(Scalar4* d_force,
              box,
              blist,
              pitch,
+             table_offsets,
              n_bonds_list,
              n_bond_type,
              d_tables,
              d_params,
              table_value,
-             d_flags);
+             d_flags,
+             hermite,
+             stage_tables);
 
     return hipSuccess;
     }
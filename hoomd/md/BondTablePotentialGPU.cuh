@@ -11,6 +11,7 @@
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/Index1D.h"
 #include "hoomd/HOOMDMath.h"
+#include "TableInterpolation.h"
 #include "hoomd/BondedGroupData.cuh"
 
 #ifndef __BONDTABLEPOTENTIALGPU_CUH__
@@ -25,6 +26,7 @@ hipError_t gpu_compute_bondtable_forces(Scalar4* d_force,
                                      const BoxDim &box,
                                      const group_storage<2> *blist,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_bonds_list,
                                      const unsigned int n_bond_type,
                                      const Scalar2 *d_tables,
@@ -32,6 +34,8 @@ hipError_t gpu_compute_bondtable_forces(Scalar4* d_force,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
                                      unsigned int *d_flags,
-                                     const unsigned int block_size);
+                                     const unsigned int block_size,
+                                     const bool hermite,
+                                     const bool stage_tables);
 
 #endif
@@ -28,7 +28,7 @@ using namespace std;
 ComputeThermo::ComputeThermo(std::shared_ptr<SystemDefinition> sysdef,
                              std::shared_ptr<ParticleGroup> group,
                              const std::string& suffix)
-    : Compute(sysdef), m_group(group), m_logging_enabled(true)
+    : Compute(sysdef), m_group(group), m_logging_enabled(true), m_hma_lattice_site(NULL)
     {
     m_exec_conf->msg->notice(5) << "Constructing ComputeThermo" << endl;
 
@@ -67,9 +67,38 @@ ComputeThermo::ComputeThermo(std::shared_ptr<SystemDefinition> sysdef,
 
     m_computed_flags.reset();
 
+    // nothing is computed until the first timestep, then everything is computed once
+    m_computed_parts = thermo_part::all;
+    m_used_parts = thermo_part::all;
+
     #ifdef ENABLE_MPI
-    m_properties_reduced = true;
+    m_unreduced_parts = 0;
     #endif
+
+    // compute() reduces the thermodynamic quantities over all ranks, the logger reads them directly
+    auto computed = [this](Scalar (ComputeThermo::*getter)())
+        {
+        return [this, getter](uint64_t timestep)
+            {
+            compute(timestep);
+            return double((this->*getter)());
+            };
+        };
+    m_log_registry.registerQuantity("kinetic_temperature", computed(&ComputeThermo::getTemperature));
+    m_log_registry.registerQuantity("pressure", computed(&ComputeThermo::getPressure));
+    m_log_registry.registerQuantity("kinetic_energy", computed(&ComputeThermo::getKineticEnergy));
+    m_log_registry.registerQuantity("translational_kinetic_energy",
+                                    computed(&ComputeThermo::getTranslationalKineticEnergy));
+    m_log_registry.registerQuantity("rotational_kinetic_energy",
+                                    computed(&ComputeThermo::getRotationalKineticEnergy));
+    m_log_registry.registerQuantity("potential_energy", computed(&ComputeThermo::getPotentialEnergy));
+
+    m_log_registry.registerQuantity("degrees_of_freedom",
+        [this](uint64_t timestep) { return getNDOF(); });
+    m_log_registry.registerQuantity("translational_degrees_of_freedom",
+        [this](uint64_t timestep) { return getTranslationalDOF(); });
+    m_log_registry.registerQuantity("rotational_degrees_of_freedom",
+        [this](uint64_t timestep) { return getRotationalDOF(); });
     }
 
 ComputeThermo::~ComputeThermo()
@@ -79,16 +108,51 @@ ComputeThermo::~ComputeThermo()
 
 /*! Calls computeProperties if the properties need updating
     \param timestep Current time step of the simulation
+
+    Only the properties that were requested since the last computation are computed now. The others are computed
+    by requireParts() when they are requested.
 */
 void ComputeThermo::compute(uint64_t timestep)
     {
     if (shouldCompute(timestep))
         {
-        computeProperties();
         m_computed_flags = m_pdata->getFlags();
+        m_computed_parts = 0;
+
+        const unsigned int parts = m_used_parts;
+        m_used_parts = 0;
+        computeParts(parts);
         }
     }
 
+/*! \param parts Bit flags of the thermo_part values to compute
+
+    The parts that the particle data flags of the last computation do not support are skipped, along with the parts
+    that were already computed.
+*/
+void ComputeThermo::computeParts(unsigned int parts)
+    {
+    if (!m_computed_flags[pdata_flag::rotational_kinetic_energy])
+        parts &= ~thermo_part::rotational_kinetic_energy;
+    if (!m_computed_flags[pdata_flag::pressure_tensor])
+        parts &= ~(thermo_part::pressure | thermo_part::pressure_tensor);
+    if (!m_hma_lattice_site)
+        parts &= ~thermo_part::hma;
+    parts &= ~m_computed_parts;
+
+    if (parts == 0)
+        return;
+
+    computeProperties(parts);
+    m_computed_parts |= parts;
+
+    #ifdef ENABLE_MPI
+    // in MPI, reduce extensive quantities only when they're needed
+    if (m_pdata->getDomainDecomposition())
+        m_unreduced_parts |= parts;
+    #endif // ENABLE_MPI
+    }
+
 std::vector< std::string > ComputeThermo::getProvidedLogQuantities()
     {
     if (m_logging_enabled)
@@ -183,9 +247,12 @@ Scalar ComputeThermo::getLogValue(const std::string& quantity, uint64_t timestep
         }
     }
 
-/*! Computes all thermodynamic properties of the system in one fell swoop.
+/*! \param parts Bit flags of the thermo_part values to compute
+
+    Computes the requested thermodynamic properties of the system in a single pass over the group. Only the
+    particle data needed by \a parts is read.
 */
-void ComputeThermo::computeProperties()
+void ComputeThermo::computeProperties(unsigned int parts)
     {
     // just drop out if the group is an empty group
     if (m_group->getNumMembersGlobal() == 0)
@@ -197,22 +264,38 @@ void ComputeThermo::computeProperties()
 
     assert(m_pdata);
 
+    const bool need_kinetic = parts & (thermo_part::translational_kinetic_energy
+                                       | thermo_part::pressure
+                                       | thermo_part::pressure_tensor);
+    const bool need_virial = parts & (thermo_part::pressure | thermo_part::pressure_tensor);
+    const bool need_rotational = parts & thermo_part::rotational_kinetic_energy;
+    const bool need_potential = parts & thermo_part::potential_energy;
+    const bool need_hma = parts & thermo_part::hma;
+
     // access the particle data
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
 
     // access the net force, pe, and virial
     const GlobalArray< Scalar4 >& net_force = m_pdata->getNetForce();
     const GlobalArray< Scalar >& net_virial = m_pdata->getNetVirial();
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::read);
+    size_t virial_pitch = net_virial.getPitch();
 
-    // total kinetic energy
-    double ke_trans_total = 0.0;
-
-    PDataFlags flags = m_pdata->getFlags();
+    // positions and lattice sites for the HMA sums
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+    std::unique_ptr< ArrayHandle<Scalar3> > h_lattice_site;
+    if (need_hma)
+        h_lattice_site.reset(new ArrayHandle<Scalar3>(*m_hma_lattice_site, access_location::host, access_mode::read));
+    const BoxDim& global_box = m_pdata->getGlobalBox();
 
+    // kinetic part of the pressure tensor
     double pressure_kinetic_xx = 0.0;
     double pressure_kinetic_xy = 0.0;
     double pressure_kinetic_xz = 0.0;
@@ -220,135 +303,106 @@ void ComputeThermo::computeProperties()
     double pressure_kinetic_yz = 0.0;
     double pressure_kinetic_zz = 0.0;
 
-    if (flags[pdata_flag::pressure_tensor])
-        {
-        // Calculate kinetic part of pressure tensor
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
-                {
-                double mass = h_vel.data[j].w;
-                pressure_kinetic_xx += mass*(  (double)h_vel.data[j].x * (double)h_vel.data[j].x );
-                pressure_kinetic_xy += mass*(  (double)h_vel.data[j].x * (double)h_vel.data[j].y );
-                pressure_kinetic_xz += mass*(  (double)h_vel.data[j].x * (double)h_vel.data[j].z );
-                pressure_kinetic_yy += mass*(  (double)h_vel.data[j].y * (double)h_vel.data[j].y );
-                pressure_kinetic_yz += mass*(  (double)h_vel.data[j].y * (double)h_vel.data[j].z );
-                pressure_kinetic_zz += mass*(  (double)h_vel.data[j].z * (double)h_vel.data[j].z );
-                }
-            }
-        // kinetic energy = 1/2 trace of kinetic part of pressure tensor
-        ke_trans_total = Scalar(0.5)*(pressure_kinetic_xx + pressure_kinetic_yy + pressure_kinetic_zz);
-        }
-    else
-        {
-        // total kinetic energy
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
-                {
-                ke_trans_total += (double)h_vel.data[j].w*( (double)h_vel.data[j].x * (double)h_vel.data[j].x
-                                                    + (double)h_vel.data[j].y * (double)h_vel.data[j].y
-                                                    + (double)h_vel.data[j].z * (double)h_vel.data[j].z);
-                }
-            }
-
-        ke_trans_total *= Scalar(0.5);
-        }
+    // upper triangular virial tensor
+    double virial_xx = m_pdata->getExternalVirial(0);
+    double virial_xy = m_pdata->getExternalVirial(1);
+    double virial_xz = m_pdata->getExternalVirial(2);
+    double virial_yy = m_pdata->getExternalVirial(3);
+    double virial_yz = m_pdata->getExternalVirial(4);
+    double virial_zz = m_pdata->getExternalVirial(5);
 
     // total rotational kinetic energy
     double ke_rot_total = 0.0;
 
-    if (flags[pdata_flag::rotational_kinetic_energy])
-        {
-        // Calculate rotational part of kinetic energy
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
-
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-            {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
-                {
-                Scalar3 I = h_inertia.data[j];
-                quat<Scalar> q(h_orientation.data[j]);
-                quat<Scalar> p(h_angmom.data[j]);
-                quat<Scalar> s(Scalar(0.5)*conj(q)*p);
-
-                // only if the moment of inertia along one principal axis is non-zero, that axis carries angular momentum
-                if (I.x >= EPSILON)
-                    {
-                    ke_rot_total += s.v.x*s.v.x/I.x;
-                    }
-                if (I.y >= EPSILON)
-                    {
-                    ke_rot_total += s.v.y*s.v.y/I.y;
-                    }
-                if (I.z >= EPSILON)
-                    {
-                    ke_rot_total += s.v.z*s.v.z/I.z;
-                    }
-                }
-            }
+    // total potential energy
+    double pe_total = m_pdata->getExternalEnergy();
 
-        ke_rot_total /= Scalar(2.0);
-        }
+    // HMA sums: potential energy, trace of the virial and forces times displacements from the lattice sites
+    double hma_pe_total = m_pdata->getExternalEnergy();
+    double hma_virial_trace = m_pdata->getExternalVirial(0) + m_pdata->getExternalVirial(3)
+                              + m_pdata->getExternalVirial(5);
+    double hma_fdr = 0.0;
 
-    // total potential energy
-    double pe_total = 0.0;
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
         unsigned int j = m_group->getMemberIndex(group_idx);
 
         // ignore rigid body constituent particles in the sum
-        if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+        if (!(h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j]))
+            continue;
+
+        if (need_kinetic)
             {
-            pe_total += (double)h_net_force.data[j].w;
+            double mass = h_vel.data[j].w;
+            pressure_kinetic_xx += mass*(  (double)h_vel.data[j].x * (double)h_vel.data[j].x );
+            pressure_kinetic_xy += mass*(  (double)h_vel.data[j].x * (double)h_vel.data[j].y );
+            pressure_kinetic_xz += mass*(  (double)h_vel.data[j].x * (double)h_vel.data[j].z );
+            pressure_kinetic_yy += mass*(  (double)h_vel.data[j].y * (double)h_vel.data[j].y );
+            pressure_kinetic_yz += mass*(  (double)h_vel.data[j].y * (double)h_vel.data[j].z );
+            pressure_kinetic_zz += mass*(  (double)h_vel.data[j].z * (double)h_vel.data[j].z );
             }
-        }
-
-    pe_total += m_pdata->getExternalEnergy();
 
-    double W = 0.0;
-    double virial_xx = m_pdata->getExternalVirial(0);
-    double virial_xy = m_pdata->getExternalVirial(1);
-    double virial_xz = m_pdata->getExternalVirial(2);
-    double virial_yy = m_pdata->getExternalVirial(3);
-    double virial_yz = m_pdata->getExternalVirial(4);
-    double virial_zz = m_pdata->getExternalVirial(5);
+        if (need_virial)
+            {
+            virial_xx += (double)h_net_virial.data[j+0*virial_pitch];
+            virial_xy += (double)h_net_virial.data[j+1*virial_pitch];
+            virial_xz += (double)h_net_virial.data[j+2*virial_pitch];
+            virial_yy += (double)h_net_virial.data[j+3*virial_pitch];
+            virial_yz += (double)h_net_virial.data[j+4*virial_pitch];
+            virial_zz += (double)h_net_virial.data[j+5*virial_pitch];
+            }
 
-    if (flags[pdata_flag::pressure_tensor])
-        {
-        // Calculate upper triangular virial tensor
-        size_t virial_pitch = net_virial.getPitch();
-        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        if (need_rotational)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
-            // ignore rigid body constituent particles in the sum
-            if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+            Scalar3 I = h_inertia.data[j];
+            quat<Scalar> q(h_orientation.data[j]);
+            quat<Scalar> p(h_angmom.data[j]);
+            quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+
+            // only if the moment of inertia along one principal axis is non-zero, that axis carries angular momentum
+            if (I.x >= EPSILON)
                 {
-                virial_xx += (double)h_net_virial.data[j+0*virial_pitch];
-                virial_xy += (double)h_net_virial.data[j+1*virial_pitch];
-                virial_xz += (double)h_net_virial.data[j+2*virial_pitch];
-                virial_yy += (double)h_net_virial.data[j+3*virial_pitch];
-                virial_yz += (double)h_net_virial.data[j+4*virial_pitch];
-                virial_zz += (double)h_net_virial.data[j+5*virial_pitch];
+                ke_rot_total += s.v.x*s.v.x/I.x;
                 }
+            if (I.y >= EPSILON)
+                {
+                ke_rot_total += s.v.y*s.v.y/I.y;
+                }
+            if (I.z >= EPSILON)
+                {
+                ke_rot_total += s.v.z*s.v.z/I.z;
+                }
+            }
+
+        if (need_potential)
+            {
+            pe_total += (double)h_net_force.data[j].w;
             }
 
-        // isotropic virial = 1/3 trace of virial tensor
-        W = Scalar(1./3.) * (virial_xx + virial_yy + virial_zz);
+        if (need_hma)
+            {
+            Scalar4 f = h_net_force.data[j];
+            hma_pe_total += (double)f.w;
+            hma_virial_trace += (double)h_net_virial.data[j+0*virial_pitch]
+                                + (double)h_net_virial.data[j+3*virial_pitch]
+                                + (double)h_net_virial.data[j+5*virial_pitch];
+
+            Scalar4 pos = h_pos.data[j];
+            Scalar3 dr = global_box.shift(make_scalar3(pos.x, pos.y, pos.z), h_image.data[j])
+                         - h_lattice_site->data[h_tag.data[j]];
+            hma_fdr += (double)f.x*dr.x + (double)f.y*dr.y + (double)f.z*dr.z;
+            }
         }
 
+    // kinetic energy = 1/2 trace of kinetic part of pressure tensor
+    double ke_trans_total = Scalar(0.5)*(pressure_kinetic_xx + pressure_kinetic_yy + pressure_kinetic_zz);
+    ke_rot_total /= Scalar(2.0);
+
+    // isotropic virial = 1/3 trace of virial tensor
+    double W = Scalar(1./3.) * (virial_xx + virial_yy + virial_zz);
+
     // compute the pressure
     // volume/area & other 2D stuff needed
-    BoxDim global_box = m_pdata->getGlobalBox();
-
     Scalar3 L = global_box.getL();
     Scalar volume;
     unsigned int D = m_sysdef->getNDimensions();
@@ -364,49 +418,87 @@ void ComputeThermo::computeProperties()
         volume = L.x * L.y * L.z;
         }
 
-    // pressure: P = (N * K_B * T + W)/V
-    Scalar pressure =  (2.0 * ke_trans_total / Scalar(D) + W) / volume;
-
-    // pressure tensor = (kinetic part + virial) / V
-    Scalar pressure_xx = (pressure_kinetic_xx + virial_xx) / volume;
-    Scalar pressure_xy = (pressure_kinetic_xy + virial_xy) / volume;
-    Scalar pressure_xz = (pressure_kinetic_xz + virial_xz) / volume;
-    Scalar pressure_yy = (pressure_kinetic_yy + virial_yy) / volume;
-    Scalar pressure_yz = (pressure_kinetic_yz + virial_yz) / volume;
-    Scalar pressure_zz = (pressure_kinetic_zz + virial_zz) / volume;
-
-    // fill out the GlobalArray
-    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::overwrite);
-    h_properties.data[thermo_index::translational_kinetic_energy] = Scalar(ke_trans_total);
-    h_properties.data[thermo_index::rotational_kinetic_energy] = Scalar(ke_rot_total);
-    h_properties.data[thermo_index::potential_energy] = Scalar(pe_total);
-    h_properties.data[thermo_index::pressure] = pressure;
-    h_properties.data[thermo_index::pressure_xx] = pressure_xx;
-    h_properties.data[thermo_index::pressure_xy] = pressure_xy;
-    h_properties.data[thermo_index::pressure_xz] = pressure_xz;
-    h_properties.data[thermo_index::pressure_yy] = pressure_yy;
-    h_properties.data[thermo_index::pressure_yz] = pressure_yz;
-    h_properties.data[thermo_index::pressure_zz] = pressure_zz;
-
-    #ifdef ENABLE_MPI
-    // in MPI, reduce extensive quantities only when they're needed
-    m_properties_reduced = !m_pdata->getDomainDecomposition();
-    #endif // ENABLE_MPI
+    // fill out the requested entries of the GlobalArray
+    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::readwrite);
+    if (parts & thermo_part::translational_kinetic_energy)
+        {
+        h_properties.data[thermo_index::translational_kinetic_energy] = Scalar(ke_trans_total);
+        }
+    if (parts & thermo_part::rotational_kinetic_energy)
+        {
+        h_properties.data[thermo_index::rotational_kinetic_energy] = Scalar(ke_rot_total);
+        }
+    if (parts & thermo_part::potential_energy)
+        {
+        h_properties.data[thermo_index::potential_energy] = Scalar(pe_total);
+        }
+    if (parts & thermo_part::pressure)
+        {
+        // pressure: P = (N * K_B * T + W)/V
+        h_properties.data[thermo_index::pressure] = (2.0 * ke_trans_total / Scalar(D) + W) / volume;
+        }
+    if (parts & thermo_part::pressure_tensor)
+        {
+        // pressure tensor = (kinetic part + virial) / V
+        h_properties.data[thermo_index::pressure_xx] = (pressure_kinetic_xx + virial_xx) / volume;
+        h_properties.data[thermo_index::pressure_xy] = (pressure_kinetic_xy + virial_xy) / volume;
+        h_properties.data[thermo_index::pressure_xz] = (pressure_kinetic_xz + virial_xz) / volume;
+        h_properties.data[thermo_index::pressure_yy] = (pressure_kinetic_yy + virial_yy) / volume;
+        h_properties.data[thermo_index::pressure_yz] = (pressure_kinetic_yz + virial_yz) / volume;
+        h_properties.data[thermo_index::pressure_zz] = (pressure_kinetic_zz + virial_zz) / volume;
+        }
+    if (parts & thermo_part::hma)
+        {
+        h_properties.data[thermo_index::hma_potential_energy] = Scalar(hma_pe_total);
+        h_properties.data[thermo_index::hma_virial] = Scalar(hma_virial_trace/D);
+        h_properties.data[thermo_index::hma_force_displacement] = Scalar(hma_fdr);
+        }
 
     if (m_prof) m_prof->pop();
     }
 
 #ifdef ENABLE_MPI
+/*! All of the parts that are not yet reduced are packed together and reduced in a single collective call.
+*/
 void ComputeThermo::reduceProperties()
     {
-    if (m_properties_reduced) return;
+    if (!m_unreduced_parts) return;
+
+    // the entries of m_properties that belong to each part
+    const unsigned int part_first[] = {thermo_index::translational_kinetic_energy,
+                                       thermo_index::rotational_kinetic_energy,
+                                       thermo_index::potential_energy,
+                                       thermo_index::pressure,
+                                       thermo_index::pressure_xx,
+                                       thermo_index::hma_potential_energy};
+    const unsigned int part_size[] = {1, 1, 1, 1, 6, 3};
+    const unsigned int n_parts = 6;
 
-    // reduce properties
     ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::readwrite);
-    MPI_Allreduce(MPI_IN_PLACE, h_properties.data, thermo_index::num_quantities, MPI_HOOMD_SCALAR,
-            MPI_SUM, m_exec_conf->getMPICommunicator());
 
-    m_properties_reduced = true;
+    // pack the unreduced entries
+    Scalar buffer[thermo_index::num_quantities];
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < n_parts; ++i)
+        {
+        if (!(m_unreduced_parts & (1 << i))) continue;
+        for (unsigned int k = 0; k < part_size[i]; ++k)
+            buffer[n++] = h_properties.data[part_first[i] + k];
+        }
+
+    // sum in rank order so that the result is reproducible
+    all_reduce_sum_ordered(buffer, n, m_exec_conf->getMPICommunicator());
+
+    // and unpack them again
+    n = 0;
+    for (unsigned int i = 0; i < n_parts; ++i)
+        {
+        if (!(m_unreduced_parts & (1 << i))) continue;
+        for (unsigned int k = 0; k < part_size[i]; ++k)
+            h_properties.data[part_first[i] + k] = buffer[n++];
+        }
+
+    m_unreduced_parts = 0;
     }
 #endif
 
@@ -48,6 +48,14 @@
     the user desires (the default is one!). In standard usage, the python interface queries the number of degrees
     of freedom from the integrators and sets that value for each ComputeThermo so that it is always correct.
 
+    The properties are evaluated lazily. compute() only computes the properties that were requested since the
+    previous timestep it computed, all in a single pass over the group. Any other property is computed the first
+    time that it is requested, so a consumer that only needs the kinetic energy never pays for the pressure tensor.
+
+    ComputeThermoHMA on the same group can share the pass of ComputeThermo (see ComputeThermoHMA::setThermo()). The
+    HMA sums are then the thermo_part::hma part, which is computed and reduced together with the other parts that
+    are requested on the same timestep.
+
     All quantities are made available for the logger. ComputerThermo can be given a suffix which it will append
     to each quantity provided to the logger. Typical usage is to provide _groupname as the suffix so that properties
     of different groups can be logged separately (e.g. temperature_group1 and temperature_group2).
@@ -73,9 +81,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
          */
         Scalar getTemperature()
         {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::translational_kinetic_energy | thermo_part::rotational_kinetic_energy);
             ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
             if (m_group->getTranslationalDOF() + m_group->getRotationalDOF() > 0)
                 {
@@ -94,9 +100,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         */
         Scalar getTranslationalTemperature()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::translational_kinetic_energy);
             ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
             if (m_group->getTranslationalDOF() > 0)
                 {
@@ -113,9 +117,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         */
         Scalar getRotationalTemperature()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::rotational_kinetic_energy);
             // return 0.0 if the flags are not valid or we have no rotational DOF
             if (m_computed_flags[pdata_flag::rotational_kinetic_energy] &&
                 m_group->getRotationalDOF() > 0)
@@ -138,9 +140,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
             if (m_computed_flags[pdata_flag::pressure_tensor])
                 {
                 // return the pressure
-                #ifdef ENABLE_MPI
-                if (!m_properties_reduced) reduceProperties();
-                #endif
+                requireParts(thermo_part::pressure);
 
                 ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
                 return h_properties.data[thermo_index::pressure];
@@ -156,9 +156,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         */
         Scalar getTranslationalKineticEnergy()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::translational_kinetic_energy);
 
             ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
             return h_properties.data[thermo_index::translational_kinetic_energy];
@@ -169,9 +167,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         */
         Scalar getRotationalKineticEnergy()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::rotational_kinetic_energy);
 
             // return 0.0 if the flags are not valid
             if (m_computed_flags[pdata_flag::rotational_kinetic_energy])
@@ -190,9 +186,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         */
         Scalar getKineticEnergy()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::translational_kinetic_energy | thermo_part::rotational_kinetic_energy);
 
             // return only translational component if the flags are not valid
             ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
@@ -212,9 +206,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         */
         Scalar getPotentialEnergy()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::potential_energy);
 
             ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
             return h_properties.data[thermo_index::potential_energy];
@@ -230,9 +222,7 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
             PressureTensor p;
             if (m_computed_flags[pdata_flag::pressure_tensor])
                 {
-                #ifdef ENABLE_MPI
-                if (!m_properties_reduced) reduceProperties();
-                #endif
+                requireParts(thermo_part::pressure_tensor);
 
                 ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
 
@@ -293,16 +283,65 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
             return m_group->getNumMembersGlobal();
             }
 
+        //! Get the group the properties are computed for
+        std::shared_ptr<ParticleGroup> getGroup()
+            {
+            return m_group;
+            }
+
+        //! Set the lattice sites for the sums of ComputeThermoHMA
+        /*! \param lattice_site Lattice site of every particle, indexed by tag, or NULL to stop computing the sums
+
+            The array is owned by the caller and must remain valid until it is unset.
+        */
+        void setHMALatticeSites(const GlobalArray<Scalar3> *lattice_site)
+            {
+            m_hma_lattice_site = lattice_site;
+            m_computed_parts &= ~thermo_part::hma;
+            }
+
+        //! Returns the sums of ComputeThermoHMA last computed by compute()
+        /*! \returns The potential energy in .x, the isotropic virial in .y and the sum of the forces times the
+                displacements from the lattice sites in .z, all summed over the whole group
+        */
+        Scalar3 getHMASums()
+            {
+            requireParts(thermo_part::hma);
+
+            ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
+            return make_scalar3(h_properties.data[thermo_index::hma_potential_energy],
+                                h_properties.data[thermo_index::hma_virial],
+                                h_properties.data[thermo_index::hma_force_displacement]);
+            }
+
         //! Get the gpu array of properties
         const GlobalArray<Scalar>& getProperties()
             {
-            #ifdef ENABLE_MPI
-            if (!m_properties_reduced) reduceProperties();
-            #endif
+            requireParts(thermo_part::all);
+
+            return m_properties;
+            }
+
+        //! Get the gpu array of properties with only the given parts computed
+        /*! \param parts Bit flags of the thermo_part values that are needed
+
+            Without domain decomposition the array is not accessed on the host, so it can be read on the device
+            without synchronizing. Parts that the flags of the last computation do not support (see
+            getComputedFlags()) are not updated.
+        */
+        const GlobalArray<Scalar>& getProperties(unsigned int parts)
+            {
+            requireParts(parts);
 
             return m_properties;
             }
 
+        //! Get the particle data flags used during the last computation
+        PDataFlags getComputedFlags() const
+            {
+            return m_computed_flags;
+            }
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -329,11 +368,32 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
         /// Store the particle data flags used during the last computation
         PDataFlags m_computed_flags;
 
+        unsigned int m_computed_parts;  //!< Bit flags of the thermo_part values computed for the last timestep
+        unsigned int m_used_parts;      //!< Bit flags of the thermo_part values requested since the last timestep
+        const GlobalArray<Scalar3> *m_hma_lattice_site; //!< Lattice sites for the HMA sums (NULL if not computed)
+
         //! Does the actual computation
-        virtual void computeProperties();
+        /*! \param parts Bit flags of the thermo_part values to compute
+
+            Only the entries of  parts are written to m_properties.
+        */
+        virtual void computeProperties(unsigned int parts);
+
+        //! Compute the properties of  parts that have not been computed for the last timestep
+        void computeParts(unsigned int parts);
+
+        //! Make sure that the properties of  parts are computed and reduced
+        void requireParts(unsigned int parts)
+            {
+            m_used_parts |= parts;
+            computeParts(parts);
+            #ifdef ENABLE_MPI
+            reduceProperties();
+            #endif
+            }
 
         #ifdef ENABLE_MPI
-        bool m_properties_reduced;      //!< True if properties have been reduced across MPI
+        unsigned int m_unreduced_parts; //!< Bit flags of the thermo_part values not yet reduced across MPI
 
         //! Reduce properties over MPI
         virtual void reduceProperties();
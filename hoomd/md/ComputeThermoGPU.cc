@@ -31,7 +31,7 @@ ComputeThermoGPU::ComputeThermoGPU(std::shared_ptr<SystemDefinition> sysdef,
                                    std::shared_ptr<ParticleGroup> group,
                                    const std::string& suffix)
     : ComputeThermo(sysdef, group, suffix), m_scratch(m_exec_conf), m_scratch_pressure_tensor(m_exec_conf),
-        m_scratch_rot(m_exec_conf)
+      m_scratch_hma(m_exec_conf)
     {
     if (!m_exec_conf->isCUDAEnabled())
         {
@@ -50,9 +50,11 @@ ComputeThermoGPU::~ComputeThermoGPU()
     hipEventDestroy(m_event);
     }
 
-/*! Computes all thermodynamic properties of the system in one fell swoop, on the GPU.
+/*! \param parts Bit flags of the thermo_part values to compute
+
+    Computes the requested thermodynamic properties of the system in one fell swoop, on the GPU.
  */
-void ComputeThermoGPU::computeProperties()
+void ComputeThermoGPU::computeProperties(unsigned int parts)
     {
     // just drop out if the group is an empty group
     if (m_group->getNumMembersGlobal() == 0)
@@ -72,7 +74,7 @@ void ComputeThermoGPU::computeProperties()
 
     m_scratch.resize(num_blocks);
     m_scratch_pressure_tensor.resize(num_blocks*6);
-    m_scratch_rot.resize(num_blocks);
+    m_scratch_hma.resize(num_blocks*3);
 
     if (m_scratch.size() != old_size)
         {
@@ -86,7 +88,7 @@ void ComputeThermoGPU::computeProperties()
                 {
                 cudaMemAdvise(m_scratch.get(), sizeof(Scalar4)*m_scratch.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
                 cudaMemAdvise(m_scratch_pressure_tensor.get(), sizeof(Scalar)*m_scratch_pressure_tensor.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
-                cudaMemAdvise(m_scratch_rot.get(), sizeof(Scalar)*m_scratch_rot.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+                cudaMemAdvise(m_scratch_hma.get(), sizeof(Scalar)*m_scratch_hma.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
                 }
             CHECK_CUDA_ERROR();
             }
@@ -95,20 +97,25 @@ void ComputeThermoGPU::computeProperties()
         // reset to zero, to be on the safe side
         ArrayHandle<Scalar4> d_scratch(m_scratch, access_location::device, access_mode::overwrite);
         ArrayHandle<Scalar> d_scratch_pressure_tensor(m_scratch_pressure_tensor, access_location::device, access_mode::overwrite);
-        ArrayHandle<Scalar> d_scratch_rot(m_scratch_rot, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_scratch_hma(m_scratch_hma, access_location::device, access_mode::overwrite);
 
         hipMemset(d_scratch.data, 0, sizeof(Scalar4)*m_scratch.size());
         hipMemset(d_scratch_pressure_tensor.data, 0, sizeof(Scalar)*m_scratch_pressure_tensor.size());
-        hipMemset(d_scratch_rot.data, 0, sizeof(Scalar)*m_scratch_rot.size());
+        hipMemset(d_scratch_hma.data, 0, sizeof(Scalar)*m_scratch_hma.size());
         }
 
     // access the particle data
     ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::read);
     BoxDim box = m_pdata->getGlobalBox();
 
-    PDataFlags flags = m_pdata->getFlags();
+    // lattice sites for the HMA sums
+    std::unique_ptr< ArrayHandle<Scalar3> > d_lattice_site;
+    if (parts & thermo_part::hma)
+        d_lattice_site.reset(new ArrayHandle<Scalar3>(*m_hma_lattice_site, access_location::device, access_mode::read));
 
     { // scope these array handles so they are released before the additional terms are added
     // access the net force, pe, and virial
@@ -121,8 +128,8 @@ void ComputeThermoGPU::computeProperties()
     ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_scratch(m_scratch, access_location::device, access_mode::overwrite);
     ArrayHandle<Scalar> d_scratch_pressure_tensor(m_scratch_pressure_tensor, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar> d_scratch_rot(m_scratch_rot, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar> d_properties(m_properties, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar> d_scratch_hma(m_scratch_hma, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar> d_properties(m_properties, access_location::device, access_mode::readwrite);
 
     // access the group
     ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
@@ -137,12 +144,15 @@ void ComputeThermoGPU::computeProperties()
     args.d_orientation = d_orientation.data;
     args.d_angmom = d_angmom.data;
     args.d_inertia = d_inertia.data;
+    args.d_pos = d_pos.data;
+    args.d_image = d_image.data;
+    args.d_lattice_site = d_lattice_site ? d_lattice_site->data : NULL;
     args.virial_pitch = net_virial.getPitch();
     args.ndof = m_group->getTranslationalDOF();
     args.D = m_sysdef->getNDimensions();
     args.d_scratch = d_scratch.data;
     args.d_scratch_pressure_tensor = d_scratch_pressure_tensor.data;
-    args.d_scratch_rot = d_scratch_rot.data;
+    args.d_scratch_hma = d_scratch_hma.data;
     args.block_size = m_block_size;
     args.external_virial_xx = m_pdata->getExternalVirial(0);
     args.external_virial_xy = m_pdata->getExternalVirial(1);
@@ -161,8 +171,7 @@ void ComputeThermoGPU::computeProperties()
                         group_size,
                         box,
                         args,
-                        flags[pdata_flag::pressure_tensor],
-                        flags[pdata_flag::rotational_kinetic_energy],
+                        parts,
                         m_group->getGPUPartition());
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
@@ -180,18 +189,12 @@ void ComputeThermoGPU::computeProperties()
                         group_size,
                         box,
                         args,
-                        flags[pdata_flag::pressure_tensor],
-                        flags[pdata_flag::rotational_kinetic_energy]);
+                        parts);
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     }
 
-    #ifdef ENABLE_MPI
-    // in MPI, reduce extensive quantities only when they're needed
-    m_properties_reduced = !m_pdata->getDomainDecomposition();
-    #endif // ENABLE_MPI
-
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
@@ -8,6 +8,7 @@
 #include "ComputeThermoGPU.cuh"
 #include "hoomd/VectorMath.h"
 #include "hoomd/HOOMDMath.h"
+#include "hoomd/WarpTools.cuh"
 
 #include <assert.h>
 
@@ -15,231 +16,135 @@
     \brief Defines GPU kernel code for computing thermodynamic properties on the GPU. Used by ComputeThermoGPU.
 */
 
-//! Perform partial sums of the thermo properties on the GPU
-/*! \param d_scratch Scratch space to hold partial sums. One element is written per block
-    \param d_net_force Net force / pe array from ParticleData
-    \param d_net_virial Net virial array from ParticleData
-    \param virial_pitch pitch of 2D virial array
-    \param d_velocity Particle velocity and mass array from ParticleData
-    \param d_body Particle body id
-    \param d_tag Particle tag
-    \param d_group_members List of group members for which to sum properties
-    \param work_size Number of particles in the group this GPU processes
-    \param offset Offset of this GPU in list of group members
-    \param block_offset Offset of this GPU in the array of partial sums
-
-    All partial sums are packaged up in a Scalar4 to keep pointer management down.
-     - 2*Kinetic energy is summed in .x
-     - Potential energy is summed in .y
-     - W is summed in .z
+//! Number of values summed per particle by the thermo kernels
+/*! The values are, in order:
+     - 2*Kinetic energy
+     - Potential energy
+     - W (isotropic virial)
+     - Rotational kinetic energy
+     - Six components of the kinetic part of the pressure tensor plus the virial (xx, xy, xz, yy, yz, zz)
+     - Potential energy, W and forces times displacements from the lattice sites for ComputeThermoHMA
 
-    One thread is executed per group member. That thread reads in the values for its member into shared memory
-    and then the block performs a reduction in parallel to produce a partial sum output for the block. These
-    partial sums are written to d_scratch[blockIdx.x]. sizeof(Scalar3)*block_size of dynamic shared memory are needed
-    for this kernel to run.
+    The last three are only summed when thermo_part::hma is requested.
 */
+const unsigned int thermo_num_sums = 13;
 
-__global__ void gpu_compute_thermo_partial_sums(Scalar4 *d_scratch,
-                                                Scalar4 *d_net_force,
-                                                Scalar *d_net_virial,
-                                                const size_t virial_pitch,
-                                                Scalar4 *d_velocity,
-                                                unsigned int *d_body,
-                                                unsigned int *d_tag,
-                                                unsigned int *d_group_members,
-                                                unsigned int work_size,
-                                                unsigned int offset,
-                                                unsigned int block_offset)
+//! Number of values summed per particle for \a parts
+__host__ __device__ inline unsigned int thermo_num_active_sums(unsigned int parts)
     {
-    extern __shared__ Scalar3 compute_thermo_sdata[];
+    return (parts & thermo_part::hma) ? thermo_num_sums : thermo_num_sums - 3;
+    }
 
-    // determine which particle this thread works on
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+//! Maximum number of warps in a block of \a block_size threads, for any supported warp size
+__host__ __device__ inline unsigned int thermo_max_warps(unsigned int block_size)
+    {
+    return block_size/32 + 1;
+    }
 
-    Scalar3 my_element; // element of scratch space read in
+//! Sum values over a thread block
+/*! \param values Values of this thread to sum, which are replaced with the sums of the block in thread 0
+    \param sdata Shared memory for thermo_num_sums values per warp
+    \param n Number of leading entries of \a values to sum
 
-    // non-participating thread: contribute 0 to the sum
-    my_element = make_scalar3(0, 0, 0);
+    The values are first summed within each warp using shuffles. The first thread of each warp writes the sums of
+    its warp to shared memory, and the first warp then sums those with shuffles again. The block size must be a
+    multiple of the warp size, and there cannot be more warps in the block than threads in a warp.
+*/
+__device__ inline void thermo_block_sum(Scalar (&values)[thermo_num_sums], Scalar *sdata, unsigned int n)
+    {
+    hoomd::detail::WarpReduce<Scalar> reducer;
+    const unsigned int lane = threadIdx.x % warpSize;
+    const unsigned int warp = threadIdx.x / warpSize;
+    const unsigned int num_warps = blockDim.x / warpSize;
 
-    if (group_idx < work_size)
+    for (unsigned int i = 0; i < n; i++)
         {
-        unsigned int idx = d_group_members[group_idx+offset];
-
-        // ignore rigid body constituent particles in the sum
-        unsigned int body = d_body[idx];
-        unsigned int tag = d_tag[idx];
-        if (body >= MIN_FLOPPY || body == tag)
-            {
-            // update positions to the next timestep and update velocities to the next half step
-            Scalar4 net_force = d_net_force[idx];
-            Scalar net_isotropic_virial;
-            // (1/3)*trace of virial tensor
-            net_isotropic_virial = Scalar(1.0/3.0)*
-                                   (d_net_virial[0*virial_pitch+idx]   // xx
-                                   +d_net_virial[3*virial_pitch+idx]   // yy
-                                   +d_net_virial[5*virial_pitch+idx]); // zz
-            Scalar4 vel = d_velocity[idx];
-            Scalar mass = vel.w;
-
-            // compute our contribution to the sum
-            my_element.x = mass * (vel.x*vel.x + vel.y*vel.y + vel.z*vel.z);
-            my_element.y = net_force.w;
-            my_element.z = net_isotropic_virial;
-            }
+        const Scalar warp_sum = reducer.Sum(values[i]);
+        if (lane == 0)
+            sdata[i*num_warps + warp] = warp_sum;
         }
-
-    compute_thermo_sdata[threadIdx.x] = my_element;
     __syncthreads();
 
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
+    if (warp == 0)
         {
-        if (threadIdx.x < offs)
+        for (unsigned int i = 0; i < n; i++)
             {
-            compute_thermo_sdata[threadIdx.x].x += compute_thermo_sdata[threadIdx.x + offs].x;
-            compute_thermo_sdata[threadIdx.x].y += compute_thermo_sdata[threadIdx.x + offs].y;
-            compute_thermo_sdata[threadIdx.x].z += compute_thermo_sdata[threadIdx.x + offs].z;
+            const Scalar warp_sum = (lane < num_warps) ? sdata[i*num_warps + lane] : Scalar(0.0);
+            values[i] = reducer.Sum(warp_sum);
             }
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        {
-        Scalar3 res = compute_thermo_sdata[0];
-        d_scratch[block_offset + blockIdx.x] = make_scalar4(res.x, res.y, res.z, 0);
         }
     }
 
-//! Perform partial sums of the pressure tensor on the GPU
+//! Perform partial sums of the thermo properties on the GPU
 /*! \param d_scratch Scratch space to hold partial sums. One element is written per block
+    \param d_scratch_pressure_tensor Scratch space to hold partial sums of the pressure tensor
+    \param d_scratch_hma Scratch space to hold partial sums for ComputeThermoHMA
+    \param box Box the particles are in
     \param d_net_force Net force / pe array from ParticleData
     \param d_net_virial Net virial array from ParticleData
     \param virial_pitch pitch of 2D virial array
     \param d_velocity Particle velocity and mass array from ParticleData
+    \param d_orientation Orientation quaternions from ParticleData
+    \param d_angmom Conjugate quaternions from ParticleData
+    \param d_inertia Moments of inertia from ParticleData
+    \param d_pos Particle positions from ParticleData
+    \param d_image Particle images from ParticleData
+    \param d_lattice_site Lattice site of every particle, by tag (only read for thermo_part::hma)
     \param d_body Particle body id
     \param d_tag Particle tag
     \param d_group_members List of group members for which to sum properties
-    \param work_size Number of particles in the group
-    \param offset Offset of this GPU in the list of group members
+    \param work_size Number of particles in the group this GPU processes
+    \param offset Offset of this GPU in list of group members
     \param block_offset Offset of this GPU in the array of partial sums
     \param num_blocks Total number of partial sums by all GPUs
+    \param parts Bit flags of the thermo_part values to compute
 
-    One thread is executed per group member. That thread reads in the six values (components of the pressure tensor)
-    for its member into shared memory and then the block performs a reduction in parallel to produce a partial sum output for the block.
-    These partial sums are written to d_scratch[i*gridDim.x + blockIdx.x], where i=0..5 is the index of the component.
-    For this kernel to run, 6*sizeof(Scalar)*block_size of dynamic shared memory are needed.
+    All scalar partial sums are packaged up in a Scalar4 to keep pointer management down.
+     - 2*Kinetic energy is summed in .x
+     - Potential energy is summed in .y
+     - W is summed in .z
+     - Rotational kinetic energy is summed in .w
+
+    One thread is executed per group member. That thread computes only the contributions of its member that are
+    needed by \a parts, and the block then reduces them with thermo_block_sum() to produce a partial sum output for
+    the block. These partial sums are written to d_scratch[blockIdx.x], and the pressure tensor partial sums to
+    d_scratch_pressure_tensor[i*num_blocks + blockIdx.x], where i=0..5 is the index of the component. The HMA sums
+    are written to d_scratch_hma[i*num_blocks + blockIdx.x] in the same way, with i=0..2.
+    thermo_num_sums*sizeof(Scalar)*thermo_max_warps(block_size) bytes of dynamic shared memory are needed for this
+    kernel to run.
 */
-
-__global__ void gpu_compute_pressure_tensor_partial_sums(Scalar *d_scratch,
-                                                Scalar4 *d_net_force,
-                                                Scalar *d_net_virial,
+__global__ void gpu_compute_thermo_partial_sums(Scalar4 *d_scratch,
+                                                Scalar *d_scratch_pressure_tensor,
+                                                Scalar *d_scratch_hma,
+                                                BoxDim box,
+                                                const Scalar4 *d_net_force,
+                                                const Scalar *d_net_virial,
                                                 const size_t virial_pitch,
-                                                Scalar4 *d_velocity,
-                                                unsigned int *d_body,
-                                                unsigned int *d_tag,
-                                                unsigned int *d_group_members,
+                                                const Scalar4 *d_velocity,
+                                                const Scalar4 *d_orientation,
+                                                const Scalar4 *d_angmom,
+                                                const Scalar3 *d_inertia,
+                                                const Scalar4 *d_pos,
+                                                const int3 *d_image,
+                                                const Scalar3 *d_lattice_site,
+                                                const unsigned int *d_body,
+                                                const unsigned int *d_tag,
+                                                const unsigned int *d_group_members,
                                                 unsigned int work_size,
                                                 unsigned int offset,
                                                 unsigned int block_offset,
-                                                unsigned int num_blocks)
+                                                unsigned int num_blocks,
+                                                unsigned int parts)
     {
-    extern __shared__ Scalar compute_pressure_tensor_sdata[];
+    extern __shared__ Scalar compute_thermo_sdata[];
 
     // determine which particle this thread works on
     int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
-    Scalar my_element[6]; // element of scratch space read in
-
     // non-participating threads: contribute 0 to the sum
-    my_element[0] = 0;
-    my_element[1] = 0;
-    my_element[2] = 0;
-    my_element[3] = 0;
-    my_element[4] = 0;
-    my_element[5] = 0;
-
-    if (group_idx < work_size)
-        {
-        unsigned int idx = d_group_members[group_idx+offset];
-
-        // ignore rigid body constituent particles in the sum
-        unsigned int body = d_body[idx];
-        unsigned int tag = d_tag[idx];
-        if (body >= MIN_FLOPPY || body == tag)
-            {
-            // compute contribution to pressure tensor and store it in my_element
-            Scalar4 vel = d_velocity[idx];
-            Scalar mass = vel.w;
-            my_element[0] = mass*vel.x*vel.x + d_net_virial[0*virial_pitch+idx];   // xx
-            my_element[1] = mass*vel.x*vel.y + d_net_virial[1*virial_pitch+idx];   // xy
-            my_element[2] = mass*vel.x*vel.z + d_net_virial[2*virial_pitch+idx];   // xz
-            my_element[3] = mass*vel.y*vel.y + d_net_virial[3*virial_pitch+idx];   // yy
-            my_element[4] = mass*vel.y*vel.z + d_net_virial[4*virial_pitch+idx];   // yz
-            my_element[5] = mass*vel.z*vel.z + d_net_virial[5*virial_pitch+idx];   // zz
-            }
-        }
-
-    for (unsigned int i = 0; i < 6; i++)
-        compute_pressure_tensor_sdata[i*blockDim.x+threadIdx.x] = my_element[i];
-
-    __syncthreads();
-
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            {
-            for (unsigned int i = 0; i < 6; i++)
-                compute_pressure_tensor_sdata[i*blockDim.x+threadIdx.x] += compute_pressure_tensor_sdata[i*blockDim.x + threadIdx.x + offs];
-            }
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        {
-        for (unsigned int i = 0; i < 6; i++)
-            d_scratch[num_blocks * i + blockIdx.x + block_offset] = compute_pressure_tensor_sdata[i*blockDim.x];
-        }
-    }
-
-//! Perform partial sums of the rotational KE on the GPU
-/*! \param d_scratch Scratch space to hold partial sums. One element is written per block
-    \param d_orientation Orientation quaternions from ParticleData
-    \param d_angmom Conjugate quaternions from ParticleData
-    \param d_inertia Moments of inertia from ParticleData
-    \param d_body Particle body id
-    \param d_tag Particle tag
-    \param d_group_members List of group members for which to sum properties
-    \param work_size Number of particles in the group processed by this GPU
-    \param offset Offset of this GPU in the list of group members
-    \param block_offset Output offset of this GPU
-*/
-
-__global__ void gpu_compute_rotational_ke_partial_sums(Scalar *d_scratch,
-                                                        const Scalar4 *d_orientation,
-                                                        const Scalar4 *d_angmom,
-                                                        const Scalar3 *d_inertia,
-                                                        unsigned int *d_body,
-                                                        unsigned int *d_tag,
-                                                        unsigned int *d_group_members,
-                                                        unsigned int work_size,
-                                                        unsigned int offset,
-                                                        unsigned int block_offset)
-    {
-    extern __shared__ Scalar compute_ke_rot_sdata[];
-
-    // determine which particle this thread works on
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar my_element; // element of scratch space read in
-    // non-participating thread: contribute 0 to the sum
-    my_element = Scalar(0.0);
+    Scalar my_element[thermo_num_sums];
+    for (unsigned int i = 0; i < thermo_num_sums; i++)
+        my_element[i] = Scalar(0.0);
 
     if (group_idx < work_size)
         {
@@ -250,132 +155,196 @@ __global__ void gpu_compute_rotational_ke_partial_sums(Scalar *d_scratch,
         unsigned int tag = d_tag[idx];
         if (body >= MIN_FLOPPY || body == tag)
             {
-            quat<Scalar> q(d_orientation[idx]);
-            quat<Scalar> p(d_angmom[idx]);
-            vec3<Scalar> I(d_inertia[idx]);
-            quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+            if (parts & (thermo_part::translational_kinetic_energy
+                         | thermo_part::pressure
+                         | thermo_part::pressure_tensor))
+                {
+                Scalar4 vel = d_velocity[idx];
+                Scalar mass = vel.w;
+                my_element[0] = mass * (vel.x*vel.x + vel.y*vel.y + vel.z*vel.z);
+                my_element[4] = mass*vel.x*vel.x;   // xx
+                my_element[5] = mass*vel.x*vel.y;   // xy
+                my_element[6] = mass*vel.x*vel.z;   // xz
+                my_element[7] = mass*vel.y*vel.y;   // yy
+                my_element[8] = mass*vel.y*vel.z;   // yz
+                my_element[9] = mass*vel.z*vel.z;   // zz
+                }
 
-            Scalar ke_rot(0.0);
+            if (parts & thermo_part::potential_energy)
+                {
+                my_element[1] = d_net_force[idx].w;
+                }
 
-            if (I.x >= EPSILON)
+            if (parts & thermo_part::pressure)
                 {
-                ke_rot += s.v.x*s.v.x/I.x;
+                // (1/3)*trace of virial tensor
+                my_element[2] = Scalar(1.0/3.0)*
+                                (d_net_virial[0*virial_pitch+idx]   // xx
+                                +d_net_virial[3*virial_pitch+idx]   // yy
+                                +d_net_virial[5*virial_pitch+idx]); // zz
                 }
-            if (I.y >= EPSILON)
+
+            if (parts & thermo_part::pressure_tensor)
                 {
-                ke_rot += s.v.y*s.v.y/I.y;
+                for (unsigned int i = 0; i < 6; i++)
+                    my_element[4+i] += d_net_virial[i*virial_pitch+idx];
                 }
-            if (I.z >= EPSILON)
+
+            if (parts & thermo_part::rotational_kinetic_energy)
                 {
-                ke_rot += s.v.z*s.v.z/I.z;
+                quat<Scalar> q(d_orientation[idx]);
+                quat<Scalar> p(d_angmom[idx]);
+                vec3<Scalar> I(d_inertia[idx]);
+                quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+
+                Scalar ke_rot(0.0);
+
+                if (I.x >= EPSILON)
+                    {
+                    ke_rot += s.v.x*s.v.x/I.x;
+                    }
+                if (I.y >= EPSILON)
+                    {
+                    ke_rot += s.v.y*s.v.y/I.y;
+                    }
+                if (I.z >= EPSILON)
+                    {
+                    ke_rot += s.v.z*s.v.z/I.z;
+                    }
+
+                // compute our contribution to the sum
+                my_element[3] = ke_rot*Scalar(1.0/2.0);
                 }
 
-            // compute our contribution to the sum
-            my_element = ke_rot*Scalar(1.0/2.0);
+            if (parts & thermo_part::hma)
+                {
+                Scalar4 net_force = d_net_force[idx];
+                Scalar4 pos = d_pos[idx];
+                Scalar3 dr = box.shift(make_scalar3(pos.x, pos.y, pos.z), d_image[idx]) - d_lattice_site[tag];
+
+                my_element[10] = net_force.w;
+                my_element[11] = Scalar(1.0/3.0)*
+                                 (d_net_virial[0*virial_pitch+idx]
+                                 +d_net_virial[3*virial_pitch+idx]
+                                 +d_net_virial[5*virial_pitch+idx]);
+                my_element[12] = net_force.x*dr.x + net_force.y*dr.y + net_force.z*dr.z;
+                }
             }
         }
 
-    compute_ke_rot_sdata[threadIdx.x] = my_element;
-    __syncthreads();
-
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            compute_ke_rot_sdata[threadIdx.x] += compute_ke_rot_sdata[threadIdx.x + offs];
-
-        offs >>= 1;
-        __syncthreads();
-        }
+    // reduce the sums over the block
+    thermo_block_sum(my_element, compute_thermo_sdata, thermo_num_active_sums(parts));
 
     // write out our partial sum
     if (threadIdx.x == 0)
         {
-        d_scratch[blockIdx.x + block_offset] = compute_ke_rot_sdata[0];
+        d_scratch[block_offset + blockIdx.x] = make_scalar4(my_element[0], my_element[1], my_element[2], my_element[3]);
+
+        if (parts & thermo_part::pressure_tensor)
+            {
+            for (unsigned int i = 0; i < 6; i++)
+                d_scratch_pressure_tensor[num_blocks * i + blockIdx.x + block_offset] = my_element[4+i];
+            }
+
+        if (parts & thermo_part::hma)
+            {
+            for (unsigned int i = 0; i < 3; i++)
+                d_scratch_hma[num_blocks * i + blockIdx.x + block_offset] = my_element[10+i];
+            }
         }
     }
 
-//! Complete partial sums and compute final thermodynamic quantities (for pressure, only isotropic contribution)
+//! Complete partial sums and compute final thermodynamic quantities
 /*! \param d_properties Property array to write final values
     \param d_scratch Partial sums
-    \param d_scratch_rot Partial sums of rotational kinetic energy
-    \param ndof Number of degrees of freedom this group possesses
+    \param d_scratch_pressure_tensor Partial sums of the pressure tensor
+    \param d_scratch_hma Partial sums for ComputeThermoHMA
     \param box Box the particles are in
     \param D Dimensionality of the system
-    \param group_size Number of particles in the group
     \param num_partial_sums Number of partial sums in \a d_scratch
-    \param external_virial External contribution to virial (1/3 trace)
+    \param external_virial_xx External contribution to virial (xx component)
+    \param external_virial_xy External contribution to virial (xy component)
+    \param external_virial_xz External contribution to virial (xz component)
+    \param external_virial_yy External contribution to virial (yy component)
+    \param external_virial_yz External contribution to virial (yz component)
+    \param external_virial_zz External contribution to virial (zz component)
     \param external_energy External contribution to potential energy
-
+    \param parts Bit flags of the thermo_part values to compute
 
     Only one block is executed. In that block, the partial sums are read in and reduced to final values. From the final
-    sums, the thermodynamic properties are computed and written to d_properties.
+    sums, the requested thermodynamic properties are computed and written to d_properties. The other entries of
+    d_properties are left unchanged.
 
-    sizeof(Scalar4)*block_size bytes of shared memory are needed for this kernel to run.
+    thermo_num_sums*sizeof(Scalar)*thermo_max_warps(block_size) bytes of shared memory are needed for this kernel to run.
 */
 __global__ void gpu_compute_thermo_final_sums(Scalar *d_properties,
-                                              Scalar4 *d_scratch,
-                                              Scalar *d_scratch_rot,
-                                              Scalar ndof,
+                                              const Scalar4 *d_scratch,
+                                              const Scalar *d_scratch_pressure_tensor,
+                                              const Scalar *d_scratch_hma,
                                               BoxDim box,
                                               unsigned int D,
-                                              unsigned int group_size,
                                               unsigned int num_partial_sums,
-                                              Scalar external_virial,
-                                              Scalar external_energy
-                                              )
+                                              Scalar external_virial_xx,
+                                              Scalar external_virial_xy,
+                                              Scalar external_virial_xz,
+                                              Scalar external_virial_yy,
+                                              Scalar external_virial_yz,
+                                              Scalar external_virial_zz,
+                                              Scalar external_energy,
+                                              unsigned int parts)
     {
-    extern __shared__ Scalar4 compute_thermo_final_sdata[];
+    extern __shared__ Scalar compute_thermo_final_sdata[];
 
-    Scalar4 final_sum = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0),Scalar(0.0));
+    Scalar final_sum[thermo_num_sums];
+    for (unsigned int i = 0; i < thermo_num_sums; i++)
+        final_sum[i] = Scalar(0.0);
 
     // sum up the values in the partial sum via a sliding window
     for (int start = 0; start < num_partial_sums; start += blockDim.x)
         {
-        __syncthreads();
+        Scalar my_element[thermo_num_sums];
+        for (unsigned int i = 0; i < thermo_num_sums; i++)
+            my_element[i] = Scalar(0.0);
+
         if (start + threadIdx.x < num_partial_sums)
             {
             Scalar4 scratch = d_scratch[start + threadIdx.x];
-            Scalar scratch_rot = d_scratch_rot[start + threadIdx.x];
+            my_element[0] = scratch.x;
+            my_element[1] = scratch.y;
+            my_element[2] = scratch.z;
+            my_element[3] = scratch.w;
 
-            compute_thermo_final_sdata[threadIdx.x] = make_scalar4(scratch.x, scratch.y, scratch.z, scratch_rot);
-            }
-        else
-            compute_thermo_final_sdata[threadIdx.x] = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
-        __syncthreads();
+            if (parts & thermo_part::pressure_tensor)
+                {
+                for (unsigned int i = 0; i < 6; i++)
+                    my_element[4+i] = d_scratch_pressure_tensor[i*num_partial_sums + start + threadIdx.x];
+                }
 
-        // reduce the sum in parallel
-        int offs = blockDim.x >> 1;
-        while (offs > 0)
-            {
-            if (threadIdx.x < offs)
+            if (parts & thermo_part::hma)
                 {
-                compute_thermo_final_sdata[threadIdx.x].x += compute_thermo_final_sdata[threadIdx.x + offs].x;
-                compute_thermo_final_sdata[threadIdx.x].y += compute_thermo_final_sdata[threadIdx.x + offs].y;
-                compute_thermo_final_sdata[threadIdx.x].z += compute_thermo_final_sdata[threadIdx.x + offs].z;
-                compute_thermo_final_sdata[threadIdx.x].w += compute_thermo_final_sdata[threadIdx.x + offs].w;
+                for (unsigned int i = 0; i < 3; i++)
+                    my_element[10+i] = d_scratch_hma[i*num_partial_sums + start + threadIdx.x];
                 }
-            offs >>= 1;
-            __syncthreads();
             }
 
+        // make sure that the shared memory is free from the previous window
+        __syncthreads();
+        thermo_block_sum(my_element, compute_thermo_final_sdata, thermo_num_active_sums(parts));
+
         if (threadIdx.x == 0)
             {
-            final_sum.x += compute_thermo_final_sdata[0].x;
-            final_sum.y += compute_thermo_final_sdata[0].y;
-            final_sum.z += compute_thermo_final_sdata[0].z;
-            final_sum.w += compute_thermo_final_sdata[0].w;
+            for (unsigned int i = 0; i < thermo_num_sums; i++)
+                final_sum[i] += my_element[i];
             }
         }
 
     if (threadIdx.x == 0)
         {
         // compute final quantities
-        Scalar ke_trans_total = final_sum.x * Scalar(0.5);
-        Scalar pe_total = final_sum.y + external_energy;
-        Scalar W = final_sum.z + external_virial;
-        Scalar ke_rot_total = final_sum.w;
+        Scalar ke_trans_total = final_sum[0] * Scalar(0.5);
+        Scalar pe_total = final_sum[1] + external_energy;
+        Scalar W = final_sum[2] + Scalar(1.0/3.0)*(external_virial_xx + external_virial_yy + external_virial_zz);
+        Scalar ke_rot_total = final_sum[3];
 
         // compute the pressure
         // volume/area & other 2D stuff needed
@@ -395,109 +364,46 @@ __global__ void gpu_compute_thermo_final_sums(Scalar *d_properties,
             volume = L.x * L.y * L.z;
             }
 
-        // pressure: P = (N * K_B * T + W)/V
-        Scalar pressure =  (Scalar(2.0) * ke_trans_total / Scalar(D) + W) / volume;
-
-        // fill out the GPUArray
-        d_properties[thermo_index::translational_kinetic_energy] = Scalar(ke_trans_total);
-        d_properties[thermo_index::rotational_kinetic_energy] = Scalar(ke_rot_total);
-        d_properties[thermo_index::potential_energy] = Scalar(pe_total);
-        d_properties[thermo_index::pressure] = pressure;
-        }
-    }
-
-//! Complete partial sums and compute final pressure tensor
-/*! \param d_properties Property array to write final values
-    \param d_scratch Partial sums
-    \param box Box the particles are in
-    \param group_size Number of particles in the group
-    \param num_partial_sums Number of partial sums in \a d_scratch
-
-    \param external_virial_xx External contribution to virial (xx component)
-    \param external_virial_xy External contribution to virial (xy component)
-    \param external_virial_xz External contribution to virial (xz component)
-    \param external_virial_yy External contribution to virial (yy component)
-    \param external_virial_yz External contribution to virial (yz component)
-    \param external_virial_zz External contribution to virial (zz component)
-
-    Only one block is executed. In that block, the partial sums are read in and reduced to final values. From the final
-    sums, the thermodynamic properties are computed and written to d_properties.
-
-    6*sizeof(Scalar)*block_size bytes of shared memory are needed for this kernel to run.
-*/
-__global__ void gpu_compute_pressure_tensor_final_sums(Scalar *d_properties,
-                                              Scalar *d_scratch,
-                                              BoxDim box,
-                                              unsigned int group_size,
-                                              unsigned int num_partial_sums,
-                                              Scalar external_virial_xx,
-                                              Scalar external_virial_xy,
-                                              Scalar external_virial_xz,
-                                              Scalar external_virial_yy,
-                                              Scalar external_virial_yz,
-                                              Scalar external_virial_zz,
-                                              bool twod)
-    {
-    extern __shared__ Scalar compute_pressure_tensor_sdata[];
-
-    Scalar final_sum[6];
-
-    final_sum[0] = external_virial_xx;
-    final_sum[1] = external_virial_xy;
-    final_sum[2] = external_virial_xz;
-    final_sum[3] = external_virial_yy;
-    final_sum[4] = external_virial_yz;
-    final_sum[5] = external_virial_zz;
-
-    // sum up the values in the partial sum via a sliding window
-    for (int start = 0; start < num_partial_sums; start += blockDim.x)
-        {
-        __syncthreads();
-        if (start + threadIdx.x < num_partial_sums)
+        // fill out the requested entries of the GPUArray
+        if (parts & thermo_part::translational_kinetic_energy)
+            d_properties[thermo_index::translational_kinetic_energy] = Scalar(ke_trans_total);
+        if (parts & thermo_part::rotational_kinetic_energy)
+            d_properties[thermo_index::rotational_kinetic_energy] = Scalar(ke_rot_total);
+        if (parts & thermo_part::potential_energy)
+            d_properties[thermo_index::potential_energy] = Scalar(pe_total);
+        if (parts & thermo_part::pressure)
             {
-            for (unsigned int i = 0; i < 6; i++)
-                compute_pressure_tensor_sdata[i * blockDim.x + threadIdx.x] = d_scratch[i*num_partial_sums + start + threadIdx.x];
+            // pressure: P = (N * K_B * T + W)/V
+            d_properties[thermo_index::pressure] = (Scalar(2.0) * ke_trans_total / Scalar(D) + W) / volume;
             }
-        else
-            for (unsigned int i = 0; i < 6; i++)
-                compute_pressure_tensor_sdata[i * blockDim.x + threadIdx.x] = Scalar(0.0);
-        __syncthreads();
 
-        // reduce the sum in parallel
-        int offs = blockDim.x >> 1;
-        while (offs > 0)
+        if (parts & thermo_part::pressure_tensor)
             {
-            if (threadIdx.x < offs)
-                {
-                for (unsigned int i = 0; i < 6; i++)
-                    compute_pressure_tensor_sdata[i*blockDim.x + threadIdx.x] += compute_pressure_tensor_sdata[i*blockDim.x + threadIdx.x + offs];
-                }
-            offs >>= 1;
-            __syncthreads();
+            // we have thus far calculated the sum of the kinetic part of the pressure tensor
+            // and the virial part, the definition includes an inverse factor of the box volume
+            Scalar V = box.getVolume(D == 2);
+
+            d_properties[thermo_index::pressure_xx] = (final_sum[4] + external_virial_xx)/V;
+            d_properties[thermo_index::pressure_xy] = (final_sum[5] + external_virial_xy)/V;
+            d_properties[thermo_index::pressure_xz] = (final_sum[6] + external_virial_xz)/V;
+            d_properties[thermo_index::pressure_yy] = (final_sum[7] + external_virial_yy)/V;
+            d_properties[thermo_index::pressure_yz] = (final_sum[8] + external_virial_yz)/V;
+            d_properties[thermo_index::pressure_zz] = (final_sum[9] + external_virial_zz)/V;
             }
 
-        if (threadIdx.x == 0)
+        if (parts & thermo_part::hma)
             {
-            for (unsigned int i = 0; i < 6; i++)
-                final_sum[i] += compute_pressure_tensor_sdata[i*blockDim.x];
-            }
-        }
+            Scalar W_hma = final_sum[11] + Scalar(1.0/3.0)*(external_virial_xx + external_virial_yy + external_virial_zz);
+            if (D == 2)
+                W_hma *= Scalar(3.0)/Scalar(2.0);
 
-    if (threadIdx.x == 0)
-        {
-        // fill out the GPUArray
-        // we have thus far calculated the sum of the kinetic part of the pressure tensor
-        // and the virial part, the definition includes an inverse factor of the box volume
-        Scalar V = box.getVolume(twod);
-
-        d_properties[thermo_index::pressure_xx] = final_sum[0]/V;
-        d_properties[thermo_index::pressure_xy] = final_sum[1]/V;
-        d_properties[thermo_index::pressure_xz] = final_sum[2]/V;
-        d_properties[thermo_index::pressure_yy] = final_sum[3]/V;
-        d_properties[thermo_index::pressure_yz] = final_sum[4]/V;
-        d_properties[thermo_index::pressure_zz] = final_sum[5]/V;
+            d_properties[thermo_index::hma_potential_energy] = final_sum[10] + external_energy;
+            d_properties[thermo_index::hma_virial] = W_hma;
+            d_properties[thermo_index::hma_force_displacement] = final_sum[12];
+            }
         }
     }
+
 //! Compute partial sums of thermodynamic properties of a group on the GPU,
 /*! \param d_properties Array to write computed properties
     \param d_vel particle velocities and masses on the GPU
@@ -507,11 +413,10 @@ __global__ void gpu_compute_pressure_tensor_final_sums(Scalar *d_properties,
     \param group_size Number of group members
     \param box Box the particles are in
     \param args Additional arguments
-    \param compute_pressure_tensor whether to compute the full pressure tensor
-    \param compute_rotational_energy whether to compute the rotational kinetic energy
+    \param parts Bit flags of the thermo_part values to compute
     \param gpu_partition Load balancing info for multi-GPU reduction
 
-    This function drives gpu_compute_thermo_partial_sums and gpu_compute_thermo_final_sums, see them for details.
+    This function drives gpu_compute_thermo_partial_sums, see it for details.
 */
 
 hipError_t gpu_compute_thermo_partial(Scalar *d_properties,
@@ -522,8 +427,7 @@ hipError_t gpu_compute_thermo_partial(Scalar *d_properties,
                                unsigned int group_size,
                                const BoxDim& box,
                                const compute_thermo_args& args,
-                               bool compute_pressure_tensor,
-                               bool compute_rotational_energy,
+                               unsigned int parts,
                                const GPUPartition& gpu_partition
                                )
     {
@@ -533,6 +437,8 @@ hipError_t gpu_compute_thermo_partial(Scalar *d_properties,
     assert(args.d_net_force);
     assert(args.d_net_virial);
     assert(args.d_scratch);
+    assert(args.d_scratch_pressure_tensor);
+    assert(!(parts & thermo_part::hma) || (args.d_scratch_hma && args.d_lattice_site));
 
     unsigned int block_offset = 0;
 
@@ -546,59 +452,30 @@ hipError_t gpu_compute_thermo_partial(Scalar *d_properties,
         dim3 grid(nwork/args.block_size+1, 1, 1);
         dim3 threads(args.block_size, 1, 1);
 
-        unsigned int shared_bytes = (unsigned int)(sizeof(Scalar3)*args.block_size);
+        unsigned int shared_bytes = (unsigned int)(thermo_num_sums*sizeof(Scalar)*thermo_max_warps(args.block_size));
 
         hipLaunchKernelGGL(gpu_compute_thermo_partial_sums, dim3(grid), dim3(threads), shared_bytes, 0, args.d_scratch,
+                                                                        args.d_scratch_pressure_tensor,
+                                                                        args.d_scratch_hma,
+                                                                        box,
                                                                         args.d_net_force,
                                                                         args.d_net_virial,
                                                                         args.virial_pitch,
                                                                         d_vel,
+                                                                        args.d_orientation,
+                                                                        args.d_angmom,
+                                                                        args.d_inertia,
+                                                                        args.d_pos,
+                                                                        args.d_image,
+                                                                        args.d_lattice_site,
                                                                         d_body,
                                                                         d_tag,
                                                                         d_group_members,
                                                                         nwork,
                                                                         range.first,
-                                                                        block_offset);
-
-        if (compute_pressure_tensor)
-            {
-            assert(args.d_scratch_pressure_tensor);
-
-            shared_bytes = (unsigned int)(6 * sizeof(Scalar) * args.block_size);
-
-            // run the kernel
-            hipLaunchKernelGGL(gpu_compute_pressure_tensor_partial_sums, dim3(grid), dim3(threads), shared_bytes, 0, args.d_scratch_pressure_tensor,
-                                                                                      args.d_net_force,
-                                                                                      args.d_net_virial,
-                                                                                      args.virial_pitch,
-                                                                                      d_vel,
-                                                                                      d_body,
-                                                                                      d_tag,
-                                                                                      d_group_members,
-                                                                                      nwork,
-                                                                                      range.first,
-                                                                                      block_offset,
-                                                                                      args.n_blocks);
-            }
-
-        if (compute_rotational_energy)
-            {
-            assert(args.d_scratch_pressure_tensor);
-
-            shared_bytes = (unsigned int)(sizeof(Scalar) * args.block_size);
-
-            // run the kernel
-            hipLaunchKernelGGL(gpu_compute_rotational_ke_partial_sums, dim3(grid), dim3(threads), shared_bytes, 0, args.d_scratch_rot,
-                                                   args.d_orientation,
-                                                   args.d_angmom,
-                                                   args.d_inertia,
-                                                   d_body,
-                                                   d_tag,
-                                                   d_group_members,
-                                                   nwork,
-                                                   range.first,
-                                                   block_offset);
-            }
+                                                                        block_offset,
+                                                                        args.n_blocks,
+                                                                        parts);
 
         block_offset += grid.x;
         }
@@ -617,11 +494,9 @@ hipError_t gpu_compute_thermo_partial(Scalar *d_properties,
     \param group_size Number of group members
     \param box Box the particles are in
     \param args Additional arguments
-    \param compute_pressure_tensor whether to compute the full pressure tensor
-    \param compute_rotational_energy whether to compute the rotational kinetic energy
-    \param num_blocks Number of partial sums to reduce
+    \param parts Bit flags of the thermo_part values to compute
 
-    This function drives gpu_compute_thermo_partial_sums and gpu_compute_thermo_final_sums, see them for details.
+    This function drives gpu_compute_thermo_final_sums, see it for details.
 */
 
 hipError_t gpu_compute_thermo_final(Scalar *d_properties,
@@ -632,8 +507,7 @@ hipError_t gpu_compute_thermo_final(Scalar *d_properties,
                                unsigned int group_size,
                                const BoxDim& box,
                                const compute_thermo_args& args,
-                               bool compute_pressure_tensor,
-                               bool compute_rotational_energy
+                               unsigned int parts
                                )
     {
     assert(d_properties);
@@ -643,47 +517,29 @@ hipError_t gpu_compute_thermo_final(Scalar *d_properties,
     assert(args.d_net_virial);
     assert(args.d_scratch);
 
-
     // setup the grid to run the final kernel
     int final_block_size = 256;
     dim3 grid = dim3(1, 1, 1);
     dim3 threads = dim3(final_block_size, 1, 1);
 
-    unsigned int shared_bytes = (unsigned int)(sizeof(Scalar4)*final_block_size);
-
-    Scalar external_virial = Scalar(1.0/3.0)*(args.external_virial_xx
-                             + args.external_virial_yy
-                             + args.external_virial_zz);
+    unsigned int shared_bytes = (unsigned int)(thermo_num_sums*sizeof(Scalar)*thermo_max_warps(final_block_size));
 
     // run the kernel
     hipLaunchKernelGGL(gpu_compute_thermo_final_sums, dim3(grid), dim3(threads), shared_bytes, 0, d_properties,
                                                                    args.d_scratch,
-                                                                   args.d_scratch_rot,
-                                                                   args.ndof,
+                                                                   args.d_scratch_pressure_tensor,
+                                                                   args.d_scratch_hma,
                                                                    box,
                                                                    args.D,
-                                                                   group_size,
                                                                    args.n_blocks,
-                                                                   external_virial,
-                                                                   args.external_energy);
-
-    if (compute_pressure_tensor)
-        {
-        shared_bytes = (unsigned int)(6 * sizeof(Scalar) * final_block_size);
-        // run the kernel
-        hipLaunchKernelGGL(gpu_compute_pressure_tensor_final_sums, dim3(grid), dim3(threads), shared_bytes, 0, d_properties,
-                                                                               args.d_scratch_pressure_tensor,
-                                                                               box,
-                                                                               group_size,
-                                                                               args.n_blocks,
-                                                                               args.external_virial_xx,
-                                                                               args.external_virial_xy,
-                                                                               args.external_virial_xz,
-                                                                               args.external_virial_yy,
-                                                                               args.external_virial_yz,
-                                                                               args.external_virial_zz,
-                                                                               args.D == 2);
-        }
+                                                                   args.external_virial_xx,
+                                                                   args.external_virial_xy,
+                                                                   args.external_virial_xz,
+                                                                   args.external_virial_yy,
+                                                                   args.external_virial_yz,
+                                                                   args.external_virial_zz,
+                                                                   args.external_energy,
+                                                                   parts);
 
     return hipSuccess;
     }
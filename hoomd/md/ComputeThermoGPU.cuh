@@ -24,12 +24,15 @@ struct compute_thermo_args
     Scalar4 *d_orientation;  //!< Particle data orientations
     Scalar4 *d_angmom;    //!< Particle data conjugate quaternions
     Scalar3 *d_inertia;      //!< Particle data moments of inertia
+    Scalar4 *d_pos;          //!< Particle data positions
+    int3 *d_image;           //!< Particle data images
+    Scalar3 *d_lattice_site; //!< Lattice sites for the HMA sums, by tag (NULL if not computed)
     size_t virial_pitch; //!< Pitch of 2D net_virial array
     Scalar ndof;      //!< Number of degrees of freedom for T calculation
     unsigned int D;         //!< Dimensionality of the system
     Scalar4 *d_scratch;      //!< n_blocks elements of scratch space for partial sums
     Scalar *d_scratch_pressure_tensor; //!< n_blocks*6 elements of scratch space for partial sums of the pressure tensor
-    Scalar *d_scratch_rot;      //!< Scratch space for rotational kinetic energy partial sums
+    Scalar *d_scratch_hma;   //!< n_blocks*3 elements of scratch space for partial sums of the HMA sums
     unsigned int block_size;    //!< Block size to execute on the GPU
     unsigned int n_blocks;      //!< Number of blocks to execute / n_blocks * block_size >= group_size
     Scalar external_virial_xx;  //!< xx component of the external virial
@@ -50,8 +53,7 @@ hipError_t gpu_compute_thermo_partial(Scalar *d_properties,
                                unsigned int group_size,
                                const BoxDim& box,
                                const compute_thermo_args& args,
-                               bool compute_pressure_tensor,
-                               bool compute_rotational_energy,
+                               unsigned int parts,
                                const GPUPartition& gpu_partition
                                );
 
@@ -64,8 +66,7 @@ hipError_t gpu_compute_thermo_final(Scalar *d_properties,
                                unsigned int group_size,
                                const BoxDim& box,
                                const compute_thermo_args& args,
-                               bool compute_pressure_tensor,
-                               bool compute_rotational_energy
+                               unsigned int parts
                                );
 
 #endif
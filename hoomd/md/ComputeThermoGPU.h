@@ -35,12 +35,12 @@ class PYBIND11_EXPORT ComputeThermoGPU : public ComputeThermo
     protected:
         GlobalVector<Scalar4> m_scratch;  //!< Scratch space for partial sums
         GlobalVector<Scalar> m_scratch_pressure_tensor; //!< Scratch space for pressure tensor partial sums
-        GlobalVector<Scalar> m_scratch_rot; //!< Scratch space for rotational kinetic energy partial sums
+        GlobalVector<Scalar> m_scratch_hma; //!< Scratch space for partial sums for ComputeThermoHMA
         unsigned int m_block_size;   //!< Block size executed
         hipEvent_t m_event;         //!< CUDA event for synchronization
 
         //! Does the actual computation
-        virtual void computeProperties();
+        virtual void computeProperties(unsigned int parts);
     };
 
 //! Exports the ComputeThermoGPU class to python
@@ -74,6 +74,31 @@ ComputeThermoHMA::ComputeThermoHMA(std::shared_ptr<SystemDefinition> sysdef,
 ComputeThermoHMA::~ComputeThermoHMA()
     {
     m_exec_conf->msg->notice(5) << "Destroying ComputeThermoHMA" << endl;
+
+    if (m_thermo)
+        m_thermo->setHMALatticeSites(NULL);
+    }
+
+/*! \param thermo ComputeThermo on the same group, or null to compute the sums in a separate pass
+
+    The lattice sites are handed to \a thermo, which adds the HMA sums to its pass over the group whenever they were
+    requested since its last computation.
+*/
+void ComputeThermoHMA::setThermo(std::shared_ptr<ComputeThermo> thermo)
+    {
+    if (thermo && thermo->getGroup() != m_group)
+        {
+        m_exec_conf->msg->error() << "compute.thermoHMA: The thermo compute must act on the same group" << endl;
+        throw runtime_error("Error setting thermo compute");
+        }
+
+    if (m_thermo)
+        m_thermo->setHMALatticeSites(NULL);
+
+    m_thermo = thermo;
+
+    if (m_thermo)
+        m_thermo->setHMALatticeSites(&m_lattice_site);
     }
 
 /*! Calls computeProperties if the properties need updating
@@ -84,7 +109,16 @@ void ComputeThermoHMA::compute(uint64_t timestep)
     if (!shouldCompute(timestep))
         return;
 
-    computeProperties();
+    if (m_thermo)
+        {
+        // bring the thermo compute to this timestep, its pass includes the HMA sums once they have been requested
+        m_thermo->compute(timestep);
+        computePropertiesFromThermo();
+        }
+    else
+        {
+        computeProperties();
+        }
     }
 
 std::vector< std::string > ComputeThermoHMA::getProvidedLogQuantities()
@@ -193,6 +227,34 @@ void ComputeThermoHMA::computeProperties()
     if (m_prof) m_prof->pop();
     }
 
+/*! The sums of m_thermo are already reduced over all ranks, so the properties are final.
+*/
+void ComputeThermoHMA::computePropertiesFromThermo()
+    {
+    // just drop out if the group is an empty group
+    unsigned int N = m_group->getNumMembersGlobal();
+    if (N == 0)
+        return;
+
+    Scalar3 sums = m_thermo->getHMASums();
+    Scalar pe = sums.x;
+    Scalar W = sums.y;
+    Scalar fdr = sums.z;
+
+    unsigned int D = m_sysdef->getNDimensions();
+    Scalar volume = m_pdata->getGlobalBox().getVolume(D == 2);
+    Scalar fV = (m_harmonicPressure/m_temperature - N/volume)/(D*(N-1));
+
+    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::overwrite);
+    h_properties.data[thermoHMA_index::potential_energyHMA] = pe + Scalar(1.5)*(N-1)*m_temperature
+                                                             + Scalar(0.5)*fdr;
+    h_properties.data[thermoHMA_index::pressureHMA] = m_harmonicPressure + W/volume + fV*fdr;
+
+    #ifdef ENABLE_MPI
+    m_properties_reduced = true;
+    #endif
+    }
+
 #ifdef ENABLE_MPI
 void ComputeThermoHMA::reduceProperties()
     {
@@ -200,8 +262,8 @@ void ComputeThermoHMA::reduceProperties()
 
     // reduce properties
     ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::readwrite);
-    MPI_Allreduce(MPI_IN_PLACE, h_properties.data, thermoHMA_index::num_quantities, MPI_HOOMD_SCALAR,
-            MPI_SUM, m_exec_conf->getMPICommunicator());
+    // sum in rank order so that the result is reproducible
+    all_reduce_sum_ordered(h_properties.data, thermoHMA_index::num_quantities, m_exec_conf->getMPICommunicator());
 
     m_properties_reduced = true;
     }
@@ -214,5 +276,6 @@ void export_ComputeThermoHMA(py::module& m)
     .def("getPotentialEnergyHMA", &ComputeThermoHMA::getPotentialEnergyHMA)
     .def("getPressureHMA", &ComputeThermoHMA::getPressureHMA)
     .def("setLoggingEnabled", &ComputeThermoHMA::setLoggingEnabled)
+    .def("setThermo", &ComputeThermoHMA::setThermo)
     ;
     }
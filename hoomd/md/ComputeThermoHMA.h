@@ -7,6 +7,7 @@
 #include "hoomd/Compute.h"
 #include "hoomd/GPUArray.h"
 #include "ComputeThermoHMATypes.h"
+#include "ComputeThermo.h"
 #include "hoomd/ParticleGroup.h"
 
 #include <memory>
@@ -39,6 +40,10 @@
     to each quantity provided to the logger. Typical usage is to provide _groupname as the suffix so that properties
     of different groups can be logged seperately (e.g. pressureHMA_group1 and pressureHMA_group2).
 
+    When a ComputeThermo on the same group is set with setThermo(), ComputeThermoHMA makes no pass of its own. The
+    HMA sums are computed in the pass of the ComputeThermo and reduced with its other properties, and only the
+    final HMA quantities are evaluated here.
+
     \ingroup computes
 */
 class PYBIND11_EXPORT ComputeThermoHMA : public Compute
@@ -123,15 +128,23 @@ class PYBIND11_EXPORT ComputeThermoHMA : public Compute
         //! Method to be called when particles are added/removed/sorted
         void slotParticleSort();
 
+        //! Compute the HMA sums in the pass of a ComputeThermo
+        void setThermo(std::shared_ptr<ComputeThermo> thermo);
+
     protected:
         std::shared_ptr<ParticleGroup> m_group;     //!< Group to compute properties for
         GPUArray<Scalar> m_properties;  //!< Stores the computed properties
         std::vector<std::string> m_logname_list;  //!< Cache all generated logged quantities names
         bool m_logging_enabled;         //!< Set to false to disable communication with the logger
 
+        std::shared_ptr<ComputeThermo> m_thermo;    //!< ComputeThermo that computes the sums (may be null)
+
         //! Does the actual computation
         virtual void computeProperties();
 
+        //! Compute the properties from the sums of m_thermo
+        void computePropertiesFromThermo();
+
         #ifdef ENABLE_MPI
         bool m_properties_reduced;      //!< True if properties have been reduced across MPI
 
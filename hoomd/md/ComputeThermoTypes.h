@@ -28,10 +28,29 @@ struct thermo_index
         pressure_yy,         //!< Index for the yy component of the pressure tensor in the GPUArray
         pressure_yz,         //!< Index for the yz component of the pressure tensor in the GPUArray
         pressure_zz,         //!< Index for the zz component of the pressure tensor in the GPUArray
+        hma_potential_energy,   //!< Potential energy summed for ComputeThermoHMA
+        hma_virial,             //!< Isotropic virial summed for ComputeThermoHMA
+        hma_force_displacement, //!< Sum of the forces times the displacements from the lattice sites
         num_quantities       // final element to count number of quantities
         };
     };
 
+//! Bit flags for the groups of properties that ComputeThermo evaluates separately
+struct thermo_part
+    {
+    //! The enum
+    enum Enum
+        {
+        translational_kinetic_energy = 1 << 0,  //!< Translational kinetic energy
+        rotational_kinetic_energy = 1 << 1,     //!< Rotational kinetic energy
+        potential_energy = 1 << 2,              //!< Potential energy
+        pressure = 1 << 3,                      //!< Total pressure
+        pressure_tensor = 1 << 4,               //!< All components of the pressure tensor
+        all = (1 << 5) - 1,                     //!< All properties
+        hma = 1 << 5                            //!< Sums for ComputeThermoHMA (only with lattice sites)
+        };
+    };
+
 //! structure for storing the components of the pressure tensor
 struct PressureTensor
     {
@@ -78,6 +78,7 @@ void CosineSqAngleForceComputeGPU::computeForces(uint64_t timestep)
     ArrayHandle<AngleData::members_t> d_gpu_anglelist(m_angle_data->getGPUTable(), access_location::device,access_mode::read);
     ArrayHandle<unsigned int> d_gpu_angle_pos_list(m_angle_data->getGPUPosTable(), access_location::device,access_mode::read);
     ArrayHandle<unsigned int> d_gpu_n_angles(m_angle_data->getNGroupsArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_table_offsets(m_angle_data->getGPUTableOffsets(), access_location::device, access_mode::read);
 
     // run the kernel on the GPU
     m_tuner->begin();
@@ -90,6 +91,7 @@ void CosineSqAngleForceComputeGPU::computeForces(uint64_t timestep)
                                       d_gpu_anglelist.data,
                                       d_gpu_angle_pos_list.data,
                                       m_angle_data->getGPUTableIndexer().getW(),
+                                      d_gpu_table_offsets.data,
                                       d_gpu_n_angles.data,
                                       d_params.data,
                                       m_angle_data->getNTypes(),
@@ -27,6 +27,7 @@
     \param box Box dimensions for periodic boundary condition handling
     \param alist Angle data to use in calculating the forces
     \param pitch Pitch of 2D angles list
+    \param table_offsets Index of the first entry of every particle in the angles list
     \param n_angles_list List of numbers of angles stored on the GPU
 */
 extern "C" __global__ void gpu_compute_cosinesq_angle_forces_kernel(Scalar4* d_force,
@@ -39,6 +40,7 @@ extern "C" __global__ void gpu_compute_cosinesq_angle_forces_kernel(Scalar4* d_f
                                                                     const group_storage<3> *alist,
                                                                     const unsigned int *apos_list,
                                                                     const unsigned int pitch,
+                                                                    const unsigned int *table_offsets,
                                                                     const unsigned int *n_angles_list)
     {
     // start by identifying which particle we are to handle
@@ -50,6 +52,9 @@ extern "C" __global__ void gpu_compute_cosinesq_angle_forces_kernel(Scalar4* d_f
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_angles = n_angles_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our b-particle from the a-b-c triplet. (MEM TRANSFER: 16 bytes)
     Scalar4 idx_postype = d_pos[idx];  // we can be either a, b, or c in the a-b-c triplet
     Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
@@ -68,13 +73,13 @@ extern "C" __global__ void gpu_compute_cosinesq_angle_forces_kernel(Scalar4* d_f
     // loop over all angles
     for (int angle_idx = 0; angle_idx < n_angles; angle_idx++)
         {
-        group_storage<3> cur_angle = alist[pitch*angle_idx + idx];
+        group_storage<3> cur_angle = alist[pitch*angle_idx + table_start];
 
         int cur_angle_x_idx = cur_angle.idx[0];
         int cur_angle_y_idx = cur_angle.idx[1];
         int cur_angle_type = cur_angle.idx[2];
 
-        int cur_angle_abc = apos_list[pitch*angle_idx + idx];
+        int cur_angle_abc = apos_list[pitch*angle_idx + table_start];
 
         // get the a-particle's position (MEM TRANSFER: 16 bytes)
         Scalar4 x_postype = d_pos[cur_angle_x_idx];
@@ -199,6 +204,7 @@ extern "C" __global__ void gpu_compute_cosinesq_angle_forces_kernel(Scalar4* d_f
     \param box Box dimensions (in GPU format) to use for periodic boundary conditions
     \param atable List of angles stored on the GPU
     \param pitch Pitch of 2D angles list
+    \param table_offsets Index of the first entry of every particle in the angles list
     \param n_angles_list List of numbers of angles stored on the GPU
     \param d_params K and t_0 params packed as Scalar2 variables
     \param n_angle_types Number of angle types in d_params
@@ -219,6 +225,7 @@ hipError_t gpu_compute_cosinesq_angle_forces(Scalar4* d_force,
                                               const group_storage<3> *atable,
                                               const unsigned int *apos_list,
                                               const unsigned int pitch,
+                                              const unsigned int *table_offsets,
                                               const unsigned int *n_angles_list,
                                               Scalar2 *d_params,
                                               unsigned int n_angle_types,
@@ -243,7 +250,7 @@ hipError_t gpu_compute_cosinesq_angle_forces(Scalar4* d_force,
     // run the kernel
     hipLaunchKernelGGL((gpu_compute_cosinesq_angle_forces_kernel), dim3(grid), dim3(threads), 0, 0,
             d_force, d_virial, virial_pitch, N, d_pos, d_params, box,
-            atable, apos_list, pitch, n_angles_list);
+            atable, apos_list, pitch, table_offsets, n_angles_list);
 
     return hipSuccess;
     }
@@ -25,6 +25,7 @@ hipError_t gpu_compute_cosinesq_angle_forces(Scalar4* d_force,
                                               const group_storage<3> *atable,
                                               const unsigned int *apos_list,
                                               const unsigned int pitch,
+                                              const unsigned int *table_offsets,
                                               const unsigned int *n_angles_list,
                                               Scalar2 *d_params,
                                               unsigned int n_angle_types,
@@ -95,6 +95,11 @@ class EvaluatorExternalElectricField
             }
 
         #ifndef __HIPCC__
+        //! Prepare the field for evaluation (nothing to do for this potential)
+        static void prepareField(field_type& field, const BoxDim& box, const param_type* params, unsigned int n_types)
+            {
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
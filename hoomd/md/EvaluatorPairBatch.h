@@ -0,0 +1,85 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __PAIR_EVALUATOR_BATCH_H__
+#define __PAIR_EVALUATOR_BATCH_H__
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file EvaluatorPairBatch.h
+    \brief Defines the batched pair evaluator interface used by PotentialPair on the CPU
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Batched evaluation of a pair potential on the CPU
+/*! PotentialPair gathers the neighbors of a particle in batches of \a width pairs into contiguous (struct of arrays)
+    buffers and calls evalForceAndEnergy() once per batch. The default implementation instantiates the scalar
+    evaluator for each pair in the batch, so every evaluator works unchanged with a batch width of 1.
+
+    Evaluators that are simple enough to be vectorized specialize this template (next to the evaluator class) with a
+    larger \a width and a branch-free loop over the batch that the compiler can map onto SIMD instructions (SSE, AVX2,
+    AVX-512). Specializations must produce the same results as the scalar evaluator, with \a force_divr and
+    \a pair_eng set to 0 and \a evaluated set to false for pairs that are not evaluated.
+
+    \tparam evaluator Scalar pair evaluator class (see EvaluatorPairLJ)
+*/
+template<class evaluator>
+struct PairEvaluatorBatch
+    {
+    typedef typename evaluator::param_type param_type;
+
+    //! Number of pairs evaluated per call
+    static const unsigned int width = 1;
+
+    //! Evaluate the force and energy for a batch of pairs
+    /*! \param n Number of pairs in the batch (n <= width)
+        \param rsq Squared distance between the particles of each pair
+        \param rcutsq Squared cutoff radius of each pair
+        \param params Per type pair parameters of the potential
+        \param typpair Index into \a params of each pair
+        \param di Diameter of particle i
+        \param dj Diameter of particle j of each pair
+        \param qi Charge of particle i
+        \param qj Charge of particle j of each pair
+        \param energy_shift Whether to shift the energy of each pair to 0 at the cutoff
+        \param force_divr Output force divided by r of each pair
+        \param pair_eng Output pair energy of each pair
+        \param evaluated Output flag set when the pair is evaluated
+    */
+    static inline void evalForceAndEnergy(unsigned int n,
+                                          const Scalar *rsq,
+                                          const Scalar *rcutsq,
+                                          const param_type *params,
+                                          const unsigned int *typpair,
+                                          Scalar di,
+                                          const Scalar *dj,
+                                          Scalar qi,
+                                          const Scalar *qj,
+                                          const bool *energy_shift,
+                                          Scalar *force_divr,
+                                          Scalar *pair_eng,
+                                          bool *evaluated)
+        {
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            force_divr[k] = Scalar(0.0);
+            pair_eng[k] = Scalar(0.0);
+
+            evaluator eval(rsq[k], rcutsq[k], params[typpair[k]]);
+            if (evaluator::needsDiameter())
+                eval.setDiameter(di, dj[k]);
+            if (evaluator::needsCharge())
+                eval.setCharge(qi, qj[k]);
+
+            evaluated[k] = eval.evalForceAndEnergy(force_divr[k], pair_eng[k], energy_shift[k]);
+            }
+        }
+    };
+
+#endif // __PAIR_EVALUATOR_BATCH_H__
@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef __HIPCC__
+#include "EvaluatorPairBatch.h"
+#endif
+
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
@@ -301,4 +305,51 @@ class EvaluatorPairDPDThermo
 
 #undef DEVICE
 
+#ifndef __HIPCC__
+//! Batched evaluation of the conservative DPD potential
+/*! The loop over the batch is free of branches so that the compiler can vectorize it. See PairEvaluatorBatch.
+*/
+template<>
+struct PairEvaluatorBatch<EvaluatorPairDPDThermo>
+    {
+    typedef EvaluatorPairDPDThermo::param_type param_type;
+
+    //! Number of pairs evaluated per call
+    static const unsigned int width = 16;
+
+    //! Evaluate the force and energy for a batch of pairs
+    static inline void evalForceAndEnergy(unsigned int n,
+                                          const Scalar *rsq,
+                                          const Scalar *rcutsq,
+                                          const param_type *params,
+                                          const unsigned int *typpair,
+                                          Scalar di,
+                                          const Scalar *dj,
+                                          Scalar qi,
+                                          const Scalar *qj,
+                                          const bool *energy_shift,
+                                          Scalar *force_divr,
+                                          Scalar *pair_eng,
+                                          bool *evaluated)
+        {
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar a = params[typpair[k]].A;
+            const bool active = rsq[k] < rcutsq[k];
+
+            Scalar rinv = fast::rsqrt(rsq[k]);
+            Scalar r = Scalar(1.0) / rinv;
+            Scalar rcutinv = fast::rsqrt(rcutsq[k]);
+            Scalar rcut = Scalar(1.0) / rcutinv;
+
+            // energy_shift is ignored, DPD always goes to 0 at the cutoff
+            force_divr[k] = active ? a*(rinv - rcutinv) : Scalar(0.0);
+            pair_eng[k] = active ? a * (rcut - r) - Scalar(1.0/2.0) * a * rcutinv * (rcutsq[k] - rsq[k])
+                                 : Scalar(0.0);
+            evaluated[k] = active;
+            }
+        }
+    };
+#endif
+
 #endif // __PAIR_EVALUATOR_DPD_H__
@@ -121,24 +121,35 @@ class EvaluatorPairDipole
             #endif
             };
 
+        //! Compute the lab frame quantities of a particle that the evaluator takes in place of its orientation
+        /*! \param q Orientation quaternion of the particle
+            \param shape Shape of the particle
+            \returns The dipole moment of the particle in the lab frame (xyz)
+        */
+        HOSTDEVICE static Scalar4 labFrame(const Scalar4& q, const shape_type& shape)
+            {
+            vec3<Scalar> p = rotate(quat<Scalar>(q), shape.mu);
+            return make_scalar4(p.x, p.y, p.z, Scalar(0.0));
+            }
+
         //! Constructs the pair potential evaluator
         /*! \param _dr Displacement vector between particle centers of mass
             \param _rcutsq Squared distance at which the potential goes to 0
-            \param _quat_i Quaternion of i^{th} particle
-            \param _quat_j Quaternion of j^{th} particle
+            \param _p_i Lab frame quantities of i^{th} particle (see labFrame)
+            \param _p_j Lab frame quantities of j^{th} particle (see labFrame)
             \param _A Electrostatic energy scale
             \param _kappa Inverse screening length
             \param _params Per type pair parameters of this potential
         */
         HOSTDEVICE EvaluatorPairDipole(
-            Scalar3& _dr, Scalar4& _quat_i, Scalar4& _quat_j,
+            Scalar3& _dr, Scalar4& _p_i, Scalar4& _p_j,
             Scalar _rcutsq, const param_type& _params)
             :dr(_dr),
              rcutsq(_rcutsq),
              q_i(0),
              q_j(0),
-             quat_i(_quat_i),
-             quat_j(_quat_j),
+             p_i(_p_i.x, _p_i.y, _p_i.z),
+             p_j(_p_j.x, _p_j.y, _p_j.z),
              mu_i{0, 0, 0},
              mu_j{0, 0, 0},
              A(_params.A),
@@ -233,11 +244,6 @@ class EvaluatorPairDipole
             Scalar r3inv = r2inv*rinv;
             Scalar r5inv = r3inv*r2inv;
 
-            // convert dipole vector in the body frame of each particle to space
-            // frame
-            vec3<Scalar> p_i = rotate(quat<Scalar>(quat_i), mu_i);
-            vec3<Scalar> p_j = rotate(quat<Scalar>(quat_j), mu_j);
-
             vec3<Scalar> f;
             vec3<Scalar> t_i;
             vec3<Scalar> t_j;
@@ -339,7 +345,7 @@ class EvaluatorPairDipole
         Scalar3 dr;                 //!< Stored vector pointing between particle centers of mass
         Scalar rcutsq;              //!< Stored rcutsq from the constructor
         Scalar q_i, q_j;            //!< Stored particle charges
-        Scalar4 quat_i,quat_j;      //!< Stored quaternion of ith and jth particle from constructor
+        vec3<Scalar> p_i, p_j;      //!< Dipole moments of ith and jth particle in the lab frame
         vec3<Scalar> mu_i;                /// Magnetic moment for ith particle
         vec3<Scalar> mu_j;                /// Magnetic moment for jth particle
         Scalar A;
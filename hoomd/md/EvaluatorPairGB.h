@@ -115,19 +115,30 @@ class EvaluatorPairGB
             #endif
             };
 
+        //! Compute the lab frame quantities of a particle that the evaluator takes in place of its orientation
+        /*! \param q Orientation quaternion of the particle
+            \param shape Shape of the particle
+            \returns The long axis of the particle in the lab frame (xyz)
+        */
+        HOSTDEVICE static Scalar4 labFrame(const Scalar4& q, const shape_type& shape)
+            {
+            vec3<Scalar> a = rotate(quat<Scalar>(q), vec3<Scalar>(0, 0, 1));
+            return make_scalar4(a.x, a.y, a.z, Scalar(0.0));
+            }
+
         //! Constructs the pair potential evaluator
         /*! \param _dr Displacement vector between particle centers of mass
             \param _rcutsq Squared distance at which the potential goes to 0
-            \param _q_i Quaternion of i^th particle
-            \param _q_j Quaternion of j^th particle
+            \param _a_i Lab frame quantities of i^th particle (see labFrame)
+            \param _a_j Lab frame quantities of j^th particle (see labFrame)
             \param _params Per type pair parameters of this potential
         */
         HOSTDEVICE EvaluatorPairGB(const Scalar3& _dr,
-                               const Scalar4& _qi,
-                               const Scalar4& _qj,
+                               const Scalar4& _a_i,
+                               const Scalar4& _a_j,
                                const Scalar _rcutsq,
                                const param_type& _params)
-            : dr(_dr),rcutsq(_rcutsq),qi(_qi),qj(_qj),
+            : dr(_dr),rcutsq(_rcutsq),a3(_a_i.x, _a_i.y, _a_i.z),b3(_a_j.x, _a_j.y, _a_j.z),
               epsilon(_params.epsilon), lperp(_params.lperp), lpar(_params.lpar)
             {
             }
@@ -200,14 +211,6 @@ class EvaluatorPairGB
             Scalar r = fast::sqrt(rsq);
             vec3<Scalar> unitr = fast::rsqrt(dot(dr,dr))*dr;
 
-            // obtain rotation matrices (space->body)
-            rotmat3<Scalar> rotA(conj(qi));
-            rotmat3<Scalar> rotB(conj(qj));
-
-            // last row of rotation matrix
-            vec3<Scalar> a3 = rotA.row2;
-            vec3<Scalar> b3 = rotB.row2;
-
             Scalar ca = dot(a3,unitr);
             Scalar cb = dot(b3,unitr);
             Scalar cab = dot(a3,b3);
@@ -295,8 +298,8 @@ class EvaluatorPairGB
     protected:
         vec3<Scalar> dr;   //!< Stored dr from the constructor
         Scalar rcutsq;     //!< Stored rcutsq from the constructor
-        quat<Scalar> qi;   //!< Orientation quaternion for particle i
-        quat<Scalar> qj;   //!< Orientation quaternion for particle j
+        vec3<Scalar> a3;   //!< Long axis of particle i in the lab frame
+        vec3<Scalar> b3;   //!< Long axis of particle j in the lab frame
         Scalar epsilon;
         Scalar lperp;
         Scalar lpar;
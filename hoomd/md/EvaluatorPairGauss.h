@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef __HIPCC__
+#include "EvaluatorPairBatch.h"
+#endif
+
 /*! \file EvaluatorPairGauss.h
     \brief Defines the pair evaluator class for Gaussian potentials
 */
@@ -174,4 +178,51 @@ class EvaluatorPairGauss
     };
 
 
+#ifndef __HIPCC__
+//! Batched evaluation of the Gaussian potential
+/*! The loop over the batch is free of branches so that the compiler can vectorize it. See PairEvaluatorBatch.
+*/
+template<>
+struct PairEvaluatorBatch<EvaluatorPairGauss>
+    {
+    typedef EvaluatorPairGauss::param_type param_type;
+
+    //! Number of pairs evaluated per call
+    static const unsigned int width = 16;
+
+    //! Evaluate the force and energy for a batch of pairs
+    static inline void evalForceAndEnergy(unsigned int n,
+                                          const Scalar *rsq,
+                                          const Scalar *rcutsq,
+                                          const param_type *params,
+                                          const unsigned int *typpair,
+                                          Scalar di,
+                                          const Scalar *dj,
+                                          Scalar qi,
+                                          const Scalar *qj,
+                                          const bool *energy_shift,
+                                          Scalar *force_divr,
+                                          Scalar *pair_eng,
+                                          bool *evaluated)
+        {
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar epsilon = params[typpair[k]].epsilon;
+            const Scalar sigma = params[typpair[k]].sigma;
+            const bool active = rsq[k] < rcutsq[k];
+
+            Scalar sigma_sq = sigma*sigma;
+            Scalar r_over_sigma_sq = rsq[k] / sigma_sq;
+            Scalar exp_val = fast::exp(-Scalar(1.0)/Scalar(2.0) * r_over_sigma_sq);
+            Scalar shift = energy_shift[k] ? epsilon * fast::exp(-Scalar(1.0)/Scalar(2.0) * rcutsq[k] / sigma_sq)
+                                           : Scalar(0.0);
+
+            force_divr[k] = active ? epsilon / sigma_sq * exp_val : Scalar(0.0);
+            pair_eng[k] = active ? epsilon * exp_val - shift : Scalar(0.0);
+            evaluated[k] = active;
+            }
+        }
+    };
+#endif
+
 #endif // __PAIR_EVALUATOR_GAUSS_H__
@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef __HIPCC__
+#include "EvaluatorPairBatch.h"
+#endif
+
 /*! \file EvaluatorPairLJ.h
     \brief Defines the pair evaluator class for LJ potentials
     \details As the prototypical example of a MD pair potential, this also serves as the primary documentation and
@@ -230,4 +234,51 @@ class EvaluatorPairLJ
     };
 
 
+#ifndef __HIPCC__
+//! Batched evaluation of the LJ potential
+/*! The loop over the batch is free of branches so that the compiler can vectorize it. See PairEvaluatorBatch.
+*/
+template<>
+struct PairEvaluatorBatch<EvaluatorPairLJ>
+    {
+    typedef EvaluatorPairLJ::param_type param_type;
+
+    //! Number of pairs evaluated per call
+    static const unsigned int width = 16;
+
+    //! Evaluate the force and energy for a batch of pairs
+    static inline void evalForceAndEnergy(unsigned int n,
+                                          const Scalar *rsq,
+                                          const Scalar *rcutsq,
+                                          const param_type *params,
+                                          const unsigned int *typpair,
+                                          Scalar di,
+                                          const Scalar *dj,
+                                          Scalar qi,
+                                          const Scalar *qj,
+                                          const bool *energy_shift,
+                                          Scalar *force_divr,
+                                          Scalar *pair_eng,
+                                          bool *evaluated)
+        {
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar lj1 = params[typpair[k]].lj1;
+            const Scalar lj2 = params[typpair[k]].lj2;
+            const bool active = rsq[k] < rcutsq[k] && lj1 != Scalar(0.0);
+
+            Scalar r2inv = Scalar(1.0)/rsq[k];
+            Scalar r6inv = r2inv * r2inv * r2inv;
+            Scalar rcut2inv = Scalar(1.0)/rcutsq[k];
+            Scalar rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+            Scalar shift = energy_shift[k] ? rcut6inv * (lj1*rcut6inv - lj2) : Scalar(0.0);
+
+            force_divr[k] = active ? r2inv * r6inv * (Scalar(12.0)*lj1*r6inv - Scalar(6.0)*lj2) : Scalar(0.0);
+            pair_eng[k] = active ? r6inv * (lj1*r6inv - lj2) - shift : Scalar(0.0);
+            evaluated[k] = active;
+            }
+        }
+    };
+#endif
+
 #endif // __PAIR_EVALUATOR_LJ_H__
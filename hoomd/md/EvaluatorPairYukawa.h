@@ -13,6 +13,10 @@
 
 #include "hoomd/HOOMDMath.h"
 
+#ifndef __HIPCC__
+#include "EvaluatorPairBatch.h"
+#endif
+
 /*! \file EvaluatorPairYukawa.h
     \brief Defines the pair evaluator class for Yukawa potentials
 */
@@ -177,4 +181,54 @@ class EvaluatorPairYukawa
     };
 
 
+#ifndef __HIPCC__
+//! Batched evaluation of the Yukawa potential
+/*! The loop over the batch is free of branches so that the compiler can vectorize it. See PairEvaluatorBatch.
+*/
+template<>
+struct PairEvaluatorBatch<EvaluatorPairYukawa>
+    {
+    typedef EvaluatorPairYukawa::param_type param_type;
+
+    //! Number of pairs evaluated per call
+    static const unsigned int width = 16;
+
+    //! Evaluate the force and energy for a batch of pairs
+    static inline void evalForceAndEnergy(unsigned int n,
+                                          const Scalar *rsq,
+                                          const Scalar *rcutsq,
+                                          const param_type *params,
+                                          const unsigned int *typpair,
+                                          Scalar di,
+                                          const Scalar *dj,
+                                          Scalar qi,
+                                          const Scalar *qj,
+                                          const bool *energy_shift,
+                                          Scalar *force_divr,
+                                          Scalar *pair_eng,
+                                          bool *evaluated)
+        {
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar epsilon = params[typpair[k]].epsilon;
+            const Scalar kappa = params[typpair[k]].kappa;
+            const bool active = rsq[k] < rcutsq[k] && epsilon != Scalar(0.0);
+
+            Scalar rinv = fast::rsqrt(rsq[k]);
+            Scalar r = Scalar(1.0) / rinv;
+            Scalar r2inv = Scalar(1.0) / rsq[k];
+            Scalar exp_val = fast::exp(-kappa * r);
+
+            Scalar rcutinv = fast::rsqrt(rcutsq[k]);
+            Scalar rcut = Scalar(1.0) / rcutinv;
+            Scalar shift = energy_shift[k] ? epsilon * fast::exp(-kappa * rcut) * rcutinv : Scalar(0.0);
+
+            force_divr[k] = active ? epsilon * exp_val * r2inv * (rinv + kappa) : Scalar(0.0);
+            pair_eng[k] = active ? epsilon * exp_val * rinv - shift : Scalar(0.0);
+            evaluated[k] = active;
+            }
+        }
+    };
+#endif
+
 #endif // __PAIR_EVALUATOR_YUKAWA_H__
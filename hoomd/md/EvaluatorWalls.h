@@ -13,6 +13,8 @@
 
 #ifndef __HIPCC__
 #include <string>
+#include <string.h>
+#include <algorithm>
 #endif
 
 #include "hoomd/BoxDim.h"
@@ -28,10 +30,30 @@
 #endif
 
 // sets the max numbers for each wall geometry type
-const unsigned int MAX_N_SWALLS=20;
+const unsigned int MAX_N_SWALLS=128;
 const unsigned int MAX_N_CWALLS=20;
 const unsigned int MAX_N_PWALLS=60;
 
+// sets the size of the grid that culls walls out of range
+const unsigned int WALL_GRID_DIM=6;
+const unsigned int WALL_GRID_N_CELLS=WALL_GRID_DIM*WALL_GRID_DIM*WALL_GRID_DIM;
+const unsigned int WALL_GRID_SWORDS=(MAX_N_SWALLS+31)/32;
+const unsigned int WALL_GRID_CWORDS=(MAX_N_CWALLS+31)/32;
+const unsigned int WALL_GRID_PWORDS=(MAX_N_PWALLS+31)/32;
+
+//! Uniform grid over the box that lists the walls within the cutoff of each cell
+/*! Each cell holds one bit per wall of each geometry, set when some point of the cell lies within the largest r_cut
+    of the wall surface. Particles outside of the grid, and types in extrapolated mode, evaluate all walls.
+*/
+struct wall_grid_type{
+    Scalar3          lo;            //!< Lower corner of the grid
+    Scalar3          inv_width;     //!< Inverse cell width along each direction
+    unsigned int     enabled;       //!< Nonzero when the grid is valid
+    unsigned int     spheres[WALL_GRID_N_CELLS*WALL_GRID_SWORDS];   //!< Sphere wall bits per cell
+    unsigned int     cylinders[WALL_GRID_N_CELLS*WALL_GRID_CWORDS]; //!< Cylinder wall bits per cell
+    unsigned int     planes[WALL_GRID_N_CELLS*WALL_GRID_PWORDS];    //!< Plane wall bits per cell
+};
+
 struct wall_type{
     unsigned int     numSpheres; // these data types come first, since the structs are aligned already
     unsigned int     numCylinders;
@@ -39,8 +61,110 @@ struct wall_type{
     SphereWall       Spheres[MAX_N_SWALLS];
     CylinderWall     Cylinders[MAX_N_CWALLS];
     PlaneWall        Planes[MAX_N_PWALLS];
+    wall_grid_type   grid;
+
+    wall_type() : numSpheres(0), numCylinders(0), numPlanes(0)
+        {
+        grid.enabled = 0;
+        }
 };
 
+//! Find the first set bit, counted from 1 (0 when no bit is set)
+DEVICE inline unsigned int wall_ffs(unsigned int x)
+    {
+    #ifdef __HIP_DEVICE_COMPILE__
+    return __ffs(x);
+    #else
+    return __builtin_ffs(x);
+    #endif
+    }
+
+#ifndef __HIPCC__
+//! Build the wall culling grid
+/*! \param field Walls to index, the grid is written to field.grid
+    \param box Simulation box covered by the grid
+    \param r_cut Largest cutoff radius of any particle type
+
+    Call whenever the walls, the cutoff radii, or the box change. The tests are conservative: a cell lists a sphere or
+    cylinder wall when the bounding sphere of the cell overlaps the shell of width 2 r_cut around the wall surface, and
+    a plane wall when the cell overlaps the slab of width 2 r_cut around the plane.
+*/
+inline void buildWallGrid(wall_type& field, const BoxDim& box, Scalar r_cut)
+    {
+    // the grid covers the axis aligned bounding box of the (possibly triclinic) box
+    vec3<Scalar> lo(box.getLo());
+    vec3<Scalar> hi = lo;
+    for (unsigned int corner = 0; corner < 8; corner++)
+        {
+        Scalar3 f = make_scalar3(Scalar(corner & 1), Scalar((corner >> 1) & 1), Scalar((corner >> 2) & 1));
+        vec3<Scalar> p(box.makeCoordinates(f));
+        lo.x = std::min(lo.x, p.x); lo.y = std::min(lo.y, p.y); lo.z = std::min(lo.z, p.z);
+        hi.x = std::max(hi.x, p.x); hi.y = std::max(hi.y, p.y); hi.z = std::max(hi.z, p.z);
+        }
+
+    // pad the grid so that particles on the box faces fall inside
+    vec3<Scalar> pad = Scalar(1e-3) * (hi - lo) + vec3<Scalar>(1e-6, 1e-6, 1e-6);
+    lo -= pad;
+    hi += pad;
+
+    vec3<Scalar> width = (hi - lo) / Scalar(WALL_GRID_DIM);
+    vec3<Scalar> half = Scalar(0.5) * width;
+    Scalar rho = sqrt(dot(half, half));
+
+    // widen the cutoff slightly to cover round off in the particle to wall distance
+    Scalar rc = r_cut * Scalar(1.0001) + Scalar(1e-6);
+
+    wall_grid_type& grid = field.grid;
+    grid.lo = vec_to_scalar3(lo);
+    grid.inv_width = make_scalar3(Scalar(1.0)/width.x, Scalar(1.0)/width.y, Scalar(1.0)/width.z);
+    memset(grid.spheres, 0, sizeof(grid.spheres));
+    memset(grid.cylinders, 0, sizeof(grid.cylinders));
+    memset(grid.planes, 0, sizeof(grid.planes));
+
+    for (unsigned int i = 0; i < WALL_GRID_DIM; i++)
+        for (unsigned int j = 0; j < WALL_GRID_DIM; j++)
+            for (unsigned int k = 0; k < WALL_GRID_DIM; k++)
+                {
+                unsigned int cell = (k*WALL_GRID_DIM + j)*WALL_GRID_DIM + i;
+                vec3<Scalar> c = lo + vec3<Scalar>((Scalar(i) + Scalar(0.5))*width.x,
+                                                   (Scalar(j) + Scalar(0.5))*width.y,
+                                                   (Scalar(k) + Scalar(0.5))*width.z);
+
+                for (unsigned int w = 0; w < field.numSpheres; w++)
+                    {
+                    const SphereWall& wall = field.Spheres[w];
+                    vec3<Scalar> dr = c - wall.origin;
+                    Scalar d = sqrt(dot(dr, dr));
+                    if (d - rho <= wall.r + rc && d + rho >= wall.r - rc)
+                        grid.spheres[cell*WALL_GRID_SWORDS + w/32] |= 1u << (w % 32);
+                    }
+
+                for (unsigned int w = 0; w < field.numCylinders; w++)
+                    {
+                    const CylinderWall& wall = field.Cylinders[w];
+                    vec3<Scalar> dr = c - wall.origin;
+                    vec3<Scalar> axis = wall.axis / sqrt(dot(wall.axis, wall.axis));
+                    vec3<Scalar> perp = dr - dot(dr, axis) * axis;
+                    Scalar d = sqrt(dot(perp, perp));
+                    if (d - rho <= wall.r + rc && d + rho >= wall.r - rc)
+                        grid.cylinders[cell*WALL_GRID_CWORDS + w/32] |= 1u << (w % 32);
+                    }
+
+                for (unsigned int w = 0; w < field.numPlanes; w++)
+                    {
+                    const PlaneWall& wall = field.Planes[w];
+                    Scalar d = dot(wall.normal, c - wall.origin);
+                    Scalar extent = fabs(wall.normal.x)*half.x + fabs(wall.normal.y)*half.y
+                                    + fabs(wall.normal.z)*half.z;
+                    if (fabs(d) <= rc + extent)
+                        grid.planes[cell*WALL_GRID_PWORDS + w/32] |= 1u << (w % 32);
+                    }
+                }
+
+    grid.enabled = 1;
+    }
+#endif
+
 //! Applys a wall force from all walls in the field parameter
 /*! \ingroup computes
 */
@@ -182,6 +306,7 @@ class EvaluatorWalls
             vec3<Scalar> position = vec3<Scalar>(m_pos);
             vec3<Scalar> drv;
             bool inside = false; //keeps compiler from complaining
+            unsigned int cell = 0;
             if (m_params.rextrap>0.0) //extrapolated mode
                 {
                 Scalar rextrapsq=m_params.rextrap * m_params.rextrap;
@@ -264,6 +389,52 @@ class EvaluatorWalls
                         }
                     }
                 }
+            else if (getGridCell(cell)) //normal mode, walls near the particle
+                {
+                const wall_grid_type& grid = m_field.grid;
+                for (unsigned int w = 0; w < WALL_GRID_SWORDS; w++)
+                    {
+                    unsigned int mask = grid.spheres[cell*WALL_GRID_SWORDS + w];
+                    while (mask)
+                        {
+                        unsigned int k = w*32 + wall_ffs(mask) - 1;
+                        mask &= mask - 1;
+                        drv = vecPtToWall(m_field.Spheres[k], position, inside);
+                        if (inside)
+                            {
+                            callEvaluator(F, energy, drv);
+                            }
+                        }
+                    }
+                for (unsigned int w = 0; w < WALL_GRID_CWORDS; w++)
+                    {
+                    unsigned int mask = grid.cylinders[cell*WALL_GRID_CWORDS + w];
+                    while (mask)
+                        {
+                        unsigned int k = w*32 + wall_ffs(mask) - 1;
+                        mask &= mask - 1;
+                        drv = vecPtToWall(m_field.Cylinders[k], position, inside);
+                        if (inside)
+                            {
+                            callEvaluator(F, energy, drv);
+                            }
+                        }
+                    }
+                for (unsigned int w = 0; w < WALL_GRID_PWORDS; w++)
+                    {
+                    unsigned int mask = grid.planes[cell*WALL_GRID_PWORDS + w];
+                    while (mask)
+                        {
+                        unsigned int k = w*32 + wall_ffs(mask) - 1;
+                        mask &= mask - 1;
+                        drv = vecPtToWall(m_field.Planes[k], position, inside);
+                        if (inside)
+                            {
+                            callEvaluator(F, energy, drv);
+                            }
+                        }
+                    }
+                }
             else //normal mode
                 {
                 for (unsigned int k = 0; k < m_field.numSpheres; k++)
@@ -302,6 +473,20 @@ class EvaluatorWalls
             }
 
         #ifndef __HIPCC__
+        //! Prepare the field for evaluation
+        /*! \param field Walls, the culling grid is rebuilt in place
+            \param box Simulation box
+            \param params Per-type parameters
+            \param n_types Number of particle types
+        */
+        static void prepareField(field_type& field, const BoxDim& box, const param_type* params, unsigned int n_types)
+            {
+            Scalar rcutsq = Scalar(0.0);
+            for (unsigned int i = 0; i < n_types; i++)
+                rcutsq = std::max(rcutsq, params[i].rcutsq);
+            buildWallGrid(field, box, sqrt(rcutsq));
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -313,6 +498,28 @@ class EvaluatorWalls
         #endif
 
     protected:
+        //! Find the grid cell of the particle
+        /*! \param cell Set to the index of the cell
+            \returns true when the grid is valid and contains the particle
+        */
+        DEVICE inline bool getGridCell(unsigned int& cell)
+            {
+            const wall_grid_type& grid = m_field.grid;
+            if (!grid.enabled)
+                return false;
+
+            Scalar fx = (m_pos.x - grid.lo.x) * grid.inv_width.x;
+            Scalar fy = (m_pos.y - grid.lo.y) * grid.inv_width.y;
+            Scalar fz = (m_pos.z - grid.lo.z) * grid.inv_width.z;
+            if (!(fx >= Scalar(0.0) && fx < Scalar(WALL_GRID_DIM)
+                  && fy >= Scalar(0.0) && fy < Scalar(WALL_GRID_DIM)
+                  && fz >= Scalar(0.0) && fz < Scalar(WALL_GRID_DIM)))
+                return false;
+
+            cell = ((unsigned int)fz*WALL_GRID_DIM + (unsigned int)fy)*WALL_GRID_DIM + (unsigned int)fx;
+            return true;
+            }
+
         Scalar3     m_pos;                //!< particle position
         const field_type&  m_field;       //!< contains all information about the walls.
         param_type  m_params;
@@ -0,0 +1,68 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file ExternalModelABI.h
+    \brief Defines the C interface between ExternalModelForceCompute and model libraries
+
+    This header is plain C so that model libraries (e.g. wrappers around TorchScript or ONNX runtime models) can be
+    built against it without HOOMD's headers or compiler settings. A model library exports three functions:
+
+    \code
+    void *hoomd_model_create(const char *model_path, unsigned int abi_version);
+    int hoomd_model_compute(void *model, const struct hoomd_model_args *args);
+    void hoomd_model_destroy(void *model);
+    \endcode
+
+    hoomd_model_create() returns NULL on failure and hoomd_model_compute() returns 0 on success.
+*/
+
+#ifndef __EXTERNAL_MODEL_ABI_H__
+#define __EXTERNAL_MODEL_ABI_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Version of the interface, incremented on every incompatible change
+#define HOOMD_MODEL_ABI_VERSION 1
+
+//! Arguments passed to hoomd_model_compute()
+/*! All arrays are device pointers when \a on_device is non-zero, and host pointers otherwise. Floating point arrays
+    hold \a scalar_size byte values (4 for single and 8 for double precision builds).
+
+    The neighbors of local particle i are nlist[head_list[i] + k] for k < n_neigh[i]. Neighbor indices may refer to
+    ghost particles (index >= n_local). With \a full_nlist set, every pair is listed for both particles, otherwise only
+    once.
+*/
+struct hoomd_model_args
+    {
+    unsigned int abi_version;       //!< HOOMD_MODEL_ABI_VERSION
+    unsigned int scalar_size;       //!< Size of a floating point value in bytes
+    int on_device;                  //!< Non-zero if the arrays are in device memory
+    unsigned int n_local;           //!< Number of local particles
+    unsigned int n_ghost;           //!< Number of ghost particles following the local particles
+    unsigned int n_types;           //!< Number of particle types
+
+    const void *pos;                //!< (n_local + n_ghost) x 4: x, y, z, type id (bits of an int)
+    const unsigned int *tag;        //!< (n_local + n_ghost) particle tags
+
+    const unsigned int *nlist;      //!< Neighbor indices
+    const unsigned int *n_neigh;    //!< n_local neighbor counts
+    const unsigned int *head_list;  //!< n_local offsets into nlist
+    int full_nlist;                 //!< Non-zero if the neighbor list is full
+
+    double box_L[3];                //!< Global box lengths
+    double box_tilt[3];             //!< Global box tilt factors xy, xz, yz
+    double r_cut;                   //!< Cutoff radius of the model
+
+    int compute_virial;             //!< Non-zero if the virial is requested
+    void *force;                    //!< n_local x 4 output: fx, fy, fz, potential energy (zeroed by HOOMD)
+    void *virial;                   //!< 6 rows of \a virial_pitch values: xx, xy, xz, yy, yz, zz (zeroed by HOOMD)
+    unsigned long virial_pitch;     //!< Row pitch of \a virial in elements
+    };
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __EXTERNAL_MODEL_ABI_H__
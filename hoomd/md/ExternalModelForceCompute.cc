@@ -0,0 +1,227 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "ExternalModelForceCompute.h"
+
+#include <dlfcn.h>
+#include <stdexcept>
+#include <string.h>
+
+namespace py = pybind11;
+
+/*! \file ExternalModelForceCompute.cc
+    \brief Defines the ExternalModelForceCompute class
+*/
+
+using namespace std;
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighborlist to use for computing the forces
+    \param library File name of the shared library implementing the model interface
+    \param model Path of the model file, passed unchanged to hoomd_model_create()
+    \param r_cut Cutoff radius of the model for all type pairs
+*/
+ExternalModelForceCompute::ExternalModelForceCompute(std::shared_ptr<SystemDefinition> sysdef,
+                                                     std::shared_ptr<NeighborList> nlist,
+                                                     const std::string& library,
+                                                     const std::string& model,
+                                                     Scalar r_cut)
+    : ForceCompute(sysdef), m_nlist(nlist), m_r_cut(r_cut), m_library(library),
+      m_library_handle(NULL), m_model(NULL)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing ExternalModelForceCompute" << endl;
+
+    assert(m_pdata);
+    assert(m_nlist);
+
+    if (r_cut <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "External model: r_cut must be positive" << endl;
+        throw runtime_error("Error initializing ExternalModelForceCompute");
+        }
+
+    m_library_handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!m_library_handle)
+        {
+        m_exec_conf->msg->error() << "External model: cannot load " << library << ": " << dlerror() << endl;
+        throw runtime_error("Error initializing ExternalModelForceCompute");
+        }
+
+    m_model_create = (void *(*)(const char *, unsigned int)) loadSymbol("hoomd_model_create");
+    m_model_compute = (int (*)(void *, const struct hoomd_model_args *)) loadSymbol("hoomd_model_compute");
+    m_model_destroy = (void (*)(void *)) loadSymbol("hoomd_model_destroy");
+
+    m_model = m_model_create(model.c_str(), HOOMD_MODEL_ABI_VERSION);
+    if (!m_model)
+        {
+        m_exec_conf->msg->error() << "External model: " << library << " failed to load the model " << model << endl;
+        dlclose(m_library_handle);
+        throw runtime_error("Error initializing ExternalModelForceCompute");
+        }
+
+    // the model sees every pair within r_cut, regardless of type
+    Index2D type_pair_idx(m_pdata->getNTypes());
+    m_r_cut_nlist = std::make_shared<GlobalArray<Scalar>>(type_pair_idx.getNumElements(), m_exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut_nlist(*m_r_cut_nlist, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < type_pair_idx.getNumElements(); i++)
+            h_r_cut_nlist.data[i] = m_r_cut;
+        }
+    nlist->addRCutMatrix(m_r_cut_nlist);
+
+    m_pdata->getNumTypesChangeSignal().connect<ExternalModelForceCompute,
+                                               &ExternalModelForceCompute::slotNumTypesChange>(this);
+    }
+
+ExternalModelForceCompute::~ExternalModelForceCompute()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying ExternalModelForceCompute" << endl;
+
+    m_pdata->getNumTypesChangeSignal().disconnect<ExternalModelForceCompute,
+                                                  &ExternalModelForceCompute::slotNumTypesChange>(this);
+
+    if (m_attached)
+        {
+        m_nlist->removeRCutMatrix(m_r_cut_nlist);
+        }
+
+    m_model_destroy(m_model);
+    dlclose(m_library_handle);
+    }
+
+/*! \param name Name of the symbol
+    \returns Address of the symbol
+    \note Closes the library and throws when the symbol is missing, so only call this from the constructor.
+*/
+void *ExternalModelForceCompute::loadSymbol(const char *name)
+    {
+    dlerror();
+    void *sym = dlsym(m_library_handle, name);
+    if (!sym)
+        {
+        m_exec_conf->msg->error() << "External model: " << m_library << " does not define " << name << endl;
+        dlclose(m_library_handle);
+        throw runtime_error("Error initializing ExternalModelForceCompute");
+        }
+    return sym;
+    }
+
+void ExternalModelForceCompute::slotNumTypesChange()
+    {
+    Index2D type_pair_idx(m_pdata->getNTypes());
+    GlobalArray<Scalar> new_r_cut_nlist(type_pair_idx.getNumElements(), m_exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut_nlist(new_r_cut_nlist, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < type_pair_idx.getNumElements(); i++)
+            h_r_cut_nlist.data[i] = m_r_cut;
+        }
+
+    // the nlist refers to m_r_cut_nlist, so copy the new data over
+    *m_r_cut_nlist = new_r_cut_nlist;
+    m_nlist->notifyRCutMatrixChange();
+    }
+
+/*! \post The model forces are computed for the given timestep. The neighborlist's compute method is called to ensure
+    that it is up to date.
+
+    \param timestep specifies the current time step of the simulation
+*/
+void ExternalModelForceCompute::computeForces(uint64_t timestep)
+    {
+    // start by updating the neighborlist
+    m_nlist->compute(timestep);
+
+    if (m_prof) m_prof->push(m_exec_conf, "External model");
+
+    // pass device pointers when running on the GPU so that the model does not need to copy through the host
+    access_location::Enum location = access_location::host;
+    #ifdef ENABLE_HIP
+    if (m_exec_conf->isCUDAEnabled())
+        location = access_location::device;
+    #endif
+
+    PDataFlags flags = m_pdata->getFlags();
+
+        {
+        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), location, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), location, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), location, access_mode::read);
+
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), location, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), location, access_mode::read);
+
+        ArrayHandle<Scalar4> h_force(m_force, location, access_mode::overwrite);
+        ArrayHandle<Scalar> h_virial(m_virial, location, access_mode::overwrite);
+
+        // the model accumulates into zeroed arrays
+        #ifdef ENABLE_HIP
+        if (location == access_location::device)
+            {
+            hipMemset(h_force.data, 0, sizeof(Scalar4)*m_force.getNumElements());
+            hipMemset(h_virial.data, 0, sizeof(Scalar)*m_virial.getNumElements());
+            }
+        else
+        #endif
+            {
+            memset((void*)h_force.data, 0, sizeof(Scalar4)*m_force.getNumElements());
+            memset((void*)h_virial.data, 0, sizeof(Scalar)*m_virial.getNumElements());
+            }
+
+        const BoxDim& box = m_pdata->getGlobalBox();
+        Scalar3 L = box.getL();
+
+        hoomd_model_args args;
+        args.abi_version = HOOMD_MODEL_ABI_VERSION;
+        args.scalar_size = sizeof(Scalar);
+        args.on_device = location == access_location::device;
+        args.n_local = m_pdata->getN();
+        args.n_ghost = m_pdata->getNGhosts();
+        args.n_types = m_pdata->getNTypes();
+        args.pos = h_pos.data;
+        args.tag = h_tag.data;
+        args.nlist = h_nlist.data;
+        args.n_neigh = h_n_neigh.data;
+        args.head_list = h_head_list.data;
+        args.full_nlist = m_nlist->getStorageMode() == NeighborList::full;
+        args.box_L[0] = L.x;
+        args.box_L[1] = L.y;
+        args.box_L[2] = L.z;
+        args.box_tilt[0] = box.getTiltFactorXY();
+        args.box_tilt[1] = box.getTiltFactorXZ();
+        args.box_tilt[2] = box.getTiltFactorYZ();
+        args.r_cut = m_r_cut;
+        args.compute_virial = flags[pdata_flag::pressure_tensor];
+        args.force = h_force.data;
+        args.virial = h_virial.data;
+        args.virial_pitch = m_virial_pitch;
+
+        int retval = m_model_compute(m_model, &args);
+
+        #ifdef ENABLE_HIP
+        if (m_exec_conf->isCUDAEnabled() && m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        #endif
+
+        if (retval != 0)
+            {
+            m_exec_conf->msg->error() << "External model: " << m_library << " returned error " << retval
+                                      << " at step " << timestep << endl;
+            throw runtime_error("Error computing ExternalModelForceCompute");
+            }
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+void export_ExternalModelForceCompute(py::module& m)
+    {
+    py::class_<ExternalModelForceCompute, ForceCompute, std::shared_ptr<ExternalModelForceCompute> >
+        (m, "ExternalModelForceCompute")
+    .def(py::init< std::shared_ptr<SystemDefinition>,
+                   std::shared_ptr<NeighborList>,
+                   const std::string&,
+                   const std::string&,
+                   Scalar >())
+    .def_property_readonly("r_cut", &ExternalModelForceCompute::getRCut)
+    ;
+    }
@@ -0,0 +1,103 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/ForceCompute.h"
+#include "NeighborList.h"
+#include "ExternalModelABI.h"
+
+#include <memory>
+#include <string>
+
+/*! \file ExternalModelForceCompute.h
+    \brief Declares the ExternalModelForceCompute class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+#ifndef __EXTERNAL_MODEL_FORCE_COMPUTE_H__
+#define __EXTERNAL_MODEL_FORCE_COMPUTE_H__
+
+//! Computes forces with a model provided by an external shared library
+/*! ExternalModelForceCompute loads a model library at run time (see ExternalModelABI.h) and passes it the particle
+    positions and the neighbor list on every force evaluation. The model writes the forces, energies and virials
+    straight into the force arrays. When the simulation runs on the GPU, all arrays are passed as device pointers so
+    that models evaluated on the GPU do not need to copy data through the host.
+
+    The neighbor list is the padded per-particle list that NeighborList already stores, so no edge list needs to be
+    packed on the HOOMD side.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT ExternalModelForceCompute : public ForceCompute
+    {
+    public:
+        //! Constructs the compute
+        ExternalModelForceCompute(std::shared_ptr<SystemDefinition> sysdef,
+                                  std::shared_ptr<NeighborList> nlist,
+                                  const std::string& library,
+                                  const std::string& model,
+                                  Scalar r_cut);
+
+        //! Destructor
+        virtual ~ExternalModelForceCompute();
+
+        //! Get the cutoff radius
+        Scalar getRCut()
+            {
+            return m_r_cut;
+            }
+
+        virtual void notifyDetach()
+            {
+            if (m_attached)
+                {
+                m_nlist->removeRCutMatrix(m_r_cut_nlist);
+                }
+            m_attached = false;
+            }
+
+        #ifdef ENABLE_MPI
+        //! Get ghost particle fields requested by this force
+        virtual CommFlags getRequestedCommFlags(uint64_t timestep)
+            {
+            CommFlags flags = CommFlags(0);
+            flags[comm_flag::tag] = 1;
+            flags |= ForceCompute::getRequestedCommFlags(timestep);
+            return flags;
+            }
+        #endif
+
+    protected:
+        //! Actually compute the forces
+        virtual void computeForces(uint64_t timestep);
+
+    private:
+        std::shared_ptr<NeighborList> m_nlist;               //!< The neighborlist to use for the computation
+        std::shared_ptr<GlobalArray<Scalar>> m_r_cut_nlist;  //!< r_cut matrix given to the neighbor list
+        Scalar m_r_cut;                                      //!< Cutoff radius of the model
+        std::string m_library;                               //!< File name of the model library
+        void *m_library_handle;                              //!< Handle of the loaded library
+        void *m_model;                                       //!< Model instance created by the library
+
+        /// Track whether we have attached to the Simulation object
+        bool m_attached = true;
+
+        void *(*m_model_create)(const char *, unsigned int);                  //!< hoomd_model_create
+        int (*m_model_compute)(void *, const struct hoomd_model_args *);     //!< hoomd_model_compute
+        void (*m_model_destroy)(void *);                                      //!< hoomd_model_destroy
+
+        //! Look up a symbol in the model library
+        void *loadSymbol(const char *name);
+
+        //! Resize the r_cut matrix when the number of types changes
+        void slotNumTypesChange();
+    };
+
+//! Exports the ExternalModelForceCompute class to python
+void export_ExternalModelForceCompute(pybind11::module& m);
+
+#endif
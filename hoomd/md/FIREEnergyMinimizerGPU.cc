@@ -21,7 +21,7 @@ using namespace std;
     \param dt Default step size
 */
 FIREEnergyMinimizerGPU::FIREEnergyMinimizerGPU(std::shared_ptr<SystemDefinition> sysdef, Scalar dt)
-    :   FIREEnergyMinimizer(sysdef, dt)
+    :   FIREEnergyMinimizer(sysdef, dt), m_check_period(1), m_steps_since_check(0)
     {
 
     // only one GPU is supported
@@ -37,9 +37,22 @@ FIREEnergyMinimizerGPU::FIREEnergyMinimizerGPU(std::shared_ptr<SystemDefinition>
     GPUArray<Scalar> sum3(3, m_exec_conf);
     m_sum3.swap(sum3);
 
+    // allocate the device state
+    GPUArray<fire_state> state(1, m_exec_conf);
+    m_state.swap(state);
+
     // initialize the partial sum arrays
     m_block_size = 256; //128;
+    resizePartialSums();
 
+    reset();
+    }
+
+/*! The partial sum arrays hold one value per block of the largest group, and the sum array holds FIRE_N_SUMS values
+    per integration method. Methods may be added after construction, so the arrays are resized before each step.
+*/
+void FIREEnergyMinimizerGPU::resizePartialSums()
+    {
     unsigned int num_blocks = 0;
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         {
@@ -50,14 +63,61 @@ FIREEnergyMinimizerGPU::FIREEnergyMinimizerGPU(std::shared_ptr<SystemDefinition>
         }
 
     num_blocks = num_blocks/m_block_size + 1;
-    GPUArray<Scalar> partial_sum1(num_blocks, m_exec_conf);
-    m_partial_sum1.swap(partial_sum1);
-    GPUArray<Scalar> partial_sum2(num_blocks, m_exec_conf);
-    m_partial_sum2.swap(partial_sum2);
-    GPUArray<Scalar> partial_sum3(num_blocks, m_exec_conf);
-    m_partial_sum3.swap(partial_sum3);
+    if (m_partial_sum1.isNull() || m_partial_sum1.getNumElements() < num_blocks)
+        {
+        GPUArray<Scalar> partial_sum1(num_blocks, m_exec_conf);
+        m_partial_sum1.swap(partial_sum1);
+        GPUArray<Scalar> partial_sum2(num_blocks, m_exec_conf);
+        m_partial_sum2.swap(partial_sum2);
+        GPUArray<Scalar> partial_sum3(num_blocks, m_exec_conf);
+        m_partial_sum3.swap(partial_sum3);
+        }
 
-    reset();
+    unsigned int n_sums = std::max((unsigned int)m_methods.size(), 1u)*FIRE_N_SUMS;
+    if (m_sums.isNull() || m_sums.getNumElements() < n_sums)
+        {
+        GPUArray<Scalar> sums(n_sums, m_exec_conf);
+        m_sums.swap(sums);
+        }
+    }
+
+/*! In addition to resetting the host state, copy it to the device state.
+*/
+void FIREEnergyMinimizerGPU::reset()
+    {
+    FIREEnergyMinimizer::reset();
+
+    m_steps_since_check = 0;
+
+    ArrayHandle<fire_state> h_state(m_state, access_location::host, access_mode::overwrite);
+    fire_state& s = h_state.data[0];
+    s.dt = m_deltaT;
+    s.alpha = m_alpha;
+    s.old_energy = m_old_energy;
+    s.energy_total = m_energy_total;
+    s.mix_alpha = m_alpha;
+    s.factor_t = Scalar(0.0);
+    s.factor_r = Scalar(0.0);
+    s.n_since_negative = m_n_since_negative;
+    s.n_since_start = m_n_since_start;
+    s.was_reset = 1;
+    s.zero = 0;
+    s.converged = 0;
+    }
+
+/*! \param check_period Number of steps between reads of the device state
+
+    Larger values avoid synchronizing with the device every step at the cost of adapting the step size less often
+    and detecting convergence up to check_period - 1 steps late.
+*/
+void FIREEnergyMinimizerGPU::setCheckPeriod(unsigned int check_period)
+    {
+    if (check_period == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.mode_minimize_fire: check_period should be > 0" << endl;
+        throw runtime_error("Error setting parameters for FIREEnergyMinimizer");
+        }
+    m_check_period = check_period;
     }
 
 /*! \param timesteps is the iteration number
@@ -68,6 +128,16 @@ void FIREEnergyMinimizerGPU::update(uint64_t timestep)
     if (m_converged)
         return;
 
+    resizePartialSums();
+
+    #ifdef ENABLE_MPI
+    if (!m_pdata->getDomainDecomposition())
+    #endif
+        {
+        updateOnDevice(timestep);
+        return;
+        }
+
     IntegratorTwoStep::update(timestep);
 
     Scalar Pt(0.0);  //translational power
@@ -381,10 +451,213 @@ void FIREEnergyMinimizerGPU::update(uint64_t timestep)
     m_old_energy = energy;
     }
 
+/*! \param timestep is the iteration number
+
+    The sums of each integration method are written to m_sums, gpu_fire_update_state() decides on the device whether
+    to mix or zero the velocities, and the velocity updates read that decision from the device state. No value is
+    copied to the host until readState() is called every m_check_period steps.
+*/
+void FIREEnergyMinimizerGPU::updateOnDevice(uint64_t timestep)
+    {
+    IntegratorTwoStep::update(timestep);
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "FIRE sums");
+
+    unsigned int total_group_size = 0;
+
+        {
+        ArrayHandle<Scalar> d_sums(m_sums, access_location::device, access_mode::overwrite);
+
+        // methods that are not anisotropic leave their rotational sums at zero
+        hipMemset(d_sums.data, 0, sizeof(Scalar)*m_methods.size()*FIRE_N_SUMS);
+
+        ArrayHandle<Scalar> d_partial_sum1(m_partial_sum1, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_partial_sum2(m_partial_sum2, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_partial_sum3(m_partial_sum3, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_net_force(m_pdata->getNetForce(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
+
+        unsigned int m = 0;
+        for (auto method = m_methods.begin(); method != m_methods.end(); ++method, ++m)
+            {
+            std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
+
+            unsigned int group_size = current_group->getNumMembers();
+            total_group_size += group_size;
+
+            ArrayHandle< unsigned int > d_index_array(current_group->getIndexArray(), access_location::device, access_mode::read);
+
+            Scalar *d_method_sums = d_sums.data + m*FIRE_N_SUMS;
+            unsigned int num_blocks = group_size/m_block_size + 1;
+
+            gpu_fire_compute_sum_pe(d_index_array.data,
+                                    group_size,
+                                    d_net_force.data,
+                                    d_method_sums,
+                                    d_partial_sum1.data,
+                                    m_block_size,
+                                    num_blocks);
+
+            if(m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+
+            gpu_fire_compute_sum_all(m_pdata->getN(),
+                                     d_vel.data,
+                                     d_accel.data,
+                                     d_index_array.data,
+                                     group_size,
+                                     d_method_sums + 1,
+                                     d_partial_sum1.data,
+                                     d_partial_sum2.data,
+                                     d_partial_sum3.data,
+                                     m_block_size,
+                                     num_blocks);
+
+            if(m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+
+            if ((*method)->getAnisotropic())
+                {
+                ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+                ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::read);
+                ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device, access_mode::read);
+                ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
+
+                gpu_fire_compute_sum_all_angular(m_pdata->getN(),
+                                         d_orientation.data,
+                                         d_inertia.data,
+                                         d_angmom.data,
+                                         d_net_torque.data,
+                                         d_index_array.data,
+                                         group_size,
+                                         d_method_sums + 4,
+                                         d_partial_sum1.data,
+                                         d_partial_sum2.data,
+                                         d_partial_sum3.data,
+                                         m_block_size,
+                                         num_blocks);
+
+                if(m_exec_conf->isCUDAErrorCheckingEnabled())
+                    CHECK_CUDA_ERROR();
+                }
+            }
+        }
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "FIRE update velocities");
+
+    fire_params params;
+    params.finc = m_finc;
+    params.fdec = m_fdec;
+    params.alpha_start = m_alpha_start;
+    params.falpha = m_falpha;
+    params.ftol = m_ftol;
+    params.wtol = m_wtol;
+    params.etol = m_etol;
+    params.dt_max = m_deltaT_max;
+    params.nmin = m_nmin;
+    params.run_minsteps = m_run_minsteps;
+    params.n_methods = (unsigned int)m_methods.size();
+    params.total_group_size = total_group_size;
+    params.ndof = m_sysdef->getNDimensions()*total_group_size;
+
+        {
+        ArrayHandle<fire_state> d_state(m_state, access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar> d_sums(m_sums, access_location::device, access_mode::read);
+
+        gpu_fire_update_state(d_state.data, d_sums.data, params);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
+            {
+            std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
+
+            unsigned int group_size = current_group->getNumMembers();
+            ArrayHandle< unsigned int > d_index_array(current_group->getIndexArray(), access_location::device, access_mode::read);
+
+            ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+            ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
+
+            gpu_fire_update_v_state(d_vel.data,
+                                    d_accel.data,
+                                    d_index_array.data,
+                                    group_size,
+                                    d_state.data);
+
+            if(m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+
+            if ((*method)->getAnisotropic())
+                {
+                ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+                ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device, access_mode::read);
+                ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::readwrite);
+                ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
+
+                gpu_fire_update_angmom_state(d_net_torque.data,
+                                             d_orientation.data,
+                                             d_inertia.data,
+                                             d_angmom.data,
+                                             d_index_array.data,
+                                             group_size,
+                                             d_state.data);
+
+                if(m_exec_conf->isCUDAErrorCheckingEnabled())
+                    CHECK_CUDA_ERROR();
+                }
+            }
+        }
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+
+    m_steps_since_check++;
+    if (m_steps_since_check >= m_check_period)
+        {
+        readState();
+
+        if (m_converged)
+            m_exec_conf->msg->notice(4) << "FIRE converged in timestep " << timestep << std::endl;
+        }
+    }
+
+/*! Copies the device state to the host members so that hasConverged(), getEnergy() and the step size of the
+    integration methods reflect the last step.
+*/
+void FIREEnergyMinimizerGPU::readState()
+    {
+    m_steps_since_check = 0;
+
+    ArrayHandle<fire_state> h_state(m_state, access_location::host, access_mode::read);
+    const fire_state& s = h_state.data[0];
+
+    m_converged = s.converged;
+    m_was_reset = s.was_reset;
+    m_energy_total = s.energy_total;
+    m_old_energy = s.old_energy;
+    m_alpha = s.alpha;
+    m_n_since_negative = s.n_since_negative;
+    m_n_since_start = s.n_since_start;
+
+    m_exec_conf->msg->notice(10) << "FIRE dt " << s.dt << " alpha " << s.alpha << " E " << s.energy_total << std::endl;
+
+    if (!m_converged)
+        IntegratorTwoStep::setDeltaT(s.dt);
+    }
+
 
 void export_FIREEnergyMinimizerGPU(py::module& m)
     {
     py::class_<FIREEnergyMinimizerGPU, FIREEnergyMinimizer, std::shared_ptr<FIREEnergyMinimizerGPU> >(m, "FIREEnergyMinimizerGPU")
         .def(py::init< std::shared_ptr<SystemDefinition>, Scalar >())
+        .def("setCheckPeriod", &FIREEnergyMinimizerGPU::setCheckPeriod)
+        .def("getCheckPeriod", &FIREEnergyMinimizerGPU::getCheckPeriod)
         ;
     }
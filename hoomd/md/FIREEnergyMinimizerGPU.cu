@@ -809,3 +809,243 @@ hipError_t gpu_fire_update_angmom(const Scalar4 *d_net_torque,
 
     return hipSuccess;
     }
+
+//! Kernel function for the alpha, dt and restart logic of one FIRE step
+/*! \param d_state State of the minimizer, updated in place
+    \param d_sums Sums of each integration method (FIRE_N_SUMS per method)
+    \param params Parameters of the minimizer
+
+    A single thread evaluates the logic of FIREEnergyMinimizer::update() from the sums on the device, so the host does
+    not need to read the sums back every step. It records the coupling factors and whether to zero the velocities
+    for gpu_fire_update_v_state_kernel() and gpu_fire_update_angmom_state_kernel().
+*/
+__global__ void gpu_fire_update_state_kernel(fire_state *d_state,
+                                             const Scalar *d_sums,
+                                             const fire_params params)
+    {
+    if (blockIdx.x != 0 || threadIdx.x != 0)
+        return;
+
+    fire_state s = *d_state;
+    if (s.converged)
+        return;
+
+    Scalar energy(0.0), Pt(0.0), vnorm(0.0), fnorm(0.0), Pr(0.0), wnorm(0.0), tnorm(0.0);
+    for (unsigned int m = 0; m < params.n_methods; ++m)
+        {
+        const Scalar *sums = d_sums + m*FIRE_N_SUMS;
+        energy += sums[0];
+        Pt += sums[1];
+        vnorm += sums[2];
+        fnorm += sums[3];
+        Pr += sums[4];
+        wnorm += sums[5];
+        tnorm += sums[6];
+        }
+
+    s.energy_total = energy;
+    energy /= Scalar(params.total_group_size);
+
+    if (s.was_reset)
+        {
+        s.was_reset = 0;
+        s.old_energy = energy + Scalar(100000)*params.etol;
+        }
+
+    vnorm = sqrt(vnorm);
+    fnorm = sqrt(fnorm);
+    wnorm = sqrt(wnorm);
+    tnorm = sqrt(tnorm);
+
+    Scalar sqrt_ndof = sqrt(Scalar(params.ndof));
+    if (fnorm/sqrt_ndof < params.ftol && wnorm/sqrt_ndof < params.wtol
+        && fabs(energy - s.old_energy) < params.etol && s.n_since_start >= params.run_minsteps)
+        {
+        s.converged = 1;
+        *d_state = s;
+        return;
+        }
+
+    s.mix_alpha = s.alpha;
+    s.factor_t = (fabs(fnorm) > EPSILON) ? s.alpha*vnorm/fnorm : Scalar(1.0);
+    s.factor_r = (fabs(tnorm) > EPSILON) ? s.alpha*wnorm/tnorm : Scalar(1.0);
+
+    if (Pt + Pr > Scalar(0.0))
+        {
+        s.zero = 0;
+        s.n_since_negative++;
+        if (s.n_since_negative > params.nmin)
+            {
+            s.dt = min(s.dt*params.finc, params.dt_max);
+            s.alpha *= params.falpha;
+            }
+        }
+    else
+        {
+        s.zero = 1;
+        s.dt *= params.fdec;
+        s.alpha = params.alpha_start;
+        s.n_since_negative = 0;
+        }
+
+    s.n_since_start++;
+    s.old_energy = energy;
+    *d_state = s;
+    }
+
+/*! \param d_state State of the minimizer, updated in place
+    \param d_sums Sums of each integration method (FIRE_N_SUMS per method)
+    \param params Parameters of the minimizer
+
+    This function is a driver for gpu_fire_update_state_kernel(), see it for details.
+*/
+hipError_t gpu_fire_update_state(fire_state *d_state,
+                                 const Scalar *d_sums,
+                                 const fire_params params)
+    {
+    hipLaunchKernelGGL((gpu_fire_update_state_kernel), dim3(1), dim3(1), 0, 0, d_state, d_sums, params);
+
+    return hipSuccess;
+    }
+
+//! Kernel function for updating the velocities from the device state
+/*! \param d_vel Array of velocities to update
+    \param d_accel Array of accelerations
+    \param d_group_members Device array listing the indices of the members of the group to update
+    \param group_size Number of members in the group
+    \param d_state State of the minimizer set by gpu_fire_update_state_kernel()
+
+    Mixes the velocities like gpu_fire_update_v_kernel(). Velocities are zeroed when the power was not positive, and
+    once the minimization has converged so that the steps run before the host reads back the state do not move the
+    particles further.
+*/
+__global__ void gpu_fire_update_v_state_kernel(Scalar4 *d_vel,
+                                               const Scalar3 *d_accel,
+                                               unsigned int *d_group_members,
+                                               unsigned int group_size,
+                                               const fire_state *d_state)
+    {
+    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (group_idx < group_size)
+        {
+        unsigned int idx = d_group_members[group_idx];
+        const bool zero = d_state->zero || d_state->converged;
+        const Scalar alpha = d_state->mix_alpha;
+        const Scalar factor_t = d_state->factor_t;
+
+        Scalar4 v = d_vel[idx];
+        if (zero)
+            {
+            v.x = Scalar(0.0);
+            v.y = Scalar(0.0);
+            v.z = Scalar(0.0);
+            }
+        else
+            {
+            Scalar3 a = d_accel[idx];
+            v.x = v.x*(Scalar(1.0)-alpha) + a.x*factor_t;
+            v.y = v.y*(Scalar(1.0)-alpha) + a.y*factor_t;
+            v.z = v.z*(Scalar(1.0)-alpha) + a.z*factor_t;
+            }
+
+        d_vel[idx] = v;
+        }
+    }
+
+/*! \param d_vel Array of velocities to update
+    \param d_accel Array of accelerations
+    \param d_group_members Device array listing the indices of the members of the group to update
+    \param group_size Number of members in the group
+    \param d_state State of the minimizer set by gpu_fire_update_state()
+
+    This function is a driver for gpu_fire_update_v_state_kernel(), see it for details.
+*/
+hipError_t gpu_fire_update_v_state(Scalar4 *d_vel,
+                                   const Scalar3 *d_accel,
+                                   unsigned int *d_group_members,
+                                   unsigned int group_size,
+                                   const fire_state *d_state)
+    {
+    int block_size = 256;
+    dim3 grid( (group_size/block_size) + 1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+
+    hipLaunchKernelGGL((gpu_fire_update_v_state_kernel), dim3(grid), dim3(threads), 0, 0, d_vel,
+                                                  d_accel,
+                                                  d_group_members,
+                                                  group_size,
+                                                  d_state);
+
+    return hipSuccess;
+    }
+
+//! Kernel function for updating the angular momenta from the device state
+/*! See gpu_fire_update_angmom_kernel() and gpu_fire_update_v_state_kernel().
+*/
+__global__ void gpu_fire_update_angmom_state_kernel(const Scalar4 *d_net_torque,
+                                                    const Scalar4 *d_orientation,
+                                                    const Scalar3 *d_inertia,
+                                                    Scalar4 *d_angmom,
+                                                    unsigned int *d_group_members,
+                                                    unsigned int group_size,
+                                                    const fire_state *d_state)
+    {
+    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (group_idx < group_size)
+        {
+        unsigned int idx = d_group_members[group_idx];
+
+        if (d_state->zero || d_state->converged)
+            {
+            d_angmom[idx] = make_scalar4(0,0,0,0);
+            return;
+            }
+
+        const Scalar alpha = d_state->mix_alpha;
+        const Scalar factor_r = d_state->factor_r;
+
+        quat<Scalar> q(d_orientation[idx]);
+        vec3<Scalar> t(d_net_torque[idx]);
+        quat<Scalar> p(d_angmom[idx]);
+        vec3<Scalar> I(d_inertia[idx]);
+
+        // rotate torque into principal frame
+        t = rotate(conj(q),t);
+
+        // ignore torque component along an axis for which the moment of inertia zero
+        if (I.x < EPSILON) t.x = 0;
+        if (I.y < EPSILON) t.y = 0;
+        if (I.z < EPSILON) t.z = 0;
+
+        p = p*Scalar(1.0-alpha) + Scalar(2.0)*q*t*factor_r;
+
+        d_angmom[idx] = quat_to_scalar4(p);
+        }
+    }
+
+/*! This function is a driver for gpu_fire_update_angmom_state_kernel(), see it for details.
+*/
+hipError_t gpu_fire_update_angmom_state(const Scalar4 *d_net_torque,
+                                        const Scalar4 *d_orientation,
+                                        const Scalar3 *d_inertia,
+                                        Scalar4 *d_angmom,
+                                        unsigned int *d_group_members,
+                                        unsigned int group_size,
+                                        const fire_state *d_state)
+    {
+    int block_size = 256;
+    dim3 grid( (group_size/block_size) + 1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+
+    hipLaunchKernelGGL((gpu_fire_update_angmom_state_kernel), dim3(grid), dim3(threads), 0, 0, d_net_torque,
+                                                  d_orientation,
+                                                  d_inertia,
+                                                  d_angmom,
+                                                  d_group_members,
+                                                  group_size,
+                                                  d_state);
+
+    return hipSuccess;
+    }
@@ -14,6 +14,44 @@
     \brief Defines the interface to GPU kernel drivers used by FIREEnergyMinimizerGPU.
 */
 
+//! Number of sums computed for each integration method: pe, P, vsq, fsq, Pr, wsq, tsq
+const unsigned int FIRE_N_SUMS = 7;
+
+//! State of the FIRE minimizer kept on the device between steps
+struct fire_state
+    {
+    Scalar dt;                      //!< Step size decided for the next step
+    Scalar alpha;                   //!< Current coupling parameter
+    Scalar old_energy;              //!< Energy per particle of the previous step
+    Scalar energy_total;            //!< Total energy of the last step
+    Scalar mix_alpha;               //!< Coupling parameter of the current velocity update
+    Scalar factor_t;                //!< Translational factor alpha*vnorm/fnorm of the current velocity update
+    Scalar factor_r;                //!< Rotational factor alpha*wnorm/tnorm of the current velocity update
+    unsigned int n_since_negative;  //!< Number of consecutive steps with positive power
+    unsigned int n_since_start;     //!< Number of steps since the last reset
+    unsigned int was_reset;         //!< Non-zero when the minimizer was just reset
+    unsigned int zero;              //!< Non-zero when the current step zeros the velocities
+    unsigned int converged;         //!< Non-zero when the minimization has converged
+    };
+
+//! Parameters of the FIRE minimizer passed to gpu_fire_update_state()
+struct fire_params
+    {
+    Scalar finc;                    //!< Fractional increase of the step size
+    Scalar fdec;                    //!< Fractional decrease of the step size
+    Scalar alpha_start;             //!< Initial coupling parameter
+    Scalar falpha;                  //!< Fractional decrease of the coupling parameter
+    Scalar ftol;                    //!< Force tolerance
+    Scalar wtol;                    //!< Angular momentum tolerance
+    Scalar etol;                    //!< Energy tolerance
+    Scalar dt_max;                  //!< Maximum step size
+    unsigned int nmin;              //!< Number of steps with positive power before adapting
+    unsigned int run_minsteps;      //!< Minimum number of steps before checking convergence
+    unsigned int n_methods;         //!< Number of integration methods with sums in d_sums
+    unsigned int total_group_size;  //!< Number of particles integrated
+    unsigned int ndof;              //!< Number of translational degrees of freedom
+    };
+
 //! Kernel driver for zeroing velocities called by FIREEnergyMinimizerGPU
 hipError_t gpu_fire_zero_v(Scalar4 *d_vel,
                             unsigned int *d_group_members,
@@ -76,4 +114,25 @@ hipError_t gpu_fire_update_angmom(const Scalar4 *d_net_torque,
                               Scalar alpha,
                               Scalar factor_r);
 
+//! Kernel driver for the alpha, dt and restart logic of one FIRE step on the device
+hipError_t gpu_fire_update_state(fire_state *d_state,
+                                 const Scalar *d_sums,
+                                 const fire_params params);
+
+//! Kernel driver for updating the velocities from the device state
+hipError_t gpu_fire_update_v_state(Scalar4 *d_vel,
+                                   const Scalar3 *d_accel,
+                                   unsigned int *d_group_members,
+                                   unsigned int group_size,
+                                   const fire_state *d_state);
+
+//! Kernel driver for updating the angular momenta from the device state
+hipError_t gpu_fire_update_angmom_state(const Scalar4 *d_net_torque,
+                                        const Scalar4 *d_orientation,
+                                        const Scalar3 *d_inertia,
+                                        Scalar4 *d_angmom,
+                                        unsigned int *d_group_members,
+                                        unsigned int group_size,
+                                        const fire_state *d_state);
+
 #endif //__FIRE_ENERGY_MINIMIZER_GPU_CUH__
@@ -5,6 +5,7 @@
 // Maintainer: askeys
 
 #include "FIREEnergyMinimizer.h"
+#include "FIREEnergyMinimizerGPU.cuh"
 
 #include <memory>
 
@@ -24,6 +25,12 @@
 //! Finds the nearest basin in the potential energy landscape
 /*! \b Overview
 
+    Without domain decomposition, the minimizer keeps its state (fire_state) on the device: the sums, the alpha, dt and
+    restart logic, and the velocity updates all run in kernels, and the host reads the state back only every
+    check_period steps to apply the new step size and test for convergence. With check_period > 1, the step size
+    adapts every check_period steps, and up to check_period - 1 steps (with zeroed velocities) may run after
+    convergence. With domain decomposition, the sums are reduced over the ranks on the host every step.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT FIREEnergyMinimizerGPU : public FIREEnergyMinimizer
@@ -38,6 +45,18 @@ class PYBIND11_EXPORT FIREEnergyMinimizerGPU : public FIREEnergyMinimizer
         //! Iterates forward one step
         virtual void update(uint64_t timestep);
 
+        //! Reset the minimization
+        virtual void reset();
+
+        //! Set the number of steps between reads of the device state
+        void setCheckPeriod(unsigned int check_period);
+
+        //! Get the number of steps between reads of the device state
+        unsigned int getCheckPeriod() const
+            {
+            return m_check_period;
+            }
+
     protected:
         unsigned int m_nparticles;              //!< number of particles in the system
         unsigned int m_block_size;              //!< block size for partial sum memory
@@ -46,6 +65,19 @@ class PYBIND11_EXPORT FIREEnergyMinimizerGPU : public FIREEnergyMinimizer
         GPUArray<Scalar> m_partial_sum3;         //!< memory space for partial sum over asq
         GPUArray<Scalar> m_sum;                  //!< memory space for sum over vsq
         GPUArray<Scalar> m_sum3;                 //!< memory space for the sum over P, vsq, asq
+        GPUArray<Scalar> m_sums;                 //!< Sums of each integration method on the device
+        GPUArray<fire_state> m_state;            //!< State of the minimizer on the device
+        unsigned int m_check_period;             //!< Number of steps between reads of the device state
+        unsigned int m_steps_since_check;        //!< Number of steps since the last read of the device state
+
+        //! Resize the partial sum arrays to fit the largest group
+        void resizePartialSums();
+
+        //! Perform one iteration with the state on the device
+        void updateOnDevice(uint64_t timestep);
+
+        //! Read the device state back and apply it on the host
+        void readState();
 
     private:
 
@@ -0,0 +1,99 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file ForceAccumulator.h
+    \brief Defines the accumulator type for per-particle force and virial sums in GPU kernels
+*/
+
+#ifndef __FORCE_ACCUMULATOR_H__
+#define __FORCE_ACCUMULATOR_H__
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// HOSTDEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif
+
+/*! Kernels that split the sum over a particle's neighbors between several threads add the terms in an order that
+    depends on the number of threads per particle, and that number is chosen by the Autotuner. Floating point
+    addition is not associative, so the forces change in the last bits from run to run.
+
+    With ENABLE_DETERMINISTIC_FORCES, every term is rounded to a 64-bit fixed point number with 32 fractional bits
+    before it is added. Integer addition is associative, so the sums are bit-identical for any launch configuration.
+    Terms are resolved to 2^-32 (about 2.3e-10) and the sum must stay below 2^31 in magnitude.
+*/
+#ifdef ENABLE_DETERMINISTIC_FORCES
+//! Accumulator for force, energy, and virial sums
+typedef long long int ForceAccum;
+
+//! Scale factor between Scalar values and ForceAccum values
+const Scalar FORCE_ACCUM_SCALE = Scalar(4294967296.0);
+
+//! Add a term to the accumulator
+HOSTDEVICE inline void force_accum_add(ForceAccum& accum, Scalar v)
+    {
+    accum += (long long int)slow::rint(v * FORCE_ACCUM_SCALE);
+    }
+
+//! Get the accumulated value
+HOSTDEVICE inline Scalar force_accum_value(ForceAccum accum)
+    {
+    return Scalar(accum) / FORCE_ACCUM_SCALE;
+    }
+
+#else
+//! Accumulator for force, energy, and virial sums
+typedef Scalar ForceAccum;
+
+//! Add a term to the accumulator
+HOSTDEVICE inline void force_accum_add(ForceAccum& accum, Scalar v)
+    {
+    accum += v;
+    }
+
+//! Get the accumulated value
+HOSTDEVICE inline Scalar force_accum_value(ForceAccum accum)
+    {
+    return accum;
+    }
+#endif
+
+#ifdef __HIPCC__
+//! Atomically add a term to an accumulator in global memory
+/*! Kernels that scatter forces to other particles, such as the pair kernels for half neighbor lists, add to
+    accumulators shared between threads. With ENABLE_DETERMINISTIC_FORCES the fixed point sums stay bit-identical
+    in any order of the atomic operations.
+*/
+__device__ inline void force_accum_atomic_add(ForceAccum *accum, Scalar v)
+    {
+    #ifdef ENABLE_DETERMINISTIC_FORCES
+    atomicAdd((unsigned long long int *)accum, (unsigned long long int)(long long int)slow::rint(v * FORCE_ACCUM_SCALE));
+    #elif defined(SINGLE_PRECISION) && defined(__HIP_PLATFORM_HCC__)
+    // workaround for HIP bug
+    unsigned int* address_as_uint = (unsigned int*)accum;
+    unsigned int old = *address_as_uint, assumed;
+    do {
+        assumed = old;
+        old = atomicCAS(address_as_uint, assumed, __float_as_uint(v + __uint_as_float(assumed)));
+    } while (assumed != old);
+    #elif !defined(SINGLE_PRECISION) && defined(__CUDA_ARCH__) && (__CUDA_ARCH__ < 600)
+    // there is no native double precision atomicAdd before sm_60
+    unsigned long long int* address_as_ull = (unsigned long long int*)accum;
+    unsigned long long int old = *address_as_ull, assumed;
+    do {
+        assumed = old;
+        old = atomicCAS(address_as_ull, assumed, __double_as_longlong(v + __longlong_as_double(assumed)));
+    } while (assumed != old);
+    #else
+    atomicAdd(accum, v);
+    #endif
+    }
+#endif
+
+#undef HOSTDEVICE
+
+#endif // __FORCE_ACCUMULATOR_H__
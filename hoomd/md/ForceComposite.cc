@@ -7,7 +7,9 @@
 #include "ForceComposite.h"
 #include "hoomd/VectorMath.h"
 
+#include <algorithm>
 #include <map>
+#include <set>
 #include <string.h>
 namespace py = pybind11;
 
@@ -44,7 +46,10 @@ ForceComposite::~ForceComposite()
     m_pdata->getCompositeParticlesSignal().disconnect<ForceComposite, &ForceComposite::getMaxBodyDiameter>(this);
     #ifdef ENABLE_MPI
     if (m_comm_ghost_layer_connected)
+        {
         m_comm->getExtraGhostLayerWidthRequestSignal().disconnect<ForceComposite, &ForceComposite::requestExtraGhostLayerWidth>(this);
+        m_comm->getGhostReconstructionRequestSignal().disconnect<ForceComposite, &ForceComposite::markReconstructedGhosts>(this);
+        }
     #endif
     }
 
@@ -401,6 +406,14 @@ void ForceComposite::validateRigidBodies(bool create)
                 }
             }
 
+        if (create && createRigidBodiesLocal())
+            {
+            // reset flags
+            m_bodies_changed = false;
+            m_ptls_added_removed = false;
+            return;
+            }
+
         SnapshotParticleData<Scalar> snap;
 
         // take a snapshot on rank 0
@@ -727,6 +740,212 @@ void ForceComposite::validateRigidBodies(bool create)
         }
     }
 
+/*! \returns false, without changing the particle data, if particles that are part of rigid bodies have to be removed
+             first
+
+    Every rank creates the constituent particles of its local central particles directly in the particle data, so
+    that no snapshot is gathered on rank 0. The new particles take the tags following ParticleData::getTagEnd(), rank
+    by rank and in the order of the tags of the central particles, which gives the same tags as creating the bodies
+    from a snapshot when there is only one rank. Constituent particles outside of the local domain are migrated by the
+    communicator at the beginning of the next run.
+
+    All ranks have to call this method.
+*/
+bool ForceComposite::createRigidBodiesLocal()
+    {
+    const unsigned int nptl = m_pdata->getN();
+
+    // local central particles as (tag, index) pairs
+    std::vector< std::pair<unsigned int, unsigned int> > central_ptls;
+    unsigned int n_add_local = 0;
+    unsigned int need_remove_bodies = 0;
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < nptl; ++i)
+            {
+            unsigned int type = __scalar_as_int(h_postype.data[i].w);
+            if (h_body_len.data[type] != 0)
+                {
+                central_ptls.push_back(std::make_pair(h_tag.data[i], i));
+                n_add_local += h_body_len.data[type];
+                }
+            else if (h_body.data[i] < MIN_FLOPPY)
+                {
+                need_remove_bodies = 1;
+                }
+            }
+        }
+
+    // number of bodies and of particles to add: offsets of this rank and totals
+    unsigned int n_local[2] = {(unsigned int)central_ptls.size(), n_add_local};
+    unsigned int offset[2] = {0, 0};
+    unsigned int n_global[2] = {n_local[0], n_local[1]};
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        MPI_Allreduce(MPI_IN_PLACE, &need_remove_bodies, 1, MPI_UNSIGNED, MPI_MAX, mpi_comm);
+        MPI_Exscan(n_local, offset, 2, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+        MPI_Allreduce(n_local, n_global, 2, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+
+        // the result of MPI_Exscan is undefined on the first rank
+        if (m_exec_conf->getRank() == 0)
+            {
+            offset[0] = 0;
+            offset[1] = 0;
+            }
+        }
+    #endif
+
+    if (need_remove_bodies)
+        return false;
+
+    const unsigned int old_tag_end = m_pdata->getTagEnd();
+    if ((uint64_t)old_tag_end + n_global[1] >= (uint64_t)MIN_FLOPPY)
+        {
+        m_exec_conf->msg->error() << "constrain.rigid(): Adding " << n_global[1] << " constituent particles exceeds "
+            << "the maximum number of particle tags" << std::endl;
+        throw std::runtime_error("Error creating rigid bodies\n");
+        }
+    const unsigned int new_tag_end = old_tag_end + n_global[1];
+
+    std::sort(central_ptls.begin(), central_ptls.end());
+
+    std::vector<pdata_element> in(nptl + n_add_local);
+    std::vector<unsigned int> molecule_tag(new_tag_end, NO_MOLECULE);
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        // keep the existing particles
+        unsigned int net_virial_pitch = (unsigned int)m_pdata->getNetVirial().getPitch();
+        for (unsigned int i = 0; i < nptl; ++i)
+            {
+            pdata_element& p = in[i];
+            p.pos = h_pos.data[i];
+            p.vel = h_vel.data[i];
+            p.accel = h_accel.data[i];
+            p.charge = h_charge.data[i];
+            p.diameter = h_diameter.data[i];
+            p.image = h_image.data[i];
+            p.body = h_body.data[i];
+            p.orientation = h_orientation.data[i];
+            p.angmom = h_angmom.data[i];
+            p.inertia = h_inertia.data[i];
+            p.tag = h_tag.data[i];
+            p.net_force = h_net_force.data[i];
+            p.net_torque = h_net_torque.data[i];
+            for (unsigned int j = 0; j < 6; ++j)
+                p.net_virial[j] = h_net_virial.data[net_virial_pitch*j+i];
+            }
+
+        // access body data
+        ArrayHandle<unsigned int> h_body_type(m_body_types, access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_body_orientation(m_body_orientation, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
+
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        unsigned int idx_out = nptl;
+        unsigned int tag_out = old_tag_end + offset[1];
+
+        // create copies
+        for (unsigned int k = 0; k < central_ptls.size(); ++k)
+            {
+            unsigned int body_tag = central_ptls[k].first;
+            unsigned int i = central_ptls[k].second;
+            unsigned int body_type = __scalar_as_int(h_pos.data[i].w);
+            unsigned int mol = offset[0] + k;
+
+            // set body id to tag of central ptl
+            in[i].body = body_tag;
+            molecule_tag[body_tag] = mol;
+
+            vec3<Scalar> central_pos(h_pos.data[i]);
+            quat<Scalar> central_orientation(h_orientation.data[i]);
+            int3 central_img = h_image.data[i];
+
+            for (unsigned int j = 0; j < h_body_len.data[body_type]; ++j)
+                {
+                vec3<Scalar> pos(central_pos);
+                pos += rotate(central_orientation, vec3<Scalar>(h_body_pos.data[m_body_idx(body_type,j)]));
+                quat<Scalar> orientation = central_orientation*quat<Scalar>(h_body_orientation.data[m_body_idx(body_type,j)]);
+
+                // wrap into box, allowing rigid bodies to span multiple images
+                int3 img = global_box.getImage(vec_to_scalar3(pos));
+                int3 negimg = make_int3(-img.x, -img.y, -img.z);
+                pos = global_box.shift(pos, negimg);
+
+                pdata_element& p = in[idx_out++];
+                p.pos = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(h_body_type.data[m_body_idx(body_type,j)]));
+                p.vel = make_scalar4(0.0, 0.0, 0.0, 1.0);
+                p.accel = make_scalar3(0.0, 0.0, 0.0);
+                p.charge = m_body_charge[body_type][j];
+                p.diameter = m_body_diameter[body_type][j];
+                p.image = central_img + img;
+                p.body = body_tag;
+                p.orientation = quat_to_scalar4(orientation);
+                p.angmom = make_scalar4(0.0, 0.0, 0.0, 0.0);
+                p.inertia = make_scalar3(0.0, 0.0, 0.0);
+                p.tag = tag_out++;
+                p.net_force = make_scalar4(0.0, 0.0, 0.0, 0.0);
+                p.net_torque = make_scalar4(0.0, 0.0, 0.0, 0.0);
+                for (unsigned int l = 0; l < 6; ++l)
+                    p.net_virial[l] = Scalar(0.0);
+
+                // use contiguous molecule tag
+                molecule_tag[p.tag] = mol;
+                }
+            }
+        }
+
+    m_exec_conf->msg->notice(2) << "constrain.rigid(): Creating " << n_global[0] << " rigid bodies (adding "
+        << n_global[1] << " particles)" << std::endl;
+
+    std::set<unsigned int> removed_tags = m_pdata->getRemovedTags();
+    m_pdata->loadLocalParticles(in, new_tag_end, removed_tags);
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // every entry of the molecule table is set by exactly one rank
+        MPI_Allreduce(MPI_IN_PLACE, molecule_tag.data(), new_tag_end, MPI_UNSIGNED, MPI_MIN,
+            m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    // store global molecule information in GlobalArray
+    m_molecule_tag.resize(new_tag_end);
+        {
+        ArrayHandle<unsigned int> h_molecule_tag(m_molecule_tag, access_location::host, access_mode::overwrite);
+        std::copy(molecule_tag.begin(), molecule_tag.end(), h_molecule_tag.data);
+        }
+
+    // store number of molecules
+    m_n_molecules_global = n_global[0];
+
+    return true;
+    }
+
 #ifdef ENABLE_MPI
 /*! \param timestep Current time step
  */
@@ -920,28 +1139,27 @@ void ForceComposite::computeForces(uint64_t timestep)
 
 /* Set position and velocity of constituent particles in rigid bodies in the 1st or second half of integration on the CPU
     based on the body center of mass and particle relative position in each body frame.
+
+    The loop runs over the local molecules, whose member lists are cached by MolecularForceCompute and only rebuilt
+    when the particles are reordered or communicated. The central particle of each body is looked up and loaded only
+    once, and its constituents are then read in order from the molecule list.
 */
 
 void ForceComposite::updateCompositeParticles(uint64_t timestep)
     {
     // access molecule order (this needs to be on top because of ArrayHandle scope)
-    ArrayHandle<unsigned int> h_molecule_order(getMoleculeOrder(), access_location::host, access_mode::read);
+    const Index2D& molecule_indexer = getMoleculeIndexer();
+    ArrayHandle<unsigned int> h_molecule_list(getMoleculeList(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_molecule_len(getMoleculeLengths(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_molecule_idx(getMoleculeIndex(), access_location::host, access_mode::read);
+    const unsigned int n_molecules = molecule_indexer.getH();
 
     // access the particle data arrays
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    /*
-    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    */
-
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     // access body positions and orientations
     ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
@@ -951,25 +1169,40 @@ void ForceComposite::updateCompositeParticles(uint64_t timestep)
     const BoxDim& box = m_pdata->getBox();
     const BoxDim& global_box = m_pdata->getGlobalBox();
 
-    // we need to update both local and ghost particles
-    unsigned int nptl = m_pdata->getN() + m_pdata->getNGhosts();
+    // molecules hold both local and ghost particles, which both need to be updated
+    const unsigned int nptl_local = m_pdata->getN();
 
-    for (unsigned int iptl = 0; iptl < nptl; iptl++)
+    for (unsigned int imol = 0; imol < n_molecules; ++imol)
         {
-        unsigned int central_tag = h_body.data[iptl];
+        const unsigned int mol_len = h_molecule_len.data[imol];
+        if (mol_len == 0)
+            continue;
 
+        // all members of the molecule have the same body tag, which is the tag of the central ptl
+        const unsigned int central_tag = h_body.data[h_molecule_list.data[molecule_indexer(0, imol)]];
         if (central_tag >= MIN_FLOPPY)
             continue;
 
+        // molecules that are only in the ghost layer may be incomplete, and are ignored
+        bool has_local = false;
+        for (unsigned int n = 0; n < mol_len; ++n)
+            {
+            if (h_molecule_list.data[molecule_indexer(n, imol)] < nptl_local)
+                {
+                has_local = true;
+                break;
+                }
+            }
+
         // body tag equals tag for central ptl
         assert(central_tag <= m_pdata->getMaximumTag());
-        unsigned int central_idx = h_rtag.data[central_tag];
-
-        if (central_idx == NOT_LOCAL && iptl >= m_pdata->getN())
-            continue;
+        const unsigned int central_idx = h_rtag.data[central_tag];
 
         if (central_idx == NOT_LOCAL)
             {
+            if (!has_local)
+                continue;
+
             m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Missing central particle tag " << central_tag
                                               << "!" << std::endl << std::endl;
             throw std::runtime_error("Error updating composite particles.\n");
@@ -977,22 +1210,18 @@ void ForceComposite::updateCompositeParticles(uint64_t timestep)
 
         // central ptl position and orientation
         assert(central_idx <= m_pdata->getN() + m_pdata->getNGhosts());
-
-        // do not overwrite the central ptl
-        if (iptl == central_idx) continue;
-
         Scalar4 postype = h_postype.data[central_idx];
         vec3<Scalar> pos(postype);
         quat<Scalar> orientation(h_orientation.data[central_idx]);
+        int3 img = h_image.data[central_idx];
 
         // body type
         unsigned int type = __scalar_as_int(postype.w);
 
         unsigned int body_len = h_body_len.data[type];
-        unsigned int mol_idx = h_molecule_idx.data[iptl];
-        if (body_len != h_molecule_len.data[mol_idx] - 1)
+        if (body_len != mol_len - 1)
             {
-            if (iptl < m_pdata->getN())
+            if (has_local)
                 {
                 // if the molecule is incomplete and has local members, this is an error
                 m_exec_conf->msg->errorAllRanks() << "constrain.rigid(): Composite particle with body tag "
@@ -1004,33 +1233,85 @@ void ForceComposite::updateCompositeParticles(uint64_t timestep)
             continue;
             }
 
-        int3 img = h_image.data[central_idx];
+        // the molecule members are ordered by tag, so the central ptl comes first, followed by the constituents
+        assert(h_molecule_list.data[molecule_indexer(0, imol)] == central_idx);
+        for (unsigned int idx_in_body = 0; idx_in_body < body_len; ++idx_in_body)
+            {
+            const unsigned int iptl = h_molecule_list.data[molecule_indexer(idx_in_body + 1, imol)];
 
-        // fetch relative index in body from molecule list
-        assert(h_molecule_order.data[iptl] > 0);
-        unsigned int idx_in_body = h_molecule_order.data[iptl] - 1;
+            vec3<Scalar> local_pos(h_body_pos.data[m_body_idx(type,idx_in_body)]);
+            vec3<Scalar> dr_space = rotate(orientation, local_pos);
 
-        vec3<Scalar> local_pos(h_body_pos.data[m_body_idx(type,idx_in_body)]);
-        vec3<Scalar> dr_space = rotate(orientation, local_pos);
+            // update position and orientation
+            vec3<Scalar> updated_pos(pos);
+            quat<Scalar> local_orientation(h_body_orientation.data[m_body_idx(type, idx_in_body)]);
 
-        // update position and orientation
-        vec3<Scalar> updated_pos(pos);
-        quat<Scalar> local_orientation(h_body_orientation.data[m_body_idx(type, idx_in_body)]);
+            updated_pos += dr_space;
+            quat<Scalar> updated_orientation = orientation*local_orientation;
 
-        updated_pos += dr_space;
-        quat<Scalar> updated_orientation = orientation*local_orientation;
+            // this runs before the ForceComputes,
+            // wrap into box, allowing rigid bodies to span multiple images
+            int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
+            int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
+            updated_pos = global_box.shift(updated_pos, negimgi);
 
-        // this runs before the ForceComputes,
-        // wrap into box, allowing rigid bodies to span multiple images
-        int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
-        int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
-        updated_pos = global_box.shift(updated_pos, negimgi);
+            h_postype.data[iptl] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, h_postype.data[iptl].w);
+            h_orientation.data[iptl] = quat_to_scalar4(updated_orientation);
+            h_image.data[iptl] = img+imgi;
+            }
+        }
+    }
+
+#ifdef ENABLE_MPI
+/*! \param reconstructed Per-particle flags, set to 1 for the ghosts placed by updateCompositeParticles()
+
+    The constituents of a body are placed from its central particle after every ghost update when the body is
+    complete on this rank, so the Communicator does not need to update their positions and orientations.
+*/
+void ForceComposite::markReconstructedGhosts(const GlobalArray<unsigned int>& reconstructed)
+    {
+    const Index2D& molecule_indexer = getMoleculeIndexer();
+    ArrayHandle<unsigned int> h_molecule_list(getMoleculeList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_molecule_len(getMoleculeLengths(), access_location::host, access_mode::read);
+    const unsigned int n_molecules = molecule_indexer.getH();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
+
+    ArrayHandle<unsigned int> h_reconstructed(reconstructed, access_location::host, access_mode::readwrite);
+
+    const unsigned int nptl_local = m_pdata->getN();
 
-        h_postype.data[iptl] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, h_postype.data[iptl].w);
-        h_orientation.data[iptl] = quat_to_scalar4(updated_orientation);
-        h_image.data[iptl] = img+imgi;
+    for (unsigned int imol = 0; imol < n_molecules; ++imol)
+        {
+        const unsigned int mol_len = h_molecule_len.data[imol];
+        if (mol_len == 0)
+            continue;
+
+        const unsigned int central_tag = h_body.data[h_molecule_list.data[molecule_indexer(0, imol)]];
+        if (central_tag >= MIN_FLOPPY)
+            continue;
+
+        const unsigned int central_idx = h_rtag.data[central_tag];
+        if (central_idx == NOT_LOCAL)
+            continue;
+
+        // incomplete bodies are skipped by updateCompositeParticles()
+        unsigned int type = __scalar_as_int(h_postype.data[central_idx].w);
+        if (h_body_len.data[type] != mol_len - 1)
+            continue;
+
+        for (unsigned int n = 1; n < mol_len; ++n)
+            {
+            const unsigned int iptl = h_molecule_list.data[molecule_indexer(n, imol)];
+            if (iptl >= nptl_local)
+                h_reconstructed.data[iptl] = 1;
+            }
         }
     }
+#endif
 
 void export_ForceComposite(py::module& m)
     {
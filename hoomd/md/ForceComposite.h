@@ -96,6 +96,9 @@ class PYBIND11_EXPORT ForceComposite : public MolecularForceCompute
         //! Helper function to be called when the number of types changes
         void slotNumTypesChange();
 
+        //! Create the constituent particles of the local central particles on every rank
+        bool createRigidBodiesLocal();
+
         //! Method to be called when particles are added or removed
         void slotPtlsAddedRemoved()
             {
@@ -142,9 +145,13 @@ class PYBIND11_EXPORT ForceComposite : public MolecularForceCompute
                 {
                 // register this class with the communicator
                 m_comm->getExtraGhostLayerWidthRequestSignal().connect<ForceComposite, &ForceComposite::requestExtraGhostLayerWidth>(this);
+                m_comm->getGhostReconstructionRequestSignal().connect<ForceComposite, &ForceComposite::markReconstructedGhosts>(this);
                 m_comm_ghost_layer_connected = true;
                 }
            }
+
+        //! Mark the ghost constituents that updateCompositeParticles() places
+        void markReconstructedGhosts(const GlobalArray<unsigned int>& reconstructed);
         #endif
 
         //! Compute the forces and torques on the central particle
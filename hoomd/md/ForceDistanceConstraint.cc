@@ -20,7 +20,8 @@ ForceDistanceConstraint::ForceDistanceConstraint(std::shared_ptr<SystemDefinitio
         : MolecularForceCompute(sysdef), m_cdata(m_sysdef->getConstraintData()),
           m_cmatrix(m_exec_conf), m_cvec(m_exec_conf), m_lagrange(m_exec_conf),
           m_rel_tol(1e-3), m_constraint_violated(m_exec_conf), m_condition(m_exec_conf),
-          m_sparse_idxlookup(m_exec_conf), m_constraint_reorder(true), m_constraints_added_removed(true),
+          m_sparse_idxlookup(m_exec_conf), m_iterative(false), m_solver_tol(1e-8), m_max_iterations(100),
+          m_warm_start(false), m_constraint_reorder(true), m_constraints_added_removed(true),
           m_d_max(0.0)
     {
     m_constraint_violated.resetFlags(0);
@@ -312,7 +313,11 @@ void ForceDistanceConstraint::solveConstraints(uint64_t timestep)
         m_prof->push("solve");
 
     // reallocate array of constraint forces
-    m_lagrange.resize(n_constraint);
+    if (m_lagrange.size() != n_constraint)
+        {
+        m_lagrange.resize(n_constraint);
+        m_warm_start = false;
+        }
 
     unsigned int sparsity_pattern_changed = m_condition.readFlags();
 
@@ -377,6 +382,43 @@ void ForceDistanceConstraint::solveConstraints(uint64_t timestep)
         }
 
 
+    // access RHS and solution vector
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::read);
+    ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::readwrite);
+    vec_map_t map_vec(h_cvec.data, n_constraint, 1);
+    vec_map_t map_lagrange(h_lagrange.data,n_constraint, 1);
+
+    if (m_iterative)
+        {
+        if (m_prof)
+            m_prof->push("iterate");
+
+        // start from the solution of the last step, if it is for the same constraints
+        if (!m_warm_start)
+            map_lagrange.setZero();
+
+        m_iterative_solver.setTolerance(m_solver_tol);
+        m_iterative_solver.setMaxIterations(m_max_iterations);
+        m_iterative_solver.compute(m_sparse);
+        map_lagrange = m_iterative_solver.solveWithGuess(map_vec, map_lagrange);
+
+        if (m_prof)
+            m_prof->pop();
+
+        if (m_iterative_solver.info() == Eigen::Success)
+            {
+            m_warm_start = true;
+
+            if (m_prof)
+                m_prof->pop();
+            return;
+            }
+
+        m_exec_conf->msg->notice(6) << "ForceDistanceConstraint: iterative solver did not converge after "
+                                    << m_iterative_solver.iterations() << " iterations. Solving directly"
+                                    << std::endl;
+        }
+
     if (m_prof)
         m_prof->push("refactor/solve");
 
@@ -389,14 +431,9 @@ void ForceDistanceConstraint::solveConstraints(uint64_t timestep)
         throw std::runtime_error("Error evaluating constraint forces.\n");
         }
 
-    // access RHS and solution vector
-    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::read);
-    ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::overwrite);
-    vec_map_t map_vec(h_cvec.data, n_constraint, 1);
-    vec_map_t map_lagrange(h_lagrange.data,n_constraint, 1);
-
     //Use the factors to solve the linear system
     map_lagrange = m_sparse_solver.solve(map_vec);
+    m_warm_start = true;
 
     if (m_prof)
         m_prof->pop();
@@ -629,5 +666,8 @@ void export_ForceDistanceConstraint(py::module& m)
     py::class_< ForceDistanceConstraint, MolecularForceCompute, std::shared_ptr<ForceDistanceConstraint> >(m, "ForceDistanceConstraint")
         .def(py::init< std::shared_ptr<SystemDefinition> >())
         .def("setRelativeTolerance", &ForceDistanceConstraint::setRelativeTolerance)
+        .def("setIterative", &ForceDistanceConstraint::setIterative)
+        .def("setSolverTolerance", &ForceDistanceConstraint::setSolverTolerance)
+        .def("setMaxIterations", &ForceDistanceConstraint::setMaxIterations)
     ;
     }
@@ -23,6 +23,7 @@
 #include "hoomd/GPUFlags.h"
 
 #include <Eigen/Dense>
+#include <Eigen/IterativeLinearSolvers>
 #include <Eigen/SparseLU>
 
 /*! Implements a pairwise distance constraint using the algorithm of
@@ -30,6 +31,12 @@
     [1] M. Yoneya, H. J. C. Berendsen, and K. Hirasawa, “A Non-Iterative Matrix Method for Constraint Molecular Dynamics Simulations,” Mol. Simul., vol. 13, no. 6, pp. 395–405, 1994.
     [2] M. Yoneya, “A Generalized Non-iterative Matrix Method for Constraint Molecular Dynamics Simulations,” J. Comput. Phys., vol. 172, no. 1, pp. 188–197, Sep. 2001.
 
+    By default, the sparse constraint matrix is factorized and solved directly on every step. Optionally, the
+    equations are solved iteratively with a Jacobi-preconditioned BiCGSTAB method, starting from the Lagrange
+    multipliers of the previous step. The multipliers change little between steps, so few iterations are needed,
+    and no factorization is performed. If the iteration does not converge on the CPU, the direct solver is used
+    for that step.
+
     See Integrator for detailed documentation on constraint force implementation.
     \ingroup computes
 */
@@ -54,6 +61,24 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
             m_rel_tol = rel_tol;
             }
 
+        //! Set whether the constraint equations are solved iteratively
+        void setIterative(bool iterative)
+            {
+            m_iterative = iterative;
+            }
+
+        //! Set the relative residual at which the iterative solver stops
+        void setSolverTolerance(Scalar solver_tol)
+            {
+            m_solver_tol = solver_tol;
+            }
+
+        //! Set the maximum number of iterations of the iterative solver
+        void setMaxIterations(unsigned int max_iterations)
+            {
+            m_max_iterations = max_iterations;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(uint64_t timestep);
@@ -78,6 +103,13 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
             //!< The persistent state of the sparse matrix solver
         GPUVector<int> m_sparse_idxlookup;          //!< Reverse lookup from column-major to sparse matrix element
 
+        bool m_iterative;                  //!< True if the constraint equations are solved iteratively
+        Scalar m_solver_tol;               //!< Relative residual at which the iterative solver stops
+        unsigned int m_max_iterations;     //!< Maximum number of iterations of the iterative solver
+        bool m_warm_start;                 //!< True if m_lagrange holds the solution for the current constraint order
+        Eigen::BiCGSTAB<Eigen::SparseMatrix<double, Eigen::ColMajor>, Eigen::DiagonalPreconditioner<double> >
+            m_iterative_solver;            //!< The iterative sparse matrix solver
+
         bool m_constraint_reorder;         //!< True if groups have changed
         bool m_constraints_added_removed;  //!< True if global constraint topology has changed
 
@@ -102,12 +134,14 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
         virtual void slotConstraintReorder()
             {
             m_constraint_reorder = true;
+            m_warm_start = false;
             }
 
         //! Method called when constraint order changes
         virtual void slotConstraintsAddedRemoved()
             {
             m_constraints_added_removed = true;
+            m_warm_start = false;
             }
 
         //! Returns the requested ghost layer width for all types
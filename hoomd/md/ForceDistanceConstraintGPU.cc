@@ -26,7 +26,7 @@ ForceDistanceConstraintGPU::ForceDistanceConstraintGPU(std::shared_ptr<SystemDef
         m_csr_val_L(m_exec_conf), m_csr_rowptr_L(m_exec_conf), m_csr_colind_L(m_exec_conf),
         m_csr_val_U(m_exec_conf), m_csr_rowptr_U(m_exec_conf), m_csr_colind_U(m_exec_conf),
         m_P(m_exec_conf), m_Q(m_exec_conf), m_T(m_exec_conf),
-        m_nnz(m_exec_conf), m_nnz_tot(0)
+        m_nnz(m_exec_conf), m_nnz_tot(0), m_lu_valid(false), m_solver_work(m_exec_conf)
 #endif
     {
     unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
@@ -127,13 +127,15 @@ void ForceDistanceConstraintGPU::fillMatrixVector(uint64_t timestep)
         ArrayHandle<double> d_cvec(m_cvec, access_location::device, access_mode::overwrite);
 
         // access GPU constraint table on device
-        const GPUArray<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
+        const GlobalArray<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
         const Index2D& gpu_table_indexer = this->m_cdata->getGPUTableIndexer();
 
         ArrayHandle<ConstraintData::members_t> d_gpu_clist(gpu_constraint_list, access_location::device, access_mode::read);
         ArrayHandle<unsigned int > d_gpu_n_constraints(this->m_cdata->getNGroupsArray(),
                                                  access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_gpu_cpos(m_cdata->getGPUPosTable(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_clist_offsets(m_cdata->getGPUTableOffsets(), access_location::device,
+            access_mode::read);
         ArrayHandle<typeval_t> d_group_typeval(m_cdata->getTypeValArray(), access_location::device, access_mode::read);
 
         // access particle data
@@ -163,6 +165,7 @@ void ForceDistanceConstraintGPU::fillMatrixVector(uint64_t timestep)
             d_netforce.data,
             d_gpu_clist.data,
             gpu_table_indexer,
+            d_gpu_clist_offsets.data,
             d_gpu_n_constraints.data,
             d_gpu_cpos.data,
             d_group_typeval.data,
@@ -208,8 +211,12 @@ void ForceDistanceConstraintGPU::solveConstraints(uint64_t timestep)
     if (m_prof)
         m_prof->push(m_exec_conf,"solve");
 
-    // reallocate array of constraint forces
-    m_lagrange.resize(n_constraint);
+    // reallocate array of constraint forces, the previous solution is kept as initial guess if the size is unchanged
+    if (m_lagrange.size() != n_constraint)
+        {
+        m_lagrange.resize(n_constraint);
+        m_warm_start = false;
+        }
 
     // resize sparse matrix storage
     m_nnz.resize(n_constraint);
@@ -300,6 +307,13 @@ void ForceDistanceConstraintGPU::solveConstraints(uint64_t timestep)
                 }
             }
 
+        // the LU factorization has to be recomputed for the new sparsity pattern
+        m_lu_valid = false;
+        }
+
+    // the iterative solver does not need the LU factorization
+    if (!m_iterative && !m_lu_valid)
+        {
         m_exec_conf->msg->notice(6) << "ForceDistanceConstraintGPU: sparsity pattern changed. Solving on CPU" << std::endl;
 
         if (m_prof)
@@ -506,10 +520,55 @@ void ForceDistanceConstraintGPU::solveConstraints(uint64_t timestep)
          */
         cusolverRfAnalyze(m_cusolver_rf_handle);
 
+        m_lu_valid = true;
+
+        if (m_prof)
+            m_prof->pop(m_exec_conf);
+
+        } // end if LU factorization is invalid
+
+    // access sparse matrix structural data
+    ArrayHandle<int> d_csr_colind(m_csr_colind, access_location::device, access_mode::read);
+    ArrayHandle<int> d_csr_rowptr(m_csr_rowptr, access_location::device, access_mode::read);
+    ArrayHandle<double> d_sparse_val(m_sparse_val, access_location::device, access_mode::read);
+
+    if (m_iterative)
+        {
+        if (m_prof)
+            m_prof->push(m_exec_conf, "iterative");
+
+        m_solver_work.resize(gpu_solve_constraints_iterative_work_size(n_constraint));
+
+        ArrayHandle<double> d_solver_work(m_solver_work, access_location::device, access_mode::overwrite);
+        ArrayHandle<double> d_lagrange(m_lagrange, access_location::device, access_mode::readwrite);
+        ArrayHandle<double> d_vec(m_cvec, access_location::device, access_mode::read);
+
+        // start from the multipliers of the previous step when available
+        if (!m_warm_start)
+            hipMemset(d_lagrange.data, 0, sizeof(double)*n_constraint);
+
+        // a fixed number of iterations avoids synchronizing with the host to check convergence
+        gpu_solve_constraints_iterative(n_constraint,
+            d_csr_rowptr.data,
+            d_csr_colind.data,
+            d_sparse_val.data,
+            d_vec.data,
+            d_lagrange.data,
+            d_solver_work.data,
+            m_max_iterations);
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        m_warm_start = true;
+
         if (m_prof)
             m_prof->pop(m_exec_conf);
 
-        } // end if sparsity pattern changed
+        if (m_prof)
+            m_prof->pop(m_exec_conf);
+        return;
+        }
 
     if (m_prof)
         m_prof->push(m_exec_conf, "refactor");
@@ -517,11 +576,6 @@ void ForceDistanceConstraintGPU::solveConstraints(uint64_t timestep)
     // reallocate work space for cusolverRf
     m_T.resize(n_constraint);
 
-    // access sparse matrix structural data
-    ArrayHandle<int> d_csr_colind(m_csr_colind, access_location::device, access_mode::read);
-    ArrayHandle<int> d_csr_rowptr(m_csr_rowptr, access_location::device, access_mode::read);
-    ArrayHandle<double> d_sparse_val(m_sparse_val, access_location::device, access_mode::read);
-
     // permutations
     ArrayHandle<int> d_P(m_P, access_location::device, access_mode::read);
     ArrayHandle<int> d_Q(m_Q, access_location::device, access_mode::read);
@@ -550,6 +604,8 @@ void ForceDistanceConstraintGPU::solveConstraints(uint64_t timestep)
     cusolverRfSolve(m_cusolver_rf_handle, d_P.data, d_Q.data, nrhs, d_T.data, n_constraint,
         d_lagrange.data, n_constraint);
 
+    m_warm_start = true;
+
     if (m_prof)
         m_prof->pop(m_exec_conf);
 
@@ -574,13 +630,15 @@ void ForceDistanceConstraintGPU::computeConstraintForces(uint64_t timestep)
     ArrayHandle<Scalar> d_virial(m_virial, access_location::device, access_mode::overwrite);
 
     // access GPU constraint table on device
-    const GPUArray<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
+    const GlobalArray<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
     const Index2D& gpu_table_indexer = this->m_cdata->getGPUTableIndexer();
 
     ArrayHandle<ConstraintData::members_t> d_gpu_clist(gpu_constraint_list, access_location::device, access_mode::read);
     ArrayHandle<unsigned int > d_gpu_n_constraints(this->m_cdata->getNGroupsArray(),
                                              access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_gpu_cpos(m_cdata->getGPUPosTable(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_clist_offsets(m_cdata->getGPUTableOffsets(), access_location::device,
+        access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
 
@@ -591,6 +649,7 @@ void ForceDistanceConstraintGPU::computeConstraintForces(uint64_t timestep)
     gpu_compute_constraint_forces(d_pos.data,
         d_gpu_clist.data,
         gpu_table_indexer,
+        d_gpu_clist_offsets.data,
         d_gpu_n_constraints.data,
         d_gpu_cpos.data,
         d_force.data,
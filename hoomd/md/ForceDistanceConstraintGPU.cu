@@ -27,6 +27,7 @@ __global__ void gpu_fill_matrix_vector_kernel(unsigned int n_constraint,
                                               const Scalar4 *d_netforce,
                                               const group_storage<2> *d_gpu_clist,
                                               const Index2D gpu_clist_indexer,
+                                              const unsigned int *d_gpu_clist_offsets,
                                               const unsigned int *d_gpu_n_constraints,
                                               const unsigned int *d_gpu_cpos,
                                               const typeval_union *d_group_typeval,
@@ -41,11 +42,12 @@ __global__ void gpu_fill_matrix_vector_kernel(unsigned int n_constraint,
 
     // load number of constraints per this ptl
     unsigned int n_constraint_ptl = d_gpu_n_constraints[idx];
+    unsigned int clist_start = d_gpu_clist_offsets[idx];
 
     // small O(N^2) loop over ptl connectivity
     for (unsigned int cidx_i = 0; cidx_i < n_constraint_ptl; cidx_i++)
         {
-        group_storage<2> cur_constraint_i = d_gpu_clist[gpu_clist_indexer(idx, cidx_i)];
+        group_storage<2> cur_constraint_i = d_gpu_clist[gpu_clist_indexer(clist_start, cidx_i)];
 
         // the other ptl in the constraint
         unsigned int cur_constraint_idx_i = cur_constraint_i.idx[0];
@@ -58,7 +60,7 @@ __global__ void gpu_fill_matrix_vector_kernel(unsigned int n_constraint,
 
         // indices of constrained ptls in correct order
         unsigned int idx_na, idx_nb;
-        unsigned int cpos = d_gpu_cpos[gpu_clist_indexer(idx, cidx_i)];
+        unsigned int cpos = d_gpu_cpos[gpu_clist_indexer(clist_start, cidx_i)];
         if (cpos == 0)
             {
             idx_na = idx;
@@ -88,17 +90,18 @@ __global__ void gpu_fill_matrix_vector_kernel(unsigned int n_constraint,
 
         // load number of constraints per this ptl
         unsigned int n_constraint_i = d_gpu_n_constraints[cur_constraint_idx_i];
+        unsigned int clist_start_i = d_gpu_clist_offsets[cur_constraint_idx_i];
 
         for (unsigned int cidx_j = 0; cidx_j < n_constraint_i; cidx_j++)
             {
-            group_storage<2> cur_constraint_j = d_gpu_clist[gpu_clist_indexer(cur_constraint_idx_i, cidx_j)];
+            group_storage<2> cur_constraint_j = d_gpu_clist[gpu_clist_indexer(clist_start_i, cidx_j)];
 
             // the other ptl in the constraint
             unsigned int cur_constraint_idx_j = cur_constraint_j.idx[0];
 
             // indices of constrained ptls in correct order
             unsigned int idx_ma, idx_mb;
-            if (d_gpu_cpos[gpu_clist_indexer(cur_constraint_idx_i, cidx_j)] == 0)
+            if (d_gpu_cpos[gpu_clist_indexer(clist_start_i, cidx_j)] == 0)
                 {
                 idx_ma = cur_constraint_idx_i;
                 idx_mb = cur_constraint_idx_j;
@@ -180,6 +183,7 @@ hipError_t gpu_fill_matrix_vector(unsigned int n_constraint,
                           const Scalar4 *d_netforce,
                           const group_storage<2> *d_gpu_clist,
                           const Index2D & gpu_clist_indexer,
+                          const unsigned int *d_gpu_clist_offsets,
                           const unsigned int *d_gpu_n_constraints,
                           const unsigned int *d_gpu_cpos,
                           const typeval_union *d_group_typeval,
@@ -215,6 +219,7 @@ hipError_t gpu_fill_matrix_vector(unsigned int n_constraint,
         d_netforce,
         d_gpu_clist,
         gpu_clist_indexer,
+        d_gpu_clist_offsets,
         d_gpu_n_constraints,
         d_gpu_cpos,
         d_group_typeval,
@@ -228,6 +233,7 @@ __global__ void gpu_fill_constraint_forces_kernel(unsigned int nptl_local,
                                         const Scalar4 *d_pos,
                                         const group_storage<2> *d_gpu_clist,
                                         const Index2D gpu_clist_indexer,
+                                        const unsigned int *d_gpu_clist_offsets,
                                         const unsigned int *d_gpu_n_constraints,
                                         const unsigned int *d_gpu_cpos,
                                         double *d_lagrange,
@@ -243,6 +249,7 @@ __global__ void gpu_fill_constraint_forces_kernel(unsigned int nptl_local,
 
     // load number of constraints per this ptl
     unsigned int n_constraint_ptl = d_gpu_n_constraints[idx];
+    unsigned int clist_start = d_gpu_clist_offsets[idx];
 
     // the accumulated force on this ptl
     vec3<Scalar> f(0.0,0.0,0.0);
@@ -258,7 +265,7 @@ __global__ void gpu_fill_constraint_forces_kernel(unsigned int nptl_local,
     // iterate over constraints involving ptl with index idx
     for (unsigned int cidx = 0; cidx < n_constraint_ptl; cidx++)
         {
-        group_storage<2> cur_constraint = d_gpu_clist[gpu_clist_indexer(idx, cidx)];
+        group_storage<2> cur_constraint = d_gpu_clist[gpu_clist_indexer(clist_start, cidx)];
 
         // the other ptl in the constraint
         unsigned int cur_constraint_idx = cur_constraint.idx[0];
@@ -267,7 +274,7 @@ __global__ void gpu_fill_constraint_forces_kernel(unsigned int nptl_local,
         unsigned int n = cur_constraint.idx[1];
 
         // position of ptl in constraint
-        unsigned int cpos = d_gpu_cpos[gpu_clist_indexer(idx, cidx)];
+        unsigned int cpos = d_gpu_cpos[gpu_clist_indexer(clist_start, cidx)];
 
         // indices of constrained ptls in correct order
         unsigned int idx_na, idx_nb;
@@ -358,6 +365,7 @@ hipError_t gpu_dense2sparse(unsigned int n_constraint,
 hipError_t gpu_compute_constraint_forces(const Scalar4 *d_pos,
                                    const group_storage<2> *d_gpu_clist,
                                    const Index2D& gpu_clist_indexer,
+                                   const unsigned int *d_gpu_clist_offsets,
                                    const unsigned int *d_gpu_n_constraints,
                                    const unsigned int *d_gpu_cpos,
                                    Scalar4 *d_force,
@@ -388,6 +396,7 @@ hipError_t gpu_compute_constraint_forces(const Scalar4 *d_pos,
         d_pos,
         d_gpu_clist,
         gpu_clist_indexer,
+        d_gpu_clist_offsets,
         d_gpu_n_constraints,
         d_gpu_cpos,
         d_lagrange,
@@ -398,3 +407,294 @@ hipError_t gpu_compute_constraint_forces(const Scalar4 *d_pos,
 
     return hipSuccess;
     }
+
+//! Block size of the iterative solver kernels
+const unsigned int bicgstab_block_size = 256;
+
+//! Maximum number of blocks in the dot product kernels
+const unsigned int bicgstab_max_dot_blocks = 1024;
+
+//! Slots of the scalars of the iterative solver in device memory
+enum bicgstab_scalar
+    {
+    bicgstab_rho = 0,       //!< (rhat, r) of the last iteration
+    bicgstab_alpha,         //!< Step along the search direction
+    bicgstab_omega,         //!< Step along the stabilizing direction
+    bicgstab_rho_new,       //!< (rhat, r) of this iteration
+    bicgstab_rhat_v,        //!< (rhat, v)
+    bicgstab_t_s,           //!< (t, s)
+    bicgstab_t_t,           //!< (t, t)
+    bicgstab_num_scalars
+    };
+
+//! Divide two scalars, returning zero if the quotient is not finite
+/*! This stops the iteration from updating the solution once it has converged exactly, instead of producing NaN.
+*/
+__device__ inline double bicgstab_div(double a, double b)
+    {
+    const double q = (b != 0.0) ? a/b : 0.0;
+    return isfinite(q) ? q : 0.0;
+    }
+
+//! Compute one row of a sparse matrix-vector product
+__device__ inline double bicgstab_row_dot(unsigned int row,
+                                          const int *d_csr_rowptr,
+                                          const int *d_csr_colind,
+                                          const double *d_csr_val,
+                                          const double *d_x)
+    {
+    double y = 0.0;
+    for (int k = d_csr_rowptr[row]; k < d_csr_rowptr[row+1]; ++k)
+        y += d_csr_val[k]*d_x[d_csr_colind[k]];
+    return y;
+    }
+
+//! Kernel to set up the iterative solver from the initial guess
+__global__ void gpu_bicgstab_init_kernel(unsigned int n,
+                                         const int *d_csr_rowptr,
+                                         const int *d_csr_colind,
+                                         const double *d_csr_val,
+                                         const double *d_b,
+                                         const double *d_x,
+                                         double *d_r,
+                                         double *d_rhat,
+                                         double *d_p,
+                                         double *d_v,
+                                         double *d_dinv,
+                                         double *d_scalars)
+    {
+    unsigned int row = blockIdx.x*blockDim.x + threadIdx.x;
+
+    if (row == 0)
+        {
+        d_scalars[bicgstab_rho] = 1.0;
+        d_scalars[bicgstab_alpha] = 1.0;
+        d_scalars[bicgstab_omega] = 1.0;
+        }
+
+    if (row >= n)
+        return;
+
+    // Jacobi preconditioner
+    double diag = 0.0;
+    for (int k = d_csr_rowptr[row]; k < d_csr_rowptr[row+1]; ++k)
+        {
+        if (d_csr_colind[k] == (int)row)
+            diag = d_csr_val[k];
+        }
+    d_dinv[row] = (diag != 0.0) ? 1.0/diag : 1.0;
+
+    const double r = d_b[row] - bicgstab_row_dot(row, d_csr_rowptr, d_csr_colind, d_csr_val, d_x);
+    d_r[row] = r;
+    d_rhat[row] = r;
+    d_p[row] = 0.0;
+    d_v[row] = 0.0;
+    }
+
+//! Kernel to compute the partial sums of a dot product per block
+__global__ void gpu_bicgstab_dot_kernel(unsigned int n, const double *d_a, const double *d_b, double *d_partial)
+    {
+    __shared__ double s_sum[bicgstab_block_size];
+
+    double sum = 0.0;
+    for (unsigned int i = blockIdx.x*blockDim.x + threadIdx.x; i < n; i += blockDim.x*gridDim.x)
+        sum += d_a[i]*d_b[i];
+    s_sum[threadIdx.x] = sum;
+    __syncthreads();
+
+    for (unsigned int offset = blockDim.x/2; offset > 0; offset >>= 1)
+        {
+        if (threadIdx.x < offset)
+            s_sum[threadIdx.x] += s_sum[threadIdx.x + offset];
+        __syncthreads();
+        }
+
+    if (threadIdx.x == 0)
+        d_partial[blockIdx.x] = s_sum[0];
+    }
+
+//! Kernel to sum the partial sums of a dot product into one scalar
+__global__ void gpu_bicgstab_dot_finish_kernel(unsigned int n_partial, const double *d_partial, double *d_result)
+    {
+    __shared__ double s_sum[bicgstab_block_size];
+
+    double sum = 0.0;
+    for (unsigned int i = threadIdx.x; i < n_partial; i += blockDim.x)
+        sum += d_partial[i];
+    s_sum[threadIdx.x] = sum;
+    __syncthreads();
+
+    for (unsigned int offset = blockDim.x/2; offset > 0; offset >>= 1)
+        {
+        if (threadIdx.x < offset)
+            s_sum[threadIdx.x] += s_sum[threadIdx.x + offset];
+        __syncthreads();
+        }
+
+    if (threadIdx.x == 0)
+        *d_result = s_sum[0];
+    }
+
+//! Kernel to compute a sparse matrix-vector product
+__global__ void gpu_bicgstab_spmv_kernel(unsigned int n,
+                                         const int *d_csr_rowptr,
+                                         const int *d_csr_colind,
+                                         const double *d_csr_val,
+                                         const double *d_x,
+                                         double *d_y)
+    {
+    unsigned int row = blockIdx.x*blockDim.x + threadIdx.x;
+    if (row >= n)
+        return;
+
+    d_y[row] = bicgstab_row_dot(row, d_csr_rowptr, d_csr_colind, d_csr_val, d_x);
+    }
+
+//! Kernel to update the search direction
+__global__ void gpu_bicgstab_update_p_kernel(unsigned int n,
+                                             const double *d_r,
+                                             const double *d_v,
+                                             const double *d_dinv,
+                                             double *d_p,
+                                             double *d_phat,
+                                             const double *d_scalars)
+    {
+    unsigned int i = blockIdx.x*blockDim.x + threadIdx.x;
+    if (i >= n)
+        return;
+
+    const double beta = bicgstab_div(d_scalars[bicgstab_rho_new], d_scalars[bicgstab_rho])
+                        *bicgstab_div(d_scalars[bicgstab_alpha], d_scalars[bicgstab_omega]);
+    const double p = d_r[i] + beta*(d_p[i] - d_scalars[bicgstab_omega]*d_v[i]);
+    d_p[i] = p;
+    d_phat[i] = d_dinv[i]*p;
+    }
+
+//! Kernel to compute the intermediate residual
+__global__ void gpu_bicgstab_update_s_kernel(unsigned int n,
+                                             const double *d_r,
+                                             const double *d_v,
+                                             const double *d_dinv,
+                                             double *d_s,
+                                             double *d_shat,
+                                             double *d_scalars)
+    {
+    unsigned int i = blockIdx.x*blockDim.x + threadIdx.x;
+
+    // no thread reads the stored alpha in this kernel
+    const double alpha = bicgstab_div(d_scalars[bicgstab_rho_new], d_scalars[bicgstab_rhat_v]);
+    if (i == 0)
+        d_scalars[bicgstab_alpha] = alpha;
+
+    if (i >= n)
+        return;
+
+    const double s = d_r[i] - alpha*d_v[i];
+    d_s[i] = s;
+    d_shat[i] = d_dinv[i]*s;
+    }
+
+//! Kernel to update the solution and the residual
+__global__ void gpu_bicgstab_update_x_kernel(unsigned int n,
+                                             const double *d_phat,
+                                             const double *d_shat,
+                                             const double *d_s,
+                                             const double *d_t,
+                                             double *d_x,
+                                             double *d_r,
+                                             double *d_scalars)
+    {
+    unsigned int i = blockIdx.x*blockDim.x + threadIdx.x;
+
+    // no thread reads the stored omega or rho in this kernel
+    const double alpha = d_scalars[bicgstab_alpha];
+    const double omega = bicgstab_div(d_scalars[bicgstab_t_s], d_scalars[bicgstab_t_t]);
+    if (i == 0)
+        {
+        d_scalars[bicgstab_omega] = omega;
+        d_scalars[bicgstab_rho] = d_scalars[bicgstab_rho_new];
+        }
+
+    if (i >= n)
+        return;
+
+    d_x[i] += alpha*d_phat[i] + omega*d_shat[i];
+    d_r[i] = d_s[i] - omega*d_t[i];
+    }
+
+//! Compute a dot product into a scalar in device memory
+static void gpu_bicgstab_dot(unsigned int n, const double *d_a, const double *d_b, double *d_partial, double *d_result)
+    {
+    unsigned int n_blocks = min(n/bicgstab_block_size + 1, bicgstab_max_dot_blocks);
+    hipLaunchKernelGGL((gpu_bicgstab_dot_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+        n, d_a, d_b, d_partial);
+    hipLaunchKernelGGL((gpu_bicgstab_dot_finish_kernel), dim3(1), dim3(bicgstab_block_size), 0, 0,
+        n_blocks, d_partial, d_result);
+    }
+
+/*! \param n Number of constraints
+    \param d_csr_rowptr Row offsets of the sparse constraint matrix
+    \param d_csr_colind Column indexes of the sparse constraint matrix
+    \param d_csr_val Values of the sparse constraint matrix
+    \param d_b Right hand side of the constraint equation
+    \param d_x Initial guess for the Lagrange multipliers (input), and the solution (output)
+    \param d_work Work space of 9*n + bicgstab_max_dot_blocks + 7 doubles
+    \param n_iterations Number of iterations to perform
+
+    Solves the constraint equation with a Jacobi-preconditioned BiCGSTAB method. All scalars of the method stay in
+    device memory, so that a fixed number of iterations runs without synchronizing with the host. Once the residual
+    vanishes, the step lengths are set to zero, which leaves the solution unchanged for the remaining iterations.
+*/
+hipError_t gpu_solve_constraints_iterative(unsigned int n,
+                                           const int *d_csr_rowptr,
+                                           const int *d_csr_colind,
+                                           const double *d_csr_val,
+                                           const double *d_b,
+                                           double *d_x,
+                                           double *d_work,
+                                           unsigned int n_iterations)
+    {
+    if (n == 0)
+        return hipSuccess;
+
+    // partition the work space
+    double *d_r = d_work;
+    double *d_rhat = d_r + n;
+    double *d_p = d_rhat + n;
+    double *d_phat = d_p + n;
+    double *d_v = d_phat + n;
+    double *d_s = d_v + n;
+    double *d_shat = d_s + n;
+    double *d_t = d_shat + n;
+    double *d_dinv = d_t + n;
+    double *d_partial = d_dinv + n;
+    double *d_scalars = d_partial + bicgstab_max_dot_blocks;
+
+    const unsigned int n_blocks = n/bicgstab_block_size + 1;
+
+    hipLaunchKernelGGL((gpu_bicgstab_init_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+        n, d_csr_rowptr, d_csr_colind, d_csr_val, d_b, d_x, d_r, d_rhat, d_p, d_v, d_dinv, d_scalars);
+
+    for (unsigned int iter = 0; iter < n_iterations; ++iter)
+        {
+        gpu_bicgstab_dot(n, d_rhat, d_r, d_partial, d_scalars + bicgstab_rho_new);
+
+        hipLaunchKernelGGL((gpu_bicgstab_update_p_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+            n, d_r, d_v, d_dinv, d_p, d_phat, d_scalars);
+        hipLaunchKernelGGL((gpu_bicgstab_spmv_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+            n, d_csr_rowptr, d_csr_colind, d_csr_val, d_phat, d_v);
+        gpu_bicgstab_dot(n, d_rhat, d_v, d_partial, d_scalars + bicgstab_rhat_v);
+
+        hipLaunchKernelGGL((gpu_bicgstab_update_s_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+            n, d_r, d_v, d_dinv, d_s, d_shat, d_scalars);
+        hipLaunchKernelGGL((gpu_bicgstab_spmv_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+            n, d_csr_rowptr, d_csr_colind, d_csr_val, d_shat, d_t);
+        gpu_bicgstab_dot(n, d_t, d_s, d_partial, d_scalars + bicgstab_t_s);
+        gpu_bicgstab_dot(n, d_t, d_t, d_partial, d_scalars + bicgstab_t_t);
+
+        hipLaunchKernelGGL((gpu_bicgstab_update_x_kernel), dim3(n_blocks), dim3(bicgstab_block_size), 0, 0,
+            n, d_phat, d_shat, d_s, d_t, d_x, d_r, d_scalars);
+        }
+
+    return hipSuccess;
+    }
@@ -26,6 +26,7 @@ hipError_t gpu_fill_matrix_vector(unsigned int n_constraint,
                           const Scalar4 *d_netforce,
                           const group_storage<2> *d_gpu_clist,
                           const Index2D & gpu_clist_indexer,
+                          const unsigned int *d_gpu_clist_offsets,
                           const unsigned int *d_gpu_n_constraints,
                           const unsigned int *d_gpu_cpos,
                           const typeval_union *d_group_typeval,
@@ -53,9 +54,28 @@ hipError_t gpu_dense2sparse(unsigned int n_constraint,
                                double *d_csr_val);
 #endif
 
+hipError_t gpu_solve_constraints_iterative(unsigned int n,
+                                           const int *d_csr_rowptr,
+                                           const int *d_csr_colind,
+                                           const double *d_csr_val,
+                                           const double *d_b,
+                                           double *d_x,
+                                           double *d_work,
+                                           unsigned int n_iterations);
+
+//! Number of doubles in the work space of gpu_solve_constraints_iterative()
+/*! The work space holds nine vectors of length \a n, the partial sums of up to 1024 blocks in the dot products,
+    and the seven scalars of the method.
+*/
+inline unsigned int gpu_solve_constraints_iterative_work_size(unsigned int n)
+    {
+    return 9*n + 1024 + 7;
+    }
+
 hipError_t gpu_compute_constraint_forces(const Scalar4 *d_pos,
                                    const group_storage<2> *d_gpu_clist,
                                    const Index2D & gpu_clist_indexer,
+                                   const unsigned int *d_gpu_clist_offsets,
                                    const unsigned int *d_gpu_n_constraints,
                                    const unsigned int *d_gpu_cpos,
                                    Scalar4 *d_force,
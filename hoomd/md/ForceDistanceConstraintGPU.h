@@ -109,6 +109,9 @@ class ForceDistanceConstraintGPU : public ForceDistanceConstraint
         int m_nnz_tot;                     //!< Total number of non-zero elements
         GPUVector<int> m_csr_rowptr;       //!< Row offset for CSR
         GPUVector<int> m_csr_colind;       //!< Column index for CSR
+
+        bool m_lu_valid;                   //!< True if the LU factorization matches the sparsity pattern
+        GPUVector<double> m_solver_work;   //!< Work space of the iterative solver
         #endif
 
         GPUVector<double> m_sparse_val;    //!< Sparse matrix value list
@@ -0,0 +1,173 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file FusedBondedForceComputeGPU.cc
+    \brief Defines FusedBondedForceComputeGPU
+*/
+
+#include "FusedBondedForceComputeGPU.h"
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \param sysdef System to compute the bonded forces on
+    \param bond Harmonic bond force to take the parameters from (may be null)
+    \param angle Harmonic angle force to take the parameters from (may be null)
+    \param dihedral Harmonic dihedral force to take the parameters from (may be null)
+*/
+FusedBondedForceComputeGPU::FusedBondedForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                                       std::shared_ptr<PotentialBondHarmonic> bond,
+                                                       std::shared_ptr<HarmonicAngleForceComputeGPU> angle,
+                                                       std::shared_ptr<HarmonicDihedralForceComputeGPU> dihedral)
+    : ForceCompute(sysdef), m_bond(bond), m_angle(angle), m_dihedral(dihedral)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing FusedBondedForceComputeGPU" << endl;
+
+    // can't run on the GPU if there aren't any GPUs in the execution configuration
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a FusedBondedForceComputeGPU with no GPU in the execution configuration"
+                                  << endl;
+        throw std::runtime_error("Error initializing FusedBondedForceComputeGPU");
+        }
+
+    // allocate flags storage on the GPU
+    GPUArray<unsigned int> flags(1, m_exec_conf);
+    m_flags.swap(flags);
+
+    // reset flags
+    ArrayHandle<unsigned int> h_flags(m_flags, access_location::host, access_mode::overwrite);
+    h_flags.data[0] = 0;
+
+    unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
+    m_tuner.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "fused_bonded", m_exec_conf));
+    }
+
+FusedBondedForceComputeGPU::~FusedBondedForceComputeGPU()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying FusedBondedForceComputeGPU" << endl;
+    }
+
+/*! Internal method for computing the forces on the GPU.
+    \post The force data on the GPU is written with the calculated forces
+
+    \param timestep Current time step of the simulation
+
+    Calls gpu_compute_fused_bonded_forces to do the dirty work.
+*/
+void FusedBondedForceComputeGPU::computeForces(uint64_t timestep)
+    {
+    // start the profile
+    if (m_prof) m_prof->push(m_exec_conf, "Fused bonded");
+
+    std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
+    std::shared_ptr<AngleData> angle_data = m_sysdef->getAngleData();
+    std::shared_ptr<DihedralData> dihedral_data = m_sysdef->getDihedralData();
+
+    // acquire all the handles up front, substituting empty parameters for the terms that are skipped
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_force(m_force, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_virial(m_virial, access_location::device, access_mode::overwrite);
+
+        ArrayHandle<harmonic_params> d_bond_params(m_bond ? m_bond->getParamArray() : m_no_bond_params,
+                                                   access_location::device, access_mode::read);
+        ArrayHandle<BondData::members_t> d_gpu_bondlist(bond_data->getGPUTable(),
+                                                        access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_n_bonds(bond_data->getNGroupsArray(),
+                                                access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_bond_offsets(bond_data->getGPUTableOffsets(),
+                                                     access_location::device, access_mode::read);
+
+        ArrayHandle<Scalar2> d_angle_params(m_angle ? m_angle->getParamArray() : m_no_angle_params,
+                                            access_location::device, access_mode::read);
+        ArrayHandle<AngleData::members_t> d_gpu_anglelist(angle_data->getGPUTable(),
+                                                          access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_angle_pos_list(angle_data->getGPUPosTable(),
+                                                       access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_n_angles(angle_data->getNGroupsArray(),
+                                                 access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_angle_offsets(angle_data->getGPUTableOffsets(),
+                                                      access_location::device, access_mode::read);
+
+        ArrayHandle<Scalar4> d_dihedral_params(m_dihedral ? m_dihedral->getParamArray() : m_no_dihedral_params,
+                                               access_location::device, access_mode::read);
+        ArrayHandle<DihedralData::members_t> d_gpu_dihedral_list(dihedral_data->getGPUTable(),
+                                                                 access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_dihedrals_ABCD(dihedral_data->getGPUPosTable(),
+                                                   access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_n_dihedrals(dihedral_data->getNGroupsArray(),
+                                                access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_dihedral_offsets(dihedral_data->getGPUTableOffsets(),
+                                                     access_location::device, access_mode::read);
+
+        // access the flags array for overwriting
+        ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::readwrite);
+
+        fused_bonded_args_t args;
+        args.d_force = d_force.data;
+        args.d_virial = d_virial.data;
+        args.virial_pitch = m_virial.getPitch();
+        args.N = m_pdata->getN();
+        args.d_pos = d_pos.data;
+        args.box = m_pdata->getGlobalBox();
+
+        args.d_bond_params = m_bond ? d_bond_params.data : NULL;
+        args.d_bond_list = d_gpu_bondlist.data;
+        args.bond_indexer = bond_data->getGPUTableIndexer();
+        args.d_bond_offsets = d_gpu_bond_offsets.data;
+        args.d_n_bonds = d_gpu_n_bonds.data;
+
+        args.d_angle_params = m_angle ? d_angle_params.data : NULL;
+        args.d_angle_list = d_gpu_anglelist.data;
+        args.d_angle_pos = d_gpu_angle_pos_list.data;
+        args.angle_pitch = angle_data->getGPUTableIndexer().getW();
+        args.d_angle_offsets = d_gpu_angle_offsets.data;
+        args.d_n_angles = d_gpu_n_angles.data;
+
+        args.d_dihedral_params = m_dihedral ? d_dihedral_params.data : NULL;
+        args.d_dihedral_list = d_gpu_dihedral_list.data;
+        args.d_dihedral_pos = d_dihedrals_ABCD.data;
+        args.dihedral_pitch = dihedral_data->getGPUTableIndexer().getW();
+        args.d_dihedral_offsets = d_dihedral_offsets.data;
+        args.d_n_dihedrals = d_n_dihedrals.data;
+
+        args.d_flags = d_flags.data;
+
+        // run the kernel on the GPU
+        m_tuner->begin();
+        args.block_size = m_tuner->getParam();
+        gpu_compute_fused_bonded_forces(args);
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner->end();
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        {
+        // check the flags for any errors
+        ArrayHandle<unsigned int> h_flags(m_flags, access_location::host, access_mode::read);
+
+        if (h_flags.data[0] & 1)
+            {
+            m_exec_conf->msg->error() << "FusedBondedForceComputeGPU: bond out of bounds (" << h_flags.data[0] << ")"
+                                      << std::endl << std::endl;
+            throw std::runtime_error("Error in bond calculation");
+            }
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+void export_FusedBondedForceComputeGPU(py::module& m)
+    {
+    py::class_<FusedBondedForceComputeGPU, ForceCompute, std::shared_ptr<FusedBondedForceComputeGPU> >(m,
+        "FusedBondedForceComputeGPU")
+    .def(py::init< std::shared_ptr<SystemDefinition>,
+                   std::shared_ptr<PotentialBondHarmonic>,
+                   std::shared_ptr<HarmonicAngleForceComputeGPU>,
+                   std::shared_ptr<HarmonicDihedralForceComputeGPU> >())
+    ;
+    }
@@ -0,0 +1,81 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/ForceCompute.h"
+#include "hoomd/Autotuner.h"
+#include "AllBondPotentials.h"
+#include "HarmonicAngleForceComputeGPU.h"
+#include "HarmonicDihedralForceComputeGPU.h"
+#include "FusedBondedForceGPU.cuh"
+
+#include <memory>
+
+/*! \file FusedBondedForceComputeGPU.h
+    \brief Declares the FusedBondedForceComputeGPU class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+#ifndef __FUSEDBONDEDFORCECOMPUTEGPU_H__
+#define __FUSEDBONDEDFORCECOMPUTEGPU_H__
+
+//! Computes the harmonic bond, angle, and dihedral forces on the GPU in a single kernel
+/*! FusedBondedForceComputeGPU evaluates the same forces as PotentialBondHarmonic, HarmonicAngleForceComputeGPU,
+    and HarmonicDihedralForceComputeGPU together. Each particle reads its position once, evaluates all of its bonded
+    terms, and writes its force and virial once, instead of once per term. The net force then also sums a single
+    bonded force array.
+
+    The parameters are read from the given component force computes, which remain the owners of the per-type
+    parameters. Any of them may be null to skip that term. The component computes must not be added to the
+    integrator themselves, otherwise their forces are counted twice. The energy reported by this compute is the sum
+    over all of the fused terms.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT FusedBondedForceComputeGPU : public ForceCompute
+    {
+    public:
+        //! Constructs the compute
+        FusedBondedForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                   std::shared_ptr<PotentialBondHarmonic> bond,
+                                   std::shared_ptr<HarmonicAngleForceComputeGPU> angle,
+                                   std::shared_ptr<HarmonicDihedralForceComputeGPU> dihedral);
+
+        //! Destructor
+        virtual ~FusedBondedForceComputeGPU();
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            ForceCompute::setAutotunerParams(enable, period);
+            m_tuner->setPeriod(period);
+            m_tuner->setEnabled(enable);
+            }
+
+    protected:
+        std::shared_ptr<PotentialBondHarmonic> m_bond;                  //!< Source of the bond parameters
+        std::shared_ptr<HarmonicAngleForceComputeGPU> m_angle;          //!< Source of the angle parameters
+        std::shared_ptr<HarmonicDihedralForceComputeGPU> m_dihedral;    //!< Source of the dihedral parameters
+
+        GlobalArray<harmonic_params> m_no_bond_params;  //!< Empty parameters used when a term is skipped
+        GPUArray<Scalar2> m_no_angle_params;            //!< Empty parameters used when a term is skipped
+        GPUArray<Scalar4> m_no_dihedral_params;         //!< Empty parameters used when a term is skipped
+
+        std::unique_ptr<Autotuner> m_tuner;    //!< Autotuner for block size
+        GPUArray<unsigned int> m_flags;        //!< Flags set during the kernel execution
+
+        //! Actually compute the forces
+        virtual void computeForces(uint64_t timestep);
+    };
+
+//! Export the FusedBondedForceComputeGPU class to python
+void export_FusedBondedForceComputeGPU(pybind11::module& m);
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "FusedBondedForceGPU.cuh"
+#include "HarmonicAngleForceGPU.cuh"
+#include "HarmonicDihedralForceGPU.cuh"
+#include "hoomd/TextureTools.h"
+
+#include <assert.h>
+
+/*! \file FusedBondedForceGPU.cu
+    \brief Defines the GPU kernel that evaluates the harmonic bond, angle, and dihedral forces in one pass.
+*/
+
+//! Kernel for calculating the harmonic bond, angle, and dihedral forces on the GPU
+/*! \param args Kernel arguments
+
+    Each thread handles one particle. The position of the particle is read once, all of its bonded terms are
+    evaluated in turn, and the sum is written once, so that the bonded forces cost one force and virial write per
+    particle instead of one per term. The angle and dihedral terms use the same device functions as
+    gpu_compute_harmonic_angle_forces_kernel and gpu_compute_harmonic_dihedral_forces_kernel.
+*/
+__global__ void gpu_compute_fused_bonded_forces_kernel(const fused_bonded_args_t args)
+    {
+    // start by identifying which particle we are to handle
+    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= args.N)
+        return;
+
+    // read in the position of our particle (MEM TRANSFER: 16 bytes)
+    Scalar4 idx_postype = __ldg(args.d_pos + idx);
+    Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
+
+    // initialize the force to 0
+    Scalar4 force_idx = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+
+    // initialize the virial to 0
+    Scalar virial_idx[6];
+    for (unsigned int i = 0; i < 6; i++)
+        virial_idx[i] = Scalar(0.0);
+
+    if (args.d_bond_params)
+        {
+        int n_bonds = args.d_n_bonds[idx];
+        unsigned int bond_start = args.d_bond_offsets[idx];
+        for (int bond_idx = 0; bond_idx < n_bonds; bond_idx++)
+            {
+            group_storage<2> cur_bond = args.d_bond_list[args.bond_indexer(bond_start, bond_idx)];
+
+            int cur_bond_idx = cur_bond.idx[0];
+            int cur_bond_type = cur_bond.idx[1];
+
+            // get the bonded particle's position (MEM_TRANSFER: 16 bytes)
+            Scalar4 neigh_postype = __ldg(args.d_pos + cur_bond_idx);
+            Scalar3 neigh_pos = make_scalar3(neigh_postype.x, neigh_postype.y, neigh_postype.z);
+
+            Scalar3 dx = args.box.minImage(idx_pos - neigh_pos);
+            Scalar rsq = dot(dx, dx);
+
+            Scalar force_divr = Scalar(0.0);
+            Scalar bond_eng = Scalar(0.0);
+            EvaluatorBondHarmonic eval(rsq, args.d_bond_params[cur_bond_type]);
+
+            if (!eval.evalForceAndEnergy(force_divr, bond_eng))
+                {
+                *args.d_flags = 1;
+                continue;
+                }
+
+            // add up the virial (double counting, multiply by 0.5)
+            Scalar force_div2r = force_divr/Scalar(2.0);
+            virial_idx[0] += dx.x * dx.x * force_div2r; // xx
+            virial_idx[1] += dx.x * dx.y * force_div2r; // xy
+            virial_idx[2] += dx.x * dx.z * force_div2r; // xz
+            virial_idx[3] += dx.y * dx.y * force_div2r; // yy
+            virial_idx[4] += dx.y * dx.z * force_div2r; // yz
+            virial_idx[5] += dx.z * dx.z * force_div2r; // zz
+
+            force_idx.x += dx.x * force_divr;
+            force_idx.y += dx.y * force_divr;
+            force_idx.z += dx.z * force_divr;
+            // energy is double counted: multiply by 0.5
+            force_idx.w += bond_eng * Scalar(0.5);
+            }
+        }
+
+    if (args.d_angle_params)
+        {
+        int n_angles = args.d_n_angles[idx];
+        unsigned int angle_start = args.d_angle_offsets[idx];
+        for (int angle_idx = 0; angle_idx < n_angles; angle_idx++)
+            {
+            group_storage<3> cur_angle = args.d_angle_list[args.angle_pitch*angle_idx + angle_start];
+            int cur_angle_abc = args.d_angle_pos[args.angle_pitch*angle_idx + angle_start];
+
+            // get the positions of the other two particles (MEM TRANSFER: 32 bytes)
+            Scalar4 x_postype = __ldg(args.d_pos + cur_angle.idx[0]);
+            Scalar4 y_postype = __ldg(args.d_pos + cur_angle.idx[1]);
+            Scalar3 x_pos = make_scalar3(x_postype.x, x_postype.y, x_postype.z);
+            Scalar3 y_pos = make_scalar3(y_postype.x, y_postype.y, y_postype.z);
+
+            // get the angle parameters (MEM TRANSFER: 8 bytes)
+            Scalar2 params = __ldg(args.d_angle_params + cur_angle.idx[2]);
+
+            gpu_add_harmonic_angle_force(force_idx, virial_idx, idx_pos, x_pos, y_pos, cur_angle_abc, params,
+                args.box);
+            }
+        }
+
+    if (args.d_dihedral_params)
+        {
+        int n_dihedrals = args.d_n_dihedrals[idx];
+        unsigned int dihedral_start = args.d_dihedral_offsets[idx];
+        for (int dihedral_idx = 0; dihedral_idx < n_dihedrals; dihedral_idx++)
+            {
+            group_storage<4> cur_dihedral = args.d_dihedral_list[args.dihedral_pitch*dihedral_idx + dihedral_start];
+            int cur_dihedral_abcd = args.d_dihedral_pos[args.dihedral_pitch*dihedral_idx + dihedral_start];
+
+            // get the positions of the other three particles (MEM TRANSFER: 48 bytes)
+            Scalar4 x_postype = __ldg(args.d_pos + cur_dihedral.idx[0]);
+            Scalar4 y_postype = __ldg(args.d_pos + cur_dihedral.idx[1]);
+            Scalar4 z_postype = __ldg(args.d_pos + cur_dihedral.idx[2]);
+            Scalar3 x_pos = make_scalar3(x_postype.x, x_postype.y, x_postype.z);
+            Scalar3 y_pos = make_scalar3(y_postype.x, y_postype.y, y_postype.z);
+            Scalar3 z_pos = make_scalar3(z_postype.x, z_postype.y, z_postype.z);
+
+            // get the dihedral parameters (MEM TRANSFER: 16 bytes)
+            Scalar4 params = __ldg(args.d_dihedral_params + cur_dihedral.idx[3]);
+
+            gpu_add_harmonic_dihedral_force(force_idx, virial_idx, idx_pos, x_pos, y_pos, z_pos, cur_dihedral_abcd,
+                params, args.box);
+            }
+        }
+
+    // now that the force calculation is complete, write out the result (MEM TRANSFER: 64 bytes)
+    args.d_force[idx] = force_idx;
+    for (unsigned int i = 0; i < 6; i++)
+        args.d_virial[i*args.virial_pitch + idx] = virial_idx[i];
+    }
+
+/*! \param args Kernel arguments
+
+    \returns Any error code resulting from the kernel launch
+    \note Always returns hipSuccess in release builds to avoid the hipDeviceSynchronize()
+*/
+hipError_t gpu_compute_fused_bonded_forces(const fused_bonded_args_t& args)
+    {
+    assert(args.block_size != 0);
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_compute_fused_bonded_forces_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(args.block_size, max_block_size);
+
+    // setup the grid to run the kernel
+    dim3 grid(args.N / run_block_size + 1, 1, 1);
+    dim3 threads(run_block_size, 1, 1);
+
+    // run the kernel
+    hipLaunchKernelGGL((gpu_compute_fused_bonded_forces_kernel), grid, threads, 0, 0, args);
+
+    return hipSuccess;
+    }
@@ -0,0 +1,58 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hip/hip_runtime.h"
+#include "hoomd/ParticleData.cuh"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/BondedGroupData.cuh"
+#include "EvaluatorBondHarmonic.h"
+
+/*! \file FusedBondedForceGPU.cuh
+    \brief Declares the GPU kernel driver that evaluates the harmonic bond, angle, and dihedral forces in one pass.
+    Used by FusedBondedForceComputeGPU.
+*/
+
+#ifndef __FUSEDBONDEDFORCEGPU_CUH__
+#define __FUSEDBONDEDFORCEGPU_CUH__
+
+//! Wraps the arguments to gpu_compute_fused_bonded_forces
+/*! A term is skipped when its parameter pointer is NULL.
+ */
+struct fused_bonded_args_t
+    {
+    Scalar4 *d_force;                          //!< Force to write out
+    Scalar *d_virial;                          //!< Virial to write out
+    size_t virial_pitch;                       //!< Pitch of 2D array of virial matrix elements
+    unsigned int N;                            //!< Number of particles
+    const Scalar4 *d_pos;                      //!< Particle positions
+    BoxDim box;                                //!< Simulation box
+
+    const harmonic_params *d_bond_params;      //!< Bond parameters per type
+    const group_storage<2> *d_bond_list;       //!< Bonds by particle index
+    Index2D bond_indexer;                      //!< Indexer of the bond table
+    const unsigned int *d_bond_offsets;        //!< Index of the first bond of every particle in the bond table
+    const unsigned int *d_n_bonds;             //!< Number of bonds per particle
+
+    const Scalar2 *d_angle_params;             //!< Angle parameters (K, t_0) per type
+    const group_storage<3> *d_angle_list;      //!< Angles by particle index
+    const unsigned int *d_angle_pos;           //!< Position of the particle in each angle
+    unsigned int angle_pitch;                  //!< Pitch of the angle table
+    const unsigned int *d_angle_offsets;       //!< Index of the first angle of every particle in the angle table
+    const unsigned int *d_n_angles;            //!< Number of angles per particle
+
+    const Scalar4 *d_dihedral_params;          //!< Dihedral parameters (K, sign, multiplicity, phi_0) per type
+    const group_storage<4> *d_dihedral_list;   //!< Dihedrals by particle index
+    const unsigned int *d_dihedral_pos;        //!< Position of the particle in each dihedral
+    unsigned int dihedral_pitch;               //!< Pitch of the dihedral table
+    const unsigned int *d_dihedral_offsets;    //!< Index of the first dihedral of every particle in the table
+    const unsigned int *d_n_dihedrals;         //!< Number of dihedrals per particle
+
+    unsigned int *d_flags;                     //!< Set to 1 if a bond cannot be evaluated
+    unsigned int block_size;                   //!< Block size to execute
+    };
+
+//! Kernel driver that computes the fused bonded forces for FusedBondedForceComputeGPU
+hipError_t gpu_compute_fused_bonded_forces(const fused_bonded_args_t& args);
+
+#endif
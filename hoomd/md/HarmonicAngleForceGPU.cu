@@ -10,9 +10,6 @@
 
 #include <assert.h>
 
-// SMALL a relatively small number
-#define SMALL Scalar(0.001)
-
 /*! \file HarmonicAngleForceGPU.cu
     \brief Defines GPU kernel code for calculating the harmonic angle forces. Used by HarmonicAngleForceComputeGPU.
 */
@@ -27,6 +24,7 @@
     \param box Box dimensions for periodic boundary condition handling
     \param alist Angle data to use in calculating the forces
     \param pitch Pitch of 2D angles list
+    \param table_offsets Index of the first entry of every particle in the angles list
     \param n_angles_list List of numbers of angles stored on the GPU
 */
 extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_force,
@@ -39,6 +37,7 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
                                                                     const group_storage<3> *alist,
                                                                     const unsigned int *apos_list,
                                                                     const unsigned int pitch,
+                                                                    const unsigned int *table_offsets,
                                                                     const unsigned int *n_angles_list)
     {
     // start by identifying which particle we are to handle
@@ -50,16 +49,16 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_angles = n_angles_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our b-particle from the a-b-c triplet. (MEM TRANSFER: 16 bytes)
     Scalar4 idx_postype = d_pos[idx];  // we can be either a, b, or c in the a-b-c triplet
     Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
-    Scalar3 a_pos,b_pos,c_pos; // allocate space for the a,b, and c atom in the a-b-c triplet
 
     // initialize the force to 0
     Scalar4 force_idx = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
 
-    Scalar fab[3], fcb[3];
-
     // initialize the virial to 0
     Scalar virial[6];
     for (int i = 0; i < 6; i++)
@@ -68,13 +67,13 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
     // loop over all angles
     for (int angle_idx = 0; angle_idx < n_angles; angle_idx++)
         {
-        group_storage<3> cur_angle = alist[pitch*angle_idx + idx];
+        group_storage<3> cur_angle = alist[pitch*angle_idx + table_start];
 
         int cur_angle_x_idx = cur_angle.idx[0];
         int cur_angle_y_idx = cur_angle.idx[1];
         int cur_angle_type = cur_angle.idx[2];
 
-        int cur_angle_abc = apos_list[pitch*angle_idx + idx];
+        int cur_angle_abc = apos_list[pitch*angle_idx + table_start];
 
         // get the a-particle's position (MEM TRANSFER: 16 bytes)
         Scalar4 x_postype = d_pos[cur_angle_x_idx];
@@ -83,108 +82,10 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
         Scalar4 y_postype = d_pos[cur_angle_y_idx];
         Scalar3 y_pos = make_scalar3(y_postype.x, y_postype.y, y_postype.z);
 
-        if (cur_angle_abc == 0)
-            {
-            a_pos = idx_pos;
-            b_pos = x_pos;
-            c_pos = y_pos;
-            }
-        if (cur_angle_abc == 1)
-            {
-            b_pos = idx_pos;
-            a_pos = x_pos;
-            c_pos = y_pos;
-            }
-        if (cur_angle_abc == 2)
-            {
-            c_pos = idx_pos;
-            a_pos = x_pos;
-            b_pos = y_pos;
-            }
-
-        // calculate dr for a-b,c-b,and a-c
-        Scalar3 dab = a_pos - b_pos;
-        Scalar3 dcb = c_pos - b_pos;
-        Scalar3 dac = a_pos - c_pos;
-
-        // apply periodic boundary conditions
-        dab = box.minImage(dab);
-        dcb = box.minImage(dcb);
-        dac = box.minImage(dac);
-
         // get the angle parameters (MEM TRANSFER: 8 bytes)
         Scalar2 params = __ldg(d_params + cur_angle_type);
-        Scalar K = params.x;
-        Scalar t_0 = params.y;
-
-        Scalar rsqab = dot(dab, dab);
-        Scalar rab = sqrtf(rsqab);
-        Scalar rsqcb = dot(dcb, dcb);
-        Scalar rcb = sqrtf(rsqcb);
-
-        Scalar c_abbc = dot(dab, dcb);
-        c_abbc /= rab*rcb;
-
-        if (c_abbc > Scalar(1.0)) c_abbc = Scalar(1.0);
-        if (c_abbc < -Scalar(1.0)) c_abbc = -Scalar(1.0);
-
-        Scalar s_abbc = sqrtf(Scalar(1.0) - c_abbc*c_abbc);
-        if (s_abbc < SMALL) s_abbc = SMALL;
-        s_abbc = Scalar(1.0)/s_abbc;
-
-        // actually calculate the force
-        Scalar dth = fast::acos(c_abbc) - t_0;
-        Scalar tk = K*dth;
-
-        Scalar a = -Scalar(1.0) * tk * s_abbc;
-        Scalar a11 = a*c_abbc/rsqab;
-        Scalar a12 = -a / (rab*rcb);
-        Scalar a22 = a*c_abbc / rsqcb;
-
-        fab[0] = a11*dab.x + a12*dcb.x;
-        fab[1] = a11*dab.y + a12*dcb.y;
-        fab[2] = a11*dab.z + a12*dcb.z;
-
-        fcb[0] = a22*dcb.x + a12*dab.x;
-        fcb[1] = a22*dcb.y + a12*dab.y;
-        fcb[2] = a22*dcb.z + a12*dab.z;
-
-        // compute 1/3 of the energy, 1/3 for each atom in the angle
-        Scalar angle_eng = tk*dth*Scalar(Scalar(1.0)/Scalar(6.0));
-
-        // upper triangular version of virial tensor
-        Scalar angle_virial[6];
-        angle_virial[0] = Scalar(1./3.)*(dab.x*fab[0] + dcb.x*fcb[0]);
-        angle_virial[1] = Scalar(1./3.)*(dab.y*fab[0] + dcb.y*fcb[0]);
-        angle_virial[2] = Scalar(1./3.)*(dab.z*fab[0] + dcb.z*fcb[0]);
-        angle_virial[3] = Scalar(1./3.)*(dab.y*fab[1] + dcb.y*fcb[1]);
-        angle_virial[4] = Scalar(1./3.)*(dab.z*fab[1] + dcb.z*fcb[1]);
-        angle_virial[5] = Scalar(1./3.)*(dab.z*fab[2] + dcb.z*fcb[2]);
-
-
-        if (cur_angle_abc == 0)
-            {
-            force_idx.x += fab[0];
-            force_idx.y += fab[1];
-            force_idx.z += fab[2];
-            }
-        if (cur_angle_abc == 1)
-            {
-            force_idx.x -= fab[0] + fcb[0];
-            force_idx.y -= fab[1] + fcb[1];
-            force_idx.z -= fab[2] + fcb[2];
-            }
-        if (cur_angle_abc == 2)
-            {
-            force_idx.x += fcb[0];
-            force_idx.y += fcb[1];
-            force_idx.z += fcb[2];
-            }
-
-        force_idx.w += angle_eng;
-
-        for (int i = 0; i < 6; i++)
-            virial[i] += angle_virial[i];
+
+        gpu_add_harmonic_angle_force(force_idx, virial, idx_pos, x_pos, y_pos, cur_angle_abc, params, box);
         }
 
     // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
@@ -201,6 +102,7 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
     \param box Box dimensions (in GPU format) to use for periodic boundary conditions
     \param atable List of angles stored on the GPU
     \param pitch Pitch of 2D angles list
+    \param table_offsets Index of the first entry of every particle in the angles list
     \param n_angles_list List of numbers of angles stored on the GPU
     \param d_params K and t_0 params packed as Scalar2 variables
     \param n_angle_types Number of angle types in d_params
@@ -222,6 +124,7 @@ hipError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
                                               const group_storage<3> *atable,
                                               const unsigned int *apos_list,
                                               const unsigned int pitch,
+                                              const unsigned int *table_offsets,
                                               const unsigned int *n_angles_list,
                                               Scalar2 *d_params,
                                               unsigned int n_angle_types,
@@ -245,7 +148,7 @@ hipError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
 
     // run the kernel
     hipLaunchKernelGGL((gpu_compute_harmonic_angle_forces_kernel), dim3(grid), dim3(threads), 0, 0, d_force, d_virial, virial_pitch, N, d_pos, d_params, box,
-        atable, apos_list, pitch, n_angles_list);
+        atable, apos_list, pitch, table_offsets, n_angles_list);
 
     return hipSuccess;
     }
@@ -15,6 +15,137 @@
 #ifndef __HARMONICANGLEFORCEGPU_CUH__
 #define __HARMONICANGLEFORCEGPU_CUH__
 
+#ifdef __HIPCC__
+//! Add the force, energy, and virial of one harmonic angle on one of its particles
+/*! \param force_idx Force and energy of the particle to accumulate into
+    \param virial Virial of the particle to accumulate into
+    \param idx_pos Position of the particle
+    \param x_pos Position of the first other particle in the angle
+    \param y_pos Position of the second other particle in the angle
+    \param cur_angle_abc Position of the particle in the a-b-c triplet
+    \param params K and t_0 of the angle type
+    \param box Box dimensions for periodic boundary condition handling
+
+    This is shared by the harmonic angle kernel and the fused bonded force kernel.
+*/
+__device__ inline void gpu_add_harmonic_angle_force(Scalar4& force_idx,
+                                                    Scalar *virial,
+                                                    const Scalar3& idx_pos,
+                                                    const Scalar3& x_pos,
+                                                    const Scalar3& y_pos,
+                                                    int cur_angle_abc,
+                                                    const Scalar2& params,
+                                                    const BoxDim& box)
+    {
+    // a relatively small number
+    const Scalar small = Scalar(0.001);
+
+    Scalar3 a_pos,b_pos,c_pos; // allocate space for the a,b, and c atom in the a-b-c triplet
+    Scalar fab[3], fcb[3];
+
+    if (cur_angle_abc == 0)
+        {
+        a_pos = idx_pos;
+        b_pos = x_pos;
+        c_pos = y_pos;
+        }
+    if (cur_angle_abc == 1)
+        {
+        b_pos = idx_pos;
+        a_pos = x_pos;
+        c_pos = y_pos;
+        }
+    if (cur_angle_abc == 2)
+        {
+        c_pos = idx_pos;
+        a_pos = x_pos;
+        b_pos = y_pos;
+        }
+
+    // calculate dr for a-b,c-b,and a-c
+    Scalar3 dab = a_pos - b_pos;
+    Scalar3 dcb = c_pos - b_pos;
+    Scalar3 dac = a_pos - c_pos;
+
+    // apply periodic boundary conditions
+    dab = box.minImage(dab);
+    dcb = box.minImage(dcb);
+    dac = box.minImage(dac);
+
+    Scalar K = params.x;
+    Scalar t_0 = params.y;
+
+    Scalar rsqab = dot(dab, dab);
+    Scalar rab = sqrtf(rsqab);
+    Scalar rsqcb = dot(dcb, dcb);
+    Scalar rcb = sqrtf(rsqcb);
+
+    Scalar c_abbc = dot(dab, dcb);
+    c_abbc /= rab*rcb;
+
+    if (c_abbc > Scalar(1.0)) c_abbc = Scalar(1.0);
+    if (c_abbc < -Scalar(1.0)) c_abbc = -Scalar(1.0);
+
+    Scalar s_abbc = sqrtf(Scalar(1.0) - c_abbc*c_abbc);
+    if (s_abbc < small) s_abbc = small;
+    s_abbc = Scalar(1.0)/s_abbc;
+
+    // actually calculate the force
+    Scalar dth = fast::acos(c_abbc) - t_0;
+    Scalar tk = K*dth;
+
+    Scalar a = -Scalar(1.0) * tk * s_abbc;
+    Scalar a11 = a*c_abbc/rsqab;
+    Scalar a12 = -a / (rab*rcb);
+    Scalar a22 = a*c_abbc / rsqcb;
+
+    fab[0] = a11*dab.x + a12*dcb.x;
+    fab[1] = a11*dab.y + a12*dcb.y;
+    fab[2] = a11*dab.z + a12*dcb.z;
+
+    fcb[0] = a22*dcb.x + a12*dab.x;
+    fcb[1] = a22*dcb.y + a12*dab.y;
+    fcb[2] = a22*dcb.z + a12*dab.z;
+
+    // compute 1/3 of the energy, 1/3 for each atom in the angle
+    Scalar angle_eng = tk*dth*Scalar(Scalar(1.0)/Scalar(6.0));
+
+    // upper triangular version of virial tensor
+    Scalar angle_virial[6];
+    angle_virial[0] = Scalar(1./3.)*(dab.x*fab[0] + dcb.x*fcb[0]);
+    angle_virial[1] = Scalar(1./3.)*(dab.y*fab[0] + dcb.y*fcb[0]);
+    angle_virial[2] = Scalar(1./3.)*(dab.z*fab[0] + dcb.z*fcb[0]);
+    angle_virial[3] = Scalar(1./3.)*(dab.y*fab[1] + dcb.y*fcb[1]);
+    angle_virial[4] = Scalar(1./3.)*(dab.z*fab[1] + dcb.z*fcb[1]);
+    angle_virial[5] = Scalar(1./3.)*(dab.z*fab[2] + dcb.z*fcb[2]);
+
+
+    if (cur_angle_abc == 0)
+        {
+        force_idx.x += fab[0];
+        force_idx.y += fab[1];
+        force_idx.z += fab[2];
+        }
+    if (cur_angle_abc == 1)
+        {
+        force_idx.x -= fab[0] + fcb[0];
+        force_idx.y -= fab[1] + fcb[1];
+        force_idx.z -= fab[2] + fcb[2];
+        }
+    if (cur_angle_abc == 2)
+        {
+        force_idx.x += fcb[0];
+        force_idx.y += fcb[1];
+        force_idx.z += fcb[2];
+        }
+
+    force_idx.w += angle_eng;
+
+    for (int i = 0; i < 6; i++)
+        virial[i] += angle_virial[i];
+    }
+#endif
+
 //! Kernel driver that computes harmonic angle forces for HarmonicAngleForceComputeGPU
 hipError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
                                               Scalar* d_virial,
@@ -25,6 +156,7 @@ hipError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
                                               const group_storage<3> *atable,
                                               const unsigned int *apos_list,
                                               const unsigned int pitch,
+                                              const unsigned int *table_offsets,
                                               const unsigned int *n_angles_list,
                                               Scalar2 *d_params,
                                               unsigned int n_angle_types,
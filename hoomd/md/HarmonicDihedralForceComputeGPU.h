@@ -51,6 +51,12 @@ class PYBIND11_EXPORT HarmonicDihedralForceComputeGPU : public HarmonicDihedralF
         //! Set the parameters
         virtual void setParams(unsigned int type, Scalar K, Scalar sign, Scalar multiplicity, Scalar phi_0);
 
+        //! Get the parameters stored on the GPU
+        const GPUArray<Scalar4>& getParamArray() const
+            {
+            return m_params;
+            }
+
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
         GPUArray<Scalar4> m_params;           //!< Parameters stored on the GPU (k,sign,m)
@@ -68,6 +68,7 @@ void HarmonicImproperForceComputeGPU::computeForces(uint64_t timestep)
 
     ArrayHandle<ImproperData::members_t> d_gpu_dihedral_list(m_improper_data->getGPUTable(), access_location::device,access_mode::read);
     ArrayHandle<unsigned int> d_n_dihedrals(m_improper_data->getNGroupsArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_table_offsets(m_improper_data->getGPUTableOffsets(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_dihedrals_ABCD(m_improper_data->getGPUPosTable(), access_location::device, access_mode::read);
 
     // the improper table is up to date: we are good to go. Call the kernel
@@ -89,6 +90,7 @@ void HarmonicImproperForceComputeGPU::computeForces(uint64_t timestep)
                                          d_gpu_dihedral_list.data,
                                          d_dihedrals_ABCD.data,
                                          m_improper_data->getGPUTableIndexer().getW(),
+                                         d_gpu_table_offsets.data,
                                          d_n_dihedrals.data,
                                          d_params.data,
                                          m_improper_data->getNTypes(),
@@ -28,6 +28,7 @@
     \param tlist Improper data to use in calculating the forces
     \param dihedral_ABCD List of relative atom positions in the dihedrals
     \param pitch Pitch of 2D dihedral list
+    \param table_offsets Index of the first entry of every particle in the dihedral list
     \param n_dihedrals_list List of numbers of dihedrals per atom
 */
 extern "C" __global__
@@ -41,6 +42,7 @@ void gpu_compute_harmonic_improper_forces_kernel(Scalar4* d_force,
                                                  const group_storage<4> *tlist,
                                                  const unsigned int *dihedral_ABCD,
                                                  const unsigned int pitch,
+                                                 const unsigned int *table_offsets,
                                                  const unsigned int *n_dihedrals_list)
 
     {
@@ -53,6 +55,9 @@ void gpu_compute_harmonic_improper_forces_kernel(Scalar4* d_force,
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_impropers = n_dihedrals_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our b-particle from the a-b-c triplet. (MEM TRANSFER: 16 bytes)
     Scalar4 idx_postype = d_pos[idx];  // we can be either a, b, or c in the a-b-c-d quartet
     Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
@@ -69,8 +74,8 @@ void gpu_compute_harmonic_improper_forces_kernel(Scalar4* d_force,
     // loop over all impropers
     for (int improper_idx = 0; improper_idx < n_impropers; improper_idx++)
         {
-        group_storage<4> cur_improper = tlist[pitch*improper_idx + idx];
-        unsigned int cur_ABCD = dihedral_ABCD[pitch*improper_idx + idx];
+        group_storage<4> cur_improper = tlist[pitch*improper_idx + table_start];
+        unsigned int cur_ABCD = dihedral_ABCD[pitch*improper_idx + table_start];
 
         int cur_improper_x_idx = cur_improper.idx[0];
         int cur_improper_y_idx = cur_improper.idx[1];
@@ -255,6 +260,7 @@ void gpu_compute_harmonic_improper_forces_kernel(Scalar4* d_force,
     \param tlist Dihedral data to use in calculating the forces
     \param dihedral_ABCD List of relative atom positions in the dihedrals
     \param pitch Pitch of 2D dihedral list
+    \param table_offsets Index of the first entry of every particle in the dihedral list
     \param n_dihedrals_list List of numbers of dihedrals per atom
     \param d_params K, sign,multiplicity params packed as padded Scalar4 variables
     \param n_improper_types Number of improper types in d_params
@@ -276,6 +282,7 @@ hipError_t gpu_compute_harmonic_improper_forces(Scalar4* d_force,
                                                  const group_storage<4> *tlist,
                                                  const unsigned int *dihedral_ABCD,
                                                  const unsigned int pitch,
+                                                 const unsigned int *table_offsets,
                                                  const unsigned int *n_dihedrals_list,
                                                  Scalar2 *d_params,
                                                  unsigned int n_improper_types,
@@ -305,7 +312,7 @@ hipError_t gpu_compute_harmonic_improper_forces(Scalar4* d_force,
     dim3 threads(run_block_size, 1, 1);
 
     // run the kernel
-    hipLaunchKernelGGL((gpu_compute_harmonic_improper_forces_kernel), dim3(grid), dim3(threads), 0, 0, d_force, d_virial, virial_pitch, N, d_pos, d_params, box, tlist, dihedral_ABCD, pitch, n_dihedrals_list);
+    hipLaunchKernelGGL((gpu_compute_harmonic_improper_forces_kernel), dim3(grid), dim3(threads), 0, 0, d_force, d_virial, virial_pitch, N, d_pos, d_params, box, tlist, dihedral_ABCD, pitch, table_offsets, n_dihedrals_list);
 
     return hipSuccess;
     }
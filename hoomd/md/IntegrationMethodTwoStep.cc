@@ -30,7 +30,7 @@ using namespace std;
 IntegrationMethodTwoStep::IntegrationMethodTwoStep(std::shared_ptr<SystemDefinition> sysdef,
                                                    std::shared_ptr<ParticleGroup> group)
     : m_sysdef(sysdef), m_group(group), m_pdata(m_sysdef->getParticleData()), m_exec_conf(m_pdata->getExecConf()),
-      m_aniso(false), m_deltaT(Scalar(0.0)), m_valid_restart(false)
+      m_aniso(false), m_deltaT(Scalar(0.0)), m_max_displacement(Scalar(-1.0)), m_valid_restart(false)
     {
     // sanity check
     assert(m_sysdef);
@@ -178,11 +178,102 @@ void IntegrationMethodTwoStep::validateGroup()
 
     }
 
+/*! \param modifiers Constraints and momentum removal to apply in the step loops
+
+    The unit vector of the one dimensional constraint is normalized.
+*/
+void IntegrationMethodTwoStep::setPostStepModifiers(const PostStepModifiers& modifiers)
+    {
+    if (modifiers.flags != 0 && !supportsPostStepModifiers())
+        {
+        m_exec_conf->msg->error() << "This integration method does not apply post step modifiers" << endl;
+        throw runtime_error("Error setting post step modifiers");
+        }
+
+    PostStepModifiers new_modifiers = modifiers;
+
+    if ((modifiers.flags & PostStepModifiers::enforce_2d) && m_sysdef->getNDimensions() != 2)
+        {
+        m_exec_conf->msg->error() << "Cannot enforce 2D in a 3 dimensional system" << endl;
+        throw runtime_error("Error setting post step modifiers");
+        }
+
+    if (modifiers.flags & PostStepModifiers::one_d)
+        {
+        Scalar len = slow::sqrt(dot(modifiers.line, modifiers.line));
+        if (len == Scalar(0.0))
+            {
+            m_exec_conf->msg->error() << "The direction of the one dimensional constraint must not be zero" << endl;
+            throw runtime_error("Error setting post step modifiers");
+            }
+        new_modifiers.line = modifiers.line / len;
+        }
+
+    if ((modifiers.flags & PostStepModifiers::sphere) && modifiers.sphere_r <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "The radius of the spherical constraint must be positive" << endl;
+        throw runtime_error("Error setting post step modifiers");
+        }
+
+    if ((modifiers.flags & PostStepModifiers::ellipsoid)
+        && (modifiers.ellipsoid_r.x <= Scalar(0.0) || modifiers.ellipsoid_r.y <= Scalar(0.0)
+            || modifiers.ellipsoid_r.z <= Scalar(0.0)))
+        {
+        m_exec_conf->msg->error() << "The radii of the ellipsoidal constraint must be positive" << endl;
+        throw runtime_error("Error setting post step modifiers");
+        }
+
+    m_post_step = new_modifiers;
+    }
+
+/*! \param sum_p Sum of the momenta of the local group members
+    \returns The sum of the momenta of all group members divided by the number of group members
+
+    With MPI, all ranks reduce the three components in a single call.
+*/
+Scalar3 IntegrationMethodTwoStep::getAverageMomentum(Scalar3 sum_p)
+    {
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        Scalar p[3] = {sum_p.x, sum_p.y, sum_p.z};
+        MPI_Allreduce(MPI_IN_PLACE, p, 3, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+        sum_p = make_scalar3(p[0], p[1], p[2]);
+        }
+    #endif
+
+    unsigned int n = m_group->getNumMembersGlobal();
+    if (n == 0)
+        return make_scalar3(0.0, 0.0, 0.0);
+
+    return sum_p / Scalar(n);
+    }
+
 void export_IntegrationMethodTwoStep(py::module& m)
     {
+    py::class_<PostStepModifiers> post_step(m, "PostStepModifiers");
+    post_step.def(py::init<>())
+        .def_readwrite("flags", &PostStepModifiers::flags)
+        .def_readwrite("line", &PostStepModifiers::line)
+        .def_readwrite("sphere_P", &PostStepModifiers::sphere_P)
+        .def_readwrite("sphere_r", &PostStepModifiers::sphere_r)
+        .def_readwrite("ellipsoid_P", &PostStepModifiers::ellipsoid_P)
+        .def_readwrite("ellipsoid_r", &PostStepModifiers::ellipsoid_r)
+        ;
+
+    py::enum_<PostStepModifiers::Flags>(post_step, "Flags", py::arithmetic())
+        .value("enforce_2d", PostStepModifiers::enforce_2d)
+        .value("one_d", PostStepModifiers::one_d)
+        .value("sphere", PostStepModifiers::sphere)
+        .value("ellipsoid", PostStepModifiers::ellipsoid)
+        .value("zero_momentum", PostStepModifiers::zero_momentum)
+        ;
+
     py::class_<IntegrationMethodTwoStep, std::shared_ptr<IntegrationMethodTwoStep> >(m, "IntegrationMethodTwoStep")
         .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup> >())
         .def("validateGroup", &IntegrationMethodTwoStep::validateGroup)
+        .def_property("post_step_modifiers", &IntegrationMethodTwoStep::getPostStepModifiers,
+                                             &IntegrationMethodTwoStep::setPostStepModifiers)
         .def_property_readonly("filter", [](const std::shared_ptr<IntegrationMethodTwoStep> method)
                                              {
                                              return method->getGroup()->getFilter();
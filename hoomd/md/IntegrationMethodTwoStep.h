@@ -7,6 +7,8 @@
 #include "hoomd/SystemDefinition.h"
 #include "hoomd/ParticleGroup.h"
 #include "hoomd/Profiler.h"
+#include "PostStepModifiers.h"
+#include "VelocityVerletStepOne.h"
 
 #include <memory>
 
@@ -230,6 +232,52 @@ class PYBIND11_EXPORT IntegrationMethodTwoStep
             return true;
             }
 
+        //! Get the largest displacement of a particle in the last call to integrateStepOne()
+        /*! \returns The displacement, or a negative value when the method does not report it
+
+            IntegratorTwoStep adds the displacement to the bound kept by ParticleData, which spares the neighbor list
+            its distance check while the particles cannot have left the buffer.
+        */
+        Scalar getMaxDisplacement() const
+            {
+            return m_max_displacement;
+            }
+
+        //! Forget the displacement reported by the last call to integrateStepOne()
+        void resetMaxDisplacement()
+            {
+            m_max_displacement = Scalar(-1.0);
+            }
+
+        //! Test if the method applies post step modifiers in its step loops
+        /*! Derived classes that apply m_post_step override this method and return true.
+        */
+        virtual bool supportsPostStepModifiers() const
+            {
+            return false;
+            }
+
+        //! Set the constraints and momentum removal applied in the step loops
+        void setPostStepModifiers(const PostStepModifiers& modifiers);
+
+        //! Get the constraints and momentum removal applied in the step loops
+        const PostStepModifiers& getPostStepModifiers() const
+            {
+            return m_post_step;
+            }
+
+        //! Get the parameters of the first step when it is a plain velocity verlet step
+        /*! \param params Set to the parameters of the first step
+            \returns true if integrateStepOne() does nothing but the step described by \a params
+
+            IntegratorTwoStep advances the members of all methods that return true in a single pass over the particle
+            data and does not call their integrateStepOne(). The base class returns false.
+        */
+        virtual bool getVelocityVerletStepOne(VelocityVerletStepOne& params) const
+            {
+            return false;
+            }
+
     protected:
         const std::shared_ptr<SystemDefinition> m_sysdef; //!< The system definition this method is associated with
         const std::shared_ptr<ParticleGroup> m_group;     //!< The group of particles this method works on
@@ -239,6 +287,8 @@ class PYBIND11_EXPORT IntegrationMethodTwoStep
         bool m_aniso;                                       //!< True if anisotropic integration is requested
 
         Scalar m_deltaT;                                    //!< The time step
+        Scalar m_max_displacement;                          //!< Largest displacement in step one (negative if unknown)
+        PostStepModifiers m_post_step;                      //!< Modifiers applied in the step loops
 
         //! helper function to get the integrator variables from the particle data
         const IntegratorVariables& getIntegratorVariables()
@@ -258,6 +308,9 @@ class PYBIND11_EXPORT IntegrationMethodTwoStep
         //! Set whether this restart is valid
         void setValidRestart(bool b) { m_valid_restart = b; }
 
+        //! Get the average momentum per group member from the local sums of the momenta
+        Scalar3 getAverageMomentum(Scalar3 sum_p);
+
 #ifdef ENABLE_MPI
         std::shared_ptr<Communicator> m_comm;             //!< The communicator to use for MPI
 #endif
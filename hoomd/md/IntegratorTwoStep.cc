@@ -3,6 +3,10 @@
 
 #include "IntegratorTwoStep.h"
 
+#ifdef ENABLE_HIP
+#include "IntegratorTwoStep.cuh"
+#endif
+
 namespace py = pybind11;
 
 #ifdef ENABLE_MPI
@@ -16,15 +20,36 @@ using namespace std;
 
 IntegratorTwoStep::IntegratorTwoStep(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
     : Integrator(sysdef, deltaT), m_prepared(false), m_gave_warning(false),
-    m_aniso_mode(Automatic)
+    m_aniso_mode(Automatic), m_fused_index_valid(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing IntegratorTwoStep" << endl;
+
+    GlobalArray<unsigned int> fused_method_id(m_pdata->getMaxN(), m_exec_conf);
+    m_fused_method_id.swap(fused_method_id);
+    TAG_ALLOCATION(m_fused_method_id);
+
+    // the method index refers to particle indices
+    m_pdata->getParticleSortSignal().connect<IntegratorTwoStep, &IntegratorTwoStep::slotFusedMethodIndexInvalid>(this);
+    m_pdata->getMaxParticleNumberChangeSignal().connect<IntegratorTwoStep, &IntegratorTwoStep::slotFusedMethodIndexInvalid>(this);
+    m_pdata->getGlobalParticleNumberChangeSignal().connect<IntegratorTwoStep, &IntegratorTwoStep::slotFusedMethodIndexInvalid>(this);
+
+#ifdef ENABLE_HIP
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        hipDeviceProp_t dev_prop = m_exec_conf->dev_prop;
+        m_tuner_fused.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "fused_step_one", this->m_exec_conf));
+        }
+#endif
     }
 
 IntegratorTwoStep::~IntegratorTwoStep()
     {
     m_exec_conf->msg->notice(5) << "Destroying IntegratorTwoStep" << endl;
 
+    m_pdata->getParticleSortSignal().disconnect<IntegratorTwoStep, &IntegratorTwoStep::slotFusedMethodIndexInvalid>(this);
+    m_pdata->getMaxParticleNumberChangeSignal().disconnect<IntegratorTwoStep, &IntegratorTwoStep::slotFusedMethodIndexInvalid>(this);
+    m_pdata->getGlobalParticleNumberChangeSignal().disconnect<IntegratorTwoStep, &IntegratorTwoStep::slotFusedMethodIndexInvalid>(this);
+
     #ifdef ENABLE_MPI
     if (m_comm)
         {
@@ -100,15 +125,37 @@ void IntegratorTwoStep::update(uint64_t timestep)
     if (m_prof)
         m_prof->push("Integrate");
 
-    // perform the first step of the integration on all groups
-    for (auto& method : m_methods)
+    // perform the first step of the integration on all groups, methods with a plain velocity verlet first step
+    // share a single pass
+    std::vector<bool> fused(m_methods.size(), false);
+    Scalar max_displacement = integrateFusedStepOne(fused);
+    for (unsigned int i = 0; i < m_methods.size(); i++)
         {
+        auto& method = m_methods[i];
+
         // deltaT should probably be passed as an argument, but that would require modifying many
         // files. Work around this by calling setDeltaT every timestep.
         method->setDeltaT(m_deltaT);
+        if (fused[i])
+            continue;
+
+        method->resetMaxDisplacement();
         method->integrateStepOne(timestep);
+
+        Scalar method_displacement = method->getMaxDisplacement();
+        if (method_displacement < Scalar(0.0) || max_displacement < Scalar(0.0))
+            max_displacement = Scalar(-1.0);
+        else
+            max_displacement = std::max(max_displacement, method_displacement);
         }
 
+    // let the neighbor list skip its distance check while the bound stays within the buffer, constituents of rigid
+    // bodies move farther than their central particles
+    if (max_displacement >= Scalar(0.0) && m_composite_forces.empty())
+        m_pdata->addDisplacementBound(timestep+1, max_displacement);
+    else
+        m_pdata->invalidateDisplacementBound();
+
     if (m_prof)
         m_prof->pop();
 
@@ -211,6 +258,8 @@ void IntegratorTwoStep::addIntegrationMethod(std::shared_ptr<IntegrationMethodTw
 void IntegratorTwoStep::removeAllIntegrationMethods()
     {
     m_methods.clear();
+    m_fused_methods.clear();
+    m_fused_index_valid = false;
     m_gave_warning = false;
     }
 
@@ -492,6 +541,158 @@ void IntegratorTwoStep::setAutotunerParams(bool enable, unsigned int period)
     // set params in all methods
     for (auto& method : m_methods)
             method->setAutotunerParams(enable, period);
+
+#ifdef ENABLE_HIP
+    if (m_tuner_fused)
+        {
+        m_tuner_fused->setPeriod(period);
+        m_tuner_fused->setEnabled(enable);
+        }
+#endif
+    }
+
+/*! \param fused Set to true for the methods that were advanced
+    \returns The largest displacement of a particle, or a negative value when it is not known
+
+    Each method that returns true from getVelocityVerletStepOne() gets an entry in a small parameter table and its
+    members are tagged with the index of that entry. One loop (or kernel) over all local particles then branches on the
+    parameters of each particle, instead of one pass per method through its own group index list. A single method
+    gains nothing from this and keeps its own integrateStepOne().
+*/
+Scalar IntegratorTwoStep::integrateFusedStepOne(std::vector<bool>& fused)
+    {
+    std::vector< std::shared_ptr<IntegrationMethodTwoStep> > methods;
+    std::vector<VelocityVerletStepOne> params;
+    for (unsigned int i = 0; i < m_methods.size(); i++)
+        {
+        VelocityVerletStepOne method_params;
+        if (m_methods[i]->getVelocityVerletStepOne(method_params))
+            {
+            fused[i] = true;
+            methods.push_back(m_methods[i]);
+            params.push_back(method_params);
+            }
+        }
+
+    if (methods.size() < 2)
+        {
+        std::fill(fused.begin(), fused.end(), false);
+        return Scalar(0.0);
+        }
+
+    // the methods list is modified directly from python, detect changes by comparing with the last rebuild
+    std::vector<unsigned int> num_members;
+    for (auto& method : methods)
+        num_members.push_back(method->getGroup()->getNumMembers());
+
+    if (!m_fused_index_valid || methods != m_fused_methods || num_members != m_fused_num_members)
+        {
+        m_fused_methods = methods;
+        m_fused_num_members = num_members;
+        updateFusedMethodIndex();
+        }
+
+    // the options of the methods may change between steps
+    unsigned int n_methods = (unsigned int)params.size();
+    if (m_fused_params.getNumElements() < n_methods)
+        {
+        GlobalArray<VelocityVerletStepOne> fused_params(n_methods, m_exec_conf);
+        m_fused_params.swap(fused_params);
+        TAG_ALLOCATION(m_fused_params);
+        }
+
+        {
+        ArrayHandle<VelocityVerletStepOne> h_params(m_fused_params, access_location::host, access_mode::overwrite);
+        std::copy(params.begin(), params.end(), h_params.data);
+        }
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "Fused step 1");
+
+    const BoxDim& box = m_pdata->getBox();
+    Scalar max_displacement(-1.0);
+
+#ifdef ENABLE_HIP
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
+        ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_method_id(m_fused_method_id, access_location::device, access_mode::read);
+        ArrayHandle<VelocityVerletStepOne> d_params(m_fused_params, access_location::device, access_mode::read);
+
+        m_exec_conf->beginMultiGPU();
+        m_tuner_fused->begin();
+        gpu_fused_step_one(d_pos.data,
+                           d_vel.data,
+                           d_accel.data,
+                           d_image.data,
+                           d_method_id.data,
+                           d_params.data,
+                           n_methods,
+                           m_pdata->getGPUPartition(),
+                           box,
+                           m_deltaT,
+                           m_tuner_fused->getParam());
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        m_tuner_fused->end();
+        m_exec_conf->endMultiGPU();
+        }
+    else
+#endif
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_method_id(m_fused_method_id, access_location::host, access_mode::read);
+        ArrayHandle<VelocityVerletStepOne> h_params(m_fused_params, access_location::host, access_mode::read);
+
+        Scalar max_dsq(0.0);
+        for (unsigned int j = 0; j < m_pdata->getN(); j++)
+            {
+            unsigned int method_id = h_method_id.data[j];
+            if (method_id >= n_methods)
+                continue;
+
+            Scalar dsq = h_params.data[method_id].apply(h_pos.data[j], h_vel.data[j], h_accel.data[j],
+                                                         h_image.data[j], box, m_deltaT);
+            max_dsq = (dsq > max_dsq) ? dsq : max_dsq;
+            }
+        max_displacement = sqrt(max_dsq);
+        }
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+
+    return max_displacement;
+    }
+
+/*! Particles outside of the fused methods get the index m_fused_methods.size().
+*/
+void IntegratorTwoStep::updateFusedMethodIndex()
+    {
+    if (m_fused_method_id.getNumElements() < m_pdata->getMaxN())
+        m_fused_method_id.resize(m_pdata->getMaxN());
+
+    ArrayHandle<unsigned int> h_method_id(m_fused_method_id, access_location::host, access_mode::overwrite);
+
+    unsigned int n_methods = (unsigned int)m_fused_methods.size();
+    std::fill(h_method_id.data, h_method_id.data + m_pdata->getN(), n_methods);
+
+    for (unsigned int k = 0; k < n_methods; k++)
+        {
+        std::shared_ptr<ParticleGroup> group = m_fused_methods[k]->getGroup();
+        ArrayHandle<unsigned int> h_index_array(group->getIndexArray(), access_location::host, access_mode::read);
+        for (unsigned int group_idx = 0; group_idx < group->getNumMembers(); group_idx++)
+            h_method_id.data[h_index_array.data[group_idx]] = k;
+        }
+
+    m_fused_index_valid = true;
     }
 
 void export_IntegratorTwoStep(py::module& m)
@@ -0,0 +1,135 @@
+#include "hip/hip_runtime.h"
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "IntegratorTwoStep.cuh"
+
+#include <assert.h>
+
+/*! \file IntegratorTwoStep.cu
+    \brief Defines GPU kernel code used by IntegratorTwoStep
+*/
+
+//! Takes the first velocity verlet step of all particles that belong to a fused integration method
+/*! \param d_pos array of particle positions
+    \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_image array of particle images
+    \param d_method_id Index of the parameters of each particle, \a n_methods or larger for particles that are
+           integrated separately
+    \param d_params Parameters of the fused methods
+    \param n_methods Number of fused methods
+    \param nwork Number of particles processed by this GPU
+    \param offset Index of the first particle processed by this GPU
+    \param box Box dimensions for periodic boundary condition handling
+    \param deltaT timestep
+
+    This kernel must be executed with a 1D grid of any block size such that the number of threads is greater than or
+    equal to the number of particles, and with n_methods*sizeof(VelocityVerletStepOne) bytes of shared memory. Each
+    thread reads the method index of one particle and branches on the parameters of that method, so a single pass
+    over the particle data replaces one kernel per method and group index list.
+*/
+__global__
+void gpu_fused_step_one_kernel(Scalar4 *d_pos,
+                               Scalar4 *d_vel,
+                               const Scalar3 *d_accel,
+                               int3 *d_image,
+                               const unsigned int *d_method_id,
+                               const VelocityVerletStepOne *d_params,
+                               const unsigned int n_methods,
+                               const unsigned int nwork,
+                               const unsigned int offset,
+                               BoxDim box,
+                               Scalar deltaT)
+    {
+    // stage the parameters of the methods in shared memory
+    HIP_DYNAMIC_SHARED(char, s_data)
+    VelocityVerletStepOne *s_params = (VelocityVerletStepOne *)(&s_data[0]);
+
+    for (unsigned int cur_offset = 0; cur_offset < n_methods; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < n_methods)
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+        }
+    __syncthreads();
+
+    unsigned int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (work_idx >= nwork)
+        return;
+
+    const unsigned int idx = work_idx + offset;
+
+    // particles of the other methods are left alone (MEM TRANSFER: 4 bytes)
+    const unsigned int method_id = d_method_id[idx];
+    if (method_id >= n_methods)
+        return;
+
+    // read the particle (MEM TRANSFER: 60 bytes)
+    Scalar4 postype = d_pos[idx];
+    Scalar4 velmass = d_vel[idx];
+    int3 image = d_image[idx];
+
+    s_params[method_id].apply(postype, velmass, d_accel[idx], image, box, deltaT);
+
+    // write out the results (MEM_TRANSFER: 44 bytes)
+    d_pos[idx] = postype;
+    d_vel[idx] = velmass;
+    d_image[idx] = image;
+    }
+
+/*! \param d_pos array of particle positions
+    \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_image array of particle images
+    \param d_method_id Index of the parameters of each particle
+    \param d_params Parameters of the fused methods
+    \param n_methods Number of fused methods
+    \param gpu_partition Load balancing info for multi-GPU execution
+    \param box Box dimensions for periodic boundary condition handling
+    \param deltaT timestep
+    \param block_size Size of the block to run
+
+    See gpu_fused_step_one_kernel() for full documentation, this function is just a driver.
+*/
+hipError_t gpu_fused_step_one(Scalar4 *d_pos,
+                              Scalar4 *d_vel,
+                              const Scalar3 *d_accel,
+                              int3 *d_image,
+                              const unsigned int *d_method_id,
+                              const VelocityVerletStepOne *d_params,
+                              unsigned int n_methods,
+                              const GPUPartition& gpu_partition,
+                              const BoxDim& box,
+                              Scalar deltaT,
+                              unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void*)gpu_fused_step_one_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    unsigned int shared_bytes = n_methods*sizeof(VelocityVerletStepOne);
+
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+
+        unsigned int nwork = range.second - range.first;
+
+        // setup the grid to run the kernel
+        dim3 grid( (nwork/run_block_size) + 1, 1, 1);
+        dim3 threads(run_block_size, 1, 1);
+
+        // run the kernel
+        hipLaunchKernelGGL((gpu_fused_step_one_kernel), dim3(grid), dim3(threads), shared_bytes, 0,
+                           d_pos, d_vel, d_accel, d_image, d_method_id, d_params, n_methods,
+                           nwork, range.first, box, deltaT);
+        }
+
+    return hipSuccess;
+    }
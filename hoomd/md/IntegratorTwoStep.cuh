@@ -0,0 +1,29 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file IntegratorTwoStep.cuh
+    \brief Declares GPU kernel code used by IntegratorTwoStep
+*/
+
+#include "hoomd/ParticleData.cuh"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/GPUPartition.cuh"
+#include "VelocityVerletStepOne.h"
+
+#ifndef __INTEGRATOR_TWO_STEP_CUH__
+#define __INTEGRATOR_TWO_STEP_CUH__
+
+//! Kernel driver for the combined velocity verlet first step of several integration methods
+hipError_t gpu_fused_step_one(Scalar4 *d_pos,
+                              Scalar4 *d_vel,
+                              const Scalar3 *d_accel,
+                              int3 *d_image,
+                              const unsigned int *d_method_id,
+                              const VelocityVerletStepOne *d_params,
+                              unsigned int n_methods,
+                              const GPUPartition& gpu_partition,
+                              const BoxDim& box,
+                              Scalar deltaT,
+                              unsigned int block_size);
+
+#endif // __INTEGRATOR_TWO_STEP_CUH__
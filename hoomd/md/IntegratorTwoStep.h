@@ -6,6 +6,10 @@
 
 #include "ForceComposite.h"
 
+#ifdef ENABLE_HIP
+#include "hoomd/Autotuner.h"
+#endif
+
 #pragma once
 
 #ifdef __HIPCC__
@@ -31,6 +35,12 @@
     one and two, and which can use the updated particle positions and velocities to update any slaved degrees
     of freedom (rigid bodies).
 
+    When two or more methods report a plain velocity verlet first step (see
+    IntegrationMethodTwoStep::getVelocityVerletStepOne()), their first steps are fused: a per particle method index
+    selects the parameters of each particle and a single pass over the particle data (one kernel on the GPU) advances
+    the members of all of them. The index is rebuilt when the particles are sorted or migrate and when the set of fused
+    methods changes.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
@@ -121,6 +131,18 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         /// Helper method to test if all added methods have valid restart information
         bool isValidRestart();
 
+        /// Advance the members of all methods with a plain velocity verlet first step in a single pass
+        Scalar integrateFusedStepOne(std::vector<bool>& fused);
+
+        /// Rebuild the per particle method index of the fused methods
+        void updateFusedMethodIndex();
+
+        /// Mark the per particle method index as out of date
+        void slotFusedMethodIndexInvalid()
+            {
+            m_fused_index_valid = false;
+            }
+
         std::vector< std::shared_ptr<IntegrationMethodTwoStep> > m_methods;   //!< List of all the integration methods
 
         bool m_prepared;              //!< True if preprun has been called
@@ -128,6 +150,16 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         AnisotropicMode m_aniso_mode; //!< Anisotropic mode for this integrator
 
         std::vector< std::shared_ptr<ForceComposite> > m_composite_forces; //!< A list of active composite forces
+
+        std::vector< std::shared_ptr<IntegrationMethodTwoStep> > m_fused_methods; //!< Methods in the method index
+        std::vector<unsigned int> m_fused_num_members;     //!< Local group sizes of the fused methods at the last rebuild
+        GlobalArray<unsigned int> m_fused_method_id;       //!< Index of the fused method of each particle
+        GlobalArray<VelocityVerletStepOne> m_fused_params; //!< Parameters of the fused methods
+        bool m_fused_index_valid;                          //!< False if the method index needs to be rebuilt
+
+#ifdef ENABLE_HIP
+        std::unique_ptr<Autotuner> m_tuner_fused;          //!< Autotuner for the fused first step
+#endif
     };
 
 /// Exports the IntegratorTwoStep class to python
@@ -0,0 +1,66 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file MDPrecisionSetup.h
+    \brief Setup for md mixed precision
+*/
+
+#ifndef __MD_PRECISION_SETUP_H__
+#define __MD_PRECISION_SETUP_H__
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define DEVICE __host__ __device__
+#else
+#define DEVICE
+#endif
+
+// Positions, box wrapping, and force accumulation always use Scalar. ShortReal is used for distance checks that
+// tolerate single precision rounding: particle separations are computed in Scalar first, so only the (small)
+// minimum image vector is rounded.
+
+#ifdef SINGLE_PRECISION
+
+//! Typedef'd real for use in distance checks
+typedef float ShortReal;
+//! Typedef'd real3 for use in distance checks
+typedef float3 ShortReal3;
+
+#else
+
+// in double precision, mixed mode enables floats for ShortReal, otherwise it is double
+#ifdef ENABLE_MD_MIXED_PRECISION
+typedef float ShortReal;
+typedef float3 ShortReal3;
+
+#else
+typedef double ShortReal;
+typedef double3 ShortReal3;
+
+#endif
+
+#endif
+
+//! Round a Scalar3 vector to a ShortReal3
+DEVICE inline ShortReal3 make_shortreal3(const Scalar3& v)
+    {
+    ShortReal3 result;
+    result.x = ShortReal(v.x);
+    result.y = ShortReal(v.y);
+    result.z = ShortReal(v.z);
+    return result;
+    }
+
+//! Squared length of a vector, evaluated in ShortReal
+DEVICE inline ShortReal short_length_sq(const Scalar3& v)
+    {
+    ShortReal3 s = make_shortreal3(v);
+    return s.x*s.x + s.y*s.y + s.z*s.z;
+    }
+
+#undef DEVICE
+
+#endif //__MD_PRECISION_SETUP_H__
@@ -32,6 +32,9 @@ MolecularForceCompute::MolecularForceCompute(std::shared_ptr<SystemDefinition> s
     // connect to the ParticleData to receive notifications when particles change order in memory
     m_pdata->getParticleSortSignal().connect<MolecularForceCompute, &MolecularForceCompute::setDirty>(this);
 
+    // ghosts are exchanged again after they are removed, without a particle sort when migration is deferred
+    m_pdata->getGhostParticlesRemovedSignal().connect<MolecularForceCompute, &MolecularForceCompute::setDirty>(this);
+
     TAG_ALLOCATION(m_molecule_tag);
     TAG_ALLOCATION(m_molecule_list);
     TAG_ALLOCATION(m_molecule_length);
@@ -56,6 +59,7 @@ MolecularForceCompute::MolecularForceCompute(std::shared_ptr<SystemDefinition> s
 MolecularForceCompute::~MolecularForceCompute()
     {
     m_pdata->getParticleSortSignal().disconnect<MolecularForceCompute, &MolecularForceCompute::setDirty>(this);
+    m_pdata->getGhostParticlesRemovedSignal().disconnect<MolecularForceCompute, &MolecularForceCompute::setDirty>(this);
     }
 
 #ifdef ENABLE_HIP
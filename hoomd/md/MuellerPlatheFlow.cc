@@ -47,7 +47,6 @@ MuellerPlatheFlow::MuellerPlatheFlow(std::shared_ptr<SystemDefinition> sysdef,
 
     m_exec_conf->msg->notice(5) << "Constructing MuellerPlatheFlow " << endl;
     this->update_domain_decomposition();
-    //m_exec_conf->msg->notice(0)<<m_exec_conf->getRank()<<": "<< m_max_swap.gbl_rank<<" "<<m_min_swap.gbl_rank<<endl;
 
     //Check min max slab.
     this->set_min_slab(m_min_slab);
@@ -111,7 +110,7 @@ void MuellerPlatheFlow::update(uint64_t timestep)
 
         if( m_last_max_vel.x == -INVALID_VEL
             || static_cast<unsigned int>(__scalar_as_int(m_last_max_vel.z)) == INVALID_TAG
-            || m_last_min_vel.x == -INVALID_VEL
+            || m_last_min_vel.x == INVALID_VEL
             || static_cast<unsigned int>(__scalar_as_int(m_last_min_vel.z)) == INVALID_TAG)
             {
             m_exec_conf->msg->warning() << "WARNING: at time "<<timestep
@@ -170,9 +169,6 @@ void MuellerPlatheFlow::swap_min_max_slab(void)
 
     std::swap( m_has_max_slab, m_has_min_slab);
 
-#ifdef ENABLE_MPI
-    std::swap( m_max_swap, m_min_swap);
-#endif//ENABLE_MPI
     m_exec_conf->msg->notice(4)<<"MuellerPlatheUpdater swapped min/max slab: "<<this->get_min_slab()<<" "<<this->get_max_slab()<<endl;
     }
 
@@ -229,14 +225,6 @@ void MuellerPlatheFlow::update_domain_decomposition(void)
         m_has_max_slab = false;
         if( my_pos == this->get_max_slab() / (m_N_slabs/my_grid) )
             m_has_max_slab = true;
-
-
-        //Create the communicator.
-        const int min_color =  this->has_min_slab() ? 0 : MPI_UNDEFINED;
-        init_mpi_swap(&m_min_swap,min_color);
-
-        const int max_color =  this->has_max_slab() ? 0 : MPI_UNDEFINED;
-        init_mpi_swap(&m_max_swap,max_color);
         }
 #endif//ENABLE_MPI
     }
@@ -292,7 +280,7 @@ void MuellerPlatheFlow::search_min_max_velocity(void)
                 if( index == this->get_min_slab() && m_last_min_vel.x > vel && this->has_min_slab())
                     {
                     m_last_min_vel.x = vel;
-                    m_last_max_vel.y = mass;
+                    m_last_min_vel.y = mass;
                     m_last_min_vel.z = __int_as_scalar(h_tag.data[j]);
                     }
                 }
@@ -318,7 +306,7 @@ void MuellerPlatheFlow::update_min_max_velocity(void)
         //Swap the particles the new velocities.
         if( min_idx < Ntotal)
             {
-              const Scalar new_min_vel = m_last_max_vel.x / m_last_min_vel.y;
+              const Scalar new_min_vel = m_last_max_vel.x / h_vel.data[min_idx].w;
               switch(m_flow_direction)
                 {
                 case flow_enum::X: h_vel.data[min_idx].x = new_min_vel; break;
@@ -328,7 +316,7 @@ void MuellerPlatheFlow::update_min_max_velocity(void)
             }
         if( max_idx < Ntotal)
           {
-            const Scalar new_max_vel = m_last_min_vel.x / m_last_max_vel.y;
+            const Scalar new_max_vel = m_last_min_vel.x / h_vel.data[max_idx].w;
             switch(m_flow_direction)
                 {
                 case flow_enum::X: h_vel.data[max_idx].x = new_max_vel;break;
@@ -359,90 +347,32 @@ void MuellerPlatheFlow::verify_orthorhombic_box(void)
     }
 #ifdef ENABLE_MPI
 
-//Not performance optimized: could be slow. It is meant for init.
-void MuellerPlatheFlow::init_mpi_swap(struct MPI_SWAP*ms,const int color)
-    {
-    if( ms->initialized && ms->rank != MPI_UNDEFINED)
-        MPI_Comm_free( &(ms->comm) );
-
-    MPI_Comm_split( m_exec_conf->getMPICommunicator(),
-                    color, m_exec_conf->getRank(),
-                    &(ms->comm));
-    if( color != MPI_UNDEFINED)
-        {
-        MPI_Comm_rank(ms->comm,&(ms->rank) );
-        MPI_Comm_size(ms->comm,&(ms->size) );
-        }
-    else
-        {
-        ms->rank = MPI_UNDEFINED;
-        ms->size = MPI_UNDEFINED;
-        }
-    int send =0;
-    if( ms->rank == 0)
-        {
-        send = 1;
-        }
-    vector<int> recv;
-    all_gather_v(send,recv,m_exec_conf->getMPICommunicator());
-
-    //ARG_MAX;
-    ms->gbl_rank = -1;
-    for(unsigned int i=0; i < recv.size(); i++)
-        {
-        if( recv[i] == 1)
-            {
-            assert( ms->gbl_rank == -1);
-            ms->gbl_rank = i;
-            }
-        }
-    assert( ms->gbl_rank > -1);
-    ms->initialized = true;
-    }
-
-void MuellerPlatheFlow::bcast_vel_to_all(struct MPI_SWAP*ms,Scalar3*vel,const MPI_Op op)
-    {
-    if( ms->rank != MPI_UNDEFINED)
-        {
-        Scalar_Int tmp;
-        tmp.s = vel->x;
-        tmp.i = ms->rank;
-        MPI_Allreduce(MPI_IN_PLACE,&tmp,1,MPI_HOOMD_SCALAR_INT,op, ms->comm);
-        //Send to subset local rank
-        if( tmp.i != 0)
-            {
-            if( ms->rank == 0)
-                {
-                  recv(vel->x,tmp.i,ms->comm);
-                  recv(vel->y,tmp.i,ms->comm);
-                  recv(vel->z,tmp.i,ms->comm);
-                }
-            if( ms->rank == tmp.i)
-                {
-                  send(vel->x, 0 , ms->comm);
-                  send(vel->y, 0 , ms->comm);
-                  send(vel->z, 0 , ms->comm);
-                }
-            }
-        //ms->rank == 0 has the definite answer
-        }
-    //Broadcast the result to every rank.
-    //This way, each rank can check, whether
-    //it needs to update and can determine the exchanged momentum.
-    bcast( vel->x, ms->gbl_rank, m_exec_conf->getMPICommunicator() );
-    bcast( vel->y, ms->gbl_rank, m_exec_conf->getMPICommunicator() );
-    bcast( vel->z, ms->gbl_rank, m_exec_conf->getMPICommunicator() );
-    }
-
+/*! The max momentum and the negated min momentum are reduced together with MPI_MAXLOC, using the particle tag
+    as the location. Every rank gets the extremal pair and its tags, and the rank(s) holding the particles
+    update them locally, so neither the mass nor a separate communicator of the slab ranks is needed.
+*/
 void MuellerPlatheFlow::mpi_exchange_velocity(void)
     {
-#ifdef ENABLE_MPI
     if( m_pdata->getDomainDecomposition() )
         {
-        bcast_vel_to_all(&m_min_swap,&m_last_min_vel,MPI_MINLOC);
-        bcast_vel_to_all(&m_max_swap,&m_last_max_vel,MPI_MAXLOC);
+        Scalar_Int extrema[2];
+        extrema[0].s = m_last_max_vel.x;
+        extrema[0].i = __scalar_as_int(m_last_max_vel.z);
+        extrema[1].s = -m_last_min_vel.x;
+        extrema[1].i = __scalar_as_int(m_last_min_vel.z);
+        MPI_Allreduce(MPI_IN_PLACE, extrema, 2, MPI_HOOMD_SCALAR_INT, MPI_MAXLOC,
+                      m_exec_conf->getMPICommunicator());
+
+        if( extrema[0].i != __scalar_as_int(m_last_max_vel.z) )
+            m_last_max_vel.y = -INVALID_VEL;
+        m_last_max_vel.x = extrema[0].s;
+        m_last_max_vel.z = __int_as_scalar(extrema[0].i);
+
+        if( extrema[1].i != __scalar_as_int(m_last_min_vel.z) )
+            m_last_min_vel.y = INVALID_VEL;
+        m_last_min_vel.x = -extrema[1].s;
+        m_last_min_vel.z = __int_as_scalar(extrema[1].i);
         }
-#endif//ENABLE_MPI
     }
 
 #endif//ENABLE_MPI
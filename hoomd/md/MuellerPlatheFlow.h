@@ -113,19 +113,15 @@ class PYBIND11_EXPORT MuellerPlatheFlow : public Updater
 
         //!Temporary variables to store last found min vel info.
         //!
-        //! x: velocity y: mass z: tag as scalar.
-        //! \note Transferring the mass is only necessary if velocities are updated in the ghost layer. This is only
-        //! sometimes the case, but for the sake of simplicity it will be update here always. The performance loss
-        //! should be only minimal.
+        //! x: momentum y: mass z: tag as scalar.
+        //! \note The mass is only valid on the rank that found the particle. It is not exchanged with MPI,
+        //! because the velocity update uses the mass stored with the particle (or its ghost).
         Scalar3 m_last_min_vel;
 
         //!Temporary variables to store last found max vel info
         //!
-        //! x: velocity y: mass z: tag as scalar.
-        //! \note Transferring the mass is only necessary if velocities are updated in the ghost layer. This is only
-        //! sometimes the case, but for the sake of simplicity it will be update here always. The performance loss
-        //! should be only minimal.
-
+        //! x: momentum y: mass z: tag as scalar.
+        //! \note The mass is only valid on the rank that found the particle.
         Scalar3 m_last_max_vel;
 
         //! Direction perpendicular to the slabs.
@@ -150,25 +146,7 @@ class PYBIND11_EXPORT MuellerPlatheFlow : public Updater
         //! Returns if box is orthorhombic, but throws a runtime_error, if the box is not orthorhombic.
         void verify_orthorhombic_box(void);
 #ifdef ENABLE_MPI
-        struct MPI_SWAP{
-            MPI_Comm comm;
-            int rank;
-            int size;
-            int gbl_rank; //!< global rank of zero in the comm.
-            bool initialized; //!< initialized struct, manually set.
-            MPI_SWAP()
-                :
-                comm(MPI_COMM_NULL),
-                rank(MPI_UNDEFINED),
-                size(MPI_UNDEFINED),
-                gbl_rank(MPI_UNDEFINED),
-                initialized(false)
-                {}
-            };
-        struct MPI_SWAP m_min_swap;
-        struct MPI_SWAP m_max_swap;
-        void init_mpi_swap(struct MPI_SWAP* ms,const int color);
-        void bcast_vel_to_all(struct MPI_SWAP*ms,Scalar3*vel,const MPI_Op op);
+        //! Reduce the min and max momentum over all ranks
         void mpi_exchange_velocity(void);
 #endif//ENABLE_MPI
     };
@@ -32,6 +32,11 @@ MuellerPlatheFlowGPU::MuellerPlatheFlowGPU(std::shared_ptr<SystemDefinition> sys
 
     unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
     m_tuner.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "muellerplatheflow", this->m_exec_conf));
+
+    GPUArray<Scalar3> extrema(2, m_exec_conf);
+    m_extrema.swap(extrema);
+    GPUVector<Scalar4> block_extrema(m_exec_conf);
+    m_block_extrema.swap(block_extrema);
     }
 
 MuellerPlatheFlowGPU::~MuellerPlatheFlowGPU(void)
@@ -49,26 +54,38 @@ void MuellerPlatheFlowGPU::search_min_max_velocity(void)
     if( !this->has_max_slab() and !this->has_min_slab())
         return;
     if(m_prof) m_prof->push("MuellerPlatheFlowGPU::search");
-    const ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(),access_location::device, access_mode::read);
-    const ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(),access_location::device, access_mode::read);
-    const ArrayHandle<unsigned int> d_tag(m_pdata->getTags(),access_location::device, access_mode::read);
-    const ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(),access_location::device, access_mode::read);
-    const GlobalArray< unsigned int >& group_members = m_group->getIndexArray();
-    const ArrayHandle<unsigned int> d_group_members(group_members, access_location::device, access_mode::read);
-
-    const BoxDim& gl_box = m_pdata->getGlobalBox();
-
+    // smallest block size of the tuner gives the most blocks
+    const unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
+    const unsigned int max_num_blocks = group_size / warp_size + 1;
+    if (m_block_extrema.size() < max_num_blocks)
+        m_block_extrema.resize(max_num_blocks);
 
+        {
+        const ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(),access_location::device, access_mode::read);
+        const ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(),access_location::device, access_mode::read);
+        const ArrayHandle<unsigned int> d_tag(m_pdata->getTags(),access_location::device, access_mode::read);
+        const GlobalArray< unsigned int >& group_members = m_group->getIndexArray();
+        const ArrayHandle<unsigned int> d_group_members(group_members, access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_extrema(m_extrema, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_block_extrema(m_block_extrema, access_location::device, access_mode::overwrite);
+
+        const BoxDim& gl_box = m_pdata->getGlobalBox();
+
+        m_tuner->begin();
+        gpu_search_min_max_velocity(d_extrema.data,d_block_extrema.data,group_size,d_vel.data,d_pos.data,
+                                    d_tag.data,d_group_members.data,gl_box,this->get_N_slabs(),
+                                    this->get_max_slab(),this->get_min_slab(),this->has_max_slab(),
+                                    this->has_min_slab(),INVALID_VEL,INVALID_TAG,
+                                    m_tuner->getParam(),m_flow_direction,m_slab_direction);
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner->end();
+        }
 
-    m_tuner->begin();
-    gpu_search_min_max_velocity(group_size,d_vel.data,d_pos.data,d_tag.data,d_rtag.data,
-                                d_group_members.data,gl_box,this->get_N_slabs(),
-                                this->get_max_slab(),this->get_min_slab(),&m_last_max_vel,
-                                &m_last_min_vel,this->has_max_slab(),this->has_min_slab(),
-                                m_tuner->getParam(),m_flow_direction,m_slab_direction);
-    m_tuner->end();
-    if(m_exec_conf->isCUDAErrorCheckingEnabled())
-        CHECK_CUDA_ERROR();
+    // only the reduced pair comes back to the host
+    ArrayHandle<Scalar3> h_extrema(m_extrema, access_location::host, access_mode::read);
+    m_last_max_vel = h_extrema.data[0];
+    m_last_min_vel = h_extrema.data[1];
 
     if(m_prof) m_prof->pop();
     }
@@ -8,168 +8,278 @@
 #include "MuellerPlatheFlowGPU.cuh"
 #include <assert.h>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wconversion"
-#include <thrust/transform_reduce.h>
-#include <thrust/functional.h>
-#include <thrust/device_ptr.h>
-#pragma GCC diagnostic pop
-
-struct vel_search_un_opt : public thrust::unary_function< const unsigned int,Scalar3>
+//! Select the component of a vector along a direction
+__device__ inline Scalar select_direction(const Scalar4& v, const flow_enum::Direction direction)
     {
-        vel_search_un_opt(const Scalar4*const d_vel,const unsigned int *const d_tag,flow_enum::Direction flow_direction)
-            :
-            m_vel(d_vel),
-            m_tag(d_tag),
-            m_flow_direction(flow_direction)
-            {}
-        const Scalar4*const m_vel;
-        const unsigned int*const m_tag;
-        const flow_enum::Direction m_flow_direction;
-        __host__ __device__ Scalar3 operator()(const unsigned int idx)const
+    switch( direction )
+        {
+        case flow_enum::X: return v.x;
+        case flow_enum::Y: return v.y;
+        default: return v.z;
+        }
+    }
+
+//! Keep the larger momentum in a, ties go to the lower particle index
+__device__ inline void reduce_max(Scalar& mom_a, unsigned int& idx_a, const Scalar mom_b, const unsigned int idx_b)
+    {
+    if( mom_b > mom_a || (mom_b == mom_a && idx_b < idx_a) )
+        {
+        mom_a = mom_b;
+        idx_a = idx_b;
+        }
+    }
+
+//! Keep the smaller momentum in a, ties go to the lower particle index
+__device__ inline void reduce_min(Scalar& mom_a, unsigned int& idx_a, const Scalar mom_b, const unsigned int idx_b)
+    {
+    if( mom_b < mom_a || (mom_b == mom_a && idx_b < idx_a) )
+        {
+        mom_a = mom_b;
+        idx_a = idx_b;
+        }
+    }
+
+//! Reduce the candidates of all threads of a block into the first element of the shared memory
+/*!
+ * \param s_max_mom Max momentum candidate of each thread
+ * \param s_max_idx Particle index of the max candidate
+ * \param s_min_mom Min momentum candidate of each thread
+ * \param s_min_idx Particle index of the min candidate
+ *
+ * The block size does not need to be a power of 2.
+ */
+__device__ inline void block_reduce_min_max(Scalar *s_max_mom,
+                                            unsigned int *s_max_idx,
+                                            Scalar *s_min_mom,
+                                            unsigned int *s_min_idx)
+    {
+    unsigned int offset = 1;
+    while (offset < blockDim.x)
+        offset *= 2;
+    __syncthreads();
+    for (offset /= 2; offset > 0; offset /= 2)
+        {
+        if (threadIdx.x < offset && threadIdx.x + offset < blockDim.x)
             {
-            const unsigned int tag = m_tag[idx];
-            Scalar vel;
-            switch( m_flow_direction )
-                {
-                case flow_enum::X: vel = m_vel[idx].x; break;
-                case flow_enum::Y: vel = m_vel[idx].y; break;
-                case flow_enum::Z: vel = m_vel[idx].z; break;
-                }
-            const Scalar mass = m_vel[idx].w;
-            vel *= mass;
-            Scalar3 result;
-            result.x = vel;
-            result.y = mass;
-            result.z = __int_as_scalar(tag);
-            return result;
+            reduce_max(s_max_mom[threadIdx.x], s_max_idx[threadIdx.x],
+                       s_max_mom[threadIdx.x + offset], s_max_idx[threadIdx.x + offset]);
+            reduce_min(s_min_mom[threadIdx.x], s_min_idx[threadIdx.x],
+                       s_min_mom[threadIdx.x + offset], s_min_idx[threadIdx.x + offset]);
             }
-    };
-template <typename CMP>
-struct vel_search_binary_opt : public thrust::binary_function< Scalar3, Scalar3, Scalar3 >
+        __syncthreads();
+        }
+    }
+
+//! Find the extremal momentum in the min and max slabs for each block of group members
+/*!
+ * \param d_block_extrema Max momentum, its particle index, min momentum, and its particle index of each block
+ *
+ * Particles outside of the slabs contribute the invalid momentum, so blocks without candidates produce
+ * the invalid index 0xffffffff.
+ */
+__global__ void gpu_search_min_max_velocity_block_kernel(Scalar4 *d_block_extrema,
+                                                         const unsigned int group_size,
+                                                         const Scalar4 *d_vel,
+                                                         const Scalar4 *d_pos,
+                                                         const unsigned int *d_group_members,
+                                                         const BoxDim gl_box,
+                                                         const unsigned int Nslabs,
+                                                         const unsigned int max_slab,
+                                                         const unsigned int min_slab,
+                                                         const bool has_max_slab,
+                                                         const bool has_min_slab,
+                                                         const Scalar invalid_vel,
+                                                         const flow_enum::Direction flow_direction,
+                                                         const flow_enum::Direction slab_direction)
+    {
+    HIP_DYNAMIC_SHARED( char, s_data)
+    Scalar *s_max_mom = (Scalar *)&s_data[0];
+    Scalar *s_min_mom = s_max_mom + blockDim.x;
+    unsigned int *s_max_idx = (unsigned int *)(s_min_mom + blockDim.x);
+    unsigned int *s_min_idx = s_max_idx + blockDim.x;
+
+    Scalar max_mom = -invalid_vel;
+    unsigned int max_idx = 0xffffffff;
+    Scalar min_mom = invalid_vel;
+    unsigned int min_idx = 0xffffffff;
+
+    const unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (group_idx < group_size)
+        {
+        const unsigned int idx = d_group_members[group_idx];
+        const Scalar4 pos = d_pos[idx];
+        const Scalar L = slab_direction == flow_enum::X ? gl_box.getL().x :
+                         (slab_direction == flow_enum::Y ? gl_box.getL().y : gl_box.getL().z);
+        unsigned int slab = (unsigned int)((select_direction(pos, slab_direction)/L + Scalar(0.5)) * Nslabs);
+        slab %= Nslabs;
+
+        const Scalar4 vel = d_vel[idx];
+        const Scalar mom = select_direction(vel, flow_direction) * vel.w;
+        if (has_max_slab && slab == max_slab)
+            {
+            max_mom = mom;
+            max_idx = idx;
+            }
+        if (has_min_slab && slab == min_slab)
+            {
+            min_mom = mom;
+            min_idx = idx;
+            }
+        }
+
+    s_max_mom[threadIdx.x] = max_mom;
+    s_max_idx[threadIdx.x] = max_idx;
+    s_min_mom[threadIdx.x] = min_mom;
+    s_min_idx[threadIdx.x] = min_idx;
+    block_reduce_min_max(s_max_mom, s_max_idx, s_min_mom, s_min_idx);
+
+    if (threadIdx.x == 0)
+        {
+        d_block_extrema[blockIdx.x] = make_scalar4(s_max_mom[0], __int_as_scalar(s_max_idx[0]),
+                                                   s_min_mom[0], __int_as_scalar(s_min_idx[0]));
+        }
+    }
+
+//! Reduce the block extrema and write the momentum, mass, and tag of the extremal particles
+/*!
+ * \param d_extrema Max (first element) and min (second element) momentum, mass, and tag as scalar
+ *
+ * The kernel is launched with a single block.
+ */
+__global__ void gpu_search_min_max_velocity_final_kernel(Scalar3 *d_extrema,
+                                                         const Scalar4 *d_block_extrema,
+                                                         const unsigned int num_blocks,
+                                                         const Scalar4 *d_vel,
+                                                         const unsigned int *d_tag,
+                                                         const Scalar invalid_vel,
+                                                         const unsigned int invalid_tag)
     {
-        vel_search_binary_opt(const unsigned int*const d_rtag,
-                              const Scalar4*const d_pos,
-                              const BoxDim gl_box,
-                              const unsigned int Nslabs,
-                              const unsigned int slab_index,
-                              const Scalar3 invalid,
-                              const flow_enum::Direction slab_direction)
-            : m_rtag(d_rtag),
-              m_pos(d_pos),
-              m_gl_box(gl_box),
-              m_Nslabs(Nslabs),
-              m_slab_index(slab_index),
-              m_invalid(invalid),
-              m_slab_direction(slab_direction)
-            {}
-        const unsigned int*const m_rtag;
-        const Scalar4*const m_pos;
-        const BoxDim m_gl_box;
-        const unsigned int m_Nslabs;
-        const unsigned int m_slab_index;
-        const Scalar3 m_invalid;
-        const flow_enum::Direction m_slab_direction;
-
-        __host__ __device__ Scalar3 operator()(const Scalar3& a,const Scalar3& b)const
+    HIP_DYNAMIC_SHARED( char, s_data)
+    Scalar *s_max_mom = (Scalar *)&s_data[0];
+    Scalar *s_min_mom = s_max_mom + blockDim.x;
+    unsigned int *s_max_idx = (unsigned int *)(s_min_mom + blockDim.x);
+    unsigned int *s_min_idx = s_max_idx + blockDim.x;
+
+    Scalar max_mom = -invalid_vel;
+    unsigned int max_idx = 0xffffffff;
+    Scalar min_mom = invalid_vel;
+    unsigned int min_idx = 0xffffffff;
+    for (unsigned int i = threadIdx.x; i < num_blocks; i += blockDim.x)
+        {
+        const Scalar4 block = d_block_extrema[i];
+        reduce_max(max_mom, max_idx, block.x, __scalar_as_int(block.y));
+        reduce_min(min_mom, min_idx, block.z, __scalar_as_int(block.w));
+        }
+
+    s_max_mom[threadIdx.x] = max_mom;
+    s_max_idx[threadIdx.x] = max_idx;
+    s_min_mom[threadIdx.x] = min_mom;
+    s_min_idx[threadIdx.x] = min_idx;
+    block_reduce_min_max(s_max_mom, s_max_idx, s_min_mom, s_min_idx);
+
+    if (threadIdx.x == 0)
+        {
+        Scalar3 max_vel = make_scalar3(-invalid_vel, -invalid_vel, __int_as_scalar(invalid_tag));
+        if (s_max_idx[0] != 0xffffffff)
             {
-            Scalar3 result = m_invalid;
-            //Early exit, if invalid args involved.
-            if( a.z == m_invalid.z )
-                return b;
-            if( b.z == m_invalid.z )
-                return a;
-
-            const unsigned int idx_a = m_rtag[__scalar_as_int(a.z)];
-            const unsigned int idx_b = m_rtag[__scalar_as_int(b.z)];
-
-            unsigned int index_a,index_b;
-            switch( m_slab_direction )
-                {
-                case flow_enum::X:
-                    index_a = (m_pos[idx_a].x/m_gl_box.getL().x +.5) * m_Nslabs;
-                    index_b = (m_pos[idx_b].x/m_gl_box.getL().x +.5) * m_Nslabs;
-                    break;
-                case flow_enum::Y:
-                    index_a = (m_pos[idx_a].y/m_gl_box.getL().y +.5) * m_Nslabs;
-                    index_b = (m_pos[idx_b].y/m_gl_box.getL().y +.5) * m_Nslabs;
-                    break;
-                case flow_enum::Z:
-                    index_a = (m_pos[idx_a].z/m_gl_box.getL().z +.5) * m_Nslabs;
-                    index_b = (m_pos[idx_b].z/m_gl_box.getL().z +.5) * m_Nslabs;
-                    break;
-                }
-            index_a %= m_Nslabs;
-            index_b %= m_Nslabs;
-
-            if( index_a == index_b)
-                {
-                if( index_a == m_slab_index )
-                    {
-                    CMP cmp;
-                    if( cmp(a.x,b.x) )
-                        result = a;
-                    else
-                        result = b;
-                    }
-                }
-            else
-                {
-                if( index_a == m_slab_index )
-                    result = a;
-                if( index_b == m_slab_index )
-                    result = b;
-                }
-            return result;
+            max_vel.x = s_max_mom[0];
+            max_vel.y = d_vel[s_max_idx[0]].w;
+            max_vel.z = __int_as_scalar(d_tag[s_max_idx[0]]);
             }
-    };
+        Scalar3 min_vel = make_scalar3(invalid_vel, invalid_vel, __int_as_scalar(invalid_tag));
+        if (s_min_idx[0] != 0xffffffff)
+            {
+            min_vel.x = s_min_mom[0];
+            min_vel.y = d_vel[s_min_idx[0]].w;
+            min_vel.z = __int_as_scalar(d_tag[s_min_idx[0]]);
+            }
+        d_extrema[0] = max_vel;
+        d_extrema[1] = min_vel;
+        }
+    }
 
-hipError_t gpu_search_min_max_velocity(const unsigned int group_size,
+/*!
+ * \param d_extrema Max (first element) and min (second element) momentum, mass, and tag as scalar
+ * \param d_block_extrema Scratch space for the extrema of each block (at least group_size/blocksize+1)
+ * \param group_size Number of group members
+ * \param d_vel Particle velocities and masses
+ * \param d_pos Particle positions
+ * \param d_tag Particle tags
+ * \param d_group_members Particle indexes of the group members
+ * \param gl_box Global simulation box
+ * \param Nslabs Number of slabs
+ * \param max_slab Index of the slab to search for the max momentum
+ * \param min_slab Index of the slab to search for the min momentum
+ * \param has_max_slab True if this rank owns part of the max slab
+ * \param has_min_slab True if this rank owns part of the min slab
+ * \param invalid_vel Momentum marking no candidate
+ * \param invalid_tag Tag marking no candidate
+ * \param blocksize Number of threads per block
+ * \param flow_direction Direction of the flow
+ * \param slab_direction Direction normal to the slabs
+ *
+ * The search is done in two kernels: one block reduction over the group members, and a single block
+ * reducing the block extrema, so that only the final pair needs to be read back.
+ */
+hipError_t gpu_search_min_max_velocity(Scalar3 *const d_extrema,
+                                        Scalar4 *const d_block_extrema,
+                                        const unsigned int group_size,
                                         const Scalar4*const d_vel,
                                         const Scalar4*const d_pos,
                                         const unsigned int *const d_tag,
-                                        const unsigned int *const d_rtag,
                                         const unsigned int *const d_group_members,
                                         const BoxDim gl_box,
                                         const unsigned int Nslabs,
                                         const unsigned int max_slab,
                                         const unsigned int min_slab,
-                                        Scalar3*const last_max_vel,
-                                        Scalar3*const last_min_vel,
                                         const bool has_max_slab,
                                         const bool has_min_slab,
+                                        const Scalar invalid_vel,
+                                        const unsigned int invalid_tag,
                                         const unsigned int blocksize,
                                         const flow_enum::Direction flow_direction,
                                         const flow_enum::Direction slab_direction)
     {
-    thrust::device_ptr<const unsigned int> member_ptr(d_group_members);
-
-    vel_search_un_opt un_opt(d_vel, d_tag,flow_direction);
-
-    if( has_max_slab )
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
         {
-        vel_search_binary_opt<thrust::greater<const Scalar> > max_bin_opt(
-            d_rtag,d_pos,gl_box,Nslabs,max_slab,*last_max_vel,slab_direction);
-        Scalar3 init = *last_max_vel;
-        *last_max_vel = thrust::transform_reduce(member_ptr,member_ptr+group_size,
-                                                 un_opt,init,max_bin_opt);
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void*)gpu_search_min_max_velocity_block_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
         }
+    const unsigned int run_block_size = min(blocksize, max_block_size);
+    const unsigned int num_blocks = group_size / run_block_size + 1;
+    const size_t shared_bytes = 2*run_block_size*(sizeof(Scalar)+sizeof(unsigned int));
 
-    if( has_min_slab )
+    hipLaunchKernelGGL((gpu_search_min_max_velocity_block_kernel), dim3(num_blocks), dim3(run_block_size),
+                       shared_bytes, 0,
+                       d_block_extrema, group_size, d_vel, d_pos, d_group_members, gl_box, Nslabs,
+                       max_slab, min_slab, has_max_slab, has_min_slab, invalid_vel,
+                       flow_direction, slab_direction);
+
+    static unsigned int max_final_block_size = UINT_MAX;
+    if (max_final_block_size == UINT_MAX)
         {
-        vel_search_binary_opt<thrust::less<const Scalar> > min_bin_opt(
-            d_rtag,d_pos,gl_box,Nslabs,min_slab,*last_min_vel,slab_direction);
-        Scalar3 init = *last_min_vel;
-        *last_min_vel = thrust::transform_reduce(member_ptr,member_ptr+group_size,
-                                                 un_opt,init,min_bin_opt);
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void*)gpu_search_min_max_velocity_final_kernel);
+        max_final_block_size = attr.maxThreadsPerBlock;
         }
+    const unsigned int final_block_size = min(run_block_size, max_final_block_size);
+    const size_t final_shared_bytes = 2*final_block_size*(sizeof(Scalar)+sizeof(unsigned int));
 
+    hipLaunchKernelGGL((gpu_search_min_max_velocity_final_kernel), dim3(1), dim3(final_block_size),
+                       final_shared_bytes, 0,
+                       d_extrema, d_block_extrema, num_blocks, d_vel, d_tag, invalid_vel, invalid_tag);
 
     return hipPeekAtLastError();
     }
 
-
-void __global__ gpu_update_min_max_velocity_kernel(const unsigned int *const d_rtag,
+//! Swap the momentum of the extremal particles
+/*!
+ * The new velocity is computed from the local mass of each particle, so the masses do not need to be
+ * exchanged between the ranks owning the min and max particles.
+ */
+__global__ void gpu_update_min_max_velocity_kernel(const unsigned int *const d_rtag,
                                                    Scalar4*const d_vel,
                                                    const unsigned int Ntotal,
                                                    const Scalar3 last_max_vel,
@@ -177,47 +287,33 @@ void __global__ gpu_update_min_max_velocity_kernel(const unsigned int *const d_r
                                                    const flow_enum::Direction flow_direction)
     {
     unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
-    if (idx >= 1)
+    if (idx >= 2)
         return;
-    const unsigned int min_tag = __scalar_as_int( last_min_vel.z);
-    const unsigned int min_idx = d_rtag[min_tag];
-    const unsigned int max_tag = __scalar_as_int( last_max_vel.z);
-    const unsigned int max_idx = d_rtag[max_tag];
+
+    // thread 0 updates the min particle, thread 1 the max particle
+    const Scalar3 vel = (idx == 0) ? last_min_vel : last_max_vel;
+    const Scalar new_mom = (idx == 0) ? last_max_vel.x : last_min_vel.x;
+    const unsigned int pidx = d_rtag[__scalar_as_int(vel.z)];
+
     //Is the particle local on the processor?
-    //Swap the particles the new velocities.
-    if( min_idx < Ntotal)
+    if (pidx < Ntotal)
         {
-        const Scalar new_min_vel = last_max_vel.x  / last_min_vel.y;
+        Scalar4 v = d_vel[pidx];
+        const Scalar new_vel = new_mom / v.w;
         switch( flow_direction )
             {
             case flow_enum::X:
-                d_vel[min_idx].x = new_min_vel;
+                v.x = new_vel;
                 break;
             case flow_enum::Y:
-                d_vel[min_idx].y = new_min_vel;
+                v.y = new_vel;
                 break;
             case flow_enum::Z:
-                d_vel[min_idx].z = new_min_vel;
+                v.z = new_vel;
                 break;
             }
+        d_vel[pidx] = v;
         }
-
-    if( max_idx < Ntotal)
-      {
-        const Scalar new_max_vel = last_min_vel.x  / last_max_vel.y;
-        switch( flow_direction)
-            {
-            case flow_enum::X:
-                d_vel[max_idx].x = new_max_vel;
-                break;
-            case flow_enum::Y:
-                d_vel[max_idx].y = new_max_vel;
-                break;
-            case flow_enum::Z:
-                d_vel[max_idx].z = new_max_vel;
-                break;
-            }
-      }
     }
 
 hipError_t gpu_update_min_max_velocity(const unsigned int *const d_rtag,
@@ -228,7 +324,7 @@ hipError_t gpu_update_min_max_velocity(const unsigned int *const d_rtag,
                                         const flow_enum::Direction flow_direction)
     {
     dim3 grid( 1, 1, 1);
-    dim3 threads(1, 1, 1);
+    dim3 threads(2, 1, 1);
 
     hipLaunchKernelGGL((gpu_update_min_max_velocity_kernel), dim3(grid), dim3(threads), 0, 0, d_rtag, d_vel, Ntotal,last_max_vel,
                                                          last_min_vel, flow_direction);
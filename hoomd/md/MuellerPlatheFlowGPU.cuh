@@ -11,24 +11,27 @@
 #ifndef __MUELLER_PLATHE_FLOW_GPU_CUH__
 #define __MUELLER_PLATHE_FLOW_GPU_CUH__
 
-hipError_t gpu_search_min_max_velocity(const unsigned int group_size,
+//! Search the min and max slabs for the particles with the extremal momentum
+hipError_t gpu_search_min_max_velocity(Scalar3 *const d_extrema,
+                                        Scalar4 *const d_block_extrema,
+                                        const unsigned int group_size,
                                         const Scalar4*const d_vel,
                                         const Scalar4*const d_pos,
                                         const unsigned int *const d_tag,
-                                        const unsigned int *const d_rtag,
                                         const unsigned int *const d_group_members,
                                         const BoxDim gl_box,
                                         const unsigned int Nslabs,
                                         const unsigned int max_slab,
                                         const unsigned int min_slab,
-                                        Scalar3*const last_max_vel,
-                                        Scalar3*const last_min_vel,
                                         const bool has_max_slab,
                                         const bool has_min_slab,
+                                        const Scalar invalid_vel,
+                                        const unsigned int invalid_tag,
                                         const unsigned int blocksize,
                                         flow_enum::Direction flow_direction,
                                         flow_enum::Direction slab_direction);
 
+//! Swap the momentum of the extremal particles
 hipError_t gpu_update_min_max_velocity(const unsigned int *const d_rtag,
                                         Scalar4*const d_vel,
                                         const unsigned int Ntotal,
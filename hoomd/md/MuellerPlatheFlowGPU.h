@@ -16,6 +16,7 @@
 #include "hoomd/Updater.h"
 #include "hoomd/Variant.h"
 #include "hoomd/Autotuner.h"
+#include "hoomd/GPUVector.h"
 #include "MuellerPlatheFlow.h"
 #include <pybind11/pybind11.h>
 
@@ -65,6 +66,8 @@ class MuellerPlatheFlowGPU : public MuellerPlatheFlow
 
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
+        GPUArray<Scalar3> m_extrema;        //!< Max and min momentum, mass, and tag found on the device
+        GPUVector<Scalar4> m_block_extrema; //!< Max and min momentum candidates of each thread block
 
         virtual void search_min_max_velocity(void);
         virtual void update_min_max_velocity(void);
@@ -0,0 +1,196 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file MultiTauCorrelator.cc
+    \brief Defines the MultiTauCorrelator and BlockAverage classes
+*/
+
+#include "MultiTauCorrelator.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+/*! \param n_channels Number of channels in a sample
+    \param points_per_level Number of samples kept per level (p)
+    \param averaging Number of samples averaged into one sample of the next level (m)
+    \param n_levels Number of levels
+
+    The longest lag is (p-1) m^(n_levels-1) samples.
+*/
+MultiTauCorrelator::MultiTauCorrelator(unsigned int n_channels,
+                                       unsigned int points_per_level,
+                                       unsigned int averaging,
+                                       unsigned int n_levels)
+    : m_n_channels(n_channels), m_p(points_per_level), m_m(averaging), m_n_levels(n_levels)
+    {
+    if (m_m < 2 || m_p < m_m || m_p % m_m != 0)
+        throw std::invalid_argument("points_per_level must be a multiple of averaging, which must be at least 2");
+    if (m_n_levels < 1)
+        throw std::invalid_argument("The correlator needs at least one level");
+
+    m_shift.resize(m_n_levels*m_p*m_n_channels);
+    m_accumulator.resize(m_n_levels*m_n_channels);
+    m_average.resize(m_n_levels*m_n_channels);
+    m_n_accumulated.resize(m_n_levels);
+    m_insert.resize(m_n_levels);
+    m_n_inserted.resize(m_n_levels);
+    m_correlation.resize(m_n_levels*m_p);
+    m_n_correlation.resize(m_n_levels*m_p);
+    reset();
+    }
+
+void MultiTauCorrelator::reset()
+    {
+    std::fill(m_shift.begin(), m_shift.end(), 0.0);
+    std::fill(m_accumulator.begin(), m_accumulator.end(), 0.0);
+    std::fill(m_n_accumulated.begin(), m_n_accumulated.end(), 0);
+    std::fill(m_insert.begin(), m_insert.end(), 0);
+    std::fill(m_n_inserted.begin(), m_n_inserted.end(), 0);
+    std::fill(m_correlation.begin(), m_correlation.end(), 0.0);
+    std::fill(m_n_correlation.begin(), m_n_correlation.end(), 0);
+    }
+
+/*! \param values Values of the channels
+    \param level Level to add the sample to
+*/
+void MultiTauCorrelator::add(const double *values, unsigned int level)
+    {
+    // store the sample as the newest of this level
+    const unsigned int newest = m_insert[level];
+    double *shift = &m_shift[level*m_p*m_n_channels];
+    for (unsigned int c = 0; c < m_n_channels; c++)
+        shift[newest*m_n_channels + c] = values[c];
+    if (m_n_inserted[level] < m_p)
+        m_n_inserted[level]++;
+
+    // correlate with the older samples, skipping the short lags that the level below resolves
+    const unsigned int first_lag = (level == 0) ? 0 : m_p/m_m;
+    for (unsigned int j = first_lag; j < m_n_inserted[level]; j++)
+        {
+        const unsigned int older = (newest + m_p - j) % m_p;
+        double sum = 0.0;
+        for (unsigned int c = 0; c < m_n_channels; c++)
+            sum += shift[newest*m_n_channels + c]*shift[older*m_n_channels + c];
+        m_correlation[level*m_p + j] += sum;
+        m_n_correlation[level*m_p + j]++;
+        }
+
+    m_insert[level] = (newest + 1) % m_p;
+
+    // average m samples into one sample of the next level
+    if (level + 1 < m_n_levels)
+        {
+        double *accumulator = &m_accumulator[level*m_n_channels];
+        for (unsigned int c = 0; c < m_n_channels; c++)
+            accumulator[c] += values[c];
+        m_n_accumulated[level]++;
+
+        if (m_n_accumulated[level] == m_m)
+            {
+            double *average = &m_average[level*m_n_channels];
+            for (unsigned int c = 0; c < m_n_channels; c++)
+                {
+                average[c] = accumulator[c]/double(m_m);
+                accumulator[c] = 0.0;
+                }
+            m_n_accumulated[level] = 0;
+            add(average, level+1);
+            }
+        }
+    }
+
+std::vector<double> MultiTauCorrelator::getLags() const
+    {
+    std::vector<double> lags;
+    lags.reserve(getNumLags());
+
+    double scale = 1.0;
+    for (unsigned int level = 0; level < m_n_levels; level++)
+        {
+        const unsigned int first_lag = (level == 0) ? 0 : m_p/m_m;
+        for (unsigned int j = first_lag; j < m_p; j++)
+            lags.push_back(double(j)*scale);
+        scale *= double(m_m);
+        }
+    return lags;
+    }
+
+std::vector<double> MultiTauCorrelator::getCorrelation() const
+    {
+    std::vector<double> correlation;
+    correlation.reserve(getNumLags());
+
+    for (unsigned int level = 0; level < m_n_levels; level++)
+        {
+        const unsigned int first_lag = (level == 0) ? 0 : m_p/m_m;
+        for (unsigned int j = first_lag; j < m_p; j++)
+            {
+            const uint64_t n = m_n_correlation[level*m_p + j];
+            if (n > 0)
+                correlation.push_back(m_correlation[level*m_p + j]/double(n));
+            else
+                correlation.push_back(std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+    return correlation;
+    }
+
+/*! \param value Mean of a block
+    \param level Level of blocking, each block at \a level averages 2^level samples
+*/
+void BlockAverage::add(double value, unsigned int level)
+    {
+    if (level == m_n.size())
+        {
+        m_sum.push_back(0.0);
+        m_sum_sq.push_back(0.0);
+        m_n.push_back(0);
+        m_pending.push_back(0.0);
+        m_has_pending.push_back(false);
+        }
+
+    m_sum[level] += value;
+    m_sum_sq[level] += value*value;
+    m_n[level]++;
+
+    if (m_has_pending[level])
+        {
+        m_has_pending[level] = false;
+        add(0.5*(m_pending[level] + value), level+1);
+        }
+    else
+        {
+        m_pending[level] = value;
+        m_has_pending[level] = true;
+        }
+    }
+
+double BlockAverage::getMean() const
+    {
+    if (getNumSamples() == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return m_sum[0]/double(m_n[0]);
+    }
+
+/*! Levels with fewer than 16 blocks are too noisy to use, unless no level has that many.
+*/
+double BlockAverage::getStandardError() const
+    {
+    const uint64_t min_blocks = 16;
+
+    double error = std::numeric_limits<double>::quiet_NaN();
+    for (unsigned int level = 0; level < m_n.size(); level++)
+        {
+        const uint64_t n = m_n[level];
+        if (n < 2 || (level > 0 && n < min_blocks))
+            break;
+
+        const double mean = m_sum[level]/double(n);
+        const double variance = std::max(m_sum_sq[level]/double(n) - mean*mean, 0.0);
+        const double level_error = std::sqrt(variance/double(n - 1));
+        if (std::isnan(error) || level_error > error)
+            error = level_error;
+        }
+    return error;
+    }
@@ -0,0 +1,133 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file MultiTauCorrelator.h
+    \brief Declares the MultiTauCorrelator and BlockAverage classes
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <stdint.h>
+#include <vector>
+
+#ifndef __MULTI_TAU_CORRELATOR_H__
+#define __MULTI_TAU_CORRELATOR_H__
+
+//! Computes time correlation functions on the fly
+/*! The multiple tau correlator (Ramirez et al. 2010, J. Chem. Phys. 133, 154103) correlates each new sample with
+    the \a p most recent samples of level 0. Every \a m samples of a level are averaged into one sample of the
+    next level, which correlates the same way with lags \a m times longer. The lags grow geometrically with the
+    level, so correlating up to a lag of T samples takes O(p log T) memory and O(p) work per sample on average.
+    The lags of the higher levels below p/m are skipped, since the level below already covers them with a finer
+    resolution.
+
+    The samples have several channels, and the correlation is the sum over the channels of the product of the two
+    samples. Give the components of a vector as channels to correlate the vector dot product.
+
+    \ingroup computes
+*/
+class MultiTauCorrelator
+    {
+    public:
+        //! Construct the correlator
+        MultiTauCorrelator(unsigned int n_channels,
+                           unsigned int points_per_level,
+                           unsigned int averaging,
+                           unsigned int n_levels);
+
+        //! Add a sample
+        /*! \param values Values of the \a n_channels channels in the sample
+        */
+        void add(const double *values)
+            {
+            add(values, 0);
+            }
+
+        //! Get the number of lags
+        unsigned int getNumLags() const
+            {
+            return m_p + (m_n_levels - 1)*(m_p - m_p/m_m);
+            }
+
+        //! Get the lags of the correlation, in samples
+        std::vector<double> getLags() const;
+
+        //! Get the correlation at each lag, NaN when no pair of samples is that far apart yet
+        std::vector<double> getCorrelation() const;
+
+        //! Remove all samples
+        void reset();
+
+    private:
+        unsigned int m_n_channels;      //!< Number of channels in a sample
+        unsigned int m_p;               //!< Number of samples per level
+        unsigned int m_m;               //!< Number of samples averaged into one sample of the next level
+        unsigned int m_n_levels;        //!< Number of levels
+
+        std::vector<double> m_shift;            //!< Recent samples, indexed by level, position, and channel
+        std::vector<double> m_accumulator;      //!< Sum of the samples to average, by level and channel
+        std::vector<double> m_average;          //!< Averaged sample passed to the next level, by level and channel
+        std::vector<unsigned int> m_n_accumulated;  //!< Number of samples in the accumulator of each level
+        std::vector<unsigned int> m_insert;     //!< Position of the newest sample of each level
+        std::vector<unsigned int> m_n_inserted; //!< Number of samples of each level, up to p
+        std::vector<double> m_correlation;      //!< Sum of the products, by level and lag index
+        std::vector<uint64_t> m_n_correlation;  //!< Number of products, by level and lag index
+
+        //! Add a sample to a level
+        void add(const double *values, unsigned int level);
+    };
+
+//! Computes the mean and its statistical error on the fly
+/*! The error is estimated with the blocking method of Flyvbjerg and Petersen (1989, J. Chem. Phys. 91, 461). The
+    samples are repeatedly averaged in pairs, and the variance of the mean is estimated at each level of blocking.
+    Correlations between the samples lead to an underestimate at the low levels, which vanishes once the blocks are
+    longer than the correlation time. The largest estimate among the levels with enough blocks is reported.
+    The memory needed grows as O(log T) with the number of samples T.
+
+    \ingroup computes
+*/
+class BlockAverage
+    {
+    public:
+        //! Add a sample
+        void add(double value)
+            {
+            add(value, 0);
+            }
+
+        //! Get the number of samples
+        uint64_t getNumSamples() const
+            {
+            return m_n.empty() ? 0 : m_n[0];
+            }
+
+        //! Get the mean of the samples, NaN when there are none
+        double getMean() const;
+
+        //! Get the estimated standard error of the mean, NaN when there are too few samples
+        double getStandardError() const;
+
+        //! Remove all samples
+        void reset()
+            {
+            m_sum.clear();
+            m_sum_sq.clear();
+            m_n.clear();
+            m_pending.clear();
+            m_has_pending.clear();
+            }
+
+    private:
+        std::vector<double> m_sum;          //!< Sum of the block means at each level
+        std::vector<double> m_sum_sq;       //!< Sum of the squared block means at each level
+        std::vector<uint64_t> m_n;          //!< Number of blocks at each level
+        std::vector<double> m_pending;      //!< First block of the next pair at each level
+        std::vector<bool> m_has_pending;    //!< True when a level holds the first block of a pair
+
+        //! Add a block mean to a level
+        void add(double value, unsigned int level);
+    };
+
+#endif
@@ -13,9 +13,17 @@
 
 namespace py = pybind11;
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_scan.h>
+#include <tbb/parallel_sort.h>
+#endif
+
 using namespace std;
 
 /*! \file NeighborList.cc
@@ -33,8 +41,8 @@ using namespace std;
 NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_cut, Scalar r_buff)
     : Compute(sysdef), m_typpair_idx(m_pdata->getNTypes()), m_rcut_max_max(_r_cut), m_rcut_min(_r_cut),
       m_r_buff(r_buff), m_d_max(1.0), m_filter_body(false), m_diameter_shift(false), m_storage_mode(half),
-      m_rcut_changed(true), m_updates(0), m_forced_updates(0), m_dangerous_updates(0), m_force_update(true),
-      m_dist_check(true), m_has_been_updated_once(false)
+      m_compress(false), m_head_list_compressed(false), m_sort_by_distance(false), m_partial_rebuild(false), m_nlist_on_host(false), m_rcut_changed(true), m_updates(0), m_forced_updates(0), m_dangerous_updates(0), m_force_update(true),
+      m_update_forced(true), m_remap_pending(false), m_dist_check(true), m_has_been_updated_once(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Neighborlist" << endl;
 
@@ -50,13 +58,32 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_last_checked_tstep = 0;
     m_last_check_result = false;
     m_rebuild_check_delay = 0;
+    m_adaptive_check = false;
+    m_predicted_delay = 0;
+    m_tune_r_buff = false;
+    m_tune_window_active = false;
+    m_tune_start_time = 0;
+    m_tune_start_tstep = 0;
+    m_tune_builds = 0;
+    m_tune_best_cost = -1.0;
+    m_tune_best_r_buff = m_r_buff;
+    m_tune_step = Scalar(0.25)*m_r_buff;
+    m_tune_direction = 1;
     m_exclusions_set = false;
 
     m_need_reallocate_exlist = false;
+    m_ex_list_idx_dirty = true;
+    m_exclusions_in_build = false;
+    m_ex_list_sorted_dirty = true;
 
     // initialize box length at last update
     m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
     m_last_L_local = m_pdata->getBox().getNearestPlaneDistance();
+    m_last_global_box = m_pdata->getGlobalBox();
+    m_scaled_check = false;
+    m_disp_bound_valid = false;
+    m_disp_bound_epoch = 0;
+    m_disp_bound = Scalar(0.0);
 
     // allocate r_cut pairwise storage
     GlobalArray<Scalar> r_cut(m_typpair_idx.getNumElements(), m_exec_conf);
@@ -160,6 +187,10 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_last_pos.swap(last_pos);
     TAG_ALLOCATION(m_last_pos);
 
+    GlobalArray<unsigned int> last_tag(m_pdata->getMaxN(), m_exec_conf);
+    m_last_tag.swap(last_tag);
+    TAG_ALLOCATION(m_last_tag);
+
     // allocate initial memory allowing 4 exclusions per particle (will grow to match specified exclusions)
 
     // note: this breaks O(N/P) memory scaling
@@ -185,8 +216,8 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_ex_list_indexer = Index2D((unsigned int)m_ex_list_idx.getPitch(), 1);
     m_ex_list_indexer_tag = Index2D((unsigned int)m_ex_list_tag.getPitch(), 1);
 
-    // connect to particle sort to force rebuild
-    m_pdata->getParticleSortSignal().connect<NeighborList, &NeighborList::forceUpdate>(this);
+    // connect to particle sort to force rebuild, or to remap the list
+    m_pdata->getParticleSortSignal().connect<NeighborList, &NeighborList::slotParticlesSorted>(this);
 
     // connect to max particle change to resize neighborlist arrays
     m_pdata->getMaxParticleNumberChangeSignal().connect<NeighborList, &NeighborList::reallocate>(this);
@@ -214,6 +245,7 @@ void NeighborList::reallocate()
     {
     // resize the exclusions
     m_last_pos.resize(m_pdata->getMaxN());
+    m_last_tag.resize(m_pdata->getMaxN());
     size_t old_n_ex = m_n_ex_idx.getNumElements();
     m_n_ex_idx.resize(m_pdata->getMaxN());
 
@@ -292,7 +324,7 @@ NeighborList::~NeighborList()
     {
     m_exec_conf->msg->notice(5) << "Destroying Neighborlist" << endl;
 
-    m_pdata->getParticleSortSignal().disconnect<NeighborList, &NeighborList::forceUpdate>(this);
+    m_pdata->getParticleSortSignal().disconnect<NeighborList, &NeighborList::slotParticlesSorted>(this);
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<NeighborList, &NeighborList::reallocate>(this);
     m_pdata->getGlobalParticleNumberChangeSignal().disconnect<NeighborList, &NeighborList::slotGlobalParticleNumberChange>(this);
 #ifdef ENABLE_MPI
@@ -321,19 +353,24 @@ void NeighborList::compute(uint64_t timestep)
         }
 
     // skip if we shouldn't compute this step
-    if (!shouldCompute(timestep) && !m_force_update)
+    if (!shouldCompute(timestep) && !m_force_update && !m_remap_pending)
         return;
 
     if (m_prof) m_prof->push("Neighbor");
 
+    // follow a permutation of the particles, unless the list is rebuilt anyway
+    if (m_remap_pending)
+        {
+        if (!m_force_update)
+            remapNlist();
+        m_remap_pending = false;
+        }
+
     // take care of some updates if things have changed since construction
     if (m_force_update)
         {
         // build the head list since some sort of change (like a particle sort) happened
         buildHeadList();
-
-        if (m_exclusions_set)
-            updateExListIdx();
         }
 
     // check if the list needs to be updated and update it
@@ -342,29 +379,83 @@ void NeighborList::compute(uint64_t timestep)
         // check simulation box size is OK
         checkBoxSize();
 
-        // rebuild the list until there is no overflow
-        bool overflowed = false;
-        do
+        #ifdef ENABLE_MPI
+        // the build reads ghost positions
+        if (m_comm)
+            m_comm->completeGhostUpdate(timestep);
+        #endif
+
+        // rows can only be rebuilt in place in the strided list of the last build
+        bool partial = m_partial_rebuild && !m_update_forced && m_has_been_updated_once && !m_head_list_compressed;
+
+        // the build writes with the Nmax stride of each type
+        if (m_head_list_compressed)
             {
-            buildNlist(timestep);
+            buildHeadList();
+            m_head_list_compressed = false;
+            }
+
+        if (m_exclusions_set && m_exclusions_in_build && m_ex_list_sorted_dirty)
+            updateExListSorted();
 
-            overflowed = checkConditions();
-            // if we overflowed, need to reallocate memory and reset the conditions
-            if (overflowed)
+        m_timer.start();
+
+        if (partial)
+            partial = rebuildPartially(timestep);
+
+        if (!partial)
+            {
+            // rebuild the list until there is no overflow
+            bool overflowed = false;
+            do
                 {
-                // always rebuild the head list after an overflow
-                buildHeadList();
+                buildNlist(timestep);
 
-                // zero out the conditions for the next build
-                resetConditions();
+                overflowed = checkConditions();
+                // if we overflowed, need to reallocate memory and reset the conditions
+                if (overflowed)
+                    {
+                    // always rebuild the head list after an overflow
+                    buildHeadList();
+
+                    // zero out the conditions for the next build
+                    resetConditions();
+                    }
+                } while (overflowed);
+
+            if (m_exclusions_set && !m_exclusions_in_build)
+                {
+                updateExListIdxIfNeeded();
+                filterNlist();
                 }
-            } while (overflowed);
 
-        if (m_exclusions_set)
-            filterNlist();
+            if (m_compress)
+                {
+                compressNlist();
+                m_head_list_compressed = true;
+                }
 
-        setLastUpdatedPos();
+            if (m_sort_by_distance)
+                sortNlist();
+            }
+
+        m_timer.stop();
+
+        // a partial rebuild has already updated the reference positions of the fast particles
+        if (!partial)
+            {
+            setLastUpdatedPos();
+
+            // remember the displacement bound of the reference positions
+            m_disp_bound_valid = m_pdata->isDisplacementBoundValid(timestep);
+            m_disp_bound_epoch = m_pdata->getDisplacementBoundEpoch();
+            m_disp_bound = m_pdata->getDisplacementBound();
+            }
+        setLastUpdatedTags();
         m_has_been_updated_once = true;
+
+        if (m_tune_r_buff)
+            tuneRBuff(timestep);
         }
     if (m_prof) m_prof->pop();
     }
@@ -380,6 +471,11 @@ double NeighborList::benchmark(unsigned int num_iters)
     // warm up run
     forceUpdate();
     compute(0);
+    if (m_head_list_compressed)
+        {
+        buildHeadList();
+        m_head_list_compressed = false;
+        }
     buildNlist(0);
 
 #ifdef ENABLE_HIP
@@ -417,6 +513,10 @@ void NeighborList::setRBuff(Scalar r_buff)
         m_exec_conf->msg->error() << "nlist: Requested buffer radius is less than zero" << endl;
         throw runtime_error("Error changing NeighborList parameters");
         }
+
+    // the predicted check delay scales with the buffer radius
+    predictCheckDelay();
+
     notifyRCutMatrixChange();
     forceUpdate();
     }
@@ -598,7 +698,7 @@ void NeighborList::addExclusion(unsigned int tag1, unsigned int tag2)
 
     if (grow)
         {
-        growExclusionList();
+        growExclusionList(m_ex_list_indexer.getH() + 1);
         }
 
         {
@@ -619,6 +719,7 @@ void NeighborList::addExclusion(unsigned int tag1, unsigned int tag2)
         h_n_ex_tag.data[tag2]++;
         }
 
+    m_ex_list_sorted_dirty = true;
     forceUpdate();
     }
 
@@ -650,6 +751,7 @@ void NeighborList::clearExclusions()
     memset(h_n_ex_tag.data, 0, sizeof(unsigned int)*m_n_ex_tag.getNumElements());
     memset(h_n_ex_idx.data, 0, sizeof(unsigned int)*m_n_ex_idx.getNumElements());
     m_exclusions_set = false;
+    m_ex_list_sorted_dirty = true;
 
     forceUpdate();
     }
@@ -800,104 +902,242 @@ void NeighborList::countExclusions()
         }
     }
 
-/*! After calling addExclusionsFromBonds() all bonds specified in the attached ParticleData will be
-    added as exclusions. Any additional bonds added after this will not be automatically added as exclusions.
+/*! \param group_data Bonded group data
+    \param pdata Particle data
+    \param exec_conf Execution configuration
+    \returns The members of all groups, on every rank
 */
-void NeighborList::addExclusionsFromBonds()
+template<class GroupData>
+static std::vector<typename GroupData::members_t> getAllGroups(std::shared_ptr<GroupData> group_data,
+                                                               std::shared_ptr<ParticleData> pdata,
+                                                               std::shared_ptr<const ExecutionConfiguration> exec_conf)
     {
-    std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
+    // access the group data by snapshot
+    typename GroupData::Snapshot snapshot;
+    group_data->takeSnapshot(snapshot);
 
-    // access bond data by snapshot
-    BondData::Snapshot snapshot;
-    bond_data->takeSnapshot(snapshot);
-
-    // broadcast global bond list
-    std::vector<BondData::members_t> bonds;
+    // broadcast the global group list
+    std::vector<typename GroupData::members_t> groups;
 
 #ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
+    if (pdata->getDomainDecomposition())
         {
-        if (m_exec_conf->getRank() == 0)
-            bonds = snapshot.groups;
+        if (exec_conf->getRank() == 0)
+            groups = snapshot.groups;
 
-        bcast(bonds, 0, m_exec_conf->getMPICommunicator());
+        bcast(groups, 0, exec_conf->getMPICommunicator());
         }
     else
 #endif
         {
-        bonds = snapshot.groups;
+        groups = snapshot.groups;
         }
 
-    // for each bond
-    for (unsigned int i = 0; i < bonds.size(); i++)
-        // add an exclusion
-        addExclusion(bonds[i].tag[0], bonds[i].tag[1]);
+    return groups;
     }
 
-/*! After calling addExclusionsFromAngles(), all angles specified in the attached ParticleData will be added to the
-    exclusion list. Only the two end particles in the angle are excluded from interacting.
+/*! \param bonds Members of all bonds
+    \param n_tags Number of particle tags
+    \param first Set to the index of the first bond partner of every tag in \a partners (n_tags+1 elements)
+    \param partners Set to the bond partners of all tags
 */
-void NeighborList::addExclusionsFromAngles()
+static void getBondPartners(const std::vector<BondData::members_t>& bonds,
+                            unsigned int n_tags,
+                            std::vector<unsigned int>& first,
+                            std::vector<unsigned int>& partners)
     {
-    std::shared_ptr<AngleData> angle_data = m_sysdef->getAngleData();
+    // count the bonds of every tag
+    first.assign(n_tags+1, 0);
+    for (const auto& bond : bonds)
+        {
+        first[bond.tag[0]+1]++;
+        first[bond.tag[1]+1]++;
+        }
 
-    // access angle data by snapshot
-    AngleData::Snapshot snapshot;
-    angle_data->takeSnapshot(snapshot);
+    for (unsigned int tag = 0; tag < n_tags; tag++)
+        first[tag+1] += first[tag];
 
-    // broadcast global angle list
-    std::vector<AngleData::members_t> angles;
+    // fill in the partners
+    std::vector<unsigned int> n_partners(n_tags, 0);
+    partners.resize(first[n_tags]);
+    for (const auto& bond : bonds)
+        {
+        const unsigned int tag_a = bond.tag[0];
+        const unsigned int tag_b = bond.tag[1];
+        partners[first[tag_a] + n_partners[tag_a]++] = tag_b;
+        partners[first[tag_b] + n_partners[tag_b]++] = tag_a;
+        }
+    }
 
-#ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
+/*! \param pairs Pairs of particle tags to exclude from the neighbor list
+
+    Adds all exclusions at once, which is much faster than calling addExclusion() for every pair in large systems.
+    Both directions of every pair are sorted by tag, the number of exclusions of every tag is counted, and then the
+    exclusion list is grown once to its final height and filled. Duplicate pairs and pairs that are already excluded
+    are skipped. With TBB, the sort and the passes over the tags run in parallel.
+*/
+void NeighborList::addExclusions(const std::vector< std::pair<unsigned int, unsigned int> >& pairs)
+    {
+    assert(! m_need_reallocate_exlist);
+
+    if (pairs.empty())
+        return;
+
+    m_exclusions_set = true;
+
+    // both directions of every pair, stored as (tag << 32) | excluded tag so that they sort by tag
+    std::vector<uint64_t> entries(2*pairs.size());
+    auto make_entries = [&](size_t begin, size_t end)
+        {
+        for (size_t i = begin; i < end; i++)
+            {
+            assert(pairs[i].first <= m_pdata->getMaximumTag());
+            assert(pairs[i].second <= m_pdata->getMaximumTag());
+            entries[2*i] = (uint64_t(pairs[i].first) << 32) | pairs[i].second;
+            entries[2*i+1] = (uint64_t(pairs[i].second) << 32) | pairs[i].first;
+            }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pairs.size()),
+        [&](const tbb::blocked_range<size_t>& r) { make_entries(r.begin(), r.end()); });
+    tbb::parallel_sort(entries.begin(), entries.end());
+    #else
+    make_entries(0, pairs.size());
+    std::sort(entries.begin(), entries.end());
+    #endif
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    const unsigned int n_tags = (unsigned int)m_pdata->getRTags().size();
+    std::vector<size_t> first(n_tags+1);
+    std::vector<unsigned int> n_ex(n_tags);
+    first[n_tags] = entries.size();
+
+    // tests if an entry is in the exclusion list of a tag before this call
+    auto is_excluded = [this](const unsigned int *ex_list_tag, unsigned int n_ex_old, unsigned int tag,
+                              unsigned int other)
         {
-        if (m_exec_conf->getRank() == 0)
-            angles = snapshot.groups;
+        for (unsigned int i = 0; i < n_ex_old; i++)
+            {
+            if (ex_list_tag[m_ex_list_indexer_tag(tag,i)] == other)
+                return true;
+            }
+        return false;
+        };
 
-        bcast(angles, 0, m_exec_conf->getMPICommunicator());
+        {
+        ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::read);
+
+        // count the exclusions of every tag
+        auto count = [&](unsigned int begin, unsigned int end)
+            {
+            for (unsigned int tag = begin; tag < end; tag++)
+                {
+                first[tag] = std::lower_bound(entries.begin(), entries.end(), uint64_t(tag) << 32) - entries.begin();
+                size_t last = std::lower_bound(entries.begin() + first[tag], entries.end(), uint64_t(tag+1) << 32)
+                    - entries.begin();
+
+                const unsigned int n_ex_old = h_n_ex_tag.data[tag];
+                n_ex[tag] = n_ex_old;
+                for (size_t i = first[tag]; i < last; i++)
+                    {
+                    if (!is_excluded(h_ex_list_tag.data, n_ex_old, tag, (unsigned int)entries[i]))
+                        n_ex[tag]++;
+                    }
+                }
+            };
+
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_tags),
+            [&](const tbb::blocked_range<unsigned int>& r) { count(r.begin(), r.end()); });
+        #else
+        count(0, n_tags);
+        #endif
         }
-    else
-#endif
+
+    // grow the list once
+    const unsigned int max_n_ex = *std::max_element(n_ex.begin(), n_ex.end());
+    if (max_n_ex > m_ex_list_indexer_tag.getH())
+        growExclusionList(max_n_ex);
+
         {
-        angles = snapshot.groups;
+        ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::readwrite);
+
+        // append the new exclusions of every tag, each tag is written by one thread
+        auto fill = [&](unsigned int begin, unsigned int end)
+            {
+            for (unsigned int tag = begin; tag < end; tag++)
+                {
+                const unsigned int n_ex_old = h_n_ex_tag.data[tag];
+                unsigned int pos = n_ex_old;
+                for (size_t i = first[tag]; i < first[tag+1]; i++)
+                    {
+                    const unsigned int other = (unsigned int)entries[i];
+                    if (!is_excluded(h_ex_list_tag.data, n_ex_old, tag, other))
+                        h_ex_list_tag.data[m_ex_list_indexer_tag(tag,pos++)] = other;
+                    }
+                assert(pos == n_ex[tag]);
+                h_n_ex_tag.data[tag] = pos;
+                }
+            };
+
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_tags),
+            [&](const tbb::blocked_range<unsigned int>& r) { fill(r.begin(), r.end()); });
+        #else
+        fill(0, n_tags);
+        #endif
         }
 
-    // for each angle
-    for (unsigned int i = 0; i < angles.size(); i++)
-        addExclusion(angles[i].tag[0], angles[i].tag[2]);
+    m_ex_list_sorted_dirty = true;
+    forceUpdate();
     }
 
-/*! After calling addExclusionsFromDihedrals(), all dihedrals specified in the attached ParticleData will be added to the
-    exclusion list. Only the two end particles in the dihedral are excluded from interacting.
+/*! After calling addExclusionsFromBonds() all bonds specified in the attached ParticleData will be
+    added as exclusions. Any additional bonds added after this will not be automatically added as exclusions.
 */
-void NeighborList::addExclusionsFromDihedrals()
+void NeighborList::addExclusionsFromBonds()
     {
-    std::shared_ptr<DihedralData> dihedral_data = m_sysdef->getDihedralData();
+    std::vector<BondData::members_t> bonds = getAllGroups(m_sysdef->getBondData(), m_pdata, m_exec_conf);
 
-    // access dihedral data by snapshot
-    DihedralData::Snapshot snapshot;
-    dihedral_data->takeSnapshot(snapshot);
+    // exclude the particles of each bond
+    std::vector< std::pair<unsigned int, unsigned int> > pairs(bonds.size());
+    for (unsigned int i = 0; i < bonds.size(); i++)
+        pairs[i] = std::make_pair(bonds[i].tag[0], bonds[i].tag[1]);
 
-    // broadcast global dihedral list
-    std::vector<DihedralData::members_t> dihedrals;
+    addExclusions(pairs);
+    }
 
-#ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        if (m_exec_conf->getRank() == 0)
-            dihedrals = snapshot.groups;
+/*! After calling addExclusionsFromAngles(), all angles specified in the attached ParticleData will be added to the
+    exclusion list. Only the two end particles in the angle are excluded from interacting.
+*/
+void NeighborList::addExclusionsFromAngles()
+    {
+    std::vector<AngleData::members_t> angles = getAllGroups(m_sysdef->getAngleData(), m_pdata, m_exec_conf);
 
-        bcast(dihedrals, 0, m_exec_conf->getMPICommunicator());
-        }
-    else
-#endif
-        {
-        dihedrals = snapshot.groups;
-        }
+    // exclude the end particles of each angle
+    std::vector< std::pair<unsigned int, unsigned int> > pairs(angles.size());
+    for (unsigned int i = 0; i < angles.size(); i++)
+        pairs[i] = std::make_pair(angles[i].tag[0], angles[i].tag[2]);
+
+    addExclusions(pairs);
+    }
 
-    // for each dihedral
+/*! After calling addExclusionsFromDihedrals(), all dihedrals specified in the attached ParticleData will be added to the
+    exclusion list. Only the two end particles in the dihedral are excluded from interacting.
+*/
+void NeighborList::addExclusionsFromDihedrals()
+    {
+    std::vector<DihedralData::members_t> dihedrals = getAllGroups(m_sysdef->getDihedralData(), m_pdata, m_exec_conf);
+
+    // exclude the end particles of each dihedral
+    std::vector< std::pair<unsigned int, unsigned int> > pairs(dihedrals.size());
     for (unsigned int i = 0; i < dihedrals.size(); i++)
-        addExclusion(dihedrals[i].tag[0], dihedrals[i].tag[3]);
+        pairs[i] = std::make_pair(dihedrals[i].tag[0], dihedrals[i].tag[3]);
+
+    addExclusions(pairs);
     }
 
 /*! After calling addExclusionFromConstraints() all constraints specified in the attached ConstraintData will be
@@ -905,33 +1145,15 @@ void NeighborList::addExclusionsFromDihedrals()
 */
 void NeighborList::addExclusionsFromConstraints()
     {
-    std::shared_ptr<ConstraintData> constraint_data = m_sysdef->getConstraintData();
+    std::vector<ConstraintData::members_t> constraints = getAllGroups(m_sysdef->getConstraintData(), m_pdata,
+                                                                      m_exec_conf);
 
-    // access constraint data by snapshot
-    ConstraintData::Snapshot snapshot;
-    constraint_data->takeSnapshot(snapshot);
-
-    // broadcast global constraint list
-    std::vector<ConstraintData::members_t> constraints;
-
-#ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        if (m_exec_conf->getRank() == 0)
-            constraints = snapshot.groups;
-
-        bcast(constraints, 0, m_exec_conf->getMPICommunicator());
-        }
-    else
-#endif
-        {
-        constraints = snapshot.groups;
-        }
-
-    // for each constraint
+    // exclude the particles of each constraint
+    std::vector< std::pair<unsigned int, unsigned int> > pairs(constraints.size());
     for (unsigned int i = 0; i < constraints.size(); i++)
-        // add an exclusion
-        addExclusion(constraints[i].tag[0], constraints[i].tag[1]);
+        pairs[i] = std::make_pair(constraints[i].tag[0], constraints[i].tag[1]);
+
+    addExclusions(pairs);
     }
 
 /*! After calling addExclusionFromPairs() all pairs specified in the attached ParticleData will be
@@ -939,33 +1161,14 @@ void NeighborList::addExclusionsFromConstraints()
 */
 void NeighborList::addExclusionsFromPairs()
     {
-    std::shared_ptr<PairData> pair_data = m_sysdef->getPairData();
+    std::vector<PairData::members_t> special_pairs = getAllGroups(m_sysdef->getPairData(), m_pdata, m_exec_conf);
 
-    // access pair data by snapshot
-    PairData::Snapshot snapshot;
-    pair_data->takeSnapshot(snapshot);
+    // exclude the particles of each special pair
+    std::vector< std::pair<unsigned int, unsigned int> > pairs(special_pairs.size());
+    for (unsigned int i = 0; i < special_pairs.size(); i++)
+        pairs[i] = std::make_pair(special_pairs[i].tag[0], special_pairs[i].tag[1]);
 
-    // broadcast global bond list
-    std::vector<PairData::members_t> pairs;
-
-#ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        if (m_exec_conf->getRank() == 0)
-            pairs = snapshot.groups;
-
-        bcast(pairs, 0, m_exec_conf->getMPICommunicator());
-        }
-    else
-#endif
-        {
-        pairs = snapshot.groups;
-        }
-
-    // for each pair
-    for (unsigned int i = 0; i < pairs.size(); i++)
-        // add an exclusion
-        addExclusion(pairs[i].tag[0], pairs[i].tag[1]);
+    addExclusions(pairs);
     }
 
 /*! \param tag1 First particle tag in the pair
@@ -996,77 +1199,36 @@ bool NeighborList::isExcluded(unsigned int tag1, unsigned int tag2)
  *
  * This excludes all non-bonded interactions between all pairs particles
  * that are bonded to the same atom.
- * To make the process quasi-linear scaling with system size we first
- * create a 1-d array the collects the number and index of bond partners.
+ * To make the process linear scaling with system size we first
+ * collect the bond partners of every atom.
  */
 void NeighborList::addOneThreeExclusionsFromTopology()
     {
-    std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
-    const unsigned int myNAtoms = (unsigned int)m_pdata->getRTags().size();
-    const unsigned int MAXNBONDS = 7+1; //! assumed maximum number of bonds per atom plus one entry for the number of bonds.
-    const unsigned int nBonds = bond_data->getNGlobal();
+    std::vector<BondData::members_t> bonds = getAllGroups(m_sysdef->getBondData(), m_pdata, m_exec_conf);
 
-    if (nBonds == 0)
+    if (bonds.size() == 0)
         {
         m_exec_conf->msg->warning() << "nlist: No bonds defined while trying to add topology derived 1-3 exclusions" << endl;
         return;
         }
 
-    // build a per atom list with all bonding partners from the list of bonds.
-    unsigned int *localBondList = new unsigned int[MAXNBONDS*myNAtoms];
-    memset((void *)localBondList,0,sizeof(unsigned int)*MAXNBONDS*myNAtoms);
+    const unsigned int n_tags = (unsigned int)m_pdata->getRTags().size();
+    std::vector<unsigned int> first;
+    std::vector<unsigned int> partners;
+    getBondPartners(bonds, n_tags, first, partners);
 
-    for (unsigned int i = 0; i < nBonds; i++)
+    // exclude all pairs of bond partners of the atoms in the middle of an angle
+    std::vector< std::pair<unsigned int, unsigned int> > pairs;
+    for (unsigned int tag = 0; tag < n_tags; tag++)
         {
-        // loop over all bonds and make a 1D exclusion map
-
-        // FIXME: this will not work when the group tags are not contiguous
-        Bond bondi = bond_data->getGroupByTag(i);
-
-        const unsigned int tagA = bondi.a;
-        const unsigned int tagB = bondi.b;
-
-        // next, increment the number of bonds, and update the tags
-        const unsigned int nBondsA = ++localBondList[tagA*MAXNBONDS];
-        const unsigned int nBondsB = ++localBondList[tagB*MAXNBONDS];
-
-        if (nBondsA >= MAXNBONDS)
-            {
-            m_exec_conf->msg->error() << "nlist: Too many bonds to process exclusions for particle with tag: " << tagA << endl;
-            m_exec_conf->msg->error() << "Maximum allowed is currently: " << MAXNBONDS-1 << endl;
-            throw runtime_error("Error setting up topological exclusions in NeighborList");
-            }
-
-        if (nBondsB >= MAXNBONDS)
+        for (unsigned int j = first[tag]; j < first[tag+1]; ++j)
             {
-            m_exec_conf->msg->error() << "nlist: Too many bonds to process exclusions for particle with tag: " << tagB << endl;
-            m_exec_conf->msg->error() << "Maximum allowed is currently: " << MAXNBONDS-1 << endl;
-            throw runtime_error("Error setting up topological exclusions in NeighborList");
+            for (unsigned int k = j+1; k < first[tag+1]; ++k)
+                pairs.push_back(std::make_pair(partners[j], partners[k]));
             }
-
-        localBondList[tagA*MAXNBONDS + nBondsA] = tagB;
-        localBondList[tagB*MAXNBONDS + nBondsB] = tagA;
         }
 
-    // now loop over the atoms and build exclusions if we have more than
-    // one bonding partner, i.e. we are in the center of an angle.
-    for (unsigned int i = 0; i < myNAtoms; i++)
-        {
-        // now, loop over all atoms, and find those in the middle of an angle
-        const unsigned int iAtom = i*MAXNBONDS;
-        const unsigned int nBonds = localBondList[iAtom];
-
-        if (nBonds > 1) // need at least two bonds
-            {
-            for (unsigned int j = 1; j < nBonds; ++j)
-                {
-                for (unsigned int k = j+1; k <= nBonds; ++k)
-                    addExclusion(localBondList[iAtom+j],localBondList[iAtom+k]);
-                }
-            }
-        }
-    // free temp memory
-    delete[] localBondList;
+    addExclusions(pairs);
     }
 
 /*! Add topologically derived exclusions for dihedrals
@@ -1074,85 +1236,49 @@ void NeighborList::addOneThreeExclusionsFromTopology()
  * This excludes all non-bonded interactions between all pairs particles
  * that are connected to a common bond.
  *
- * To make the process quasi-linear scaling with system size we first
- * create a 1-d array the collects the number and index of bond partners.
- * and then loop over bonded partners.
+ * To make the process linear scaling with system size we first
+ * collect the bond partners of every atom and then loop over bonded partners.
  */
 void NeighborList::addOneFourExclusionsFromTopology()
     {
-    std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
-    const unsigned int myNAtoms = (unsigned int)m_pdata->getRTags().size();
-    const unsigned int MAXNBONDS = 7+1; //! assumed maximum number of bonds per atom plus one entry for the number of bonds.
-    const unsigned int nBonds = bond_data->getNGlobal();
+    std::vector<BondData::members_t> bonds = getAllGroups(m_sysdef->getBondData(), m_pdata, m_exec_conf);
 
-    if (nBonds == 0)
+    if (bonds.size() == 0)
         {
         m_exec_conf->msg->warning() << "nlist: No bonds defined while trying to add topology derived 1-4 exclusions" << endl;
         return;
         }
 
-    // allocate and clear data.
-    unsigned int *localBondList = new unsigned int[MAXNBONDS*myNAtoms];
-    memset((void *)localBondList,0,sizeof(unsigned int)*MAXNBONDS*myNAtoms);
-
-    for (unsigned int i = 0; i < nBonds; i++)
-        {
-        // loop over all bonds and make a 1D exclusion map
-        Bond bondi = bond_data->getGroupByTag(i);
-        const unsigned int tagA = bondi.a;
-        const unsigned int tagB = bondi.b;
-
-        // next, increment the number of bonds, and update the tags
-        const unsigned int nBondsA = ++localBondList[tagA*MAXNBONDS];
-        const unsigned int nBondsB = ++localBondList[tagB*MAXNBONDS];
-
-        if (nBondsA >= MAXNBONDS)
-            {
-            m_exec_conf->msg->error() << "nlist: Too many bonds to process exclusions for particle with tag: " << tagA << endl;
-            m_exec_conf->msg->error() << "Maximum allowed is currently: " << MAXNBONDS-1 << endl;
-            throw runtime_error("Error setting up topological exclusions in NeighborList");
-            }
-
-        if (nBondsB >= MAXNBONDS)
-            {
-            m_exec_conf->msg->error() << "nlist: Too many bonds to process exclusions for particle with tag: " << tagB << endl;
-            m_exec_conf->msg->error() << "Maximum allowed is currently: " << MAXNBONDS-1 << endl;
-            throw runtime_error("Error setting up topological exclusions in NeighborList");
-            }
-
-        localBondList[tagA*MAXNBONDS + nBondsA] = tagB;
-        localBondList[tagB*MAXNBONDS + nBondsB] = tagA;
-        }
+    const unsigned int n_tags = (unsigned int)m_pdata->getRTags().size();
+    std::vector<unsigned int> first;
+    std::vector<unsigned int> partners;
+    getBondPartners(bonds, n_tags, first, partners);
 
     //  loop over all bonds
-    for (unsigned int i = 0; i < nBonds; i++)
+    std::vector< std::pair<unsigned int, unsigned int> > pairs;
+    for (const auto& bond : bonds)
         {
-        // FIXME: this will not work when the group tags are not contiguous
-        Bond bondi = bond_data->getGroupByTag(i);
-        const unsigned int tagA = bondi.a;
-        const unsigned int tagB = bondi.b;
-
-        const unsigned int nBondsA = localBondList[tagA*MAXNBONDS];
-        const unsigned int nBondsB = localBondList[tagB*MAXNBONDS];
+        const unsigned int tagA = bond.tag[0];
+        const unsigned int tagB = bond.tag[1];
 
-        for (unsigned int j = 1; j <= nBondsA; j++)
+        for (unsigned int j = first[tagA]; j < first[tagA+1]; j++)
             {
-            const unsigned int tagJ = localBondList[tagA*MAXNBONDS+j];
+            const unsigned int tagJ = partners[j];
             if (tagJ == tagB) // skip the bond in the middle of the dihedral
                 continue;
 
-            for (unsigned int k = 1; k <= nBondsB; k++)
+            for (unsigned int k = first[tagB]; k < first[tagB+1]; k++)
                 {
-                const unsigned int tagK = localBondList[tagB*MAXNBONDS+k];
+                const unsigned int tagK = partners[k];
                 if (tagK == tagA) // skip the bond in the middle of the dihedral
                     continue;
 
-                addExclusion(tagJ,tagK);
+                pairs.push_back(std::make_pair(tagJ, tagK));
                 }
             }
         }
-    // free temp memory
-    delete[] localBondList;
+
+    addExclusions(pairs);
     }
 
 
@@ -1188,6 +1314,10 @@ bool NeighborList::distanceCheck(uint64_t timestep)
     Scalar lambda_min = (lambda.x < lambda.y) ? lambda.x : lambda.y;
     lambda_min = (lambda_min < lambda.z) ? lambda_min : (Scalar) lambda.z;
 
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    if (m_scaled_check)
+        lambda_min = getMinBoxStretch();
+
     ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcut_max(m_rcut_max, access_location::host, access_mode::read);
 
@@ -1205,9 +1335,20 @@ bool NeighborList::distanceCheck(uint64_t timestep)
         const Scalar delta_max = (rmax*lambda_min - old_rmin)/Scalar(2.0);
         Scalar maxsq = (delta_max > 0) ? delta_max*delta_max : 0;
 
-        Scalar3 dx = make_scalar3(h_pos.data[i].x - lambda.x*h_last_pos.data[i].x,
-                                  h_pos.data[i].y - lambda.y*h_last_pos.data[i].y,
-                                  h_pos.data[i].z - lambda.z*h_last_pos.data[i].z);
+        Scalar3 dx;
+        if (m_scaled_check)
+            {
+            // position at the last update, carried along with the box deformation
+            Scalar3 last_pos = make_scalar3(h_last_pos.data[i].x, h_last_pos.data[i].y, h_last_pos.data[i].z);
+            Scalar3 affine_pos = global_box.makeCoordinates(m_last_global_box.makeFraction(last_pos));
+            dx = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z) - affine_pos;
+            }
+        else
+            {
+            dx = make_scalar3(h_pos.data[i].x - lambda.x*h_last_pos.data[i].x,
+                              h_pos.data[i].y - lambda.y*h_last_pos.data[i].y,
+                              h_pos.data[i].z - lambda.z*h_last_pos.data[i].z);
+            }
 
         dx = box.minImage(dx);
 
@@ -1242,6 +1383,65 @@ bool NeighborList::distanceCheck(uint64_t timestep)
     return result;
     }
 
+/*! \param timestep Current time step
+    \returns true if the rows near the fast particles were rebuilt, false if the full list must be built
+
+    A partial rebuild requires the box of the last build, because the reference positions are not carried along with
+    the box deformation, and a list in the strided storage of the build. It pays off only when few particles moved
+    more than half of the buffer distance.
+*/
+bool NeighborList::rebuildPartially(uint64_t timestep)
+    {
+    if (m_compress || m_sort_by_distance || (m_exclusions_set && !m_exclusions_in_build))
+        return false;
+
+    if (!(m_pdata->getGlobalBox() == m_last_global_box))
+        return false;
+
+    #ifdef ENABLE_MPI
+    // ghost particles have no reference positions
+    if (m_pdata->getDomainDecomposition())
+        return false;
+    #endif
+
+    if (m_prof) m_prof->push("partial");
+
+    const unsigned int N = m_pdata->getN();
+    const Scalar maxsq = m_r_buff*m_r_buff/Scalar(4.0);
+    std::vector<unsigned int> fast;
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::read);
+        const BoxDim& box = m_pdata->getBox();
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            Scalar3 dx = make_scalar3(h_pos.data[i].x - h_last_pos.data[i].x,
+                                      h_pos.data[i].y - h_last_pos.data[i].y,
+                                      h_pos.data[i].z - h_last_pos.data[i].z);
+            dx = box.minImage(dx);
+            if (dot(dx, dx) >= maxsq)
+                fast.push_back(i);
+            }
+        }
+
+    // the rows near the fast particles are rebuilt in about the time of the full list
+    bool result = !fast.empty() && fast.size() <= N/8 && buildNlistRows(timestep, fast);
+
+    // an overflow grows Nmax, and the full list is built with the new head list
+    if (checkConditions())
+        {
+        buildHeadList();
+        resetConditions();
+        result = false;
+        }
+
+    if (m_prof) m_prof->pop();
+
+    return result;
+    }
+
 /*! Copies the current positions of all particles over to m_last_x etc...
 */
 void NeighborList::setLastUpdatedPos()
@@ -1264,13 +1464,215 @@ void NeighborList::setLastUpdatedPos()
     // update last box nearest plane distance
     m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
     m_last_L_local = m_pdata->getBox().getNearestPlaneDistance();
+    m_last_global_box = m_pdata->getGlobalBox();
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \returns The smallest singular value of the deformation gradient F = H H_last^-1 that maps the global box at the
+        last update to the current one, where the columns of H_last and H are the lattice vectors of the boxes
+
+    The distance between two particles that follow the deformation shrinks at most by this factor. The singular
+    values are the square roots of the eigenvalues of the symmetric matrix F^T F, which are found in closed form.
+*/
+Scalar NeighborList::getMinBoxStretch() const
+    {
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+
+    // both box matrices are upper triangular
+    Scalar h[3][3], h_last[3][3];
+    for (unsigned int j = 0; j < 3; ++j)
+        {
+        Scalar3 a = global_box.getLatticeVector(j);
+        Scalar3 a_last = m_last_global_box.getLatticeVector(j);
+        h[0][j] = a.x; h[1][j] = a.y; h[2][j] = a.z;
+        h_last[0][j] = a_last.x; h_last[1][j] = a_last.y; h_last[2][j] = a_last.z;
+        }
+
+    // invert H_last
+    Scalar inv[3][3] = {{0,0,0},{0,0,0},{0,0,0}};
+    inv[0][0] = Scalar(1.0)/h_last[0][0];
+    inv[1][1] = Scalar(1.0)/h_last[1][1];
+    inv[2][2] = Scalar(1.0)/h_last[2][2];
+    inv[0][1] = -h_last[0][1]*inv[0][0]*inv[1][1];
+    inv[1][2] = -h_last[1][2]*inv[1][1]*inv[2][2];
+    inv[0][2] = -(h_last[0][1]*inv[1][2] + h_last[0][2]*inv[2][2])*inv[0][0];
+
+    Scalar F[3][3];
+    for (unsigned int i = 0; i < 3; ++i)
+        for (unsigned int j = 0; j < 3; ++j)
+            {
+            F[i][j] = Scalar(0.0);
+            for (unsigned int k = 0; k < 3; ++k)
+                F[i][j] += h[i][k]*inv[k][j];
+            }
+
+    // C = F^T F
+    Scalar C[3][3];
+    for (unsigned int i = 0; i < 3; ++i)
+        for (unsigned int j = 0; j < 3; ++j)
+            {
+            C[i][j] = Scalar(0.0);
+            for (unsigned int k = 0; k < 3; ++k)
+                C[i][j] += F[k][i]*F[k][j];
+            }
+
+    // smallest eigenvalue of C
+    Scalar eig_min;
+    Scalar p1 = C[0][1]*C[0][1] + C[0][2]*C[0][2] + C[1][2]*C[1][2];
+    if (p1 == Scalar(0.0))
+        {
+        eig_min = std::min(C[0][0], std::min(C[1][1], C[2][2]));
+        }
+    else
+        {
+        Scalar q = (C[0][0] + C[1][1] + C[2][2])/Scalar(3.0);
+        Scalar p2 = (C[0][0]-q)*(C[0][0]-q) + (C[1][1]-q)*(C[1][1]-q) + (C[2][2]-q)*(C[2][2]-q)
+                    + Scalar(2.0)*p1;
+        Scalar p = sqrt(p2/Scalar(6.0));
+
+        Scalar B[3][3];
+        for (unsigned int i = 0; i < 3; ++i)
+            for (unsigned int j = 0; j < 3; ++j)
+                B[i][j] = (C[i][j] - ((i == j) ? q : Scalar(0.0)))/p;
+
+        Scalar r = (B[0][0]*(B[1][1]*B[2][2] - B[1][2]*B[2][1])
+                    - B[0][1]*(B[1][0]*B[2][2] - B[1][2]*B[2][0])
+                    + B[0][2]*(B[1][0]*B[2][1] - B[1][1]*B[2][0]))/Scalar(2.0);
+        r = std::max(Scalar(-1.0), std::min(Scalar(1.0), r));
+        Scalar phi = acos(r)/Scalar(3.0);
+
+        eig_min = q + Scalar(2.0)*p*cos(phi + Scalar(2.0*M_PI/3.0));
+        }
+
+    return (eig_min > Scalar(0.0)) ? sqrt(eig_min) : Scalar(0.0);
+    }
+
+/*! \param timestep Current time step
+    \returns true if no particle can have moved by half the buffer distance since the last build
+
+    IntegratorTwoStep sums the largest displacement reported by the integration methods in every step, see
+    ParticleData::addDisplacementBound(). When the sum has grown by less than half the buffer since the reference
+    positions were set, in the same epoch and without a change of the box, distanceCheck() would find no particle
+    beyond its maximum displacement. With domain decomposition, every rank takes part in the reduction of the
+    distance check, so the bound is not used.
+*/
+bool NeighborList::isDisplacementBounded(uint64_t timestep)
+    {
+    if (!m_disp_bound_valid || !m_pdata->isDisplacementBoundValid(timestep)
+        || m_pdata->getDisplacementBoundEpoch() != m_disp_bound_epoch)
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        return false;
+    #endif
+
+    if (!(m_pdata->getGlobalBox() == m_last_global_box))
+        return false;
+
+    return m_pdata->getDisplacementBound() - m_disp_bound < Scalar(0.5)*m_r_buff;
+    }
+
+/*! Copies the current tags of all particles over to m_last_tag
+*/
+void NeighborList::setLastUpdatedTags()
+    {
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_last_tag(m_last_tag, access_location::host, access_mode::overwrite);
+    std::copy(h_tag.data, h_tag.data + m_pdata->getN(), h_last_tag.data);
+    }
+
+/*! A sort that only permutes the particles keeps every pair of neighbors, so the list is remapped to the new order
+    on the next call to compute() instead of being rebuilt. Any other change to the particle data forces a rebuild.
+    With domain decomposition, the ghost particles are exchanged again after a sort, and the list is always rebuilt.
+*/
+void NeighborList::slotParticlesSorted()
+    {
+    bool remap = m_pdata->isParticleSortPermutation() && m_has_been_updated_once;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        remap = false;
+    #endif
+
+    if (remap)
+        m_remap_pending = true;
+    else
+        forceUpdate();
+    }
+
+/*! The particle with index \a i at the last build or remap has the tag m_last_tag[i] and now has the index
+    rtag[m_last_tag[i]]. The neighbors of each particle are translated to the new indices in place, and the per
+    particle arrays (head list, number of neighbors, last positions and the neighbor counts of the consumers) are
+    scattered to the new order. The head list then no longer follows the Nmax stride of the new order, so it is
+    marked as compressed and rebuilt before the next build.
+
+    The exclusions by index are translated again the next time they are needed.
+*/
+void NeighborList::remapNlist()
+    {
+    if (m_prof) m_prof->push("remap");
+
+    const unsigned int N = m_pdata->getN();
+
+        {
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_last_tag(m_last_tag, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::readwrite);
+
+        // new index of each particle in the order of the neighbor list
+        std::vector<unsigned int> new_idx(N);
+        for (unsigned int i = 0; i < N; ++i)
+            new_idx[i] = h_rtag.data[h_last_tag.data[i]];
+
+        // the neighbors of each particle stay in place, only their indices change
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            const size_t head = h_head_list.data[i];
+            for (unsigned int k = 0; k < h_n_neigh.data[i]; ++k)
+                h_nlist.data[head + k] = new_idx[h_nlist.data[head + k]];
+            }
+
+        // scatter the per particle data to the new order
+        std::vector<unsigned int> old_uint(h_head_list.data, h_head_list.data + N);
+        for (unsigned int i = 0; i < N; ++i)
+            h_head_list.data[new_idx[i]] = old_uint[i];
+
+        old_uint.assign(h_n_neigh.data, h_n_neigh.data + N);
+        for (unsigned int i = 0; i < N; ++i)
+            h_n_neigh.data[new_idx[i]] = old_uint[i];
+
+        std::vector<Scalar4> old_last_pos(h_last_pos.data, h_last_pos.data + N);
+        for (unsigned int i = 0; i < N; ++i)
+            h_last_pos.data[new_idx[i]] = old_last_pos[i];
+
+        for (unsigned int consumer = 0; consumer < m_n_neigh_consumer.size(); ++consumer)
+            {
+            if (!m_n_neigh_consumer[consumer] || m_n_neigh_consumer[consumer]->getNumElements() < N)
+                continue;
+
+            ArrayHandle<unsigned int> h_n_neigh_consumer(*m_n_neigh_consumer[consumer], access_location::host,
+                                                         access_mode::readwrite);
+            old_uint.assign(h_n_neigh_consumer.data, h_n_neigh_consumer.data + N);
+            for (unsigned int i = 0; i < N; ++i)
+                h_n_neigh_consumer.data[new_idx[i]] = old_uint[i];
+            }
+        }
+
+    m_head_list_compressed = true;
+    setLastUpdatedTags();
+    m_ex_list_idx_dirty = true;
 
     if (m_prof) m_prof->pop();
     }
 
 bool NeighborList::shouldCheckDistance(uint64_t timestep)
     {
-    return !m_force_update && !(timestep < (m_last_updated_tstep + m_rebuild_check_delay));
+    return !m_force_update && !(timestep < (m_last_updated_tstep + getCheckDelay()));
     }
 
 /*! \returns true If the neighbor list needs to be updated
@@ -1288,6 +1690,7 @@ bool NeighborList::needsUpdating(uint64_t timestep)
             {
             // force update is counted only once per time step
             m_force_update = false;
+            m_update_forced = true;
             return true;
             }
         return m_last_check_result;
@@ -1305,12 +1708,15 @@ bool NeighborList::needsUpdating(uint64_t timestep)
     bool result = false;
 
     // check if this is a dangerous time
-    // we are dangerous if m_rebuild_check_delay is greater than 1 and this is the first check after the
+    // we are dangerous if the check delay is greater than 1 and this is the first check after the
     // last build
     bool dangerous = false;
-    if (m_dist_check && (m_rebuild_check_delay > 1 && timestep == (m_last_updated_tstep + m_rebuild_check_delay)))
+    const uint64_t check_delay = getCheckDelay();
+    if (m_dist_check && (check_delay > 1 && timestep == (m_last_updated_tstep + check_delay)))
         dangerous = true;
 
+    m_update_forced = m_force_update;
+
     // if the update has been forced, the result defaults to true
     if (m_force_update)
         {
@@ -1335,7 +1741,11 @@ bool NeighborList::needsUpdating(uint64_t timestep)
             }
         else
             {
-            result = distanceCheck(timestep);
+            // the positions need not be read while the integrator bounds the displacements
+            result = !isDisplacementBounded(timestep) && distanceCheck(timestep);
+
+            if (result && m_adaptive_check && timestep > m_last_updated_tstep)
+                updatePredictedDelay(timestep - m_last_updated_tstep, dangerous);
             }
 
         if (result)
@@ -1365,6 +1775,122 @@ bool NeighborList::needsUpdating(uint64_t timestep)
     return result;
     }
 
+/*! \param period Number of steps since the last build
+    \param dangerous True if the build was triggered by the first check after the last build
+
+    The particle that triggered the build has moved half the buffer distance in \a period steps, so the largest
+    displacement per step is at least r_buff/(2*period). The predicted delay is the number of steps it takes to
+    move half the buffer distance at the largest displacement per step of the recent builds.
+    When the first check after a build already triggers, the particles may have moved faster than predicted and
+    the history starts over from half the previous delay.
+*/
+void NeighborList::updatePredictedDelay(uint64_t period, bool dangerous)
+    {
+    const unsigned int history_length = 8;
+
+    if (dangerous)
+        {
+        m_max_speed_history.clear();
+        m_predicted_delay /= 2;
+        return;
+        }
+
+    m_max_speed_history.push_back(m_r_buff / (Scalar(2.0) * Scalar(period)));
+    if (m_max_speed_history.size() > history_length)
+        m_max_speed_history.pop_front();
+
+    predictCheckDelay();
+    }
+
+/*! The predicted delay leaves a safety margin of a factor of two to the fastest displacement of the recent builds.
+*/
+void NeighborList::predictCheckDelay()
+    {
+    if (m_max_speed_history.empty())
+        return;
+
+    const Scalar safety = 0.5;
+    Scalar max_speed = *std::max_element(m_max_speed_history.begin(), m_max_speed_history.end());
+    m_predicted_delay = (uint64_t)(safety * m_r_buff / (Scalar(2.0) * max_speed));
+    }
+
+/*! \param timestep Current time step
+
+    Called after every build. Each trial buffer radius is measured over a window of builds, and the time per step
+    is the wall clock time between the builds that open and close the window. On MPI runs, the slowest rank
+    determines the time per step, so that all ranks choose the same buffer radius.
+
+    The change of the buffer radius forces a build on the next step, which opens the next window.
+*/
+void NeighborList::tuneRBuff(uint64_t timestep)
+    {
+    const unsigned int window_builds = 10;
+
+    ClockSource t;
+    if (!m_tune_window_active)
+        {
+        m_tune_window_active = true;
+        m_tune_start_time = t.getTime();
+        m_tune_start_tstep = timestep;
+        m_tune_builds = 0;
+        return;
+        }
+
+    if (++m_tune_builds < window_builds || timestep <= m_tune_start_tstep)
+        return;
+
+    double elapsed = double(t.getTime() - m_tune_start_time);
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    double cost = elapsed / double(timestep - m_tune_start_tstep);
+    m_tune_window_active = false;
+
+    if (m_tune_best_cost < 0 || cost < m_tune_best_cost)
+        {
+        m_tune_best_cost = cost;
+        m_tune_best_r_buff = m_r_buff;
+        }
+    else
+        {
+        // the last trial was slower, search in the other direction with a smaller step
+        m_tune_direction = -m_tune_direction;
+        m_tune_step *= Scalar(0.5);
+        }
+
+    // the buffer radius is bounded by the domain size and a small fraction of the cutoff
+    const Scalar3 L = m_pdata->getBox().getNearestPlaneDistance();
+    Scalar L_min = std::min(L.x, L.y);
+    if (m_sysdef->getNDimensions() == 3)
+        L_min = std::min(L_min, L.z);
+    const Scalar r_buff_min = Scalar(0.05) * getMaxRCut();
+    Scalar r_buff_max = std::max(Scalar(0.45) * L_min - getMaxRCut(), r_buff_min);
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &r_buff_max, 1, MPI_HOOMD_SCALAR, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    if (m_tune_step < Scalar(0.01) * getMaxRCut())
+        {
+        // converged, keep the best buffer radius
+        m_tune_r_buff = false;
+        m_exec_conf->msg->notice(2) << "nlist: Tuned the buffer radius to " << m_tune_best_r_buff << endl;
+        if (m_r_buff != m_tune_best_r_buff)
+            setRBuff(m_tune_best_r_buff);
+        return;
+        }
+
+    Scalar r_buff = m_tune_best_r_buff + Scalar(m_tune_direction) * m_tune_step;
+    r_buff = std::max(r_buff_min, std::min(r_buff, r_buff_max));
+    m_exec_conf->msg->notice(6) << "nlist: Trying buffer radius " << r_buff << endl;
+    setRBuff(r_buff);
+    }
+
 void NeighborList::resetStats()
     {
     m_updates = m_forced_updates = m_dangerous_updates = 0;
@@ -1434,6 +1960,39 @@ void NeighborList::updateExListIdx()
         m_prof->pop();
     }
 
+/*! The exclusions of tag t are stored in m_ex_sorted_tag from m_ex_sorted_head[t] to m_ex_sorted_head[t+1], in
+    ascending order. They only depend on the tags, so they are rebuilt only when the exclusions change.
+*/
+void NeighborList::updateExListSorted()
+    {
+    if (m_prof)
+        m_prof->push("sort-ex");
+
+    ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::read);
+
+    const unsigned int n_tags = (unsigned int)m_n_ex_tag.size();
+    m_ex_sorted_head.resize(n_tags+1);
+    m_ex_sorted_head[0] = 0;
+    for (unsigned int tag = 0; tag < n_tags; tag++)
+        m_ex_sorted_head[tag+1] = m_ex_sorted_head[tag] + h_n_ex_tag.data[tag];
+
+    m_ex_sorted_tag.resize(m_ex_sorted_head[n_tags]);
+    for (unsigned int tag = 0; tag < n_tags; tag++)
+        {
+        unsigned int *ex = m_ex_sorted_tag.data() + m_ex_sorted_head[tag];
+        const unsigned int n = h_n_ex_tag.data[tag];
+        for (unsigned int offset = 0; offset < n; offset++)
+            ex[offset] = h_ex_list_tag.data[m_ex_list_indexer_tag(tag,offset)];
+        std::sort(ex, ex + n);
+        }
+
+    m_ex_list_sorted_dirty = false;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
 /*! Loops through the neighbor list and filters out any excluded pairs
 */
 void NeighborList::filterNlist()
@@ -1489,6 +2048,54 @@ void NeighborList::filterNlist()
         m_prof->pop();
     }
 
+#ifdef ENABLE_TBB
+namespace detail
+{
+//! Body for the parallel exclusive prefix sum of the per-particle neighbor list sizes
+/*! The head address of particle i is the sum of Nmax over the types of all particles before it. tbb::parallel_scan
+    calls the body with a pre-scan pass (only accumulating m_sum) and a final pass (also writing the head list).
+*/
+struct HeadListScan
+    {
+    unsigned int *m_head_list;      //!< Head list to fill out
+    const Scalar4 *m_pos;           //!< Particle positions and types
+    const unsigned int *m_Nmax;     //!< Maximum number of neighbors per type
+    unsigned int m_sum;             //!< Running sum of the neighbor list sizes
+
+    HeadListScan(unsigned int *head_list, const Scalar4 *pos, const unsigned int *Nmax)
+        : m_head_list(head_list), m_pos(pos), m_Nmax(Nmax), m_sum(0)
+        { }
+
+    HeadListScan(HeadListScan& other, tbb::split)
+        : m_head_list(other.m_head_list), m_pos(other.m_pos), m_Nmax(other.m_Nmax), m_sum(0)
+        { }
+
+    template<typename Tag>
+    void operator()(const tbb::blocked_range<unsigned int>& r, Tag)
+        {
+        unsigned int sum = m_sum;
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            {
+            if (Tag::is_final_scan())
+                m_head_list[i] = sum;
+            sum += m_Nmax[__scalar_as_int(m_pos[i].w)];
+            }
+        m_sum = sum;
+        }
+
+    void reverse_join(HeadListScan& left)
+        {
+        m_sum += left.m_sum;
+        }
+
+    void assign(HeadListScan& other)
+        {
+        m_sum = other.m_sum;
+        }
+    };
+} // end namespace detail
+#endif
+
 /*!
  * Iterates through each particle, and calculates a running sum of the starting index for that particle
  * in the flat array of neighbors.
@@ -1505,6 +2112,11 @@ void NeighborList::buildHeadList()
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
 
+        #ifdef ENABLE_TBB
+        detail::HeadListScan scan(h_head_list.data, h_pos.data, h_Nmax.data);
+        tbb::parallel_scan(tbb::blocked_range<unsigned int>(0, m_pdata->getN()), scan);
+        headAddress = scan.m_sum;
+        #else
         for (unsigned int i=0; i < m_pdata->getN(); ++i)
             {
             h_head_list.data[i] = headAddress;
@@ -1513,6 +2125,7 @@ void NeighborList::buildHeadList()
             unsigned int myType = __scalar_as_int(h_pos.data[i].w);
             headAddress += h_Nmax.data[myType];
             }
+        #endif
         }
 
     resizeNlist(headAddress);
@@ -1520,6 +2133,137 @@ void NeighborList::buildHeadList()
     if (m_prof) m_prof->pop();
     }
 
+/*!
+ * The neighbors of each particle are moved forward to the end of the neighbors of the previous particle, and the head
+ * list is rewritten with the packed offsets. Moving forward never overwrites neighbors that are yet to be moved.
+ */
+void NeighborList::compressNlist()
+    {
+    if (m_prof) m_prof->push("compress");
+
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::readwrite);
+
+    size_t head = 0;
+    for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+        {
+        const size_t old_head = h_head_list.data[i];
+        const unsigned int n_neigh = h_n_neigh.data[i];
+        if (old_head != head)
+            std::copy(h_nlist.data + old_head, h_nlist.data + old_head + n_neigh, h_nlist.data + head);
+        h_head_list.data[i] = (unsigned int)head;
+        head += n_neigh;
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*!
+ * A pair that is built at a distance of at least r_cut + r_buff cannot come within r_cut before the next build,
+ * because each particle moves less than r_buff/2. The neighbor list cutoff of each consumer is therefore its own
+ * r_cut plus the buffer, and the maximum diameter shift when diameter shifting is enabled.
+ */
+void NeighborList::updateConsumerRList()
+    {
+    const unsigned int n_consumers = (unsigned int)m_consumer_r_cut.size();
+    const Scalar delta = m_diameter_shift ? m_d_max - Scalar(1.0) : Scalar(0.0);
+
+    m_n_neigh_consumer.resize(n_consumers);
+    m_r_listsq_consumer.resize(n_consumers);
+    for (unsigned int consumer = 0; consumer < n_consumers; ++consumer)
+        {
+        if (!m_n_neigh_consumer[consumer] || m_n_neigh_consumer[consumer]->getNumElements() < m_pdata->getMaxN())
+            {
+            m_n_neigh_consumer[consumer] = std::make_shared<GlobalArray<unsigned int>>(m_pdata->getMaxN(),
+                                                                                       m_exec_conf);
+            }
+        if (!m_r_listsq_consumer[consumer]
+            || m_r_listsq_consumer[consumer]->getNumElements() != m_typpair_idx.getNumElements())
+            {
+            m_r_listsq_consumer[consumer] = std::make_shared<GlobalArray<Scalar>>(m_typpair_idx.getNumElements(),
+                                                                                  m_exec_conf);
+            }
+
+        ArrayHandle<Scalar> h_consumer_r_cut(*m_consumer_r_cut[consumer], access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_r_listsq(*m_r_listsq_consumer[consumer], access_location::host,
+                                       access_mode::overwrite);
+
+        for (unsigned int cur_pair = 0; cur_pair < m_typpair_idx.getNumElements(); ++cur_pair)
+            {
+            const Scalar r_cut_ij = h_consumer_r_cut.data[cur_pair];
+            Scalar r_list = (r_cut_ij > Scalar(0.0)) ? r_cut_ij + m_r_buff + delta : Scalar(0.0);
+            h_r_listsq.data[cur_pair] = r_list*r_list;
+            }
+        }
+    }
+
+/*!
+ * The neighbors are sorted by their distance at the time of the build. The number of neighbors within reach of a
+ * consumer is the position after the last neighbor that is within the consumer's neighbor list cutoff.
+ */
+void NeighborList::sortNlist()
+    {
+    if (m_prof) m_prof->push("sort");
+
+    updateConsumerRList();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+    std::vector< std::pair<Scalar, unsigned int> > neighbors;
+
+    for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+        {
+        const Scalar3 pos_i = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        const size_t head = h_head_list.data[i];
+        const unsigned int n_neigh = h_n_neigh.data[i];
+
+        neighbors.resize(n_neigh);
+        for (unsigned int k = 0; k < n_neigh; ++k)
+            {
+            const unsigned int j = h_nlist.data[head + k];
+            Scalar3 dx = pos_i - make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            dx = box.minImage(dx);
+            neighbors[k] = std::make_pair(dot(dx, dx), j);
+            }
+        std::sort(neighbors.begin(), neighbors.end());
+
+        for (unsigned int k = 0; k < n_neigh; ++k)
+            h_nlist.data[head + k] = neighbors[k].second;
+        }
+
+    for (unsigned int consumer = 0; consumer < m_consumer_r_cut.size(); ++consumer)
+        {
+        ArrayHandle<unsigned int> h_n_neigh_consumer(*m_n_neigh_consumer[consumer], access_location::host,
+                                                     access_mode::overwrite);
+        ArrayHandle<Scalar> h_r_listsq(*m_r_listsq_consumer[consumer], access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+            {
+            const Scalar3 pos_i = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
+            const size_t head = h_head_list.data[i];
+
+            unsigned int n_neigh = 0;
+            for (unsigned int k = 0; k < h_n_neigh.data[i]; ++k)
+                {
+                const unsigned int j = h_nlist.data[head + k];
+                Scalar3 dx = pos_i - make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+                dx = box.minImage(dx);
+                if (dot(dx, dx) < h_r_listsq.data[m_typpair_idx(type_i, __scalar_as_int(h_pos.data[j].w))])
+                    n_neigh = k + 1;
+                }
+            h_n_neigh_consumer.data[i] = n_neigh;
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
 /*!
  * \param size the requested number of elements in the neighbor list
  *
@@ -1577,9 +2321,10 @@ void NeighborList::resetConditions()
     memset(h_conditions.data, 0, sizeof(unsigned int)*m_pdata->getNTypes());
     }
 
-void NeighborList::growExclusionList()
+/*! \param new_height Number of exclusions per particle to make room for
+*/
+void NeighborList::growExclusionList(unsigned int new_height)
     {
-    unsigned int new_height = m_ex_list_indexer.getH() + 1;
 
     m_ex_list_tag.resize(m_pdata->getRTags().size(), new_height);
     m_ex_list_idx.resize(m_pdata->getMaxN(), new_height);
@@ -1701,6 +2446,18 @@ void export_NeighborList(py::module& m)
                       &NeighborList::setDiameterShift)
         .def_property("max_diameter", &NeighborList::getMaximumDiameter,
                       &NeighborList::setMaximumDiameter)
+        .def_property("compress", &NeighborList::getCompressedStorage,
+                      &NeighborList::setCompressedStorage)
+        .def_property("sort_by_distance", &NeighborList::getSortByDistance,
+                      &NeighborList::setSortByDistance)
+        .def_property("adaptive_check", &NeighborList::getAdaptiveCheck,
+                      &NeighborList::setAdaptiveCheck)
+        .def_property("scaled_check", &NeighborList::getScaledCheck,
+                      &NeighborList::setScaledCheck)
+        .def_property("tune_buffer", &NeighborList::getTuneRBuff,
+                      &NeighborList::setTuneRBuff)
+        .def_property("partial_rebuild", &NeighborList::getPartialRebuild,
+                      &NeighborList::setPartialRebuild)
         .def("getMaxRCut", &NeighborList::getMaxRCut)
         .def("getMinRCut", &NeighborList::getMinRCut)
         .def("getMaxRList", &NeighborList::getMaxRList)
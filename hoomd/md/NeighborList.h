@@ -14,6 +14,8 @@
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 #include <vector>
 #include <set>
+#include <deque>
+#include <algorithm>
 
 /*! \file NeighborList.h
     \brief Declares the NeighborList class
@@ -85,20 +87,36 @@
     only then is the list actually updated. This check can even be avoided for a number of time
     steps by calling setEvery(). If the caller wants to force a full update, forceUpdate()
     can be called before compute() to do so. Note that if the particle data is resorted,
-    an update is automatically forced.
+    an update is automatically forced, unless the sort only permuted the particles. In that case the list is
+    remapped to the new order by remapNlist() instead of being rebuilt (except with domain decomposition, where
+    the ghost particles are exchanged again after a sort).
 
     The CUDA profiler expects the exact same sequence of kernels on every run. Due to the non-deterministic cell list,
     a different sequence of calls may be generated with nlist builds at different times. To work around this problem
     setEvery takes a dist_check parameter. When dist_check=True, the above described behavior is followed. When
     dist_check is false, the nlist is built exactly m_rebuild_check_delay steps. This is intended for use in profiling only.
 
+    <b>Partial rebuilds:</b>
+
+    When setPartialRebuild() is enabled and the distance check finds only a few particles that moved more than half
+    of the buffer distance, rebuildPartially() rebuilds only the rows of those particles and of the particles near
+    them. Each particle then keeps its own reference position in m_last_pos, and every row lists the neighbors
+    within r_list at the reference positions. Since every particle is within half of the buffer distance of its
+    reference position, the list remains valid. Subclasses implement buildNlistRows() to support partial rebuilds,
+    the others always rebuild the full list.
+
     \b Exclusions:
 
     Exclusions are stored in \a ex_list, a data structure similar in structure to \a nlist, except this time exclusions
-    are stored. User-specified exclusions are stored by tag and translated to indices whenever a particle sort occurs
-    (updateExListIdx()). If any exclusions are set, filterNlist() is called after buildNlist(). filterNlist() loops
-    through the neighbor list and removes any particles that are excluded. This allows an arbitrary number of exclusions
-    to be processed without slowing the performance of the buildNlist() step itself.
+    are stored. User-specified exclusions are stored by tag. Subclasses that set \a m_exclusions_in_build (the CPU
+    neighbor lists) apply the exclusions while building the list: updateExListSorted() packs the exclusions of each
+    tag into a sorted list when the exclusions change, and the build tests each candidate neighbor with a binary search
+    on its tag (see getSortedExclusions()). Since tags do not change when particles are sorted or migrate, no
+    translation is needed between builds.
+
+    Otherwise, filterNlist() is called after buildNlist() and removes any particles that are excluded, using the
+    exclusions translated to indices by updateExListIdx(). The translation is done lazily, only when the filter or a
+    caller of getExListArray() needs it after the particle order has changed.
 
     <b>Overflow handling:</b>
     For easy support of derived GPU classes to implement overflow detection the overflow condition is stored in the
@@ -176,6 +194,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
                 {
                 throw std::invalid_argument("r_cut_matrix not found in neighbor list");
                 }
+            size_t consumer = p - m_consumer_r_cut.begin();
+            if (consumer < m_n_neigh_consumer.size())
+                m_n_neigh_consumer.erase(m_n_neigh_consumer.begin() + consumer);
             m_consumer_r_cut.erase(p);
             }
 
@@ -195,6 +216,75 @@ class PYBIND11_EXPORT NeighborList : public Compute
 
         uint64_t getRebuildCheckDelay() {return m_rebuild_check_delay;}
 
+        //! Set whether the checks after a build are scheduled adaptively
+        /*! \param adaptive True to skip the distance checks that cannot yet trigger a build
+
+            The largest displacement per time step observed in the recent builds predicts how many steps particles
+            need to move half the buffer distance. No checks are performed until the predicted build step, but at
+            least getRebuildCheckDelay() steps after the last build.
+        */
+        void setAdaptiveCheck(bool adaptive)
+            {
+            m_adaptive_check = adaptive;
+            m_max_speed_history.clear();
+            m_predicted_delay = 0;
+            }
+
+        //! Test if the checks after a build are scheduled adaptively
+        bool getAdaptiveCheck()
+            {
+            return m_adaptive_check;
+            }
+
+        //! Set whether the distance check compares positions in the scaled coordinates of the box
+        /*! \param scaled True to map the positions at the last build through the box deformation since then
+
+            The positions at the last build are mapped to the current box through their fractional coordinates, so
+            that particles following an affine box deformation (isotropic, anisotropic, or changing the tilt factors)
+            have not moved. The deformation also changes the distances between particles by at most its smallest
+            stretch, which consumes part of the buffer. The list remains valid while the remaining buffer exceeds
+            twice the largest displacement from the affine positions.
+        */
+        void setScaledCheck(bool scaled)
+            {
+            m_scaled_check = scaled;
+            }
+
+        //! Test if the distance check compares positions in the scaled coordinates of the box
+        bool getScaledCheck()
+            {
+            return m_scaled_check;
+            }
+
+        //! Get the number of steps after a build during which no distance checks are performed
+        uint64_t getCheckDelay()
+            {
+            return (m_adaptive_check && m_predicted_delay > m_rebuild_check_delay) ? m_predicted_delay
+                                                                                    : m_rebuild_check_delay;
+            }
+
+        //! Set whether the buffer radius is tuned during the run
+        /*! \param tune True to tune the buffer radius to the smallest run time per time step
+
+            The time per step, including the builds and all the other work between them, is measured over a window
+            of builds for each trial buffer radius. The buffer radius follows the direction that lowers the time
+            per step, with a step size that halves every time the direction reverses.
+        */
+        void setTuneRBuff(bool tune)
+            {
+            m_tune_r_buff = tune;
+            m_tune_window_active = false;
+            m_tune_best_cost = -1.0;
+            m_tune_step = Scalar(0.25)*m_r_buff;
+            m_tune_direction = 1;
+            }
+
+        //! Test if the buffer radius is tuned during the run
+        bool getTuneRBuff()
+            {
+            return m_tune_r_buff;
+            }
+
         void setDistCheck(bool dist_check) {m_dist_check = dist_check;}
 
         bool getDistCheck(){return m_dist_check;}
@@ -281,9 +371,35 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_n_neigh;
             }
 
+        //! Get the number of neighbors each particle needs to traverse for one consumer
+        /*! \param r_cut_matrix The r_cut matrix the consumer registered with addRCutMatrix()
+
+            When the neighbors are sorted by distance, all neighbors that can come within the cutoff of the consumer
+            before the next build are at the start of each particle's list, and the returned array counts those.
+            Otherwise the full list must be traversed and getNNeighArray() is returned.
+        */
+        const GlobalArray<unsigned int>& getConsumerNNeighArray(
+            const std::shared_ptr<GlobalArray<Scalar>>& r_cut_matrix)
+            {
+            if (m_sort_by_distance)
+                {
+                auto p = std::find(m_consumer_r_cut.begin(), m_consumer_r_cut.end(), r_cut_matrix);
+                size_t consumer = p - m_consumer_r_cut.begin();
+                if (p != m_consumer_r_cut.end() && consumer < m_n_neigh_consumer.size())
+                    return *m_n_neigh_consumer[consumer];
+                }
+            return m_n_neigh;
+            }
+
         //! Get the neighbor list
         const GlobalArray<unsigned int>& getNListArray()
             {
+            if (m_nlist_on_host)
+                {
+                m_exec_conf->msg->error() << "nlist: The neighbor list is stored out of core, only pair potentials "
+                                          << "can stream it to the GPU" << std::endl;
+                throw std::runtime_error("Error accessing the neighbor list");
+                }
             return m_nlist;
             }
 
@@ -296,12 +412,14 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Get the number of exclusions array
         const GlobalArray<unsigned int>& getNExArray()
             {
+            updateExListIdxIfNeeded();
             return m_n_ex_idx;
             }
 
          //! Get the exclusion list
          const GlobalArray<unsigned int>& getExListArray()
             {
+            updateExListIdxIfNeeded();
             return m_ex_list_idx;
             }
 
@@ -340,6 +458,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Exclude a pair of particles from being added to the neighbor list
         void addExclusion(unsigned int tag1, unsigned int tag2);
 
+        //! Exclude many pairs of particles from being added to the neighbor list
+        void addExclusions(const std::vector< std::pair<unsigned int, unsigned int> >& pairs);
+
         //! Clear all existing exclusions
         void clearExclusions();
 
@@ -416,6 +537,61 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_diameter_shift;
             }
 
+        //! Set whether the neighbor list is stored compressed
+        /*! \param compress True to pack the neighbors of all particles with exact counts after every build
+
+            The build writes into storage with a stride of Nmax for each particle type. When compressed, the
+            neighbors are packed back to back after the build and getHeadList() indexes the packed list, so
+            particles with few neighbors no longer pad the list that the pair potentials read.
+        */
+        void setCompressedStorage(bool compress)
+            {
+            m_compress = compress;
+            forceUpdate();
+            }
+
+        //! Test if the neighbor list is stored compressed
+        bool getCompressedStorage()
+            {
+            return m_compress;
+            }
+
+        //! Set whether the neighbors of each particle are sorted by distance
+        /*! \param sort True to sort the neighbors of each particle by distance after every build
+
+            Sorted neighbors let every consumer traverse only the prefix of each particle's neighbors that can come
+            within its own cutoff, see getConsumerNNeighArray().
+        */
+        void setSortByDistance(bool sort)
+            {
+            m_sort_by_distance = sort;
+            forceUpdate();
+            }
+
+        //! Test if the neighbors of each particle are sorted by distance
+        bool getSortByDistance()
+            {
+            return m_sort_by_distance;
+            }
+
+        //! Set whether the list may be rebuilt only for the rows near fast particles
+        /*! \param partial True to rebuild only the rows of the particles near those that moved too far
+
+            Partial rebuilds require a fixed box and strided storage without compression or sorting by distance.
+            The full list is rebuilt otherwise, or when too many particles moved.
+        */
+        virtual void setPartialRebuild(bool partial)
+            {
+            m_partial_rebuild = partial;
+            forceUpdate();
+            }
+
+        //! Test if the list may be rebuilt only for the rows near fast particles
+        bool getPartialRebuild()
+            {
+            return m_partial_rebuild;
+            }
+
         //! Set the maximum diameter to use in computing neighbor lists
         /*!
          * If diameter shifting is enabled, then this sets the maximum query radius for inclusion in the neighborlist.
@@ -472,6 +648,7 @@ class PYBIND11_EXPORT NeighborList : public Compute
         void forceUpdate()
             {
             m_force_update = true;
+            m_ex_list_idx_dirty = true;
             }
 
         //! Get the number of updates
@@ -530,12 +707,29 @@ class PYBIND11_EXPORT NeighborList : public Compute
         bool m_filter_body;         //!< Set to true if particles in the same body are to be filtered
         bool m_diameter_shift;      //!< Set to true if the neighborlist rcut(i,j) should be diameter shifted
         storageMode m_storage_mode; //!< The storage mode
+        bool m_compress;            //!< True if the neighbor list is packed with exact counts after every build
+        bool m_head_list_compressed; //!< True if the head list indexes the packed neighbor list
+        bool m_sort_by_distance;    //!< True if the neighbors of each particle are sorted by distance
+        bool m_partial_rebuild;     //!< True if the list may be rebuilt only for the rows near fast particles
+        bool m_nlist_on_host;       //!< True if the neighbor list is held in host memory and streamed in chunks
+
+        /// Number of neighbors of each particle within the reach of each consumer, when sorted by distance
+        std::vector<std::shared_ptr<GlobalArray<unsigned int>>> m_n_neigh_consumer;
+
+        /// Squared neighbor list cutoff of each consumer by type pair, when sorted by distance
+        std::vector<std::shared_ptr<GlobalArray<Scalar>>> m_r_listsq_consumer;
 
         GlobalArray<unsigned int> m_nlist;      //!< Neighbor list data
         GlobalArray<unsigned int> m_n_neigh;    //!< Number of neighbors for each particle
         GlobalArray<Scalar4> m_last_pos;        //!< coordinates of last updated particle positions
+        GlobalArray<unsigned int> m_last_tag;   //!< Tag of each particle in the order of the neighbor list
         Scalar3 m_last_L;                    //!< Box lengths at last update
         Scalar3 m_last_L_local;              //!< Local Box lengths at last update
+        BoxDim m_last_global_box;            //!< Global box at last update
+        bool m_scaled_check;                 //!< True if the distance check follows the box deformation
+        bool m_disp_bound_valid;             //!< True if the displacement bound covered the last build
+        uint64_t m_disp_bound_epoch;         //!< Epoch of the displacement bound at the last build
+        Scalar m_disp_bound;                 //!< Displacement bound at the last build
 
         GlobalArray<unsigned int> m_head_list;     //!< Indexes for particles to read from the neighbor list
         GlobalArray<unsigned int> m_Nmax;          //!< Holds the maximum number of neighbors for each particle type
@@ -549,6 +743,36 @@ class PYBIND11_EXPORT NeighborList : public Compute
         Index2D m_ex_list_indexer_tag;         //!< Indexer for accessing the by-tag exclusion list
         bool m_exclusions_set;                 //!< True if any exclusions have been set
         bool m_need_reallocate_exlist;         //!< True if global exclusion list needs to be reallocated
+        bool m_ex_list_idx_dirty;              //!< True when the exclusions by index must be translated again
+
+        bool m_exclusions_in_build;                 //!< True when buildNlist() applies the exclusions itself
+        bool m_ex_list_sorted_dirty;                //!< True when the sorted exclusions must be rebuilt
+        std::vector<unsigned int> m_ex_sorted_head; //!< Offset of the sorted exclusions of each tag
+        std::vector<unsigned int> m_ex_sorted_tag;  //!< Sorted excluded tags of each tag, packed by tag
+
+        //! Sorted range of the tags excluded from the neighbor list of a particle
+        struct ExclusionRange
+            {
+            const unsigned int *begin; //!< First excluded tag
+            const unsigned int *end;   //!< One past the last excluded tag
+
+            //! Test if the particle with tag \a tag is excluded
+            bool contains(unsigned int tag) const
+                {
+                return begin != end && std::binary_search(begin, end, tag);
+                }
+            };
+
+        //! Get the sorted exclusions of the particle with tag \a tag
+        /*! \pre updateExListSorted() has been called since the exclusions last changed
+        */
+        ExclusionRange getSortedExclusions(unsigned int tag) const
+            {
+            ExclusionRange range;
+            range.begin = m_ex_sorted_tag.data() + m_ex_sorted_head[tag];
+            range.end = m_ex_sorted_tag.data() + m_ex_sorted_head[tag+1];
+            return range;
+            }
 
         //! Return true if we are supposed to do a distance check in this time step
         bool shouldCheckDistance(uint64_t timestep);
@@ -556,15 +780,56 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Performs the distance check
         virtual bool distanceCheck(uint64_t timestep);
 
+        //! Checks if the displacement bound of the integrator rules out a rebuild
+        bool isDisplacementBounded(uint64_t timestep);
+
         //! Updates the previous position table for use in the next distance check
         virtual void setLastUpdatedPos();
 
+        //! Computes the smallest stretch of the box deformation since the last update
+        Scalar getMinBoxStretch() const;
+
+        //! Records the tags of the particles in the order of the neighbor list for remapNlist()
+        virtual void setLastUpdatedTags();
+
+        //! Permute the neighbor list to follow a sort of the particles
+        virtual void remapNlist();
+
         //! Builds the neighbor list
         virtual void buildNlist(uint64_t timestep);
 
+        //! Rebuild the rows of the particles near those that moved too far
+        /*! \param timestep Current time step
+            \param fast Particles that moved more than half of the buffer distance from their reference positions
+
+            Implementations set the reference positions of the fast particles to their current positions and rebuild
+            the rows of the fast particles and of all particles within reach of their old or new reference positions,
+            using the reference positions of all particles. Overflows are flagged in m_conditions.
+
+            \returns false when the rows were not rebuilt and the full list must be built instead
+        */
+        virtual bool buildNlistRows(uint64_t timestep, const std::vector<unsigned int>& fast)
+            {
+            return false;
+            }
+
+        //! Try to rebuild only the rows near the particles that moved too far
+        bool rebuildPartially(uint64_t timestep);
+
         //! Updates the idx exclusion list
         virtual void updateExListIdx();
 
+        //! Translates the exclusions to indices if the particle order changed since the last translation
+        void updateExListIdxIfNeeded()
+            {
+            if (m_ex_list_idx_dirty && m_exclusions_set)
+                updateExListIdx();
+            m_ex_list_idx_dirty = false;
+            }
+
+        //! Packs the exclusions of each tag into a sorted list for the build time exclusion check
+        void updateExListSorted();
+
         //! Loops through all pairs, and updates the r_list(i,j)
         void updateRList();
 
@@ -577,6 +842,15 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Build the head list to allocated memory
         virtual void buildHeadList();
 
+        //! Pack the neighbor list with exact counts
+        virtual void compressNlist();
+
+        //! Sort the neighbors of each particle by distance and count the neighbors within reach of each consumer
+        virtual void sortNlist();
+
+        //! Compute the neighbor list cutoff of each consumer and allocate the per consumer neighbor counts
+        void updateConsumerRList();
+
         //! Amortized resizing of the neighborlist
         void resizeNlist(size_t size);
 
@@ -616,6 +890,8 @@ class PYBIND11_EXPORT NeighborList : public Compute
         uint64_t m_forced_updates;       //!< Number of times the neighbor list has been forcibly updated
         uint64_t m_dangerous_updates;    //!< Number of dangerous builds counted
         bool m_force_update;            //!< Flag to handle the forcing of neighborlist updates
+        bool m_update_forced;           //!< True if the last update was forced rather than found by the distance check
+        bool m_remap_pending;           //!< Flag set when the particles were permuted since the last compute
         bool m_dist_check;              //!< Set to false to disable distance checks (nlist always built m_rebuild_check_delay steps)
         bool m_has_been_updated_once;   //!< True if the neighbor list has been updated at least once
 
@@ -623,12 +899,34 @@ class PYBIND11_EXPORT NeighborList : public Compute
         uint64_t m_last_checked_tstep; //!< Track the last time step we have checked
         bool m_last_check_result;          //!< Last result of rebuild check
         uint64_t m_rebuild_check_delay; //!< No update checks will be performed until m_rebuild_check_delay steps after the last one
+        bool m_adaptive_check;          //!< True if the checks after a build are scheduled from the displacement history
+        uint64_t m_predicted_delay;     //!< Steps after a build that cannot trigger the next one
+        std::deque<Scalar> m_max_speed_history; //!< Largest displacement per step observed in the recent builds
+
+        bool m_tune_r_buff;             //!< True if the buffer radius is tuned during the run
+        bool m_tune_window_active;      //!< True if the run time of the current buffer radius is being measured
+        uint64_t m_tune_start_time;     //!< Wall clock time at the start of the measurement window (in ns)
+        uint64_t m_tune_start_tstep;    //!< Time step at the start of the measurement window
+        unsigned int m_tune_builds;     //!< Number of builds in the measurement window
+        double m_tune_best_cost;        //!< Lowest run time per step measured so far (in ns), negative if none
+        Scalar m_tune_best_r_buff;      //!< Buffer radius with the lowest run time per step
+        Scalar m_tune_step;             //!< Current change of the buffer radius between trials
+        int m_tune_direction;           //!< Direction of the next trial (1 to grow the buffer, -1 to shrink it)
         std::vector<uint64_t> m_update_periods;    //!< Steps between updates
         std::set<std::string> m_exclusions;        //!< Exclusions that have been set
 
         //! Test if the list needs updating
         bool needsUpdating(uint64_t timestep);
 
+        //! Update the predicted check delay after a build that was triggered by the distance check
+        void updatePredictedDelay(uint64_t period, bool dangerous);
+
+        //! Predict the check delay from the displacement history and the current buffer radius
+        void predictCheckDelay();
+
+        //! Measure the run time per step and choose the buffer radius of the next trial
+        void tuneRBuff(uint64_t timestep);
+
         //! Reallocate internal neighbor list data structures
         void reallocate();
 
@@ -641,8 +939,11 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Resets the condition status to all zeroes
         virtual void resetConditions();
 
-        //! Grow the exclusions list memory capacity by one row
-        void growExclusionList();
+        //! Grow the exclusions list memory capacity to the given number of rows
+        void growExclusionList(unsigned int new_height);
+
+        //! Method to be called when the particles are sorted
+        void slotParticlesSorted();
 
         //! Method to be called when the global particle number changes
         void slotGlobalParticleNumberChange()
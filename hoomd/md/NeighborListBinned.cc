@@ -14,6 +14,12 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 
 using namespace std;
 namespace py = pybind11;
@@ -37,6 +43,8 @@ NeighborListBinned::NeighborListBinned(std::shared_ptr<SystemDefinition> sysdef,
 
     // cell sizes need update by default
     m_update_cell_size = true;
+
+    m_exclusions_in_build = true;
     }
 
 NeighborListBinned::~NeighborListBinned()
@@ -53,6 +61,10 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
         if (m_diameter_shift)
             rmax += m_d_max - Scalar(1.0);
 
+        // partial rebuilds search around reference positions up to half of the buffer distance away
+        if (m_partial_rebuild)
+            rmax += Scalar(0.5)*m_r_buff;
+
         m_cl->setNominalWidth(rmax);
         m_update_cell_size = false;
         }
@@ -69,6 +81,7 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
 
@@ -99,7 +112,18 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    #ifdef ENABLE_TBB
+    // each thread records its own overflow conditions, which are merged after the loop
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > thread_conditions(m_pdata->getNTypes(), 0);
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    unsigned int *conditions = thread_conditions.local().data();
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    unsigned int *conditions = h_conditions.data;
+    for (unsigned int i = 0; i < nparticles; i++)
+    #endif
         {
         unsigned int cur_n_neigh = 0;
 
@@ -111,6 +135,10 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
         const unsigned int Nmax_i = h_Nmax.data[type_i];
         const unsigned int head_idx_i = h_head_list.data[i];
 
+        ExclusionRange ex_i = {NULL, NULL};
+        if (m_exclusions_set)
+            ex_i = getSortedExclusions(h_tag.data[i]);
+
         // find the bin each particle belongs in
         Scalar3 f = box.makeFraction(my_pos,ghost_width);
         int ib = (unsigned int)(f.x * dim.x);
@@ -148,7 +176,7 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
                 // (1) they are the same particle, or
                 // (2) the r_cut(i,j) indicates to skip, or
                 // (3) they are in the same body
-                bool excluded = ((i == (int)cur_neigh) || (r_cut <= Scalar(0.0)));
+                bool excluded = ((i == cur_neigh) || (r_cut <= Scalar(0.0)));
                 if (m_filter_body && body_i != NO_BODY)
                     excluded = excluded | (body_i == h_body.data[cur_neigh]);
                 if (excluded)
@@ -174,7 +202,7 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
                 Scalar r_listsq = h_r_listsq.data[m_typpair_idx(type_i,cur_neigh_type)];
                 if (dr_sq <= (r_listsq + sqshift) && !excluded)
                     {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    if ((m_storage_mode == full || i < cur_neigh) && !ex_i.contains(h_tag.data[cur_neigh]))
                         {
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
@@ -182,7 +210,7 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
                             h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
                             }
                         else
-                            h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
+                            conditions[type_i] = max(conditions[type_i], cur_n_neigh+1);
 
                         cur_n_neigh++;
                         }
@@ -192,11 +220,220 @@ void NeighborListBinned::buildNlist(uint64_t timestep)
 
         h_n_neigh.data[i] = cur_n_neigh;
         }
+    #ifdef ENABLE_TBB
+        });
+
+    for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+        for (unsigned int t = 0; t < m_pdata->getNTypes(); ++t)
+            h_conditions.data[t] = max(h_conditions.data[t], (*it)[t]);
+    #endif
 
     if (m_prof)
         m_prof->pop(m_exec_conf);
     }
 
+/*! \param timestep Current time step
+    \param fast Particles that moved more than half of the buffer distance from their reference positions
+
+    The cell list bins the current positions, and cells are widened by half of the buffer distance so that the
+    particles within reach of a reference position are found in the adjacent cells. Rows are rebuilt with the same
+    criteria as buildNlist(), applied to the reference positions.
+
+    \returns false when more than half of the rows would be rebuilt
+*/
+bool NeighborListBinned::buildNlistRows(uint64_t timestep, const std::vector<unsigned int>& fast)
+    {
+    // the cells are only wide enough for partial rebuilds after a full build in this mode
+    if (m_update_cell_size)
+        return false;
+
+    m_cl->compute(timestep);
+
+    uint3 dim = m_cl->getDim();
+    Scalar3 ghost_width = m_cl->getGhostWidth();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::readwrite);
+
+    const BoxDim& box = m_pdata->getBox();
+    uchar3 periodic = box.getPeriodic();
+
+    ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_r_listsq(m_r_listsq, access_location::host, access_mode::read);
+
+    ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_adj(m_cl->getCellAdjArray(), access_location::host, access_mode::read);
+
+    Index3D ci = m_cl->getCellIndexer();
+    Index2D cli = m_cl->getCellListIndexer();
+    Index2D cadji = m_cl->getCellAdjIndexer();
+
+    // find the cell of a position in the box
+    auto get_cell = [&](const Scalar3& pos)
+        {
+        Scalar3 f = box.makeFraction(pos,ghost_width);
+        int ib = (unsigned int)(f.x * dim.x);
+        int jb = (unsigned int)(f.y * dim.y);
+        int kb = (unsigned int)(f.z * dim.z);
+
+        if (ib == (int)dim.x && periodic.x)
+            ib = 0;
+        if (jb == (int)dim.y && periodic.y)
+            jb = 0;
+        if (kb == (int)dim.z && periodic.z)
+            kb = 0;
+
+        return ci(ib,jb,kb);
+        };
+
+    const unsigned int N = m_pdata->getN();
+    std::vector<char> rebuild(N, 0);
+
+    // mark the particles whose reference positions are within reach of pos
+    Scalar rmax = getMaxRCut() + m_r_buff;
+    if (m_diameter_shift)
+        rmax += m_d_max - Scalar(1.0);
+    const Scalar rmaxsq = rmax*rmax;
+
+    auto mark_near = [&](const Scalar3& pos)
+        {
+        unsigned int my_cell = get_cell(pos);
+        for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); cur_adj++)
+            {
+            unsigned int neigh_cell = h_cell_adj.data[cadji(cur_adj, my_cell)];
+            unsigned int size = h_cell_size.data[neigh_cell];
+            for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                {
+                unsigned int j = __scalar_as_int(h_cell_xyzf.data[cli(cur_offset, neigh_cell)].w);
+                Scalar3 dx = box.minImage(pos - make_scalar3(h_last_pos.data[j].x,
+                                                             h_last_pos.data[j].y,
+                                                             h_last_pos.data[j].z));
+                if (dot(dx, dx) <= rmaxsq)
+                    rebuild[j] = 1;
+                }
+            }
+        };
+
+    // the fast particles leave the rows near their old reference positions and enter those near the new ones
+    for (unsigned int i : fast)
+        mark_near(make_scalar3(h_last_pos.data[i].x, h_last_pos.data[i].y, h_last_pos.data[i].z));
+
+    for (unsigned int i : fast)
+        {
+        h_last_pos.data[i] = make_scalar4(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z, Scalar(0.0));
+        rebuild[i] = 1;
+        }
+
+    for (unsigned int i : fast)
+        mark_near(make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z));
+
+    std::vector<unsigned int> rows;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (rebuild[i])
+            rows.push_back(i);
+        }
+
+    if (rows.size() > N/2)
+        return false;
+
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_conditions(m_conditions, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::readwrite);
+
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > thread_conditions(m_pdata->getNTypes(), 0);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, rows.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+    unsigned int *conditions = thread_conditions.local().data();
+    for (size_t row = r.begin(); row != r.end(); ++row)
+    #else
+    unsigned int *conditions = h_conditions.data;
+    for (size_t row = 0; row < rows.size(); row++)
+    #endif
+        {
+        const unsigned int i = rows[row];
+        unsigned int cur_n_neigh = 0;
+
+        const Scalar3 my_pos = make_scalar3(h_last_pos.data[i].x, h_last_pos.data[i].y, h_last_pos.data[i].z);
+        const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
+        const unsigned int body_i = h_body.data[i];
+        const Scalar diam_i = h_diameter.data[i];
+
+        const unsigned int Nmax_i = h_Nmax.data[type_i];
+        const unsigned int head_idx_i = h_head_list.data[i];
+
+        ExclusionRange ex_i = {NULL, NULL};
+        if (m_exclusions_set)
+            ex_i = getSortedExclusions(h_tag.data[i]);
+
+        unsigned int my_cell = get_cell(my_pos);
+
+        for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); cur_adj++)
+            {
+            unsigned int neigh_cell = h_cell_adj.data[cadji(cur_adj, my_cell)];
+
+            unsigned int size = h_cell_size.data[neigh_cell];
+            for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                {
+                unsigned int cur_neigh = __scalar_as_int(h_cell_xyzf.data[cli(cur_offset, neigh_cell)].w);
+
+                unsigned int cur_neigh_type = __scalar_as_int(h_pos.data[cur_neigh].w);
+                Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i,cur_neigh_type)];
+
+                bool excluded = ((i == cur_neigh) || (r_cut <= Scalar(0.0)));
+                if (m_filter_body && body_i != NO_BODY)
+                    excluded = excluded | (body_i == h_body.data[cur_neigh]);
+                if (excluded)
+                    continue;
+
+                Scalar3 neigh_pos = make_scalar3(h_last_pos.data[cur_neigh].x,
+                                                 h_last_pos.data[cur_neigh].y,
+                                                 h_last_pos.data[cur_neigh].z);
+                Scalar3 dx = box.minImage(my_pos - neigh_pos);
+
+                Scalar r_list = r_cut + m_r_buff;
+                Scalar sqshift = Scalar(0.0);
+                if (m_diameter_shift)
+                    {
+                    const Scalar delta = (diam_i + h_diameter.data[cur_neigh]) * Scalar(0.5) - Scalar(1.0);
+                    sqshift = (delta + Scalar(2.0) * r_list) * delta;
+                    }
+
+                Scalar r_listsq = h_r_listsq.data[m_typpair_idx(type_i,cur_neigh_type)];
+                if (dot(dx,dx) <= (r_listsq + sqshift)
+                    && (m_storage_mode == full || i < cur_neigh) && !ex_i.contains(h_tag.data[cur_neigh]))
+                    {
+                    if (cur_n_neigh < Nmax_i)
+                        h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
+                    else
+                        conditions[type_i] = max(conditions[type_i], cur_n_neigh+1);
+
+                    cur_n_neigh++;
+                    }
+                }
+            }
+
+        h_n_neigh.data[i] = cur_n_neigh;
+        }
+    #ifdef ENABLE_TBB
+        });
+
+    for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+        for (unsigned int t = 0; t < m_pdata->getNTypes(); ++t)
+            h_conditions.data[t] = max(h_conditions.data[t], (*it)[t]);
+    #endif
+
+    return true;
+    }
+
 void export_NeighborListBinned(py::module& m)
     {
     py::class_<NeighborListBinned, NeighborList, std::shared_ptr<NeighborListBinned> >(m, "NeighborListBinned")
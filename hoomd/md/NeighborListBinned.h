@@ -44,6 +44,13 @@ class PYBIND11_EXPORT NeighborListBinned : public NeighborList
             NeighborList::notifyRCutMatrixChange();
             }
 
+        //! Set whether the list may be rebuilt only for the rows near fast particles
+        virtual void setPartialRebuild(bool partial)
+            {
+            m_update_cell_size = true;
+            NeighborList::setPartialRebuild(partial);
+            }
+
         /// Make the neighborlist deterministic
         void setDeterministic(bool deterministic)
             {
@@ -64,6 +71,9 @@ class PYBIND11_EXPORT NeighborListBinned : public NeighborList
 
         //! Builds the neighbor list
         virtual void buildNlist(uint64_t timestep);
+
+        //! Rebuild the rows of the particles near those that moved too far
+        virtual bool buildNlistRows(uint64_t timestep, const std::vector<unsigned int>& fast);
     };
 
 //! Exports NeighborListBinned to python
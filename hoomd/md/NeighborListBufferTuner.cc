@@ -0,0 +1,267 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file NeighborListBufferTuner.cc
+    \brief Defines the NeighborListBufferTuner class
+*/
+
+#include "NeighborListBufferTuner.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+namespace py = pybind11;
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+//! The inverse of the golden ratio
+const Scalar GOLDEN_RATIO_INV = Scalar(0.6180339887498949);
+
+/*! \param sysdef System the neighbor list computes neighbors for
+    \param trigger Select the time steps on which the tuner measures a trial and sets the next one
+    \param nlist Neighbor list to tune
+    \param r_buff_min Smallest buffer radius to try
+    \param r_buff_max Largest buffer radius to try
+*/
+NeighborListBufferTuner::NeighborListBufferTuner(std::shared_ptr<SystemDefinition> sysdef,
+                                                 std::shared_ptr<Trigger> trigger,
+                                                 std::shared_ptr<NeighborList> nlist,
+                                                 Scalar r_buff_min,
+                                                 Scalar r_buff_max)
+    : Tuner(sysdef, trigger), m_nlist(nlist), m_r_buff_min(r_buff_min), m_r_buff_max(r_buff_max),
+      m_tolerance(0.01), m_density_tolerance(0.1), m_state(measure_c), m_started(false), m_a(0), m_b(0), m_c(0),
+      m_d(0), m_f_c(0), m_f_d(0), m_have_c(false), m_have_d(false), m_tuned_density(0), m_trial_time(0),
+      m_trial_tstep(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListBufferTuner" << endl;
+
+    if (m_r_buff_min < 0.0 || m_r_buff_max <= m_r_buff_min)
+        {
+        m_exec_conf->msg->error() << "tune.NeighborListBuffer: Requested buffer range is invalid" << endl;
+        throw runtime_error("Error initializing NeighborListBufferTuner");
+        }
+    }
+
+NeighborListBufferTuner::~NeighborListBufferTuner()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListBufferTuner" << endl;
+    }
+
+void NeighborListBufferTuner::setMinimumBuffer(Scalar r_buff_min)
+    {
+    if (r_buff_min < 0.0 || r_buff_min >= m_r_buff_max)
+        {
+        m_exec_conf->msg->error() << "tune.NeighborListBuffer: Requested buffer range is invalid" << endl;
+        throw runtime_error("Error changing NeighborListBufferTuner parameters");
+        }
+    m_r_buff_min = r_buff_min;
+    m_started = false;
+    }
+
+void NeighborListBufferTuner::setMaximumBuffer(Scalar r_buff_max)
+    {
+    if (r_buff_max <= m_r_buff_min)
+        {
+        m_exec_conf->msg->error() << "tune.NeighborListBuffer: Requested buffer range is invalid" << endl;
+        throw runtime_error("Error changing NeighborListBufferTuner parameters");
+        }
+    m_r_buff_max = r_buff_max;
+    m_started = false;
+    }
+
+/*! \param timestep Current time step
+
+    Each call, except the first one of a search, closes the measurement of the current trial. The golden-section
+    search keeps two interior points c < d of the interval [a, b]. It drops the part of the interval beyond the
+    slower interior point, which leaves the faster point as one of the interior points of the smaller interval, so
+    only one new point needs to be measured per step of the search.
+*/
+void NeighborListBufferTuner::update(uint64_t timestep)
+    {
+    if (!m_started)
+        {
+        startSearch(timestep);
+        return;
+        }
+
+    if (m_state == tuned)
+        {
+        Scalar density = getDensity();
+        if (std::abs(density - m_tuned_density) > m_density_tolerance * m_tuned_density)
+            {
+            m_exec_conf->msg->notice(3) << "tune.NeighborListBuffer: Density changed, tuning the buffer again" << endl;
+            startSearch(timestep);
+            }
+        return;
+        }
+
+    // nothing to measure yet
+    if (timestep <= m_trial_tstep)
+        return;
+
+    double cost = measureTrial(timestep);
+    if (m_state == measure_c)
+        {
+        m_f_c = cost;
+        m_have_c = true;
+        }
+    else
+        {
+        m_f_d = cost;
+        m_have_d = true;
+        }
+
+    if (!m_have_d)
+        {
+        m_state = measure_d;
+        startTrial(m_d, timestep);
+        return;
+        }
+
+    if (m_b - m_a < m_tolerance)
+        {
+        Scalar r_buff = (m_f_c < m_f_d) ? m_c : m_d;
+        m_exec_conf->msg->notice(2) << "tune.NeighborListBuffer: Tuned the buffer to " << r_buff << endl;
+        m_nlist->setRBuff(r_buff);
+        m_state = tuned;
+        m_tuned_density = getDensity();
+        return;
+        }
+
+    if (m_f_c < m_f_d)
+        {
+        // the minimum is in [a, d]
+        m_b = m_d;
+        m_d = m_c;
+        m_f_d = m_f_c;
+        m_c = m_b - GOLDEN_RATIO_INV*(m_b - m_a);
+        m_have_c = false;
+        m_state = measure_c;
+        startTrial(m_c, timestep);
+        }
+    else
+        {
+        // the minimum is in [c, b]
+        m_a = m_c;
+        m_c = m_d;
+        m_f_c = m_f_d;
+        m_d = m_a + GOLDEN_RATIO_INV*(m_b - m_a);
+        m_have_d = false;
+        m_state = measure_d;
+        startTrial(m_d, timestep);
+        }
+    }
+
+/*! \param timestep Current time step
+*/
+void NeighborListBufferTuner::startSearch(uint64_t timestep)
+    {
+    m_a = m_r_buff_min;
+    m_b = std::max(std::min(m_r_buff_max, getMaximumAllowedBuffer()), m_r_buff_min);
+    m_c = m_b - GOLDEN_RATIO_INV*(m_b - m_a);
+    m_d = m_a + GOLDEN_RATIO_INV*(m_b - m_a);
+    m_have_c = false;
+    m_have_d = false;
+    m_state = measure_c;
+    m_started = true;
+
+    m_exec_conf->msg->notice(6) << "tune.NeighborListBuffer: Searching the buffer in [" << m_a << ", " << m_b << "]"
+                                << endl;
+    startTrial(m_c, timestep);
+    }
+
+/*! \param r_buff Buffer radius to measure
+    \param timestep Current time step
+
+    Setting the buffer radius forces a neighbor list build on the next step, which is part of the measurement.
+*/
+void NeighborListBufferTuner::startTrial(Scalar r_buff, uint64_t timestep)
+    {
+    m_exec_conf->msg->notice(6) << "tune.NeighborListBuffer: Trying buffer " << r_buff << endl;
+    m_nlist->setRBuff(r_buff);
+    m_trial_time = m_clock.getTime();
+    m_trial_tstep = timestep;
+    }
+
+/*! \param timestep Current time step
+    \returns The wall clock time per step since the start of the trial (in ns)
+*/
+double NeighborListBufferTuner::measureTrial(uint64_t timestep)
+    {
+    double elapsed = double(m_clock.getTime() - m_trial_time);
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return elapsed / double(timestep - m_trial_tstep);
+    }
+
+/*! The neighbor list cutoff must be less than half the box, and the ghost layer less than half the local domain
+    along every decomposed direction.
+*/
+Scalar NeighborListBufferTuner::getMaximumAllowedBuffer()
+    {
+    Scalar r_cut = m_nlist->getMaxRCut();
+    if (m_nlist->getDiameterShift())
+        r_cut += m_nlist->getMaximumDiameter() - Scalar(1.0);
+
+    const Scalar3 L = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    Scalar L_min = std::min(L.x, L.y);
+    if (m_sysdef->getNDimensions() == 3)
+        L_min = std::min(L_min, L.z);
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        const Scalar3 L_local = m_pdata->getBox().getNearestPlaneDistance();
+        const Index3D& di = m_pdata->getDomainDecomposition()->getDomainIndexer();
+        if (di.getW() > 1)
+            L_min = std::min(L_min, L_local.x);
+        if (di.getH() > 1)
+            L_min = std::min(L_min, L_local.y);
+        if (di.getD() > 1)
+            L_min = std::min(L_min, L_local.z);
+
+        MPI_Allreduce(MPI_IN_PLACE, &L_min, 1, MPI_HOOMD_SCALAR, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return Scalar(0.99)*L_min/Scalar(2.0) - r_cut;
+    }
+
+Scalar NeighborListBufferTuner::getDensity()
+    {
+    const bool twod = m_sysdef->getNDimensions() == 2;
+    return Scalar(m_pdata->getNGlobal()) / m_pdata->getGlobalBox().getVolume(twod);
+    }
+
+void export_NeighborListBufferTuner(py::module& m)
+    {
+    py::class_<NeighborListBufferTuner, Tuner, std::shared_ptr<NeighborListBufferTuner> >(m,
+                                                                                       "NeighborListBufferTuner")
+    .def(py::init< std::shared_ptr<SystemDefinition>,
+                   std::shared_ptr<Trigger>,
+                   std::shared_ptr<NeighborList>,
+                   Scalar,
+                   Scalar >())
+    .def_property("minimum_buffer", &NeighborListBufferTuner::getMinimumBuffer,
+                                    &NeighborListBufferTuner::setMinimumBuffer)
+    .def_property("maximum_buffer", &NeighborListBufferTuner::getMaximumBuffer,
+                                    &NeighborListBufferTuner::setMaximumBuffer)
+    .def_property("tolerance", &NeighborListBufferTuner::getTolerance,
+                               &NeighborListBufferTuner::setTolerance)
+    .def_property("density_tolerance", &NeighborListBufferTuner::getDensityTolerance,
+                                       &NeighborListBufferTuner::setDensityTolerance)
+    .def_property_readonly("tuned", &NeighborListBufferTuner::isTuned)
+    ;
+    }
@@ -0,0 +1,152 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file NeighborListBufferTuner.h
+    \brief Declares the NeighborListBufferTuner class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/Tuner.h"
+#include "hoomd/ClockSource.h"
+#include "NeighborList.h"
+
+#include <memory>
+#include <pybind11/pybind11.h>
+
+#ifndef __NEIGHBORLIST_BUFFER_TUNER_H__
+#define __NEIGHBORLIST_BUFFER_TUNER_H__
+
+//! Tune the buffer radius of a neighbor list
+/*! A larger buffer radius makes the neighbor list builds less frequent, but adds neighbors that the force
+    computes must loop over. The tuner searches for the buffer radius that minimizes the run time per step,
+    which includes both the builds and the force computes.
+
+    Every time the tuner is triggered, it measures the wall clock time per step since the previous trigger, during
+    which the neighbor list used the trial buffer radius, and sets the next trial. The trials follow a golden-section
+    search on the interval between the minimum and maximum buffer radius. The maximum is reduced so that the ghost
+    layer fits in the local domain. On MPI runs, the slowest rank determines the time per step.
+
+    Once the interval is narrower than the tolerance, the tuner keeps the best buffer radius. It starts a new search
+    when the number density changes by more than the relative density tolerance.
+
+    \ingroup updaters
+*/
+class PYBIND11_EXPORT NeighborListBufferTuner : public Tuner
+    {
+    public:
+        //! Constructor
+        NeighborListBufferTuner(std::shared_ptr<SystemDefinition> sysdef,
+                                std::shared_ptr<Trigger> trigger,
+                                std::shared_ptr<NeighborList> nlist,
+                                Scalar r_buff_min,
+                                Scalar r_buff_max);
+
+        //! Destructor
+        virtual ~NeighborListBufferTuner();
+
+        //! Measure the current trial and set the next one
+        virtual void update(uint64_t timestep);
+
+        //! Get the smallest buffer radius to try
+        Scalar getMinimumBuffer()
+            {
+            return m_r_buff_min;
+            }
+
+        //! Set the smallest buffer radius to try
+        void setMinimumBuffer(Scalar r_buff_min);
+
+        //! Get the largest buffer radius to try
+        Scalar getMaximumBuffer()
+            {
+            return m_r_buff_max;
+            }
+
+        //! Set the largest buffer radius to try
+        void setMaximumBuffer(Scalar r_buff_max);
+
+        //! Get the width of the search interval at which the search stops
+        Scalar getTolerance()
+            {
+            return m_tolerance;
+            }
+
+        //! Set the width of the search interval at which the search stops
+        void setTolerance(Scalar tolerance)
+            {
+            m_tolerance = tolerance;
+            }
+
+        //! Get the relative change of the number density that starts a new search
+        Scalar getDensityTolerance()
+            {
+            return m_density_tolerance;
+            }
+
+        //! Set the relative change of the number density that starts a new search
+        void setDensityTolerance(Scalar density_tolerance)
+            {
+            m_density_tolerance = density_tolerance;
+            }
+
+        //! Test if the search has converged
+        bool isTuned()
+            {
+            return m_state == tuned;
+            }
+
+    protected:
+        //! States of the search
+        enum searchState
+            {
+            measure_c,  //!< Measuring the lower interior point
+            measure_d,  //!< Measuring the upper interior point
+            tuned       //!< The search has converged
+            };
+
+        std::shared_ptr<NeighborList> m_nlist; //!< Neighbor list to tune
+        Scalar m_r_buff_min;                    //!< Smallest buffer radius to try
+        Scalar m_r_buff_max;                    //!< Largest buffer radius to try
+        Scalar m_tolerance;                     //!< Width of the search interval at which the search stops
+        Scalar m_density_tolerance;             //!< Relative change of the number density that restarts the search
+
+        searchState m_state;    //!< Current state of the search
+        bool m_started;         //!< True once the first trial has been set
+        Scalar m_a;             //!< Lower bound of the search interval
+        Scalar m_b;             //!< Upper bound of the search interval
+        Scalar m_c;             //!< Lower interior point
+        Scalar m_d;             //!< Upper interior point
+        double m_f_c;           //!< Time per step at the lower interior point
+        double m_f_d;           //!< Time per step at the upper interior point
+        bool m_have_c;          //!< True if the lower interior point has been measured
+        bool m_have_d;          //!< True if the upper interior point has been measured
+        Scalar m_tuned_density; //!< Number density when the search converged
+
+        ClockSource m_clock;        //!< Wall clock for the measurements
+        uint64_t m_trial_time;      //!< Wall clock time at the start of the trial (in ns)
+        uint64_t m_trial_tstep;     //!< Time step at the start of the trial
+
+        //! Start a new search
+        void startSearch(uint64_t timestep);
+
+        //! Set the buffer radius of the next trial and start measuring it
+        void startTrial(Scalar r_buff, uint64_t timestep);
+
+        //! Measure the time per step of the current trial
+        double measureTrial(uint64_t timestep);
+
+        //! Get the largest buffer radius that fits the box and the local domain
+        Scalar getMaximumAllowedBuffer();
+
+        //! Get the current number density
+        Scalar getDensity();
+    };
+
+//! Export the NeighborListBufferTuner class to python
+void export_NeighborListBufferTuner(pybind11::module& m);
+
+#endif
@@ -19,9 +19,27 @@ namespace py = pybind11;
 
 #include "hoomd/CachedAllocator.h"
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
 using namespace std;
 
+NeighborListGPU::~NeighborListGPU()
+    {
+    if (m_h_nlist_ooc)
+        hipHostFree(m_h_nlist_ooc);
+
+    for (unsigned int i = 0; i < 2; ++i)
+        {
+        if (m_ooc_stream[i])
+            {
+            hipStreamDestroy(m_ooc_stream[i]);
+            hipEventDestroy(m_ooc_ready[i]);
+            hipEventDestroy(m_ooc_done[i]);
+            }
+        }
+    }
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
 
@@ -89,6 +107,9 @@ bool NeighborListGPU::distanceCheck(uint64_t timestep)
     Scalar lambda_min = (lambda.x < lambda.y) ? lambda.x : lambda.y;
     lambda_min = (lambda_min < lambda.z) ? lambda_min : lambda.z;
 
+    if (m_scaled_check)
+        lambda_min = getMinBoxStretch();
+
     ArrayHandle<Scalar> d_rcut_max(m_rcut_max, access_location::device, access_mode::read);
 
         {
@@ -106,6 +127,9 @@ bool NeighborListGPU::distanceCheck(uint64_t timestep)
                                          m_pdata->getNTypes(),
                                          lambda_min,
                                          lambda,
+                                         m_scaled_check,
+                                         m_pdata->getGlobalBox(),
+                                         m_last_global_box,
                                          ++m_checkn,
                                          m_pdata->getGPUPartition());
 
@@ -145,10 +169,14 @@ bool NeighborListGPU::distanceCheck(uint64_t timestep)
     return result;
     }
 
-/*! Calls gpu_nlist_filter() to filter the neighbor list on the GPU
+/*! Calls gpu_nlist_filter() to filter the neighbor list on the GPU. The out of core neighbor list is filtered chunk
+    by chunk in buildOutOfCore().
 */
 void NeighborListGPU::filterNlist()
     {
+    if (m_ooc_chunk_size)
+        return;
+
     if (m_prof)
         m_prof->push(m_exec_conf, "filter");
 
@@ -215,6 +243,12 @@ void NeighborListGPU::buildHeadList()
     if (!m_pdata->getN())
         return;
 
+    if (m_ooc_chunk_size)
+        {
+        buildHeadListOutOfCore();
+        return;
+        }
+
     if (m_prof) m_prof->push(m_exec_conf, "head-list");
 
         {
@@ -257,10 +291,521 @@ void NeighborListGPU::buildHeadList()
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+//! Pack the neighbor list with exact counts on the GPU
+void NeighborListGPU::compressNlist()
+    {
+    // don't do anything if there are no particles owned by this rank
+    if (!m_pdata->getN())
+        return;
+
+    if (m_prof) m_prof->push(m_exec_conf, "compress");
+
+    if (m_alt_head_list.getNumElements() < m_head_list.getNumElements())
+        {
+        GlobalArray<unsigned int> alt_head_list(m_head_list.getNumElements(), m_exec_conf);
+        m_alt_head_list.swap(alt_head_list);
+        TAG_ALLOCATION(m_alt_head_list);
+        }
+
+        {
+        ArrayHandle<unsigned int> d_alt_head_list(m_alt_head_list, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_req_size_nlist(m_req_size_nlist, access_location::device, access_mode::overwrite);
+
+        gpu_nlist_compress_head_list(d_alt_head_list.data,
+                                     d_req_size_nlist.data,
+                                     d_n_neigh.data,
+                                     m_pdata->getN());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    unsigned int req_size_nlist;
+        {
+        ArrayHandle<unsigned int> h_req_size_nlist(m_req_size_nlist, access_location::host, access_mode::read);
+        req_size_nlist = *h_req_size_nlist.data;
+        }
+
+    // the temporary storage only needs to hold the exact number of neighbors, grow it with some slack
+    if (req_size_nlist > m_packed_nlist.getNumElements())
+        {
+        GlobalArray<unsigned int> packed_nlist(req_size_nlist + req_size_nlist/8, m_exec_conf);
+        m_packed_nlist.swap(packed_nlist);
+        TAG_ALLOCATION(m_packed_nlist);
+        }
+
+        {
+        ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_packed_nlist(m_packed_nlist, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_alt_head_list(m_alt_head_list, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::read);
+
+        m_tuner_compress->begin();
+        gpu_nlist_compress(d_nlist.data,
+                           d_packed_nlist.data,
+                           d_head_list.data,
+                           d_alt_head_list.data,
+                           d_n_neigh.data,
+                           req_size_nlist,
+                           m_pdata->getN(),
+                           m_tuner_compress->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_compress->end();
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+void NeighborListGPU::setLastUpdatedTags()
+    {
+    if (!m_pdata->getN())
+        return;
+
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_last_tag(m_last_tag, access_location::device, access_mode::overwrite);
+    hipMemcpy(d_last_tag.data, d_tag.data, sizeof(unsigned int)*m_pdata->getN(), hipMemcpyDeviceToDevice);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+/*! See NeighborList::remapNlist(). The per particle arrays are scattered into temporary storage and copied back, so
+    that the arrays of the neighbor list keep their identity and memory hints.
+*/
+void NeighborListGPU::remapNlist()
+    {
+    const unsigned int N = m_pdata->getN();
+    if (!N)
+        return;
+
+    // the chunks of the out of core list change with the order of the particles
+    if (m_ooc_chunk_size)
+        {
+        forceUpdate();
+        return;
+        }
+
+    if (m_prof) m_prof->push(m_exec_conf, "remap");
+
+    if (m_new_idx.getNumElements() < N)
+        {
+        GlobalArray<unsigned int> new_idx(m_pdata->getMaxN(), m_exec_conf);
+        m_new_idx.swap(new_idx);
+        TAG_ALLOCATION(m_new_idx);
+
+        GlobalArray<Scalar4> alt_last_pos(m_pdata->getMaxN(), m_exec_conf);
+        m_alt_last_pos.swap(alt_last_pos);
+        TAG_ALLOCATION(m_alt_last_pos);
+        }
+
+    if (m_alt_head_list.getNumElements() < N)
+        {
+        GlobalArray<unsigned int> alt_head_list(m_head_list.getNumElements(), m_exec_conf);
+        m_alt_head_list.swap(alt_head_list);
+        TAG_ALLOCATION(m_alt_head_list);
+        }
+
+    const unsigned int block_size = 256;
+
+        {
+        ArrayHandle<unsigned int> d_new_idx(m_new_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_alt(m_alt_head_list, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_alt_last_pos(m_alt_last_pos, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_last_pos(m_last_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_last_tag(m_last_tag, access_location::device, access_mode::read);
+
+        gpu_nlist_remap(d_new_idx.data,
+                        d_nlist.data,
+                        d_head_list.data,
+                        d_n_neigh.data,
+                        d_rtag.data,
+                        d_last_tag.data,
+                        N,
+                        block_size);
+
+        gpu_nlist_scatter(d_alt.data, d_head_list.data, d_new_idx.data, N, block_size);
+        hipMemcpy(d_head_list.data, d_alt.data, sizeof(unsigned int)*N, hipMemcpyDeviceToDevice);
+
+        gpu_nlist_scatter(d_alt.data, d_n_neigh.data, d_new_idx.data, N, block_size);
+        hipMemcpy(d_n_neigh.data, d_alt.data, sizeof(unsigned int)*N, hipMemcpyDeviceToDevice);
+
+        gpu_nlist_scatter(d_alt_last_pos.data, d_last_pos.data, d_new_idx.data, N, block_size);
+        hipMemcpy(d_last_pos.data, d_alt_last_pos.data, sizeof(Scalar4)*N, hipMemcpyDeviceToDevice);
+
+        for (unsigned int consumer = 0; consumer < m_n_neigh_consumer.size(); ++consumer)
+            {
+            if (!m_n_neigh_consumer[consumer] || m_n_neigh_consumer[consumer]->getNumElements() < N)
+                continue;
+
+            ArrayHandle<unsigned int> d_n_neigh_consumer(*m_n_neigh_consumer[consumer], access_location::device,
+                                                         access_mode::readwrite);
+            gpu_nlist_scatter(d_alt.data, d_n_neigh_consumer.data, d_new_idx.data, N, block_size);
+            hipMemcpy(d_n_neigh_consumer.data, d_alt.data, sizeof(unsigned int)*N, hipMemcpyDeviceToDevice);
+            }
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    m_head_list_compressed = true;
+    setLastUpdatedTags();
+    m_ex_list_idx_dirty = true;
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+//! Sort the neighbors of each particle by distance on the GPU
+void NeighborListGPU::sortNlist()
+    {
+    if (m_prof) m_prof->push(m_exec_conf, "sort");
+
+    updateConsumerRList();
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
+
+    m_tuner_sort->begin();
+    gpu_nlist_sort_by_distance(d_nlist.data,
+                               d_head_list.data,
+                               d_n_neigh.data,
+                               d_pos.data,
+                               m_pdata->getBox(),
+                               m_pdata->getN(),
+                               m_tuner_sort->getParam());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    m_tuner_sort->end();
+
+    for (unsigned int consumer = 0; consumer < m_consumer_r_cut.size(); ++consumer)
+        {
+        ArrayHandle<unsigned int> d_n_neigh_consumer(*m_n_neigh_consumer[consumer], access_location::device,
+                                                     access_mode::overwrite);
+        ArrayHandle<Scalar> d_r_listsq(*m_r_listsq_consumer[consumer], access_location::device, access_mode::read);
+
+        gpu_nlist_count_consumer(d_n_neigh_consumer.data,
+                                 d_nlist.data,
+                                 d_head_list.data,
+                                 d_n_neigh.data,
+                                 d_pos.data,
+                                 m_pdata->getBox(),
+                                 d_r_listsq.data,
+                                 m_pdata->getN(),
+                                 m_pdata->getNTypes(),
+                                 m_tuner_sort->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*! \param chunk_size Number of particles in each chunk, 0 to keep the neighbor list resident in device memory
+
+    Out of core storage holds the neighbor list in pinned host memory, for systems whose neighbor list does not fit in
+    device memory next to the particle data. The particles are processed in chunks of \a chunk_size consecutive
+    indices, which are spatially compact when the particles are sorted along a space filling curve. Each chunk has its
+    own head list, so the size of the neighbor list is only limited by host memory. The list is built chunk by chunk
+    into one of two device buffers and copied to the host while the next chunk is built, and streamChunks() copies it
+    back to the device with the same double buffering. All other per particle arrays stay resident.
+
+    Only pair potentials on a single GPU can read the out of core neighbor list, and it cannot be compressed, sorted by
+    distance, rebuilt partially, or store each pair once.
+*/
+void NeighborListGPU::setOutOfCore(unsigned int chunk_size)
+    {
+    if (chunk_size && !supportsOutOfCore())
+        {
+        m_exec_conf->msg->error() << "nlist: This neighbor list does not support out of core storage" << endl;
+        throw runtime_error("Error setting up the neighbor list");
+        }
+
+    if (chunk_size && !m_ooc_stream[0])
+        {
+        for (unsigned int i = 0; i < 2; ++i)
+            {
+            hipStreamCreateWithFlags(&m_ooc_stream[i], hipStreamNonBlocking);
+            hipEventCreateWithFlags(&m_ooc_ready[i], hipEventDisableTiming);
+            hipEventCreateWithFlags(&m_ooc_done[i], hipEventDisableTiming);
+            }
+        CHECK_CUDA_ERROR();
+        }
+
+    if (!chunk_size && m_h_nlist_ooc)
+        {
+        // the copies of the last build may still be in flight
+        hipDeviceSynchronize();
+        hipHostFree(m_h_nlist_ooc);
+        m_h_nlist_ooc = nullptr;
+        m_h_nlist_ooc_size = 0;
+        m_ooc_offset.clear();
+        m_ooc_partition.clear();
+        }
+
+    if (chunk_size && !m_ooc_chunk_size)
+        {
+        // release the device neighbor list, the staging buffers take its place
+        GlobalArray<unsigned int> nlist(4, m_exec_conf);
+        m_nlist.swap(nlist);
+        TAG_ALLOCATION(m_nlist);
+        }
+
+    m_ooc_chunk_size = chunk_size;
+    m_nlist_on_host = chunk_size > 0;
+    forceUpdate();
+    }
+
+void NeighborListGPU::checkOutOfCore()
+    {
+    if (m_compress || m_sort_by_distance || m_partial_rebuild)
+        {
+        m_exec_conf->msg->error() << "nlist: The out of core neighbor list cannot be compressed, sorted by distance, "
+                                  << "or rebuilt partially" << endl;
+        throw runtime_error("Error building the neighbor list");
+        }
+
+    if (m_storage_mode == half)
+        {
+        m_exec_conf->msg->error() << "nlist: The out of core neighbor list cannot store each pair once" << endl;
+        throw runtime_error("Error building the neighbor list");
+        }
+
+    if (m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        m_exec_conf->msg->error() << "nlist: The out of core neighbor list runs on a single GPU" << endl;
+        throw runtime_error("Error building the neighbor list");
+        }
+    }
+
+/*! Each chunk gets its own head list that starts at zero, and the offsets of the chunks in the host buffer are kept in
+    64 bit integers. The staging buffers are sized to the largest chunk.
+*/
+void NeighborListGPU::buildHeadListOutOfCore()
+    {
+    checkOutOfCore();
+
+    if (m_prof) m_prof->push(m_exec_conf, "head-list");
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_chunks = (N + m_ooc_chunk_size - 1) / m_ooc_chunk_size;
+
+    // the head list of each chunk is computed in 32 bit integers
+        {
+        ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
+        unsigned int Nmax_max = *std::max_element(h_Nmax.data, h_Nmax.data + m_pdata->getNTypes());
+        if (uint64_t(Nmax_max) * m_ooc_chunk_size > UINT_MAX)
+            {
+            m_exec_conf->msg->error() << "nlist: The neighbors of " << m_ooc_chunk_size << " particles exceed the "
+                                      << "capacity of an out of core chunk, reduce the chunk size" << endl;
+            throw runtime_error("Error building the neighbor list");
+            }
+        }
+
+    if (m_ooc_chunk_nlist_size.getNumElements() < n_chunks)
+        {
+        GlobalArray<unsigned int> chunk_nlist_size(n_chunks, m_exec_conf);
+        m_ooc_chunk_nlist_size.swap(chunk_nlist_size);
+        TAG_ALLOCATION(m_ooc_chunk_nlist_size);
+        }
+
+        {
+        ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_chunk_nlist_size(m_ooc_chunk_nlist_size, access_location::device,
+                                                     access_mode::overwrite);
+
+        m_tuner_head_list->begin();
+        for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+            {
+            unsigned int first = chunk*m_ooc_chunk_size;
+            gpu_nlist_build_head_list(d_head_list.data + first,
+                                      d_chunk_nlist_size.data + chunk,
+                                      d_Nmax.data,
+                                      d_pos.data + first,
+                                      std::min(m_ooc_chunk_size, N - first),
+                                      m_pdata->getNTypes(),
+                                      m_tuner_head_list->getParam());
+            }
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_head_list->end();
+        }
+
+    size_t max_chunk_nlist_size = 0;
+    m_ooc_offset.resize(n_chunks + 1);
+    m_ooc_partition.clear();
+        {
+        ArrayHandle<unsigned int> h_chunk_nlist_size(m_ooc_chunk_nlist_size, access_location::host, access_mode::read);
+        m_ooc_offset[0] = 0;
+        for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+            {
+            m_ooc_offset[chunk + 1] = m_ooc_offset[chunk] + h_chunk_nlist_size.data[chunk];
+            max_chunk_nlist_size = std::max(max_chunk_nlist_size, size_t(h_chunk_nlist_size.data[chunk]));
+
+            unsigned int first = chunk*m_ooc_chunk_size;
+            GPUPartition partition(m_exec_conf->getGPUIds());
+            partition.setN(std::min(m_ooc_chunk_size, N - first), first);
+            m_ooc_partition.push_back(partition);
+            }
+        }
+
+    // grow the host buffer with some slack, the copies of the last build must complete before it is freed
+    size_t size = m_ooc_offset[n_chunks];
+    if (size > m_h_nlist_ooc_size)
+        {
+        m_exec_conf->msg->notice(6) << "nlist: (Re-)allocating out of core neighbor list, new size " << size
+                                    << " uints " << endl;
+
+        hipDeviceSynchronize();
+        if (m_h_nlist_ooc)
+            hipHostFree(m_h_nlist_ooc);
+
+        size_t alloc_size = size + size/8;
+        void *ptr = nullptr;
+        if (hipHostMalloc(&ptr, sizeof(unsigned int)*alloc_size, hipHostMallocDefault) != hipSuccess)
+            {
+            m_h_nlist_ooc = nullptr;
+            m_h_nlist_ooc_size = 0;
+            m_exec_conf->msg->error() << "nlist: Unable to allocate " << sizeof(unsigned int)*alloc_size
+                                      << " bytes of pinned host memory for the out of core neighbor list" << endl;
+            throw runtime_error("Error building the neighbor list");
+            }
+        m_h_nlist_ooc = (unsigned int *)ptr;
+        m_h_nlist_ooc_size = alloc_size;
+        }
+
+    if (max_chunk_nlist_size > m_ooc_stage_pitch)
+        {
+        size_t pitch = max_chunk_nlist_size + max_chunk_nlist_size/8;
+        GlobalArray<unsigned int> stage(2*pitch, m_exec_conf);
+        m_ooc_stage.swap(stage);
+        TAG_ALLOCATION(m_ooc_stage);
+        m_ooc_stage_pitch = pitch;
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*! \param build_chunk Builds the neighbor list of the particles in the given partition into the given device buffer,
+                       on the default stream. It must release its handles to the neighbor list arrays before returning.
+
+    The chunks are built into the two staging buffers in turn. Each buffer is copied to the host on its own stream
+    while the next chunk is built into the other buffer, and is only refilled once its copy completed. The exclusions
+    are filtered from each chunk before the copy.
+*/
+void NeighborListGPU::buildOutOfCore(const std::function<void(unsigned int *, const GPUPartition&)>& build_chunk)
+    {
+    if (m_exclusions_set)
+        updateExListIdxIfNeeded();
+
+    ArrayHandle<unsigned int> d_stage(m_ooc_stage, access_location::device, access_mode::overwrite);
+
+    for (unsigned int chunk = 0; chunk < m_ooc_partition.size(); ++chunk)
+        {
+        unsigned int buf = chunk % 2;
+        unsigned int *d_buf = d_stage.data + buf*m_ooc_stage_pitch;
+
+        // wait until the previous chunk in this buffer has reached the host
+        hipStreamWaitEvent(0, m_ooc_done[buf], 0);
+
+        build_chunk(d_buf, m_ooc_partition[chunk]);
+
+        if (m_exclusions_set)
+            {
+            ArrayHandle<unsigned int> d_n_ex_idx(m_n_ex_idx, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_ex_list_idx(m_ex_list_idx, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::readwrite);
+            ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
+
+            auto range = m_ooc_partition[chunk].getRange(0);
+            gpu_nlist_filter(d_n_neigh.data + range.first,
+                             d_buf,
+                             d_head_list.data + range.first,
+                             d_n_ex_idx.data + range.first,
+                             d_ex_list_idx.data + range.first,
+                             m_ex_list_indexer,
+                             range.second - range.first,
+                             m_tuner_filter->getParam());
+            }
+
+        hipEventRecord(m_ooc_ready[buf], 0);
+        hipStreamWaitEvent(m_ooc_stream[buf], m_ooc_ready[buf], 0);
+        hipMemcpyAsync(m_h_nlist_ooc + m_ooc_offset[chunk],
+                       d_buf,
+                       sizeof(unsigned int)*(m_ooc_offset[chunk + 1] - m_ooc_offset[chunk]),
+                       hipMemcpyDeviceToHost,
+                       m_ooc_stream[buf]);
+        hipEventRecord(m_ooc_done[buf], m_ooc_stream[buf]);
+        }
+
+    // later work on the default stream sees the complete list
+    for (unsigned int buf = 0; buf < 2; ++buf)
+        hipStreamWaitEvent(0, m_ooc_done[buf], 0);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+/*! \param f Called for each chunk with the device buffer holding its neighbors, the range of its particles and the
+             stream to launch on. The buffer is indexed with the head list.
+    \param stream Stream that orders the chunks with the caller's work
+
+    The chunks start after the preceding work on \a stream, and the work submitted to \a stream afterwards waits for
+    all chunks. Each of the two staging buffers has its own stream, so the copy of a chunk overlaps the work on the
+    previous chunk.
+*/
+void NeighborListGPU::streamChunks(
+    const std::function<void(const unsigned int *, const GPUPartition&, hipStream_t)>& f,
+    hipStream_t stream)
+    {
+    if (!m_ooc_chunk_size)
+        {
+        m_exec_conf->msg->error() << "nlist: The neighbor list is not stored out of core" << endl;
+        throw runtime_error("Error streaming the neighbor list");
+        }
+
+    ArrayHandle<unsigned int> d_stage(m_ooc_stage, access_location::device, access_mode::overwrite);
+
+    hipEventRecord(m_ooc_ready[0], stream);
+    for (unsigned int buf = 0; buf < 2; ++buf)
+        hipStreamWaitEvent(m_ooc_stream[buf], m_ooc_ready[0], 0);
+
+    for (unsigned int chunk = 0; chunk < m_ooc_partition.size(); ++chunk)
+        {
+        unsigned int buf = chunk % 2;
+        unsigned int *d_buf = d_stage.data + buf*m_ooc_stage_pitch;
+
+        hipMemcpyAsync(d_buf,
+                       m_h_nlist_ooc + m_ooc_offset[chunk],
+                       sizeof(unsigned int)*(m_ooc_offset[chunk + 1] - m_ooc_offset[chunk]),
+                       hipMemcpyHostToDevice,
+                       m_ooc_stream[buf]);
+        f(d_buf, m_ooc_partition[chunk], m_ooc_stream[buf]);
+        }
+
+    for (unsigned int buf = 0; buf < 2; ++buf)
+        {
+        hipEventRecord(m_ooc_done[buf], m_ooc_stream[buf]);
+        hipStreamWaitEvent(stream, m_ooc_done[buf], 0);
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
 void export_NeighborListGPU(py::module& m)
     {
     py::class_<NeighborListGPU, NeighborList, std::shared_ptr<NeighborListGPU> >(m, "NeighborListGPU")
     .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >())
                      .def("benchmarkFilter", &NeighborListGPU::benchmarkFilter)
+                     .def("setOutOfCore", &NeighborListGPU::setOutOfCore)
+                     .def("getOutOfCore", &NeighborListGPU::getOutOfCore)
                      ;
     }
@@ -10,6 +10,7 @@
 */
 
 #include "NeighborListGPU.cuh"
+#include "MDPrecisionSetup.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wconversion"
@@ -27,6 +28,9 @@
     \param ntypes The number of particle types
     \param lambda_min Minimum contraction of deformation tensor
     \param lambda Diagonal deformation tensor (for orthorhombic boundaries)
+    \param scaled True to compare to the last positions mapped through the box deformation
+    \param global_box Current global box
+    \param last_global_box Global box at the time the nlist was last updated
     \param checkn
 
     gpu_nlist_needs_update_check_new_kernel() executes one thread per particle. Every particle's current position is
@@ -43,6 +47,9 @@ __global__ void gpu_nlist_needs_update_check_new_kernel(unsigned int *d_result,
                                                         const unsigned int ntypes,
                                                         const Scalar lambda_min,
                                                         const Scalar3 lambda,
+                                                        const bool scaled,
+                                                        const BoxDim global_box,
+                                                        const BoxDim last_global_box,
                                                         const unsigned int checkn,
                                                         const unsigned int offset)
     {
@@ -81,10 +88,14 @@ __global__ void gpu_nlist_needs_update_check_new_kernel(unsigned int *d_result,
         Scalar4 last_postype = d_last_pos[idx];
         Scalar3 last_pos = make_scalar3(last_postype.x, last_postype.y, last_postype.z);
 
-        Scalar3 dx = cur_pos - lambda*last_pos;
+        Scalar3 dx;
+        if (scaled)
+            dx = cur_pos - global_box.makeCoordinates(last_global_box.makeFraction(last_pos));
+        else
+            dx = cur_pos - lambda*last_pos;
         dx = box.minImage(dx);
 
-        if (dot(dx, dx) >= s_maxshiftsq[cur_type])
+        if (short_length_sq(dx) >= ShortReal(s_maxshiftsq[cur_type]))
             #if (__CUDA_ARCH__ >= 600)
             atomicMax_system(d_result, checkn);
             #else
@@ -103,6 +114,9 @@ hipError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                              const unsigned int ntypes,
                                              const Scalar lambda_min,
                                              const Scalar3 lambda,
+                                             const bool scaled,
+                                             const BoxDim& global_box,
+                                             const BoxDim& last_global_box,
                                              const unsigned int checkn,
                                              const GPUPartition& gpu_partition)
     {
@@ -127,6 +141,9 @@ hipError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                                                                         ntypes,
                                                                                         lambda_min,
                                                                                         lambda,
+                                                                                        scaled,
+                                                                                        global_box,
+                                                                                        last_global_box,
                                                                                         checkn,
                                                                                         range.first);
         }
@@ -453,3 +470,463 @@ hipError_t gpu_nlist_build_head_list(unsigned int *d_head_list,
 
     return hipSuccess;
     }
+
+/*!
+ * \param d_packed_head_list Head list of the packed neighbor list to compute
+ * \param d_req_size_nlist Flag for the total size of the packed neighbor list
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param N the number of particles on this rank
+ *
+ * \return hipSuccess on completion
+ *
+ * The packed head list is the exclusive prefix sum of the number of neighbors.
+ */
+hipError_t gpu_nlist_compress_head_list(unsigned int *d_packed_head_list,
+                                        unsigned int *d_req_size_nlist,
+                                        const unsigned int *d_n_neigh,
+                                        const unsigned int N)
+    {
+    thrust::device_ptr<const unsigned int> t_n_neigh = thrust::device_pointer_cast(d_n_neigh);
+    thrust::device_ptr<unsigned int> t_packed_head_list = thrust::device_pointer_cast(d_packed_head_list);
+    thrust::exclusive_scan(t_n_neigh, t_n_neigh+N, t_packed_head_list);
+
+    // the size is the head of the last particle plus its number of neighbors
+    hipMemcpy(d_req_size_nlist, d_n_neigh + N - 1, sizeof(unsigned int), hipMemcpyDeviceToDevice);
+    hipLaunchKernelGGL((gpu_nlist_get_nlist_size_kernel), dim3(1), dim3(1), 0, 0, d_req_size_nlist, d_packed_head_list, N);
+
+    return hipSuccess;
+    }
+
+//! GPU kernel to copy the neighbors of each particle to a new head address
+/*!
+ * \param d_dst Neighbor list to write
+ * \param d_dst_head_list Head list of \a d_dst
+ * \param d_src Neighbor list to read
+ * \param d_src_head_list Head list of \a d_src
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param N the number of particles on this rank
+ *
+ * One thread copies the neighbors of one particle.
+ */
+__global__ void gpu_nlist_copy_kernel(unsigned int *d_dst,
+                                      const unsigned int *d_dst_head_list,
+                                      const unsigned int *d_src,
+                                      const unsigned int *d_src_head_list,
+                                      const unsigned int *d_n_neigh,
+                                      const unsigned int N)
+    {
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    const unsigned int n_neigh = d_n_neigh[idx];
+    const unsigned int src_head = d_src_head_list[idx];
+    const unsigned int dst_head = d_dst_head_list[idx];
+
+    for (unsigned int k = 0; k < n_neigh; ++k)
+        d_dst[dst_head + k] = d_src[src_head + k];
+    }
+
+/*!
+ * \param d_nlist Neighbor list to pack in place
+ * \param d_packed_nlist Temporary storage for the packed neighbor list
+ * \param d_head_list Head list of \a d_nlist, overwritten with \a d_packed_head_list
+ * \param d_packed_head_list Head list of the packed neighbor list from gpu_nlist_compress_head_list()
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param size Total number of neighbors in the packed neighbor list
+ * \param N the number of particles on this rank
+ * \param block_size Number of threads per block for gpu_nlist_copy_kernel()
+ *
+ * \return hipSuccess on completion
+ *
+ * Particles are copied in parallel, so the neighbors are packed into \a d_packed_nlist first and then copied back to
+ * the front of \a d_nlist.
+ */
+hipError_t gpu_nlist_compress(unsigned int *d_nlist,
+                              unsigned int *d_packed_nlist,
+                              unsigned int *d_head_list,
+                              const unsigned int *d_packed_head_list,
+                              const unsigned int *d_n_neigh,
+                              const size_t size,
+                              const unsigned int N,
+                              const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_nlist_copy_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    hipLaunchKernelGGL((gpu_nlist_copy_kernel), dim3(N/run_block_size + 1), dim3(run_block_size), 0, 0, d_packed_nlist,
+                                                                                         d_packed_head_list,
+                                                                                         d_nlist,
+                                                                                         d_head_list,
+                                                                                         d_n_neigh,
+                                                                                         N);
+
+    hipMemcpy(d_nlist, d_packed_nlist, sizeof(unsigned int)*size, hipMemcpyDeviceToDevice);
+    hipMemcpy(d_head_list, d_packed_head_list, sizeof(unsigned int)*N, hipMemcpyDeviceToDevice);
+
+    return hipSuccess;
+    }
+
+//! GPU kernel to find the new index of each particle in the order of the neighbor list
+/*!
+ * \param d_new_idx New index of each particle
+ * \param d_rtag Current index of each tag
+ * \param d_last_tag Tag of each particle in the order of the neighbor list
+ * \param N the number of particles on this rank
+ */
+__global__ void gpu_nlist_new_idx_kernel(unsigned int *d_new_idx,
+                                         const unsigned int *d_rtag,
+                                         const unsigned int *d_last_tag,
+                                         const unsigned int N)
+    {
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    d_new_idx[idx] = d_rtag[d_last_tag[idx]];
+    }
+
+//! GPU kernel to translate the neighbors of each particle to their new indices
+/*!
+ * \param d_nlist Neighbor list to translate in place
+ * \param d_head_list Head list of \a d_nlist
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param d_new_idx New index of each particle
+ * \param N the number of particles on this rank
+ *
+ * One thread translates the neighbors of one particle.
+ */
+__global__ void gpu_nlist_translate_kernel(unsigned int *d_nlist,
+                                           const unsigned int *d_head_list,
+                                           const unsigned int *d_n_neigh,
+                                           const unsigned int *d_new_idx,
+                                           const unsigned int N)
+    {
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    const unsigned int n_neigh = d_n_neigh[idx];
+    const unsigned int head = d_head_list[idx];
+
+    for (unsigned int k = 0; k < n_neigh; ++k)
+        d_nlist[head + k] = d_new_idx[d_nlist[head + k]];
+    }
+
+//! GPU kernel to scatter per particle values to a new order of the particles
+/*!
+ * \param d_out Values in the new order
+ * \param d_in Values in the order of the neighbor list
+ * \param d_new_idx New index of each particle
+ * \param N the number of particles on this rank
+ */
+template<class T>
+__global__ void gpu_nlist_scatter_kernel(T *d_out,
+                                         const T *d_in,
+                                         const unsigned int *d_new_idx,
+                                         const unsigned int N)
+    {
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    d_out[d_new_idx[idx]] = d_in[idx];
+    }
+
+/*!
+ * \param d_new_idx New index of each particle, written
+ * \param d_nlist Neighbor list to translate in place
+ * \param d_head_list Head list of \a d_nlist
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param d_rtag Current index of each tag
+ * \param d_last_tag Tag of each particle in the order of the neighbor list
+ * \param N the number of particles on this rank
+ * \param block_size Number of threads per block
+ *
+ * \return hipSuccess on completion
+ *
+ * The neighbors of each particle stay in place, only their indices change. The head list and the number of
+ * neighbors still follow the old order, and must be scattered to the new order with gpu_nlist_scatter().
+ */
+hipError_t gpu_nlist_remap(unsigned int *d_new_idx,
+                           unsigned int *d_nlist,
+                           const unsigned int *d_head_list,
+                           const unsigned int *d_n_neigh,
+                           const unsigned int *d_rtag,
+                           const unsigned int *d_last_tag,
+                           const unsigned int N,
+                           const unsigned int block_size)
+    {
+    hipLaunchKernelGGL((gpu_nlist_new_idx_kernel), dim3(N/block_size + 1), dim3(block_size), 0, 0, d_new_idx,
+                                                                                           d_rtag,
+                                                                                           d_last_tag,
+                                                                                           N);
+
+    hipLaunchKernelGGL((gpu_nlist_translate_kernel), dim3(N/block_size + 1), dim3(block_size), 0, 0, d_nlist,
+                                                                                             d_head_list,
+                                                                                             d_n_neigh,
+                                                                                             d_new_idx,
+                                                                                             N);
+
+    return hipSuccess;
+    }
+
+/*!
+ * \param d_out Values in the new order
+ * \param d_in Values in the order of the neighbor list
+ * \param d_new_idx New index of each particle from gpu_nlist_remap()
+ * \param N the number of particles on this rank
+ * \param block_size Number of threads per block
+ *
+ * \return hipSuccess on completion
+ */
+hipError_t gpu_nlist_scatter(unsigned int *d_out,
+                             const unsigned int *d_in,
+                             const unsigned int *d_new_idx,
+                             const unsigned int N,
+                             const unsigned int block_size)
+    {
+    hipLaunchKernelGGL((gpu_nlist_scatter_kernel<unsigned int>), dim3(N/block_size + 1), dim3(block_size), 0, 0,
+                       d_out,
+                       d_in,
+                       d_new_idx,
+                       N);
+
+    return hipSuccess;
+    }
+
+/*!
+ * \param d_out Values in the new order
+ * \param d_in Values in the order of the neighbor list
+ * \param d_new_idx New index of each particle from gpu_nlist_remap()
+ * \param N the number of particles on this rank
+ * \param block_size Number of threads per block
+ *
+ * \return hipSuccess on completion
+ */
+hipError_t gpu_nlist_scatter(Scalar4 *d_out,
+                             const Scalar4 *d_in,
+                             const unsigned int *d_new_idx,
+                             const unsigned int N,
+                             const unsigned int block_size)
+    {
+    hipLaunchKernelGGL((gpu_nlist_scatter_kernel<Scalar4>), dim3(N/block_size + 1), dim3(block_size), 0, 0,
+                       d_out,
+                       d_in,
+                       d_new_idx,
+                       N);
+
+    return hipSuccess;
+    }
+
+//! GPU kernel to sort the neighbors of each particle by distance
+/*!
+ * \param d_nlist Neighbor list to sort in place
+ * \param d_head_list Head list for reading \a d_nlist
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param d_pos Particle positions
+ * \param box Local box
+ * \param N the number of particles on this rank
+ *
+ * One thread sorts the neighbors of one particle with an insertion sort, which needs no temporary storage. The cell
+ * list based builds already produce neighbors that are partially ordered by distance.
+ */
+__global__ void gpu_nlist_sort_by_distance_kernel(unsigned int *d_nlist,
+                                                  const unsigned int *d_head_list,
+                                                  const unsigned int *d_n_neigh,
+                                                  const Scalar4 *d_pos,
+                                                  const BoxDim box,
+                                                  const unsigned int N)
+    {
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    const Scalar4 postype_i = d_pos[idx];
+    const Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
+    const unsigned int head = d_head_list[idx];
+    const unsigned int n_neigh = d_n_neigh[idx];
+
+    for (unsigned int k = 1; k < n_neigh; ++k)
+        {
+        const unsigned int j = d_nlist[head + k];
+        const Scalar4 postype_j = d_pos[j];
+        const Scalar3 dx_j = box.minImage(pos_i - make_scalar3(postype_j.x, postype_j.y, postype_j.z));
+        const Scalar rsq_j = dot(dx_j, dx_j);
+
+        // shift the farther neighbors up
+        unsigned int m = k;
+        while (m > 0)
+            {
+            const unsigned int prev = d_nlist[head + m - 1];
+            const Scalar4 postype_prev = d_pos[prev];
+            const Scalar3 dx_prev = box.minImage(pos_i - make_scalar3(postype_prev.x, postype_prev.y, postype_prev.z));
+            if (dot(dx_prev, dx_prev) <= rsq_j)
+                break;
+
+            d_nlist[head + m] = prev;
+            --m;
+            }
+        d_nlist[head + m] = j;
+        }
+    }
+
+//! GPU kernel to count the sorted neighbors within reach of a consumer
+/*!
+ * \param d_n_neigh_consumer Number of neighbors within reach of the consumer to write
+ * \param d_nlist Neighbor list sorted by distance
+ * \param d_head_list Head list for reading \a d_nlist
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param d_pos Particle positions
+ * \param box Local box
+ * \param d_r_listsq Squared neighbor list cutoff of the consumer by type pair
+ * \param N the number of particles on this rank
+ * \param ntypes Number of particle types
+ */
+__global__ void gpu_nlist_count_consumer_kernel(unsigned int *d_n_neigh_consumer,
+                                                const unsigned int *d_nlist,
+                                                const unsigned int *d_head_list,
+                                                const unsigned int *d_n_neigh,
+                                                const Scalar4 *d_pos,
+                                                const BoxDim box,
+                                                const Scalar *d_r_listsq,
+                                                const unsigned int N,
+                                                const unsigned int ntypes)
+    {
+    // cache the cutoffs into shared memory for faster reads
+    Index2D typpair_idx(ntypes);
+    HIP_DYNAMIC_SHARED( unsigned char, sh)
+    Scalar *s_r_listsq = (Scalar *)(&sh[0]);
+    for (unsigned int cur_offset = 0; cur_offset < typpair_idx.getNumElements(); cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < typpair_idx.getNumElements())
+            {
+            s_r_listsq[cur_offset + threadIdx.x] = d_r_listsq[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    const Scalar4 postype_i = d_pos[idx];
+    const Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
+    const unsigned int type_i = __scalar_as_int(postype_i.w);
+    const unsigned int head = d_head_list[idx];
+
+    unsigned int n_neigh = 0;
+    for (unsigned int k = 0; k < d_n_neigh[idx]; ++k)
+        {
+        const Scalar4 postype_j = d_pos[d_nlist[head + k]];
+        const Scalar3 dx = box.minImage(pos_i - make_scalar3(postype_j.x, postype_j.y, postype_j.z));
+        if (dot(dx, dx) < s_r_listsq[typpair_idx(type_i, __scalar_as_int(postype_j.w))])
+            n_neigh = k + 1;
+        }
+
+    d_n_neigh_consumer[idx] = n_neigh;
+    }
+
+/*!
+ * \param d_nlist Neighbor list to sort in place
+ * \param d_head_list Head list for reading \a d_nlist
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param d_pos Particle positions
+ * \param box Local box
+ * \param N the number of particles on this rank
+ * \param block_size Number of threads per block
+ *
+ * \return hipSuccess on completion
+ */
+hipError_t gpu_nlist_sort_by_distance(unsigned int *d_nlist,
+                                      const unsigned int *d_head_list,
+                                      const unsigned int *d_n_neigh,
+                                      const Scalar4 *d_pos,
+                                      const BoxDim& box,
+                                      const unsigned int N,
+                                      const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_nlist_sort_by_distance_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    hipLaunchKernelGGL((gpu_nlist_sort_by_distance_kernel), dim3(N/run_block_size + 1), dim3(run_block_size), 0, 0,
+                       d_nlist,
+                       d_head_list,
+                       d_n_neigh,
+                       d_pos,
+                       box,
+                       N);
+
+    return hipSuccess;
+    }
+
+/*!
+ * \param d_n_neigh_consumer Number of neighbors within reach of the consumer to write
+ * \param d_nlist Neighbor list sorted by distance
+ * \param d_head_list Head list for reading \a d_nlist
+ * \param d_n_neigh Number of neighbors of each particle
+ * \param d_pos Particle positions
+ * \param box Local box
+ * \param d_r_listsq Squared neighbor list cutoff of the consumer by type pair
+ * \param N the number of particles on this rank
+ * \param ntypes Number of particle types
+ * \param block_size Number of threads per block
+ *
+ * \return hipSuccess on completion
+ */
+hipError_t gpu_nlist_count_consumer(unsigned int *d_n_neigh_consumer,
+                                    const unsigned int *d_nlist,
+                                    const unsigned int *d_head_list,
+                                    const unsigned int *d_n_neigh,
+                                    const Scalar4 *d_pos,
+                                    const BoxDim& box,
+                                    const Scalar *d_r_listsq,
+                                    const unsigned int N,
+                                    const unsigned int ntypes,
+                                    const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_nlist_count_consumer_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    unsigned int shared_bytes = (unsigned int)(ntypes*ntypes*sizeof(Scalar));
+
+    hipLaunchKernelGGL((gpu_nlist_count_consumer_kernel), dim3(N/run_block_size + 1), dim3(run_block_size),
+                       shared_bytes, 0,
+                       d_n_neigh_consumer,
+                       d_nlist,
+                       d_head_list,
+                       d_n_neigh,
+                       d_pos,
+                       box,
+                       d_r_listsq,
+                       N,
+                       ntypes);
+
+    return hipSuccess;
+    }
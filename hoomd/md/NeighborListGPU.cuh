@@ -29,6 +29,9 @@ hipError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                              const unsigned int ntypes,
                                              const Scalar lambda_min,
                                              const Scalar3 lambda,
+                                             const bool scaled,
+                                             const BoxDim& global_box,
+                                             const BoxDim& last_global_box,
                                              const unsigned int checkn,
                                              const GPUPartition& gpu_partition);
 
@@ -51,6 +54,66 @@ hipError_t gpu_nlist_build_head_list(unsigned int *d_head_list,
                                       const unsigned int n_types,
                                       const unsigned int block_size);
 
+//! Kernel driver to compute the head list of the packed neighbor list
+hipError_t gpu_nlist_compress_head_list(unsigned int *d_packed_head_list,
+                                        unsigned int *d_req_size_nlist,
+                                        const unsigned int *d_n_neigh,
+                                        const unsigned int N);
+
+//! Kernel driver to pack the neighbor list with exact counts
+hipError_t gpu_nlist_compress(unsigned int *d_nlist,
+                              unsigned int *d_packed_nlist,
+                              unsigned int *d_head_list,
+                              const unsigned int *d_packed_head_list,
+                              const unsigned int *d_n_neigh,
+                              const size_t size,
+                              const unsigned int N,
+                              const unsigned int block_size);
+
+//! Kernel driver to translate the neighbor list to a new order of the particles
+hipError_t gpu_nlist_remap(unsigned int *d_new_idx,
+                           unsigned int *d_nlist,
+                           const unsigned int *d_head_list,
+                           const unsigned int *d_n_neigh,
+                           const unsigned int *d_rtag,
+                           const unsigned int *d_last_tag,
+                           const unsigned int N,
+                           const unsigned int block_size);
+
+//! Kernel driver to scatter per particle values to a new order of the particles
+hipError_t gpu_nlist_scatter(unsigned int *d_out,
+                             const unsigned int *d_in,
+                             const unsigned int *d_new_idx,
+                             const unsigned int N,
+                             const unsigned int block_size);
+
+//! Kernel driver to scatter per particle values to a new order of the particles
+hipError_t gpu_nlist_scatter(Scalar4 *d_out,
+                             const Scalar4 *d_in,
+                             const unsigned int *d_new_idx,
+                             const unsigned int N,
+                             const unsigned int block_size);
+
+//! Kernel driver to sort the neighbors of each particle by distance
+hipError_t gpu_nlist_sort_by_distance(unsigned int *d_nlist,
+                                      const unsigned int *d_head_list,
+                                      const unsigned int *d_n_neigh,
+                                      const Scalar4 *d_pos,
+                                      const BoxDim& box,
+                                      const unsigned int N,
+                                      const unsigned int block_size);
+
+//! Kernel driver to count the sorted neighbors within reach of a consumer
+hipError_t gpu_nlist_count_consumer(unsigned int *d_n_neigh_consumer,
+                                    const unsigned int *d_nlist,
+                                    const unsigned int *d_head_list,
+                                    const unsigned int *d_n_neigh,
+                                    const Scalar4 *d_pos,
+                                    const BoxDim& box,
+                                    const Scalar *d_r_listsq,
+                                    const unsigned int N,
+                                    const unsigned int ntypes,
+                                    const unsigned int block_size);
 
 //! GPU function to update the exclusion list on the device
 hipError_t gpu_update_exclusion_list(const unsigned int *d_tag,
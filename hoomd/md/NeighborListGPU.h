@@ -9,6 +9,8 @@
 #include "hoomd/GlobalArray.h"
 #include "hoomd/Autotuner.h"
 
+#include <functional>
+
 /*! \file NeighborListGPU.h
     \brief Declares the NeighborListGPU class
 */
@@ -35,7 +37,8 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
     public:
         //! Constructs the compute
         NeighborListGPU(std::shared_ptr<SystemDefinition> sysdef, Scalar r_cut, Scalar r_buff)
-            : NeighborList(sysdef, r_cut, r_buff)
+            : NeighborList(sysdef, r_cut, r_buff), m_ooc_chunk_size(0), m_h_nlist_ooc(nullptr), m_h_nlist_ooc_size(0),
+              m_ooc_stage_pitch(0), m_ooc_stream{0, 0}, m_ooc_ready{0, 0}, m_ooc_done{0, 0}
             {
             m_exec_conf->msg->notice(5) << "Constructing NeighborlistGPU" << std::endl;
 
@@ -77,11 +80,12 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
             unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
             m_tuner_filter.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "nlist_filter", this->m_exec_conf));
             m_tuner_head_list.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "nlist_head_list", this->m_exec_conf));
+            m_tuner_compress.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "nlist_compress", this->m_exec_conf));
+            m_tuner_sort.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "nlist_sort", this->m_exec_conf));
             }
 
         //! Destructor
-        virtual ~NeighborListGPU()
-            { }
+        virtual ~NeighborListGPU();
 
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
@@ -95,6 +99,12 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
 
             m_tuner_head_list->setPeriod(period/10);
             m_tuner_head_list->setEnabled(enable);
+
+            m_tuner_compress->setPeriod(period/10);
+            m_tuner_compress->setEnabled(enable);
+
+            m_tuner_sort->setPeriod(period/10);
+            m_tuner_sort->setEnabled(enable);
             }
 
         //! Benchmark the filter kernel
@@ -103,6 +113,21 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
         //! Update the exclusion list on the GPU
         virtual void updateExListIdx();
 
+        //! Set the number of particles in each chunk of the out of core neighbor list
+        void setOutOfCore(unsigned int chunk_size);
+
+        //! Get the number of particles in each chunk of the out of core neighbor list
+        /*! \returns 0 when the neighbor list is resident in device memory
+        */
+        unsigned int getOutOfCore()
+            {
+            return m_ooc_chunk_size;
+            }
+
+        //! Stream the out of core neighbor list to the device chunk by chunk
+        void streamChunks(const std::function<void(const unsigned int *, const GPUPartition&, hipStream_t)>& f,
+                          hipStream_t stream);
+
     protected:
         GlobalArray<unsigned int> m_flags;   //!< Storage for device flags on the GPU
 
@@ -114,19 +139,41 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
         //! Perform the nlist distance check on the GPU
         virtual bool distanceCheck(uint64_t timestep);
 
-        //! GPU nlists set their last updated pos in the compute kernel, this call only resets the last box length
+        //! GPU nlists set their last updated pos in the compute kernel, this call only resets the last box
         virtual void setLastUpdatedPos()
             {
             m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
             m_last_L_local = m_pdata->getBox().getNearestPlaneDistance();
+            m_last_global_box = m_pdata->getGlobalBox();
             }
 
+        //! Records the tags of the particles in the order of the neighbor list on the GPU
+        virtual void setLastUpdatedTags();
+
+        //! Permute the neighbor list to follow a sort of the particles on the GPU
+        virtual void remapNlist();
+
         //! Filter the neighbor list of excluded particles
         virtual void filterNlist();
 
         //! Build the head list for neighbor list indexing on the GPU
         virtual void buildHeadList();
 
+        //! Pack the neighbor list with exact counts on the GPU
+        virtual void compressNlist();
+
+        //! Sort the neighbors of each particle by distance on the GPU
+        virtual void sortNlist();
+
+        //! Test if buildNlist() supports out of core storage through buildOutOfCore()
+        virtual bool supportsOutOfCore()
+            {
+            return false;
+            }
+
+        //! Build the out of core neighbor list chunk by chunk and copy each chunk to the host
+        void buildOutOfCore(const std::function<void(unsigned int *, const GPUPartition&)>& build_chunk);
+
         //! Schedule the distance check kernel
         /*! \param timestep Current time step
          */
@@ -135,8 +182,31 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
     private:
         std::unique_ptr<Autotuner> m_tuner_filter; //!< Autotuner for filter block size
         std::unique_ptr<Autotuner> m_tuner_head_list; //!< Autotuner for the head list block size
+        std::unique_ptr<Autotuner> m_tuner_compress; //!< Autotuner for the compression block size
+        std::unique_ptr<Autotuner> m_tuner_sort; //!< Autotuner for the sort block size
 
         GlobalArray<unsigned int> m_alt_head_list; //!< Alternate array to hold the head list from prefix sum
+        GlobalArray<unsigned int> m_packed_nlist;  //!< Temporary storage to pack the neighbor list
+        GlobalArray<unsigned int> m_new_idx;       //!< New index of each particle when remapping the neighbor list
+        GlobalArray<Scalar4> m_alt_last_pos;       //!< Temporary storage to remap the last positions
+
+        unsigned int m_ooc_chunk_size;             //!< Particles per out of core chunk, 0 to keep the list resident
+        unsigned int *m_h_nlist_ooc;               //!< Pinned host memory holding the out of core neighbor list
+        size_t m_h_nlist_ooc_size;                 //!< Number of elements allocated in m_h_nlist_ooc
+        std::vector<size_t> m_ooc_offset;          //!< Offset of each chunk in m_h_nlist_ooc, and the total size
+        std::vector<GPUPartition> m_ooc_partition; //!< Particle range of each chunk
+        GlobalArray<unsigned int> m_ooc_chunk_nlist_size; //!< Neighbor list size of each chunk
+        GlobalArray<unsigned int> m_ooc_stage;     //!< Two device buffers for the neighbors of a chunk
+        size_t m_ooc_stage_pitch;                  //!< Number of elements in each buffer of m_ooc_stage
+        hipStream_t m_ooc_stream[2];               //!< Copy and compute stream of each buffer
+        hipEvent_t m_ooc_ready[2];                 //!< Recorded when the contents of a buffer are ready
+        hipEvent_t m_ooc_done[2];                  //!< Recorded when the copy of a buffer completed
+
+        //! Check that the neighbor list options are compatible with out of core storage
+        void checkOutOfCore();
+
+        //! Build the head list of each out of core chunk and size the host and staging buffers
+        void buildHeadListOutOfCore();
     };
 
 //! Exports NeighborListGPU to python
@@ -60,6 +60,12 @@ NeighborListGPUBinned::NeighborListGPUBinned(std::shared_ptr<SystemDefinition> s
         }
 
     m_tuner.reset(new Autotuner(valid_params, 5, 100000, "nlist_binned", this->m_exec_conf));
+    // time the block sizes and threads per particle in alternating sweeps instead of the full matrix
+    m_tuner->setSearch(Autotuner::search_coordinate_descent);
+    #ifdef ENABLE_MPI
+    // synchronize autotuner results across ranks
+    m_tuner->setSync(bool(m_pdata->getDomainDecomposition()));
+    #endif
 
     // cell sizes need update by default
     m_update_cell_size = true;
@@ -71,12 +77,6 @@ NeighborListGPUBinned::~NeighborListGPUBinned()
 
 void NeighborListGPUBinned::buildNlist(uint64_t timestep)
     {
-    if (m_storage_mode != full)
-        {
-        m_exec_conf->msg->error() << "Only full mode nlists can be generated on the GPU" << std::endl;
-        throw std::runtime_error("Error computing neighbor list");
-        }
-
     // update the cell list size if needed
     if (m_update_cell_size)
         {
@@ -93,43 +93,12 @@ void NeighborListGPUBinned::buildNlist(uint64_t timestep)
     if (m_prof)
         m_prof->push(m_exec_conf, "compute");
 
-    // acquire the particle data
-    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
-
-    const BoxDim& box = m_pdata->getBox();
-
-    // access the cell list data arrays
-    ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_cell_xyzf(m_cl->getXYZFArray(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_cell_idx(m_cl->getIndexArray(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_cell_tdb(m_cl->getTDBArray(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
-
-    const ArrayHandle<unsigned int>& d_cell_size_per_device = m_cl->getPerDevice() ?
-        ArrayHandle<unsigned int>(m_cl->getCellSizeArrayPerDevice(),access_location::device, access_mode::read) :
-        ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
-    const ArrayHandle<unsigned int>& d_cell_idx_per_device = m_cl->getPerDevice() ?
-        ArrayHandle<unsigned int>(m_cl->getIndexArrayPerDevice(), access_location::device, access_mode::read) :
-        ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
-
-    ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
-    ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_last_pos(m_last_pos, access_location::device, access_mode::overwrite);
-
-    ArrayHandle<Scalar> d_r_cut(m_r_cut, access_location::device, access_mode::read);
-    ArrayHandle<Scalar> d_r_listsq(m_r_listsq, access_location::device, access_mode::read);
-
     #ifdef __HIP_PLATFORM_NVCC__
-    auto& gpu_map = m_exec_conf->getGPUIds();
-
     // prefetch some cell list arrays
     if (m_exec_conf->allConcurrentManagedAccess())
         {
+        auto& gpu_map = m_exec_conf->getGPUIds();
+        ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
         for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
             {
             // prefetch cell adjacency
@@ -148,36 +117,82 @@ void NeighborListGPUBinned::buildNlist(uint64_t timestep)
     unsigned int block_size = param / 10000;
     unsigned int threads_per_particle = param % 10000;
 
-    gpu_compute_nlist_binned(d_nlist.data,
-                             d_n_neigh.data,
-                             d_last_pos.data,
-                             d_conditions.data,
-                             d_Nmax.data,
-                             d_head_list.data,
-                             d_pos.data,
-                             d_body.data,
-                             d_diameter.data,
-                             m_pdata->getN(),
-                             m_cl->getPerDevice() ? d_cell_size_per_device.data : d_cell_size.data,
-                             d_cell_xyzf.data,
-                             m_cl->getPerDevice() ? d_cell_idx_per_device.data : d_cell_idx.data,
-                             d_cell_tdb.data,
-                             d_cell_adj.data,
-                             m_cl->getCellIndexer(),
-                             m_cl->getCellListIndexer(),
-                             m_cl->getCellAdjIndexer(),
-                             box,
-                             d_r_cut.data,
-                             m_r_buff,
-                             m_pdata->getNTypes(),
-                             threads_per_particle,
-                             block_size,
-                             m_filter_body,
-                             m_diameter_shift,
-                             m_cl->getGhostWidth(),
-                             m_exec_conf->getComputeCapability()/10,
-                             m_pdata->getGPUPartition(),
-                             m_use_index);
+    // builds the list of the particles in gpu_partition into d_nlist
+    auto build = [&](unsigned int *d_nlist, const GPUPartition& gpu_partition)
+        {
+        // acquire the particle data
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+
+        const BoxDim& box = m_pdata->getBox();
+
+        // access the cell list data arrays
+        ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cell_xyzf(m_cl->getXYZFArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_idx(m_cl->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cell_tdb(m_cl->getTDBArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+        const ArrayHandle<unsigned int>& d_cell_size_per_device = m_cl->getPerDevice() ?
+            ArrayHandle<unsigned int>(m_cl->getCellSizeArrayPerDevice(),access_location::device, access_mode::read) :
+            ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+        const ArrayHandle<unsigned int>& d_cell_idx_per_device = m_cl->getPerDevice() ?
+            ArrayHandle<unsigned int>(m_cl->getIndexArrayPerDevice(), access_location::device, access_mode::read) :
+            ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+
+        ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_last_pos(m_last_pos, access_location::device, access_mode::readwrite);
+
+        ArrayHandle<Scalar> d_r_cut(m_r_cut, access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_r_listsq(m_r_listsq, access_location::device, access_mode::read);
+
+        gpu_compute_nlist_binned(d_nlist,
+                                 d_n_neigh.data,
+                                 d_last_pos.data,
+                                 d_conditions.data,
+                                 d_Nmax.data,
+                                 d_head_list.data,
+                                 d_pos.data,
+                                 d_body.data,
+                                 d_diameter.data,
+                                 m_pdata->getN(),
+                                 m_cl->getPerDevice() ? d_cell_size_per_device.data : d_cell_size.data,
+                                 d_cell_xyzf.data,
+                                 m_cl->getPerDevice() ? d_cell_idx_per_device.data : d_cell_idx.data,
+                                 d_cell_tdb.data,
+                                 d_cell_adj.data,
+                                 m_cl->getCellIndexer(),
+                                 m_cl->getCellListIndexer(),
+                                 m_cl->getCellAdjIndexer(),
+                                 box,
+                                 d_r_cut.data,
+                                 m_r_buff,
+                                 m_pdata->getNTypes(),
+                                 threads_per_particle,
+                                 block_size,
+                                 m_filter_body,
+                                 m_diameter_shift,
+                                 m_cl->getGhostWidth(),
+                                 m_exec_conf->getComputeCapability()/10,
+                                 gpu_partition,
+                                 m_use_index,
+                                 m_storage_mode == half);
+        };
+
+    if (getOutOfCore())
+        {
+        // each chunk of particles writes its neighbors into a staging buffer on the device
+        buildOutOfCore(build);
+        }
+    else
+        {
+        ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::overwrite);
+        build(d_nlist.data, m_pdata->getGPUPartition());
+        }
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
     this->m_tuner->end();
@@ -6,6 +6,7 @@
 // Maintainer: joaander
 
 #include "NeighborListGPUBinned.cuh"
+#include "MDPrecisionSetup.h"
 #include "hoomd/TextureTools.h"
 #include "hoomd/WarpTools.cuh"
 
@@ -40,6 +41,8 @@
     \param ghost_width Width of ghost cell layer
     \param offset Starting particle index
     \param nwork Number of particles to process
+    \param ngpu Number of active GPUs
+    \param half True to store each pair only once, as a neighbor of the particle with the smaller index
 
     \note optimized for Kepler
 */
@@ -69,7 +72,8 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
                                                     const Scalar3 ghost_width,
                                                     const unsigned int offset,
                                                     const unsigned int nwork,
-                                                    const unsigned int ngpu)
+                                                    const unsigned int ngpu,
+                                                    const bool half)
     {
     bool filter_body = flags & 1;
     bool diameter_shift = flags & 2;
@@ -232,9 +236,10 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
                 dx = box.minImage(dx);
 
                 // compute dr squared
-                Scalar drsq = dot(dx,dx);
+                ShortReal drsq = short_length_sq(dx);
 
-                bool excluded = (my_pidx == cur_neigh);
+                // a half list only stores the neighbors with larger indices
+                bool excluded = half ? (cur_neigh <= my_pidx) : (my_pidx == cur_neigh);
 
                 if (filter_body && my_body != 0xffffffff)
                     excluded = excluded | (my_body == neigh_body);
@@ -249,7 +254,7 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
                     }
 
                 // store result in shared memory
-                if (drsq <= (r_list*r_list + sqshift) && !excluded)
+                if (drsq <= ShortReal(r_list*r_list + sqshift) && !excluded)
                     {
                     neighbor = cur_neigh;
                     has_neighbor = 1;
@@ -331,7 +336,8 @@ inline void launcher(unsigned int *d_nlist,
               unsigned int block_size,
               std::pair<unsigned int, unsigned int> range,
               bool use_index,
-              const unsigned int ngpu)
+              const unsigned int ngpu,
+              bool half)
     {
     // shared memory = r_listsq + Nmax + stuff needed for neighborlist (computed below)
     Index2D typpair_idx(ntypes);
@@ -378,7 +384,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             else if (!diameter_shift && filter_body)
                 {
@@ -414,7 +421,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             else if (diameter_shift && !filter_body)
                 {
@@ -450,7 +458,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             else if (diameter_shift && filter_body)
                 {
@@ -486,7 +495,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             }
         else // use_index
@@ -525,7 +535,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             else if (!diameter_shift && filter_body)
                 {
@@ -561,7 +572,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             else if (diameter_shift && !filter_body)
                 {
@@ -597,7 +609,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             else if (diameter_shift && filter_body)
                 {
@@ -633,7 +646,8 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              ghost_width,
                                                                                              offset,
                                                                                              nwork,
-                                                                                             ngpu);
+                                                                                             ngpu,
+                                                                                             half);
                 }
             }
         }
@@ -669,7 +683,8 @@ inline void launcher(unsigned int *d_nlist,
                      block_size,
                      range,
                      use_index,
-                     ngpu
+                     ngpu,
+                     half
                      );
         }
     }
@@ -706,7 +721,8 @@ inline void launcher<min_threads_per_particle/2>(unsigned int *d_nlist,
               unsigned int block_size,
               std::pair<unsigned int, unsigned int> range,
               bool use_index,
-              const unsigned int ngpu)
+              const unsigned int ngpu,
+              bool half)
     { }
 
 hipError_t gpu_compute_nlist_binned(unsigned int *d_nlist,
@@ -738,7 +754,8 @@ hipError_t gpu_compute_nlist_binned(unsigned int *d_nlist,
                                      const Scalar3& ghost_width,
                                      const unsigned int compute_capability,
                                      const GPUPartition& gpu_partition,
-                                     bool use_index)
+                                     bool use_index,
+                                     bool half)
     {
     unsigned int ngpu = gpu_partition.getNumActiveGPUs();
 
@@ -777,7 +794,8 @@ hipError_t gpu_compute_nlist_binned(unsigned int *d_nlist,
                                        block_size,
                                        range,
                                        use_index,
-                                       ngpu
+                                       ngpu,
+                                       half
                                        );
         }
     return hipSuccess;
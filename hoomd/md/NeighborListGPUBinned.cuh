@@ -58,5 +58,6 @@ hipError_t gpu_compute_nlist_binned(unsigned int *d_nlist,
                                      const Scalar3& ghost_width,
                                      const unsigned int compute_capability,
                                      const GPUPartition& gpu_partition,
-                                     bool use_index);
+                                     bool use_index,
+                                     bool half);
 #endif
@@ -89,6 +89,12 @@ class PYBIND11_EXPORT NeighborListGPUBinned : public NeighborListGPU
 
         //! Builds the neighbor list
         virtual void buildNlist(uint64_t timestep);
+
+        //! The binned build can write each chunk of the out of core neighbor list separately
+        virtual bool supportsOutOfCore()
+            {
+            return true;
+            }
     };
 
 //! Exports NeighborListGPUBinned to python
@@ -0,0 +1,331 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file NeighborListGPUCluster.cc
+    \brief Defines NeighborListGPUCluster
+*/
+
+#include "NeighborListGPUCluster.h"
+
+namespace py = pybind11;
+
+NeighborListGPUCluster::NeighborListGPUCluster(std::shared_ptr<SystemDefinition> sysdef,
+                                               Scalar r_cut,
+                                               Scalar r_buff,
+                                               std::shared_ptr<CellList> cl)
+    : NeighborListGPU(sysdef, r_cut, r_buff), m_cl(cl), m_n_clusters(0), m_max_cluster_pairs(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListGPUCluster" << std::endl;
+
+    // create a default cell list if one was not specified
+    if (!m_cl)
+        m_cl = std::shared_ptr<CellList>(new CellList(sysdef));
+
+    // the clusters are filled from the particle indices of each cell
+    m_cl->setRadius(1);
+    m_cl->setComputeXYZF(false);
+    m_cl->setComputeTDB(false);
+    m_cl->setComputeIdx(true);
+
+    // the masks of the cluster pairs already leave out the excluded pairs
+    m_exclusions_in_build = true;
+
+    GlobalArray<unsigned int> cluster_conditions(1, m_exec_conf);
+    m_cluster_conditions.swap(cluster_conditions);
+    TAG_ALLOCATION(m_cluster_conditions);
+
+        {
+        ArrayHandle<unsigned int> h_cluster_conditions(m_cluster_conditions, access_location::host,
+                                                       access_mode::overwrite);
+        *h_cluster_conditions.data = 0;
+        }
+
+    // a first guess, grown as needed
+    m_max_cluster_pairs = 32;
+
+    unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
+    m_tuner_pairs.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "nlist_cluster_pairs",
+                                      this->m_exec_conf));
+    }
+
+NeighborListGPUCluster::~NeighborListGPUCluster()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListGPUCluster" << std::endl;
+    }
+
+void NeighborListGPUCluster::buildNlist(uint64_t timestep)
+    {
+    if (m_storage_mode != full)
+        {
+        m_exec_conf->msg->error() << "Only full mode nlists can be generated on the GPU" << std::endl;
+        throw std::runtime_error("Error computing neighbor list");
+        }
+
+    if (m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        m_exec_conf->msg->error() << "The cluster pair neighbor list does not support multiple GPUs" << std::endl;
+        throw std::runtime_error("Error computing neighbor list");
+        }
+
+    // update the cell list size if needed
+    if (m_update_cell_size)
+        {
+        Scalar rmax = getMaxRCut() + m_r_buff;
+        if (m_diameter_shift)
+            rmax += m_d_max - Scalar(1.0);
+
+        m_cl->setNominalWidth(rmax);
+        m_update_cell_size = false;
+        }
+
+    m_cl->compute(timestep);
+
+    if (m_exclusions_set)
+        updateExListIdxIfNeeded();
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "clusters");
+    buildClusters();
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "cluster pairs");
+    while (!buildClusterPairs())
+        {
+        }
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "expand");
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cluster_idx(m_cluster_idx, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cluster_n_pairs(m_cluster_n_pairs, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cluster_pair_j(m_cluster_pair_j, access_location::device, access_mode::read);
+    ArrayHandle<uint2> d_cluster_pair_mask(m_cluster_pair_mask, access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::overwrite);
+    ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_last_pos(m_last_pos, access_location::device, access_mode::overwrite);
+
+    gpu_nlist_cluster_expand(d_nlist.data,
+                             d_n_neigh.data,
+                             d_last_pos.data,
+                             d_conditions.data,
+                             d_Nmax.data,
+                             d_head_list.data,
+                             m_n_clusters,
+                             d_cluster_idx.data,
+                             d_cluster_n_pairs.data,
+                             d_cluster_pair_j.data,
+                             d_cluster_pair_mask.data,
+                             m_max_cluster_pairs,
+                             d_pos.data,
+                             m_pdata->getN(),
+                             256);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+
+/*! The number of clusters follows from the cell sizes, and the cluster arrays are grown when needed.
+*/
+void NeighborListGPUCluster::buildClusters()
+    {
+    const unsigned int ncells = m_cl->getCellIndexer().getNumElements();
+
+    if (m_cell_cluster_start.getNumElements() < ncells + 1)
+        {
+        GlobalArray<unsigned int> cell_cluster_start(ncells + 1, m_exec_conf);
+        m_cell_cluster_start.swap(cell_cluster_start);
+        TAG_ALLOCATION(m_cell_cluster_start);
+        }
+
+        {
+        ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_cluster_start(m_cell_cluster_start, access_location::device,
+                                                       access_mode::overwrite);
+
+        gpu_nlist_cluster_count(d_cell_cluster_start.data,
+                                d_cell_size.data,
+                                ncells,
+                                m_exec_conf->getCachedAllocator());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+        {
+        ArrayHandle<unsigned int> h_cell_cluster_start(m_cell_cluster_start, access_location::host,
+                                                       access_mode::read);
+        m_n_clusters = h_cell_cluster_start.data[ncells];
+        }
+
+    if (m_cluster_cell.getNumElements() < m_n_clusters)
+        {
+        unsigned int n_alloc = m_n_clusters + m_n_clusters/8 + 1;
+
+        GlobalArray<unsigned int> cluster_idx(n_alloc*nlist_cluster_size, m_exec_conf);
+        m_cluster_idx.swap(cluster_idx);
+        TAG_ALLOCATION(m_cluster_idx);
+
+        GlobalArray<unsigned int> cluster_cell(n_alloc, m_exec_conf);
+        m_cluster_cell.swap(cluster_cell);
+        TAG_ALLOCATION(m_cluster_cell);
+
+        GlobalArray<Scalar4> cluster_center(n_alloc, m_exec_conf);
+        m_cluster_center.swap(cluster_center);
+        TAG_ALLOCATION(m_cluster_center);
+
+        GlobalArray<Scalar4> cluster_extent(n_alloc, m_exec_conf);
+        m_cluster_extent.swap(cluster_extent);
+        TAG_ALLOCATION(m_cluster_extent);
+
+        GlobalArray<unsigned int> cluster_n_pairs(n_alloc, m_exec_conf);
+        m_cluster_n_pairs.swap(cluster_n_pairs);
+        TAG_ALLOCATION(m_cluster_n_pairs);
+
+        allocateClusterPairs(m_max_cluster_pairs);
+        }
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_idx(m_cl->getIndexArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_cluster_start(m_cell_cluster_start, access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_cluster_idx(m_cluster_idx, access_location::device, access_mode::overwrite);
+    ArrayHandle<unsigned int> d_cluster_cell(m_cluster_cell, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_cluster_center(m_cluster_center, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_cluster_extent(m_cluster_extent, access_location::device, access_mode::overwrite);
+
+    gpu_nlist_cluster_fill(d_cluster_idx.data,
+                           d_cluster_cell.data,
+                           d_cluster_center.data,
+                           d_cluster_extent.data,
+                           m_n_clusters,
+                           d_cell_cluster_start.data,
+                           d_cell_size.data,
+                           d_cell_idx.data,
+                           m_cl->getCellListIndexer(),
+                           d_pos.data,
+                           ncells,
+                           256);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+/*! \returns true if all cluster pairs fit into the pair arrays
+
+    On overflow, the pair arrays are grown to the required size and the caller repeats the search.
+*/
+bool NeighborListGPUCluster::buildClusterPairs()
+    {
+    Scalar r_list_max = getMaxRCut() + m_r_buff;
+    if (m_diameter_shift)
+        r_list_max += m_d_max - Scalar(1.0);
+
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+
+        ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_cluster_start(m_cell_cluster_start, access_location::device,
+                                                       access_mode::read);
+        ArrayHandle<unsigned int> d_cluster_idx(m_cluster_idx, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cluster_cell(m_cluster_cell, access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cluster_center(m_cluster_center, access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cluster_extent(m_cluster_extent, access_location::device, access_mode::read);
+
+        ArrayHandle<unsigned int> d_n_ex_idx(m_n_ex_idx, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_ex_list_idx(m_ex_list_idx, access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_r_cut(m_r_cut, access_location::device, access_mode::read);
+
+        ArrayHandle<unsigned int> d_cluster_n_pairs(m_cluster_n_pairs, access_location::device,
+                                                    access_mode::overwrite);
+        ArrayHandle<unsigned int> d_cluster_pair_j(m_cluster_pair_j, access_location::device,
+                                                   access_mode::overwrite);
+        ArrayHandle<uint2> d_cluster_pair_mask(m_cluster_pair_mask, access_location::device,
+                                               access_mode::overwrite);
+        ArrayHandle<unsigned int> d_cluster_conditions(m_cluster_conditions, access_location::device,
+                                                       access_mode::readwrite);
+
+        m_tuner_pairs->begin();
+        gpu_nlist_cluster_pairs(d_cluster_n_pairs.data,
+                                d_cluster_pair_j.data,
+                                d_cluster_pair_mask.data,
+                                d_cluster_conditions.data,
+                                m_max_cluster_pairs,
+                                m_n_clusters,
+                                d_cluster_idx.data,
+                                d_cluster_cell.data,
+                                d_cluster_center.data,
+                                d_cluster_extent.data,
+                                d_cell_cluster_start.data,
+                                d_cell_adj.data,
+                                m_cl->getCellAdjIndexer(),
+                                d_pos.data,
+                                d_diameter.data,
+                                d_body.data,
+                                m_exclusions_set ? d_n_ex_idx.data : NULL,
+                                d_ex_list_idx.data,
+                                m_ex_list_indexer,
+                                m_pdata->getN(),
+                                m_pdata->getBox(),
+                                d_r_cut.data,
+                                m_r_buff,
+                                r_list_max,
+                                m_pdata->getNTypes(),
+                                m_filter_body,
+                                m_diameter_shift,
+                                m_tuner_pairs->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_pairs->end();
+        }
+
+    ArrayHandle<unsigned int> h_cluster_conditions(m_cluster_conditions, access_location::host,
+                                                   access_mode::readwrite);
+    if (*h_cluster_conditions.data > m_max_cluster_pairs)
+        {
+        m_exec_conf->msg->notice(6) << "nlist.cluster: (Re-)allocating cluster pairs, max "
+                                    << *h_cluster_conditions.data << std::endl;
+        allocateClusterPairs(*h_cluster_conditions.data);
+        *h_cluster_conditions.data = 0;
+        return false;
+        }
+
+    return true;
+    }
+
+/*! \param max_pairs Maximum number of pairs per cluster
+*/
+void NeighborListGPUCluster::allocateClusterPairs(unsigned int max_pairs)
+    {
+    m_max_cluster_pairs = max_pairs;
+    size_t n_pairs = (size_t)m_cluster_cell.getNumElements()*m_max_cluster_pairs;
+
+    GlobalArray<unsigned int> cluster_pair_j(n_pairs, m_exec_conf);
+    m_cluster_pair_j.swap(cluster_pair_j);
+    TAG_ALLOCATION(m_cluster_pair_j);
+
+    GlobalArray<uint2> cluster_pair_mask(n_pairs, m_exec_conf);
+    m_cluster_pair_mask.swap(cluster_pair_mask);
+    TAG_ALLOCATION(m_cluster_pair_mask);
+    }
+
+void export_NeighborListGPUCluster(py::module& m)
+    {
+    py::class_<NeighborListGPUCluster, NeighborListGPU, std::shared_ptr<NeighborListGPUCluster> >(m,
+        "NeighborListGPUCluster")
+        .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar, std::shared_ptr<CellList> >())
+        .def_property("deterministic", &NeighborListGPUCluster::getDeterministic,
+                      &NeighborListGPUCluster::setDeterministic)
+        ;
+    }
@@ -0,0 +1,613 @@
+#include "hip/hip_runtime.h"
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "NeighborListGPUCluster.cuh"
+
+#include <hipcub/hipcub.hpp>
+
+/*! \file NeighborListGPUCluster.cu
+    \brief Defines GPU kernel code for the cluster pair neighbor list
+*/
+
+//! Kernel that counts the clusters of each cell
+/*! \param d_cluster_count Number of clusters in each cell, one extra element is set to zero
+    \param d_cell_size Number of particles in each cell
+    \param ncells Number of cells
+*/
+__global__ void gpu_nlist_cluster_count_kernel(unsigned int *d_cluster_count,
+                                               const unsigned int *d_cell_size,
+                                               const unsigned int ncells)
+    {
+    unsigned int cell = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (cell > ncells)
+        return;
+
+    d_cluster_count[cell] = (cell < ncells) ?
+        (d_cell_size[cell] + nlist_cluster_size - 1) / nlist_cluster_size : 0;
+    }
+
+/*! \param d_cell_cluster_start First cluster of each cell, with ncells+1 elements
+    \param d_cell_size Number of particles in each cell
+    \param ncells Number of cells
+    \param alloc Caching allocator for temporary storage
+
+    The particles of a cell are split into clusters of nlist_cluster_size. The last element of \a d_cell_cluster_start
+    is set to the total number of clusters.
+*/
+hipError_t gpu_nlist_cluster_count(unsigned int *d_cell_cluster_start,
+                                   const unsigned int *d_cell_size,
+                                   const unsigned int ncells,
+                                   CachedAllocator& alloc)
+    {
+    unsigned int block_size = 256;
+    unsigned int n = ncells + 1;
+
+    unsigned int *d_cluster_count = alloc.getTemporaryBuffer<unsigned int>(n);
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_nlist_cluster_count_kernel), dim3(n/block_size + 1), dim3(block_size), 0, 0,
+        d_cluster_count,
+        d_cell_size,
+        ncells);
+
+    // Determine temporary device storage requirements
+    void *d_temp_storage = NULL;
+    size_t temp_storage_bytes = 0;
+    hipcub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_cluster_count, d_cell_cluster_start, n);
+    d_temp_storage = alloc.allocate(temp_storage_bytes);
+    hipcub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_cluster_count, d_cell_cluster_start, n);
+    alloc.deallocate((char *) d_temp_storage);
+
+    alloc.deallocate((char *) d_cluster_count);
+
+    return hipSuccess;
+    }
+
+//! Kernel that writes the particles of each cell into its clusters
+/*! \param d_cluster_idx Particle indices of each cluster, must be preset to 0xffffffff
+    \param d_cluster_cell Cell of each cluster
+    \param d_cell_cluster_start First cluster of each cell
+    \param d_cell_size Number of particles in each cell
+    \param d_cell_idx Particle indices in the cell list
+    \param cli Cell list indexer
+    \param ncells Number of cells
+
+    One thread handles one entry of the cell list.
+*/
+__global__ void gpu_nlist_cluster_assign_kernel(unsigned int *d_cluster_idx,
+                                                unsigned int *d_cluster_cell,
+                                                const unsigned int *d_cell_cluster_start,
+                                                const unsigned int *d_cell_size,
+                                                const unsigned int *d_cell_idx,
+                                                const Index2D cli,
+                                                const unsigned int ncells)
+    {
+    unsigned int entry = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (entry >= cli.getNumElements())
+        return;
+
+    unsigned int cell = entry / cli.getW();
+    unsigned int offset = entry % cli.getW();
+
+    if (offset >= d_cell_size[cell])
+        return;
+
+    unsigned int cluster = d_cell_cluster_start[cell] + offset / nlist_cluster_size;
+    d_cluster_idx[cluster*nlist_cluster_size + offset % nlist_cluster_size] = d_cell_idx[entry];
+
+    if (offset % nlist_cluster_size == 0)
+        d_cluster_cell[cluster] = cell;
+    }
+
+//! Kernel that computes the axis aligned bounding box of each cluster
+/*! \param d_cluster_center Center of the bounding box of each cluster
+    \param d_cluster_extent Half the edge lengths of the bounding box of each cluster
+    \param d_cluster_idx Particle indices of each cluster
+    \param d_pos Particle positions
+    \param n_clusters Number of clusters
+*/
+__global__ void gpu_nlist_cluster_bounds_kernel(Scalar4 *d_cluster_center,
+                                                Scalar4 *d_cluster_extent,
+                                                const unsigned int *d_cluster_idx,
+                                                const Scalar4 *d_pos,
+                                                const unsigned int n_clusters)
+    {
+    unsigned int cluster = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (cluster >= n_clusters)
+        return;
+
+    // the first particle of a cluster is always present
+    Scalar4 postype = d_pos[d_cluster_idx[cluster*nlist_cluster_size]];
+    Scalar3 lo = make_scalar3(postype.x, postype.y, postype.z);
+    Scalar3 hi = lo;
+
+    for (unsigned int k = 1; k < nlist_cluster_size; ++k)
+        {
+        unsigned int idx = d_cluster_idx[cluster*nlist_cluster_size + k];
+        if (idx == 0xffffffff)
+            break;
+
+        postype = d_pos[idx];
+        lo.x = fmin(lo.x, postype.x); hi.x = fmax(hi.x, postype.x);
+        lo.y = fmin(lo.y, postype.y); hi.y = fmax(hi.y, postype.y);
+        lo.z = fmin(lo.z, postype.z); hi.z = fmax(hi.z, postype.z);
+        }
+
+    d_cluster_center[cluster] = make_scalar4(Scalar(0.5)*(lo.x+hi.x),
+                                             Scalar(0.5)*(lo.y+hi.y),
+                                             Scalar(0.5)*(lo.z+hi.z),
+                                             Scalar(0.0));
+    d_cluster_extent[cluster] = make_scalar4(Scalar(0.5)*(hi.x-lo.x),
+                                             Scalar(0.5)*(hi.y-lo.y),
+                                             Scalar(0.5)*(hi.z-lo.z),
+                                             Scalar(0.0));
+    }
+
+/*! \param d_cluster_idx Particle indices of each cluster (output)
+    \param d_cluster_cell Cell of each cluster (output)
+    \param d_cluster_center Center of the bounding box of each cluster (output)
+    \param d_cluster_extent Half the edge lengths of the bounding box of each cluster (output)
+    \param n_clusters Number of clusters
+    \param d_cell_cluster_start First cluster of each cell
+    \param d_cell_size Number of particles in each cell
+    \param d_cell_idx Particle indices in the cell list
+    \param cli Cell list indexer
+    \param d_pos Particle positions
+    \param ncells Number of cells
+    \param block_size Number of threads per block
+
+    Empty slots of the last cluster of a cell are set to 0xffffffff.
+*/
+hipError_t gpu_nlist_cluster_fill(unsigned int *d_cluster_idx,
+                                  unsigned int *d_cluster_cell,
+                                  Scalar4 *d_cluster_center,
+                                  Scalar4 *d_cluster_extent,
+                                  const unsigned int n_clusters,
+                                  const unsigned int *d_cell_cluster_start,
+                                  const unsigned int *d_cell_size,
+                                  const unsigned int *d_cell_idx,
+                                  const Index2D& cli,
+                                  const Scalar4 *d_pos,
+                                  const unsigned int ncells,
+                                  const unsigned int block_size)
+    {
+    if (n_clusters == 0)
+        return hipSuccess;
+
+    hipMemsetAsync(d_cluster_idx, 0xff, sizeof(unsigned int)*n_clusters*nlist_cluster_size);
+
+    unsigned int n_entries = cli.getNumElements();
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_nlist_cluster_assign_kernel), dim3(n_entries/block_size + 1),
+        dim3(block_size), 0, 0,
+        d_cluster_idx,
+        d_cluster_cell,
+        d_cell_cluster_start,
+        d_cell_size,
+        d_cell_idx,
+        cli,
+        ncells);
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_nlist_cluster_bounds_kernel), dim3(n_clusters/block_size + 1),
+        dim3(block_size), 0, 0,
+        d_cluster_center,
+        d_cluster_extent,
+        d_cluster_idx,
+        d_pos,
+        n_clusters);
+
+    return hipSuccess;
+    }
+
+//! Kernel that finds the interacting cluster pairs of each cluster
+/*! \param d_cluster_n_pairs Number of cluster pairs of each cluster
+    \param d_cluster_pair_j Second cluster of each pair, stored with a stride of \a max_pairs per cluster
+    \param d_cluster_pair_mask Interaction mask of each pair
+    \param d_cluster_conditions Largest number of pairs of any cluster when it exceeds \a max_pairs
+    \param max_pairs Maximum number of pairs per cluster
+    \param n_clusters Number of clusters
+    \param d_cluster_idx Particle indices of each cluster
+    \param d_cluster_cell Cell of each cluster
+    \param d_cluster_center Center of the bounding box of each cluster
+    \param d_cluster_extent Half the edge lengths of the bounding box of each cluster
+    \param d_cell_cluster_start First cluster of each cell
+    \param d_cell_adj Cell adjacency list
+    \param cadji Adjacent cell indexer
+    \param d_pos Particle positions
+    \param d_diameter Particle diameters
+    \param d_body Particle body indices
+    \param d_n_ex_idx Number of exclusions of each particle, NULL without exclusions
+    \param d_ex_list_idx Excluded particles by index
+    \param ex_list_indexer Indexer for \a d_ex_list_idx
+    \param N Number of local particles
+    \param box Simulation box dimensions
+    \param d_r_cut Cutoff radius stored by pair type r_cut(i,j)
+    \param r_buff Buffer width
+    \param r_list_max Largest neighbor list cutoff, including the diameter shift
+    \param ntypes Number of particle types
+    \param filter_body True if particles of the same body are excluded
+    \param diameter_shift True if the cutoff is shifted by the diameters
+
+    Bit a*nlist_cluster_size+b of the mask is set when particle b of the second cluster is a neighbor of particle a of
+    the first cluster. The low word of the mask holds the first four rows. Clusters without local particles have no
+    pairs. The list is full, each pair of clusters is stored for both clusters.
+*/
+__global__ void gpu_nlist_cluster_pairs_kernel(unsigned int *d_cluster_n_pairs,
+                                               unsigned int *d_cluster_pair_j,
+                                               uint2 *d_cluster_pair_mask,
+                                               unsigned int *d_cluster_conditions,
+                                               const unsigned int max_pairs,
+                                               const unsigned int n_clusters,
+                                               const unsigned int *d_cluster_idx,
+                                               const unsigned int *d_cluster_cell,
+                                               const Scalar4 *d_cluster_center,
+                                               const Scalar4 *d_cluster_extent,
+                                               const unsigned int *d_cell_cluster_start,
+                                               const unsigned int *d_cell_adj,
+                                               const Index2D cadji,
+                                               const Scalar4 *d_pos,
+                                               const Scalar *d_diameter,
+                                               const unsigned int *d_body,
+                                               const unsigned int *d_n_ex_idx,
+                                               const unsigned int *d_ex_list_idx,
+                                               const Index2D ex_list_indexer,
+                                               const unsigned int N,
+                                               const BoxDim box,
+                                               const Scalar *d_r_cut,
+                                               const Scalar r_buff,
+                                               const Scalar r_list_max,
+                                               const unsigned int ntypes,
+                                               const bool filter_body,
+                                               const bool diameter_shift)
+    {
+    // cache the r_list parameters into shared memory
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
+
+    HIP_DYNAMIC_SHARED( unsigned char, s_data)
+    Scalar *s_r_list = (Scalar *)(&s_data[0]);
+
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            Scalar r_cut = d_r_cut[cur_offset + threadIdx.x];
+            // force the r_list(i,j) to a skippable value if r_cut(i,j) is skippable
+            s_r_list[cur_offset + threadIdx.x] = (r_cut > Scalar(0.0)) ? r_cut+r_buff : Scalar(-1.0);
+            }
+        }
+    __syncthreads();
+
+    unsigned int cluster_i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (cluster_i >= n_clusters)
+        return;
+
+    // load the particles of this cluster
+    unsigned int idx_i[nlist_cluster_size];
+    Scalar4 postype_i[nlist_cluster_size];
+    bool has_local = false;
+    for (unsigned int a = 0; a < nlist_cluster_size; ++a)
+        {
+        idx_i[a] = d_cluster_idx[cluster_i*nlist_cluster_size + a];
+        if (idx_i[a] != 0xffffffff)
+            {
+            postype_i[a] = d_pos[idx_i[a]];
+            has_local |= idx_i[a] < N;
+            }
+        }
+
+    // forces are never computed for ghost particles
+    unsigned int n_pairs = 0;
+    if (has_local)
+        {
+        Scalar4 center_i = d_cluster_center[cluster_i];
+        Scalar4 extent_i = d_cluster_extent[cluster_i];
+        unsigned int my_cell = d_cluster_cell[cluster_i];
+
+        for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); ++cur_adj)
+            {
+            unsigned int neigh_cell = d_cell_adj[cadji(cur_adj, my_cell)];
+            unsigned int first = d_cell_cluster_start[neigh_cell];
+            unsigned int last = d_cell_cluster_start[neigh_cell+1];
+
+            for (unsigned int cluster_j = first; cluster_j < last; ++cluster_j)
+                {
+                // skip clusters whose bounding boxes are too far apart
+                Scalar4 center_j = d_cluster_center[cluster_j];
+                Scalar4 extent_j = d_cluster_extent[cluster_j];
+                Scalar3 dc = box.minImage(make_scalar3(center_i.x - center_j.x,
+                                                       center_i.y - center_j.y,
+                                                       center_i.z - center_j.z));
+                Scalar3 gap = make_scalar3(fmax(fabs(dc.x) - extent_i.x - extent_j.x, Scalar(0.0)),
+                                           fmax(fabs(dc.y) - extent_i.y - extent_j.y, Scalar(0.0)),
+                                           fmax(fabs(dc.z) - extent_i.z - extent_j.z, Scalar(0.0)));
+                if (dot(gap, gap) > r_list_max*r_list_max)
+                    continue;
+
+                // test all particle pairs of the two clusters
+                uint2 mask = make_uint2(0, 0);
+                for (unsigned int b = 0; b < nlist_cluster_size; ++b)
+                    {
+                    unsigned int idx_j = d_cluster_idx[cluster_j*nlist_cluster_size + b];
+                    if (idx_j == 0xffffffff)
+                        break;
+
+                    Scalar4 postype_j = d_pos[idx_j];
+                    unsigned int type_j = __scalar_as_int(postype_j.w);
+                    Scalar diam_j = diameter_shift ? d_diameter[idx_j] : Scalar(0.0);
+                    unsigned int body_j = filter_body ? d_body[idx_j] : 0xffffffff;
+
+                    for (unsigned int a = 0; a < nlist_cluster_size; ++a)
+                        {
+                        // rows of ghost particles are never read
+                        if (idx_i[a] >= N || idx_i[a] == idx_j)
+                            continue;
+
+                        Scalar r_list = s_r_list[typpair_idx(__scalar_as_int(postype_i[a].w), type_j)];
+                        if (r_list <= Scalar(0.0))
+                            continue;
+
+                        if (filter_body && body_j != 0xffffffff && d_body[idx_i[a]] == body_j)
+                            continue;
+
+                        Scalar3 dx = box.minImage(make_scalar3(postype_i[a].x - postype_j.x,
+                                                               postype_i[a].y - postype_j.y,
+                                                               postype_i[a].z - postype_j.z));
+                        Scalar sqshift = Scalar(0.0);
+                        if (diameter_shift)
+                            {
+                            const Scalar delta = (d_diameter[idx_i[a]] + diam_j) * Scalar(0.5) - Scalar(1.0);
+                            sqshift = (delta + Scalar(2.0) * r_list) * delta;
+                            }
+
+                        if (dot(dx, dx) > r_list*r_list + sqshift)
+                            continue;
+
+                        bool excluded = false;
+                        if (d_n_ex_idx)
+                            {
+                            unsigned int n_ex = d_n_ex_idx[idx_i[a]];
+                            for (unsigned int k = 0; k < n_ex; ++k)
+                                excluded |= d_ex_list_idx[ex_list_indexer(idx_i[a], k)] == idx_j;
+                            }
+                        if (excluded)
+                            continue;
+
+                        unsigned int bit = a*nlist_cluster_size + b;
+                        if (bit < 32)
+                            mask.x |= 1u << bit;
+                        else
+                            mask.y |= 1u << (bit - 32);
+                        }
+                    }
+
+                if (mask.x || mask.y)
+                    {
+                    if (n_pairs < max_pairs)
+                        {
+                        d_cluster_pair_j[cluster_i*max_pairs + n_pairs] = cluster_j;
+                        d_cluster_pair_mask[cluster_i*max_pairs + n_pairs] = mask;
+                        }
+                    n_pairs++;
+                    }
+                }
+            }
+        }
+
+    // flag if we need to grow the list
+    if (n_pairs > max_pairs)
+        atomicMax(d_cluster_conditions, n_pairs);
+
+    d_cluster_n_pairs[cluster_i] = n_pairs;
+    }
+
+/*! \param d_cluster_n_pairs Number of cluster pairs of each cluster (output)
+    \param d_cluster_pair_j Second cluster of each pair (output)
+    \param d_cluster_pair_mask Interaction mask of each pair (output)
+    \param d_cluster_conditions Overflow condition (output)
+    \param block_size Number of threads per block
+
+    The remaining parameters are documented in gpu_nlist_cluster_pairs_kernel().
+*/
+hipError_t gpu_nlist_cluster_pairs(unsigned int *d_cluster_n_pairs,
+                                   unsigned int *d_cluster_pair_j,
+                                   uint2 *d_cluster_pair_mask,
+                                   unsigned int *d_cluster_conditions,
+                                   const unsigned int max_pairs,
+                                   const unsigned int n_clusters,
+                                   const unsigned int *d_cluster_idx,
+                                   const unsigned int *d_cluster_cell,
+                                   const Scalar4 *d_cluster_center,
+                                   const Scalar4 *d_cluster_extent,
+                                   const unsigned int *d_cell_cluster_start,
+                                   const unsigned int *d_cell_adj,
+                                   const Index2D& cadji,
+                                   const Scalar4 *d_pos,
+                                   const Scalar *d_diameter,
+                                   const unsigned int *d_body,
+                                   const unsigned int *d_n_ex_idx,
+                                   const unsigned int *d_ex_list_idx,
+                                   const Index2D& ex_list_indexer,
+                                   const unsigned int N,
+                                   const BoxDim& box,
+                                   const Scalar *d_r_cut,
+                                   const Scalar r_buff,
+                                   const Scalar r_list_max,
+                                   const unsigned int ntypes,
+                                   bool filter_body,
+                                   bool diameter_shift,
+                                   const unsigned int block_size)
+    {
+    if (n_clusters == 0)
+        return hipSuccess;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void*)gpu_nlist_cluster_pairs_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    unsigned int shared_size = (unsigned int)(sizeof(Scalar)*Index2D(ntypes).getNumElements());
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_nlist_cluster_pairs_kernel), dim3(n_clusters/run_block_size + 1),
+        dim3(run_block_size), shared_size, 0,
+        d_cluster_n_pairs,
+        d_cluster_pair_j,
+        d_cluster_pair_mask,
+        d_cluster_conditions,
+        max_pairs,
+        n_clusters,
+        d_cluster_idx,
+        d_cluster_cell,
+        d_cluster_center,
+        d_cluster_extent,
+        d_cell_cluster_start,
+        d_cell_adj,
+        cadji,
+        d_pos,
+        d_diameter,
+        d_body,
+        d_n_ex_idx,
+        d_ex_list_idx,
+        ex_list_indexer,
+        N,
+        box,
+        d_r_cut,
+        r_buff,
+        r_list_max,
+        ntypes,
+        filter_body,
+        diameter_shift);
+
+    return hipSuccess;
+    }
+
+//! Kernel that writes the neighbors of each particle from the cluster pairs
+/*! \param d_nlist Neighbor list data structure to write
+    \param d_n_neigh Number of neighbors to write
+    \param d_last_updated_pos Particle positions at this update are written to this array
+    \param d_conditions Conditions array for writing overflow condition
+    \param d_Nmax Maximum number of neighbors per type
+    \param d_head_list List of indexes to access \a d_nlist
+    \param n_clusters Number of clusters
+    \param d_cluster_idx Particle indices of each cluster
+    \param d_cluster_n_pairs Number of cluster pairs of each cluster
+    \param d_cluster_pair_j Second cluster of each pair
+    \param d_cluster_pair_mask Interaction mask of each pair
+    \param max_pairs Maximum number of pairs per cluster
+    \param d_pos Particle positions
+    \param N Number of local particles
+
+    One thread handles one particle slot of a cluster.
+*/
+__global__ void gpu_nlist_cluster_expand_kernel(unsigned int *d_nlist,
+                                                unsigned int *d_n_neigh,
+                                                Scalar4 *d_last_updated_pos,
+                                                unsigned int *d_conditions,
+                                                const unsigned int *d_Nmax,
+                                                const unsigned int *d_head_list,
+                                                const unsigned int n_clusters,
+                                                const unsigned int *d_cluster_idx,
+                                                const unsigned int *d_cluster_n_pairs,
+                                                const unsigned int *d_cluster_pair_j,
+                                                const uint2 *d_cluster_pair_mask,
+                                                const unsigned int max_pairs,
+                                                const Scalar4 *d_pos,
+                                                const unsigned int N)
+    {
+    unsigned int slot = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (slot >= n_clusters*nlist_cluster_size)
+        return;
+
+    unsigned int my_pidx = d_cluster_idx[slot];
+    if (my_pidx >= N)
+        return;
+
+    unsigned int cluster_i = slot / nlist_cluster_size;
+    unsigned int a = slot % nlist_cluster_size;
+    unsigned int shift = (a % (32/nlist_cluster_size)) * nlist_cluster_size;
+
+    Scalar4 my_postype = d_pos[my_pidx];
+    unsigned int my_type = __scalar_as_int(my_postype.w);
+    unsigned int my_head = d_head_list[my_pidx];
+    unsigned int Nmax = d_Nmax[my_type];
+
+    unsigned int nneigh = 0;
+    unsigned int n_pairs = min(d_cluster_n_pairs[cluster_i], max_pairs);
+    for (unsigned int p = 0; p < n_pairs; ++p)
+        {
+        uint2 mask = d_cluster_pair_mask[cluster_i*max_pairs + p];
+        unsigned int row = (((a < 32/nlist_cluster_size) ? mask.x : mask.y) >> shift) & ((1u << nlist_cluster_size) - 1);
+        if (!row)
+            continue;
+
+        unsigned int cluster_j = d_cluster_pair_j[cluster_i*max_pairs + p];
+        while (row)
+            {
+            unsigned int b = __ffs(row) - 1;
+            row &= row - 1;
+
+            if (nneigh < Nmax)
+                d_nlist[my_head + nneigh] = d_cluster_idx[cluster_j*nlist_cluster_size + b];
+            nneigh++;
+            }
+        }
+
+    // flag if we need to grow the neighbor list
+    if (nneigh >= Nmax)
+        atomicMax(&d_conditions[my_type], nneigh);
+
+    d_n_neigh[my_pidx] = nneigh;
+    d_last_updated_pos[my_pidx] = my_postype;
+    }
+
+/*! \param block_size Number of threads per block
+
+    The remaining parameters are documented in gpu_nlist_cluster_expand_kernel().
+*/
+hipError_t gpu_nlist_cluster_expand(unsigned int *d_nlist,
+                                    unsigned int *d_n_neigh,
+                                    Scalar4 *d_last_updated_pos,
+                                    unsigned int *d_conditions,
+                                    const unsigned int *d_Nmax,
+                                    const unsigned int *d_head_list,
+                                    const unsigned int n_clusters,
+                                    const unsigned int *d_cluster_idx,
+                                    const unsigned int *d_cluster_n_pairs,
+                                    const unsigned int *d_cluster_pair_j,
+                                    const uint2 *d_cluster_pair_mask,
+                                    const unsigned int max_pairs,
+                                    const Scalar4 *d_pos,
+                                    const unsigned int N,
+                                    const unsigned int block_size)
+    {
+    unsigned int n_slots = n_clusters*nlist_cluster_size;
+    if (n_slots == 0)
+        return hipSuccess;
+
+    hipLaunchKernelGGL(HIP_KERNEL_NAME(gpu_nlist_cluster_expand_kernel), dim3(n_slots/block_size + 1),
+        dim3(block_size), 0, 0,
+        d_nlist,
+        d_n_neigh,
+        d_last_updated_pos,
+        d_conditions,
+        d_Nmax,
+        d_head_list,
+        n_clusters,
+        d_cluster_idx,
+        d_cluster_n_pairs,
+        d_cluster_pair_j,
+        d_cluster_pair_mask,
+        max_pairs,
+        d_pos,
+        N);
+
+    return hipSuccess;
+    }
@@ -0,0 +1,88 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __NEIGHBORLISTGPUCLUSTER_CUH__
+#define __NEIGHBORLISTGPUCLUSTER_CUH__
+
+#include <hip/hip_runtime.h>
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/CachedAllocator.h"
+
+/*! \file NeighborListGPUCluster.cuh
+    \brief Declares GPU kernel code for the cluster pair neighbor list
+*/
+
+//! Number of particles in a cluster
+const unsigned int nlist_cluster_size = 8;
+
+//! Kernel driver to group the particles of each cell into clusters
+hipError_t gpu_nlist_cluster_count(unsigned int *d_cell_cluster_start,
+                                   const unsigned int *d_cell_size,
+                                   const unsigned int ncells,
+                                   CachedAllocator& alloc);
+
+//! Kernel driver to fill the clusters and their bounding boxes
+hipError_t gpu_nlist_cluster_fill(unsigned int *d_cluster_idx,
+                                  unsigned int *d_cluster_cell,
+                                  Scalar4 *d_cluster_center,
+                                  Scalar4 *d_cluster_extent,
+                                  const unsigned int n_clusters,
+                                  const unsigned int *d_cell_cluster_start,
+                                  const unsigned int *d_cell_size,
+                                  const unsigned int *d_cell_idx,
+                                  const Index2D& cli,
+                                  const Scalar4 *d_pos,
+                                  const unsigned int ncells,
+                                  const unsigned int block_size);
+
+//! Kernel driver to find the interacting cluster pairs
+hipError_t gpu_nlist_cluster_pairs(unsigned int *d_cluster_n_pairs,
+                                   unsigned int *d_cluster_pair_j,
+                                   uint2 *d_cluster_pair_mask,
+                                   unsigned int *d_cluster_conditions,
+                                   const unsigned int max_pairs,
+                                   const unsigned int n_clusters,
+                                   const unsigned int *d_cluster_idx,
+                                   const unsigned int *d_cluster_cell,
+                                   const Scalar4 *d_cluster_center,
+                                   const Scalar4 *d_cluster_extent,
+                                   const unsigned int *d_cell_cluster_start,
+                                   const unsigned int *d_cell_adj,
+                                   const Index2D& cadji,
+                                   const Scalar4 *d_pos,
+                                   const Scalar *d_diameter,
+                                   const unsigned int *d_body,
+                                   const unsigned int *d_n_ex_idx,
+                                   const unsigned int *d_ex_list_idx,
+                                   const Index2D& ex_list_indexer,
+                                   const unsigned int N,
+                                   const BoxDim& box,
+                                   const Scalar *d_r_cut,
+                                   const Scalar r_buff,
+                                   const Scalar r_list_max,
+                                   const unsigned int ntypes,
+                                   bool filter_body,
+                                   bool diameter_shift,
+                                   const unsigned int block_size);
+
+//! Kernel driver to expand the cluster pairs into the neighbor list of each particle
+hipError_t gpu_nlist_cluster_expand(unsigned int *d_nlist,
+                                    unsigned int *d_n_neigh,
+                                    Scalar4 *d_last_updated_pos,
+                                    unsigned int *d_conditions,
+                                    const unsigned int *d_Nmax,
+                                    const unsigned int *d_head_list,
+                                    const unsigned int n_clusters,
+                                    const unsigned int *d_cluster_idx,
+                                    const unsigned int *d_cluster_n_pairs,
+                                    const unsigned int *d_cluster_pair_j,
+                                    const uint2 *d_cluster_pair_mask,
+                                    const unsigned int max_pairs,
+                                    const Scalar4 *d_pos,
+                                    const unsigned int N,
+                                    const unsigned int block_size);
+
+#endif
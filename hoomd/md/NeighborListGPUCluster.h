@@ -0,0 +1,152 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "NeighborListGPU.h"
+#include "NeighborListGPUCluster.cuh"
+#include "hoomd/CellList.h"
+#include "hoomd/Autotuner.h"
+
+/*! \file NeighborListGPUCluster.h
+    \brief Declares the NeighborListGPUCluster class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+#ifndef __NEIGHBORLISTGPUCLUSTER_H__
+#define __NEIGHBORLISTGPUCLUSTER_H__
+
+//! Cluster pair neighbor list build on the GPU
+/*! The particles of each cell of a cell list are grouped into clusters of nlist_cluster_size particles. The list
+    stores, for every cluster with local particles, the clusters within the neighbor list cutoff together with a mask
+    of nlist_cluster_size x nlist_cluster_size bits that marks the neighboring particle pairs. Pair potentials that
+    support it (see PotentialPairGPU) evaluate the forces tile by tile from the cluster pairs, which loads one index
+    per cluster pair instead of one per neighbor.
+
+    The cluster pairs are also expanded into the per particle neighbor list, so that every other consumer of the
+    neighbor list can attach to it unchanged. Exclusions, body filtering and diameter shifting are applied to the
+    masks during the build.
+
+    The cluster list is only available on a single GPU.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT NeighborListGPUCluster : public NeighborListGPU
+    {
+    public:
+        //! Constructs the compute
+        NeighborListGPUCluster(std::shared_ptr<SystemDefinition> sysdef,
+                               Scalar r_cut,
+                               Scalar r_buff,
+                               std::shared_ptr<CellList> cl = std::shared_ptr<CellList>());
+
+        //! Destructor
+        virtual ~NeighborListGPUCluster();
+
+        /// Notify NeighborList that a r_cut matrix value has changed
+        virtual void notifyRCutMatrixChange()
+            {
+            m_update_cell_size = true;
+            NeighborListGPU::notifyRCutMatrixChange();
+            }
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            NeighborListGPU::setAutotunerParams(enable, period);
+            m_tuner_pairs->setPeriod(period/10);
+            m_tuner_pairs->setEnabled(enable);
+            }
+
+        /// Make the neighborlist deterministic
+        void setDeterministic(bool deterministic)
+            {
+            m_cl->setSortCellList(deterministic);
+            }
+
+        /// Get the deterministic flag
+        bool getDeterministic()
+            {
+            return m_cl->getSortCellList();
+            }
+
+        //! Get the number of clusters
+        unsigned int getNumClusters() const
+            {
+            return m_n_clusters;
+            }
+
+        //! Get the maximum number of cluster pairs per cluster, the stride of the pair arrays
+        unsigned int getMaxClusterPairs() const
+            {
+            return m_max_cluster_pairs;
+            }
+
+        //! Get the particle indices of each cluster, 0xffffffff marks an empty slot
+        const GlobalArray<unsigned int>& getClusterIndexArray() const
+            {
+            return m_cluster_idx;
+            }
+
+        //! Get the number of cluster pairs of each cluster
+        const GlobalArray<unsigned int>& getClusterNPairsArray() const
+            {
+            return m_cluster_n_pairs;
+            }
+
+        //! Get the second cluster of each cluster pair
+        const GlobalArray<unsigned int>& getClusterPairArray() const
+            {
+            return m_cluster_pair_j;
+            }
+
+        //! Get the interaction mask of each cluster pair
+        const GlobalArray<uint2>& getClusterMaskArray() const
+            {
+            return m_cluster_pair_mask;
+            }
+
+    protected:
+        std::shared_ptr<CellList> m_cl;     //!< The cell list
+
+        /// Track when the cell size needs to be updated
+        bool m_update_cell_size = true;
+
+        unsigned int m_n_clusters;          //!< Number of clusters
+        unsigned int m_max_cluster_pairs;   //!< Maximum number of cluster pairs per cluster
+
+        GlobalArray<unsigned int> m_cell_cluster_start; //!< First cluster of each cell
+        GlobalArray<unsigned int> m_cluster_idx;        //!< Particle indices of each cluster
+        GlobalArray<unsigned int> m_cluster_cell;       //!< Cell of each cluster
+        GlobalArray<Scalar4> m_cluster_center;          //!< Center of the bounding box of each cluster
+        GlobalArray<Scalar4> m_cluster_extent;          //!< Half the edge lengths of the bounding box of each cluster
+        GlobalArray<unsigned int> m_cluster_n_pairs;    //!< Number of cluster pairs of each cluster
+        GlobalArray<unsigned int> m_cluster_pair_j;     //!< Second cluster of each pair
+        GlobalArray<uint2> m_cluster_pair_mask;         //!< Interaction mask of each pair
+        GlobalArray<unsigned int> m_cluster_conditions; //!< Largest number of pairs on overflow
+
+        std::unique_ptr<Autotuner> m_tuner_pairs;   //!< Autotuner for the block size of the cluster pair search
+
+        //! Builds the neighbor list
+        virtual void buildNlist(uint64_t timestep);
+
+        //! Groups the particles into clusters
+        void buildClusters();
+
+        //! Finds the cluster pairs, returns false if the pair arrays overflowed
+        bool buildClusterPairs();
+
+        //! Resize the pair arrays to hold \a max_pairs pairs per cluster
+        void allocateClusterPairs(unsigned int max_pairs);
+    };
+
+//! Exports NeighborListGPUCluster to python
+void export_NeighborListGPUCluster(pybind11::module& m);
+
+#endif
@@ -6,6 +6,7 @@
 // Maintainer: mphoward
 
 #include "NeighborListGPUStencil.cuh"
+#include "MDPrecisionSetup.h"
 #include "hoomd/TextureTools.h"
 #include "hoomd/WarpTools.cuh"
 #include <hipcub/hipcub.hpp>
@@ -239,9 +240,9 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
                 Scalar3 dx = my_pos - neigh_pos;
                 dx = box.minImage(dx);
 
-                Scalar dr_sq = dot(dx,dx);
+                ShortReal dr_sq = short_length_sq(dx);
 
-                if (dr_sq <= r_listsq)
+                if (dr_sq <= ShortReal(r_listsq))
                     {
                     neighbor = cur_neigh;
                     has_neighbor = 1;
@@ -27,12 +27,14 @@ NeighborListGPUTree::NeighborListGPUTree(std::shared_ptr<SystemDefinition> sysde
                                        Scalar r_buff)
     : NeighborListGPU(sysdef, r_cut, r_buff), m_type_bits(1), m_lbvh_errors(m_exec_conf),
       m_n_images(0),
+      m_refit(false), m_refit_threshold(1.5), m_needs_build(true),
       m_type_changed(true), m_box_changed(true), m_max_num_changed(true), m_max_types(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing NeighborListGPUTree" << std::endl;
     m_pdata->getNumTypesChangeSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotNumTypesChanged>(this);
     m_pdata->getBoxChangeSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotBoxChanged>(this);
     m_pdata->getMaxParticleNumberChangeSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotMaxNumChanged>(this);
+    m_pdata->getParticleSortSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotParticleSort>(this);
 
     hipDeviceProp_t dev_prop = m_exec_conf->dev_prop;
     unsigned int warp_size = dev_prop.warpSize;
@@ -40,6 +42,7 @@ NeighborListGPUTree::NeighborListGPUTree(std::shared_ptr<SystemDefinition> sysde
     m_mark_tuner.reset(new Autotuner(warp_size, max_threads, warp_size, 5, 100000, "nlist_tree_mark", m_exec_conf));
     m_count_tuner.reset(new Autotuner(warp_size, max_threads, warp_size, 5, 100000, "nlist_tree_count", m_exec_conf));
     m_copy_tuner.reset(new Autotuner(warp_size, max_threads, warp_size, 5, 100000, "nlist_tree_copy", m_exec_conf));
+    m_refit_tuner.reset(new Autotuner(warp_size, max_threads, warp_size, 5, 100000, "nlist_tree_refit", m_exec_conf));
     }
 
 /*!
@@ -51,6 +54,7 @@ NeighborListGPUTree::~NeighborListGPUTree()
     m_pdata->getNumTypesChangeSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotNumTypesChanged>(this);
     m_pdata->getBoxChangeSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotBoxChanged>(this);
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotMaxNumChanged>(this);
+    m_pdata->getParticleSortSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotParticleSort>(this);
 
     // destroy all of the created streams
     for (auto stream=m_streams.begin(); stream != m_streams.end(); ++stream)
@@ -104,6 +108,11 @@ void NeighborListGPUTree::buildNlist(uint64_t timestep)
             GPUArray<unsigned int> type_last(m_pdata->getNTypes(), m_exec_conf);
             m_type_last.swap(type_last);
 
+            GPUArray<float> lbvh_cost(m_pdata->getNTypes(), m_exec_conf);
+            m_lbvh_cost.swap(lbvh_cost);
+            m_lbvh_first.resize(m_pdata->getNTypes(), NeighborListTypeSentinel);
+            m_build_cost.resize(m_pdata->getNTypes(), 0.0f);
+
             m_lbvhs.resize(m_pdata->getNTypes());
             m_traversers.resize(m_pdata->getNTypes());
             m_streams.resize(m_pdata->getNTypes());
@@ -181,6 +190,8 @@ void NeighborListGPUTree::buildNlist(uint64_t timestep)
  * double buffer. (It must report which buffer holds the sorted data.) However, benchmarks showed that
  * using the CUB API that should be non-blocking had significantly worse performance.
  *
+ * When refitting is enabled, refitTree() is tried first, and the LBVHs are only built when it fails.
+ *
  * I also note that the use of autotuners in neighbor should break concurrency, since these CUDA timing
  * events are placed in the default stream. This might be reconsidered in future if HOOMD makes more use
  * of CUDA streams anywhere.
@@ -300,7 +311,9 @@ void NeighborListGPUTree::buildTree()
         m_count_tuner->end();
         }
 
-    // build a lbvh for each type
+    // refit the lbvhs if possible, otherwise build a lbvh for each type
+    const bool refit = refitTree();
+    if (!refit)
         {
         ArrayHandle<unsigned int> h_type_first(m_type_first, access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_type_last(m_type_last, access_location::host, access_mode::read);
@@ -358,6 +371,20 @@ void NeighborListGPUTree::buildTree()
         m_build_tuner->end();
         // wait for all builds to finish
         hipDeviceSynchronize();
+
+        // save the reference for subsequent refits
+        if (m_refit)
+            {
+            for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+                {
+                m_lbvh_first[i] = h_type_first.data[i];
+                }
+
+            computeTreeCost();
+            ArrayHandle<float> h_lbvh_cost(m_lbvh_cost, access_location::host, access_mode::read);
+            std::copy(h_lbvh_cost.data, h_lbvh_cost.data + m_pdata->getNTypes(), m_build_cost.begin());
+            }
+        m_needs_build = false;
         }
 
     // put particles in primitive order for traversal and compress the lbvhs so that the data is ready for traversal
@@ -395,6 +422,99 @@ void NeighborListGPUTree::buildTree()
         }
     }
 
+/*!
+ * \returns True if the LBVHs were refit, and false if they need to be built.
+ *
+ * Refitting updates the bounding boxes of the LBVHs from the last build to the current particle positions
+ * while keeping their hierarchy, which is much cheaper than a build. This requires the same particles in the
+ * same order in each LBVH, so refitting is not possible after the particles are sorted, when the number of
+ * particles of a type changes, or in MPI simulations because the ghosts are exchanged when the neighbor list is
+ * updated. The refit is also rejected if the cost of any LBVH has grown by more than the refit threshold since
+ * it was built, since the boxes overlap more as the particles move and traversal gets slower.
+ */
+bool NeighborListGPUTree::refitTree()
+    {
+    if (!m_refit || m_needs_build)
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
+
+        {
+        ArrayHandle<unsigned int> h_type_first(m_type_first, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_type_last(m_type_last, access_location::host, access_mode::read);
+
+        // each lbvh must hold the same range of sorted particles as when it was built
+        for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+            {
+            const unsigned int first = h_type_first.data[i];
+            const unsigned int Ni = (first != NeighborListTypeSentinel) ? h_type_last.data[i] - first : 0;
+            if (Ni != m_lbvhs[i]->getN() || (Ni > 0 && first != m_lbvh_first[i]))
+                return false;
+            }
+
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_sorted_indexes(m_sorted_indexes, access_location::device, access_mode::read);
+
+        // the lbvhs of each type use a disjoint range of locks
+        ScopedAllocation<unsigned int> d_locks(m_exec_conf->getCachedAllocator(),
+                                               m_pdata->getN() + m_pdata->getNGhosts());
+
+        hipDeviceSynchronize();
+        m_refit_tuner->begin();
+        const unsigned int block_size = m_refit_tuner->getParam();
+        for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+            {
+            const unsigned int Ni = m_lbvhs[i]->getN();
+            if (Ni == 0) continue;
+
+            const unsigned int first = h_type_first.data[i];
+            m_lbvhs[i]->refit(d_pos.data,
+                              d_sorted_indexes.data + first,
+                              Ni,
+                              d_locks() + first,
+                              m_streams[i],
+                              block_size);
+            }
+        m_refit_tuner->end();
+        // wait for all refits to finish
+        hipDeviceSynchronize();
+        }
+
+    // reject the refit if any lbvh has gotten too expensive to traverse
+    computeTreeCost();
+    ArrayHandle<float> h_lbvh_cost(m_lbvh_cost, access_location::host, access_mode::read);
+    for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+        {
+        if (h_lbvh_cost.data[i] > m_refit_threshold*m_build_cost[i])
+            return false;
+        }
+
+    return true;
+    }
+
+/*!
+ * The cost of each LBVH is the surface area heuristic, which sums the surface areas of its internal nodes
+ * relative to the surface area of its root. An empty LBVH or one with a single particle has zero cost.
+ */
+void NeighborListGPUTree::computeTreeCost()
+    {
+        {
+        ArrayHandle<float> d_lbvh_cost(m_lbvh_cost, access_location::device, access_mode::overwrite);
+        hipMemset(d_lbvh_cost.data, 0, sizeof(float)*m_pdata->getNTypes());
+
+        // this is a small kernel that runs once per build or refit, so it is not tuned
+        for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+            {
+            m_lbvhs[i]->computeCost(d_lbvh_cost.data + i, m_streams[i], 256);
+            }
+        if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+        }
+    hipDeviceSynchronize();
+    }
+
 /*!
  * Traversal is performed for each particle type against all LBVHs. This is done using one CUDA stream for
  * each particle type, and traversal of each LBVH is loaded into the stream so that there are no race conditions.
@@ -559,5 +679,7 @@ void NeighborListGPUTree::updateImageVectors()
 void export_NeighborListGPUTree(py::module& m)
     {
     py::class_<NeighborListGPUTree, NeighborListGPU, std::shared_ptr<NeighborListGPUTree> >(m, "NeighborListGPUTree")
-    .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >());
+    .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >())
+    .def_property("refit", &NeighborListGPUTree::getRefit, &NeighborListGPUTree::setRefit)
+    .def_property("refit_threshold", &NeighborListGPUTree::getRefitThreshold, &NeighborListGPUTree::setRefitThreshold);
     }
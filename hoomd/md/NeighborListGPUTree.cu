@@ -5,6 +5,7 @@
 
 #include "hip/hip_runtime.h"
 #include "NeighborListGPUTree.cuh"
+#include "MDPrecisionSetup.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wconversion"
@@ -420,6 +421,98 @@ struct PointMapInsertOp
     const unsigned int N;
     };
 
+//! Kernel to refit the bounding boxes of an LBVH
+/*!
+ * \param tree LBVH data to refit.
+ * \param insert Insert operation for the points in the LBVH.
+ * \param d_locks One lock per internal node, initialized to zero.
+ * \param N Number of primitives in the LBVH.
+ *
+ * The LBVH stores its N-1 internal nodes first, followed by its N leaves. Using one thread per leaf, the
+ * bounding box of each leaf is updated from the current position of its primitive. The threads then walk up
+ * the hierarchy toward the root. The first thread to reach an internal node stops, while the second thread
+ * merges the boxes of both children, so each internal node is processed exactly once after its children.
+ */
+__global__ void gpu_nlist_refit_lbvh_kernel(const neighbor::LBVHData tree,
+                                            const PointMapInsertOp insert,
+                                            unsigned int *d_locks,
+                                            const unsigned int N)
+    {
+    // one thread per leaf
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+    if (idx >= N)
+        return;
+
+    // refit the leaf to its primitive
+    int node = idx + N - 1;
+    const neighbor::BoundingBox leaf = insert.get(tree.primitive[idx]);
+    tree.lo[node] = leaf.lo;
+    tree.hi[node] = leaf.hi;
+
+    // a single leaf is the root
+    if (node == tree.root)
+        return;
+
+    // then bubble up the boxes to the root
+    do
+        {
+        node = tree.parent[node];
+
+        // make sure the child box is visible, then let the first thread to arrive quit
+        __threadfence();
+        if (atomicAdd(d_locks + node, 1) == 0)
+            return;
+
+        const int left = tree.left[node];
+        const int right = tree.right[node];
+        const float3 left_lo = tree.lo[left];
+        const float3 left_hi = tree.hi[left];
+        const float3 right_lo = tree.lo[right];
+        const float3 right_hi = tree.hi[right];
+
+        tree.lo[node] = make_float3(fminf(left_lo.x, right_lo.x),
+                                    fminf(left_lo.y, right_lo.y),
+                                    fminf(left_lo.z, right_lo.z));
+        tree.hi[node] = make_float3(fmaxf(left_hi.x, right_hi.x),
+                                    fmaxf(left_hi.y, right_hi.y),
+                                    fmaxf(left_hi.z, right_hi.z));
+        }
+    while (node != tree.root);
+    }
+
+//! Surface area of a bounding box
+DEVICE float lbvh_box_area(const float3& lo, const float3& hi)
+    {
+    const float3 L = make_float3(hi.x-lo.x, hi.y-lo.y, hi.z-lo.z);
+    return 2.0f*(L.x*L.y + L.y*L.z + L.z*L.x);
+    }
+
+//! Kernel to compute the surface area cost of an LBVH
+/*!
+ * \param d_cost Accumulated cost of the LBVH.
+ * \param tree LBVH data.
+ * \param N Number of primitives in the LBVH.
+ *
+ * Using one thread per internal node, the surface area of each node relative to the surface area of
+ * the root is summed into \a d_cost. This is the surface area heuristic for the cost of traversing the LBVH,
+ * up to constant factors. It grows as refitting the LBVH makes its boxes overlap more.
+ */
+__global__ void gpu_nlist_lbvh_cost_kernel(float *d_cost,
+                                           const neighbor::LBVHData tree,
+                                           const unsigned int N)
+    {
+    // one thread per internal node
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+    if (idx >= N-1)
+        return;
+
+    const float root_area = lbvh_box_area(tree.lo[tree.root], tree.hi[tree.root]);
+    if (root_area > 0.0f)
+        {
+        atomicAdd(d_cost, lbvh_box_area(tree.lo[idx], tree.hi[idx])/root_area);
+        }
+    }
+
 //! Neighbor list particle query operation.
 /*!
  * \tparam use_body If true, use the body fields during query.
@@ -583,10 +676,10 @@ struct ParticleQueryOp
 
             // compute distance and wrap back into box
             const Scalar3 dr = box.minImage(r - q.position);
-            const Scalar drsq = dot(dr,dr);
+            const ShortReal drsq = short_length_sq(dr);
 
             // exclude if outside the sphere
-            exclude |= drsq > rc2;
+            exclude |= drsq > ShortReal(rc2);
             }
 
         return !exclude;
@@ -844,6 +937,79 @@ void LBVHWrapper::build(const Scalar4* points,
     lbvh_->build(neighbor::LBVH::LaunchParameters(block_size,stream), insert, lof, hif);
     }
 
+/*!
+ * \param points Particle positions
+ * \param map Mapping of particles for insertion
+ * \param N Number of particles
+ * \param d_locks Temporary storage for at least N-1 locks
+ * \param stream CUDA stream for execution
+ * \param block_size CUDA block size for execution
+ *
+ * The hierarchy of the LBVH is kept from the last build, so the same primitives must be
+ * given in the same order by \a map as for that build.
+ *
+ * \sa gpu_nlist_refit_lbvh_kernel
+ */
+void LBVHWrapper::refit(const Scalar4* points,
+                        const unsigned int* map,
+                        unsigned int N,
+                        unsigned int* d_locks,
+                        hipStream_t stream,
+                        unsigned int block_size)
+    {
+    if (N == 0) return;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(gpu_nlist_refit_lbvh_kernel));
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    if (N > 1)
+        {
+        hipMemsetAsync(d_locks, 0, sizeof(unsigned int)*(N-1), stream);
+        }
+
+    PointMapInsertOp insert(points, map, N);
+    int run_block_size = min(block_size,max_block_size);
+    hipLaunchKernelGGL(gpu_nlist_refit_lbvh_kernel, dim3(N/run_block_size + 1), dim3(run_block_size), 0, stream,
+                       lbvh_->data(),
+                       insert,
+                       d_locks,
+                       N);
+    }
+
+/*!
+ * \param d_cost Cost of the LBVH, which is added to the current value
+ * \param stream CUDA stream for execution
+ * \param block_size CUDA block size for execution
+ *
+ * \sa gpu_nlist_lbvh_cost_kernel
+ */
+void LBVHWrapper::computeCost(float* d_cost,
+                              hipStream_t stream,
+                              unsigned int block_size)
+    {
+    const unsigned int N = lbvh_->getN();
+    if (N <= 1) return;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, reinterpret_cast<const void*>(gpu_nlist_lbvh_cost_kernel));
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    int run_block_size = min(block_size,max_block_size);
+    hipLaunchKernelGGL(gpu_nlist_lbvh_cost_kernel, dim3((N-1)/run_block_size + 1), dim3(run_block_size), 0, stream,
+                       d_cost,
+                       lbvh_->data(),
+                       N);
+    }
+
 unsigned int LBVHWrapper::getN() const
     {
     return lbvh_->getN();
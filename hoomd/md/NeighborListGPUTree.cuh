@@ -90,6 +90,19 @@ class LBVHWrapper
                    hipStream_t stream,
                    unsigned int block_size);
 
+        //! Refit the bounding boxes of the LBVH without changing its hierarchy
+        void refit(const Scalar4* points,
+                   const unsigned int* map,
+                   unsigned int N,
+                   unsigned int* d_locks,
+                   hipStream_t stream,
+                   unsigned int block_size);
+
+        //! Accumulate the surface area cost of the LBVH
+        void computeCost(float* d_cost,
+                         hipStream_t stream,
+                         unsigned int block_size);
+
         //! Get the underlying LBVH
         std::shared_ptr<neighbor::LBVH> get()
             {
@@ -65,6 +65,9 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
             m_copy_tuner->setPeriod(period/10);
             m_copy_tuner->setEnabled(enable);
 
+            m_refit_tuner->setPeriod(period/10);
+            m_refit_tuner->setEnabled(enable);
+
             /* These may be null pointers if the first compute has not occurred, since construction of these tuners
                is deferred until the first neighbor list build (in order to get the tuner parameters from the
                LBVHWrapper and LBVHTraverserWrapper). When initialized, the period and enabled must be borrowed
@@ -83,6 +86,36 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
                 }
             }
 
+        //! Set whether the LBVHs are refit instead of rebuilt when possible
+        void setRefit(bool refit)
+            {
+            m_refit = refit;
+            m_needs_build = true;
+            }
+
+        //! Get whether the LBVHs are refit instead of rebuilt when possible
+        bool getRefit() const
+            {
+            return m_refit;
+            }
+
+        //! Set the growth of the LBVH cost that triggers a full rebuild
+        void setRefitThreshold(Scalar threshold)
+            {
+            if (threshold < Scalar(1.0))
+                {
+                m_exec_conf->msg->error() << "nlist.tree(): Refit threshold must be at least 1" << std::endl;
+                throw std::runtime_error("Error setting refit threshold");
+                }
+            m_refit_threshold = threshold;
+            }
+
+        //! Get the growth of the LBVH cost that triggers a full rebuild
+        Scalar getRefitThreshold() const
+            {
+            return m_refit_threshold;
+            }
+
     protected:
         //! Builds the neighbor list
         virtual void buildNlist(uint64_t timestep);
@@ -91,6 +124,7 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
         std::unique_ptr<Autotuner> m_mark_tuner;    //!< Tuner for the type mark kernel
         std::unique_ptr<Autotuner> m_count_tuner;   //!< Tuner for the type-count kernel
         std::unique_ptr<Autotuner> m_copy_tuner;    //!< Tuner for the primitive-copy kernel
+        std::unique_ptr<Autotuner> m_refit_tuner;   //!< Tuner for LBVH refits
         std::unique_ptr<Autotuner> m_build_tuner;   //!< Tuner for LBVH builds
         std::unique_ptr<Autotuner> m_traverse_tuner;//!< Tuner for LBVH traversers
 
@@ -112,9 +146,22 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
         unsigned int m_n_images;            //!< Number of translation vectors for traversal
         GPUArray<unsigned int> m_traverse_order;    //!< Order to traverse primitives
 
+        bool m_refit;                               //!< If true, refit the LBVHs when possible
+        Scalar m_refit_threshold;                   //!< Relative growth of the LBVH cost that triggers a rebuild
+        bool m_needs_build;                         //!< Flag if the LBVHs must be fully rebuilt
+        std::vector<unsigned int> m_lbvh_first;     //!< First sorted index in each LBVH at the last build
+        std::vector<float> m_build_cost;            //!< Cost of each LBVH at the last build
+        GPUArray<float> m_lbvh_cost;                //!< Current cost of each LBVH
+
         //! Build the LBVHs using the neighbor library
         void buildTree();
 
+        //! Try to refit the LBVHs from the last build
+        bool refitTree();
+
+        //! Compute the cost of each LBVH into m_lbvh_cost
+        void computeTreeCost();
+
         //! Traverse the LBVHs using the neighbor library
         void traverseTree();
 
@@ -153,12 +200,20 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
         void slotMaxNumChanged()
             {
             m_max_num_changed = true;
+            m_needs_build = true;
             }
 
         //! Notification of a change in the number of types
         void slotNumTypesChanged()
             {
             m_type_changed = true;
+            m_needs_build = true;
+            }
+
+        //! Notification of a particle sort
+        void slotParticleSort()
+            {
+            m_needs_build = true;
             }
 
         bool m_type_changed;        //!< Flag if types changed
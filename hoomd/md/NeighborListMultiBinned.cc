@@ -0,0 +1,387 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file NeighborListMultiBinned.cc
+    \brief Defines NeighborListMultiBinned
+*/
+
+#include "NeighborListMultiBinned.h"
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
+using namespace std;
+namespace py = pybind11;
+
+/*!
+ * \param sysdef System definition
+ * \param r_cut Default cutoff radius
+ * \param r_buff Neighbor list buffer width
+ */
+NeighborListMultiBinned::NeighborListMultiBinned(std::shared_ptr<SystemDefinition> sysdef,
+                                                 Scalar r_cut,
+                                                 Scalar r_buff)
+    : NeighborList(sysdef, r_cut, r_buff), m_needs_restencil(true)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListMultiBinned" << endl;
+
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "nlist: NeighborListMultiBinned is not supported on the GPU" << endl;
+        throw std::runtime_error("Error initializing NeighborListMultiBinned");
+        }
+
+    initializeCellLists();
+
+    m_exclusions_in_build = true;
+    }
+
+NeighborListMultiBinned::~NeighborListMultiBinned()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListMultiBinned" << endl;
+    }
+
+void NeighborListMultiBinned::initializeCellLists()
+    {
+    m_cl.clear();
+    m_cls.clear();
+    for (unsigned int cur_type = 0; cur_type < m_pdata->getNTypes(); ++cur_type)
+        {
+        std::shared_ptr<CellList> cl(new CellList(m_sysdef));
+        cl->setRadius(1);
+        cl->setComputeTDB(true);
+        cl->setFlagIndex();
+        cl->setComputeAdjList(false);
+        cl->setTypeFilter(std::vector<unsigned int>(1, cur_type));
+        if (m_prof)
+            cl->setProfiler(m_prof);
+
+        m_cl.push_back(cl);
+        m_cls.push_back(std::shared_ptr<CellListStencil>(new CellListStencil(m_sysdef, cl)));
+        }
+    m_needs_restencil = true;
+    }
+
+/*! \param type_i Type of the particle that searches
+    \param type_j Type of the particle that is searched for
+    \returns The list radius of the pair, or a negative value if the pair does not interact
+*/
+Scalar NeighborListMultiBinned::getRList(unsigned int type_i, unsigned int type_j)
+    {
+    ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
+    Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i, type_j)];
+    if (r_cut <= Scalar(0.0))
+        return Scalar(-1.0);
+
+    Scalar r_list = r_cut + m_r_buff;
+    if (m_diameter_shift)
+        r_list += m_d_max - Scalar(1.0);
+    return r_list;
+    }
+
+/*! The grid of type \a b is sized by the smallest list radius over the pairs (\a a, \a b), which is the pair
+    that searches that grid with the fewest cells. The stencil of type \a a into the grid of \a b covers the list
+    radius of the pair (\a a, \a b).
+*/
+void NeighborListMultiBinned::updateRStencil()
+    {
+    const unsigned int ntypes = m_pdata->getNTypes();
+    for (unsigned int type_j = 0; type_j < ntypes; ++type_j)
+        {
+        std::vector<Scalar> rstencil(ntypes, -1.0);
+        Scalar width = Scalar(-1.0);
+        for (unsigned int type_i = 0; type_i < ntypes; ++type_i)
+            {
+            Scalar r_list = getRList(type_i, type_j);
+            rstencil[type_i] = r_list;
+            if (r_list > Scalar(0.0) && (width < Scalar(0.0) || r_list < width))
+                width = r_list;
+            }
+
+        // a type that is never searched keeps its previous width, its cell list is not computed
+        if (width > Scalar(0.0))
+            m_cl[type_j]->setNominalWidth(width);
+        m_cls[type_j]->setRStencil(rstencil);
+        }
+    }
+
+void NeighborListMultiBinned::buildNlist(uint64_t timestep)
+    {
+    if (m_cl.size() != m_pdata->getNTypes())
+        initializeCellLists();
+
+    if (m_needs_restencil)
+        {
+        updateRStencil();
+        m_needs_restencil = false;
+        }
+
+    // compute the grids that are searched by any type before the particle data is acquired
+    const unsigned int ntypes = m_pdata->getNTypes();
+    std::vector<bool> searched(ntypes, false);
+    for (unsigned int type_j = 0; type_j < ntypes; ++type_j)
+        {
+        for (unsigned int type_i = 0; type_i < ntypes; ++type_i)
+            searched[type_j] = searched[type_j] || (getRList(type_i, type_j) > Scalar(0.0));
+
+        if (searched[type_j])
+            {
+            m_cl[type_j]->compute(timestep);
+            m_cls[type_j]->compute(timestep);
+            }
+        }
+
+    // acquire the particle data and box dimension
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+    Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
+
+    // validate that the cutoff fits inside the box
+    Scalar rmax = getMaxRCut() + m_r_buff;
+    if (m_diameter_shift)
+        rmax += m_d_max - Scalar(1.0);
+
+    if (m_filter_body)
+        {
+        // add the maximum diameter of all composite particles
+        Scalar max_d_comp = m_pdata->getMaxCompositeParticleDiameter();
+        rmax += 0.5*max_d_comp;
+        }
+
+    // get periodic flags
+    uchar3 periodic = box.getPeriodic();
+
+    if ((periodic.x && nearest_plane_distance.x <= rmax * 2.0) ||
+        (periodic.y && nearest_plane_distance.y <= rmax * 2.0) ||
+        (this->m_sysdef->getNDimensions() == 3 && periodic.z && nearest_plane_distance.z <= rmax * 2.0))
+        {
+        std::ostringstream oss;
+        oss << "nlist: Simulation box is too small! Particles would be interacting with themselves."
+            << "rmax=" << rmax << std::endl;
+
+        if (box.getPeriodic().x)
+            oss << "nearest_plane_distance.x=" << nearest_plane_distance.x << std::endl;
+        if (box.getPeriodic().y)
+            oss << "nearest_plane_distance.y=" << nearest_plane_distance.y << std::endl;
+        if (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z)
+            oss << "nearest_plane_distance.z=" << nearest_plane_distance.z << std::endl;
+        throw std::runtime_error(oss.str());
+        }
+
+    // access the rlist data
+    ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
+
+    // access the neighbor list data
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_conditions(m_conditions, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
+
+    // the neighbors found in each grid are appended to the ones found in the previous grids
+    unsigned int nparticles = m_pdata->getN();
+    memset(h_n_neigh.data, 0, sizeof(unsigned int)*nparticles);
+
+    for (unsigned int type_j = 0; type_j < ntypes; ++type_j)
+        {
+        if (!searched[type_j])
+            continue;
+
+        std::shared_ptr<CellList> cl = m_cl[type_j];
+        std::shared_ptr<CellListStencil> cls = m_cls[type_j];
+
+        if (m_prof)
+            m_prof->push(m_exec_conf, "compute");
+
+        uint3 dim = cl->getDim();
+        Scalar3 ghost_width = cl->getGhostWidth();
+
+        // access the cell list data arrays
+        ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_cell_xyzf(cl->getXYZFArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_cell_tdb(cl->getTDBArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_stencil(cls->getStencils(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_stencil(cls->getStencilSizes(), access_location::host, access_mode::read);
+        const Index2D& stencil_idx = cls->getStencilIndexer();
+
+        // access indexers
+        Index3D ci = cl->getCellIndexer();
+        Index2D cli = cl->getCellListIndexer();
+
+        #ifdef ENABLE_TBB
+        // each thread records its own overflow conditions, which are merged after the loop
+        tbb::enumerable_thread_specific< std::vector<unsigned int> > thread_conditions(ntypes, 0);
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+        unsigned int *conditions = thread_conditions.local().data();
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+        #else
+        unsigned int *conditions = h_conditions.data;
+        for (unsigned int i = 0; i < nparticles; i++)
+        #endif
+            {
+            const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
+
+            unsigned int n_stencil = h_n_stencil.data[type_i];
+            if (n_stencil == 0)
+                continue;
+
+            unsigned int cur_n_neigh = h_n_neigh.data[i];
+
+            const Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            const unsigned int body_i = h_body.data[i];
+            const Scalar diam_i = h_diameter.data[i];
+
+            const unsigned int Nmax_i = h_Nmax.data[type_i];
+            const unsigned int head_idx_i = h_head_list.data[i];
+
+            ExclusionRange ex_i = {NULL, NULL};
+            if (m_exclusions_set)
+                ex_i = getSortedExclusions(h_tag.data[i]);
+
+            // the cutoff is the same for all particles in this grid
+            Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i, type_j)];
+            Scalar r_list = r_cut + m_r_buff;
+
+            // find the bin of the particle in this grid
+            Scalar3 f = box.makeFraction(my_pos,ghost_width);
+            int ib = (unsigned int)(f.x * dim.x);
+            int jb = (unsigned int)(f.y * dim.y);
+            int kb = (unsigned int)(f.z * dim.z);
+
+            // need to handle the case where the particle is exactly at the box hi
+            if (ib == (int)dim.x && periodic.x)
+                ib = 0;
+            if (jb == (int)dim.y && periodic.y)
+                jb = 0;
+            if (kb == (int)dim.z && periodic.z)
+                kb = 0;
+
+            // loop through all neighboring bins
+            for (unsigned int cur_stencil = 0; cur_stencil < n_stencil; ++cur_stencil)
+                {
+                // compute the stenciled cell cartesian coordinates
+                Scalar4 stencil = h_stencil.data[stencil_idx(cur_stencil, type_i)];
+                int sib = ib + __scalar_as_int(stencil.x);
+                int sjb = jb + __scalar_as_int(stencil.y);
+                int skb = kb + __scalar_as_int(stencil.z);
+                Scalar cell_dist2 = stencil.w;
+
+                // wrap through the boundary
+                if (periodic.x)
+                    {
+                    if (sib >= (int)dim.x) sib -= dim.x;
+                    else if (sib < 0) sib += dim.x;
+                    }
+                else if (sib < 0 || sib >= (int)dim.x)
+                    {
+                    continue;
+                    }
+
+                if (periodic.y)
+                    {
+                    if (sjb >= (int)dim.y) sjb -= dim.y;
+                    else if (sjb < 0) sjb += dim.y;
+                    }
+                else if (sjb < 0 || sjb >= (int)dim.y)
+                    {
+                    continue;
+                    }
+
+                if (periodic.z)
+                    {
+                    if (skb >= (int)dim.z) skb -= dim.z;
+                    else if (skb < 0) skb += dim.z;
+                    }
+                else if (skb < 0 || skb >= (int)dim.z)
+                    {
+                    continue;
+                    }
+
+                unsigned int neigh_cell = ci(sib, sjb, skb);
+
+                // check against all the particles in that neighboring bin to see if it is a neighbor
+                unsigned int size = h_cell_size.data[neigh_cell];
+                for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                    {
+                    const Scalar4& neigh_tdb = h_cell_tdb.data[cli(cur_offset, neigh_cell)];
+                    const Scalar diam_j = neigh_tdb.y;
+                    const unsigned int body_j = __scalar_as_int(neigh_tdb.z);
+
+                    // skip any particles belonging to the same body if requested
+                    if (m_filter_body && body_i != NO_BODY && body_i == body_j) continue;
+
+                    Scalar sqshift = Scalar(0.0);
+                    if (m_diameter_shift)
+                        {
+                        const Scalar delta = (diam_i + diam_j) * Scalar(0.5) - Scalar(1.0);
+                        // r^2 < (r_list + delta)^2
+                        // r^2 < r_listsq + delta^2 + 2*r_list*delta
+                        sqshift = (delta + Scalar(2.0) * r_list) * delta;
+                        }
+                    Scalar r_listsq = r_list*r_list + sqshift;
+
+                    // compare the check distance to the minimum cell distance, and pass without distance check if
+                    // unnecessary
+                    if (cell_dist2 > r_listsq) continue;
+
+                    // only load in the particle position and id if distance check is satisfied
+                    const Scalar4& neigh_xyzf = h_cell_xyzf.data[cli(cur_offset, neigh_cell)];
+                    unsigned int cur_neigh = __scalar_as_int(neigh_xyzf.w);
+
+                    // a particle cannot neighbor itself
+                    if (i == cur_neigh) continue;
+
+                    Scalar3 neigh_pos = make_scalar3(neigh_xyzf.x, neigh_xyzf.y, neigh_xyzf.z);
+                    Scalar3 dx = my_pos - neigh_pos;
+                    dx = box.minImage(dx);
+
+                    Scalar dr_sq = dot(dx,dx);
+
+                    if (dr_sq <= r_listsq)
+                        {
+                        if ((m_storage_mode == full || i < cur_neigh) && !ex_i.contains(h_tag.data[cur_neigh]))
+                            {
+                            if (cur_n_neigh < Nmax_i)
+                                {
+                                h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
+                                }
+                            else
+                                conditions[type_i] = max(conditions[type_i], cur_n_neigh+1);
+
+                            ++cur_n_neigh;
+                            }
+                        }
+                    }
+                }
+
+            h_n_neigh.data[i] = cur_n_neigh;
+            }
+        #ifdef ENABLE_TBB
+            });
+
+        for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+            for (unsigned int t = 0; t < ntypes; ++t)
+                h_conditions.data[t] = max(h_conditions.data[t], (*it)[t]);
+        #endif
+
+        if (m_prof)
+            m_prof->pop(m_exec_conf);
+        }
+    }
+
+void export_NeighborListMultiBinned(py::module& m)
+    {
+    py::class_<NeighborListMultiBinned, NeighborList, std::shared_ptr<NeighborListMultiBinned> >(m,
+        "NeighborListMultiBinned")
+        .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >())
+        .def("getCellList", &NeighborListMultiBinned::getCellList);
+    }
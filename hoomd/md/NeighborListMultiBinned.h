@@ -0,0 +1,84 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "NeighborList.h"
+#include "hoomd/CellList.h"
+#include "hoomd/CellListStencil.h"
+
+#include <vector>
+
+/*! \file NeighborListMultiBinned.h
+    \brief Declares the NeighborListMultiBinned class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+#ifndef __NEIGHBORLISTMULTIBINNED_H__
+#define __NEIGHBORLISTMULTIBINNED_H__
+
+//! Efficient neighbor list build on the CPU for size-disperse systems
+/*! Implements the O(N) neighbor list build on the CPU using one cell list per particle type.
+
+    A single cell list sized to the largest cutoff holds many small particles in each cell when the cutoffs of
+    the types differ a lot. Instead, the particles of each type \a b are binned into their own grid, with a cell
+    width set by the smallest list radius of the pairs that involve \a b. A particle of type \a a searches the grid
+    of \a b with a stencil of the cells within the list radius of the pair (\a a, \a b), so that the large
+    particles search many small cells of the small particles and not the other way around.
+
+    \sa CellListStencil, NeighborListStencil
+    \ingroup computes
+*/
+class PYBIND11_EXPORT NeighborListMultiBinned : public NeighborList
+    {
+    public:
+        //! Constructs the compute
+        NeighborListMultiBinned(std::shared_ptr<SystemDefinition> sysdef,
+                                Scalar r_cut,
+                                Scalar r_buff);
+
+        //! Destructor
+        virtual ~NeighborListMultiBinned();
+
+        /// Notify NeighborList that a r_cut matrix value has changed
+        virtual void notifyRCutMatrixChange()
+            {
+            m_needs_restencil = true;
+            NeighborList::notifyRCutMatrixChange();
+            }
+
+        //! Get the cell list that bins the particles of type \a type
+        std::shared_ptr<CellList> getCellList(unsigned int type)
+            {
+            if (m_cl.size() != m_pdata->getNTypes())
+                initializeCellLists();
+            return m_cl[type];
+            }
+
+    protected:
+        //! Builds the neighbor list
+        virtual void buildNlist(uint64_t timestep);
+
+    private:
+        std::vector< std::shared_ptr<CellList> > m_cl;           //!< The cell list of each type
+        std::vector< std::shared_ptr<CellListStencil> > m_cls;   //!< The stencils into the cell list of each type
+
+        bool m_needs_restencil;                                     //!< Flag for updating the widths and stencils
+
+        //! Construct one cell list and stencil per type
+        void initializeCellLists();
+
+        //! Update the cell widths and stencil radii from the cutoffs
+        void updateRStencil();
+
+        //! Get the neighbor list radius of a pair of types, negative if the pair does not interact
+        Scalar getRList(unsigned int type_i, unsigned int type_j);
+    };
+
+//! Exports NeighborListMultiBinned to python
+void export_NeighborListMultiBinned(pybind11::module& m);
+
+#endif // __NEIGHBORLISTMULTIBINNED_H__
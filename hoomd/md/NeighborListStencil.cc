@@ -14,6 +14,12 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 /*!
@@ -51,6 +57,8 @@ NeighborListStencil::NeighborListStencil(std::shared_ptr<SystemDefinition> sysde
     // cell sizes need update by default
     m_update_cell_size = true;
     m_needs_restencil = true;
+
+    m_exclusions_in_build = true;
     }
 
 NeighborListStencil::~NeighborListStencil()
@@ -113,6 +121,7 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
     Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
@@ -174,7 +183,18 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    #ifdef ENABLE_TBB
+    // each thread records its own overflow conditions, which are merged after the loop
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > thread_conditions(m_pdata->getNTypes(), 0);
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    unsigned int *conditions = thread_conditions.local().data();
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    unsigned int *conditions = h_conditions.data;
+    for (unsigned int i = 0; i < nparticles; i++)
+    #endif
         {
         unsigned int cur_n_neigh = 0;
 
@@ -186,6 +206,10 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
         const unsigned int Nmax_i = h_Nmax.data[type_i];
         const unsigned int head_idx_i = h_head_list.data[i];
 
+        ExclusionRange ex_i = {NULL, NULL};
+        if (m_exclusions_set)
+            ex_i = getSortedExclusions(h_tag.data[i]);
+
         // find the bin each particle belongs in
         Scalar3 f = box.makeFraction(my_pos,ghost_width);
         int ib = (unsigned int)(f.x * dim.x);
@@ -288,7 +312,7 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
                 unsigned int cur_neigh = __scalar_as_int(neigh_xyzf.w);
 
                 // a particle cannot neighbor itself
-                if (i == (int)cur_neigh) continue;
+                if (i == cur_neigh) continue;
 
                 Scalar3 neigh_pos = make_scalar3(neigh_xyzf.x, neigh_xyzf.y, neigh_xyzf.z);
                 Scalar3 dx = my_pos - neigh_pos;
@@ -298,7 +322,7 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
 
                 if (dr_sq <= r_listsq)
                     {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    if ((m_storage_mode == full || i < cur_neigh) && !ex_i.contains(h_tag.data[cur_neigh]))
                         {
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
@@ -306,7 +330,7 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
                             h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
                             }
                         else
-                            h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
+                            conditions[type_i] = max(conditions[type_i], cur_n_neigh+1);
 
                         ++cur_n_neigh;
                         }
@@ -316,6 +340,13 @@ void NeighborListStencil::buildNlist(uint64_t timestep)
 
         h_n_neigh.data[i] = cur_n_neigh;
         }
+    #ifdef ENABLE_TBB
+        });
+
+    for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+        for (unsigned int t = 0; t < m_pdata->getNTypes(); ++t)
+            h_conditions.data[t] = max(h_conditions.data[t], (*it)[t]);
+    #endif
 
     if (m_prof)
         m_prof->pop(m_exec_conf);
@@ -17,6 +17,12 @@ namespace py = pybind11;
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 using namespace hpmc::detail;
 
@@ -32,6 +38,8 @@ NeighborListTree::NeighborListTree(std::shared_ptr<SystemDefinition> sysdef,
     m_pdata->getBoxChangeSignal().connect<NeighborListTree, &NeighborListTree::slotBoxChanged>(this);
     m_pdata->getMaxParticleNumberChangeSignal().connect<NeighborListTree, &NeighborListTree::slotMaxNumChanged>(this);
     m_pdata->getParticleSortSignal().connect<NeighborListTree, &NeighborListTree::slotRemapParticles>(this);
+
+    m_exclusions_in_build = true;
     }
 
 NeighborListTree::~NeighborListTree()
@@ -265,6 +273,7 @@ void NeighborListTree::traverseTree()
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
 
@@ -276,7 +285,18 @@ void NeighborListTree::traverseTree()
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
     // Loop over all particles
-    for (unsigned int i=0; i < m_pdata->getN(); ++i)
+    #ifdef ENABLE_TBB
+    // each thread records its own overflow conditions, which are merged after the loop
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > thread_conditions(m_pdata->getNTypes(), 0);
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    unsigned int *conditions = thread_conditions.local().data();
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    unsigned int *conditions = h_conditions.data;
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    #endif
         {
         // read in the current position and orientation
         const Scalar4 postype_i = h_postype.data[i];
@@ -288,6 +308,10 @@ void NeighborListTree::traverseTree()
         const unsigned int Nmax_i = h_Nmax.data[type_i];
         const unsigned int nlist_head_i = h_head_list.data[i];
 
+        ExclusionRange ex_i = {NULL, NULL};
+        if (m_exclusions_set)
+            ex_i = getSortedExclusions(h_tag.data[i]);
+
         unsigned int n_neigh_i = 0;
         for (unsigned int cur_pair_type=0; cur_pair_type < m_pdata->getNTypes(); ++cur_pair_type) // loop on pair types
             {
@@ -358,12 +382,12 @@ void NeighborListTree::traverseTree()
 
                                     if (dr_sq <= (r_cutsq_i + sqshift))
                                         {
-                                        if (m_storage_mode == full || i < j)
+                                        if ((m_storage_mode == full || i < j) && !ex_i.contains(h_tag.data[j]))
                                             {
                                             if (n_neigh_i < Nmax_i)
                                                 h_nlist.data[nlist_head_i + n_neigh_i] = j;
                                             else
-                                                h_conditions.data[type_i] = max(h_conditions.data[type_i], n_neigh_i+1);
+                                                conditions[type_i] = max(conditions[type_i], n_neigh_i+1);
 
                                             ++n_neigh_i;
                                             }
@@ -382,6 +406,13 @@ void NeighborListTree::traverseTree()
             } // end loop over pair types
             h_n_neigh.data[i] = n_neigh_i;
         } // end loop over particles
+    #ifdef ENABLE_TBB
+        });
+
+    for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+        for (unsigned int t = 0; t < m_pdata->getNTypes(); ++t)
+            h_conditions.data[t] = max(h_conditions.data[t], (*it)[t]);
+    #endif
 
     if (this->m_prof) this->m_prof->pop();
     }
@@ -46,6 +46,7 @@ void OPLSDihedralForceComputeGPU::computeForces(uint64_t timestep)
 
     ArrayHandle<DihedralData::members_t> d_gpu_dihedral_list(m_dihedral_data->getGPUTable(), access_location::device,access_mode::read);
     ArrayHandle<unsigned int> d_n_dihedrals(m_dihedral_data->getNGroupsArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_table_offsets(m_dihedral_data->getGPUTableOffsets(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_dihedrals_ABCD(m_dihedral_data->getGPUPosTable(), access_location::device, access_mode::read);
 
     // the dihedral table is up to date: we are good to go. Call the kernel
@@ -67,6 +68,7 @@ void OPLSDihedralForceComputeGPU::computeForces(uint64_t timestep)
                                          d_gpu_dihedral_list.data,
                                          d_dihedrals_ABCD.data,
                                          m_dihedral_data->getGPUTableIndexer().getW(),
+                                         d_gpu_table_offsets.data,
                                          d_n_dihedrals.data,
                                          d_params.data,
                                          m_dihedral_data->getNTypes(),
@@ -25,6 +25,7 @@
     \param tlist Dihedral data to use in calculating the forces
     \param dihedral_ABCD List of relative atom positions in the dihedrals
     \param pitch Pitch of 2D dihedral list
+    \param table_offsets Index of the first entry of every particle in the dihedral list
     \param n_dihedrals_list List of numbers of dihedrals per atom
 */
 extern "C" __global__
@@ -38,6 +39,7 @@ void gpu_compute_opls_dihedral_forces_kernel(Scalar4* d_force,
                                                  const group_storage<4> *tlist,
                                                  const unsigned int *dihedral_ABCD,
                                                  const unsigned int pitch,
+                                                 const unsigned int *table_offsets,
                                                  const unsigned int *n_dihedrals_list)
     {
     // start by identifying which particle we are to handle
@@ -49,6 +51,9 @@ void gpu_compute_opls_dihedral_forces_kernel(Scalar4* d_force,
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_dihedrals = n_dihedrals_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our b-particle from the a-b-c-d set. (MEM TRANSFER: 16 bytes)
     Scalar4 idx_postype = d_pos[idx];  // we can be either a, b, or c in the a-b-c-d quartet
     Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
@@ -65,8 +70,8 @@ void gpu_compute_opls_dihedral_forces_kernel(Scalar4* d_force,
     // loop over all dihedrals
     for (int dihedral_idx = 0; dihedral_idx < n_dihedrals; dihedral_idx++)
         {
-        group_storage<4> cur_dihedral = tlist[pitch*dihedral_idx + idx];
-        unsigned int cur_ABCD = dihedral_ABCD[pitch*dihedral_idx + idx];
+        group_storage<4> cur_dihedral = tlist[pitch*dihedral_idx + table_start];
+        unsigned int cur_ABCD = dihedral_ABCD[pitch*dihedral_idx + table_start];
 
         int cur_dihedral_x_idx = cur_dihedral.idx[0];
         int cur_dihedral_y_idx = cur_dihedral.idx[1];
@@ -295,6 +300,7 @@ void gpu_compute_opls_dihedral_forces_kernel(Scalar4* d_force,
     \param tlist Dihedral data to use in calculating the forces
     \param dihedral_ABCD List of relative atom positions in the dihedrals
     \param pitch Pitch of 2D dihedral list
+    \param table_offsets Index of the first entry of every particle in the dihedral list
     \param n_dihedrals_list List of numbers of dihedrals per atom
     \param d_params Array of OPLS parameters k1/2, k2/2, k3/2, and k4/2
     \param n_dihedral_types Number of dihedral types in d_params
@@ -316,6 +322,7 @@ hipError_t gpu_compute_opls_dihedral_forces(Scalar4* d_force,
                                                 const group_storage<4> *tlist,
                                                 const unsigned int *dihedral_ABCD,
                                                 const unsigned int pitch,
+                                                const unsigned int *table_offsets,
                                                 const unsigned int *n_dihedrals_list,
                                                 const Scalar4 *d_params,
                                                 const unsigned int n_dihedral_types,
@@ -343,7 +350,7 @@ hipError_t gpu_compute_opls_dihedral_forces(Scalar4* d_force,
 
     // run the kernel
     hipLaunchKernelGGL((gpu_compute_opls_dihedral_forces_kernel), dim3(grid), dim3(threads), 0, 0, d_force, d_virial, virial_pitch, N, d_pos, d_params,
-                                                                box, tlist, dihedral_ABCD, pitch, n_dihedrals_list);
+                                                                box, tlist, dihedral_ABCD, pitch, table_offsets, n_dihedrals_list);
 
     return hipSuccess;
     }
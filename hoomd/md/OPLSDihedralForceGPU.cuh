@@ -25,6 +25,7 @@ hipError_t gpu_compute_opls_dihedral_forces(Scalar4* d_force,
                                                 const group_storage<4> *tlist,
                                                 const unsigned int *dihedral_ABCD,
                                                 const unsigned int pitch,
+                                                const unsigned int *table_offsets,
                                                 const unsigned int *n_dihedrals_list,
                                                 const Scalar4 *d_params,
                                                 const unsigned int n_dihedral_types,
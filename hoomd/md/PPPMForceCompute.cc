@@ -2,6 +2,7 @@
 // This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
 #include "PPPMForceCompute.h"
+#include "EvaluatorPairEwald.h"
 #include <map>
 
 namespace py = pybind11;
@@ -44,7 +45,14 @@ PPPMForceCompute::PPPMForceCompute(std::shared_ptr<SystemDefinition> sysdef,
       m_q2(0.0),
       m_body_energy(0.0),
       m_ptls_added_removed(false),
+      m_box_change_tol(0.0),
+      m_inf_f_ref_valid(false),
       m_kiss_fft_initialized(false),
+      m_pencil_fft_enabled(false),
+      m_pencil_fft_ranks(0),
+      m_overlap(false),
+      m_forward_pending(false),
+      m_forces_pending(false),
       m_dfft_initialized(false)
     {
 
@@ -463,19 +471,33 @@ void PPPMForceCompute::initializeFFT()
         embed[1] = m_mesh_points.y+2*m_n_ghost_cells.y;
         embed[2] = m_mesh_points.x+2*m_n_ghost_cells.x;
         m_ghost_offset = (m_n_ghost_cells.z*embed[1]+m_n_ghost_cells.y)*embed[2]+m_n_ghost_cells.x;
-        uint3 pcoord = m_pdata->getDomainDecomposition()->getGridPos();
-        int pidx[3];
-        pidx[0] = pcoord.z;
-        pidx[1] = pcoord.y;
-        pidx[2] = pcoord.x;
-        int row_m = 0; /* both local grid and proc grid are row major, no transposition necessary */
-        ArrayHandle<unsigned int> h_cart_ranks(m_pdata->getDomainDecomposition()->getCartRanks(),
-            access_location::host, access_mode::read);
-        dfft_create_plan(&m_dfft_plan_forward, 3, gdim, embed, NULL, pdim, pidx,
-            row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *)h_cart_ranks.data);
-        dfft_create_plan(&m_dfft_plan_inverse, 3, gdim, NULL, embed, pdim, pidx,
-            row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *)h_cart_ranks.data);
-        m_dfft_initialized = true;
+
+        if (m_pencil_fft_enabled)
+            {
+            // the pencil FFT redistributes the mesh independently of the domain decomposition
+            m_pencil_fft = std::unique_ptr<PencilFFT>(new PencilFFT(m_sysdef,
+                m_mesh_points,
+                make_uint3(embed[2], embed[1], embed[0]),
+                m_pencil_fft_ranks));
+            }
+        else
+            {
+            m_pencil_fft.reset();
+
+            uint3 pcoord = m_pdata->getDomainDecomposition()->getGridPos();
+            int pidx[3];
+            pidx[0] = pcoord.z;
+            pidx[1] = pcoord.y;
+            pidx[2] = pcoord.x;
+            int row_m = 0; /* both local grid and proc grid are row major, no transposition necessary */
+            ArrayHandle<unsigned int> h_cart_ranks(m_pdata->getDomainDecomposition()->getCartRanks(),
+                access_location::host, access_mode::read);
+            dfft_create_plan(&m_dfft_plan_forward, 3, gdim, embed, NULL, pdim, pidx,
+                row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *)h_cart_ranks.data);
+            dfft_create_plan(&m_dfft_plan_inverse, 3, gdim, NULL, embed, pdim, pidx,
+                row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *)h_cart_ranks.data);
+            m_dfft_initialized = true;
+            }
         }
     #endif // ENABLE_MPI
 
@@ -619,10 +641,20 @@ void PPPMForceCompute::computeInfluenceFunction()
            int n_local = cell_idx/ny/nx;
            int m_local = (cell_idx-n_local*ny*nx)/nx;
            int l_local = cell_idx % nx;
-           // cyclic distribution
-           wave_idx.x = l_local*pdim.x + pidx.x;
-           wave_idx.y = m_local*pdim.y + pidx.y;
-           wave_idx.z = n_local*pdim.z + pidx.z;
+           if (m_pencil_fft)
+               {
+               // block distribution, the pencil FFT returns the transform in the bricks of the domain decomposition
+               wave_idx.x = l_local + pidx.x*nx;
+               wave_idx.y = m_local + pidx.y*ny;
+               wave_idx.z = n_local + pidx.z*m_mesh_points.z;
+               }
+           else
+               {
+               // cyclic distribution
+               wave_idx.x = l_local*pdim.x + pidx.x;
+               wave_idx.y = m_local*pdim.y + pidx.y;
+               wave_idx.z = n_local*pdim.z + pidx.z;
+               }
            }
         else
         #endif
@@ -719,6 +751,136 @@ void PPPMForceCompute::computeInfluenceFunction()
     if (m_prof) m_prof->pop();
     }
 
+/*! \param rescale True to rescale the reference influence function if the box changed little since it was computed
+
+    The mesh indices of the wave vector k = n1 b1 + n2 b2 + n3 b3 of a mesh point do not depend on the box, so the wave
+    vectors of a deformed box follow from the reference ones as k = H^-T H_ref^T k_ref, where the columns of H are the
+    lattice vectors. The influence function is dominated by the unaliased term
+    4 pi/(k^2 + alpha^2) exp(-(k^2 + alpha^2)/(4 kappa^2)) W(n)^2/denom(n), in which only the factors of k change.
+    The reference influence function is rescaled by the ratio of this term at the new and the reference wave vectors,
+    which neglects the change of the aliased terms relative to the unaliased one. The reference is computed in full
+    again once a box length changed by more than the tolerance relative to the reference box, or a tilt factor
+    changed by more than the tolerance.
+*/
+void PPPMForceCompute::updateInfluenceFunction(bool rescale)
+    {
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+
+    if (m_box_change_tol <= Scalar(0.0))
+        {
+        computeInfluenceFunction();
+        return;
+        }
+
+    if (rescale && m_inf_f_ref_valid)
+        {
+        Scalar3 L = global_box.getL();
+        Scalar3 L_ref = m_inf_f_ref_box.getL();
+        Scalar change = std::max(fabs(L.x/L_ref.x - Scalar(1.0)),
+                        std::max(fabs(L.y/L_ref.y - Scalar(1.0)), fabs(L.z/L_ref.z - Scalar(1.0))));
+        change = std::max(change, fabs(global_box.getTiltFactorXY() - m_inf_f_ref_box.getTiltFactorXY()));
+        change = std::max(change, fabs(global_box.getTiltFactorXZ() - m_inf_f_ref_box.getTiltFactorXZ()));
+        change = std::max(change, fabs(global_box.getTiltFactorYZ() - m_inf_f_ref_box.getTiltFactorYZ()));
+        rescale = change <= m_box_change_tol;
+        }
+    else
+        {
+        rescale = false;
+        }
+
+    if (!rescale)
+        {
+        computeInfluenceFunction();
+        storeInfluenceFunction();
+        m_inf_f_ref_box = global_box;
+        m_inf_f_ref_valid = true;
+        return;
+        }
+
+    // M = H^-T H_ref^T, H is upper triangular with the lattice vectors as columns
+    Scalar3 a1 = global_box.getLatticeVector(0);
+    Scalar3 a2 = global_box.getLatticeVector(1);
+    Scalar3 a3 = global_box.getLatticeVector(2);
+    Scalar3 r1 = m_inf_f_ref_box.getLatticeVector(0);
+    Scalar3 r2 = m_inf_f_ref_box.getLatticeVector(1);
+    Scalar3 r3 = m_inf_f_ref_box.getLatticeVector(2);
+
+    // inverse of H (upper triangular)
+    Scalar i00 = Scalar(1.0)/a1.x;
+    Scalar i11 = Scalar(1.0)/a2.y;
+    Scalar i22 = Scalar(1.0)/a3.z;
+    Scalar i01 = -a2.x*i00*i11;
+    Scalar i12 = -a3.y*i11*i22;
+    Scalar i02 = -(a2.x*i12 + a3.x*i22)*i00;
+
+    // H_ref^T is lower triangular, H^-T is lower triangular with entries (j,i) = inv(i,j)
+    Scalar h00 = r1.x, h01 = r2.x, h02 = r3.x, h11 = r2.y, h12 = r3.y, h22 = r3.z;
+    Scalar3 m0 = make_scalar3(i00*h00, Scalar(0.0), Scalar(0.0));
+    Scalar3 m1 = make_scalar3(i01*h00 + i11*h01, i11*h11, Scalar(0.0));
+    Scalar3 m2 = make_scalar3(i02*h00 + i12*h01 + i22*h02, i12*h11 + i22*h12, i22*h22);
+
+    rescaleInfluenceFunction(m0, m1, m2);
+    }
+
+/*! Copies the current influence function and wave vectors to the reference arrays.
+*/
+void PPPMForceCompute::storeInfluenceFunction()
+    {
+    if (m_inf_f_ref.getNumElements() != m_inf_f.getNumElements())
+        {
+        GlobalArray<Scalar> inf_f_ref(m_inf_f.getNumElements(), m_exec_conf);
+        m_inf_f_ref.swap(inf_f_ref);
+        GlobalArray<Scalar3> k_ref(m_k.getNumElements(), m_exec_conf);
+        m_k_ref.swap(k_ref);
+        }
+
+    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_inf_f_ref(m_inf_f_ref, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_k_ref(m_k_ref, access_location::host, access_mode::overwrite);
+
+    std::copy(h_inf_f.data, h_inf_f.data + m_inf_f.getNumElements(), h_inf_f_ref.data);
+    std::copy(h_k.data, h_k.data + m_k.getNumElements(), h_k_ref.data);
+    }
+
+/*! \param m0 First row of the matrix that maps the reference wave vectors to the current ones
+    \param m1 Second row
+    \param m2 Third row
+
+    See updateInfluenceFunction().
+*/
+void PPPMForceCompute::rescaleInfluenceFunction(const Scalar3& m0, const Scalar3& m1, const Scalar3& m2)
+    {
+    if (m_prof) m_prof->push("influence function rescale");
+
+    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_inf_f_ref(m_inf_f_ref, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_k_ref(m_k_ref, access_location::host, access_mode::read);
+
+    const Scalar alpha_sq = m_alpha*m_alpha;
+    const Scalar inv_4kappa_sq = Scalar(0.25)/(m_kappa*m_kappa);
+
+    for (unsigned int cell_idx = 0; cell_idx < m_n_inner_cells; ++cell_idx)
+        {
+        Scalar3 k_ref = h_k_ref.data[cell_idx];
+        Scalar3 k = make_scalar3(dot(m0, k_ref), dot(m1, k_ref), dot(m2, k_ref));
+
+        Scalar ksq_ref = dot(k_ref, k_ref);
+        Scalar ksq = dot(k, k);
+
+        Scalar inf_f(0.0);
+        if (ksq_ref > Scalar(0.0))
+            inf_f = h_inf_f_ref.data[cell_idx]*(ksq_ref + alpha_sq)/(ksq + alpha_sq)
+                * exp(-(ksq - ksq_ref)*inv_4kappa_sq);
+
+        h_inf_f.data[cell_idx] = inf_f;
+        h_k.data[cell_idx] = k;
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
 //! Assignment of particles to mesh using variable order interpolation scheme
 void PPPMForceCompute::assignParticles()
     {
@@ -891,7 +1053,16 @@ void PPPMForceCompute::updateMeshes()
         }
 
     #ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
+    if (m_forward_pending)
+        {
+        // complete the transform started in beginUpdateMeshes()
+        if (m_prof) m_prof->push("FFT");
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
+        m_pencil_fft->forwardEnd(h_fourier_mesh.data);
+        m_forward_pending = false;
+        if (m_prof) m_prof->pop();
+        }
+    else if (m_pdata->getDomainDecomposition())
         {
         // update inner cells of particle mesh
         if (m_prof) m_prof->push("ghost cell update");
@@ -906,7 +1077,10 @@ void PPPMForceCompute::updateMeshes()
         ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
 
-        dfft_execute((cpx_t *)(h_mesh.data+m_ghost_offset), (cpx_t *)h_fourier_mesh.data, 0,m_dfft_plan_forward);
+        if (m_pencil_fft)
+            m_pencil_fft->forward(h_mesh.data+m_ghost_offset, h_fourier_mesh.data);
+        else
+            dfft_execute((cpx_t *)(h_mesh.data+m_ghost_offset), (cpx_t *)h_fourier_mesh.data, 0,m_dfft_plan_forward);
         if (m_prof) m_prof->pop();
         }
     #endif
@@ -975,9 +1149,18 @@ void PPPMForceCompute::updateMeshes()
         ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
         ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
 
-        dfft_execute((cpx_t *)h_fourier_mesh_G_x.data, (cpx_t *)(h_inv_fourier_mesh_x.data+m_ghost_offset), 1,m_dfft_plan_inverse);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_y.data, (cpx_t *)(h_inv_fourier_mesh_y.data+m_ghost_offset), 1,m_dfft_plan_inverse);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_z.data, (cpx_t *)(h_inv_fourier_mesh_z.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+        if (m_pencil_fft)
+            {
+            m_pencil_fft->inverse(h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data+m_ghost_offset);
+            m_pencil_fft->inverse(h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data+m_ghost_offset);
+            m_pencil_fft->inverse(h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data+m_ghost_offset);
+            }
+        else
+            {
+            dfft_execute((cpx_t *)h_fourier_mesh_G_x.data, (cpx_t *)(h_inv_fourier_mesh_x.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            dfft_execute((cpx_t *)h_fourier_mesh_G_y.data, (cpx_t *)(h_inv_fourier_mesh_y.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            dfft_execute((cpx_t *)h_fourier_mesh_G_z.data, (cpx_t *)(h_inv_fourier_mesh_z.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+            }
         if (m_prof) m_prof->pop();
         }
     #endif
@@ -998,6 +1181,26 @@ void PPPMForceCompute::updateMeshes()
     #endif
     }
 
+/*! Updates the ghost cells of the particle mesh and posts the messages that send it to the pencil grid. The next
+    call to updateMeshes() completes the transform. Only valid with a pencil decomposition of the distributed FFT.
+ */
+void PPPMForceCompute::beginUpdateMeshes()
+    {
+    #ifdef ENABLE_MPI
+    // update inner cells of particle mesh
+    if (m_prof) m_prof->push("ghost cell update");
+    m_exec_conf->msg->notice(8) << "charge.pppm: Ghost cell update" << std::endl;
+    m_grid_comm_forward->communicate(m_mesh);
+    if (m_prof) m_prof->pop();
+
+    m_exec_conf->msg->notice(8) << "charge.pppm: Start distributed FFT mesh" << std::endl;
+
+    ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::read);
+    m_pencil_fft->forwardBegin(h_mesh.data+m_ghost_offset);
+    m_forward_pending = true;
+    #endif
+    }
+
 void PPPMForceCompute::interpolateForces()
     {
     if (m_prof) m_prof->push("interpolate");
@@ -1258,7 +1461,7 @@ void PPPMForceCompute::computeForces(uint64_t timestep)
         // setup tables and do misc validation
         setupCoeffs();
 
-        computeInfluenceFunction();
+        updateInfluenceFunction(false);
 
         if (m_nlist->getFilterBody())
             {
@@ -1282,14 +1485,53 @@ void PPPMForceCompute::computeForces(uint64_t timestep)
     if (m_box_changed || ghost_cell_num_changed)
         {
         if (ghost_cell_num_changed) setupMesh();
-        computeInfluenceFunction();
+        updateInfluenceFunction(!ghost_cell_num_changed);
         m_box_changed = false;
         }
 
     assignParticles();
 
+    #ifdef ENABLE_MPI
+    if (m_overlap && m_pencil_fft)
+        {
+        // the forces computed next overlap with the messages to the pencil grid
+        beginUpdateMeshes();
+        m_forces_pending = true;
+        if (m_prof) m_prof->pop();
+        return;
+        }
+    #endif
+
+    updateMeshes();
+    completeForces(timestep);
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param timestep Current time step
+
+    Completes the forces when computeForces() returned before the forward transform.
+*/
+void PPPMForceCompute::finishCompute(uint64_t timestep)
+    {
+    if (!m_forces_pending)
+        return;
+
+    if (m_prof) m_prof->push("PPPM");
+
     updateMeshes();
+    completeForces(timestep);
+    m_forces_pending = false;
 
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param timestep Current time step
+
+    Computes the energy, forces and virial from the transformed mesh.
+*/
+void PPPMForceCompute::completeForces(uint64_t timestep)
+    {
     PDataFlags flags = this->m_pdata->getFlags();
     computePE();
 
@@ -1311,8 +1553,6 @@ void PPPMForceCompute::computeForces(uint64_t timestep)
         m_nlist->compute(timestep);
         fixExclusions();
         }
-
-    if (m_prof) m_prof->pop();
     }
 
 void PPPMForceCompute::computeVirial()
@@ -1384,13 +1624,19 @@ inline void eval_pppm_real_space(Scalar alpha, Scalar kappa, Scalar rsq, Scalar
 
     Scalar r = slow::sqrt(rsq);
     Scalar expfac = fast::exp(-alpha*r);
+    Scalar expfac_inv = Scalar(1.0)/expfac;
     Scalar arg1 = kappa * r - alpha/Scalar(2.0)/kappa;
     Scalar arg2 = kappa * r + alpha/Scalar(2.0)/kappa;
-    Scalar erffac = (::erf(arg1)*expfac + expfac - ::erfc(arg2)*exp(alpha*r))/(Scalar(2.0)*r);
+    Scalar gauss1 = fast::exp(-arg1*arg1);
+    Scalar erfc1 = ewald_erfc(arg1, gauss1);
+    Scalar erfc2 = (alpha == Scalar(0.0)) ? erfc1 : ewald_erfc(arg2, fast::exp(-arg2*arg2));
+
+    // erf(arg1) + 1 = 2 - erfc(arg1)
+    Scalar erffac = ((Scalar(2.0) - erfc1)*expfac - erfc2*expfac_inv)/(Scalar(2.0)*r);
 
     pair_eng = erffac;
-    force_divr = -(expfac*Scalar(2.0)*kappa/sqrtpi*fast::exp(-arg1*arg1)
-        - Scalar(0.5)*alpha*(expfac*::erfc(arg1)+fast::exp(alpha*r)*::erfc(arg2)) - erffac)/rsq;
+    force_divr = -(expfac*Scalar(2.0)*kappa/sqrtpi*gauss1
+        - Scalar(0.5)*alpha*(expfac*erfc1+expfac_inv*erfc2) - erffac)/rsq;
     }
 
 void PPPMForceCompute::computeBodyCorrection()
@@ -1603,6 +1849,7 @@ Scalar PPPMForceCompute::getLogValue(const std::string& quantity, uint64_t times
         {
         // make sure values are current
         compute(timestep);
+        finishCompute(timestep);
 
         Scalar result = computePE();
 
@@ -1680,5 +1927,8 @@ void export_PPPMForceCompute(py::module& m)
         .def("setParams", &PPPMForceCompute::setParams)
         .def("getQSum", &PPPMForceCompute::getQSum)
         .def("getQ2Sum", &PPPMForceCompute::getQ2Sum)
+        .def("setPencilFFT", &PPPMForceCompute::setPencilFFT)
+        .def("setOverlap", &PPPMForceCompute::setOverlap)
+        .def("setBoxChangeTolerance", &PPPMForceCompute::setBoxChangeTolerance)
         ;
     }
@@ -10,6 +10,7 @@
 
 #ifdef ENABLE_MPI
 #include "CommunicatorGrid.h"
+#include "PencilFFT.h"
 #include "hoomd/extern/dfftlib/src/dfft_host.h"
 #endif
 
@@ -39,6 +40,9 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
 
         void computeForces(uint64_t timestep);
 
+        //! Complete the long-range solve started in computeForces()
+        virtual void finishCompute(uint64_t timestep);
+
         /*! Returns the names of provided log quantities.
          */
         std::vector<std::string> getProvidedLogQuantities()
@@ -60,6 +64,40 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         //! Get sum of charges
         Scalar getQSum();
 
+        //! Set whether the distributed FFT uses a pencil decomposition
+        /*! \param enable True to use a pencil decomposition, false to follow the domain decomposition with dfftlib
+            \param n_ranks Number of ranks in the pencil grid, 0 to use all ranks
+        */
+        void setPencilFFT(bool enable, unsigned int n_ranks)
+            {
+            m_pencil_fft_enabled = enable;
+            m_pencil_fft_ranks = n_ranks;
+            m_need_initialize = true;
+            }
+
+        //! Set whether the solve overlaps with the forces computed after this one
+        /*! \param overlap True to return from computeForces() while the mesh is sent to the pencil grid
+
+            The option only takes effect with a pencil decomposition of the distributed FFT.
+        */
+        void setOverlap(bool overlap)
+            {
+            m_overlap = overlap;
+            }
+
+        //! Set the relative box change up to which the influence function is rescaled
+        /*! \param tol Largest relative change of a box length or change of a tilt factor since the influence function
+                was last computed in full, 0 to compute it in full after every box change
+
+            Within the tolerance, the cached influence function is rescaled to the new wave vectors of each mesh point
+            instead of summing over the aliased wave vectors again.
+        */
+        void setBoxChangeTolerance(Scalar tol)
+            {
+            m_box_change_tol = tol;
+            m_inf_f_ref_valid = false;
+            }
+
         //! Get sum of squares of charges
         Scalar getQ2Sum();
 
@@ -132,6 +170,12 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         Scalar m_body_energy;                      //!< Energy correction due to rigid body exclusions
         bool m_ptls_added_removed;          //!< True if global particle number changed
 
+        Scalar m_box_change_tol;               //!< Relative box change up to which the influence function is rescaled
+        bool m_inf_f_ref_valid;                //!< True if the reference influence function is current
+        BoxDim m_inf_f_ref_box;                //!< Global box of the reference influence function
+        GlobalArray<Scalar> m_inf_f_ref;       //!< Influence function at the last full computation
+        GlobalArray<Scalar3> m_k_ref;          //!< Wave vectors at the last full computation
+
         //! Helper function to be called when particle number changes
         void slotGlobalParticleNumberChange()
             {
@@ -153,12 +197,27 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         //! Compute the optimal influence function
         virtual void computeInfluenceFunction();
 
+        //! Compute the influence function in full, or rescale it after a small box change
+        void updateInfluenceFunction(bool rescale);
+
+        //! Store the influence function and wave vectors as the reference for rescaling
+        virtual void storeInfluenceFunction();
+
+        //! Rescale the reference influence function to the current box
+        virtual void rescaleInfluenceFunction(const Scalar3& m0, const Scalar3& m1, const Scalar3& m2);
+
         //! Helper function to assign particle coordinates to mesh
         virtual void assignParticles();
 
         //! Helper function to update the mesh arrays
         virtual void updateMeshes();
 
+        //! Helper function to start the forward transform of the particle mesh
+        void beginUpdateMeshes();
+
+        //! Helper function to compute the forces from the particle mesh
+        void completeForces(uint64_t timestep);
+
         //! Helper function to interpolate the forces
         virtual void interpolateForces();
 
@@ -186,10 +245,18 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         dfft_plan m_dfft_plan_inverse;     //!< Distributed FFT for inverse transform
         std::unique_ptr<CommunicatorGrid<kiss_fft_cpx> > m_grid_comm_forward; //!< Communicator for charge mesh
         std::unique_ptr<CommunicatorGrid<kiss_fft_cpx> > m_grid_comm_reverse; //!< Communicator for inv fourier mesh
+        std::unique_ptr<PencilFFT> m_pencil_fft;   //!< Distributed FFT on a pencil decomposition
         #endif
 
+        bool m_pencil_fft_enabled;                 //!< True if the distributed FFT uses a pencil decomposition
+        unsigned int m_pencil_fft_ranks;           //!< Number of ranks in the pencil grid
+        bool m_overlap;                            //!< True if the solve overlaps with other forces
+        bool m_forward_pending;                    //!< True if a forward transform has been started
+        bool m_forces_pending;                     //!< True if computeForces() left the forces to finishCompute()
+
         bool m_kiss_fft_initialized;               //!< True if a local KISS FFT has been set up
 
+        // the meshes are single precision (kiss_fft_scalar is float) in all builds, only the sums over them use Scalar
         GlobalArray<kiss_fft_cpx> m_mesh;             //!< The particle density mesh
         GlobalArray<kiss_fft_cpx> m_fourier_mesh;     //!< The fourier transformed mesh
         GlobalArray<kiss_fft_cpx> m_fourier_mesh_G_x;   //!< Fourier transformed mesh times the influence function, x-component
@@ -18,17 +18,48 @@ PPPMForceComputeGPU::PPPMForceComputeGPU(std::shared_ptr<SystemDefinition> sysde
     : PPPMForceCompute(sysdef,nlist,group),
       m_local_fft(true),
       m_sum(m_exec_conf),
-      m_block_size(256)
+      m_block_size(256),
+      m_particles_binned(false)
     {
     unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
-    m_tuner_assign.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "pppm_assign", this->m_exec_conf));
+
+    // the charge assignment either scatters the charges to the mesh with atomic operations (0),
+    // or gathers them over the particles sorted into the mesh cells (1)
+    std::vector<unsigned int> valid_params;
+    for (unsigned int block_size = warp_size; block_size <= 1024; block_size += warp_size)
+        {
+        valid_params.push_back(block_size*10);
+
+        // the sorted particle list is not split between GPUs
+        if (m_exec_conf->getNumActiveGPUs() == 1)
+            valid_params.push_back(block_size*10 + 1);
+        }
+
+    m_tuner_assign.reset(new Autotuner(valid_params, 5, 100000, "pppm_assign", this->m_exec_conf));
     m_tuner_reduce_mesh.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "pppm_reduce_mesh", this->m_exec_conf));
     m_tuner_update.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "pppm_update_mesh", this->m_exec_conf));
     m_tuner_force.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "pppm_force", this->m_exec_conf));
     m_tuner_influence.reset(new Autotuner(warp_size, 1024, warp_size, 5, 100000, "pppm_influence", this->m_exec_conf));
 
+    // sorted particle list for gathering the charges, grown with the group
+    unsigned int n_alloc = std::max(m_group->getNumMembers(), 1u);
+    GlobalArray<uint2> bin_slot(n_alloc, m_exec_conf);
+    m_bin_slot.swap(bin_slot);
+
+    GlobalArray<unsigned int> sorted_idx(n_alloc, m_exec_conf);
+    m_sorted_idx.swap(sorted_idx);
+
+    GlobalArray<Scalar4> sorted_dr(n_alloc, m_exec_conf);
+    m_sorted_dr.swap(sorted_dr);
+
     m_cufft_initialized = false;
     m_cuda_dfft_initialized = false;
+
+    #ifdef ENABLE_MPI_CUDA
+    m_cuda_aware_mpi = true;
+    #else
+    m_cuda_aware_mpi = false;
+    #endif
     }
 
 PPPMForceComputeGPU::~PPPMForceComputeGPU()
@@ -44,8 +75,13 @@ PPPMForceComputeGPU::~PPPMForceComputeGPU()
     #ifdef ENABLE_MPI
     else if (m_cuda_dfft_initialized)
         {
+        #ifndef USE_HOST_DFFT
+        dfft_cuda_destroy_plan(m_dfft_plan_forward);
+        dfft_cuda_destroy_plan(m_dfft_plan_inverse);
+        #else
         dfft_destroy_plan(m_dfft_plan_forward);
         dfft_destroy_plan(m_dfft_plan_inverse);
+        #endif
         }
     #endif
     }
@@ -64,8 +100,13 @@ void PPPMForceComputeGPU::initializeFFT()
     #ifdef ENABLE_MPI
     else if (m_cuda_dfft_initialized)
         {
+        #ifndef USE_HOST_DFFT
+        dfft_cuda_destroy_plan(m_dfft_plan_forward);
+        dfft_cuda_destroy_plan(m_dfft_plan_inverse);
+        #else
         dfft_destroy_plan(m_dfft_plan_forward);
         dfft_destroy_plan(m_dfft_plan_inverse);
+        #endif
         }
     #endif
 
@@ -117,6 +158,8 @@ void PPPMForceComputeGPU::initializeFFT()
             row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *) h_cart_ranks.data);
         dfft_cuda_create_plan(&m_dfft_plan_inverse, 3, gdim, NULL, embed, pdim, pidx,
             row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *)h_cart_ranks.data);
+        dfft_cuda_set_cuda_aware_mpi(&m_dfft_plan_forward, m_cuda_aware_mpi);
+        dfft_cuda_set_cuda_aware_mpi(&m_dfft_plan_inverse, m_cuda_aware_mpi);
         #else
         dfft_create_plan(&m_dfft_plan_forward, 3, gdim, embed, NULL, pdim, pidx,
             row_m, 0, 1, m_exec_conf->getMPICommunicator(), (int *) h_cart_ranks.data);
@@ -169,6 +212,13 @@ void PPPMForceComputeGPU::initializeFFT()
     GlobalArray<hipfftComplex> mesh(m_n_cells+m_ghost_offset,m_exec_conf);
     m_mesh.swap(mesh);
 
+    // one extra cell for particles outside of the local mesh
+    GlobalArray<unsigned int> bin_count(m_n_cells+1, m_exec_conf);
+    m_bin_count.swap(bin_count);
+
+    GlobalArray<unsigned int> bin_start(m_n_cells+1, m_exec_conf);
+    m_bin_start.swap(bin_start);
+
     // pad with offset
     unsigned int inv_mesh_elements = m_n_cells+m_ghost_offset;
     GlobalArray<hipfftComplex> inv_fourier_mesh_x(inv_mesh_elements, m_exec_conf);
@@ -227,24 +277,70 @@ void PPPMForceComputeGPU::assignParticles()
     this->m_exec_conf->beginMultiGPU();
 
     m_tuner_assign->begin();
-    unsigned int block_size = m_tuner_assign->getParam();
+    unsigned int param = m_tuner_assign->getParam();
+    unsigned int block_size = param / 10;
+    m_particles_binned = param % 10;
+
+    if (m_particles_binned)
+        {
+        if (m_sorted_idx.getNumElements() < group_size)
+            {
+            m_bin_slot.resize(group_size);
+            m_sorted_idx.resize(group_size);
+            m_sorted_dr.resize(group_size);
+            }
 
-    gpu_assign_particles(m_mesh_points,
+        ArrayHandle<unsigned int> d_bin_count(m_bin_count, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_bin_start(m_bin_start, access_location::device, access_mode::overwrite);
+        ArrayHandle<uint2> d_bin_slot(m_bin_slot, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_sorted_idx(m_sorted_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_sorted_dr(m_sorted_dr, access_location::device, access_mode::overwrite);
+
+        gpu_bin_particles(m_mesh_points,
+                          m_n_ghost_cells,
+                          group_size,
+                          d_index_array.data,
+                          d_postype.data,
+                          d_charge.data,
+                          d_bin_count.data,
+                          d_bin_start.data,
+                          d_bin_slot.data,
+                          d_sorted_idx.data,
+                          d_sorted_dr.data,
+                          m_order,
+                          m_pdata->getBox(),
+                          block_size,
+                          m_exec_conf->getCachedAllocator());
+
+        gpu_gather_mesh(m_mesh_points,
                         m_n_ghost_cells,
-                        m_grid_dim,
-                        group_size,
-                        d_index_array.data,
-                        d_postype.data,
-                        d_charge.data,
+                        d_bin_start.data,
+                        d_sorted_dr.data,
                         d_mesh.data,
-                        d_mesh_scratch.data,
-                        (unsigned int)m_mesh.getNumElements(),
                         m_order,
                         m_pdata->getBox(),
                         block_size,
-                        d_rho_coeff.data,
-                        m_exec_conf->dev_prop,
-                        m_group->getGPUPartition());
+                        d_rho_coeff.data);
+        }
+    else
+        {
+        gpu_assign_particles(m_mesh_points,
+                            m_n_ghost_cells,
+                            m_grid_dim,
+                            group_size,
+                            d_index_array.data,
+                            d_postype.data,
+                            d_charge.data,
+                            d_mesh.data,
+                            d_mesh_scratch.data,
+                            (unsigned int)m_mesh.getNumElements(),
+                            m_order,
+                            m_pdata->getBox(),
+                            block_size,
+                            d_rho_coeff.data,
+                            m_exec_conf->dev_prop,
+                            m_group->getGPUPartition());
+        }
 
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
@@ -449,6 +545,9 @@ void PPPMForceComputeGPU::interpolateForces()
     // access the group
     ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
 
+    // if the charges were gathered, interpolate in the order of the mesh cells for better memory locality
+    ArrayHandle< unsigned int > d_sorted_idx(m_sorted_idx, access_location::device, access_mode::read);
+
     // access polynomial interpolation coefficients
     ArrayHandle< Scalar > d_rho_coeff(m_rho_coeff, access_location::device, access_mode::read);
 
@@ -467,7 +566,7 @@ void PPPMForceComputeGPU::interpolateForces()
                        d_charge.data,
                        m_pdata->getBox(),
                        m_order,
-                       d_index_array.data,
+                       m_particles_binned ? d_sorted_idx.data : d_index_array.data,
                        m_group->getGPUPartition(),
                        m_pdata->getGPUPartition(),
                        d_rho_coeff.data,
@@ -659,6 +758,52 @@ void PPPMForceComputeGPU::computeInfluenceFunction()
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+void PPPMForceComputeGPU::storeInfluenceFunction()
+    {
+    if (m_inf_f_ref.getNumElements() != m_inf_f.getNumElements())
+        {
+        GlobalArray<Scalar> inf_f_ref(m_inf_f.getNumElements(), m_exec_conf);
+        m_inf_f_ref.swap(inf_f_ref);
+        GlobalArray<Scalar3> k_ref(m_k.getNumElements(), m_exec_conf);
+        m_k_ref.swap(k_ref);
+        }
+
+    ArrayHandle<Scalar> d_inf_f(m_inf_f, access_location::device, access_mode::read);
+    ArrayHandle<Scalar3> d_k(m_k, access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_inf_f_ref(m_inf_f_ref, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar3> d_k_ref(m_k_ref, access_location::device, access_mode::overwrite);
+
+    hipMemcpy(d_inf_f_ref.data, d_inf_f.data, sizeof(Scalar)*m_inf_f.getNumElements(), hipMemcpyDeviceToDevice);
+    hipMemcpy(d_k_ref.data, d_k.data, sizeof(Scalar3)*m_k.getNumElements(), hipMemcpyDeviceToDevice);
+    }
+
+void PPPMForceComputeGPU::rescaleInfluenceFunction(const Scalar3& m0, const Scalar3& m1, const Scalar3& m2)
+    {
+    if (m_prof) m_prof->push(m_exec_conf, "influence function rescale");
+
+    ArrayHandle<Scalar> d_inf_f(m_inf_f, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar3> d_k(m_k, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar> d_inf_f_ref(m_inf_f_ref, access_location::device, access_mode::read);
+    ArrayHandle<Scalar3> d_k_ref(m_k_ref, access_location::device, access_mode::read);
+
+    gpu_rescale_influence_function(m_n_inner_cells,
+                                   d_inf_f.data,
+                                   d_k.data,
+                                   d_inf_f_ref.data,
+                                   d_k_ref.data,
+                                   m0,
+                                   m1,
+                                   m2,
+                                   m_kappa,
+                                   m_alpha,
+                                   256);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
 void PPPMForceComputeGPU::fixExclusions()
     {
     if (m_prof) m_prof->push(m_exec_conf, "fix exclusions");
@@ -700,12 +845,27 @@ void PPPMForceComputeGPU::fixExclusions()
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+void PPPMForceComputeGPU::setCUDAAwareMPI(bool cuda_aware_mpi)
+    {
+    m_cuda_aware_mpi = cuda_aware_mpi;
+
+    #if defined(ENABLE_MPI) && !defined(USE_HOST_DFFT)
+    // update existing plans, the option does not change their layout
+    if (m_cuda_dfft_initialized)
+        {
+        dfft_cuda_set_cuda_aware_mpi(&m_dfft_plan_forward, m_cuda_aware_mpi);
+        dfft_cuda_set_cuda_aware_mpi(&m_dfft_plan_inverse, m_cuda_aware_mpi);
+        }
+    #endif
+    }
+
 void export_PPPMForceComputeGPU(py::module& m)
     {
     py::class_<PPPMForceComputeGPU, PPPMForceCompute, std::shared_ptr<PPPMForceComputeGPU> >(m, "PPPMForceComputeGPU")
                 .def(py::init< std::shared_ptr<SystemDefinition>,
                                       std::shared_ptr<NeighborList>,
-                                      std::shared_ptr<ParticleGroup> >());
+                                      std::shared_ptr<ParticleGroup> >())
+                .def("setCUDAAwareMPI", &PPPMForceComputeGPU::setCUDAAwareMPI);
     }
 
 #endif // ENABLE_HIP
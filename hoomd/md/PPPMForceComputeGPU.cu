@@ -2,8 +2,14 @@
 // This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
 #include "PPPMForceComputeGPU.cuh"
+#include "EvaluatorPairEwald.h"
 #include "hoomd/TextureTools.h"
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#include <hipcub/hipcub.hpp>
+#pragma GCC diagnostic pop
+
 // __scalar2int_rd is __float2int_rd in single, __double2int_rd in double
 #ifdef SINGLE_PRECISION
 #define __scalar2int_rd __float2int_rd
@@ -391,6 +397,355 @@ void gpu_reduce_meshes(const unsigned int mesh_elements,
         ngpu);
     }
 
+//! Count the particles in every mesh cell and record their slot within the cell
+/*! Particles outside of the local mesh are put into the extra cell with index n_bins, so that the binned index list
+    contains every group member.
+ */
+__global__ void gpu_bin_particles_kernel(const uint3 mesh_dim,
+                                         const uint3 n_ghost_bins,
+                                         unsigned int group_size,
+                                         const unsigned int *d_index_array,
+                                         const Scalar4 *d_postype,
+                                         unsigned int *d_bin_count,
+                                         uint2 *d_bin_slot,
+                                         int order,
+                                         BoxDim box)
+    {
+    unsigned int group_idx = blockIdx.x*blockDim.x+threadIdx.x;
+
+    if (group_idx >= group_size) return;
+
+    int3 bin_dim = make_int3(mesh_dim.x+2*n_ghost_bins.x,
+                             mesh_dim.y+2*n_ghost_bins.y,
+                             mesh_dim.z+2*n_ghost_bins.z);
+    unsigned int n_bins = bin_dim.x*bin_dim.y*bin_dim.z;
+
+    unsigned int idx = d_index_array[group_idx];
+    Scalar4 postype = d_postype[idx];
+    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+    Scalar3 dr = make_scalar3(0,0,0);
+    int3 bin_coord = find_cell(pos, mesh_dim.x, mesh_dim.y, mesh_dim.z, n_ghost_bins, box, order, dr);
+
+    unsigned int bin = n_bins;
+    if (bin_coord.x >= 0 && bin_coord.x < bin_dim.x &&
+        bin_coord.y >= 0 && bin_coord.y < bin_dim.y &&
+        bin_coord.z >= 0 && bin_coord.z < bin_dim.z)
+        {
+        bin = bin_coord.x + bin_dim.x * (bin_coord.y + bin_dim.y * bin_coord.z);
+        }
+
+    unsigned int slot = atomicAdd(&d_bin_count[bin], 1);
+    d_bin_slot[group_idx] = make_uint2(bin, slot);
+    }
+
+//! Write the particles into their cells, storing the distance to the cell center and the charge
+__global__ void gpu_fill_bins_kernel(const uint3 mesh_dim,
+                                     const uint3 n_ghost_bins,
+                                     unsigned int group_size,
+                                     const unsigned int *d_index_array,
+                                     const Scalar4 *d_postype,
+                                     const Scalar *d_charge,
+                                     const uint2 *d_bin_slot,
+                                     const unsigned int *d_bin_start,
+                                     unsigned int *d_sorted_idx,
+                                     Scalar4 *d_sorted_dr,
+                                     int order,
+                                     BoxDim box)
+    {
+    unsigned int group_idx = blockIdx.x*blockDim.x+threadIdx.x;
+
+    if (group_idx >= group_size) return;
+
+    unsigned int idx = d_index_array[group_idx];
+    Scalar4 postype = d_postype[idx];
+    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+    Scalar3 dr = make_scalar3(0,0,0);
+    find_cell(pos, mesh_dim.x, mesh_dim.y, mesh_dim.z, n_ghost_bins, box, order, dr);
+
+    uint2 bin_slot = d_bin_slot[group_idx];
+    unsigned int sorted_idx = d_bin_start[bin_slot.x] + bin_slot.y;
+    d_sorted_idx[sorted_idx] = idx;
+    d_sorted_dr[sorted_idx] = make_scalar4(dr.x, dr.y, dr.z, d_charge[idx]);
+    }
+
+//! Sort the particles within every cell by their index, so that the order of summation is deterministic
+__global__ void gpu_sort_bins_kernel(unsigned int n_bins,
+                                     const unsigned int *d_bin_start,
+                                     unsigned int *d_sorted_idx,
+                                     Scalar4 *d_sorted_dr)
+    {
+    unsigned int bin = blockIdx.x*blockDim.x+threadIdx.x;
+
+    // the extra bin of particles outside the mesh is sorted, too
+    if (bin > n_bins) return;
+
+    unsigned int start = d_bin_start[bin];
+    unsigned int end = d_bin_start[bin+1];
+
+    // insertion sort, cells contain only a few particles
+    for (unsigned int i = start + 1; i < end; ++i)
+        {
+        unsigned int idx = d_sorted_idx[i];
+        Scalar4 dr = d_sorted_dr[i];
+        unsigned int j = i;
+        while (j > start && d_sorted_idx[j-1] > idx)
+            {
+            d_sorted_idx[j] = d_sorted_idx[j-1];
+            d_sorted_dr[j] = d_sorted_dr[j-1];
+            --j;
+            }
+        d_sorted_idx[j] = idx;
+        d_sorted_dr[j] = dr;
+        }
+    }
+
+//! Assign the charge density to the mesh by gathering over the binned particles
+/*! Every thread computes one mesh point from the particles in the surrounding cells, so no atomic operations are
+    needed and the result does not depend on the order of execution.
+ */
+__global__ void gpu_gather_mesh_kernel(const uint3 mesh_dim,
+                                       const uint3 n_ghost_bins,
+                                       const unsigned int *d_bin_start,
+                                       const Scalar4 *d_sorted_dr,
+                                       hipfftComplex *d_mesh,
+                                       Scalar V_cell,
+                                       int order,
+                                       const Scalar *d_rho_coeff)
+    {
+    extern __shared__ Scalar s_coeff[];
+
+    // load in interpolation coefficients
+    unsigned int ncoeffs = order*(2*order+1);
+    for (unsigned int cur_offset = 0; cur_offset < ncoeffs; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < ncoeffs)
+            {
+            s_coeff[cur_offset + threadIdx.x] = d_rho_coeff[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    int3 bin_dim = make_int3(mesh_dim.x+2*n_ghost_bins.x,
+                             mesh_dim.y+2*n_ghost_bins.y,
+                             mesh_dim.z+2*n_ghost_bins.z);
+
+    unsigned int cell_idx = blockIdx.x*blockDim.x+threadIdx.x;
+
+    if (cell_idx >= (unsigned int)(bin_dim.x*bin_dim.y*bin_dim.z)) return;
+
+    // grid coordinates of the mesh point (column-major)
+    int i = cell_idx % bin_dim.x;
+    int j = (cell_idx / bin_dim.x) % bin_dim.y;
+    int k = cell_idx / (bin_dim.x * bin_dim.y);
+
+    int nlower = - (order - 1)/2;
+    int nupper = order/2;
+
+    int mult_fact = 2*order + 1;
+
+    Scalar rho(0.0);
+
+    // loop over the cells whose particles contribute to this mesh point
+    for (int l = nlower; l <= nupper; ++l)
+        {
+        int bin_i = i - l;
+        if (bin_i >= bin_dim.x)
+            {
+            if (n_ghost_bins.x)
+                continue;
+            bin_i -= bin_dim.x;
+            }
+        else if (bin_i < 0)
+            {
+            if (n_ghost_bins.x)
+                continue;
+            bin_i += bin_dim.x;
+            }
+
+        for (int m = nlower; m <= nupper; ++m)
+            {
+            int bin_j = j - m;
+            if (bin_j >= bin_dim.y)
+                {
+                if (n_ghost_bins.y)
+                    continue;
+                bin_j -= bin_dim.y;
+                }
+            else if (bin_j < 0)
+                {
+                if (n_ghost_bins.y)
+                    continue;
+                bin_j += bin_dim.y;
+                }
+
+            for (int n = nlower; n <= nupper; ++n)
+                {
+                int bin_k = k - n;
+                if (bin_k >= bin_dim.z)
+                    {
+                    if (n_ghost_bins.z)
+                        continue;
+                    bin_k -= bin_dim.z;
+                    }
+                else if (bin_k < 0)
+                    {
+                    if (n_ghost_bins.z)
+                        continue;
+                    bin_k += bin_dim.z;
+                    }
+
+                unsigned int bin = bin_i + bin_dim.x * (bin_j + bin_dim.y * bin_k);
+                unsigned int start = d_bin_start[bin];
+                unsigned int end = d_bin_start[bin+1];
+
+                for (unsigned int p = start; p < end; ++p)
+                    {
+                    Scalar4 drq = d_sorted_dr[p];
+
+                    Scalar wx(0.0), wy(0.0), wz(0.0);
+                    for (int iorder = order-1; iorder >= 0; iorder--)
+                        {
+                        wx = s_coeff[l-nlower + iorder*mult_fact] + wx * drq.x;
+                        wy = s_coeff[m-nlower + iorder*mult_fact] + wy * drq.y;
+                        wz = s_coeff[n-nlower + iorder*mult_fact] + wz * drq.z;
+                        }
+
+                    rho += drq.w*wx*wy*wz;
+                    }
+                }
+            }
+        } // end of loop over neighboring bins
+
+    hipfftComplex val;
+    val.x = rho/V_cell;
+    val.y = 0;
+    d_mesh[cell_idx] = val;
+    }
+
+//! Sort the group members into the mesh cells they belong to
+/*! \param mesh_dim Dimensions of the local mesh
+    \param n_ghost_bins Number of ghost cells along every direction
+    \param group_size Number of group members
+    \param d_index_array Indices of the group members
+    \param d_postype Particle positions
+    \param d_charge Particle charges
+    \param d_bin_count Number of particles per cell (n_bins+1 elements, scratch)
+    \param d_bin_start First entry of every cell in the sorted arrays (n_bins+1 elements)
+    \param d_bin_slot Cell and slot of every group member (scratch)
+    \param d_sorted_idx Particle indices sorted by cell
+    \param d_sorted_dr Distance to the cell center and charge, sorted by cell
+    \param order Assignment order
+    \param box Local simulation box
+    \param block_size Block size for the kernels
+    \param alloc Caching allocator for temporary storage
+
+    The particles outside of the local mesh are stored after all cells, so that d_sorted_idx can be used in place of
+    the group index array.
+ */
+void gpu_bin_particles(const uint3 mesh_dim,
+                       const uint3 n_ghost_bins,
+                       unsigned int group_size,
+                       const unsigned int *d_index_array,
+                       const Scalar4 *d_postype,
+                       const Scalar *d_charge,
+                       unsigned int *d_bin_count,
+                       unsigned int *d_bin_start,
+                       uint2 *d_bin_slot,
+                       unsigned int *d_sorted_idx,
+                       Scalar4 *d_sorted_dr,
+                       int order,
+                       const BoxDim& box,
+                       unsigned int block_size,
+                       CachedAllocator& alloc)
+    {
+    unsigned int n_bins = (mesh_dim.x+2*n_ghost_bins.x)*(mesh_dim.y+2*n_ghost_bins.y)*(mesh_dim.z+2*n_ghost_bins.z);
+
+    hipMemsetAsync(d_bin_count, 0, sizeof(unsigned int)*(n_bins+1));
+
+    if (group_size > 0)
+        {
+        hipLaunchKernelGGL((gpu_bin_particles_kernel), dim3(group_size/block_size+1), dim3(block_size), 0, 0,
+            mesh_dim,
+            n_ghost_bins,
+            group_size,
+            d_index_array,
+            d_postype,
+            d_bin_count,
+            d_bin_slot,
+            order,
+            box);
+        }
+
+    // offsets of the cells in the sorted arrays
+    void *d_temp_storage = NULL;
+    size_t temp_storage_bytes = 0;
+    hipcub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_bin_count, d_bin_start, n_bins+1);
+    d_temp_storage = alloc.getTemporaryBuffer<char>(temp_storage_bytes);
+    hipcub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_bin_count, d_bin_start, n_bins+1);
+    alloc.deallocate((char *)d_temp_storage);
+
+    if (group_size > 0)
+        {
+        hipLaunchKernelGGL((gpu_fill_bins_kernel), dim3(group_size/block_size+1), dim3(block_size), 0, 0,
+            mesh_dim,
+            n_ghost_bins,
+            group_size,
+            d_index_array,
+            d_postype,
+            d_charge,
+            d_bin_slot,
+            d_bin_start,
+            d_sorted_idx,
+            d_sorted_dr,
+            order,
+            box);
+        }
+
+    hipLaunchKernelGGL((gpu_sort_bins_kernel), dim3((n_bins+1)/block_size+1), dim3(block_size), 0, 0,
+        n_bins,
+        d_bin_start,
+        d_sorted_idx,
+        d_sorted_dr);
+    }
+
+//! Assign the charges of the binned particles to the mesh without atomic operations
+void gpu_gather_mesh(const uint3 mesh_dim,
+                     const uint3 n_ghost_bins,
+                     const unsigned int *d_bin_start,
+                     const Scalar4 *d_sorted_dr,
+                     hipfftComplex *d_mesh,
+                     int order,
+                     const BoxDim& box,
+                     unsigned int block_size,
+                     const Scalar *d_rho_coeff)
+    {
+    Scalar V_cell = box.getVolume()/(Scalar)(mesh_dim.x*mesh_dim.y*mesh_dim.z);
+    unsigned int n_bins = (mesh_dim.x+2*n_ghost_bins.x)*(mesh_dim.y+2*n_ghost_bins.y)*(mesh_dim.z+2*n_ghost_bins.z);
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void*)gpu_gather_mesh_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(max_block_size, block_size);
+    unsigned int shared_bytes = (unsigned int)(order*(2*order+1)*sizeof(Scalar));
+
+    hipLaunchKernelGGL((gpu_gather_mesh_kernel), dim3(n_bins/run_block_size+1), dim3(run_block_size), shared_bytes, 0,
+        mesh_dim,
+        n_ghost_bins,
+        d_bin_start,
+        d_sorted_dr,
+        d_mesh,
+        V_cell,
+        order,
+        d_rho_coeff);
+    }
+
 __global__ void gpu_compute_mesh_virial_kernel(const unsigned int n_wave_vectors,
                                          hipfftComplex *d_fourier_mesh,
                                          Scalar *d_inf_f,
@@ -1268,6 +1623,76 @@ void gpu_compute_influence_function(const uint3 mesh_dim,
     #endif
     }
 
+//! Kernel to rescale the reference influence function to the current box
+/*! \param n_wave_vectors Number of wave vectors
+    \param d_inf_f Influence function to write
+    \param d_k Wave vectors to write
+    \param d_inf_f_ref Influence function at the last full computation
+    \param d_k_ref Wave vectors at the last full computation
+    \param m0 First row of the matrix that maps the reference wave vectors to the current ones
+    \param m1 Second row
+    \param m2 Third row
+    \param inv_4kappa_sq 1/(4 kappa^2)
+    \param alpha_sq Square of the Debye screening parameter
+
+    See PPPMForceCompute::updateInfluenceFunction().
+*/
+__global__ void gpu_rescale_influence_function_kernel(const unsigned int n_wave_vectors,
+                                                      Scalar *d_inf_f,
+                                                      Scalar3 *d_k,
+                                                      const Scalar *d_inf_f_ref,
+                                                      const Scalar3 *d_k_ref,
+                                                      const Scalar3 m0,
+                                                      const Scalar3 m1,
+                                                      const Scalar3 m2,
+                                                      const Scalar inv_4kappa_sq,
+                                                      const Scalar alpha_sq)
+    {
+    unsigned int kidx = blockIdx.x*blockDim.x + threadIdx.x;
+
+    if (kidx >= n_wave_vectors) return;
+
+    Scalar3 k_ref = d_k_ref[kidx];
+    Scalar3 k = make_scalar3(dot(m0, k_ref), dot(m1, k_ref), dot(m2, k_ref));
+
+    Scalar ksq_ref = dot(k_ref, k_ref);
+    Scalar ksq = dot(k, k);
+
+    Scalar inf_f(0.0);
+    if (ksq_ref > Scalar(0.0))
+        inf_f = d_inf_f_ref[kidx]*(ksq_ref + alpha_sq)/(ksq + alpha_sq)*exp(-(ksq - ksq_ref)*inv_4kappa_sq);
+
+    d_inf_f[kidx] = inf_f;
+    d_k[kidx] = k;
+    }
+
+void gpu_rescale_influence_function(const unsigned int n_wave_vectors,
+                                    Scalar *d_inf_f,
+                                    Scalar3 *d_k,
+                                    const Scalar *d_inf_f_ref,
+                                    const Scalar3 *d_k_ref,
+                                    const Scalar3 m0,
+                                    const Scalar3 m1,
+                                    const Scalar3 m2,
+                                    Scalar kappa,
+                                    Scalar alpha,
+                                    unsigned int block_size)
+    {
+    unsigned int n_blocks = n_wave_vectors/block_size + 1;
+
+    hipLaunchKernelGGL((gpu_rescale_influence_function_kernel), dim3(n_blocks), dim3(block_size), 0, 0,
+        n_wave_vectors,
+        d_inf_f,
+        d_k,
+        d_inf_f_ref,
+        d_k_ref,
+        m0,
+        m1,
+        m2,
+        Scalar(0.25)/(kappa*kappa),
+        alpha*alpha);
+    }
+
 //! The developer has chosen not to document this function
 __global__ void gpu_fix_exclusions_kernel(Scalar4 *d_force,
                                           Scalar *d_virial,
@@ -1329,12 +1754,16 @@ __global__ void gpu_fix_exclusions_kernel(Scalar4 *d_force,
                     Scalar r = sqrtf(rsq);
                     Scalar qiqj = qi * qj;
                     Scalar expfac = fast::exp(-alpha*r);
+                    Scalar expfac_inv = Scalar(1.0)/expfac;
                     Scalar arg1 = kappa * r - alpha/Scalar(2.0)/kappa;
                     Scalar arg2 = kappa * r + alpha/Scalar(2.0)/kappa;
-                    Scalar erffac = (::erf(arg1)*expfac + expfac - fast::erfc(arg2)*exp(alpha*r))/(Scalar(2.0)*r);
+                    Scalar gauss1 = fast::exp(-arg1*arg1);
+                    Scalar erfc1 = ewald_erfc(arg1, gauss1);
+                    Scalar erfc2 = (alpha == Scalar(0.0)) ? erfc1 : ewald_erfc(arg2, fast::exp(-arg2*arg2));
+                    Scalar erffac = ((Scalar(2.0) - erfc1)*expfac - erfc2*expfac_inv)/(Scalar(2.0)*r);
 
-                    Scalar force_divr = qiqj * (expfac*Scalar(2.0)*kappa/sqrtpi*fast::exp(-arg1*arg1)
-                        - Scalar(0.5)*alpha*(expfac*::erfc(arg1)+fast::exp(alpha*r)*fast::erfc(arg2)) - erffac)/rsq;
+                    Scalar force_divr = qiqj * (expfac*Scalar(2.0)*kappa/sqrtpi*gauss1
+                        - Scalar(0.5)*alpha*(expfac*erfc1+expfac_inv*erfc2) - erffac)/rsq;
 
                     // subtract long-range part of pair-interaction
                     Scalar pair_eng = -qiqj * erffac;
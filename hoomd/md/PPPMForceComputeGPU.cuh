@@ -6,6 +6,7 @@
 #include "hoomd/BoxDim.h"
 
 #include "hoomd/GPUPartition.cuh"
+#include "hoomd/CachedAllocator.h"
 
 #include "hip/hip_runtime.h"
 
@@ -41,6 +42,32 @@ void gpu_reduce_meshes(const unsigned int mesh_elements,
     const unsigned int ngpu,
     const unsigned int block_size);
 
+void gpu_bin_particles(const uint3 mesh_dim,
+                       const uint3 n_ghost_bins,
+                       unsigned int group_size,
+                       const unsigned int *d_index_array,
+                       const Scalar4 *d_postype,
+                       const Scalar *d_charge,
+                       unsigned int *d_bin_count,
+                       unsigned int *d_bin_start,
+                       uint2 *d_bin_slot,
+                       unsigned int *d_sorted_idx,
+                       Scalar4 *d_sorted_dr,
+                       int order,
+                       const BoxDim& box,
+                       unsigned int block_size,
+                       CachedAllocator& alloc);
+
+void gpu_gather_mesh(const uint3 mesh_dim,
+                     const uint3 n_ghost_bins,
+                     const unsigned int *d_bin_start,
+                     const Scalar4 *d_sorted_dr,
+                     hipfftComplex *d_mesh,
+                     int order,
+                     const BoxDim& box,
+                     unsigned int block_size,
+                     const Scalar *d_rho_coeff);
+
 void gpu_compute_mesh_virial(const unsigned int n_wave_vectors,
                              hipfftComplex *d_fourier_mesh,
                              Scalar *d_inf_f,
@@ -108,6 +135,18 @@ void gpu_compute_influence_function(const uint3 mesh_dim,
                                     int order,
                                     unsigned int block_size);
 
+void gpu_rescale_influence_function(const unsigned int n_wave_vectors,
+                                    Scalar *d_inf_f,
+                                    Scalar3 *d_k,
+                                    const Scalar *d_inf_f_ref,
+                                    const Scalar3 *d_k_ref,
+                                    const Scalar3 m0,
+                                    const Scalar3 m1,
+                                    const Scalar3 m2,
+                                    Scalar kappa,
+                                    Scalar alpha,
+                                    unsigned int block_size);
+
 hipError_t gpu_fix_exclusions(Scalar4 *d_force,
                            Scalar *d_virial,
                            const size_t virial_pitch,
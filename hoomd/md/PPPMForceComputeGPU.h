@@ -64,6 +64,14 @@ class PYBIND11_EXPORT PPPMForceComputeGPU : public PPPMForceCompute
             m_tuner_influence->setEnabled(enable);
             }
 
+        //! Set whether the distributed FFT passes device buffers to MPI directly
+        /*! \param cuda_aware_mpi True to pass device buffers to MPI (requires CUDA-aware MPI), false to stage the
+                transposes through host memory
+
+            The default follows the ENABLE_MPI_CUDA build option.
+        */
+        void setCUDAAwareMPI(bool cuda_aware_mpi);
+
     protected:
         //! Helper function to setup FFT and allocate the mesh arrays
         virtual void initializeFFT();
@@ -80,6 +88,12 @@ class PYBIND11_EXPORT PPPMForceComputeGPU : public PPPMForceCompute
         //! Compute the optimal influence function
         virtual void computeInfluenceFunction();
 
+        //! Store the influence function and wave vectors as the reference for rescaling on the GPU
+        virtual void storeInfluenceFunction();
+
+        //! Rescale the reference influence function to the current box on the GPU
+        virtual void rescaleInfluenceFunction(const Scalar3& m0, const Scalar3& m1, const Scalar3& m2);
+
         //! Helper function to calculate value of collective variable
         virtual Scalar computePE();
 
@@ -119,6 +133,7 @@ class PYBIND11_EXPORT PPPMForceComputeGPU : public PPPMForceCompute
         bool m_local_fft;                  //!< True if we are only doing local FFTs (not distributed)
         bool m_cufft_initialized;          //!< True if CUFFT has been initialized
         bool m_cuda_dfft_initialized;      //!< True if dfft has been initialized
+        bool m_cuda_aware_mpi;             //!< True if dfft passes device buffers to MPI directly
 
         #ifdef ENABLE_MPI
         typedef CommunicatorGridGPU<hipfftComplex> CommunicatorGridGPUComplex;
@@ -140,6 +155,13 @@ class PYBIND11_EXPORT PPPMForceComputeGPU : public PPPMForceCompute
         GlobalArray<Scalar> m_sum_virial_partial;     //!< Partial sums over virial mesh values
         GlobalArray<Scalar> m_sum_virial;             //!< Final sum over virial mesh values
         unsigned int m_block_size;                 //!< Block size for fourier mesh reduction
+
+        GlobalArray<unsigned int> m_bin_count;     //!< Number of group members per mesh cell
+        GlobalArray<unsigned int> m_bin_start;     //!< Offset of every mesh cell into the sorted arrays
+        GlobalArray<uint2> m_bin_slot;             //!< Mesh cell and slot of every group member
+        GlobalArray<unsigned int> m_sorted_idx;    //!< Particle indices sorted by mesh cell
+        GlobalArray<Scalar4> m_sorted_dr;          //!< Distance to the cell center and charge, sorted by mesh cell
+        bool m_particles_binned;                   //!< True if the particles were sorted by mesh cell in this step
     };
 
 void export_PPPMForceComputeGPU(pybind11::module& m);
@@ -0,0 +1,72 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __PAIR_SPLINE_TABLE_H__
+#define __PAIR_SPLINE_TABLE_H__
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file PairSplineTable.h
+    \brief Defines the evaluation of pair potentials tabulated with cubic splines in r^2
+*/
+
+// DEVICE is __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Evaluate a pair potential from its cubic spline table
+/*! \param force_divr Set to the force divided by r
+    \param pair_eng Set to the pair energy
+    \param rsq Squared distance between the particles, at least x_min
+    \param table Spline coefficients of the \a width - 1 intervals of the type pair
+    \param range Lower bound x_min of the table in r^2 (x) and the inverse of the knot spacing in r^2 (y)
+    \param width Number of knots of the table
+
+    The table spans x = r^2 from x_min to r_cut^2 with evenly spaced knots. In interval k, the energy is the cubic
+    V = c.x + u*(c.y + u*(c.z + u*c.w)) of u = (x - x_min)/dx - k, and the force is F/r = -2 dV/dx, so the forces are
+    the exact derivatives of the tabulated energy and both are continuous at the knots.
+*/
+DEVICE inline void evalPairSplineTable(Scalar& force_divr,
+                                       Scalar& pair_eng,
+                                       const Scalar rsq,
+                                       const Scalar4 *table,
+                                       const Scalar2 range,
+                                       const unsigned int width)
+    {
+    Scalar t = (rsq - range.x) * range.y;
+    unsigned int k = (unsigned int)t;
+    if (k > width - 2)
+        k = width - 2;
+    Scalar u = t - Scalar(k);
+
+    #ifdef __HIPCC__
+    Scalar4 c = __ldg(table + k);
+    #else
+    Scalar4 c = table[k];
+    #endif
+
+    pair_eng = c.x + u*(c.y + u*(c.z + u*c.w));
+    force_divr = Scalar(-2.0)*range.y*(c.y + u*(Scalar(2.0)*c.z + Scalar(3.0)*u*c.w));
+    }
+
+#ifndef __HIPCC__
+//! Compute the spline coefficients of one table interval
+/*! \param v0 Energy at the first knot
+    \param d0 Derivative of the energy with respect to u at the first knot
+    \param v1 Energy at the second knot
+    \param d1 Derivative of the energy with respect to u at the second knot
+    \returns The coefficients of the cubic Hermite polynomial read by evalPairSplineTable()
+*/
+inline Scalar4 makePairSplineInterval(Scalar v0, Scalar d0, Scalar v1, Scalar d1)
+    {
+    return make_scalar4(v0,
+                        d0,
+                        Scalar(3.0)*(v1 - v0) - Scalar(2.0)*d0 - d1,
+                        Scalar(2.0)*(v0 - v1) + d0 + d1);
+    }
+#endif
+
+#endif // __PAIR_SPLINE_TABLE_H__
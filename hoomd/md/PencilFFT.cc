@@ -0,0 +1,395 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifdef ENABLE_MPI
+
+#include "PencilFFT.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+
+//! Number of mesh points in a box
+static inline unsigned int boxVolume(const uint3& lo, const uint3& hi)
+    {
+    if (hi.x <= lo.x || hi.y <= lo.y || hi.z <= lo.z)
+        return 0;
+    return (hi.x-lo.x)*(hi.y-lo.y)*(hi.z-lo.z);
+    }
+
+//! Lower bound of part i of n mesh points split into p parts
+static inline unsigned int splitBegin(unsigned int n, unsigned int p, unsigned int i)
+    {
+    return (unsigned int)((unsigned long long)n*i/p);
+    }
+
+/*! \param sysdef The system definition, the bricks follow its domain decomposition
+    \param dim Dimensions of the local brick
+    \param embed Embedding dimensions of the local brick in the input and output arrays
+    \param n_ranks Number of ranks in the pencil grid, 0 to use all ranks
+ */
+PencilFFT::PencilFFT(std::shared_ptr<SystemDefinition> sysdef, uint3 dim, uint3 embed, unsigned int n_ranks)
+    : m_exec_conf(sysdef->getParticleData()->getExecConf()),
+      m_dim(dim),
+      m_embed(embed)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing PencilFFT" << std::endl;
+
+    std::shared_ptr<DomainDecomposition> decomposition = sysdef->getParticleData()->getDomainDecomposition();
+    if (!decomposition)
+        {
+        m_exec_conf->msg->error() << "PencilFFT requires a domain decomposition" << std::endl;
+        throw std::runtime_error("Error initializing PencilFFT");
+        }
+
+    unsigned int nranks = m_exec_conf->getNRanks();
+    if (n_ranks == 0 || n_ranks > nranks)
+        n_ranks = nranks;
+
+    // the most square pencil grid with n_ranks ranks
+    unsigned int p1 = (unsigned int)sqrt((double) n_ranks);
+    while (n_ranks % p1)
+        p1--;
+    m_pencil_grid = make_uint2(p1, n_ranks/p1);
+
+    m_exec_conf->msg->notice(4) << "PencilFFT: " << m_pencil_grid.x << "x" << m_pencil_grid.y
+        << " pencil grid" << std::endl;
+
+    // the bricks of all ranks
+    const Index3D& di = decomposition->getDomainIndexer();
+    m_global_dim = make_uint3(dim.x*di.getW(), dim.y*di.getH(), dim.z*di.getD());
+
+    Box empty;
+    empty.lo = empty.hi = make_uint3(0,0,0);
+    m_bricks.resize(nranks, empty);
+
+        {
+        ArrayHandle<unsigned int> h_cart_ranks(decomposition->getCartRanks(), access_location::host, access_mode::read);
+        for (unsigned int idx = 0; idx < di.getNumElements(); ++idx)
+            {
+            uint3 pos = di.getTriple(idx);
+            Box& b = m_bricks[h_cart_ranks.data[idx]];
+            b.lo = make_uint3(pos.x*dim.x, pos.y*dim.y, pos.z*dim.z);
+            b.hi = make_uint3(b.lo.x+dim.x, b.lo.y+dim.y, b.lo.z+dim.z);
+            }
+        }
+
+    // the pencils of all ranks, ranks beyond the pencil grid hold empty pencils
+    const uint3& g = m_global_dim;
+    for (unsigned int d = 0; d < 3; ++d)
+        {
+        m_pencils[d].resize(nranks, empty);
+        for (unsigned int r = 0; r < n_ranks; ++r)
+            {
+            unsigned int a = r % m_pencil_grid.x;
+            unsigned int b = r / m_pencil_grid.x;
+            Box& p = m_pencils[d][r];
+
+            if (d == 0)
+                {
+                p.lo = make_uint3(0, splitBegin(g.y, m_pencil_grid.x, a), splitBegin(g.z, m_pencil_grid.y, b));
+                p.hi = make_uint3(g.x, splitBegin(g.y, m_pencil_grid.x, a+1), splitBegin(g.z, m_pencil_grid.y, b+1));
+                }
+            else if (d == 1)
+                {
+                p.lo = make_uint3(splitBegin(g.x, m_pencil_grid.x, a), 0, splitBegin(g.z, m_pencil_grid.y, b));
+                p.hi = make_uint3(splitBegin(g.x, m_pencil_grid.x, a+1), g.y, splitBegin(g.z, m_pencil_grid.y, b+1));
+                }
+            else
+                {
+                p.lo = make_uint3(splitBegin(g.x, m_pencil_grid.x, a), splitBegin(g.y, m_pencil_grid.y, b), 0);
+                p.hi = make_uint3(splitBegin(g.x, m_pencil_grid.x, a+1), splitBegin(g.y, m_pencil_grid.y, b+1), g.z);
+                }
+            }
+        }
+
+    // store the local pencils with the transform direction fastest
+    unsigned int rank = m_exec_conf->getRank();
+    uint3 px = make_uint3(m_pencils[0][rank].hi.x-m_pencils[0][rank].lo.x,
+        m_pencils[0][rank].hi.y-m_pencils[0][rank].lo.y,
+        m_pencils[0][rank].hi.z-m_pencils[0][rank].lo.z);
+    uint3 py = make_uint3(m_pencils[1][rank].hi.x-m_pencils[1][rank].lo.x,
+        m_pencils[1][rank].hi.y-m_pencils[1][rank].lo.y,
+        m_pencils[1][rank].hi.z-m_pencils[1][rank].lo.z);
+    uint3 pz = make_uint3(m_pencils[2][rank].hi.x-m_pencils[2][rank].lo.x,
+        m_pencils[2][rank].hi.y-m_pencils[2][rank].lo.y,
+        m_pencils[2][rank].hi.z-m_pencils[2][rank].lo.z);
+    m_pencil_stride[0] = make_uint3(1, px.x, px.x*px.y);
+    m_pencil_stride[1] = make_uint3(py.y, 1, py.x*py.y);
+    m_pencil_stride[2] = make_uint3(pz.z, pz.x*pz.z, 1);
+
+    m_brick_to_x = makePlan(m_bricks, m_pencils[0]);
+    m_x_to_y = makePlan(m_pencils[0], m_pencils[1]);
+    m_y_to_z = makePlan(m_pencils[1], m_pencils[2]);
+    m_z_to_brick = makePlan(m_pencils[2], m_bricks);
+    m_brick_to_z = reversePlan(m_z_to_brick);
+    m_z_to_y = reversePlan(m_y_to_z);
+    m_y_to_x = reversePlan(m_x_to_y);
+    m_x_to_brick = reversePlan(m_brick_to_x);
+
+    // allocate buffers
+    unsigned int max_pencil = 0;
+    for (unsigned int d = 0; d < 3; ++d)
+        max_pencil = std::max(max_pencil, boxVolume(m_pencils[d][rank].lo, m_pencils[d][rank].hi));
+    m_work.resize(max_pencil);
+    m_work_out.resize(max_pencil);
+
+    unsigned int max_send = std::max(std::max(m_brick_to_x.send_size, m_x_to_y.send_size),
+        std::max(m_y_to_z.send_size, m_z_to_brick.send_size));
+    unsigned int max_recv = std::max(std::max(m_brick_to_x.recv_size, m_x_to_y.recv_size),
+        std::max(m_y_to_z.recv_size, m_z_to_brick.recv_size));
+    max_send = std::max(max_send, max_recv);
+    m_send_buf.resize(max_send);
+    m_recv_buf.resize(max_send);
+
+    m_fft_cfg[0] = kiss_fft_alloc(g.x, 0, NULL, NULL);
+    m_fft_cfg[1] = kiss_fft_alloc(g.y, 0, NULL, NULL);
+    m_fft_cfg[2] = kiss_fft_alloc(g.z, 0, NULL, NULL);
+    m_ifft_cfg[0] = kiss_fft_alloc(g.x, 1, NULL, NULL);
+    m_ifft_cfg[1] = kiss_fft_alloc(g.y, 1, NULL, NULL);
+    m_ifft_cfg[2] = kiss_fft_alloc(g.z, 1, NULL, NULL);
+    }
+
+PencilFFT::~PencilFFT()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying PencilFFT" << std::endl;
+
+    for (unsigned int d = 0; d < 3; ++d)
+        {
+        kiss_fft_free(m_fft_cfg[d]);
+        kiss_fft_free(m_ifft_cfg[d]);
+        }
+    }
+
+/*! \param from Box of every rank in the source layout
+    \param to Box of every rank in the destination layout
+    \returns The messages this rank sends and receives
+ */
+PencilFFT::Plan PencilFFT::makePlan(const std::vector<Box>& from, const std::vector<Box>& to)
+    {
+    unsigned int rank = m_exec_conf->getRank();
+    Plan plan;
+    plan.send_size = 0;
+    plan.recv_size = 0;
+    plan.send_lo = from[rank].lo;
+    plan.recv_lo = to[rank].lo;
+
+    for (unsigned int r = 0; r < from.size(); ++r)
+        {
+        // what we send to rank r
+        Message msg;
+        msg.rank = r;
+        msg.box.lo = make_uint3(std::max(from[rank].lo.x, to[r].lo.x),
+            std::max(from[rank].lo.y, to[r].lo.y),
+            std::max(from[rank].lo.z, to[r].lo.z));
+        msg.box.hi = make_uint3(std::min(from[rank].hi.x, to[r].hi.x),
+            std::min(from[rank].hi.y, to[r].hi.y),
+            std::min(from[rank].hi.z, to[r].hi.z));
+        unsigned int n = boxVolume(msg.box.lo, msg.box.hi);
+        if (n)
+            {
+            msg.offset = plan.send_size;
+            plan.send.push_back(msg);
+            plan.send_size += n;
+            }
+
+        // what we receive from rank r
+        msg.box.lo = make_uint3(std::max(from[r].lo.x, to[rank].lo.x),
+            std::max(from[r].lo.y, to[rank].lo.y),
+            std::max(from[r].lo.z, to[rank].lo.z));
+        msg.box.hi = make_uint3(std::min(from[r].hi.x, to[rank].hi.x),
+            std::min(from[r].hi.y, to[rank].hi.y),
+            std::min(from[r].hi.z, to[rank].hi.z));
+        n = boxVolume(msg.box.lo, msg.box.hi);
+        if (n)
+            {
+            msg.offset = plan.recv_size;
+            plan.recv.push_back(msg);
+            plan.recv_size += n;
+            }
+        }
+
+    return plan;
+    }
+
+PencilFFT::Plan PencilFFT::reversePlan(const Plan& plan)
+    {
+    Plan reverse;
+    reverse.send = plan.recv;
+    reverse.recv = plan.send;
+    reverse.send_size = plan.recv_size;
+    reverse.recv_size = plan.send_size;
+    reverse.send_lo = plan.recv_lo;
+    reverse.recv_lo = plan.send_lo;
+    return reverse;
+    }
+
+/*! \param plan Messages of the redistribution
+    \param in Local mesh in the source layout
+    \param in_stride Strides of the local mesh in the source layout
+    \param out Local mesh in the destination layout
+    \param out_stride Strides of the local mesh in the destination layout
+
+    Messages hold the mesh points of their box with x fastest, independent of the storage order on either side.
+ */
+void PencilFFT::redistribute(const Plan& plan, const kiss_fft_cpx *in, uint3 in_stride, kiss_fft_cpx *out,
+    uint3 out_stride)
+    {
+    beginRedistribute(plan, in, in_stride);
+    endRedistribute(plan, out, out_stride);
+    }
+
+/*! \param plan Messages of the redistribution
+    \param in Local box in the source layout
+    \param in_stride Strides of the source layout
+
+    Packs the local box and posts the messages, without waiting for them.
+ */
+void PencilFFT::beginRedistribute(const Plan& plan, const kiss_fft_cpx *in, uint3 in_stride)
+    {
+    unsigned int rank = m_exec_conf->getRank();
+    MPI_Comm comm = m_exec_conf->getMPICommunicator();
+
+    // pack
+    for (const Message& msg : plan.send)
+        {
+        unsigned int n = msg.offset;
+        for (unsigned int z = msg.box.lo.z; z < msg.box.hi.z; ++z)
+            for (unsigned int y = msg.box.lo.y; y < msg.box.hi.y; ++y)
+                {
+                const kiss_fft_cpx *row = in + (y-plan.send_lo.y)*in_stride.y + (z-plan.send_lo.z)*in_stride.z;
+                for (unsigned int x = msg.box.lo.x; x < msg.box.hi.x; ++x)
+                    m_send_buf[n++] = row[(x-plan.send_lo.x)*in_stride.x];
+                }
+        }
+
+    // exchange
+    m_reqs.clear();
+    for (const Message& msg : plan.recv)
+        {
+        if (msg.rank == rank)
+            continue;
+
+        MPI_Request req;
+        MPI_Irecv(&m_recv_buf[msg.offset], boxVolume(msg.box.lo, msg.box.hi)*sizeof(kiss_fft_cpx), MPI_BYTE,
+            msg.rank, 0, comm, &req);
+        m_reqs.push_back(req);
+        }
+
+    for (const Message& msg : plan.send)
+        {
+        unsigned int n = boxVolume(msg.box.lo, msg.box.hi);
+        if (msg.rank == rank)
+            {
+            // the part of the mesh that stays on this rank
+            for (const Message& self : plan.recv)
+                {
+                if (self.rank == rank)
+                    memcpy(&m_recv_buf[self.offset], &m_send_buf[msg.offset], n*sizeof(kiss_fft_cpx));
+                }
+            continue;
+            }
+
+        MPI_Request req;
+        MPI_Isend(&m_send_buf[msg.offset], n*sizeof(kiss_fft_cpx), MPI_BYTE, msg.rank, 0, comm, &req);
+        m_reqs.push_back(req);
+        }
+    }
+
+/*! \param plan Messages of the redistribution
+    \param out Local box in the destination layout
+    \param out_stride Strides of the destination layout
+
+    Waits for the messages posted by beginRedistribute() and unpacks the local box.
+ */
+void PencilFFT::endRedistribute(const Plan& plan, kiss_fft_cpx *out, uint3 out_stride)
+    {
+    if (m_reqs.size())
+        MPI_Waitall((int)m_reqs.size(), &m_reqs.front(), MPI_STATUSES_IGNORE);
+    m_reqs.clear();
+
+    // unpack
+    for (const Message& msg : plan.recv)
+        {
+        unsigned int n = msg.offset;
+        for (unsigned int z = msg.box.lo.z; z < msg.box.hi.z; ++z)
+            for (unsigned int y = msg.box.lo.y; y < msg.box.hi.y; ++y)
+                {
+                kiss_fft_cpx *row = out + (y-plan.recv_lo.y)*out_stride.y + (z-plan.recv_lo.z)*out_stride.z;
+                for (unsigned int x = msg.box.lo.x; x < msg.box.hi.x; ++x)
+                    row[(x-plan.recv_lo.x)*out_stride.x] = m_recv_buf[n++];
+                }
+        }
+    }
+
+/*! \param cfg The 1D transform
+    \param d Direction of the pencils
+    \param in Local pencil, with direction d fastest
+    \param out Transformed pencil
+ */
+void PencilFFT::transformPencils(kiss_fft_cfg cfg, unsigned int d, const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    unsigned int rank = m_exec_conf->getRank();
+    const Box& p = m_pencils[d][rank];
+    unsigned int n = (d == 0) ? m_global_dim.x : ((d == 1) ? m_global_dim.y : m_global_dim.z);
+    unsigned int n_lines = boxVolume(p.lo, p.hi)/n;
+
+    for (unsigned int l = 0; l < n_lines; ++l)
+        kiss_fft(cfg, in + l*n, out + l*n);
+    }
+
+/*! \param in Local brick, pointing to the first inner mesh point of an array with dimensions embed
+    \param out Transformed local brick in row major order
+ */
+void PencilFFT::forward(const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    forwardBegin(in);
+    forwardEnd(out);
+    }
+
+/*! \param in Local brick, pointing to the first inner mesh point of an array with dimensions embed
+
+    Posts the messages that move the bricks into the x pencils and returns without waiting for them. The input is
+    packed before forwardBegin() returns. No other transform may start before forwardEnd().
+ */
+void PencilFFT::forwardBegin(const kiss_fft_cpx *in)
+    {
+    uint3 embed_stride = make_uint3(1, m_embed.x, m_embed.x*m_embed.y);
+    beginRedistribute(m_brick_to_x, in, embed_stride);
+    }
+
+/*! \param out Transformed local brick in row major order
+
+    Completes a transform started with forwardBegin().
+ */
+void PencilFFT::forwardEnd(kiss_fft_cpx *out)
+    {
+    uint3 brick_stride = make_uint3(1, m_dim.x, m_dim.x*m_dim.y);
+
+    endRedistribute(m_brick_to_x, m_work.data(), m_pencil_stride[0]);
+    transformPencils(m_fft_cfg[0], 0, m_work.data(), m_work_out.data());
+    redistribute(m_x_to_y, m_work_out.data(), m_pencil_stride[0], m_work.data(), m_pencil_stride[1]);
+    transformPencils(m_fft_cfg[1], 1, m_work.data(), m_work_out.data());
+    redistribute(m_y_to_z, m_work_out.data(), m_pencil_stride[1], m_work.data(), m_pencil_stride[2]);
+    transformPencils(m_fft_cfg[2], 2, m_work.data(), m_work_out.data());
+    redistribute(m_z_to_brick, m_work_out.data(), m_pencil_stride[2], out, brick_stride);
+    }
+
+/*! \param in Local brick in row major order
+    \param out Transformed local brick, pointing to the first inner mesh point of an array with dimensions embed
+ */
+void PencilFFT::inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    uint3 embed_stride = make_uint3(1, m_embed.x, m_embed.x*m_embed.y);
+    uint3 brick_stride = make_uint3(1, m_dim.x, m_dim.x*m_dim.y);
+
+    redistribute(m_brick_to_z, in, brick_stride, m_work.data(), m_pencil_stride[2]);
+    transformPencils(m_ifft_cfg[2], 2, m_work.data(), m_work_out.data());
+    redistribute(m_z_to_y, m_work_out.data(), m_pencil_stride[2], m_work.data(), m_pencil_stride[1]);
+    transformPencils(m_ifft_cfg[1], 1, m_work.data(), m_work_out.data());
+    redistribute(m_y_to_x, m_work_out.data(), m_pencil_stride[1], m_work.data(), m_pencil_stride[0]);
+    transformPencils(m_ifft_cfg[0], 0, m_work.data(), m_work_out.data());
+    redistribute(m_x_to_brick, m_work_out.data(), m_pencil_stride[0], out, embed_stride);
+    }
+
+#endif // ENABLE_MPI
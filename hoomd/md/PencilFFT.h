@@ -0,0 +1,134 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __PENCIL_FFT_H__
+#define __PENCIL_FFT_H__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/SystemDefinition.h"
+
+#include "hoomd/extern/kiss_fft.h"
+
+#include <memory>
+#include <vector>
+
+#ifdef ENABLE_MPI
+
+/*! Distributed 3D FFT on a pencil decomposition of the mesh
+
+    The mesh is stored in bricks that follow the domain decomposition. A transform redistributes the bricks into
+    pencils along x, then y, then z on a 2D grid of ranks, performs the one dimensional transforms along the pencils
+    with KISS FFT, and redistributes the result back into the bricks. Both the input and the output use the brick
+    layout, so that the wave vector of a mesh point follows from its position in the global mesh.
+
+    The pencil grid is independent of the domain decomposition and may span a subset of the ranks. Ranks exchange
+    point-to-point messages only with the ranks whose boxes overlap theirs, so every rank communicates within one row
+    or column of the pencil grid between the 1D transforms.
+
+    The inverse transform is not normalized.
+ */
+class PYBIND11_EXPORT PencilFFT
+    {
+    public:
+        //! Constructor
+        PencilFFT(std::shared_ptr<SystemDefinition> sysdef, uint3 dim, uint3 embed, unsigned int n_ranks);
+
+        //! Destructor
+        ~PencilFFT();
+
+        //! Forward transform
+        void forward(const kiss_fft_cpx *in, kiss_fft_cpx *out);
+
+        //! Start a forward transform
+        void forwardBegin(const kiss_fft_cpx *in);
+
+        //! Complete a forward transform
+        void forwardEnd(kiss_fft_cpx *out);
+
+        //! Inverse transform
+        void inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out);
+
+        //! Get the dimensions of the pencil grid
+        uint2 getPencilGrid() const
+            {
+            return m_pencil_grid;
+            }
+
+    private:
+        //! A box of mesh points, including lo and excluding hi
+        struct Box
+            {
+            uint3 lo;   //!< Lower corner
+            uint3 hi;   //!< Upper corner
+            };
+
+        //! A message of a redistribution
+        struct Message
+            {
+            unsigned int rank;      //!< Rank of the peer
+            Box box;                //!< Mesh points exchanged with the peer
+            unsigned int offset;    //!< Offset of the message in the send or receive buffer
+            };
+
+        //! Messages that redistribute the mesh from one layout into another
+        struct Plan
+            {
+            std::vector<Message> send;  //!< Messages sent by this rank
+            std::vector<Message> recv;  //!< Messages received by this rank
+            unsigned int send_size;     //!< Number of mesh points sent
+            unsigned int recv_size;     //!< Number of mesh points received
+            uint3 send_lo;              //!< Lower corner of the local box in the source layout
+            uint3 recv_lo;              //!< Lower corner of the local box in the destination layout
+            };
+
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+
+        uint3 m_global_dim;                 //!< Global mesh dimensions
+        uint3 m_dim;                        //!< Dimensions of the local brick
+        uint3 m_embed;                      //!< Embedding dimensions of the local brick in the input/output array
+        uint2 m_pencil_grid;                //!< Dimensions of the pencil grid
+
+        std::vector<Box> m_bricks;          //!< Brick of every rank
+        std::vector<Box> m_pencils[3];      //!< Pencil of every rank, per direction
+        uint3 m_pencil_stride[3];           //!< Strides of the local pencil, per direction
+
+        Plan m_brick_to_x;                  //!< Redistribution from bricks to x pencils
+        Plan m_x_to_y;                      //!< Redistribution from x pencils to y pencils
+        Plan m_y_to_z;                      //!< Redistribution from y pencils to z pencils
+        Plan m_z_to_brick;                  //!< Redistribution from z pencils to bricks
+        Plan m_brick_to_z;                  //!< Redistribution from bricks to z pencils
+        Plan m_z_to_y;                      //!< Redistribution from z pencils to y pencils
+        Plan m_y_to_x;                      //!< Redistribution from y pencils to x pencils
+        Plan m_x_to_brick;                  //!< Redistribution from x pencils to bricks
+
+        kiss_fft_cfg m_fft_cfg[3];          //!< 1D forward transforms, per direction
+        kiss_fft_cfg m_ifft_cfg[3];         //!< 1D inverse transforms, per direction
+
+        std::vector<kiss_fft_cpx> m_work;       //!< Pencil before a 1D transform
+        std::vector<kiss_fft_cpx> m_work_out;   //!< Pencil after a 1D transform
+        std::vector<kiss_fft_cpx> m_send_buf;   //!< Send buffer
+        std::vector<kiss_fft_cpx> m_recv_buf;   //!< Receive buffer
+        std::vector<MPI_Request> m_reqs;        //!< Pending requests
+
+        //! Set up the messages between two layouts
+        Plan makePlan(const std::vector<Box>& from, const std::vector<Box>& to);
+
+        //! Set up the messages of the reverse redistribution
+        static Plan reversePlan(const Plan& plan);
+
+        //! Redistribute the mesh between two layouts
+        void redistribute(const Plan& plan, const kiss_fft_cpx *in, uint3 in_stride, kiss_fft_cpx *out,
+            uint3 out_stride);
+
+        //! Pack the local box and post the messages of a redistribution
+        void beginRedistribute(const Plan& plan, const kiss_fft_cpx *in, uint3 in_stride);
+
+        //! Wait for the messages of a redistribution and unpack the local box
+        void endRedistribute(const Plan& plan, kiss_fft_cpx *out, uint3 out_stride);
+
+        //! Perform the 1D transforms along the pencils in direction d
+        void transformPencils(kiss_fft_cfg cfg, unsigned int d, const kiss_fft_cpx *in, kiss_fft_cpx *out);
+    };
+
+#endif // ENABLE_MPI
+#endif // __PENCIL_FFT_H__
@@ -0,0 +1,125 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __POST_STEP_MODIFIERS_H__
+#define __POST_STEP_MODIFIERS_H__
+
+#include "hoomd/HOOMDMath.h"
+#include "EvaluatorConstraintEllipsoid.h"
+
+/*! \file PostStepModifiers.h
+    \brief Defines the PostStepModifiers struct
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Constraints and momentum removal applied by an integration method inside its own step loops
+/*! Enforce2DUpdater, ZeroMomentumUpdater, ConstraintEllipsoid and the one dimensional and spherical constraints each
+    make a pass over the particle data after the integrator. An integration method that supports post step modifiers
+    applies the enabled ones to each particle while it is in registers, in the fixed order 2D, 1D, sphere, ellipsoid.
+
+    - enforce_2d zeroes the z components of the displacement, velocity and acceleration.
+    - one_d projects the displacement, velocity and acceleration onto the unit vector \a line.
+    - sphere moves the particle to the closest point on the sphere and removes the radial velocity.
+    - ellipsoid moves the particle to the closest point on the ellipsoid, as ConstraintEllipsoid does.
+    - zero_momentum removes the momentum of the integrated group at the end of the second step. The method sums the
+      momentum in the same loop that updates the velocities, so the only extra cost is a single reduction over the
+      ranks and a pass that subtracts the average.
+
+    The struct is plain data so that it can be passed by value to GPU kernels.
+*/
+struct PostStepModifiers
+    {
+    //! Flags for the enabled modifiers
+    enum Flags
+        {
+        enforce_2d = 1,
+        one_d = 2,
+        sphere = 4,
+        ellipsoid = 8,
+        zero_momentum = 16
+        };
+
+    unsigned int flags;     //!< Bitwise or of the enabled Flags
+    Scalar3 line;           //!< Unit vector of the one dimensional constraint
+    Scalar3 sphere_P;       //!< Center of the sphere
+    Scalar sphere_r;        //!< Radius of the sphere
+    Scalar3 ellipsoid_P;    //!< Center of the ellipsoid
+    Scalar3 ellipsoid_r;    //!< Radii of the ellipsoid along x, y and z
+
+    //! Default constructor, no modifiers enabled
+    PostStepModifiers()
+        : flags(0), line(make_scalar3(1,0,0)), sphere_P(make_scalar3(0,0,0)), sphere_r(1),
+          ellipsoid_P(make_scalar3(0,0,0)), ellipsoid_r(make_scalar3(1,1,1))
+        {
+        }
+
+    //! Test if any modifier acting on single particles is enabled
+    DEVICE bool hasParticleModifiers() const
+        {
+        return (flags & (enforce_2d | one_d | sphere | ellipsoid)) != 0;
+        }
+
+    //! Test if the momentum of the group is removed
+    DEVICE bool hasZeroMomentum() const
+        {
+        return (flags & zero_momentum) != 0;
+        }
+
+    //! Constrain a vector (displacement, velocity or acceleration) to the allowed directions
+    /*! \param v Vector to constrain
+    */
+    DEVICE void constrainDirection(Scalar3& v) const
+        {
+        if (flags & enforce_2d)
+            v.z = Scalar(0.0);
+
+        if (flags & one_d)
+            v = dot(v, line)*line;
+        }
+
+    //! Move a position onto the constraint surfaces
+    /*! \param pos Position to constrain
+    */
+    DEVICE void constrainPosition(Scalar3& pos) const
+        {
+        if (flags & sphere)
+            {
+            Scalar3 r = pos - sphere_P;
+            Scalar r_len = fast::sqrt(dot(r, r));
+            if (r_len > Scalar(0.0))
+                pos = sphere_P + r*(sphere_r/r_len);
+            }
+
+        if (flags & ellipsoid)
+            {
+            EvaluatorConstraintEllipsoid evaluator(ellipsoid_P, ellipsoid_r.x, ellipsoid_r.y, ellipsoid_r.z);
+            pos = evaluator.evalClosest(pos);
+            }
+        }
+
+    //! Constrain a velocity at a position that is already constrained
+    /*! \param pos Constrained position
+        \param vel Velocity to constrain
+    */
+    DEVICE void constrainVelocity(const Scalar3& pos, Scalar3& vel) const
+        {
+        constrainDirection(vel);
+
+        if (flags & sphere)
+            {
+            Scalar3 r = pos - sphere_P;
+            Scalar r_sq = dot(r, r);
+            if (r_sq > Scalar(0.0))
+                vel -= (dot(vel, r)/r_sq)*r;
+            }
+        }
+    };
+
+#endif // __POST_STEP_MODIFIERS_H__
@@ -46,6 +46,12 @@ class PotentialBond : public ForceCompute
         /// Get the parameters
         pybind11::dict getParams(std::string type);
 
+        /// Get the array of parameters per type
+        const GlobalArray<param_type>& getParamArray() const
+            {
+            return m_params;
+            }
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -61,7 +67,7 @@ class PotentialBond : public ForceCompute
         #endif
 
     protected:
-        GPUArray<param_type> m_params;              //!< Bond parameters per type
+        GlobalArray<param_type> m_params;           //!< Bond parameters per type
         std::shared_ptr<BondData> m_bond_data;    //!< Bond data to use in computing bonds
         std::string m_log_name;                     //!< Cached log name
         std::string m_prof_name;                    //!< Cached profiler name
@@ -87,7 +93,7 @@ PotentialBond< evaluator >::PotentialBond(std::shared_ptr<SystemDefinition> sysd
     m_prof_name = std::string("Bond ") + evaluator::getName();
 
     // allocate the parameters
-    GPUArray<param_type> params(m_bond_data->getNTypes(), m_exec_conf);
+    GlobalArray<param_type> params(m_bond_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
     }
 
@@ -36,9 +36,12 @@ struct bond_args_t
               const BoxDim& _box,
               const group_storage<2> *_d_gpu_bondlist,
               const Index2D & _gpu_table_indexer,
+              const unsigned int *_d_gpu_table_offsets,
               const unsigned int *_d_gpu_n_bonds,
               const unsigned int _n_bond_types,
-              const unsigned int _block_size)
+              const unsigned int _block_size,
+              const GPUPartition& _gpu_partition,
+              hipStream_t _stream = 0)
                 : d_force(_d_force),
                   d_virial(_d_virial),
                   virial_pitch(_virial_pitch),
@@ -50,9 +53,12 @@ struct bond_args_t
                   box(_box),
                   d_gpu_bondlist(_d_gpu_bondlist),
                   gpu_table_indexer(_gpu_table_indexer),
+                  d_gpu_table_offsets(_d_gpu_table_offsets),
                   d_gpu_n_bonds(_d_gpu_n_bonds),
                   n_bond_types(_n_bond_types),
-                  block_size(_block_size)
+                  block_size(_block_size),
+                  gpu_partition(_gpu_partition),
+                  stream(_stream)
         {
         };
 
@@ -67,9 +73,12 @@ struct bond_args_t
     const BoxDim& box;            //!< Simulation box in GPU format
     const group_storage<2> *d_gpu_bondlist;       //!< List of bonds stored on the GPU
     const Index2D& gpu_table_indexer;  //!< Indexer of 2D bond list
+    const unsigned int *d_gpu_table_offsets; //!< Index of the first bond of every particle in the bond list
     const unsigned int *d_gpu_n_bonds; //!< List of number of bonds stored on the GPU
     const unsigned int n_bond_types;   //!< Number of bond types in the simulation
     const unsigned int block_size;     //!< Block size to execute
+    const GPUPartition& gpu_partition; //!< Load balancing info for multi-GPU execution
+    hipStream_t stream;                //!< Stream to launch the kernel on
     };
 
 #ifdef __HIPCC__
@@ -81,13 +90,15 @@ struct bond_args_t
     \param d_force Device memory to write computed forces
     \param d_virial Device memory to write computed virials
     \param virial_pitch pitch of 2D virial array
-    \param N Number of particles in the system
+    \param N Number of particles in this GPU's range
+    \param offset Index of the first particle in this GPU's range
     \param d_pos particle positions on the GPU
     \param d_charge particle charges
     \param d_diameter particle diameters
     \param box Box dimensions used to implement periodic boundary conditions
     \param blist List of bonds stored on the GPU
     \param pitch Pitch of 2D bond list
+    \param blist_offsets Index of the first bond of every particle in the bond list
     \param n_bonds_list List of numbers of bonds stored on the GPU
     \param n_bond_type number of bond types
     \param d_params Parameters for the potential, stored per bond type
@@ -103,12 +114,14 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
                                                Scalar *d_virial,
                                                const size_t virial_pitch,
                                                const unsigned int N,
+                                               const unsigned int offset,
                                                const Scalar4 *d_pos,
                                                const Scalar *d_charge,
                                                const Scalar *d_diameter,
                                                const BoxDim box,
                                                const group_storage<2> *blist,
                                                const Index2D blist_idx,
+                                               const unsigned int *blist_offsets,
                                                const unsigned int *n_bonds_list,
                                                const unsigned int n_bond_type,
                                                const typename evaluator::param_type *d_params,
@@ -136,8 +149,11 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
     if (idx >= N)
         return;
 
+    idx += offset;
+
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_bonds =n_bonds_list[idx];
+    unsigned int blist_start = blist_offsets[idx];
 
     // read in the position of our particle. (MEM TRANSFER: 16 bytes)
     Scalar4 postype = __ldg(d_pos + idx);
@@ -170,7 +186,7 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
     // loop over neighbors
     for (int bond_idx = 0; bond_idx < n_bonds; bond_idx++)
         {
-        group_storage<2> cur_bond = blist[blist_idx(idx, bond_idx)];
+        group_storage<2> cur_bond = blist[blist_idx(blist_start, bond_idx)];
 
         int cur_bond_idx = cur_bond.idx[0];
         int cur_bond_type = cur_bond.idx[1];
@@ -272,18 +288,25 @@ hipError_t gpu_compute_bond_forces(const bond_args_t& bond_args,
 
     unsigned int run_block_size = min(bond_args.block_size, max_block_size);
 
-    // setup the grid to run the kernel
-    dim3 grid( bond_args.N / run_block_size + 1, 1, 1);
-    dim3 threads(run_block_size, 1, 1);
-
     unsigned int shared_bytes = (unsigned int)(sizeof(typename evaluator::param_type) *
                                 bond_args.n_bond_types);
 
-    // run the kernel
-    hipLaunchKernelGGL(gpu_compute_bond_forces_kernel<evaluator>, grid, threads, shared_bytes, 0,
-        bond_args.d_force, bond_args.d_virial, bond_args.virial_pitch, bond_args.N,
-        bond_args.d_pos, bond_args.d_charge, bond_args.d_diameter, bond_args.box, bond_args.d_gpu_bondlist,
-        bond_args.gpu_table_indexer, bond_args.d_gpu_n_bonds, bond_args.n_bond_types, d_params, d_flags);
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = bond_args.gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = bond_args.gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
+
+        // setup the grid to run the kernel
+        dim3 grid( nwork / run_block_size + 1, 1, 1);
+        dim3 threads(run_block_size, 1, 1);
+
+        // run the kernel
+        hipLaunchKernelGGL(gpu_compute_bond_forces_kernel<evaluator>, grid, threads, shared_bytes, bond_args.stream,
+            bond_args.d_force, bond_args.d_virial, bond_args.virial_pitch, nwork, range.first,
+            bond_args.d_pos, bond_args.d_charge, bond_args.d_diameter, bond_args.box, bond_args.d_gpu_bondlist,
+            bond_args.gpu_table_indexer, bond_args.d_gpu_table_offsets, bond_args.d_gpu_n_bonds, bond_args.n_bond_types, d_params, d_flags);
+        }
 
     return hipSuccess;
     }
@@ -53,9 +53,15 @@ class PotentialBondGPU : public PotentialBond<evaluator>
             m_tuner->setEnabled(enable);
             }
 
+        //! Bond forces can be launched on a separate stream
+        virtual bool supportsStream()
+            {
+            return true;
+            }
+
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
-        GPUArray<unsigned int> m_flags;       //!< Flags set during the kernel execution
+        GlobalArray<unsigned int> m_flags;    //!< Flags set during the kernel execution
 
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
@@ -76,11 +82,11 @@ PotentialBondGPU< evaluator, gpu_cgbf >::PotentialBondGPU(std::shared_ptr<System
         }
 
     // allocate and zero device memory
-    GPUArray<typename evaluator::param_type> params(this->m_bond_data->getNTypes(), this->m_exec_conf);
+    GlobalArray<typename evaluator::param_type> params(this->m_bond_data->getNTypes(), this->m_exec_conf);
     this->m_params.swap(params);
 
     // allocate flags storage on the GPU
-    GPUArray<unsigned int> flags(1, this->m_exec_conf);
+    GlobalArray<unsigned int> flags(1, this->m_exec_conf);
     m_flags.swap(flags);
 
     // reset flags
@@ -116,16 +122,19 @@ void PotentialBondGPU< evaluator, gpu_cgbf >::computeForces(uint64_t timestep)
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::readwrite);
 
         {
-        const GPUArray<typename BondData::members_t>& gpu_bond_list = this->m_bond_data->getGPUTable();
+        const GlobalArray<typename BondData::members_t>& gpu_bond_list = this->m_bond_data->getGPUTable();
         const Index2D& gpu_table_indexer = this->m_bond_data->getGPUTableIndexer();
 
         ArrayHandle<typename BondData::members_t> d_gpu_bondlist(gpu_bond_list, access_location::device, access_mode::read);
         ArrayHandle<unsigned int > d_gpu_n_bonds(this->m_bond_data->getNGroupsArray(),
                                                  access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_table_offsets(this->m_bond_data->getGPUTableOffsets(),
+                                                      access_location::device, access_mode::read);
 
         // access the flags array for overwriting
         ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::readwrite);
 
+        this->m_exec_conf->beginMultiGPU();
         this->m_tuner->begin();
         gpu_cgbf(bond_args_t(d_force.data,
                              d_virial.data,
@@ -138,12 +147,16 @@ void PotentialBondGPU< evaluator, gpu_cgbf >::computeForces(uint64_t timestep)
                              box,
                              d_gpu_bondlist.data,
                              gpu_table_indexer,
+                             d_gpu_table_offsets.data,
                              d_gpu_n_bonds.data,
                              this->m_bond_data->getNTypes(),
-                             this->m_tuner->getParam()),
+                             this->m_tuner->getParam(),
+                             this->m_pdata->getGPUPartition(),
+                             this->m_stream),
                  d_params.data,
                  d_flags.data);
         }
+    this->m_exec_conf->endMultiGPU();
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
         {
@@ -53,10 +53,29 @@ class PotentialExternal: public ForceCompute
         GPUArray<param_type>    m_params;        //!< Array of per-type parameters
         std::string             m_log_name;               //!< Cached log name
         GPUArray<field_type>    m_field;
+        bool                    m_field_changed;          //!< True when the field must be prepared again
 
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
 
+        //! Let the evaluator prepare the field after the field, the parameters, or the box change
+        void prepareField()
+            {
+            if (!m_field_changed)
+                return;
+
+            ArrayHandle<field_type> h_field(m_field, access_location::host, access_mode::readwrite);
+            ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+            evaluator::prepareField(*h_field.data, m_pdata->getGlobalBox(), h_params.data, m_pdata->getNTypes());
+            m_field_changed = false;
+            }
+
+        //! Method to be called when the box changes
+        void slotBoxChanged()
+            {
+            m_field_changed = true;
+            }
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -69,6 +88,7 @@ class PotentialExternal: public ForceCompute
             // reallocate parameter array
             GPUArray<param_type> params(m_pdata->getNTypes(), m_exec_conf);
             m_params.swap(params);
+            m_field_changed = true;
             }
    };
 
@@ -79,7 +99,7 @@ class PotentialExternal: public ForceCompute
 template<class evaluator>
 PotentialExternal<evaluator>::PotentialExternal(std::shared_ptr<SystemDefinition> sysdef,
                          const std::string& log_suffix)
-    : ForceCompute(sysdef)
+    : ForceCompute(sysdef), m_field_changed(true)
     {
     m_log_name = std::string("external_") + evaluator::getName() + std::string("_energy") + log_suffix;
 
@@ -91,6 +111,7 @@ PotentialExternal<evaluator>::PotentialExternal(std::shared_ptr<SystemDefinition
 
     // connect to the ParticleData to receive notifications when the maximum number of particles changes
     m_pdata->getNumTypesChangeSignal().template connect<PotentialExternal<evaluator>, &PotentialExternal<evaluator>::slotNumTypesChange>(this);
+    m_pdata->getBoxChangeSignal().template connect<PotentialExternal<evaluator>, &PotentialExternal<evaluator>::slotBoxChanged>(this);
     }
 
 /*! Destructor
@@ -99,6 +120,7 @@ template<class evaluator>
 PotentialExternal<evaluator>::~PotentialExternal()
     {
     m_pdata->getNumTypesChangeSignal().template disconnect<PotentialExternal<evaluator>, &PotentialExternal<evaluator>::slotNumTypesChange>(this);
+    m_pdata->getBoxChangeSignal().template disconnect<PotentialExternal<evaluator>, &PotentialExternal<evaluator>::slotBoxChanged>(this);
     }
 
 /*! PotentialExternal provides
@@ -137,6 +159,8 @@ template<class evaluator>
 void PotentialExternal<evaluator>::computeForces(uint64_t timestep)
     {
 
+    prepareField();
+
     if (m_prof) m_prof->push("PotentialExternal");
 
     assert(m_pdata);
@@ -230,6 +254,7 @@ void PotentialExternal<evaluator>::setParams(unsigned int type, param_type param
 
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::readwrite);
     h_params.data[type] = params;
+    m_field_changed = true;
     }
 
 template<class evaluator>
@@ -237,6 +262,7 @@ void PotentialExternal<evaluator>::setField(field_type field)
     {
     ArrayHandle<field_type> h_field(m_field, access_location::host, access_mode::overwrite);
     *(h_field.data) = field;
+    m_field_changed = true;
     }
 
 //! Export this external potential to python
@@ -29,7 +29,8 @@ struct external_potential_args_t
               const Scalar *_d_diameter,
               const Scalar *_d_charge,
               const BoxDim& _box,
-              const unsigned int _block_size)
+              const unsigned int _block_size,
+              hipStream_t _stream = 0)
                 : d_force(_d_force),
                   d_virial(_d_virial),
                   virial_pitch(_virial_pitch),
@@ -38,7 +39,8 @@ struct external_potential_args_t
                   d_pos(_d_pos),
                   d_diameter(_d_diameter),
                   d_charge(_d_charge),
-                  block_size(_block_size)
+                  block_size(_block_size),
+                  stream(_stream)
         {
         };
 
@@ -51,6 +53,7 @@ struct external_potential_args_t
     const Scalar *d_diameter;       //!< particle diameters
     const Scalar *d_charge;         //!< particle charges
     const unsigned int block_size;  //!< Block size to execute
+    hipStream_t stream;             //!< Stream to launch the kernel on
     };
 
 //! Driver function for compute external field kernel
@@ -189,7 +192,7 @@ hipError_t gpu_cpef(const external_potential_args_t& external_potential_args,
         unsigned int bytes = (sizeof(typename evaluator::field_type)/sizeof(int)+1)*sizeof(int);
 
         // run the kernel
-        hipLaunchKernelGGL((gpu_compute_external_forces_kernel<evaluator>), dim3(grid), dim3(threads), bytes, 0, external_potential_args.d_force,
+        hipLaunchKernelGGL((gpu_compute_external_forces_kernel<evaluator>), dim3(grid), dim3(threads), bytes, external_potential_args.stream, external_potential_args.d_force,
                                                                                 external_potential_args.d_virial,
                                                                                 external_potential_args.virial_pitch,
                                                                                 external_potential_args.N,
@@ -44,6 +44,12 @@ class PotentialExternalGPU : public PotentialExternal<evaluator>
             m_tuner->setEnabled(enable);
             }
 
+        //! External forces can be launched on a separate stream
+        virtual bool supportsStream()
+            {
+            return true;
+            }
+
     protected:
 
         //! Actually compute the forces
@@ -70,6 +76,8 @@ PotentialExternalGPU<evaluator>::PotentialExternalGPU(std::shared_ptr<SystemDefi
 template<class evaluator>
 void PotentialExternalGPU<evaluator>::computeForces(uint64_t timestep)
     {
+    this->prepareField();
+
     // start the profile
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, "PotentialExternalGPU");
 
@@ -97,7 +105,8 @@ void PotentialExternalGPU<evaluator>::computeForces(uint64_t timestep)
                          d_diameter.data,
                          d_charge.data,
                          box,
-                         this->m_tuner->getParam()),
+                         this->m_tuner->getParam(),
+                         this->m_stream),
                          d_params.data,
                          d_field.data);
 
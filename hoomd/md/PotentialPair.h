@@ -7,6 +7,7 @@
 #ifndef __POTENTIAL_PAIR_H__
 #define __POTENTIAL_PAIR_H__
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <memory>
@@ -20,6 +21,8 @@
 #include "NeighborList.h"
 #include "hoomd/GSDShapeSpecWriter.h"
 #include "hoomd/md/EvaluatorPairLJ.h"
+#include "EvaluatorPairBatch.h"
+#include "PairSplineTable.h"
 
 #ifdef ENABLE_HIP
 #include <hip/hip_runtime.h>
@@ -29,6 +32,12 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 
 /*! \file PotentialPair.h
     \brief Defines the template class for standard pair potentials
@@ -79,6 +88,23 @@
     potential evaluator class passed in. See the appropriate documentation for the evaluator for the definition of each
     element of the parameters.
 
+    When built with TBB, the CPU force loop is parallelized over particles. With a full neighbor list, each thread
+    only writes to the particles it owns. With a half neighbor list, each thread accumulates forces and virials into
+    private arrays that are summed after the loop.
+
+    The neighbors of each particle are processed in batches of PairEvaluatorBatch<evaluator>::width pairs. The pair
+    separations are first gathered into contiguous buffers, then evaluated with PairEvaluatorBatch, and finally
+    accumulated. Evaluators with a vectorized specialization of PairEvaluatorBatch use SIMD instructions, all others
+    evaluate one pair at a time.
+
+    With setTable(), the potential is instead evaluated from a cubic spline table in r^2 per type pair, which is built
+    from the evaluator whenever the parameters change (see updateTable()). Pairs closer than the lower bound of the
+    table are still evaluated with the evaluator. Only evaluators that need neither diameters nor charges can be
+    tabulated, since the table depends on r and the type pair alone.
+
+    With MPI and a ghost update left pending by the Communicator, computeForces() first evaluates the particles that
+    have no ghost neighbors, then completes the ghost update and evaluates the remaining particles.
+
     For profiling and logging, PotentialPair needs to know the name of the potential. For now, that will be queried from
     the evaluator. Perhaps in the future we could allow users to change that so multiple pair potentials could be logged
     independently.
@@ -141,6 +167,7 @@ class PotentialPair : public ForceCompute
         void setShiftMode(energyShiftMode mode)
             {
             m_shift_mode = mode;
+            m_table_dirty = true;
             }
 
         void setShiftModePython(std::string mode)
@@ -161,6 +188,7 @@ class PotentialPair : public ForceCompute
                 {
                 throw std::runtime_error("Invalid energy shift mode.");
                 }
+            m_table_dirty = true;
             }
 
         /// Get the mode used for the energy shifting
@@ -179,6 +207,27 @@ class PotentialPair : public ForceCompute
                 }
             }
 
+        //! Evaluate the potential from a cubic spline table
+        virtual void setTable(unsigned int width, Scalar r_min);
+
+        //! Get the number of knots of the table per type pair, 0 when the potential is not tabulated
+        unsigned int getTableWidth() const
+            {
+            return m_table_width;
+            }
+
+        //! Get the smallest distance covered by the table
+        Scalar getTableRMin() const
+            {
+            return m_table_r_min;
+            }
+
+        //! Get the largest force error of the table relative to the largest force of its type pair
+        Scalar getTableError() const
+            {
+            return m_table_error;
+            }
+
         virtual void notifyDetach()
             {
             if (m_attached)
@@ -191,8 +240,20 @@ class PotentialPair : public ForceCompute
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(uint64_t timestep);
+
+        //! Pair forces between local particles are computed while the ghost update is in flight
+        virtual bool overlapsGhostUpdate()
+            {
+            return true;
+            }
         #endif
 
+        //! The pair forces can be added directly to the net force
+        virtual bool canAccumulateNetForce()
+            {
+            return true;
+            }
+
         //! Calculates the energy between two lists of particles.
         template< class InputIterator >
         void computeEnergyBetweenSets(  InputIterator first1, InputIterator last1,
@@ -230,9 +291,26 @@ class PotentialPair : public ForceCompute
         /// r_cut (not squared) given to the neighbor list
         std::shared_ptr<GlobalArray<Scalar>> m_r_cut_nlist;
 
+        unsigned int m_table_width = 0;             //!< Number of knots per type pair, 0 to evaluate directly
+        Scalar m_table_r_min = Scalar(0.0);         //!< Smallest distance covered by the table
+        Scalar m_table_error = Scalar(0.0);         //!< Largest relative force error of the table
+        bool m_table_dirty = true;                  //!< True when the table must be rebuilt
+        GlobalArray<Scalar4> m_table;               //!< Spline coefficients of each interval, per type pair
+        GlobalArray<Scalar2> m_table_range;         //!< Lower bound in r^2 and inverse knot spacing per type pair
+
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
 
+        //! Build the spline table from the evaluator
+        void updateTable();
+
+        //! Compute the forces on a subset of the local particles
+        void computeParticleForces(const unsigned int *particles, unsigned int n, bool zero_forces);
+
+        //! Compute the forces on a subset of the local particles for the given flags
+        template<bool compute_virial, unsigned int shift_mode>
+        void evaluateParticleForces(const unsigned int *particles, unsigned int n, bool zero_forces);
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -303,6 +381,7 @@ class PotentialPair : public ForceCompute
 
             // set the new type pair indexer
             m_typpair_idx = new_type_pair_idx;
+            m_table_dirty = true;
 
             #if defined(ENABLE_HIP) && defined(__HIP_PLATFORM_NVCC__)
             if (m_pdata->getExecConf()->isCUDAEnabled() && m_pdata->getExecConf()->allConcurrentManagedAccess())
@@ -409,6 +488,7 @@ void PotentialPair< evaluator >::setParams(unsigned int typ1, unsigned int typ2,
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::readwrite);
     h_params.data[m_typpair_idx(typ1, typ2)] = param;
     h_params.data[m_typpair_idx(typ2, typ1)] = param;
+    m_table_dirty = true;
     }
 
 template< class evaluator >
@@ -465,6 +545,7 @@ void PotentialPair< evaluator >::setRcut(unsigned int typ1, unsigned int typ2, S
         h_r_cut_nlist.data[m_typpair_idx(typ1, typ2)] = rcut;
         h_r_cut_nlist.data[m_typpair_idx(typ2, typ1)] = rcut;
         }
+    m_table_dirty = true;
 
     // notify the neighbor list that we have changed r_cut values
     m_nlist->notifyRCutMatrixChange();
@@ -504,6 +585,7 @@ void PotentialPair< evaluator >::setRon(unsigned int typ1, unsigned int typ2, Sc
                                 access_mode::readwrite);
     h_ronsq.data[m_typpair_idx(typ1, typ2)] = ron * ron;
     h_ronsq.data[m_typpair_idx(typ2, typ1)] = ron * ron;
+    m_table_dirty = true;
     }
 
 template< class evaluator >
@@ -526,6 +608,138 @@ void PotentialPair< evaluator >::setROnPython(pybind11::tuple types,
     setRon(typ1, typ2, r_on);
     }
 
+/*! \param width Number of knots of the table per type pair, 0 to evaluate the potential directly
+    \param r_min Smallest distance covered by the table
+
+    Pairs closer than \a r_min are evaluated directly. The table is built the next time the forces are computed.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::setTable(unsigned int width, Scalar r_min)
+    {
+    if (width > 0 && (evaluator::needsDiameter() || evaluator::needsCharge()))
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName()
+                                  << ": potentials that depend on the diameter or charge cannot be tabulated"
+                                  << std::endl;
+        throw std::runtime_error("Error setting the pair potential table");
+        }
+    if (width == 1 || r_min < Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName()
+                                  << ": the table needs at least 2 knots and a non-negative r_min" << std::endl;
+        throw std::runtime_error("Error setting the pair potential table");
+        }
+
+    m_table_width = width;
+    m_table_r_min = r_min;
+    m_table_dirty = true;
+    }
+
+/*! For each type pair, the evaluator is sampled at \a m_table_width evenly spaced knots in r^2 between r_min^2 and
+    r_cut^2, with the energy shift applied as in computeParticleForces(). The energy and its derivative at the knots
+    define a cubic Hermite spline in each interval, see evalPairSplineTable(). The XPLOR smoothing is applied to the
+    tabulated values when the forces are computed, as it is for the evaluator.
+
+    The spline is then compared to the evaluator at the middle of every interval, where the error is largest. A
+    warning is issued when the force error exceeds 1e-4 of the largest force magnitude in the table of that type pair.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::updateTable()
+    {
+    const unsigned int n_typpair = m_typpair_idx.getNumElements();
+    const unsigned int n_intervals = m_table_width - 1;
+
+    if (m_table.getNumElements() != n_typpair*n_intervals)
+        {
+        GlobalArray<Scalar4> table(n_typpair*n_intervals, m_exec_conf);
+        m_table.swap(table);
+        TAG_ALLOCATION(m_table);
+        }
+    if (m_table_range.getNumElements() != n_typpair)
+        {
+        GlobalArray<Scalar2> table_range(n_typpair, m_exec_conf);
+        m_table_range.swap(table_range);
+        TAG_ALLOCATION(m_table_range);
+        }
+
+    ArrayHandle<Scalar4> h_table(m_table, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar2> h_table_range(m_table_range, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
+    ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+
+    const Scalar x_min = m_table_r_min*m_table_r_min;
+    m_table_error = Scalar(0.0);
+
+    for (unsigned int typpair = 0; typpair < n_typpair; typpair++)
+        {
+        const Scalar rcutsq = h_rcutsq.data[typpair];
+        const param_type& param = h_params.data[typpair];
+        const bool energy_shift = m_shift_mode == shift || (m_shift_mode == xplor && h_ronsq.data[typpair] > rcutsq);
+        Scalar4 *table = h_table.data + typpair*n_intervals;
+
+        if (x_min >= rcutsq)
+            {
+            // the table is empty and all pairs are evaluated directly
+            h_table_range.data[typpair] = make_scalar2(rcutsq, Scalar(0.0));
+            std::fill(table, table + n_intervals, make_scalar4(0, 0, 0, 0));
+            continue;
+            }
+
+        const Scalar dx = (rcutsq - x_min)/Scalar(n_intervals);
+        const Scalar2 range = make_scalar2(x_min, Scalar(1.0)/dx);
+        h_table_range.data[typpair] = range;
+
+        // evaluate the potential at x = r^2
+        auto eval_at = [&](Scalar x, Scalar& force_divr, Scalar& pair_eng)
+            {
+            force_divr = Scalar(0.0);
+            pair_eng = Scalar(0.0);
+            evaluator eval(x, rcutsq, param);
+            eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+            };
+
+        Scalar f0, v0;
+        eval_at(x_min, f0, v0);
+        Scalar max_force = fabs(f0)*sqrt(x_min);
+        Scalar max_error(0.0);
+
+        for (unsigned int k = 0; k < n_intervals; k++)
+            {
+            // the evaluator is zero at r_cut, so sample the last knot just inside of it
+            const Scalar x1 = (k == n_intervals - 1) ? std::nextafter(rcutsq, Scalar(0.0)) : x_min + Scalar(k+1)*dx;
+            Scalar f1, v1;
+            eval_at(x1, f1, v1);
+
+            // dV/du = dV/dx dx and F/r = -2 dV/dx
+            table[k] = makePairSplineInterval(v0, Scalar(-0.5)*f0*dx, v1, Scalar(-0.5)*f1*dx);
+
+            const Scalar x_mid = x_min + (Scalar(k) + Scalar(0.5))*dx;
+            Scalar f_mid, v_mid, f_table, v_table;
+            eval_at(x_mid, f_mid, v_mid);
+            evalPairSplineTable(f_table, v_table, x_mid, table, range, m_table_width);
+
+            max_error = std::max(max_error, Scalar(fabs(f_table - f_mid)*sqrt(x_mid)));
+            max_force = std::max(max_force, Scalar(std::max(fabs(f_mid)*sqrt(x_mid), fabs(f1)*sqrt(x1))));
+
+            f0 = f1;
+            v0 = v1;
+            }
+
+        if (max_force > Scalar(0.0))
+            m_table_error = std::max(m_table_error, max_error/max_force);
+        }
+
+    if (!(m_table_error <= Scalar(1e-4)))
+        {
+        m_exec_conf->msg->warning() << "pair." << evaluator::getName() << ": the table has a force error of "
+                                    << m_table_error << " relative to the largest force, "
+                                    << "increase the number of knots or r_min" << std::endl;
+        }
+
+    m_table_dirty = false;
+    }
+
 template <class evaluator>
 void PotentialPair<evaluator>::connectGSDShapeSpec(std::shared_ptr<GSDDumpWriter> writer)
     {
@@ -589,12 +803,126 @@ void PotentialPair< evaluator >::computeForces(uint64_t timestep)
     // start the profile for this compute
     if (m_prof) m_prof->push(m_prof_name);
 
+    if (m_table_width > 0 && m_table_dirty)
+        updateTable();
+
+    #ifdef ENABLE_MPI
+    if (m_comm && m_comm->isGhostUpdatePending())
+        {
+        // split the local particles into those without ghost neighbors, which can be computed while the ghost
+        // positions are still being received, and those that need the ghost positions
+        const unsigned int N = m_pdata->getN();
+        std::vector<unsigned int> interior;
+        std::vector<unsigned int> boundary;
+        interior.reserve(N);
+
+            {
+            ArrayHandle<unsigned int> h_n_neigh(m_nlist->getConsumerNNeighArray(m_r_cut_nlist),
+                                                access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+
+            for (unsigned int i = 0; i < N; i++)
+                {
+                const unsigned int myHead = h_head_list.data[i];
+                const unsigned int size = (unsigned int)h_n_neigh.data[i];
+                bool has_ghost = false;
+                for (unsigned int k = 0; k < size; k++)
+                    {
+                    if (h_nlist.data[myHead + k] >= N)
+                        {
+                        has_ghost = true;
+                        break;
+                        }
+                    }
+
+                if (has_ghost)
+                    boundary.push_back(i);
+                else
+                    interior.push_back(i);
+                }
+            }
+
+        computeParticleForces(interior.data(), (unsigned int)interior.size(), true);
+
+        // all handles are released at this point, so the communicator may access the particle data
+        m_comm->completeGhostUpdate(timestep);
+
+        computeParticleForces(boundary.data(), (unsigned int)boundary.size(), false);
+        }
+    else
+    #endif
+        {
+        computeParticleForces(NULL, m_pdata->getN(), true);
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param particles Indices of the local particles to compute, or NULL to compute particles 0 through \a n-1
+    \param n Number of particles to compute
+    \param zero_forces Set to true to overwrite the force and virial arrays, false to add to them
+
+    With a half neighbor list, forces are also applied to the local neighbors j of the particles in the subset.
+    The loop is specialized for whether the virial is requested and for the energy shift mode.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeParticleForces(const unsigned int *particles,
+                                                       unsigned int n,
+                                                       bool zero_forces)
+    {
+    PDataFlags flags = this->m_pdata->getFlags();
+    if (flags[pdata_flag::pressure_tensor])
+        {
+        switch (m_shift_mode)
+            {
+            case no_shift:
+                evaluateParticleForces<true, no_shift>(particles, n, zero_forces);
+                break;
+            case shift:
+                evaluateParticleForces<true, shift>(particles, n, zero_forces);
+                break;
+            case xplor:
+                evaluateParticleForces<true, xplor>(particles, n, zero_forces);
+                break;
+            }
+        }
+    else
+        {
+        switch (m_shift_mode)
+            {
+            case no_shift:
+                evaluateParticleForces<false, no_shift>(particles, n, zero_forces);
+                break;
+            case shift:
+                evaluateParticleForces<false, shift>(particles, n, zero_forces);
+                break;
+            case xplor:
+                evaluateParticleForces<false, xplor>(particles, n, zero_forces);
+                break;
+            }
+        }
+    }
+
+/*! \tparam compute_virial True if the virial is computed
+    \tparam shift_mode Energy shift mode (an energyShiftMode)
+    \param particles Indices of the local particles to compute, or NULL to compute particles 0 through \a n-1
+    \param n Number of particles to compute
+    \param zero_forces Set to true to overwrite the force and virial arrays, false to add to them
+*/
+template< class evaluator >
+template< bool compute_virial, unsigned int shift_mode >
+void PotentialPair< evaluator >::evaluateParticleForces(const unsigned int *particles,
+                                                        unsigned int n,
+                                                        bool zero_forces)
+    {
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
 
     // access the neighbor list, particle data, and system box
-    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getConsumerNNeighArray(m_r_cut_nlist),
+                                        access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
 //     Index2D nli = m_nlist->getNListIndexer();
     ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
@@ -604,26 +932,73 @@ void PotentialPair< evaluator >::computeForces(uint64_t timestep)
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
 
-    //force arrays
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
+    //force arrays, which are the net force arrays when adding to the net force directly
+    const GlobalArray<Scalar4>& force_array = this->m_accumulating ? m_pdata->getNetForce() : m_force;
+    const GlobalArray<Scalar>& virial_array = this->m_accumulating ? m_pdata->getNetVirial() : m_virial;
+    const size_t virial_pitch = virial_array.getPitch();
+    zero_forces = zero_forces && !this->m_accumulating;
+    ArrayHandle<Scalar4> h_force(force_array,access_location::host,
+                                 zero_forces ? access_mode::overwrite : access_mode::readwrite);
+    ArrayHandle<Scalar>  h_virial(virial_array,access_location::host,
+                                  zero_forces ? access_mode::overwrite : access_mode::readwrite);
 
 
     const BoxDim& box = m_pdata->getGlobalBox();
     ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
-
-    PDataFlags flags = this->m_pdata->getFlags();
-    bool compute_virial = flags[pdata_flag::pressure_tensor];
+    ArrayHandle<Scalar4> h_table(m_table, access_location::host, access_mode::read);
+    ArrayHandle<Scalar2> h_table_range(m_table_range, access_location::host, access_mode::read);
+    const unsigned int table_width = m_table_width;
 
     // need to start from a zero force, energy and virial
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (zero_forces)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*force_array.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*virial_array.getNumElements());
+        }
+
+    const unsigned int N = m_pdata->getN();
+
+    // number of neighbors gathered and evaluated together
+    const unsigned int batch_width = PairEvaluatorBatch<evaluator>::width;
+
+    #ifdef ENABLE_TBB
+    // with a half neighbor list, several threads may add to the same particle j concurrently, so each thread
+    // accumulates into a private copy of the force and virial arrays which are reduced at the end
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_force;
+    tbb::enumerable_thread_specific< std::vector<Scalar> > thread_virial;
+
+    // for each particle
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    Scalar4 *force = h_force.data;
+    Scalar *virial = h_virial.data;
+    if (third_law)
+        {
+        bool exists = false;
+        std::vector<Scalar4>& my_force = thread_force.local(exists);
+        std::vector<Scalar>& my_virial = thread_virial.local();
+        if (!exists)
+            {
+            my_force.resize(N, make_scalar4(0,0,0,0));
+            my_virial.resize(6*virial_pitch, Scalar(0.0));
+            }
+        force = my_force.data();
+        virial = my_virial.data();
+        }
+
+    for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
+    Scalar4 *force = h_force.data;
+    Scalar *virial = h_virial.data;
 
     // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    for (unsigned int idx = 0; idx < n; idx++)
+    #endif
         {
+        const unsigned int i = particles ? particles[idx] : idx;
+
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
@@ -649,72 +1024,146 @@ void PotentialPair< evaluator >::computeForces(uint64_t timestep)
         Scalar virialyzi = 0.0;
         Scalar virialzzi = 0.0;
 
-        // loop over all of the neighbors of this particle
+        // loop over all of the neighbors of this particle, one batch at a time
         const unsigned int myHead = h_head_list.data[i];
         const unsigned int size = (unsigned int)h_n_neigh.data[i];
-        for (unsigned int k = 0; k < size; k++)
+        for (unsigned int k_start = 0; k_start < size; k_start += batch_width)
             {
-            // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[myHead + k];
-            assert(j < m_pdata->getN() + m_pdata->getNGhosts());
-
-            // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-            Scalar3 dx = pi - pj;
-
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
-            assert(typej < m_pdata->getNTypes());
-
-            // access diameter and charge (if needed)
-            Scalar dj = Scalar(0.0);
-            Scalar qj = Scalar(0.0);
-            if (evaluator::needsDiameter())
-                dj = h_diameter.data[j];
-            if (evaluator::needsCharge())
-                qj = h_charge.data[j];
-
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // calculate r_ij squared (FLOPS: 5)
-            Scalar rsq = dot(dx, dx);
-
-            // get parameters for this type pair
-            unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
-            Scalar ronsq = Scalar(0.0);
-            if (m_shift_mode == xplor)
-                ronsq = h_ronsq.data[typpair_idx];
-
-            // design specifies that energies are shifted if
-            // 1) shift mode is set to shift
-            // or 2) shift mode is explor and ron > rcut
-            bool energy_shift = false;
-            if (m_shift_mode == shift)
-                energy_shift = true;
-            else if (m_shift_mode == xplor)
+            const unsigned int n_batch = std::min(batch_width, size - k_start);
+
+            unsigned int j_batch[batch_width];
+            Scalar3 dx_batch[batch_width];
+            Scalar rsq_batch[batch_width];
+            Scalar rcutsq_batch[batch_width];
+            Scalar ronsq_batch[batch_width];
+            unsigned int typpair_batch[batch_width];
+            Scalar dj_batch[batch_width];
+            Scalar qj_batch[batch_width];
+            bool energy_shift_batch[batch_width];
+            Scalar force_divr_batch[batch_width];
+            Scalar pair_eng_batch[batch_width];
+            bool evaluated_batch[batch_width];
+
+            // gather the pair separations and parameters of this batch
+            for (unsigned int b = 0; b < n_batch; b++)
                 {
-                if (ronsq > rcutsq)
+                // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                unsigned int j = h_nlist.data[myHead + k_start + b];
+                assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+                // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+                Scalar3 dx = pi - pj;
+
+                // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
+                unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+                assert(typej < m_pdata->getNTypes());
+
+                // access diameter and charge (if needed)
+                Scalar dj = Scalar(0.0);
+                Scalar qj = Scalar(0.0);
+                if (evaluator::needsDiameter())
+                    dj = h_diameter.data[j];
+                if (evaluator::needsCharge())
+                    qj = h_charge.data[j];
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
+
+                // get parameters for this type pair
+                unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                Scalar ronsq = Scalar(0.0);
+                if (shift_mode == xplor)
+                    ronsq = h_ronsq.data[typpair_idx];
+
+                // design specifies that energies are shifted if
+                // 1) shift mode is set to shift
+                // or 2) shift mode is explor and ron > rcut
+                bool energy_shift = false;
+                if (shift_mode == shift)
                     energy_shift = true;
+                else if (shift_mode == xplor)
+                    {
+                    if (ronsq > rcutsq)
+                        energy_shift = true;
+                    }
+
+                j_batch[b] = j;
+                dx_batch[b] = dx;
+                // calculate r_ij squared (FLOPS: 5)
+                rsq_batch[b] = dot(dx, dx);
+                rcutsq_batch[b] = rcutsq;
+                ronsq_batch[b] = ronsq;
+                typpair_batch[b] = typpair_idx;
+                dj_batch[b] = dj;
+                qj_batch[b] = qj;
+                energy_shift_batch[b] = energy_shift;
                 }
 
-            // compute the force and potential energy
-            Scalar force_divr = Scalar(0.0);
-            Scalar pair_eng = Scalar(0.0);
-            evaluator eval(rsq, rcutsq, param);
-            if (evaluator::needsDiameter())
-                eval.setDiameter(di, dj);
-            if (evaluator::needsCharge())
-                eval.setCharge(qi, qj);
+            // compute the force and potential energy of all pairs in the batch
+            if (table_width > 0)
+                {
+                // pairs inside the table are interpolated, closer pairs are evaluated directly
+                for (unsigned int b = 0; b < n_batch; b++)
+                    {
+                    const unsigned int typpair_idx = typpair_batch[b];
+                    force_divr_batch[b] = Scalar(0.0);
+                    pair_eng_batch[b] = Scalar(0.0);
+                    if (rsq_batch[b] >= rcutsq_batch[b])
+                        {
+                        evaluated_batch[b] = false;
+                        }
+                    else if (rsq_batch[b] >= h_table_range.data[typpair_idx].x)
+                        {
+                        evalPairSplineTable(force_divr_batch[b],
+                                            pair_eng_batch[b],
+                                            rsq_batch[b],
+                                            h_table.data + typpair_idx*(table_width - 1),
+                                            h_table_range.data[typpair_idx],
+                                            table_width);
+                        evaluated_batch[b] = true;
+                        }
+                    else
+                        {
+                        evaluator eval(rsq_batch[b], rcutsq_batch[b], h_params.data[typpair_idx]);
+                        evaluated_batch[b] = eval.evalForceAndEnergy(force_divr_batch[b],
+                                                                     pair_eng_batch[b],
+                                                                     energy_shift_batch[b]);
+                        }
+                    }
+                }
+            else
+                PairEvaluatorBatch<evaluator>::evalForceAndEnergy(n_batch,
+                                                              rsq_batch,
+                                                              rcutsq_batch,
+                                                              h_params.data,
+                                                              typpair_batch,
+                                                              di,
+                                                              dj_batch,
+                                                              qi,
+                                                              qj_batch,
+                                                              energy_shift_batch,
+                                                              force_divr_batch,
+                                                              pair_eng_batch,
+                                                              evaluated_batch);
+
+            // accumulate the results of this batch
+            for (unsigned int b = 0; b < n_batch; b++)
+                {
+                if (!evaluated_batch[b])
+                    continue;
 
-            bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+                const unsigned int j = j_batch[b];
+                const Scalar3 dx = dx_batch[b];
+                const Scalar rsq = rsq_batch[b];
+                const Scalar rcutsq = rcutsq_batch[b];
+                const Scalar ronsq = ronsq_batch[b];
+                Scalar force_divr = force_divr_batch[b];
+                Scalar pair_eng = pair_eng_batch[b];
 
-            if (evaluated)
-                {
                 // modify the potential for xplor shifting
-                if (m_shift_mode == xplor)
+                if (shift_mode == xplor)
                     {
                     if (rsq >= ronsq && rsq < rcutsq)
                         {
@@ -756,21 +1205,21 @@ void PotentialPair< evaluator >::computeForces(uint64_t timestep)
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
                 // only add force to local particles
-                if (third_law && j < m_pdata->getN())
+                if (third_law && j < N)
                     {
                     unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x*force_divr;
-                    h_force.data[mem_idx].y -= dx.y*force_divr;
-                    h_force.data[mem_idx].z -= dx.z*force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                    force[mem_idx].x -= dx.x*force_divr;
+                    force[mem_idx].y -= dx.y*force_divr;
+                    force[mem_idx].z -= dx.z*force_divr;
+                    force[mem_idx].w += pair_eng * Scalar(0.5);
                     if (compute_virial)
                         {
-                        h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
-                        h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
-                        h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
-                        h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
-                        h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
-                        h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
+                        virial[0*virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
+                        virial[1*virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
+                        virial[2*virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
+                        virial[3*virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
+                        virial[4*virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
+                        virial[5*virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
                         }
                     }
                 }
@@ -778,22 +1227,53 @@ void PotentialPair< evaluator >::computeForces(uint64_t timestep)
 
         // finally, increment the force, potential energy and virial for particle i
         unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
+        force[mem_idx].x += fi.x;
+        force[mem_idx].y += fi.y;
+        force[mem_idx].z += fi.z;
+        force[mem_idx].w += pei;
         if (compute_virial)
             {
-            h_virial.data[0*m_virial_pitch+mem_idx] += virialxxi;
-            h_virial.data[1*m_virial_pitch+mem_idx] += virialxyi;
-            h_virial.data[2*m_virial_pitch+mem_idx] += virialxzi;
-            h_virial.data[3*m_virial_pitch+mem_idx] += virialyyi;
-            h_virial.data[4*m_virial_pitch+mem_idx] += virialyzi;
-            h_virial.data[5*m_virial_pitch+mem_idx] += virialzzi;
+            virial[0*virial_pitch+mem_idx] += virialxxi;
+            virial[1*virial_pitch+mem_idx] += virialxyi;
+            virial[2*virial_pitch+mem_idx] += virialxzi;
+            virial[3*virial_pitch+mem_idx] += virialyyi;
+            virial[4*virial_pitch+mem_idx] += virialyzi;
+            virial[5*virial_pitch+mem_idx] += virialzzi;
             }
         }
+    #ifdef ENABLE_TBB
+        });
 
-    if (m_prof) m_prof->pop();
+    // reduce the per-thread accumulators of the half neighbor list path
+    if (third_law)
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+            for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+                {
+                const Scalar4 *my_force = it->data();
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    h_force.data[i].x += my_force[i].x;
+                    h_force.data[i].y += my_force[i].y;
+                    h_force.data[i].z += my_force[i].z;
+                    h_force.data[i].w += my_force[i].w;
+                    }
+                }
+
+            if (compute_virial)
+                {
+                for (auto it = thread_virial.begin(); it != thread_virial.end(); ++it)
+                    {
+                    const Scalar *my_virial = it->data();
+                    for (unsigned int k = 0; k < 6; ++k)
+                        for (unsigned int i = r.begin(); i != r.end(); ++i)
+                            h_virial.data[k*virial_pitch+i] += my_virial[k*virial_pitch+i];
+                    }
+                }
+            });
+        }
+    #endif
     }
 
 #ifdef ENABLE_MPI
@@ -1018,6 +1498,10 @@ template < class T > void export_PotentialPair(pybind11::module& m, const std::s
         .def("setROn", &T::setROnPython)
         .def("getROn", &T::getROn)
         .def_property("mode", &T::getShiftMode, &T::setShiftModePython)
+        .def("setTable", &T::setTable)
+        .def("getTableWidth", &T::getTableWidth)
+        .def("getTableRMin", &T::getTableRMin)
+        .def("getTableError", &T::getTableError)
         .def("computeEnergyBetweenSets", &T::computeEnergyBetweenSetsPythonList)
         .def("slotWriteGSDShapeSpec", &T::slotWriteGSDShapeSpec)
         .def("connectGSDShapeSpec", &T::connectGSDShapeSpec)
@@ -61,8 +61,31 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(uint64_t timestep);
+
+        //! The thermostat forces are computed in a single pass
+        virtual bool overlapsGhostUpdate()
+            {
+            return false;
+            }
         #endif
 
+        //! The thermostat forces are only written to the per-force arrays
+        virtual bool canAccumulateNetForce()
+            {
+            return false;
+            }
+
+        //! The thermostat forces depend on the relative velocity and cannot be tabulated
+        virtual void setTable(unsigned int width, Scalar r_min)
+            {
+            if (width > 0)
+                {
+                this->m_exec_conf->msg->error() << "pair." << evaluator::getName()
+                                                << ": DPD thermostat forces cannot be tabulated" << std::endl;
+                throw std::runtime_error("Error setting the pair potential table");
+                }
+            }
+
     protected:
 
         std::shared_ptr<Variant> m_T;     //!< Temperature for the DPD thermostat
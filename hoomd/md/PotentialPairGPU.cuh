@@ -11,6 +11,9 @@
 #include "hoomd/Index1D.h"
 
 #include "hoomd/GPUPartition.cuh"
+#include "ForceAccumulator.h"
+#include "PairSplineTable.h"
+#include "NeighborListGPUCluster.cuh"
 
 #ifdef __HIPCC__
 #include "hoomd/WarpTools.cuh"
@@ -80,7 +83,24 @@ struct pair_args_t
                   shift_mode(_shift_mode),
                   compute_virial(_compute_virial),
                   threads_per_particle(_threads_per_particle),
-                  gpu_partition(_gpu_partition)
+                  gpu_partition(_gpu_partition),
+                  d_cell_size(NULL),
+                  d_cell_xyzf(NULL),
+                  d_cell_tdb(NULL),
+                  d_cell_adj(NULL),
+                  ghost_width(make_scalar3(0,0,0)),
+                  d_cluster_idx(NULL),
+                  d_cluster_n_pairs(NULL),
+                  d_cluster_pair_j(NULL),
+                  d_cluster_pair_mask(NULL),
+                  n_clusters(0),
+                  max_cluster_pairs(0),
+                  d_half_accum(NULL),
+                  half_accum_pitch(0),
+                  d_table(NULL),
+                  d_table_range(NULL),
+                  table_width(0),
+                  stream(0)
         {
         };
 
@@ -105,10 +125,136 @@ struct pair_args_t
     const unsigned int compute_virial;  //!< Flag to indicate if virials should be computed
     const unsigned int threads_per_particle; //!< Number of threads per particle (maximum: 1 warp)
     const GPUPartition& gpu_partition;      //!< The load balancing partition of particles between GPUs
+
+    // the cell list is only set when the forces are computed without a neighbor list
+    const unsigned int *d_cell_size;   //!< Number of particles in each cell
+    const Scalar4 *d_cell_xyzf;        //!< Cell list with particle positions and indices
+    const Scalar4 *d_cell_tdb;         //!< Cell list with particle types and diameters
+    const unsigned int *d_cell_adj;    //!< Cell adjacency list
+    Index3D ci;                        //!< Cell indexer
+    Index2D cli;                       //!< Cell list indexer
+    Index2D cadji;                     //!< Cell adjacency indexer
+    Scalar3 ghost_width;               //!< Width of the ghost layer of the cell list
+
+    // the cluster pairs are only set when the neighbor list is a NeighborListGPUCluster
+    const unsigned int *d_cluster_idx;      //!< Particle indices of each cluster
+    const unsigned int *d_cluster_n_pairs;  //!< Number of cluster pairs of each cluster
+    const unsigned int *d_cluster_pair_j;   //!< Second cluster of each cluster pair
+    const uint2 *d_cluster_pair_mask;       //!< Interaction mask of each cluster pair
+    unsigned int n_clusters;                //!< Number of clusters
+    unsigned int max_cluster_pairs;         //!< Stride of the cluster pair arrays
+
+    // the accumulators are only set when the neighbor list stores each pair once
+    ForceAccum *d_half_accum;               //!< Force, energy, and virial accumulators for the half list kernel
+    size_t half_accum_pitch;                //!< Pitch of the accumulator components
+
+    // the table is only set when the potential is tabulated
+    const Scalar4 *d_table;            //!< Spline coefficients of the table intervals, per type pair
+    const Scalar2 *d_table_range;      //!< Lower bound in r^2 and inverse knot spacing of the table, per type pair
+    unsigned int table_width;          //!< Number of knots of the table per type pair
+
+    hipStream_t stream;                //!< Stream to launch the kernels on
     };
 
 #ifdef __HIPCC__
 
+//! Evaluate the force and energy of a single pair
+/*! \param force_divr Set to the force divided by r
+    \param pair_eng Set to the pair energy
+    \param rsq Squared distance between the particles
+    \param rcutsq Squared cutoff radius of the type pair
+    \param ronsq Squared XPLOR switching radius of the type pair
+    \param param Parameters of the type pair
+    \param di Diameter of particle i
+    \param dj Diameter of particle j
+    \param qi Charge of particle i
+    \param qj Charge of particle j
+    \param typpair Index of the type pair
+    \param d_table Spline table of the potential, NULL to always evaluate the potential directly
+    \param d_table_range Lower bound and inverse knot spacing of the table per type pair
+    \param table_width Number of knots of the table per type pair
+
+    The energy shift and XPLOR smoothing are applied according to \a shift_mode, see
+    gpu_compute_pair_forces_shared_kernel(). Pairs within the range of the table are interpolated with
+    evalPairSplineTable() instead of evaluating the potential.
+*/
+template< class evaluator, unsigned int shift_mode>
+__device__ inline void gpu_eval_pair(Scalar& force_divr,
+                                     Scalar& pair_eng,
+                                     const Scalar rsq,
+                                     const Scalar rcutsq,
+                                     const Scalar ronsq,
+                                     const typename evaluator::param_type& param,
+                                     const Scalar di,
+                                     const Scalar dj,
+                                     const Scalar qi,
+                                     const Scalar qj,
+                                     const unsigned int typpair,
+                                     const Scalar4 *d_table,
+                                     const Scalar2 *d_table_range,
+                                     const unsigned int table_width)
+    {
+    // design specifies that energies are shifted if
+    // 1) shift mode is set to shift
+    // or 2) shift mode is explor and ron > rcut
+    bool energy_shift = false;
+    if (shift_mode == 1)
+        energy_shift = true;
+    else if (shift_mode == 2)
+        {
+        if (ronsq > rcutsq)
+            energy_shift = true;
+        }
+
+    Scalar2 table_range = make_scalar2(rcutsq, Scalar(0.0));
+    if (d_table)
+        table_range = __ldg(d_table_range + typpair);
+
+    if (d_table && rsq >= table_range.x)
+        {
+        if (rsq < rcutsq)
+            evalPairSplineTable(force_divr,
+                                pair_eng,
+                                rsq,
+                                d_table + typpair*(table_width - 1),
+                                table_range,
+                                table_width);
+        }
+    else
+        {
+        evaluator eval(rsq, rcutsq, param);
+        if (evaluator::needsDiameter())
+            eval.setDiameter(di, dj);
+        if (evaluator::needsCharge())
+            eval.setCharge(qi, qj);
+
+        eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+        }
+
+    if (shift_mode == 2)
+        {
+        if (rsq >= ronsq && rsq < rcutsq)
+            {
+            // Implement XPLOR smoothing
+            Scalar old_pair_eng = pair_eng;
+            Scalar old_force_divr = force_divr;
+
+            // calculate 1.0 / (xplor denominator)
+            Scalar xplor_denom_inv =
+                Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+
+            Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
+            Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
+                       (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
+            Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
+
+            // make modifications to the old pair energy and force
+            pair_eng = old_pair_eng * s;
+            force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+            }
+        }
+    }
+
 //! Kernel for calculating pair forces
 /*! This kernel is called to calculate the pair forces on all N particles. Actual evaluation of the potentials and
     forces for each pair is handled via the template class \a evaluator.
@@ -129,6 +275,9 @@ struct pair_args_t
     \param d_ronsq ron squared, stored per type pair
     \param ntypes Number of types in the simulation
     \param offset Offset of first particle
+    \param d_table Spline table of the potential, or NULL when it is not tabulated
+    \param d_table_range Lower bound and inverse knot spacing of the table per type pair
+    \param table_width Number of knots of the table per type pair
 
     \a d_params, \a d_rcutsq, and \a d_ronsq must be indexed with an Index2DUpperTriangular(typei, typej) to access the
     unique value for that type pair. These values are all cached into shared memory for quick access, so a dynamic
@@ -163,7 +312,10 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
                                                const Scalar *d_rcutsq,
                                                const Scalar *d_ronsq,
                                                const unsigned int ntypes,
-                                               const unsigned int offset)
+                                               const unsigned int offset,
+                                               const Scalar4 *d_table,
+                                               const Scalar2 *d_table_range,
+                                               const unsigned int table_width)
     {
     Index2D typpair_idx(ntypes);
     const unsigned int num_typ_parameters = typpair_idx.getNumElements();
@@ -201,13 +353,13 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
     idx += offset;
 
     // initialize the force to 0
-    Scalar4 force = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
-    Scalar virialxx = Scalar(0.0);
-    Scalar virialxy = Scalar(0.0);
-    Scalar virialxz = Scalar(0.0);
-    Scalar virialyy = Scalar(0.0);
-    Scalar virialyz = Scalar(0.0);
-    Scalar virialzz = Scalar(0.0);
+    ForceAccum forcex(0), forcey(0), forcez(0), energy(0);
+    ForceAccum virialxx(0);
+    ForceAccum virialxy(0);
+    ForceAccum virialxz(0);
+    ForceAccum virialyy(0);
+    ForceAccum virialyz(0);
+    ForceAccum virialzz(0);
 
     if (active)
         {
@@ -271,87 +423,323 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
                 if (shift_mode == 2)
                     ronsq = s_ronsq[typpair];
 
-                // design specifies that energies are shifted if
-                // 1) shift mode is set to shift
-                // or 2) shift mode is explor and ron > rcut
-                bool energy_shift = false;
-                if (shift_mode == 1)
-                    energy_shift = true;
-                else if (shift_mode == 2)
-                    {
-                    if (ronsq > rcutsq)
-                        energy_shift = true;
-                    }
-
                 // evaluate the potential
                 Scalar force_divr = Scalar(0.0);
                 Scalar pair_eng = Scalar(0.0);
+                gpu_eval_pair<evaluator, shift_mode>(force_divr,
+                                                     pair_eng,
+                                                     rsq,
+                                                     rcutsq,
+                                                     ronsq,
+                                                     param,
+                                                     di,
+                                                     dj,
+                                                     qi,
+                                                     qj,
+                                                     typpair,
+                                                     d_table,
+                                                     d_table_range,
+                                                     table_width);
+
+                // calculate the virial
+                if (compute_virial)
+                    {
+                    Scalar force_div2r = Scalar(0.5) * force_divr;
+                    force_accum_add(virialxx, dx.x * dx.x * force_div2r);
+                    force_accum_add(virialxy, dx.x * dx.y * force_div2r);
+                    force_accum_add(virialxz, dx.x * dx.z * force_div2r);
+                    force_accum_add(virialyy, dx.y * dx.y * force_div2r);
+                    force_accum_add(virialyz, dx.y * dx.z * force_div2r);
+                    force_accum_add(virialzz, dx.z * dx.z * force_div2r);
+                    }
+
+                // add up the force vector components
+                force_accum_add(forcex, dx.x * force_divr);
+                force_accum_add(forcey, dx.y * force_divr);
+                force_accum_add(forcez, dx.z * force_divr);
+
+                force_accum_add(energy, pair_eng);
+                }
+            }
+        }
+
+    // reduce force over threads in cta
+    hoomd::detail::WarpReduce<ForceAccum, tpp> reducer;
+    forcex = reducer.Sum(forcex);
+    forcey = reducer.Sum(forcey);
+    forcez = reducer.Sum(forcez);
+    energy = reducer.Sum(energy);
+
+    // now that the force calculation is complete, write out the result
+    // potential energy per particle must be halved
+    if (active && threadIdx.x % tpp == 0)
+        d_force[idx] = make_scalar4(force_accum_value(forcex),
+                                    force_accum_value(forcey),
+                                    force_accum_value(forcez),
+                                    Scalar(0.5) * force_accum_value(energy));
+
+    if (compute_virial)
+        {
+        virialxx = reducer.Sum(virialxx);
+        virialxy = reducer.Sum(virialxy);
+        virialxz = reducer.Sum(virialxz);
+        virialyy = reducer.Sum(virialyy);
+        virialyz = reducer.Sum(virialyz);
+        virialzz = reducer.Sum(virialzz);
+
+        // if we are the first thread in the cta, write out virial to global mem
+        if (active && threadIdx.x %tpp == 0)
+            {
+            d_virial[0*virial_pitch+idx] = force_accum_value(virialxx);
+            d_virial[1*virial_pitch+idx] = force_accum_value(virialxy);
+            d_virial[2*virial_pitch+idx] = force_accum_value(virialxz);
+            d_virial[3*virial_pitch+idx] = force_accum_value(virialyy);
+            d_virial[4*virial_pitch+idx] = force_accum_value(virialyz);
+            d_virial[5*virial_pitch+idx] = force_accum_value(virialzz);
+            }
+        }
+    }
+
+//! Kernel for calculating pair forces without a neighbor list
+/*! This kernel computes the same forces as gpu_compute_pair_forces_shared_kernel(), but finds the neighbors of each
+    particle in the cell list instead of a neighbor list. The cells must be at least as wide as the largest cutoff.
+
+    \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param N number of particles in system
+    \param d_pos particle positions
+    \param d_diameter particle diameters
+    \param d_charge particle charges
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param d_cell_size Number of particles in each cell
+    \param d_cell_xyzf Cell list with particle positions and indices
+    \param d_cell_tdb Cell list with particle types and diameters
+    \param d_cell_adj Cell adjacency list
+    \param ci Cell indexer
+    \param cli Cell list indexer
+    \param cadji Cell adjacency indexer
+    \param ghost_width Width of the ghost layer of the cell list
+    \param d_params Parameters for the potential, stored per type pair
+    \param d_rcutsq rcut squared, stored per type pair
+    \param d_ronsq ron squared, stored per type pair
+    \param ntypes Number of types in the simulation
+    \param offset Offset of first particle
+    \param d_table Spline table of the potential, or NULL when it is not tabulated
+    \param d_table_range Lower bound and inverse knot spacing of the table per type pair
+    \param table_width Number of knots of the table per type pair
 
-                evaluator eval(rsq, rcutsq, param);
+    The template parameters and the shared memory layout are the same as for gpu_compute_pair_forces_shared_kernel().
+
+    <b>Implementation details</b>
+    Each group of \a tpp threads computes the total force on one particle, striding over the particles of each
+    adjacent cell. Sorting the cell list keeps the reads of neighboring threads close in memory.
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, int tpp>
+__global__ void gpu_compute_pair_forces_cell_kernel(Scalar4 *d_force,
+                                                    Scalar *d_virial,
+                                                    const size_t virial_pitch,
+                                                    const unsigned int N,
+                                                    const Scalar4 *d_pos,
+                                                    const Scalar *d_diameter,
+                                                    const Scalar *d_charge,
+                                                    const BoxDim box,
+                                                    const unsigned int *d_cell_size,
+                                                    const Scalar4 *d_cell_xyzf,
+                                                    const Scalar4 *d_cell_tdb,
+                                                    const unsigned int *d_cell_adj,
+                                                    const Index3D ci,
+                                                    const Index2D cli,
+                                                    const Index2D cadji,
+                                                    const Scalar3 ghost_width,
+                                                    const typename evaluator::param_type *d_params,
+                                                    const Scalar *d_rcutsq,
+                                                    const Scalar *d_ronsq,
+                                                    const unsigned int ntypes,
+                                                    const unsigned int offset,
+                                                    const Scalar4 *d_table,
+                                                    const Scalar2 *d_table_range,
+                                                    const unsigned int table_width)
+    {
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
+
+    // shared arrays for per type pair parameters
+    HIP_DYNAMIC_SHARED( char, s_data)
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(typename evaluator::param_type)]);
+    Scalar *s_ronsq = (Scalar *)(&s_data[num_typ_parameters*(sizeof(typename evaluator::param_type) + sizeof(Scalar))]);
+
+    // load in the per type pair parameters
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            if (shift_mode == 2)
+                s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    // start by identifying which particle we are to handle
+    unsigned int idx = blockIdx.x * (blockDim.x/tpp) + threadIdx.x/tpp;
+    bool active = true;
+    if (idx >= N)
+        {
+        // need to mask this thread, but still participate in warp-level reduction
+        active = false;
+        }
+
+    // add offset to get actual particle index
+    idx += offset;
+
+    // initialize the force to 0
+    ForceAccum forcex(0), forcey(0), forcez(0), energy(0);
+    ForceAccum virialxx(0);
+    ForceAccum virialxy(0);
+    ForceAccum virialxz(0);
+    ForceAccum virialyy(0);
+    ForceAccum virialyz(0);
+    ForceAccum virialzz(0);
+
+    if (active)
+        {
+        // read in the position of our particle.
+        Scalar4 postypei = __ldg(d_pos + idx);
+        Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+        unsigned int typei = __scalar_as_int(postypei.w);
+
+        Scalar di = Scalar(0);
+        if (evaluator::needsDiameter())
+            di = __ldg(d_diameter + idx);
+
+        Scalar qi = Scalar(0);
+        if (evaluator::needsCharge())
+            qi = __ldg(d_charge + idx);
+
+        // find the cell of this particle
+        Scalar3 f = box.makeFraction(posi, ghost_width);
+        int ib = (int)(f.x * ci.getW());
+        int jb = (int)(f.y * ci.getH());
+        int kb = (int)(f.z * ci.getD());
+
+        uchar3 periodic = box.getPeriodic();
+
+        // need to handle the case where the particle is exactly at the box hi
+        if (ib == ci.getW() && periodic.x)
+            ib = 0;
+        if (jb == ci.getH() && periodic.y)
+            jb = 0;
+        if (kb == ci.getD() && periodic.z)
+            kb = 0;
+
+        unsigned int my_cell = ci(ib,jb,kb);
+
+        // loop over the particles in the adjacent cells
+        for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); ++cur_adj)
+            {
+            unsigned int neigh_cell = __ldg(d_cell_adj + cadji(cur_adj, my_cell));
+            unsigned int size = __ldg(d_cell_size + neigh_cell);
+
+            for (unsigned int cur_offset = threadIdx.x%tpp; cur_offset < size; cur_offset += tpp)
+                {
+                Scalar4 cur_xyzf = __ldg(d_cell_xyzf + cli(cur_offset, neigh_cell));
+                unsigned int cur_j = __scalar_as_int(cur_xyzf.w);
+
+                // a particle does not interact with itself
+                if (cur_j == idx)
+                    continue;
+
+                Scalar4 cur_tdb = __ldg(d_cell_tdb + cli(cur_offset, neigh_cell));
+                Scalar3 posj = make_scalar3(cur_xyzf.x, cur_xyzf.y, cur_xyzf.z);
+
+                Scalar dj = Scalar(0.0);
                 if (evaluator::needsDiameter())
-                    eval.setDiameter(di, dj);
+                    dj = cur_tdb.y;
+
+                Scalar qj = Scalar(0.0);
                 if (evaluator::needsCharge())
-                    eval.setCharge(qi, qj);
+                    qj = __ldg(d_charge + cur_j);
 
-                eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+                // calculate dr (with periodic boundary conditions)
+                Scalar3 dx = posi - posj;
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
 
+                // calculate r squared
+                Scalar rsq = dot(dx, dx);
+
+                // access the per type pair parameters
+                unsigned int typpair = typpair_idx(typei, __scalar_as_int(cur_tdb.x));
+                Scalar rcutsq = s_rcutsq[typpair];
+
+                // most particles in the adjacent cells are outside of the cutoff
+                if (rsq >= rcutsq)
+                    continue;
+
+                typename evaluator::param_type param = s_params[typpair];
+                Scalar ronsq = Scalar(0.0);
                 if (shift_mode == 2)
-                    {
-                    if (rsq >= ronsq && rsq < rcutsq)
-                        {
-                        // Implement XPLOR smoothing
-                        Scalar old_pair_eng = pair_eng;
-                        Scalar old_force_divr = force_divr;
-
-                        // calculate 1.0 / (xplor denominator)
-                        Scalar xplor_denom_inv =
-                            Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
-
-                        Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
-                        Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
-                                   (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
-                        Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
-
-                        // make modifications to the old pair energy and force
-                        pair_eng = old_pair_eng * s;
-                        force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
-                        }
-                    }
+                    ronsq = s_ronsq[typpair];
+
+                // evaluate the potential
+                Scalar force_divr = Scalar(0.0);
+                Scalar pair_eng = Scalar(0.0);
+                gpu_eval_pair<evaluator, shift_mode>(force_divr,
+                                                     pair_eng,
+                                                     rsq,
+                                                     rcutsq,
+                                                     ronsq,
+                                                     param,
+                                                     di,
+                                                     dj,
+                                                     qi,
+                                                     qj,
+                                                     typpair,
+                                                     d_table,
+                                                     d_table_range,
+                                                     table_width);
+
                 // calculate the virial
                 if (compute_virial)
                     {
                     Scalar force_div2r = Scalar(0.5) * force_divr;
-                    virialxx +=  dx.x * dx.x * force_div2r;
-                    virialxy +=  dx.x * dx.y * force_div2r;
-                    virialxz +=  dx.x * dx.z * force_div2r;
-                    virialyy +=  dx.y * dx.y * force_div2r;
-                    virialyz +=  dx.y * dx.z * force_div2r;
-                    virialzz +=  dx.z * dx.z * force_div2r;
+                    force_accum_add(virialxx, dx.x * dx.x * force_div2r);
+                    force_accum_add(virialxy, dx.x * dx.y * force_div2r);
+                    force_accum_add(virialxz, dx.x * dx.z * force_div2r);
+                    force_accum_add(virialyy, dx.y * dx.y * force_div2r);
+                    force_accum_add(virialyz, dx.y * dx.z * force_div2r);
+                    force_accum_add(virialzz, dx.z * dx.z * force_div2r);
                     }
 
                 // add up the force vector components
-                force.x += dx.x * force_divr;
-                force.y += dx.y * force_divr;
-                force.z += dx.z * force_divr;
+                force_accum_add(forcex, dx.x * force_divr);
+                force_accum_add(forcey, dx.y * force_divr);
+                force_accum_add(forcez, dx.z * force_divr);
 
-                force.w += pair_eng;
+                force_accum_add(energy, pair_eng);
                 }
             }
-
-        // potential energy per particle must be halved
-        force.w *= Scalar(0.5);
         }
 
     // reduce force over threads in cta
-    hoomd::detail::WarpReduce<Scalar, tpp> reducer;
-    force.x = reducer.Sum(force.x);
-    force.y = reducer.Sum(force.y);
-    force.z = reducer.Sum(force.z);
-    force.w = reducer.Sum(force.w);
+    hoomd::detail::WarpReduce<ForceAccum, tpp> reducer;
+    forcex = reducer.Sum(forcex);
+    forcey = reducer.Sum(forcey);
+    forcez = reducer.Sum(forcez);
+    energy = reducer.Sum(energy);
 
     // now that the force calculation is complete, write out the result
+    // potential energy per particle must be halved
     if (active && threadIdx.x % tpp == 0)
-        d_force[idx] = force;
+        d_force[idx] = make_scalar4(force_accum_value(forcex),
+                                    force_accum_value(forcey),
+                                    force_accum_value(forcez),
+                                    Scalar(0.5) * force_accum_value(energy));
 
     if (compute_virial)
         {
@@ -365,16 +753,484 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
         // if we are the first thread in the cta, write out virial to global mem
         if (active && threadIdx.x %tpp == 0)
             {
-            d_virial[0*virial_pitch+idx] = virialxx;
-            d_virial[1*virial_pitch+idx] = virialxy;
-            d_virial[2*virial_pitch+idx] = virialxz;
-            d_virial[3*virial_pitch+idx] = virialyy;
-            d_virial[4*virial_pitch+idx] = virialyz;
-            d_virial[5*virial_pitch+idx] = virialzz;
+            d_virial[0*virial_pitch+idx] = force_accum_value(virialxx);
+            d_virial[1*virial_pitch+idx] = force_accum_value(virialxy);
+            d_virial[2*virial_pitch+idx] = force_accum_value(virialxz);
+            d_virial[3*virial_pitch+idx] = force_accum_value(virialyy);
+            d_virial[4*virial_pitch+idx] = force_accum_value(virialyz);
+            d_virial[5*virial_pitch+idx] = force_accum_value(virialzz);
             }
         }
     }
 
+//! Kernel for calculating pair forces from a cluster pair list
+/*! This kernel computes the same forces as gpu_compute_pair_forces_shared_kernel(), but reads the neighbors from the
+    cluster pairs of a NeighborListGPUCluster.
+
+    \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param N number of particles in system
+    \param d_pos particle positions
+    \param d_diameter particle diameters
+    \param d_charge particle charges
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param d_cluster_idx Particle indices of each cluster
+    \param d_cluster_n_pairs Number of cluster pairs of each cluster
+    \param d_cluster_pair_j Second cluster of each cluster pair
+    \param d_cluster_pair_mask Interaction mask of each cluster pair
+    \param n_clusters Number of clusters
+    \param max_cluster_pairs Stride of the cluster pair arrays
+    \param d_params Parameters for the potential, stored per type pair
+    \param d_rcutsq rcut squared, stored per type pair
+    \param d_ronsq ron squared, stored per type pair
+    \param ntypes Number of types in the simulation
+    \param d_table Spline table of the potential, or NULL when it is not tabulated
+    \param d_table_range Lower bound and inverse knot spacing of the table per type pair
+    \param table_width Number of knots of the table per type pair
+
+    The template parameters and the shared memory layout are the same as for gpu_compute_pair_forces_shared_kernel().
+
+    <b>Implementation details</b>
+    Each group of nlist_cluster_size threads handles one cluster, one thread per particle. The threads of a group read
+    the same cluster pair, so one index and one mask are loaded for up to nlist_cluster_size x nlist_cluster_size
+    particle pairs. Each thread takes its row of the mask and evaluates the marked particles of the second cluster.
+    The list is full, so every thread accumulates the total force on its particle without atomic operations.
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial>
+__global__ void gpu_compute_pair_forces_cluster_kernel(Scalar4 *d_force,
+                                                       Scalar *d_virial,
+                                                       const size_t virial_pitch,
+                                                       const unsigned int N,
+                                                       const Scalar4 *d_pos,
+                                                       const Scalar *d_diameter,
+                                                       const Scalar *d_charge,
+                                                       const BoxDim box,
+                                                       const unsigned int *d_cluster_idx,
+                                                       const unsigned int *d_cluster_n_pairs,
+                                                       const unsigned int *d_cluster_pair_j,
+                                                       const uint2 *d_cluster_pair_mask,
+                                                       const unsigned int n_clusters,
+                                                       const unsigned int max_cluster_pairs,
+                                                       const typename evaluator::param_type *d_params,
+                                                       const Scalar *d_rcutsq,
+                                                       const Scalar *d_ronsq,
+                                                       const unsigned int ntypes,
+                                                       const Scalar4 *d_table,
+                                                       const Scalar2 *d_table_range,
+                                                       const unsigned int table_width)
+    {
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
+
+    // shared arrays for per type pair parameters
+    HIP_DYNAMIC_SHARED( char, s_data)
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(typename evaluator::param_type)]);
+    Scalar *s_ronsq = (Scalar *)(&s_data[num_typ_parameters*(sizeof(typename evaluator::param_type) + sizeof(Scalar))]);
+
+    // load in the per type pair parameters
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            if (shift_mode == 2)
+                s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    // identify the cluster and the particle we are to handle
+    unsigned int slot = blockIdx.x * blockDim.x + threadIdx.x;
+    if (slot >= n_clusters*nlist_cluster_size)
+        return;
+
+    unsigned int idx = __ldg(d_cluster_idx + slot);
+
+    // forces are not computed for empty slots and ghost particles
+    if (idx >= N)
+        return;
+
+    unsigned int cluster_i = slot / nlist_cluster_size;
+    unsigned int a = slot % nlist_cluster_size;
+    unsigned int shift = (a % (32/nlist_cluster_size)) * nlist_cluster_size;
+
+    // read in the position of our particle.
+    Scalar4 postypei = __ldg(d_pos + idx);
+    Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+    unsigned int typei = __scalar_as_int(postypei.w);
+
+    Scalar di = Scalar(0);
+    if (evaluator::needsDiameter())
+        di = __ldg(d_diameter + idx);
+
+    Scalar qi = Scalar(0);
+    if (evaluator::needsCharge())
+        qi = __ldg(d_charge + idx);
+
+    // initialize the force to 0
+    ForceAccum forcex(0), forcey(0), forcez(0), energy(0);
+    ForceAccum virialxx(0);
+    ForceAccum virialxy(0);
+    ForceAccum virialxz(0);
+    ForceAccum virialyy(0);
+    ForceAccum virialyz(0);
+    ForceAccum virialzz(0);
+
+    unsigned int n_pairs = __ldg(d_cluster_n_pairs + cluster_i);
+    for (unsigned int p = 0; p < n_pairs; ++p)
+        {
+        uint2 mask = d_cluster_pair_mask[cluster_i*max_cluster_pairs + p];
+        unsigned int row = (((a < 32/nlist_cluster_size) ? mask.x : mask.y) >> shift)
+                           & ((1u << nlist_cluster_size) - 1);
+        if (!row)
+            continue;
+
+        unsigned int cluster_j = __ldg(d_cluster_pair_j + cluster_i*max_cluster_pairs + p);
+        while (row)
+            {
+            unsigned int b = __ffs(row) - 1;
+            row &= row - 1;
+
+            unsigned int cur_j = __ldg(d_cluster_idx + cluster_j*nlist_cluster_size + b);
+
+            // get the neighbor's position
+            Scalar4 postypej = __ldg(d_pos + cur_j);
+            Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+
+            Scalar dj = Scalar(0.0);
+            if (evaluator::needsDiameter())
+                dj = __ldg(d_diameter + cur_j);
+
+            Scalar qj = Scalar(0.0);
+            if (evaluator::needsCharge())
+                qj = __ldg(d_charge + cur_j);
+
+            // calculate dr (with periodic boundary conditions)
+            Scalar3 dx = posi - posj;
+
+            // apply periodic boundary conditions
+            dx = box.minImage(dx);
+
+            // calculate r squared
+            Scalar rsq = dot(dx, dx);
+
+            // access the per type pair parameters
+            unsigned int typpair = typpair_idx(typei, __scalar_as_int(postypej.w));
+            Scalar rcutsq = s_rcutsq[typpair];
+
+            // the mask includes the buffer layer
+            if (rsq >= rcutsq)
+                continue;
+
+            typename evaluator::param_type param = s_params[typpair];
+            Scalar ronsq = Scalar(0.0);
+            if (shift_mode == 2)
+                ronsq = s_ronsq[typpair];
+
+            // evaluate the potential
+            Scalar force_divr = Scalar(0.0);
+            Scalar pair_eng = Scalar(0.0);
+            gpu_eval_pair<evaluator, shift_mode>(force_divr,
+                                                 pair_eng,
+                                                 rsq,
+                                                 rcutsq,
+                                                 ronsq,
+                                                 param,
+                                                 di,
+                                                 dj,
+                                                 qi,
+                                                 qj,
+                                                 typpair,
+                                                 d_table,
+                                                 d_table_range,
+                                                 table_width);
+
+            // calculate the virial
+            if (compute_virial)
+                {
+                Scalar force_div2r = Scalar(0.5) * force_divr;
+                force_accum_add(virialxx, dx.x * dx.x * force_div2r);
+                force_accum_add(virialxy, dx.x * dx.y * force_div2r);
+                force_accum_add(virialxz, dx.x * dx.z * force_div2r);
+                force_accum_add(virialyy, dx.y * dx.y * force_div2r);
+                force_accum_add(virialyz, dx.y * dx.z * force_div2r);
+                force_accum_add(virialzz, dx.z * dx.z * force_div2r);
+                }
+
+            // add up the force vector components
+            force_accum_add(forcex, dx.x * force_divr);
+            force_accum_add(forcey, dx.y * force_divr);
+            force_accum_add(forcez, dx.z * force_divr);
+
+            force_accum_add(energy, pair_eng);
+            }
+        }
+
+    // potential energy per particle must be halved
+    d_force[idx] = make_scalar4(force_accum_value(forcex),
+                                force_accum_value(forcey),
+                                force_accum_value(forcez),
+                                Scalar(0.5) * force_accum_value(energy));
+
+    if (compute_virial)
+        {
+        d_virial[0*virial_pitch+idx] = force_accum_value(virialxx);
+        d_virial[1*virial_pitch+idx] = force_accum_value(virialxy);
+        d_virial[2*virial_pitch+idx] = force_accum_value(virialxz);
+        d_virial[3*virial_pitch+idx] = force_accum_value(virialyy);
+        d_virial[4*virial_pitch+idx] = force_accum_value(virialyz);
+        d_virial[5*virial_pitch+idx] = force_accum_value(virialzz);
+        }
+    }
+
+//! Kernel for calculating pair forces from a half neighbor list
+/*! This kernel computes the same forces as gpu_compute_pair_forces_shared_kernel(), but each pair is stored only
+    once in the neighbor list, as a neighbor of the particle with the smaller index.
+
+    \param d_accum Accumulators for the force, energy, and virial, component c of particle i at c*accum_pitch + i
+    \param accum_pitch Pitch of the accumulator components
+    \param N number of particles in system
+    \param d_pos particle positions
+    \param d_diameter particle diameters
+    \param d_charge particle charges
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param d_n_neigh Device memory array listing the number of neighbors for each particle
+    \param d_nlist Device memory array containing the neighbor list contents
+    \param d_head_list Indexes for reading \a d_nlist
+    \param d_params Parameters for the potential, stored per type pair
+    \param d_rcutsq rcut squared, stored per type pair
+    \param d_ronsq ron squared, stored per type pair
+    \param ntypes Number of types in the simulation
+    \param d_table Spline table of the potential, or NULL when it is not tabulated
+    \param d_table_range Lower bound and inverse knot spacing of the table per type pair
+    \param table_width Number of knots of the table per type pair
+
+    <b>Implementation details</b>
+    Each thread handles one particle i and evaluates every pair once. The sums for particle i are kept in registers
+    and added to the accumulators at the end, while the reaction on a local neighbor j is scattered immediately with
+    force_accum_atomic_add(). The accumulators must be zeroed before the launch, and
+    gpu_compute_pair_forces_half_finalize_kernel() converts them to forces and virials.
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial>
+__global__ void gpu_compute_pair_forces_half_kernel(ForceAccum *d_accum,
+                                                    const size_t accum_pitch,
+                                                    const unsigned int N,
+                                                    const Scalar4 *d_pos,
+                                                    const Scalar *d_diameter,
+                                                    const Scalar *d_charge,
+                                                    const BoxDim box,
+                                                    const unsigned int *d_n_neigh,
+                                                    const unsigned int *d_nlist,
+                                                    const unsigned int *d_head_list,
+                                                    const typename evaluator::param_type *d_params,
+                                                    const Scalar *d_rcutsq,
+                                                    const Scalar *d_ronsq,
+                                                    const unsigned int ntypes,
+                                                    const Scalar4 *d_table,
+                                                    const Scalar2 *d_table_range,
+                                                    const unsigned int table_width)
+    {
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
+
+    // shared arrays for per type pair parameters
+    HIP_DYNAMIC_SHARED( char, s_data)
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(typename evaluator::param_type)]);
+    Scalar *s_ronsq = (Scalar *)(&s_data[num_typ_parameters*(sizeof(typename evaluator::param_type) + sizeof(Scalar))]);
+
+    // load in the per type pair parameters
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            if (shift_mode == 2)
+                s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    // start by identifying which particle we are to handle
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N)
+        return;
+
+    // load in the length of the neighbor list
+    unsigned int n_neigh = d_n_neigh[idx];
+
+    // read in the position of our particle.
+    Scalar4 postypei = __ldg(d_pos + idx);
+    Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+
+    Scalar di = Scalar(0);
+    if (evaluator::needsDiameter())
+        di = __ldg(d_diameter + idx);
+
+    Scalar qi = Scalar(0);
+    if (evaluator::needsCharge())
+        qi = __ldg(d_charge + idx);
+
+    // initialize the force to 0
+    ForceAccum forcex(0), forcey(0), forcez(0), energy(0);
+    ForceAccum virialxx(0);
+    ForceAccum virialxy(0);
+    ForceAccum virialxz(0);
+    ForceAccum virialyy(0);
+    ForceAccum virialyz(0);
+    ForceAccum virialzz(0);
+
+    unsigned int my_head = d_head_list[idx];
+
+    // loop over neighbors
+    for (unsigned int neigh_idx = 0; neigh_idx < n_neigh; neigh_idx++)
+        {
+        // read the current neighbor index
+        unsigned int cur_j = __ldg(d_nlist + my_head + neigh_idx);
+
+        // get the neighbor's position
+        Scalar4 postypej = __ldg(d_pos + cur_j);
+        Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+
+        Scalar dj = Scalar(0.0);
+        if (evaluator::needsDiameter())
+            dj = __ldg(d_diameter + cur_j);
+
+        Scalar qj = Scalar(0.0);
+        if (evaluator::needsCharge())
+            qj = __ldg(d_charge + cur_j);
+
+        // calculate dr (with periodic boundary conditions)
+        Scalar3 dx = posi - posj;
+
+        // apply periodic boundary conditions
+        dx = box.minImage(dx);
+
+        // calculate r squared
+        Scalar rsq = dot(dx, dx);
+
+        // access the per type pair parameters
+        unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
+        Scalar rcutsq = s_rcutsq[typpair];
+        typename evaluator::param_type param = s_params[typpair];
+        Scalar ronsq = Scalar(0.0);
+        if (shift_mode == 2)
+            ronsq = s_ronsq[typpair];
+
+        // evaluate the potential
+        Scalar force_divr = Scalar(0.0);
+        Scalar pair_eng = Scalar(0.0);
+        gpu_eval_pair<evaluator, shift_mode>(force_divr,
+                                             pair_eng,
+                                             rsq,
+                                             rcutsq,
+                                             ronsq,
+                                             param,
+                                             di,
+                                             dj,
+                                             qi,
+                                             qj,
+                                             typpair,
+                                             d_table,
+                                             d_table_range,
+                                             table_width);
+
+        if (force_divr == Scalar(0.0) && pair_eng == Scalar(0.0))
+            continue;
+
+        Scalar force_div2r = Scalar(0.5) * force_divr;
+
+        // calculate the virial
+        if (compute_virial)
+            {
+            force_accum_add(virialxx, dx.x * dx.x * force_div2r);
+            force_accum_add(virialxy, dx.x * dx.y * force_div2r);
+            force_accum_add(virialxz, dx.x * dx.z * force_div2r);
+            force_accum_add(virialyy, dx.y * dx.y * force_div2r);
+            force_accum_add(virialyz, dx.y * dx.z * force_div2r);
+            force_accum_add(virialzz, dx.z * dx.z * force_div2r);
+            }
+
+        // add up the force vector components
+        force_accum_add(forcex, dx.x * force_divr);
+        force_accum_add(forcey, dx.y * force_divr);
+        force_accum_add(forcez, dx.z * force_divr);
+
+        force_accum_add(energy, Scalar(0.5) * pair_eng);
+
+        // scatter the reaction to the neighbor, ghost particles do not receive forces
+        if (cur_j < N)
+            {
+            force_accum_atomic_add(d_accum + 0*accum_pitch + cur_j, -dx.x * force_divr);
+            force_accum_atomic_add(d_accum + 1*accum_pitch + cur_j, -dx.y * force_divr);
+            force_accum_atomic_add(d_accum + 2*accum_pitch + cur_j, -dx.z * force_divr);
+            force_accum_atomic_add(d_accum + 3*accum_pitch + cur_j, Scalar(0.5) * pair_eng);
+            if (compute_virial)
+                {
+                force_accum_atomic_add(d_accum + 4*accum_pitch + cur_j, dx.x * dx.x * force_div2r);
+                force_accum_atomic_add(d_accum + 5*accum_pitch + cur_j, dx.x * dx.y * force_div2r);
+                force_accum_atomic_add(d_accum + 6*accum_pitch + cur_j, dx.x * dx.z * force_div2r);
+                force_accum_atomic_add(d_accum + 7*accum_pitch + cur_j, dx.y * dx.y * force_div2r);
+                force_accum_atomic_add(d_accum + 8*accum_pitch + cur_j, dx.y * dx.z * force_div2r);
+                force_accum_atomic_add(d_accum + 9*accum_pitch + cur_j, dx.z * dx.z * force_div2r);
+                }
+            }
+        }
+
+    // add the sums for particle i
+    force_accum_atomic_add(d_accum + 0*accum_pitch + idx, force_accum_value(forcex));
+    force_accum_atomic_add(d_accum + 1*accum_pitch + idx, force_accum_value(forcey));
+    force_accum_atomic_add(d_accum + 2*accum_pitch + idx, force_accum_value(forcez));
+    force_accum_atomic_add(d_accum + 3*accum_pitch + idx, force_accum_value(energy));
+    if (compute_virial)
+        {
+        force_accum_atomic_add(d_accum + 4*accum_pitch + idx, force_accum_value(virialxx));
+        force_accum_atomic_add(d_accum + 5*accum_pitch + idx, force_accum_value(virialxy));
+        force_accum_atomic_add(d_accum + 6*accum_pitch + idx, force_accum_value(virialxz));
+        force_accum_atomic_add(d_accum + 7*accum_pitch + idx, force_accum_value(virialyy));
+        force_accum_atomic_add(d_accum + 8*accum_pitch + idx, force_accum_value(virialyz));
+        force_accum_atomic_add(d_accum + 9*accum_pitch + idx, force_accum_value(virialzz));
+        }
+    }
+
+//! Kernel for writing the forces accumulated by gpu_compute_pair_forces_half_kernel()
+/*! \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param d_accum Accumulators for the force, energy, and virial
+    \param accum_pitch Pitch of the accumulator components
+    \param N number of particles in system
+*/
+template<unsigned int compute_virial>
+__global__ void gpu_compute_pair_forces_half_finalize_kernel(Scalar4 *d_force,
+                                                             Scalar *d_virial,
+                                                             const size_t virial_pitch,
+                                                             const ForceAccum *d_accum,
+                                                             const size_t accum_pitch,
+                                                             const unsigned int N)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N)
+        return;
+
+    d_force[idx] = make_scalar4(force_accum_value(d_accum[0*accum_pitch+idx]),
+                                force_accum_value(d_accum[1*accum_pitch+idx]),
+                                force_accum_value(d_accum[2*accum_pitch+idx]),
+                                force_accum_value(d_accum[3*accum_pitch+idx]));
+
+    if (compute_virial)
+        {
+        for (unsigned int i = 0; i < 6; ++i)
+            d_virial[i*virial_pitch+idx] = force_accum_value(d_accum[(4+i)*accum_pitch+idx]);
+        }
+    }
+
 template<typename T>
 int get_max_block_size(T func)
     {
@@ -423,6 +1279,81 @@ struct PairForceComputeKernel
             unsigned int shared_bytes = (unsigned int)((2*sizeof(Scalar) + sizeof(typename evaluator::param_type))
                                         * typpair_idx.getNumElements());
 
+            if (pair_args.d_half_accum)
+                {
+                // one thread per particle, the threads per particle are not used
+                static unsigned int max_block_size_half = UINT_MAX;
+                if (max_block_size_half == UINT_MAX)
+                    max_block_size_half = get_max_block_size(
+                        gpu_compute_pair_forces_half_kernel<evaluator, shift_mode, compute_virial>);
+
+                unsigned int half_block_size = block_size < max_block_size_half ? block_size : max_block_size_half;
+                unsigned int n_accum = compute_virial ? 10 : 4;
+                hipMemsetAsync(pair_args.d_half_accum, 0, sizeof(ForceAccum)*n_accum*pair_args.half_accum_pitch,
+                    pair_args.stream);
+
+                hipLaunchKernelGGL((gpu_compute_pair_forces_half_kernel<evaluator, shift_mode, compute_virial>),
+                    dim3(pair_args.N / half_block_size + 1), dim3(half_block_size), shared_bytes, pair_args.stream,
+                    pair_args.d_half_accum, pair_args.half_accum_pitch, pair_args.N, pair_args.d_pos,
+                    pair_args.d_diameter, pair_args.d_charge, pair_args.box, pair_args.d_n_neigh, pair_args.d_nlist,
+                    pair_args.d_head_list, d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes,
+                    pair_args.d_table, pair_args.d_table_range, pair_args.table_width);
+
+                static unsigned int max_block_size_finalize = UINT_MAX;
+                if (max_block_size_finalize == UINT_MAX)
+                    max_block_size_finalize = get_max_block_size(
+                        gpu_compute_pair_forces_half_finalize_kernel<compute_virial>);
+
+                unsigned int finalize_block_size = 256 < max_block_size_finalize ? 256 : max_block_size_finalize;
+                hipLaunchKernelGGL((gpu_compute_pair_forces_half_finalize_kernel<compute_virial>),
+                    dim3(pair_args.N / finalize_block_size + 1), dim3(finalize_block_size), 0, pair_args.stream,
+                    pair_args.d_force, pair_args.d_virial, pair_args.virial_pitch, pair_args.d_half_accum,
+                    pair_args.half_accum_pitch, pair_args.N);
+                return;
+                }
+
+            if (pair_args.d_cluster_pair_j)
+                {
+                // one thread per particle slot of a cluster, the threads per particle are not used
+                static unsigned int max_block_size_cluster = UINT_MAX;
+                if (max_block_size_cluster == UINT_MAX)
+                    max_block_size_cluster = get_max_block_size(
+                        gpu_compute_pair_forces_cluster_kernel<evaluator, shift_mode, compute_virial>);
+
+                block_size = block_size < max_block_size_cluster ? block_size : max_block_size_cluster;
+                unsigned int n_slots = pair_args.n_clusters*nlist_cluster_size;
+                dim3 grid(n_slots / block_size + 1, 1, 1);
+
+                hipLaunchKernelGGL((gpu_compute_pair_forces_cluster_kernel<evaluator, shift_mode, compute_virial>),
+                    dim3(grid), dim3(block_size), shared_bytes, pair_args.stream, pair_args.d_force,
+                    pair_args.d_virial, pair_args.virial_pitch, pair_args.N, pair_args.d_pos, pair_args.d_diameter,
+                    pair_args.d_charge, pair_args.box, pair_args.d_cluster_idx, pair_args.d_cluster_n_pairs,
+                    pair_args.d_cluster_pair_j, pair_args.d_cluster_pair_mask, pair_args.n_clusters,
+                    pair_args.max_cluster_pairs, d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes,
+                    pair_args.d_table, pair_args.d_table_range, pair_args.table_width);
+                return;
+                }
+
+            if (pair_args.d_cell_xyzf)
+                {
+                static unsigned int max_block_size_cell = UINT_MAX;
+                if (max_block_size_cell == UINT_MAX)
+                    max_block_size_cell = get_max_block_size(
+                        gpu_compute_pair_forces_cell_kernel<evaluator, shift_mode, compute_virial, tpp>);
+
+                block_size = block_size < max_block_size_cell ? block_size : max_block_size_cell;
+                dim3 grid(N / (block_size/tpp) + 1, 1, 1);
+
+                hipLaunchKernelGGL((gpu_compute_pair_forces_cell_kernel<evaluator, shift_mode, compute_virial, tpp>),
+                    dim3(grid), dim3(block_size), shared_bytes, pair_args.stream, pair_args.d_force, pair_args.d_virial,
+                    pair_args.virial_pitch, N, pair_args.d_pos, pair_args.d_diameter, pair_args.d_charge,
+                    pair_args.box, pair_args.d_cell_size, pair_args.d_cell_xyzf, pair_args.d_cell_tdb,
+                    pair_args.d_cell_adj, pair_args.ci, pair_args.cli, pair_args.cadji, pair_args.ghost_width,
+                    d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes, offset, pair_args.d_table,
+                    pair_args.d_table_range, pair_args.table_width);
+                return;
+                }
+
             static unsigned int max_block_size = UINT_MAX;
             if (max_block_size == UINT_MAX)
                 max_block_size = get_max_block_size(gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, tpp>);
@@ -430,10 +1361,12 @@ struct PairForceComputeKernel
             block_size = block_size < max_block_size ? block_size : max_block_size;
             dim3 grid(N / (block_size/tpp) + 1, 1, 1);
 
-            hipLaunchKernelGGL((gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, tpp>), dim3(grid), dim3(block_size), shared_bytes, 0, pair_args.d_force, pair_args.d_virial,
+            hipLaunchKernelGGL((gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, tpp>), dim3(grid),
+                dim3(block_size), shared_bytes, pair_args.stream, pair_args.d_force, pair_args.d_virial,
               pair_args.virial_pitch, N, pair_args.d_pos, pair_args.d_diameter,
               pair_args.d_charge, pair_args.box, pair_args.d_n_neigh, pair_args.d_nlist,
-              pair_args.d_head_list, d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes, offset);
+              pair_args.d_head_list, d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes, offset,
+              pair_args.d_table, pair_args.d_table_range, pair_args.table_width);
             }
         else
             {
@@ -456,7 +1389,10 @@ struct PairForceComputeKernel<evaluator, shift_mode, compute_virial, 0>
 /*! \param pair_args Other arguments to pass onto the kernel
     \param d_params Parameters for the potential, stored per type pair
 
-    This is just a driver function for gpu_compute_pair_forces_shared_kernel(), see it for details.
+    This is just a driver function for gpu_compute_pair_forces_shared_kernel(), see it for details. When the cell list
+    is set in \a pair_args, gpu_compute_pair_forces_cell_kernel() is launched instead, when the cluster pairs are
+    set, gpu_compute_pair_forces_cluster_kernel(), and when the half list accumulators are set,
+    gpu_compute_pair_forces_half_kernel().
 */
 template< class evaluator >
 hipError_t gpu_compute_pair_forces(const pair_args_t& pair_args,
@@ -13,8 +13,10 @@
 
 #include "PotentialPair.h"
 #include "PotentialPairGPU.cuh"
+#include "NeighborListGPUCluster.h"
 
 #include "hoomd/Autotuner.h"
+#include "hoomd/CellListGPU.h"
 
 /*! \file PotentialPairGPU.h
     \brief Defines the template class for standard pair potentials on the GPU
@@ -76,11 +78,90 @@ class PotentialPairGPU : public PotentialPair<evaluator>
             PotentialPair<evaluator>::setAutotunerParams(enable, period);
             m_tuner->setPeriod(period);
             m_tuner->setEnabled(enable);
+            m_tuner_cell->setPeriod(period);
+            m_tuner_cell->setEnabled(enable);
+            }
+
+        //! Set whether the forces are computed directly from a cell list
+        /*! \param enable True to find the neighbors in a cell list instead of the neighbor list
+
+            The cell list is rebuilt on every step and no neighbor list is stored, which pays off when the cutoff
+            is short and the neighbor list would be rebuilt every few steps anyway. The mode runs on a single GPU
+            and does not support exclusions, rigid body filtering or diameter shifting in the neighbor list.
+        */
+        void setCellListMode(bool enable)
+            {
+            if (enable && !m_cl)
+                {
+                m_cl = std::shared_ptr<CellList>(new CellListGPU(this->m_sysdef));
+                m_cl->setRadius(1);
+                m_cl->setComputeXYZF(true);
+                m_cl->setComputeTDB(true);
+                m_cl->setFlagIndex();
+                m_cl->setSortCellList(true);
+                #ifdef ENABLE_MPI
+                if (this->m_comm)
+                    m_cl->setCommunicator(this->m_comm);
+                #endif
+                }
+            m_cell_list_mode = enable;
+            }
+
+        //! Get whether the forces are computed directly from a cell list
+        bool getCellListMode()
+            {
+            return m_cell_list_mode;
+            }
+
+        #ifdef ENABLE_MPI
+        //! Set the communicator to use
+        /*! \param comm MPI communication class
+
+            The cell list needs the communicator to size its ghost layer.
+        */
+        virtual void setCommunicator(std::shared_ptr<Communicator> comm)
+            {
+            PotentialPair<evaluator>::setCommunicator(comm);
+            if (m_cl)
+                m_cl->setCommunicator(comm);
+            }
+
+        //! The GPU kernel computes all particles in a single pass
+        virtual bool overlapsGhostUpdate()
+            {
+            return false;
+            }
+        #endif
+
+        //! The GPU kernels write to the per-force arrays
+        virtual bool canAccumulateNetForce()
+            {
+            return false;
+            }
+
+        //! Pair forces can be launched on a separate stream
+        virtual bool supportsStream()
+            {
+            return true;
+            }
+
+        //! The neighbor list or cell list is updated on the default stream
+        virtual bool updatesInputsOnDefaultStream()
+            {
+            return true;
             }
 
     protected:
         std::unique_ptr<Autotuner> m_tuner;   //!< Autotuner for block size and threads per particle
         unsigned int m_param;                       //!< Kernel tuning parameter
+        std::unique_ptr<Autotuner> m_tuner_cell;    //!< Autotuner for the kernel without a neighbor list
+        std::shared_ptr<CellList> m_cl;             //!< Cell list used when there is no neighbor list
+        bool m_cell_list_mode;                      //!< True if the forces are computed from the cell list
+        Scalar m_cell_width;                        //!< Nominal width of the cells
+        GlobalArray<ForceAccum> m_half_accum;       //!< Force accumulators for the half neighbor list kernel
+
+        //! Check that the neighbor list options can be honored without a neighbor list, and update the cell list
+        void computeCellList(uint64_t timestep);
 
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
@@ -91,7 +172,7 @@ template< class evaluator, hipError_t gpu_cgpf(const pair_args_t& pair_args,
                                                 const typename evaluator::param_type *d_params)>
 PotentialPairGPU< evaluator, gpu_cgpf >::PotentialPairGPU(std::shared_ptr<SystemDefinition> sysdef,
                                                           std::shared_ptr<NeighborList> nlist, const std::string& log_suffix)
-    : PotentialPair<evaluator>(sysdef, nlist, log_suffix), m_param(0)
+    : PotentialPair<evaluator>(sysdef, nlist, log_suffix), m_param(0), m_cell_list_mode(false), m_cell_width(0)
     {
     // can't run on the GPU if there aren't any GPUs in the execution configuration
     if (!this->m_exec_conf->isCUDAEnabled())
@@ -115,33 +196,102 @@ PotentialPairGPU< evaluator, gpu_cgpf >::PotentialPairGPU(std::shared_ptr<System
         }
 
     m_tuner.reset(new Autotuner(valid_params, 5, 100000, "pair_" + evaluator::getName(), this->m_exec_conf));
+    m_tuner_cell.reset(new Autotuner(valid_params, 5, 100000, "pair_cell_" + evaluator::getName(),
+        this->m_exec_conf));
+    // time the block sizes and threads per particle in alternating sweeps instead of the full matrix
+    m_tuner->setSearch(Autotuner::search_coordinate_descent);
+    m_tuner_cell->setSearch(Autotuner::search_coordinate_descent);
     #ifdef ENABLE_MPI
     // synchronize autotuner results across ranks
     m_tuner->setSync(bool(this->m_pdata->getDomainDecomposition()));
+    m_tuner_cell->setSync(bool(this->m_pdata->getDomainDecomposition()));
     #endif
     }
 
+template< class evaluator, hipError_t gpu_cgpf(const pair_args_t& pair_args,
+                                                const typename evaluator::param_type *d_params)>
+void PotentialPairGPU< evaluator, gpu_cgpf >::computeCellList(uint64_t timestep)
+    {
+    // the cell list holds all pairs, so nothing can be filtered out
+    if (this->m_nlist->getExclusionsSet() || this->m_nlist->getFilterBody() || this->m_nlist->getDiameterShift())
+        {
+        this->m_exec_conf->msg->error() << "PotentialPairGPU cannot compute forces from the cell list with exclusions, "
+                  << "rigid body filtering or diameter shifting in the neighbor list" << std::endl;
+        throw std::runtime_error("Error computing forces in PotentialPairGPU");
+        }
+
+    if (this->m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        this->m_exec_conf->msg->error() << "PotentialPairGPU cannot compute forces from the cell list on multiple GPUs"
+                  << std::endl;
+        throw std::runtime_error("Error computing forces in PotentialPairGPU");
+        }
+
+    // the cells must be at least as wide as the largest cutoff
+    Scalar rcutsq_max = Scalar(0.0);
+        {
+        ArrayHandle<Scalar> h_rcutsq(this->m_rcutsq, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < this->m_rcutsq.getNumElements(); ++i)
+            rcutsq_max = std::max(rcutsq_max, h_rcutsq.data[i]);
+        }
+
+    Scalar width = std::max(fast::sqrt(rcutsq_max), Scalar(0.1));
+    if (width != m_cell_width)
+        {
+        m_cl->setNominalWidth(width);
+        m_cell_width = width;
+        }
+
+    m_cl->compute(timestep);
+    }
+
 template< class evaluator, hipError_t gpu_cgpf(const pair_args_t& pair_args,
                                                 const typename evaluator::param_type *d_params)>
 void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timestep)
     {
-    this->m_nlist->compute(timestep);
+    if (m_cell_list_mode)
+        computeCellList(timestep);
+    else
+        this->m_nlist->compute(timestep);
 
     // start the profile
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, this->m_prof_name);
 
-    // The GPU implementation CANNOT handle a half neighborlist, error out now
-    bool third_law = this->m_nlist->getStorageMode() == NeighborList::half;
+    // with a half neighborlist, each pair is evaluated once and the reaction is scattered to the neighbor
+    bool third_law = !m_cell_list_mode && this->m_nlist->getStorageMode() == NeighborList::half;
     if (third_law)
         {
-        this->m_exec_conf->msg->error() << "PotentialPairGPU cannot handle a half neighborlist"
-                  << std::endl;
-        throw std::runtime_error("Error computing forces in PotentialPairGPU");
+        if (this->m_exec_conf->getNumActiveGPUs() > 1)
+            {
+            this->m_exec_conf->msg->error() << "PotentialPairGPU cannot handle a half neighborlist on multiple GPUs"
+                      << std::endl;
+            throw std::runtime_error("Error computing forces in PotentialPairGPU");
+            }
+
+        // force, energy, and 6 virial components per particle
+        if (m_half_accum.getNumElements() < 10*(size_t)this->m_pdata->getMaxN())
+            {
+            GlobalArray<ForceAccum> half_accum(10*(size_t)this->m_pdata->getMaxN(), this->m_exec_conf);
+            m_half_accum.swap(half_accum);
+            TAG_ALLOCATION(m_half_accum);
+            }
         }
 
+    if (this->m_table_width > 0 && this->m_table_dirty)
+        this->updateTable();
+
+    // the out of core neighbor list is streamed to the device chunk by chunk
+    auto nlist_ooc = std::dynamic_pointer_cast<NeighborListGPU>(this->m_nlist);
+    if (m_cell_list_mode || (nlist_ooc && !nlist_ooc->getOutOfCore()))
+        nlist_ooc.reset();
+
     // access the neighbor list
-    ArrayHandle<unsigned int> d_n_neigh(this->m_nlist->getNNeighArray(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_nlist(this->m_nlist->getNListArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_n_neigh(this->m_nlist->getConsumerNNeighArray(this->m_r_cut_nlist),
+                                        access_location::device, access_mode::read);
+    const ArrayHandle<unsigned int>& d_nlist = !nlist_ooc ?
+        ArrayHandle<unsigned int>(this->m_nlist->getNListArray(), access_location::device, access_mode::read) :
+        ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
+    const size_t nlist_pitch = !nlist_ooc ? this->m_nlist->getNListArray().getPitch() : 0;
     ArrayHandle<unsigned int> d_head_list(this->m_nlist->getHeadList(), access_location::device, access_mode::read);
 
     // access the particle data
@@ -155,21 +305,28 @@ void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timestep)
     ArrayHandle<Scalar> d_ronsq(this->m_ronsq, access_location::device, access_mode::read);
     ArrayHandle<Scalar> d_rcutsq(this->m_rcutsq, access_location::device, access_mode::read);
     ArrayHandle<typename evaluator::param_type> d_params(this->m_params, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_table(this->m_table, access_location::device, access_mode::read);
+    ArrayHandle<Scalar2> d_table_range(this->m_table_range, access_location::device, access_mode::read);
 
     ArrayHandle<Scalar4> d_force(this->m_force, access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::readwrite);
+    ArrayHandle<ForceAccum> d_half_accum(m_half_accum, access_location::device, access_mode::overwrite);
 
     // access flags
     PDataFlags flags = this->m_pdata->getFlags();
 
     this->m_exec_conf->beginMultiGPU();
 
-    if (! m_param) this->m_tuner->begin();
-    unsigned int param = !m_param ?  this->m_tuner->getParam() : m_param;
+    Autotuner *tuner = m_cell_list_mode ? m_tuner_cell.get() : m_tuner.get();
+    if (! m_param) tuner->begin();
+    unsigned int param = !m_param ?  tuner->getParam() : m_param;
     unsigned int block_size = param / 10000;
     unsigned int threads_per_particle = param % 10000;
 
-    gpu_cgpf(pair_args_t(d_force.data,
+    // arguments for the particles in gpu_partition, with their neighbors in d_nlist_data
+    auto make_pair_args = [&](const unsigned int *d_nlist_data, const GPUPartition& gpu_partition)
+        {
+        pair_args_t args(d_force.data,
                          d_virial.data,
                          this->m_virial.getPitch(),
                          this->m_pdata->getN(),
@@ -179,22 +336,92 @@ void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timestep)
                          d_charge.data,
                          box,
                          d_n_neigh.data,
-                         d_nlist.data,
+                         d_nlist_data,
                          d_head_list.data,
                          d_rcutsq.data,
                          d_ronsq.data,
-                         this->m_nlist->getNListArray().getPitch(),
+                         nlist_pitch,
                          this->m_pdata->getNTypes(),
                          block_size,
                          this->m_shift_mode,
                          flags[pdata_flag::pressure_tensor],
                          threads_per_particle,
-                         this->m_pdata->getGPUPartition()),
-             d_params.data);
+                         gpu_partition);
+        args.stream = this->m_stream;
+        if (this->m_table_width > 0)
+            {
+            args.d_table = d_table.data;
+            args.d_table_range = d_table_range.data;
+            args.table_width = this->m_table_width;
+            }
+        return args;
+        };
+
+    pair_args_t pair_args = make_pair_args(d_nlist.data, this->m_pdata->getGPUPartition());
+    if (third_law)
+        {
+        pair_args.d_half_accum = d_half_accum.data;
+        pair_args.half_accum_pitch = this->m_pdata->getMaxN();
+        }
+
+    if (m_cell_list_mode)
+        {
+        // access the cell list
+        ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cell_xyzf(m_cl->getXYZFArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cell_tdb(m_cl->getTDBArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+        pair_args.d_cell_size = d_cell_size.data;
+        pair_args.d_cell_xyzf = d_cell_xyzf.data;
+        pair_args.d_cell_tdb = d_cell_tdb.data;
+        pair_args.d_cell_adj = d_cell_adj.data;
+        pair_args.ci = m_cl->getCellIndexer();
+        pair_args.cli = m_cl->getCellListIndexer();
+        pair_args.cadji = m_cl->getCellAdjIndexer();
+        pair_args.ghost_width = m_cl->getGhostWidth();
+
+        gpu_cgpf(pair_args, d_params.data);
+        }
+    else if (nlist_ooc)
+        {
+        // each chunk is evaluated on the stream that copied its neighbors while the next chunk is copied
+        nlist_ooc->streamChunks([&](const unsigned int *d_chunk_nlist, const GPUPartition& chunk, hipStream_t stream)
+            {
+            pair_args_t chunk_args = make_pair_args(d_chunk_nlist, chunk);
+            chunk_args.stream = stream;
+            gpu_cgpf(chunk_args, d_params.data);
+            }, this->m_stream);
+        }
+    else if (auto nlist_cluster = std::dynamic_pointer_cast<NeighborListGPUCluster>(this->m_nlist))
+        {
+        // evaluate the forces tile by tile from the cluster pairs
+        ArrayHandle<unsigned int> d_cluster_idx(nlist_cluster->getClusterIndexArray(),
+                                                access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cluster_n_pairs(nlist_cluster->getClusterNPairsArray(),
+                                                    access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cluster_pair_j(nlist_cluster->getClusterPairArray(),
+                                                   access_location::device, access_mode::read);
+        ArrayHandle<uint2> d_cluster_pair_mask(nlist_cluster->getClusterMaskArray(),
+                                               access_location::device, access_mode::read);
+
+        pair_args.d_cluster_idx = d_cluster_idx.data;
+        pair_args.d_cluster_n_pairs = d_cluster_n_pairs.data;
+        pair_args.d_cluster_pair_j = d_cluster_pair_j.data;
+        pair_args.d_cluster_pair_mask = d_cluster_pair_mask.data;
+        pair_args.n_clusters = nlist_cluster->getNumClusters();
+        pair_args.max_cluster_pairs = nlist_cluster->getMaxClusterPairs();
+
+        gpu_cgpf(pair_args, d_params.data);
+        }
+    else
+        {
+        gpu_cgpf(pair_args, d_params.data);
+        }
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
-    if (!m_param) this->m_tuner->end();
+    if (!m_param) tuner->end();
 
     this->m_exec_conf->endMultiGPU();
 
@@ -211,6 +438,8 @@ template < class T, class Base > void export_PotentialPairGPU(pybind11::module&
     pybind11::class_<T, Base, std::shared_ptr<T> >(m, name.c_str())
         .def(pybind11::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, const std::string& >())
         .def("setTuningParam",&T::setTuningParam)
+        .def("setCellListMode", &T::setCellListMode)
+        .def("getCellListMode", &T::getCellListMode)
     ;
     }
 
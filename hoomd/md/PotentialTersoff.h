@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <memory>
 #include <fstream>
+#include <vector>
 
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
@@ -16,6 +17,12 @@
 #include "hoomd/ForceCompute.h"
 #include "NeighborList.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 
 /*! \file PotentialTersoff.h
     \brief Defines the template class for standard three-body potentials
@@ -130,6 +137,17 @@ class PotentialTersoff : public ForceCompute
         // r_cut (not squared) given to the neighborlist
         std::shared_ptr<GlobalArray<Scalar>> m_r_cut_nlist;
 
+        //! Bond between a particle and one of its neighbors, cached while computing the forces on the particle
+        struct bond_data
+            {
+            Scalar3 dx;                 //!< Minimum image of the separation from the neighbor to the particle
+            Scalar rsq;                 //!< Squared length of the bond
+            unsigned int idx;           //!< Index of the neighbor
+            unsigned int type;          //!< Type of the neighbor
+            unsigned int typpair;       //!< Index of the type pair parameters of the bond
+            bool interactive;           //!< True when the neighbor takes part in the three-body terms
+            };
+
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
 
@@ -373,103 +391,152 @@ Scalar PotentialTersoff< evaluator >::getLogValue(const std::string& quantity, u
 /*! \post The forces are computed for the given timestep. The neighborlist's compute method is called to ensure
     that it is up to date before proceeding.
 
+    The separation, squared distance, and type pair of every bond between particle i and one of its neighbors are
+    computed once and cached in a bond array, which the loops over the neighbors j and the inner loops over the
+    neighbors k then reuse instead of recomputing the minimum image for every triplet.
+
     \param timestep specifies the current time step of the simulation
 */
 template< class evaluator >
 void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
     {
-    // *****  check if we need the structure of the Tersoff or the RevCross potential for evaluation
-    if (evaluator::flag_for_RevCross )
+    // start by updating the neighborlist
+    m_nlist->compute(timestep);
+
+    // start the profile for this compute
+    if (m_prof) m_prof->push(m_prof_name);
+
+    // The three-body potentials can't handle a half neighbor list, so check now.
+    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+    if (third_law)
         {
-        // ***** RevCross potential
-        // start by updating the neighborlist
-        m_nlist->compute(timestep);
+        const std::string name = evaluator::flag_for_RevCross ? "PotentialRevCross" : "PotentialTersoff";
+        m_exec_conf->msg->error() << std::endl << name << " cannot handle a half neighborlist"
+                                  << std::endl;
+        throw std::runtime_error("Error computing forces in " + name);
+        }
 
-        // start the profile for this compute
-        if (m_prof) m_prof->push(m_prof_name);
+    // access the neighbor list, particle data, and system box
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
 
-        // The three-body potentials can't handle a half neighbor list, so check now.
-        bool third_law = m_nlist->getStorageMode() == NeighborList::half;
-        if (third_law)
-            {
-            m_exec_conf->msg->error() << std::endl << "PotentialRevCross cannot handle a half neighborlist"
-                                      << std::endl;
-            throw std::runtime_error("Error computing forces in PotentialRevCross");
-            }
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    //force and virial arrays
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
 
-        // access the neighbor list, particle data, and system box
-        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+    PDataFlags flags = this->m_pdata->getFlags();
+    bool compute_virial = flags[pdata_flag::pressure_tensor];
 
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    const BoxDim& box = m_pdata->getBox();
+    ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
+    ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
 
-        //force and virial arrays
-        ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_total = N + m_pdata->getNGhosts();
 
-        PDataFlags flags = this->m_pdata->getFlags();
-        bool compute_virial = flags[pdata_flag::pressure_tensor];
+    // need to start from a zero force, energy
+    memset(h_force.data, 0, sizeof(Scalar4)*n_total);
+    memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
 
-        const BoxDim& box = m_pdata->getBox();
-        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
-        ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+    unsigned int ntypes = m_pdata->getNTypes();
 
-        // need to start from a zero force, energy
-        memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
-        memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
+    #ifdef ENABLE_TBB
+    // the forces are also added to the neighbors j and k, which several threads may update concurrently, so each
+    // thread accumulates into a private copy of the force and virial arrays which are reduced at the end
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_force;
+    tbb::enumerable_thread_specific< std::vector<Scalar> > thread_virial;
 
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
+    // for each particle
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    bool exists = false;
+    std::vector<Scalar4>& my_force = thread_force.local(exists);
+    std::vector<Scalar>& my_virial = thread_virial.local();
+    if (!exists)
+        {
+        my_force.resize(n_total, make_scalar4(0,0,0,0));
+        my_virial.resize(6*m_virial_pitch, Scalar(0.0));
+        }
+    Scalar4 *force = my_force.data();
+    Scalar *virial = my_virial.data();
+    std::vector<bond_data> bonds;
+
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    Scalar4 *force = h_force.data;
+    Scalar *virial = h_virial.data;
+    std::vector<bond_data> bonds;
+
+    // for each particle
+    for (unsigned int i = 0; i < N; i++)
+    #endif
+        {
+        // access the particle's position and type (MEM TRANSFER: 4 scalars)
+        Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        const unsigned int head_i = h_head_list.data[i];
+        // sanity check
+        assert(typei < m_pdata->getNTypes());
+
+        // initialize current force and potential energy of particle i to 0
+        Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
+        Scalar pei = 0.0;
+
+        Scalar viriali_xx(0.0);
+        Scalar viriali_xy(0.0);
+        Scalar viriali_xz(0.0);
+        Scalar viriali_yy(0.0);
+        Scalar viriali_yz(0.0);
+        Scalar viriali_zz(0.0);
+
+        // cache the bonds to all neighbors of this particle
+        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        bonds.resize(size);
+        for (unsigned int j = 0; j < size; j++)
             {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            const unsigned int head_i = h_head_list.data[i];
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // initialize current force and potential energy of particle i to 0
-            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pei = 0.0;
-
-            Scalar virialixx(0.0);
-            Scalar virialixy(0.0);
-            Scalar virialixz(0.0);
-            Scalar virialiyy(0.0);
-            Scalar virialiyz(0.0);
-            Scalar virializz(0.0);
+            bond_data& bond = bonds[j];
+
+            // access the index of neighbor j (MEM TRANSFER: 1 scalar)
+            bond.idx = h_nlist.data[head_i + j];
+            assert(bond.idx < n_total);
+
+            // access the position and type of particle j
+            Scalar3 posj = make_scalar3(h_pos.data[bond.idx].x, h_pos.data[bond.idx].y, h_pos.data[bond.idx].z);
+            bond.type = __scalar_as_int(h_pos.data[bond.idx].w);
+            assert(bond.type < m_pdata->getNTypes());
+
+            // calculate dr_ij and apply periodic boundary conditions (FLOPS: 15)
+            bond.dx = box.minImage(posi - posj);
+
+            // compute rij_sq (FLOPS: 5)
+            bond.rsq = dot(bond.dx, bond.dx);
 
+            // index of the parameters for this type pair
+            bond.typpair = m_typpair_idx(typei, bond.type);
+            }
+
+        // *****  check if we need the structure of the Tersoff or the RevCross potential for evaluation
+        if (evaluator::flag_for_RevCross )
+            {
+            // ***** RevCross potential
             // loop over all of the neighbors of this particle
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
             for (unsigned int j = 0; j < size; j++)
                 {
-                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                unsigned int jj = h_nlist.data[head_i + j];
-                assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                // access the position and type of particle j
-                Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                assert(typej < m_pdata->getNTypes());
+                const bond_data& bond_j = bonds[j];
+                unsigned int jj = bond_j.idx;
+                const Scalar3& dxij = bond_j.dx;
+                Scalar rij_sq = bond_j.rsq;
 
                 // initialize the current force and potential energy of particle j to 0
                 Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
                 Scalar pej = 0.0;
 
-                // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 dxij = posi - posj;
-
-                // apply periodic boundary conditions
-                dxij = box.minImage(dxij);
-
-                // compute rij_sq (FLOPS: 5)
-                Scalar rij_sq = dot(dxij, dxij);
-
                 // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                param_type param = h_params.data[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                param_type param = h_params.data[bond_j.typpair];
+                Scalar rcutsq = h_rcutsq.data[bond_j.typpair];
 
                 // evaluate the base repulsive and attractive terms
                 Scalar invratio = 0.0;
@@ -482,7 +549,6 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                 // (since nl are type-wise I can not even merge them because i, j and k could be different types)
                 if (evaluated)
                     {
-                    //printf("\nEvaluating the pair (i,j)=(%d, %d)  from inside HOOMD CPU",i,jj);
                     // evaluate the force and energy from the ij interaction
                     Scalar force_divr = Scalar(0.0);
                     Scalar potential_eng = Scalar(0.0);
@@ -498,38 +564,26 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                     pej += potential_eng ;
 
                     //vir contribute for i j direct interaction on particle i and j
-                if (compute_virial)
-                    {
-                    virialixx += force_divr*dxij.x*dxij.x;
-                    virialixy += force_divr*dxij.x*dxij.y;
-                    virialixz += force_divr*dxij.x*dxij.z;
-                    virialiyy += force_divr*dxij.y*dxij.y;
-                    virialiyz += force_divr*dxij.y*dxij.z;
-                    virializz += force_divr*dxij.z*dxij.z;
-                    }
+                    if (compute_virial)
+                        {
+                        viriali_xx += force_divr*dxij.x*dxij.x;
+                        viriali_xy += force_divr*dxij.x*dxij.y;
+                        viriali_xz += force_divr*dxij.x*dxij.z;
+                        viriali_yy += force_divr*dxij.y*dxij.y;
+                        viriali_yz += force_divr*dxij.y*dxij.z;
+                        viriali_zz += force_divr*dxij.z*dxij.z;
+                        }
 
                     // evaluate the force from the ik interactions
                     for (unsigned int k = j+1; k < size; k++)  // I want to account only a single time for each triplets
                         {
-                        // access the index of neighbor k
-                        unsigned int kk = h_nlist.data[head_i + k];
-                        assert(kk < m_pdata->getN());
-
-                        // access the position and type of neighbor k
-                        Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                        unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                        assert(typek < m_pdata->getNTypes());
+                        const bond_data& bond_k = bonds[k];
+                        unsigned int kk = bond_k.idx;
+                        const Scalar3& dxik = bond_k.dx;
+                        Scalar rik_sq = bond_k.rsq;
 
                         // access the type pair parameters for i and k
-                        typpair_idx = m_typpair_idx(typei, typek);
-                        param_type temp_param = h_params.data[typpair_idx];  // use this to control the species wich have to interact
-
-                        // compute dr_ik
-                        Scalar3 dxik = posi - posk;
-                        // apply periodic boundary conditions
-                        dxik = box.minImage(dxik);
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
+                        param_type temp_param = h_params.data[bond_k.typpair];  // use this to control the species wich have to interact
 
                         // check if k interacts using a temporary evaluator to analyze i-k parameters
                         evaluator temp_eval(rij_sq, rcutsq, temp_param);
@@ -566,20 +620,19 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                                     //***look at 3 body pressure notes
                                     //i just need a single term to account for all of the 3 body virial that i decide to store in the i particle's data
                                     //and i just defined the diagonal component of pressure tensor, I don't know how the off diagonal terms can be included
-                                    virialixx += (force_divr_ij*dxij.x*dxij.x + force_divr_ik*dxik.x*dxik.x);
-                                    virialiyy += (force_divr_ij*dxij.y*dxij.y + force_divr_ik*dxik.y*dxik.y);
-                                    virializz += (force_divr_ij*dxij.z*dxij.z + force_divr_ik*dxik.z*dxik.z);
-                                    virialixy += (force_divr_ij*dxij.x*dxij.y + force_divr_ik*dxik.x*dxik.y);
-                                    virialixz += (force_divr_ij*dxij.x*dxij.z + force_divr_ik*dxik.x*dxik.z);
-                                    virialiyz += (force_divr_ij*dxij.y*dxij.z + force_divr_ik*dxik.y*dxik.z);
+                                    viriali_xx += (force_divr_ij*dxij.x*dxij.x + force_divr_ik*dxik.x*dxik.x);
+                                    viriali_yy += (force_divr_ij*dxij.y*dxij.y + force_divr_ik*dxik.y*dxik.y);
+                                    viriali_zz += (force_divr_ij*dxij.z*dxij.z + force_divr_ik*dxik.z*dxik.z);
+                                    viriali_xy += (force_divr_ij*dxij.x*dxij.y + force_divr_ik*dxik.x*dxik.y);
+                                    viriali_xz += (force_divr_ij*dxij.x*dxij.z + force_divr_ik*dxik.x*dxik.z);
+                                    viriali_yz += (force_divr_ij*dxij.y*dxij.z + force_divr_ik*dxik.y*dxik.z);
                                     }
 
-
                                 // increment the force for particle k
                                 unsigned int mem_idx = kk;
-                                h_force.data[mem_idx].x += fk.x;
-                                h_force.data[mem_idx].y += fk.y;
-                                h_force.data[mem_idx].z += fk.z;
+                                force[mem_idx].x += fk.x;
+                                force[mem_idx].y += fk.y;
+                                force[mem_idx].z += fk.z;
                                 }
                             }
                         }
@@ -587,96 +640,15 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
 
                 // increment the force and potential energy for particle j
                 unsigned int mem_idx = jj;
-                h_force.data[mem_idx].x += fj.x;
-                h_force.data[mem_idx].y += fj.y;
-                h_force.data[mem_idx].z += fj.z;
-                h_force.data[mem_idx].w += pej;
-                }
-
-            // finally, increment the force and potential energy for particle i
-            unsigned int mem_idx = i;
-            h_force.data[mem_idx].x += fi.x;
-            h_force.data[mem_idx].y += fi.y;
-            h_force.data[mem_idx].z += fi.z;
-            h_force.data[mem_idx].w += pei;
-
-            //imcrement vir for i
-            if (compute_virial)
-                {
-                h_virial.data[0*m_virial_pitch+mem_idx] += virialixx;
-                h_virial.data[1*m_virial_pitch+mem_idx] += virialixy;
-                h_virial.data[2*m_virial_pitch+mem_idx] += virialixz;
-                h_virial.data[3*m_virial_pitch+mem_idx] += virialiyy;
-                h_virial.data[4*m_virial_pitch+mem_idx] += virialiyz;
-                h_virial.data[5*m_virial_pitch+mem_idx] += virializz;
+                force[mem_idx].x += fj.x;
+                force[mem_idx].y += fj.y;
+                force[mem_idx].z += fj.z;
+                force[mem_idx].w += pej;
                 }
-
-            }
-        }
-    else
-        {
-        // ****** Tersoff or SquareDensity potential
-        // start by updating the neighborlist
-        m_nlist->compute(timestep);
-
-        // start the profile for this compute
-        if (m_prof) m_prof->push(m_prof_name);
-
-        // The three-body potentials can't handle a half neighbor list, so check now.
-        bool third_law = m_nlist->getStorageMode() == NeighborList::half;
-        if (third_law)
-            {
-            m_exec_conf->msg->error() << std::endl << "PotentialTersoff cannot handle a half neighborlist"
-                                      << std::endl;
-            throw std::runtime_error("Error computing forces in PotentialTersoff");
             }
-
-        // access the neighbor list, particle data, and system box
-        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
-
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-
-
-        //force and virial arrays
-        ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
-
-        PDataFlags flags = this->m_pdata->getFlags();
-        bool compute_virial = flags[pdata_flag::pressure_tensor];
-
-        const BoxDim& box = m_pdata->getBox();
-        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
-        ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
-
-        // need to start from a zero force, energy
-        memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
-        memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
-
-        unsigned int ntypes = m_pdata->getNTypes();
-
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
+        else
             {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            const unsigned int head_i = h_head_list.data[i];
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // initialize current force and potential energy of particle i to 0
-            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pei = 0.0;
-
-            Scalar viriali_xx(0.0);
-            Scalar viriali_xy(0.0);
-            Scalar viriali_xz(0.0);
-            Scalar viriali_yy(0.0);
-            Scalar viriali_yz(0.0);
-            Scalar viriali_zz(0.0);
-
+            // ****** Tersoff or SquareDensity potential
             Scalar phi_ab[ntypes];
 
             // reset phi
@@ -685,38 +657,19 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                 phi_ab[typ_b] = Scalar(0.0);
                 }
 
-            // all neighbors of this particle
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
             if (evaluator::hasPerParticleEnergy())
                 {
                 for (unsigned int j = 0; j < size; j++)
                     {
-                    // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                    unsigned int jj = h_nlist.data[head_i + j];
-                    assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                    // access the position and type of particle j
-                    Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                    unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                    assert(typej < m_pdata->getNTypes());
-
-                    // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                    Scalar3 dxij = posi - posj;
-
-                    // apply periodic boundary conditions
-                    dxij = box.minImage(dxij);
-
-                    // compute rij_sq (FLOPS: 5)
-                    Scalar rij_sq = dot(dxij, dxij);
+                    const bond_data& bond_j = bonds[j];
 
                     // get parameters for this type pair
-                    unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                    param_type param = h_params.data[typpair_idx];
-                    Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                    param_type param = h_params.data[bond_j.typpair];
+                    Scalar rcutsq = h_rcutsq.data[bond_j.typpair];
 
                     // evaluate the scalar per-neighbor contribution
-                    evaluator eval(rij_sq, rcutsq, param);
-                    eval.evalPhi(phi_ab[typej]);
+                    evaluator eval(bond_j.rsq, rcutsq, param);
+                    eval.evalPhi(phi_ab[bond_j.type]);
                     }
 
                 // self-energy
@@ -732,35 +685,29 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                     }
                 }
 
+            // whether each neighbor k contributes to the three-body terms, which these evaluators decide from the
+            // i-k parameters alone, so it is the same for every j
+            for (unsigned int k = 0; k < size; k++)
+                {
+                evaluator temp_eval(bonds[k].rsq, h_rcutsq.data[bonds[k].typpair], h_params.data[bonds[k].typpair]);
+                bonds[k].interactive = temp_eval.areInteractive();
+                }
+
             // loop over all of the neighbors of this particle
             for (unsigned int j = 0; j < size; j++)
                 {
-                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                unsigned int jj = h_nlist.data[head_i + j];
-                assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                // access the position and type of particle j
-                Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                assert(typej < m_pdata->getNTypes());
+                const bond_data& bond_j = bonds[j];
+                unsigned int jj = bond_j.idx;
+                const Scalar3& dxij = bond_j.dx;
+                Scalar rij_sq = bond_j.rsq;
 
                 // initialize the current force and potential energy of particle j to 0
                 Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
                 Scalar pej = 0.0;
 
-                // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 dxij = posi - posj;
-
-                // apply periodic boundary conditions
-                dxij = box.minImage(dxij);
-
-                // compute rij_sq (FLOPS: 5)
-                Scalar rij_sq = dot(dxij, dxij);
-
                 // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                param_type param = h_params.data[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                param_type param = h_params.data[bond_j.typpair];
+                Scalar rcutsq = h_rcutsq.data[bond_j.typpair];
 
                 // evaluate the base repulsive and attractive terms
                 Scalar fR = 0.0;
@@ -783,40 +730,17 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                         {
                         for (unsigned int k = 0; k < size; k++)
                             {
-                            // access the index of neighbor k
-                            unsigned int kk = h_nlist.data[head_i + k];
-                            assert(kk < m_pdata->getN());
-
-                            // access the position and type of neighbor k
-                            Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                            unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                            assert(typek < m_pdata->getNTypes());
-
-                            // access the type pair parameters for i and k
-                            typpair_idx = m_typpair_idx(typei, typek);
-                            param_type temp_param = h_params.data[typpair_idx];
-
-                            evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                            bool temp_evaluated = temp_eval.areInteractive();
+                            const bond_data& bond_k = bonds[k];
 
-                            if (kk != jj && temp_evaluated)
+                            if (bond_k.idx != jj && bond_k.interactive)
                                 {
-                                // compute drik
-                                Scalar3 dxik = posi - posk;
-
-                                // apply periodic boundary conditions
-                                dxik = box.minImage(dxik);
-
-                                // compute rik_sq
-                                Scalar rik_sq = dot(dxik, dxik);
-
                                 // compute the bond angle (if needed)
                                 Scalar cos_th = Scalar(0.0);
                                 if (evaluator::needsAngle())
-                                    cos_th = dot(dxij, dxik) / fast::sqrt(rij_sq * rik_sq);
+                                    cos_th = dot(dxij, bond_k.dx) / fast::sqrt(rij_sq * bond_k.rsq);
 
                                 // evaluate the partial chi term
-                                eval.setRik(rik_sq);
+                                eval.setRik(bond_k.rsq);
                                 if (evaluator::needsAngle())
                                     eval.setAngle(cos_th);
 
@@ -829,7 +753,7 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                     Scalar force_divr = Scalar(0.0);
                     Scalar potential_eng = Scalar(0.0);
                     Scalar bij = Scalar(0.0);
-                    eval.evalForceij(fR, fA, chi, phi_ab[typej], bij, force_divr, potential_eng);
+                    eval.evalForceij(fR, fA, chi, phi_ab[bond_j.type], bij, force_divr, potential_eng);
 
                     // add this force to particle i
                     fi += force_divr * dxij;
@@ -868,36 +792,16 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                         // evaluate the force from the ik interactions
                         for (unsigned int k = 0; k < size; k++)
                             {
-                            // access the index of neighbor k
-                            unsigned int kk = h_nlist.data[head_i + k];
-                            assert(kk < m_pdata->getN());
-
-                            // access the position and type of neighbor k
-                            Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                            unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                            assert(typek < m_pdata->getNTypes());
-
-                            // access the type pair parameters for i and k
-                            typpair_idx = m_typpair_idx(typei, typek);
-                            param_type temp_param = h_params.data[typpair_idx];
+                            const bond_data& bond_k = bonds[k];
+                            unsigned int kk = bond_k.idx;
+                            const Scalar3& dxik = bond_k.dx;
+                            Scalar rik_sq = bond_k.rsq;
 
-                            evaluator temp_eval(rij_sq, rcutsq, temp_param);
-                            bool temp_evaluated = temp_eval.areInteractive();
-
-                            if (kk != jj && temp_evaluated)
+                            if (kk != jj && bond_k.interactive)
                                 {
                                 // create variable for the force on k
                                 Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
 
-                                // compute dr_ik
-                                Scalar3 dxik = posi - posk;
-
-                                // apply periodic boundary conditions
-                                dxik = box.minImage(dxik);
-
-                                // compute rik_sq
-                                Scalar rik_sq = dot(dxik, dxik);
-
                                 // compute the bond angle (if needed)
                                 Scalar cos_th = Scalar(0.0);
                                 if (evaluator::needsAngle())
@@ -957,20 +861,20 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
 
                                 // increment the force for particle k
                                 unsigned int mem_idx = kk;
-                                h_force.data[mem_idx].x += fk.x;
-                                h_force.data[mem_idx].y += fk.y;
-                                h_force.data[mem_idx].z += fk.z;
+                                force[mem_idx].x += fk.x;
+                                force[mem_idx].y += fk.y;
+                                force[mem_idx].z += fk.z;
 
                                 if (compute_virial)
                                     {
                                     Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.z;
                                     Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.z;
-                                    h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
-                                    h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
-                                    h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
-                                    h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
-                                    h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
-                                    h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
+                                    virial[0*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
+                                    virial[1*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
+                                    virial[2*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
+                                    virial[3*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
+                                    virial[4*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
+                                    virial[5*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
                                     }
                                 }
                             }
@@ -978,39 +882,70 @@ void PotentialTersoff< evaluator >::computeForces(uint64_t timestep)
                     }
                 // increment the force and potential energy for particle j
                 unsigned int mem_idx = jj;
-                h_force.data[mem_idx].x += fj.x;
-                h_force.data[mem_idx].y += fj.y;
-                h_force.data[mem_idx].z += fj.z;
-                h_force.data[mem_idx].w += pej;
+                force[mem_idx].x += fj.x;
+                force[mem_idx].y += fj.y;
+                force[mem_idx].z += fj.z;
+                force[mem_idx].w += pej;
 
                 if (compute_virial)
                     {
-                    h_virial.data[0*m_virial_pitch+mem_idx] += virialj_xx;
-                    h_virial.data[1*m_virial_pitch+mem_idx] += virialj_xy;
-                    h_virial.data[2*m_virial_pitch+mem_idx] += virialj_xz;
-                    h_virial.data[3*m_virial_pitch+mem_idx] += virialj_yy;
-                    h_virial.data[4*m_virial_pitch+mem_idx] += virialj_yz;
-                    h_virial.data[5*m_virial_pitch+mem_idx] += virialj_zz;
+                    virial[0*m_virial_pitch+mem_idx] += virialj_xx;
+                    virial[1*m_virial_pitch+mem_idx] += virialj_xy;
+                    virial[2*m_virial_pitch+mem_idx] += virialj_xz;
+                    virial[3*m_virial_pitch+mem_idx] += virialj_yy;
+                    virial[4*m_virial_pitch+mem_idx] += virialj_yz;
+                    virial[5*m_virial_pitch+mem_idx] += virialj_zz;
                     }
                 }
-            // finally, increment the force and potential energy for particle i
-            unsigned int mem_idx = i;
-            h_force.data[mem_idx].x += fi.x;
-            h_force.data[mem_idx].y += fi.y;
-            h_force.data[mem_idx].z += fi.z;
-            h_force.data[mem_idx].w += pei;
-
-            if (compute_virial)
+            }
+
+        // finally, increment the force and potential energy for particle i
+        unsigned int mem_idx = i;
+        force[mem_idx].x += fi.x;
+        force[mem_idx].y += fi.y;
+        force[mem_idx].z += fi.z;
+        force[mem_idx].w += pei;
+
+        if (compute_virial)
+            {
+            virial[0*m_virial_pitch+mem_idx] += viriali_xx;
+            virial[1*m_virial_pitch+mem_idx] += viriali_xy;
+            virial[2*m_virial_pitch+mem_idx] += viriali_xz;
+            virial[3*m_virial_pitch+mem_idx] += viriali_yy;
+            virial[4*m_virial_pitch+mem_idx] += viriali_yz;
+            virial[5*m_virial_pitch+mem_idx] += viriali_zz;
+            }
+        }
+    #ifdef ENABLE_TBB
+        });
+
+    // reduce the per-thread accumulators, including the ghost particles
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_total),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+            {
+            const Scalar4 *my_force = it->data();
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                {
+                h_force.data[i].x += my_force[i].x;
+                h_force.data[i].y += my_force[i].y;
+                h_force.data[i].z += my_force[i].z;
+                h_force.data[i].w += my_force[i].w;
+                }
+            }
+
+        if (compute_virial)
+            {
+            for (auto it = thread_virial.begin(); it != thread_virial.end(); ++it)
                 {
-                h_virial.data[0*m_virial_pitch+mem_idx] += viriali_xx;
-                h_virial.data[1*m_virial_pitch+mem_idx] += viriali_xy;
-                h_virial.data[2*m_virial_pitch+mem_idx] += viriali_xz;
-                h_virial.data[3*m_virial_pitch+mem_idx] += viriali_yy;
-                h_virial.data[4*m_virial_pitch+mem_idx] += viriali_yz;
-                h_virial.data[5*m_virial_pitch+mem_idx] += viriali_zz;
+                const Scalar *my_virial = it->data();
+                for (unsigned int k = 0; k < 6; ++k)
+                    for (unsigned int i = r.begin(); i != r.end(); ++i)
+                        h_virial.data[k*m_virial_pitch+i] += my_virial[k*m_virial_pitch+i];
                 }
             }
-        }
+        });
+    #endif
 
     if (m_prof) m_prof->pop();
     }
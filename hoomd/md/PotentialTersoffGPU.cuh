@@ -42,6 +42,7 @@ struct tersoff_args_t
                    const unsigned int *_d_n_neigh,
                    const unsigned int *_d_nlist,
                    const unsigned int *_d_head_list,
+                   Scalar4 *_d_bond,
                    const Scalar *_d_rcutsq,
                    const size_t _size_nlist,
                    const unsigned int _ntypes,
@@ -59,6 +60,7 @@ struct tersoff_args_t
                      d_n_neigh(_d_n_neigh),
                      d_nlist(_d_nlist),
                      d_head_list(_d_head_list),
+                     d_bond(_d_bond),
                      d_rcutsq(_d_rcutsq),
                      size_nlist(_size_nlist),
                      ntypes(_ntypes),
@@ -79,6 +81,7 @@ struct tersoff_args_t
     const unsigned int *d_n_neigh;  //!< Device array listing the number of neighbors on each particle
     const unsigned int *d_nlist;    //!< Device array listing the neighbors of each particle
     const unsigned int *d_head_list;//!< Indexes for accessing d_nlist
+    Scalar4 *d_bond;                //!< Separation and neighbor type of each bond, indexed like d_nlist
     const Scalar *d_rcutsq;          //!< Device array listing r_cut squared per particle type pair
     const size_t size_nlist;  //!< Number of elements in the neighborlist
     const unsigned int ntypes;      //!< Number of particle types in the simulation
@@ -151,10 +154,10 @@ inline __device__ float myAtomicAdd(float* address, float val)
     \param d_force Device memory to write computed forces
     \param N Number of particles in the system
     \param d_pos Positions of all the particles
-    \param box Box dimensions used to implement periodic boundary conditions
     \param d_n_neigh Device memory array listing the number of neighbors for each particle
     \param d_nlist Device memory array containing the neighbor list contents
     \param d_head_list Indexes for reading \a d_nlist
+    \param d_bond Bonds computed by gpu_compute_triplet_bonds_kernel()
     \param d_params Parameters for the potential, stored per type pair
     \param d_rcutsq rcut squared, stored per type pair
     \param d_ronsq ron squared, stored per type pair
@@ -172,6 +175,9 @@ inline __device__ float myAtomicAdd(float* address, float val)
     Each block will calculate the forces on a block of particles.
     Each thread will calculate the total force on one particle.
     The neighborlist is arranged in columns so that reads are fully coalesced when doing this.
+    The loops over the neighbors j and k read the separations from \a d_bond, which stores them contiguously per
+    particle, instead of gathering the positions of the neighbors and applying the periodic boundary conditions again
+    for every triplet.
 */
 template< class evaluator, unsigned char compute_virial, int tpp>
 __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
@@ -179,10 +185,10 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                                                   Scalar *d_virial,
                                                   size_t virial_pitch,
                                                   const Scalar4 *d_pos,
-                                                  const BoxDim box,
                                                   const unsigned int *d_n_neigh,
                                                   const unsigned int *d_nlist,
                                                   const unsigned int *d_head_list,
+                                                  const Scalar4 *d_bond,
                                                   const typename evaluator::param_type *d_params,
                                                   const Scalar *d_rcutsq,
                                                   const unsigned int ntypes)
@@ -225,9 +231,8 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
     // load in the length of the neighbor list (MEM_TRANSFER: 4 bytes)
     unsigned int n_neigh = d_n_neigh[idx];
 
-    // read in the position of the particle
+    // read in the type of the particle
     Scalar4 postypei = __ldg(d_pos + idx);
-    Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
 
     // initialize the force to 0
     Scalar4 forcei = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
@@ -262,24 +267,20 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                 next_j = __ldg(d_nlist + head_idx + neigh_idx + tpp);
                 }
 
-            // read the position of j (MEM TRANSFER: 16 bytes)
-            Scalar4 postypej = __ldg(d_pos + cur_j);
-            Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+            // read the cached bond to j (MEM TRANSFER: 16 bytes)
+            Scalar4 bondj = __ldg(d_bond + head_idx + neigh_idx);
 
             // initialize the force on j
             Scalar4 forcej = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
 
-            // compute r_ij (FLOPS: 3)
-            Scalar3 dxij = posi - posj;
-
-            // apply periodic boundary conditions (FLOPS: 12)
-            dxij = box.minImage(dxij);
+            // separation of i and j
+            Scalar3 dxij = make_scalar3(bondj.x, bondj.y, bondj.z);
 
             // compute rij_sq (FLOPS: 5)
             Scalar rij_sq = dot(dxij, dxij);
 
             // access the per type-pair parameters
-            unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
+            unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(bondj.w));
             Scalar rcutsq = s_rcutsq[typpair];
             typename evaluator::param_type param = s_params[typpair];
 
@@ -321,32 +322,25 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                    }
 
                 // now evaluate the force from the ik interactions
-                unsigned int cur_k = 0;
-                unsigned int next_k(0);
-
                 // loop over k neighbors one by one
                 for (int neigh_idy = 0; neigh_idy < n_neigh; neigh_idy++)
                     {
-                    // read the current neighbor index and prefetch the next one
-                    cur_k = next_k;
-                    next_k = __ldg(d_nlist + head_idx + neigh_idy+1);
+                    // read the index of neighbor k
+                    unsigned int cur_k = __ldg(d_nlist + head_idx + neigh_idy);
 
                     // I continue only if k is not the same as j
                     if((cur_k>cur_j)&&(cur_j>idx))
                         {
-                        // get the position of neighbor k
-                        Scalar4 postypek = __ldg(d_pos + cur_k);
-                        Scalar3 posk = make_scalar3(postypek.x, postypek.y, postypek.z);
+                        // read the cached bond to k
+                        Scalar4 bondk = __ldg(d_bond + head_idx + neigh_idy);
 
                         // get the type pair parameters for i and k
-                        typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypek.w));
+                        typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(bondk.w));
                         Scalar temp_rcutsq = s_rcutsq[typpair];
                         typename evaluator::param_type temp_param = s_params[typpair];
 
-                         // compute rik
-                        Scalar3 dxik = posi - posk;
-                        // apply the periodic boundary conditions
-                        dxik = box.minImage(dxik);
+                        // separation of i and k
+                        Scalar3 dxik = make_scalar3(bondk.x, bondk.y, bondk.z);
                         // compute rik_sq
                         Scalar rik_sq = dot(dxik, dxik);
 
@@ -461,29 +455,25 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                     next_j = __ldg(d_nlist + head_idx + neigh_idx + tpp);
                     }
 
-                // read the position of j (MEM TRANSFER: 16 bytes)
-                Scalar4 postypej = __ldg(d_pos + cur_j);
-                Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+                // read the cached bond to j (MEM TRANSFER: 16 bytes)
+                Scalar4 bondj = __ldg(d_bond + head_idx + neigh_idx);
 
                 // initialize the force on j
                 Scalar4 forcej = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
 
-                // compute r_ij (FLOPS: 3)
-                Scalar3 dxij = posi - posj;
-
-                // apply periodic boundary conditions (FLOPS: 12)
-                dxij = box.minImage(dxij);
+                // separation of i and j
+                Scalar3 dxij = make_scalar3(bondj.x, bondj.y, bondj.z);
 
                 // compute rij_sq (FLOPS: 5)
                 Scalar rij_sq = dot(dxij, dxij);
 
                 // access the per type-pair parameters
-                unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
+                unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(bondj.w));
                 Scalar rcutsq = s_rcutsq[typpair];
                 typename evaluator::param_type param = s_params[typpair];
 
                 evaluator eval(rij_sq, rcutsq, param);
-                eval.evalPhi(s_phi_ab[threadIdx.x*ntypes+__scalar_as_int(postypej.w)]);
+                eval.evalPhi(s_phi_ab[threadIdx.x*ntypes+__scalar_as_int(bondj.w)]);
                 }
 
             // self-energy
@@ -531,9 +521,8 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                 next_j = __ldg(d_nlist + head_idx + neigh_idx + tpp);
                 }
 
-            // read the position of j (MEM TRANSFER: 16 bytes)
-            Scalar4 postypej = __ldg(d_pos + cur_j);
-            Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+            // read the cached bond to j (MEM TRANSFER: 16 bytes)
+            Scalar4 bondj = __ldg(d_bond + head_idx + neigh_idx);
 
             // initialize the force on j
             Scalar4 forcej = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
@@ -545,17 +534,14 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
             Scalar virialj_yz(0.0);
             Scalar virialj_zz(0.0);
 
-            // compute r_ij (FLOPS: 3)
-            Scalar3 dxij = posi - posj;
-
-            // apply periodic boundary conditions (FLOPS: 12)
-            dxij = box.minImage(dxij);
+            // separation of i and j
+            Scalar3 dxij = make_scalar3(bondj.x, bondj.y, bondj.z);
 
             // compute rij_sq (FLOPS: 5)
             Scalar rij_sq = dot(dxij, dxij);
 
             // access the per type-pair parameters
-            unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
+            unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(bondj.w));
             Scalar rcutsq = s_rcutsq[typpair];
             typename evaluator::param_type param = s_params[typpair];
 
@@ -572,23 +558,15 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                 if (evaluator::needsChi())
                     {
                     // compute chi
-                    unsigned int cur_k = 0;
-                    unsigned int next_k(0);
-                    next_k = __ldg(d_nlist + head_idx);
-
                     // loop over neighbors one by one
                     for (int neigh_idy = 0; neigh_idy < n_neigh; neigh_idy++)
                         {
-                        // read the current index of k and prefetch the next one
-                        cur_k = next_k;
-                        next_k = __ldg(d_nlist + head_idx + neigh_idy+1);
-
-                        // get the position of neighbor k
-                        Scalar4 postypek = __ldg(d_pos + cur_k);
-                        Scalar3 posk = make_scalar3(postypek.x, postypek.y, postypek.z);
+                        // read the index of neighbor k and the cached bond to it
+                        unsigned int cur_k = __ldg(d_nlist + head_idx + neigh_idy);
+                        Scalar4 bondk = __ldg(d_bond + head_idx + neigh_idy);
 
                         // get the type pair parameters for i and k
-                        typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypek.w));
+                        typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(bondk.w));
                         Scalar temp_rcutsq = s_rcutsq[typpair];
                         typename evaluator::param_type temp_param = s_params[typpair];
 
@@ -597,11 +575,8 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
 
                         if (cur_k != cur_j && temp_evaluated)
                             {
-                            // compute rik
-                            Scalar3 dxik = posi - posk;
-
-                            // apply the periodic boundary conditions
-                            dxik = box.minImage(dxik);
+                            // separation of i and k
+                            Scalar3 dxik = make_scalar3(bondk.x, bondk.y, bondk.z);
 
                             // compute rik_sq
                             Scalar rik_sq = dot(dxik, dxik);
@@ -626,7 +601,7 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                 Scalar force_divr = Scalar(0.0);
                 Scalar potential_eng = Scalar(0.0);
                 Scalar bij = Scalar(0.0);
-                const Scalar& phi = s_phi_ab[threadIdx.x*ntypes+__scalar_as_int(postypej.w)];
+                const Scalar& phi = s_phi_ab[threadIdx.x*ntypes+__scalar_as_int(bondj.w)];
                 eval.evalForceij(fR, fA, chi, phi, bij, force_divr, potential_eng);
 
                 // add the forces and energies to their respective particles
@@ -670,23 +645,15 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                 if (evaluator::hasIkForce())
                     {
                     // now evaluate the force from the ik interactions
-                    unsigned int cur_k = 0;
-                    unsigned int next_k(0);
-                    next_k = __ldg(d_nlist + head_idx);
-
                     // loop over neighbors one by one
                     for (int neigh_idy = 0; neigh_idy < n_neigh; neigh_idy++)
                         {
-                        // read the current neighbor index and prefetch the next one
-                        cur_k = next_k;
-                        next_k = __ldg(d_nlist + head_idx + neigh_idy+1);
-
-                        // get the position of neighbor k
-                        Scalar4 postypek = __ldg(d_pos + cur_k);
-                        Scalar3 posk = make_scalar3(postypek.x, postypek.y, postypek.z);
+                        // read the index of neighbor k and the cached bond to it
+                        unsigned int cur_k = __ldg(d_nlist + head_idx + neigh_idy);
+                        Scalar4 bondk = __ldg(d_bond + head_idx + neigh_idy);
 
                         // get the type pair parameters for i and k
-                        typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypek.w));
+                        typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(bondk.w));
                         Scalar temp_rcutsq = s_rcutsq[typpair];
                         typename evaluator::param_type temp_param = s_params[typpair];
 
@@ -697,11 +664,8 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                             {
                             Scalar4 forcek = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
 
-                            // compute rik
-                            Scalar3 dxik = posi - posk;
-
-                            // apply the periodic boundary conditions
-                            dxik = box.minImage(dxik);
+                            // separation of i and k
+                            Scalar3 dxik = make_scalar3(bondk.x, bondk.y, bondk.z);
 
                             // compute rik_sq
                             Scalar rik_sq = dot(dxik, dxik);
@@ -818,6 +782,50 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
         }
     }
 
+//! Kernel for computing the bonds between the particles and their neighbors
+/*! \param d_bond Device memory to write the bonds to, indexed like \a d_nlist
+    \param N Number of particles in the system
+    \param d_pos Positions of all the particles
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param d_n_neigh Device memory array listing the number of neighbors for each particle
+    \param d_nlist Device memory array containing the neighbor list contents
+    \param d_head_list Indexes for reading \a d_nlist
+    \param tpp Number of threads per particle
+
+    Each bond stores the minimum image of r_i - r_j in xyz and the type of neighbor j in w. The threads are mapped to
+    the particles and neighbors in the same way as in gpu_compute_triplet_forces_kernel().
+*/
+__global__ void gpu_compute_triplet_bonds_kernel(Scalar4 *d_bond,
+                                                 const unsigned int N,
+                                                 const Scalar4 *d_pos,
+                                                 const BoxDim box,
+                                                 const unsigned int *d_n_neigh,
+                                                 const unsigned int *d_nlist,
+                                                 const unsigned int *d_head_list,
+                                                 const unsigned int tpp)
+    {
+    unsigned int idx = blockIdx.x * (blockDim.x/tpp) + threadIdx.x/tpp;
+
+    if (idx >= N)
+        return;
+
+    const unsigned int n_neigh = d_n_neigh[idx];
+    const unsigned int head_idx = d_head_list[idx];
+    Scalar4 postypei = __ldg(d_pos + idx);
+    Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+
+    for (unsigned int neigh_idx = threadIdx.x%tpp; neigh_idx < n_neigh; neigh_idx += tpp)
+        {
+        unsigned int cur_j = __ldg(d_nlist + head_idx + neigh_idx);
+        Scalar4 postypej = __ldg(d_pos + cur_j);
+        Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+
+        // apply periodic boundary conditions (FLOPS: 15)
+        Scalar3 dxij = box.minImage(posi - posj);
+        d_bond[head_idx + neigh_idx] = make_scalar4(dxij.x, dxij.y, dxij.z, postypej.w);
+        }
+    }
+
 //! Kernel for zeroing forces and virial before computation with atomic additions.
 /*! \param d_force Device memory to write forces to
     \param N Number of particles in the system
@@ -906,6 +914,16 @@ struct TersoffComputeKernel
                                                     pair_args.virial_pitch,
                                                     pair_args.N + pair_args.Nghosts);
 
+            // compute the bonds once, they are read by every triplet they belong to
+            hipLaunchKernelGGL((gpu_compute_triplet_bonds_kernel), dim3(pair_args.N / (run_block_size/pair_args.tpp) + 1), dim3(run_block_size), 0, 0,
+                                                    pair_args.d_bond,
+                                                    pair_args.N,
+                                                    pair_args.d_pos,
+                                                    pair_args.box,
+                                                    pair_args.d_n_neigh,
+                                                    pair_args.d_nlist,
+                                                    pair_args.d_head_list,
+                                                    pair_args.tpp);
 
             // setup the grid to run the kernel
             dim3 grid( pair_args.N / (run_block_size/pair_args.tpp) + 1, 1, 1);
@@ -916,10 +934,10 @@ struct TersoffComputeKernel
                                                 pair_args.d_virial,
                                                 pair_args.virial_pitch,
                                                 pair_args.d_pos,
-                                                pair_args.box,
                                                 pair_args.d_n_neigh,
                                                 pair_args.d_nlist,
                                                 pair_args.d_head_list,
+                                                pair_args.d_bond,
                                                 d_params,
                                                 pair_args.d_rcutsq,
                                                 pair_args.ntypes);
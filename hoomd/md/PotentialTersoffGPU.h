@@ -57,6 +57,7 @@ class PotentialTersoffGPU : public PotentialTersoff<evaluator>
 
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
+        GlobalArray<Scalar4> m_bond;        //!< Separation and neighbor type of each bond, indexed like the neighbor list
 
         //! Actually compute the forces
         virtual void computeForces(uint64_t timestep);
@@ -131,6 +132,16 @@ void PotentialTersoffGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timestep
     ArrayHandle<unsigned int> d_nlist(this->m_nlist->getNListArray(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_head_list(this->m_nlist->getHeadList(), access_location::device, access_mode::read);
 
+    // the bonds are indexed like the neighbor list, so they grow with it
+    const size_t n_bonds = this->m_nlist->getNListArray().getNumElements();
+    if (m_bond.getNumElements() < n_bonds)
+        {
+        GlobalArray<Scalar4> bond(n_bonds, this->m_exec_conf);
+        m_bond.swap(bond);
+        TAG_ALLOCATION(m_bond);
+        }
+    ArrayHandle<Scalar4> d_bond(m_bond, access_location::device, access_mode::overwrite);
+
     // access the particle data
     ArrayHandle<Scalar4> d_pos(this->m_pdata->getPositions(), access_location::device, access_mode::read);
 
@@ -162,6 +173,7 @@ void PotentialTersoffGPU< evaluator, gpu_cgpf >::computeForces(uint64_t timestep
                             d_n_neigh.data,
                             d_nlist.data,
                             d_head_list.data,
+                            d_bond.data,
                             d_rcutsq.data,
                             this->m_nlist->getNListArray().getPitch(),
                             this->m_pdata->getNTypes(),
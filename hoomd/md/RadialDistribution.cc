@@ -0,0 +1,184 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RadialDistribution.cc
+    \brief Defines the RadialDistribution class
+*/
+
+#include "RadialDistribution.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <pybind11/stl.h>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System to analyze
+    \param nlist Neighbor list to read the pairs from
+    \param r_max Largest distance in the histogram
+    \param n_bins Number of bins in the histogram
+*/
+RadialDistribution::RadialDistribution(std::shared_ptr<SystemDefinition> sysdef,
+                                       std::shared_ptr<NeighborList> nlist,
+                                       Scalar r_max,
+                                       unsigned int n_bins)
+    : Analyzer(sysdef), m_nlist(nlist), m_r_max(r_max), m_n_bins(n_bins), m_n_frames(0), m_norm(0.0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing RadialDistribution" << endl;
+
+    if (m_r_max <= Scalar(0.0) || m_n_bins == 0)
+        {
+        m_exec_conf->msg->error() << "md.compute.RDF: r_max and bins must be positive" << endl;
+        throw runtime_error("Error initializing RadialDistribution");
+        }
+
+    GlobalArray<unsigned long long> histogram(m_n_bins, m_exec_conf);
+    m_histogram.swap(histogram);
+    TAG_ALLOCATION(m_histogram);
+
+    // request all type pairs out to r_max from the neighbor list
+    Index2D typpair_idx(m_pdata->getNTypes());
+    m_r_cut_nlist = std::make_shared<GlobalArray<Scalar>>(typpair_idx.getNumElements(), m_exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut_nlist(*m_r_cut_nlist, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < typpair_idx.getNumElements(); i++)
+            h_r_cut_nlist.data[i] = m_r_max;
+        }
+    m_nlist->addRCutMatrix(m_r_cut_nlist);
+
+    reset();
+    }
+
+RadialDistribution::~RadialDistribution()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying RadialDistribution" << endl;
+    m_nlist->removeRCutMatrix(m_r_cut_nlist);
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void RadialDistribution::analyze(uint64_t timestep)
+    {
+    if (m_prof)
+        m_prof->push(m_exec_conf, "RDF");
+
+    m_nlist->compute(timestep);
+    computeHistogram();
+
+    const double N = double(m_pdata->getNGlobal());
+    const double V = m_pdata->getGlobalBox().getVolume(m_sysdef->getNDimensions() == 2);
+    m_norm += N*N/V;
+    m_n_frames++;
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+
+/*! In the half storage mode, each pair of local particles is stored once and counts twice. A pair with a ghost
+    also appears on the rank that owns the ghost, so it counts once on each rank.
+*/
+void RadialDistribution::computeHistogram()
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned long long> h_histogram(m_histogram, access_location::host, access_mode::readwrite);
+
+    const BoxDim& box = m_pdata->getBox();
+    const bool half = m_nlist->getStorageMode() == NeighborList::half;
+    const unsigned int N = m_pdata->getN();
+    const Scalar r_max_sq = m_r_max*m_r_max;
+    const Scalar bin_scale = Scalar(m_n_bins)/m_r_max;
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        const unsigned int head = h_head_list.data[i];
+
+        for (unsigned int k = 0; k < h_n_neigh.data[i]; k++)
+            {
+            unsigned int j = h_nlist.data[head + k];
+            Scalar3 dx = pi - make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            dx = box.minImage(dx);
+            Scalar r_sq = dot(dx, dx);
+            if (r_sq >= r_max_sq)
+                continue;
+
+            unsigned int bin = (unsigned int)(fast::sqrt(r_sq)*bin_scale);
+            if (bin >= m_n_bins)
+                bin = m_n_bins - 1;
+            h_histogram.data[bin] += (half && j < N) ? 2 : 1;
+            }
+        }
+    }
+
+std::vector<double> RadialDistribution::getBinCenters() const
+    {
+    std::vector<double> centers(m_n_bins);
+    const double dr = double(m_r_max)/double(m_n_bins);
+    for (unsigned int i = 0; i < m_n_bins; i++)
+        centers[i] = (double(i) + 0.5)*dr;
+    return centers;
+    }
+
+/*! The histogram is summed over the ranks, so all ranks must call getRDF() together.
+*/
+std::vector<double> RadialDistribution::getRDF()
+    {
+    std::vector<unsigned long long> counts(m_n_bins);
+        {
+        ArrayHandle<unsigned long long> h_histogram(m_histogram, access_location::host, access_mode::read);
+        std::copy(h_histogram.data, h_histogram.data + m_n_bins, counts.begin());
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE,
+                      counts.data(),
+                      m_n_bins,
+                      MPI_UNSIGNED_LONG_LONG,
+                      MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    std::vector<double> rdf(m_n_bins, 0.0);
+    if (m_n_frames == 0)
+        return rdf;
+
+    const double dr = double(m_r_max)/double(m_n_bins);
+    const bool twod = m_sysdef->getNDimensions() == 2;
+    for (unsigned int i = 0; i < m_n_bins; i++)
+        {
+        double r_lo = double(i)*dr;
+        double r_hi = r_lo + dr;
+        double shell = twod ? M_PI*(r_hi*r_hi - r_lo*r_lo)
+                            : 4.0/3.0*M_PI*(r_hi*r_hi*r_hi - r_lo*r_lo*r_lo);
+        rdf[i] = double(counts[i])/(m_norm*shell);
+        }
+    return rdf;
+    }
+
+void RadialDistribution::reset()
+    {
+    ArrayHandle<unsigned long long> h_histogram(m_histogram, access_location::host, access_mode::overwrite);
+    std::fill(h_histogram.data, h_histogram.data + m_n_bins, 0);
+    m_n_frames = 0;
+    m_norm = 0.0;
+    }
+
+void export_RadialDistribution(py::module& m)
+    {
+    py::class_<RadialDistribution, Analyzer, std::shared_ptr<RadialDistribution> >(m, "RadialDistribution")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, Scalar, unsigned int >())
+        .def_property_readonly("bin_centers", &RadialDistribution::getBinCenters)
+        .def_property_readonly("rdf", &RadialDistribution::getRDF)
+        .def_property_readonly("num_frames", &RadialDistribution::getNumFrames)
+        .def("reset", &RadialDistribution::reset)
+        ;
+    }
@@ -0,0 +1,82 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RadialDistribution.h
+    \brief Declares the RadialDistribution class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "NeighborList.h"
+#include "hoomd/Analyzer.h"
+#include "hoomd/GlobalArray.h"
+
+#include <memory>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+#ifndef __RADIAL_DISTRIBUTION_H__
+#define __RADIAL_DISTRIBUTION_H__
+
+//! Accumulates the radial distribution function during the simulation
+/*! The pairs within \a r_max are read from a neighbor list, which RadialDistribution requests to include all type
+    pairs out to \a r_max. Each call to analyze() adds the distances of the pairs to a histogram of \a n_bins bins
+    between 0 and \a r_max. The histogram counts ordered pairs, and getRDF() normalizes it by the number of frames,
+    the number of particles, the density, and the volume of each shell to give g(r).
+
+    Pairs excluded from the neighbor list (e.g. bonded pairs) are not counted.
+
+    The histogram is summed over the ranks only when it is read, so the accumulation costs no communication.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT RadialDistribution : public Analyzer
+    {
+    public:
+        //! Construct the analyzer
+        RadialDistribution(std::shared_ptr<SystemDefinition> sysdef,
+                           std::shared_ptr<NeighborList> nlist,
+                           Scalar r_max,
+                           unsigned int n_bins);
+
+        //! Destructor
+        virtual ~RadialDistribution();
+
+        //! Add the pairs at this time step to the histogram
+        virtual void analyze(uint64_t timestep);
+
+        //! Get the centers of the bins
+        std::vector<double> getBinCenters() const;
+
+        //! Get the radial distribution function, summed over all ranks
+        std::vector<double> getRDF();
+
+        //! Get the number of frames in the histogram
+        uint64_t getNumFrames() const
+            {
+            return m_n_frames;
+            }
+
+        //! Remove all frames
+        void reset();
+
+    protected:
+        std::shared_ptr<NeighborList> m_nlist;              //!< Neighbor list to read the pairs from
+        std::shared_ptr<GlobalArray<Scalar>> m_r_cut_nlist; //!< Cutoff requested from the neighbor list
+        Scalar m_r_max;                                     //!< Largest distance in the histogram
+        unsigned int m_n_bins;                              //!< Number of bins
+        GlobalArray<unsigned long long> m_histogram;        //!< Number of ordered pairs in each bin
+        uint64_t m_n_frames;                                //!< Number of frames in the histogram
+        double m_norm;                                      //!< Sum of N^2/V over the frames
+
+        //! Add the pairs of the local particles to the histogram
+        virtual void computeHistogram();
+    };
+
+//! Exports the RadialDistribution class to python
+void export_RadialDistribution(pybind11::module& m);
+
+#endif
@@ -0,0 +1,79 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RadialDistributionGPU.cc
+    \brief Defines the RadialDistributionGPU class
+*/
+
+#include "RadialDistributionGPU.h"
+#include "RadialDistributionGPU.cuh"
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System to analyze
+    \param nlist Neighbor list to read the pairs from
+    \param r_max Largest distance in the histogram
+    \param n_bins Number of bins in the histogram
+*/
+RadialDistributionGPU::RadialDistributionGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                             std::shared_ptr<NeighborList> nlist,
+                                             Scalar r_max,
+                                             unsigned int n_bins)
+    : RadialDistribution(sysdef, nlist, r_max, n_bins)
+    {
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a RadialDistributionGPU with no GPU in the execution configuration"
+                                  << endl;
+        throw std::runtime_error("Error initializing RadialDistributionGPU");
+        }
+
+    // each block keeps its own histogram in shared memory
+    if (m_n_bins*sizeof(unsigned int) > m_exec_conf->dev_prop.sharedMemPerBlock)
+        {
+        m_exec_conf->msg->error() << "md.compute.RDF: Too many bins for the GPU shared memory" << endl;
+        throw std::runtime_error("Error initializing RadialDistributionGPU");
+        }
+
+    std::vector<unsigned int> valid_params;
+    unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
+    for (unsigned int block_size = warp_size; block_size <= 1024; block_size += warp_size)
+        valid_params.push_back(block_size);
+
+    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "rdf_histogram", this->m_exec_conf));
+    }
+
+void RadialDistributionGPU::computeHistogram()
+    {
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_n_neigh(m_nlist->getNNeighArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_nlist(m_nlist->getNListArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_head_list(m_nlist->getHeadList(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned long long> d_histogram(m_histogram, access_location::device, access_mode::readwrite);
+
+    m_tuner->begin();
+    gpu_compute_rdf_histogram(d_histogram.data,
+                              d_pos.data,
+                              d_n_neigh.data,
+                              d_nlist.data,
+                              d_head_list.data,
+                              m_pdata->getN(),
+                              m_pdata->getBox(),
+                              m_r_max,
+                              m_n_bins,
+                              m_nlist->getStorageMode() == NeighborList::half,
+                              m_tuner->getParam());
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    m_tuner->end();
+    }
+
+void export_RadialDistributionGPU(py::module& m)
+    {
+    py::class_<RadialDistributionGPU, RadialDistribution, std::shared_ptr<RadialDistributionGPU> >(
+        m, "RadialDistributionGPU")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, Scalar, unsigned int >())
+        ;
+    }
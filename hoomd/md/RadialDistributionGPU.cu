@@ -0,0 +1,113 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hip/hip_runtime.h"
+#include "RadialDistributionGPU.cuh"
+
+/*! \file RadialDistributionGPU.cu
+    \brief Defines GPU kernel code for RadialDistributionGPU
+*/
+
+//! Adds the pairs in the neighbor list to the histogram
+/*! \param d_histogram Histogram to add to, n_bins elements
+    \param d_pos Particle positions
+    \param d_n_neigh Number of neighbors of each particle
+    \param d_nlist Neighbor list
+    \param d_head_list Indexes of the first neighbor of each particle in \a d_nlist
+    \param N Number of local particles
+    \param box Local simulation box
+    \param r_max Largest distance in the histogram
+    \param n_bins Number of bins in the histogram
+    \param half True when the neighbor list stores each pair of local particles once
+
+    Each thread processes one particle. The block accumulates its pairs into a histogram in shared memory, which
+    is then added to \a d_histogram, so that the global atomic operations are few.
+*/
+__global__ void gpu_compute_rdf_histogram_kernel(unsigned long long *d_histogram,
+                                                 const Scalar4 *d_pos,
+                                                 const unsigned int *d_n_neigh,
+                                                 const unsigned int *d_nlist,
+                                                 const unsigned int *d_head_list,
+                                                 const unsigned int N,
+                                                 const BoxDim box,
+                                                 const Scalar r_max,
+                                                 const unsigned int n_bins,
+                                                 const bool half)
+    {
+    extern __shared__ unsigned int s_histogram[];
+
+    for (unsigned int bin = threadIdx.x; bin < n_bins; bin += blockDim.x)
+        s_histogram[bin] = 0;
+    __syncthreads();
+
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx < N)
+        {
+        const Scalar4 postype = d_pos[idx];
+        const Scalar3 pi = make_scalar3(postype.x, postype.y, postype.z);
+        const unsigned int head = d_head_list[idx];
+        const unsigned int n_neigh = d_n_neigh[idx];
+        const Scalar r_max_sq = r_max*r_max;
+        const Scalar bin_scale = Scalar(n_bins)/r_max;
+
+        for (unsigned int k = 0; k < n_neigh; k++)
+            {
+            const unsigned int j = d_nlist[head + k];
+            const Scalar4 postype_j = d_pos[j];
+            Scalar3 dx = pi - make_scalar3(postype_j.x, postype_j.y, postype_j.z);
+            dx = box.minImage(dx);
+            const Scalar r_sq = dot(dx, dx);
+            if (r_sq >= r_max_sq)
+                continue;
+
+            unsigned int bin = (unsigned int)(fast::sqrt(r_sq)*bin_scale);
+            if (bin >= n_bins)
+                bin = n_bins - 1;
+            atomicAdd(&s_histogram[bin], (half && j < N) ? 2u : 1u);
+            }
+        }
+    __syncthreads();
+
+    for (unsigned int bin = threadIdx.x; bin < n_bins; bin += blockDim.x)
+        {
+        if (s_histogram[bin] > 0)
+            atomicAdd(&d_histogram[bin], (unsigned long long)s_histogram[bin]);
+        }
+    }
+
+/*! \param d_histogram Histogram to add to, n_bins elements
+    \param d_pos Particle positions
+    \param d_n_neigh Number of neighbors of each particle
+    \param d_nlist Neighbor list
+    \param d_head_list Indexes of the first neighbor of each particle in \a d_nlist
+    \param N Number of local particles
+    \param box Local simulation box
+    \param r_max Largest distance in the histogram
+    \param n_bins Number of bins in the histogram
+    \param half True when the neighbor list stores each pair of local particles once
+    \param block_size Number of threads per block
+*/
+hipError_t gpu_compute_rdf_histogram(unsigned long long *d_histogram,
+                                     const Scalar4 *d_pos,
+                                     const unsigned int *d_n_neigh,
+                                     const unsigned int *d_nlist,
+                                     const unsigned int *d_head_list,
+                                     const unsigned int N,
+                                     const BoxDim& box,
+                                     const Scalar r_max,
+                                     const unsigned int n_bins,
+                                     const bool half,
+                                     const unsigned int block_size)
+    {
+    if (N == 0)
+        return hipSuccess;
+
+    dim3 grid(N/block_size + 1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+    size_t shared_bytes = n_bins*sizeof(unsigned int);
+
+    hipLaunchKernelGGL((gpu_compute_rdf_histogram_kernel), grid, threads, shared_bytes, 0,
+                       d_histogram, d_pos, d_n_neigh, d_nlist, d_head_list, N, box, r_max, n_bins, half);
+
+    return hipSuccess;
+    }
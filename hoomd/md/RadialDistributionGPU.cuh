@@ -0,0 +1,28 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RadialDistributionGPU.cuh
+    \brief Declares GPU kernel code for RadialDistributionGPU
+*/
+
+#ifndef __RADIAL_DISTRIBUTION_GPU_CUH__
+#define __RADIAL_DISTRIBUTION_GPU_CUH__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/ParticleData.cuh"
+
+//! Kernel driver that adds the pairs in the neighbor list to the histogram
+hipError_t gpu_compute_rdf_histogram(unsigned long long *d_histogram,
+                                     const Scalar4 *d_pos,
+                                     const unsigned int *d_n_neigh,
+                                     const unsigned int *d_nlist,
+                                     const unsigned int *d_head_list,
+                                     const unsigned int N,
+                                     const BoxDim& box,
+                                     const Scalar r_max,
+                                     const unsigned int n_bins,
+                                     const bool half,
+                                     const unsigned int block_size);
+
+#endif
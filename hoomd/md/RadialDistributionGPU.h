@@ -0,0 +1,55 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file RadialDistributionGPU.h
+    \brief Declares the RadialDistributionGPU class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "RadialDistribution.h"
+#include "hoomd/Autotuner.h"
+
+#include <memory>
+
+#ifndef __RADIAL_DISTRIBUTION_GPU_H__
+#define __RADIAL_DISTRIBUTION_GPU_H__
+
+//! Accumulates the radial distribution function on the GPU
+/*! The histogram stays in device memory and is copied to the host only when it is read.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT RadialDistributionGPU : public RadialDistribution
+    {
+    public:
+        //! Construct the analyzer
+        RadialDistributionGPU(std::shared_ptr<SystemDefinition> sysdef,
+                              std::shared_ptr<NeighborList> nlist,
+                              Scalar r_max,
+                              unsigned int n_bins);
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            RadialDistribution::setAutotunerParams(enable, period);
+            m_tuner->setPeriod(period);
+            m_tuner->setEnabled(enable);
+            }
+
+    protected:
+        std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for the block size
+
+        //! Add the pairs of the local particles to the histogram
+        virtual void computeHistogram();
+    };
+
+//! Exports the RadialDistributionGPU class to python
+void export_RadialDistributionGPU(pybind11::module& m);
+
+#endif
@@ -0,0 +1,218 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file StructureFactor.cc
+    \brief Defines the StructureFactor class
+*/
+
+#include "StructureFactor.h"
+#include "hoomd/VectorMath.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <cmath>
+#include <limits>
+#include <pybind11/stl.h>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System to analyze
+    \param group Group of particles to compute S(q) of
+    \param q_max Largest wave vector magnitude
+    \param n_bins Number of bins of |q|
+*/
+StructureFactor::StructureFactor(std::shared_ptr<SystemDefinition> sysdef,
+                                 std::shared_ptr<ParticleGroup> group,
+                                 Scalar q_max,
+                                 unsigned int n_bins)
+    : Analyzer(sysdef), m_group(group), m_q_max(q_max), m_n_bins(n_bins), m_n_frames(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing StructureFactor" << endl;
+
+    if (m_q_max <= Scalar(0.0) || m_n_bins == 0)
+        {
+        m_exec_conf->msg->error() << "md.compute.StructureFactor: q_max and bins must be positive" << endl;
+        throw runtime_error("Error initializing StructureFactor");
+        }
+
+    m_s_sum.resize(m_n_bins);
+    m_s_count.resize(m_n_bins);
+    updateWavevectors();
+    reset();
+    }
+
+StructureFactor::~StructureFactor()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying StructureFactor" << endl;
+    }
+
+/*! A wave vector of the reciprocal lattice is q = n_1 b_1 + n_2 b_2 + n_3 b_3 with integer n_i, where
+    a_i . b_j = 2 pi delta_ij. Since n_i = q . a_i / (2 pi), the wave vectors with |q| <= q_max have
+    |n_i| <= q_max |a_i| / (2 pi).
+*/
+void StructureFactor::updateWavevectors()
+    {
+    m_box = m_pdata->getGlobalBox();
+    const bool twod = m_sysdef->getNDimensions() == 2;
+
+    vec3<double> a1(m_box.getLatticeVector(0));
+    vec3<double> a2(m_box.getLatticeVector(1));
+    vec3<double> a3(m_box.getLatticeVector(2));
+    if (twod)
+        a3 = vec3<double>(0, 0, 1);
+
+    const double two_pi = 2.0*M_PI;
+    const double volume = dot(a1, cross(a2, a3));
+    vec3<double> b1 = two_pi/volume*cross(a2, a3);
+    vec3<double> b2 = two_pi/volume*cross(a3, a1);
+    vec3<double> b3 = two_pi/volume*cross(a1, a2);
+
+    const double q_max = m_q_max;
+    const int n1_max = int(q_max*sqrt(dot(a1, a1))/two_pi);
+    const int n2_max = int(q_max*sqrt(dot(a2, a2))/two_pi);
+    const int n3_max = twod ? 0 : int(q_max*sqrt(dot(a3, a3))/two_pi);
+
+    std::vector<Scalar3> wavevectors;
+    m_q_bin.clear();
+    for (int n1 = 0; n1 <= n1_max; n1++)
+        {
+        for (int n2 = (n1 == 0) ? 0 : -n2_max; n2 <= n2_max; n2++)
+            {
+            for (int n3 = (n1 == 0 && n2 == 0) ? 1 : -n3_max; n3 <= n3_max; n3++)
+                {
+                vec3<double> q = double(n1)*b1 + double(n2)*b2 + double(n3)*b3;
+                double q_mag = sqrt(dot(q, q));
+                if (q_mag > q_max)
+                    continue;
+
+                unsigned int bin = (unsigned int)(q_mag/q_max*m_n_bins);
+                if (bin >= m_n_bins)
+                    bin = m_n_bins - 1;
+                wavevectors.push_back(make_scalar3(Scalar(q.x), Scalar(q.y), Scalar(q.z)));
+                m_q_bin.push_back(bin);
+                }
+            }
+        }
+
+    if (wavevectors.size() > 0)
+        {
+        GlobalArray<Scalar3> new_wavevectors(wavevectors.size(), m_exec_conf);
+        m_wavevectors.swap(new_wavevectors);
+        TAG_ALLOCATION(m_wavevectors);
+
+        ArrayHandle<Scalar3> h_wavevectors(m_wavevectors, access_location::host, access_mode::overwrite);
+        std::copy(wavevectors.begin(), wavevectors.end(), h_wavevectors.data);
+        }
+    m_rho.resize(2*wavevectors.size());
+
+    m_exec_conf->msg->notice(6) << "StructureFactor: evaluating " << wavevectors.size() << " wave vectors" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void StructureFactor::analyze(uint64_t timestep)
+    {
+    if (m_prof)
+        m_prof->push(m_exec_conf, "S(q)");
+
+    if (m_pdata->getGlobalBox() != m_box)
+        updateWavevectors();
+
+    m_n_frames++;
+    const unsigned int n_q = getNumWavevectors();
+    const unsigned int N = m_group->getNumMembersGlobal();
+    if (n_q == 0 || N == 0)
+        {
+        if (m_prof)
+            m_prof->pop(m_exec_conf);
+        return;
+        }
+
+    computeDensityModes();
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, m_rho.data(), 2*n_q, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    for (unsigned int i = 0; i < n_q; i++)
+        {
+        const double re = m_rho[2*i];
+        const double im = m_rho[2*i+1];
+        m_s_sum[m_q_bin[i]] += (re*re + im*im)/double(N);
+        m_s_count[m_q_bin[i]]++;
+        }
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+
+void StructureFactor::computeDensityModes()
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_wavevectors(m_wavevectors, access_location::host, access_mode::read);
+
+    const unsigned int n_q = getNumWavevectors();
+    const unsigned int n_members = m_group->getNumMembers();
+    for (unsigned int i = 0; i < n_q; i++)
+        {
+        const Scalar3 q = h_wavevectors.data[i];
+        double re = 0.0;
+        double im = 0.0;
+        for (unsigned int group_idx = 0; group_idx < n_members; group_idx++)
+            {
+            const Scalar4 postype = h_pos.data[m_group->getMemberIndex(group_idx)];
+            const Scalar phase = q.x*postype.x + q.y*postype.y + q.z*postype.z;
+            re += fast::cos(phase);
+            im += fast::sin(phase);
+            }
+        m_rho[2*i] = re;
+        m_rho[2*i+1] = im;
+        }
+    }
+
+std::vector<double> StructureFactor::getBinCenters() const
+    {
+    std::vector<double> centers(m_n_bins);
+    const double dq = double(m_q_max)/double(m_n_bins);
+    for (unsigned int i = 0; i < m_n_bins; i++)
+        centers[i] = (double(i) + 0.5)*dq;
+    return centers;
+    }
+
+std::vector<double> StructureFactor::getStructureFactor() const
+    {
+    std::vector<double> s(m_n_bins);
+    for (unsigned int i = 0; i < m_n_bins; i++)
+        {
+        if (m_s_count[i] > 0)
+            s[i] = m_s_sum[i]/double(m_s_count[i]);
+        else
+            s[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+    return s;
+    }
+
+void StructureFactor::reset()
+    {
+    std::fill(m_s_sum.begin(), m_s_sum.end(), 0.0);
+    std::fill(m_s_count.begin(), m_s_count.end(), 0);
+    m_n_frames = 0;
+    }
+
+void export_StructureFactor(py::module& m)
+    {
+    py::class_<StructureFactor, Analyzer, std::shared_ptr<StructureFactor> >(m, "StructureFactor")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup>, Scalar, unsigned int >())
+        .def_property_readonly("bin_centers", &StructureFactor::getBinCenters)
+        .def_property_readonly("structure_factor", &StructureFactor::getStructureFactor)
+        .def_property_readonly("num_wavevectors", &StructureFactor::getNumWavevectors)
+        .def_property_readonly("num_frames", &StructureFactor::getNumFrames)
+        .def("reset", &StructureFactor::reset)
+        ;
+    }
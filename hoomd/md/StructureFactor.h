@@ -0,0 +1,96 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file StructureFactor.h
+    \brief Declares the StructureFactor class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/Analyzer.h"
+#include "hoomd/GlobalArray.h"
+#include "hoomd/ParticleGroup.h"
+
+#include <memory>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+
+#ifndef __STRUCTURE_FACTOR_H__
+#define __STRUCTURE_FACTOR_H__
+
+//! Accumulates the static structure factor during the simulation
+/*! S(q) = |rho(q)|^2 / N is evaluated at the wave vectors q of the reciprocal lattice of the periodic box with
+    0 < |q| <= \a q_max, where rho(q) is the sum of exp(i q.r) over the particles in the group. Only one of q and
+    -q is evaluated, since they give the same S(q). The values are averaged over the frames and over the wave
+    vectors in each of \a n_bins bins of |q|.
+
+    The density modes are summed directly over the particles, which is exact at every wave vector and costs
+    O(N N_q) per frame. This suits the low q region of interest, where N_q grows as q_max^3. The wave vectors are
+    regenerated when the box changes.
+
+    In MPI simulations, the density modes of the ranks are summed every frame, which communicates 2 N_q values.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT StructureFactor : public Analyzer
+    {
+    public:
+        //! Construct the analyzer
+        StructureFactor(std::shared_ptr<SystemDefinition> sysdef,
+                        std::shared_ptr<ParticleGroup> group,
+                        Scalar q_max,
+                        unsigned int n_bins);
+
+        //! Destructor
+        virtual ~StructureFactor();
+
+        //! Add the structure factor at this time step to the average
+        virtual void analyze(uint64_t timestep);
+
+        //! Get the centers of the bins
+        std::vector<double> getBinCenters() const;
+
+        //! Get the structure factor in each bin, NaN for bins with no wave vectors
+        std::vector<double> getStructureFactor() const;
+
+        //! Get the number of wave vectors evaluated
+        unsigned int getNumWavevectors() const
+            {
+            return (unsigned int)m_q_bin.size();
+            }
+
+        //! Get the number of frames in the average
+        uint64_t getNumFrames() const
+            {
+            return m_n_frames;
+            }
+
+        //! Remove all frames
+        void reset();
+
+    protected:
+        std::shared_ptr<ParticleGroup> m_group;     //!< Group of particles to compute S(q) of
+        Scalar m_q_max;                             //!< Largest wave vector magnitude
+        unsigned int m_n_bins;                      //!< Number of bins
+        BoxDim m_box;                               //!< Box the wave vectors were generated for
+        GlobalArray<Scalar3> m_wavevectors;         //!< Wave vectors to evaluate
+        std::vector<unsigned int> m_q_bin;          //!< Bin of each wave vector
+        std::vector<double> m_rho;                  //!< Real and imaginary parts of the density modes
+        std::vector<double> m_s_sum;                //!< Sum of S(q) in each bin
+        std::vector<uint64_t> m_s_count;            //!< Number of values summed in each bin
+        uint64_t m_n_frames;                        //!< Number of frames in the average
+
+        //! Generate the wave vectors of the reciprocal lattice of the current box
+        void updateWavevectors();
+
+        //! Sum the density modes of the local particles into m_rho
+        virtual void computeDensityModes();
+    };
+
+//! Exports the StructureFactor class to python
+void export_StructureFactor(pybind11::module& m);
+
+#endif
@@ -0,0 +1,86 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file StructureFactorGPU.cc
+    \brief Defines the StructureFactorGPU class
+*/
+
+#include "StructureFactorGPU.h"
+#include "StructureFactorGPU.cuh"
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System to analyze
+    \param group Group of particles to compute S(q) of
+    \param q_max Largest wave vector magnitude
+    \param n_bins Number of bins of |q|
+*/
+StructureFactorGPU::StructureFactorGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                       std::shared_ptr<ParticleGroup> group,
+                                       Scalar q_max,
+                                       unsigned int n_bins)
+    : StructureFactor(sysdef, group, q_max, n_bins)
+    {
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a StructureFactorGPU with no GPU in the execution configuration"
+                                  << endl;
+        throw std::runtime_error("Error initializing StructureFactorGPU");
+        }
+
+    // the reduction in the kernel needs a power of two block size
+    std::vector<unsigned int> valid_params;
+    unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
+    for (unsigned int block_size = warp_size; block_size <= 1024; block_size *= 2)
+        valid_params.push_back(block_size);
+
+    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "structure_factor", this->m_exec_conf));
+    }
+
+void StructureFactorGPU::computeDensityModes()
+    {
+    const unsigned int n_q = getNumWavevectors();
+    if (m_rho_gpu.getNumElements() != n_q)
+        {
+        GlobalArray<double2> rho_gpu(n_q, m_exec_conf);
+        m_rho_gpu.swap(rho_gpu);
+        TAG_ALLOCATION(m_rho_gpu);
+        }
+
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_group_members(m_group->getIndexArray(),
+                                                  access_location::device,
+                                                  access_mode::read);
+        ArrayHandle<Scalar3> d_wavevectors(m_wavevectors, access_location::device, access_mode::read);
+        ArrayHandle<double2> d_rho(m_rho_gpu, access_location::device, access_mode::overwrite);
+
+        m_tuner->begin();
+        gpu_compute_density_modes(d_rho.data,
+                                  d_pos.data,
+                                  d_group_members.data,
+                                  m_group->getNumMembers(),
+                                  d_wavevectors.data,
+                                  n_q,
+                                  m_tuner->getParam());
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner->end();
+        }
+
+    ArrayHandle<double2> h_rho(m_rho_gpu, access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < n_q; i++)
+        {
+        m_rho[2*i] = h_rho.data[i].x;
+        m_rho[2*i+1] = h_rho.data[i].y;
+        }
+    }
+
+void export_StructureFactorGPU(py::module& m)
+    {
+    py::class_<StructureFactorGPU, StructureFactor, std::shared_ptr<StructureFactorGPU> >(m, "StructureFactorGPU")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup>, Scalar, unsigned int >())
+        ;
+    }
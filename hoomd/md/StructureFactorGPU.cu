@@ -0,0 +1,93 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hip/hip_runtime.h"
+#include "StructureFactorGPU.cuh"
+
+/*! \file StructureFactorGPU.cu
+    \brief Defines GPU kernel code for StructureFactorGPU
+*/
+
+//! Sums the density modes of the group members
+/*! \param d_rho Real and imaginary parts of the density mode at each wave vector (output)
+    \param d_pos Particle positions
+    \param d_group_members Indices of the group members
+    \param group_size Number of local group members
+    \param d_wavevectors Wave vectors to evaluate
+    \param n_q Number of wave vectors
+
+    Each block evaluates the wave vectors blockIdx.x, blockIdx.x + gridDim.x, ... Its threads stride over the
+    group members, then the partial sums are reduced in shared memory.
+*/
+__global__ void gpu_compute_density_modes_kernel(double2 *d_rho,
+                                                 const Scalar4 *d_pos,
+                                                 const unsigned int *d_group_members,
+                                                 const unsigned int group_size,
+                                                 const Scalar3 *d_wavevectors,
+                                                 const unsigned int n_q)
+    {
+    extern __shared__ double2 s_rho[];
+
+    for (unsigned int q_idx = blockIdx.x; q_idx < n_q; q_idx += gridDim.x)
+        {
+        const Scalar3 q = d_wavevectors[q_idx];
+
+        double2 rho = make_double2(0.0, 0.0);
+        for (unsigned int group_idx = threadIdx.x; group_idx < group_size; group_idx += blockDim.x)
+            {
+            const Scalar4 postype = d_pos[d_group_members[group_idx]];
+            const Scalar phase = q.x*postype.x + q.y*postype.y + q.z*postype.z;
+            Scalar s, c;
+            fast::sincos(phase, s, c);
+            rho.x += c;
+            rho.y += s;
+            }
+
+        s_rho[threadIdx.x] = rho;
+        __syncthreads();
+
+        for (unsigned int offset = blockDim.x/2; offset > 0; offset >>= 1)
+            {
+            if (threadIdx.x < offset)
+                {
+                s_rho[threadIdx.x].x += s_rho[threadIdx.x + offset].x;
+                s_rho[threadIdx.x].y += s_rho[threadIdx.x + offset].y;
+                }
+            __syncthreads();
+            }
+
+        if (threadIdx.x == 0)
+            d_rho[q_idx] = s_rho[0];
+        __syncthreads();
+        }
+    }
+
+/*! \param d_rho Real and imaginary parts of the density mode at each wave vector (output)
+    \param d_pos Particle positions
+    \param d_group_members Indices of the group members
+    \param group_size Number of local group members
+    \param d_wavevectors Wave vectors to evaluate
+    \param n_q Number of wave vectors
+    \param block_size Number of threads per block, a power of two
+*/
+hipError_t gpu_compute_density_modes(double2 *d_rho,
+                                     const Scalar4 *d_pos,
+                                     const unsigned int *d_group_members,
+                                     const unsigned int group_size,
+                                     const Scalar3 *d_wavevectors,
+                                     const unsigned int n_q,
+                                     const unsigned int block_size)
+    {
+    if (n_q == 0)
+        return hipSuccess;
+
+    // one block per wave vector, up to the grid size limit
+    dim3 grid(n_q < 65535 ? n_q : 65535, 1, 1);
+    dim3 threads(block_size, 1, 1);
+    size_t shared_bytes = block_size*sizeof(double2);
+
+    hipLaunchKernelGGL((gpu_compute_density_modes_kernel), grid, threads, shared_bytes, 0,
+                       d_rho, d_pos, d_group_members, group_size, d_wavevectors, n_q);
+
+    return hipSuccess;
+    }
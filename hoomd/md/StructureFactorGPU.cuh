@@ -0,0 +1,23 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file StructureFactorGPU.cuh
+    \brief Declares GPU kernel code for StructureFactorGPU
+*/
+
+#ifndef __STRUCTURE_FACTOR_GPU_CUH__
+#define __STRUCTURE_FACTOR_GPU_CUH__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/ParticleData.cuh"
+
+//! Kernel driver that sums the density modes of the group members
+hipError_t gpu_compute_density_modes(double2 *d_rho,
+                                     const Scalar4 *d_pos,
+                                     const unsigned int *d_group_members,
+                                     const unsigned int group_size,
+                                     const Scalar3 *d_wavevectors,
+                                     const unsigned int n_q,
+                                     const unsigned int block_size);
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file StructureFactorGPU.h
+    \brief Declares the StructureFactorGPU class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "StructureFactor.h"
+#include "hoomd/Autotuner.h"
+
+#include <memory>
+
+#ifndef __STRUCTURE_FACTOR_GPU_H__
+#define __STRUCTURE_FACTOR_GPU_H__
+
+//! Accumulates the static structure factor on the GPU
+/*! The density modes are summed on the device, and only the 2 N_q sums are copied to the host each frame.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT StructureFactorGPU : public StructureFactor
+    {
+    public:
+        //! Construct the analyzer
+        StructureFactorGPU(std::shared_ptr<SystemDefinition> sysdef,
+                           std::shared_ptr<ParticleGroup> group,
+                           Scalar q_max,
+                           unsigned int n_bins);
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            StructureFactor::setAutotunerParams(enable, period);
+            m_tuner->setPeriod(period);
+            m_tuner->setEnabled(enable);
+            }
+
+    protected:
+        std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for the block size
+        GlobalArray<double2> m_rho_gpu;     //!< Density modes computed on the device
+
+        //! Sum the density modes of the local particles into m_rho
+        virtual void computeDensityModes();
+    };
+
+//! Exports the StructureFactorGPU class to python
+void export_StructureFactorGPU(pybind11::module& m);
+
+#endif
@@ -29,7 +29,7 @@ using namespace std;
 TableAngleForceCompute::TableAngleForceCompute(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_table_width(table_width)
+        : ForceCompute(sysdef), m_table_width(table_width), m_hermite(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing TableAngleForceCompute" << endl;
 
@@ -109,6 +109,26 @@ void TableAngleForceCompute::setTable(unsigned int type,
         }
     }
 
+/*! \param interpolation "linear" or "hermite"
+*/
+void TableAngleForceCompute::setInterpolation(const std::string& interpolation)
+    {
+    if (interpolation == "linear")
+        m_hermite = false;
+    else if (interpolation == "hermite")
+        m_hermite = true;
+    else
+        {
+        m_exec_conf->msg->error() << "angle.table: interpolation must be linear or hermite, got " << interpolation << endl;
+        throw runtime_error("Error setting table interpolation");
+        }
+    }
+
+std::string TableAngleForceCompute::getInterpolation()
+    {
+    return m_hermite ? "hermite" : "linear";
+    }
+
 /*! TableAngleForceCompute provides
     - \c angle_table_energy
 */
@@ -248,20 +268,19 @@ void TableAngleForceCompute::computeForces(uint64_t timestep)
         /// Here we use the table!!
         unsigned int angle_type = m_angle_data->getTypeByIndex(i);
         unsigned int value_i = (unsigned int)(slow::floor(value_f));
+        // theta = pi ends on the last point, interpolate in the last interval
+        if (value_i > m_table_width - 2)
+            value_i = m_table_width - 2;
         Scalar2 VT0 = h_tables.data[m_table_value(value_i, angle_type)];
         Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, angle_type)];
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
 
-        // compute the linear interpolation coefficient
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        // interpolate to get V and T
+        Scalar2 VT = table_interpolate(VT0, VT1, f, delta_th, m_hermite);
+        Scalar V = VT.x;
+        Scalar T = VT.y;
 
         Scalar a =  T*s_abbc;
         Scalar a11 = a*c_abbc/rsqab;
@@ -333,5 +352,7 @@ void export_TableAngleForceCompute(py::module& m)
     py::class_<TableAngleForceCompute, ForceCompute, std::shared_ptr<TableAngleForceCompute> >(m, "TableAngleForceCompute")
     .def(py::init< std::shared_ptr<SystemDefinition>, unsigned int, const std::string& >())
     .def("setTable", &TableAngleForceCompute::setTable)
+    .def("setInterpolation", &TableAngleForceCompute::setInterpolation)
+    .def("getInterpolation", &TableAngleForceCompute::getInterpolation)
     ;
     }
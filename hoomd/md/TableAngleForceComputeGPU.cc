@@ -58,6 +58,9 @@ void TableAngleForceComputeGPU::computeForces(uint64_t timestep)
     // access the table data
     ArrayHandle<Scalar2> d_tables(m_tables, access_location::device, access_mode::read);
 
+    // stage the tables in shared memory when they fit
+    bool stage_tables = sizeof(Scalar2)*m_tables.getNumElements() <= m_exec_conf->dev_prop.sharedMemPerBlock;
+
     ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(m_virial,access_location::device,access_mode::overwrite);
 
@@ -66,6 +69,7 @@ void TableAngleForceComputeGPU::computeForces(uint64_t timestep)
         ArrayHandle<group_storage<3> > d_gpu_anglelist(m_angle_data->getGPUTable(), access_location::device,access_mode::read);
         ArrayHandle<unsigned int> d_gpu_angle_pos_list(m_angle_data->getGPUPosTable(), access_location::device,access_mode::read);
         ArrayHandle<unsigned int> d_gpu_n_angles(m_angle_data->getNGroupsArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_table_offsets(m_angle_data->getGPUTableOffsets(), access_location::device, access_mode::read);
 
 
         // run the kernel on all GPUs in parallel
@@ -79,11 +83,14 @@ void TableAngleForceComputeGPU::computeForces(uint64_t timestep)
                              d_gpu_anglelist.data,
                              d_gpu_angle_pos_list.data,
                              m_angle_data->getGPUTableIndexer().getW(),
+                             d_gpu_table_offsets.data,
                              d_gpu_n_angles.data,
                              d_tables.data,
                              m_table_width,
                              m_table_value,
-                             m_tuner->getParam());
+                             m_tuner->getParam(),
+                             m_hermite,
+                             stage_tables);
         }
 
 
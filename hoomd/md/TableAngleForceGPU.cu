@@ -28,11 +28,15 @@
     \param alist List of angles stored on the GPU
     \param apos_list List of particle position in angle stored on the GPU
     \param pitch Pitch of 2D angle list
+    \param table_offsets Index of the first entry of every particle in the angle list
     \param n_angles_list List of numbers of angles stored on the GPU
     \param n_angle_type number of angle types
     \param d_tables Tables of the potential and force
     \param table_value index helper function
     \param delta_th angle delta of the table
+    \param table_width Number of points in each table
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \param stage_tables True if the tables are copied to shared memory
 
     See TableAngleForceCompute for information on the memory layout.
 */
@@ -45,11 +49,26 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
                                      const group_storage<3> *alist,
                                      const unsigned int *apos_list,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_angles_list,
                                      const Scalar2 *d_tables,
                                      const Index2D table_value,
-                                     const Scalar delta_th)
+                                     const Scalar delta_th,
+                                     const unsigned int table_width,
+                                     const bool hermite,
+                                     const bool stage_tables)
     {
+    // stage the tables in shared memory when they fit
+    HIP_DYNAMIC_SHARED( Scalar2, s_tables)
+    if (stage_tables)
+        {
+        for (unsigned int cur_offset = 0; cur_offset < table_value.getNumElements(); cur_offset += blockDim.x)
+            {
+            if (cur_offset + threadIdx.x < table_value.getNumElements())
+                s_tables[cur_offset + threadIdx.x] = d_tables[cur_offset + threadIdx.x];
+            }
+        __syncthreads();
+        }
 
 
     // start by identifying which particle we are to handle
@@ -61,6 +80,9 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_angles =n_angles_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our b-particle from the a-b-c triplet. (MEM TRANSFER: 16 bytes)
     Scalar4 idx_postype = d_pos[idx];  // we can be either a, b, or c in the a-b-c triplet
     Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
@@ -79,12 +101,12 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
 
     for (int angle_idx = 0; angle_idx < n_angles; angle_idx++)
         {
-        group_storage<3> cur_angle = alist[pitch*angle_idx + idx];
+        group_storage<3> cur_angle = alist[pitch*angle_idx + table_start];
 
         int cur_angle_x_idx = cur_angle.idx[0];
         int cur_angle_y_idx = cur_angle.idx[1];
         int cur_angle_type = cur_angle.idx[2];
-        int cur_angle_abc = apos_list[pitch*angle_idx + idx];
+        int cur_angle_abc = apos_list[pitch*angle_idx + table_start];
 
         // get the a-particle's position (MEM TRANSFER: 16 bytes)
         Scalar4 x_postype = d_pos[cur_angle_x_idx];
@@ -146,20 +168,20 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
 
         // compute index into the table and read in values
         unsigned int value_i = value_f;
-        Scalar2 VT0 = __ldg(d_tables + table_value(value_i, cur_angle_type));
-        Scalar2 VT1 = __ldg(d_tables + table_value(value_i+1, cur_angle_type));
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
-
-        // compute the linear interpolation coefficient
+        // theta = pi ends on the last point, interpolate in the last interval
+        if (value_i > table_width - 2)
+            value_i = table_width - 2;
+        unsigned int i0 = table_value(value_i, cur_angle_type);
+        Scalar2 VT0 = stage_tables ? s_tables[i0] : __ldg(d_tables + i0);
+        Scalar2 VT1 = stage_tables ? s_tables[i0+1] : __ldg(d_tables + i0 + 1);
+
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        // interpolate to get V and T
+        Scalar2 VT = table_interpolate(VT0, VT1, f, delta_th, hermite);
+        Scalar V = VT.x;
+        Scalar T = VT.y;
 
 
         Scalar a = T * s_abbc;
@@ -227,13 +249,15 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
     \param box Box dimensions used to implement periodic boundary conditions
     \param alist List of angles stored on the GPU
     \param pitch Pitch of 2D angle list
+    \param table_offsets Index of the first entry of every particle in the angle list
     \param n_angles_list List of numbers of angles stored on the GPU
     \param n_angle_type number of angle types
     \param d_tables Tables of the potential and force
     \param table_width Number of points in each table
     \param table_value indexer helper
     \param block_size Block size at which to run the kernel
-    \param compute_capability Compute capability of the device (200, 300, 350, ...)
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \param stage_tables True if the tables fit in shared memory
 
     \note This is just a kernel driver. See gpu_compute_table_angle_forces_kernel for full documentation.
 */
@@ -246,11 +270,14 @@ hipError_t gpu_compute_table_angle_forces(Scalar4* d_force,
                                      const group_storage<3> *alist,
                                      const unsigned int *apos_list,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_angles_list,
                                      const Scalar2 *d_tables,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
-                                     const unsigned int block_size)
+                                     const unsigned int block_size,
+                                     const bool hermite,
+                                     const bool stage_tables)
     {
     assert(d_tables);
     assert(table_width > 1);
@@ -274,7 +301,9 @@ hipError_t gpu_compute_table_angle_forces(Scalar4* d_force,
 
     Scalar delta_th = Scalar(M_PI)/(Scalar)(table_width - 1);
 
-    hipLaunchKernelGGL((gpu_compute_table_angle_forces_kernel), dim3(grid), dim3(threads ), 0, 0, d_force,
+    unsigned int shared_bytes = stage_tables ? sizeof(Scalar2)*table_value.getNumElements() : 0;
+
+    hipLaunchKernelGGL((gpu_compute_table_angle_forces_kernel), dim3(grid), dim3(threads), shared_bytes, 0, d_force,
              d_virial,
              virial_pitch,
              N,
@@ -283,10 +312,14 @@ hipError_t gpu_compute_table_angle_forces(Scalar4* d_force,
              alist,
              apos_list,
              pitch,
+             table_offsets,
              n_angles_list,
              d_tables,
              table_value,
-             delta_th);
+             delta_th,
+             table_width,
+             hermite,
+             stage_tables);
 
     return hipSuccess;
     }
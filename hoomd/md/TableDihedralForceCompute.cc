@@ -30,7 +30,7 @@ using namespace std;
 TableDihedralForceCompute::TableDihedralForceCompute(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_table_width(table_width)
+        : ForceCompute(sysdef), m_table_width(table_width), m_hermite(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing TableDihedralForceCompute" << endl;
 
@@ -99,6 +99,26 @@ void TableDihedralForceCompute::setTable(unsigned int type,
         }
     }
 
+/*! \param interpolation "linear" or "hermite"
+*/
+void TableDihedralForceCompute::setInterpolation(const std::string& interpolation)
+    {
+    if (interpolation == "linear")
+        m_hermite = false;
+    else if (interpolation == "hermite")
+        m_hermite = true;
+    else
+        {
+        m_exec_conf->msg->error() << "dihedral.table: interpolation must be linear or hermite, got " << interpolation << endl;
+        throw runtime_error("Error setting table interpolation");
+        }
+    }
+
+std::string TableDihedralForceCompute::getInterpolation()
+    {
+    return m_hermite ? "hermite" : "linear";
+    }
+
 /*! TableDihedralForceCompute provides
     - \c dihedral_table_energy
 */
@@ -279,20 +299,19 @@ void TableDihedralForceCompute::computeForces(uint64_t timestep)
         /// Here we use the table!!
         unsigned int dihedral_type = m_dihedral_data->getTypeByIndex(i);
         unsigned int value_i = (unsigned int)value_f;
+        // phi = pi ends on the last point, interpolate in the last interval
+        if (value_i > m_table_width - 2)
+            value_i = m_table_width - 2;
         Scalar2 VT0 = h_tables.data[m_table_value(value_i, dihedral_type)];
         Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, dihedral_type)];
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
 
-        // compute the linear interpolation coefficient
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        // interpolate to get V and T
+        Scalar2 VT = table_interpolate(VT0, VT1, f, delta_phi, m_hermite);
+        Scalar V = VT.x;
+        Scalar T = VT.y;
 
         // from Blondel and Karplus 1995
         vec3<Scalar> A = cross(vec3<Scalar>(dab),vec3<Scalar>(dcbm));
@@ -359,6 +378,8 @@ void export_TableDihedralForceCompute(py::module& m)
     py::class_<TableDihedralForceCompute, ForceCompute, std::shared_ptr<TableDihedralForceCompute> >(m, "TableDihedralForceCompute")
     .def(py::init< std::shared_ptr<SystemDefinition>, unsigned int, const std::string& >())
     .def("setTable", &TableDihedralForceCompute::setTable)
+    .def("setInterpolation", &TableDihedralForceCompute::setInterpolation)
+    .def("getInterpolation", &TableDihedralForceCompute::getInterpolation)
     .def("getEntry", &TableDihedralForceCompute::getEntry)
     ;
     }
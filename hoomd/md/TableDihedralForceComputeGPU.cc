@@ -59,6 +59,9 @@ void TableDihedralForceComputeGPU::computeForces(uint64_t timestep)
     // access the table data
     ArrayHandle<Scalar2> d_tables(m_tables, access_location::device, access_mode::read);
 
+    // stage the tables in shared memory when they fit
+    bool stage_tables = sizeof(Scalar2)*m_tables.getNumElements() <= m_exec_conf->dev_prop.sharedMemPerBlock;
+
     ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(m_virial,access_location::device,access_mode::overwrite);
 
@@ -66,6 +69,7 @@ void TableDihedralForceComputeGPU::computeForces(uint64_t timestep)
         // Access the dihedral data for reading
         ArrayHandle<group_storage<4> > d_gpu_dihedrallist(m_dihedral_data->getGPUTable(), access_location::device,access_mode::read);
         ArrayHandle<unsigned int> d_gpu_n_dihedrals(m_dihedral_data->getNGroupsArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_gpu_table_offsets(m_dihedral_data->getGPUTableOffsets(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_dihedrals_ABCD(m_dihedral_data->getGPUPosTable(), access_location::device, access_mode::read);
 
 
@@ -80,11 +84,14 @@ void TableDihedralForceComputeGPU::computeForces(uint64_t timestep)
                              d_gpu_dihedrallist.data,
                              d_dihedrals_ABCD.data,
                              m_dihedral_data->getGPUTableIndexer().getW(),
+                             d_gpu_table_offsets.data,
                              d_gpu_n_dihedrals.data,
                              d_tables.data,
                              m_table_width,
                              m_table_value,
-                             m_tuner->getParam());
+                             m_tuner->getParam(),
+                             m_hermite,
+                             stage_tables);
         }
 
 
@@ -29,11 +29,15 @@
     \param box Box dimensions used to implement periodic boundary conditions
     \param dlist List of dihedrals stored on the GPU
     \param pitch Pitch of 2D dihedral list
+    \param table_offsets Index of the first entry of every particle in the dihedral list
     \param n_dihedrals_list List of numbers of dihedrals stored on the GPU
     \param n_dihedral_type number of dihedral types
     \param d_tables Tables of the potential and force
     \param table_value index helper function
     \param delta_phi dihedral delta of the table
+    \param table_width Number of points in each table
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \param stage_tables True if the tables are copied to shared memory
 
     See TableDihedralForceCompute for information on the memory layout.
 */
@@ -46,11 +50,26 @@ __global__ void gpu_compute_table_dihedral_forces_kernel(Scalar4* d_force,
                                      const group_storage<4> *dlist,
                                      const unsigned int *dihedral_ABCD,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_dihedrals_list,
                                      const Scalar2 *d_tables,
                                      const Index2D table_value,
-                                     const Scalar delta_phi)
+                                     const Scalar delta_phi,
+                                     const unsigned int table_width,
+                                     const bool hermite,
+                                     const bool stage_tables)
     {
+    // stage the tables in shared memory when they fit
+    HIP_DYNAMIC_SHARED( Scalar2, s_tables)
+    if (stage_tables)
+        {
+        for (unsigned int cur_offset = 0; cur_offset < table_value.getNumElements(); cur_offset += blockDim.x)
+            {
+            if (cur_offset + threadIdx.x < table_value.getNumElements())
+                s_tables[cur_offset + threadIdx.x] = d_tables[cur_offset + threadIdx.x];
+            }
+        __syncthreads();
+        }
 
 
     // start by identifying which particle we are to handle
@@ -62,6 +81,9 @@ __global__ void gpu_compute_table_dihedral_forces_kernel(Scalar4* d_force,
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_dihedrals = n_dihedrals_list[idx];
 
+    // the entries of this particle start at its offset in the list (MEM TRANSFER: 4 bytes)
+    unsigned int table_start = table_offsets[idx];
+
     // read in the position of our b-particle from the a-b-c triplet. (MEM TRANSFER: 16 bytes)
     Scalar4 idx_postype = device_pos[idx];  // we can be either a, b, or c in the a-b-c triplet
     Scalar3 idx_pos = make_scalar3(idx_postype.x, idx_postype.y, idx_postype.z);
@@ -78,8 +100,8 @@ __global__ void gpu_compute_table_dihedral_forces_kernel(Scalar4* d_force,
 
     for (int dihedral_idx = 0; dihedral_idx < n_dihedrals; dihedral_idx++)
         {
-        group_storage<4> cur_dihedral = dlist[pitch*dihedral_idx + idx];
-        unsigned int cur_ABCD = dihedral_ABCD[pitch*dihedral_idx + idx];
+        group_storage<4> cur_dihedral = dlist[pitch*dihedral_idx + table_start];
+        unsigned int cur_ABCD = dihedral_ABCD[pitch*dihedral_idx + table_start];
 
         int cur_dihedral_x_idx = cur_dihedral.idx[0];
         int cur_dihedral_y_idx = cur_dihedral.idx[1];
@@ -199,20 +221,20 @@ __global__ void gpu_compute_table_dihedral_forces_kernel(Scalar4* d_force,
 
         // compute index into the table and read in values
         unsigned int value_i = value_f;
-        Scalar2 VT0 = __ldg(d_tables + table_value(value_i, cur_dihedral_type));
-        Scalar2 VT1 = __ldg(d_tables + table_value(value_i+1, cur_dihedral_type));
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
-
-        // compute the linear interpolation coefficient
+        // phi = pi ends on the last point, interpolate in the last interval
+        if (value_i > table_width - 2)
+            value_i = table_width - 2;
+        unsigned int i0 = table_value(value_i, cur_dihedral_type);
+        Scalar2 VT0 = stage_tables ? s_tables[i0] : __ldg(d_tables + i0);
+        Scalar2 VT1 = stage_tables ? s_tables[i0+1] : __ldg(d_tables + i0 + 1);
+
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        // interpolate to get V and T
+        Scalar2 VT = table_interpolate(VT0, VT1, f, delta_phi, hermite);
+        Scalar V = VT.x;
+        Scalar T = VT.y;
 
         // from Blondel and Karplus 1995
         vec3<Scalar> A = cross(vec3<Scalar>(dab),vec3<Scalar>(dcbm));
@@ -288,13 +310,15 @@ __global__ void gpu_compute_table_dihedral_forces_kernel(Scalar4* d_force,
     \param box Box dimensions used to implement periodic boundary conditions
     \param dlist List of dihedrals stored on the GPU
     \param pitch Pitch of 2D dihedral list
+    \param table_offsets Index of the first entry of every particle in the dihedral list
     \param n_dihedrals_list List of numbers of dihedrals stored on the GPU
     \param n_dihedral_type number of dihedral types
     \param d_tables Tables of the potential and force
     \param table_width Number of points in each table
     \param table_value indexer helper
     \param block_size Block size at which to run the kernel
-    \param compute_capability Compute capability of the device (200, 300, 350, ...)
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \param stage_tables True if the tables fit in shared memory
 
     \note This is just a kernel driver. See gpu_compute_table_dihedral_forces_kernel for full documentation.
 */
@@ -307,11 +331,14 @@ hipError_t gpu_compute_table_dihedral_forces(Scalar4* d_force,
                                      const group_storage<4> *dlist,
                                      const unsigned int *dihedral_ABCD,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_dihedrals_list,
                                      const Scalar2 *d_tables,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
-                                     const unsigned int block_size)
+                                     const unsigned int block_size,
+                                     const bool hermite,
+                                     const bool stage_tables)
     {
     assert(d_tables);
     assert(table_width > 1);
@@ -335,7 +362,9 @@ hipError_t gpu_compute_table_dihedral_forces(Scalar4* d_force,
 
     Scalar delta_phi = Scalar(2.0*M_PI)/(Scalar)(table_width - 1);
 
-    hipLaunchKernelGGL((gpu_compute_table_dihedral_forces_kernel), dim3(grid), dim3(threads), 0, 0, d_force,
+    unsigned int shared_bytes = stage_tables ? sizeof(Scalar2)*table_value.getNumElements() : 0;
+
+    hipLaunchKernelGGL((gpu_compute_table_dihedral_forces_kernel), dim3(grid), dim3(threads), shared_bytes, 0, d_force,
              d_virial,
              virial_pitch,
              N,
@@ -344,10 +373,14 @@ hipError_t gpu_compute_table_dihedral_forces(Scalar4* d_force,
              dlist,
              dihedral_ABCD,
              pitch,
+             table_offsets,
              n_dihedrals_list,
              d_tables,
              table_value,
-             delta_phi);
+             delta_phi,
+             table_width,
+             hermite,
+             stage_tables);
 
     return hipSuccess;
     }
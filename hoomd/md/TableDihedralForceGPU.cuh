@@ -12,6 +12,7 @@
 #include "hoomd/BondedGroupData.cuh"
 #include "hoomd/Index1D.h"
 #include "hoomd/HOOMDMath.h"
+#include "TableInterpolation.h"
 
 #ifndef __TABLEDIHEDRALFORCECOMPUTEGPU_CUH__
 #define __TABLEDIHEDRALFORCECOMPUTEGPU_CUH__
@@ -26,10 +27,13 @@ hipError_t gpu_compute_table_dihedral_forces(Scalar4* d_force,
                                      const group_storage<4> *dlist,
                                      const unsigned int *dihedral_ABCD,
                                      const unsigned int pitch,
+                                     const unsigned int *table_offsets,
                                      const unsigned int *n_dihedrals_list,
                                      const Scalar2 *d_tables,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
-                                     const unsigned int block_size);
+                                     const unsigned int block_size,
+                                     const bool hermite,
+                                     const bool stage_tables);
 
 #endif
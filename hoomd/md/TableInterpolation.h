@@ -0,0 +1,58 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __TABLE_INTERPOLATION_H__
+#define __TABLE_INTERPOLATION_H__
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file TableInterpolation.h
+    \brief Defines the interpolation of the tabulated bonded potentials
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Interpolate a tabulated potential and its negative derivative between two grid points
+/*! \param VF0 V and -dV/dx at the lower grid point
+    \param VF1 V and -dV/dx at the upper grid point
+    \param f Fraction of the interval between the grid points, from 0 to 1
+    \param delta Spacing of the grid points
+    \param hermite True for cubic Hermite interpolation, false for linear interpolation
+    \returns V (x) and -dV/dx (y) at the interpolated point
+
+    Linear interpolation treats V and -dV/dx independently, so the table needs a fine grid to keep the force
+    consistent with the energy. Cubic Hermite interpolation fits a cubic to V with the tabulated derivatives as slopes
+    and differentiates it, so the force is continuous, matches the table at the grid points and is exact for cubic
+    potentials. A coarser table then gives the same accuracy, which lets the GPU kernels stage it in shared memory.
+*/
+DEVICE inline Scalar2 table_interpolate(const Scalar2& VF0, const Scalar2& VF1, Scalar f, Scalar delta, bool hermite)
+    {
+    if (!hermite)
+        return make_scalar2(VF0.x + f * (VF1.x - VF0.x), VF0.y + f * (VF1.y - VF0.y));
+
+    Scalar f2 = f*f;
+    Scalar f3 = f2*f;
+
+    // Hermite basis functions, the slopes at the grid points are -F
+    Scalar h00 = Scalar(2.0)*f3 - Scalar(3.0)*f2 + Scalar(1.0);
+    Scalar h10 = f3 - Scalar(2.0)*f2 + f;
+    Scalar h01 = Scalar(3.0)*f2 - Scalar(2.0)*f3;
+    Scalar h11 = f3 - f2;
+    Scalar V = h00*VF0.x + h01*VF1.x - delta*(h10*VF0.y + h11*VF1.y);
+
+    // derivatives of the basis functions with respect to f
+    Scalar dh00 = Scalar(6.0)*(f2 - f);
+    Scalar dh10 = Scalar(3.0)*f2 - Scalar(4.0)*f + Scalar(1.0);
+    Scalar dh11 = Scalar(3.0)*f2 - Scalar(2.0)*f;
+    Scalar F = dh00*(VF1.x - VF0.x)/delta + dh10*VF0.y + dh11*VF1.y;
+
+    return make_scalar2(V, F);
+    }
+
+#endif // __TABLE_INTERPOLATION_H__
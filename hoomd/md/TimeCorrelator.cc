@@ -0,0 +1,261 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file TimeCorrelator.cc
+    \brief Defines the TimeCorrelator class
+*/
+
+#include "TimeCorrelator.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <pybind11/stl.h>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System to sample
+    \param thermo Compute for the thermodynamic quantities
+    \param group Group of particles to sample the charge current and velocities of
+    \param quantities Names of the quantities to sample
+    \param points_per_level Number of samples kept per level of the correlators
+    \param averaging Number of samples averaged into one sample of the next level
+    \param n_levels Number of levels of the correlators
+*/
+TimeCorrelator::TimeCorrelator(std::shared_ptr<SystemDefinition> sysdef,
+                               std::shared_ptr<ComputeThermo> thermo,
+                               std::shared_ptr<ParticleGroup> group,
+                               const std::vector<std::string>& quantities,
+                               unsigned int points_per_level,
+                               unsigned int averaging,
+                               unsigned int n_levels)
+    : Analyzer(sysdef), m_thermo(thermo), m_group(group), m_quantities(quantities)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing TimeCorrelator" << endl;
+
+    if (m_quantities.size() == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.correlator: No quantities to sample" << endl;
+        throw runtime_error("Error initializing TimeCorrelator");
+        }
+
+    if (averaging < 2 || points_per_level < averaging || points_per_level % averaging != 0 || n_levels < 1)
+        {
+        m_exec_conf->msg->error() << "analyze.correlator: points_per_level must be a multiple of averaging, "
+                                  << "averaging must be at least 2, and n_levels at least 1" << endl;
+        throw runtime_error("Error initializing TimeCorrelator");
+        }
+
+    std::vector<std::string> thermo_quantities = m_thermo->getProvidedLogQuantities();
+    const unsigned int n_members = m_group->getNumMembersGlobal();
+
+    for (const auto& quantity : m_quantities)
+        {
+        unsigned int n_channels = 1;
+        double scale = 1.0;
+        if (quantity == "velocity")
+            {
+            #ifdef ENABLE_MPI
+            if (m_pdata->getDomainDecomposition())
+                {
+                m_exec_conf->msg->error() << "analyze.correlator: velocity correlations are not supported with "
+                                          << "domain decomposition" << endl;
+                throw runtime_error("Error initializing TimeCorrelator");
+                }
+            #endif
+
+            if (n_members == 0)
+                {
+                m_exec_conf->msg->error() << "analyze.correlator: The group is empty" << endl;
+                throw runtime_error("Error initializing TimeCorrelator");
+                }
+
+            n_channels = 3*n_members;
+            scale = 1.0/double(n_members);
+            m_velocities.resize(n_channels);
+            }
+        else if (quantity != "charge_current_x" && quantity != "charge_current_y" && quantity != "charge_current_z"
+                 && std::find(thermo_quantities.begin(), thermo_quantities.end(), quantity) == thermo_quantities.end())
+            {
+            m_exec_conf->msg->error() << "analyze.correlator: Unknown quantity " << quantity << endl;
+            throw runtime_error("Error initializing TimeCorrelator");
+            }
+
+        m_correlators.push_back(MultiTauCorrelator(n_channels, points_per_level, averaging, n_levels));
+        m_averages.push_back(BlockAverage());
+        m_scale.push_back(scale);
+        }
+    }
+
+TimeCorrelator::~TimeCorrelator()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying TimeCorrelator" << endl;
+    }
+
+PDataFlags TimeCorrelator::getRequestedPDataFlags()
+    {
+    PDataFlags flags(0);
+    for (const auto& quantity : m_quantities)
+        {
+        if (quantity.compare(0, 8, "pressure") == 0)
+            flags[pdata_flag::pressure_tensor] = 1;
+        if (quantity.compare(0, 10, "rotational") == 0)
+            flags[pdata_flag::rotational_kinetic_energy] = 1;
+        }
+    return flags;
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void TimeCorrelator::analyze(uint64_t timestep)
+    {
+    if (m_prof)
+        m_prof->push("TimeCorrelator");
+
+    bool has_current = false;
+    vec3<double> current;
+
+    for (unsigned int i = 0; i < m_quantities.size(); i++)
+        {
+        const std::string& quantity = m_quantities[i];
+        if (quantity == "velocity")
+            {
+            m_averages[i].add(sampleVelocities());
+            m_correlators[i].add(m_velocities.data());
+            continue;
+            }
+
+        double value;
+        if (quantity.compare(0, 14, "charge_current") == 0)
+            {
+            if (!has_current)
+                {
+                current = computeChargeCurrent();
+                has_current = true;
+                }
+
+            const char component = quantity.back();
+            value = (component == 'x') ? current.x : ((component == 'y') ? current.y : current.z);
+            }
+        else
+            {
+            value = m_thermo->getLogValue(quantity, timestep);
+            }
+
+        m_averages[i].add(value);
+        m_correlators[i].add(&value);
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+vec3<double> TimeCorrelator::computeChargeCurrent()
+    {
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+    double current[3] = {0.0, 0.0, 0.0};
+    for (unsigned int group_idx = 0; group_idx < m_group->getNumMembers(); group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+        double q = h_charge.data[j];
+        current[0] += q*h_vel.data[j].x;
+        current[1] += q*h_vel.data[j].y;
+        current[2] += q*h_vel.data[j].z;
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, current, 3, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return vec3<double>(current[0], current[1], current[2]);
+    }
+
+double TimeCorrelator::sampleVelocities()
+    {
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    const unsigned int n_members = m_group->getNumMembersGlobal();
+    double v_sq = 0.0;
+    for (unsigned int i = 0; i < n_members; i++)
+        {
+        unsigned int j = h_rtag.data[m_group->getMemberTag(i)];
+        m_velocities[3*i] = h_vel.data[j].x;
+        m_velocities[3*i+1] = h_vel.data[j].y;
+        m_velocities[3*i+2] = h_vel.data[j].z;
+        v_sq += m_velocities[3*i]*m_velocities[3*i] + m_velocities[3*i+1]*m_velocities[3*i+1]
+                + m_velocities[3*i+2]*m_velocities[3*i+2];
+        }
+
+    return v_sq/double(n_members);
+    }
+
+pybind11::object TimeCorrelator::getCorrelationPython() const
+    {
+    const unsigned int n_lags = m_correlators[0].getNumLags();
+    std::vector<double> correlation;
+    correlation.reserve(m_quantities.size()*n_lags);
+
+    for (unsigned int i = 0; i < m_quantities.size(); i++)
+        {
+        for (double c : m_correlators[i].getCorrelation())
+            correlation.push_back(c*m_scale[i]);
+        }
+
+    std::vector<size_t> dims(2);
+    dims[0] = m_quantities.size();
+    dims[1] = n_lags;
+    return pybind11::array(dims, correlation.data());
+    }
+
+std::vector<double> TimeCorrelator::getMean() const
+    {
+    std::vector<double> mean;
+    for (const auto& average : m_averages)
+        mean.push_back(average.getMean());
+    return mean;
+    }
+
+std::vector<double> TimeCorrelator::getStandardError() const
+    {
+    std::vector<double> error;
+    for (const auto& average : m_averages)
+        error.push_back(average.getStandardError());
+    return error;
+    }
+
+void TimeCorrelator::reset()
+    {
+    for (auto& correlator : m_correlators)
+        correlator.reset();
+    for (auto& average : m_averages)
+        average.reset();
+    }
+
+void export_TimeCorrelator(py::module& m)
+    {
+    py::class_<TimeCorrelator, Analyzer, std::shared_ptr<TimeCorrelator> >(m, "TimeCorrelator")
+        .def(py::init< std::shared_ptr<SystemDefinition>,
+                       std::shared_ptr<ComputeThermo>,
+                       std::shared_ptr<ParticleGroup>,
+                       const std::vector<std::string>&,
+                       unsigned int,
+                       unsigned int,
+                       unsigned int >())
+        .def_property_readonly("quantities", &TimeCorrelator::getQuantities)
+        .def_property_readonly("lags", &TimeCorrelator::getLags)
+        .def_property_readonly("correlation", &TimeCorrelator::getCorrelationPython)
+        .def_property_readonly("mean", &TimeCorrelator::getMean)
+        .def_property_readonly("standard_error", &TimeCorrelator::getStandardError)
+        .def_property_readonly("num_samples", &TimeCorrelator::getNumSamples)
+        .def("reset", &TimeCorrelator::reset)
+        ;
+    }
@@ -0,0 +1,112 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file TimeCorrelator.h
+    \brief Declares the TimeCorrelator class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ComputeThermo.h"
+#include "MultiTauCorrelator.h"
+#include "hoomd/Analyzer.h"
+#include "hoomd/ParticleGroup.h"
+#include "hoomd/VectorMath.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#ifndef __TIME_CORRELATOR_H__
+#define __TIME_CORRELATOR_H__
+
+//! Computes block averages and time correlation functions during the simulation
+/*! Each call to analyze() samples the selected quantities and adds them to one BlockAverage and one
+    MultiTauCorrelator per quantity. The quantities are:
+
+     - Any quantity logged by ComputeThermo, such as "pressure_xy" for the shear stress autocorrelation.
+     - "charge_current_x", "charge_current_y", "charge_current_z": Components of the charge current, the sum of
+       q v over the group.
+     - "velocity": The per-particle velocities of the group. The correlation is the velocity autocorrelation
+       averaged over the particles, and the block average is the mean of v.v.
+
+    The lags are counted in calls to analyze(). Sample with a periodic trigger to convert them to time steps.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT TimeCorrelator : public Analyzer
+    {
+    public:
+        //! Construct the analyzer
+        TimeCorrelator(std::shared_ptr<SystemDefinition> sysdef,
+                       std::shared_ptr<ComputeThermo> thermo,
+                       std::shared_ptr<ParticleGroup> group,
+                       const std::vector<std::string>& quantities,
+                       unsigned int points_per_level,
+                       unsigned int averaging,
+                       unsigned int n_levels);
+
+        //! Destructor
+        virtual ~TimeCorrelator();
+
+        //! Sample the quantities
+        virtual void analyze(uint64_t timestep);
+
+        //! Request the flags needed by the sampled thermodynamic quantities
+        virtual PDataFlags getRequestedPDataFlags();
+
+        //! Get the names of the sampled quantities
+        const std::vector<std::string>& getQuantities() const
+            {
+            return m_quantities;
+            }
+
+        //! Get the lags of the correlation functions, in samples
+        std::vector<double> getLags() const
+            {
+            return m_correlators[0].getLags();
+            }
+
+        //! Get the correlation functions as an array of shape (number of quantities, number of lags)
+        pybind11::object getCorrelationPython() const;
+
+        //! Get the mean of each quantity
+        std::vector<double> getMean() const;
+
+        //! Get the standard error of the mean of each quantity
+        std::vector<double> getStandardError() const;
+
+        //! Get the number of samples
+        uint64_t getNumSamples() const
+            {
+            return m_averages[0].getNumSamples();
+            }
+
+        //! Remove all samples
+        void reset();
+
+    private:
+        std::shared_ptr<ComputeThermo> m_thermo;        //!< Computes the thermodynamic quantities
+        std::shared_ptr<ParticleGroup> m_group;         //!< Group to sample the particle quantities of
+        std::vector<std::string> m_quantities;          //!< Names of the sampled quantities
+        std::vector<MultiTauCorrelator> m_correlators;  //!< Correlator of each quantity
+        std::vector<BlockAverage> m_averages;           //!< Block average of each quantity
+        std::vector<double> m_scale;                    //!< Factor to normalize each correlation with
+        std::vector<double> m_velocities;               //!< Velocities of the group members, in tag order
+
+        //! Sample the charge current of the group
+        vec3<double> computeChargeCurrent();
+
+        //! Sample the velocities of the group members and return the mean of v.v
+        double sampleVelocities();
+    };
+
+//! Exports the TimeCorrelator class to python
+void export_TimeCorrelator(pybind11::module& m);
+
+#endif
@@ -2,6 +2,7 @@
 // This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
 #include "TwoStepBD.h"
+#include "ActiveForceMath.h"
 #include "hoomd/VectorMath.h"
 #include "QuaternionMath.h"
 #include "hoomd/HOOMDMath.h"
@@ -34,6 +35,29 @@ TwoStepBD::TwoStepBD(std::shared_ptr<SystemDefinition> sysdef,
 TwoStepBD::~TwoStepBD()
     {
     m_exec_conf->msg->notice(5) << "Destroying TwoStepBD" << endl;
+
+    if (m_active_force)
+        m_active_force->setFused(false);
+    }
+
+/** @param active Active force acting on the same group as this method, or NULL to stop applying it
+*/
+void TwoStepBD::setActiveForce(std::shared_ptr<ActiveForceCompute> active)
+    {
+    if (active && active->getGroup() != m_group)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian: The active force must act on the same group as the "
+                                  << "integration method" << endl;
+        throw runtime_error("Error setting active force in TwoStepBD");
+        }
+
+    if (m_active_force)
+        m_active_force->setFused(false);
+
+    m_active_force = active;
+
+    if (m_active_force)
+        m_active_force->setFused(true);
     }
 
 /*! @param timestep Current time step
@@ -75,9 +99,28 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
 
     uint16_t seed = m_sysdef->getSeed();
 
+    // active force parameters, when fused into this method
+    const bool active = bool(m_active_force);
+    std::unique_ptr< ArrayHandle<Scalar4> > h_f_act, h_t_act;
+    Scalar3 active_P = make_scalar3(0,0,0);
+    Scalar3 active_r = make_scalar3(0,0,0);
+    Scalar active_rotation_const = Scalar(0.0);
+    if (active)
+        {
+        h_f_act.reset(new ArrayHandle<Scalar4>(m_active_force->getActiveForceVectors(), access_location::host,
+                                               access_mode::read));
+        h_t_act.reset(new ArrayHandle<Scalar4>(m_active_force->getActiveTorqueVectors(), access_location::host,
+                                               access_mode::read));
+        active_P = m_active_force->getConstraintPosition();
+        active_r = m_active_force->getConstraintRadii();
+        active_rotation_const = slow::sqrt(Scalar(2.0) * m_active_force->getRdiff() * m_deltaT);
+        }
+    EvaluatorConstraintEllipsoid active_ellipsoid(active_P, active_r.x, active_r.y, active_r.z);
+
     // perform the first half step
     // r(t+deltaT) = r(t) + (Fc(t) + Fr)*deltaT/gamma
     // v(t+deltaT) = random distribution consistent with T
+    Scalar max_dsq(0.0);
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
         unsigned int j = m_group->getMemberIndex(group_idx);
@@ -89,8 +132,8 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
 
         // compute the random force
         UniformDistribution<Scalar> uniform(Scalar(-1), Scalar(1));
-        Scalar rx = uniform(rng);
-        Scalar ry = uniform(rng);
+        Scalar rx, ry;
+        uniform(rx, ry, rng);
         Scalar rz = uniform(rng);
 
         Scalar gamma;
@@ -114,10 +157,24 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
         if (D < 3)
             Fr_z = Scalar(0.0);
 
+        // active force and torque from the orientation at this step
+        vec3<Scalar> f_active(0,0,0), t_active(0,0,0);
+        if (active)
+            {
+            unsigned int type = __scalar_as_int(h_pos.data[j].w);
+            active_force_and_torque(quat<Scalar>(h_orientation.data[j]), h_f_act->data[type], h_t_act->data[type],
+                                    f_active, t_active);
+            }
+
         // update position
-        h_pos.data[j].x += (h_net_force.data[j].x + Fr_x) * m_deltaT / gamma;
-        h_pos.data[j].y += (h_net_force.data[j].y + Fr_y) * m_deltaT / gamma;
-        h_pos.data[j].z += (h_net_force.data[j].z + Fr_z) * m_deltaT / gamma;
+        Scalar dx = (h_net_force.data[j].x + f_active.x + Fr_x) * m_deltaT / gamma;
+        Scalar dy = (h_net_force.data[j].y + f_active.y + Fr_y) * m_deltaT / gamma;
+        Scalar dz = (h_net_force.data[j].z + f_active.z + Fr_z) * m_deltaT / gamma;
+        h_pos.data[j].x += dx;
+        h_pos.data[j].y += dy;
+        h_pos.data[j].z += dz;
+        Scalar dsq = dx*dx + dy*dy + dz*dz;
+        max_dsq = (dsq > max_dsq) ? dsq : max_dsq;
 
         // particles may have been moved slightly outside the box by the above steps, wrap them back into place
         box.wrap(h_pos.data[j], h_image.data[j]);
@@ -126,8 +183,7 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
         Scalar mass =  h_vel.data[j].w;
         Scalar sigma = fast::sqrt(currentTemp/mass);
         NormalDistribution<Scalar> normal(sigma);
-        h_vel.data[j].x = normal(rng);
-        h_vel.data[j].y = normal(rng);
+        normal(h_vel.data[j].x, h_vel.data[j].y, rng);
         if (D > 2)
             h_vel.data[j].z = normal(rng);
         else
@@ -143,6 +199,7 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
                 vec3<Scalar> p_vec;
                 quat<Scalar> q(h_orientation.data[j]);
                 vec3<Scalar> t(h_torque.data[j]);
+                t += t_active;
                 vec3<Scalar> I(h_inertia.data[j]);
 
                 bool x_zero, y_zero, z_zero;
@@ -156,10 +213,17 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
 
                 // original Gaussian random torque
                 // Gaussian random distribution is preferred in terms of preserving the exact math
+                // draw the unit normals for the torque and the new angular momentum below in pairs
+                NormalDistribution<Scalar> unit_normal;
+                Scalar n[6];
+                unit_normal(n[0], n[1], rng);
+                unit_normal(n[2], n[3], rng);
+                unit_normal(n[4], n[5], rng);
+
                 vec3<Scalar> bf_torque;
-                bf_torque.x = NormalDistribution<Scalar>(sigma_r.x)(rng);
-                bf_torque.y = NormalDistribution<Scalar>(sigma_r.y)(rng);
-                bf_torque.z = NormalDistribution<Scalar>(sigma_r.z)(rng);
+                bf_torque.x = sigma_r.x*n[0];
+                bf_torque.y = sigma_r.y*n[1];
+                bf_torque.z = sigma_r.z*n[2];
 
                 if (x_zero) bf_torque.x = 0;
                 if (y_zero) bf_torque.y = 0;
@@ -184,9 +248,9 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
                 h_orientation.data[j] = quat_to_scalar4(q);
 
                 // draw a new random ang_mom for particle j in body frame
-                p_vec.x = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.x))(rng);
-                p_vec.y = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.y))(rng);
-                p_vec.z = NormalDistribution<Scalar>(fast::sqrt(currentTemp * I.z))(rng);
+                p_vec.x = fast::sqrt(currentTemp * I.x)*n[3];
+                p_vec.y = fast::sqrt(currentTemp * I.y)*n[4];
+                p_vec.z = fast::sqrt(currentTemp * I.z)*n[5];
                 if (x_zero) p_vec.x = 0;
                 if (y_zero) p_vec.y = 0;
                 if (z_zero) p_vec.z = 0;
@@ -199,7 +263,28 @@ void TwoStepBD::integrateStepOne(uint64_t timestep)
                 h_angmom.data[j] = quat_to_scalar4(p);
                 }
             }
+
+        // constrain and diffuse the orientation as ActiveForceCompute does at the next step
+        if (active)
+            {
+            unsigned int type = __scalar_as_int(h_pos.data[j].w);
+            Scalar3 pos = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            quat<Scalar> q(h_orientation.data[j]);
+
+            if (active_r.x != 0)
+                active_force_constrain(q, pos, h_f_act->data[type], active_ellipsoid);
+
+            if (active_rotation_const != 0)
+                {
+                RandomGenerator rng_active(hoomd::Seed(RNGIdentifier::ActiveForceCompute, timestep+1, seed),
+                                           hoomd::Counter(ptag));
+                active_force_rotational_diffusion(q, pos, h_f_act->data[type], active_ellipsoid, active_r.x != 0,
+                                                  D == 2, active_rotation_const, rng_active);
+                }
+            h_orientation.data[j] = quat_to_scalar4(q);
+            }
         }
+    m_max_displacement = sqrt(max_dsq);
 
     // done profiling
     if (m_prof)
@@ -220,5 +305,7 @@ void export_TwoStepBD(py::module& m)
         .def(py::init< std::shared_ptr<SystemDefinition>,
                             std::shared_ptr<ParticleGroup>,
                             std::shared_ptr<Variant>>())
+        .def("setActiveForce", &TwoStepBD::setActiveForce)
+        .def("getActiveForce", &TwoStepBD::getActiveForce)
         ;
     }
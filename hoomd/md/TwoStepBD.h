@@ -2,6 +2,7 @@
 // This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
 #include "TwoStepLangevinBase.h"
+#include "ActiveForceCompute.h"
 
 #pragma once
 
@@ -32,9 +33,26 @@ class PYBIND11_EXPORT TwoStepBD : public TwoStepLangevinBase
         /// Performs the second step of the integration
         virtual void integrateStepTwo(uint64_t timestep);
 
+        /** Apply an active force in the integration step
+
+            @param active Active force acting on the same group as this method, or NULL to stop
+
+            The method evaluates the active force and torque from the current orientation in step one and then applies
+            the constraint and rotational diffusion that ActiveForceCompute would apply at the next time step. The
+            active force compute stays in the force list but no longer writes its force arrays.
+        */
+        void setActiveForce(std::shared_ptr<ActiveForceCompute> active);
+
+        /// Get the active force applied in the integration step
+        std::shared_ptr<ActiveForceCompute> getActiveForce()
+            {
+            return m_active_force;
+            }
+
     protected:
         bool m_noiseless_t;
         bool m_noiseless_r;
+        std::shared_ptr<ActiveForceCompute> m_active_force;  //!< Active force applied in the integration step
     };
 
 //! Exports the TwoStepLangevin class to python
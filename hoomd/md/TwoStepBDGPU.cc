@@ -80,6 +80,28 @@ void TwoStepBDGPU::integrateStepOne(uint64_t timestep)
 
     bool aniso = m_aniso;
 
+    // active force parameters, when fused into this method
+    brownian_active_args active_args;
+    active_args.d_f_act = NULL;
+    active_args.d_t_act = NULL;
+    active_args.P = make_scalar3(0,0,0);
+    active_args.r = make_scalar3(0,0,0);
+    active_args.rotation_const = Scalar(0.0);
+
+    std::unique_ptr< ArrayHandle<Scalar4> > d_f_act, d_t_act;
+    if (m_active_force)
+        {
+        d_f_act.reset(new ArrayHandle<Scalar4>(m_active_force->getActiveForceVectors(), access_location::device,
+                                               access_mode::read));
+        d_t_act.reset(new ArrayHandle<Scalar4>(m_active_force->getActiveTorqueVectors(), access_location::device,
+                                               access_mode::read));
+        active_args.d_f_act = d_f_act->data;
+        active_args.d_t_act = d_t_act->data;
+        active_args.P = m_active_force->getConstraintPosition();
+        active_args.r = m_active_force->getConstraintRadii();
+        active_args.rotation_const = slow::sqrt(Scalar(2.0) * m_active_force->getRdiff() * m_deltaT);
+        }
+
     #ifdef __HIP_PLATFORM_NVCC__
     if (m_exec_conf->allConcurrentManagedAccess())
         {
@@ -113,6 +135,7 @@ void TwoStepBDGPU::integrateStepOne(uint64_t timestep)
                           d_inertia.data,
                           d_angmom.data,
                           args,
+                          active_args,
                           aniso,
                           m_deltaT,
                           D,
@@ -6,6 +6,7 @@
 // Maintainer: joaander
 
 #include "TwoStepBDGPU.cuh"
+#include "ActiveForceMath.h"
 #include "hoomd/VectorMath.h"
 #include "hoomd/HOOMDMath.h"
 
@@ -46,10 +47,14 @@ using namespace hoomd;
     \param D Dimensionality of the system
     \param d_noiseless_t If set true, there will be no translational noise (random force)
     \param d_noiseless_r If set true, there will be no rotational noise (random torque)
+    \param active Active force parameters, applied when active.d_f_act is not NULL
     \param offset Offset of this GPU into group indices
 
     This kernel is implemented in a very similar manner to gpu_nve_step_one_kernel(), see it for design details.
 
+    With an active force, the kernel adds the active force and torque evaluated from the current orientation and then
+    constrains and diffuses the orientation as ActiveForceCompute does at the next time step.
+
     This kernel must be launched with enough dynamic shared memory per block to read in d_gamma
 */
 extern "C" __global__
@@ -79,6 +84,7 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                                   unsigned int D,
                                   const bool d_noiseless_t,
                                   const bool d_noiseless_r,
+                                  const brownian_active_args active,
                                   const unsigned int offset)
     {
     HIP_DYNAMIC_SHARED( char, s_data)
@@ -127,8 +133,8 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         RandomGenerator rng(hoomd::Seed(RNGIdentifier::TwoStepBD, timestep, seed),
                             hoomd::Counter(ptag));
         UniformDistribution<Scalar> uniform(Scalar(-1), Scalar(1));
-        Scalar rx = uniform(rng);
-        Scalar ry = uniform(rng);
+        Scalar rx, ry;
+        uniform(rx, ry, rng);
         Scalar rz =  uniform(rng);
 
         // calculate the magnitude of the random force
@@ -157,10 +163,19 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         if (D < 3)
             Fr_z = Scalar(0.0);
 
+        // active force and torque from the orientation at this step
+        vec3<Scalar> f_active(0,0,0), t_active(0,0,0);
+        if (active.d_f_act)
+            {
+            unsigned int typ = __scalar_as_int(postype.w);
+            active_force_and_torque(quat<Scalar>(d_orientation[idx]), __ldg(active.d_f_act + typ),
+                                    __ldg(active.d_t_act + typ), f_active, t_active);
+            }
+
         // update position
-        postype.x += (net_force.x + Fr_x) * deltaT / gamma;
-        postype.y += (net_force.y + Fr_y) * deltaT / gamma;
-        postype.z += (net_force.z + Fr_z) * deltaT / gamma;
+        postype.x += (net_force.x + f_active.x + Fr_x) * deltaT / gamma;
+        postype.y += (net_force.y + f_active.y + Fr_y) * deltaT / gamma;
+        postype.z += (net_force.z + f_active.z + Fr_z) * deltaT / gamma;
 
         // particles may have been moved slightly outside the box by the above steps, wrap them back into place
         box.wrap(postype, image);
@@ -169,8 +184,7 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         Scalar mass = vel.w;
         Scalar sigma = fast::sqrt(T/mass);
         NormalDistribution<Scalar> normal(sigma);
-        vel.x = normal(rng);
-        vel.y = normal(rng);
+        normal(vel.x, vel.y, rng);
         if (D > 2)
             vel.z = normal(rng);
         else
@@ -193,6 +207,7 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 vec3<Scalar> p_vec;
                 quat<Scalar> q(d_orientation[idx]);
                 vec3<Scalar> t(d_torque[idx]);
+                t += t_active;
                 vec3<Scalar> I(d_inertia[idx]);
 
                 // check if the shape is degenerate
@@ -207,10 +222,17 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
 
                 // original Gaussian random torque
                 // Gaussian random distribution is preferred in terms of preserving the exact math
+                // draw the unit normals for the torque and the new angular momentum below in pairs
+                NormalDistribution<Scalar> unit_normal;
+                Scalar n[6];
+                unit_normal(n[0], n[1], rng);
+                unit_normal(n[2], n[3], rng);
+                unit_normal(n[4], n[5], rng);
+
                 vec3<Scalar> bf_torque;
-                bf_torque.x = NormalDistribution<Scalar>(sigma_r.x)(rng);
-                bf_torque.y = NormalDistribution<Scalar>(sigma_r.y)(rng);
-                bf_torque.z = NormalDistribution<Scalar>(sigma_r.z)(rng);
+                bf_torque.x = sigma_r.x*n[0];
+                bf_torque.y = sigma_r.y*n[1];
+                bf_torque.z = sigma_r.z*n[2];
 
                 if (x_zero) bf_torque.x = 0;
                 if (y_zero) bf_torque.y = 0;
@@ -233,9 +255,9 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 d_orientation[idx] = quat_to_scalar4(q);
 
                 // draw a new random ang_mom for particle j in body frame
-                p_vec.x = NormalDistribution<Scalar>(fast::sqrt(T * I.x))(rng);
-                p_vec.y = NormalDistribution<Scalar>(fast::sqrt(T * I.y))(rng);
-                p_vec.z = NormalDistribution<Scalar>(fast::sqrt(T * I.z))(rng);
+                p_vec.x = fast::sqrt(T * I.x)*n[3];
+                p_vec.y = fast::sqrt(T * I.y)*n[4];
+                p_vec.z = fast::sqrt(T * I.z)*n[5];
                 if (x_zero) p_vec.x = 0;
                 if (y_zero) p_vec.y = 0;
                 if (z_zero) p_vec.z = 0;
@@ -248,6 +270,28 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 d_angmom[idx] = quat_to_scalar4(p);
                 }
             }
+
+        // constrain and diffuse the orientation as ActiveForceCompute does at the next step
+        if (active.d_f_act)
+            {
+            unsigned int typ = __scalar_as_int(postype.w);
+            Scalar4 fact = __ldg(active.d_f_act + typ);
+            Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+            quat<Scalar> q(d_orientation[idx]);
+            EvaluatorConstraintEllipsoid ellipsoid(active.P, active.r.x, active.r.y, active.r.z);
+
+            if (active.r.x != 0)
+                active_force_constrain(q, pos, fact, ellipsoid);
+
+            if (active.rotation_const != 0)
+                {
+                RandomGenerator rng_active(hoomd::Seed(RNGIdentifier::ActiveForceCompute, timestep+1, seed),
+                                           hoomd::Counter(ptag));
+                active_force_rotational_diffusion(q, pos, fact, ellipsoid, active.r.x != 0, D == 2,
+                                                  active.rotation_const, rng_active);
+                }
+            d_orientation[idx] = quat_to_scalar4(q);
+            }
         }
     }
 
@@ -266,6 +310,7 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
     \param d_inertia Device array of moment of inertial of each particle
     \param d_angmom Device array of transformed angular momentum quaternion of each particle (see online documentation)
     \param langevin_args Collected arguments for gpu_brownian_step_one_kernel()
+    \param active_args Active force parameters for gpu_brownian_step_one_kernel()
     \param aniso If set true, the system would go through rigid body updates for its orientation
     \param deltaT Amount of real time to step forward in one time step
     \param D Dimensionality of the system
@@ -289,6 +334,7 @@ hipError_t gpu_brownian_step_one(Scalar4 *d_pos,
                                   const Scalar3 *d_inertia,
                                   Scalar4 *d_angmom,
                                   const langevin_step_two_args& langevin_args,
+                                  const brownian_active_args& active_args,
                                   const bool aniso,
                                   const Scalar deltaT,
                                   const unsigned int D,
@@ -337,6 +383,7 @@ hipError_t gpu_brownian_step_one(Scalar4 *d_pos,
                                      D,
                                      d_noiseless_t,
                                      d_noiseless_r,
+                                     active_args,
                                      range.first);
         }
 
@@ -16,6 +16,16 @@
 #ifndef __TWO_STEP_BD_GPU_CUH__
 #define __TWO_STEP_BD_GPU_CUH__
 
+//! Parameters of an active force applied in the Brownian update
+struct brownian_active_args
+    {
+    const Scalar4 *d_f_act;   //!< Per-type active force unit vectors and magnitudes, NULL without an active force
+    const Scalar4 *d_t_act;   //!< Per-type active torque unit vectors and magnitudes
+    Scalar3 P;                //!< Position of the constraint ellipsoid
+    Scalar3 r;                //!< Radii of the constraint ellipsoid, r.x == 0 without a constraint
+    Scalar rotation_const;    //!< Standard deviation of the rotational diffusion angle per step
+    };
+
 //! Kernel driver for the first part of the Brownian update called by TwoStepBDGPU
 hipError_t gpu_brownian_step_one(Scalar4 *d_pos,
                                   Scalar4 *d_vel,
@@ -32,6 +42,7 @@ hipError_t gpu_brownian_step_one(Scalar4 *d_pos,
                                   const Scalar3 *d_inertia,
                                   Scalar4 *d_angmom,
                                   const langevin_step_two_args& langevin_args,
+                                  const brownian_active_args& active_args,
                                   const bool aniso,
                                   const Scalar deltaT,
                                   const unsigned int D,
@@ -80,6 +80,7 @@ void TwoStepLangevin::integrateStepOne(uint64_t timestep)
     // perform the first half step of velocity verlet
     // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
     // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
+    Scalar max_dsq(0.0);
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
         unsigned int j = m_group->getMemberIndex(group_idx);
@@ -91,6 +92,8 @@ void TwoStepLangevin::integrateStepOne(uint64_t timestep)
         h_pos.data[j].x += dx;
         h_pos.data[j].y += dy;
         h_pos.data[j].z += dz;
+        Scalar dsq = dx*dx + dy*dy + dz*dz;
+        max_dsq = (dsq > max_dsq) ? dsq : max_dsq;
         // particles may have been moved slightly outside the box by the above steps, wrap them back into place
         box.wrap(h_pos.data[j], h_image.data[j]);
 
@@ -98,6 +101,7 @@ void TwoStepLangevin::integrateStepOne(uint64_t timestep)
         h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
         h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
         }
+    m_max_displacement = sqrt(max_dsq);
 
     if (m_aniso)
         {
@@ -210,19 +214,21 @@ void TwoStepLangevin::integrateStepOne(uint64_t timestep)
         m_prof->pop();
     }
 
-/*! \param timestep Current time step
-    \post particle velocities are moved forward to timestep+1
+/*! \tparam aniso True if the rotational degrees of freedom are integrated
+    \tparam two_d True in 2D simulations
+    \tparam tally True if the energy transferred to the reservoir is computed
+    \param timestep Current time step
+    \returns The rate at which the Langevin forces transfer energy to the particles (zero unless \a tally)
+
+    The flags are template parameters so the common combinations compile to loops without branches on them.
 */
-void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
+template<bool aniso, bool two_d, bool tally>
+Scalar TwoStepLangevin::applyLangevinForces(uint64_t timestep)
     {
     unsigned int group_size = m_group->getNumMembers();
 
     const GlobalArray< Scalar4 >& net_force = m_pdata->getNetForce();
 
-    // profile this step
-    if (m_prof)
-        m_prof->push("Langevin step 2");
-
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
@@ -239,7 +245,6 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
 
     // grab some initial variables
     const Scalar currentTemp = (*m_T)(timestep);
-    const unsigned int D = m_sysdef->getNDimensions();
 
     // energy transferred over this time step
     Scalar bd_energy_transfer = 0;
@@ -258,10 +263,10 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
                             hoomd::Counter(ptag));
 
         // first, calculate the BD forces
-        // Generate three random numbers
+        // Generate three random numbers, the first two from one draw
         hoomd::UniformDistribution<Scalar> uniform(Scalar(-1), Scalar(1));
-        Scalar rx = uniform(rng);
-        Scalar ry = uniform(rng);
+        Scalar rx, ry;
+        uniform(rx, ry, rng);
         Scalar rz = uniform(rng);
 
         Scalar gamma;
@@ -281,7 +286,7 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
         Scalar bd_fy = ry*coeff - gamma*h_vel.data[j].y;
         Scalar bd_fz = rz*coeff - gamma*h_vel.data[j].z;
 
-        if (D < 3)
+        if (two_d)
             bd_fz = Scalar(0.0);
 
         // then, calculate acceleration from the net force
@@ -296,10 +301,10 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
         h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
 
         // tally the energy transfer from the bd thermal reservoir to the particles
-        if (m_tally) bd_energy_transfer += bd_fx * h_vel.data[j].x + bd_fy * h_vel.data[j].y + bd_fz * h_vel.data[j].z;
+        if (tally) bd_energy_transfer += bd_fx * h_vel.data[j].x + bd_fy * h_vel.data[j].y + bd_fz * h_vel.data[j].z;
 
         // rotational updates
-        if (m_aniso)
+        if (aniso)
             {
             unsigned int type_r = __scalar_as_int(h_pos.data[j].w);
             Scalar3 gamma_r = h_gamma_r.data[type_r];
@@ -324,9 +329,12 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
                                                fast::sqrt(Scalar(2.0)*gamma_r.z*currentTemp/m_deltaT));
                 if (m_noiseless_r) sigma_r = make_scalar3(0.0,0.0,0.0);
 
-                Scalar rand_x = hoomd::NormalDistribution<Scalar>(sigma_r.x)(rng);
-                Scalar rand_y = hoomd::NormalDistribution<Scalar>(sigma_r.y)(rng);
-                Scalar rand_z = hoomd::NormalDistribution<Scalar>(sigma_r.z)(rng);
+                hoomd::NormalDistribution<Scalar> normal;
+                Scalar rand_x, rand_y;
+                normal(rand_x, rand_y, rng);
+                rand_x *= sigma_r.x;
+                rand_y *= sigma_r.y;
+                Scalar rand_z = sigma_r.z*normal(rng);
 
                 // check for degenerate moment of inertia
                 bool x_zero, y_zero, z_zero;
@@ -347,15 +355,15 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
                 h_net_torque.data[j].y += bf_torque.y;
                 h_net_torque.data[j].z += bf_torque.z;
 
-                if (D < 3) h_net_torque.data[j].x = 0;
-                if (D < 3) h_net_torque.data[j].y = 0;
+                if (two_d) h_net_torque.data[j].x = 0;
+                if (two_d) h_net_torque.data[j].y = 0;
                 }
             }
         }
 
 
     // then, update the angular velocity
-    if (m_aniso)
+    if (aniso)
         {
         // angular degrees of freedom
         for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
@@ -386,6 +394,55 @@ void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
         }
 
 
+    return bd_energy_transfer;
+    }
+
+/*! \param params Set to plain velocity verlet
+    \returns true unless the rotational degrees of freedom are integrated
+
+    The first step of the Langevin method is the first step of velocity verlet, the random and drag forces are only
+    applied in the second step.
+*/
+bool TwoStepLangevin::getVelocityVerletStepOne(VelocityVerletStepOne& params) const
+    {
+    if (m_aniso)
+        return false;
+
+    params = VelocityVerletStepOne();
+    return true;
+    }
+
+/*! \param timestep Current time step
+    \post particle velocities are moved forward to timestep+1
+*/
+void TwoStepLangevin::integrateStepTwo(uint64_t timestep)
+    {
+    // profile this step
+    if (m_prof)
+        m_prof->push("Langevin step 2");
+
+    // select the variant of the loop for the flags of this step
+    const bool two_d = m_sysdef->getNDimensions() < 3;
+    Scalar bd_energy_transfer;
+    if (m_aniso)
+        {
+        if (two_d)
+            bd_energy_transfer = m_tally ? applyLangevinForces<true, true, true>(timestep)
+                                         : applyLangevinForces<true, true, false>(timestep);
+        else
+            bd_energy_transfer = m_tally ? applyLangevinForces<true, false, true>(timestep)
+                                         : applyLangevinForces<true, false, false>(timestep);
+        }
+    else
+        {
+        if (two_d)
+            bd_energy_transfer = m_tally ? applyLangevinForces<false, true, true>(timestep)
+                                         : applyLangevinForces<false, true, false>(timestep);
+        else
+            bd_energy_transfer = m_tally ? applyLangevinForces<false, false, true>(timestep)
+                                         : applyLangevinForces<false, false, false>(timestep);
+        }
+
     // update energy reservoir
     if (m_tally)
         {
@@ -62,6 +62,9 @@ class PYBIND11_EXPORT TwoStepLangevin : public TwoStepLangevinBase
         /// Performs the second step of the integration
         virtual void integrateStepTwo(uint64_t timestep);
 
+        /// Get the parameters of the first step when it is a plain velocity verlet step
+        virtual bool getVelocityVerletStepOne(VelocityVerletStepOne& params) const;
+
     protected:
         /// The energy of the reservoir the system is coupled to.
         Scalar m_reservoir_energy;
@@ -80,6 +83,11 @@ class PYBIND11_EXPORT TwoStepLangevin : public TwoStepLangevinBase
 
         /// If set true, there will be no rotational noise (random torque)
         bool m_noiseless_r;
+
+    private:
+        /// Apply the Langevin forces and advance the velocities by the second half step
+        template<bool aniso, bool two_d, bool tally>
+        Scalar applyLangevinForces(uint64_t timestep);
     };
 
 //! Exports the TwoStepLangevin class to python
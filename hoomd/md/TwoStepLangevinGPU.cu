@@ -121,8 +121,8 @@ __global__ void gpu_langevin_step_two_kernel(const Scalar4 *d_pos,
                             hoomd::Counter(ptag));
         UniformDistribution<Scalar> uniform(-1, 1);
 
-        Scalar randomx = uniform(rng);
-        Scalar randomy = uniform(rng);
+        Scalar randomx, randomy;
+        uniform(randomx, randomy, rng);
         Scalar randomz = uniform(rng);
 
         bd_force.x = randomx*coeff - gamma*vel.x;
@@ -310,9 +310,12 @@ __global__ void gpu_langevin_angular_step_two_kernel(
 
             RandomGenerator rng(hoomd::Seed(RNGIdentifier::TwoStepLangevinAngular, timestep, seed),
                                 hoomd::Counter(ptag));
-            Scalar rand_x = NormalDistribution<Scalar>(sigma_r.x)(rng);
-            Scalar rand_y = NormalDistribution<Scalar>(sigma_r.y)(rng);
-            Scalar rand_z = NormalDistribution<Scalar>(sigma_r.z)(rng);
+            NormalDistribution<Scalar> normal;
+            Scalar rand_x, rand_y;
+            normal(rand_x, rand_y, rng);
+            rand_x *= sigma_r.x;
+            rand_y *= sigma_r.y;
+            Scalar rand_z = sigma_r.z*normal(rng);
 
             // check for zero moment of inertia
             bool x_zero, y_zero, z_zero;
@@ -728,6 +728,15 @@ void TwoStepNPTMTK::advanceBarostat(uint64_t timestep)
     // compute pressure for the next half time step
     PressureTensor P = m_thermo_full_step->getPressureTensor();
 
+    advanceBarostat(timestep, P, m_thermo_full_step->getTranslationalKineticEnergy());
+    }
+
+/*! \param timestep Current time step
+    \param P Pressure tensor at the full time step, or NaN if it has not been computed
+    \param translational_kinetic_energy Translational kinetic energy of the group at the full time step
+*/
+void TwoStepNPTMTK::advanceBarostat(uint64_t timestep, PressureTensor P, Scalar translational_kinetic_energy)
+    {
     if ( std::isnan(P.xx) || std::isnan(P.xy) || std::isnan(P.xz) || std::isnan(P.yy) || std::isnan(P.yz) || std::isnan(P.zz) )
         {
         P.xx = (*m_S[0])(timestep);
@@ -742,7 +751,7 @@ void TwoStepNPTMTK::advanceBarostat(uint64_t timestep)
     // Martyna-Tobias-Klein correction
     unsigned int d = m_sysdef->getNDimensions();
     Scalar W = (Scalar)(m_ndof+d)/(Scalar)d*(*m_T)(timestep)*m_tauS*m_tauS;
-    Scalar mtk_term = Scalar(2.0)*m_thermo_full_step->getTranslationalKineticEnergy();
+    Scalar mtk_term = Scalar(2.0)*translational_kinetic_energy;
     mtk_term *= Scalar(1.0/2.0)*m_deltaT/(Scalar)m_ndof/W;
 
     couplingMode couple = getRelevantCouplings();
@@ -259,6 +259,9 @@ class PYBIND11_EXPORT TwoStepNPTMTK : public IntegrationMethodTwoStep
         //! Helper function to advance the barostat parameters
         void advanceBarostat(uint64_t timestep);
 
+        //! Advance the barostat parameters with a given pressure tensor and kinetic energy
+        void advanceBarostat(uint64_t timestep, PressureTensor P, Scalar translational_kinetic_energy);
+
         //! advance the thermostat
         /*!\param timestep The time step
          * \param broadcast True if we should broadcast the integrator variables via MPI
@@ -44,7 +44,9 @@ TwoStepNPTMTKGPU::TwoStepNPTMTKGPU(std::shared_ptr<SystemDefinition> sysdef,
                        const std::vector<bool>& flags,
                        const bool nph)
 
-    : TwoStepNPTMTK(sysdef, group, thermo_group, thermo_group_t, tau, tauS, T, S, couple, flags,nph)
+    : TwoStepNPTMTK(sysdef, group, thermo_group, thermo_group_t, tau, tauS, T, S, couple, flags,nph),
+      m_thermostat_on_device(false), m_pressure_valid(false), m_pressure_timestep(0),
+      m_translational_kinetic_energy(0)
     {
     if (!m_exec_conf->isCUDAEnabled())
         {
@@ -61,6 +63,10 @@ TwoStepNPTMTKGPU::TwoStepNPTMTKGPU(std::shared_ptr<SystemDefinition> sysdef,
     m_tuner_rescale.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "npt_mtk_rescale", this->m_exec_conf));
     m_tuner_angular_one.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "npt_mtk_angular_one", this->m_exec_conf));
     m_tuner_angular_two.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "npt_mtk_angular_two", this->m_exec_conf));
+
+    GlobalArray<npt_mtk_state> state(1, m_exec_conf);
+    m_state.swap(state);
+    TAG_ALLOCATION(m_state);
     }
 
 TwoStepNPTMTKGPU::~TwoStepNPTMTKGPU()
@@ -88,7 +94,16 @@ void TwoStepNPTMTKGPU::integrateStepOne(uint64_t timestep)
     m_ndof = m_group->getTranslationalDOF();
 
     // advance barostat (nuxx, nuyy, nuzz) half a time step
-    advanceBarostat(timestep);
+    if (useDeviceState() && m_pressure_valid && m_pressure_timestep == timestep)
+        {
+        // the pressure at this time step was read back with the barostat update of the last second step
+        advanceBarostat(timestep, m_pressure, m_translational_kinetic_energy);
+        }
+    else
+        {
+        advanceBarostat(timestep);
+        }
+    m_pressure_valid = false;
 
     IntegratorVariables v = getIntegratorVariables();
     Scalar nuxx = v.variable[2];  // Barostat tensor, xx component
@@ -257,7 +272,43 @@ void TwoStepNPTMTKGPU::integrateStepOne(uint64_t timestep)
         m_exec_conf->endMultiGPU();
         }
 
-    if (! m_nph)
+    if (useDeviceState())
+        {
+        // propagate thermostat variables forward on the device, they are copied back after the second step
+        npt_mtk_thermostat_args args;
+        for (unsigned int i = 0; i < 10; ++i)
+            args.variable[i] = v.variable[i];
+        args.T = (*m_T)(timestep);
+        args.tau = m_tau;
+        args.ndof = m_ndof;
+        args.ndof_trans = m_group->getTranslationalDOF();
+        args.ndof_rot = m_group->getRotationalDOF();
+        args.deltaT = m_deltaT;
+        args.nph = m_nph;
+        args.aniso = m_aniso;
+
+        unsigned int parts = 0;
+        if (! m_nph)
+            {
+            m_thermo_half_step->compute(timestep);
+            parts = thermo_part::translational_kinetic_energy;
+            if (m_aniso)
+                parts |= thermo_part::rotational_kinetic_energy;
+            }
+        const GlobalArray<Scalar>& properties = m_thermo_half_step->getProperties(parts);
+        args.rot_valid = m_thermo_half_step->getComputedFlags()[pdata_flag::rotational_kinetic_energy];
+
+        ArrayHandle<Scalar> d_properties(properties, access_location::device, access_mode::read);
+        ArrayHandle<npt_mtk_state> d_state(m_state, access_location::device, access_mode::readwrite);
+
+        gpu_npt_mtk_advance_thermostat(d_state.data, d_properties.data, args);
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        m_thermostat_on_device = true;
+        }
+    else if (! m_nph)
         {
         // propagate thermostat variables forward
         advanceThermostat(timestep);
@@ -299,9 +350,14 @@ void TwoStepNPTMTKGPU::integrateStepTwo(uint64_t timestep)
     // Martyna-Tobias-Klein correction
     Scalar mtk = (nuxx+nuyy+nuzz)/(Scalar)m_ndof;
 
+    // the thermostat factors are read on the device if the first step left them there
+    const bool thermostat_on_device = m_thermostat_on_device;
+    m_thermostat_on_device = false;
+
     {
     ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::overwrite);
+    ArrayHandle<npt_mtk_state> d_state(m_state, access_location::device, access_mode::read);
 
     ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::read);
     ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
@@ -322,7 +378,8 @@ void TwoStepNPTMTKGPU::integrateStepTwo(uint64_t timestep)
                      m_mat_exp_v,
                      m_deltaT,
                      exp_thermo_fac,
-                     m_tuner_two->getParam());
+                     m_tuner_two->getParam(),
+                     thermostat_on_device ? &d_state.data->exp_thermo_fac : NULL);
 
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
@@ -339,6 +396,7 @@ void TwoStepNPTMTKGPU::integrateStepTwo(uint64_t timestep)
         ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device, access_mode::read);
         ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
         ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<npt_mtk_state> d_state(m_state, access_location::device, access_mode::read);
 
         // precompute loop invariant quantity
         Scalar xi_rot = v.variable[8];
@@ -355,7 +413,8 @@ void TwoStepNPTMTKGPU::integrateStepTwo(uint64_t timestep)
                                  m_group->getGPUPartition(),
                                  m_deltaT,
                                  exp_thermo_fac_rot,
-                                 m_tuner_angular_two->getParam());
+                                 m_tuner_angular_two->getParam(),
+                                 thermostat_on_device ? &d_state.data->exp_thermo_fac_rot : NULL);
 
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
             CHECK_CUDA_ERROR();
@@ -365,13 +424,74 @@ void TwoStepNPTMTKGPU::integrateStepTwo(uint64_t timestep)
         }
 
     // advance barostat (nuxx, nuyy, nuzz) half a time step
-    advanceBarostat(timestep+1);
+    if (thermostat_on_device)
+        {
+        m_thermo_full_step->compute(timestep+1);
+        const GlobalArray<Scalar>& properties = m_thermo_full_step->getProperties(
+            thermo_part::translational_kinetic_energy | thermo_part::pressure_tensor);
+
+        unsigned int d = m_sysdef->getNDimensions();
+        npt_mtk_barostat_args args;
+        for (unsigned int i = 0; i < 6; ++i)
+            args.S[i] = (*m_S[i])(timestep+1);
+        args.W = (Scalar)(m_ndof+d)/(Scalar)d*(*m_T)(timestep+1)*m_tauS*m_tauS;
+        args.V = m_V;
+        args.ndof = m_ndof;
+        args.deltaT = m_deltaT;
+        args.gamma = m_gamma;
+        args.flags = m_flags;
+        args.couple = getRelevantCouplings();
+        args.pressure_valid = m_thermo_full_step->getComputedFlags()[pdata_flag::pressure_tensor];
+
+            {
+            ArrayHandle<Scalar> d_properties(properties, access_location::device, access_mode::read);
+            ArrayHandle<npt_mtk_state> d_state(m_state, access_location::device, access_mode::readwrite);
+
+            gpu_npt_mtk_advance_barostat(d_state.data, d_properties.data, args);
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+
+        // copy the thermostat and barostat variables back, the only synchronization of the time step
+        ArrayHandle<npt_mtk_state> h_state(m_state, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < 10; ++i)
+            v.variable[i] = h_state.data->variable[i];
+        setIntegratorVariables(v);
+
+        // keep the pressure for the barostat update of the next first step
+        m_pressure.xx = h_state.data->P[0];
+        m_pressure.xy = h_state.data->P[1];
+        m_pressure.xz = h_state.data->P[2];
+        m_pressure.yy = h_state.data->P[3];
+        m_pressure.yz = h_state.data->P[4];
+        m_pressure.zz = h_state.data->P[5];
+        m_translational_kinetic_energy = h_state.data->ke_trans;
+        m_pressure_timestep = timestep+1;
+        m_pressure_valid = true;
+        }
+    else
+        {
+        advanceBarostat(timestep+1);
+        }
 
     // done profiling
     if (m_prof)
         m_prof->pop();
     }
 
+/*! The thermodynamic properties are only reduced over MPI ranks on the host, so the thermostat and barostat are
+    updated on the device only without domain decomposition.
+*/
+bool TwoStepNPTMTKGPU::useDeviceState()
+    {
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        return false;
+    #endif
+
+    return true;
+    }
 
 void export_TwoStepNPTMTKGPU(py::module& m)
     {
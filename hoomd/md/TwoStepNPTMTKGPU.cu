@@ -6,6 +6,7 @@
 // Maintainer: jglaser
 
 #include "TwoStepNPTMTKGPU.cuh"
+#include "ComputeThermoTypes.h"
 #include "hoomd/VectorMath.h"
 
 #include <assert.h>
@@ -266,13 +267,17 @@ __global__ void gpu_npt_mtk_step_two_kernel(Scalar4 *d_vel,
                              Scalar mat_exp_v_yz,
                              Scalar mat_exp_v_zz,
                              Scalar deltaT,
-                             Scalar exp_thermo_fac)
+                             Scalar exp_thermo_fac,
+                             const Scalar *d_exp_thermo_fac)
     {
     // determine which particle this thread works on
     int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
     if (work_idx < nwork)
         {
+        if (d_exp_thermo_fac)
+            exp_thermo_fac = *d_exp_thermo_fac;
+
         const unsigned int group_idx = work_idx + offset;
         unsigned int idx = d_group_members[group_idx];
 
@@ -314,6 +319,9 @@ __global__ void gpu_npt_mtk_step_two_kernel(Scalar4 *d_vel,
     \param d_net_force Net force on each particle
 
     \param deltaT Time to move forward in one whole step
+    \param exp_thermo_fac Thermostat rescaling factor
+    \param block_size Kernel block size
+    \param d_exp_thermo_fac If not NULL, the thermostat rescaling factor is read from this device memory
 
     This is just a kernel driver for gpu_npt_mtk_step_kernel(). See it for more details.
 */
@@ -325,7 +333,8 @@ hipError_t gpu_npt_mtk_step_two(Scalar4 *d_vel,
                              Scalar* mat_exp_v,
                              Scalar deltaT,
                              Scalar exp_thermo_fac,
-                             const unsigned int block_size)
+                             const unsigned int block_size,
+                             const Scalar *d_exp_thermo_fac)
     {
     static unsigned int max_block_size = UINT_MAX;
     if (max_block_size == UINT_MAX)
@@ -362,7 +371,8 @@ hipError_t gpu_npt_mtk_step_two(Scalar4 *d_vel,
                                                          mat_exp_v[4],
                                                          mat_exp_v[5],
                                                          deltaT,
-                                                         exp_thermo_fac);
+                                                         exp_thermo_fac,
+                                                         d_exp_thermo_fac);
         }
 
     return hipSuccess;
@@ -436,3 +446,189 @@ void gpu_npt_mtk_rescale(const GPUPartition& gpu_partition,
             mat_exp_r_zz);
         }
     }
+
+//! Kernel to advance the barostat half a time step, in a single thread
+/*! The update follows TwoStepNPTMTK::advanceBarostat(). The flag and coupling values mirror
+    TwoStepNPTMTK::baroFlags and TwoStepNPTMTK::couplingMode.
+*/
+__global__ void gpu_npt_mtk_advance_barostat_kernel(npt_mtk_state *d_state,
+                                                    const Scalar *d_properties,
+                                                    const npt_mtk_barostat_args args)
+    {
+    if (blockIdx.x * blockDim.x + threadIdx.x != 0)
+        return;
+
+    npt_mtk_state state = *d_state;
+
+    // pressure tensor, or the set point if it has not been computed
+    Scalar P_xx = d_properties[thermo_index::pressure_xx];
+    Scalar P_xy = d_properties[thermo_index::pressure_xy];
+    Scalar P_xz = d_properties[thermo_index::pressure_xz];
+    Scalar P_yy = d_properties[thermo_index::pressure_yy];
+    Scalar P_yz = d_properties[thermo_index::pressure_yz];
+    Scalar P_zz = d_properties[thermo_index::pressure_zz];
+    if (!args.pressure_valid || isnan(P_xx) || isnan(P_xy) || isnan(P_xz) || isnan(P_yy) || isnan(P_yz)
+        || isnan(P_zz))
+        {
+        P_xx = args.S[0];
+        P_yy = args.S[1];
+        P_zz = args.S[2];
+        P_yz = args.S[3];
+        P_xz = args.S[4];
+        P_xy = args.S[5];
+        }
+
+    const Scalar ke_trans = d_properties[thermo_index::translational_kinetic_energy];
+
+    // Martyna-Tobias-Klein correction
+    Scalar mtk_term = Scalar(2.0)*ke_trans;
+    mtk_term *= Scalar(1.0/2.0)*args.deltaT/args.ndof/args.W;
+
+    // couple diagonal elements of pressure tensor together
+    Scalar3 P_diag = make_scalar3(P_xx, P_yy, P_zz);
+    if (args.couple == 1) // couple_xy
+        {
+        P_diag.x = P_diag.y = Scalar(1.0/2.0)*(P_xx + P_yy);
+        }
+    else if (args.couple == 2) // couple_xz
+        {
+        P_diag.x = P_diag.z = Scalar(1.0/2.0)*(P_xx + P_zz);
+        }
+    else if (args.couple == 3) // couple_yz
+        {
+        P_diag.y = P_diag.z = Scalar(1.0/2.0)*(P_yy + P_zz);
+        }
+    else if (args.couple == 4) // couple_xyz
+        {
+        P_diag.x = P_diag.y = P_diag.z = Scalar(1.0/3.0)*(P_xx + P_yy + P_zz);
+        }
+
+    // update barostat matrix
+    const Scalar fac = Scalar(1.0/2.0)*args.deltaT*args.V/args.W;
+    Scalar& nuxx = state.variable[2];
+    Scalar& nuxy = state.variable[3];
+    Scalar& nuxz = state.variable[4];
+    Scalar& nuyy = state.variable[5];
+    Scalar& nuyz = state.variable[6];
+    Scalar& nuzz = state.variable[7];
+
+    if (args.flags & 1) // baro_x
+        {
+        nuxx += fac*(P_diag.x - args.S[0]) + mtk_term;
+        nuxx -= args.gamma*nuxx;
+        }
+    if (args.flags & 8) // baro_xy
+        {
+        nuxy += fac*(P_xy - args.S[5]);
+        nuxy -= args.gamma*nuxy;
+        }
+    if (args.flags & 16) // baro_xz
+        {
+        nuxz += fac*(P_xz - args.S[4]);
+        nuxz -= args.gamma*nuxz;
+        }
+    if (args.flags & 2) // baro_y
+        {
+        nuyy += fac*(P_diag.y - args.S[1]) + mtk_term;
+        nuyy -= args.gamma*nuyy;
+        }
+    if (args.flags & 32) // baro_yz
+        {
+        nuyz += fac*(P_yz - args.S[3]);
+        nuyz -= args.gamma*nuyz;
+        }
+    if (args.flags & 4) // baro_z
+        {
+        nuzz += fac*(P_diag.z - args.S[2]) + mtk_term;
+        nuzz -= args.gamma*nuzz;
+        }
+
+    state.P[0] = P_xx;
+    state.P[1] = P_xy;
+    state.P[2] = P_xz;
+    state.P[3] = P_yy;
+    state.P[4] = P_yz;
+    state.P[5] = P_zz;
+    state.ke_trans = ke_trans;
+
+    *d_state = state;
+    }
+
+/*! \param d_state Thermostat and barostat variables
+    \param d_properties Thermodynamic properties at the full time step (ComputeThermo)
+    \param args Barostat parameters
+*/
+hipError_t gpu_npt_mtk_advance_barostat(npt_mtk_state *d_state,
+                                        const Scalar *d_properties,
+                                        const npt_mtk_barostat_args& args)
+    {
+    hipLaunchKernelGGL((gpu_npt_mtk_advance_barostat_kernel), dim3(1), dim3(1), 0, 0, d_state, d_properties, args);
+
+    return hipSuccess;
+    }
+
+//! Kernel to advance the thermostat half a time step, in a single thread
+/*! The update follows TwoStepNPTMTK::advanceThermostat(), starting from the integrator variables passed from the
+    host. The thermostat factors of the second step are computed from the new variables, so that the second step
+    does not need them on the host.
+*/
+__global__ void gpu_npt_mtk_advance_thermostat_kernel(npt_mtk_state *d_state,
+                                                      const Scalar *d_properties,
+                                                      const npt_mtk_thermostat_args args)
+    {
+    if (blockIdx.x * blockDim.x + threadIdx.x != 0)
+        return;
+
+    npt_mtk_state state = *d_state;
+    for (unsigned int i = 0; i < 10; ++i)
+        state.variable[i] = args.variable[i];
+    Scalar& eta = state.variable[0];
+    Scalar& xi = state.variable[1];
+    Scalar& xi_rot = state.variable[8];
+    Scalar& eta_rot = state.variable[9];
+
+    if (!args.nph)
+        {
+        Scalar curr_T_trans(0.0);
+        if (args.ndof_trans > 0)
+            curr_T_trans = Scalar(2.0)/args.ndof_trans*d_properties[thermo_index::translational_kinetic_energy];
+
+        // update the state variables Xi and eta
+        Scalar xi_prime = xi + Scalar(1.0/2.0)*args.deltaT/args.tau/args.tau*(curr_T_trans/args.T - Scalar(1.0));
+        xi = xi_prime + Scalar(1.0/2.0)*args.deltaT/args.tau/args.tau*(curr_T_trans/args.T - Scalar(1.0));
+        eta += xi_prime*args.deltaT;
+
+        if (args.aniso)
+            {
+            // update thermostat for rotational DOF
+            Scalar curr_ke_rot = args.rot_valid ? d_properties[thermo_index::rotational_kinetic_energy] : Scalar(0.0);
+
+            Scalar xi_prime_rot = xi_rot + Scalar(1.0/2.0)*args.deltaT/args.tau/args.tau
+                                  *(Scalar(2.0)*curr_ke_rot/args.ndof_rot/args.T - Scalar(1.0));
+            xi_rot = xi_prime_rot + Scalar(1.0/2.0)*args.deltaT/args.tau/args.tau
+                     *(Scalar(2.0)*curr_ke_rot/args.ndof_rot/args.T - Scalar(1.0));
+
+            eta_rot += xi_prime_rot*args.deltaT;
+            }
+        }
+
+    // Martyna-Tobias-Klein correction
+    Scalar mtk = (state.variable[2] + state.variable[5] + state.variable[7])/args.ndof;
+    state.exp_thermo_fac = exp(-Scalar(1.0/2.0)*(xi+mtk)*args.deltaT);
+    state.exp_thermo_fac_rot = exp(-(xi_rot+mtk)*args.deltaT/Scalar(2.0));
+
+    *d_state = state;
+    }
+
+/*! \param d_state Thermostat and barostat variables
+    \param d_properties Thermodynamic properties at the half time step (ComputeThermo)
+    \param args Thermostat parameters
+*/
+hipError_t gpu_npt_mtk_advance_thermostat(npt_mtk_state *d_state,
+                                          const Scalar *d_properties,
+                                          const npt_mtk_thermostat_args& args)
+    {
+    hipLaunchKernelGGL((gpu_npt_mtk_advance_thermostat_kernel), dim3(1), dim3(1), 0, 0, d_state, d_properties, args);
+
+    return hipSuccess;
+    }
@@ -17,6 +17,55 @@
     \brief Declares GPU kernel code for NPT integration on the GPU using the Martyna-Tobias-Klein (MTK) equations. Used by TwoStepNPTMTKGPU.
 */
 
+//! Thermostat and barostat variables of TwoStepNPTMTKGPU that are updated on the device
+struct npt_mtk_state
+    {
+    Scalar variable[10];        //!< Integrator variables (eta, xi, nuxx, nuxy, nuxz, nuyy, nuyz, nuzz, xi_rot, eta_rot)
+    Scalar P[6];                //!< Pressure tensor of the last barostat update (xx, xy, xz, yy, yz, zz)
+    Scalar ke_trans;            //!< Translational kinetic energy of the last barostat update
+    Scalar exp_thermo_fac;      //!< Thermostat factor of the velocities in the second step
+    Scalar exp_thermo_fac_rot;  //!< Thermostat factor of the angular momenta in the second step
+    };
+
+//! Parameters of the barostat update on the device
+struct npt_mtk_barostat_args
+    {
+    Scalar S[6];                //!< Stress set point (xx, yy, zz, yz, xz, xy)
+    Scalar W;                   //!< Barostat mass
+    Scalar V;                   //!< Box volume
+    Scalar ndof;                //!< Translational degrees of freedom of the MTK correction
+    Scalar deltaT;              //!< Time step
+    Scalar gamma;               //!< Damping factor of the box degrees of freedom
+    unsigned int flags;         //!< Barostatted degrees of freedom (TwoStepNPTMTK::baroFlags)
+    unsigned int couple;        //!< Coupling of the diagonal elements (TwoStepNPTMTK::couplingMode)
+    bool pressure_valid;        //!< True if the pressure tensor has been computed
+    };
+
+//! Parameters of the thermostat update on the device
+struct npt_mtk_thermostat_args
+    {
+    Scalar variable[10];        //!< Integrator variables at the start of the update
+    Scalar T;                   //!< Temperature set point
+    Scalar tau;                 //!< Thermostat period
+    Scalar ndof;                //!< Translational degrees of freedom of the MTK correction
+    Scalar ndof_trans;          //!< Translational degrees of freedom of the thermostatted group
+    Scalar ndof_rot;            //!< Rotational degrees of freedom of the thermostatted group
+    Scalar deltaT;              //!< Time step
+    bool nph;                   //!< True if the thermostat variables are not updated
+    bool aniso;                 //!< True if the rotational degrees of freedom are integrated
+    bool rot_valid;             //!< True if the rotational kinetic energy has been computed
+    };
+
+//! Kernel driver to advance the barostat half a time step on the device
+hipError_t gpu_npt_mtk_advance_barostat(npt_mtk_state *d_state,
+                                        const Scalar *d_properties,
+                                        const npt_mtk_barostat_args& args);
+
+//! Kernel driver to advance the thermostat half a time step on the device
+hipError_t gpu_npt_mtk_advance_thermostat(npt_mtk_state *d_state,
+                                          const Scalar *d_properties,
+                                          const npt_mtk_thermostat_args& args);
+
 //! Kernel driver for the the first step of the computation
 hipError_t gpu_npt_mtk_step_one(Scalar4 *d_pos,
                              Scalar4 *d_vel,
@@ -47,7 +96,8 @@ hipError_t gpu_npt_mtk_step_two(Scalar4 *d_vel,
                              Scalar *mat_exp_v,
                              Scalar deltaT,
                              Scalar exp_thermo_fac,
-                             const unsigned int block_size);
+                             const unsigned int block_size,
+                             const Scalar *d_exp_thermo_fac = NULL);
 
 //! Rescale all positions
 void gpu_npt_mtk_rescale(const GPUPartition& gpu_partition,
@@ -5,9 +5,11 @@
 // Maintainer: jglaser
 
 #include "TwoStepNPTMTK.h"
+#include "TwoStepNPTMTKGPU.cuh"
 #include "hoomd/Variant.h"
 #include "ComputeThermo.h"
 #include "hoomd/Autotuner.h"
+#include "hoomd/GlobalArray.h"
 
 #include <memory>
 
@@ -27,6 +29,12 @@
 
 //! Integrates part of the system forward in two steps in the NPT ensemble
 /*! This is a version of TwoStepNPTMTK that runs on the GPU.
+ *
+ * Without domain decomposition, the thermostat update of the first step and the barostat update of the second
+ * step run on the device, reading the thermodynamic properties directly from the ComputeThermo. The second step
+ * reads its thermostat factors from the device, and the updated variables are copied back to the host once per
+ * time step, at the end of the second step, together with the pressure tensor. The first step of the next time
+ * step reuses this pressure tensor to update the box without another synchronization.
  *
     \ingroup updaters
 */
@@ -82,6 +90,16 @@ class PYBIND11_EXPORT TwoStepNPTMTKGPU : public TwoStepNPTMTK
         std::unique_ptr<Autotuner> m_tuner_rescale; //!< Autotuner for thermostat rescaling
         std::unique_ptr<Autotuner> m_tuner_angular_one; //!< Autotuner for angular step one
         std::unique_ptr<Autotuner> m_tuner_angular_two; //!< Autotuner for angular step two
+
+        GlobalArray<npt_mtk_state> m_state;   //!< Thermostat and barostat variables updated on the device
+        bool m_thermostat_on_device;          //!< True if the first step left the thermostat factors in m_state
+        bool m_pressure_valid;                //!< True if m_pressure was read back at m_pressure_timestep
+        uint64_t m_pressure_timestep;         //!< Time step of the pressure tensor read back with m_state
+        PressureTensor m_pressure;            //!< Pressure tensor of the last barostat update on the device
+        Scalar m_translational_kinetic_energy; //!< Translational kinetic energy of the last barostat update
+
+        //! Check if the thermostat and barostat are updated on the device
+        bool useDeviceState();
     };
 
 //! Exports the TwoStepNPTMTKGPU class to python
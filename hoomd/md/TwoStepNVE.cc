@@ -17,6 +17,169 @@ namespace py = pybind11;
     \brief Contains code for the TwoStepNVE class
 */
 
+//! Advance the positions and velocities of a group by the first half step of velocity verlet
+/*! \tparam zero_force True if the accelerations are set to zero
+    \tparam limit True if the displacement of each particle is limited to \a limit_val
+    \param index_array Indices of the group members, NULL for a group of all particles
+    \param group_size Number of group members
+    \param pos Particle positions
+    \param vel Particle velocities
+    \param accel Particle accelerations
+    \param deltaT Time step size
+    \param limit_val Maximum displacement
+    \param modifiers Constraints applied to each particle
+    \returns The largest squared displacement of a group member
+
+    The flags are template parameters so the common combinations compile to loops without branches.
+*/
+template<bool zero_force, bool limit>
+static Scalar nve_step_one(const unsigned int *index_array,
+                           unsigned int group_size,
+                           Scalar4 *pos,
+                           Scalar4 *vel,
+                           Scalar3 *accel,
+                           Scalar deltaT,
+                           Scalar limit_val,
+                           const PostStepModifiers& modifiers)
+    {
+    const bool constrain = modifiers.hasParticleModifiers();
+
+    Scalar max_dsq(0.0);
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = index_array ? index_array[group_idx] : group_idx;
+        if (zero_force)
+            accel[j].x = accel[j].y = accel[j].z = 0.0;
+
+        Scalar dx = vel[j].x*deltaT + Scalar(1.0/2.0)*accel[j].x*deltaT*deltaT;
+        Scalar dy = vel[j].y*deltaT + Scalar(1.0/2.0)*accel[j].y*deltaT*deltaT;
+        Scalar dz = vel[j].z*deltaT + Scalar(1.0/2.0)*accel[j].z*deltaT*deltaT;
+
+        // limit the movement of the particles
+        if (limit)
+            {
+            Scalar len = sqrt(dx*dx + dy*dy + dz*dz);
+            if (len > limit_val)
+                {
+                dx = dx / len * limit_val;
+                dy = dy / len * limit_val;
+                dz = dz / len * limit_val;
+                }
+            }
+
+        if (constrain)
+            {
+            Scalar3 r_old = make_scalar3(pos[j].x, pos[j].y, pos[j].z);
+            Scalar3 d = make_scalar3(dx, dy, dz);
+            modifiers.constrainDirection(d);
+            Scalar3 r = r_old + d;
+            modifiers.constrainPosition(r);
+            d = r - r_old;
+            dx = d.x; dy = d.y; dz = d.z;
+            }
+
+        pos[j].x += dx;
+        pos[j].y += dy;
+        pos[j].z += dz;
+
+        Scalar dsq = dx*dx + dy*dy + dz*dz;
+        max_dsq = (dsq > max_dsq) ? dsq : max_dsq;
+
+        vel[j].x += Scalar(1.0/2.0)*accel[j].x*deltaT;
+        vel[j].y += Scalar(1.0/2.0)*accel[j].y*deltaT;
+        vel[j].z += Scalar(1.0/2.0)*accel[j].z*deltaT;
+
+        if (constrain)
+            {
+            Scalar3 v = make_scalar3(vel[j].x, vel[j].y, vel[j].z);
+            modifiers.constrainVelocity(make_scalar3(pos[j].x, pos[j].y, pos[j].z), v);
+            vel[j].x = v.x; vel[j].y = v.y; vel[j].z = v.z;
+            }
+        }
+
+    return max_dsq;
+    }
+
+//! Advance the velocities of a group by the second half step of velocity verlet
+/*! \tparam zero_force True if the accelerations are set to zero
+    \tparam limit True if the displacement of each particle in the next step is limited to \a limit_val
+    \param index_array Indices of the group members, NULL for a group of all particles
+    \param group_size Number of group members
+    \param pos Particle positions
+    \param vel Particle velocities
+    \param accel Particle accelerations
+    \param net_force Net force on each particle
+    \param deltaT Time step size
+    \param limit_val Maximum displacement
+    \param modifiers Constraints applied to each particle
+    \returns The sum of the momenta of the group members
+*/
+template<bool zero_force, bool limit>
+static Scalar3 nve_step_two(const unsigned int *index_array,
+                            unsigned int group_size,
+                            const Scalar4 *pos,
+                            Scalar4 *vel,
+                            Scalar3 *accel,
+                            const Scalar4 *net_force,
+                            Scalar deltaT,
+                            Scalar limit_val,
+                            const PostStepModifiers& modifiers)
+    {
+    const bool constrain = modifiers.hasParticleModifiers();
+
+    Scalar3 sum_p = make_scalar3(0.0, 0.0, 0.0);
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = index_array ? index_array[group_idx] : group_idx;
+
+        if (zero_force)
+            {
+            accel[j].x = accel[j].y = accel[j].z = 0.0;
+            }
+        else
+            {
+            // first, calculate acceleration from the net force
+            Scalar minv = Scalar(1.0) / vel[j].w;
+            accel[j].x = net_force[j].x*minv;
+            accel[j].y = net_force[j].y*minv;
+            accel[j].z = net_force[j].z*minv;
+
+            if (constrain)
+                modifiers.constrainDirection(accel[j]);
+            }
+
+        // then, update the velocity
+        vel[j].x += Scalar(1.0/2.0)*accel[j].x*deltaT;
+        vel[j].y += Scalar(1.0/2.0)*accel[j].y*deltaT;
+        vel[j].z += Scalar(1.0/2.0)*accel[j].z*deltaT;
+
+        // limit the movement of the particles
+        if (limit)
+            {
+            Scalar v = sqrt(vel[j].x*vel[j].x+vel[j].y*vel[j].y+vel[j].z*vel[j].z);
+            if ( (v*deltaT) > limit_val)
+                {
+                vel[j].x = vel[j].x / v * limit_val / deltaT;
+                vel[j].y = vel[j].y / v * limit_val / deltaT;
+                vel[j].z = vel[j].z / v * limit_val / deltaT;
+                }
+            }
+
+        if (constrain)
+            {
+            Scalar3 v = make_scalar3(vel[j].x, vel[j].y, vel[j].z);
+            modifiers.constrainVelocity(make_scalar3(pos[j].x, pos[j].y, pos[j].z), v);
+            vel[j].x = v.x; vel[j].y = v.y; vel[j].z = v.z;
+            }
+
+        sum_p.x += vel[j].w*vel[j].x;
+        sum_p.y += vel[j].w*vel[j].y;
+        sum_p.z += vel[j].w*vel[j].z;
+        }
+
+    return sum_p;
+    }
+
 /*! \param sysdef SystemDefinition this method will act on. Must not be NULL.
     \param group The group of particles this integration method is to work on
     \param skip_restart Skip initialization of the restart information
@@ -99,6 +262,21 @@ void TwoStepNVE::setZeroForce(pybind11::object zero_force)
     }
 
 
+/*! \param params Set to the limit, zero force and post step modifier options of this method
+    \returns true unless the rotational degrees of freedom are integrated
+*/
+bool TwoStepNVE::getVelocityVerletStepOne(VelocityVerletStepOne& params) const
+    {
+    if (m_aniso)
+        return false;
+
+    params.zero_force = m_zero_force;
+    params.limit = m_limit;
+    params.limit_val = m_limit_val;
+    params.modifiers = m_post_step;
+    return true;
+    }
+
 /*! \param timestep Current time step
     \post Particle positions are moved forward to timestep+1 and velocities to timestep+1/2 per the velocity verlet
           method.
@@ -107,6 +285,10 @@ void TwoStepNVE::integrateStepOne(uint64_t timestep)
     {
     unsigned int group_size = m_group->getNumMembers();
 
+    // a group of all particles needs no index list
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
+    const unsigned int *index_array = m_group->isIdentity() ? NULL : h_index_array.data;
+
     // profile this step
     if (m_prof)
         m_prof->push("NVE step 1");
@@ -118,36 +300,26 @@ void TwoStepNVE::integrateStepOne(uint64_t timestep)
     // perform the first half step of velocity verlet
     // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
     // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    Scalar max_dsq;
+    if (m_zero_force)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        if (m_zero_force)
-            h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
-
-        Scalar dx = h_vel.data[j].x*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT*m_deltaT;
-        Scalar dy = h_vel.data[j].y*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT*m_deltaT;
-        Scalar dz = h_vel.data[j].z*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT*m_deltaT;
-
-        // limit the movement of the particles
         if (m_limit)
-            {
-            Scalar len = sqrt(dx*dx + dy*dy + dz*dz);
-            if (len > m_limit_val)
-                {
-                dx = dx / len * m_limit_val;
-                dy = dy / len * m_limit_val;
-                dz = dz / len * m_limit_val;
-                }
-            }
-
-        h_pos.data[j].x += dx;
-        h_pos.data[j].y += dy;
-        h_pos.data[j].z += dz;
-
-        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
-        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
-        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+            max_dsq = nve_step_one<true, true>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                               m_deltaT, m_limit_val, m_post_step);
+        else
+            max_dsq = nve_step_one<true, false>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                                m_deltaT, m_limit_val, m_post_step);
+        }
+    else
+        {
+        if (m_limit)
+            max_dsq = nve_step_one<false, true>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                                m_deltaT, m_limit_val, m_post_step);
+        else
+            max_dsq = nve_step_one<false, false>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                                 m_deltaT, m_limit_val, m_post_step);
         }
+    m_max_displacement = sqrt(max_dsq);
 
     // particles may have been moved slightly outside the box by the above steps, wrap them back into place
     const BoxDim& box = m_pdata->getBox();
@@ -156,7 +328,7 @@ void TwoStepNVE::integrateStepOne(uint64_t timestep)
 
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = index_array ? index_array[group_idx] : group_idx;
         box.wrap(h_pos.data[j], h_image.data[j]);
         }
 
@@ -171,7 +343,7 @@ void TwoStepNVE::integrateStepOne(uint64_t timestep)
 
         for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
+            unsigned int j = index_array ? index_array[group_idx] : group_idx;
 
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
@@ -280,6 +452,10 @@ void TwoStepNVE::integrateStepTwo(uint64_t timestep)
     {
     unsigned int group_size = m_group->getNumMembers();
 
+    // a group of all particles needs no index list
+    ArrayHandle<unsigned int> h_index_array(m_group->getIndexArray(), access_location::host, access_mode::read);
+    const unsigned int *index_array = m_group->isIdentity() ? NULL : h_index_array.data;
+
     const GlobalArray< Scalar4 >& net_force = m_pdata->getNetForce();
 
     // profile this step
@@ -290,40 +466,40 @@ void TwoStepNVE::integrateStepTwo(uint64_t timestep)
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
     // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    Scalar3 sum_p;
+    if (m_zero_force)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-
-        if (m_zero_force)
-            {
-            h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
-            }
+        if (m_limit)
+            sum_p = nve_step_two<true, true>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                             h_net_force.data, m_deltaT, m_limit_val, m_post_step);
         else
-            {
-            // first, calculate acceleration from the net force
-            Scalar minv = Scalar(1.0) / h_vel.data[j].w;
-            h_accel.data[j].x = h_net_force.data[j].x*minv;
-            h_accel.data[j].y = h_net_force.data[j].y*minv;
-            h_accel.data[j].z = h_net_force.data[j].z*minv;
-            }
-
-        // then, update the velocity
-        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
-        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
-        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
-
-        // limit the movement of the particles
+            sum_p = nve_step_two<true, false>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                              h_net_force.data, m_deltaT, m_limit_val, m_post_step);
+        }
+    else
+        {
         if (m_limit)
+            sum_p = nve_step_two<false, true>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                              h_net_force.data, m_deltaT, m_limit_val, m_post_step);
+        else
+            sum_p = nve_step_two<false, false>(index_array, group_size, h_pos.data, h_vel.data, h_accel.data,
+                                               h_net_force.data, m_deltaT, m_limit_val, m_post_step);
+        }
+
+    // remove the momentum of the group, summed in the loop above
+    if (m_post_step.hasZeroMomentum())
+        {
+        Scalar3 avg_p = getAverageMomentum(sum_p);
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
             {
-            Scalar vel = sqrt(h_vel.data[j].x*h_vel.data[j].x+h_vel.data[j].y*h_vel.data[j].y+h_vel.data[j].z*h_vel.data[j].z);
-            if ( (vel*m_deltaT) > m_limit_val)
-                {
-                h_vel.data[j].x = h_vel.data[j].x / vel * m_limit_val / m_deltaT;
-                h_vel.data[j].y = h_vel.data[j].y / vel * m_limit_val / m_deltaT;
-                h_vel.data[j].z = h_vel.data[j].z / vel * m_limit_val / m_deltaT;
-                }
+            unsigned int j = index_array ? index_array[group_idx] : group_idx;
+            Scalar minv = Scalar(1.0) / h_vel.data[j].w;
+            h_vel.data[j].x -= avg_p.x*minv;
+            h_vel.data[j].y -= avg_p.y*minv;
+            h_vel.data[j].z -= avg_p.z*minv;
             }
         }
 
@@ -337,7 +513,7 @@ void TwoStepNVE::integrateStepTwo(uint64_t timestep)
 
         for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
             {
-            unsigned int j = m_group->getMemberIndex(group_idx);
+            unsigned int j = index_array ? index_array[group_idx] : group_idx;
 
             quat<Scalar> q(h_orientation.data[j]);
             quat<Scalar> p(h_angmom.data[j]);
@@ -55,6 +55,15 @@ class PYBIND11_EXPORT TwoStepNVE : public IntegrationMethodTwoStep
         //! Performs the second step of the integration
         virtual void integrateStepTwo(uint64_t timestep);
 
+        //! The post step modifiers are applied in the step loops
+        virtual bool supportsPostStepModifiers() const
+            {
+            return true;
+            }
+
+        //! Get the parameters of the first step when it is a plain velocity verlet step
+        virtual bool getVelocityVerletStepOne(VelocityVerletStepOne& params) const;
+
     protected:
         bool m_limit;       //!< True if we should limit the distance a particle moves in one step
         Scalar m_limit_val; //!< The maximum distance a particle is to move in one step
@@ -21,7 +21,7 @@ using namespace std;
 */
 TwoStepNVEGPU::TwoStepNVEGPU(std::shared_ptr<SystemDefinition> sysdef,
                              std::shared_ptr<ParticleGroup> group)
-    : TwoStepNVE(sysdef, group)
+    : TwoStepNVE(sysdef, group), m_partial_p(m_exec_conf)
     {
     // only one GPU is supported
     if (!m_exec_conf->isCUDAEnabled())
@@ -60,6 +60,7 @@ void TwoStepNVEGPU::integrateStepOne(uint64_t timestep)
 
     BoxDim box = m_pdata->getBox();
     ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+    unsigned int *d_group_members = m_group->isIdentity() ? NULL : d_index_array.data;
 
     // perform the update on the GPU
     m_exec_conf->beginMultiGPU();
@@ -68,14 +69,15 @@ void TwoStepNVEGPU::integrateStepOne(uint64_t timestep)
                      d_vel.data,
                      d_accel.data,
                      d_image.data,
-                     d_index_array.data,
+                     d_group_members,
                      m_group->getGPUPartition(),
                      box,
                      m_deltaT,
                      m_limit,
                      m_limit_val,
                      m_zero_force,
-                     m_tuner_one->getParam());
+                     m_tuner_one->getParam(),
+                     m_post_step);
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
@@ -98,7 +100,7 @@ void TwoStepNVEGPU::integrateStepOne(uint64_t timestep)
                                  d_angmom.data,
                                  d_inertia.data,
                                  d_net_torque.data,
-                                 d_index_array.data,
+                                 d_group_members,
                                  m_group->getGPUPartition(),
                                  m_deltaT,
                                  1.0,
@@ -129,30 +131,77 @@ void TwoStepNVEGPU::integrateStepTwo(uint64_t timestep)
 
     ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::readwrite);
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
 
     ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::read);
     ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+    unsigned int *d_group_members = m_group->isIdentity() ? NULL : d_index_array.data;
 
-    // perform the update on the GPU
-    m_exec_conf->beginMultiGPU();
-    m_tuner_two->begin();
+    // the kernel sums the momentum per block while it updates the velocities
+    const bool zero_momentum = m_post_step.hasZeroMomentum();
+    unsigned int block_size = m_tuner_two->getParam();
+    unsigned int n_blocks = 0;
+    if (zero_momentum)
+        {
+        n_blocks = gpu_nve_num_blocks(m_group->getGPUPartition(), block_size);
+        if (m_partial_p.getNumElements() < n_blocks)
+            {
+            GlobalArray<Scalar3> partial_p(n_blocks, m_exec_conf);
+            m_partial_p.swap(partial_p);
+            TAG_ALLOCATION(m_partial_p);
+            }
+        }
 
-    gpu_nve_step_two(d_vel.data,
-                     d_accel.data,
-                     d_index_array.data,
-                     m_group->getGPUPartition(),
-                     d_net_force.data,
-                     m_deltaT,
-                     m_limit,
-                     m_limit_val,
-                     m_zero_force,
-                     m_tuner_two->getParam());
+        {
+        ArrayHandle<Scalar3> d_partial_p(m_partial_p, access_location::device, access_mode::overwrite);
 
-    if(m_exec_conf->isCUDAErrorCheckingEnabled())
-        CHECK_CUDA_ERROR();
+        // perform the update on the GPU
+        m_exec_conf->beginMultiGPU();
+        m_tuner_two->begin();
+
+        gpu_nve_step_two(d_vel.data,
+                         d_accel.data,
+                         d_pos.data,
+                         d_group_members,
+                         m_group->getGPUPartition(),
+                         d_net_force.data,
+                         m_deltaT,
+                         m_limit,
+                         m_limit_val,
+                         m_zero_force,
+                         block_size,
+                         m_post_step,
+                         zero_momentum ? d_partial_p.data : NULL);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
 
-    m_tuner_two->end();
-    m_exec_conf->endMultiGPU();
+        m_tuner_two->end();
+        m_exec_conf->endMultiGPU();
+        }
+
+    if (zero_momentum)
+        {
+        Scalar3 sum_p = make_scalar3(0.0, 0.0, 0.0);
+            {
+            ArrayHandle<Scalar3> h_partial_p(m_partial_p, access_location::host, access_mode::read);
+            for (unsigned int i = 0; i < n_blocks; ++i)
+                sum_p += h_partial_p.data[i];
+            }
+
+        Scalar3 avg_p = getAverageMomentum(sum_p);
+
+        m_exec_conf->beginMultiGPU();
+        gpu_nve_subtract_momentum(d_vel.data,
+                                  d_group_members,
+                                  m_group->getGPUPartition(),
+                                  avg_p,
+                                  block_size);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_exec_conf->endMultiGPU();
+        }
 
     if (m_aniso)
         {
@@ -169,7 +218,7 @@ void TwoStepNVEGPU::integrateStepTwo(uint64_t timestep)
                                  d_angmom.data,
                                  d_inertia.data,
                                  d_net_torque.data,
-                                 d_index_array.data,
+                                 d_group_members,
                                  m_group->getGPUPartition(),
                                  m_deltaT,
                                  1.0,
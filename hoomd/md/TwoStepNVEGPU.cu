@@ -19,7 +19,8 @@
     \param d_vel array of particle velocities
     \param d_accel array of particle accelerations
     \param d_image array of particle images
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param box Box dimensions for periodic boundary condition handling
     \param deltaT timestep
@@ -27,6 +28,7 @@
         a distance further than \a limit_val in one step.
     \param limit_val Length to limit particle distance movement to
     \param zero_force Set to true to always assign an acceleration of 0 to all particles in the group
+    \param modifiers Constraints applied to each particle
 
     This kernel must be executed with a 1D grid of any block size such that the number of threads is greater than or
     equal to the number of members in the group. The kernel's implementation simply reads one particle in each thread
@@ -49,7 +51,8 @@ void gpu_nve_step_one_kernel(Scalar4 *d_pos,
                              Scalar deltaT,
                              bool limit,
                              Scalar limit_val,
-                             bool zero_force)
+                             bool zero_force,
+                             PostStepModifiers modifiers)
     {
     // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
     int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -57,7 +60,7 @@ void gpu_nve_step_one_kernel(Scalar4 *d_pos,
     if (work_idx < nwork)
         {
         const unsigned int group_idx = work_idx + offset;
-        unsigned int idx = d_group_members[group_idx];
+        unsigned int idx = d_group_members ? d_group_members[group_idx] : group_idx;
 
         // do velocity verlet update
         // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
@@ -86,12 +89,24 @@ void gpu_nve_step_one_kernel(Scalar4 *d_pos,
                 dx = dx / len * limit_val;
             }
 
-        // FLOPS: 3
-        pos += dx;
+        if (modifiers.hasParticleModifiers())
+            {
+            modifiers.constrainDirection(dx);
+            pos += dx;
+            modifiers.constrainPosition(pos);
+            }
+        else
+            {
+            // FLOPS: 3
+            pos += dx;
+            }
 
         // update the velocity (FLOPS: 9)
         vel += (Scalar(1.0)/Scalar(2.0)) * accel * deltaT;
 
+        if (modifiers.hasParticleModifiers())
+            modifiers.constrainVelocity(pos, vel);
+
         // read in the particle's image (MEM TRANSFER: 16 bytes)
         int3 image = d_image[idx];
 
@@ -109,7 +124,8 @@ void gpu_nve_step_one_kernel(Scalar4 *d_pos,
     \param d_vel array of particle velocities
     \param d_accel array of particle accelerations
     \param d_image array of particle images
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param box Box dimensions for periodic boundary condition handling
     \param deltaT timestep
@@ -117,6 +133,8 @@ void gpu_nve_step_one_kernel(Scalar4 *d_pos,
         a distance further than \a limit_val in one step.
     \param limit_val Length to limit particle distance movement to
     \param zero_force Set to true to always assign an acceleration of 0 to all particles in the group
+    \param block_size Block size of the kernel
+    \param modifiers Constraints applied to each particle
 
     See gpu_nve_step_one_kernel() for full documentation, this function is just a driver.
 */
@@ -131,7 +149,8 @@ hipError_t gpu_nve_step_one(Scalar4 *d_pos,
                              bool limit,
                              Scalar limit_val,
                              bool zero_force,
-                             unsigned int block_size)
+                             unsigned int block_size,
+                             const PostStepModifiers& modifiers)
     {
     static unsigned int max_block_size = UINT_MAX;
     if (max_block_size == UINT_MAX)
@@ -155,7 +174,7 @@ hipError_t gpu_nve_step_one(Scalar4 *d_pos,
         dim3 threads(run_block_size, 1, 1);
 
         // run the kernel
-        hipLaunchKernelGGL((gpu_nve_step_one_kernel), dim3(grid), dim3(threads ), 0, 0, d_pos, d_vel, d_accel, d_image, d_group_members, nwork, range.first, box, deltaT, limit, limit_val, zero_force);
+        hipLaunchKernelGGL((gpu_nve_step_one_kernel), dim3(grid), dim3(threads ), 0, 0, d_pos, d_vel, d_accel, d_image, d_group_members, nwork, range.first, box, deltaT, limit, limit_val, zero_force, modifiers);
         }
 
     return hipSuccess;
@@ -166,7 +185,8 @@ hipError_t gpu_nve_step_one(Scalar4 *d_pos,
     \param d_angmom array of particle conjugate quaternions
     \param d_inertia array of moments of inertia
     \param d_net_torque array of net torques
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param deltaT timestep
 */
@@ -186,7 +206,7 @@ __global__ void gpu_nve_angular_step_one_kernel(Scalar4 *d_orientation,
     if (work_idx < nwork)
         {
         const unsigned int group_idx = work_idx + offset;
-        unsigned int idx = d_group_members[group_idx];
+        unsigned int idx = d_group_members ? d_group_members[group_idx] : group_idx;
 
         // read the particle's orientation, conjugate quaternion, moment of inertia and net torque
         quat<Scalar> q(d_orientation[idx]);
@@ -289,7 +309,8 @@ __global__ void gpu_nve_angular_step_one_kernel(Scalar4 *d_orientation,
     \param d_angmom array of particle conjugate quaternions
     \param d_inertia array of moments of inertia
     \param d_net_torque array of net torques
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param deltaT timestep
 */
@@ -335,7 +356,9 @@ hipError_t gpu_nve_angular_step_one(Scalar4 *d_orientation,
 //! Takes the second half-step forward in the velocity-verlet NVE integration on a group of particles
 /*! \param d_vel array of particle velocities
     \param d_accel array of particle accelerations
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_pos array of particle positions
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param d_net_force Net force on each particle
     \param deltaT Amount of real time to step forward in one time step
@@ -343,13 +366,20 @@ hipError_t gpu_nve_angular_step_one(Scalar4 *d_orientation,
         a distance further than \a limit_val in one step.
     \param limit_val Length to limit particle distance movement to
     \param zero_force Set to true to always assign an acceleration of 0 to all particles in the group
+    \param modifiers Constraints applied to each particle
+    \param d_partial_p Sums of the momenta per block, NULL if the momentum is not removed
+    \param block_offset Index of the first block of this launch in \a d_partial_p
 
     This kernel is implemented in a very similar manner to gpu_nve_step_one_kernel(), see it for design details.
+
+    When \a d_partial_p is set, each block sums the momenta of its particles after the update in shared memory, so
+    that the momentum is reduced in the same pass that updates the velocities.
 */
 extern "C" __global__
 void gpu_nve_step_two_kernel(
                             Scalar4 *d_vel,
                             Scalar3 *d_accel,
+                            const Scalar4 *d_pos,
                             unsigned int *d_group_members,
                             const unsigned int nwork,
                             const unsigned int offset,
@@ -357,15 +387,23 @@ void gpu_nve_step_two_kernel(
                             Scalar deltaT,
                             bool limit,
                             Scalar limit_val,
-                            bool zero_force)
+                            bool zero_force,
+                            PostStepModifiers modifiers,
+                            Scalar3 *d_partial_p,
+                            const unsigned int block_offset)
     {
+    HIP_DYNAMIC_SHARED( char, s_data)
+    Scalar3 *s_p = (Scalar3 *)s_data;
+
     // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
     int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
+    Scalar3 p = make_scalar3(Scalar(0.0), Scalar(0.0), Scalar(0.0));
+
     if (work_idx < nwork)
         {
         const unsigned int group_idx = work_idx + offset;
-        unsigned int idx = d_group_members[group_idx];
+        unsigned int idx = d_group_members ? d_group_members[group_idx] : group_idx;
 
         // read in the net forc and calculate the acceleration MEM TRANSFER: 16 bytes
         Scalar3 accel = make_scalar3(Scalar(0.0), Scalar(0.0), Scalar(0.0));
@@ -382,6 +420,9 @@ void gpu_nve_step_two_kernel(
             accel.x /= mass;
             accel.y /= mass;
             accel.z /= mass;
+
+            if (modifiers.hasParticleModifiers())
+                modifiers.constrainDirection(accel);
             }
 
         // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
@@ -402,16 +443,81 @@ void gpu_nve_step_two_kernel(
                 }
             }
 
+        if (modifiers.hasParticleModifiers())
+            {
+            Scalar4 postype = d_pos[idx];
+            Scalar3 v = make_scalar3(vel.x, vel.y, vel.z);
+            modifiers.constrainVelocity(make_scalar3(postype.x, postype.y, postype.z), v);
+            vel.x = v.x; vel.y = v.y; vel.z = v.z;
+            }
+
         // write out data (MEM TRANSFER: 32 bytes)
         d_vel[idx] = vel;
         // since we calculate the acceleration, we need to write it for the next step
         d_accel[idx] = accel;
+
+        p = make_scalar3(vel.w*vel.x, vel.w*vel.y, vel.w*vel.z);
+        }
+
+    if (d_partial_p)
+        {
+        // reduce the momenta of the block
+        s_p[threadIdx.x] = p;
+        __syncthreads();
+
+        // the block size need not be a power of two
+        unsigned int s = 1;
+        while (s < blockDim.x)
+            s <<= 1;
+
+        for (s >>= 1; s > 0; s >>= 1)
+            {
+            if (threadIdx.x < s && threadIdx.x + s < blockDim.x)
+                s_p[threadIdx.x] += s_p[threadIdx.x + s];
+            __syncthreads();
+            }
+
+        if (threadIdx.x == 0)
+            d_partial_p[block_offset + blockIdx.x] = s_p[0];
+        }
+    }
+
+//! Limit a block size to the maximum block size of gpu_nve_step_two_kernel()
+static unsigned int nve_step_two_block_size(unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_nve_step_two_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
         }
+
+    return min(block_size, max_block_size);
+    }
+
+/*! \param gpu_partition Partition of the group over the GPUs
+    \param block_size Block size passed to gpu_nve_step_two()
+    \returns The number of blocks gpu_nve_step_two() launches on all GPUs
+*/
+unsigned int gpu_nve_num_blocks(const GPUPartition& gpu_partition, unsigned int block_size)
+    {
+    unsigned int run_block_size = nve_step_two_block_size(block_size);
+
+    unsigned int n_blocks = 0;
+    for (int idev = 0; idev < (int)gpu_partition.getNumActiveGPUs(); ++idev)
+        {
+        auto range = gpu_partition.getRange(idev);
+        n_blocks += (range.second - range.first)/run_block_size + 1;
+        }
+    return n_blocks;
     }
 
 /*! \param d_vel array of particle velocities
     \param d_accel array of particle accelerations
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_pos array of particle positions
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param d_net_force Net force on each particle
     \param deltaT Amount of real time to step forward in one time step
@@ -419,11 +525,16 @@ void gpu_nve_step_two_kernel(
         a distance further than \a limit_val in one step.
     \param limit_val Length to limit particle distance movement to
     \param zero_force Set to true to always assign an acceleration of 0 to all particles in the group
+    \param block_size Block size of the kernel
+    \param modifiers Constraints applied to each particle
+    \param d_partial_p Sums of the momenta per block, NULL if the momentum is not removed. It must hold
+           gpu_nve_num_blocks() elements.
 
     This is just a driver for gpu_nve_step_two_kernel(), see it for details.
 */
 hipError_t gpu_nve_step_two(Scalar4 *d_vel,
                              Scalar3 *d_accel,
+                             const Scalar4 *d_pos,
                              unsigned int *d_group_members,
                              const GPUPartition& gpu_partition,
                              Scalar4 *d_net_force,
@@ -431,17 +542,15 @@ hipError_t gpu_nve_step_two(Scalar4 *d_vel,
                              bool limit,
                              Scalar limit_val,
                              bool zero_force,
-                             unsigned int block_size)
+                             unsigned int block_size,
+                             const PostStepModifiers& modifiers,
+                             Scalar3 *d_partial_p)
     {
-    static unsigned int max_block_size = UINT_MAX;
-    if (max_block_size == UINT_MAX)
-        {
-        hipFuncAttributes attr;
-        hipFuncGetAttributes(&attr, (const void *)gpu_nve_step_two_kernel);
-        max_block_size = attr.maxThreadsPerBlock;
-        }
+    unsigned int run_block_size = nve_step_two_block_size(block_size);
+    unsigned int shared_bytes = d_partial_p ? (unsigned int)(run_block_size*sizeof(Scalar3)) : 0;
 
-    unsigned int run_block_size = min(block_size, max_block_size);
+    // the blocks of all GPUs write to consecutive elements of d_partial_p
+    unsigned int block_offset = gpu_nve_num_blocks(gpu_partition, block_size);
 
     // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
     for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
@@ -453,10 +562,12 @@ hipError_t gpu_nve_step_two(Scalar4 *d_vel,
         // setup the grid to run the kernel
         dim3 grid( (nwork/run_block_size) + 1, 1, 1);
         dim3 threads(run_block_size, 1, 1);
+        block_offset -= grid.x;
 
         // run the kernel
-        hipLaunchKernelGGL((gpu_nve_step_two_kernel), dim3(grid), dim3(threads ), 0, 0, d_vel,
+        hipLaunchKernelGGL((gpu_nve_step_two_kernel), dim3(grid), dim3(threads ), shared_bytes, 0, d_vel,
                                                      d_accel,
+                                                     d_pos,
                                                      d_group_members,
                                                      nwork,
                                                      range.first,
@@ -464,8 +575,81 @@ hipError_t gpu_nve_step_two(Scalar4 *d_vel,
                                                      deltaT,
                                                      limit,
                                                      limit_val,
-                                                     zero_force);
+                                                     zero_force,
+                                                     modifiers,
+                                                     d_partial_p,
+                                                     block_offset);
+        }
+    return hipSuccess;
+    }
+
+//! Subtracts the average momentum from the velocities of a group of particles
+/*! \param d_vel array of particle velocities
+    \param d_group_members Device array listing the indices of the members of the group, or NULL when the group
+           contains all particles
+    \param nwork Number of group members handled by this launch
+    \param offset Index of the first group member handled by this launch
+    \param avg_p Average momentum per group member
+*/
+__global__ void gpu_nve_subtract_momentum_kernel(Scalar4 *d_vel,
+                                                 const unsigned int *d_group_members,
+                                                 const unsigned int nwork,
+                                                 const unsigned int offset,
+                                                 Scalar3 avg_p)
+    {
+    int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (work_idx < nwork)
+        {
+        const unsigned int group_idx = work_idx + offset;
+        unsigned int idx = d_group_members ? d_group_members[group_idx] : group_idx;
+
+        Scalar4 vel = d_vel[idx];
+        Scalar minv = Scalar(1.0)/vel.w;
+        vel.x -= avg_p.x*minv;
+        vel.y -= avg_p.y*minv;
+        vel.z -= avg_p.z*minv;
+        d_vel[idx] = vel;
+        }
+    }
+
+/*! \param d_vel array of particle velocities
+    \param d_group_members Device array listing the indices of the members of the group, or NULL when the group
+           contains all particles
+    \param gpu_partition Partition of the group over the GPUs
+    \param avg_p Average momentum per group member
+    \param block_size Block size of the kernel
+*/
+hipError_t gpu_nve_subtract_momentum(Scalar4 *d_vel,
+                                     unsigned int *d_group_members,
+                                     const GPUPartition& gpu_partition,
+                                     Scalar3 avg_p,
+                                     unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_nve_subtract_momentum_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
         }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+
+        unsigned int nwork = range.second - range.first;
+
+        dim3 grid( (nwork/run_block_size) + 1, 1, 1);
+        dim3 threads(run_block_size, 1, 1);
+
+        hipLaunchKernelGGL((gpu_nve_subtract_momentum_kernel), dim3(grid), dim3(threads), 0, 0,
+            d_vel, d_group_members, nwork, range.first, avg_p);
+        }
+
     return hipSuccess;
     }
 
@@ -474,7 +658,8 @@ hipError_t gpu_nve_step_two(Scalar4 *d_vel,
     \param d_angmom array of particle conjugate quaternions
     \param d_inertia array of moments of inertia
     \param d_net_torque array of net torques
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param deltaT timestep
 */
@@ -486,7 +671,8 @@ __global__ void gpu_nve_angular_step_two_kernel(const Scalar4 *d_orientation,
                              const unsigned int nwork,
                              const unsigned int offset,
                              Scalar deltaT,
-                             Scalar scale)
+                             Scalar scale,
+                             const Scalar *d_scale)
     {
     // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
     int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -494,7 +680,7 @@ __global__ void gpu_nve_angular_step_two_kernel(const Scalar4 *d_orientation,
     if (work_idx < nwork)
         {
         const unsigned int group_idx = work_idx + offset;
-        unsigned int idx = d_group_members[group_idx];
+        unsigned int idx = d_group_members ? d_group_members[group_idx] : group_idx;
 
         // read the particle's orientation, conjugate quaternion, moment of inertia and net torque
         quat<Scalar> q(d_orientation[idx]);
@@ -515,6 +701,8 @@ __global__ void gpu_nve_angular_step_two_kernel(const Scalar4 *d_orientation,
         if (z_zero) t.z = Scalar(0.0);
 
         // rescale
+        if (d_scale)
+            scale = *d_scale;
         p = p*scale;
 
         // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
@@ -528,9 +716,13 @@ __global__ void gpu_nve_angular_step_two_kernel(const Scalar4 *d_orientation,
     \param d_angmom array of particle conjugate quaternions
     \param d_inertia array of moments of inertia
     \param d_net_torque array of net torques
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param d_group_members Device array listing the indices of the members of the group to integrate, or NULL when
+           the group contains all particles
     \param group_size Number of members in the group
     \param deltaT timestep
+    \param scale Rescaling factor of the angular momenta
+    \param block_size Kernel block size
+    \param d_scale If not NULL, the rescaling factor is read from this device memory instead of \a scale
 */
 hipError_t gpu_nve_angular_step_two(const Scalar4 *d_orientation,
                              Scalar4 *d_angmom,
@@ -540,7 +732,8 @@ hipError_t gpu_nve_angular_step_two(const Scalar4 *d_orientation,
                              const GPUPartition& gpu_partition,
                              Scalar deltaT,
                              Scalar scale,
-                             const unsigned int block_size)
+                             const unsigned int block_size,
+                             const Scalar *d_scale)
     {
     static unsigned int max_block_size = UINT_MAX;
     if (max_block_size == UINT_MAX)
@@ -564,7 +757,7 @@ hipError_t gpu_nve_angular_step_two(const Scalar4 *d_orientation,
         dim3 threads(run_block_size, 1, 1);
 
         // run the kernel
-        hipLaunchKernelGGL((gpu_nve_angular_step_two_kernel), dim3(grid), dim3(threads ), 0, 0, d_orientation, d_angmom, d_inertia, d_net_torque, d_group_members, nwork, range.first, deltaT, scale);
+        hipLaunchKernelGGL((gpu_nve_angular_step_two_kernel), dim3(grid), dim3(threads ), 0, 0, d_orientation, d_angmom, d_inertia, d_net_torque, d_group_members, nwork, range.first, deltaT, scale, d_scale);
         }
 
     return hipSuccess;
@@ -11,6 +11,7 @@
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/GPUPartition.cuh"
+#include "PostStepModifiers.h"
 
 #ifndef __TWO_STEP_NVE_GPU_CUH__
 #define __TWO_STEP_NVE_GPU_CUH__
@@ -27,11 +28,13 @@ hipError_t gpu_nve_step_one(Scalar4 *d_pos,
                              bool limit,
                              Scalar limit_val,
                              bool zero_force,
-                             unsigned int block_size);
+                             unsigned int block_size,
+                             const PostStepModifiers& modifiers = PostStepModifiers());
 
 //! Kernel driver for the second part of the NVE update called by TwoStepNVEGPU
 hipError_t gpu_nve_step_two(Scalar4 *d_vel,
                              Scalar3 *d_accel,
+                             const Scalar4 *d_pos,
                              unsigned int *d_group_members,
                              const GPUPartition& gpu_partition,
                              Scalar4 *d_net_force,
@@ -39,7 +42,19 @@ hipError_t gpu_nve_step_two(Scalar4 *d_vel,
                              bool limit,
                              Scalar limit_val,
                              bool zero_force,
-                             unsigned int block_size);
+                             unsigned int block_size,
+                             const PostStepModifiers& modifiers,
+                             Scalar3 *d_partial_p);
+
+//! Get the number of blocks launched by gpu_nve_step_two()
+unsigned int gpu_nve_num_blocks(const GPUPartition& gpu_partition, unsigned int block_size);
+
+//! Kernel driver that subtracts the average momentum from the velocities of a group
+hipError_t gpu_nve_subtract_momentum(Scalar4 *d_vel,
+                                     unsigned int *d_group_members,
+                                     const GPUPartition& gpu_partition,
+                                     Scalar3 avg_p,
+                                     unsigned int block_size);
 
 //! Kernel driver for the first part of the angular NVE update (NO_SQUISH) by TwoStepNVEPU
 hipError_t gpu_nve_angular_step_one(Scalar4 *d_orientation,
@@ -61,6 +76,7 @@ hipError_t gpu_nve_angular_step_two(const Scalar4 *d_orientation,
                              const GPUPartition &gpu_partition,
                              Scalar deltaT,
                              Scalar scale,
-                             const unsigned int block_size);
+                             const unsigned int block_size,
+                             const Scalar *d_scale = NULL);
 
 #endif //__TWO_STEP_NVE_GPU_CUH__
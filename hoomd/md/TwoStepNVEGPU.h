@@ -61,6 +61,7 @@ class PYBIND11_EXPORT TwoStepNVEGPU : public TwoStepNVE
         std::unique_ptr<Autotuner> m_tuner_two; //!< Autotuner for block size (step two kernel)
         std::unique_ptr<Autotuner> m_tuner_angular_one; //!< Autotuner for block size (angular step one kernel)
         std::unique_ptr<Autotuner> m_tuner_angular_two; //!< Autotuner for block size (angular step two kernel)
+        GlobalArray<Scalar3> m_partial_p;                //!< Sums of the momenta per block of the step two kernel
     };
 
 //! Exports the TwoStepNVEGPU class to python
@@ -33,7 +33,8 @@ TwoStepNVTMTK::TwoStepNVTMTK(std::shared_ptr<SystemDefinition> sysdef,
                        Scalar tau,
                        std::shared_ptr<Variant> T,
                        const std::string& suffix)
-    : IntegrationMethodTwoStep(sysdef, group), m_thermo(thermo), m_tau(tau), m_T(T), m_exp_thermo_fac(1.0)
+    : IntegrationMethodTwoStep(sysdef, group), m_thermo(thermo), m_tau(tau), m_T(T), m_exp_thermo_fac(1.0),
+      m_have_ke_trans(false), m_ke_trans(0.0)
     {
     m_exec_conf->msg->notice(5) << "Constructing TwoStepNVTMTK" << endl;
 
@@ -121,6 +122,12 @@ void TwoStepNVTMTK::integrateStepOne(uint64_t timestep)
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    // sum the kinetic energy for the thermostat while the velocities are at hand, unless the rotational
+    // thermostat needs the thermo compute anyway
+    double ke_trans = 0.0;
 
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
@@ -139,6 +146,14 @@ void TwoStepNVTMTK::integrateStepOne(uint64_t timestep)
 
         pos += m_deltaT * v;
 
+        // ignore rigid body constituent particles in the sum, like ComputeThermo
+        if (h_body.data[j] >= MIN_FLOPPY || h_body.data[j] == h_tag.data[j])
+            {
+            ke_trans += (double)h_vel.data[j].w*((double)v.x*(double)v.x
+                                                 + (double)v.y*(double)v.y
+                                                 + (double)v.z*(double)v.z);
+            }
+
         // store updated variables
         h_vel.data[j].x = v.x;
         h_vel.data[j].y = v.y;
@@ -160,6 +175,12 @@ void TwoStepNVTMTK::integrateStepOne(uint64_t timestep)
         // wrap the particles around the box
         box.wrap(h_pos.data[j], h_image.data[j]);
         }
+
+    if (!m_aniso)
+        {
+        m_ke_trans = Scalar(0.5*ke_trans);
+        m_have_ke_trans = true;
+        }
     }
 
     // Integration of angular degrees of freedom using symplectic and
@@ -389,10 +410,30 @@ void TwoStepNVTMTK::advanceThermostat(uint64_t timestep, bool broadcast)
     Scalar& xi = v.variable[0];
     Scalar& eta = v.variable[1];
 
-    // compute the current thermodynamic properties
-    m_thermo->compute(timestep+1);
+    Scalar curr_T_trans(0.0);
+    if (m_have_ke_trans)
+        {
+        // step one already summed the kinetic energy, so there is no need for a separate pass in the thermo compute
+        Scalar ke_trans = m_ke_trans;
+        #ifdef ENABLE_MPI
+        if (m_pdata->getDomainDecomposition())
+            {
+            // sum in rank order so that the result is reproducible
+            all_reduce_sum_ordered(&ke_trans, 1, m_exec_conf->getMPICommunicator());
+            }
+        #endif
+
+        if (m_group->getTranslationalDOF() > 0)
+            curr_T_trans = Scalar(2.0)/m_group->getTranslationalDOF()*ke_trans;
+        m_have_ke_trans = false;
+        }
+    else
+        {
+        // compute the current thermodynamic properties
+        m_thermo->compute(timestep+1);
 
-    Scalar curr_T_trans = m_thermo->getTranslationalTemperature();
+        curr_T_trans = m_thermo->getTranslationalTemperature();
+        }
 
     // update the state variables Xi and eta
     Scalar xi_prime = xi + Scalar(1.0/2.0)*m_deltaT/m_tau/m_tau*(curr_T_trans/(*m_T)(timestep) - Scalar(1.0));
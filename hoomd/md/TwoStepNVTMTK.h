@@ -145,9 +145,15 @@ class PYBIND11_EXPORT TwoStepNVTMTK : public IntegrationMethodTwoStep
 
         Scalar m_exp_thermo_fac;        //!< Thermostat rescaling factor
 
+        bool m_have_ke_trans;           //!< True if step one summed the translational kinetic energy
+        Scalar m_ke_trans;              //!< Translational kinetic energy on this rank summed by step one
+
         //! advance the thermostat
         /*!\param timestep The time step
          * \param broadcast True if we should broadcast the integrator variables via MPI
+         *
+         * If step one set m_have_ke_trans, the translational temperature is computed from m_ke_trans instead of
+         * with m_thermo.
          */
         void advanceThermostat(uint64_t timestep, bool broadcast=true);
     };
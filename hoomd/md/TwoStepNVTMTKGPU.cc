@@ -55,6 +55,12 @@ TwoStepNVTMTKGPU::TwoStepNVTMTKGPU(std::shared_ptr<SystemDefinition> sysdef,
     m_tuner_two.reset(new Autotuner(valid_params, 5, 100000, "nvt_mtk_step_two", this->m_exec_conf));
     m_tuner_angular_one.reset(new Autotuner(valid_params, 5, 100000, "nvt_mtk_angular_one", this->m_exec_conf));
     m_tuner_angular_two.reset(new Autotuner(valid_params, 5, 100000, "nvt_mtk_angular_two", this->m_exec_conf));
+
+    GlobalVector<Scalar>(m_exec_conf).swap(m_partial_sum2K);
+    TAG_ALLOCATION(m_partial_sum2K);
+
+    GlobalArray<Scalar>(1, m_exec_conf).swap(m_sum2K);
+    TAG_ALLOCATION(m_sum2K);
     }
 
 /*! \param timestep Current time step
@@ -76,12 +82,45 @@ void TwoStepNVTMTKGPU::integrateStepOne(uint64_t timestep)
         m_prof->push(m_exec_conf, "NVT MTK step 1");
         }
 
+    // the rotational thermostat needs the thermo compute anyway, otherwise sum the kinetic energy in the kernel
+    const bool compute_sum2K = !m_aniso;
+
+    if (compute_sum2K)
+        {
+        // one partial sum per block of the smallest block size on each GPU
+        unsigned int warp_size = m_exec_conf->dev_prop.warpSize;
+        unsigned int ngpu = m_exec_conf->getNumActiveGPUs();
+        unsigned int max_partial = group_size/warp_size + ngpu;
+        if (m_partial_sum2K.size() < max_partial)
+            {
+            m_partial_sum2K.resize(max_partial);
+
+            #if defined(__HIP_PLATFORM_NVCC__)
+            if (m_exec_conf->allConcurrentManagedAccess())
+                {
+                auto& gpu_map = m_exec_conf->getGPUIds();
+                for (unsigned int idev = 0; idev < ngpu; ++idev)
+                    {
+                    cudaMemAdvise(m_partial_sum2K.get(), sizeof(Scalar)*m_partial_sum2K.getNumElements(),
+                        cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+                    }
+                CHECK_CUDA_ERROR();
+                }
+            #endif
+            }
+        }
+
+    unsigned int num_partial = 0;
+
         {
         // access all the needed data
         ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
         ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
         ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
         ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_partial_sum2K(m_partial_sum2K, access_location::device, access_mode::overwrite);
 
         BoxDim box = m_pdata->getBox();
         ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
@@ -100,13 +139,37 @@ void TwoStepNVTMTKGPU::integrateStepOne(uint64_t timestep)
                          m_tuner_one->getParam(),
                          m_exp_thermo_fac,
                          m_deltaT,
-                         m_group->getGPUPartition());
+                         m_group->getGPUPartition(),
+                         d_body.data,
+                         d_tag.data,
+                         compute_sum2K ? d_partial_sum2K.data : NULL,
+                         num_partial);
 
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
             CHECK_CUDA_ERROR();
         m_tuner_one->end();
 
         m_exec_conf->endMultiGPU();
+
+        if (compute_sum2K)
+            {
+            // finish the sum on the first GPU
+            ArrayHandle<Scalar> d_sum2K(m_sum2K, access_location::device, access_mode::overwrite);
+            gpu_nvt_mtk_reduce_sum2K(d_sum2K.data,
+                                     d_partial_sum2K.data,
+                                     num_partial,
+                                     512);
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+        }
+
+    if (compute_sum2K)
+        {
+        ArrayHandle<Scalar> h_sum2K(m_sum2K, access_location::host, access_mode::read);
+        m_ke_trans = Scalar(0.5)*h_sum2K.data[0];
+        m_have_ke_trans = true;
         }
 
     if (m_aniso)
@@ -6,6 +6,7 @@
 // Maintainer: jglaser
 
 #include "TwoStepNVTMTKGPU.cuh"
+#include "hoomd/WarpTools.cuh"
 
 #include <assert.h>
 
@@ -13,6 +14,36 @@
     \brief Defines GPU kernel code for NVT integration on the GPU. Used by TwoStepNVTGPU.
 */
 
+//! Sum a value over a thread block
+/*! \param value Value of this thread to sum
+    \param sdata Shared memory for one value per warp
+    \returns The sum of the block in thread 0
+
+    The value is first summed within each warp using shuffles. The first thread of each warp writes the sum of
+    its warp to shared memory, and the first warp then sums those with shuffles again. The block size must be a
+    multiple of the warp size.
+*/
+__device__ inline Scalar nvt_mtk_block_sum(Scalar value, Scalar *sdata)
+    {
+    hoomd::detail::WarpReduce<Scalar> reducer;
+    const unsigned int lane = threadIdx.x % warpSize;
+    const unsigned int warp = threadIdx.x / warpSize;
+    const unsigned int num_warps = blockDim.x / warpSize;
+
+    const Scalar warp_sum = reducer.Sum(value);
+    if (lane == 0)
+        sdata[warp] = warp_sum;
+    __syncthreads();
+
+    Scalar sum(0.0);
+    if (warp == 0)
+        {
+        sum = (lane < num_warps) ? sdata[lane] : Scalar(0.0);
+        sum = reducer.Sum(sum);
+        }
+    return sum;
+    }
+
 //! Takes the first 1/2 step forward in the NVT integration step
 /*! \param d_pos array of particle positions
     \param d_vel array of particle velocities
@@ -24,8 +55,14 @@
     \param exp_fac Velocity rescaling factor from thermostat
     \param deltaT Amount of real time to step forward in one time step
     \param offset The offset of this GPU into the list of particles
+    \param d_body Particle body id
+    \param d_tag Particle tag
+    \param d_partial_sum2K Partial sums of m*v^2 written per block, or NULL to skip the sum
+    \param block_offset Offset of this GPU in the array of partial sums
 
-    Take the first half step forward in the NVT integration.
+    Take the first half step forward in the NVT integration. When \a d_partial_sum2K is set, each block also sums
+    m*v^2 of the updated velocities for the thermostat, ignoring rigid body constituent particles like
+    ComputeThermo does. The kernel must then be launched with one Scalar of shared memory per warp.
 
     See gpu_nve_step_one_kernel() for some performance notes on how to handle the group data reads efficiently.
 */
@@ -39,11 +76,18 @@ void gpu_nvt_mtk_step_one_kernel(Scalar4 *d_pos,
                              BoxDim box,
                              Scalar exp_fac,
                              Scalar deltaT,
-                             unsigned int offset)
+                             unsigned int offset,
+                             const unsigned int *d_body,
+                             const unsigned int *d_tag,
+                             Scalar *d_partial_sum2K,
+                             unsigned int block_offset)
     {
+    HIP_DYNAMIC_SHARED( Scalar, sdata)
+
     // determine which particle this thread works on
     int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
+    Scalar mv2(0.0);
     if (group_idx < work_size)
         {
         unsigned int idx = d_group_members[group_idx + offset];
@@ -74,7 +118,45 @@ void gpu_nvt_mtk_step_one_kernel(Scalar4 *d_pos,
         d_pos[idx] = make_scalar4(pos.x, pos.y, pos.z, postype.w);
         d_vel[idx] = make_scalar4(vel.x, vel.y, vel.z, velmass.w);
         d_image[idx] = image;
+
+        // ignore rigid body constituent particles in the sum
+        if (d_partial_sum2K != NULL)
+            {
+            unsigned int body = d_body[idx];
+            unsigned int tag = d_tag[idx];
+            if (body >= MIN_FLOPPY || body == tag)
+                mv2 = velmass.w * dot(vel, vel);
+            }
         }
+
+    if (d_partial_sum2K != NULL)
+        {
+        Scalar sum = nvt_mtk_block_sum(mv2, sdata);
+        if (threadIdx.x == 0)
+            d_partial_sum2K[block_offset + blockIdx.x] = sum;
+        }
+    }
+
+//! Sum the partial sums of m*v^2 written by gpu_nvt_mtk_step_one_kernel()
+/*! \param d_sum2K Written with the total sum of m*v^2
+    \param d_partial_sum2K Partial sums of m*v^2
+    \param num_partial Number of partial sums
+
+    Must be launched with a single block and one Scalar of shared memory per warp.
+*/
+__global__ void gpu_nvt_mtk_reduce_sum2K_kernel(Scalar *d_sum2K,
+                                                const Scalar *d_partial_sum2K,
+                                                unsigned int num_partial)
+    {
+    HIP_DYNAMIC_SHARED( Scalar, sdata)
+
+    Scalar sum(0.0);
+    for (unsigned int i = threadIdx.x; i < num_partial; i += blockDim.x)
+        sum += d_partial_sum2K[i];
+
+    sum = nvt_mtk_block_sum(sum, sdata);
+    if (threadIdx.x == 0)
+        *d_sum2K = sum;
     }
 
 /*! \param d_pos array of particle positions
@@ -87,6 +169,13 @@ void gpu_nvt_mtk_step_one_kernel(Scalar4 *d_pos,
     \param block_size Size of the block to run
     \param exp_fac Thermostat rescaling factor
     \param deltaT Amount of real time to step forward in one time step
+    \param gpu_partition Load balancing info for multi-GPU execution
+    \param d_body Particle body id
+    \param d_tag Particle tag
+    \param d_partial_sum2K Partial sums of m*v^2, one per block of every GPU, or NULL to skip the sum
+    \param num_partial Set to the number of partial sums written
+
+    The size of \a d_partial_sum2K must be at least group_size/warp_size + 1 per active GPU.
 */
 hipError_t gpu_nvt_mtk_step_one(Scalar4 *d_pos,
                              Scalar4 *d_vel,
@@ -98,7 +187,11 @@ hipError_t gpu_nvt_mtk_step_one(Scalar4 *d_pos,
                              unsigned int block_size,
                              Scalar exp_fac,
                              Scalar deltaT,
-                             const GPUPartition& gpu_partition)
+                             const GPUPartition& gpu_partition,
+                             const unsigned int *d_body,
+                             const unsigned int *d_tag,
+                             Scalar *d_partial_sum2K,
+                             unsigned int& num_partial)
     {
     static unsigned int max_block_size = UINT_MAX;
     if (max_block_size == UINT_MAX)
@@ -110,6 +203,11 @@ hipError_t gpu_nvt_mtk_step_one(Scalar4 *d_pos,
 
     unsigned int run_block_size = min(block_size, max_block_size);
 
+    // one value per warp for the block sum
+    unsigned int shared_bytes = (d_partial_sum2K != NULL) ? (run_block_size/32 + 1)*sizeof(Scalar) : 0;
+
+    num_partial = 0;
+
     // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
     for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
         {
@@ -122,7 +220,7 @@ hipError_t gpu_nvt_mtk_step_one(Scalar4 *d_pos,
         dim3 threads(run_block_size, 1, 1);
 
         // run the kernel, starting with offset range.first
-        hipLaunchKernelGGL((gpu_nvt_mtk_step_one_kernel), dim3(grid), dim3(threads ), 0, 0, d_pos,
+        hipLaunchKernelGGL((gpu_nvt_mtk_step_one_kernel), dim3(grid), dim3(threads ), shared_bytes, 0, d_pos,
                              d_vel,
                              d_accel,
                              d_image,
@@ -131,9 +229,44 @@ hipError_t gpu_nvt_mtk_step_one(Scalar4 *d_pos,
                              box,
                              exp_fac,
                              deltaT,
-                             range.first);
+                             range.first,
+                             d_body,
+                             d_tag,
+                             d_partial_sum2K,
+                             num_partial);
+
+        num_partial += grid.x;
+        }
+
+    return hipSuccess;
+    }
+
+/*! \param d_sum2K Written with the total sum of m*v^2
+    \param d_partial_sum2K Partial sums of m*v^2 written by gpu_nvt_mtk_step_one()
+    \param num_partial Number of partial sums
+    \param block_size Size of the block to run
+*/
+hipError_t gpu_nvt_mtk_reduce_sum2K(Scalar *d_sum2K,
+                                    const Scalar *d_partial_sum2K,
+                                    unsigned int num_partial,
+                                    unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        hipFuncAttributes attr;
+        hipFuncGetAttributes(&attr, (const void *)gpu_nvt_mtk_reduce_sum2K_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
         }
 
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    hipLaunchKernelGGL((gpu_nvt_mtk_reduce_sum2K_kernel), dim3(1), dim3(run_block_size),
+                       (run_block_size/32 + 1)*sizeof(Scalar), 0,
+                       d_sum2K,
+                       d_partial_sum2K,
+                       num_partial);
+
     return hipSuccess;
     }
 
@@ -20,13 +20,16 @@
 #include <pybind11/pybind11.h>
 
 #include "hoomd/Autotuner.h"
+#include "hoomd/GlobalArray.h"
 
 //! Integrates part of the system forward in two steps in the NVT ensemble on the GPU
 /*! Implements Nose-Hoover NVT integration through the IntegrationMethodTwoStep interface, runs on the GPU
 
     In order to compute efficiently and limit the number of kernel launches integrateStepOne() performs a first
     pass reduction on the sum of m*v^2 and stores the partial reductions. A second kernel is then launched to reduce
-    those to a final \a sum2K, which is a scalar but stored in a GPUArray for convenience.
+    those to a final \a sum2K, which is a scalar but stored in a GPUArray for convenience. The thermostat uses this
+    sum instead of a separate pass over the particles in the thermo compute, unless it also thermalizes the
+    rotational degrees of freedom.
 
     \ingroup updaters
 */
@@ -70,6 +73,9 @@ class PYBIND11_EXPORT TwoStepNVTMTKGPU : public TwoStepNVTMTK
         std::unique_ptr<Autotuner> m_tuner_two; //!< Autotuner for block size (step two kernel)
         std::unique_ptr<Autotuner> m_tuner_angular_one; //!< Autotuner_angular for block size (angular step one kernel)
         std::unique_ptr<Autotuner> m_tuner_angular_two; //!< Autotuner_angular for block size (angular step two kernel)
+
+        GlobalVector<Scalar> m_partial_sum2K;   //!< Partial sums of m*v^2 from the step one kernel
+        GlobalArray<Scalar> m_sum2K;            //!< Total sum of m*v^2
     };
 
 //! Exports the TwoStepNVTMTKGPU class to python
@@ -0,0 +1,210 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file UpdaterReplicaExchange.cc
+    \brief Defines the UpdaterReplicaExchange class
+*/
+
+#include "UpdaterReplicaExchange.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/RNGIdentifiers.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <pybind11/stl.h>
+
+#include <math.h>
+#include <stdexcept>
+
+using namespace std;
+using namespace hoomd;
+namespace py = pybind11;
+
+/*! \param sysdef System to run the replica on
+    \param thermo Compute that evaluates the potential energy of the whole system
+    \param kT Temperature set point used by the integration method, modified on accepted swaps
+    \param temperatures Temperature ladder, one entry per partition
+*/
+UpdaterReplicaExchange::UpdaterReplicaExchange(std::shared_ptr<SystemDefinition> sysdef,
+                                               std::shared_ptr<ComputeThermo> thermo,
+                                               std::shared_ptr<VariantConstant> kT,
+                                               const std::vector<Scalar>& temperatures)
+    : Updater(sysdef), m_thermo(thermo), m_kT(kT), m_temperatures(temperatures), m_index(0), m_n_calls(0),
+      m_n_attempts(0), m_n_accepted(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing UpdaterReplicaExchange" << endl;
+
+    assert(m_thermo);
+    assert(m_kT);
+
+    unsigned int n_partitions = m_exec_conf->getNPartitions();
+    if (m_temperatures.size() != n_partitions)
+        {
+        m_exec_conf->msg->error() << "update.ReplicaExchange: " << m_temperatures.size()
+                                  << " temperatures given for " << n_partitions << " partitions" << endl;
+        throw runtime_error("Error initializing UpdaterReplicaExchange");
+        }
+
+    for (auto T : m_temperatures)
+        {
+        if (!(T > Scalar(0.0)))
+            {
+            m_exec_conf->msg->error() << "update.ReplicaExchange: temperatures must be positive" << endl;
+            throw runtime_error("Error initializing UpdaterReplicaExchange");
+            }
+        }
+
+    // partitions start at the temperature with the same index
+    m_index = m_exec_conf->getPartition();
+    m_kT->setValue(m_temperatures[m_index]);
+
+#ifdef ENABLE_MPI
+    // the root ranks of all partitions form their own communicator, ordered by partition
+    int color = m_exec_conf->isRoot() ? 0 : MPI_UNDEFINED;
+    MPI_Comm_split(m_exec_conf->getHOOMDWorldMPICommunicator(), color, m_exec_conf->getPartition(), &m_roots_comm);
+#endif
+    }
+
+UpdaterReplicaExchange::~UpdaterReplicaExchange()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying UpdaterReplicaExchange" << endl;
+
+#ifdef ENABLE_MPI
+    if (m_roots_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&m_roots_comm);
+#endif
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void UpdaterReplicaExchange::update(uint64_t timestep)
+    {
+#ifdef ENABLE_MPI
+    unsigned int n_partitions = m_exec_conf->getNPartitions();
+    if (n_partitions < 2)
+        return;
+
+    // all ranks of the partition take part in the reduction of the potential energy
+    m_thermo->compute(timestep);
+    Scalar energy = m_thermo->getPotentialEnergy();
+
+    if (m_prof) m_prof->push("ReplicaExchange");
+
+    unsigned int old_index = m_index;
+    unsigned int attempted = 0;
+
+    if (m_exec_conf->isRoot())
+        {
+        std::vector<Scalar> all_energy(n_partitions);
+        std::vector<unsigned int> all_index(n_partitions);
+        std::vector<unsigned int> all_attempted(n_partitions, 0);
+
+        MPI_Gather(&energy, 1, MPI_HOOMD_SCALAR, all_energy.data(), 1, MPI_HOOMD_SCALAR, 0, m_roots_comm);
+        MPI_Gather(&m_index, 1, MPI_UNSIGNED, all_index.data(), 1, MPI_UNSIGNED, 0, m_roots_comm);
+
+        if (m_exec_conf->getPartition() == 0)
+            attemptSwaps(timestep, all_energy, all_index, all_attempted);
+
+        MPI_Scatter(all_index.data(), 1, MPI_UNSIGNED, &m_index, 1, MPI_UNSIGNED, 0, m_roots_comm);
+        MPI_Scatter(all_attempted.data(), 1, MPI_UNSIGNED, &attempted, 1, MPI_UNSIGNED, 0, m_roots_comm);
+        }
+
+    // distribute the outcome within the partition
+    bcast(m_index, 0, m_exec_conf->getMPICommunicator());
+    bcast(attempted, 0, m_exec_conf->getMPICommunicator());
+
+    m_n_calls++;
+    m_n_attempts += attempted;
+
+    if (m_index != old_index)
+        {
+        m_n_accepted++;
+
+        Scalar T_old = m_temperatures[old_index];
+        Scalar T_new = m_temperatures[m_index];
+        m_kT->setValue(T_new);
+        rescaleMomenta(sqrt(T_new / T_old));
+        }
+
+    if (m_prof) m_prof->pop();
+#endif
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step of the simulation
+    \param energy Potential energy of the replica in each partition
+    \param index Temperature index of each partition, updated in place
+    \param attempted Set to 1 for every partition that took part in a swap attempt
+
+    Swaps are attempted between the partitions holding temperatures (k, k+1) for all even k on even calls, and all odd
+    k on odd calls, so that no replica takes part in two attempts in the same round.
+*/
+void UpdaterReplicaExchange::attemptSwaps(uint64_t timestep,
+                                          const std::vector<Scalar>& energy,
+                                          std::vector<unsigned int>& index,
+                                          std::vector<unsigned int>& attempted)
+    {
+    unsigned int n = (unsigned int)m_temperatures.size();
+
+    // invert the assignment to find the partition holding each temperature
+    std::vector<unsigned int> partition(n);
+    for (unsigned int p = 0; p < n; p++)
+        partition[index[p]] = p;
+
+    for (unsigned int k = m_n_calls % 2; k + 1 < n; k += 2)
+        {
+        unsigned int a = partition[k];
+        unsigned int b = partition[k+1];
+
+        Scalar delta = (Scalar(1.0)/m_temperatures[k] - Scalar(1.0)/m_temperatures[k+1]) * (energy[a] - energy[b]);
+
+        RandomGenerator rng(hoomd::Seed(RNGIdentifier::UpdaterReplicaExchange, timestep, m_sysdef->getSeed()),
+                            hoomd::Counter(k));
+
+        attempted[a] = 1;
+        attempted[b] = 1;
+
+        if (delta >= Scalar(0.0) || hoomd::detail::generate_canonical<Scalar>(rng) < fast::exp(delta))
+            {
+            index[a] = k+1;
+            index[b] = k;
+            }
+        }
+    }
+#endif
+
+/*! \param fraction Factor to scale the velocities and angular momenta by
+*/
+void UpdaterReplicaExchange::rescaleMomenta(Scalar fraction)
+    {
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        h_vel.data[i].x *= fraction;
+        h_vel.data[i].y *= fraction;
+        h_vel.data[i].z *= fraction;
+
+        h_angmom.data[i].x *= fraction;
+        h_angmom.data[i].y *= fraction;
+        h_angmom.data[i].z *= fraction;
+        h_angmom.data[i].w *= fraction;
+        }
+    }
+
+void export_UpdaterReplicaExchange(py::module& m)
+    {
+    py::class_<UpdaterReplicaExchange, Updater, std::shared_ptr<UpdaterReplicaExchange> >(m, "UpdaterReplicaExchange")
+        .def(py::init< std::shared_ptr<SystemDefinition>,
+                       std::shared_ptr<ComputeThermo>,
+                       std::shared_ptr<VariantConstant>,
+                       const std::vector<Scalar>& >())
+        .def_property_readonly("temperature_index", &UpdaterReplicaExchange::getTemperatureIndex)
+        .def_property_readonly("temperatures", &UpdaterReplicaExchange::getTemperatures)
+        .def_property_readonly("swap_attempts", &UpdaterReplicaExchange::getSwapAttempts)
+        .def_property_readonly("swaps_accepted", &UpdaterReplicaExchange::getSwapsAccepted)
+        ;
+    }
@@ -0,0 +1,105 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file UpdaterReplicaExchange.h
+    \brief Declares an updater that exchanges temperatures between MPI partitions
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/Updater.h"
+#include "hoomd/Variant.h"
+#include "ComputeThermo.h"
+
+#include <memory>
+#include <vector>
+#include <pybind11/pybind11.h>
+
+#ifndef __UPDATER_REPLICA_EXCHANGE_H__
+#define __UPDATER_REPLICA_EXCHANGE_H__
+
+//! Parallel tempering between MPI partitions
+/*! Every partition runs one replica of the system. The replicas are assigned a temperature from the list given at
+    construction, initially in partition order. When the updater runs, the root rank of every partition computes the
+    potential energy of its replica and the roots of all partitions gather (energy, temperature index) pairs on the
+    root of partition 0. That rank attempts swaps between replicas at adjacent temperatures, alternating between even
+    and odd pairs on subsequent calls, with the Metropolis acceptance probability
+
+    \f$ \min\left(1, \exp\left[(\beta_i - \beta_j)(U_i - U_j)\right]\right) \f$
+
+    and scatters the new temperature indices back. Only scalars are communicated, configurations never move between
+    partitions.
+
+    On acceptance, the updater sets the value of the temperature variant shared with the integration method and rescales
+    the particle velocities and angular momenta by \f$ \sqrt{T_\mathrm{new} / T_\mathrm{old}} \f$.
+
+    Without MPI, or with a single partition, update() is a no-op.
+
+    \ingroup updaters
+*/
+class PYBIND11_EXPORT UpdaterReplicaExchange : public Updater
+    {
+    public:
+        //! Constructor
+        UpdaterReplicaExchange(std::shared_ptr<SystemDefinition> sysdef,
+                               std::shared_ptr<ComputeThermo> thermo,
+                               std::shared_ptr<VariantConstant> kT,
+                               const std::vector<Scalar>& temperatures);
+        virtual ~UpdaterReplicaExchange();
+
+        //! Attempt temperature swaps
+        virtual void update(uint64_t timestep);
+
+        //! Get the index of the temperature currently assigned to this partition
+        unsigned int getTemperatureIndex()
+            {
+            return m_index;
+            }
+
+        //! Get the list of temperatures
+        const std::vector<Scalar>& getTemperatures()
+            {
+            return m_temperatures;
+            }
+
+        //! Get the number of swaps this partition's replica took part in
+        uint64_t getSwapAttempts()
+            {
+            return m_n_attempts;
+            }
+
+        //! Get the number of accepted swaps of this partition's replica
+        uint64_t getSwapsAccepted()
+            {
+            return m_n_accepted;
+            }
+
+    protected:
+        std::shared_ptr<ComputeThermo> m_thermo;    //!< Computes the potential energy
+        std::shared_ptr<VariantConstant> m_kT;      //!< Temperature set point shared with the integration method
+        std::vector<Scalar> m_temperatures;         //!< Temperature ladder
+        unsigned int m_index;                       //!< Temperature index assigned to this partition
+        unsigned int m_n_calls;                     //!< Number of exchange rounds, selects even or odd pairs
+        uint64_t m_n_attempts;                      //!< Number of attempted swaps involving this partition
+        uint64_t m_n_accepted;                      //!< Number of accepted swaps involving this partition
+
+#ifdef ENABLE_MPI
+        MPI_Comm m_roots_comm;                      //!< Communicator between the partition roots
+
+        //! Decide on swaps given the energies and temperature indices of all partitions (partition 0 root only)
+        void attemptSwaps(uint64_t timestep,
+                          const std::vector<Scalar>& energy,
+                          std::vector<unsigned int>& index,
+                          std::vector<unsigned int>& attempted);
+#endif
+
+        //! Rescale particle velocities and angular momenta
+        void rescaleMomenta(Scalar fraction);
+    };
+
+//! Export the UpdaterReplicaExchange to python
+void export_UpdaterReplicaExchange(pybind11::module& m);
+
+#endif
@@ -0,0 +1,108 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __VELOCITY_VERLET_STEP_ONE_H__
+#define __VELOCITY_VERLET_STEP_ONE_H__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "PostStepModifiers.h"
+
+/*! \file VelocityVerletStepOne.h
+    \brief Defines the VelocityVerletStepOne struct
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef __HIPCC__
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Parameters of the translational first step of velocity verlet for one integration method
+/*! TwoStepNVE and TwoStepLangevin share the same first step: the particles drift with their current velocity and
+    acceleration and the velocities advance by half a step. Methods that report their parameters in
+    IntegrationMethodTwoStep::getVelocityVerletStepOne() are advanced together by IntegratorTwoStep in a single pass
+    over the particle data, which looks up the parameters of each particle by the index of its method.
+
+    The struct is plain data so that a table of them can be copied to the GPU.
+*/
+struct VelocityVerletStepOne
+    {
+    bool zero_force;                //!< True if the accelerations are ignored
+    bool limit;                     //!< True if the displacement is limited to \a limit_val
+    Scalar limit_val;               //!< Maximum displacement in one step
+    PostStepModifiers modifiers;    //!< Constraints applied to each particle
+
+    //! Default constructor, plain velocity verlet
+    VelocityVerletStepOne()
+        : zero_force(false), limit(false), limit_val(1.0)
+        {
+        }
+
+    //! Advance a single particle
+    /*! \param postype Position and type of the particle
+        \param velmass Velocity and mass of the particle
+        \param accel Acceleration of the particle
+        \param image Image of the particle
+        \param box Box to wrap the particle back into
+        \param deltaT Time step size
+        \returns The squared displacement of the particle
+
+        r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2 and v(t+deltaT/2) = v(t) + (1/2)a*deltaT, with the same
+        order of operations as TwoStepNVE::integrateStepOne().
+    */
+    DEVICE Scalar apply(Scalar4& postype,
+                        Scalar4& velmass,
+                        Scalar3 accel,
+                        int3& image,
+                        const BoxDim& box,
+                        Scalar deltaT) const
+        {
+        if (zero_force)
+            accel = make_scalar3(0.0, 0.0, 0.0);
+
+        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+        Scalar3 vel = make_scalar3(velmass.x, velmass.y, velmass.z);
+
+        Scalar3 dx = vel*deltaT + Scalar(1.0/2.0)*accel*deltaT*deltaT;
+
+        // limit the movement of the particles
+        if (limit)
+            {
+            Scalar len = slow::sqrt(dot(dx, dx));
+            if (len > limit_val)
+                dx = dx / len * limit_val;
+            }
+
+        const bool constrain = modifiers.hasParticleModifiers();
+        if (constrain)
+            {
+            Scalar3 r_old = pos;
+            modifiers.constrainDirection(dx);
+            pos += dx;
+            modifiers.constrainPosition(pos);
+            dx = pos - r_old;
+            }
+        else
+            {
+            pos += dx;
+            }
+
+        vel += Scalar(1.0/2.0)*accel*deltaT;
+
+        if (constrain)
+            modifiers.constrainVelocity(pos, vel);
+
+        // particles may have been moved slightly outside the box, wrap them back into place
+        box.wrap(pos, image);
+
+        postype = make_scalar4(pos.x, pos.y, pos.z, postype.w);
+        velmass = make_scalar4(vel.x, vel.y, vel.z, velmass.w);
+
+        return dot(dx, dx);
+        }
+    };
+
+#endif // __VELOCITY_VERLET_STEP_ONE_H__
@@ -19,6 +19,7 @@ from hoomd.md import improper
 from hoomd.md.integrate import Integrator
 from hoomd.md import nlist
 from hoomd.md import pair
+from hoomd.md import tune
 from hoomd.md import update
 from hoomd.md import wall
 from hoomd.md import special_pair
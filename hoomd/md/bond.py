@@ -148,6 +148,7 @@ class table(force._force):
     Args:
         width (int): Number of points to use to interpolate V and F
         name (str): Name of the potential instance
+        interpolation (str): ``'linear'`` or ``'hermite'`` interpolation between the grid points
 
     :py:class:`table` specifies that a tabulated bond potential should be applied between the two particles in each
     defined bond.
@@ -172,7 +173,9 @@ class table(force._force):
     specified range.  On the CPU, this will throw an error.  On the GPU, this will throw an error if GPU error checking is enabled.
 
     :math:`F_{\mathrm{user}}(r)` and :math:`V_{\mathrm{user}}(r)` are evaluated on *width* grid points between
-    :math:`r_{\mathrm{min}}` and :math:`r_{\mathrm{max}}`. Values are interpolated linearly between grid points.
+    :math:`r_{\mathrm{min}}` and :math:`r_{\mathrm{max}}`. Values are interpolated linearly between grid points,
+    or with a cubic Hermite spline through the values and derivatives when *interpolation* is ``'hermite'``, which
+    reaches the same accuracy with a much smaller *width*.
     For correctness, you must specify the force defined by: :math:`F = -\frac{\partial V}{\partial r}`
 
     The following coefficients must be set for each bond type:
@@ -217,7 +220,7 @@ class table(force._force):
         Ensure that ``rmin`` and ``rmax`` cover the range of possible bond lengths. When gpu error checking is on, a error will
         be thrown if a bond distance is outside than this range.
     """
-    def __init__(self, width, name=None):
+    def __init__(self, width, name=None, interpolation='linear'):
 
         # initialize the base class
         force._force.__init__(self, name);
@@ -229,6 +232,8 @@ class table(force._force):
         else:
             self.cpp_force = _md.BondTablePotentialGPU(hoomd.context.current.system_definition, int(width), self.name);
 
+        self.cpp_force.setInterpolation(interpolation);
+
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
 
         # setup the coefficients matrix
@@ -68,6 +68,10 @@ class pppm(force._force):
     .. important::
         In MPI simulations, the number of grid point along every dimensions must be a power of two.
 
+    Note:
+        The charge mesh and its Fourier transforms are stored and transformed in single precision, also in double
+        precision builds. The forces, energy and virial are accumulated in the precision of the build.
+
     Example::
 
         charged = group.charged();
@@ -110,7 +114,7 @@ class pppm(force._force):
         force._force.enable(self);
         self.ewald.enable();
 
-    def set_params(self, Nx, Ny, Nz, order, rcut, alpha = 0.0):
+    def set_params(self, Nx, Ny, Nz, order, rcut, alpha = 0.0, pencil_ranks = None, overlap = False, box_change_tol = 0.0, cuda_aware_mpi = None):
         """ Sets PPPM parameters.
 
         Args:
@@ -121,6 +125,25 @@ class pppm(force._force):
             rcut  (float): Cutoff for the short-ranged part of the electrostatics calculation
             alpha (float, **optional**): Debye screening parameter (in units 1/distance)
                 .. versionadded:: 2.1
+            pencil_ranks (int, **optional**): Number of MPI ranks that perform the distributed FFT on a pencil
+                decomposition of the mesh (0 for all ranks). By default, the FFT follows the domain decomposition.
+                The pencil decomposition is independent of the domain decomposition, which reduces the communication
+                of the FFT at large numbers of ranks. It is only available on the CPU.
+                .. versionadded:: 3.0
+            overlap (bool, **optional**): Set to True to overlap the distributed FFT with the short-range part of the
+                electrostatics. The charge mesh is sent to the ranks of the pencil grid while the short-range forces
+                are computed, and the long-range forces are completed afterwards. Requires ``pencil_ranks``.
+                .. versionadded:: 3.0
+            box_change_tol (float, **optional**): Largest relative change of a box length (or change of a tilt
+                factor) since the influence function was last computed in full, up to which the influence function
+                is rescaled to the new box instead of being computed again. Set to a small value such as 0.01 for
+                constant pressure simulations. By default, it is computed in full after every box change.
+                .. versionadded:: 3.0
+            cuda_aware_mpi (bool, **optional**): Set to True to pass device buffers directly to MPI in the transposes
+                of the distributed FFT on the GPU, or to False to stage them through host memory. Requires an MPI
+                library with CUDA support. By default, device buffers are passed when HOOMD was built with
+                ``ENABLE_MPI_CUDA``.
+                .. versionadded:: 3.0
 
         Examples::
 
@@ -192,6 +215,22 @@ class pppm(force._force):
         # set the parameters for the appropriate type
         self.cpp_force.setParams(Nx, Ny, Nz, order, kappa, rcut, alpha);
 
+        if pencil_ranks is not None and hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+            hoomd.context.current.device.cpp_msg.warning("charge.pppm: pencil_ranks is ignored on the GPU\n");
+        self.cpp_force.setPencilFFT(pencil_ranks is not None, 0 if pencil_ranks is None else int(pencil_ranks));
+
+        if overlap and pencil_ranks is None:
+            hoomd.context.current.device.cpp_msg.warning("charge.pppm: overlap requires pencil_ranks, ignoring\n");
+        self.cpp_force.setOverlap(bool(overlap) and pencil_ranks is not None);
+
+        self.cpp_force.setBoxChangeTolerance(float(box_change_tol));
+
+        if cuda_aware_mpi is not None:
+            if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+                self.cpp_force.setCUDAAwareMPI(bool(cuda_aware_mpi));
+            else:
+                hoomd.context.current.device.cpp_msg.warning("charge.pppm: cuda_aware_mpi is ignored on the CPU\n");
+
     def update_coeffs(self):
         if not self.params_set:
             hoomd.context.current.device.cpp_msg.error("Coefficients for PPPM are not set. Call set_coeff prior to run()\n");
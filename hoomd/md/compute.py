@@ -7,9 +7,14 @@
 
 from hoomd import _hoomd
 from hoomd.md import _md
-from hoomd.operation import Compute
+from hoomd.operation import Compute, Writer
 from hoomd.logging import log
+from hoomd.md.nlist import NList
+from hoomd.data.typeconverter import OnlyTypes
 import hoomd
+import numpy
+
+validate_nlist = OnlyTypes(NList)
 
 
 class _Thermo(Compute):
@@ -282,6 +287,380 @@ class ThermodynamicQuantities(_Thermo):
             return None
 
 
+class TimeCorrelation(Writer):
+    r"""Block averages and time correlation functions computed on the fly.
+
+    Args:
+        filter (``hoomd.filter``): Particles to sample the charge current and
+            velocities of, and to compute the thermodynamic quantities of.
+        quantities (list[str]): Names of the quantities to sample.
+        trigger (hoomd.trigger.Periodic or int): Select the timesteps to
+            sample on. An integer is the period of a periodic trigger.
+        points_per_level (int): Number of lags correlated at each level.
+        averaging (int): Number of samples averaged into one sample of the next
+            level. *points_per_level* must be a multiple of *averaging*.
+        n_levels (int): Number of levels.
+
+    `TimeCorrelation` samples each quantity at the timesteps selected by
+    *trigger*. It accumulates the mean of the samples and computes the
+    autocorrelation :math:`\langle A(0) A(t) \rangle` with a multiple tau
+    correlator: each level correlates *points_per_level* lags, then averages
+    *averaging* samples into one sample of the next level, so that the lags
+    grow geometrically. The memory and time needed grow only logarithmically
+    with the longest lag, which is
+
+    .. math::
+
+        (\mathrm{points\_per\_level} - 1) \cdot
+        \mathrm{averaging}^{\mathrm{n\_levels} - 1} \cdot \mathrm{period}
+
+    The quantities are any of the thermodynamic quantities of
+    `ThermodynamicQuantities` (``kinetic_energy``, ``potential_energy``,
+    ``pressure``, ``pressure_xy``, ...), the components of the charge current
+    :math:`\sum_i q_i \vec{v}_i` (``charge_current_x``,
+    ``charge_current_y``, ``charge_current_z``), and ``velocity``, whose
+    correlation is the velocity autocorrelation function averaged over the
+    particles :math:`\frac{1}{N} \sum_i \langle \vec{v}_i(0) \cdot
+    \vec{v}_i(t) \rangle`.
+
+    The standard error of the mean is estimated by blocking the samples
+    (Flyvbjerg and Petersen 1989), which accounts for the correlation between
+    successive samples.
+
+    Examples::
+
+        correlation = hoomd.md.compute.TimeCorrelation(
+            filter=hoomd.filter.All(),
+            quantities=['pressure_xy', 'velocity'],
+            trigger=hoomd.trigger.Periodic(10))
+        sim.operations.writers.append(correlation)
+        logger.add(correlation, quantities=['lags', 'correlation'])
+
+    Note:
+        ``velocity`` is not available with domain decomposition.
+    """
+
+    def __init__(self,
+                 filter,
+                 quantities,
+                 trigger=1,
+                 points_per_level=16,
+                 averaging=2,
+                 n_levels=16):
+        if isinstance(trigger, int):
+            trigger = hoomd.trigger.Periodic(trigger)
+        if not isinstance(trigger, hoomd.trigger.Periodic):
+            raise ValueError("TimeCorrelation requires a periodic trigger.")
+        if (averaging < 2 or points_per_level < averaging
+                or points_per_level % averaging != 0):
+            raise ValueError("points_per_level must be a multiple of "
+                             "averaging, which must be at least 2.")
+        if n_levels < 1:
+            raise ValueError("n_levels must be at least 1.")
+
+        super().__init__(trigger)
+        self._filter = filter
+        self._quantities = list(quantities)
+        self._points_per_level = points_per_level
+        self._averaging = averaging
+        self._n_levels = n_levels
+
+    def _attach(self):
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            thermo_cls = _md.ComputeThermo
+        else:
+            thermo_cls = _md.ComputeThermoGPU
+        group = self._simulation.state._get_group(self._filter)
+        thermo = thermo_cls(self._simulation.state._cpp_sys_def, group, "")
+        self._cpp_obj = _md.TimeCorrelator(self._simulation.state._cpp_sys_def,
+                                           thermo, group, self._quantities,
+                                           self._points_per_level,
+                                           self._averaging, self._n_levels)
+        super()._attach()
+
+    @property
+    def filter(self):
+        """``hoomd.filter``: Particles sampled (read only)."""
+        return self._filter
+
+    @property
+    def quantities(self):
+        """list[str]: Names of the sampled quantities (read only)."""
+        return list(self._quantities)
+
+    @log(category='sequence')
+    def lags(self):
+        """(*N_lags*, ) `numpy.ndarray` of ``numpy.float64``: Lags of the
+        correlation functions in time steps."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.lags) * self.trigger.period
+        else:
+            return None
+
+    @log(category='sequence')
+    def correlation(self):
+        """(*N_quantities*, *N_lags*) `numpy.ndarray` of ``numpy.float64``:
+        Time correlation function of each quantity.
+
+        The correlation is ``nan`` at lags longer than the sampled time.
+        """
+        if self._attached:
+            return self._cpp_obj.correlation
+        else:
+            return None
+
+    @log(category='sequence')
+    def mean(self):
+        """(*N_quantities*, ) `numpy.ndarray` of ``numpy.float64``: Mean of
+        each quantity over the samples."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.mean)
+        else:
+            return None
+
+    @log(category='sequence')
+    def standard_error(self):
+        """(*N_quantities*, ) `numpy.ndarray` of ``numpy.float64``: Estimated
+        standard error of the mean of each quantity."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.standard_error)
+        else:
+            return None
+
+    @log
+    def num_samples(self):
+        """int: Number of samples taken."""
+        if self._attached:
+            return self._cpp_obj.num_samples
+        else:
+            return None
+
+    def reset(self):
+        """Remove all samples."""
+        if self._attached:
+            self._cpp_obj.reset()
+
+
+class RDF(Writer):
+    r"""Radial distribution function computed on the fly.
+
+    Args:
+        nlist (`hoomd.md.nlist.NList`): Neighbor list to find the pairs with.
+        r_max (float): Largest distance in the histogram (in distance units).
+        bins (int): Number of bins between 0 and *r_max*.
+        trigger (hoomd.trigger.Trigger or int): Select the timesteps to sample
+            on.
+
+    `RDF` accumulates a histogram of the pair distances at the timesteps
+    selected by *trigger* and normalizes it to the radial distribution function
+
+    .. math::
+
+        g(r) = \frac{V}{N^2} \left\langle \sum_i \sum_{j \ne i}
+               \delta(r - r_{ij}) \right\rangle \frac{1}{4 \pi r^2}
+
+    (:math:`2 \pi r` in 2D). The pairs are read from *nlist*, which includes
+    all pairs of types out to *r_max*, so the histogram costs a single pass
+    over the neighbor list. Share the neighbor list of a pair potential when
+    *r_max* is not much larger than its cutoff. On the GPU, the histogram
+    stays in device memory until it is read.
+
+    Note:
+        Pairs excluded from *nlist*, such as bonded pairs, are not counted.
+
+    Note:
+        In MPI simulations, the histogram is summed over the ranks when `rdf`
+        is read, so all ranks must read it together.
+
+    Examples::
+
+        rdf = hoomd.md.compute.RDF(nlist=nl, r_max=4.0, bins=200,
+                                   trigger=100)
+        sim.operations.writers.append(rdf)
+        logger.add(rdf, quantities=['bin_centers', 'rdf'])
+    """
+
+    def __init__(self, nlist, r_max, bins=100, trigger=1):
+        if r_max <= 0 or bins < 1:
+            raise ValueError("r_max and bins must be positive.")
+        super().__init__(trigger)
+        self._nlist = validate_nlist(nlist)
+        self._r_max = float(r_max)
+        self._bins = int(bins)
+
+    def _attach(self):
+        if not self._nlist._added:
+            self._nlist._add(self._simulation)
+        else:
+            if self._simulation != self._nlist._simulation:
+                raise RuntimeError("{} object's neighbor list is used in a "
+                                   "different simulation.".format(type(self)))
+        if not self._nlist._attached:
+            self._nlist._attach()
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            cls = _md.RadialDistribution
+        else:
+            cls = _md.RadialDistributionGPU
+        self._cpp_obj = cls(self._simulation.state._cpp_sys_def,
+                            self._nlist._cpp_obj, self._r_max, self._bins)
+        super()._attach()
+
+    @property
+    def _children(self):
+        return [self._nlist]
+
+    @property
+    def nlist(self):
+        """`hoomd.md.nlist.NList`: Neighbor list (read only)."""
+        return self._nlist
+
+    @property
+    def r_max(self):
+        """float: Largest distance in the histogram (read only)."""
+        return self._r_max
+
+    @property
+    def bins(self):
+        """int: Number of bins (read only)."""
+        return self._bins
+
+    @log(category='sequence')
+    def bin_centers(self):
+        """(*bins*, ) `numpy.ndarray` of ``numpy.float64``: Distance at the
+        center of each bin."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.bin_centers)
+        else:
+            return None
+
+    @log(category='sequence')
+    def rdf(self):
+        """(*bins*, ) `numpy.ndarray` of ``numpy.float64``: :math:`g(r)`
+        averaged over the sampled frames."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.rdf)
+        else:
+            return None
+
+    @log
+    def num_frames(self):
+        """int: Number of frames sampled."""
+        if self._attached:
+            return self._cpp_obj.num_frames
+        else:
+            return None
+
+    def reset(self):
+        """Remove all frames."""
+        if self._attached:
+            self._cpp_obj.reset()
+
+
+class StructureFactor(Writer):
+    r"""Static structure factor computed on the fly.
+
+    Args:
+        filter (``hoomd.filter``): Particles to compute the structure factor
+            of.
+        q_max (float): Largest wave vector magnitude (in inverse distance
+            units).
+        bins (int): Number of bins between 0 and *q_max*.
+        trigger (hoomd.trigger.Trigger or int): Select the timesteps to sample
+            on.
+
+    `StructureFactor` evaluates
+
+    .. math::
+
+        S(\vec{q}) = \frac{1}{N} \left| \sum_{j \in \mathrm{filter}}
+                      e^{i \vec{q} \cdot \vec{r}_j} \right|^2
+
+    at the wave vectors of the reciprocal lattice of the box with
+    :math:`0 < |\vec{q}| \le q_\mathrm{max}` at the timesteps selected by
+    *trigger*. `structure_factor` is the average over the frames and over the
+    wave vectors in each bin of :math:`|\vec{q}|`.
+
+    The sums are evaluated directly, which is exact and costs
+    :math:`O(N N_q)` per frame. The number of wave vectors :math:`N_q` grows
+    as :math:`(q_\mathrm{max} L)^3`, so keep *q_max* to the low :math:`q`
+    region of interest in large boxes. On the GPU, the sums are computed on
+    the device.
+
+    Examples::
+
+        sq = hoomd.md.compute.StructureFactor(filter=hoomd.filter.All(),
+                                              q_max=10.0, bins=100,
+                                              trigger=1000)
+        sim.operations.writers.append(sq)
+        logger.add(sq, quantities=['bin_centers', 'structure_factor'])
+    """
+
+    def __init__(self, filter, q_max, bins=100, trigger=1):
+        if q_max <= 0 or bins < 1:
+            raise ValueError("q_max and bins must be positive.")
+        super().__init__(trigger)
+        self._filter = filter
+        self._q_max = float(q_max)
+        self._bins = int(bins)
+
+    def _attach(self):
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            cls = _md.StructureFactor
+        else:
+            cls = _md.StructureFactorGPU
+        group = self._simulation.state._get_group(self._filter)
+        self._cpp_obj = cls(self._simulation.state._cpp_sys_def, group,
+                            self._q_max, self._bins)
+        super()._attach()
+
+    @property
+    def filter(self):
+        """``hoomd.filter``: Particles sampled (read only)."""
+        return self._filter
+
+    @property
+    def q_max(self):
+        """float: Largest wave vector magnitude (read only)."""
+        return self._q_max
+
+    @property
+    def bins(self):
+        """int: Number of bins (read only)."""
+        return self._bins
+
+    @log(category='sequence')
+    def bin_centers(self):
+        """(*bins*, ) `numpy.ndarray` of ``numpy.float64``: Wave vector
+        magnitude at the center of each bin."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.bin_centers)
+        else:
+            return None
+
+    @log(category='sequence')
+    def structure_factor(self):
+        """(*bins*, ) `numpy.ndarray` of ``numpy.float64``: :math:`S(q)`
+        averaged over the sampled frames, ``nan`` in bins with no wave
+        vectors."""
+        if self._attached:
+            return numpy.array(self._cpp_obj.structure_factor)
+        else:
+            return None
+
+    @log
+    def num_frames(self):
+        """int: Number of frames sampled."""
+        if self._attached:
+            return self._cpp_obj.num_frames
+        else:
+            return None
+
+    def reset(self):
+        """Remove all frames."""
+        if self._attached:
+            self._cpp_obj.reset()
+
+
 class thermoHMA(Compute):
     R""" Compute HMA thermodynamic properties of a group of particles.
 
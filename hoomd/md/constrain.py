@@ -248,21 +248,49 @@ class distance(ConstraintForce):
 
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name)
 
-    def set_params(self, rel_tol=None):
+    def set_params(self,
+                   rel_tol=None,
+                   solver=None,
+                   solver_tol=None,
+                   max_iterations=None):
         R"""Set parameters for constraint computation.
 
         Args:
             rel_tol (float): The relative tolerance with which constraint
                 violations are detected (**optional**).
+            solver (str): Method to solve the constraint equations, either
+                ``'direct'`` (sparse LU decomposition) or ``'iterative'``
+                (preconditioned BiCGSTAB, starting from the constraint forces
+                of the previous step) (**optional**).
+            solver_tol (float): Relative residual at which the iterative solver
+                stops on the CPU (**optional**).
+            max_iterations (int): Maximum number of iterations of the iterative
+                solver. On the GPU, the iterative solver always performs this
+                many iterations (**optional**).
+
+        On the CPU, the iterative solver falls back to the direct solver when it
+        does not converge within *max_iterations*.
 
         Example::
 
             dist = constrain.distance()
             dist.set_params(rel_tol=0.0001)
+            dist.set_params(solver='iterative', max_iterations=20)
         """
         if rel_tol is not None:
             self.cpp_force.setRelativeTolerance(float(rel_tol))
 
+        if solver is not None:
+            if solver not in ('direct', 'iterative'):
+                raise ValueError("solver must be 'direct' or 'iterative'")
+            self.cpp_force.setIterative(solver == 'iterative')
+
+        if solver_tol is not None:
+            self.cpp_force.setSolverTolerance(float(solver_tol))
+
+        if max_iterations is not None:
+            self.cpp_force.setMaxIterations(int(max_iterations))
+
 
 class rigid(ConstraintForce):
     R"""Constrain particles in rigid bodies.
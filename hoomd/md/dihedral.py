@@ -116,11 +116,14 @@ class table(force._force):
     Args:
         width (int): Number of points to use to interpolate V and T (see documentation above)
         name (str): Name of the force instance
+        interpolation (str): ``'linear'`` or ``'hermite'`` interpolation between the grid points
 
     :py:class:`table` specifies that a tabulated dihedral force should be applied to every define dihedral.
 
     :math:`T_{\mathrm{user}}(\theta)` and :math:`V_{\mathrm{user}}(\theta)` are evaluated on *width* grid points between
-    :math:`-\pi` and :math:`\pi`. Values are interpolated linearly between grid points.
+    :math:`-\pi` and :math:`\pi`. Values are interpolated linearly between grid points, or with a
+    cubic Hermite spline through the values and derivatives when *interpolation* is ``'hermite'``, which reaches the
+    same accuracy with a much smaller *width*.
     For correctness, you must specify the derivative of the potential with respect to the dihedral angle,
     defined by: :math:`T = -\frac{\partial V}{\partial \theta}`.
 
@@ -154,7 +157,7 @@ class table(force._force):
         dtable.set_from_file('polymer', 'dihedral.dat')
 
     """
-    def __init__(self, width, name=None):
+    def __init__(self, width, name=None, interpolation='linear'):
 
         # initialize the base class
         force._force.__init__(self, name);
@@ -166,6 +169,8 @@ class table(force._force):
         else:
             self.cpp_force = _md.TableDihedralForceComputeGPU(hoomd.context.current.system_definition, int(width), self.name);
 
+        self.cpp_force.setInterpolation(interpolation);
+
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
 
         # setup the coefficient matrix
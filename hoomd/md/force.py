@@ -47,10 +47,78 @@ class Force(_HOOMDBaseObject):
         Users should not instantiate this class directly.
 
     Initializes some loggable quantities.
+
+    Attributes:
+        respa_period (int): Number of time steps between evaluations of the
+            force in a multiple time step (RESPA) integration. Integrators
+            evaluate the force on time steps that are multiples of
+            ``respa_period`` and apply it as an impulse, scaled by
+            ``respa_period``. Assign expensive, slowly varying forces to the
+            outer level with a period of 2 to 4 and keep bonds and short-ranged
+            pairs on the inner level with the default period of 1. The energy and virial of the force contribute
+            to logged quantities only on the time steps it is evaluated.
+
+            .. versionadded:: 3.0
+
+        accumulate_net_force (bool): When `True`, forces that support it add
+            directly to the net force on the CPU instead of being summed from
+            their own arrays after they are computed. Their per-particle
+            forces, energies, and virials are evaluated again only when they
+            are accessed, e.g. on logging steps. Forces with a
+            ``respa_period`` other than 1 are always summed.
+
+            .. versionadded:: 3.0
     """
 
+    _respa_period = 1
+    _accumulate_net_force = False
+
     def _attach(self):
         super()._attach()
+        self._cpp_obj.setRESPAPeriod(self._respa_period)
+        self._cpp_obj.setAccumulateNetForce(self._accumulate_net_force)
+
+    @property
+    def respa_period(self):
+        return self._respa_period
+
+    @respa_period.setter
+    def respa_period(self, value):
+        value = int(value)
+        if value < 1:
+            raise ValueError("respa_period must be at least 1.")
+        self._respa_period = value
+        if self._attached:
+            self._cpp_obj.setRESPAPeriod(value)
+
+    @property
+    def accumulate_net_force(self):
+        return self._accumulate_net_force
+
+    @accumulate_net_force.setter
+    def accumulate_net_force(self, value):
+        value = bool(value)
+        self._accumulate_net_force = value
+        if self._attached:
+            self._cpp_obj.setAccumulateNetForce(value)
+
+    @log
+    def time_per_step(self):
+        """float: Wall time spent evaluating this force per time step (seconds).
+
+        The average is taken over the current or last `hoomd.Simulation.run`.
+
+        See `hoomd.operation.Operation.time_per_step`.
+
+        .. versionadded:: 3.0
+        """
+        if not self._attached:
+            return None
+        n_steps = (self._simulation.timestep
+                   - self._simulation._cpp_sys.initial_timestep)
+        if n_steps == 0:
+            return 0.0
+        return self._cpp_obj.getExecutionTime() / n_steps
 
     @log
     def energy(self):
@@ -117,6 +117,9 @@ class Integrator(_DynamicIntegrator):
             constraint forces applied to the particles in the system.
             The default value of ``None`` initializes an empty list.
 
+        concurrent_forces (bool): When `True`, launch the GPU kernels of
+            independent forces on separate streams so that they can run
+            concurrently (default `False`). Only takes effect on a single GPU.
 
     The following classes can be used as elements in `methods`
 
@@ -168,15 +171,19 @@ class Integrator(_DynamicIntegrator):
 
         constraints (List[hoomd.md.constrain.ConstraintForce]): List of
             constraint forces applied to the particles in the system.
+
+        concurrent_forces (bool): When `True`, launch the GPU kernels of
+            independent forces on separate streams.
     """
 
     def __init__(self, dt, aniso='auto', forces=None, constraints=None,
-                 methods=None):
+                 methods=None, concurrent_forces=False):
 
         super().__init__(forces, constraints, methods)
 
         self._param_dict = ParameterDict(
             dt=float(dt),
+            concurrent_forces=bool(concurrent_forces),
             aniso=OnlyFrom(['true', 'false', 'auto'],
                            preprocess=_preprocess_aniso),
             _defaults=dict(aniso="auto")
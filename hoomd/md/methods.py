@@ -932,6 +932,12 @@ class Brownian(_Method):
             The rotational drag coefficient can be set. The type of ``gamma_r``
             parameter is a tuple of three float. The type of each element of
             tuple is either positive float or zero.
+
+        active_force (hoomd.md.force.Active): When set, `Brownian` applies
+            this active force, its constraint, and its rotational diffusion in
+            the integration step instead of a separate force evaluation. The
+            active force must be in the integrator's forces and act on the same
+            filter as this method. Defaults to None.
     """
 
     def __init__(self, filter, kT, alpha=None):
@@ -955,6 +961,28 @@ class Brownian(_Method):
                                 param_dict=TypeParameterDict((1., 1., 1.), len_keys=1)
                                 )
         self._extend_typeparam([gamma,gamma_r])
+        self._active_force = None
+
+    @property
+    def active_force(self):
+        return self._active_force
+
+    @active_force.setter
+    def active_force(self, value):
+        if value is not None and not isinstance(value, hoomd.md.force.Active):
+            raise TypeError("active_force must be a hoomd.md.force.Active")
+        self._active_force = value
+        if self._attached:
+            self._set_cpp_active_force()
+
+    def _set_cpp_active_force(self):
+        if self._active_force is None:
+            self._cpp_obj.setActiveForce(None)
+        elif not self._active_force._attached:
+            raise RuntimeError(
+                "active_force must be in the forces of the integrator")
+        else:
+            self._cpp_obj.setActiveForce(self._active_force._cpp_obj)
 
     def _add(self, simulation):
         """Add the operation to a simulation.
@@ -982,6 +1010,9 @@ class Brownian(_Method):
         # Attach param_dict and typeparam_dict
         super()._attach()
 
+        if self._active_force is not None:
+            self._set_cpp_active_force()
+
 
 class Berendsen(_Method):
     r"""Applies the Berendsen thermostat.
@@ -18,6 +18,7 @@
 #include "ConstExternalFieldDipoleForceCompute.h"
 #include "ConstraintEllipsoid.h"
 #include "ConstraintSphere.h"
+#include "ExternalModelForceCompute.h"
 #include "OneDConstraint.h"
 #include "Enforce2DUpdater.h"
 #include "EvaluatorTersoff.h"
@@ -34,8 +35,10 @@
 #include "IntegratorTwoStep.h"
 #include "MolecularForceCompute.h"
 #include "NeighborListBinned.h"
+#include "NeighborListBufferTuner.h"
 #include "NeighborList.h"
 #include "NeighborListStencil.h"
+#include "NeighborListMultiBinned.h"
 #include "NeighborListTree.h"
 #include "OPLSDihedralForceCompute.h"
 #include "PotentialBond.h"
@@ -44,11 +47,14 @@
 #include "PotentialPair.h"
 #include "PotentialTersoff.h"
 #include "PPPMForceCompute.h"
+#include "RadialDistribution.h"
+#include "StructureFactor.h"
 #include "QuaternionMath.h"
 #include "TableAngleForceCompute.h"
 #include "TableDihedralForceCompute.h"
 #include "TablePotential.h"
 #include "TempRescaleUpdater.h"
+#include "TimeCorrelator.h"
 #include "TwoStepBD.h"
 #include "TwoStepBerendsen.h"
 #include "TwoStepLangevinBase.h"
@@ -58,6 +64,7 @@
 #include "TwoStepNVTMTK.h"
 #include "WallData.h"
 #include "ZeroMomentumUpdater.h"
+#include "UpdaterReplicaExchange.h"
 #include "MuellerPlatheFlow.h"
 
 // include GPU classes
@@ -74,11 +81,13 @@
 #include "FIREEnergyMinimizerGPU.h"
 #include "ForceCompositeGPU.h"
 #include "ForceDistanceConstraintGPU.h"
+#include "FusedBondedForceComputeGPU.h"
 #include "HarmonicAngleForceComputeGPU.h"
 #include "CosineSqAngleForceComputeGPU.h"
 #include "HarmonicDihedralForceComputeGPU.h"
 #include "HarmonicImproperForceComputeGPU.h"
 #include "NeighborListGPUBinned.h"
+#include "NeighborListGPUCluster.h"
 #include "NeighborListGPU.h"
 #include "NeighborListGPUStencil.h"
 #include "NeighborListGPUTree.h"
@@ -89,6 +98,8 @@
 #include "PotentialPairGPU.h"
 #include "PotentialTersoffGPU.h"
 #include "PPPMForceComputeGPU.h"
+#include "RadialDistributionGPU.h"
+#include "StructureFactorGPU.h"
 #include "TableAngleForceComputeGPU.h"
 #include "TableDihedralForceComputeGPU.h"
 #include "TablePotentialGPU.h"
@@ -218,6 +229,9 @@ PYBIND11_MODULE(_md, m)
     export_ConstExternalFieldDipoleForceCompute(m);
     export_ComputeThermo(m);
     export_ComputeThermoHMA(m);
+    export_TimeCorrelator(m);
+    export_RadialDistribution(m);
+    export_StructureFactor(m);
     export_HarmonicAngleForceCompute(m);
     export_CosineSqAngleForceCompute(m);
     export_TableAngleForceCompute(m);
@@ -226,6 +240,7 @@ PYBIND11_MODULE(_md, m)
     export_TableDihedralForceCompute(m);
     export_HarmonicImproperForceCompute(m);
     export_TablePotential(m);
+    export_ExternalModelForceCompute(m);
     export_BondTablePotential(m);
     export_PotentialPair<PotentialPairBuckingham>(m, "PotentialPairBuckingham");
     export_PotentialPair<PotentialPairLJ>(m, "PotentialPairLJ");
@@ -259,7 +274,9 @@ PYBIND11_MODULE(_md, m)
     export_PotentialSpecialPair<PotentialSpecialPairCoulomb>(m, "PotentialSpecialPairCoulomb");
     export_NeighborList(m);
     export_NeighborListBinned(m);
+    export_NeighborListBufferTuner(m);
     export_NeighborListStencil(m);
+    export_NeighborListMultiBinned(m);
     export_NeighborListTree(m);
     export_ConstraintSphere(m);
     export_OneDConstraint(m);
@@ -283,6 +300,7 @@ PYBIND11_MODULE(_md, m)
 #ifdef ENABLE_HIP
     export_NeighborListGPU(m);
     export_NeighborListGPUBinned(m);
+    export_NeighborListGPUCluster(m);
     export_NeighborListGPUStencil(m);
     export_NeighborListGPUTree(m);
     export_ForceCompositeGPU(m);
@@ -322,6 +340,7 @@ PYBIND11_MODULE(_md, m)
     export_CosineSqAngleForceComputeGPU(m);
     export_TableAngleForceComputeGPU(m);
     export_HarmonicDihedralForceComputeGPU(m);
+    export_FusedBondedForceComputeGPU(m);
     export_OPLSDihedralForceComputeGPU(m);
     export_TableDihedralForceComputeGPU(m);
     export_HarmonicImproperForceComputeGPU(m);
@@ -331,6 +350,8 @@ PYBIND11_MODULE(_md, m)
     // export_ConstExternalFieldDipoleForceComputeGPU(m);
     export_ComputeThermoGPU(m);
     export_ComputeThermoHMAGPU(m);
+    export_RadialDistributionGPU(m);
+    export_StructureFactorGPU(m);
     export_PPPMForceComputeGPU(m);
     export_ActiveForceComputeGPU(m);
     export_PotentialExternalGPU<PotentialExternalPeriodicGPU, PotentialExternalPeriodic>(m, "PotentialExternalPeriodicGPU");
@@ -349,6 +370,7 @@ PYBIND11_MODULE(_md, m)
     export_IntegrationMethodTwoStep(m);
     export_TempRescaleUpdater(m);
     export_ZeroMomentumUpdater(m);
+    export_UpdaterReplicaExchange(m);
     export_TwoStepNVE(m);
     export_TwoStepNVTMTK(m);
     export_TwoStepLangevinBase(m);
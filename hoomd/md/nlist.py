@@ -49,6 +49,24 @@ class NList(_HOOMDBaseObject):
     `check_dist` is `False`, `NList` always rebuilds after
     `rebuild_check_delay` time steps.
 
+    Set `adaptive_check` to `True` to skip the checks that cannot yet trigger
+    a rebuild. `NList` records the largest distance per time step that
+    particles moved before the recent rebuilds and waits half the predicted
+    time to move ``buffer/2`` before it starts checking again. Set
+    `tune_buffer` to `True` to tune `buffer` during the run. `NList` measures
+    the run time per step over several rebuilds for each trial `buffer` and
+    keeps the fastest. When the tuning converges, `tune_buffer` is set to
+    `False`.
+
+    Set `scaled_check` to `True` when the box deforms during the run, for
+    example with `hoomd.md.methods.NPT` or `hoomd.update.BoxResize`.
+    `NList` then measures how far particles moved from their positions at the
+    last build carried along with the box deformation (through their
+    fractional coordinates), and subtracts from the buffer the amount by which
+    the deformation may shrink the distances between particles. Isotropic,
+    anisotropic, and tilt changes of the box that are small compared to the
+    buffer then keep the neighbor list valid.
+
     .. rubric:: Exclusions
 
     Neighbor lists nominally include all particles within the specified cutoff
@@ -78,19 +96,77 @@ class NList(_HOOMDBaseObject):
     largest value that any particle's diameter will achieve (where **diameter**
     is the per particle quantity stored in the `hoomd.State`).
 
+    .. rubric:: Compressed storage
+
+    The neighbor list build reserves the same number of entries for all
+    particles of a type, sized to the particle with the most neighbors. Set
+    `compress` to `True` to pack the neighbors of all particles with exact
+    counts after every build. Pair forces then read a denser list, which helps
+    when a few particles (for example, large particles with `diameter_shift`)
+    have many more neighbors than the rest.
+
+    .. rubric:: Partial rebuilds
+
+    Set `partial_rebuild` to `True` to rebuild only the neighbors of the
+    particles near those that moved a distance ``buffer/2``, when few particles
+    did. Each particle then keeps the position at which its neighbors were last
+    found, which helps in systems where a small fast subset (such as hot
+    solvent or active particles) moves through a slow matrix. Partial rebuilds
+    are implemented by `Cell` on the CPU and require a fixed box; `compress`
+    and `sort_by_distance` disable them. The full list is rebuilt otherwise.
+
+    .. rubric:: Sorting by distance
+
+    Set `sort_by_distance` to `True` to sort the neighbors of each particle by
+    their distance after every build. A pair potential that shares the neighbor
+    list with another one that has a longer :math:`r_\mathrm{cut}` then only
+    traverses the neighbors that may come within its own cutoff before the
+    next build.
+
     Attributes:
+        adaptive_check (bool): Predict the next rebuild from the recent
+            displacements and skip the checks before it.
+
+            .. versionadded:: 3.0
+
         buffer (float): Buffer width.
         check_dist (bool): Flag to enable / disable distance checking.
+        compress (bool): Pack the neighbor list with exact counts after every
+            build.
+
+            .. versionadded:: 3.0
+
         diameter_shift (bool): Flag to enable / disable diameter shifting.
         exclusions (tuple[str]): Excludes pairs from the neighbor list, which
             excludes them from the pair potential calculation.
         max_diameter (float): The maximum diameter a particle will achieve.
+        partial_rebuild (bool): Rebuild only the neighbors of the particles
+            near those that moved too far.
+
+            .. versionadded:: 3.0
+
         rebuild_check_delay (int): How often to attempt to rebuild the neighbor
             list.
+        scaled_check (bool): Measure the displacements from the last positions
+            carried along with the box deformation.
+
+            .. versionadded:: 3.0
+
+        sort_by_distance (bool): Sort the neighbors of each particle by
+            distance after every build.
+
+            .. versionadded:: 3.0
+
+        tune_buffer (bool): Tune `buffer` to the smallest run time per step.
+
+            .. versionadded:: 3.0
     """
 
     def __init__(self, buffer, exclusions, rebuild_check_delay,
-                 diameter_shift, check_dist, max_diameter):
+                 diameter_shift, check_dist, max_diameter, compress=False,
+                 sort_by_distance=False, adaptive_check=False,
+                 tune_buffer=False, scaled_check=False,
+                 partial_rebuild=False):
 
         validate_exclusions = OnlyFrom(
             ['bond', 'angle', 'constraint', 'dihedral', 'special_pair',
@@ -103,6 +179,12 @@ class NList(_HOOMDBaseObject):
                                check_dist=bool(check_dist),
                                diameter_shift=bool(diameter_shift),
                                max_diameter=float(max_diameter),
+                               compress=bool(compress),
+                               sort_by_distance=bool(sort_by_distance),
+                               adaptive_check=bool(adaptive_check),
+                               tune_buffer=bool(tune_buffer),
+                               scaled_check=bool(scaled_check),
+                               partial_rebuild=bool(partial_rebuild),
                                _defaults={'exclusions': exclusions}
                                )
         self._param_dict.update(params)
@@ -119,6 +201,24 @@ class NList(_HOOMDBaseObject):
         else:
             return self._cpp_obj.getSmallestRebuild()
 
+    @log
+    def time_per_step(self):
+        """float: Wall time spent building the list per time step (seconds).
+
+        The average is taken over the current or last `hoomd.Simulation.run`.
+        It includes the cell list and the neighbor list builds, but not the
+        checks for a rebuild. See `hoomd.operation.Operation.time_per_step`.
+
+        .. versionadded:: 3.0
+        """
+        if not self._attached:
+            return None
+        n_steps = (self._simulation.timestep
+                   - self._simulation._cpp_sys.initial_timestep)
+        if n_steps == 0:
+            return 0.0
+        return self._cpp_obj.getExecutionTime() / n_steps
+
     # TODO need to add tuning Updater for NList
 
 
@@ -134,16 +234,32 @@ class Cell(NList):
     r"""Cell list based neighbor list
 
     Args:
+        adaptive_check (bool): Predict the next rebuild from the recent
+            displacements and skip the checks before it.
         buffer (float): Buffer width.
         check_dist (bool): Flag to enable / disable distance checking.
+        compress (bool): Pack the neighbor list with exact counts after every
+            build.
         deterministic (bool): When `True`, sort neighbors to help provide
             deterministic simulation runs.
         diameter_shift (bool): Flag to enable / disable diameter shifting.
         exclusions (tuple[str]): Excludes pairs from the neighbor list, which
             excludes them from the pair potential calculation.
+        half_list (bool): Store each pair only once on the GPU, so that pair
+            potentials evaluate each pair once (GPU only).
         max_diameter (float): The maximum diameter a particle will achieve.
+        out_of_core (int): Number of particles in each chunk of a neighbor
+            list stored in host memory, or 0 to store it on the GPU (GPU
+            only).
+        partial_rebuild (bool): Rebuild only the neighbors of the particles
+            near those that moved too far (CPU only).
         rebuild_check_delay (int): How often to attempt to rebuild the neighbor
             list.
+        scaled_check (bool): Measure the displacements from the last positions
+            carried along with the box deformation.
+        sort_by_distance (bool): Sort the neighbors of each particle by
+            distance after every build.
+        tune_buffer (bool): Tune `buffer` to the smallest run time per step.
 
     `Cell` finds neighboring particles using a fixed width cell list, allowing
     for *O(kN)* construction of the neighbor list where *k* is the number of
@@ -152,11 +268,37 @@ class Cell(NList):
     but performance degrades for large cutoff radius asymmetries due to the
     significantly increased number of particles per cell.
 
+    On the CPU, the neighbor list always stores each pair once. On the GPU,
+    it stores each pair twice by default so that every particle sums its own
+    forces. With ``half_list=True``, the GPU neighbor list also stores each
+    pair once, and the pair potentials add the reaction force to the neighbor
+    with atomic operations. This halves the number of evaluated pairs, which
+    pays off for expensive potentials. All forces that use the neighbor list
+    must support half lists on the GPU, which excludes the anisotropic pair
+    potentials, `md.pair.DPD`, `md.pair.DPDLJ`, and `hoomd.jit.pair.User`.
+
+    When the neighbor list of a large system does not fit in GPU memory, set
+    ``out_of_core`` to store it in pinned host memory instead. The particles are
+    processed in chunks of ``out_of_core`` consecutive particles, which are
+    close in space because `hoomd.tune.ParticleSorter` orders the particles
+    along a space filling curve. The list is built one chunk at a time and each
+    chunk is copied to the host while the next one is built. The pair
+    potentials copy the chunks back to the GPU, overlapping the copy of one
+    chunk with the evaluation of the previous one. All other particle data
+    stays on the GPU. Choose the chunk size so that two chunks of the neighbor
+    list fit in GPU memory next to the particle data, and large enough to
+    saturate the GPU. Only the isotropic pair potentials in `hoomd.md.pair`
+    support an out of core neighbor list, on a single GPU, and without
+    ``compress``, ``sort_by_distance``, ``partial_rebuild``, or
+    ``half_list``.
+
     Examples::
 
         cell = nlist.Cell()
         lj = md.pair.LJ(nlist=cell)
 
+        cell = nlist.Cell(out_of_core=50_000_000)
+
     Attributes:
         deterministic (bool): When `True`, sort neighbors to help provide
             deterministic simulation runs.
@@ -164,13 +306,29 @@ class Cell(NList):
 
     def __init__(self, buffer=0.4, exclusions=('bond',), rebuild_check_delay=1,
                  diameter_shift=False, check_dist=True, max_diameter=1.0,
-                 deterministic=False):
+                 deterministic=False, compress=False, sort_by_distance=False,
+                 adaptive_check=False, tune_buffer=False, scaled_check=False,
+                 partial_rebuild=False, half_list=False, out_of_core=0):
 
         super().__init__(buffer, exclusions, rebuild_check_delay,
-                         diameter_shift, check_dist, max_diameter)
+                         diameter_shift, check_dist, max_diameter, compress,
+                         sort_by_distance, adaptive_check, tune_buffer,
+                         scaled_check, partial_rebuild)
 
         self._param_dict.update(
             ParameterDict(deterministic=bool(deterministic)))
+        self._half_list = bool(half_list)
+        self._out_of_core = int(out_of_core)
+
+    @property
+    def half_list(self):
+        """bool: Store each pair only once on the GPU."""
+        return self._half_list
+
+    @property
+    def out_of_core(self):
+        """int: Particles per chunk of a neighbor list in host memory."""
+        return self._out_of_core
 
     def _attach(self):
         if isinstance(self._simulation.device, hoomd.device.CPU):
@@ -183,6 +341,143 @@ class Cell(NList):
         # TODO remove 0.0 (r_cut) from constructor
         self._cpp_obj = nlist_cls(self._simulation.state._cpp_sys_def, 0.0,
                                   self.buffer, self._cpp_cell)
+        if self._out_of_core > 0:
+            if isinstance(self._simulation.device, hoomd.device.CPU):
+                raise RuntimeError("Out of core neighbor lists require a GPU "
+                                   "device.")
+            self._cpp_obj.setOutOfCore(self._out_of_core)
+        super()._attach()
+
+    def _detach(self):
+        del self._cpp_cell
+        super()._detach()
+
+
+class MultiCell(NList):
+    r"""Neighbor list with one cell list per particle type.
+
+    Args:
+        adaptive_check (bool): Predict the next rebuild from the recent
+            displacements and skip the checks before it.
+        buffer (float): Buffer width.
+        check_dist (bool): Flag to enable / disable distance checking.
+        compress (bool): Pack the neighbor list with exact counts after every
+            build.
+        diameter_shift (bool): Flag to enable / disable diameter shifting.
+        exclusions (tuple[str]): Excludes pairs from the neighbor list, which
+            excludes them from the pair potential calculation.
+        max_diameter (float): The maximum diameter a particle will achieve.
+        rebuild_check_delay (int): How often to attempt to rebuild the neighbor
+            list.
+        scaled_check (bool): Measure the displacements from the last positions
+            carried along with the box deformation.
+        sort_by_distance (bool): Sort the neighbors of each particle by
+            distance after every build.
+        tune_buffer (bool): Tune `buffer` to the smallest run time per step.
+
+    `MultiCell` bins the particles of each type into a separate cell list.
+    The cells of a type are sized to the smallest :math:`r_\mathrm{cut}` of
+    the pairs that involve that type, and each type searches the cell list of
+    another type with a stencil of the cells within the pair cutoff. Cells of
+    small particles stay small in mixtures with large cutoff radius
+    asymmetries, so the construction remains *O(N)* when `Cell` would place
+    many small particles in each cell.
+
+    Note:
+        `MultiCell` is only available on the CPU.
+
+    Examples::
+
+        multi_cell = nlist.MultiCell()
+        lj = md.pair.LJ(nlist=multi_cell)
+    """
+
+    def __init__(self, buffer=0.4, exclusions=('bond',), rebuild_check_delay=1,
+                 diameter_shift=False, check_dist=True, max_diameter=1.0,
+                 compress=False, sort_by_distance=False, adaptive_check=False,
+                 tune_buffer=False, scaled_check=False):
+
+        super().__init__(buffer, exclusions, rebuild_check_delay,
+                         diameter_shift, check_dist, max_diameter, compress,
+                         sort_by_distance, adaptive_check, tune_buffer,
+                         scaled_check)
+
+    def _attach(self):
+        if not isinstance(self._simulation.device, hoomd.device.CPU):
+            raise RuntimeError("nlist.MultiCell is not supported on the GPU.")
+        # TODO remove 0.0 (r_cut) from constructor
+        self._cpp_obj = _md.NeighborListMultiBinned(
+            self._simulation.state._cpp_sys_def, 0.0, self.buffer)
+        super()._attach()
+
+
+class ClusterPair(NList):
+    r"""Neighbor list of particle cluster pairs.
+
+    Args:
+        adaptive_check (bool): Predict the next rebuild from the recent
+            displacements and skip the checks before it.
+        buffer (float): Buffer width.
+        check_dist (bool): Flag to enable / disable distance checking.
+        compress (bool): Pack the neighbor list with exact counts after every
+            build.
+        deterministic (bool): When `True`, sort the particles in each cell to
+            help provide deterministic simulation runs.
+        diameter_shift (bool): Flag to enable / disable diameter shifting.
+        exclusions (tuple[str]): Excludes pairs from the neighbor list, which
+            excludes them from the pair potential calculation.
+        max_diameter (float): The maximum diameter a particle will achieve.
+        rebuild_check_delay (int): How often to attempt to rebuild the neighbor
+            list.
+        scaled_check (bool): Measure the displacements from the last positions
+            carried along with the box deformation.
+        sort_by_distance (bool): Sort the neighbors of each particle by
+            distance after every build.
+        tune_buffer (bool): Tune `buffer` to the smallest run time per step.
+
+    `ClusterPair` groups the particles of each cell of a cell list into
+    clusters of 8 and stores, for every cluster, the neighboring clusters
+    together with a bit mask of the particle pairs within the neighbor list
+    cutoff. Pair potentials evaluate the forces from the cluster pairs, which
+    reads one neighbor index per pair of clusters instead of one per pair of
+    particles. The cluster pairs are also expanded into a conventional
+    neighbor list for the other forces and computes that use it.
+
+    Note:
+        `ClusterPair` is only available on a single GPU.
+
+    Examples::
+
+        cluster = nlist.ClusterPair()
+        lj = md.pair.LJ(nlist=cluster)
+
+    Attributes:
+        deterministic (bool): When `True`, sort the particles in each cell to
+            help provide deterministic simulation runs.
+    """
+
+    def __init__(self, buffer=0.4, exclusions=('bond',), rebuild_check_delay=1,
+                 diameter_shift=False, check_dist=True, max_diameter=1.0,
+                 deterministic=False, compress=False, sort_by_distance=False,
+                 adaptive_check=False, tune_buffer=False, scaled_check=False):
+
+        super().__init__(buffer, exclusions, rebuild_check_delay,
+                         diameter_shift, check_dist, max_diameter, compress,
+                         sort_by_distance, adaptive_check, tune_buffer,
+                         scaled_check)
+
+        self._param_dict.update(
+            ParameterDict(deterministic=bool(deterministic)))
+
+    def _attach(self):
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            raise RuntimeError(
+                "nlist.ClusterPair is not supported on the CPU.")
+        self._cpp_cell = _hoomd.CellListGPU(self._simulation.state._cpp_sys_def)
+        # TODO remove 0.0 (r_cut) from constructor
+        self._cpp_obj = _md.NeighborListGPUCluster(
+            self._simulation.state._cpp_sys_def, 0.0, self.buffer,
+            self._cpp_cell)
         super()._attach()
 
     def _detach(self):
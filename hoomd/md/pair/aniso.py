@@ -27,6 +27,7 @@ class AnisotropicPair(Pair):
             defaults to ``None`` which means no cutoff (units: [length]).
         mode (`str`, optional) : the energy shifting mode, defaults to "none".
     """
+    _half_list_gpu = False
 
     def __init__(self, nlist, r_cut=None, mode="none"):
         self._nlist = OnlyTypes(md.nlist.NList, strict=True)(nlist)
@@ -106,8 +106,40 @@ class Pair(force.Force):
           `tuple` [``particle_type``, ``particle_type``],\
           `float`]): *r_on* (in distance units),  *optional*: defaults to the
           value ``r_on`` specified on construction
+
+        cell_list (bool): Set to `True` to compute the forces on the GPU
+          directly from a cell list instead of the neighbor list. The cell list
+          is rebuilt every step and no neighbor list is stored, which is faster
+          for short cutoffs where the neighbor list rebuilds every few steps.
+          Requires a neighbor list without exclusions, rigid body filtering or
+          diameter shifting, and a single GPU. Ignored on the CPU.
+
+          .. versionadded:: 3.0
+
+        tabulate (int): Number of knots of a cubic spline table in
+          :math:`r^2` that replaces the evaluation of the potential for pairs
+          with :math:`r \\ge r_{\\mathrm{min}}`, where
+          :math:`r_{\\mathrm{min}}` is ``tabulate_r_min``. The table is
+          built from the potential whenever the parameters change. Set to 0
+          (the default) to always evaluate the potential directly. A warning is
+          issued when the force error of the table exceeds :math:`10^{-4}` of
+          the largest force in the table, see ``table_error``. Not supported
+          by potentials that depend on the diameter or charge.
+
+          .. versionadded:: 3.0
+
+        tabulate_r_min (float): Smallest distance covered by the table
+          (in distance units). Closer pairs are evaluated directly.
+
+          .. versionadded:: 3.0
     """
 
+    _cell_list = False
+    # the GPU implementation evaluates each pair once with a half neighbor list
+    _half_list_gpu = True
+    _tabulate = 0
+    _tabulate_r_min = 0.5
+
     def __init__(self, nlist, r_cut=None, r_on=0., mode='none'):
         self._nlist = validate_nlist(nlist)
         tp_r_cut = TypeParameter('r_cut', 'particle_types',
@@ -172,18 +204,94 @@ class Pair(force.Force):
         if not self.nlist._attached:
             self.nlist._attach()
         if isinstance(self._simulation.device, hoomd.device.CPU):
-            cls = getattr(_md, self._cpp_class_name)
+            self.nlist._cpp_obj.setStorageMode(
+                _md.NeighborList.storageMode.half)
+        elif getattr(self.nlist, 'half_list', False):
+            if not self._half_list_gpu:
+                raise RuntimeError("{} does not support half neighbor lists "
+                                   "on the GPU.".format(type(self).__name__))
             self.nlist._cpp_obj.setStorageMode(
                 _md.NeighborList.storageMode.half)
         else:
-            cls = getattr(_md, self._cpp_class_name + "GPU")
             self.nlist._cpp_obj.setStorageMode(
                 _md.NeighborList.storageMode.full)
-        self._cpp_obj = cls(
-            self._simulation.state._cpp_sys_def, self.nlist._cpp_obj,
-            '')  # TODO remove name string arg
+        self._cpp_obj = self._create_cpp_obj()
 
         super()._attach()
+        self._apply_cell_list()
+        self._apply_tabulate()
+
+    def _create_cpp_obj(self):
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            cls = getattr(_md, self._cpp_class_name)
+        else:
+            cls = getattr(_md, self._cpp_class_name + "GPU")
+        return cls(self._simulation.state._cpp_sys_def, self.nlist._cpp_obj,
+                   '')  # TODO remove name string arg
+
+    def _apply_tabulate(self):
+        if hasattr(self._cpp_obj, 'setTable'):
+            self._cpp_obj.setTable(self._tabulate, self._tabulate_r_min)
+        elif self._tabulate:
+            raise RuntimeError("{} does not support tabulate.".format(
+                type(self).__name__))
+
+    @property
+    def tabulate(self):
+        return self._tabulate
+
+    @tabulate.setter
+    def tabulate(self, value):
+        value = int(value)
+        if value < 0 or value == 1:
+            raise ValueError("tabulate must be 0 or at least 2.")
+        self._tabulate = value
+        if self._attached:
+            self._apply_tabulate()
+
+    @property
+    def tabulate_r_min(self):
+        return self._tabulate_r_min
+
+    @tabulate_r_min.setter
+    def tabulate_r_min(self, value):
+        value = float(value)
+        if value < 0:
+            raise ValueError("tabulate_r_min must be non-negative.")
+        self._tabulate_r_min = value
+        if self._attached:
+            self._apply_tabulate()
+
+    @property
+    def table_error(self):
+        """float: Largest force error of the table relative to the largest
+        force.
+
+        0 when the potential is not tabulated or the table has not been built
+        yet.
+        """
+        if not self._attached or not hasattr(self._cpp_obj, 'getTableError'):
+            return 0.0
+        return self._cpp_obj.getTableError()
+
+    def _apply_cell_list(self):
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            return
+        if hasattr(self._cpp_obj, 'setCellListMode'):
+            self._cpp_obj.setCellListMode(self._cell_list)
+        elif self._cell_list:
+            raise RuntimeError("{} does not support cell_list.".format(
+                type(self).__name__))
+
+    @property
+    def cell_list(self):
+        return self._cell_list
+
+    @cell_list.setter
+    def cell_list(self, value):
+        self._cell_list = bool(value)
+        if self._attached:
+            self._apply_cell_list()
 
     @property
     def nlist(self):
@@ -929,6 +1037,7 @@ class DPD(Pair):
         dpd.params[(['A', 'B'], ['C', 'D'])] = dict(A=40.0, gamma=4.5)
     """
     _cpp_class_name = "PotentialPairDPDThermoDPD"
+    _half_list_gpu = False
     def __init__(self, nlist, kT, r_cut=None, r_on=0., mode='none'):
         super().__init__(nlist, r_cut, r_on, mode)
         params = TypeParameter('params', 'particle_types',
@@ -1102,6 +1211,7 @@ class DPDLJ(Pair):
         dpdlj.r_cut[('B', 'B')] = 2.0**(1.0/6.0)
     """
     _cpp_class_name = "PotentialPairDPDLJThermoDPD"
+    _half_list_gpu = False
     def __init__(self, nlist, kT, r_cut=None, r_on=0., mode='none'):
         if mode == 'xplor':
             raise ValueError("xplor smoothing is not supported with pair.DPDLJ")
@@ -0,0 +1,65 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def _make_simulation(simulation_factory, two_particle_snapshot_factory,
+                     accumulate):
+    snap = two_particle_snapshot_factory(d=1.2)
+    if snap.exists:
+        snap.particles.velocity[:] = 0
+    sim = simulation_factory(snap)
+
+    nlist = hoomd.md.nlist.Cell()
+    lj = hoomd.md.pair.LJ(nlist=nlist, r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    lj.accumulate_net_force = accumulate
+    gauss = hoomd.md.pair.Gauss(nlist=nlist, r_cut=2.5)
+    gauss.params[('A', 'A')] = dict(epsilon=0.5, sigma=0.8)
+
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005,
+                                                    methods=[nve],
+                                                    forces=[lj, gauss])
+    return sim, lj
+
+
+def test_accumulate_net_force_attribute(simulation_factory,
+                                        two_particle_snapshot_factory):
+    sim, lj = _make_simulation(simulation_factory,
+                               two_particle_snapshot_factory, True)
+    assert lj.accumulate_net_force
+
+    sim.run(0)
+    assert lj._cpp_obj.getAccumulateNetForce()
+
+    lj.accumulate_net_force = False
+    assert not lj._cpp_obj.getAccumulateNetForce()
+
+
+def test_accumulate_net_force_trajectory(simulation_factory,
+                                         two_particle_snapshot_factory):
+    sim_sum, lj_sum = _make_simulation(simulation_factory,
+                                       two_particle_snapshot_factory, False)
+    sim_acc, lj_acc = _make_simulation(simulation_factory,
+                                       two_particle_snapshot_factory, True)
+
+    sim_sum.run(10)
+    sim_acc.run(10)
+
+    # the per-force quantities are evaluated again when they are accessed
+    np.testing.assert_allclose(lj_acc.energy, lj_sum.energy, rtol=1e-6)
+    forces_sum = lj_sum.forces
+    forces_acc = lj_acc.forces
+    if forces_sum is not None:
+        np.testing.assert_allclose(forces_acc, forces_sum, rtol=1e-6)
+
+    snap_sum = sim_sum.state.snapshot
+    snap_acc = sim_acc.state.snapshot
+    if snap_sum.exists:
+        np.testing.assert_allclose(snap_acc.particles.position,
+                                   snap_sum.particles.position,
+                                   rtol=1e-6)
+        np.testing.assert_allclose(snap_acc.particles.velocity,
+                                   snap_sum.particles.velocity,
+                                   rtol=1e-6)
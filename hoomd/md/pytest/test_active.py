@@ -13,3 +13,47 @@ def test_attach(simulation_factory, two_particle_snapshot_factory):
     sim.operations._schedule()
     sim.run(10)
 
+
+
+def _run_brownian_active(simulation_factory, snapshot, fused, rotation_diff):
+    sim = simulation_factory(snapshot)
+    integrator = hoomd.md.Integrator(.005)
+    brownian = hoomd.md.methods.Brownian(hoomd.filter.All(), kT=0)
+    active = hoomd.md.force.Active(filter=hoomd.filter.All(),
+                                   rotation_diff=rotation_diff)
+    active.active_force['A'] = (1, 0, 0)
+    integrator.methods.append(brownian)
+    integrator.forces.append(active)
+    if fused:
+        brownian.active_force = active
+    sim.operations.integrator = integrator
+    sim.run(10)
+    return sim.state.snapshot
+
+
+def test_brownian_fused_active_force(simulation_factory,
+                                     two_particle_snapshot_factory):
+    snap = two_particle_snapshot_factory(dimensions=3, d=8)
+    separate = _run_brownian_active(simulation_factory, snap, False, 0)
+    fused = _run_brownian_active(simulation_factory, snap, True, 0)
+
+    if separate.exists:
+        numpy.testing.assert_allclose(fused.particles.position,
+                                      separate.particles.position,
+                                      rtol=1e-6)
+        numpy.testing.assert_allclose(fused.particles.orientation,
+                                      separate.particles.orientation,
+                                      rtol=1e-6)
+
+
+def test_brownian_fused_active_diffusion(simulation_factory,
+                                         two_particle_snapshot_factory):
+    snap = two_particle_snapshot_factory(dimensions=3, d=8)
+    fused = _run_brownian_active(simulation_factory, snap, True, 0.5)
+
+    if fused.exists:
+        orientation = numpy.array(fused.particles.orientation)
+        assert not numpy.allclose(orientation, [1, 0, 0, 0])
+        numpy.testing.assert_allclose(numpy.linalg.norm(orientation, axis=1),
+                                      1,
+                                      rtol=1e-6)
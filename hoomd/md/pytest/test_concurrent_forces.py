@@ -0,0 +1,58 @@
+import hoomd
+import numpy as np
+
+
+def _make_simulation(simulation_factory, two_particle_snapshot_factory,
+                     concurrent):
+    snap = two_particle_snapshot_factory(d=1.2)
+    if snap.exists:
+        snap.particles.velocity[:] = 0
+    sim = simulation_factory(snap)
+
+    nlist = hoomd.md.nlist.Cell()
+    lj = hoomd.md.pair.LJ(nlist=nlist, r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    gauss = hoomd.md.pair.Gauss(nlist=nlist, r_cut=2.5)
+    gauss.params[('A', 'A')] = dict(epsilon=0.5, sigma=0.8)
+
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    integrator = hoomd.md.Integrator(0.005,
+                                     methods=[nve],
+                                     forces=[lj, gauss],
+                                     concurrent_forces=concurrent)
+    sim.operations.integrator = integrator
+    return sim, integrator
+
+
+def test_concurrent_forces_attribute(simulation_factory,
+                                     two_particle_snapshot_factory):
+    sim, integrator = _make_simulation(simulation_factory,
+                                       two_particle_snapshot_factory, True)
+    assert integrator.concurrent_forces
+
+    sim.run(0)
+    assert integrator._cpp_obj.concurrent_forces
+
+    integrator.concurrent_forces = False
+    assert not integrator._cpp_obj.concurrent_forces
+
+
+def test_concurrent_forces_trajectory(simulation_factory,
+                                      two_particle_snapshot_factory):
+    sim_serial, _ = _make_simulation(simulation_factory,
+                                     two_particle_snapshot_factory, False)
+    sim_concurrent, _ = _make_simulation(simulation_factory,
+                                         two_particle_snapshot_factory, True)
+
+    sim_serial.run(10)
+    sim_concurrent.run(10)
+
+    snap_serial = sim_serial.state.snapshot
+    snap_concurrent = sim_concurrent.state.snapshot
+    if snap_serial.exists:
+        np.testing.assert_allclose(snap_concurrent.particles.position,
+                                   snap_serial.particles.position,
+                                   rtol=1e-6)
+        np.testing.assert_allclose(snap_concurrent.particles.velocity,
+                                   snap_serial.particles.velocity,
+                                   rtol=1e-6)
@@ -0,0 +1,45 @@
+import hoomd
+import pytest
+
+
+def test_attributes():
+    nl = hoomd.md.nlist.Cell()
+    tuner = hoomd.md.tune.NeighborListBuffer(trigger=10,
+                                             nlist=nl,
+                                             minimum_buffer=0.1,
+                                             maximum_buffer=1.0)
+    assert tuner.nlist is nl
+    assert tuner.minimum_buffer == 0.1
+    assert tuner.maximum_buffer == 1.0
+    assert tuner.tolerance == 0.01
+    assert tuner.density_tolerance == 0.1
+    assert not tuner.tuned
+
+    tuner.tolerance = 0.05
+    assert tuner.tolerance == 0.05
+
+
+def test_tune_buffer(simulation_factory, lattice_snapshot_factory):
+    sim = simulation_factory(lattice_snapshot_factory(n=10, a=1.5, r=0.1))
+
+    nl = hoomd.md.nlist.Cell()
+    lj = hoomd.md.pair.LJ(nlist=nl, r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005,
+                                                    methods=[nve],
+                                                    forces=[lj])
+
+    tuner = hoomd.md.tune.NeighborListBuffer(trigger=10,
+                                             nlist=nl,
+                                             minimum_buffer=0.1,
+                                             maximum_buffer=1.0,
+                                             tolerance=0.5)
+    sim.operations.tuners.append(tuner)
+    sim.run(100)
+
+    assert tuner.tuned
+    assert 0.1 <= nl.buffer <= 1.0
+
+    with pytest.raises(RuntimeError):
+        tuner.minimum_buffer = 2.0
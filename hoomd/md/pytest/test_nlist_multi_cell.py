@@ -0,0 +1,40 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+@pytest.mark.cpu
+@pytest.mark.serial
+def test_multi_cell_forces(simulation_factory, lattice_snapshot_factory):
+    snap = lattice_snapshot_factory(particle_types=['A', 'B'],
+                                    n=8,
+                                    a=1.5,
+                                    r=0.1)
+    if snap.exists:
+        # every fourth particle is a large particle
+        snap.particles.typeid[::4] = 1
+    sim = simulation_factory(snap)
+
+    forces = []
+    for nlist in (hoomd.md.nlist.Cell(exclusions=()),
+                  hoomd.md.nlist.MultiCell(exclusions=())):
+        lj = hoomd.md.pair.LJ(nlist=nlist, r_cut=1.2)
+        lj.params[('A', 'A')] = dict(epsilon=1, sigma=0.5)
+        lj.params[('A', 'B')] = dict(epsilon=1, sigma=1.5)
+        lj.params[('B', 'B')] = dict(epsilon=1, sigma=2.5)
+        lj.r_cut[('A', 'B')] = 2.5
+        lj.r_cut[('B', 'B')] = 4.0
+        forces.append(lj)
+
+    sim.operations.integrator = hoomd.md.Integrator(0.005, forces=forces)
+    sim.run(0)
+
+    # both neighbor lists find the same pairs within the cutoffs
+    np.testing.assert_allclose(forces[1].forces,
+                               forces[0].forces,
+                               rtol=1e-5,
+                               atol=1e-6)
+    np.testing.assert_allclose(forces[1].energies,
+                               forces[0].energies,
+                               rtol=1e-5,
+                               atol=1e-6)
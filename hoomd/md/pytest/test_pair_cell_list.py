@@ -0,0 +1,49 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def test_cell_list_attribute(simulation_factory, lattice_snapshot_factory):
+    lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(exclusions=()),
+                          r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    assert not lj.cell_list
+
+    lj.cell_list = True
+    assert lj.cell_list
+
+    sim = simulation_factory(lattice_snapshot_factory(n=6, a=1.5, r=0.1))
+    sim.operations.integrator = hoomd.md.Integrator(0.005, forces=[lj])
+    sim.run(0)
+    assert lj.cell_list
+
+
+@pytest.mark.gpu
+@pytest.mark.serial
+@pytest.mark.parametrize("mode", ['none', 'shift', 'xplor'])
+def test_cell_list_forces(simulation_factory, lattice_snapshot_factory, mode):
+    sim = simulation_factory(lattice_snapshot_factory(n=8, a=1.2, r=0.1))
+
+    forces = []
+    for cell_list in (False, True):
+        lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(exclusions=()),
+                              r_cut=2.5,
+                              r_on=2.0,
+                              mode=mode)
+        lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+        lj.cell_list = cell_list
+        forces.append(lj)
+
+    sim.operations.integrator = hoomd.md.Integrator(0.005, forces=forces)
+    sim.run(0)
+
+    # both modes find the same pairs within the cutoff
+    assert forces[1]._cpp_obj.getCellListMode()
+    np.testing.assert_allclose(forces[1].forces,
+                               forces[0].forces,
+                               rtol=1e-5,
+                               atol=1e-6)
+    np.testing.assert_allclose(forces[1].energies,
+                               forces[0].energies,
+                               rtol=1e-5,
+                               atol=1e-6)
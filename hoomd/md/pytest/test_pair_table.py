@@ -0,0 +1,64 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def test_tabulate_attribute(simulation_factory, lattice_snapshot_factory):
+    lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(), r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    assert lj.tabulate == 0
+    assert lj.table_error == 0
+
+    lj.tabulate = 1000
+    lj.tabulate_r_min = 0.8
+    assert lj.tabulate == 1000
+    assert lj.tabulate_r_min == 0.8
+
+    with pytest.raises(ValueError):
+        lj.tabulate = 1
+    with pytest.raises(ValueError):
+        lj.tabulate_r_min = -1.0
+
+    sim = simulation_factory(lattice_snapshot_factory(n=6, a=1.5, r=0.1))
+    sim.operations.integrator = hoomd.md.Integrator(0.005, forces=[lj])
+    sim.run(0)
+    assert lj._cpp_obj.getTableWidth() == 1000
+    assert 0 < lj.table_error < 1e-4
+
+
+@pytest.mark.parametrize("mode", ['none', 'shift', 'xplor'])
+def test_tabulate_forces(simulation_factory, lattice_snapshot_factory, mode):
+    sim = simulation_factory(lattice_snapshot_factory(n=8, a=1.2, r=0.1))
+
+    forces = []
+    for tabulate in (0, 1000):
+        lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(),
+                              r_cut=2.5,
+                              r_on=2.0,
+                              mode=mode)
+        lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+        lj.tabulate = tabulate
+        lj.tabulate_r_min = 0.8
+        forces.append(lj)
+
+    sim.operations.integrator = hoomd.md.Integrator(0.005, forces=forces)
+    sim.run(0)
+
+    # the table interpolates the potential it was built from
+    np.testing.assert_allclose(forces[1].forces,
+                               forces[0].forces,
+                               rtol=1e-4,
+                               atol=1e-5)
+    np.testing.assert_allclose(forces[1].energies,
+                               forces[0].energies,
+                               rtol=1e-5,
+                               atol=1e-6)
+
+    # the table is rebuilt when the parameters change
+    for lj in forces:
+        lj.params[('A', 'A')] = dict(epsilon=2, sigma=1)
+    sim.run(0)
+    np.testing.assert_allclose(forces[1].forces,
+                               forces[0].forces,
+                               rtol=1e-4,
+                               atol=1e-5)
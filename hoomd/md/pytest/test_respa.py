@@ -0,0 +1,58 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def test_respa_period_attribute(simulation_factory,
+                                two_particle_snapshot_factory):
+    lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(), r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    assert lj.respa_period == 1
+
+    lj.respa_period = 3
+    assert lj.respa_period == 3
+
+    with pytest.raises(ValueError):
+        lj.respa_period = 0
+
+    sim = simulation_factory(two_particle_snapshot_factory(d=1.2))
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005,
+                                                    methods=[nve],
+                                                    forces=[lj])
+    sim.run(0)
+    assert lj.respa_period == 3
+    assert lj._cpp_obj.getRESPAPeriod() == 3
+
+    lj.respa_period = 2
+    assert lj._cpp_obj.getRESPAPeriod() == 2
+
+
+def test_respa_impulse(simulation_factory, two_particle_snapshot_factory):
+    snap = two_particle_snapshot_factory(d=1.2)
+    if snap.exists:
+        snap.particles.velocity[:] = 0
+        snap.particles.mass[:] = 1
+    sim = simulation_factory(snap)
+
+    lj = hoomd.md.pair.LJ(nlist=hoomd.md.nlist.Cell(), r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    lj.respa_period = 2
+
+    dt = 0.001
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(dt,
+                                                    methods=[nve],
+                                                    forces=[lj])
+    sim.run(0)
+    forces = lj.forces
+
+    # the force acts with twice its magnitude on step 0 and not at all on
+    # step 1, so the first step applies a half kick of 2*F
+    sim.run(1)
+    snap = sim.state.snapshot
+    if snap.exists:
+        np.testing.assert_allclose(snap.particles.velocity,
+                                   dt * forces,
+                                   rtol=1e-5,
+                                   atol=1e-7)
@@ -0,0 +1,85 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def _static_simulation(simulation_factory, snapshot):
+    sim = simulation_factory(snapshot)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005, methods=[nve])
+    return sim
+
+
+def test_before_attaching():
+    rdf = hoomd.md.compute.RDF(nlist=hoomd.md.nlist.Cell(), r_max=3.0, bins=30)
+    assert rdf.r_max == 3.0
+    assert rdf.bins == 30
+    assert rdf.rdf is None
+    assert rdf.bin_centers is None
+
+    sq = hoomd.md.compute.StructureFactor(filter=hoomd.filter.All(),
+                                          q_max=5.0,
+                                          bins=10)
+    assert sq.q_max == 5.0
+    assert sq.structure_factor is None
+
+    with pytest.raises(ValueError):
+        hoomd.md.compute.RDF(nlist=hoomd.md.nlist.Cell(), r_max=-1.0)
+    with pytest.raises(ValueError):
+        hoomd.md.compute.StructureFactor(filter=hoomd.filter.All(),
+                                         q_max=5.0,
+                                         bins=0)
+
+
+def test_rdf_lattice(simulation_factory, lattice_snapshot_factory):
+    """Each particle of a simple cubic lattice has 6 neighbors at a."""
+    a = 1.5
+    sim = _static_simulation(simulation_factory,
+                             lattice_snapshot_factory(a=a, n=6))
+    rdf = hoomd.md.compute.RDF(nlist=hoomd.md.nlist.Cell(buffer=0.4),
+                               r_max=1.6,
+                               bins=16,
+                               trigger=5)
+    sim.operations.writers.append(rdf)
+    sim.run(10)
+
+    assert rdf.num_frames == 2
+    np.testing.assert_allclose(rdf.bin_centers, (np.arange(16) + 0.5) * 0.1)
+
+    g = rdf.rdf
+    r_lo = np.arange(16) * 0.1
+    shell = 4 / 3 * np.pi * ((r_lo + 0.1)**3 - r_lo**3)
+    rho = 6**3 / (6 * a)**3
+    coordination = rho * g * shell
+    np.testing.assert_allclose(coordination[:15], 0, atol=1e-6)
+    np.testing.assert_allclose(coordination[15], 6, rtol=1e-5)
+
+    rdf.reset()
+    assert rdf.num_frames == 0
+
+
+def test_structure_factor_lattice(simulation_factory, lattice_snapshot_factory):
+    """A simple cubic lattice has Bragg peaks of height N at 2 pi/a."""
+    a = 1.5
+    n = 4
+    sim = _static_simulation(simulation_factory,
+                             lattice_snapshot_factory(a=a, n=n))
+    q_bragg = 2 * np.pi / a
+    sq = hoomd.md.compute.StructureFactor(filter=hoomd.filter.All(),
+                                          q_max=1.05 * q_bragg,
+                                          bins=10,
+                                          trigger=5)
+    sim.operations.writers.append(sq)
+    sim.run(10)
+
+    assert sq.num_frames == 2
+    s = sq.structure_factor
+    assert s.shape == (10,)
+
+    # the first bins are below the smallest wave vector of the box, and the
+    # other wave vectors below the Bragg peak have S = 0
+    assert np.all(np.isnan(s[:2]))
+    np.testing.assert_allclose(s[2:9], 0, atol=1e-4)
+
+    # the last bin holds the 3 Bragg peaks of height N
+    assert s[9] > 1
@@ -141,3 +141,59 @@ def test_system_rotational_dof(simulation_factory, device):
                               2./3*thermo.translational_kinetic_energy/10.0**3,
                               (0., 0., 0., 2./10**3, 0., 0.))
 
+
+
+def test_lazy_quantities(simulation_factory, two_particle_snapshot_factory):
+    filt = hoomd.filter.All()
+    snap = two_particle_snapshot_factory()
+    if snap.exists:
+        snap.particles.velocity[:] = [[-2, 1, 0], [2, 0, -1]]
+    sim = simulation_factory(snap)
+    sim.always_compute_pressure = True
+
+    integrator = hoomd.md.Integrator(dt=0.005)
+    integrator.methods.append(hoomd.md.methods.NVE(filt))
+    sim.operations.integrator = integrator
+
+    # one compute is only asked for some quantities at a time, the other for everything
+    thermo_partial = hoomd.md.compute.ThermodynamicQuantities(filt)
+    thermo_full = hoomd.md.compute.ThermodynamicQuantities(filt)
+    sim.operations.add(thermo_partial)
+    sim.operations.add(thermo_full)
+
+    for step in range(4):
+        sim.run(1)
+        full = {qty: getattr(thermo_full, qty) for qty, typ in _thermo_qtys}
+        qty, typ = _thermo_qtys[step % len(_thermo_qtys)]
+        np.testing.assert_allclose(getattr(thermo_partial, qty), full[qty])
+
+        # quantities that were not requested on this step are computed on demand
+        for qty, typ in _thermo_qtys:
+            np.testing.assert_allclose(getattr(thermo_partial, qty), full[qty])
+
+
+def test_logger_batch(simulation_factory, two_particle_snapshot_factory):
+    filt = hoomd.filter.All()
+    snap = two_particle_snapshot_factory()
+    if snap.exists:
+        snap.particles.velocity[:] = [[-2, 1, 0], [2, 0, -1]]
+    sim = simulation_factory(snap)
+
+    integrator = hoomd.md.Integrator(dt=0.005)
+    integrator.methods.append(hoomd.md.methods.NVE(filt))
+    sim.operations.integrator = integrator
+
+    thermo = hoomd.md.compute.ThermodynamicQuantities(filt)
+    sim.operations.add(thermo)
+    logger = hoomd.logging.Logger(categories=['scalar'])
+    logger.add(thermo)
+
+    for step in range(3):
+        sim.run(1)
+        # scalar quantities registered in C++ are evaluated in one batch
+        log = logger.log()['md']['compute']['ThermodynamicQuantities']
+        for qty, typ in _thermo_qtys:
+            if typ is float:
+                value, category = log[qty]
+                assert category == 'scalar'
+                np.testing.assert_allclose(value, getattr(thermo, qty))
@@ -0,0 +1,81 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def test_before_attaching():
+    correlation = hoomd.md.compute.TimeCorrelation(
+        filter=hoomd.filter.All(),
+        quantities=['kinetic_energy', 'pressure_xy'],
+        trigger=10)
+    assert correlation.trigger.period == 10
+    assert correlation.quantities == ['kinetic_energy', 'pressure_xy']
+    assert correlation.lags is None
+    assert correlation.correlation is None
+    assert correlation.mean is None
+    assert correlation.standard_error is None
+
+    with pytest.raises(ValueError):
+        hoomd.md.compute.TimeCorrelation(filter=hoomd.filter.All(),
+                                         quantities=['kinetic_energy'],
+                                         trigger=hoomd.trigger.On(10))
+    with pytest.raises(ValueError):
+        hoomd.md.compute.TimeCorrelation(filter=hoomd.filter.All(),
+                                         quantities=['kinetic_energy'],
+                                         points_per_level=9,
+                                         averaging=2)
+
+
+def test_unknown_quantity(simulation_factory, two_particle_snapshot_factory):
+    sim = simulation_factory(two_particle_snapshot_factory())
+    correlation = hoomd.md.compute.TimeCorrelation(filter=hoomd.filter.All(),
+                                                   quantities=['not_a_qty'])
+    sim.operations.writers.append(correlation)
+    with pytest.raises(RuntimeError):
+        sim.run(0)
+
+
+def test_free_particles(simulation_factory, two_particle_snapshot_factory):
+    """Without forces, the velocities and charge current are constant."""
+    snap = two_particle_snapshot_factory(d=4)
+    if snap.exists:
+        snap.particles.velocity[:] = [[1, 0, 0], [0, -2, 0]]
+        snap.particles.charge[:] = [1, -1]
+    sim = simulation_factory(snap)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.001, methods=[nve])
+
+    quantities = ['kinetic_energy', 'charge_current_y']
+    if sim.device.communicator.num_ranks == 1:
+        quantities.append('velocity')
+    correlation = hoomd.md.compute.TimeCorrelation(filter=hoomd.filter.All(),
+                                                   quantities=quantities,
+                                                   trigger=2,
+                                                   points_per_level=8,
+                                                   averaging=2,
+                                                   n_levels=4)
+    sim.operations.writers.append(correlation)
+    sim.run(200)
+
+    assert correlation.num_samples == 100
+    lags = correlation.lags
+    np.testing.assert_allclose(lags[:8], np.arange(8) * 2)
+    np.testing.assert_allclose(lags[8:12], np.arange(4, 8) * 4)
+
+    values = correlation.correlation
+    assert values.shape == (len(quantities), len(lags))
+    np.testing.assert_allclose(values[0], 2.5**2, rtol=1e-5)
+    np.testing.assert_allclose(values[1], 2**2, rtol=1e-5)
+
+    mean = correlation.mean
+    np.testing.assert_allclose(mean[0], 2.5, rtol=1e-5)
+    np.testing.assert_allclose(mean[1], 2, rtol=1e-5)
+    np.testing.assert_allclose(correlation.standard_error[:2], 0, atol=1e-5)
+
+    if 'velocity' in quantities:
+        np.testing.assert_allclose(values[2], 2.5, rtol=1e-5)
+        np.testing.assert_allclose(mean[2], 2.5, rtol=1e-5)
+
+    correlation.reset()
+    assert correlation.num_samples == 0
+    assert np.all(np.isnan(correlation.correlation))
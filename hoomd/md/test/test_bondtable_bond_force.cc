@@ -223,6 +223,47 @@ void bond_force_type_test(bondforce_creator bf_creator, std::shared_ptr<Executio
      }
 
 
+//! checks that hermite interpolation reproduces a cubic potential from a coarse table
+void bond_force_hermite_test(bondforce_creator bf_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef_2(new SystemDefinition(2, BoxDim(1000.0), 1, 1, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_2 = sysdef_2->getParticleData();
+
+    pdata_2->setPosition(0,make_scalar3(0.0,0.0,0.0));
+    pdata_2->setPosition(1,make_scalar3(1.5,0.0,0.0));
+
+    std::shared_ptr<BondTablePotential> fc_2 = bf_creator(sysdef_2,3);
+    fc_2->setInterpolation("hermite");
+    UP_ASSERT_EQUAL(fc_2->getInterpolation(), "hermite");
+
+    // tabulate V = r^3 and F = -3 r^2 at r = 1, 2, 3
+    vector<Scalar> V, F;
+    V.push_back(1.0);   F.push_back(-3.0);
+    V.push_back(8.0);   F.push_back(-12.0);
+    V.push_back(27.0);  F.push_back(-27.0);
+    fc_2->setTable(0, V, F, 1.0, 3.0);
+
+    sysdef_2->getBondData()->addBondedGroup(Bond(0, 0,1));
+
+    fc_2->compute(0);
+
+    {
+    ArrayHandle<Scalar4> h_force(fc_2->getForceArray(),access_location::host,access_mode::read);
+
+    // between the grid points the cubic is exact: V(1.5) = 3.375 and F(1.5) = -6.75
+    MY_CHECK_CLOSE(h_force.data[0].x, 6.75, tol);
+    MY_CHECK_SMALL(h_force.data[0].y, tol_small);
+    MY_CHECK_SMALL(h_force.data[0].z, tol_small);
+    MY_CHECK_CLOSE(h_force.data[0].w, 0.5*3.375, tol);
+
+    MY_CHECK_CLOSE(h_force.data[1].x, -6.75, tol);
+    MY_CHECK_SMALL(h_force.data[1].y, tol_small);
+    MY_CHECK_SMALL(h_force.data[1].z, tol_small);
+    MY_CHECK_CLOSE(h_force.data[1].w, 0.5*3.375, tol);
+    }
+    }
+
+
 
 //! BondTablePotential creator for bond_force_basic_tests()
 std::shared_ptr<BondTablePotential> base_class_bf_creator(std::shared_ptr<SystemDefinition> sysdef, unsigned int width)
@@ -252,6 +293,13 @@ UP_TEST( BondTablePotential_type )
     bond_force_type_test(bf_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for hermite interpolation on the CPU
+UP_TEST( BondTablePotential_hermite )
+    {
+    bondforce_creator bf_creator = bind(base_class_bf_creator, _1, _2);
+    bond_force_hermite_test(bf_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 
 #ifdef ENABLE_HIP
 //! test case for bond forces on the GPU
@@ -268,4 +316,11 @@ UP_TEST( BondTablePotentialGPU_type )
     bond_force_type_test(bf_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+//! test case for hermite interpolation on the GPU
+UP_TEST( BondTablePotentialGPU_hermite )
+    {
+    bondforce_creator bf_creator = bind(gpu_bf_creator, _1, _2);
+    bond_force_hermite_test(bf_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
 #endif
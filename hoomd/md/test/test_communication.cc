@@ -959,7 +959,8 @@ void test_communicator_ghosts(communicator_creator comm_creator,
                               std::shared_ptr<ExecutionConfiguration> exec_conf,
                               const BoxDim& dest_box,
                               std::shared_ptr<DomainDecomposition> decomposition,
-                              Scalar3 origin)
+                              Scalar3 origin,
+                              bool quantize_ghost_positions = false)
     {
     // this test needs to be run on eight processors
     int size;
@@ -1016,6 +1017,7 @@ void test_communicator_ghosts(communicator_creator comm_creator,
     // initialize a 2x2x2 domain decomposition on processor with rank 0
 //     std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf,  pdata->getBox().getL()));
     std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+    comm->setGhostPositionQuantization(quantize_ghost_positions);
 
     pdata->setDomainDecomposition(decomposition);
 
@@ -3258,6 +3260,88 @@ void test_communicator_ghost_layer_width(communicator_creator comm_creator, std:
         }
     }
 
+//! Test that migrations are deferred while particles stay within the migration skin
+void test_communicator_deferred_migration(communicator_creator comm_creator,
+                                         std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,          // number of particles
+                                                             BoxDim(2.0), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    // place one particle in the middle of every box
+    pdata->setPosition(0, make_scalar3(-0.5,-0.5,-0.5),false);
+    pdata->setPosition(1, make_scalar3( 0.5,-0.5,-0.5),false);
+    pdata->setPosition(2, make_scalar3(-0.5, 0.5,-0.5),false);
+    pdata->setPosition(3, make_scalar3( 0.5, 0.5,-0.5),false);
+    pdata->setPosition(4, make_scalar3(-0.5,-0.5, 0.5),false);
+    pdata->setPosition(5, make_scalar3( 0.5,-0.5, 0.5),false);
+    pdata->setPosition(6, make_scalar3(-0.5, 0.5, 0.5),false);
+    pdata->setPosition(7, make_scalar3( 0.5, 0.5, 0.5),false);
+
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf,  pdata->getBox().getL()));
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    CommFlags flags(0);
+    flags[comm_flag::position] = 1;
+    comm->setFlags(flags);
+
+    comm->getGhostLayerWidthRequestSignal().connect<&ghost_layer_width_request_3>();
+    comm->getMigrateSignal().connect<migrate_request>();
+    comm->setMigrationSkin(0.2);
+    comm->setMigrationPeriod(3);
+
+    comm->communicate(0);
+    UP_ASSERT(!comm->hasDeferredMigration());
+
+    // the ghost layer is widened by the skin
+    CHECK_CLOSE(comm->getGhostLayerMaxWidth(), 0.3, tol);
+
+    unsigned int owner_0 = pdata->getOwnerRank(0);
+    unsigned int owner_1 = pdata->getOwnerRank(1);
+    UP_ASSERT(owner_0 != owner_1);
+
+    // move particle 0 into the domain of particle 1, but within the skin
+    pdata->setPosition(0, make_scalar3(0.1,-0.5,-0.5),false);
+
+    // the first two requests only exchange the ghosts
+    comm->communicate(1);
+    UP_ASSERT(comm->hasDeferredMigration());
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(0), owner_0);
+
+    comm->communicate(2);
+    UP_ASSERT(comm->hasDeferredMigration());
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(0), owner_0);
+
+    // every third request migrates
+    comm->communicate(3);
+    UP_ASSERT(!comm->hasDeferredMigration());
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(0), owner_1);
+
+    // a particle beyond the skin migrates immediately
+    pdata->setPosition(1, make_scalar3(-0.3,-0.5,-0.5),false);
+    comm->communicate(4);
+    UP_ASSERT(!comm->hasDeferredMigration());
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(1), owner_0);
+    }
+
+
 //! Test per-type ghost layer
 void test_communicator_ghosts_per_type(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box)
     {
@@ -3593,6 +3677,28 @@ UP_TEST( communicator_ghosts_test)
                                  std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
                                  origin);
         }
+
+    ///////////////////////
+    // quantized version //
+    ///////////////////////
+        {
+        BoxDim box(2.0);
+        test_communicator_ghosts(communicator_creator_base,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
+                                 origin,
+                                 true);
+        }
+        {
+        BoxDim box(1.0,-.6,.7,.5);
+        test_communicator_ghosts(communicator_creator_base,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
+                                 origin,
+                                 true);
+        }
     }
 
 UP_TEST( communicator_bonded_ghosts_test)
@@ -3657,6 +3763,15 @@ UP_TEST( communicator_ghost_layer_width_test)
     test_communicator_ghost_layer_width(communicator_creator_base, exec_conf_cpu);
     }
 
+UP_TEST( communicator_deferred_migration_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_deferred_migration(communicator_creator_base, exec_conf_cpu);
+    }
+
 UP_TEST( communicator_ghost_layer_per_type_test)
     {
     if (!exec_conf_cpu)
@@ -3871,6 +3986,15 @@ UP_TEST( communicator_ghost_layer_width_test_GPU)
     test_communicator_ghost_layer_width(communicator_creator_gpu, exec_conf_gpu);
     }
 
+UP_TEST( communicator_deferred_migration_test_GPU)
+    {
+    if (!exec_conf_gpu)
+        exec_conf_gpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+
+    communicator_creator communicator_creator_gpu = bind(gpu_communicator_creator, _1, _2);
+    test_communicator_deferred_migration(communicator_creator_gpu, exec_conf_gpu);
+    }
+
 UP_TEST( communicator_ghost_layer_per_type_test_GPU)
     {
     if (!exec_conf_gpu)
@@ -0,0 +1,165 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+
+#include "hoomd/md/AllBondPotentials.h"
+#include "hoomd/md/HarmonicAngleForceCompute.h"
+#include "hoomd/md/HarmonicDihedralForceCompute.h"
+#ifdef ENABLE_HIP
+#include "hoomd/md/FusedBondedForceComputeGPU.h"
+#endif
+
+#include <stdio.h>
+
+#include "hoomd/Initializers.h"
+#include "hoomd/SnapshotSystemData.h"
+
+using namespace std;
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN();
+
+#ifdef ENABLE_HIP
+//! Compare the fused bonded forces to the sum of the separate CPU bonded forces
+/*! \param fuse_bond Include the bond term
+    \param fuse_angle Include the angle term
+    \param fuse_dihedral Include the dihedral term
+    \param exec_conf Execution configuration
+*/
+void fused_bonded_comparison_tests(bool fuse_bond,
+                                   bool fuse_angle,
+                                   bool fuse_dihedral,
+                                   std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+
+    // just randomly place particles. We don't really care how huge the forces get: this is just a unit test
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = rand_init.getSnapshot();
+    snap->bond_data.type_mapping.push_back("A");
+    snap->bond_data.type_mapping.push_back("B");
+    snap->angle_data.type_mapping.push_back("A");
+    snap->dihedral_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // chain the particles together with bonds, angles, and dihedrals
+    for (unsigned int i = 0; i < N-1; i++)
+        sysdef->getBondData()->addBondedGroup(Bond(i % 2, i, i+1));
+    for (unsigned int i = 0; i < N-2; i++)
+        sysdef->getAngleData()->addBondedGroup(Angle(0, i, i+1, i+2));
+    for (unsigned int i = 0; i < N-3; i++)
+        sysdef->getDihedralData()->addBondedGroup(Dihedral(0, i, i+1, i+2, i+3));
+
+    // reference computes on the CPU
+    std::vector< std::shared_ptr<ForceCompute> > ref;
+    std::shared_ptr<PotentialBondHarmonic> bond;
+    std::shared_ptr<HarmonicAngleForceComputeGPU> angle;
+    std::shared_ptr<HarmonicDihedralForceComputeGPU> dihedral;
+    if (fuse_bond)
+        {
+        std::shared_ptr<PotentialBondHarmonic> bond_cpu(new PotentialBondHarmonic(sysdef));
+        bond_cpu->setParams(0, harmonic_params(1.5, 0.75));
+        bond_cpu->setParams(1, harmonic_params(3.0, 0.5));
+        ref.push_back(bond_cpu);
+        bond = bond_cpu;
+        }
+    if (fuse_angle)
+        {
+        std::shared_ptr<HarmonicAngleForceCompute> angle_cpu(new HarmonicAngleForceCompute(sysdef));
+        angle_cpu->setParams(0, Scalar(1.5), Scalar(1.2));
+        ref.push_back(angle_cpu);
+        angle = std::shared_ptr<HarmonicAngleForceComputeGPU>(new HarmonicAngleForceComputeGPU(sysdef));
+        angle->setParams(0, Scalar(1.5), Scalar(1.2));
+        }
+    if (fuse_dihedral)
+        {
+        std::shared_ptr<HarmonicDihedralForceCompute> dihedral_cpu(new HarmonicDihedralForceCompute(sysdef));
+        dihedral_cpu->setParams(0, Scalar(3.0), -1, 3, Scalar(0.5));
+        ref.push_back(dihedral_cpu);
+        dihedral = std::shared_ptr<HarmonicDihedralForceComputeGPU>(new HarmonicDihedralForceComputeGPU(sysdef));
+        dihedral->setParams(0, Scalar(3.0), -1, 3, Scalar(0.5));
+        }
+
+    std::shared_ptr<FusedBondedForceComputeGPU> fc(new FusedBondedForceComputeGPU(sysdef, bond, angle, dihedral));
+
+    // compute the forces
+    for (unsigned int k = 0; k < ref.size(); k++)
+        ref[k]->compute(0);
+    fc->compute(0);
+
+    // sum up the reference forces
+    std::vector<Scalar4> ref_force(N, make_scalar4(0, 0, 0, 0));
+    std::vector<Scalar> ref_virial(6*N, Scalar(0.0));
+    for (unsigned int k = 0; k < ref.size(); k++)
+        {
+        GlobalArray<Scalar4>& force_array = ref[k]->getForceArray();
+        GlobalArray<Scalar>& virial_array = ref[k]->getVirialArray();
+        size_t pitch = virial_array.getPitch();
+        ArrayHandle<Scalar4> h_force(force_array, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(virial_array, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            ref_force[i].x += h_force.data[i].x;
+            ref_force[i].y += h_force.data[i].y;
+            ref_force[i].z += h_force.data[i].z;
+            ref_force[i].w += h_force.data[i].w;
+            for (unsigned int j = 0; j < 6; j++)
+                ref_virial[j*N+i] += h_virial.data[j*pitch+i];
+            }
+        }
+
+    // verify that the forces are identical (within roundoff errors)
+    GlobalArray<Scalar4>& force_array = fc->getForceArray();
+    GlobalArray<Scalar>& virial_array = fc->getVirialArray();
+    size_t pitch = virial_array.getPitch();
+    ArrayHandle<Scalar4> h_force(force_array, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(virial_array, access_location::host, access_mode::read);
+
+    // compare average deviation between the two computes
+    double deltaf2 = 0.0;
+    double deltape2 = 0.0;
+    double deltav2[6];
+    for (unsigned int i = 0; i < 6; i++)
+        deltav2[i] = 0.0;
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        deltaf2 += double(h_force.data[i].x - ref_force[i].x) * double(h_force.data[i].x - ref_force[i].x);
+        deltaf2 += double(h_force.data[i].y - ref_force[i].y) * double(h_force.data[i].y - ref_force[i].y);
+        deltaf2 += double(h_force.data[i].z - ref_force[i].z) * double(h_force.data[i].z - ref_force[i].z);
+        deltape2 += double(h_force.data[i].w - ref_force[i].w) * double(h_force.data[i].w - ref_force[i].w);
+        for (unsigned int j = 0; j < 6; j++)
+            deltav2[j] += double(h_virial.data[j*pitch+i] - ref_virial[j*N+i])
+                          * double(h_virial.data[j*pitch+i] - ref_virial[j*N+i]);
+        }
+    deltaf2 /= double(N);
+    deltape2 /= double(N);
+    for (unsigned int j = 0; j < 6; j++)
+        deltav2[j] /= double(N);
+
+    CHECK_SMALL(deltaf2, double(tol_small));
+    CHECK_SMALL(deltape2, double(tol_small));
+    for (unsigned int j = 0; j < 6; j++)
+        CHECK_SMALL(deltav2[j], double(tol_small));
+    }
+
+//! test case for comparing all fused terms to the CPU computes
+UP_TEST( FusedBondedForceComputeGPU_compare )
+    {
+    fused_bonded_comparison_tests(true, true, true,
+        std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
+//! test case for skipping some of the fused terms
+UP_TEST( FusedBondedForceComputeGPU_partial )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+    fused_bonded_comparison_tests(true, false, false, exec_conf);
+    fused_bonded_comparison_tests(false, true, true, exec_conf);
+    }
+#endif
@@ -305,10 +305,68 @@ void bond_force_basic_tests(bondforce_creator bf_creator, std::shared_ptr<Execut
                                        +h_virial_6.data[3*pitch+2]
                                        +h_virial_6.data[5*pitch+2]), 0.375, tol);
     }
+
+    // put the particles in tag order and reorder the bonds to follow them
+    {
+    ArrayHandle<Scalar4> h_pos(pdata_4->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(pdata_4->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata_4->getRTags(), access_location::host, access_mode::readwrite);
+
+    h_pos.data[0].x = 0; h_pos.data[0].y = 1.0; h_pos.data[0].z = 0.0;
+    h_pos.data[1].x = 1.0; h_pos.data[1].y = 1.0; h_pos.data[1].z = 0.0;
+    h_pos.data[2].x = 0.0; h_pos.data[2].y = 0.0; h_pos.data[2].z = 0.0;
+    h_pos.data[3].x = 1.0; h_pos.data[3].y = 0; h_pos.data[3].z = 0.0;
+
+    for (unsigned int i = 0; i < 4; ++i)
+        {
+        h_tag.data[i] = i;
+        h_rtag.data[i] = i;
+        }
+    }
+
+    pdata_4->notifyParticleSort();
+    sysdef_4->getBondData()->sortGroups();
+
+    {
+    // the bonds are ordered by their first member in memory, and the tags still refer to the same bonds
+    std::shared_ptr<BondData> bond_data_4 = sysdef_4->getBondData();
+    UP_ASSERT_EQUAL(bond_data_4->getN(), 3u);
+    ArrayHandle<unsigned int> h_bond_tag(bond_data_4->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_bond_rtag(bond_data_4->getRTags(), access_location::host, access_mode::read);
+    UP_ASSERT_EQUAL(h_bond_tag.data[0], 1u);
+    UP_ASSERT_EQUAL(h_bond_tag.data[1], 2u);
+    UP_ASSERT_EQUAL(h_bond_tag.data[2], 0u);
+    for (unsigned int tag = 0; tag < 3; ++tag)
+        UP_ASSERT_EQUAL(h_bond_tag.data[h_bond_rtag.data[tag]], tag);
+
+    Bond bond_0 = bond_data_4->getGroupByTag(0);
+    UP_ASSERT_EQUAL(bond_0.a, 2u);
+    UP_ASSERT_EQUAL(bond_0.b, 3u);
+    }
+
+    fc_4->compute(1);
+
+    {
+    GlobalArray<Scalar4>& force_array_7 =  fc_4->getForceArray();
+    ArrayHandle<Scalar4> h_force_7(force_array_7,access_location::host,access_mode::read);
+    // the forces are the same as before, now indexed by tag
+    MY_CHECK_CLOSE(h_force_7.data[3].x, 1.125, tol);
+    MY_CHECK_SMALL(h_force_7.data[3].y, tol_small);
+    MY_CHECK_CLOSE(h_force_7.data[1].x, 1.125, tol);
+    MY_CHECK_SMALL(h_force_7.data[1].y, tol_small);
+    MY_CHECK_CLOSE(h_force_7.data[2].x, -1.125, tol);
+    MY_CHECK_CLOSE(h_force_7.data[2].y, -1.125, tol);
+    MY_CHECK_CLOSE(h_force_7.data[0].x, -1.125, tol);
+    MY_CHECK_CLOSE(h_force_7.data[0].y, 1.125, tol);
+    MY_CHECK_CLOSE(h_force_7.data[0].w, 0.421875, tol);
+    }
     }
 
 //! Compares the output of two PotentialBondHarmonics
-void bond_force_comparison_tests(bondforce_creator bf_creator1, bondforce_creator bf_creator2, std::shared_ptr<ExecutionConfiguration> exec_conf)
+/*! \param hub If true, also bond the first particle to every tenth particle so that the GPU bond table is stored in
+               the CSR layout
+*/
+void bond_force_comparison_tests(bondforce_creator bf_creator1, bondforce_creator bf_creator2, std::shared_ptr<ExecutionConfiguration> exec_conf, bool hub=false)
     {
     const unsigned int N = 1000;
 
@@ -332,10 +390,22 @@ void bond_force_comparison_tests(bondforce_creator bf_creator1, bondforce_creato
         sysdef->getBondData()->addBondedGroup(Bond(0, i, i+1));
         }
 
+    if (hub)
+        {
+        for (unsigned int i = 10; i < N; i += 10)
+            {
+            sysdef->getBondData()->addBondedGroup(Bond(0, 0, i));
+            }
+        }
+
     // compute the forces
     fc1->compute(0);
     fc2->compute(0);
 
+    // the bonds of the first particle would leave the padded GPU table mostly empty
+    if (hub && exec_conf->isCUDAEnabled())
+        UP_ASSERT(sysdef->getBondData()->isGPUTableCSR());
+
     // verify that the forces are identical (within roundoff errors)
     {
     GlobalArray<Scalar4>& force_array_7 =  fc1->getForceArray();
@@ -480,6 +550,14 @@ UP_TEST( PotentialBondHarmonicGPU_compare )
     bond_force_comparison_tests(bf_creator, bf_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+//! test case for comparing bond GPU and CPU BondForceComputes with a highly connected particle
+UP_TEST( PotentialBondHarmonicGPU_compare_hub )
+    {
+    bondforce_creator bf_creator_gpu = bind(gpu_bf_creator, _1);
+    bondforce_creator bf_creator = bind(base_class_bf_creator, _1);
+    bond_force_comparison_tests(bf_creator, bf_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), true);
+    }
+
 #endif
 
 //! test case for constant forces
@@ -0,0 +1,122 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+#include "hoomd/md/MultiTauCorrelator.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+/*! \file test_multi_tau_correlator.cc
+    \brief Unit tests of MultiTauCorrelator and BlockAverage
+    \ingroup unit_tests
+*/
+
+//! Test that the lags span the levels geometrically
+UP_TEST( multi_tau_lags )
+    {
+    MultiTauCorrelator correlator(1, 8, 2, 3);
+    std::vector<double> lags = correlator.getLags();
+
+    // level 0 has lags 0..7, levels 1 and 2 have lags 4..7 times 2 and 4
+    double expected[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28};
+    UP_ASSERT_EQUAL(lags.size(), (size_t)16);
+    UP_ASSERT_EQUAL(correlator.getNumLags(), (unsigned int)16);
+    for (unsigned int i = 0; i < 16; i++)
+        MY_CHECK_CLOSE(lags[i], expected[i], tol);
+
+    // no samples have been correlated yet
+    std::vector<double> correlation = correlator.getCorrelation();
+    for (double c : correlation)
+        UP_ASSERT(std::isnan(c));
+    }
+
+//! Test that the level 0 correlation matches the direct computation
+UP_TEST( multi_tau_direct )
+    {
+    const unsigned int n = 200;
+    const unsigned int p = 8;
+    std::vector<double> signal(2*n);
+    for (unsigned int t = 0; t < n; t++)
+        {
+        signal[2*t] = std::sin(0.3*t) + 0.1*t/double(n);
+        signal[2*t+1] = std::cos(0.7*t);
+        }
+
+    MultiTauCorrelator correlator(2, p, 2, 4);
+    for (unsigned int t = 0; t < n; t++)
+        correlator.add(&signal[2*t]);
+
+    std::vector<double> correlation = correlator.getCorrelation();
+    for (unsigned int j = 0; j < p; j++)
+        {
+        double sum = 0.0;
+        for (unsigned int t = j; t < n; t++)
+            sum += signal[2*t]*signal[2*(t-j)] + signal[2*t+1]*signal[2*(t-j)+1];
+        MY_CHECK_CLOSE(correlation[j], sum/double(n-j), tol);
+        }
+
+    // reset removes all samples
+    correlator.reset();
+    correlation = correlator.getCorrelation();
+    for (double c : correlation)
+        UP_ASSERT(std::isnan(c));
+    }
+
+//! Test that a constant signal correlates to its square at all lags
+UP_TEST( multi_tau_constant )
+    {
+    MultiTauCorrelator correlator(1, 16, 4, 3);
+    double value = 1.5;
+    for (unsigned int t = 0; t < 16*16*4; t++)
+        correlator.add(&value);
+
+    std::vector<double> correlation = correlator.getCorrelation();
+    for (double c : correlation)
+        MY_CHECK_CLOSE(c, 2.25, tol);
+    }
+
+//! Test that invalid parameters are rejected
+UP_TEST( multi_tau_invalid )
+    {
+    UP_ASSERT_EXCEPTION(std::invalid_argument, [&]{ MultiTauCorrelator(1, 8, 1, 3); });
+    UP_ASSERT_EXCEPTION(std::invalid_argument, [&]{ MultiTauCorrelator(1, 9, 2, 3); });
+    UP_ASSERT_EXCEPTION(std::invalid_argument, [&]{ MultiTauCorrelator(1, 8, 2, 0); });
+    }
+
+//! Test the mean and the blocking estimate of the error
+UP_TEST( block_average )
+    {
+    BlockAverage average;
+    UP_ASSERT(std::isnan(average.getMean()));
+    UP_ASSERT(std::isnan(average.getStandardError()));
+
+    // an alternating signal is anticorrelated, and the unblocked estimate of the error is the largest
+    const unsigned int n = 1024;
+    for (unsigned int t = 0; t < n; t++)
+        average.add((t % 2 == 0) ? 2.0 : 0.0);
+
+    UP_ASSERT_EQUAL(average.getNumSamples(), (uint64_t)n);
+    MY_CHECK_CLOSE(average.getMean(), 1.0, tol);
+    MY_CHECK_CLOSE(average.getStandardError(), 1.0/std::sqrt(double(n-1)), tol);
+
+    // a signal that is constant over blocks of 64 samples is correlated, which blocking detects
+    BlockAverage blocked;
+    for (unsigned int t = 0; t < n; t++)
+        blocked.add(((t/64) % 2 == 0) ? 2.0 : 0.0);
+
+    MY_CHECK_CLOSE(blocked.getMean(), 1.0, tol);
+    UP_ASSERT(blocked.getStandardError() > 4.0/std::sqrt(double(n-1)));
+
+    blocked.reset();
+    UP_ASSERT_EQUAL(blocked.getNumSamples(), (uint64_t)0);
+    }
@@ -1131,6 +1131,363 @@ void neighborlist_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_c
         }
     }
 
+//! Test that a compressed NeighborList holds the same neighbors, packed with exact counts
+template <class NL>
+void neighborlist_compress_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist1(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist1->getTypePairIndexer().getNumElements(),
+                                               exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist1->addRCutMatrix(r_cut);
+    nlist1->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist2(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->addRCutMatrix(r_cut);
+    nlist2->setStorageMode(NeighborList::full);
+    nlist2->setCompressedStorage(true);
+
+    // exclusions are filtered before the list is packed
+    for (unsigned int i=0; i < pdata->getN()-2; i++)
+        {
+        nlist1->addExclusion(i,i+2);
+        nlist2->addExclusion(i,i+2);
+        }
+
+    // build twice, so that the second build starts from the packed list
+    for (unsigned int timestep = 0; timestep < 2; ++timestep)
+        {
+        nlist1->forceUpdate();
+        nlist2->forceUpdate();
+        nlist1->compute(timestep);
+        nlist2->compute(timestep);
+
+        ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+
+        unsigned int head = 0;
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            // the packed list has no gaps
+            UP_ASSERT_EQUAL(h_head_list2.data[i], head);
+            UP_ASSERT_EQUAL(h_n_neigh2.data[i], h_n_neigh1.data[i]);
+            head += h_n_neigh2.data[i];
+
+            std::vector<unsigned int> ref_list(h_nlist1.data + h_head_list1.data[i],
+                                               h_nlist1.data + h_head_list1.data[i] + h_n_neigh1.data[i]);
+            std::vector<unsigned int> test_list(h_nlist2.data + h_head_list2.data[i],
+                                                h_nlist2.data + h_head_list2.data[i] + h_n_neigh2.data[i]);
+            std::sort(ref_list.begin(), ref_list.end());
+            std::sort(test_list.begin(), test_list.end());
+            UP_ASSERT(ref_list == test_list);
+            }
+        }
+    }
+
+//! Test that a NeighborList sorted by distance holds the same neighbors and counts the prefix of each consumer
+template <class NL>
+void neighborlist_sort_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist1(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    auto r_cut_long = std::make_shared<GlobalArray<Scalar>>(nlist1->getTypePairIndexer().getNumElements(),
+                                                            exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut_long, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    auto r_cut_short = std::make_shared<GlobalArray<Scalar>>(nlist1->getTypePairIndexer().getNumElements(),
+                                                             exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut_short, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 1.5;
+        }
+    nlist1->addRCutMatrix(r_cut_long);
+    nlist1->addRCutMatrix(r_cut_short);
+    nlist1->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist2(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->addRCutMatrix(r_cut_long);
+    nlist2->addRCutMatrix(r_cut_short);
+    nlist2->setStorageMode(NeighborList::full);
+    nlist2->setSortByDistance(true);
+
+    nlist1->compute(0);
+    nlist2->compute(0);
+
+    // without sorting, every consumer traverses the full list
+    UP_ASSERT(&nlist1->getConsumerNNeighArray(r_cut_short) == &nlist1->getNNeighArray());
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh_long(nlist2->getConsumerNNeighArray(r_cut_long), access_location::host,
+                                             access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh_short(nlist2->getConsumerNNeighArray(r_cut_short), access_location::host,
+                                              access_mode::read);
+
+    // the short consumer sees all neighbors within its cutoff plus the buffer
+    const BoxDim& box = pdata->getBox();
+    const Scalar r_list_shortsq = Scalar(1.9*1.9);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        UP_ASSERT_EQUAL(h_n_neigh2.data[i], h_n_neigh1.data[i]);
+        UP_ASSERT_EQUAL(h_n_neigh_long.data[i], h_n_neigh2.data[i]);
+
+        std::vector<unsigned int> ref_list(h_nlist1.data + h_head_list1.data[i],
+                                           h_nlist1.data + h_head_list1.data[i] + h_n_neigh1.data[i]);
+        std::vector<unsigned int> test_list(h_nlist2.data + h_head_list2.data[i],
+                                            h_nlist2.data + h_head_list2.data[i] + h_n_neigh2.data[i]);
+
+        Scalar3 pos_i = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        Scalar last_rsq = Scalar(0.0);
+        for (unsigned int k = 0; k < test_list.size(); k++)
+            {
+            unsigned int j = test_list[k];
+            Scalar3 dx = box.minImage(pos_i - make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z));
+            Scalar rsq = dot(dx, dx);
+            UP_ASSERT(rsq >= last_rsq);
+            last_rsq = rsq;
+
+            if (rsq < r_list_shortsq)
+                UP_ASSERT(k < h_n_neigh_short.data[i]);
+            else
+                UP_ASSERT(k >= h_n_neigh_short.data[i]);
+            }
+
+        std::sort(ref_list.begin(), ref_list.end());
+        std::sort(test_list.begin(), test_list.end());
+        UP_ASSERT(ref_list == test_list);
+        }
+    }
+
+//! Test that the NeighborList follows a permutation of the particles without a rebuild
+template <class NL>
+void neighborlist_remap_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist->getTypePairIndexer().getNumElements(),
+                                                       exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist->addRCutMatrix(r_cut);
+    nlist->setStorageMode(NeighborList::full);
+    nlist->addExclusion(0, 1);
+
+    // record the neighbors of each particle by tag
+    auto neighbor_tags = [&]()
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist(nlist->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list(nlist->getHeadList(), access_location::host, access_mode::read);
+
+        std::vector< std::vector<unsigned int> > neighbors(pdata->getN());
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            std::vector<unsigned int>& list = neighbors[h_tag.data[i]];
+            for (unsigned int k = 0; k < h_n_neigh.data[i]; k++)
+                list.push_back(h_tag.data[h_nlist.data[h_head_list.data[i] + k]]);
+            std::sort(list.begin(), list.end());
+            }
+        return neighbors;
+        };
+
+    nlist->compute(0);
+    UP_ASSERT_EQUAL(nlist->getNumUpdates(), (uint64_t)1);
+    std::vector< std::vector<unsigned int> > ref_neighbors = neighbor_tags();
+
+    // reverse the order of the particles
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+        const unsigned int N = pdata->getN();
+        std::reverse(h_pos.data, h_pos.data + N);
+        std::reverse(h_tag.data, h_tag.data + N);
+        for (unsigned int i = 0; i < N; i++)
+            h_rtag.data[h_tag.data[i]] = i;
+        }
+    pdata->notifyParticleSort(true);
+
+    // the list is remapped, not rebuilt
+    nlist->compute(1);
+    UP_ASSERT_EQUAL(nlist->getNumUpdates(), (uint64_t)1);
+    UP_ASSERT(neighbor_tags() == ref_neighbors);
+
+    // the remapped list builds correctly
+    nlist->forceUpdate();
+    nlist->compute(2);
+    UP_ASSERT_EQUAL(nlist->getNumUpdates(), (uint64_t)2);
+    UP_ASSERT(neighbor_tags() == ref_neighbors);
+
+    // any other change to the particle data forces a rebuild
+    pdata->notifyParticleSort();
+    nlist->compute(3);
+    UP_ASSERT_EQUAL(nlist->getNumUpdates(), (uint64_t)3);
+    UP_ASSERT(neighbor_tags() == ref_neighbors);
+
+    // the exclusions by index follow the new order of the particles
+        {
+        ArrayHandle<unsigned int> h_n_ex(nlist->getNExArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_ex_list(nlist->getExListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+        Index2D exli = nlist->getExListIndexer();
+
+        const unsigned int idx0 = h_rtag.data[0];
+        const unsigned int idx1 = h_rtag.data[1];
+        UP_ASSERT_EQUAL(h_n_ex.data[idx0], (unsigned int)1);
+        UP_ASSERT_EQUAL(h_n_ex.data[idx1], (unsigned int)1);
+        UP_ASSERT_EQUAL(h_ex_list.data[exli(idx0, 0)], idx1);
+        UP_ASSERT_EQUAL(h_ex_list.data[exli(idx1, 0)], idx0);
+        }
+    }
+
+//! Test that adaptive checks build the NeighborList on the same steps as checks on every step
+template <class NL>
+void neighborlist_adaptive_check_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // two particles in a huge box, one of them moving at a constant speed
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(2, BoxDim(25.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+
+    h_pos.data[0].x = h_pos.data[0].y = h_pos.data[0].z = 0.0;
+    h_pos.data[1].x = 1.0; h_pos.data[1].y = h_pos.data[1].z = 0.0;
+
+    h_pos.data[0].w = 0.0; h_pos.data[1].w = 0.0;
+    pdata->notifyParticleSort();
+    }
+
+    std::shared_ptr<NeighborList> nlist1(new NL(sysdef, 3.0, 0.4));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist1->getTypePairIndexer().getNumElements(),
+                                               exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist1->addRCutMatrix(r_cut);
+
+    std::shared_ptr<NeighborList> nlist2(new NL(sysdef, 3.0, 0.4));
+    nlist2->addRCutMatrix(r_cut);
+    nlist2->setAdaptiveCheck(true);
+    UP_ASSERT(nlist2->getAdaptiveCheck());
+
+    for (unsigned int timestep = 0; timestep < 200; ++timestep)
+        {
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            h_pos.data[1].x = Scalar(1.0) + Scalar(0.01)*Scalar(timestep);
+            }
+
+        nlist1->compute(timestep);
+        nlist2->compute(timestep);
+        UP_ASSERT_EQUAL(nlist2->getNumUpdates(), nlist1->getNumUpdates());
+        }
+
+    // the particle moves half the buffer in 20 steps, checks start half way
+    UP_ASSERT(nlist1->getNumUpdates() > 5);
+    UP_ASSERT_EQUAL(nlist1->getCheckDelay(), (uint64_t)0);
+    UP_ASSERT(nlist2->getCheckDelay() >= (uint64_t)9);
+    UP_ASSERT(nlist2->getCheckDelay() <= (uint64_t)10);
+    }
+
+//! Test that the scaled distance check keeps the list through an affine shear of the box
+template <class NL>
+void neighborlist_scaled_check_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // two particles in a box that is sheared slowly, following the deformation
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(2, BoxDim(10.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+
+    h_pos.data[0].x = h_pos.data[0].y = h_pos.data[0].z = 0.0;
+    h_pos.data[1].x = 0.5; h_pos.data[1].y = 2.0; h_pos.data[1].z = 0.0;
+
+    h_pos.data[0].w = 0.0; h_pos.data[1].w = 0.0;
+    pdata->notifyParticleSort();
+    }
+
+    std::shared_ptr<NeighborList> nlist1(new NL(sysdef, 3.0, 0.4));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist1->getTypePairIndexer().getNumElements(),
+                                               exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist1->addRCutMatrix(r_cut);
+    nlist1->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist2(new NL(sysdef, 3.0, 0.4));
+    nlist2->addRCutMatrix(r_cut);
+    nlist2->setStorageMode(NeighborList::full);
+    nlist2->setScaledCheck(true);
+    UP_ASSERT(nlist2->getScaledCheck());
+
+    BoxDim box0 = pdata->getGlobalBox();
+    const Scalar3 f1 = box0.makeFraction(make_scalar3(0.5, 2.0, 0.0));
+    for (unsigned int timestep = 0; timestep < 100; ++timestep)
+        {
+        BoxDim box(10.0, 10.0, 10.0);
+        box.setTiltFactors(Scalar(0.002)*Scalar(timestep), 0.0, 0.0);
+        pdata->setGlobalBox(box);
+
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            Scalar3 pos = box.makeCoordinates(f1);
+            Scalar3 origin = box.makeCoordinates(box0.makeFraction(make_scalar3(0.0, 0.0, 0.0)));
+            h_pos.data[0].x = origin.x; h_pos.data[0].y = origin.y; h_pos.data[0].z = origin.z;
+            h_pos.data[1].x = pos.x; h_pos.data[1].y = pos.y; h_pos.data[1].z = pos.z;
+            }
+
+        nlist1->compute(timestep);
+        nlist2->compute(timestep);
+
+        ArrayHandle<unsigned int> h_n_neigh(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL(h_n_neigh.data[0], 1);
+        UP_ASSERT_EQUAL(h_n_neigh.data[1], 1);
+        }
+
+    // the shear displaces the particles from their scaled positions only in the unscaled check
+    UP_ASSERT(nlist1->getNumUpdates() > 1);
+    UP_ASSERT_EQUAL(nlist2->getNumUpdates(), (uint64_t)1);
+    }
+
 //! Test that a NeighborList can successfully exclude a ridiculously large number of particles
 template <class NL>
 void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1182,6 +1539,49 @@ void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_co
         }
     }
 
+//! Test that exclusions added in bulk and from the bond topology match the expected pairs
+template <class NL>
+void neighborlist_bulk_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a chain of bonds 0-1-2-3 and a branch 1-4
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(6, BoxDim(20.0), 1, 1, 0, 0, 0, exec_conf));
+    sysdef->getBondData()->addBondedGroup(Bond(0, 0, 1));
+    sysdef->getBondData()->addBondedGroup(Bond(0, 1, 2));
+    sysdef->getBondData()->addBondedGroup(Bond(0, 2, 3));
+    sysdef->getBondData()->addBondedGroup(Bond(0, 1, 4));
+
+    std::shared_ptr<NeighborList> nlist(new NL(sysdef, Scalar(3.0), Scalar(0.25)));
+
+    // duplicates, reversed pairs, and pairs excluded before are added once
+    nlist->addExclusion(0, 5);
+    std::vector< std::pair<unsigned int, unsigned int> > pairs = {{0, 5}, {5, 0}, {0, 1}, {2, 5}, {1, 0}};
+    nlist->addExclusions(pairs);
+
+    UP_ASSERT(nlist->isExcluded(0, 5));
+    UP_ASSERT(nlist->isExcluded(5, 0));
+    UP_ASSERT(nlist->isExcluded(1, 0));
+    UP_ASSERT(nlist->isExcluded(5, 2));
+    UP_ASSERT(!nlist->isExcluded(1, 5));
+    UP_ASSERT_EQUAL(nlist->getNumExclusions(2), 2u);
+    UP_ASSERT_EQUAL(nlist->getNumExclusions(1), 2u);
+
+    nlist->clearExclusions();
+    nlist->addOneThreeExclusionsFromTopology();
+    UP_ASSERT(nlist->isExcluded(0, 2));
+    UP_ASSERT(nlist->isExcluded(0, 4));
+    UP_ASSERT(nlist->isExcluded(2, 4));
+    UP_ASSERT(nlist->isExcluded(1, 3));
+    UP_ASSERT(!nlist->isExcluded(0, 1));
+    UP_ASSERT(!nlist->isExcluded(0, 3));
+
+    nlist->clearExclusions();
+    nlist->addOneFourExclusionsFromTopology();
+    UP_ASSERT(nlist->isExcluded(0, 3));
+    UP_ASSERT(nlist->isExcluded(3, 4));
+    UP_ASSERT(!nlist->isExcluded(0, 2));
+    UP_ASSERT(!nlist->isExcluded(0, 4));
+    }
+
 //! Test that NeighborList can exclude particles correctly when cutoff radius is negative
 template <class NL>
 void neighborlist_cutoff_exclude_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1449,6 +1849,11 @@ UP_TEST( NeighborListBinned_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! bulk exclusion test case for binned class
+UP_TEST( NeighborListBinned_bulk_ex )
+    {
+    neighborlist_bulk_ex_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for binned class
 UP_TEST( NeighborListBinned_body_filter)
     {
@@ -1474,6 +1879,31 @@ UP_TEST( NeighborListBinned_cutoff_exclude )
     {
     neighborlist_cutoff_exclude_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! compressed storage test case for binned class
+UP_TEST( NeighborListBinned_compress )
+    {
+    neighborlist_compress_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! sort by distance test case for binned class
+UP_TEST( NeighborListBinned_sort )
+    {
+    neighborlist_sort_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! adaptive check test case for binned class
+UP_TEST( NeighborListBinned_adaptive_check )
+    {
+    neighborlist_adaptive_check_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! scaled check test case for binned class
+UP_TEST( NeighborListBinned_scaled_check )
+    {
+    neighborlist_scaled_check_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! remap test case for binned class
+UP_TEST( NeighborListBinned_remap )
+    {
+    neighborlist_remap_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! type test case for binned class
 UP_TEST( NeighborListBinned_type )
     {
@@ -1649,6 +2079,31 @@ UP_TEST( NeighborListGPUBinned_cutoff_exclude )
     {
     neighborlist_cutoff_exclude_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! compressed storage test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_compress )
+    {
+    neighborlist_compress_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+//! sort by distance test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_sort )
+    {
+    neighborlist_sort_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+//! adaptive check test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_adaptive_check )
+    {
+    neighborlist_adaptive_check_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+//! scaled check test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_scaled_check )
+    {
+    neighborlist_scaled_check_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+//! remap test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_remap )
+    {
+    neighborlist_remap_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 //! type test case for GPUBinned class
 UP_TEST( NeighborListGPUBinned_type )
     {
@@ -1665,6 +2120,94 @@ UP_TEST( NeighborListGPUBinned_comparison )
     neighborlist_comparison_test<NeighborListBinned, NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+//! Test that the out of core neighbor list streams the same neighbors as the resident list
+void neighborlist_out_of_core_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborListGPUBinned> nlist1(new NeighborListGPUBinned(sysdef, Scalar(3.0), Scalar(0.4)));
+    auto r_cut = std::make_shared<GlobalArray<Scalar>>(nlist1->getTypePairIndexer().getNumElements(),
+                                               exec_conf);
+        {
+        ArrayHandle<Scalar> h_r_cut(*r_cut, access_location::host, access_mode::overwrite);
+        h_r_cut.data[0] = 3.0;
+        }
+    nlist1->addRCutMatrix(r_cut);
+    nlist1->setStorageMode(NeighborList::full);
+
+    // the last chunk is smaller than the others
+    std::shared_ptr<NeighborListGPUBinned> nlist2(new NeighborListGPUBinned(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->addRCutMatrix(r_cut);
+    nlist2->setStorageMode(NeighborList::full);
+    nlist2->setOutOfCore(300);
+    UP_ASSERT_EQUAL(nlist2->getOutOfCore(), (unsigned int)300);
+
+    // exclusions are filtered chunk by chunk
+    for (unsigned int i=0; i < pdata->getN()-2; i++)
+        {
+        nlist1->addExclusion(i,i+2);
+        nlist2->addExclusion(i,i+2);
+        }
+
+    nlist1->compute(0);
+    nlist2->compute(0);
+
+    // only the pair potentials can read the out of core list
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ nlist2->getNListArray(); });
+
+    // copy the chunks back to the host in the order of the particles
+    std::vector< std::vector<unsigned int> > test_lists(pdata->getN());
+        {
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+
+        unsigned int n_chunks = 0;
+        nlist2->streamChunks([&](const unsigned int *d_nlist, const GPUPartition& chunk, hipStream_t stream)
+            {
+            auto range = chunk.getRange(0);
+            UP_ASSERT_EQUAL(range.first, 300*n_chunks);
+            n_chunks++;
+
+            unsigned int size = 0;
+            for (unsigned int i = range.first; i < range.second; i++)
+                size = std::max(size, h_head_list2.data[i] + h_n_neigh2.data[i]);
+
+            std::vector<unsigned int> h_chunk(size);
+            hipStreamSynchronize(stream);
+            hipMemcpy(h_chunk.data(), d_nlist, sizeof(unsigned int)*size, hipMemcpyDeviceToHost);
+
+            for (unsigned int i = range.first; i < range.second; i++)
+                test_lists[i].assign(h_chunk.begin() + h_head_list2.data[i],
+                                     h_chunk.begin() + h_head_list2.data[i] + h_n_neigh2.data[i]);
+            }, 0);
+        hipDeviceSynchronize();
+        UP_ASSERT_EQUAL(n_chunks, (unsigned int)4);
+        }
+
+    ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        std::vector<unsigned int> ref_list(h_nlist1.data + h_head_list1.data[i],
+                                           h_nlist1.data + h_head_list1.data[i] + h_n_neigh1.data[i]);
+        std::sort(ref_list.begin(), ref_list.end());
+        std::sort(test_lists[i].begin(), test_lists[i].end());
+        UP_ASSERT(ref_list == test_lists[i]);
+        }
+    }
+
+//! out of core test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_out_of_core )
+    {
+    neighborlist_out_of_core_tests(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
 ///////////////
 // STENCIL GPU
 ///////////////
@@ -434,6 +434,133 @@ void nve_updater_aniso_test(std::shared_ptr<ExecutionConfiguration> exec_conf, t
         }
     }
 
+//! Check that the post step modifiers keep the particles in the plane and remove the momentum
+void nve_updater_post_step_tests(twostepnve_creator nve_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(2, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    sysdef->setNDimensions(2);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterTag(sysdef, 0, pdata->getN()-1));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_pos.data[0].x = -1.0; h_pos.data[0].y = 0.0; h_pos.data[0].z = 0.0;
+    h_vel.data[0].x = 1.0; h_vel.data[0].y = 2.0; h_vel.data[0].z = 3.0;
+    h_pos.data[1].x = 1.0; h_pos.data[1].y = 0.0; h_pos.data[1].z = 0.0;
+    h_vel.data[1].x = 3.0; h_vel.data[1].y = 2.0; h_vel.data[1].z = 1.0;
+    h_vel.data[1].w = 2.0;
+    }
+
+    std::shared_ptr<TwoStepNVE> two_step_nve = nve_creator(sysdef, group_all);
+    PostStepModifiers modifiers;
+    modifiers.flags = PostStepModifiers::enforce_2d | PostStepModifiers::zero_momentum;
+    two_step_nve->setPostStepModifiers(modifiers);
+
+    std::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, Scalar(0.001)));
+    nve_up->addIntegrationMethod(two_step_nve);
+    std::shared_ptr<ConstForceCompute> fc(new ConstForceCompute(sysdef, 1.0, 0.5, 2.0));
+    nve_up->addForceCompute(fc);
+    nve_up->prepRun(0);
+
+    for (int i = 0; i < 10; i++)
+        nve_up->update(i);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_accel(pdata->getAccelerations(), access_location::host, access_mode::read);
+
+    Scalar3 p = make_scalar3(0.0, 0.0, 0.0);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        MY_CHECK_SMALL(h_pos.data[i].z, tol_small);
+        MY_CHECK_SMALL(h_vel.data[i].z, tol_small);
+        MY_CHECK_SMALL(h_accel.data[i].z, tol_small);
+        p.x += h_vel.data[i].w*h_vel.data[i].x;
+        p.y += h_vel.data[i].w*h_vel.data[i].y;
+        p.z += h_vel.data[i].w*h_vel.data[i].z;
+        }
+
+    MY_CHECK_SMALL(p.x, tol_small);
+    MY_CHECK_SMALL(p.y, tol_small);
+    MY_CHECK_SMALL(p.z, tol_small);
+
+    // methods that do not apply the modifiers reject them
+    std::shared_ptr<IntegrationMethodTwoStep> method(new IntegrationMethodTwoStep(sysdef, group_all));
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{method->setPostStepModifiers(modifiers);});
+    }
+
+//! Check that two methods with different options are advanced correctly by the fused first step
+void nve_updater_fused_tests(twostepnve_creator nve_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // particle 0 is integrated normally, particle 1 is constrained to the x axis and particle 2 is not integrated
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(3, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<ParticleFilter> selector_a(new ParticleFilterTag(sysdef, 0, 0));
+    std::shared_ptr<ParticleGroup> group_a(new ParticleGroup(sysdef, selector_a));
+    std::shared_ptr<ParticleFilter> selector_b(new ParticleFilterTag(sysdef, 1, 1));
+    std::shared_ptr<ParticleGroup> group_b(new ParticleGroup(sysdef, selector_b));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int j = 0; j < 3; j++)
+        {
+        h_pos.data[j].x = Scalar(j);
+        h_pos.data[j].y = 0.0;
+        h_pos.data[j].z = 0.0;
+        h_vel.data[j].x = 1.0;
+        h_vel.data[j].y = 0.0;
+        h_vel.data[j].z = 0.0;
+        }
+    }
+
+    Scalar deltaT = Scalar(0.001);
+    std::shared_ptr<TwoStepNVE> two_step_nve_a = nve_creator(sysdef, group_a);
+    std::shared_ptr<TwoStepNVE> two_step_nve_b = nve_creator(sysdef, group_b);
+    PostStepModifiers modifiers;
+    modifiers.flags = PostStepModifiers::one_d;
+    modifiers.line = make_scalar3(1.0, 0.0, 0.0);
+    two_step_nve_b->setPostStepModifiers(modifiers);
+
+    std::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, deltaT));
+    nve_up->addIntegrationMethod(two_step_nve_a);
+    nve_up->addIntegrationMethod(two_step_nve_b);
+
+    std::shared_ptr<ConstForceCompute> fc1(new ConstForceCompute(sysdef, 1.0, 2.0, 0.0));
+    nve_up->addForceCompute(fc1);
+
+    nve_up->prepRun(0);
+
+    for (int i = 0; i < 100; i++)
+        nve_up->update(i);
+
+    // velocity verlet is exact for a constant force
+    Scalar t = Scalar(100)*deltaT;
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+    unsigned int a = h_rtag.data[0];
+    MY_CHECK_CLOSE(h_pos.data[a].x, 0.0 + t + Scalar(0.5)*t*t, tol);
+    MY_CHECK_CLOSE(h_pos.data[a].y, Scalar(0.5)*Scalar(2.0)*t*t, tol);
+    MY_CHECK_CLOSE(h_vel.data[a].x, 1.0 + t, tol);
+    MY_CHECK_CLOSE(h_vel.data[a].y, Scalar(2.0)*t, tol);
+
+    unsigned int b = h_rtag.data[1];
+    MY_CHECK_CLOSE(h_pos.data[b].x, 1.0 + t + Scalar(0.5)*t*t, tol);
+    MY_CHECK_SMALL(h_pos.data[b].y, tol_small);
+    MY_CHECK_CLOSE(h_vel.data[b].x, 1.0 + t, tol);
+    MY_CHECK_SMALL(h_vel.data[b].y, tol_small);
+
+    unsigned int c = h_rtag.data[2];
+    MY_CHECK_CLOSE(h_pos.data[c].x, 2.0, tol);
+    MY_CHECK_CLOSE(h_vel.data[c].x, 1.0, tol);
+    }
+
 //! TwoStepNVE factory for the unit tests
 std::shared_ptr<TwoStepNVE> base_class_nve_creator(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleGroup> group)
     {
@@ -470,6 +597,20 @@ UP_TEST( TwoStepNVE_boundary_tests )
     nve_updater_boundary_tests(nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for the post step modifiers
+UP_TEST( TwoStepNVE_post_step_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_post_step_tests(nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test case for the fused first step
+UP_TEST( TwoStepNVE_fused_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_fused_tests(nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 //! Performs a basic equilibration test of TwoStepNVE
 UP_TEST( TwoStepNVE_aniso_test )
     {
@@ -499,6 +640,20 @@ UP_TEST( TwoStepNVEGPU_boundary_tests )
     nve_updater_boundary_tests(nve_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+//! test case for the post step modifiers
+UP_TEST( TwoStepNVEGPU_post_step_tests )
+    {
+    twostepnve_creator nve_creator_gpu = bind(gpu_nve_creator, _1, _2);
+    nve_updater_post_step_tests(nve_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
+//! test case for the fused first step
+UP_TEST( TwoStepNVEGPU_fused_tests )
+    {
+    twostepnve_creator nve_creator_gpu = bind(gpu_nve_creator, _1, _2);
+    nve_updater_fused_tests(nve_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
 //! test case for comparing the GPU and CPU NVEUpdaters
 UP_TEST( TwoStepNVEGPU_comparison_tests)
     {
@@ -0,0 +1,117 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifdef ENABLE_MPI
+
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN()
+
+#include "hoomd/System.h"
+
+#include <memory>
+#include <vector>
+
+#include "hoomd/md/PencilFFT.h"
+#include "hoomd/extern/kiss_fftnd.h"
+
+//! Compare the distributed transform against a local transform of the global mesh
+void test_pencil_fft(std::shared_ptr<ExecutionConfiguration> exec_conf, unsigned int n_ranks)
+    {
+    // create a system with eight particles
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,           // number of particles
+                                                             BoxDim(2.0), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL()));
+    pdata->setDomainDecomposition(decomposition);
+
+    // a brick with a ghost layer
+    uint3 dim = make_uint3(8, 4, 2);
+    uint3 ghost = make_uint3(1, 2, 1);
+    uint3 embed = make_uint3(dim.x+2*ghost.x, dim.y+2*ghost.y, dim.z+2*ghost.z);
+    unsigned int offset = (ghost.z*embed.y + ghost.y)*embed.x + ghost.x;
+
+    const Index3D& di = decomposition->getDomainIndexer();
+    uint3 global_dim = make_uint3(dim.x*di.getW(), dim.y*di.getH(), dim.z*di.getD());
+    uint3 pos = decomposition->getGridPos();
+
+    // the global mesh is known on every rank
+    std::vector<kiss_fft_cpx> global_mesh(global_dim.x*global_dim.y*global_dim.z);
+    for (unsigned int i = 0; i < global_mesh.size(); ++i)
+        {
+        global_mesh[i].r = float(sin(0.1*i));
+        global_mesh[i].i = float(cos(0.3*i));
+        }
+
+    std::vector<kiss_fft_cpx> global_fourier_mesh(global_mesh.size());
+    int dims[3] = {(int)global_dim.z, (int)global_dim.y, (int)global_dim.x};
+    kiss_fftnd_cfg cfg = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
+    kiss_fftnd(cfg, &global_mesh.front(), &global_fourier_mesh.front());
+    kiss_fft_free(cfg);
+
+    std::vector<kiss_fft_cpx> mesh(embed.x*embed.y*embed.z);
+    for (unsigned int z = 0; z < dim.z; ++z)
+        for (unsigned int y = 0; y < dim.y; ++y)
+            for (unsigned int x = 0; x < dim.x; ++x)
+                {
+                unsigned int gx = pos.x*dim.x + x;
+                unsigned int gy = pos.y*dim.y + y;
+                unsigned int gz = pos.z*dim.z + z;
+                mesh[offset + (z*embed.y + y)*embed.x + x] = global_mesh[(gz*global_dim.y + gy)*global_dim.x + gx];
+                }
+
+    PencilFFT fft(sysdef, dim, embed, n_ranks);
+
+    std::vector<kiss_fft_cpx> fourier_mesh(dim.x*dim.y*dim.z);
+    fft.forward(&mesh.front() + offset, &fourier_mesh.front());
+
+    // the transform is returned in the local brick
+    for (unsigned int z = 0; z < dim.z; ++z)
+        for (unsigned int y = 0; y < dim.y; ++y)
+            for (unsigned int x = 0; x < dim.x; ++x)
+                {
+                unsigned int gx = pos.x*dim.x + x;
+                unsigned int gy = pos.y*dim.y + y;
+                unsigned int gz = pos.z*dim.z + z;
+                kiss_fft_cpx val = fourier_mesh[(z*dim.y + y)*dim.x + x];
+                kiss_fft_cpx ref = global_fourier_mesh[(gz*global_dim.y + gy)*global_dim.x + gx];
+                UP_ASSERT_SMALL(val.r - ref.r, 1e-3);
+                UP_ASSERT_SMALL(val.i - ref.i, 1e-3);
+                }
+
+    // the inverse transform recovers the input, up to normalization
+    std::vector<kiss_fft_cpx> inv_mesh(mesh.size());
+    fft.inverse(&fourier_mesh.front(), &inv_mesh.front() + offset);
+
+    float N = float(global_mesh.size());
+    for (unsigned int z = 0; z < dim.z; ++z)
+        for (unsigned int y = 0; y < dim.y; ++y)
+            for (unsigned int x = 0; x < dim.x; ++x)
+                {
+                unsigned int idx = offset + (z*embed.y + y)*embed.x + x;
+                UP_ASSERT_SMALL(inv_mesh[idx].r/N - mesh[idx].r, 1e-4);
+                UP_ASSERT_SMALL(inv_mesh[idx].i/N - mesh[idx].i, 1e-4);
+                }
+    }
+
+//! Pencil FFT on all ranks
+UP_TEST( PencilFFT_test_all_ranks )
+    {
+    test_pencil_fft(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 0);
+    }
+
+//! Pencil FFT on a subset of the ranks
+UP_TEST( PencilFFT_test_rank_subset )
+    {
+    test_pencil_fft(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 3);
+    }
+
+#endif //ENABLE_MPI
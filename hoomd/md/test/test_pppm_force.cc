@@ -200,6 +200,136 @@ void pppm_force_particle_test_triclinic(pppmforce_creator pppm_creator, std::sha
     }
 
 
+//! Test that the rescaled influence function after a small box change matches the full computation
+void pppm_force_box_change_test(pppmforce_creator pppm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef_2(new SystemDefinition(2, BoxDim(6.0, 10.0, 14.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_2 = sysdef_2->getParticleData();
+    pdata_2->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist_2(new NeighborListTree(sysdef_2, Scalar(1.0), Scalar(1.0)));
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterTags(std::vector<unsigned int>({0, 1})));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef_2, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata_2->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata_2->getCharges(), access_location::host, access_mode::readwrite);
+
+    h_pos.data[0].x = h_pos.data[0].y = h_pos.data[0].z = 1.0;
+    h_charge.data[0] = 1.0;
+    h_pos.data[1].x = h_pos.data[1].y = h_pos.data[1].z = 2.0;
+    h_charge.data[1] = -1.0;
+    }
+
+    // fc_full computes the influence function in full after every box change, fc_rescale rescales it
+    std::shared_ptr<PPPMForceCompute> fc_full = pppm_creator(sysdef_2, nlist_2, group_all);
+    std::shared_ptr<PPPMForceCompute> fc_rescale = pppm_creator(sysdef_2, nlist_2, group_all);
+    fc_full->setParams(10, 15, 24, 5, 1.0, 1.0);
+    fc_rescale->setParams(10, 15, 24, 5, 1.0, 1.0);
+    fc_rescale->setBoxChangeTolerance(0.01);
+
+    fc_full->compute(0);
+    fc_rescale->compute(0);
+
+    // deform the box within the tolerance
+    BoxDim new_box(6.02, 10.05, 13.97);
+    new_box.setTiltFactors(0.005, 0.0, 0.0);
+    pdata_2->setGlobalBox(new_box);
+
+    fc_full->compute(1);
+    fc_rescale->compute(1);
+
+        {
+        ArrayHandle<Scalar4> h_force_full(fc_full->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_force_rescale(fc_rescale->getForceArray(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < 2; ++i)
+            {
+            MY_CHECK_CLOSE(h_force_rescale.data[i].x, h_force_full.data[i].x, tol);
+            MY_CHECK_CLOSE(h_force_rescale.data[i].y, h_force_full.data[i].y, tol);
+            MY_CHECK_CLOSE(h_force_rescale.data[i].z, h_force_full.data[i].z, tol);
+            }
+        MY_CHECK_CLOSE(fc_rescale->getExternalEnergy(), fc_full->getExternalEnergy(), tol);
+        }
+
+    // a box change beyond the tolerance computes the influence function in full again
+    pdata_2->setGlobalBox(BoxDim(6.3, 10.0, 14.0));
+
+    fc_full->compute(2);
+    fc_rescale->compute(2);
+
+    ArrayHandle<Scalar4> h_force_full(fc_full->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_force_rescale(fc_rescale->getForceArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < 2; ++i)
+        {
+        MY_CHECK_CLOSE(h_force_rescale.data[i].x, h_force_full.data[i].x, tol_small);
+        MY_CHECK_CLOSE(h_force_rescale.data[i].y, h_force_full.data[i].y, tol_small);
+        MY_CHECK_CLOSE(h_force_rescale.data[i].z, h_force_full.data[i].z, tol_small);
+        }
+    }
+
+
+//! Compare the charge assignment methods selected by the autotuner to the CPU reference
+void pppm_force_assign_compare_test(pppmforce_creator pppm_creator_1,
+                                    pppmforce_creator pppm_creator_2,
+                                    std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 8;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(6.0, 10.0, 14.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(1.0), Scalar(1.0)));
+    std::vector<unsigned int> tags;
+    for (unsigned int i = 0; i < N; ++i)
+        tags.push_back(i);
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterTags(tags));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::readwrite);
+
+    // pairs of particles share a mesh cell, some are close to the box boundary
+    Scalar3 pos[N] = {make_scalar3(1.0, 1.0, 1.0), make_scalar3(1.1, 1.05, 0.95),
+                      make_scalar3(-2.0, 3.0, -5.0), make_scalar3(-2.05, 3.1, -5.1),
+                      make_scalar3(2.9, -4.9, 6.9), make_scalar3(-2.95, 4.95, -6.95),
+                      make_scalar3(0.3, -1.7, 2.2), make_scalar3(-0.8, 0.4, -3.3)};
+    Scalar charge[N] = {1.0, -0.5, 2.0, -1.5, 0.7, -0.7, -1.2, 0.2};
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        h_pos.data[i].x = pos[i].x;
+        h_pos.data[i].y = pos[i].y;
+        h_pos.data[i].z = pos[i].z;
+        h_charge.data[i] = charge[i];
+        }
+    }
+
+    std::shared_ptr<PPPMForceCompute> fc_1 = pppm_creator_1(sysdef, nlist, group_all);
+    std::shared_ptr<PPPMForceCompute> fc_2 = pppm_creator_2(sysdef, nlist, group_all);
+    fc_1->setParams(10, 15, 24, 5, 1.0, 1.0);
+    fc_2->setParams(10, 15, 24, 5, 1.0, 1.0);
+
+    fc_1->compute(0);
+
+    // run long enough for the autotuner to try every assignment method and block size
+    for (unsigned int timestep = 0; timestep < 1000; ++timestep)
+        {
+        fc_2->compute(timestep);
+
+        ArrayHandle<Scalar4> h_force_1(fc_1->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_force_2(fc_2->getForceArray(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            MY_CHECK_CLOSE(h_force_2.data[i].x, h_force_1.data[i].x, tol_small);
+            MY_CHECK_CLOSE(h_force_2.data[i].y, h_force_1.data[i].y, tol_small);
+            MY_CHECK_CLOSE(h_force_2.data[i].z, h_force_1.data[i].z, tol_small);
+            }
+        }
+    }
+
+
 //! PPPMForceCompute creator for unit tests
 std::shared_ptr<PPPMForceCompute> base_class_pppm_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                      std::shared_ptr<NeighborList> nlist,
@@ -234,6 +364,13 @@ UP_TEST( PPPMForceCompute_triclinic )
     pppm_force_particle_test_triclinic(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for the influence function rescaling on CPU
+UP_TEST( PPPMForceCompute_box_change )
+    {
+    pppmforce_creator pppm_creator = bind(base_class_pppm_creator, _1, _2, _3);
+    pppm_force_box_change_test(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 
 #ifdef ENABLE_HIP
 //! test case for bond forces on the GPU
@@ -249,4 +386,17 @@ UP_TEST( PPPMForceComputeGPU_triclinic )
     pppm_force_particle_test_triclinic(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+UP_TEST( PPPMForceComputeGPU_box_change )
+    {
+    pppmforce_creator pppm_creator = bind(gpu_pppm_creator, _1, _2, _3);
+    pppm_force_box_change_test(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
+UP_TEST( PPPMForceComputeGPU_assign_compare )
+    {
+    pppmforce_creator pppm_creator_1 = bind(base_class_pppm_creator, _1, _2, _3);
+    pppmforce_creator pppm_creator_2 = bind(gpu_pppm_creator, _1, _2, _3);
+    pppm_force_assign_compare_test(pppm_creator_1, pppm_creator_2, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
 #endif
@@ -13,6 +13,8 @@ HOOMD_UP_MAIN();
 
 
 #include "hoomd/md/WallData.h"
+#include "hoomd/md/EvaluatorWalls.h"
+#include "hoomd/md/EvaluatorPairLJ.h"
 
 #include <memory>
 #include <cstdlib>
@@ -275,3 +277,64 @@ UP_TEST( plane_wall_math )
     MY_CHECK_SMALL(vx.z, tol_small);
     MY_CHECK_SMALL(dx, tol_small);
     }
+
+//! Compare wall forces evaluated with and without the culling grid
+UP_TEST( wall_grid_culling )
+    {
+    typedef EvaluatorWalls<EvaluatorPairLJ> evaluator;
+
+    BoxDim box(20.0);
+    Scalar r_cut = 2.5;
+
+    std::shared_ptr<wall_type> field(new wall_type());
+    field->numSpheres = MAX_N_SWALLS;
+    field->numCylinders = 4;
+    field->numPlanes = 6;
+
+    srand(12345);
+    for (unsigned int i = 0; i < field->numSpheres; i++)
+        {
+        Scalar3 origin = make_scalar3(Scalar(rand())/RAND_MAX*20.0 - 10.0,
+                                      Scalar(rand())/RAND_MAX*20.0 - 10.0,
+                                      Scalar(rand())/RAND_MAX*20.0 - 10.0);
+        field->Spheres[i] = SphereWall(0.5 + Scalar(rand())/RAND_MAX, origin, false);
+        }
+    field->Cylinders[0] = CylinderWall(3.0, make_scalar3(0,0,0), make_scalar3(0,0,1), false);
+    field->Cylinders[1] = CylinderWall(1.5, make_scalar3(5,5,0), make_scalar3(1,1,0), false);
+    field->Cylinders[2] = CylinderWall(12.0, make_scalar3(0,0,0), make_scalar3(1,0,0), true);
+    field->Cylinders[3] = CylinderWall(2.0, make_scalar3(-5,3,1), make_scalar3(0.3,-1,0.5), false);
+    field->Planes[0] = PlaneWall(make_scalar3(-9.5,0,0), make_scalar3(1,0,0), true);
+    field->Planes[1] = PlaneWall(make_scalar3(9.5,0,0), make_scalar3(-1,0,0), true);
+    field->Planes[2] = PlaneWall(make_scalar3(0,-9.5,0), make_scalar3(0,1,0), true);
+    field->Planes[3] = PlaneWall(make_scalar3(0,9.5,0), make_scalar3(0,-1,0), true);
+    field->Planes[4] = PlaneWall(make_scalar3(0,0,2), make_scalar3(1,1,1), true);
+    field->Planes[5] = PlaneWall(make_scalar3(0,0,-9.5), make_scalar3(0,0,1), true);
+
+    evaluator::param_type params = make_wall_params<EvaluatorPairLJ>(EvaluatorPairLJ::param_type(0.5, 1.0),
+                                                                      r_cut*r_cut, 0.0);
+    std::shared_ptr<wall_type> field_grid(new wall_type(*field));
+    evaluator::prepareField(*field_grid, box, &params, 1);
+    UP_ASSERT(field_grid->grid.enabled);
+
+    for (unsigned int i = 0; i < 1000; i++)
+        {
+        Scalar3 pos = make_scalar3(Scalar(rand())/RAND_MAX*20.0 - 10.0,
+                                   Scalar(rand())/RAND_MAX*20.0 - 10.0,
+                                   Scalar(rand())/RAND_MAX*20.0 - 10.0);
+
+        Scalar3 F, F_grid;
+        Scalar energy, energy_grid;
+        Scalar virial[6], virial_grid[6];
+
+        evaluator eval(pos, box, params, *field);
+        eval.evalForceEnergyAndVirial(F, energy, virial);
+
+        evaluator eval_grid(pos, box, params, *field_grid);
+        eval_grid.evalForceEnergyAndVirial(F_grid, energy_grid, virial_grid);
+
+        MY_CHECK_CLOSE(F.x, F_grid.x, tol_small);
+        MY_CHECK_CLOSE(F.y, F_grid.y, tol_small);
+        MY_CHECK_CLOSE(F.z, F_grid.z, tol_small);
+        MY_CHECK_CLOSE(energy, energy_grid, tol_small);
+        }
+    }
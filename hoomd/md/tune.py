@@ -0,0 +1,109 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+"""Tuners for molecular dynamics."""
+
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.data.typeconverter import OnlyTypes
+from hoomd.md import _md
+from hoomd.md.nlist import NList
+from hoomd.operation import Tuner
+from hoomd.trigger import Trigger
+
+validate_nlist = OnlyTypes(NList)
+
+
+class NeighborListBuffer(Tuner):
+    """Tune the neighbor list buffer to minimize the run time per step.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to
+            measure a trial buffer and set the next one.
+        nlist (hoomd.md.nlist.NList): Neighbor list to tune.
+        minimum_buffer (float): Smallest buffer to try.
+        maximum_buffer (float): Largest buffer to try.
+        tolerance (float): Width of the search interval at which the search
+            stops.
+        density_tolerance (float): Relative change of the number density that
+            starts a new search.
+
+    A larger `hoomd.md.nlist.NList.buffer` makes neighbor list builds less
+    frequent, but adds neighbors that the pair forces must loop over.
+    `NeighborListBuffer` measures the wall clock time per step between
+    consecutive triggers and performs a golden-section search for the buffer
+    with the smallest time per step. Choose a trigger period that spans many
+    neighbor list builds so that the measurements are accurate.
+
+    The search never exceeds the largest buffer that fits the neighbor list and
+    the ghost layer into the box and the local domains. Once the search has
+    converged, `NeighborListBuffer` keeps the best buffer until the number
+    density changes by more than `density_tolerance`.
+
+    Example::
+
+        nl = hoomd.md.nlist.Cell()
+        tuner = hoomd.md.tune.NeighborListBuffer(trigger=1000, nlist=nl,
+                                                 minimum_buffer=0.1,
+                                                 maximum_buffer=1.0)
+        sim.operations.tuners.append(tuner)
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps on which to
+            measure a trial buffer and set the next one.
+        minimum_buffer (float): Smallest buffer to try.
+        maximum_buffer (float): Largest buffer to try.
+        tolerance (float): Width of the search interval at which the search
+            stops.
+        density_tolerance (float): Relative change of the number density that
+            starts a new search.
+    """
+
+    def __init__(self,
+                 trigger,
+                 nlist,
+                 minimum_buffer=0.05,
+                 maximum_buffer=1.0,
+                 tolerance=0.01,
+                 density_tolerance=0.1):
+        self._nlist = validate_nlist(nlist)
+        self._param_dict = ParameterDict(trigger=Trigger,
+                                         minimum_buffer=float,
+                                         maximum_buffer=float,
+                                         tolerance=float,
+                                         density_tolerance=float)
+        self._param_dict.update(
+            dict(trigger=trigger,
+                 minimum_buffer=minimum_buffer,
+                 maximum_buffer=maximum_buffer,
+                 tolerance=tolerance,
+                 density_tolerance=density_tolerance))
+
+    def _attach(self):
+        if not self._nlist._added:
+            self._nlist._add(self._simulation)
+        elif self._simulation != self._nlist._simulation:
+            raise RuntimeError("{} object's neighbor list is used in a "
+                               "different simulation.".format(type(self)))
+        if not self._nlist._attached:
+            self._nlist._attach()
+
+        self._cpp_obj = _md.NeighborListBufferTuner(
+            self._simulation.state._cpp_sys_def, self.trigger,
+            self._nlist._cpp_obj, self.minimum_buffer, self.maximum_buffer)
+        super()._attach()
+
+    @property
+    def nlist(self):
+        """hoomd.md.nlist.NList: Neighbor list to tune."""
+        return self._nlist
+
+    @property
+    def tuned(self):
+        """bool: `True` when the search has converged."""
+        if not self._attached:
+            return False
+        return self._cpp_obj.tuned
+
+    @property
+    def _children(self):
+        return [self._nlist]
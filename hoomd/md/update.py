@@ -14,6 +14,7 @@ from hoomd.md import _md
 import hoomd;
 from hoomd.update import _updater
 from hoomd.operation import Updater
+from hoomd.logging import log
 import sys;
 
 class rescale_temp(_updater):
@@ -106,6 +107,104 @@ class ZeroMomentum(Updater):
         super()._attach()
 
 
+class ReplicaExchange(Updater):
+    r"""Exchange temperatures between replicas in MPI partitions.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps to attempt
+            exchanges.
+        kT (hoomd.variant.Constant): Temperature set point of the integration
+            method in this partition. `ReplicaExchange` sets its value.
+        temperatures (list[float]): Temperature ladder, one value per partition
+            (in energy units).
+
+    Run one replica of the system in each MPI partition (see
+    `hoomd.communicator.Communicator`). Partition :math:`p` starts at
+    ``temperatures[p]``. On the timesteps selected by *trigger*,
+    `ReplicaExchange` attempts to swap the temperatures of replicas at adjacent
+    positions in the ladder, alternating between even and odd pairs, and accepts
+    a swap with probability
+
+    .. math::
+
+        \min\left(1, \exp\left[(\beta_i - \beta_j)(U_i - U_j)\right]\right)
+
+    where :math:`\beta = 1/kT` and :math:`U` is the potential energy of the
+    replica. Partitions only exchange these scalars, never configurations. When
+    a swap is accepted, the updater sets *kT* to the new temperature and
+    rescales velocities and angular momenta by :math:`\sqrt{T_\mathrm{new} /
+    T_\mathrm{old}}`.
+
+    Pass the same *kT* object to the thermostatted integration method so that
+    it follows the exchanges. Every partition must use the same *trigger*.
+
+    Note:
+        Thermostat degrees of freedom are not rescaled on a swap.
+
+    Examples::
+
+        T = [1.0, 1.1, 1.2, 1.3]
+        kT = hoomd.variant.Constant(T[0])
+        nvt = hoomd.md.methods.NVT(filter=hoomd.filter.All(), kT=kT, tau=0.5)
+        remd = hoomd.md.update.ReplicaExchange(hoomd.trigger.Periodic(1000),
+                                               kT=kT, temperatures=T)
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps to attempt
+            exchanges.
+        temperatures (list[float]): Temperature ladder.
+    """
+    def __init__(self, trigger, kT, temperatures):
+        super().__init__(trigger)
+        if not isinstance(kT, hoomd.variant.Constant):
+            raise TypeError("kT must be a hoomd.variant.Constant")
+        self._kT = kT
+        self._temperatures = [float(T) for T in temperatures]
+
+    def _attach(self):
+        if isinstance(self._simulation.device, hoomd.device.CPU):
+            thermo_cls = _md.ComputeThermo
+        else:
+            thermo_cls = _md.ComputeThermoGPU
+
+        cpp_sys_def = self._simulation.state._cpp_sys_def
+        group = self._simulation.state._get_group(hoomd.filter.All())
+        thermo = thermo_cls(cpp_sys_def, group, "")
+        self._cpp_obj = _md.UpdaterReplicaExchange(cpp_sys_def, thermo,
+                                                   self._kT,
+                                                   self._temperatures)
+        super()._attach()
+
+    @property
+    def temperatures(self):
+        return list(self._temperatures)
+
+    @log
+    def temperature_index(self):
+        """int: Index of the temperature currently assigned to this \
+        partition."""
+        if self._attached:
+            return self._cpp_obj.temperature_index
+        else:
+            return None
+
+    @log
+    def swap_attempts(self):
+        """int: Number of swaps this partition's replica took part in."""
+        if self._attached:
+            return self._cpp_obj.swap_attempts
+        else:
+            return None
+
+    @log
+    def swaps_accepted(self):
+        """int: Number of accepted swaps of this partition's replica."""
+        if self._attached:
+            return self._cpp_obj.swaps_accepted
+        else:
+            return None
+
+
 class enforce2d(_updater):
     R""" Enforces 2D simulation.
 
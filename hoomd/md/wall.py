@@ -42,7 +42,7 @@ class group(object):
     wall group object before any wall force can be created. Modifications
     of the created wall group may occur at any time before ```hoomd.run```
     is invoked. Current supported geometries are spheres, cylinder, and planes. The
-    maximum number of each type of wall is 20, 20, and 60 respectively.
+    maximum number of each type of wall is 128, 20, and 60 respectively.
 
     The **inside** parameter used in each wall geometry is used to specify the
     half-space that is to be used for the force implementation. See
@@ -6,8 +6,15 @@
 
 #include "EAMForceCompute.h"
 
+#include <algorithm>
 #include <vector>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 
 #include <stdexcept>
@@ -236,7 +243,9 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
     interpolation(nrho * m_ntypes, nrho, drho, &h_F, &h_dF);
     interpolation(nr * m_ntypes * m_ntypes, nr, dr, &h_rho, &h_drho);
     interpolation((int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), nr, dr, &h_rphi, &h_drphi);
+    }
 
+    buildPairTable();
     }
 
 /*! compute cubic interpolation coefficients
@@ -339,16 +348,7 @@ void EAMForceCompute::computeForces(uint64_t timestep)
     ArrayHandle<Scalar4> h_F(m_F, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_dF(m_dF, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_rho(m_rho, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_drho(m_drho, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_rphi(m_rphi, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_drphi(m_drphi, access_location::host, access_mode::read);
-
-    // index and remainder
-    Scalar position;  // look up position, scalar
-    unsigned int int_position;  // look up index for position, integer
-    unsigned int idxs; // look up index in F, rho, rphi array, considering shift, integer
-    Scalar remainder;  // look up remainder in array, integer
-    Scalar4 v, dv;  // value, d(value)
+    ArrayHandle<Scalar4> h_pair_table(m_pair_table, access_location::host, access_mode::read);
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
@@ -357,9 +357,7 @@ void EAMForceCompute::computeForces(uint64_t timestep)
     assert(h_F.data);
     assert(h_dF.data);
     assert(h_rho.data);
-    assert(h_drho.data);
-    assert(h_rphi.data);
-    assert(h_drphi.data);
+    assert(h_pair_table.data);
 
     // Zero data for force calculation.
     memset((void *) h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
@@ -371,19 +369,37 @@ void EAMForceCompute::computeForces(uint64_t timestep)
     // create a temporary copy of r_cut squared
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
-    // sum up the number of forces calculated
-    int64_t n_calc = 0;
+    const unsigned int N = m_pdata->getN();
+    const unsigned int ntypes = m_pdata->getNTypes();
 
     // parameters for each particle
-    vector<Scalar> atomElectronDensity;
-    atomElectronDensity.resize(m_pdata->getN());
-    vector<Scalar> atomDerivativeEmbeddingFunction;
-    atomDerivativeEmbeddingFunction.resize(m_pdata->getN());
-    vector<Scalar> atomEmbeddingFunction;
-    atomEmbeddingFunction.resize(m_pdata->getN());
-    unsigned int ntypes = m_pdata->getNTypes();
-
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    vector<Scalar> atomElectronDensity(N, Scalar(0.0));
+    vector<Scalar> atomDerivativeEmbeddingFunction(N, Scalar(0.0));
+
+    // first pass: electron density P = sum(rho)
+    #ifdef ENABLE_TBB
+    // with a half neighbor list, several threads may add to the same particle k concurrently, so each thread
+    // accumulates into a private copy of the density which is reduced at the end
+    tbb::enumerable_thread_specific< vector<Scalar> > thread_density;
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+    Scalar *density = atomElectronDensity.data();
+    if (third_law)
+        {
+        bool exists = false;
+        vector<Scalar>& my_density = thread_density.local(exists);
+        if (!exists)
+            my_density.resize(N, Scalar(0.0));
+        density = my_density.data();
+        }
+
+    for (unsigned int i = range.begin(); i != range.end(); ++i)
+    #else
+    Scalar *density = atomElectronDensity.data();
+
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         // access the particle's position and type
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -395,12 +411,10 @@ void EAMForceCompute::computeForces(uint64_t timestep)
 
         // loop over all of the neighbors of this particle
         const unsigned int size = (unsigned int) h_n_neigh.data[i];
+        Scalar densityi = Scalar(0.0);
 
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
             // sanity check
@@ -418,56 +432,102 @@ void EAMForceCompute::computeForces(uint64_t timestep)
             // apply periodic boundary conditions
             dx = box.minImage(dx);
 
-            // start computing the force
             // calculate r squared
             Scalar rsq = dot(dx, dx);
-            ;
-            // only compute the force if the particles are closer than the cut-off
+
+            // only compute the density if the particles are closer than the cut-off
             if (rsq < r_cut_sq)
                 {
                 // calculate position r for rho(r)
-                position = sqrt(rsq) * rdr;
-                int_position = (unsigned int) position;
-                int_position = min(int_position, nr - 1);
-                remainder = position - int_position;
+                Scalar position = sqrt(rsq) * rdr;
+                unsigned int int_position = min((unsigned int) position, nr - 1);
+                Scalar remainder = position - int_position;
+
                 // calculate P = sum{rho}
-                idxs = int_position + nr * (typej * ntypes + typei);
-                v = h_rho.data[idxs];
-                atomElectronDensity[i] += v.w + v.z * remainder + v.y * remainder * remainder
+                Scalar4 v = h_rho.data[int_position + nr * (typej * ntypes + typei)];
+                densityi += v.w + v.z * remainder + v.y * remainder * remainder
                         + v.x * remainder * remainder * remainder;
+
                 // if third_law, pair it
                 if (third_law)
                     {
-                    idxs = int_position + nr * (typei * ntypes + typej);
-                    v = h_rho.data[idxs];
-                    atomElectronDensity[k] += v.w + v.z * remainder + v.y * remainder * remainder
+                    v = h_rho.data[int_position + nr * (typei * ntypes + typej)];
+                    density[k] += v.w + v.z * remainder + v.y * remainder * remainder
                             + v.x * remainder * remainder * remainder;
                     }
                 }
             }
+        density[i] += densityi;
         }
+    #ifdef ENABLE_TBB
+        });
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // reduce the per-thread densities of the half neighbor list path
+    for (auto it = thread_density.begin(); it != thread_density.end(); ++it)
+        {
+        for (unsigned int i = 0; i < N; i++)
+            atomElectronDensity[i] += (*it)[i];
+        }
+    #endif
+
+    // second pass: embedding energy F(P) and dF/dP
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+    for (unsigned int i = range.begin(); i != range.end(); ++i)
+    #else
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
         // calculate position rho for F(rho)
-        position = atomElectronDensity[i] * rdrho;
-        int_position = (unsigned int) position;
-        int_position = min(int_position, nrho - 1);
-        remainder = position - int_position;
-
-        idxs = int_position + typei * nrho;
-        v = h_F.data[idxs];
-        dv = h_dF.data[idxs];
+        Scalar position = atomElectronDensity[i] * rdrho;
+        unsigned int int_position = min((unsigned int) position, nrho - 1);
+        Scalar remainder = position - int_position;
+
+        unsigned int idxs = int_position + typei * nrho;
+        Scalar4 v = h_F.data[idxs];
+        Scalar4 dv = h_dF.data[idxs];
         // compute dF / dP
         atomDerivativeEmbeddingFunction[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
         // compute embedded energy F(P), sum up each particle
         h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
                 + v.x * remainder * remainder * remainder;
-
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
+
+    // third pass: forces
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific< vector<Scalar4> > thread_force;
+    tbb::enumerable_thread_specific< vector<Scalar> > thread_virial;
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+    Scalar4 *force = h_force.data;
+    Scalar *virial = h_virial.data;
+    if (third_law)
+        {
+        bool exists = false;
+        vector<Scalar4>& my_force = thread_force.local(exists);
+        vector<Scalar>& my_virial = thread_virial.local();
+        if (!exists)
+            {
+            my_force.resize(N, make_scalar4(0, 0, 0, 0));
+            my_virial.resize(6 * virial_pitch, Scalar(0.0));
+            }
+        force = my_force.data();
+        virial = my_virial.data();
+        }
+
+    for (unsigned int i = range.begin(); i != range.end(); ++i)
+    #else
+    Scalar4 *force = h_force.data;
+    Scalar *virial = h_virial.data;
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         // access the particle's position and type
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -489,9 +549,6 @@ void EAMForceCompute::computeForces(uint64_t timestep)
         const unsigned int size = (unsigned int) h_n_neigh.data[i];
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
             // sanity check
@@ -509,7 +566,6 @@ void EAMForceCompute::computeForces(uint64_t timestep)
             // apply periodic boundary conditions
             dx = box.minImage(dx);
 
-            // start computing the force
             // calculate r squared
             Scalar rsq = dot(dx, dx);
 
@@ -518,31 +574,24 @@ void EAMForceCompute::computeForces(uint64_t timestep)
                 continue;
             Scalar r = sqrt(rsq);
             Scalar inverseR = 1.0 / r;
-            position = r * rdr;
-            int_position = (unsigned int) position;
-            int_position = min(int_position, nr - 1);
-            remainder = position - int_position;
-            // calculate the shift position for type ij
-            int shift =
-                    (typei >= typej) ?
-                            (int) (0.5 * (2 * ntypes - typej - 1) * typej + typei) * nr :
-                            (int) (0.5 * (2 * ntypes - typei - 1) * typei + typej) * nr;
-
-            idxs = int_position + shift;
-            v = h_rphi.data[idxs];
-            dv = h_drphi.data[idxs];
+            Scalar position = r * rdr;
+            unsigned int int_position = min((unsigned int) position, nr - 1);
+            Scalar remainder = position - int_position;
+
+            // the pair function and both density derivatives are stored next to each other
+            const Scalar4 *record = h_pair_table.data + 4 * ((typei * ntypes + typej) * nr + int_position);
+            Scalar4 v = record[0];
+            Scalar4 dv = record[1];
             // pair_eng = phi
             Scalar pair_eng = (v.w + v.z * remainder + v.y * remainder * remainder
                     + v.x * remainder * remainder * remainder) * inverseR;
             // derivativePhi = (phi + r * dphi/dr - phi) * 1/r = dphi / dr
             Scalar derivativePhi = (dv.z + dv.y * remainder + dv.x * remainder * remainder - pair_eng) * inverseR;
             // derivativeRhoI = drho / dr of i
-            idxs = int_position + typei * ntypes * nr + typej * nr;
-            dv = h_drho.data[idxs];
+            dv = record[2];
             Scalar derivativeRhoI = dv.z + dv.y * remainder + dv.x * remainder * remainder;
             // derivativeRhoJ = drho / dr of j
-            idxs = int_position + typej * ntypes * nr + typei * nr;
-            dv = h_drho.data[idxs];
+            dv = record[3];
             Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
             // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
             Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ
@@ -562,28 +611,99 @@ void EAMForceCompute::computeForces(uint64_t timestep)
 
             if (third_law)
                 {
-                h_force.data[k].x -= dx.x * pairForce;
-                h_force.data[k].y -= dx.y * pairForce;
-                h_force.data[k].z -= dx.z * pairForce;
-                h_force.data[k].w += pair_eng * 0.5;
+                force[k].x -= dx.x * pairForce;
+                force[k].y -= dx.y * pairForce;
+                force[k].z -= dx.z * pairForce;
+                force[k].w += pair_eng * 0.5;
                 }
             }
-        h_force.data[i].x += fxi;
-        h_force.data[i].y += fyi;
-        h_force.data[i].z += fzi;
-        h_force.data[i].w += pei;
+        force[i].x += fxi;
+        force[i].y += fyi;
+        force[i].z += fzi;
+        force[i].w += pei;
         for (int k = 0; k < 6; k++)
-            h_virial.data[k * virial_pitch + i] += viriali[k];
+            virial[k * virial_pitch + i] += viriali[k];
         }
+    #ifdef ENABLE_TBB
+        });
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3 + 5 + 9 + 1 + 9 + 6 + 8);
+    // reduce the per-thread accumulators of the half neighbor list path
     if (third_law)
-        flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5 + 4 + 10) * sizeof(Scalar) + n_calc * (1 + 3 + 1) * sizeof(Scalar);
-    if (third_law)
-        mem_transfer += n_calc * 10 * sizeof(Scalar);
+        {
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& range) {
+            for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+                {
+                const Scalar4 *my_force = it->data();
+                for (unsigned int i = range.begin(); i != range.end(); ++i)
+                    {
+                    h_force.data[i].x += my_force[i].x;
+                    h_force.data[i].y += my_force[i].y;
+                    h_force.data[i].z += my_force[i].z;
+                    h_force.data[i].w += my_force[i].w;
+                    }
+                }
+            for (auto it = thread_virial.begin(); it != thread_virial.end(); ++it)
+                {
+                const Scalar *my_virial = it->data();
+                for (unsigned int k = 0; k < 6; ++k)
+                    for (unsigned int i = range.begin(); i != range.end(); ++i)
+                        h_virial.data[k * virial_pitch + i] += my_virial[k * virial_pitch + i];
+                }
+            });
+        }
+    #endif
+
     if (m_prof)
+        {
+        // sum up the number of forces calculated
+        int64_t n_calc = 0;
+        for (unsigned int i = 0; i < N; i++)
+            n_calc += h_n_neigh.data[i];
+
+        int64_t flops = N * 5 + n_calc * (3 + 5 + 9 + 1 + 9 + 6 + 8);
+        if (third_law)
+            flops += n_calc * 8;
+        int64_t mem_transfer = N * (5 + 4 + 10) * sizeof(Scalar) + n_calc * (1 + 3 + 1) * sizeof(Scalar);
+        if (third_law)
+            mem_transfer += n_calc * 10 * sizeof(Scalar);
         m_prof->pop(flops, mem_transfer);
+        }
+    }
+
+/*! The pair function is stored for the unordered type pairs, the electron densities for the ordered ones. The
+    interleaved table duplicates the pair function for both orders of each type pair, so that the force pass finds
+    all four records of a neighbor at the same place.
+*/
+void EAMForceCompute::buildPairTable()
+    {
+    GPUArray<Scalar4> pair_table(4 * m_ntypes * m_ntypes * nr, m_exec_conf);
+    m_pair_table.swap(pair_table);
+
+    ArrayHandle<Scalar4> h_pair_table(m_pair_table, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_rphi(m_rphi, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_drphi(m_drphi, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_drho(m_drho, access_location::host, access_mode::read);
+
+    for (unsigned int typei = 0; typei < m_ntypes; typei++)
+        {
+        for (unsigned int typej = 0; typej < m_ntypes; typej++)
+            {
+            // r*phi(r) is stored for type pairs k >= j in the order of the potential file
+            const unsigned int k = max(typei, typej);
+            const unsigned int j = min(typei, typej);
+            const unsigned int shift = (k * (k + 1) / 2 + j) * nr;
+
+            for (unsigned int m = 0; m < nr; m++)
+                {
+                Scalar4 *record = h_pair_table.data + 4 * ((typei * m_ntypes + typej) * nr + m);
+                record[0] = h_rphi.data[shift + m];
+                record[1] = h_drphi.data[shift + m];
+                record[2] = h_drho.data[typei * m_ntypes * nr + typej * nr + m];
+                record[3] = h_drho.data[typej * m_ntypes * nr + typei * nr + m];
+                }
+            }
+        }
     }
 
 void EAMForceCompute::set_neighbor_list(std::shared_ptr<NeighborList> nlist)
@@ -42,6 +42,15 @@
  h_dF.data[100].z, h_dF.data[100].y, h_dF.data[100].x, are for interpolating derivative embedded
  function.
 
+ The force pass reads the pair function, its derivative and the derivatives of the electron density of both
+ particles at the same distance. These are interleaved in m_pair_table, so that one neighbor reads four
+ consecutive Scalar4 values: for the ordered type pair (i, j) and the table position m, the record at
+ 4*((i*ntypes + j)*nr + m) holds the coefficients of r*phi_ij, d(r*phi_ij)/dr, drho_ij/dr and drho_ji/dr.
+
+ \b Threading
+ When built with TBB, the density, embedding and force passes are parallelized over particles. With a half
+ neighbor list, each thread accumulates into private arrays that are summed after each pass.
+
  \ingroup computes
  */
 class EAMForceCompute: public ForceCompute
@@ -92,6 +101,7 @@ protected:
     GPUArray<Scalar4> m_drho;              //!< derivative electron density and its coefficients
     GPUArray<Scalar4> m_drphi;             //!< derivative pair wise function and its coefficients
     GPUArray<Scalar> m_dFdP;               //!< derivative F / derivative P
+    GPUArray<Scalar4> m_pair_table;        //!< interleaved pair function and density derivatives by type pair
 
     //! Actually compute the forces
     virtual void computeForces(uint64_t timestep);
@@ -106,6 +116,9 @@ protected:
     //! cubic interpolation
     virtual void interpolation(int num_all, int num_per, Scalar delta, ArrayHandle<Scalar4> *f,
             ArrayHandle<Scalar4> *df);
+
+    //! Fill the interleaved table used by the force pass
+    void buildPairTable();
     };
 
 //! Exports the EAMForceCompute class to python
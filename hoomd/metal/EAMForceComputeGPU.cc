@@ -92,22 +92,22 @@ void EAMForceComputeGPU::computeForces(uint64_t timestep)
     ArrayHandle<Scalar4> d_F(m_F, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_dF(m_dF, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_rho(m_rho, access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_drho(m_drho, access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_rphi(m_rphi, access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_drphi(m_drphi, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_pair_table(m_pair_table, access_location::device, access_mode::read);
     ArrayHandle<EAMTexInterData> d_eam_data(m_eam_data, access_location::device, access_mode::read);
 
-    // Derivative Embedding Function for each atom
-    GPUArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
-    m_dFdP.swap(t_dFdP);
+    // Derivative Embedding Function for each atom, only reallocated when the number of particles changes
+    if (m_dFdP.getNumElements() != m_pdata->getN())
+        {
+        GPUArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
+        m_dFdP.swap(t_dFdP);
+        }
     ArrayHandle<Scalar> d_dFdP(m_dFdP, access_location::device, access_mode::overwrite);
 
     // Compute energy and forces in GPU
     m_tuner->begin();
     gpu_compute_eam_tex_inter_forces(d_force.data, d_virial.data, m_virial.getPitch(), m_pdata->getN(), d_pos.data, box,
             d_n_neigh.data, d_nlist.data, d_head_list.data, this->m_nlist->getNListArray().getPitch(), d_eam_data.data,
-            d_dFdP.data, d_F.data, d_rho.data, d_rphi.data, d_dF.data, d_drho.data, d_drphi.data,
-            m_tuner->getParam());
+            d_dFdP.data, d_F.data, d_rho.data, d_dF.data, d_pair_table.data, m_tuner->getParam());
 
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
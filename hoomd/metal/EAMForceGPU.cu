@@ -16,8 +16,8 @@
 //! Kernel for computing EAM forces on the GPU
 __global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const size_t virial_pitch, const unsigned int N,
         const Scalar4 *d_pos, BoxDim box, const unsigned int *d_n_neigh, const unsigned int *d_nlist,
-        const unsigned int *d_head_list, const Scalar4 *d_F, const Scalar4 *d_rho, const Scalar4 *d_rphi,
-        const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi, Scalar *d_dFdP, const EAMTexInterData *d_eam_data)
+        const unsigned int *d_head_list, const Scalar4 *d_F, const Scalar4 *d_rho, const Scalar4 *d_dF,
+        Scalar *d_dFdP, const EAMTexInterData *d_eam_data)
     {
     __shared__ EAMTexInterData eam_data_ti;
 
@@ -129,10 +129,13 @@ __global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const size_t vi
     }
 
 //! Second stage kernel for computing EAM forces on the GPU
+/*! The pair function and both density derivatives of a neighbor are four consecutive records of d_pair_table, so
+    the lookups of one neighbor share cache lines.
+*/
 __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const size_t virial_pitch, const unsigned int N,
         const Scalar4 *d_pos, BoxDim box, const unsigned int *d_n_neigh, const unsigned int *d_nlist,
-        const unsigned int *d_head_list, const Scalar4 *d_F, const Scalar4 *d_rho, const Scalar4 *d_rphi,
-        const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi, Scalar *d_dFdP, const EAMTexInterData *d_eam_data)
+        const unsigned int *d_head_list, const Scalar4 *d_pair_table, Scalar *d_dFdP,
+        const EAMTexInterData *d_eam_data)
     {
     __shared__ EAMTexInterData eam_data_ti;
 
@@ -222,15 +225,10 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const size_t vi
         int_position = (unsigned int) position;
         int_position = min(int_position, nr - 1);
         remainder = position - int_position;
-        // calculate the shift position for type ij
-        int shift =
-        (typei >= typej) ?
-        (int) (0.5 * (2 * ntypes - typej - 1) * typej + typei) * nr :
-        (int) (0.5 * (2 * ntypes - typei - 1) * typei + typej) * nr;
-
-        idxs = int_position + shift;
-        v = __ldg(d_rphi + idxs);
-        dv = __ldg(d_drphi + idxs);
+        // locate the records of type pair ij
+        idxs = 4 * ((typei * ntypes + typej) * nr + int_position);
+        v = __ldg(d_pair_table + idxs);
+        dv = __ldg(d_pair_table + idxs + 1);
         // aspair_potential = r * phi
         Scalar aspair_potential = v.w + v.z * remainder + v.y * remainder * remainder
         + v.x * remainder * remainder * remainder;
@@ -241,12 +239,10 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const size_t vi
         // derivativePhi = (phi + r * dphi/dr - phi) * 1/r = dphi / dr
         Scalar derivativePhi = (derivative_pair_potential - pair_eng) * inverseR;
         // derivativeRhoI = drho / dr of i
-        idxs = int_position + typei * ntypes * nr + typej * nr;
-        dv = __ldg(d_drho + idxs);
+        dv = __ldg(d_pair_table + idxs + 2);
         Scalar derivativeRhoI = dv.z + dv.y * remainder + dv.x * remainder * remainder;
         // derivativeRhoJ = drho / dr of j
-        idxs = int_position + typej * ntypes * nr + typei * nr;
-        dv = __ldg(d_drho + idxs);
+        dv = __ldg(d_pair_table + idxs + 3);
         Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
         // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
         Scalar d_dFdPcur = __ldg(d_dFdP + cur_neigh);
@@ -285,8 +281,7 @@ hipError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial,
         const unsigned int N, const Scalar4 *d_pos, const BoxDim &box, const unsigned int *d_n_neigh,
         const unsigned int *d_nlist, const unsigned int *d_head_list, const size_t size_nlist,
         const EAMTexInterData *d_eam_data, Scalar *d_dFdP, const Scalar4 *d_F, const Scalar4 *d_rho,
-        const Scalar4 *d_rphi, const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi,
-        const unsigned int block_size)
+        const Scalar4 *d_dF, const Scalar4 *d_pair_table, const unsigned int block_size)
     {
     static unsigned int max_block_size_1 = UINT_MAX;
     static unsigned int max_block_size_2 = UINT_MAX;
@@ -312,9 +307,9 @@ hipError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial,
     dim3 threads_2(run_block_size_2, 1, 1);
 
     hipLaunchKernelGGL(gpu_kernel_1, dim3(grid_1), dim3(threads_1), 0, 0, d_force, d_virial, virial_pitch, N, d_pos, box, d_n_neigh, d_nlist,
-            d_head_list, d_F, d_rho, d_rphi, d_dF, d_drho, d_drphi, d_dFdP, d_eam_data);
+            d_head_list, d_F, d_rho, d_dF, d_dFdP, d_eam_data);
     hipLaunchKernelGGL(gpu_kernel_2, dim3(grid_2), dim3(threads_2), 0, 0, d_force, d_virial, virial_pitch, N, d_pos, box, d_n_neigh, d_nlist,
-            d_head_list, d_F, d_rho, d_rphi, d_dF, d_drho, d_drphi, d_dFdP, d_eam_data);
+            d_head_list, d_pair_table, d_dFdP, d_eam_data);
 
     return hipSuccess;
     }
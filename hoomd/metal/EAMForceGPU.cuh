@@ -34,7 +34,6 @@ hipError_t gpu_compute_eam_tex_inter_forces(Scalar4* d_force, Scalar* d_virial,
         const unsigned int N, const Scalar4 *d_pos, const BoxDim& box, const unsigned int *d_n_neigh,
         const unsigned int *d_nlist, const unsigned int *d_head_list, const size_t size_nlist,
         const EAMTexInterData *d_eam_data, Scalar *d_dFdP, const Scalar4 *d_F, const Scalar4 *d_rho,
-        const Scalar4 *d_rphi, const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi,
-        const unsigned int block_size);
+        const Scalar4 *d_dF, const Scalar4 *d_pair_table, const unsigned int block_size);
 
 #endif
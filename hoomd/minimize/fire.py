@@ -29,6 +29,7 @@ class FIRE(_integrator):
         min_steps (int): A minimum number of attempts before convergence criteria are considered
         aniso (bool): Whether to integrate rotational degrees of freedom (bool), default None (autodetect).
           Added in version 2.2
+        check_period (int): Number of steps between reads of the minimizer state on the GPU (ignored on the CPU)
 
     .. versionadded:: 2.1
     .. versionchanged:: 2.2
@@ -88,8 +89,14 @@ class FIRE(_integrator):
         aggressive a first step, but also from quitting before having found a good search direction. The minimum number of
         attempts can be set by the user.
 
+    Note:
+        On the GPU without domain decomposition, the :math:`\alpha`, :math:`\delta t` and restart logic runs on the
+        device and the host reads the minimizer state back only every *check_period* steps. With
+        *check_period* > 1, :math:`\delta t` adapts every *check_period* steps and :py:meth:`has_converged`
+        may report convergence up to *check_period* - 1 steps late.
+
     """
-    def __init__(self, dt, Nmin=5, finc=1.1, fdec=0.5, alpha_start=0.1, falpha=0.99, ftol = 1e-1, wtol=1e-1, Etol= 1e-5, min_steps=10, aniso=None):
+    def __init__(self, dt, Nmin=5, finc=1.1, fdec=0.5, alpha_start=0.1, falpha=0.99, ftol = 1e-1, wtol=1e-1, Etol= 1e-5, min_steps=10, aniso=None, check_period=1):
 
         # initialize base class
         _integrator.__init__(self)
@@ -149,6 +156,11 @@ class FIRE(_integrator):
         self.min_steps = min_steps
         self.metadata_fields.append(min_steps)
 
+        if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+            self.cpp_integrator.setCheckPeriod(check_period)
+        self.check_period = check_period
+        self.metadata_fields.append('check_period')
+
     ## \internal
     #  \brief Cached set of anisotropic mode enums for ease of access
     _aniso_modes = {
@@ -21,8 +21,11 @@
 #include "ForceConstraint.h"
 #include "ConstForceCompute.h"
 #include "Analyzer.h"
+#include "AscentWriter.h"
+#include "AsyncAnalyzer.h"
 #include "PythonAnalyzer.h"
 #include "IMDInterface.h"
+#include "Checkpoint.h"
 #include "DCDDumpWriter.h"
 #include "GetarDumpWriter.h"
 #include "GSDDumpWriter.h"
@@ -30,6 +33,8 @@
 #include "LogPlainTXT.h"
 #include "LogMatrix.h"
 #include "LogHDF5.h"
+#include "LogBatch.h"
+#include "LogTable.h"
 #include "CallbackAnalyzer.h"
 #include "Updater.h"
 #include "PythonUpdater.h"
@@ -189,6 +194,7 @@ PYBIND11_MODULE(_hoomd, m)
         .def_static("getCXXCompiler", BuildInfo::getCXXCompiler)
         .def_static("getEnableTBB", BuildInfo::getEnableTBB)
         .def_static("getEnableMPI", BuildInfo::getEnableMPI)
+        .def_static("getEnableAscent", BuildInfo::getEnableAscent)
         .def_static("getSourceDir", BuildInfo::getSourceDir)
         .def_static("getInstallDir", BuildInfo::getInstallDir)
         ;
@@ -273,15 +279,22 @@ PYBIND11_MODULE(_hoomd, m)
 
     // analyzers
     export_Analyzer(m);
+    export_AsyncAnalyzer(m);
     export_PythonAnalyzer(m);
     export_IMDInterface(m);
     export_DCDDumpWriter(m);
+#ifdef ENABLE_ASCENT
+    export_AscentWriter(m);
+#endif
+    export_Checkpoint(m);
     getardump::export_GetarDumpWriter(m);
     export_GSDDumpWriter(m);
     export_Logger(m);
     export_LogPlainTXT(m);
     export_LogMatrix(m);
     export_LogHDF5(m);
+    export_LogBatch(m);
+    export_LogTable(m);
     export_CallbackAnalyzer(m);
 
     // updaters
@@ -12,6 +12,11 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif // ENABLE_TBB
+
 mpcd::ATCollisionMethod::ATCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                            uint64_t cur_timestep,
                                            uint64_t period,
@@ -84,8 +89,15 @@ void mpcd::ATCollisionMethod::drawVelocities(uint64_t timestep)
     uint16_t seed = m_sysdef->getSeed();
 
     // random velocities are drawn for each particle and stored into the "alternate" arrays
+    // each particle has its own random number stream, so they can be split between threads
     const Scalar T = (*m_T)(timestep);
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
     for (unsigned int idx=0; idx < N_tot; ++idx)
+    #endif // ENABLE_TBB
         {
         unsigned int pidx;
         unsigned int tag; Scalar mass;
@@ -120,6 +132,9 @@ void mpcd::ATCollisionMethod::drawVelocities(uint64_t timestep)
             h_alt_vel_embed->data[pidx] = make_scalar4(vel.x, vel.y, vel.z, mass);
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif // ENABLE_TBB
     }
 
 void mpcd::ATCollisionMethod::applyVelocities()
@@ -147,7 +162,14 @@ void mpcd::ATCollisionMethod::applyVelocities()
     ArrayHandle<double4> h_cell_vel(m_thermo->getCellVelocities(), access_location::host, access_mode::read);
     ArrayHandle<double4> h_rand_vel(m_rand_thermo->getCellVelocities(), access_location::host, access_mode::read);
 
+    // each particle is updated independently
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
     for (unsigned int idx=0; idx < N_tot; ++idx)
+    #endif // ENABLE_TBB
         {
         unsigned int cell, pidx;
         Scalar4 vel_rand;
@@ -183,6 +205,9 @@ void mpcd::ATCollisionMethod::applyVelocities()
             h_vel_embed->data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, vel_rand.w);
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif // ENABLE_TBB
     }
 
 /*!
@@ -10,6 +10,12 @@
 #include "hoomd/Communicator.h"
 #endif // ENABLE_MPI
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif // ENABLE_TBB
+
 /*!
  * \file mpcd/CellList.cc
  * \brief Definition of mpcd::CellList
@@ -19,7 +25,9 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
                          std::shared_ptr<mpcd::ParticleData> mpcd_pdata)
         : Compute(sysdef), m_mpcd_pdata(mpcd_pdata),
           m_cell_size(1.0), m_cell_np_max(4), m_cell_np(m_exec_conf), m_cell_list(m_exec_conf),
-          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_needs_compute_dim(true),
+          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_prebinned(false), m_prebin_timestep(0),
+          m_prebin_N(0), m_grid_shift_steps(0), m_fine_bins(m_exec_conf), m_fine_bins_valid(false),
+          m_reuse_fine_bins(false), m_needs_compute_dim(true),
           m_particles_sorted(false), m_virtual_change(false)
     {
     assert(m_mpcd_pdata);
@@ -30,8 +38,10 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
     m_global_cell_dim = make_uint3(0,0,0);
 
     m_grid_shift = make_scalar3(0.0,0.0,0.0);
+    m_prebin_shift = make_scalar3(0.0,0.0,0.0);
     m_max_grid_shift = 0.5 * m_cell_size;
     m_origin_idx = make_int3(0,0,0);
+    m_grid_shift_idx = make_int3(0,0,0);
 
     resetConditions();
 
@@ -39,6 +49,8 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
     m_decomposition = m_pdata->getDomainDecomposition();
     m_num_extra = 0;
     m_cover_box = m_pdata->getBox();
+    m_embed_migrate_checked = false;
+    m_embed_migrate_timestep = 0;
     #endif // ENABLE_MPI
 
     m_mpcd_pdata->getSortSignal().connect<mpcd::CellList, &mpcd::CellList::sort>(this);
@@ -83,8 +95,10 @@ void mpcd::CellList::compute(uint64_t timestep)
         #ifdef ENABLE_MPI
         if (m_prof) m_prof->pop(m_exec_conf);
 
-        // exchange embedded particles if necessary
-        if (m_comm && needsEmbedMigrate(timestep))
+        // exchange embedded particles if necessary, unless they were already checked during the last communication
+        const bool embed_checked = m_embed_migrate_checked && m_embed_migrate_timestep == timestep;
+        m_embed_migrate_checked = false;
+        if (m_comm && !embed_checked && needsEmbedMigrate(timestep))
             {
             m_comm->forceMigrate();
             m_comm->communicate(timestep);
@@ -98,19 +112,51 @@ void mpcd::CellList::compute(uint64_t timestep)
             m_embed_cell_ids.resize(m_embed_group->getNumMembers());
             }
 
-        bool overflowed = false;
-        do
+        // the cell list may already have been filled for this timestep while streaming
+        const bool prebinned = m_prebinned && !m_force_compute && m_prebin_timestep == timestep
+                               && m_prebin_shift.x == m_grid_shift.x && m_prebin_shift.y == m_grid_shift.y
+                               && m_prebin_shift.z == m_grid_shift.z && m_prebin_N == m_mpcd_pdata->getN();
+        m_prebinned = false;
+
+        // the particles have not moved since the fine bins were filled, so only the grid shift can have changed
+        m_reuse_fine_bins = m_fine_bins_valid && !m_force_compute && !m_embed_group
+                            && m_mpcd_pdata->checkCellCache()
+                            && m_fine_bins.size() == m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
+        m_fine_bins_valid = false;
+
+        // the embedded particles have moved since streaming, so only they are added to a filled cell list
+        bool rebuild = !prebinned;
+        if (prebinned && m_embed_group)
             {
-            buildCellList();
-
-            overflowed = checkConditions();
-
-            if (overflowed)
+            resetConditions();
+            if (!appendEmbedded())
+                {
+                rebuild = true;
+                }
+            else if (checkConditions())
                 {
                 reallocate();
                 resetConditions();
+                rebuild = true;
                 }
-            } while (overflowed);
+            }
+
+        if (rebuild)
+            {
+            bool overflowed = false;
+            do
+                {
+                buildCellList();
+
+                overflowed = checkConditions();
+
+                if (overflowed)
+                    {
+                    reallocate();
+                    resetConditions();
+                    }
+                } while (overflowed);
+            }
 
         // we are finished building, explicitly mark everything (rather than using shouldCompute)
         m_first_compute = false;
@@ -124,6 +170,46 @@ void mpcd::CellList::compute(uint64_t timestep)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*!
+ * \param timestep Timestep of the collision that will use the cell list
+ * \param grid_shift Grid shift that will be drawn for \a timestep
+ * \returns True if the cell list can be filled from another kernel
+ *
+ * Another kernel (e.g., a fused streaming step) can fill the cell list with the final particle positions
+ * for a later timestep, so that compute() does not need to bin the particles again. This is only possible
+ * when the cell list does not need to be resized. Embedded particles keep moving after the streaming step, so
+ * compute() appends them to the filled cell list with appendEmbedded(). The caller must zero the
+ * number of particles per cell, fill the cell list, stash the cell ids into the particle velocities, and then
+ * call finishPrebin().
+ */
+bool mpcd::CellList::beginPrebin(uint64_t timestep, const Scalar3& grid_shift)
+    {
+    m_prebinned = false;
+    if (m_needs_compute_dim || m_virtual_change || m_particles_sorted || m_force_compute)
+        return false;
+
+    m_prebin_timestep = timestep;
+    m_prebin_shift = grid_shift;
+    resetConditions();
+    return true;
+    }
+
+/*!
+ * If the cell list overflowed, it is resized and the next call to compute() bins the particles again.
+ */
+void mpcd::CellList::finishPrebin()
+    {
+    if (checkConditions())
+        {
+        reallocate();
+        resetConditions();
+        return;
+        }
+
+    m_prebinned = true;
+    m_prebin_N = m_mpcd_pdata->getN();
+    }
+
 void mpcd::CellList::reallocate()
     {
     m_exec_conf->msg->notice(6) << "Allocating MPCD cell list, " << m_cell_np_max
@@ -491,6 +577,31 @@ bool mpcd::CellList::isCommunicating(mpcd::detail::face dir)
     }
 #endif // ENABLE_MPI
 
+namespace
+{
+//! Integer division that rounds toward negative infinity
+inline int floorDiv(int a, int b)
+    {
+    return (a >= 0) ? a / b : -((b - 1 - a) / b);
+    }
+
+//! Shifted global cell of a particle from its fine bin
+/*!
+ * \param fine_bin Sub-grid bin of the particle relative to the global box
+ * \param steps Number of sub-grid bins per cell
+ * \param shift Grid shift in sub-grid bins
+ *
+ * Because the grid shift is a whole number of sub-grid bins, floor((x - s)/a) = floor((floor(x/h) - s/h)/M),
+ * where h = a/M is the width of a sub-grid bin.
+ */
+inline int3 fineToCell(const int3& fine_bin, int steps, const int3& shift)
+    {
+    return make_int3(floorDiv(fine_bin.x - shift.x, steps),
+                     floorDiv(fine_bin.y - shift.y, steps),
+                     floorDiv(fine_bin.z - shift.z, steps));
+    }
+} // end namespace
+
 /*!
  * \param timestep Current simulation timestep
  */
@@ -534,30 +645,80 @@ void mpcd::CellList::buildCellList()
 
     const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
 
+    // with a quantized grid shift, the cells follow from the fine bins of the particles
+    const int shift_steps = m_grid_shift_steps;
+    const Scalar fine_size = getGridShiftStep();
+    const bool reuse_fine_bins = shift_steps > 0 && m_reuse_fine_bins;
+    if (shift_steps > 0 && !reuse_fine_bins)
+        {
+        m_fine_bins.resize(N_tot);
+        }
+    std::unique_ptr< ArrayHandle<int3> > h_fine_bins;
+    if (shift_steps > 0)
+        {
+        h_fine_bins.reset(new ArrayHandle<int3>(m_fine_bins,
+                                                access_location::host,
+                                                reuse_fine_bins ? access_mode::read : access_mode::overwrite));
+        }
+
+    /*
+     * The particles are binned in two passes. First, the cell of each particle is computed and stashed, which can
+     * be split between threads. Then, the particles are inserted into their cells in order of their index, so the
+     * cell list is the same regardless of the number of threads.
+     */
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific<uint2> thread_conditions(make_uint2(0,0));
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    uint2& error = thread_conditions.local();
+    for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+    #else
+    uint2 error = make_uint2(0,0);
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    #endif // ENABLE_TBB
         {
-        Scalar4 postype_i;
-        if (cur_p < N_mpcd)
+        int3 global_bin;
+        if (reuse_fine_bins)
             {
-            postype_i = h_pos.data[cur_p];
+            global_bin = fineToCell(h_fine_bins->data[cur_p], shift_steps, m_grid_shift_idx);
             }
         else
             {
-            postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
-            }
-        Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
+            Scalar4 postype_i;
+            if (cur_p < N_mpcd)
+                {
+                postype_i = h_pos.data[cur_p];
+                }
+            else
+                {
+                postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+                }
+            Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
-        if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
-            {
-            conditions.y = cur_p + 1;
-            continue;
-            }
+            if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
+                {
+                error.x = std::max(error.x, cur_p + 1);
+                continue;
+                }
 
-        // bin particle assuming orthorhombic box (already validated)
-        const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
-        int3 global_bin = make_int3((int)std::floor(delta.x / m_cell_size),
-                                    (int)std::floor(delta.y / m_cell_size),
-                                    (int)std::floor(delta.z / m_cell_size));
+            // bin particle assuming orthorhombic box (already validated)
+            if (shift_steps > 0)
+                {
+                const Scalar3 delta = pos_i - global_lo;
+                const int3 fine_bin = make_int3((int)std::floor(delta.x / fine_size),
+                                                (int)std::floor(delta.y / fine_size),
+                                                (int)std::floor(delta.z / fine_size));
+                h_fine_bins->data[cur_p] = fine_bin;
+                global_bin = fineToCell(fine_bin, shift_steps, m_grid_shift_idx);
+                }
+            else
+                {
+                const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
+                global_bin = make_int3((int)std::floor(delta.x / m_cell_size),
+                                       (int)std::floor(delta.y / m_cell_size),
+                                       (int)std::floor(delta.z / m_cell_size));
+                }
+            }
 
         // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
         // this is done using periodic from the "local" box, since this will be periodic
@@ -594,30 +755,55 @@ void mpcd::CellList::buildCellList()
             (bin.y < 0 || bin.y >= (int)m_cell_dim.y) ||
             (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
             {
-            conditions.z = cur_p + 1;
+            error.y = std::max(error.y, cur_p + 1);
             continue;
             }
 
-        unsigned int bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
-        unsigned int offset = h_cell_np.data[bin_idx];
-        if (offset < m_cell_np_max)
+        // stash the current particle bin into the velocity array
+        const unsigned int bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
+        if (cur_p < N_mpcd)
             {
-            h_cell_list.data[m_cell_list_indexer(offset, bin_idx)] = cur_p;
+            h_vel.data[cur_p].w = __int_as_scalar(bin_idx);
             }
         else
             {
-            // overflow
-            conditions.x = std::max(conditions.x, offset+1);
+            h_embed_cell_ids->data[cur_p - N_mpcd] = bin_idx;
             }
+        }
+    #ifdef ENABLE_TBB
+        });
 
-        // stash the current particle bin into the velocity array
-        if (cur_p < N_mpcd)
+    uint2 error = make_uint2(0,0);
+    for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+        {
+        error.x = std::max(error.x, it->x);
+        error.y = std::max(error.y, it->y);
+        }
+    #endif // ENABLE_TBB
+
+    // the stashed cells are not valid if any particle could not be binned, and the build will raise an error
+    conditions.y = error.x;
+    conditions.z = error.y;
+    if (error.x || error.y)
+        {
+        m_conditions.resetFlags(conditions);
+        return;
+        }
+    m_fine_bins_valid = (shift_steps > 0 && !m_embed_group);
+
+    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+        {
+        const unsigned int bin_idx = (cur_p < N_mpcd) ? __scalar_as_int(h_vel.data[cur_p].w)
+                                                      : h_embed_cell_ids->data[cur_p - N_mpcd];
+        unsigned int offset = h_cell_np.data[bin_idx];
+        if (offset < m_cell_np_max)
             {
-            h_vel.data[cur_p].w = __int_as_scalar(bin_idx);
+            h_cell_list.data[m_cell_list_indexer(offset, bin_idx)] = cur_p;
             }
         else
             {
-            h_embed_cell_ids->data[cur_p - N_mpcd] = bin_idx;
+            // overflow
+            conditions.x = std::max(conditions.x, offset+1);
             }
 
         // increment the counter always
@@ -637,6 +823,10 @@ void mpcd::CellList::sort(uint64_t timestep,
                           const GPUArray<unsigned int>& order,
                           const GPUArray<unsigned int>& rorder)
     {
+    // a cell list filled for a later timestep and the fine bins refer to the old particle order
+    m_prebinned = false;
+    m_fine_bins_valid = false;
+
     // no need to do any sorting if we can still be called at the current timestep
     if (peekCompute(timestep)) return;
 
@@ -671,6 +861,24 @@ void mpcd::CellList::sort(uint64_t timestep,
         }
     }
 
+#ifdef ENABLE_MPI
+/*!
+ * \param timestep Timestep the cell list will be computed for
+ * \returns True if the embedded particles must be migrated
+ *
+ * This check is meant to be made by a slot of the MD Communicator migrate signal, so that embedded particles that
+ * left the box covered by the cell list are migrated by the regular MD communication before the collision. If no
+ * migration is needed, compute() skips its own check (and its extra communication) at \a timestep. The result is
+ * discarded if the box changes or the particles are sorted in between. All ranks must call this method.
+ */
+bool mpcd::CellList::checkEmbedMigrate(uint64_t timestep)
+    {
+    const bool migrate = needsEmbedMigrate(timestep);
+    m_embed_migrate_checked = !migrate;
+    m_embed_migrate_timestep = timestep;
+    return migrate;
+    }
+
 #ifdef ENABLE_MPI
 bool mpcd::CellList::needsEmbedMigrate(uint64_t timestep)
     {
@@ -858,7 +1066,11 @@ void mpcd::detail::export_CellList(pybind11::module& m)
     py::class_<mpcd::CellList, Compute, std::shared_ptr<mpcd::CellList> >(m, "CellList")
         .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<mpcd::ParticleData> >())
         .def_property("cell_size", &mpcd::CellList::getCellSize, &mpcd::CellList::setCellSize)
+        .def_property("grid_shift_steps", &mpcd::CellList::getGridShiftSteps, &mpcd::CellList::setGridShiftSteps)
         .def("setEmbeddedGroup", &mpcd::CellList::setEmbeddedGroup)
         .def("removeEmbeddedGroup", &mpcd::CellList::removeEmbeddedGroup)
+        #ifdef ENABLE_MPI
+        .def_property("num_extra", &mpcd::CellList::getNExtraCells, &mpcd::CellList::setNExtraCells)
+        #endif // ENABLE_MPI
         ;
     }
@@ -25,7 +25,9 @@
 #include "hoomd/extern/nano-signal-slot/nano_signal_slot.hpp"
 #include <pybind11/pybind11.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 
 namespace mpcd
 {
@@ -125,6 +127,7 @@ class PYBIND11_EXPORT CellList : public Compute
             m_cell_size = cell_size;
             m_max_grid_shift = 0.5 * m_cell_size;
             m_needs_compute_dim = true;
+            setGridShift(make_scalar3(0.0,0.0,0.0));
             }
 
         //! Get the MPCD cell size
@@ -191,7 +194,22 @@ class PYBIND11_EXPORT CellList : public Compute
                 throw std::runtime_error("Error setting MPCD grid shift");
                 }
 
-            m_grid_shift = shift;
+            if (m_grid_shift_steps > 0)
+                {
+                // snap the shift onto the sub-grid so that the cells follow from the fine bins
+                const Scalar step = getGridShiftStep();
+                const int max_idx = m_grid_shift_steps / 2;
+                m_grid_shift_idx = make_int3(std::max(std::min((int)std::lround(shift.x / step), max_idx), -max_idx),
+                                             std::max(std::min((int)std::lround(shift.y / step), max_idx), -max_idx),
+                                             std::max(std::min((int)std::lround(shift.z / step), max_idx), -max_idx));
+                m_grid_shift = make_scalar3(Scalar(m_grid_shift_idx.x) * step,
+                                            Scalar(m_grid_shift_idx.y) * step,
+                                            Scalar(m_grid_shift_idx.z) * step);
+                }
+            else
+                {
+                m_grid_shift = shift;
+                }
             }
 
         // Get the grid shift vector
@@ -200,6 +218,33 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_grid_shift;
             }
 
+        //! Get the number of sub-grid steps per cell that the grid shift is restricted to
+        unsigned int getGridShiftSteps() const
+            {
+            return m_grid_shift_steps;
+            }
+
+        //! Restrict the grid shift to multiples of a fraction of the cell size
+        /*!
+         * \param steps Number of sub-grid steps per cell, or 0 to shift the grid continuously
+         *
+         * With \a steps > 0, the particles are binned into a fine sub-grid with \a steps bins per cell, and the
+         * shifted cell of a particle follows from its fine bin by integer arithmetic. The fine bins are kept, so a
+         * new grid shift does not need the particle positions as long as the particles have not moved.
+         */
+        void setGridShiftSteps(unsigned int steps)
+            {
+            m_grid_shift_steps = steps;
+            m_fine_bins_valid = false;
+            setGridShift(m_grid_shift);
+            }
+
+        //! Get the distance between allowed grid shifts, or zero if the grid shifts continuously
+        Scalar getGridShiftStep() const
+            {
+            return (m_grid_shift_steps > 0) ? m_cell_size / Scalar(m_grid_shift_steps) : Scalar(0.0);
+            }
+
         //! Calculate current cell occupancy statistics
         virtual void getCellStatistics() const;
 
@@ -227,6 +272,23 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_embed_cell_ids;
             }
 
+        //! Prepare to fill the cell list for a later timestep from another kernel
+        bool beginPrebin(uint64_t timestep, const Scalar3& grid_shift);
+
+        //! Check the cell list that another kernel filled
+        void finishPrebin();
+
+        #ifdef ENABLE_MPI
+        //! Check ahead of time if the embedded particles must be migrated before the cell list is computed
+        bool checkEmbedMigrate(uint64_t timestep);
+
+        //! Discard the result of checkEmbedMigrate()
+        void clearEmbedMigrateCheck()
+            {
+            m_embed_migrate_checked = false;
+            }
+        #endif // ENABLE_MPI
+
         //! Get the signal for dimensions changing
         /*!
          * \returns A signal that subscribers can attach to be notified that the
@@ -261,6 +323,17 @@ class PYBIND11_EXPORT CellList : public Compute
 
         int3 m_origin_idx;                  //!< Origin as a global index
 
+        unsigned int m_grid_shift_steps;    //!< Number of sub-grid steps per cell for the grid shift (0 is continuous)
+        int3 m_grid_shift_idx;              //!< Grid shift in sub-grid steps
+        GPUVector<int3> m_fine_bins;        //!< Sub-grid bin of each particle relative to the global box
+        bool m_fine_bins_valid;             //!< True if the fine bins match the current particle positions
+        bool m_reuse_fine_bins;             //!< True if the next build can take the cells from the fine bins
+
+        bool m_prebinned;                   //!< True if another kernel filled the cell list for a later timestep
+        uint64_t m_prebin_timestep;         //!< Timestep the cell list was filled for
+        Scalar3 m_prebin_shift;             //!< Grid shift the cell list was filled with
+        unsigned int m_prebin_N;            //!< Number of MPCD particles when the cell list was filled
+
         #ifdef ENABLE_MPI
         unsigned int m_num_extra;               //!< Number of extra cells to communicate over
         std::array<unsigned int, 6> m_num_comm; //!< Number of cells to communicate on each face
@@ -268,6 +341,9 @@ class PYBIND11_EXPORT CellList : public Compute
 
         //! Determine if embedded particles require migration
         virtual bool needsEmbedMigrate(uint64_t timestep);
+
+        bool m_embed_migrate_checked;       //!< True if the embedded particles were found not to need migration
+        uint64_t m_embed_migrate_timestep;  //!< Timestep the embedded particles were checked for
         #endif // ENABLE_MPI
 
         //! Check the condition flags
@@ -279,6 +355,15 @@ class PYBIND11_EXPORT CellList : public Compute
         //! Builds the cell list and handles cell list memory
         virtual void buildCellList();
 
+        //! Add the embedded particles to the cell list filled by another kernel
+        /*!
+         * \returns False if the embedded particles cannot be added, and the cell list must be built instead
+         */
+        virtual bool appendEmbedded()
+            {
+            return false;
+            }
+
         //! Callback to sort cell list when particle data is sorted
         virtual void sort(uint64_t timestep,
                           const GPUArray<unsigned int>& order,
@@ -290,6 +375,9 @@ class PYBIND11_EXPORT CellList : public Compute
         void slotBoxChanged()
             {
             m_needs_compute_dim = true;
+            #ifdef ENABLE_MPI
+            m_embed_migrate_checked = false;
+            #endif // ENABLE_MPI
             }
 
         Nano::Signal<void ()> m_dim_signal; //!< Signal for dimensions changing
@@ -304,6 +392,9 @@ class PYBIND11_EXPORT CellList : public Compute
         void slotSorted()
             {
             m_particles_sorted = true;
+            #ifdef ENABLE_MPI
+            m_embed_migrate_checked = false;
+            #endif // ENABLE_MPI
             }
 
         bool m_virtual_change;  //!< True if the number of virtual particles has changed
@@ -17,6 +17,7 @@ mpcd::CellListGPU::CellListGPU(std::shared_ptr<SystemDefinition> sysdef,
     {
     m_tuner_cell.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_cell", m_exec_conf));
     m_tuner_sort.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_cell_sort", m_exec_conf));
+    m_tuner_embed.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_cell_embed", m_exec_conf));
 
     #ifdef ENABLE_MPI
     m_tuner_embed_migrate.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_cell_embed_migrate", m_exec_conf));
@@ -40,14 +41,7 @@ void mpcd::CellListGPU::buildCellList()
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
-    // total effective number of cells in the global box, optionally padded by
-    // extra cells in MPI simulations
-    uint3 n_global_cells = m_global_cell_dim;
-    #ifdef ENABLE_MPI
-    if (isCommunicating(mpcd::detail::face::east)) n_global_cells.x += 2*m_num_extra;
-    if (isCommunicating(mpcd::detail::face::north)) n_global_cells.y += 2*m_num_extra;
-    if (isCommunicating(mpcd::detail::face::up)) n_global_cells.z += 2*m_num_extra;
-    #endif // ENABLE_MPI
+    const uint3 n_global_cells = getNGlobalCells();
 
     if (m_embed_group)
         {
@@ -108,6 +102,74 @@ void mpcd::CellListGPU::buildCellList()
         }
     }
 
+/*!
+ * \returns True, since the embedded particles can always be added on the GPU
+ *
+ * Only the embedded particles are binned, so coupling to the solvent costs a pass over the embedded particles
+ * instead of over all particles. The caller must check the conditions afterwards.
+ */
+bool mpcd::CellListGPU::appendEmbedded()
+    {
+    ArrayHandle<unsigned int> d_cell_list(m_cell_list, access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_cell_np(m_cell_np, access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_embed_cell_ids(m_embed_cell_ids, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_pos_embed(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_embed_member_idx(m_embed_group->getIndexArray(), access_location::device, access_mode::read);
+
+    // the grid shift was checked to match the one the cell list was filled with
+    const mpcd::gpu::cell_bin_args_t bin = getPrebinArgs(d_cell_np.data, d_cell_list.data);
+
+    m_tuner_embed->begin();
+    mpcd::gpu::cell_append_embed(bin,
+                                 d_embed_cell_ids.data,
+                                 d_pos_embed.data,
+                                 d_embed_member_idx.data,
+                                 m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual(),
+                                 m_embed_group->getNumMembers(),
+                                 m_tuner_embed->getParam());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner_embed->end();
+
+    return true;
+    }
+
+/*!
+ * \param d_cell_np Device pointer to the number of particles per cell
+ * \param d_cell_list Device pointer to the cell list
+ * \returns Arguments to bin particles into the cell list with the grid shift passed to beginPrebin()
+ */
+mpcd::gpu::cell_bin_args_t mpcd::CellListGPU::getPrebinArgs(unsigned int *d_cell_np, unsigned int *d_cell_list)
+    {
+    mpcd::gpu::cell_bin_args_t args;
+    args.d_cell_np = d_cell_np;
+    args.d_cell_list = d_cell_list;
+    args.d_conditions = m_conditions.getDeviceFlags();
+    args.periodic = m_pdata->getBox().getPeriodic();
+    args.origin_idx = m_origin_idx;
+    args.grid_shift = m_prebin_shift;
+    args.global_lo = m_pdata->getGlobalBox().getLo();
+    args.n_global_cell = getNGlobalCells();
+    args.cell_size = m_cell_size;
+    args.cell_np_max = m_cell_np_max;
+    args.cell_indexer = m_cell_indexer;
+    args.cell_list_indexer = m_cell_list_indexer;
+    return args;
+    }
+
+/*!
+ * \returns Total effective number of cells in the global box, optionally padded by extra cells in MPI simulations
+ */
+uint3 mpcd::CellListGPU::getNGlobalCells()
+    {
+    uint3 n_global_cells = m_global_cell_dim;
+    #ifdef ENABLE_MPI
+    if (isCommunicating(mpcd::detail::face::east)) n_global_cells.x += 2*m_num_extra;
+    if (isCommunicating(mpcd::detail::face::north)) n_global_cells.y += 2*m_num_extra;
+    if (isCommunicating(mpcd::detail::face::up)) n_global_cells.z += 2*m_num_extra;
+    #endif // ENABLE_MPI
+    return n_global_cells;
+    }
+
 /*!
  * \param timestep Timestep that the sorting occurred
  * \param order Mapping of sorted particle indexes onto old particle indexes
@@ -117,6 +179,9 @@ void mpcd::CellListGPU::sort(uint64_t timestep,
                              const GPUArray<unsigned int>& order,
                              const GPUArray<unsigned int>& rorder)
     {
+    // a cell list filled for a later timestep refers to the old particle order
+    m_prebinned = false;
+
     // no need to do any sorting if we can still be called at the current timestep
     if (peekCompute(timestep)) return;
 
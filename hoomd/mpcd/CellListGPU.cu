@@ -87,51 +87,20 @@ __global__ void compute_cell_list(unsigned int *d_cell_np,
         }
 
     // bin particle with grid shift assuming orthorhombic box (already validated)
-    const Scalar3 delta = (pos_i - grid_shift) - global_lo;
-    int3 global_bin = make_int3(std::floor(delta.x / cell_size),
-                                std::floor(delta.y / cell_size),
-                                std::floor(delta.z / cell_size));
-
-    // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
-    // this is done using periodic from the "local" box, since this will be periodic
-    // only when there is one rank along the dimension
-    if (periodic.x)
-        {
-        if (global_bin.x == (int)n_global_cell.x)
-            global_bin.x = 0;
-        else if (global_bin.x == -1)
-            global_bin.x = n_global_cell.x - 1;
-        }
-    if (periodic.y)
-        {
-        if (global_bin.y == (int)n_global_cell.y)
-            global_bin.y = 0;
-        else if (global_bin.y == -1)
-            global_bin.y = n_global_cell.y - 1;
-        }
-    if (periodic.z)
-        {
-        if (global_bin.z == (int)n_global_cell.z)
-            global_bin.z = 0;
-        else if (global_bin.z == -1)
-            global_bin.z = n_global_cell.z - 1;
-        }
-
-    // compute the local cell
-    int3 bin = make_int3(global_bin.x - origin_idx.x,
-                         global_bin.y - origin_idx.y,
-                         global_bin.z - origin_idx.z);
-
-    // validate and make sure no particles blew out of the box
-    if ((bin.x < 0 || bin.x >= (int)cell_indexer.getW()) ||
-        (bin.y < 0 || bin.y >= (int)cell_indexer.getH()) ||
-        (bin.z < 0 || bin.z >= (int)cell_indexer.getD()))
+    const unsigned int bin_idx = mpcd::gpu::detail::find_cell(pos_i,
+                                                              periodic,
+                                                              origin_idx,
+                                                              grid_shift,
+                                                              global_lo,
+                                                              n_global_cell,
+                                                              cell_size,
+                                                              cell_indexer);
+    if (bin_idx == mpcd::detail::NO_CELL)
         {
         (*d_conditions).z = idx + 1;
         return;
         }
 
-    const unsigned int bin_idx = cell_indexer(bin.x, bin.y, bin.z);
     const unsigned int offset = atomicInc(&d_cell_np[bin_idx], 0xffffffff);
     if (offset < cell_np_max)
         {
@@ -154,6 +123,69 @@ __global__ void compute_cell_list(unsigned int *d_cell_np,
         }
     }
 
+//! Kernel to add the embedded particles to a filled MPCD cell list
+/*!
+ * \param bin Arguments to bin particles into the cell list
+ * \param d_embed_cell_ids Cell indexes of embedded particles
+ * \param d_pos_embed Particle positions
+ * \param d_embed_member_idx Indexes of embedded particles in \a d_pos_embed
+ * \param N_mpcd Number of MPCD particles already in the cell list
+ * \param N_embed Number of embedded particles
+ *
+ * \b Implementation
+ * One thread is launched per embedded particle, which is binned as in compute_cell_list and appended to its cell
+ * with index \a N_mpcd plus its index in the group.
+ */
+__global__ void cell_append_embed(const mpcd::gpu::cell_bin_args_t bin,
+                                  unsigned int *d_embed_cell_ids,
+                                  const Scalar4 *d_pos_embed,
+                                  const unsigned int *d_embed_member_idx,
+                                  const unsigned int N_mpcd,
+                                  const unsigned int N_embed)
+    {
+    // one thread per embedded particle
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N_embed)
+        return;
+
+    const Scalar4 postype_i = d_pos_embed[d_embed_member_idx[idx]];
+    const Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
+    const unsigned int pid = N_mpcd + idx;
+
+    if (isnan(pos_i.x) || isnan(pos_i.y) || isnan(pos_i.z))
+        {
+        (*bin.d_conditions).y = pid + 1;
+        return;
+        }
+
+    const unsigned int bin_idx = mpcd::gpu::detail::find_cell(pos_i,
+                                                              bin.periodic,
+                                                              bin.origin_idx,
+                                                              bin.grid_shift,
+                                                              bin.global_lo,
+                                                              bin.n_global_cell,
+                                                              bin.cell_size,
+                                                              bin.cell_indexer);
+    if (bin_idx == mpcd::detail::NO_CELL)
+        {
+        (*bin.d_conditions).z = pid + 1;
+        return;
+        }
+
+    const unsigned int offset = atomicInc(&bin.d_cell_np[bin_idx], 0xffffffff);
+    if (offset < bin.cell_np_max)
+        {
+        bin.d_cell_list[bin.cell_list_indexer(offset, bin_idx)] = pid;
+        }
+    else
+        {
+        // overflow
+        atomicMax(&(*bin.d_conditions).x, offset+1);
+        }
+
+    d_embed_cell_ids[idx] = bin_idx;
+    }
+
 /*!
  * \param d_migrate_flag Flag signaling migration is required (output)
  * \param d_pos Embedded particle positions
@@ -312,6 +344,50 @@ cudaError_t mpcd::gpu::compute_cell_list(unsigned int *d_cell_np,
     return cudaSuccess;
     }
 
+/*!
+ * \param bin Arguments to bin particles into the cell list
+ * \param d_embed_cell_ids Cell indexes of embedded particles
+ * \param d_pos_embed Particle positions
+ * \param d_embed_member_idx Indexes of embedded particles in \a d_pos_embed
+ * \param N_mpcd Number of MPCD particles already in the cell list
+ * \param N_embed Number of embedded particles
+ * \param block_size Number of threads per block
+ *
+ * \returns cudaSuccess on completion, or an error on failure
+ *
+ * \sa mpcd::gpu::kernel::cell_append_embed
+ */
+cudaError_t mpcd::gpu::cell_append_embed(const cell_bin_args_t& bin,
+                                         unsigned int *d_embed_cell_ids,
+                                         const Scalar4 *d_pos_embed,
+                                         const unsigned int *d_embed_member_idx,
+                                         const unsigned int N_mpcd,
+                                         const unsigned int N_embed,
+                                         const unsigned int block_size)
+    {
+    if (N_embed == 0)
+        return cudaSuccess;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::cell_append_embed);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(N_embed / run_block_size + 1);
+    mpcd::gpu::kernel::cell_append_embed<<<grid, run_block_size>>>(bin,
+                                                                   d_embed_cell_ids,
+                                                                   d_pos_embed,
+                                                                   d_embed_member_idx,
+                                                                   N_mpcd,
+                                                                   N_embed);
+
+    return cudaSuccess;
+    }
+
 /*!
  * \param d_migrate_flag Flag signaling migration is required (output)
  * \param d_pos Embedded particle positions
@@ -13,6 +13,7 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
 #include "hoomd/BoxDim.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
@@ -22,6 +23,23 @@ namespace mpcd
 namespace gpu
 {
 
+//! Arguments to bin particles into the MPCD cell list from another kernel
+struct cell_bin_args_t
+    {
+    unsigned int *d_cell_np;        //!< Number of particles per cell
+    unsigned int *d_cell_list;      //!< 2D array of MPCD particles in each cell
+    uint3 *d_conditions;            //!< Conditions flags for error reporting
+    uchar3 periodic;                //!< Flags if local simulation is periodic
+    int3 origin_idx;                //!< Global origin index for the local box
+    Scalar3 grid_shift;             //!< Random grid shift vector
+    Scalar3 global_lo;              //!< Lower bound of global orthorhombic simulation box
+    uint3 n_global_cell;            //!< Global dimensions of the cell list, including padding
+    Scalar cell_size;               //!< Cell width
+    unsigned int cell_np_max;       //!< Maximum number of particles per cell
+    Index3D cell_indexer;           //!< 3D indexer for cell id
+    Index2D cell_list_indexer;      //!< 2D indexer for particle position in cell
+    };
+
 //! Kernel driver to compute mpcd cell list
 cudaError_t compute_cell_list(unsigned int *d_cell_np,
                               unsigned int *d_cell_list,
@@ -44,6 +62,15 @@ cudaError_t compute_cell_list(unsigned int *d_cell_np,
                               const unsigned int N_tot,
                               const unsigned int block_size);
 
+//! Kernel driver to add the embedded particles to a filled mpcd cell list
+cudaError_t cell_append_embed(const cell_bin_args_t& bin,
+                              unsigned int *d_embed_cell_ids,
+                              const Scalar4 *d_pos_embed,
+                              const unsigned int *d_embed_member_idx,
+                              const unsigned int N_mpcd,
+                              const unsigned int N_embed,
+                              const unsigned int block_size);
+
 //! Kernel driver to check if any embedded particles require migration
 cudaError_t cell_check_migrate_embed(unsigned int *d_migrate_flag,
                                      const Scalar4 *d_pos,
@@ -61,6 +88,81 @@ cudaError_t cell_apply_sort(unsigned int *d_cell_list,
                             const unsigned int N_mpcd,
                             const unsigned int block_size);
 
+#ifdef __HIPCC__
+namespace detail
+{
+//! Find the local cell of a position
+/*!
+ * \param pos Particle position
+ * \param periodic Flags if local simulation is periodic
+ * \param origin_idx Global origin index for the local box
+ * \param grid_shift Random grid shift vector
+ * \param global_lo Lower bound of global orthorhombic simulation box
+ * \param n_global_cell Global dimensions of the cell list, including padding
+ * \param cell_size Cell width
+ * \param cell_indexer 3D indexer for cell id
+ *
+ * \returns Index of the local cell, or mpcd::detail::NO_CELL if the position lies outside the local cells
+ *
+ * The position is floored into a bin subject to the random grid shift, assuming an orthorhombic box.
+ */
+__device__ inline unsigned int find_cell(const Scalar3& pos,
+                                         const uchar3& periodic,
+                                         const int3& origin_idx,
+                                         const Scalar3& grid_shift,
+                                         const Scalar3& global_lo,
+                                         const uint3& n_global_cell,
+                                         const Scalar cell_size,
+                                         const Index3D& cell_indexer)
+    {
+    const Scalar3 delta = (pos - grid_shift) - global_lo;
+    int3 global_bin = make_int3(std::floor(delta.x / cell_size),
+                                std::floor(delta.y / cell_size),
+                                std::floor(delta.z / cell_size));
+
+    // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
+    // this is done using periodic from the "local" box, since this will be periodic
+    // only when there is one rank along the dimension
+    if (periodic.x)
+        {
+        if (global_bin.x == (int)n_global_cell.x)
+            global_bin.x = 0;
+        else if (global_bin.x == -1)
+            global_bin.x = n_global_cell.x - 1;
+        }
+    if (periodic.y)
+        {
+        if (global_bin.y == (int)n_global_cell.y)
+            global_bin.y = 0;
+        else if (global_bin.y == -1)
+            global_bin.y = n_global_cell.y - 1;
+        }
+    if (periodic.z)
+        {
+        if (global_bin.z == (int)n_global_cell.z)
+            global_bin.z = 0;
+        else if (global_bin.z == -1)
+            global_bin.z = n_global_cell.z - 1;
+        }
+
+    // compute the local cell
+    int3 bin = make_int3(global_bin.x - origin_idx.x,
+                         global_bin.y - origin_idx.y,
+                         global_bin.z - origin_idx.z);
+
+    // validate and make sure no particles blew out of the box
+    if ((bin.x < 0 || bin.x >= (int)cell_indexer.getW()) ||
+        (bin.y < 0 || bin.y >= (int)cell_indexer.getH()) ||
+        (bin.z < 0 || bin.z >= (int)cell_indexer.getD()))
+        {
+        return mpcd::detail::NO_CELL;
+        }
+
+    return cell_indexer(bin.x, bin.y, bin.z);
+    }
+} // end namespace detail
+#endif // __HIPCC__
+
 } // end namespace gpu
 } // end namespace mpcd
 
@@ -16,6 +16,7 @@
 #endif
 
 #include "CellList.h"
+#include "CellListGPU.cuh"
 #include "hoomd/Autotuner.h"
 
 namespace mpcd
@@ -42,15 +43,25 @@ class PYBIND11_EXPORT CellListGPU : public mpcd::CellList
 
             m_tuner_cell->setPeriod(period); m_tuner_cell->setEnabled(enable);
             m_tuner_sort->setPeriod(period); m_tuner_sort->setEnabled(enable);
+            m_tuner_embed->setPeriod(period); m_tuner_embed->setEnabled(enable);
             #ifdef ENABLE_MPI
             m_tuner_embed_migrate->setPeriod(period); m_tuner_embed_migrate->setEnabled(enable);
             #endif // ENABLE_MPI
             }
 
+        //! Get the arguments to fill the cell list from another kernel
+        mpcd::gpu::cell_bin_args_t getPrebinArgs(unsigned int *d_cell_np, unsigned int *d_cell_list);
+
     protected:
         //! Compute the cell list of particles on the GPU
         virtual void buildCellList();
 
+        //! Add the embedded particles to the cell list filled by another kernel on the GPU
+        virtual bool appendEmbedded();
+
+        //! Get the global dimensions of the cell list, including padding
+        uint3 getNGlobalCells();
+
         //! Callback to sort cell list on the GPU when particle data is sorted
         virtual void sort(uint64_t timestep,
                           const GPUArray<unsigned int>& order,
@@ -65,6 +76,7 @@ class PYBIND11_EXPORT CellListGPU : public mpcd::CellList
     private:
         std::unique_ptr<Autotuner> m_tuner_cell;    //!< Autotuner for the cell list calculation
         std::unique_ptr<Autotuner> m_tuner_sort;    //!< Autotuner for sorting the cell list
+        std::unique_ptr<Autotuner> m_tuner_embed;   //!< Autotuner for adding the embedded particles
         #ifdef ENABLE_MPI
         std::unique_ptr<Autotuner> m_tuner_embed_migrate;   //!< Autotuner for checking embedded migration
         #endif // ENABLE_MPI
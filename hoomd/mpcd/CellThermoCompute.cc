@@ -11,6 +11,11 @@
 #include "CellThermoCompute.h"
 #include "ReductionOperators.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+#endif // ENABLE_TBB
+
 /*!
  * \param sysdata MPCD system data
  * \param suffix Suffix for logged quantities
@@ -364,10 +369,19 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
         }
 
     // iterate over all of the inner cells and compute average velocity, energy, temperature
+    // each cell is independent, so rows of cells can be split between threads
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range2d<unsigned int>(lo.z, hi.z, lo.y, hi.y),
+        [&](const tbb::blocked_range2d<unsigned int>& r) {
+    for (unsigned int k=r.rows().begin(); k != r.rows().end(); ++k)
+        {
+        for (unsigned int j=r.cols().begin(); j != r.cols().end(); ++j)
+    #else
     for (unsigned int k=lo.z; k < hi.z; ++k)
         {
         for (unsigned int j=lo.y; j < hi.y; ++j)
+    #endif // ENABLE_TBB
             {
             for (unsigned int i=lo.x; i < hi.x; ++i)
                 {
@@ -400,6 +414,9 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
                 } // i
             } //j
         } // k
+    #ifdef ENABLE_TBB
+        });
+    #endif // ENABLE_TBB
     }
 
 void mpcd::CellThermoCompute::computeNetProperties()
@@ -71,6 +71,18 @@ bool mpcd::CollisionMethod::peekCollide(uint64_t timestep) const
         return ((timestep - m_next_timestep) % m_period == 0);
     }
 
+/*!
+ * \param timestep Current timestep
+ * \returns The first timestep after \a timestep that peekCollide() is true for
+ */
+uint64_t mpcd::CollisionMethod::getNextCollision(uint64_t timestep) const
+    {
+    if (timestep < m_next_timestep)
+        return m_next_timestep;
+    else
+        return timestep + m_period - (timestep - m_next_timestep) % m_period;
+    }
+
 /*!
  * \param cur_timestep Current simulation timestep
  * \param period New period
@@ -124,36 +136,60 @@ bool mpcd::CollisionMethod::shouldCollide(uint64_t timestep)
  *
  * \post The MPCD cell list has its grid shift set for \a timestep.
  *
- * If grid shifting is enabled, three uniform random numbers are drawn using
- * the Mersenne twister generator. (In two dimensions, only two numbers are drawn.)
- *
- * If grid shifting is disabled, a zero vector is instead set.
+ * \sa computeGridShift
  */
 void mpcd::CollisionMethod::drawGridShift(uint64_t timestep)
     {
-    uint16_t seed = m_sysdef->getSeed();
+    m_cl->setGridShift(computeGridShift(timestep));
+    }
 
+/*!
+ * \param timestep Timestep to compute shifting for
+ * \returns The grid shift that drawGridShift() sets for \a timestep
+ *
+ * If grid shifting is enabled, three uniform random numbers are drawn using
+ * a counter-based generator seeded by \a timestep. (In two dimensions, only two numbers are drawn.)
+ * When the cell list restricts the grid shift to sub-grid steps, whole steps are drawn instead.
+ * The result only depends on \a timestep, so the shift of a later collision can be computed in advance.
+ *
+ * If grid shifting is disabled, a zero vector is instead returned.
+ */
+Scalar3 mpcd::CollisionMethod::computeGridShift(uint64_t timestep) const
+    {
     // return zeros if shifting is off
     if (!m_enable_grid_shift)
         {
-        m_cl->setGridShift(make_scalar3(0.0,0.0,0.0));
+        return make_scalar3(0.0,0.0,0.0);
+        }
+
+    // PRNG using seed and timestep as seeds
+    uint16_t seed = m_sysdef->getSeed();
+    hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::CollisionMethod, timestep, seed),
+                               hoomd::Counter(m_instance));
+    const Scalar max_shift = m_cl->getMaxGridShift();
+    const unsigned int steps = m_cl->getGridShiftSteps();
+
+    Scalar3 shift;
+    if (steps > 0)
+        {
+        // draw whole sub-grid steps with equal probability, so the shift is uniform over a cell up to the step size
+        const Scalar step = m_cl->getGridShiftStep();
+        const int half = steps / 2;
+        hoomd::UniformIntDistribution uniform(steps - 1);
+        shift.x = Scalar((int)uniform(rng) - half) * step;
+        shift.y = Scalar((int)uniform(rng) - half) * step;
+        shift.z = (m_sysdef->getNDimensions() == 3) ? Scalar((int)uniform(rng) - half) * step : Scalar(0.0);
         }
     else
         {
-        // PRNG using seed and timestep as seeds
-        hoomd::RandomGenerator rng(hoomd::Seed(hoomd::RNGIdentifier::CollisionMethod, timestep, seed),
-                                   hoomd::Counter(m_instance));
-        const Scalar max_shift = m_cl->getMaxGridShift();
-
         // draw shift variables from uniform distribution
-        Scalar3 shift;
         hoomd::UniformDistribution<Scalar> uniform(-max_shift, max_shift);
         shift.x = uniform(rng);
         shift.y = uniform(rng);
         shift.z = (m_sysdef->getNDimensions() == 3) ? uniform(rng) : Scalar(0.0);
-
-        m_cl->setGridShift(shift);
         }
+
+    return shift;
     }
 
 /*!
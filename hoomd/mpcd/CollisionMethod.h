@@ -43,6 +43,9 @@ class PYBIND11_EXPORT CollisionMethod
         //! Peek if a collision will occur on this timestep
         virtual bool peekCollide(uint64_t timestep) const;
 
+        //! Get the first timestep after \a timestep on which a collision will occur
+        uint64_t getNextCollision(uint64_t timestep) const;
+
         //! Sets the profiler for the integration method to use
         void setProfiler(std::shared_ptr<Profiler> prof)
             {
@@ -70,6 +73,9 @@ class PYBIND11_EXPORT CollisionMethod
         //! Generates the random grid shift vector
         void drawGridShift(uint64_t timestep);
 
+        //! Compute the random grid shift vector that will be drawn on a timestep
+        Scalar3 computeGridShift(uint64_t timestep) const;
+
         //! Sets a group of particles that is coupled to the MPCD solvent through the collision step
         /*!
          * \param embed_group Group to embed
@@ -215,7 +215,9 @@ void mpcd::Communicator::communicate(uint64_t timestep)
         }
     if (migrate)
         {
-        migrateParticles(timestep);
+        // skip the exchange if all particles are still covered by the cell list, unless forced
+        if (m_force_migrate || needsMigrate())
+            migrateParticles(timestep);
         m_force_migrate = false;
         }
 
@@ -260,15 +262,16 @@ void mpcd::Communicator::migrateParticles(uint64_t timestep)
     {
     if (m_prof) m_prof->push("migrate");
 
+    // virtual particles are not migrated, so remove them and let the integrator fill them again
     if (m_mpcd_pdata->getNVirtual() > 0)
         {
-        m_exec_conf->msg->warning() << "MPCD communication with virtual particles set is not supported, removing them." << std::endl;
+        m_exec_conf->msg->notice(6) << "MPCD communicator removing virtual particles before migration" << std::endl;
         m_mpcd_pdata->removeVirtualParticles();
         }
 
-    // determine local particles that are to be sent to neighboring processors
+    // send all particles that have left the local domain, which resets the diffusion layer
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
-    setCommFlags(box);
+    setCommFlags(m_pdata->getBox());
 
     // fill send buffer once
     if (m_prof) m_prof->push("pack");
@@ -408,6 +411,49 @@ void mpcd::Communicator::migrateParticles(uint64_t timestep)
     if (m_prof) m_prof->pop();
     }
 
+/*!
+ * \returns True if a particle on any rank has left the box covered by the cell list
+ *
+ * The particles do not need to be migrated until one of them can no longer be binned into the cell list.
+ * All ranks must agree on the result because the migration is a collective operation.
+ */
+bool mpcd::Communicator::needsMigrate()
+    {
+    if (m_prof) m_prof->push("check");
+    const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
+    char migrate = static_cast<char>(checkParticlesOutside(box));
+    MPI_Allreduce(MPI_IN_PLACE, &migrate, 1, MPI_CHAR, MPI_MAX, m_mpi_comm);
+    if (m_prof) m_prof->pop();
+
+    return static_cast<bool>(migrate);
+    }
+
+/*!
+ * \param box Bounding box
+ * \returns True if any local particle lies outside \a box
+ */
+bool mpcd::Communicator::checkParticlesOutside(const BoxDim& box)
+    {
+    const unsigned int N = m_mpcd_pdata->getN();
+    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+
+    // same test as setCommFlags, but stop at the first particle outside the box
+    const Scalar3 lo = box.getLo();
+    const Scalar3 hi = box.getHi();
+    for (unsigned int idx = 0; idx < N; ++idx)
+        {
+        const Scalar4 postype = h_pos.data[idx];
+        if (postype.x >= hi.x || postype.x < lo.x ||
+            postype.y >= hi.y || postype.y < lo.y ||
+            postype.z >= hi.z || postype.z < lo.z)
+            {
+            return true;
+            }
+        }
+
+    return false;
+    }
+
 /*!
  * \param box Bounding box
  *
@@ -49,6 +49,13 @@ namespace mpcd
  * far, the only communication needed for MPCD particles is migration, which is handled
  * using the same algorithms as for the standard ::ParticleData (::Communicator::migrateParticles).
  *
+ * Particles may lie anywhere inside the box covered by the mpcd::CellList, which includes a diffusion
+ * layer around the local domain. Migration is requested on every collision step, but it is only performed
+ * when a particle has left this coverage box on some rank (or when it is forced). A migration sends every
+ * particle outside the local domain, so that the particles can stream through the whole diffusion layer
+ * before the next migration is needed. Increasing the number of extra cells (mpcd::CellList::setNExtraCells)
+ * makes migrations less frequent at the cost of communicating more cells.
+ *
  * There is unfortunately significant code duplication with ::Communicator, but
  * there is little that can be done about this without creating an abstracted
  * communication base class.
@@ -122,6 +129,9 @@ class PYBIND11_EXPORT Communicator
          */
         virtual void migrateParticles(uint64_t timestep);
 
+        //! Check if any particle needs to be migrated
+        bool needsMigrate();
+
         //! Migration signal type
         typedef Nano::Signal<bool (uint64_t timestep)> MigrateSignal;
 
@@ -146,6 +156,9 @@ class PYBIND11_EXPORT Communicator
         //! Set the communication flags for the particle data
         virtual void setCommFlags(const BoxDim& box);
 
+        //! Check if any local particle lies outside a box
+        virtual bool checkParticlesOutside(const BoxDim& box);
+
         //! Checks for overdecomposition
         void checkDecomposition();
 
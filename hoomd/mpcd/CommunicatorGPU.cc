@@ -14,6 +14,7 @@
 #include "CommunicatorGPU.h"
 #include "CommunicatorGPU.cuh"
 
+#include "hoomd/CachedAllocator.h"
 #include "hoomd/Profiler.h"
 
 namespace py = pybind11;
@@ -28,7 +29,8 @@ mpcd::CommunicatorGPU::CommunicatorGPU(std::shared_ptr<mpcd::SystemData> system_
       m_max_stages(1),
       m_num_stages(0),
       m_comm_mask(0),
-      m_tmp_keys(m_exec_conf)
+      m_tmp_keys(m_exec_conf),
+      m_outside_flags(m_exec_conf)
     {
     // initialize communication stages
     initializeCommunicationStages();
@@ -162,9 +164,10 @@ void mpcd::CommunicatorGPU::migrateParticles(uint64_t timestep)
     {
     if (m_prof) m_prof->push("migrate");
 
+    // virtual particles are not migrated, so remove them and let the integrator fill them again
     if (m_mpcd_pdata->getNVirtual() > 0)
         {
-        m_exec_conf->msg->warning() << "MPCD communication with virtual particles set is not supported, removing them." << std::endl;
+        m_exec_conf->msg->notice(6) << "MPCD communicator removing virtual particles before migration" << std::endl;
         m_mpcd_pdata->removeVirtualParticles();
         }
 
@@ -173,9 +176,9 @@ void mpcd::CommunicatorGPU::migrateParticles(uint64_t timestep)
     m_n_recv_ptls.resize(m_n_unique_neigh);
     m_offsets.resize(m_n_unique_neigh);
 
-    // determine local particles that are to be sent to neighboring processors
+    // send all particles that have left the local domain, which resets the diffusion layer
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
-    setCommFlags(box);
+    setCommFlags(m_pdata->getBox());
 
     for (unsigned int stage = 0; stage < m_num_stages; stage++)
         {
@@ -353,6 +356,42 @@ void mpcd::CommunicatorGPU::setCommFlags(const BoxDim& box)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*!
+ * \param box Bounding box
+ * \returns True if any local particle lies outside \a box
+ *
+ * The communication flags are set for \a box, and then reduced with a bitwise OR on the GPU.
+ */
+bool mpcd::CommunicatorGPU::checkParticlesOutside(const BoxDim& box)
+    {
+    const unsigned int N = m_mpcd_pdata->getN();
+    if (N == 0) return false;
+
+    setCommFlags(box);
+
+    ArrayHandle<unsigned int> d_comm_flag(m_mpcd_pdata->getCommFlags(), access_location::device, access_mode::read);
+    void *d_tmp = NULL;
+    size_t tmp_bytes = 0;
+    mpcd::gpu::reduce_comm_flags(m_outside_flags.getDeviceFlags(),
+                                 d_tmp,
+                                 tmp_bytes,
+                                 d_comm_flag.data,
+                                 N);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+
+    ScopedAllocation<unsigned char> d_tmp_alloc(m_exec_conf->getCachedAllocator(), (tmp_bytes > 0) ? tmp_bytes : 1);
+    d_tmp = (void*)d_tmp_alloc();
+
+    mpcd::gpu::reduce_comm_flags(m_outside_flags.getDeviceFlags(),
+                                 d_tmp,
+                                 tmp_bytes,
+                                 d_comm_flag.data,
+                                 N);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+
+    return (m_outside_flags.readFlags() != 0);
+    }
+
 /*!
  * \param m Python module to export to
  */
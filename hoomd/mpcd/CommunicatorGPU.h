@@ -83,6 +83,9 @@ class PYBIND11_EXPORT CommunicatorGPU : public mpcd::Communicator
         //! Set the communication flags for the particle data on the GPU
         virtual void setCommFlags(const BoxDim& box);
 
+        //! Check if any local particle lies outside a box on the GPU
+        virtual bool checkParticlesOutside(const BoxDim& box);
+
     private:
         /* General communication */
         unsigned int m_max_stages;                     //!< Maximum number of (dependent) communication stages
@@ -97,6 +100,7 @@ class PYBIND11_EXPORT CommunicatorGPU : public mpcd::Communicator
         std::vector<unsigned int> m_n_send_ptls;        //!< Number of particles sent per neighbor
         std::vector<unsigned int> m_n_recv_ptls;        //!< Number of particles received per neighbor
         std::vector<unsigned int> m_offsets;            //!< Offsets for particle send buffers
+        GPUFlags<unsigned int> m_outside_flags;         //!< Reduced communication flags of the local particles
 
         //! Helper function to set up communication stages
         void initializeCommunicationStages();
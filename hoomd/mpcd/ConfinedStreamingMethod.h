@@ -18,6 +18,11 @@
 #include "StreamingMethod.h"
 #include <pybind11/pybind11.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif // ENABLE_TBB
+
 namespace mpcd
 {
 
@@ -112,7 +117,15 @@ void ConfinedStreamingMethod<Geometry>::stream(uint64_t timestep)
     // acquire polymorphic pointer to the external field
     const mpcd::ExternalField* field = (m_field) ? m_field->get(access_location::host) : nullptr;
 
-    for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
+    // particles stream independently, so they can be split between threads
+    const unsigned int N = m_mpcd_pdata->getN();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+    #else
+    for (unsigned int cur_p = 0; cur_p < N; ++cur_p)
+    #endif // ENABLE_TBB
         {
         const Scalar4 postype = h_pos.data[cur_p];
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
@@ -148,6 +161,9 @@ void ConfinedStreamingMethod<Geometry>::stream(uint64_t timestep)
         h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
         h_vel.data[cur_p] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif // ENABLE_TBB
 
     // particles have moved, so the cell cache is no longer valid
     m_mpcd_pdata->invalidateCellCache();
@@ -11,6 +11,7 @@
  * \brief Declaration of CUDA kernels for mpcd::ConfinedStreamingMethodGPU
  */
 
+#include "CellListGPU.cuh"
 #include "ExternalField.h"
 #include "ParticleDataUtilities.h"
 #include "hoomd/BoxDim.h"
@@ -33,7 +34,8 @@ struct stream_args_t
                   const Scalar _dt,
                   const unsigned int _N,
                   const unsigned int _block_size)
-        : d_pos(_d_pos), d_vel(_d_vel), mass(_mass), field(_field), box(_box), dt(_dt), N(_N), block_size(_block_size)
+        : d_pos(_d_pos), d_vel(_d_vel), mass(_mass), field(_field), box(_box), dt(_dt), N(_N), block_size(_block_size),
+          stream(0)
         { }
 
     Scalar4 *d_pos;                     //!< Particle positions
@@ -44,12 +46,17 @@ struct stream_args_t
     const Scalar dt;                    //!< Timestep
     const unsigned int N;               //!< Number of particles
     const unsigned int block_size;      //!< Number of threads per block
+    cudaStream_t stream;                //!< Stream to launch the kernels on
     };
 
 //! Kernel driver to stream particles ballistically
 template<class Geometry>
 cudaError_t confined_stream(const stream_args_t& args, const Geometry& geom);
 
+//! Kernel driver to stream particles ballistically and bin them into the cell list
+template<class Geometry>
+cudaError_t confined_stream_bin(const stream_args_t& args, const cell_bin_args_t& bin, const Geometry& geom);
+
 #ifdef __HIPCC__
 namespace kernel
 {
@@ -129,6 +136,111 @@ __global__ void confined_stream(Scalar4 *d_pos,
     d_vel[idx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
     }
 
+//! Kernel to stream particles ballistically and bin them into the cell list
+/*!
+ * \param d_pos Particle positions
+ * \param d_vel Particle velocities
+ * \param mass Particle mass
+ * \param box Simulation box
+ * \param dt Timestep to stream
+ * \param field Applied external field
+ * \param N Number of particles
+ * \param geom Confined geometry
+ * \param bin Arguments to bin the particles into the cell list
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * \b Implementation
+ * The particles are streamed as in mpcd::gpu::kernel::confined_stream. The final position, which is still in
+ * registers, is then binned into the cell list as in mpcd::gpu::kernel::compute_cell_list, and the cell id is
+ * stashed into the velocity array. This saves the pass over the positions and velocities that the cell list would
+ * need before the next collision.
+ */
+template<class Geometry>
+__global__ void confined_stream_bin(Scalar4 *d_pos,
+                                    Scalar4 *d_vel,
+                                    const Scalar mass,
+                                    const mpcd::ExternalField* field,
+                                    const BoxDim box,
+                                    const Scalar dt,
+                                    const unsigned int N,
+                                    const Geometry geom,
+                                    const mpcd::gpu::cell_bin_args_t bin)
+    {
+    // one thread per particle
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N)
+        return;
+
+    const Scalar4 postype = d_pos[idx];
+    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+    const unsigned int type = __scalar_as_int(postype.w);
+
+    const Scalar4 vel_cell = d_vel[idx];
+    Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
+    // estimate next velocity based on current acceleration
+    if (field)
+        {
+        vel += Scalar(0.5) * dt * field->evaluate(pos) / mass;
+        }
+
+    // propagate the particle to its new position ballistically
+    Scalar dt_remain = dt;
+    bool collide = true;
+    do
+        {
+        pos += dt_remain * vel;
+        collide = geom.detectCollision(pos, vel, dt_remain);
+        }
+    while (dt_remain > 0 && collide);
+    // finalize velocity update
+    if (field)
+        {
+        vel += Scalar(0.5) * dt * field->evaluate(pos) / mass;
+        }
+
+    // wrap and update the position
+    int3 image = make_int3(0,0,0);
+    box.wrap(pos, image);
+    d_pos[idx] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
+
+    // bin the particle for the next collision
+    unsigned int bin_idx = mpcd::detail::NO_CELL;
+    if (isnan(pos.x) || isnan(pos.y) || isnan(pos.z))
+        {
+        (*bin.d_conditions).y = idx + 1;
+        }
+    else
+        {
+        bin_idx = mpcd::gpu::detail::find_cell(pos,
+                                               bin.periodic,
+                                               bin.origin_idx,
+                                               bin.grid_shift,
+                                               bin.global_lo,
+                                               bin.n_global_cell,
+                                               bin.cell_size,
+                                               bin.cell_indexer);
+        if (bin_idx == mpcd::detail::NO_CELL)
+            {
+            (*bin.d_conditions).z = idx + 1;
+            }
+        else
+            {
+            const unsigned int offset = atomicInc(&bin.d_cell_np[bin_idx], 0xffffffff);
+            if (offset < bin.cell_np_max)
+                {
+                bin.d_cell_list[bin.cell_list_indexer(offset, bin_idx)] = idx;
+                }
+            else
+                {
+                // overflow
+                atomicMax(&(*bin.d_conditions).x, offset+1);
+                }
+            }
+        }
+    d_vel[idx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(bin_idx));
+    }
+
 } // end namespace kernel
 
 /*!
@@ -152,7 +264,39 @@ cudaError_t confined_stream(const stream_args_t& args, const Geometry& geom)
 
     unsigned int run_block_size = min(args.block_size, max_block_size);
     dim3 grid(args.N / run_block_size + 1);
-    mpcd::gpu::kernel::confined_stream<Geometry><<<grid, run_block_size>>>(args.d_pos, args.d_vel, args.mass, args.field, args.box, args.dt, args.N, geom);
+    mpcd::gpu::kernel::confined_stream<Geometry><<<grid, run_block_size, 0, args.stream>>>(args.d_pos, args.d_vel, args.mass, args.field, args.box, args.dt, args.N, geom);
+
+    return cudaSuccess;
+    }
+
+/*!
+ * \param args Common arguments for a streaming kernel
+ * \param bin Arguments to bin the particles into the cell list
+ * \param geom Confined geometry
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * \sa mpcd::gpu::kernel::confined_stream_bin
+ */
+template<class Geometry>
+cudaError_t confined_stream_bin(const stream_args_t& args, const cell_bin_args_t& bin, const Geometry& geom)
+    {
+    // set the number of particles in each cell to zero
+    cudaError_t error = cudaMemsetAsync(bin.d_cell_np, 0, sizeof(unsigned int)*bin.cell_indexer.getNumElements(), args.stream);
+    if (error != cudaSuccess)
+        return error;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::confined_stream_bin<Geometry>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(args.block_size, max_block_size);
+    dim3 grid(args.N / run_block_size + 1);
+    mpcd::gpu::kernel::confined_stream_bin<Geometry><<<grid, run_block_size, 0, args.stream>>>(args.d_pos, args.d_vel, args.mass, args.field, args.box, args.dt, args.N, geom, bin);
 
     return cudaSuccess;
     }
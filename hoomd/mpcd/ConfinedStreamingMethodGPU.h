@@ -15,6 +15,7 @@
 #error This header cannot be compiled by nvcc
 #endif
 
+#include "CellListGPU.h"
 #include "ConfinedStreamingMethod.h"
 #include "ConfinedStreamingMethodGPU.cuh"
 #include "hoomd/Autotuner.h"
@@ -26,6 +27,14 @@ namespace mpcd
 /*!
  * This method implements the GPU version of ballistic propagation of MPCD
  * particles in a confined geometry.
+ *
+ * When the next collision was requested to be binned with requestPrebin(), the particles are binned into
+ * the cell list in the same kernel that streams them.
+ *
+ * The kernels can be launched on a separate stream given by setStream(). They wait for the work already queued on
+ * the default stream, but the default stream does not wait for them until the caller joins the streams. The
+ * cell list overflow flags are read on the host, so checking the binned cell list is deferred to finishStream().
+ * The kernels are not autotuned while they run on a separate stream because the autotuner times the default stream.
  */
 template<class Geometry>
 class PYBIND11_EXPORT ConfinedStreamingMethodGPU : public mpcd::ConfinedStreamingMethod<Geometry>
@@ -47,6 +56,14 @@ class PYBIND11_EXPORT ConfinedStreamingMethodGPU : public mpcd::ConfinedStreamin
             : mpcd::ConfinedStreamingMethod<Geometry>(sysdata, cur_timestep, period, phase, geom)
             {
             m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_stream", this->m_exec_conf));
+            m_tuner_bin.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_stream_bin", this->m_exec_conf));
+            hipEventCreateWithFlags(&m_fork_event, hipEventDisableTiming);
+            }
+
+        //! Destructor
+        virtual ~ConfinedStreamingMethodGPU()
+            {
+            hipEventDestroy(m_fork_event);
             }
 
         //! Implementation of the streaming rule
@@ -63,10 +80,33 @@ class PYBIND11_EXPORT ConfinedStreamingMethodGPU : public mpcd::ConfinedStreamin
             {
             ConfinedStreamingMethod<Geometry>::setAutotunerParams(enable, period);
             m_tuner->setEnabled(enable); m_tuner->setPeriod(period);
+            m_tuner_bin->setEnabled(enable); m_tuner_bin->setPeriod(period);
+            }
+
+        //! The streaming kernels can be launched on a separate stream
+        virtual bool supportsStream()
+            {
+            return true;
+            }
+
+        //! Check the cell list binned by a streaming step on a separate stream
+        virtual void finishStream()
+            {
+            if (m_pending_cl)
+                {
+                m_pending_cl->finishPrebin();
+                m_pending_cl.reset();
+                }
             }
 
     protected:
         std::unique_ptr<Autotuner> m_tuner;
+        std::unique_ptr<Autotuner> m_tuner_bin;     //!< Autotuner for streaming with cell binning
+        hipEvent_t m_fork_event;                    //!< Event for the separate stream to wait on the default stream
+        std::shared_ptr<mpcd::CellListGPU> m_pending_cl;    //!< Cell list binned on a separate stream, not yet checked
+
+        //! Make the separate stream wait for the work queued on the default stream
+        void forkStream();
     };
 
 /*!
@@ -86,27 +126,81 @@ void ConfinedStreamingMethodGPU<Geometry>::stream(uint64_t timestep)
         }
 
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, "MPCD stream");
-    ArrayHandle<Scalar4> d_pos(this->m_mpcd_pdata->getPositions(), access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar4> d_vel(this->m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-    mpcd::gpu::stream_args_t args(d_pos.data,
-                                  d_vel.data,
-                                  this->m_mpcd_pdata->getMass(),
-                                  (this->m_field) ? this->m_field->get(access_location::device) : nullptr,
-                                  this->m_mpcd_sys->getCellList()->getCoverageBox(),
-                                  this->m_mpcd_dt,
-                                  this->m_mpcd_pdata->getN(),
-                                  m_tuner->getParam());
-
-    m_tuner->begin();
-    mpcd::gpu::confined_stream<Geometry>(args, *(this->m_geom));
-    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
-    m_tuner->end();
+
+    // bin the particles for the next collision while they are streamed, if requested
+    std::shared_ptr<mpcd::CellListGPU> cl;
+    if (this->m_prebin)
+        {
+        this->m_prebin = false;
+        cl = std::dynamic_pointer_cast<mpcd::CellListGPU>(this->m_mpcd_sys->getCellList());
+        if (cl && !cl->beginPrebin(this->m_prebin_timestep, this->m_prebin_shift))
+            cl.reset();
+        }
+
+        {
+        ArrayHandle<Scalar4> d_pos(this->m_mpcd_pdata->getPositions(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_vel(this->m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+        mpcd::gpu::stream_args_t args(d_pos.data,
+                                      d_vel.data,
+                                      this->m_mpcd_pdata->getMass(),
+                                      (this->m_field) ? this->m_field->get(access_location::device) : nullptr,
+                                      this->m_mpcd_sys->getCellList()->getCoverageBox(),
+                                      this->m_mpcd_dt,
+                                      this->m_mpcd_pdata->getN(),
+                                      (cl) ? m_tuner_bin->getParam() : m_tuner->getParam());
+        args.stream = this->m_stream;
+        const bool tune = (this->m_stream == 0);
+
+        if (cl)
+            {
+            ArrayHandle<unsigned int> d_cell_np(cl->getCellSizeArray(), access_location::device, access_mode::overwrite);
+            ArrayHandle<unsigned int> d_cell_list(cl->getCellList(), access_location::device, access_mode::overwrite);
+            const mpcd::gpu::cell_bin_args_t bin = cl->getPrebinArgs(d_cell_np.data, d_cell_list.data);
+
+            forkStream();
+            if (tune) m_tuner_bin->begin();
+            mpcd::gpu::confined_stream_bin<Geometry>(args, bin, *(this->m_geom));
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+            if (tune) m_tuner_bin->end();
+            }
+        else
+            {
+            forkStream();
+            if (tune) m_tuner->begin();
+            mpcd::gpu::confined_stream<Geometry>(args, *(this->m_geom));
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+            if (tune) m_tuner->end();
+            }
+        }
+
+    // check the cell list now that the particle data is released, or once the separate stream is joined
+    if (cl)
+        {
+        if (this->m_stream == 0)
+            cl->finishPrebin();
+        else
+            m_pending_cl = cl;
+        }
 
     // particles have moved, so the cell cache is no longer valid
     this->m_mpcd_pdata->invalidateCellCache();
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
     }
 
+/*!
+ * Any copies made while the particle data was acquired for the device are queued on the default stream, so the
+ * separate stream must wait for them before the kernels are launched.
+ */
+template<class Geometry>
+void ConfinedStreamingMethodGPU<Geometry>::forkStream()
+    {
+    if (this->m_stream == 0)
+        return;
+
+    hipEventRecord(m_fork_event, 0);
+    hipStreamWaitEvent(this->m_stream, m_fork_event, 0);
+    }
+
 namespace detail
 {
 //! Export mpcd::StreamingMethodGPU to python
@@ -0,0 +1,404 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/FlowFieldAnalyzer.cc
+ * \brief Definition of mpcd::FlowFieldAnalyzer
+ */
+
+#include "FlowFieldAnalyzer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <pybind11/numpy.h>
+
+/*!
+ * \param sysdata MPCD system data
+ * \param thermo Compute of the cell properties to average
+ * \param nx Number of bins along x, or 0 for one bin per cell
+ * \param ny Number of bins along y, or 0 for one bin per cell
+ * \param nz Number of bins along z, or 0 for one bin per cell
+ */
+mpcd::FlowFieldAnalyzer::FlowFieldAnalyzer(std::shared_ptr<mpcd::SystemData> sysdata,
+                                           std::shared_ptr<mpcd::CellThermoCompute> thermo,
+                                           unsigned int nx,
+                                           unsigned int ny,
+                                           unsigned int nz)
+    : Analyzer(sysdata->getSystemDefinition()), m_thermo(thermo), m_cl(sysdata->getCellList()),
+      m_cell_momentum(m_exec_conf), m_cell_thermal(m_exec_conf), m_num_samples(0), m_sample_ready(false),
+      m_cells_dirty(false)
+    {
+    assert(m_thermo);
+    assert(m_cl);
+    m_exec_conf->msg->notice(5) << "Constructing MPCD FlowFieldAnalyzer" << std::endl;
+
+    m_num_bins = make_uint3(nx, ny, nz);
+    m_bin_dim = make_uint3(0,0,0);
+    m_bin_global_dim = make_uint3(0,0,0);
+    m_sum_origin = make_int3(0,0,0);
+    m_sum_upper = make_uint3(0,0,0);
+
+    m_thermo->getFlagsSignal().connect<mpcd::FlowFieldAnalyzer, &mpcd::FlowFieldAnalyzer::getRequestedThermoFlags>(this);
+    m_thermo->getCallbackSignal().connect<mpcd::FlowFieldAnalyzer, &mpcd::FlowFieldAnalyzer::slotThermoComputed>(this);
+    }
+
+mpcd::FlowFieldAnalyzer::~FlowFieldAnalyzer()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying MPCD FlowFieldAnalyzer" << std::endl;
+    m_thermo->getFlagsSignal().disconnect<mpcd::FlowFieldAnalyzer, &mpcd::FlowFieldAnalyzer::getRequestedThermoFlags>(this);
+    m_thermo->getCallbackSignal().disconnect<mpcd::FlowFieldAnalyzer, &mpcd::FlowFieldAnalyzer::slotThermoComputed>(this);
+    }
+
+/*!
+ * \param timestep Current timestep
+ *
+ * The cell properties are not computed again for \a timestep. Instead, the properties from the last time the
+ * CellThermoCompute ran (for example, in the last collision) are sampled if they have not been sampled yet. This keeps
+ * the analyzer from building a cell list with a stale grid shift, and a trigger with the collision period samples
+ * every collision exactly once.
+ */
+void mpcd::FlowFieldAnalyzer::analyze(uint64_t timestep)
+    {
+    if (!m_sample_ready) return;
+
+    if (m_prof) m_prof->push(m_exec_conf, "MPCD flow field");
+
+    updateCells();
+    accumulate();
+    m_sample_ready = false;
+    m_cells_dirty = true;
+    ++m_num_samples;
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+void mpcd::FlowFieldAnalyzer::accumulate()
+    {
+    ArrayHandle<double4> h_cell_vel(m_thermo->getCellVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<double3> h_cell_energy(m_thermo->getCellEnergies(), access_location::host, access_mode::read);
+    ArrayHandle<double4> h_cell_momentum(m_cell_momentum, access_location::host, access_mode::readwrite);
+    ArrayHandle<double2> h_cell_thermal(m_cell_thermal, access_location::host, access_mode::readwrite);
+
+    const unsigned int ncells = m_sum_ci.getNumElements();
+    for (unsigned int idx=0; idx < ncells; ++idx)
+        {
+        const double4 vel_mass = h_cell_vel.data[idx];
+        double4 momentum = h_cell_momentum.data[idx];
+        momentum.x += vel_mass.w * vel_mass.x;
+        momentum.y += vel_mass.w * vel_mass.y;
+        momentum.z += vel_mass.w * vel_mass.z;
+        momentum.w += vel_mass.w;
+        h_cell_momentum.data[idx] = momentum;
+
+        // temperature is only defined for 2 or more particles
+        const double3 energy = h_cell_energy.data[idx];
+        const int np = __double_as_int(energy.z);
+        if (np > 1)
+            {
+            h_cell_thermal.data[idx].x += energy.y * (np-1);
+            h_cell_thermal.data[idx].y += (np-1);
+            }
+        }
+    }
+
+/*!
+ * If the cells changed since the last sample, the per-cell sums are added into the bins and then laid out for the
+ * new cells.
+ */
+void mpcd::FlowFieldAnalyzer::updateCells()
+    {
+    m_cl->computeDimensions();
+    const Index3D& ci = m_cl->getCellIndexer();
+    const int3 origin = m_cl->getOriginIndex();
+    uint3 upper = make_uint3(ci.getW(), ci.getH(), ci.getD());
+    #ifdef ENABLE_MPI
+    // in MPI, the last cells along the direction of communication are duplicates of the neighbor's cells
+    if (m_exec_conf->getNRanks() > 1)
+        {
+        auto num_comm = m_cl->getNComm();
+        upper.x -= num_comm[static_cast<unsigned int>(mpcd::detail::face::east)];
+        upper.y -= num_comm[static_cast<unsigned int>(mpcd::detail::face::north)];
+        upper.z -= num_comm[static_cast<unsigned int>(mpcd::detail::face::up)];
+        }
+    #endif // ENABLE_MPI
+
+    if (ci.getW() == m_sum_ci.getW() && ci.getH() == m_sum_ci.getH() && ci.getD() == m_sum_ci.getD()
+        && origin.x == m_sum_origin.x && origin.y == m_sum_origin.y && origin.z == m_sum_origin.z
+        && upper.x == m_sum_upper.x && upper.y == m_sum_upper.y && upper.z == m_sum_upper.z)
+        return;
+
+    foldCells();
+
+    m_sum_ci = ci;
+    m_sum_origin = origin;
+    m_sum_upper = upper;
+
+    const unsigned int ncells = ci.getNumElements();
+    m_cell_momentum.resize(ncells);
+    m_cell_thermal.resize(ncells);
+        {
+        ArrayHandle<double4> h_cell_momentum(m_cell_momentum, access_location::host, access_mode::overwrite);
+        ArrayHandle<double2> h_cell_thermal(m_cell_thermal, access_location::host, access_mode::overwrite);
+        memset(h_cell_momentum.data, 0, sizeof(double4)*ncells);
+        memset(h_cell_thermal.data, 0, sizeof(double2)*ncells);
+        }
+
+    updateBins();
+    }
+
+/*!
+ * The bins are laid out again when the global cells change, which discards the samples.
+ */
+void mpcd::FlowFieldAnalyzer::updateBins()
+    {
+    const uint3 global_dim = m_cl->getGlobalDim();
+    if (global_dim.x == m_bin_global_dim.x && global_dim.y == m_bin_global_dim.y && global_dim.z == m_bin_global_dim.z)
+        return;
+
+    uint3 bin_dim = make_uint3(m_num_bins.x > 0 ? m_num_bins.x : global_dim.x,
+                               m_num_bins.y > 0 ? m_num_bins.y : global_dim.y,
+                               m_num_bins.z > 0 ? m_num_bins.z : global_dim.z);
+    if (global_dim.x % bin_dim.x != 0 || global_dim.y % bin_dim.y != 0 || global_dim.z % bin_dim.z != 0)
+        {
+        m_exec_conf->msg->error() << "mpcd: " << bin_dim.x << " x " << bin_dim.y << " x " << bin_dim.z
+                                  << " flow field bins do not evenly divide the " << global_dim.x << " x "
+                                  << global_dim.y << " x " << global_dim.z << " cells" << std::endl;
+        throw std::runtime_error("Error laying out MPCD flow field bins");
+        }
+
+    if (m_num_samples > 0)
+        {
+        m_exec_conf->msg->warning() << "mpcd: cells changed, discarding " << m_num_samples
+                                    << " flow field samples" << std::endl;
+        }
+
+    m_bin_dim = bin_dim;
+    m_bin_global_dim = global_dim;
+    m_num_samples = 0;
+
+    const unsigned int nbins = m_bin_dim.x * m_bin_dim.y * m_bin_dim.z;
+    m_bin_mass.assign(nbins, 0.0);
+    m_bin_momentum.assign(3*nbins, 0.0);
+    m_bin_thermal.assign(nbins, 0.0);
+    m_bin_dof.assign(nbins, 0.0);
+    }
+
+void mpcd::FlowFieldAnalyzer::foldCells()
+    {
+    if (!m_cells_dirty) return;
+
+    ArrayHandle<double4> h_cell_momentum(m_cell_momentum, access_location::host, access_mode::readwrite);
+    ArrayHandle<double2> h_cell_thermal(m_cell_thermal, access_location::host, access_mode::readwrite);
+
+    const Index3D bin_idx(m_bin_dim.x, m_bin_dim.y, m_bin_dim.z);
+    const uint3 cells_per_bin = make_uint3(m_bin_global_dim.x / m_bin_dim.x,
+                                           m_bin_global_dim.y / m_bin_dim.y,
+                                           m_bin_global_dim.z / m_bin_dim.z);
+    const int3 G = make_int3(m_bin_global_dim.x, m_bin_global_dim.y, m_bin_global_dim.z);
+
+    for (unsigned int k=0; k < m_sum_upper.z; ++k)
+        {
+        const int gk = ((((int)k + m_sum_origin.z) % G.z) + G.z) % G.z;
+        for (unsigned int j=0; j < m_sum_upper.y; ++j)
+            {
+            const int gj = ((((int)j + m_sum_origin.y) % G.y) + G.y) % G.y;
+            for (unsigned int i=0; i < m_sum_upper.x; ++i)
+                {
+                const int gi = ((((int)i + m_sum_origin.x) % G.x) + G.x) % G.x;
+                const unsigned int bin = bin_idx(gi / cells_per_bin.x, gj / cells_per_bin.y, gk / cells_per_bin.z);
+
+                const unsigned int idx = m_sum_ci(i,j,k);
+                const double4 momentum = h_cell_momentum.data[idx];
+                const double2 thermal = h_cell_thermal.data[idx];
+                m_bin_momentum[3*bin] += momentum.x;
+                m_bin_momentum[3*bin+1] += momentum.y;
+                m_bin_momentum[3*bin+2] += momentum.z;
+                m_bin_mass[bin] += momentum.w;
+                m_bin_thermal[bin] += thermal.x;
+                m_bin_dof[bin] += thermal.y;
+                }
+            }
+        }
+
+    const unsigned int ncells = m_sum_ci.getNumElements();
+    memset(h_cell_momentum.data, 0, sizeof(double4)*ncells);
+    memset(h_cell_thermal.data, 0, sizeof(double2)*ncells);
+    m_cells_dirty = false;
+    }
+
+/*!
+ * \param mass Summed mass in each bin (output)
+ * \param momentum Summed momentum in each bin (output)
+ * \param thermal Summed thermal energy in each bin (output)
+ * \param dof Summed degrees of freedom in each bin (output)
+ *
+ * This method must be called on all ranks.
+ */
+void mpcd::FlowFieldAnalyzer::reduceBins(std::vector<double>& mass,
+                                         std::vector<double>& momentum,
+                                         std::vector<double>& thermal,
+                                         std::vector<double>& dof)
+    {
+    foldCells();
+
+    mass = m_bin_mass;
+    momentum = m_bin_momentum;
+    thermal = m_bin_thermal;
+    dof = m_bin_dof;
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1 && !mass.empty())
+        {
+        MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        MPI_Allreduce(MPI_IN_PLACE, mass.data(), (int)mass.size(), MPI_DOUBLE, MPI_SUM, mpi_comm);
+        MPI_Allreduce(MPI_IN_PLACE, momentum.data(), (int)momentum.size(), MPI_DOUBLE, MPI_SUM, mpi_comm);
+        MPI_Allreduce(MPI_IN_PLACE, thermal.data(), (int)thermal.size(), MPI_DOUBLE, MPI_SUM, mpi_comm);
+        MPI_Allreduce(MPI_IN_PLACE, dof.data(), (int)dof.size(), MPI_DOUBLE, MPI_SUM, mpi_comm);
+        }
+    #endif // ENABLE_MPI
+    }
+
+/*!
+ * \returns Number of bins along each direction
+ */
+uint3 mpcd::FlowFieldAnalyzer::getNumBins()
+    {
+    updateCells();
+    return m_bin_dim;
+    }
+
+/*!
+ * \returns Mass per volume in each bin, ordered with z varying fastest
+ *
+ * This method must be called on all ranks.
+ */
+std::vector<double> mpcd::FlowFieldAnalyzer::getDensity()
+    {
+    updateCells();
+    std::vector<double> mass, momentum, thermal, dof;
+    reduceBins(mass, momentum, thermal, dof);
+
+    // volume of a bin, which is an area in 2D
+    const Scalar cell_size = m_cl->getCellSize();
+    double bin_volume = (double)(m_bin_global_dim.x / m_bin_dim.x) * cell_size
+                        * (double)(m_bin_global_dim.y / m_bin_dim.y) * cell_size;
+    if (m_sysdef->getNDimensions() == 3)
+        bin_volume *= (double)(m_bin_global_dim.z / m_bin_dim.z) * cell_size;
+
+    const Index3D bin_idx(m_bin_dim.x, m_bin_dim.y, m_bin_dim.z);
+    std::vector<double> density;
+    density.reserve(mass.size());
+    for (unsigned int i=0; i < m_bin_dim.x; ++i)
+        for (unsigned int j=0; j < m_bin_dim.y; ++j)
+            for (unsigned int k=0; k < m_bin_dim.z; ++k)
+                {
+                const unsigned int bin = bin_idx(i,j,k);
+                density.push_back((m_num_samples > 0) ? mass[bin] / (bin_volume * m_num_samples) : 0.0);
+                }
+    return density;
+    }
+
+/*!
+ * \returns Mass-weighted velocity in each bin, ordered with the component and then z varying fastest
+ *
+ * This method must be called on all ranks.
+ */
+std::vector<double> mpcd::FlowFieldAnalyzer::getVelocity()
+    {
+    updateCells();
+    std::vector<double> mass, momentum, thermal, dof;
+    reduceBins(mass, momentum, thermal, dof);
+
+    const Index3D bin_idx(m_bin_dim.x, m_bin_dim.y, m_bin_dim.z);
+    std::vector<double> velocity;
+    velocity.reserve(momentum.size());
+    for (unsigned int i=0; i < m_bin_dim.x; ++i)
+        for (unsigned int j=0; j < m_bin_dim.y; ++j)
+            for (unsigned int k=0; k < m_bin_dim.z; ++k)
+                {
+                const unsigned int bin = bin_idx(i,j,k);
+                for (unsigned int d=0; d < 3; ++d)
+                    {
+                    velocity.push_back((mass[bin] > 0) ? momentum[3*bin+d] / mass[bin] : 0.0);
+                    }
+                }
+    return velocity;
+    }
+
+/*!
+ * \returns Temperature in each bin, ordered with z varying fastest
+ *
+ * This method must be called on all ranks.
+ */
+std::vector<double> mpcd::FlowFieldAnalyzer::getTemperature()
+    {
+    updateCells();
+    std::vector<double> mass, momentum, thermal, dof;
+    reduceBins(mass, momentum, thermal, dof);
+
+    const Index3D bin_idx(m_bin_dim.x, m_bin_dim.y, m_bin_dim.z);
+    std::vector<double> temperature;
+    temperature.reserve(thermal.size());
+    for (unsigned int i=0; i < m_bin_dim.x; ++i)
+        for (unsigned int j=0; j < m_bin_dim.y; ++j)
+            for (unsigned int k=0; k < m_bin_dim.z; ++k)
+                {
+                const unsigned int bin = bin_idx(i,j,k);
+                temperature.push_back((dof[bin] > 0) ? thermal[bin] / dof[bin] : 0.0);
+                }
+    return temperature;
+    }
+
+void mpcd::FlowFieldAnalyzer::reset()
+    {
+    updateCells();
+    foldCells();
+    std::fill(m_bin_mass.begin(), m_bin_mass.end(), 0.0);
+    std::fill(m_bin_momentum.begin(), m_bin_momentum.end(), 0.0);
+    std::fill(m_bin_thermal.begin(), m_bin_thermal.end(), 0.0);
+    std::fill(m_bin_dof.begin(), m_bin_dof.end(), 0.0);
+    m_num_samples = 0;
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_FlowFieldAnalyzer(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<mpcd::FlowFieldAnalyzer, Analyzer, std::shared_ptr<mpcd::FlowFieldAnalyzer> >(m, "FlowFieldAnalyzer")
+        .def(py::init< std::shared_ptr<mpcd::SystemData>,
+                       std::shared_ptr<mpcd::CellThermoCompute>,
+                       unsigned int,
+                       unsigned int,
+                       unsigned int >())
+        .def("reset", &mpcd::FlowFieldAnalyzer::reset)
+        .def_property_readonly("num_samples", &mpcd::FlowFieldAnalyzer::getNumSamples)
+        .def_property_readonly("num_bins", [](mpcd::FlowFieldAnalyzer& self)
+            {
+            const uint3 n = self.getNumBins();
+            return py::make_tuple(n.x, n.y, n.z);
+            })
+        .def_property_readonly("density", [](mpcd::FlowFieldAnalyzer& self)
+            {
+            const uint3 n = self.getNumBins();
+            const std::vector<double> density = self.getDensity();
+            return py::array_t<double>(std::vector<size_t>{n.x, n.y, n.z}, density.data());
+            })
+        .def_property_readonly("velocity", [](mpcd::FlowFieldAnalyzer& self)
+            {
+            const uint3 n = self.getNumBins();
+            const std::vector<double> velocity = self.getVelocity();
+            return py::array_t<double>(std::vector<size_t>{n.x, n.y, n.z, 3}, velocity.data());
+            })
+        .def_property_readonly("temperature", [](mpcd::FlowFieldAnalyzer& self)
+            {
+            const uint3 n = self.getNumBins();
+            const std::vector<double> temperature = self.getTemperature();
+            return py::array_t<double>(std::vector<size_t>{n.x, n.y, n.z}, temperature.data());
+            })
+        ;
+    }
@@ -0,0 +1,145 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/FlowFieldAnalyzer.h
+ * \brief Declaration of mpcd::FlowFieldAnalyzer
+ */
+
+#ifndef MPCD_FLOW_FIELD_ANALYZER_H_
+#define MPCD_FLOW_FIELD_ANALYZER_H_
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "CellThermoCompute.h"
+#include "SystemData.h"
+
+#include "hoomd/Analyzer.h"
+#include <pybind11/pybind11.h>
+
+#include <vector>
+
+namespace mpcd
+{
+
+//! Accumulates time-averaged flow fields of the MPCD solvent
+/*!
+ * The analyzer averages the mass density, velocity, and temperature of the solvent over time in bins of whole
+ * MPCD cells. The cell properties are taken from a CellThermoCompute: every time it computes the cell properties
+ * (typically once per collision), the next call to analyze() adds the mass, momentum, and thermal energy of each
+ * cell to per-cell sums. The per-cell sums stay in the memory of the device doing the work, so a sample costs one
+ * pass over the cells and no communication.
+ *
+ * The per-cell sums are only added into the output bins, and summed across ranks, when the fields are requested or
+ * the cells change. The bins divide the global cells evenly along each direction, so a 1D profile has one bin along
+ * the other two directions and per-cell fields have one bin per cell.
+ *
+ * The temperature of a bin is the average of the cell temperatures weighted by the number of degrees of freedom in
+ * each cell, so it does not include the flow between cells in the bin.
+ */
+class PYBIND11_EXPORT FlowFieldAnalyzer : public Analyzer
+    {
+    public:
+        //! Constructor
+        FlowFieldAnalyzer(std::shared_ptr<mpcd::SystemData> sysdata,
+                          std::shared_ptr<mpcd::CellThermoCompute> thermo,
+                          unsigned int nx,
+                          unsigned int ny,
+                          unsigned int nz);
+
+        //! Destructor
+        virtual ~FlowFieldAnalyzer();
+
+        //! Add the latest cell properties to the averages
+        virtual void analyze(uint64_t timestep);
+
+        //! Get the number of samples in the averages
+        unsigned int getNumSamples() const
+            {
+            return m_num_samples;
+            }
+
+        //! Get the number of bins along each direction
+        uint3 getNumBins();
+
+        //! Get the averaged mass density in each bin
+        std::vector<double> getDensity();
+
+        //! Get the averaged velocity in each bin
+        std::vector<double> getVelocity();
+
+        //! Get the averaged temperature in each bin
+        std::vector<double> getTemperature();
+
+        //! Discard the samples
+        void reset();
+
+    protected:
+        std::shared_ptr<mpcd::CellThermoCompute> m_thermo;  //!< Source of the cell properties
+        std::shared_ptr<mpcd::CellList> m_cl;               //!< MPCD cell list
+
+        GPUVector<double4> m_cell_momentum; //!< Summed momentum and mass of each cell
+        GPUVector<double2> m_cell_thermal;  //!< Summed thermal energy and degrees of freedom of each cell
+
+        //! Add the current cell properties to the per-cell sums
+        virtual void accumulate();
+
+    private:
+        uint3 m_num_bins;                   //!< Requested number of bins along each direction (0 is one per cell)
+        uint3 m_bin_dim;                    //!< Number of bins along each direction
+        uint3 m_bin_global_dim;             //!< Global cell dimensions the bins were laid out for
+        unsigned int m_num_samples;         //!< Number of samples in the averages
+        bool m_sample_ready;                //!< True if the cell properties changed since the last sample
+
+        Index3D m_sum_ci;                   //!< Cell indexer of the per-cell sums
+        int3 m_sum_origin;                  //!< Global index of the first cell of the per-cell sums
+        uint3 m_sum_upper;                  //!< Number of cells owned by this rank along each direction
+        bool m_cells_dirty;                 //!< True if the per-cell sums hold samples not yet added to the bins
+
+        std::vector<double> m_bin_mass;     //!< Summed mass in each bin on this rank
+        std::vector<double> m_bin_momentum; //!< Summed momentum in each bin on this rank
+        std::vector<double> m_bin_thermal;  //!< Summed thermal energy in each bin on this rank
+        std::vector<double> m_bin_dof;      //!< Summed degrees of freedom in each bin on this rank
+
+        //! Match the per-cell sums to the current cells
+        void updateCells();
+
+        //! Add the per-cell sums of the owned cells to the bins and zero them
+        void foldCells();
+
+        //! Lay out the bins for the global cells
+        void updateBins();
+
+        //! Sum the bins across ranks
+        void reduceBins(std::vector<double>& mass,
+                        std::vector<double>& momentum,
+                        std::vector<double>& thermal,
+                        std::vector<double>& dof);
+
+        //! Request the cell energies from the CellThermoCompute
+        mpcd::detail::ThermoFlags getRequestedThermoFlags() const
+            {
+            mpcd::detail::ThermoFlags flags;
+            flags[mpcd::detail::thermo_options::energy] = 1;
+            return flags;
+            }
+
+        //! Slot for the cell properties being computed
+        void slotThermoComputed(uint64_t timestep)
+            {
+            m_sample_ready = true;
+            }
+    };
+
+namespace detail
+{
+//! Export the FlowFieldAnalyzer class to python
+void export_FlowFieldAnalyzer(pybind11::module& m);
+} // end namespace detail
+
+} // end namespace mpcd
+#endif // MPCD_FLOW_FIELD_ANALYZER_H_
@@ -0,0 +1,62 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/FlowFieldAnalyzerGPU.cc
+ * \brief Definition of mpcd::FlowFieldAnalyzerGPU
+ */
+
+#include "FlowFieldAnalyzerGPU.h"
+#include "FlowFieldAnalyzerGPU.cuh"
+
+/*!
+ * \param sysdata MPCD system data
+ * \param thermo Compute of the cell properties to average
+ * \param nx Number of bins along x, or 0 for one bin per cell
+ * \param ny Number of bins along y, or 0 for one bin per cell
+ * \param nz Number of bins along z, or 0 for one bin per cell
+ */
+mpcd::FlowFieldAnalyzerGPU::FlowFieldAnalyzerGPU(std::shared_ptr<mpcd::SystemData> sysdata,
+                                                 std::shared_ptr<mpcd::CellThermoCompute> thermo,
+                                                 unsigned int nx,
+                                                 unsigned int ny,
+                                                 unsigned int nz)
+    : mpcd::FlowFieldAnalyzer(sysdata, thermo, nx, ny, nz)
+    {
+    m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_flow_field", m_exec_conf));
+    }
+
+void mpcd::FlowFieldAnalyzerGPU::accumulate()
+    {
+    ArrayHandle<double4> d_cell_vel(m_thermo->getCellVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<double3> d_cell_energy(m_thermo->getCellEnergies(), access_location::device, access_mode::read);
+    ArrayHandle<double4> d_cell_momentum(m_cell_momentum, access_location::device, access_mode::readwrite);
+    ArrayHandle<double2> d_cell_thermal(m_cell_thermal, access_location::device, access_mode::readwrite);
+
+    m_tuner->begin();
+    mpcd::gpu::flow_field_accumulate(d_cell_momentum.data,
+                                     d_cell_thermal.data,
+                                     d_cell_vel.data,
+                                     d_cell_energy.data,
+                                     m_cell_momentum.size(),
+                                     m_tuner->getParam());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner->end();
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_FlowFieldAnalyzerGPU(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<mpcd::FlowFieldAnalyzerGPU, mpcd::FlowFieldAnalyzer, std::shared_ptr<mpcd::FlowFieldAnalyzerGPU> >(m, "FlowFieldAnalyzerGPU")
+        .def(py::init< std::shared_ptr<mpcd::SystemData>,
+                       std::shared_ptr<mpcd::CellThermoCompute>,
+                       unsigned int,
+                       unsigned int,
+                       unsigned int >())
+        ;
+    }
@@ -0,0 +1,99 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/FlowFieldAnalyzerGPU.cu
+ * \brief Defines GPU functions and kernels used by mpcd::FlowFieldAnalyzerGPU
+ */
+
+#include "FlowFieldAnalyzerGPU.cuh"
+
+namespace mpcd
+{
+namespace gpu
+{
+namespace kernel
+{
+//! Kernel to add the cell properties to the per-cell sums
+/*!
+ * \param d_cell_momentum Summed momentum and mass of each cell
+ * \param d_cell_thermal Summed thermal energy and degrees of freedom of each cell
+ * \param d_cell_vel Cell velocities and masses
+ * \param d_cell_energy Cell kinetic energies, temperatures, and number of particles
+ * \param num_cells Number of cells
+ *
+ * \b Implementation
+ * Using one thread per cell, the cell properties are added to the sums of the cell. No thread writes to another
+ * cell, so no atomic operations are needed.
+ */
+__global__ void flow_field_accumulate(double4 *d_cell_momentum,
+                                      double2 *d_cell_thermal,
+                                      const double4 *d_cell_vel,
+                                      const double3 *d_cell_energy,
+                                      const unsigned int num_cells)
+    {
+    // one thread per cell
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= num_cells)
+        return;
+
+    const double4 vel_mass = d_cell_vel[idx];
+    double4 momentum = d_cell_momentum[idx];
+    momentum.x += vel_mass.w * vel_mass.x;
+    momentum.y += vel_mass.w * vel_mass.y;
+    momentum.z += vel_mass.w * vel_mass.z;
+    momentum.w += vel_mass.w;
+    d_cell_momentum[idx] = momentum;
+
+    // temperature is only defined for 2 or more particles
+    const double3 energy = d_cell_energy[idx];
+    const int np = __double_as_int(energy.z);
+    if (np > 1)
+        {
+        double2 thermal = d_cell_thermal[idx];
+        thermal.x += energy.y * (np-1);
+        thermal.y += (np-1);
+        d_cell_thermal[idx] = thermal;
+        }
+    }
+} // end namespace kernel
+} // end namespace gpu
+} // end namespace mpcd
+
+/*!
+ * \param d_cell_momentum Summed momentum and mass of each cell
+ * \param d_cell_thermal Summed thermal energy and degrees of freedom of each cell
+ * \param d_cell_vel Cell velocities and masses
+ * \param d_cell_energy Cell kinetic energies, temperatures, and number of particles
+ * \param num_cells Number of cells
+ * \param block_size Number of threads per block
+ *
+ * \returns cudaSuccess on completion
+ */
+cudaError_t mpcd::gpu::flow_field_accumulate(double4 *d_cell_momentum,
+                                             double2 *d_cell_thermal,
+                                             const double4 *d_cell_vel,
+                                             const double3 *d_cell_energy,
+                                             const unsigned int num_cells,
+                                             const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::flow_field_accumulate);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(num_cells / run_block_size + 1);
+    mpcd::gpu::kernel::flow_field_accumulate<<<grid, run_block_size>>>(d_cell_momentum,
+                                                                       d_cell_thermal,
+                                                                       d_cell_vel,
+                                                                       d_cell_energy,
+                                                                       num_cells);
+
+    return cudaSuccess;
+    }
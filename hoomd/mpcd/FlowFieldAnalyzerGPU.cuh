@@ -0,0 +1,32 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#ifndef MPCD_FLOW_FIELD_ANALYZER_GPU_CUH_
+#define MPCD_FLOW_FIELD_ANALYZER_GPU_CUH_
+
+/*!
+ * \file mpcd/FlowFieldAnalyzerGPU.cuh
+ * \brief Declaration of CUDA kernels for mpcd::FlowFieldAnalyzerGPU
+ */
+
+#include <cuda_runtime.h>
+
+#include "hoomd/HOOMDMath.h"
+
+namespace mpcd
+{
+namespace gpu
+{
+//! Kernel driver to add the cell properties to the per-cell sums
+cudaError_t flow_field_accumulate(double4 *d_cell_momentum,
+                                  double2 *d_cell_thermal,
+                                  const double4 *d_cell_vel,
+                                  const double3 *d_cell_energy,
+                                  const unsigned int num_cells,
+                                  const unsigned int block_size);
+} // end namespace gpu
+} // end namespace mpcd
+
+#endif // MPCD_FLOW_FIELD_ANALYZER_GPU_CUH_
@@ -0,0 +1,65 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/FlowFieldAnalyzerGPU.h
+ * \brief Declaration of mpcd::FlowFieldAnalyzerGPU
+ */
+
+#ifndef MPCD_FLOW_FIELD_ANALYZER_GPU_H_
+#define MPCD_FLOW_FIELD_ANALYZER_GPU_H_
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "FlowFieldAnalyzer.h"
+#include "hoomd/Autotuner.h"
+
+namespace mpcd
+{
+
+//! Accumulates time-averaged flow fields of the MPCD solvent on the GPU
+/*!
+ * The per-cell sums are accumulated on the GPU from the cell properties of a CellThermoComputeGPU, so the cell
+ * properties are only copied to the host when the fields are requested.
+ */
+class PYBIND11_EXPORT FlowFieldAnalyzerGPU : public mpcd::FlowFieldAnalyzer
+    {
+    public:
+        //! Constructor
+        FlowFieldAnalyzerGPU(std::shared_ptr<mpcd::SystemData> sysdata,
+                             std::shared_ptr<mpcd::CellThermoCompute> thermo,
+                             unsigned int nx,
+                             unsigned int ny,
+                             unsigned int nz);
+
+        //! Set autotuner parameters
+        /*!
+         * \param enable Enable/disable autotuning
+         * \param period period (approximate) in time steps when returning occurs
+         */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            mpcd::FlowFieldAnalyzer::setAutotunerParams(enable, period);
+            m_tuner->setEnabled(enable); m_tuner->setPeriod(period);
+            }
+
+    protected:
+        //! Add the current cell properties to the per-cell sums on the GPU
+        virtual void accumulate();
+
+    private:
+        std::unique_ptr<Autotuner> m_tuner; //!< Tuner for accumulating the cell properties
+    };
+
+namespace detail
+{
+//! Export the FlowFieldAnalyzerGPU class to python
+void export_FlowFieldAnalyzerGPU(pybind11::module& m);
+} // end namespace detail
+
+} // end namespace mpcd
+#endif // MPCD_FLOW_FIELD_ANALYZER_GPU_H_
@@ -19,10 +19,16 @@
  * \param deltaT Fundamental integration timestep
  */
 mpcd::Integrator::Integrator(std::shared_ptr<mpcd::SystemData> sysdata, Scalar deltaT)
-    : IntegratorTwoStep(sysdata->getSystemDefinition(), deltaT), m_mpcd_sys(sysdata)
+    : IntegratorTwoStep(sysdata->getSystemDefinition(), deltaT), m_mpcd_sys(sysdata), m_concurrent_stream(false)
     {
     assert(m_mpcd_sys);
     m_exec_conf->msg->notice(5) << "Constructing MPCD Integrator" << std::endl;
+
+    #ifdef ENABLE_HIP
+    m_solvent_stream = 0;
+    m_solvent_event = 0;
+    m_solvent_forked = false;
+    #endif // ENABLE_HIP
     }
 
 mpcd::Integrator::~Integrator()
@@ -32,6 +38,19 @@ mpcd::Integrator::~Integrator()
     if (m_mpcd_comm)
         m_mpcd_comm->getMigrateRequestSignal().disconnect<mpcd::Integrator, &mpcd::Integrator::checkCollide>(this);
     #endif // ENABLE_MPI
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        m_comm->getMigrateSignal().disconnect<mpcd::Integrator, &mpcd::Integrator::checkEmbedMigrate>(this);
+    #endif // ENABLE_MPI
+
+    #ifdef ENABLE_HIP
+    if (m_solvent_stream)
+        {
+        hipEventDestroy(m_solvent_event);
+        hipStreamDestroy(m_solvent_stream);
+        }
+    #endif // ENABLE_HIP
     }
 
 /*!
@@ -69,10 +88,11 @@ void mpcd::Integrator::update(uint64_t timestep)
         m_gave_warning = true;
         }
 
-    // remove any leftover virtual particles
+    // remove any leftover virtual particles, unless the fillers will redraw them
     if (checkCollide(timestep))
         {
-        m_mpcd_sys->getParticleData()->removeVirtualParticles();
+        if (m_fillers.empty())
+            m_mpcd_sys->getParticleData()->removeVirtualParticles();
         m_collide->drawGridShift(timestep);
         }
 
@@ -84,10 +104,7 @@ void mpcd::Integrator::update(uint64_t timestep)
     // fill in any virtual particles
     if (checkCollide(timestep) && !m_fillers.empty())
         {
-        for (auto filler = m_fillers.begin(); filler != m_fillers.end(); ++filler)
-            {
-            (*filler)->fill(timestep);
-            }
+        fillVirtualParticles(timestep);
         }
 
     // optionally sort
@@ -117,10 +134,7 @@ void mpcd::Integrator::update(uint64_t timestep)
         }
 
     // execute the MPCD streaming step now that MD particles are communicated onto their final domains
-    if (m_stream)
-        {
-        m_stream->stream(timestep);
-        }
+    streamSolvent(timestep);
 
     // compute the net force on the MD particles
 #ifdef ENABLE_HIP
@@ -135,8 +149,132 @@ void mpcd::Integrator::update(uint64_t timestep)
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         (*method)->integrateStepTwo(timestep);
     if (m_prof) m_prof->pop();
+
+    // join the MPCD streaming step now that the MD kernels are queued alongside it
+    joinSolvent();
+    }
+
+/*!
+ * \param timestep Current timestep
+ *
+ * With concurrent streaming enabled on a single GPU, the streaming kernels are launched on a separate stream
+ * that does not synchronize with the default stream, so they run alongside the MD force computes and integration
+ * methods queued after them. The MD kernels never touch the MPCD particles and the streaming kernels never touch
+ * the MD particles, so the streams only need to be joined before the MPCD particles are used again. update()
+ * joins them at the end of the step with a wait on the device, so the host does not block.
+ */
+void mpcd::Integrator::streamSolvent(uint64_t timestep)
+    {
+    if (!m_stream)
+        return;
+
+    requestPrebin(timestep);
+
+    #ifdef ENABLE_HIP
+    if (m_concurrent_stream && m_exec_conf->isCUDAEnabled() && m_exec_conf->getNumActiveGPUs() == 1
+        && m_stream->supportsStream())
+        {
+        if (!m_solvent_stream)
+            {
+            hipStreamCreateWithFlags(&m_solvent_stream, hipStreamNonBlocking);
+            hipEventCreateWithFlags(&m_solvent_event, hipEventDisableTiming);
+            }
+
+        m_stream->setStream(m_solvent_stream);
+        m_stream->stream(timestep);
+        m_stream->setStream(0);
+        m_solvent_forked = true;
+        return;
+        }
+    #endif // ENABLE_HIP
+
+    m_stream->stream(timestep);
+    }
+
+/*!
+ * The default stream waits for the streaming kernels, and the streaming method finishes any work that needed
+ * them to complete.
+ */
+void mpcd::Integrator::joinSolvent()
+    {
+    #ifdef ENABLE_HIP
+    if (!m_solvent_forked)
+        return;
+
+    hipEventRecord(m_solvent_event, m_solvent_stream);
+    hipStreamWaitEvent(0, m_solvent_event, 0);
+    m_solvent_forked = false;
+    m_stream->finishStream();
+    #endif // ENABLE_HIP
+    }
+
+/*!
+ * \param timestep Current timestep
+ *
+ * If nothing changes the MPCD particles between the streaming step on \a timestep and the next collision,
+ * the streaming method is asked to bin the particles into the cell list for that collision while it streams
+ * them. This requires that the next collision occurs before the next streaming step, and that there are no
+ * virtual particles or MPCD particle communication. Sorting is still allowed because the cell list discards the
+ * binned particles when they are reordered. Embedded particles are added to the cell list at the collision.
+ */
+void mpcd::Integrator::requestPrebin(uint64_t timestep)
+    {
+    if (!m_collide || !m_fillers.empty() || !m_stream->peekStream(timestep))
+        return;
+
+    #ifdef ENABLE_MPI
+    if (m_mpcd_comm)
+        return;
+    #endif // ENABLE_MPI
+
+    const uint64_t next_collision = m_collide->getNextCollision(timestep);
+    if (next_collision > timestep + m_stream->getPeriod())
+        return;
+
+    m_stream->requestPrebin(next_collision, m_collide->computeGridShift(next_collision));
+    }
+
+#ifdef ENABLE_MPI
+/*!
+ * \param comm MD communicator
+ *
+ * The integrator subscribes to the migrate signal of \a comm so that embedded particles are migrated by the
+ * regular MD communication before a collision.
+ */
+void mpcd::Integrator::setCommunicator(std::shared_ptr<::Communicator> comm)
+    {
+    if (comm != m_comm)
+        {
+        if (m_comm)
+            m_comm->getMigrateSignal().disconnect<mpcd::Integrator, &mpcd::Integrator::checkEmbedMigrate>(this);
+        if (comm)
+            comm->getMigrateSignal().connect<mpcd::Integrator, &mpcd::Integrator::checkEmbedMigrate>(this);
+        }
+
+    IntegratorTwoStep::setCommunicator(comm);
     }
 
+/*!
+ * \param timestep Timestep the MD particles are communicated for
+ * \returns True if embedded particles must be migrated before the collision at \a timestep
+ *
+ * The MD particles are communicated at the end of each step for the next one, after the embedded particles last
+ * moved. When a collision follows, the cell list checks the embedded particles against the box it covers now, so
+ * they are migrated along with the other MD particles. The cell list then skips its own check and communication.
+ */
+bool mpcd::Integrator::checkEmbedMigrate(uint64_t timestep)
+    {
+    if (!checkCollide(timestep))
+        return false;
+
+    std::shared_ptr<mpcd::CellList> cl = m_mpcd_sys->getCellList();
+    if (!cl->getEmbeddedGroup())
+        return false;
+
+    return cl->checkEmbedMigrate(timestep);
+    }
+#endif // ENABLE_MPI
+
 /*!
  * \param deltaT new deltaT to set
  * \post \a deltaT is also set on all contained integration methods
@@ -164,6 +302,9 @@ void mpcd::Integrator::prepRun(uint64_t timestep)
         }
 
     #ifdef ENABLE_MPI
+    // the particles may have changed since the last run, so the embedded particles must be checked again
+    m_mpcd_sys->getCellList()->clearEmbedMigrateCheck();
+
     // force a communication step if present
     if (m_mpcd_comm)
         {
@@ -187,6 +328,54 @@ void mpcd::Integrator::setAutotunerParams(bool enable, unsigned int period)
         m_sorter->setAutotunerParams(enable,period);
     }
 
+/*!
+ * \param timestep Current timestep
+ *
+ * The virtual particles are kept in the particle data between collisions. If every filler can draw its particles
+ * again in place, and the particle data still holds exactly the blocks they filled in order, they are redrawn. Otherwise,
+ * all virtual particles are removed and filled again. All ranks must take the same path because filling assigns
+ * the tags collectively.
+ */
+void mpcd::Integrator::fillVirtualParticles(uint64_t timestep)
+    {
+    std::shared_ptr<mpcd::ParticleData> mpcd_pdata = m_mpcd_sys->getParticleData();
+
+    // the fillers must still own consecutive blocks covering all the virtual particles
+    unsigned int next_idx = mpcd_pdata->getN();
+    int redraw = 1;
+    for (auto filler = m_fillers.begin(); filler != m_fillers.end(); ++filler)
+        {
+        if (!(*filler)->canRedraw() || (*filler)->getFirstIndex() != next_idx)
+            redraw = 0;
+        next_idx += (*filler)->getNumFill();
+        }
+    if (next_idx != mpcd_pdata->getN() + mpcd_pdata->getNVirtual())
+        redraw = 0;
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &redraw, 1, MPI_INT, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+    #endif // ENABLE_MPI
+
+    if (redraw)
+        {
+        for (auto filler = m_fillers.begin(); filler != m_fillers.end(); ++filler)
+            {
+            (*filler)->redraw(timestep);
+            }
+        }
+    else
+        {
+        mpcd_pdata->removeVirtualParticles();
+        for (auto filler = m_fillers.begin(); filler != m_fillers.end(); ++filler)
+            {
+            (*filler)->fill(timestep);
+            }
+        }
+    }
+
 /*!
  * \param filler Virtual particle filler to add to the integrator
  *
@@ -221,6 +410,7 @@ void mpcd::detail::export_Integrator(pybind11::module& m)
         .def("removeSorter", &mpcd::Integrator::removeSorter)
         .def("addFiller", &mpcd::Integrator::addFiller)
         .def("removeAllFillers", &mpcd::Integrator::removeAllFillers)
+        .def_property("concurrent_stream", &mpcd::Integrator::getConcurrentStream, &mpcd::Integrator::setConcurrentStream)
         #ifdef ENABLE_MPI
         .def("setMPCDCommunicator", &mpcd::Integrator::setMPCDCommunicator)
         #endif // ENABLE_MPI
@@ -53,6 +53,9 @@ class PYBIND11_EXPORT Integrator : public ::IntegratorTwoStep
         virtual void prepRun(uint64_t timestep);
 
 #ifdef ENABLE_MPI
+        //! Set the MD communicator to use
+        virtual void setCommunicator(std::shared_ptr<::Communicator> comm);
+
         //! Set the MPCD communicator to use
         virtual void setMPCDCommunicator(std::shared_ptr<mpcd::Communicator> comm)
             {
@@ -151,6 +154,18 @@ class PYBIND11_EXPORT Integrator : public ::IntegratorTwoStep
             m_fillers.clear();
             }
 
+        //! Set whether the MPCD streaming step runs on a separate stream on the GPU
+        void setConcurrentStream(bool concurrent)
+            {
+            m_concurrent_stream = concurrent;
+            }
+
+        //! Get whether the MPCD streaming step runs on a separate stream on the GPU
+        bool getConcurrentStream() const
+            {
+            return m_concurrent_stream;
+            }
+
     protected:
         std::shared_ptr<mpcd::SystemData> m_mpcd_sys;   //!< MPCD system
         std::shared_ptr<mpcd::CollisionMethod> m_collide;   //!< MPCD collision rule
@@ -162,12 +177,37 @@ class PYBIND11_EXPORT Integrator : public ::IntegratorTwoStep
         #endif // ENABLE_MPI
 
         std::vector<std::shared_ptr<mpcd::VirtualParticleFiller>> m_fillers; //!< MPCD virtual particle fillers
+
+        bool m_concurrent_stream;   //!< True if the MPCD streaming step runs on a separate stream on the GPU
+        #ifdef ENABLE_HIP
+        hipStream_t m_solvent_stream;   //!< Stream for the MPCD streaming step
+        hipEvent_t m_solvent_event;     //!< Event to join the MPCD streaming step to the default stream
+        bool m_solvent_forked;          //!< True if the streaming step was launched on the solvent stream
+        #endif // ENABLE_HIP
+
     private:
         //! Check if a collision will occur at the current timestep
         bool checkCollide(uint64_t timestep)
             {
             return (m_collide && m_collide->peekCollide(timestep));
             }
+
+        #ifdef ENABLE_MPI
+        //! Check if embedded particles must be migrated by the MD communicator before a collision
+        bool checkEmbedMigrate(uint64_t timestep);
+        #endif // ENABLE_MPI
+
+        //! Ask the streaming method to bin the particles for the next collision
+        void requestPrebin(uint64_t timestep);
+
+        //! Fill or redraw the virtual particles for a collision
+        void fillVirtualParticles(uint64_t timestep);
+
+        //! Perform the MPCD streaming step
+        void streamSolvent(uint64_t timestep);
+
+        //! Join the MPCD streaming step to the default stream
+        void joinSolvent();
     };
 
 namespace detail
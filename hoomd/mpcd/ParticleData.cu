@@ -172,10 +172,6 @@ cudaError_t mpcd::gpu::partition_particles(void *d_tmp,
  * \param d_vel Device array of particle velocities
  * \param d_tag Device array of particle tags
  * \param d_comm_flags Device array of communication flags
- * \param d_pos_alt Device array of particle positions (output)
- * \param d_vel_alt Device array of particle velocities (output)
- * \param d_tag_alt Device array of particle tags (output)
- * \param d_comm_flags_alt Device array of communication flags (output)
  * \param d_remove_ids Partitioned indexes of particles to remove (first) or keep (last)
  * \param n_remove Number of particles to remove
  * \param N Current number of particles
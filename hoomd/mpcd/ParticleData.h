@@ -230,38 +230,48 @@ class PYBIND11_EXPORT ParticleData
         //! \name swap methods
         //@{
         //! Get alternate array of MPCD particle positions
-        const GPUArray<Scalar4>& getAltPositions() const
+        /*!
+         * The alternate arrays are only scratch space for reordering the particles, so they are
+         * not allocated until they are first requested.
+         */
+        const GPUArray<Scalar4>& getAltPositions()
             {
+            checkAlternate(m_pos_alt);
             return m_pos_alt;
             }
 
         //! Swap out alternate MPCD particle position array
         void swapPositions()
             {
+            checkAlternate(m_pos_alt);
             m_pos.swap(m_pos_alt);
             }
 
         //! Get alternate array of MPCD particle velocities
-        const GPUArray<Scalar4>& getAltVelocities() const
+        const GPUArray<Scalar4>& getAltVelocities()
             {
+            checkAlternate(m_vel_alt);
             return m_vel_alt;
             }
 
         //! Swap out alternate MPCD particle velocity array
         void swapVelocities()
             {
+            checkAlternate(m_vel_alt);
             m_vel.swap(m_vel_alt);
             }
 
         //! Get alternate array of MPCD particle tags
-        const GPUArray<unsigned int>& getAltTags() const
+        const GPUArray<unsigned int>& getAltTags()
             {
+            checkAlternate(m_tag_alt);
             return m_tag_alt;
             }
 
         //! Swap out alternate MPCD particle tags
         void swapTags()
             {
+            checkAlternate(m_tag_alt);
             m_tag.swap(m_tag_alt);
             }
         //@}
@@ -392,18 +402,6 @@ class PYBIND11_EXPORT ParticleData
             return m_comm_flags;
             }
 
-        //! Get the alternate MPCD particle communication flags
-        const GPUArray<unsigned int>& getAltCommFlags() const
-            {
-            return m_comm_flags_alt;
-            }
-
-        //! Swap out alternate MPCD communication flags
-        void swapCommFlags()
-            {
-            m_comm_flags.swap(m_comm_flags_alt);
-            }
-
         //@}
         #endif // ENABLE_MPI
 
@@ -430,7 +428,6 @@ class PYBIND11_EXPORT ParticleData
         GPUArray<Scalar4> m_vel_alt;        //!< Alternate velocity array
         GPUArray<unsigned int> m_tag_alt;   //!< Alternate tag array
         #ifdef ENABLE_MPI
-        GPUArray<unsigned int> m_comm_flags_alt;    //!< Alternate communication flags
         GPUArray<unsigned int> m_remove_ids;      //!< Partitioned indexes of particles to keep
         #ifdef ENABLE_HIP
         GPUArray<unsigned char> m_remove_flags;   //!< Temporary flag to mark keeping particle
@@ -458,6 +455,22 @@ class PYBIND11_EXPORT ParticleData
         //! Allocate data arrays
         void allocate(unsigned int N_max);
 
+        //! Allocate an alternate array if it cannot hold all particles
+        /*!
+         * \param alt Alternate array
+         *
+         * The contents of \a alt are discarded, since they are overwritten before every swap.
+         */
+        template<class T>
+        void checkAlternate(GPUArray<T>& alt)
+            {
+            if (alt.getNumElements() < m_N_max)
+                {
+                GPUArray<T> tmp(m_N_max, m_exec_conf);
+                alt.swap(tmp);
+                }
+            }
+
         //! Reallocate data arrays
         void reallocate(unsigned int N_max);
 
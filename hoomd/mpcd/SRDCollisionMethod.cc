@@ -12,6 +12,12 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range2d.h>
+#include <tbb/parallel_for.h>
+#endif // ENABLE_TBB
+
 mpcd::SRDCollisionMethod::SRDCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                              unsigned int cur_timestep,
                                              unsigned int period,
@@ -75,9 +81,18 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(uint64_t timestep)
 
     uint16_t seed = m_sysdef->getSeed();
 
+    // each cell has its own random number stream, so rows of cells can be split between threads
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range2d<unsigned int>(0, ci.getD(), 0, ci.getH()),
+        [&](const tbb::blocked_range2d<unsigned int>& r) {
+    for (unsigned int k=r.rows().begin(); k != r.rows().end(); ++k)
+        {
+        for (unsigned int j=r.cols().begin(); j != r.cols().end(); ++j)
+    #else
     for (unsigned int k=0; k < ci.getD(); ++k)
         {
         for (unsigned int j=0; j < ci.getH(); ++j)
+    #endif // ENABLE_TBB
             {
             for (unsigned int i=0; i < ci.getW(); ++i)
                 {
@@ -120,6 +135,9 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(uint64_t timestep)
                 }
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif // ENABLE_TBB
     }
 
 void mpcd::SRDCollisionMethod::rotate(uint64_t timestep)
@@ -157,7 +175,14 @@ void mpcd::SRDCollisionMethod::rotate(uint64_t timestep)
         h_factors.reset(new ArrayHandle<double>(m_factors, access_location::host, access_mode::read));
         }
 
+    // each particle is rotated independently
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+    #else
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    #endif // ENABLE_TBB
         {
         double3 vel;
         unsigned int cell;
@@ -225,6 +250,9 @@ void mpcd::SRDCollisionMethod::rotate(uint64_t timestep)
             h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif // ENABLE_TBB
     }
 
 /*!
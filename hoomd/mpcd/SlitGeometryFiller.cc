@@ -89,7 +89,7 @@ void mpcd::SlitGeometryFiller::drawParticles(uint64_t timestep)
     uint16_t seed = m_sysdef->getSeed();
 
     // index to start filling from
-    const unsigned int first_idx = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual() - m_N_fill;
+    const unsigned int first_idx = m_first_idx;
     for (unsigned int i=0; i < m_N_fill; ++i)
         {
         const unsigned int tag = m_first_tag + i;
@@ -42,6 +42,7 @@ class PYBIND11_EXPORT SlitGeometryFiller : public mpcd::VirtualParticleFiller
         void setGeometry(std::shared_ptr<const mpcd::detail::SlitGeometry> geom)
             {
             m_geom = geom;
+            invalidateFill();
             }
 
     protected:
@@ -30,7 +30,7 @@ void mpcd::SlitGeometryFillerGPU::drawParticles(uint64_t timestep)
     ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
     ArrayHandle<unsigned int> d_tag(m_mpcd_pdata->getTags(), access_location::device, access_mode::readwrite);
 
-    const unsigned int first_idx = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual() - m_N_fill;
+    const unsigned int first_idx = m_first_idx;
 
     uint16_t seed = m_sysdef->getSeed();
 
@@ -35,7 +35,7 @@ void mpcd::SlitPoreGeometryFillerGPU::drawParticles(uint64_t timestep)
     ArrayHandle<Scalar4> d_boxes(m_boxes, access_location::device, access_mode::read);
     ArrayHandle<uint2> d_ranges(m_ranges, access_location::device, access_mode::read);
 
-    const unsigned int first_idx = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual() - m_N_fill;
+    const unsigned int first_idx = m_first_idx;
 
     uint16_t seed = m_sysdef->getSeed();
 
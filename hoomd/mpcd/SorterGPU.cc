@@ -17,11 +17,12 @@
 mpcd::SorterGPU::SorterGPU(std::shared_ptr<mpcd::SystemData> sysdata,
                            unsigned int cur_timestep,
                            unsigned int period)
-    : mpcd::Sorter(sysdata,cur_timestep,period)
+    : mpcd::Sorter(sysdata,cur_timestep,period), m_cell_offset(m_exec_conf)
     {
     m_sentinel_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_sort_sentinel", m_exec_conf));
     m_reverse_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_sort_reverse", m_exec_conf));
     m_apply_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_sort_apply", m_exec_conf));
+    m_order_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_sort_order", m_exec_conf));
     }
 
 /*!
@@ -38,6 +39,35 @@ void mpcd::SorterGPU::computeOrder(uint64_t timestep)
     m_cl->compute(timestep);
     if (m_prof) m_prof->push(m_exec_conf,"MPCD sort");
 
+    // counting sort of the cell list when it holds only MPCD particles
+    if (m_mpcd_pdata->getNVirtual() == 0 && !m_cl->getEmbeddedGroup())
+        {
+        const unsigned int num_cells = m_cl->getNCells();
+        if (m_cell_offset.getNumElements() < num_cells)
+            m_cell_offset.resize(num_cells);
+
+        ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_np(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_offset(m_cell_offset, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_order(m_order, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_rorder(m_rorder, access_location::device, access_mode::overwrite);
+
+        mpcd::gpu::sort_cell_offsets(d_cell_offset.data, d_cell_np.data, num_cells);
+        if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+
+        m_order_tuner->begin();
+        mpcd::gpu::sort_cell_order(d_order.data,
+                                   d_rorder.data,
+                                   d_cell_list.data,
+                                   d_cell_np.data,
+                                   d_cell_offset.data,
+                                   m_cl->getCellListIndexer(),
+                                   m_order_tuner->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+        m_order_tuner->end();
+        return;
+        }
+
     // fill the empty cell list entries with a sentinel larger than number of MPCD particles
         {
         ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::readwrite);
@@ -14,6 +14,7 @@
 #pragma GCC diagnostic ignored "-Wconversion"
 #include <thrust/copy.h>
 #include <thrust/execution_policy.h>
+#include <thrust/scan.h>
 #pragma GCC diagnostic pop
 
 namespace mpcd
@@ -119,6 +120,49 @@ __global__ void sort_gen_reverse(unsigned int *d_rorder,
     d_rorder[pid] = idx;
     }
 
+//! Kernel to compute the particle order by counting sort of the cell list
+/*!
+ * \param d_order Map of new particle indexes onto old particle indexes (output)
+ * \param d_rorder Map of old particle indexes onto new particle indexes (output)
+ * \param d_cell_list Cell list of MPCD particles
+ * \param d_cell_np Number of particles per cell
+ * \param d_cell_offset First new particle index in each cell
+ * \param cli Two-dimensional cell-list indexer
+ * \param N_cli Number of total entries (filled and empty) in the cell list
+ *
+ * \b Implementation
+ * Using one thread per cell-list entry, the 1D kernel index is mapped onto
+ * the 2D entry in the cell list. A filled entry at \a offset in \a cell moves its
+ * particle to the new index d_cell_offset[cell] + offset, and both maps are written
+ * directly. This requires that the cell list holds only MPCD particles.
+ */
+__global__ void sort_cell_order(unsigned int *d_order,
+                                unsigned int *d_rorder,
+                                const unsigned int *d_cell_list,
+                                const unsigned int *d_cell_np,
+                                const unsigned int *d_cell_offset,
+                                const Index2D cli,
+                                const unsigned int N_cli)
+    {
+    // one thread per cell-list entry
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N_cli)
+        return;
+
+    // convert the entry 1D index into a 2D index
+    const unsigned int cell = idx / cli.getW();
+    const unsigned int offset = idx - (cell * cli.getW());
+
+    const unsigned int np = d_cell_np[cell];
+    if (offset < np)
+        {
+        const unsigned int pid = d_cell_list[idx];
+        const unsigned int new_idx = d_cell_offset[cell] + offset;
+        d_order[new_idx] = pid;
+        d_rorder[pid] = new_idx;
+        }
+    }
+
 } // end namespace kernel
 
 /*!
@@ -265,6 +309,68 @@ unsigned int sort_cell_compact(unsigned int *d_order,
     return (unsigned int)(last-d_order);
     }
 
+/*!
+ * \param d_cell_offset First new particle index in each cell (output)
+ * \param d_cell_np Number of particles per cell
+ * \param num_cells Number of cells
+ *
+ * \returns cudaSuccess on completion
+ *
+ * \b Implementation
+ * thrust::exclusive_scan counts the particles in all preceding cells.
+ */
+cudaError_t sort_cell_offsets(unsigned int *d_cell_offset,
+                              const unsigned int *d_cell_np,
+                              const unsigned int num_cells)
+    {
+    thrust::exclusive_scan(thrust::device, d_cell_np, d_cell_np+num_cells, d_cell_offset);
+    return cudaSuccess;
+    }
+
+/*!
+ * \param d_order Map of new particle indexes onto old particle indexes (output)
+ * \param d_rorder Map of old particle indexes onto new particle indexes (output)
+ * \param d_cell_list Cell list of MPCD particles
+ * \param d_cell_np Number of particles per cell
+ * \param d_cell_offset First new particle index in each cell
+ * \param cli Two-dimensional cell-list indexer
+ * \param block_size Number of threads per block
+ *
+ * \returns cudaSuccess on completion
+ *
+ * \sa mpcd::gpu::kernel::sort_cell_order
+ */
+cudaError_t sort_cell_order(unsigned int *d_order,
+                            unsigned int *d_rorder,
+                            const unsigned int *d_cell_list,
+                            const unsigned int *d_cell_np,
+                            const unsigned int *d_cell_offset,
+                            const Index2D& cli,
+                            const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::sort_cell_order);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    const unsigned int N_cli = cli.getNumElements();
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(N_cli / run_block_size + 1);
+    mpcd::gpu::kernel::sort_cell_order<<<grid, run_block_size>>>(d_order,
+                                                                 d_rorder,
+                                                                 d_cell_list,
+                                                                 d_cell_np,
+                                                                 d_cell_offset,
+                                                                 cli,
+                                                                 N_cli);
+
+    return cudaSuccess;
+    }
+
 /*!
  * \param d_rorder Map of old particle indexes onto new particle indexes (output)
  * \param d_order Map of new particle indexes onto old particle indexes
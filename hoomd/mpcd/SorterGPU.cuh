@@ -44,6 +44,20 @@ unsigned int sort_cell_compact(unsigned int *d_order,
                                const unsigned int num_items,
                                const unsigned int N_mpcd);
 
+//! Driver for thrust to count the particles preceding each cell
+cudaError_t sort_cell_offsets(unsigned int *d_cell_offset,
+                              const unsigned int *d_cell_np,
+                              const unsigned int num_cells);
+
+//! Kernel driver to compute the particle order by counting sort of the cell list
+cudaError_t sort_cell_order(unsigned int *d_order,
+                            unsigned int *d_rorder,
+                            const unsigned int *d_cell_list,
+                            const unsigned int *d_cell_np,
+                            const unsigned int *d_cell_offset,
+                            const Index2D& cli,
+                            const unsigned int block_size);
+
 //! Kernel driver to reverse map the particle ordering
 cudaError_t sort_gen_reverse(unsigned int *d_rorder,
                              const unsigned int *d_order,
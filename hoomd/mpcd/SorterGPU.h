@@ -25,6 +25,11 @@ namespace mpcd
 //! Sorts MPCD particles on the GPU
 /*!
  * See mpcd::Sorter for design details.
+ *
+ * When the cell list holds only MPCD particles, the order is computed by a counting sort: the
+ * number of particles in the preceding cells gives the first new index in each cell, and each
+ * cell-list entry is moved to that index plus its offset in the cell. Otherwise, the cell list
+ * is compacted to skip the virtual and embedded particles.
  */
 class PYBIND11_EXPORT SorterGPU : public mpcd::Sorter
     {
@@ -44,6 +49,7 @@ class PYBIND11_EXPORT SorterGPU : public mpcd::Sorter
             mpcd::Sorter::setAutotunerParams(enable, period);
 
             m_sentinel_tuner->setEnabled(enable); m_sentinel_tuner->setPeriod(period);
+            m_order_tuner->setEnabled(enable); m_order_tuner->setPeriod(period);
             m_reverse_tuner->setEnabled(enable); m_reverse_tuner->setPeriod(period);
             m_apply_tuner->setEnabled(enable); m_apply_tuner->setPeriod(period);
             }
@@ -52,6 +58,9 @@ class PYBIND11_EXPORT SorterGPU : public mpcd::Sorter
         std::unique_ptr<Autotuner> m_sentinel_tuner;    //!< Kernel tuner for filling sentinels in cell list
         std::unique_ptr<Autotuner> m_reverse_tuner;     //!< Kernel tuner for setting reverse map
         std::unique_ptr<Autotuner> m_apply_tuner;       //!< Kernel tuner for applying sorted order
+        std::unique_ptr<Autotuner> m_order_tuner;       //!< Kernel tuner for the counting sort of the cell list
+
+        GPUVector<unsigned int> m_cell_offset;          //!< First new particle index in each cell
 
         //! Compute the sorting order at the current timestep on the GPU
         virtual void computeOrder(uint64_t timestep);
@@ -25,9 +25,13 @@ mpcd::StreamingMethod::StreamingMethod(std::shared_ptr<mpcd::SystemData> sysdata
       m_pdata(m_sysdef->getParticleData()),
       m_mpcd_pdata(m_mpcd_sys->getParticleData()),
       m_exec_conf(m_pdata->getExecConf()),
-      m_mpcd_dt(0.0), m_period(period)
+      m_mpcd_dt(0.0), m_period(period), m_prebin(false), m_prebin_timestep(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD StreamingMethod" << std::endl;
+    m_prebin_shift = make_scalar3(0.0, 0.0, 0.0);
+    #ifdef ENABLE_HIP
+    m_stream = 0;
+    #endif // ENABLE_HIP
 
     // setup next timestep for streaming
     m_next_timestep = cur_timestep;
@@ -97,6 +97,55 @@ class PYBIND11_EXPORT StreamingMethod
         //! Set the period of the streaming method
         void setPeriod(unsigned int cur_timestep, unsigned int period);
 
+        //! Get the period of the streaming method
+        unsigned int getPeriod() const
+            {
+            return m_period;
+            }
+
+        //! Request that the next streaming step also bins the particles into the cell list
+        /*!
+         * \param timestep Timestep of the collision that will use the cell list
+         * \param grid_shift Grid shift that will be drawn for \a timestep
+         *
+         * The caller must guarantee that the particles are not changed between the streaming step and
+         * the collision. Streaming methods that cannot bin the particles ignore the request.
+         */
+        void requestPrebin(uint64_t timestep, const Scalar3& grid_shift)
+            {
+            m_prebin = true;
+            m_prebin_timestep = timestep;
+            m_prebin_shift = grid_shift;
+            }
+
+        #ifdef ENABLE_HIP
+        //! Returns true if stream() launches its kernels on the stream given by setStream()
+        /*!
+         * Integrators may run such methods on a separate stream so that the streaming step executes concurrently
+         * with the MD integration. stream() must not wait on the host for its kernels, and anything left to do
+         * after the kernels complete is deferred to finishStream().
+         */
+        virtual bool supportsStream()
+            {
+            return false;
+            }
+
+        //! Set the stream for the streaming kernels
+        /*!
+         * \param stream Stream to launch on, 0 for the default stream
+         */
+        void setStream(hipStream_t stream)
+            {
+            m_stream = stream;
+            }
+
+        //! Finish a streaming step launched on a separate stream
+        /*!
+         * The caller must make the default stream wait for the kernels launched by stream() first.
+         */
+        virtual void finishStream() { }
+        #endif // ENABLE_HIP
+
     protected:
         std::shared_ptr<mpcd::SystemData> m_mpcd_sys;                   //!< MPCD system data
         std::shared_ptr<SystemDefinition> m_sysdef;                     //!< HOOMD system definition
@@ -111,6 +160,14 @@ class PYBIND11_EXPORT StreamingMethod
 
         std::shared_ptr<hoomd::GPUPolymorph<mpcd::ExternalField>> m_field;  //!< External field
 
+        bool m_prebin;                  //!< True if the next streaming step should bin the particles
+        uint64_t m_prebin_timestep;     //!< Timestep of the collision to bin the particles for
+        Scalar3 m_prebin_shift;         //!< Grid shift of the collision to bin the particles for
+
+        #ifdef ENABLE_HIP
+        hipStream_t m_stream;           //!< Stream for the streaming kernels
+        #endif // ENABLE_HIP
+
         //! Check if streaming should occur
         virtual bool shouldStream(uint64_t timestep);
     };
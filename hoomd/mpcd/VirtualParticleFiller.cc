@@ -19,7 +19,8 @@ mpcd::VirtualParticleFiller::VirtualParticleFiller(std::shared_ptr<mpcd::SystemD
       m_exec_conf(m_pdata->getExecConf()),
       m_mpcd_pdata(sysdata->getParticleData()),
       m_cl(sysdata->getCellList()),
-      m_density(density), m_type(type), m_T(T), m_N_fill(0), m_first_tag(0)
+      m_density(density), m_type(type), m_T(T), m_N_fill(0), m_first_tag(0), m_first_idx(0),
+      m_fill_valid(false), m_fill_N(0), m_fill_N_global(0), m_fill_N_fill(0), m_fill_cell(make_scalar2(0,0))
     {
     }
 
@@ -41,11 +42,51 @@ void mpcd::VirtualParticleFiller::fill(uint64_t timestep)
     m_first_tag += m_mpcd_pdata->getNGlobal() + m_mpcd_pdata->getNVirtualGlobal();
 
     // add the new virtual particles locally
+    m_first_idx = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     m_mpcd_pdata->addVirtualParticles(m_N_fill);
 
     // draw the particles consistent with those tags
     drawParticles(timestep);
 
+    m_mpcd_pdata->invalidateCellCache();
+
+    // save the state of this fill so that it can be redrawn
+    m_fill_valid = true;
+    m_fill_N = m_mpcd_pdata->getN();
+    m_fill_N_global = m_mpcd_pdata->getNGlobal();
+    m_fill_N_fill = m_N_fill;
+    m_fill_box = m_pdata->getBox();
+    m_fill_cell = make_scalar2(m_cl->getCellSize(), m_cl->getMaxGridShift());
+    }
+
+/*!
+ * 
+eturns True if redraw() can be used instead of fill()
+ *
+ * The fill volume is computed again, and the particles can be redrawn if it gives the same number of particles
+ * for the same box and cells as the last fill. The number of MPCD particles must also be unchanged, since the
+ * virtual particles are stored after them and their tags follow the global number of particles. The caller is responsible for checking that the virtual particles have
+ * not been removed from the particle data since the last fill.
+ */
+bool mpcd::VirtualParticleFiller::canRedraw()
+    {
+    if (!m_fill_valid)
+        return false;
+
+    computeNumFill();
+
+    return (m_N_fill == m_fill_N_fill && m_mpcd_pdata->getN() == m_fill_N
+            && m_mpcd_pdata->getNGlobal() == m_fill_N_global
+            && m_pdata->getBox() == m_fill_box
+            && m_cl->getCellSize() == m_fill_cell.x && m_cl->getMaxGridShift() == m_fill_cell.y);
+    }
+
+/*!
+ * \param timestep Current timestep
+ */
+void mpcd::VirtualParticleFiller::redraw(uint64_t timestep)
+    {
+    drawParticles(timestep);
     m_mpcd_pdata->invalidateCellCache();
     }
 
@@ -57,6 +98,7 @@ void mpcd::VirtualParticleFiller::setDensity(Scalar density)
         throw std::runtime_error("Invalid virtual particle density");
         }
     m_density = density;
+    invalidateFill();
     }
 
 void mpcd::VirtualParticleFiller::setType(unsigned int type)
@@ -67,6 +109,7 @@ void mpcd::VirtualParticleFiller::setType(unsigned int type)
         throw std::runtime_error("Invalid type id");
         }
     m_type = type;
+    invalidateFill();
     }
 
 /*!
@@ -30,6 +30,12 @@ namespace mpcd
  * particle data. Each deriving class must then implement two methods:
  *  1. computeNumFill(), which is the number of virtual particles to add.
  *  2. drawParticles(), which is the rule to determine where to put the particles.
+ *
+ * The virtual particles from the last fill() can also be drawn again in place with redraw(), as long as the fill
+ * volume has not changed and the particles are still held in the particle data. This keeps the same tags and indexes,
+ * so it gives the same particles as removing and filling them again, but it avoids resizing the particle data,
+ * invalidating the cell list, and the collective calls needed to assign new tags. drawParticles() must write to the
+ * indexes starting from m_first_idx so that it can be used for both.
  */
 class PYBIND11_EXPORT VirtualParticleFiller
     {
@@ -44,6 +50,24 @@ class PYBIND11_EXPORT VirtualParticleFiller
         //! Fill up virtual particles
         void fill(uint64_t timestep);
 
+        //! Check if the virtual particles from the last fill can be drawn again in place
+        bool canRedraw();
+
+        //! Draw the virtual particles from the last fill again in place
+        void redraw(uint64_t timestep);
+
+        //! Get the number of virtual particles to fill locally
+        unsigned int getNumFill() const
+            {
+            return m_N_fill;
+            }
+
+        //! Get the first local index of the virtual particles from the last fill
+        unsigned int getFirstIndex() const
+            {
+            return m_first_idx;
+            }
+
         //! Sets the profiler for the integration method to use
         virtual void setProfiler(std::shared_ptr<Profiler> prof)
             {
@@ -86,6 +110,20 @@ class PYBIND11_EXPORT VirtualParticleFiller
 
         unsigned int m_N_fill;      //!< Number of particles to fill locally
         unsigned int m_first_tag;   //!< First tag of locally held particles
+        unsigned int m_first_idx;   //!< First local index of the filled particles
+
+        bool m_fill_valid;              //!< True if the filled particles match the current parameters
+        unsigned int m_fill_N;          //!< Number of MPCD particles at the last fill
+        unsigned int m_fill_N_global;   //!< Global number of MPCD particles at the last fill
+        unsigned int m_fill_N_fill;     //!< Number of particles filled at the last fill
+        BoxDim m_fill_box;              //!< Local box at the last fill
+        Scalar2 m_fill_cell;            //!< Cell size and maximum grid shift at the last fill
+
+        //! Mark the filled particles as outdated so that the next fill starts over
+        void invalidateFill()
+            {
+            m_fill_valid = false;
+            }
 
         //! Compute the total number of particles to fill
         virtual void computeNumFill() {}
@@ -98,6 +98,7 @@ import hoomd
 from hoomd import _hoomd
 from hoomd.md import _md
 
+from hoomd.mpcd import analyze
 from hoomd.mpcd import collide
 from hoomd.mpcd import data
 from hoomd.mpcd import force
@@ -115,6 +116,10 @@ class integrator(hoomd.integrate._integrator):
                     advance the real time of the system forward by *dt* (in time units).
         aniso (bool): Whether to integrate rotational degrees of freedom (bool),
                       default None (autodetect).
+        concurrent_stream (bool): When True, launch the MPCD streaming step on a
+                      separate GPU stream so that it runs concurrently with the
+                      MD forces and integration methods (default False). Only takes
+                      effect on a single GPU.
 
     The MPCD integrator enables the MPCD algorithm concurrently with standard
     MD :py:mod:`~hoomd.md.methods` methods. An integrator must be created
@@ -139,13 +144,21 @@ class integrator(hoomd.integrate._integrator):
     The MD particles can be read at any time step because their positions
     are updated every step.
 
+    With *concurrent_stream*, the MPCD particles are streamed on their own GPU
+    stream while the MD forces are computed and the MD particles are integrated.
+    The streams are joined on the device at the end of every time step, so the
+    MPCD particle data is complete before it is used again. Sorting and the
+    collisions still run on the default stream. The benefit is largest when the
+    MD particles are too few to fill the GPU on their own.
+
     Examples::
 
         mpcd.integrator(dt=0.1)
         mpcd.integrator(dt=0.01, aniso=True)
+        mpcd.integrator(dt=0.01, concurrent_stream=True)
 
     """
-    def __init__(self, dt, aniso=None):
+    def __init__(self, dt, aniso=None, concurrent_stream=False):
         # check system is initialized
         if hoomd.context.current.mpcd is None:
             hoomd.context.current.device.cpp_msg.error('mpcd.integrate: an MPCD system must be initialized before the integrator\n')
@@ -156,12 +169,14 @@ class integrator(hoomd.integrate._integrator):
         self.supports_methods = True
         self.dt = dt
         self.aniso = aniso
-        self.metadata_fields = ['dt','aniso']
+        self.concurrent_stream = concurrent_stream
+        self.metadata_fields = ['dt','aniso','concurrent_stream']
 
         # configure C++ integrator
         self.cpp_integrator = _mpcd.Integrator(hoomd.context.current.mpcd.data, self.dt)
         if hoomd.context.current.mpcd.comm is not None:
             self.cpp_integrator.setMPCDCommunicator(hoomd.context.current.mpcd.comm)
+        self.cpp_integrator.concurrent_stream = bool(concurrent_stream)
         hoomd.context.current.system.setIntegrator(self.cpp_integrator)
 
         if self.aniso is not None:
@@ -172,17 +187,19 @@ class integrator(hoomd.integrate._integrator):
         True: _md.IntegratorAnisotropicMode.Anisotropic,
         False: _md.IntegratorAnisotropicMode.Isotropic}
 
-    def set_params(self, dt=None, aniso=None):
+    def set_params(self, dt=None, aniso=None, concurrent_stream=None):
         """ Changes parameters of an existing integration mode.
 
         Args:
             dt (float): New time step delta (if set) (in time units).
             aniso (bool): Anisotropic integration mode (bool), default None (autodetect).
+            concurrent_stream (bool): Launch the MPCD streaming step on a separate GPU stream (if set).
 
         Examples::
 
             integrator.set_params(dt=0.007)
             integrator.set_params(dt=0.005, aniso=False)
+            integrator.set_params(concurrent_stream=True)
 
         """
         self.check_initialization()
@@ -201,6 +218,10 @@ class integrator(hoomd.integrate._integrator):
             self.aniso = aniso
             self.cpp_integrator.setAnisotropicMode(anisoMode)
 
+        if concurrent_stream is not None:
+            self.concurrent_stream = bool(concurrent_stream)
+            self.cpp_integrator.concurrent_stream = self.concurrent_stream
+
     def update_methods(self):
         self.check_initialization()
 
@@ -0,0 +1,108 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: mphoward
+
+R""" MPCD analyzers
+
+Analyze properties of the MPCD solvent during the simulation.
+
+"""
+
+import hoomd
+
+from . import _mpcd
+
+class flow_field():
+    R""" Time-averaged flow fields of the MPCD solvent
+
+    Args:
+        period (int): Number of integration steps between samples.
+        bins (tuple): Number of bins along *x*, *y*, and *z*. A value of 0
+            gives one bin per MPCD cell along that direction.
+
+    The mass density, velocity, and temperature of the MPCD solvent are
+    averaged over time in bins of whole MPCD cells. The number of bins along
+    each direction must evenly divide the number of cells. For example,
+    ``bins=(1, 0, 1)`` gives profiles along *y* with the resolution of the
+    cells, and ``bins=(0, 0, 0)`` gives the fields of every cell.
+
+    The samples are taken from the cell properties computed for the
+    collisions, so the cells are not binned again to take a sample. A
+    sample is only taken if the cell properties were computed since the last
+    sample, so choose *period* equal to the collision period to sample every
+    collision. The samples are summed in each cell on the device that runs
+    the simulation, and they are only binned and summed across MPI ranks when
+    the fields are read.
+
+    The velocity of a bin is weighted by the mass in each cell, and the
+    temperature of a bin is the average of the cell temperatures weighted by
+    the number of degrees of freedom in each cell.
+
+    Note:
+        :py:attr:`density`, :py:attr:`velocity`, and :py:attr:`temperature`
+        must be read on all MPI ranks.
+
+    Examples::
+
+        field = mpcd.analyze.flow_field(period=10, bins=(1, 20, 1))
+        hoomd.run(1e5)
+        vx = field.velocity[0,:,0,0]
+        field.reset()
+
+    """
+    def __init__(self, period, bins=(0, 0, 0)):
+        # check for mpcd initialization
+        if hoomd.context.current.mpcd is None:
+            hoomd.context.current.device.cpp_msg.error('mpcd.analyze: an MPCD system must be initialized before the flow field\n')
+            raise RuntimeError('MPCD system not initialized')
+
+        bins = tuple(int(n) for n in bins)
+        if len(bins) != 3 or any(n < 0 for n in bins):
+            hoomd.context.current.device.cpp_msg.error('mpcd.analyze: flow field bins must be 3 non-negative integers.\n')
+            raise ValueError('Flow field bins must be 3 non-negative integers')
+
+        if not hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+            cpp_class = _mpcd.FlowFieldAnalyzer
+        else:
+            cpp_class = _mpcd.FlowFieldAnalyzerGPU
+        self._cpp = cpp_class(hoomd.context.current.mpcd.data,
+                              hoomd.context.current.mpcd._thermo,
+                              bins[0],
+                              bins[1],
+                              bins[2])
+
+        self.period = period
+        hoomd.context.current.system.addAnalyzer(self._cpp, "mpcd_flow_field", period)
+
+    @property
+    def num_samples(self):
+        """int: Number of samples in the averages."""
+        return self._cpp.num_samples
+
+    @property
+    def bins(self):
+        """tuple: Number of bins along *x*, *y*, and *z*."""
+        return self._cpp.num_bins
+
+    @property
+    def density(self):
+        """numpy.ndarray: Averaged mass density in each bin, with shape
+        ``bins``."""
+        return self._cpp.density
+
+    @property
+    def velocity(self):
+        """numpy.ndarray: Averaged velocity in each bin, with shape
+        ``bins + (3,)``."""
+        return self._cpp.velocity
+
+    @property
+    def temperature(self):
+        """numpy.ndarray: Averaged temperature in each bin, with shape
+        ``bins``."""
+        return self._cpp.temperature
+
+    def reset(self):
+        """ Discard the samples. """
+        self._cpp.reset()
@@ -234,11 +234,16 @@ class system():
 
         self.data.initializeFromSnapshot(snapshot.sys_snap)
 
-    def set_params(self, cell=None):
+    def set_params(self, cell=None, extra_cells=None, grid_shift_steps=None):
         R""" Set parameters of the MPCD system
 
         Args:
             cell (float): Edge length of an MPCD cell.
+            extra_cells (int): Number of extra layers of cells around each
+                domain in MPI simulations.
+            grid_shift_steps (int): Number of steps per cell that the
+                random grid shift is restricted to, or 0 to shift the
+                grid continuously.
 
         Every MPCD system is given a cell list for binning particles (see
         :py:mod:`.mpcd.collide`). The size of the cell list sets the length
@@ -248,10 +253,49 @@ class system():
         has a different fundamental unit of length, you can adjust the
         cell size, but be aware that this will also change the fluid properties.
 
+        In MPI simulations, the cells of each domain are padded by a
+        diffusion layer that the MPCD particles can stream into before
+        they must be migrated to a neighboring rank. Particles are only
+        migrated once one of them has left this layer, so adding
+        *extra_cells* makes migration less frequent at the cost of
+        communicating more cells during each collision. By default, no
+        extra cells are added. *extra_cells* has no effect in simulations
+        on a single rank.
+
+        The collision methods shift the cell grid by a random vector
+        before every collision. With *grid_shift_steps* > 0, each
+        component of the shift is a whole multiple of
+        ``cell/grid_shift_steps``, drawn with equal probability, and the
+        CPU cell list derives the shifted cells from a fine grid with
+        *grid_shift_steps* bins per cell using integer arithmetic. The
+        fine bins are kept, so the cells for a new shift are found without
+        the particle positions while the particles have not moved. By
+        default, the grid shifts continuously.
+
+        Examples::
+
+            mpcd_sys.set_params(extra_cells=1)
+            mpcd_sys.set_params(grid_shift_steps=8)
+
         """
         if cell is not None:
             self.cell.cell_size = cell
 
+        if extra_cells is not None:
+            extra_cells = int(extra_cells)
+            if extra_cells < 0:
+                hoomd.context.current.device.cpp_msg.error("mpcd: number of extra cells must be non-negative.\n")
+                raise ValueError("Number of extra cells must be non-negative")
+            if self.comm is not None:
+                self.cell.num_extra = extra_cells
+
+        if grid_shift_steps is not None:
+            grid_shift_steps = int(grid_shift_steps)
+            if grid_shift_steps < 0:
+                hoomd.context.current.device.cpp_msg.error("mpcd: number of grid shift steps must be non-negative.\n")
+                raise ValueError("Number of grid shift steps must be non-negative")
+            self.cell.grid_shift_steps = grid_shift_steps
+
     def take_snapshot(self, particles=True):
         R""" Takes a snapshot of the current state of the MPCD system
 
@@ -21,6 +21,12 @@
 #include "CellThermoComputeGPU.h"
 #endif // ENABLE_HIP
 
+// analyzers
+#include "FlowFieldAnalyzer.h"
+#ifdef ENABLE_HIP
+#include "FlowFieldAnalyzerGPU.h"
+#endif // ENABLE_HIP
+
 // integration
 #include "Integrator.h"
 
@@ -125,6 +131,11 @@ PYBIND11_MODULE(_mpcd, m)
     mpcd::detail::export_CellThermoComputeGPU(m);
     #endif // ENABLE_HIP
 
+    mpcd::detail::export_FlowFieldAnalyzer(m);
+    #ifdef ENABLE_HIP
+    mpcd::detail::export_FlowFieldAnalyzerGPU(m);
+    #endif // ENABLE_HIP
+
     mpcd::detail::export_Integrator(m);
 
     mpcd::detail::export_CollisionMethod(m);
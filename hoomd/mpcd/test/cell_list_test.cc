@@ -332,6 +332,76 @@ void celllist_grid_shift_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ cl->setGridShift(make_scalar3( 0.51,  0.51,  0.51)); });
     }
 
+//! Test that particles are binned correctly when the grid shift is restricted to sub-grid steps
+template<class CL>
+void celllist_grid_shift_steps_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(6.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    std::shared_ptr<mpcd::ParticleData> pdata_1;
+        {
+        auto mpcd_snap = std::make_shared<mpcd::ParticleDataSnapshot>(1);
+        mpcd_snap->position[0] = vec3<Scalar>(0.1, 0.1, 0.1);
+        pdata_1 = std::make_shared<mpcd::ParticleData>(mpcd_snap, snap->global_box, exec_conf);
+        }
+
+    std::shared_ptr<mpcd::CellList> cl(new CL(sysdef, pdata_1));
+    cl->setGridShiftSteps(4);
+    CHECK_CLOSE(cl->getGridShiftStep(), 0.25, tol_small);
+
+    // the shift is snapped onto the sub-grid, so the particle falls from (3,3,3) to (2,2,2)
+    cl->setGridShift(make_scalar3(0.3, 0.3, 0.3));
+    CHECK_CLOSE(cl->getGridShift().x, 0.25, tol_small);
+    CHECK_CLOSE(cl->getGridShift().y, 0.25, tol_small);
+    CHECK_CLOSE(cl->getGridShift().z, 0.25, tol_small);
+    cl->compute(0);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(2,2,2)], 1);
+        }
+
+    // the particle has not moved, so the new shift puts it back into (3,3,3)
+    cl->setGridShift(make_scalar3(-0.5, -0.5, -0.5));
+    cl->compute(1);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(3,3,3)], 1);
+        }
+
+    // check for cell periodic wrapping by putting particles near the box boundary
+        {
+        ArrayHandle<Scalar4> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
+        h_pos.data[0] = make_scalar4(-2.9, -2.9, -2.9, 0.0);
+        }
+    pdata_1->invalidateCellCache();
+    cl->setGridShift(make_scalar3(0.5, 0.5, 0.5));
+    cl->compute(2);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(5,5,5)], 1);
+        }
+
+    // and the other way, without moving the particle
+    cl->setGridShift(make_scalar3(-0.25, 0.0, 0.25));
+    cl->compute(3);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(0,0,5)], 1);
+        }
+
+    // turning off the steps lets the grid shift continuously again
+    cl->setGridShiftSteps(0);
+    cl->setGridShift(make_scalar3(0.3, 0.3, 0.3));
+    CHECK_CLOSE(cl->getGridShift().x, 0.3, tol_small);
+    }
+
 //! Test that small systems can embed particles
 template<class CL>
 void celllist_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -612,6 +682,12 @@ UP_TEST( mpcd_cell_list_grid_shift_test )
     celllist_grid_shift_test<mpcd::CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! quantized grid shift test case for MPCD CellList class
+UP_TEST( mpcd_cell_list_grid_shift_steps_test )
+    {
+    celllist_grid_shift_steps_test<mpcd::CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 //! embedded particle test case for MPCD CellList class
 UP_TEST( mpcd_cell_list_embed_test )
     {
@@ -637,6 +713,12 @@ UP_TEST( mpcd_cell_list_gpu_grid_shift_test )
     celllist_grid_shift_test<mpcd::CellListGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+//! quantized grid shift test case for MPCD CellListGPU class
+UP_TEST( mpcd_cell_list_gpu_grid_shift_steps_test )
+    {
+    celllist_grid_shift_steps_test<mpcd::CellListGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
 //! embedded particle test case for MPCD CellListGPU class
 UP_TEST( mpcd_cell_list_gpu_embed_test )
     {
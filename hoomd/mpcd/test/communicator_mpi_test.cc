@@ -723,6 +723,74 @@ void test_communicator_migrate_ortho(communicator_creator comm_creator, std::sha
         }
     }
 
+//! Test that the Communicator only migrates particles that have left the diffusion layer
+void test_communicator_migrate_lazy(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf, unsigned int nstages)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // default initialize an empty snapshot in the reference box
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(2.0);
+    snap->particle_data.type_mapping.push_back("A");
+    // initialize a 2x2x2 domain decomposition on processor with rank 0
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, snap->global_box.getL(),2,2,2));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf, decomposition));
+
+    // place one mpcd particle in the middle of each domain
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+
+        mpcd_snap->resize(8);
+        mpcd_snap->position[0] = vec3<Scalar>(-0.5,-0.5,-0.5);
+        mpcd_snap->position[1] = vec3<Scalar>( 0.5,-0.5,-0.5);
+        mpcd_snap->position[2] = vec3<Scalar>(-0.5, 0.5,-0.5);
+        mpcd_snap->position[3] = vec3<Scalar>( 0.5, 0.5,-0.5);
+        mpcd_snap->position[4] = vec3<Scalar>(-0.5,-0.5, 0.5);
+        mpcd_snap->position[5] = vec3<Scalar>( 0.5,-0.5, 0.5);
+        mpcd_snap->position[6] = vec3<Scalar>(-0.5, 0.5, 0.5);
+        mpcd_snap->position[7] = vec3<Scalar>( 0.5, 0.5, 0.5);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    // with this cell size, the diffusion layer extends 0.25 past each face of the domain
+    mpcd_sys->getCellList()->setCellSize(0.5);
+
+    // initialize the communicator
+    std::shared_ptr<mpcd::Communicator> comm = comm_creator(mpcd_sys, nstages);
+    MigrateSelectOp migrate_op(comm);
+
+    std::shared_ptr<mpcd::ParticleData> pdata = mpcd_sys->getParticleData();
+    const unsigned int rank = exec_conf->getRank();
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    UP_ASSERT_EQUAL(pdata->getTag(0), rank);
+
+    // move every particle into the diffusion layer along x, which should not trigger a migration
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[0].x += Scalar(0.6);
+        }
+    comm->communicate(0);
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    UP_ASSERT_EQUAL(pdata->getTag(0), rank);
+
+    // forcing the migration sends the particles out of the local domain
+    comm->forceMigrate(); comm->communicate(1);
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    UP_ASSERT_EQUAL(pdata->getTag(0), rank ^ 1);
+
+    // now move the particles past the diffusion layer, which requires a migration
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[0].x += Scalar(1.2);
+        }
+    comm->communicate(2);
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    UP_ASSERT_EQUAL(pdata->getTag(0), rank);
+    }
+
 //! Test particle migration of Communicator
 void test_communicator_overdecompose(std::shared_ptr<ExecutionConfiguration> exec_conf,
                                      unsigned int nx,
@@ -799,6 +867,14 @@ UP_TEST( mpcd_communicator_migrate_ortho_test )
     test_communicator_migrate_ortho(communicator_creator_base, exec_conf, 3);
     }
 
+UP_TEST( mpcd_communicator_migrate_lazy_test )
+    {
+    auto exec_conf = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_migrate_lazy(communicator_creator_base, exec_conf, 3);
+    }
+
 UP_TEST( mpcd_communicator_overdecompose_test )
     {
     // two ranks in any direction
@@ -892,5 +968,13 @@ UP_TEST( mpcd_communicator_migrate_ortho_test_GPU_two_stage )
     communicator_creator communicator_creator_gpu = bind(gpu_communicator_creator, _1, _2);
     test_communicator_migrate_ortho(communicator_creator_gpu, exec_conf, 2);
     }
+
+UP_TEST( mpcd_communicator_migrate_lazy_test_GPU )
+    {
+    auto exec_conf = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+
+    communicator_creator communicator_creator_gpu = bind(gpu_communicator_creator, _1, _2);
+    test_communicator_migrate_lazy(communicator_creator_gpu, exec_conf, 1);
+    }
 #endif // ENABLE_HIP
 #endif // ENABLE_MPI
@@ -0,0 +1,148 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#include "hoomd/mpcd/CellList.h"
+#include "hoomd/mpcd/CellThermoCompute.h"
+#include "hoomd/mpcd/FlowFieldAnalyzer.h"
+#ifdef ENABLE_HIP
+#include "hoomd/mpcd/CellThermoComputeGPU.h"
+#include "hoomd/mpcd/FlowFieldAnalyzerGPU.h"
+#endif // ENABLE_HIP
+
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN()
+
+//! Test for correct averaging of the flow fields
+template<class CT, class FA>
+void flow_field_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(2.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // place particles in three of the cells, doubling two of them
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(5);
+
+        mpcd_snap->position[0] = vec3<Scalar>(-0.5, -0.5, -0.5);
+        mpcd_snap->position[1] = vec3<Scalar>(-0.5, -0.5, -0.5);
+        mpcd_snap->position[2] = vec3<Scalar>( 0.5,  0.5,  0.5);
+        mpcd_snap->position[3] = vec3<Scalar>( 0.5,  0.5,  0.5);
+        mpcd_snap->position[4] = vec3<Scalar>(-0.5,  0.5,  0.5);
+
+        mpcd_snap->velocity[0] = vec3<Scalar>(2.0, 0.0, 0.0);
+        mpcd_snap->velocity[1] = vec3<Scalar>(1.0, 0.0, 0.0);
+        mpcd_snap->velocity[2] = vec3<Scalar>(0.0, -3.0, 0.0);
+        mpcd_snap->velocity[3] = vec3<Scalar>(0.0, 0.0, -5.0);
+        mpcd_snap->velocity[4] = vec3<Scalar>(1.0, -1.0, 4.0);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    std::shared_ptr<CT> thermo = std::make_shared<CT>(mpcd_sys);
+
+    // profile along x
+    std::shared_ptr<FA> profile = std::make_shared<FA>(mpcd_sys, thermo, 2, 1, 1);
+    // fields of every cell
+    std::shared_ptr<FA> cells = std::make_shared<FA>(mpcd_sys, thermo, 0, 0, 0);
+
+    // nothing is sampled until the cell properties are computed
+    profile->analyze(0);
+    UP_ASSERT_EQUAL(profile->getNumSamples(), 0);
+
+    thermo->compute(0);
+    profile->analyze(1);
+    cells->analyze(1);
+    UP_ASSERT_EQUAL(profile->getNumSamples(), 1);
+    UP_ASSERT_EQUAL(cells->getNumSamples(), 1);
+
+    // the same cell properties are not sampled twice
+    profile->analyze(2);
+    UP_ASSERT_EQUAL(profile->getNumSamples(), 1);
+
+    thermo->compute(3);
+    profile->analyze(3);
+    UP_ASSERT_EQUAL(profile->getNumSamples(), 2);
+
+        {
+        const uint3 n = profile->getNumBins();
+        UP_ASSERT_EQUAL(n.x, 2);
+        UP_ASSERT_EQUAL(n.y, 1);
+        UP_ASSERT_EQUAL(n.z, 1);
+
+        // each bin is 1 x 2 x 2
+        const std::vector<double> density = profile->getDensity();
+        UP_ASSERT_EQUAL(density.size(), 2);
+        CHECK_CLOSE(density[0], 3.0/4.0, tol);
+        CHECK_CLOSE(density[1], 2.0/4.0, tol);
+
+        // the velocity is weighted by the mass of the cells
+        const std::vector<double> velocity = profile->getVelocity();
+        UP_ASSERT_EQUAL(velocity.size(), 6);
+        CHECK_CLOSE(velocity[0], 4.0/3.0, tol);
+        CHECK_CLOSE(velocity[1], -1.0/3.0, tol);
+        CHECK_CLOSE(velocity[2], 4.0/3.0, tol);
+        CHECK_SMALL(velocity[3], tol_small);
+        CHECK_CLOSE(velocity[4], -1.5, tol);
+        CHECK_CLOSE(velocity[5], -2.5, tol);
+
+        // the cell with one particle has no temperature
+        const std::vector<double> temperature = profile->getTemperature();
+        UP_ASSERT_EQUAL(temperature.size(), 2);
+        CHECK_CLOSE(temperature[0], 2.0*0.5*0.5/3.0, tol);
+        CHECK_CLOSE(temperature[1], 2.0*(1.5*1.5+2.5*2.5)/3.0, tol);
+        }
+
+        {
+        const uint3 n = cells->getNumBins();
+        UP_ASSERT_EQUAL(n.x, 2);
+        UP_ASSERT_EQUAL(n.y, 2);
+        UP_ASSERT_EQUAL(n.z, 2);
+
+        // bins are ordered with z varying fastest
+        const std::vector<double> density = cells->getDensity();
+        UP_ASSERT_EQUAL(density.size(), 8);
+        CHECK_CLOSE(density[0], 2.0, tol);
+        CHECK_CLOSE(density[3], 1.0, tol);
+        CHECK_CLOSE(density[7], 2.0, tol);
+        CHECK_SMALL(density[1], tol_small);
+
+        const std::vector<double> velocity = cells->getVelocity();
+        UP_ASSERT_EQUAL(velocity.size(), 24);
+        CHECK_CLOSE(velocity[9], 1.0, tol);
+        CHECK_CLOSE(velocity[10], -1.0, tol);
+        CHECK_CLOSE(velocity[11], 4.0, tol);
+        }
+
+    // reset discards the samples
+    profile->reset();
+    UP_ASSERT_EQUAL(profile->getNumSamples(), 0);
+        {
+        const std::vector<double> density = profile->getDensity();
+        CHECK_SMALL(density[0], tol_small);
+        CHECK_SMALL(density[1], tol_small);
+        }
+
+    // bins must divide the cells evenly
+    std::shared_ptr<FA> bad = std::make_shared<FA>(mpcd_sys, thermo, 3, 1, 1);
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ bad->getDensity(); });
+    }
+
+//! basic test case for MPCD FlowFieldAnalyzer class
+UP_TEST( mpcd_flow_field_basic )
+    {
+    flow_field_basic_test<mpcd::CellThermoCompute, mpcd::FlowFieldAnalyzer>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_HIP
+//! basic test case for MPCD FlowFieldAnalyzerGPU class
+UP_TEST( mpcd_flow_field_gpu_basic )
+    {
+    flow_field_basic_test<mpcd::CellThermoComputeGPU, mpcd::FlowFieldAnalyzerGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif // ENABLE_HIP
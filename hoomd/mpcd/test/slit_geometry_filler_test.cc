@@ -129,6 +129,35 @@ void slit_fill_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         UP_ASSERT_EQUAL(N_hi, 2*(20*20/2));
         }
 
+    /*
+     * Redraw the particles in place, which should keep the same number of particles and tags.
+     */
+    UP_ASSERT(filler->canRedraw());
+    UP_ASSERT_EQUAL(filler->getFirstIndex(), pdata->getN());
+    filler->redraw(3);
+    UP_ASSERT_EQUAL(pdata->getNVirtual(), 2*(20*20/2)*2);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        unsigned int N_lo(0), N_hi(0);
+        for (unsigned int i=pdata->getN(); i < pdata->getN() + pdata->getNVirtual(); ++i)
+            {
+            UP_ASSERT_EQUAL(h_tag.data[i], i);
+
+            const Scalar z = h_pos.data[i].z;
+            if (z < Scalar(-5.0))
+                ++N_lo;
+            else if (z >= Scalar(5.0))
+                ++N_hi;
+            }
+        UP_ASSERT_EQUAL(N_lo, 2*(20*20/2));
+        UP_ASSERT_EQUAL(N_hi, 2*(20*20/2));
+        }
+
+    // changing the cell size changes the fill volume, so the particles must be filled again
+    mpcd_sys->getCellList()->setCellSize(2.0);
+    UP_ASSERT(!filler->canRedraw());
+
     /*
      * Test the average properties of the virtual particles.
      */
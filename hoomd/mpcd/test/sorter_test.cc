@@ -329,6 +329,83 @@ void sorter_virtual_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         }
     }
 
+//! Test for MPCD sorting with several particles per cell and no embedded or virtual particles
+template<class T>
+void sorter_counting_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // default initialize an empty snapshot in the reference box
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(2.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // place twelve mpcd particles, with an uneven number per cell
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->type_mapping.push_back("M");
+
+        mpcd_snap->resize(12);
+        mpcd_snap->position[0] = vec3<Scalar>(0.5, 0.5, 0.5);
+        mpcd_snap->position[1] = vec3<Scalar>(-0.5,-0.5,-0.5);
+        mpcd_snap->position[2] = vec3<Scalar>(0.6, 0.4, 0.5);
+        mpcd_snap->position[3] = vec3<Scalar>(-0.5, 0.5, 0.5);
+        mpcd_snap->position[4] = vec3<Scalar>(0.5,-0.5,-0.5);
+        mpcd_snap->position[5] = vec3<Scalar>(-0.4,-0.6,-0.5);
+        mpcd_snap->position[6] = vec3<Scalar>(0.5, 0.6, 0.4);
+        mpcd_snap->position[7] = vec3<Scalar>(-0.5,-0.5, 0.5);
+        mpcd_snap->position[8] = vec3<Scalar>(0.5, 0.5,-0.5);
+        mpcd_snap->position[9] = vec3<Scalar>(-0.6,-0.4,-0.4);
+        mpcd_snap->position[10] = vec3<Scalar>(0.5,-0.5, 0.5);
+        mpcd_snap->position[11] = vec3<Scalar>(-0.5, 0.4, 0.6);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+
+    // run the sorter
+    std::shared_ptr<T> sorter = std::make_shared<T>(mpcd_sys,0,1);
+    sorter->update(0);
+
+    std::shared_ptr<mpcd::ParticleData> pdata = mpcd_sys->getParticleData();
+    auto cl = mpcd_sys->getCellList();
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cl(cl->getCellList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+    const Index3D& ci = cl->getCellIndexer();
+    const Index2D& cli = cl->getCellListIndexer();
+
+    // particles should be in cell order, and still in the cell their position belongs to
+    std::vector<unsigned int> tags;
+    for (unsigned int i=0; i < 12; ++i)
+        {
+        const unsigned int cell = __scalar_as_int(h_vel.data[i].w);
+        if (i > 0)
+            UP_ASSERT(cell >= (unsigned int)__scalar_as_int(h_vel.data[i-1].w));
+        const unsigned int cx = (h_pos.data[i].x > 0) ? 1 : 0;
+        const unsigned int cy = (h_pos.data[i].y > 0) ? 1 : 0;
+        const unsigned int cz = (h_pos.data[i].z > 0) ? 1 : 0;
+        UP_ASSERT_EQUAL(cell, ci(cx,cy,cz));
+        tags.push_back(h_tag.data[i]);
+        }
+    std::sort(tags.begin(), tags.end());
+    for (unsigned int i=0; i < 12; ++i)
+        UP_ASSERT_EQUAL(tags[i], i);
+
+    // the cell list should refer to the sorted indexes, which are consecutive
+    unsigned int next_idx = 0;
+    for (unsigned int cell=0; cell < cl->getNCells(); ++cell)
+        {
+        std::vector<unsigned int> members;
+        for (unsigned int offset=0; offset < h_np.data[cell]; ++offset)
+            members.push_back(h_cl.data[cli(offset,cell)]);
+        std::sort(members.begin(), members.end());
+        for (unsigned int offset=0; offset < members.size(); ++offset)
+            UP_ASSERT_EQUAL(members[offset], next_idx++);
+        }
+    UP_ASSERT_EQUAL(next_idx, 12);
+    }
+
 //! basic test case for MPCD sorter
 UP_TEST( mpcd_sorter_test )
     {
@@ -339,6 +416,11 @@ UP_TEST( mpcd_sorter_virtual_test )
     {
     sorter_virtual_test<mpcd::Sorter>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! test case for MPCD sorter with several particles per cell
+UP_TEST( mpcd_sorter_counting_test )
+    {
+    sorter_counting_test<mpcd::Sorter>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 #ifdef ENABLE_HIP
 UP_TEST( mpcd_sorter_test_gpu )
     {
@@ -348,4 +430,8 @@ UP_TEST( mpcd_sorter_virtual_test_gpu )
     {
     sorter_virtual_test<mpcd::SorterGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+UP_TEST( mpcd_sorter_counting_test_gpu )
+    {
+    sorter_counting_test<mpcd::SorterGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 #endif // ENABLE_HIP
@@ -10,6 +10,7 @@
 #endif // ENABLE_HIP
 
 #include "hoomd/SnapshotSystemData.h"
+#include "hoomd/filter/ParticleFilterAll.h"
 #include "hoomd/test/upp11_config.h"
 
 HOOMD_UP_MAIN()
@@ -105,6 +106,159 @@ void streaming_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_co
         }
     }
 
+//! Test that streaming with cell binning fills the same cell list as the cell list compute
+template<class SM>
+void streaming_method_prebin_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(10.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // 4 particle system, two of which will stream through the boundary
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(4);
+
+        mpcd_snap->position[0] = vec3<Scalar>(1.0, 4.85, 3.0);
+        mpcd_snap->position[1] = vec3<Scalar>(-3.0, -4.75, -1.0);
+        mpcd_snap->position[2] = vec3<Scalar>(0.5, 0.5, 0.5);
+        mpcd_snap->position[3] = vec3<Scalar>(0.6, 0.4, 0.55);
+
+        mpcd_snap->velocity[0] = vec3<Scalar>(1.0, 1.0, 1.0);
+        mpcd_snap->velocity[1] = vec3<Scalar>(-1.0, -1.0, -1.0);
+        mpcd_snap->velocity[2] = vec3<Scalar>(2.0, 0.0, 0.0);
+        mpcd_snap->velocity[3] = vec3<Scalar>(0.0, 0.0, 0.0);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    std::shared_ptr<mpcd::CellList> cl = mpcd_sys->getCellList();
+    cl->compute(0);
+
+    auto geom = std::make_shared<const mpcd::detail::BulkGeometry>();
+    std::shared_ptr<mpcd::StreamingMethod> stream = std::make_shared<SM>(mpcd_sys, 0, 1, 0, geom);
+    stream->setDeltaT(0.5);
+
+    // stream and bin for the collision on the next step with a shifted grid
+    const Scalar3 shift = make_scalar3(0.1, -0.2, 0.3);
+    stream->requestPrebin(1, shift);
+    stream->stream(0);
+    cl->setGridShift(shift);
+    cl->compute(1);
+
+    const unsigned int ncells = cl->getNCells();
+    const Index2D& cli = cl->getCellListIndexer();
+    std::vector<unsigned int> prebin_np(ncells);
+    std::vector<unsigned int> prebin_cell(4);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(mpcd_sys->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < ncells; ++i)
+            prebin_np[i] = h_cell_np.data[i];
+        for (unsigned int i=0; i < 4; ++i)
+            prebin_cell[i] = __scalar_as_int(h_vel.data[i].w);
+        }
+
+    // the cell list built from scratch must agree
+    cl->forceCompute(1);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(mpcd_sys->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < ncells; ++i)
+            UP_ASSERT_EQUAL(prebin_np[i], h_cell_np.data[i]);
+        for (unsigned int i=0; i < 4; ++i)
+            {
+            const unsigned int cell = __scalar_as_int(h_vel.data[i].w);
+            UP_ASSERT_EQUAL(prebin_cell[i], cell);
+            bool found = false;
+            for (unsigned int offset=0; offset < h_cell_np.data[cell]; ++offset)
+                found = found || (h_cell_list.data[cli(offset, cell)] == i);
+            UP_ASSERT(found);
+            }
+        }
+    }
+
+//! Test that embedded particles are added to the cell list filled while streaming
+template<class SM>
+void streaming_method_prebin_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // 2 embedded particles, one of which shares a cell with an MPCD particle
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(10.0);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(2);
+    snap->particle_data.pos[0] = vec3<Scalar>(1.2, 0.1, 0.4);
+    snap->particle_data.pos[1] = vec3<Scalar>(-4.9, 4.9, -4.9);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(2);
+
+        mpcd_snap->position[0] = vec3<Scalar>(0.5, 0.5, 0.5);
+        mpcd_snap->position[1] = vec3<Scalar>(-3.0, -4.75, -1.0);
+
+        mpcd_snap->velocity[0] = vec3<Scalar>(1.0, 0.0, 0.0);
+        mpcd_snap->velocity[1] = vec3<Scalar>(-1.0, -1.0, -1.0);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    std::shared_ptr<mpcd::CellList> cl = mpcd_sys->getCellList();
+    std::shared_ptr<ParticleFilter> selector(new ParticleFilterAll());
+    std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef, selector));
+    cl->setEmbeddedGroup(group);
+    cl->compute(0);
+
+    auto geom = std::make_shared<const mpcd::detail::BulkGeometry>();
+    std::shared_ptr<mpcd::StreamingMethod> stream = std::make_shared<SM>(mpcd_sys, 0, 1, 0, geom);
+    stream->setDeltaT(0.5);
+
+    const Scalar3 shift = make_scalar3(0.1, -0.2, 0.3);
+    stream->requestPrebin(1, shift);
+    stream->stream(0);
+
+    // move an embedded particle after streaming, which must be seen at the collision
+        {
+        ArrayHandle<Scalar4> h_pos(sysdef->getParticleData()->getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[1].x = -2.9;
+        }
+    cl->setGridShift(shift);
+    cl->compute(1);
+
+    const unsigned int ncells = cl->getNCells();
+    std::vector<unsigned int> prebin_np(ncells);
+    std::vector<unsigned int> prebin_embed_cell(2);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_embed_cell(cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < ncells; ++i)
+            prebin_np[i] = h_cell_np.data[i];
+        for (unsigned int i=0; i < 2; ++i)
+            prebin_embed_cell[i] = h_embed_cell.data[i];
+        }
+
+    // the cell list built from scratch must agree
+    cl->forceCompute(1);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_embed_cell(cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read);
+        const Index2D& cli = cl->getCellListIndexer();
+        for (unsigned int i=0; i < ncells; ++i)
+            UP_ASSERT_EQUAL(prebin_np[i], h_cell_np.data[i]);
+        for (unsigned int i=0; i < 2; ++i)
+            {
+            const unsigned int cell = h_embed_cell.data[i];
+            UP_ASSERT_EQUAL(prebin_embed_cell[i], cell);
+            bool found = false;
+            for (unsigned int offset=0; offset < h_cell_np.data[cell]; ++offset)
+                found = found || (h_cell_list.data[cli(offset, cell)] == 2+i);
+            UP_ASSERT(found);
+            }
+        }
+    }
+
 //! basic test case for MPCD StreamingMethod class
 UP_TEST( mpcd_streaming_method_basic )
     {
@@ -118,4 +272,18 @@ UP_TEST( mpcd_streaming_method_setup )
     typedef mpcd::ConfinedStreamingMethodGPU<mpcd::detail::BulkGeometry> method;
     streaming_method_basic_test<method>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU));
     }
+
+//! test case for streaming with cell binning on the GPU
+UP_TEST( mpcd_streaming_method_prebin )
+    {
+    typedef mpcd::ConfinedStreamingMethodGPU<mpcd::detail::BulkGeometry> method;
+    streaming_method_prebin_test<method>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU));
+    }
+
+//! test case for adding embedded particles to a cell list binned while streaming on the GPU
+UP_TEST( mpcd_streaming_method_prebin_embed )
+    {
+    typedef mpcd::ConfinedStreamingMethodGPU<mpcd::detail::BulkGeometry> method;
+    streaming_method_prebin_embed_test<method>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU));
+    }
 #endif // ENABLE_HIP
@@ -498,7 +498,26 @@ class Operation(_HOOMDBaseObject):
     HOOMD-blue operations inherit from one of these five base classes. To find
     the purpose of each class see its documentation.
     """
-    pass
+
+    @log
+    def time_per_step(self):
+        """float: Wall time spent in this operation per time step (seconds).
+
+        The average is taken over the current or last `hoomd.Simulation.run`.
+
+        The time is measured on each rank without synchronizing the GPU. On the
+        GPU, it is the time between events recorded in the stream before and
+        after the operation executes.
+
+        .. versionadded:: 3.0
+        """
+        if not self._attached:
+            return None
+        n_steps = (self._simulation.timestep
+                   - self._simulation._cpp_sys.initial_timestep)
+        if n_steps == 0:
+            return 0.0
+        return self._cpp_obj.getExecutionTime() / n_steps
 
 
 class _TriggeredOperation(Operation):
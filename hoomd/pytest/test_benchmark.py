@@ -0,0 +1,64 @@
+"""Test the benchmark suite."""
+
+import json
+
+import pytest
+
+import hoomd
+import hoomd.benchmark
+
+
+@pytest.mark.parametrize("name", sorted(hoomd.benchmark.BENCHMARKS.keys()))
+def test_run(device, name):
+    """Test that each benchmark runs and reports its timers."""
+    result = hoomd.benchmark.run(name,
+                                 device,
+                                 n=4,
+                                 warmup=2,
+                                 steps=5,
+                                 repeat=2)
+    assert len(result['tps']) == 2
+    assert all(tps > 0 for tps in result['tps'])
+    assert result['steps'] == 5
+    assert any(key.startswith('integrator.') for key in result['time_per_step'])
+    assert all(t >= 0 for t in result['time_per_step'].values())
+    assert result['communication_time_per_step'] >= 0
+
+
+@pytest.mark.parametrize("workload", sorted(hoomd.benchmark.WORKLOADS.keys()))
+def test_scaling(device, workload):
+    """Test that the scaling workloads replicate to the requested size."""
+    result = hoomd.benchmark.scaling(workload,
+                                     device,
+                                     N=2000,
+                                     warmup=2,
+                                     steps=5)
+    assert result['N'] >= 2000
+    assert result['num_ranks'] == device.communicator.num_ranks
+    assert result['tps'] > 0
+    assert result['imbalance'] >= 1.0
+    assert result['N_local']['max'] >= result['N_local']['mean']
+    if device.communicator.num_ranks == 1:
+        assert result['N_local']['mean'] == result['N']
+        assert result['N_ghost']['max'] == 0
+
+
+def test_main(device, tmp_path):
+    """Test that the command line writes the results as JSON."""
+    if 'md_pair_lj' not in hoomd.benchmark.BENCHMARKS:
+        pytest.skip("MD is not enabled")
+
+    # only rank 0 writes and reads the file
+    filename = str(tmp_path / 'results.json')
+    hoomd.benchmark.main([
+        '--device', 'cpu', '--benchmarks', 'md_pair_lj', '-n', '4',
+        '--warmup', '2', '--steps', '5', '--repeat', '1', '--output', filename
+    ])
+
+    if device.communicator.rank == 0:
+        with open(filename) as f:
+            results = json.load(f)
+        assert results['hoomd_version'] == hoomd.version.version
+        assert list(results['benchmarks'].keys()) == ['md_pair_lj']
+        assert 'force.0.LJ' in results['benchmarks']['md_pair_lj'][
+            'time_per_step']
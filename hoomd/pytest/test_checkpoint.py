@@ -0,0 +1,71 @@
+import os
+import signal
+import hoomd
+import numpy
+
+
+def test_restart(simulation_factory, lattice_snapshot_factory, tmp_path):
+    snap = lattice_snapshot_factory(n=6)
+    if snap.exists:
+        N = snap.particles.N
+        snap.particles.velocity[:] = numpy.random.uniform(-1, 1, size=(N, 3))
+        snap.particles.charge[:] = numpy.random.uniform(-2, 2, size=N)
+        snap.bonds.types = ['bondA', 'bondB']
+        snap.bonds.N = N - 1
+        snap.bonds.group[:] = [[i, i + 1] for i in range(N - 1)]
+        snap.bonds.typeid[:] = numpy.arange(N - 1) % 2
+
+    filename = str(tmp_path / 'restart.chk')
+    sim = simulation_factory(snap)
+    sim.operations.writers.append(
+        hoomd.write.Checkpoint(filename, hoomd.trigger.Periodic(10)))
+    sim.run(20)
+    snap = sim.state.snapshot
+
+    restart = simulation_factory()
+    restart.create_state_from_checkpoint(filename)
+    assert restart.timestep == 20
+    assert restart.state.N_particles == sim.state.N_particles
+    assert restart.state.N_bonds == sim.state.N_bonds
+    assert restart.state.bond_types == sim.state.bond_types
+
+    snap2 = restart.state.snapshot
+    if snap.exists:
+        numpy.testing.assert_array_equal(snap.configuration.box,
+                                         snap2.configuration.box)
+        numpy.testing.assert_array_equal(snap.particles.position,
+                                         snap2.particles.position)
+        numpy.testing.assert_array_equal(snap.particles.velocity,
+                                         snap2.particles.velocity)
+        numpy.testing.assert_array_equal(snap.particles.charge,
+                                         snap2.particles.charge)
+        numpy.testing.assert_array_equal(snap.bonds.group, snap2.bonds.group)
+        numpy.testing.assert_array_equal(snap.bonds.typeid, snap2.bonds.typeid)
+
+
+def test_preemption(simulation_factory, lattice_snapshot_factory, tmp_path):
+
+    class Preempt(hoomd.custom.Action):
+
+        def act(self, timestep):
+            os.kill(os.getpid(), signal.SIGTERM)
+
+    filename = str(tmp_path / 'preempt.chk')
+    sim = simulation_factory(lattice_snapshot_factory(n=6))
+    sim.operations.writers.append(
+        hoomd.write.CustomWriter(action=Preempt(),
+                                 trigger=hoomd.trigger.On(10)))
+    sim.enable_preemption_checkpoint(filename, exit=False)
+    sim.run(20)
+    assert sim.preempted
+    assert sim.timestep == 10
+
+    restart = simulation_factory()
+    restart.create_state_from_checkpoint(filename)
+    assert restart.timestep == 10
+    assert restart.state.N_particles == sim.state.N_particles
+
+    # the next run is not preempted
+    sim.run(10)
+    assert not sim.preempted
+    assert sim.timestep == 20
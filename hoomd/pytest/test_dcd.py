@@ -38,3 +38,31 @@ def test_write(simulation_factory, two_particle_snapshot_factory, tmp_path):
         for i in range(len(traj)):
             for j in [0, 1]:
                 np.testing.assert_allclose(traj[i].position[j], positions[i][j])
+
+
+def test_parallel_io(simulation_factory, two_particle_snapshot_factory,
+                     tmp_path):
+    filename_serial = tmp_path / "serial.dcd"
+    filename_parallel = tmp_path / "parallel.dcd"
+    sim = simulation_factory(two_particle_snapshot_factory())
+    dcd_serial = hoomd.write.DCD(filename_serial, hoomd.trigger.Periodic(1))
+    dcd_parallel = hoomd.write.DCD(filename_parallel,
+                                   hoomd.trigger.Periodic(1),
+                                   parallel_io=True)
+    sim.operations.add(dcd_serial)
+    sim.operations.add(dcd_parallel)
+    assert dcd_parallel.parallel_io
+    sim.run(3)
+
+    # flush and close both files
+    sim.operations.writers.clear()
+    del dcd_serial, dcd_parallel
+
+    if sim.device.communicator.rank == 0:
+        serial = filename_serial.read_bytes()
+        parallel = filename_parallel.read_bytes()
+        assert len(serial) == len(parallel)
+
+        # skip the creation time in the file header
+        assert serial[:180] == parallel[:180]
+        assert serial[260:] == parallel[260:]
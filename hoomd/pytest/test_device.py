@@ -49,6 +49,21 @@ def test_common_properties(device):
             dev2 = device_type(shared_msg_file="shared.txt")
 
 
+def test_host_memory_policy(device):
+    assert device.huge_pages
+    assert device.numa_binding
+
+    device.huge_pages = False
+    device.numa_binding = False
+    assert not device.huge_pages
+    assert not device.numa_binding
+
+    device.huge_pages = True
+    device.numa_binding = True
+    assert device.huge_pages
+    assert device.numa_binding
+
+
 def _assert_gpu_properties(dev, mem_traceback, gpu_error_checking):
     """Assert properties specific to GPU objects are correct."""
     assert dev.memory_traceback == mem_traceback
@@ -484,6 +484,25 @@ class TestLocalSnapshots:
                 with pytest.raises(RuntimeError):
                     sim.state.snapshot = base_snapshot
 
+    def test_cached_arrays(self, base_simulation):
+        sim = base_simulation()
+        with sim.state.cpu_local_snapshot as data:
+            position = data.particles.position
+            expected = np.array(position, copy=True)
+
+        # arrays are invalid outside the context manager
+        with pytest.raises(hoomd.data.array.HOOMDArrayError):
+            position[0]
+
+        # the same local snapshot and arrays are reused in later context
+        # managers
+        with sim.state.cpu_local_snapshot as data:
+            # reused arrays are only valid after they are accessed again
+            with pytest.raises(hoomd.data.array.HOOMDArrayError):
+                position[0]
+            assert data.particles.position is position
+            assert general_array_equality(position, expected)
+
     @pytest.fixture
     def base_simulation(self, simulation_factory, base_snapshot):
         """Creates the simulation from the base_snapshot."""
@@ -270,6 +270,75 @@ def test_writer_order_initial(simulation_factory,
     ]
 
 
+def test_trace(simulation_factory, lattice_snapshot_factory, tmp_path):
+    """Test that runs write a Chrome trace of the profiled ranges."""
+    import json
+    sim = simulation_factory(lattice_snapshot_factory())
+    sim.operations.tuners[0].trigger = hoomd.trigger.Periodic(1)
+
+    filename = str(tmp_path / "trace.{rank}.json")
+    sim.enable_trace(filename, max_events=4)
+    sim.run(10)
+
+    rank = sim.device.communicator.rank
+    with open(filename.format(rank=rank)) as f:
+        trace = json.load(f)
+
+    events = trace['traceEvents']
+    assert 0 < len(events) <= 4
+    assert trace['otherData']['dropped_events'] > 0
+    for event in events:
+        assert event['ph'] == 'X'
+        assert event['pid'] == rank
+        assert event['dur'] >= 0
+    assert 'SFCPack' in [event['name'] for event in events]
+
+    # the ranges are in the order they completed
+    ends = [event['ts'] + event['dur'] for event in events]
+    assert ends == sorted(ends)
+
+
+def test_time_per_step(simulation_factory, lattice_snapshot_factory):
+    """Test the per operation timers."""
+    sim = simulation_factory(lattice_snapshot_factory())
+    tuner = sim.operations.tuners[0]
+    tuner.trigger = hoomd.trigger.Periodic(1)
+    assert tuner.time_per_step is None
+
+    sim.run(0)
+    assert tuner.time_per_step == 0.0
+    assert sim.communication_time_per_step == 0.0
+
+    sim.run(10)
+    assert tuner.time_per_step > 0
+    assert sim.communication_time_per_step >= 0
+    if sim.device.communicator.num_ranks == 1:
+        assert sim.communication_time_per_step == 0.0
+
+    # the timers restart with each run
+    tuner.trigger = hoomd.trigger.Periodic(1000)
+    sim.run(5)
+    assert tuner.time_per_step == 0.0
+
+    assert 'time_per_step' in tuner._export_dict
+    assert 'communication_time_per_step' in sim._export_dict
+
+
+def test_memory_usage(simulation_factory, lattice_snapshot_factory):
+    """Test the memory accounting by owning class."""
+    sim = simulation_factory(lattice_snapshot_factory())
+    sim.run(0)
+
+    usage = sim.memory_usage
+    assert usage['ParticleData'] > 0
+    assert sim.memory_bytes == sum(usage.values())
+    peak = sim.peak_memory_usage
+    assert all(peak[owner] >= usage[owner] for owner in usage)
+
+    assert 'memory_usage' in sim._export_dict
+    assert 'memory_bytes' in sim._export_dict
+
+
 def test_large_timestep(simulation_factory, lattice_snapshot_factory):
     """Test that simluations suport large timestep values."""
     sim = simulation_factory()
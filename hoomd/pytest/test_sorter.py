@@ -1,6 +1,8 @@
 """Test ParticleSorter."""
 
 import hoomd
+import numpy
+import pytest
 
 
 def test_attributes():
@@ -10,6 +12,18 @@ def test_attributes():
 
     assert sorter.trigger is trigger
     assert sorter.grid == 32
+    assert not sorter.sort_bonded_groups
+    assert not sorter.low_memory
+    assert not sorter.adaptive
+
+    sorter.sort_bonded_groups = True
+    assert sorter.sort_bonded_groups
+
+    sorter.low_memory = True
+    assert sorter.low_memory
+
+    sorter.adaptive = True
+    assert sorter.adaptive
 
 
 def test_attributes_attached(simulation_factory, two_particle_snapshot_factory):
@@ -23,6 +37,10 @@ def test_attributes_attached(simulation_factory, two_particle_snapshot_factory):
 
     assert sorter.trigger is trigger
     assert sorter.grid == 32
+    assert not sorter.sort_bonded_groups
+
+    sorter.sort_bonded_groups = True
+    assert sorter.sort_bonded_groups
 
 
 def test_default_sorter(simulation_factory, two_particle_snapshot_factory):
@@ -31,3 +49,60 @@ def test_default_sorter(simulation_factory, two_particle_snapshot_factory):
 
     assert len(sim.operations.tuners) == 1
     assert isinstance(sim.operations.tuners[0], hoomd.tune.ParticleSorter)
+
+
+@pytest.mark.serial
+def test_low_memory_sort(simulation_factory, lattice_snapshot_factory):
+    """Test that the in place sort keeps the particle data of each tag."""
+    snap = lattice_snapshot_factory(n=10, r=0.1)
+    if snap.exists:
+        # scramble the particle order so that the sort has to move particles
+        order = numpy.random.permutation(snap.particles.N)
+        snap.particles.position[:] = snap.particles.position[order]
+        snap.particles.velocity[:] = numpy.random.uniform(
+            -1, 1, size=(snap.particles.N, 3))
+        snap.particles.charge[:] = numpy.arange(snap.particles.N)
+
+    sim = simulation_factory(snap)
+    sorter = hoomd.tune.ParticleSorter(trigger=hoomd.trigger.Periodic(1),
+                                       low_memory=True)
+    sim.operations.tuners.clear()
+    sim.operations.tuners.append(sorter)
+    sim.run(2)
+
+    assert sorter.low_memory
+
+    new_snap = sim.state.snapshot
+    if new_snap.exists:
+        numpy.testing.assert_allclose(new_snap.particles.position,
+                                      snap.particles.position)
+        numpy.testing.assert_allclose(new_snap.particles.velocity,
+                                      snap.particles.velocity)
+        numpy.testing.assert_allclose(new_snap.particles.charge,
+                                      snap.particles.charge)
+
+
+@pytest.mark.serial
+def test_adaptive_sort(simulation_factory, lattice_snapshot_factory):
+    """Test that the Morton key sort keeps the particle data of each tag."""
+    snap = lattice_snapshot_factory(n=10, r=0.1)
+    if snap.exists:
+        order = numpy.random.permutation(snap.particles.N)
+        snap.particles.position[:] = snap.particles.position[order]
+        snap.particles.charge[:] = numpy.arange(snap.particles.N)
+
+    sim = simulation_factory(snap)
+    sorter = hoomd.tune.ParticleSorter(trigger=hoomd.trigger.Periodic(1),
+                                       adaptive=True)
+    sim.operations.tuners.clear()
+    sim.operations.tuners.append(sorter)
+    sim.run(2)
+
+    assert sorter.adaptive
+
+    new_snap = sim.state.snapshot
+    if new_snap.exists:
+        numpy.testing.assert_allclose(new_snap.particles.position,
+                                      snap.particles.position)
+        numpy.testing.assert_allclose(new_snap.particles.charge,
+                                      snap.particles.charge)
@@ -160,6 +160,18 @@ def test_modify_snapshot(simulation_factory, snap):
     assert_snapshots_equal(snap, snap2)
 
 
+def test_replicate(simulation_factory, snap):
+    sim = simulation_factory(snap)
+    sim.state.replicate(2, 3, 2)
+
+    if snap.exists:
+        snap.replicate(2, 3, 2)
+
+    assert sim.state.N_particles == 12 * 1000
+    assert sim.state.N_bonds == 12 * 999
+    assert_snapshots_equal(snap, sim.state.snapshot)
+
+
 def test_thermalize_particle_velocity(simulation_factory,
                                       lattice_snapshot_factory):
     snap = lattice_snapshot_factory()
@@ -158,3 +158,63 @@ def test_only_string_and_scalar_quantities(device):
     logger = hoomd.logging.Logger(categories=['sequence'])
     with pytest.raises(ValueError):
         _ = hoomd.write.Table(0, logger, output)
+
+
+@pytest.mark.serial
+def test_rows_per_flush(device, logger):
+    output = StringIO("")
+    table_writer = hoomd.write.Table(0, logger, output, rows_per_flush=4)
+    table_writer._comm = device.communicator
+    assert table_writer.rows_per_flush == 4
+
+    for i in range(3):
+        table_writer.write()
+    assert output.getvalue() == ''
+
+    # the header and the first 4 rows are written together
+    table_writer.write()
+    assert len(output.getvalue().split('\n')) == 6
+
+    table_writer.write()
+    assert len(output.getvalue().split('\n')) == 6
+    table_writer.flush()
+    assert len(output.getvalue().split('\n')) == 7
+
+    with pytest.raises(ValueError):
+        hoomd.write.Table(0, logger, output, rows_per_flush=0)
+
+
+@pytest.mark.serial
+def test_cpp_table(simulation_factory, two_particle_snapshot_factory,
+                   tmp_path):
+    sim = simulation_factory(two_particle_snapshot_factory())
+    logger = hoomd.logging.Logger(categories=['scalar'])
+    logger.add(sim, quantities=['timestep', 'final_timestep'])
+
+    # quantities evaluated in C++ are written by the C++ table writer when the
+    # output has a file descriptor
+    filename = tmp_path / 'table.txt'
+    with open(filename, 'w') as output:
+        table_writer = hoomd.write.Table(2, logger, output, rows_per_flush=3)
+        sim.operations.writers.append(table_writer)
+        sim.run(10)
+        assert table_writer._action._cpp_table is not None
+        sim.operations.writers.remove(table_writer)
+
+    # the output is the same as when Python formats the rows
+    current_step = [0]
+    python_logger = hoomd.logging.Logger(categories=['scalar'])
+    for namespace in hoomd.util.dict_flatten(logger.log()):
+        if namespace[-1] == 'timestep':
+            python_logger[namespace] = (lambda: current_step[0], 'scalar')
+        else:
+            python_logger[namespace] = (lambda: 10, 'scalar')
+
+    expected = StringIO("")
+    table_writer = hoomd.write.Table(2, python_logger, expected)
+    table_writer._comm = sim.device.communicator
+    for step in range(2, 11, 2):
+        current_step[0] = step
+        table_writer.write()
+
+    assert filename.read_text() == expected.getvalue()
@@ -136,6 +136,39 @@ def test_pickling(trigger):
     assert trigger == pkled_trigger
 
 
+@pytest.mark.parametrize('trigger, eval_func',
+                         zip(triggers(), _eval_funcs),
+                         ids=_test_name)
+def test_next_fire_step(trigger, eval_func):
+    starts = itertools.chain(range(0, 1000, 7),
+                             range(10000000000, 10000001000, 7))
+    for start in starts:
+        next_step = trigger.next_fire_step(start)
+        assert next_step >= start
+        # the trigger is not active before the returned step
+        for i in range(start, min(next_step, start + 1000)):
+            assert not eval_func(i)
+
+
+def test_next_fire_step_exact():
+    assert hoomd.trigger.Periodic(10, 3).next_fire_step(3) == 3
+    assert hoomd.trigger.Periodic(10, 3).next_fire_step(4) == 13
+    assert hoomd.trigger.Periodic(10, 3).next_fire_step(13) == 13
+    assert hoomd.trigger.Before(100).next_fire_step(50) == 50
+    assert hoomd.trigger.Before(100).next_fire_step(100) == 2**64 - 1
+    assert hoomd.trigger.On(100).next_fire_step(50) == 100
+    assert hoomd.trigger.On(100).next_fire_step(101) == 2**64 - 1
+    assert hoomd.trigger.After(100).next_fire_step(50) == 101
+    assert hoomd.trigger.After(100).next_fire_step(200) == 200
+    trigger = hoomd.trigger.Or(
+        [hoomd.trigger.On(100), hoomd.trigger.Periodic(30)])
+    assert trigger.next_fire_step(61) == 90
+    trigger = hoomd.trigger.And(
+        [hoomd.trigger.After(100), hoomd.trigger.Periodic(30)])
+    assert trigger.next_fire_step(61) == 101
+    assert CustomTrigger().next_fire_step(5) == 5
+
+
 def test_custom():
     c = CustomTrigger()
 
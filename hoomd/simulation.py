@@ -152,7 +152,7 @@ class Simulation(metaclass=Loggable):
             self.device._cpp_msg.warning(
                 "Simulation.seed is not set, using default seed=0\n")
 
-    def create_state_from_gsd(self, filename, frame=-1):
+    def create_state_from_gsd(self, filename, frame=-1, bisect_domains=False):
         """Create the simulation state from a GSD file.
 
         Args:
@@ -160,6 +160,17 @@ class Simulation(metaclass=Loggable):
 
             frame (int): Index of the frame to read from the file. Negative
                 values index back from the last frame in the file.
+
+            bisect_domains (bool): Place the MPI domain boundaries so that
+                each slab of domains holds the same number of particles.
+
+        With *bisect_domains*, the cut planes of the domain decomposition are
+        placed at the quantiles of the particle distribution along each
+        dimension instead of uniformly. This helps inhomogeneous systems, such
+        as slabs or droplets, start close to balanced.
+        `hoomd.tune.LoadBalancer` can keep them balanced afterwards. No domain
+        is made narrower than a quarter of its uniform width.
+        *bisect_domains* has no effect without domain decomposition.
         """
         if self.state is not None:
             raise RuntimeError("Cannot initialize more than once\n")
@@ -172,13 +183,45 @@ class Simulation(metaclass=Loggable):
                                                self.device.communicator)
 
         step = reader.getTimeStep() if self.timestep is None else self.timestep
-        self._state = State(self, snapshot)
+        self._state = State(self, snapshot, bisect_domains)
 
         reader.clearSnapshot()
 
         self._init_system(step)
 
-    def create_state_from_snapshot(self, snapshot):
+    def create_state_from_checkpoint(self, filename):
+        """Create the simulation state from a checkpoint.
+
+        Args:
+            filename (str): Prefix of the checkpoint file names given to
+                `hoomd.write.Checkpoint`.
+
+        Each MPI rank reads the files of the ranks that wrote them in turn, so
+        the checkpoint can be read with a different number of ranks than it
+        was written with. The particles are then sent to the ranks of their
+        domains.
+
+        When `timestep` is `None` before calling,
+        `create_state_from_checkpoint` sets `timestep` to the timestep of the
+        checkpoint.
+        """
+        if self.state is not None:
+            raise RuntimeError("Cannot initialize more than once\n")
+        filename = _hoomd.mpi_bcast_str(filename,
+                                        self.device._cpp_exec_conf)
+        reader = _hoomd.CheckpointReader(self.device._cpp_exec_conf, filename)
+        snapshot = Snapshot._from_cpp_snapshot(reader.getSnapshot(),
+                                               self.device.communicator)
+
+        step = reader.getTimeStep() if self.timestep is None else self.timestep
+        self._state = State(self, snapshot)
+        reader.restore(self._state._cpp_sys_def)
+
+        self._init_system(step)
+        if self._system_communicator is not None:
+            self._system_communicator.migrateParticlesToDomains()
+
+    def create_state_from_snapshot(self, snapshot, bisect_domains=False):
         """Create the simulations state from a `Snapshot`.
 
         Args:
@@ -186,6 +229,10 @@ class Simulation(metaclass=Loggable):
                 the state from. A `gsd.hoomd.Snapshot` will first be
                 converted to a `hoomd.Snapshot`.
 
+            bisect_domains (bool): Place the MPI domain boundaries so that
+                each slab of domains holds the same number of particles (see
+                `create_state_from_gsd`).
+
 
         When `timestep` is `None` before calling, `create_state_from_snapshot`
         sets `timestep` to 0.
@@ -195,13 +242,13 @@ class Simulation(metaclass=Loggable):
 
         if isinstance(snapshot, Snapshot):
             # snapshot is hoomd.Snapshot
-            self._state = State(self, snapshot)
+            self._state = State(self, snapshot, bisect_domains)
         elif _match_class_path(snapshot, 'gsd.hoomd.Snapshot'):
             # snapshot is gsd.hoomd.Snapshot
             snapshot = Snapshot.from_gsd_snapshot(
                     snapshot, self._device.communicator
                     )
-            self._state = State(self, snapshot)
+            self._state = State(self, snapshot, bisect_domains)
         else:
             raise TypeError(
                 "Snapshot must be a hoomd.Snapshot or gsd.hoomd.Snapshot."
@@ -288,6 +335,218 @@ class Simulation(metaclass=Loggable):
         else:
             return self._cpp_sys.final_timestep
 
+    @log
+    def communication_time_per_step(self):
+        """float: Wall time spent in MPI communication per time step (seconds).
+
+        The average is taken over the current or last `run`.
+
+        This includes the migration of particles between ranks and the ghost
+        particle exchanges and updates. It is 0 without domain decomposition.
+
+        .. versionadded:: 3.0
+        """
+        if self.state is None:
+            return None
+        n_steps = self.timestep - self._cpp_sys.initial_timestep
+        if n_steps == 0:
+            return 0.0
+        return self._cpp_sys.getCommunicationTime() / n_steps
+
+    @log(category='object')
+    def memory_usage(self):
+        """dict[str, int]: Bytes of array memory by owning class on this rank.
+
+        Each key names the C++ class that allocated the arrays, such as
+        ``NeighborList`` or ``ParticleData``. ``CachedAllocator`` and
+        ``CachedAllocatorManaged`` hold the temporary buffers on GPU devices.
+        The counters are always on and cost nothing per time step. On GPU
+        devices, arrays hold the counted bytes in device memory.
+
+        .. versionadded:: 3.0
+        """
+        return self.device._cpp_exec_conf.getMemoryUsage()
+
+    @log(category='object')
+    def peak_memory_usage(self):
+        """dict[str, int]: High-water mark of `memory_usage` for each class.
+
+        .. versionadded:: 3.0
+        """
+        return self.device._cpp_exec_conf.getPeakMemoryUsage()
+
+    @log
+    def memory_bytes(self):
+        """int: Total bytes of array memory on this rank.
+
+        .. versionadded:: 3.0
+        """
+        return sum(self.memory_usage.values())
+
+    def enable_trace(self, filename, max_events=2**20):
+        """Record a timeline of each following `run`.
+
+        Args:
+            filename (str): Name of the trace file to write at the end of
+                each `run`. ``{rank}`` in *filename* is replaced by the
+                MPI rank, so that each rank can write its own file.
+            max_events (int): Maximum number of timed ranges to keep per rank.
+
+        The trace holds the timed ranges of the internal profiler, such as
+        force computations, neighbor list builds, and the phases of the MPI
+        communication. It is written in the Chrome trace event format, which
+        `Perfetto <https://ui.perfetto.dev>`_ and ``chrome://tracing`` can
+        display. Once *max_events* ranges are recorded, new ranges overwrite
+        the oldest ones, so the trace covers the end of the run.
+
+        Note:
+            Like profiling, tracing synchronizes the GPU at the start and end
+            of each range, which slows down the simulation.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            raise RuntimeError('Cannot enable tracing without state')
+        filename = filename.format(rank=self.device.communicator.rank)
+        self._cpp_sys.setTrace(filename, int(max_events))
+
+    def disable_trace(self):
+        """Stop recording timelines of runs."""
+        if hasattr(self, '_cpp_sys'):
+            self._cpp_sys.setTrace("", 0)
+
+    def enable_counters(self, events):
+        """Collect hardware performance counters in each following `run`.
+
+        Args:
+            events (list[str]): Names of the PAPI events to count, such as
+                ``'PAPI_TOT_CYC'``, ``'PAPI_TOT_INS'``, ``'PAPI_L2_TCM'``, and
+                ``'PAPI_L2_TCA'`` on the CPU, or
+                ``'cuda:::dram__bytes_read.sum:device=0'`` and
+                ``'cuda:::sm__warps_active.sum:device=0'`` through the PAPI
+                CUDA component on NVIDIA GPUs.
+
+        The counters are read at the start and end of every range of the
+        internal profiler. `profile` lists the rate of every counter below
+        each range, together with the instructions per cycle, cache miss
+        rates, memory bandwidth, and achieved occupancy when the necessary
+        counters are collected.
+
+        Note:
+            Hardware counters require HOOMD-blue to be built with
+            ``ENABLE_PAPI=on``. Like profiling, counting synchronizes the GPU
+            at the start and end of each range.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            raise RuntimeError('Cannot enable counters without state')
+        self._cpp_sys.setCounters([str(e) for e in events])
+
+    def disable_counters(self):
+        """Stop collecting hardware performance counters."""
+        if hasattr(self, '_cpp_sys'):
+            self._cpp_sys.setCounters([])
+
+    def enable_rollback(self,
+                        period=1000,
+                        depth=3,
+                        dt_scale=1.0,
+                        max_rollbacks=5):
+        """Roll back to an in-memory checkpoint when the simulation fails.
+
+        Args:
+            period (int): Number of steps between checkpoints.
+            depth (int): Number of checkpoints to keep in memory.
+            dt_scale (float): Factor to multiply the integrator's time step
+                by on each rollback.
+            max_rollbacks (int): Maximum number of rollbacks before the next
+                checkpoint. `run` raises an exception when the simulation
+                fails again.
+
+        Every *period* steps, `run` checks that all particle positions and
+        velocities are finite and keeps a copy of the particle data, box, and
+        integrator variables in memory (in GPU memory on GPU devices). When the
+        check fails, or when a step raises an exception on a single rank,
+        `run` restores the newest checkpoint and continues from its timestep.
+        Consecutive failures restore older checkpoints. Set *dt_scale* below 1
+        to continue with a smaller time step, which remains in effect after the
+        rollback.
+
+        Note:
+            Random numbers in HOOMD-blue depend on the timestep, so a rollback
+            without a change of the time step repeats the same trajectory.
+
+        Note:
+            With more than one MPI rank, only the periodic check triggers a
+            rollback. Rolling back across the addition or removal of particles
+            is an error.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            raise RuntimeError('Cannot enable rollback without state')
+        self._cpp_sys.setRollback(int(period), int(depth), float(dt_scale),
+                                  int(max_rollbacks))
+
+    def disable_rollback(self):
+        """Stop checkpointing and free the in-memory checkpoints."""
+        if hasattr(self, '_cpp_sys'):
+            self._cpp_sys.setRollback(0, 0, 1.0, 0)
+
+    def enable_preemption_checkpoint(self, filename, exit=True):
+        """Write a checkpoint and stop when the job is preempted.
+
+        Args:
+            filename (str): Prefix of the checkpoint file names.
+            exit (bool): When `True`, `run` raises `SystemExit` after writing
+                the checkpoint. When `False`, `run` returns and
+                `preempted` is `True`.
+
+        During each following `run`, the SIGTERM signal that batch schedulers
+        send to preempted jobs no longer terminates the process. Instead, the
+        simulation completes the current step, every MPI rank writes its local
+        data to ``<filename>.<rank>`` in the format of `hoomd.write.Checkpoint`,
+        and the run ends. A preempted job loses at most one step of work and
+        restarts with `create_state_from_checkpoint`.
+
+        Note:
+            The ranks agree on the signal with a small MPI reduction each step.
+            Outside of `run`, SIGTERM keeps its default action.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            raise RuntimeError(
+                'Cannot enable the preemption checkpoint without state')
+        # all ranks write next to the files of the root rank
+        filename = _hoomd.mpi_bcast_str(str(filename),
+                                        self.device._cpp_exec_conf)
+        self._cpp_sys.setPreemptionCheckpoint(
+            _hoomd.CheckpointWriter(self.state._cpp_sys_def, filename))
+        self._preemption_exit = bool(exit)
+
+    def disable_preemption_checkpoint(self):
+        """Restore the default action of SIGTERM during `run`."""
+        if hasattr(self, '_cpp_sys'):
+            self._cpp_sys.setPreemptionCheckpoint(None)
+
+    @property
+    def preempted(self):
+        """bool: `True` when the last `run` ended on SIGTERM."""
+        if not hasattr(self, '_cpp_sys'):
+            return False
+        return self._cpp_sys.preempted
+
+    @property
+    def num_rollbacks(self):
+        """int: Number of rollbacks since `enable_rollback`."""
+        if not hasattr(self, '_cpp_sys'):
+            return 0
+        return self._cpp_sys.getNumRollbacks()
+
+    @property
+    def profile(self):
+        """str: Timing tree of the last `run` with tracing or counters.
+
+        Empty when the last `run` was not profiled.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            return ''
+        return self._cpp_sys.getProfile()
+
     @property
     def always_compute_pressure(self):
         """bool: Always compute the virial and pressure (defaults to ``False``).
@@ -389,6 +648,10 @@ class Simulation(metaclass=Loggable):
 
         self._cpp_sys.run(steps_int, write_at_start)
 
+        if self._cpp_sys.preempted and getattr(self, '_preemption_exit',
+                                               False):
+            raise SystemExit(0)
+
     def write_debug_data(self, filename):
         """Write debug data to a JSON file.
 
@@ -13,7 +13,7 @@ from hoomd.data import LocalSnapshot, LocalSnapshotGPU
 import hoomd
 
 
-def _create_domain_decomposition(device, box):
+def _create_domain_decomposition(device, box, bisect=False):
     """Create a default domain decomposition.
 
     This method is a quick hack to get basic MPI simulations working with
@@ -28,13 +28,15 @@ def _create_domain_decomposition(device, box):
     if device.communicator.num_ranks == 1:
         return None
 
-    # create a default domain decomposition
+    # create a default domain decomposition, placing neighboring domains on
+    # the same node when every node has the same number of ranks
     result = _hoomd.DomainDecomposition(device._cpp_exec_conf,
                                         box.getL(),
                                         0,
                                         0,
                                         0,
-                                        False)
+                                        True)
+    result.bisect = bisect
 
     return result
 
@@ -59,12 +61,13 @@ class State:
         `State` object.
     """
 
-    def __init__(self, simulation, snapshot):
+    def __init__(self, simulation, snapshot, bisect_domains=False):
         self._simulation = simulation
         snapshot._broadcast_box()
         domain_decomp = _create_domain_decomposition(
             simulation.device,
-            snapshot._cpp_obj._global_box)
+            snapshot._cpp_obj._global_box,
+            bisect_domains)
 
         if domain_decomp is not None:
             self._cpp_sys_def = _hoomd.SystemDefinition(
@@ -77,6 +80,10 @@ class State:
         # Necessary for local snapshot API. This is used to ensure two local
         # snapshots are not contexted at once.
         self._in_context_manager = False
+        # Local snapshots are created once, so the array views they hold are
+        # reused between context managers.
+        self._cpu_local_snapshot = None
+        self._gpu_local_snapshot = None
 
         # self._groups provides a cache of C++ group objects of the form:
         # {type(filter): {filter: C++ group}}
@@ -247,8 +254,35 @@ class State:
             self._cpp_sys_def.setNDimensions(value.dimensions)
         self._cpp_sys_def.getParticleData().setGlobalBox(value._cpp_obj)
 
-    def replicate(self):  # noqa: D102
-        raise NotImplementedError
+    def replicate(self, nx, ny, nz=1):
+        """Replicate the state of the system along the periodic box directions.
+
+        Args:
+            nx (int): Number of times to replicate in the x direction.
+            ny (int): Number of times to replicate in the y direction.
+            nz (int): Number of times to replicate in the z direction.
+
+        `replicate` makes the system larger by a factor of *nx*, *ny*, and
+        *nz* along the box vectors. It produces the same state as
+        `hoomd.Snapshot.replicate`, but each MPI rank replicates the particles
+        and bonded groups it owns in place, so the replicated system is never
+        gathered on one rank. The copies are then sent to the ranks of their
+        domains.
+
+        Note:
+            `replicate` requires that no particles or bonded groups have been
+            removed from the system.
+        """
+        if self._in_context_manager:
+            raise RuntimeError(
+                "Cannot replicate the state inside local snapshot.")
+        if self.box.is2D and nz != 1:
+            raise ValueError("nz must be 1 in 2D simulations.")
+        self._cpp_sys_def.replicate(nx, ny, nz)
+
+        communicator = self._simulation._system_communicator
+        if communicator is not None:
+            communicator.migrateParticlesToDomains()
 
     def _get_group(self, filter_):
         cls = filter_.__class__
@@ -324,12 +358,21 @@ class State:
         Note:
             Getting a local snapshot object is order :math:`O(1)` and setting a
             single value is of order :math:`O(1)`.
+
+        Note:
+            `State` returns the same local snapshot object every time. Arrays
+            accessed in one context manager are reused in later ones when the
+            underlying buffer has not moved, so code that accesses the same
+            arrays every time step (e.g. a custom force) does not pay for
+            creating new arrays each time.
         """
         if self._in_context_manager:
             raise RuntimeError(
                 "Cannot enter cpu_local_snapshot context manager inside "
                 "another local_snapshot context manager.")
-        return LocalSnapshot(self)
+        if self._cpu_local_snapshot is None:
+            self._cpu_local_snapshot = LocalSnapshot(self)
+        return self._cpu_local_snapshot
 
     @property
     def gpu_local_snapshot(self):
@@ -378,7 +421,9 @@ class State:
                 "Cannot enter gpu_local_snapshot context manager inside "
                 "another local_snapshot context manager.")
         else:
-            return LocalSnapshotGPU(self)
+            if self._gpu_local_snapshot is None:
+                self._gpu_local_snapshot = LocalSnapshotGPU(self)
+            return self._gpu_local_snapshot
 
     def thermalize_particle_momenta(self, filter, kT):
         """Assign random values to particle momenta.
@@ -340,6 +340,54 @@ UP_TEST( uniform_float_test )
     check_range(gen, 5000000, a, b);
     }
 
+//! Draws values from a distribution in pairs and returns them one at a time
+template<class Distribution, typename Real>
+class PairGenerator
+    {
+    public:
+        PairGenerator(const Distribution& dist) : m_dist(dist), m_have_second(false), m_second(0) {}
+
+        Real operator()(hoomd::RandomGenerator& rng)
+            {
+            if (m_have_second)
+                {
+                m_have_second = false;
+                return m_second;
+                }
+
+            Real first;
+            m_dist(first, m_second, rng);
+            m_have_second = true;
+            return first;
+            }
+
+    private:
+        Distribution m_dist;
+        bool m_have_second;
+        Real m_second;
+    };
+
+//! Test case for UniformDistribution -- pairs of doubles
+UP_TEST( uniform_pair_double_test )
+    {
+    double a = -1, b = 1;
+    double mean = (a+b)/2.0, var=1.0/12.0*(b-a)*(b-a), skew=0.0, exkurtosis=-6.0/5.0;
+
+    PairGenerator<hoomd::UniformDistribution<double>, double> gen(hoomd::UniformDistribution<double>(a, b));
+    check_moments(gen, 5000000, mean, var, skew, exkurtosis, 0.01);
+    check_range(gen, 5000000, a, b);
+    }
+
+//! Test case for NormalDistribution -- pairs of doubles
+UP_TEST( normal_pair_double_test )
+    {
+    double mu = 1.5, sigma=2.0;
+    double mean = mu, var=sigma*sigma, skew=0, exkurtosis=0.0;
+
+    PairGenerator<hoomd::NormalDistribution<double>, double> gen(hoomd::NormalDistribution<double>(sigma, mu));
+    check_moments(gen, 5000000, mean, var, skew, exkurtosis, 0.01);
+    }
+
 //! Test case for UniformIntDistribution
 UP_TEST( uniform_int_test_1000 )
     {
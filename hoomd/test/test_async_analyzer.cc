@@ -0,0 +1,91 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include "hoomd/AsyncAnalyzer.h"
+#include "hoomd/ClockSource.h"
+
+#include <stdexcept>
+#include <vector>
+
+/*! \file test_async_analyzer.cc
+    \brief Unit tests for AsyncAnalyzer
+    \ingroup unit_tests
+*/
+
+using namespace std;
+
+//! Analyzer that records the staged positions
+class RecordingAnalyzer : public AsyncAnalyzer
+    {
+    public:
+        RecordingAnalyzer(std::shared_ptr<SystemDefinition> sysdef) : AsyncAnalyzer(sysdef) { }
+
+        vector<uint64_t> m_timesteps;   //!< Time steps analyzed, in order
+        vector<Scalar> m_x;             //!< x coordinate of the first particle in each snapshot
+        bool m_fail = false;            //!< Throw from the analysis
+
+    protected:
+        virtual unsigned int getRequestedFields()
+            {
+            return position | tag;
+            }
+
+        virtual void analyzeAsync(const AsyncAnalyzerData& data)
+            {
+            if (m_fail)
+                throw runtime_error("analysis failed");
+
+            Sleep(5);
+            m_timesteps.push_back(data.timestep);
+            m_x.push_back(data.pos[0].x);
+            }
+    };
+
+//! Checks that the analyses see the snapshot of their time step and complete in order
+UP_TEST( async_analyzer_snapshot )
+    {
+    std::shared_ptr< SystemDefinition > sysdef(new SystemDefinition(2, BoxDim(10)));
+    std::shared_ptr< ParticleData > pdata = sysdef->getParticleData();
+    std::shared_ptr< RecordingAnalyzer > analyzer(new RecordingAnalyzer(sysdef));
+
+    for (unsigned int i = 0; i < 5; i++)
+        {
+        pdata->setPosition(0, make_scalar3(Scalar(i), 0, 0));
+        analyzer->analyze(i);
+
+        // the particle moves while the analysis runs
+        pdata->setPosition(0, make_scalar3(Scalar(-1.0), 0, 0));
+        }
+    analyzer->synchronize();
+
+    UP_ASSERT_EQUAL(analyzer->m_timesteps.size(), (size_t)5);
+    for (unsigned int i = 0; i < 5; i++)
+        {
+        UP_ASSERT_EQUAL(analyzer->m_timesteps[i], (uint64_t)i);
+        MY_CHECK_CLOSE(analyzer->m_x[i], Scalar(i), tol);
+        }
+    }
+
+//! Checks that errors of the analysis reach the caller
+UP_TEST( async_analyzer_error )
+    {
+    std::shared_ptr< SystemDefinition > sysdef(new SystemDefinition(2, BoxDim(10)));
+    std::shared_ptr< RecordingAnalyzer > analyzer(new RecordingAnalyzer(sysdef));
+
+    analyzer->m_fail = true;
+    analyzer->analyze(0);
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ analyzer->synchronize(); });
+
+    // the same error is raised inline without the worker thread
+    analyzer->setAsync(false);
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ analyzer->analyze(1); });
+    }
@@ -0,0 +1,123 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <limits>
+
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+#include "hoomd/CheckpointRing.h"
+
+/*! \file test_checkpoint_ring.cc
+    \brief Unit tests for CheckpointRing
+    \ingroup unit_tests
+*/
+
+using namespace std;
+
+//! Set the x coordinate of the particle with the given tag
+static void set_x(std::shared_ptr<ParticleData> pdata, unsigned int tag, Scalar x)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    h_pos.data[h_rtag.data[tag]].x = x;
+    }
+
+//! Get the x coordinate of the particle with the given tag
+static Scalar get_x(std::shared_ptr<ParticleData> pdata, unsigned int tag)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    return h_pos.data[h_rtag.data[tag]].x;
+    }
+
+//! Checks saving and restoring checkpoints, including the wrap around of the ring
+void checkpoint_ring_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SystemDefinition > sysdef(new SystemDefinition(2, BoxDim(10), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< ParticleData > pdata = sysdef->getParticleData();
+    CheckpointRing ring(sysdef, 2);
+
+    UP_ASSERT_EQUAL(ring.getDepth(), 2u);
+    UP_ASSERT_EQUAL(ring.getNumCheckpoints(), 0u);
+    UP_ASSERT(ring.isStateValid());
+
+    for (unsigned int i = 0; i < 3; i++)
+        {
+        set_x(pdata, 0, Scalar(i));
+        ring.save(100*i);
+        }
+
+    // the first checkpoint was overwritten
+    UP_ASSERT_EQUAL(ring.getNumCheckpoints(), 2u);
+    UP_ASSERT_EQUAL(ring.getTimeStep(0), (uint64_t)200);
+    UP_ASSERT_EQUAL(ring.getTimeStep(1), (uint64_t)100);
+
+    // the restored state is the state at the checkpoint
+    set_x(pdata, 0, std::numeric_limits<Scalar>::quiet_NaN());
+    UP_ASSERT(!ring.isStateValid());
+    UP_ASSERT_EQUAL(ring.restore(0), (uint64_t)200);
+    UP_ASSERT(ring.isStateValid());
+    MY_CHECK_CLOSE(get_x(pdata, 0), 2.0, tol);
+
+    // restoring an older checkpoint discards the newer ones
+    UP_ASSERT_EQUAL(ring.restore(1), (uint64_t)100);
+    MY_CHECK_CLOSE(get_x(pdata, 0), 1.0, tol);
+    UP_ASSERT_EQUAL(ring.getNumCheckpoints(), 1u);
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ring.restore(1);});
+    }
+
+//! Checks that restoring rebuilds the reverse tags after the particles were reordered
+void checkpoint_ring_sort_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SystemDefinition > sysdef(new SystemDefinition(2, BoxDim(10), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< ParticleData > pdata = sysdef->getParticleData();
+    set_x(pdata, 0, 1.0);
+    set_x(pdata, 1, 2.0);
+
+    CheckpointRing ring(sysdef, 1);
+    ring.save(0);
+
+        {
+        // swap the two particles in memory
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+        std::swap(h_pos.data[0], h_pos.data[1]);
+        std::swap(h_tag.data[0], h_tag.data[1]);
+        h_rtag.data[h_tag.data[0]] = 0;
+        h_rtag.data[h_tag.data[1]] = 1;
+        }
+    pdata->notifyParticleSort();
+
+    ring.restore(0);
+    MY_CHECK_CLOSE(get_x(pdata, 0), 1.0, tol);
+    MY_CHECK_CLOSE(get_x(pdata, 1), 2.0, tol);
+    }
+
+UP_TEST( CheckpointRing_cpu )
+    {
+    checkpoint_ring_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+UP_TEST( CheckpointRing_sort_cpu )
+    {
+    checkpoint_ring_sort_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_HIP
+UP_TEST( CheckpointRing_gpu )
+    {
+    checkpoint_ring_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
+UP_TEST( CheckpointRing_sort_gpu )
+    {
+    checkpoint_ring_sort_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif
@@ -412,3 +412,92 @@ UP_TEST( GPUVector_basic_tests )
     UP_ASSERT_EQUAL((unsigned int)vec[9], (unsigned int)890);
     }
 #endif
+
+//! test case for counting the memory of arrays by owner
+UP_TEST( GPUArray_memory_usage_tests )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<MemoryUsage> usage = exec_conf->getMemoryUsage();
+    size_t start = usage->getBytes();
+
+        {
+        // arrays are counted under the class in their tag
+        GPUArray<int> a(100, exec_conf);
+        UP_ASSERT_EQUAL(usage->getBytes(), start + 100*sizeof(int));
+        a.setTag("Owner::m_a");
+        UP_ASSERT_EQUAL(usage->getCounters()["Owner"].bytes, 100*sizeof(int));
+
+        a.resize(200);
+        UP_ASSERT_EQUAL(usage->getCounters()["Owner"].bytes, 200*sizeof(int));
+
+        // swapping moves the tags with the data
+        GPUArray<int> b(50, exec_conf);
+        b.setTag("hpmc::Other::m_b");
+        a.swap(b);
+        UP_ASSERT_EQUAL(usage->getCounters()["Owner"].bytes, 200*sizeof(int));
+        UP_ASSERT_EQUAL(usage->getCounters()["hpmc::Other"].bytes, 50*sizeof(int));
+
+        // a copy counts its own allocation
+        GPUArray<int> c(a);
+        UP_ASSERT_EQUAL(usage->getCounters()["hpmc::Other"].bytes, 100*sizeof(int));
+        UP_ASSERT_EQUAL(usage->getCounters()["hpmc::Other"].num_arrays, (unsigned long)2);
+        UP_ASSERT_EQUAL(usage->getBytes(), start + 300*sizeof(int));
+        }
+
+    // freed arrays are removed, the high-water marks remain
+    UP_ASSERT_EQUAL(usage->getBytes(), start);
+    UP_ASSERT_EQUAL(usage->getCounters()["Owner"].bytes, (size_t)0);
+    UP_ASSERT_EQUAL(usage->getCounters()["Owner"].peak_bytes, 200*sizeof(int));
+    }
+
+#ifdef ENABLE_HIP
+//! test case for reusing device memory through the DeviceMemoryPool
+UP_TEST( GPUArray_memory_pool_tests )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+    DeviceMemoryPool& pool = exec_conf->getDeviceMemoryPool();
+    MemoryPoolStatistics start = pool.getStatistics();
+
+        {
+        GPUArray<int> gpu_array(1000, exec_conf);
+        ArrayHandle<int> d_handle(gpu_array, access_location::device, access_mode::overwrite);
+        }
+
+    // the freed block stays in the pool
+    MemoryPoolStatistics freed = pool.getStatistics();
+    UP_ASSERT_EQUAL(freed.bytes_in_use, start.bytes_in_use);
+    UP_ASSERT(freed.bytes_cached > start.bytes_cached);
+    UP_ASSERT(freed.peak_bytes_in_use >= 1000*sizeof(int));
+
+    // a slightly smaller array reuses it without allocating
+        {
+        GPUArray<int> gpu_array(990, exec_conf);
+        ArrayHandle<int> d_handle(gpu_array, access_location::device, access_mode::overwrite);
+
+        MemoryPoolStatistics reused = pool.getStatistics();
+        UP_ASSERT_EQUAL(reused.num_misses, freed.num_misses);
+        UP_ASSERT_EQUAL(reused.num_hits, freed.num_hits+1);
+        }
+
+    // the data survives resizing through the pool
+    GPUArray<int> gpu_array(100, exec_conf);
+        {
+        ArrayHandle<int> h_handle(gpu_array, access_location::host, access_mode::overwrite);
+        for (int i = 0; i < 100; i++)
+            h_handle.data[i] = i;
+        }
+        {
+        ArrayHandle<int> d_handle(gpu_array, access_location::device, access_mode::readwrite);
+        }
+    gpu_array.resize(5000);
+        {
+        ArrayHandle<int> h_handle(gpu_array, access_location::host, access_mode::read);
+        for (int i = 0; i < 100; i++)
+            UP_ASSERT_EQUAL(h_handle.data[i], i);
+        }
+
+    // releasing the cache frees the unused blocks
+    pool.releaseCache();
+    UP_ASSERT_EQUAL(pool.getStatistics().bytes_cached, (size_t)0);
+    }
+#endif
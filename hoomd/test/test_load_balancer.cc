@@ -363,6 +363,73 @@ void test_load_balancer_ghost(std::shared_ptr<ExecutionConfiguration> exec_conf,
     UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
     }
 
+//! Test that bisecting the initial particle distribution gives each rank one particle
+void test_domain_decomposition_bisect(std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box)
+{
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with eight particles
+    BoxDim ref_box = BoxDim(2.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,           // number of particles
+                                                             dest_box,        // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    // all particles are in one octant of the box
+    pdata->setPosition(0, TO_TRICLINIC(make_scalar3(0.25,-0.25,0.25)),false);
+    pdata->setPosition(1, TO_TRICLINIC(make_scalar3(0.25,-0.25,0.75)),false);
+    pdata->setPosition(2, TO_TRICLINIC(make_scalar3(0.25,-0.75,0.25)),false);
+    pdata->setPosition(3, TO_TRICLINIC(make_scalar3(0.25,-0.75,0.75)),false);
+    pdata->setPosition(4, TO_TRICLINIC(make_scalar3(0.75,-0.25,0.25)),false);
+    pdata->setPosition(5, TO_TRICLINIC(make_scalar3(0.75,-0.25,0.75)),false);
+    pdata->setPosition(6, TO_TRICLINIC(make_scalar3(0.75,-0.75,0.25)),false);
+    pdata->setPosition(7, TO_TRICLINIC(make_scalar3(0.75,-0.75,0.75)),false);
+
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    // initialize a uniform 2x2x2 domain decomposition and bisect the snapshot
+    std::vector<Scalar> fxs(1), fys(1), fzs(1);
+    fxs[0] = Scalar(0.5);
+    fys[0] = Scalar(0.5);
+    fzs[0] = Scalar(0.5);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(), fxs, fys, fzs));
+    decomposition->setBisect(true);
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    // the cut planes moved into the occupied octant
+    UP_ASSERT(decomposition->getCumulativeFraction(0, 1) > Scalar(0.625));
+    UP_ASSERT(decomposition->getCumulativeFraction(0, 1) < Scalar(0.875));
+    UP_ASSERT(decomposition->getCumulativeFraction(1, 1) > Scalar(0.125));
+    UP_ASSERT(decomposition->getCumulativeFraction(1, 1) < Scalar(0.375));
+    UP_ASSERT(decomposition->getCumulativeFraction(2, 1) > Scalar(0.625));
+    UP_ASSERT(decomposition->getCumulativeFraction(2, 1) < Scalar(0.875));
+
+    // each rank should own one particle
+    const Index3D& di = decomposition->getDomainIndexer();
+    UP_ASSERT_EQUAL(pdata->getN(), 1);
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(0), di(0,1,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(1), di(0,1,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(2), di(0,0,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(3), di(0,0,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(4), di(1,1,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(5), di(1,1,1));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(6), di(1,0,0));
+    UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
+    }
+
 //! Tests basic particle redistribution
 UP_TEST( LoadBalancer_test_basic)
     {
@@ -399,6 +466,18 @@ UP_TEST( LoadBalancer_test_ghost)
     test_load_balancer_ghost<LoadBalancer>(exec_conf, BoxDim(1.0,-.6,.7,.5));
     }
 
+//! Tests the bisection of the initial particle distribution
+UP_TEST( DomainDecomposition_test_bisect)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    // cubic box
+    test_domain_decomposition_bisect(exec_conf, BoxDim(2.0));
+    // triclinic box 1
+    test_domain_decomposition_bisect(exec_conf, BoxDim(1.0,.1,.2,.3));
+    // triclinic box 2
+    test_domain_decomposition_bisect(exec_conf, BoxDim(1.0,-.6,.7,.5));
+    }
+
 #ifdef ENABLE_HIP
 //! Tests basic particle redistribution on the GPU
 UP_TEST( LoadBalancerGPU_test_basic)
@@ -154,6 +154,11 @@ UP_TEST( ParticleGroup_sort_test )
 
     std::shared_ptr<ParticleFilter> selector04(new ParticleFilterTags(std::vector<unsigned int>({0,1,2,3,4})));
     ParticleGroup tags04(sysdef, selector04);
+    std::shared_ptr<ParticleFilter> selector_all(new ParticleFilterAll());
+    ParticleGroup tags_all(sysdef, selector_all);
+    UP_ASSERT(!tags04.isIdentity());
+    UP_ASSERT(tags_all.isIdentity());
+
     // verify the initial set
     CHECK_EQUAL_UINT(tags04.getNumMembers(), 5);
     CHECK_EQUAL_UINT(tags04.getIndexArray().getNumElements(), 5);
@@ -221,6 +226,15 @@ UP_TEST( ParticleGroup_sort_test )
             UP_ASSERT(!tags04.isMember(i));
         }
     }
+
+    // the group of all particles lists the particles in index order in any order of the particles
+    UP_ASSERT(tags_all.isIdentity());
+    CHECK_EQUAL_UINT(tags_all.getNumMembers(), pdata->getN());
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        CHECK_EQUAL_UINT(tags_all.getMemberIndex(i), i);
+        UP_ASSERT(tags_all.isMember(i));
+        }
     }
 
 //! Checks that ParticleGroup can initialize by particle type
@@ -617,6 +617,104 @@ UP_TEST( ParticleData_test )
     UP_ASSERT(pdata_type_test.getTypeByName("test") == 1);
     }
 
+//! Tests the structure of arrays view of the particle positions
+UP_TEST( ParticleData_positions_soa_test )
+    {
+    BoxDim box(10.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    ParticleData pdata(3, box, 1, exec_conf);
+
+    pdata.setPosition(0, make_scalar3(1.0, 2.0, 3.0));
+    pdata.setPosition(1, make_scalar3(-1.0, -2.0, -3.0));
+    pdata.setPosition(2, make_scalar3(0.5, 1.5, 2.5));
+
+    Scalar tol = Scalar(1e-6);
+
+        {
+        const GlobalArray<Scalar>& pos_soa = pdata.getPositionsSoA(0);
+        ArrayHandle<Scalar> h_pos_soa(pos_soa, access_location::host, access_mode::read);
+        const size_t pitch = pos_soa.getPitch();
+        UP_ASSERT(pitch >= 3);
+        MY_CHECK_CLOSE(h_pos_soa.data[0], 1.0, tol);
+        MY_CHECK_CLOSE(h_pos_soa.data[pitch+1], -2.0, tol);
+        MY_CHECK_CLOSE(h_pos_soa.data[2*pitch+2], 2.5, tol);
+        }
+
+    // the view is cached within a timestep and refreshed for the next one
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[pdata.getRTag(0)].x = Scalar(4.0);
+        }
+        {
+        ArrayHandle<Scalar> h_pos_soa(pdata.getPositionsSoA(0), access_location::host, access_mode::read);
+        MY_CHECK_CLOSE(h_pos_soa.data[0], 1.0, tol);
+        }
+        {
+        ArrayHandle<Scalar> h_pos_soa(pdata.getPositionsSoA(1), access_location::host, access_mode::read);
+        MY_CHECK_CLOSE(h_pos_soa.data[0], 4.0, tol);
+        }
+
+    // explicit invalidation repacks at the same timestep
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[pdata.getRTag(0)].x = Scalar(-4.0);
+        }
+    pdata.invalidatePositionsSoA();
+        {
+        ArrayHandle<Scalar> h_pos_soa(pdata.getPositionsSoA(1), access_location::host, access_mode::read);
+        MY_CHECK_CLOSE(h_pos_soa.data[0], -4.0, tol);
+        }
+
+    // setPosition invalidates the view
+    pdata.setPosition(0, make_scalar3(3.0, 2.0, 3.0));
+        {
+        ArrayHandle<Scalar> h_pos_soa(pdata.getPositionsSoA(1), access_location::host, access_mode::read);
+        MY_CHECK_CLOSE(h_pos_soa.data[0], 3.0, tol);
+        }
+    }
+
+//! Test the local snapshot of a particle data without domain decomposition
+UP_TEST( ParticleData_local_snapshot_test )
+    {
+    BoxDim box(10.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    ParticleData pdata(4, box, 2, exec_conf);
+
+    pdata.setPosition(0, make_scalar3(1.0, 2.0, 3.0));
+    pdata.setPosition(1, make_scalar3(-1.0, -2.0, -3.0));
+    pdata.setPosition(2, make_scalar3(0.5, 1.5, 2.5));
+    pdata.setPosition(3, make_scalar3(-0.5, -1.5, -2.5));
+    pdata.setType(1, 1);
+    pdata.setType(3, 1);
+
+    Scalar tol = Scalar(1e-6);
+
+    // all particles, in tag order
+    SnapshotParticleData<Scalar> snapshot;
+    std::vector<unsigned int> tags = pdata.takeLocalSnapshot(snapshot);
+    UP_ASSERT_EQUAL(tags.size(), 4);
+    UP_ASSERT_EQUAL(snapshot.size, 4);
+    for (unsigned int i = 0; i < 4; i++)
+        {
+        UP_ASSERT_EQUAL(tags[i], i);
+        Scalar3 pos = pdata.getPosition(i);
+        MY_CHECK_CLOSE(snapshot.pos[i].x, pos.x, tol);
+        MY_CHECK_CLOSE(snapshot.pos[i].y, pos.y, tol);
+        MY_CHECK_CLOSE(snapshot.pos[i].z, pos.z, tol);
+        UP_ASSERT_EQUAL(snapshot.type[i], pdata.getType(i));
+        }
+
+    // only particles of type 1
+    SnapshotParticleData<Scalar> snapshot_type;
+    tags = pdata.takeLocalSnapshot(snapshot_type, 1);
+    UP_ASSERT_EQUAL(tags.size(), 2);
+    UP_ASSERT_EQUAL(snapshot_type.size, 2);
+    UP_ASSERT_EQUAL(tags[0], 1);
+    UP_ASSERT_EQUAL(tags[1], 3);
+    MY_CHECK_CLOSE(snapshot_type.pos[1].z, -2.5, tol);
+    UP_ASSERT_EQUAL(snapshot_type.type_mapping.size(), 2);
+    }
+
 //! Tests the RandomParticleInitializer class
 UP_TEST( Random_test )
     {
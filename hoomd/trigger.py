@@ -12,7 +12,8 @@ may be assigned to multiple operations.
 
 You can define your own triggers by subclassing `Trigger` in Python. When you do
 so, override the `Trigger.compute` method and explicitly call the base class
-constructor in ``__init__``.
+constructor in ``__init__``. Override `Trigger.next_fire_step` as well to let
+`hoomd.Simulation.run` skip the steps on which the trigger is not active.
 
 Example:
     Define a custom trigger::
@@ -24,6 +25,9 @@ Example:
 
             def compute(self, timestep):
                 return (timestep**(1 / 2)).is_integer()
+
+            def next_fire_step(self, timestep):
+                return math.ceil(timestep**(1 / 2))**2
 """
 
 from hoomd import _hoomd
@@ -78,6 +82,25 @@ class Trigger(_hoomd.Trigger): # noqa D214
 
             Returns:
                 bool: `True` when the trigger is active, `False` when it is not.
+
+        next_fire_step(timestep):
+            Find the next timestep on which the trigger may be active.
+
+            Args:
+                timestep (int): The first timestep to consider.
+
+            Returns:
+                int: A timestep ``s >= timestep`` such that the trigger is not
+                active on any timestep in ``[timestep, s)``, or ``2**64 - 1``
+                when it is never active again.
+
+            Note:
+                `hoomd.Simulation.run` advances the integrator without
+                evaluating any trigger until the next timestep on which an
+                operation may be active. User defined triggers may override
+                `next_fire_step` to take part in this. The default
+                implementation returns *timestep*, so the trigger is evaluated
+                on every step.
     """
     def __getstate__(self):
         """Get the state of the trigger object."""
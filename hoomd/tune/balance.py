@@ -19,6 +19,10 @@ class LoadBalancer(Tuner):
         tolerance (:obj:`float`): Load imbalance tolerance.
         max_iterations (:obj:`int`): Maximum number of iterations to
             attempt in a single step.
+        time_weighted (:obj:`bool`): Balance the measured compute time
+            instead of the number of particles when `True`.
+        damping (:obj:`float`): Fraction of each new time measurement mixed
+            into the cost estimate :math:`0 < d \le 1`.
 
     `LoadBalancer` adjusts the boundaries of the MPI domains to distribute
     the particle load close to evenly between them. The load imbalance is
@@ -48,6 +52,21 @@ class LoadBalancer(Tuner):
     significantly more pair force neighbors than others, this estimate of the
     load imbalance may not produce the optimal results.
 
+    For such simulations, set *time_weighted* to `True` to weight each particle
+    by the measured cost of a particle on its rank:
+
+    .. math::
+
+        I = \frac{c_i N_i}{\langle c N \rangle}
+
+    where :math:`c_i` is the wall clock time that rank :math:`i` spent outside
+    of MPI communication since the last update divided by :math:`N_i`. Timings
+    are noisy, so the cost is updated as :math:`c_i \leftarrow (1-d) c_i + d
+    c_i^\prime` from each new measurement :math:`c_i^\prime`, where :math:`d`
+    is *damping*. Smaller values of *damping* balance more slowly but are less
+    likely to oscillate. The first update after enabling *time_weighted* starts
+    the measurement and balances the number of particles.
+
     A load balancing adjustment is only performed when the maximum load
     imbalance exceeds a *tolerance*. The ideal load balance is 1.0, so setting
     *tolerance* less than 1.0 will force an adjustment every update. The load
@@ -82,6 +101,10 @@ class LoadBalancer(Tuner):
         tolerance (:obj:`float`): Load imbalance tolerance.
         max_iterations (:obj:`int`): Maximum number of iterations to
             attempt in a single step.
+        time_weighted (:obj:`bool`): Balance the measured compute time
+            instead of the number of particles when `True`.
+        damping (:obj:`float`): Fraction of each new time measurement mixed
+            into the cost estimate :math:`0 < d \le 1`.
     """
 
     def __init__(self,
@@ -90,18 +113,24 @@ class LoadBalancer(Tuner):
                  y=True,
                  z=True,
                  tolerance=1.02,
-                 max_iterations=1):
+                 max_iterations=1,
+                 time_weighted=False,
+                 damping=0.5):
         defaults = dict(x=x,
                         y=y,
                         z=z,
                         tolerance=tolerance,
                         max_iterations=max_iterations,
+                        time_weighted=time_weighted,
+                        damping=damping,
                         trigger=trigger)
         self._param_dict = ParameterDict(x=bool,
                                          y=bool,
                                          z=bool,
                                          max_iterations=int,
                                          tolerance=float,
+                                         time_weighted=bool,
+                                         damping=float,
                                          trigger=Trigger)
         self._param_dict.update(defaults)
 
@@ -20,6 +20,18 @@ class ParticleSorter(Tuner):
             value of `None` sets ``grid=4096`` in 2D simulations and
             ``grid=256`` in 3D simulations.
 
+        sort_bonded_groups (bool): Set to True to reorder the bonds, angles,
+            dihedrals, impropers, constraints, and special pairs to follow the
+            sorted particle order. Defaults to False.
+
+        low_memory (bool): Set to True to sort the particle data in place
+            and release the second copy of the particle data that the sort
+            otherwise keeps. Defaults to False.
+
+        adaptive (bool): Set to True to order the particles by Morton keys
+            of their continuous coordinates instead of the grid. Defaults to
+            False.
+
     `ParticleSorter` improves simulation performance by sorting the particles in
     memory along a space-filling curve. This takes particles that are close in
     space and places them close in memory, leading to a higher rate of
@@ -37,18 +49,49 @@ class ParticleSorter(Tuner):
             of `grid` provide more accurate space-filling curves, but consume
             more memory (``grid**D * 4`` bytes, where *D* is the dimensionality
             of the system).
+
+        sort_bonded_groups (bool): Reorder the bonded groups to follow the
+            sorted particle order. Bonded force computations then access
+            particles that are close in memory, which improves performance in
+            systems with many bonds, such as polymer melts.
+
+        low_memory (bool): Sort the particle data in place, one array at a
+            time. By default, the particle data keeps a second copy of every
+            per-particle array to write the sorted data to, which doubles its
+            memory footprint. With `low_memory`, that copy is released and
+            each array is permuted through a single scratch buffer on the GPU
+            or in place on the CPU. Sorts take somewhat longer. Not supported
+            with MPI domain decomposition.
+
+        adaptive (bool): Order the particles along a Morton curve computed
+            from their continuous coordinates with 21 bits per dimension in 3D
+            (32 bits in 2D), sorted with a radix sort. `grid` is ignored. The
+            curve resolves dense regions, such as droplets, interfaces, or
+            polymer globules, much more finely than any practical `grid`, and
+            needs no memory for empty regions of the box.
     """
 
-    def __init__(self, trigger=200, grid=None):
+    def __init__(self,
+                 trigger=200,
+                 grid=None,
+                 sort_bonded_groups=False,
+                 low_memory=False,
+                 adaptive=False):
         self._param_dict = ParameterDict(
             trigger=Trigger,
             grid=OnlyTypes(
                 int,
                 postprocess=lambda x: int(ParticleSorter._to_power_of_two(x)),
                 preprocess=ParticleSorter._natural_number,
-                allow_none=True))
+                allow_none=True),
+            sort_bonded_groups=bool,
+            low_memory=bool,
+            adaptive=bool)
         self.trigger = trigger
         self.grid = grid
+        self.sort_bonded_groups = sort_bonded_groups
+        self.low_memory = low_memory
+        self.adaptive = adaptive
 
     @staticmethod
     def _to_power_of_two(value):
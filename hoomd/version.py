@@ -5,6 +5,9 @@
 """Version and build information.
 
 Attributes:
+    ascent_enabled (bool): ``True`` when this build supports in situ
+        visualization with Ascent.
+
     compile_date (str): The date this build was compiled.
 
     compile_flags (str): Human readable summary of compilation flags.
@@ -55,5 +58,6 @@ gpu_platform = _hoomd.BuildInfo.getGPUPlatform()
 cxx_compiler = _hoomd.BuildInfo.getCXXCompiler()
 tbb_enabled = _hoomd.BuildInfo.getEnableTBB()
 mpi_enabled = _hoomd.BuildInfo.getEnableMPI()
+ascent_enabled = _hoomd.BuildInfo.getEnableAscent()
 source_dir = _hoomd.BuildInfo.getSourceDir()
 install_dir = _hoomd.BuildInfo.getInstallDir()
@@ -1,4 +1,6 @@
 from hoomd.write.custom_writer import CustomWriter
 from hoomd.write.gsd import GSD
 from hoomd.write.dcd import DCD
+from hoomd.write.checkpoint import Checkpoint
 from hoomd.write.table import Table
+from hoomd.write.ascent import Ascent
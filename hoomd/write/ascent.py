@@ -0,0 +1,92 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan This file is
+# part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+"""Visualize and analyze simulations in situ with Ascent."""
+
+import hoomd
+from hoomd import _hoomd
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.operation import Writer
+
+
+class Ascent(Writer):
+    """Pass the particle data to an Ascent in situ pipeline.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps to visualize.
+        actions (str): Ascent actions in YAML or JSON, or the name of a file
+            that contains them. The default, ``''``, lets Ascent read
+            ``ascent_actions.yaml`` or ``ascent_actions.json`` from the current
+            working directory.
+        device_pointers (bool): When True, pass pointers to the GPU copies of
+            the particle data arrays. Requires a GPU device and an Ascent build
+            with GPU support. Defaults to False.
+
+    On each triggered timestep, `Ascent` describes the particles of each MPI
+    rank as a Conduit Mesh Blueprint point mesh and executes the *actions* on
+    it. The particle data is passed to Ascent by pointer: `Ascent` copies no
+    particle data and gathers no data across ranks, so renderings and extracts
+    of very large systems do not require writing trajectories to disk.
+
+    The mesh has the topology ``particles`` with the following vertex fields:
+
+    * ``typeid`` - particle type index
+    * ``velocity`` - velocity with components ``u``, ``v``, ``w``
+    * ``mass``
+    * ``orientation`` - quaternion with components ``s``, ``x``, ``y``, ``z``
+    * ``image`` - periodic image with components ``x``, ``y``, ``z``
+    * ``tag``
+
+    The global box lengths and tilt factors are stored in ``state/box``, along
+    with the bounds of the local domain.
+
+    Example::
+
+        actions = '''
+        -
+          action: add_scenes
+          scenes:
+            s1:
+              plots:
+                p1:
+                  type: pseudocolor
+                  field: typeid
+                  points:
+                    radius: 0.5
+        '''
+        ascent = hoomd.write.Ascent(trigger=hoomd.trigger.Periodic(10000),
+                                    actions=actions)
+        sim.operations.writers.append(ascent)
+
+    Note:
+        `Ascent` is only available when HOOMD-blue is built with
+        ``ENABLE_ASCENT=on``. See `hoomd.version.ascent_enabled`.
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps to visualize.
+        actions (str): Ascent actions or the name of the file that contains
+            them *(read only)*.
+        device_pointers (bool): Pass pointers to the GPU copies of the
+            particle data arrays *(read only)*.
+    """
+
+    def __init__(self, trigger, actions='', device_pointers=False):
+        super().__init__(trigger)
+        self._param_dict.update(
+            ParameterDict(actions=str(actions),
+                          device_pointers=bool(device_pointers)))
+
+    def _attach(self):
+        if not hoomd.version.ascent_enabled:
+            raise RuntimeError("write.Ascent requires HOOMD-blue to be built "
+                               "with ENABLE_ASCENT=on.")
+
+        if (self.device_pointers
+                and not isinstance(self._simulation.device, hoomd.device.GPU)):
+            raise RuntimeError("write.Ascent: device_pointers requires a GPU "
+                               "device.")
+
+        self._cpp_obj = _hoomd.AscentWriter(
+            self._simulation.state._cpp_sys_def, self.actions,
+            self.device_pointers)
+        super()._attach()
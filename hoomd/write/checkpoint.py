@@ -0,0 +1,56 @@
+"""Write checkpoints of the simulation state."""
+
+from hoomd import _hoomd
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.operation import Writer
+
+
+class Checkpoint(Writer):
+    """Write checkpoints for an exact restart of the simulation.
+
+    Args:
+        filename (str): Prefix of the checkpoint file names.
+        trigger (hoomd.trigger.Trigger): Select the timesteps to write.
+
+    `Checkpoint` writes the full state of the simulation: the particle data
+    including the net forces, the bonded groups and the variables of the
+    integration methods, such as the thermostat variables of
+    `hoomd.md.methods.NVT`.
+    Each MPI rank writes its local data to its own file
+    ``<filename>.<rank>``, so a checkpoint takes a fraction of the time of a
+    GSD frame of the same system. The new files replace the previous
+    checkpoint only after all ranks have written them.
+
+    Use `hoomd.Simulation.create_state_from_checkpoint` to restart from the
+    checkpoint. A restart with the same number of MPI ranks restores the
+    particles in the same order on each rank. Add the integration methods in
+    the same order as in the original simulation so that each restores its
+    own variables. The autotuner parameters are not stored and are tuned
+    again after the restart.
+
+    Note:
+        Checkpoint files store the values in the native byte order and
+        floating point precision. Read them with the same build of HOOMD.
+
+    Examples::
+
+        checkpoint = hoomd.write.Checkpoint('restart.chk',
+                                            hoomd.trigger.Periodic(100000))
+        sim.operations.writers.append(checkpoint)
+
+    Attributes:
+        filename (str): Prefix of the checkpoint file names.
+        trigger (hoomd.trigger.Trigger): Select the timesteps to write.
+    """
+
+    def __init__(self, filename, trigger):
+        super().__init__(trigger)
+        self._param_dict.update(ParameterDict(filename=str(filename)))
+
+    def _attach(self):
+        # all ranks write next to the files of the root rank
+        filename = _hoomd.mpi_bcast_str(self.filename,
+                                        self._simulation.device._cpp_exec_conf)
+        self._cpp_obj = _hoomd.CheckpointWriter(
+            self._simulation.state._cpp_sys_def, filename)
+        super()._attach()
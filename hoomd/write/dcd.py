@@ -29,6 +29,9 @@ class DCD(Writer):
             *unwrap_full* is True.
         angle_z (bool): When True, the particle orientation angle is written to
             the z component (only useful for 2D simulations)
+        parallel_io (bool): When True, each MPI rank writes the positions of
+            its own particles directly to the file with MPI-IO instead of
+            gathering them on the root rank. Defaults to False.
 
     On each timestep where `DCD` triggers, it writes the simulation snapshot to
     the specified file in the DCD file format. DCD only stores particle
@@ -66,6 +69,13 @@ class DCD(Writer):
             *unwrap_full* is True.
         angle_z (bool): When True, the particle orientation angle is written to
             the z component
+        parallel_io (bool): When True, each MPI rank writes the positions of
+            its own particles with MPI-IO. Set it before the first write.
+
+    Note:
+        With *parallel_io* and *unwrap_rigid*, the central particle of each
+        rigid body must be a local or ghost particle on every rank that
+        writes one of its constituents.
     """
 
     def __init__(self,
@@ -75,7 +85,8 @@ class DCD(Writer):
                  overwrite=False,
                  unwrap_full=False,
                  unwrap_rigid=False,
-                 angle_z=False):
+                 angle_z=False,
+                 parallel_io=False):
 
         # initialize base class
         super().__init__(trigger)
@@ -85,7 +96,8 @@ class DCD(Writer):
                           overwrite=bool(overwrite),
                           unwrap_full=bool(unwrap_full),
                           unwrap_rigid=bool(unwrap_rigid),
-                          angle_z=bool(angle_z)))
+                          angle_z=bool(angle_z),
+                          parallel_io=bool(parallel_io)))
         self.filter = filter
 
     def _attach(self):
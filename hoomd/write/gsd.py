@@ -30,6 +30,9 @@ class GSD(Writer):
             Defaults to ``['property']``.
         log (hoomd.logging.Logger): Provide log quantities to write. Defaults to
             `None`.
+        async_write (bool): When `True`, write each frame to the file in a
+            background thread while the simulation continues. Defaults to
+            `False`.
 
     `GSD` writes a simulation snapshot to the specified file each time it
     triggers. `GSD` can store all particle, bond, angle, dihedral, improper,
@@ -129,6 +132,8 @@ class GSD(Writer):
         truncate (bool): When `True`, truncate the file and write a new frame 0
             each time this operation triggers.
         dynamic (list[str]): Quantity categories to save in every frame.
+        async_write (bool): When `True`, write each frame to the file in a
+            background thread. At most one frame is written at a time.
     """
 
     def __init__(self,
@@ -138,7 +143,8 @@ class GSD(Writer):
                  mode='ab',
                  truncate=False,
                  dynamic=None,
-                 log=None):
+                 log=None,
+                 async_write=False):
 
         super().__init__(trigger)
 
@@ -152,6 +158,7 @@ class GSD(Writer):
                           filter=ParticleFilter,
                           mode=str(mode),
                           truncate=bool(truncate),
+                          async_write=bool(async_write),
                           dynamic=[dynamic_validation],
                           _defaults=dict(filter=filter, dynamic=dynamic)))
 
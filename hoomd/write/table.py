@@ -3,6 +3,7 @@ from numbers import Integral
 from math import log10
 from sys import stdout
 
+from hoomd import _hoomd
 from hoomd.write.custom_writer import _InternalCustomWriter
 from hoomd.custom.custom_action import _InternalAction
 from hoomd.logging import LoggerCategories, Logger
@@ -138,6 +139,10 @@ class _TableInternal(_InternalAction):
     has not changed since the last run of `~.act`. Performance could be
     improved by allowing for writing of data without checking for a change in
     logged quantities, but would be more fragile.
+
+    When every logged quantity is evaluated in C++ and the output has a file
+    descriptor, rows are evaluated, formatted, and buffered by a C++
+    ``LogTable`` instead, which writes the same output.
     """
 
     _invalid_logger_categories = LoggerCategories.any([
@@ -152,7 +157,8 @@ class _TableInternal(_InternalAction):
                  delimiter=' ',
                  pretty=True,
                  max_precision=10,
-                 max_header_len=None):
+                 max_header_len=None,
+                 rows_per_flush=1):
 
         def writable(fh):
             if not fh.writable():
@@ -168,7 +174,8 @@ class _TableInternal(_InternalAction):
                                    max_precision=int,
                                    output=OnlyTypes(_OutputWriter,
                                                    postprocess=writable),
-                                   logger=Logger)
+                                   logger=Logger,
+                                   rows_per_flush=int)
 
         param_dict.update(
             dict(header_sep=header_sep,
@@ -178,9 +185,13 @@ class _TableInternal(_InternalAction):
                  max_precision=max_precision,
                  pretty=pretty,
                  output=output,
-                 logger=logger))
+                 logger=logger,
+                 rows_per_flush=rows_per_flush))
         self._param_dict = param_dict
 
+        if rows_per_flush < 1:
+            raise ValueError("rows_per_flush must be at least 1.")
+
         # internal variables that are not part of the state.
         # Ensure that only scalar and potentially string are set for the logger
         if (LoggerCategories.scalar not in logger.categories
@@ -192,6 +203,13 @@ class _TableInternal(_InternalAction):
         self._cur_headers_with_width = dict()
         self._fmt = _Formatter(pretty, max_precision)
         self._comm = None
+        self._simulation = None
+        # formatted lines not yet written to the output
+        self._buffer = []
+        self._n_buffered_rows = 0
+        # C++ writer and the logger entries it was built for
+        self._cpp_table = None
+        self._cpp_table_entries = []
 
     def _setattr_param(self, attr, value):
         """Makes self._param_dict attributes read only."""
@@ -199,9 +217,23 @@ class _TableInternal(_InternalAction):
 
     def attach(self, simulation):
         self._comm = simulation.device._comm
+        self._simulation = simulation
 
     def detach(self):
+        self.flush()
+        self._drop_cpp_table()
         self._comm = None
+        self._simulation = None
+
+    def flush(self):
+        """Write the buffered lines to output and flush it."""
+        if self._cpp_table is not None:
+            self._cpp_table.flush()
+        if len(self._buffer) > 0:
+            self.output.write(''.join(self._buffer))
+            self.output.flush()
+            self._buffer = []
+            self._n_buffered_rows = 0
 
     def _get_log_dict(self):
         """Get a flattened dict for writing to output."""
@@ -228,10 +260,10 @@ class _TableInternal(_InternalAction):
             header_dict[namespace] = column_size
             header_output_list.append((header, column_size))
         self._cur_headers_with_width = header_dict
-        self.output.write(
+        self._buffer.append(
             self.delimiter.join((self._fmt.format_str(hdr, width)
                                  for hdr, width in header_output_list)))
-        self.output.write('\n')
+        self._buffer.append('\n')
 
     @staticmethod
     def _determine_header(namespace, sep, max_len):
@@ -248,12 +280,84 @@ class _TableInternal(_InternalAction):
             return sep.join(namespace[index:])
 
     def _write_row(self, data):
-        """Write a row of data to output."""
+        """Add a row of data to the buffered lines."""
         headers = self._cur_headers_with_width
-        self.output.write(
+        self._buffer.append(
             self.delimiter.join(
                 (self._fmt(data[k], headers[k]) for k in headers)))
-        self.output.write('\n')
+        self._buffer.append('\n')
+        self._n_buffered_rows += 1
+
+    def _output_fileno(self):
+        """Get the file descriptor of output or None if it has none."""
+        try:
+            return self.output.fileno()
+        except (AttributeError, OSError, ValueError):
+            return None
+
+    def _drop_cpp_table(self):
+        """Write the rows buffered in C++ and return to the Python path."""
+        if self._cpp_table is not None:
+            self._cpp_table.flush()
+        self._cpp_table = None
+        self._cpp_table_entries = []
+
+    def _update_cpp_table(self):
+        """Build the C++ writer when all logged quantities are in C++.
+
+        Returns:
+            bool: True when the C++ writer writes the current row.
+        """
+        if self._simulation is None:
+            return False
+
+        flat = dict_flatten(self.logger._dict)
+        entries, simulation = self.logger._batch_entries()
+        if (len(flat) == 0 or len(entries) != len(flat)
+                or simulation is not self._simulation):
+            self._drop_cpp_table()
+            return False
+
+        cached = self._cpp_table_entries
+        if (len(cached) == len(entries) and all(
+                a[0] is b[0] and a[1] is b[1]
+                for a, b in zip(cached, entries))):
+            return True
+
+        fd = self._output_fileno()
+        if fd is None:
+            self._drop_cpp_table()
+            return False
+
+        # rows written so far must reach the output before C++ writes to it
+        self._drop_cpp_table()
+        self.flush()
+        self.output.flush()
+
+        batch = _hoomd.LogBatch(simulation.device._cpp_exec_conf)
+        for entry, cpp_obj in entries:
+            batch.add(cpp_obj, entry.attr)
+
+        new_keys = flat.keys()
+        write_header = new_keys != self._cur_headers_with_width.keys()
+        headers = [
+            self._determine_header(namespace, self.header_sep,
+                                   self.max_header_len)
+            for namespace in new_keys
+        ]
+        self._cur_headers_with_width = {
+            namespace: max(len(header), self.min_column_width)
+            for namespace, header in zip(new_keys, headers)
+        }
+
+        self._cpp_table = _hoomd.LogTable(simulation.state._cpp_sys_def, batch,
+                                          fd, headers, write_header,
+                                          self.delimiter, self.pretty,
+                                          self.max_precision,
+                                          self.min_column_width,
+                                          self.rows_per_flush)
+        self._cpp_table_entries = entries
+        return True
 
     def act(self, timestep=None):
         """Write row to designated output.
@@ -261,6 +365,12 @@ class _TableInternal(_InternalAction):
         Will also write header when logged quantities are determined to have
         changed.
         """
+        if self._update_cpp_table():
+            if timestep is None:
+                timestep = self._simulation.timestep
+            self._cpp_table.analyze(timestep)
+            return
+
         output_dict = self._get_log_dict()
         if self._comm is not None and self._comm.rank == 0:
             # determine if a header needs to be written. This is always the case
@@ -270,10 +380,12 @@ class _TableInternal(_InternalAction):
             if new_keys != self._cur_headers_with_width.keys():
                 self._update_headers(new_keys)
 
-            # Write the data and flush. We must flush to ensure that the data
-            # isn't merely stored in Python ready to be written later.
+            # Write the data and flush every rows_per_flush rows. We must flush
+            # to ensure that the data isn't merely stored in Python ready to be
+            # written later.
             self._write_row(output_dict)
-            self.output.flush()
+            if self._n_buffered_rows >= self.rows_per_flush:
+                self.flush()
 
 
 class Table(_InternalCustomWriter):
@@ -323,6 +435,20 @@ class Table(_InternalCustomWriter):
             be set to 'energy'. Note that at least the most specific part of the
             namespace will be used regardless of this setting (e.g. if set to 5
             in the previous example, 'energy' would still be the header).
+        rows_per_flush (:obj:`int`, optional): Number of rows to collect
+            before they are written to ``output`` and it is flushed, defaults
+            to 1. Writing many rows at once reduces the overhead of logging on
+            every time step. Rows that are still buffered are written by
+            `flush` and when the writer is removed from the simulation.
+
+            .. versionadded:: 3.0
+
+    Note:
+        When ``output`` has a file descriptor (such as standard out or a file
+        opened with `open`) and every logged quantity is evaluated in C++
+        (e.g. energies of forces, thermodynamic quantities, and the timestep),
+        `Table` evaluates, formats, and buffers the rows in C++. The output is
+        the same as when it formats the rows in Python.
 
     Attributes:
         trigger (hoomd.trigger.Trigger): The trigger to determine when to run
@@ -356,6 +482,10 @@ class Table(_InternalCustomWriter):
             regardless of this setting (e.g. if set to 5 in the previous
             example, 'energy' would still be the header).
         min_column_width (int): The minimum allowed column width.
+        rows_per_flush (int): Number of rows to collect before they are
+            written to ``output``.
+
+            .. versionadded:: 3.0
 
     """
     _internal_class = _TableInternal
@@ -366,3 +496,10 @@ class Table(_InternalCustomWriter):
         Writes a row from given ``hoomd.logging.Logger`` object data.
         """
         self._action.act()
+
+    def flush(self):
+        """Write the buffered rows to ``self.output`` and flush it.
+
+        .. versionadded:: 3.0
+        """
+        self._action.flush()